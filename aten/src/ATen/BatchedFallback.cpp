@@ -2,6 +2,8 @@
 #include <ATen/MatrixRef.h>
 #include <ATen/VmapTransforms.h>
 
+#include <mutex>
+
 namespace at {
 
 // Given a linear index, return the actual index.
@@ -20,6 +22,28 @@ computeIndex(int64_t linear_idx, IntArrayRef sizes) {
   return result;
 }
 
+static std::mutex fallback_counts_mutex;
+
+static std::unordered_map<std::string, int64_t>& fallbackCounts() {
+  static std::unordered_map<std::string, int64_t> counts;
+  return counts;
+}
+
+static void countFallback(const FunctionSchema& schema) {
+  std::lock_guard<std::mutex> lock(fallback_counts_mutex);
+  fallbackCounts()[toString(schema.operator_name())]++;
+}
+
+std::unordered_map<std::string, int64_t> batchedFallbackCounts() {
+  std::lock_guard<std::mutex> lock(fallback_counts_mutex);
+  return fallbackCounts();
+}
+
+void resetBatchedFallbackCounts() {
+  std::lock_guard<std::mutex> lock(fallback_counts_mutex);
+  fallbackCounts().clear();
+}
+
 static bool areAllReturnsTensors(const FunctionSchema& schema) {
   return std::all_of(
       schema.returns().begin(),
@@ -61,6 +85,7 @@ void batchedTensorForLoopFallback(const c10::OperatorHandle& op, torch::jit::Sta
               "The fallback path does not support operations with no returns.");
   TORCH_WARN("Batching rule not implemented for ", schema, " falling back "
              "to slow (for loop and stack) implementation");
+  countFallback(schema);
 
   const auto num_arguments = schema.arguments().size();
   const auto arguments = torch::jit::last(stack, num_arguments);
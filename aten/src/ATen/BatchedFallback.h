@@ -3,6 +3,9 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <string>
+#include <unordered_map>
+
 namespace at {
 
 // If an operator doesn't have a batching rule implemented then we fallback
@@ -20,4 +23,10 @@ namespace at {
 // write batching rules for operators whenever possible.
 void batchedTensorForLoopFallback(const c10::OperatorHandle& op, torch::jit::Stack* stack);
 
+// The number of times the fallback ran for each operator, by operator name
+// (e.g. "aten::atan2"), since the process started or the counts were last
+// reset. Useful to find the operators that are worth a batching rule.
+TORCH_API std::unordered_map<std::string, int64_t> batchedFallbackCounts();
+TORCH_API void resetBatchedFallbackCounts();
+
 } // namespace at
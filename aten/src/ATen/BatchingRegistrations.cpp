@@ -48,10 +48,60 @@ namespace at {
 // if not use the same mechanism. In order to accomplish that we might have to
 // do some refactoring.
 
+// Reductions over a list of dims, like sum.dim_IntList. An empty list means all of
+// the logical dims, which must not become all of the physical dims. The reductions of
+// a logical scalar reduce over a new dim of size one instead of over the batch dims.
+template <typename F, F Func, typename... ExtraArgs>
+Tensor reduction_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, ExtraArgs... extra_args) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  if (self.dim() == 0) {
+    for (auto dim : dims) {
+      maybe_wrap_dim(dim, /*logical_dim*/int64_t{0});
+    }
+    auto result = Func(self_physical.tensor().unsqueeze(-1), {-1}, /*keepdim=*/false, extra_args...);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  VmapDimVector dims_physical;
+  if (dims.empty()) {
+    for (int64_t dim = self_physical.numBatchDims(); dim < self_physical.tensor().dim(); dim++) {
+      dims_physical.push_back(dim);
+    }
+  } else {
+    dims_physical = self_physical.getPhysicalDims(dims);
+  }
+  auto result = Func(self_physical.tensor(), dims_physical, keepdim, extra_args...);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
 Tensor sum_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
+  using SumType = Tensor (*)(const Tensor&, IntArrayRef, bool, optional<ScalarType>);
+  return reduction_batching_rule<SumType, at::sum, optional<ScalarType>>(self, dims, keepdim, dtype);
+}
+
+Tensor sum_full_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  return sum_batching_rule(self, {}, /*keepdim=*/false, dtype);
+}
+
+Tensor mean_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
+  using MeanType = Tensor (*)(const Tensor&, IntArrayRef, bool, optional<ScalarType>);
+  return reduction_batching_rule<MeanType, at::mean, optional<ScalarType>>(self, dims, keepdim, dtype);
+}
+
+Tensor mean_full_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  return mean_batching_rule(self, {}, /*keepdim=*/false, dtype);
+}
+
+// softmax and log_softmax
+template <typename F, F Func>
+Tensor softmax_batching_rule(const Tensor& self, int64_t dim, optional<ScalarType> dtype) {
   auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
-  auto dims_physical = self_physical.getPhysicalDims(dims);
-  auto result = at::sum(self_physical.tensor(), dims_physical, keepdim, dtype);
+  if (self.dim() == 0) {
+    maybe_wrap_dim(dim, /*logical_dim*/int64_t{0});
+    auto result = Func(self_physical.tensor().unsqueeze(-1), -1, dtype).squeeze(-1);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = Func(self_physical.tensor(), dim_physical, dtype);
   return self_physical.newLogicalFromPhysical(result);
 }
 
@@ -314,6 +364,234 @@ Tensor pow_scalar_Tensor_batching_rule(Scalar other, const Tensor& self) {
   return makeBatched(output_physical, BatchDims(old_bdims.begin(), old_bdims.end()));
 }
 
+// The matrix products all go through matmul_batching_rule. Products with a
+// logical vector are rewritten as products of logical matrices, which the
+// batching rules of unsqueeze and squeeze take care of.
+Tensor dot_batching_rule(const Tensor& self, const Tensor& other);
+
+Tensor matmul_batching_rule(const Tensor& self, const Tensor& other) {
+  const auto self_dim = self.dim();
+  const auto other_dim = other.dim();
+  TORCH_CHECK(self_dim > 0 && other_dim > 0,
+      "both arguments to matmul need to be at least 1D, but they are ",
+      self_dim, "D and ", other_dim, "D");
+  if (self_dim == 1 && other_dim == 1) {
+    return dot_batching_rule(self, other);
+  }
+  if (self_dim == 1) {
+    return at::matmul(self.unsqueeze(0), other).squeeze(-2);
+  }
+  if (other_dim == 1) {
+    return at::matmul(self, other.unsqueeze(-1)).squeeze(-1);
+  }
+  // A batched input times a weight matrix is a single matrix product of the
+  // input with its batch dims folded into the rows, which matmul does itself.
+  if (!isBatchedTensor(other) && other_dim == 2) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto result = at::matmul(self_physical.tensor(), other);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
+  auto result = at::matmul(physical_args[0].tensor(), physical_args[1].tensor());
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+Tensor dot_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(self.dim() == 1 && other.dim() == 1,
+      "1D tensors expected, but got ", self.dim(), "D and ", other.dim(), "D tensors");
+  auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
+  auto result = at::matmul(
+      physical_args[0].tensor().unsqueeze(-2),
+      physical_args[1].tensor().unsqueeze(-1));
+  return physical_args[0].newLogicalFromPhysical(result.squeeze(-1).squeeze(-1));
+}
+
+Tensor mv_batching_rule(const Tensor& self, const Tensor& vec) {
+  TORCH_CHECK(self.dim() == 2 && vec.dim() == 1,
+      "vector + matrix @ vector expected, got ", self.dim(), ", ", vec.dim());
+  return matmul_batching_rule(self, vec);
+}
+
+Tensor mm_batching_rule(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 2, "self must be a matrix");
+  TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix");
+  return matmul_batching_rule(self, mat2);
+}
+
+Tensor bmm_batching_rule(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 3, "batch1 must be a 3D tensor");
+  TORCH_CHECK(mat2.dim() == 3, "batch2 must be a 3D tensor");
+  return matmul_batching_rule(self, mat2);
+}
+
+Tensor addmm_batching_rule(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
+  TORCH_CHECK(mat1.dim() == 2, "mat1 must be a matrix, got ", mat1.dim(), "-D tensor");
+  TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix, got ", mat2.dim(), "-D tensor");
+  // The batched input of linear: one addmm with the batch dims folded into the rows.
+  if (!isBatchedTensor(self) && !isBatchedTensor(mat2) && (self.dim() < 2 || self.size(0) == 1)) {
+    auto mat1_physical = MultiBatchVmapTransform::logicalToPhysical(mat1);
+    const auto& mat1_tensor = mat1_physical.tensor();
+    auto result = at::addmm(self, mat1_tensor.reshape({-1, mat1_tensor.size(-1)}), mat2, beta, alpha);
+    VmapDimVector result_shape(mat1_tensor.sizes().begin(), mat1_tensor.sizes().end() - 1);
+    result_shape.push_back(result.size(-1));
+    return mat1_physical.newLogicalFromPhysical(result.view(result_shape));
+  }
+  // The product is [n, m], which self broadcasts to. Like addmm, self (and
+  // its nans and infs) is ignored when beta is zero.
+  auto product = at::matmul(mat1, mat2);
+  if (beta.toComplexDouble() == 0.0) {
+    return at::mul(product, alpha);
+  }
+  return at::add(beta.toComplexDouble() == 1.0 ? self : at::mul(self, beta), product, alpha);
+}
+
+Tensor linear_batching_rule(const Tensor& input, const Tensor& weight, const c10::optional<Tensor>& bias_opt) {
+  Tensor bias = bias_opt.value_or(Tensor());
+  if (input.dim() == 2 && bias.defined()) {
+    return at::addmm(bias, input, weight.t());
+  }
+  auto output = at::matmul(input, weight.t());
+  return bias.defined() ? at::add(output, bias) : output;
+}
+
+// The examples of a batched input go into the batch of conv2d. The examples
+// of a batched weight (or bias) go into its groups: the channels of all of the
+// examples are concatenated and each example convolved with its own weight.
+Tensor conv2d_batching_rule(
+    const Tensor& input, const Tensor& weight, const c10::optional<Tensor>& bias_opt,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  Tensor bias = bias_opt.value_or(Tensor());
+  TORCH_CHECK(input.dim() == 4 && weight.dim() == 4,
+      "Expected 4-dimensional input for 4-dimensional weight ", weight.sizes(),
+      ", but got ", input.dim(), "-dimensional input of size ", input.sizes(), " instead");
+  if (!isBatchedTensor(weight) && !(bias.defined() && isBatchedTensor(bias))) {
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    const auto& input_tensor = input_physical.tensor();
+    const auto num_batch_dims = input_physical.numBatchDims();
+    auto result = at::conv2d(
+        input_tensor.flatten(0, num_batch_dims), weight, bias, stride, padding, dilation, groups);
+    VmapDimVector result_shape(input_tensor.sizes().begin(), input_tensor.sizes().begin() + num_batch_dims + 1);
+    result_shape.insert(result_shape.end(), result.sizes().begin() + 1, result.sizes().end());
+    return input_physical.newLogicalFromPhysical(result.reshape(result_shape));
+  }
+  std::vector<Tensor> logical_args = {input, weight};
+  if (bias.defined()) {
+    logical_args.push_back(bias);
+  }
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical(logical_args);
+  const auto& input_tensor = physical_args[0].tensor();
+  const auto& weight_tensor = physical_args[1].tensor();
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  // [B..., N, C, H, W] -> [N, B*C, H, W]
+  auto flat_input = input_tensor.flatten(0, num_batch_dims - 1).transpose(0, 1);
+  const auto batch_size = flat_input.size(1);
+  flat_input = flat_input.flatten(1, 2);
+  // [B..., O, C/groups, kH, kW] -> [B*O, C/groups, kH, kW]
+  auto flat_weight = weight_tensor.flatten(0, num_batch_dims);
+  Tensor flat_bias;
+  if (bias.defined()) {
+    flat_bias = physical_args[2].tensor().flatten(0, num_batch_dims);
+  }
+  auto result = at::conv2d(flat_input, flat_weight, flat_bias, stride, padding, dilation, groups * batch_size);
+  // [N, B*O, H', W'] -> [B..., N, O, H', W']
+  VmapDimVector result_shape(input_tensor.sizes().begin(), input_tensor.sizes().begin() + num_batch_dims);
+  result_shape.push_back(result.size(0));
+  result_shape.push_back(weight_tensor.size(num_batch_dims));
+  result_shape.insert(result_shape.end(), result.sizes().begin() + 2, result.sizes().end());
+  result = result.view({result.size(0), batch_size, -1, result.size(2), result.size(3)}).transpose(0, 1);
+  return physical_args[0].newLogicalFromPhysical(result.reshape(result_shape));
+}
+
+// A batched weight is the weights of all of the examples concatenated, each
+// example looking up its own rows.
+Tensor embedding_batching_rule(
+    const Tensor& weight, const Tensor& indices, int64_t padding_idx, bool scale_grad_by_freq, bool sparse) {
+  if (!isBatchedTensor(weight)) {
+    auto indices_physical = MultiBatchVmapTransform::logicalToPhysical(indices);
+    auto result = at::embedding(weight, indices_physical.tensor(), padding_idx, scale_grad_by_freq, sparse);
+    return indices_physical.newLogicalFromPhysical(result);
+  }
+  TORCH_CHECK(weight.dim() == 2, "'weight' must be 2-D");
+  TORCH_CHECK(!sparse, "vmap: embedding with sparse=True is not supported for a batched weight");
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({weight, indices});
+  auto weight_tensor = physical_args[0].tensor();
+  const auto& indices_tensor = physical_args[1].tensor();
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  const auto num_weights = weight_tensor.size(-2);
+  if (padding_idx >= 0 && weight_tensor.requires_grad()) {
+    // The padding rows of the concatenated weight must not get gradients either
+    auto is_padding = (at::arange(num_weights, indices.options()) == padding_idx).unsqueeze(-1);
+    weight_tensor = at::where(is_padding, weight_tensor.detach(), weight_tensor);
+  }
+  int64_t batch_size = 1;
+  VmapDimVector offsets_shape(indices_tensor.dim(), 1);
+  for (int64_t dim = 0; dim < num_batch_dims; dim++) {
+    offsets_shape[dim] = indices_tensor.size(dim);
+    batch_size *= indices_tensor.size(dim);
+  }
+  auto offsets = at::arange(batch_size, indices_tensor.options()).mul_(num_weights).view(offsets_shape);
+  auto result = at::embedding(
+      weight_tensor.reshape({-1, weight_tensor.size(-1)}), indices_tensor + offsets,
+      /*padding_idx=*/-1, scale_grad_by_freq, /*sparse=*/false);
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+// layer_norm normalizes over the trailing dims, which are the same in the
+// physical input. A batched weight or bias is applied afterwards.
+Tensor layer_norm_batching_rule(
+    const Tensor& input, IntArrayRef normalized_shape, const c10::optional<Tensor>& weight_opt,
+    const c10::optional<Tensor>& bias_opt, double eps, bool cudnn_enable) {
+  Tensor weight = weight_opt.value_or(Tensor());
+  Tensor bias = bias_opt.value_or(Tensor());
+  const bool affine_is_batched =
+      (weight.defined() && isBatchedTensor(weight)) || (bias.defined() && isBatchedTensor(bias));
+  if (!affine_is_batched) {
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    auto result = at::layer_norm(input_physical.tensor(), normalized_shape, weight, bias, eps, cudnn_enable);
+    return input_physical.newLogicalFromPhysical(result);
+  }
+  auto result = at::layer_norm(input, normalized_shape, Tensor(), Tensor(), eps, cudnn_enable);
+  if (weight.defined()) {
+    result = at::mul(result, weight);
+  }
+  if (bias.defined()) {
+    result = at::add(result, bias);
+  }
+  return result;
+}
+
+// Each example selecting its own indices is a gather, with the indices
+// expanded along the other dims.
+Tensor index_select_batching_rule(const Tensor& self, int64_t dim, const Tensor& index) {
+  if (!isBatchedTensor(index)) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto dim_physical = self_physical.getPhysicalDim(dim);
+    auto result = at::index_select(self_physical.tensor(), dim_physical, index);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  TORCH_CHECK(index.dim() <= 1, "index_select(): Index is supposed to be a vector");
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  const auto& self_tensor = physical_args[0].tensor();
+  const auto& index_tensor = physical_args[1].tensor();
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  const auto num_indices = index.numel();
+  VmapDimVector index_shape(self_tensor.dim(), 1);
+  std::copy(index_tensor.sizes().begin(), index_tensor.sizes().begin() + num_batch_dims, index_shape.begin());
+  index_shape[dim_physical] = num_indices;
+  VmapDimVector expanded_shape(self_tensor.sizes().begin(), self_tensor.sizes().end());
+  expanded_shape[dim_physical] = num_indices;
+  auto result = at::gather(self_tensor, dim_physical, index_tensor.reshape(index_shape).expand(expanded_shape));
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+Tensor gather_batching_rule(const Tensor& self, int64_t dim, const Tensor& index, bool sparse_grad) {
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto result = at::gather(physical_args[0].tensor(), dim_physical, physical_args[1].tensor(), sparse_grad);
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
 TORCH_LIBRARY_IMPL(_, Batched, m) {
   m.fallback(torch::CppFunction::makeFromBoxedFunction<&batchedTensorForLoopFallback>());
 }
@@ -327,7 +605,37 @@ TORCH_LIBRARY_IMPL(aten, Batched, m) {
   m.impl("_add_batch_dim", native::_add_batch_dim);
   m.impl("_remove_batch_dim", native::_remove_batch_dim);
 
+  // reductions
+  m.impl("sum", sum_full_batching_rule);
   m.impl_UNBOXED("sum.dim_IntList", sum_batching_rule);
+  m.impl("mean", mean_full_batching_rule);
+  m.impl("mean.dim", mean_batching_rule);
+  {
+    using LogsumexpType = Tensor (*)(const Tensor&, IntArrayRef, bool);
+    m.impl("logsumexp", reduction_batching_rule<LogsumexpType, at::logsumexp>);
+    m.impl("amax", reduction_batching_rule<LogsumexpType, at::amax>);
+  }
+  {
+    using SoftmaxType = Tensor (*)(const Tensor&, int64_t, optional<ScalarType>);
+    m.impl("softmax.int", softmax_batching_rule<SoftmaxType, at::softmax>);
+    m.impl("log_softmax.int", softmax_batching_rule<SoftmaxType, at::log_softmax>);
+  }
+
+  // matrix products and the nn ops built on them
+  m.impl("addmm", addmm_batching_rule);
+  m.impl("bmm", bmm_batching_rule);
+  m.impl("dot", dot_batching_rule);
+  m.impl("linear", linear_batching_rule);
+  m.impl("matmul", matmul_batching_rule);
+  m.impl("mm", mm_batching_rule);
+  m.impl("mv", mv_batching_rule);
+  m.impl("conv2d", conv2d_batching_rule);
+  m.impl("embedding", embedding_batching_rule);
+  m.impl("layer_norm", layer_norm_batching_rule);
+
+  // indexing
+  m.impl("gather", gather_batching_rule);
+  m.impl("index_select", index_select_batching_rule);
 
   // view operations
   m.impl("chunk", chunk_batching_rule);
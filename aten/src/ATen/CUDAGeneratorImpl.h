@@ -7,6 +7,41 @@
 
 namespace at {
 
+/**
+ * Note [CUDA Graph-safe RNG states]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * A kernel launched during CUDA graph capture is replayed with the arguments
+ * it was captured with, so a seed and offset passed by value would make every
+ * replay draw the same random numbers. While a graph is being captured the
+ * generator instead hands out pointers to device-side seed and offset values
+ * (owned by the CUDAGraph, refilled from the generator before each replay)
+ * plus the offset into the graph's share of the philox sequence at which the
+ * kernel starts. Kernels receive a PhiloxCudaState and call
+ * at::cuda::philox::unpack (ATen/cuda/CUDAGraphsUtils.cuh) on the device to
+ * get the (seed, offset) pair for curand_init, whichever mode they run in.
+ */
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  // Called if graph capture is not underway
+  PhiloxCudaState(uint64_t seed, uint64_t offset)
+    : seed_(seed), offset_(offset) {}
+  // Called if graph capture is underway
+  PhiloxCudaState(int64_t* seed_extragraph,
+                  int64_t* offset_extragraph,
+                  uint64_t offset_intragraph)
+    : seed_extragraph_(seed_extragraph),
+      offset_extragraph_(offset_extragraph),
+      offset_intragraph_(offset_intragraph),
+      captured_(true) {}
+
+  uint64_t seed_ = 0;
+  uint64_t offset_ = 0;
+  int64_t* seed_extragraph_ = nullptr;
+  int64_t* offset_extragraph_ = nullptr;
+  uint64_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
 struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   // Constructors
   CUDAGeneratorImpl(DeviceIndex device_index = -1);
@@ -20,12 +55,19 @@ struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   void set_philox_offset_per_thread(uint64_t offset);
   uint64_t philox_offset_per_thread();
   std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+  PhiloxCudaState philox_cuda_state(uint64_t increment);
+  void capture_prologue(int64_t* seed_extragraph, int64_t* offset_extragraph);
+  uint64_t capture_epilogue();
   static DeviceType device_type();
 
 private:
   CUDAGeneratorImpl* clone_impl() const override;
   uint64_t seed_ = default_rng_seed_val;
   uint64_t philox_offset_per_thread_ = 0;
+  int64_t* seed_extragraph_ = nullptr;
+  int64_t* offset_extragraph_ = nullptr;
+  uint64_t offset_intragraph_ = 0;
+  bool graph_expects_this_gen_ = false;
 };
 
 namespace cuda {
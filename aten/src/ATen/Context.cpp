@@ -116,6 +116,14 @@ void Context::setBenchmarkCuDNN(bool b) {
   benchmark_cudnn = b;
 }
 
+bool Context::benchmarkCPUConv() const {
+  return benchmark_cpu_conv;
+}
+
+void Context::setBenchmarkCPUConv(bool b) {
+  benchmark_cpu_conv = b;
+}
+
 bool Context::allowTF32CuBLAS() const {
   return allow_tf32_cublas;
 }
@@ -124,6 +132,14 @@ void Context::setAllowTF32CuBLAS(bool b) {
   allow_tf32_cublas = b;
 }
 
+bool Context::philoxCPURNG() const {
+  return philox_cpu_rng;
+}
+
+void Context::setPhiloxCPURNG(bool b) {
+  philox_cpu_rng = b;
+}
+
 bool Context::hasMKL() const {
 #if AT_MKL_ENABLED()
   return true;
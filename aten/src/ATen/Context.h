@@ -110,6 +110,10 @@ class CAFFE2_API Context {
   void setUserEnabledMkldnn(bool e);
   bool benchmarkCuDNN() const;
   void setBenchmarkCuDNN(bool);
+  // Whether CPU convolutions pick their implementation by timing them, see
+  // Note [CPU convolution benchmarking] in native/Convolution.cpp
+  bool benchmarkCPUConv() const;
+  void setBenchmarkCPUConv(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
   bool deterministic() const;
@@ -118,6 +122,10 @@ class CAFFE2_API Context {
   bool allowTF32CuBLAS() const;
   void setAllowTF32CuBLAS(bool);
   void alertCuBLASConfigNotDeterministic();
+  // Whether uniform_, normal_ and bernoulli_ on CPU generate in parallel with
+  // Philox, see Note [Philox CPU generation] in cpu/DistributionTemplates.h
+  bool philoxCPURNG() const;
+  void setPhiloxCPURNG(bool);
   at::QEngine qEngine() const;
   void setQEngine(at::QEngine e);
   const std::vector<at::QEngine>& supportedQEngines() const;
@@ -146,7 +154,9 @@ class CAFFE2_API Context {
   bool deterministic_cudnn = false;
   bool _deterministic = false;
   bool benchmark_cudnn = false;
+  bool benchmark_cpu_conv = false;
   bool allow_tf32_cublas = true;
+  bool philox_cpu_rng = false;
   bool enabled_mkldnn = true;
   #ifdef C10_MOBILE
   bool release_original_weights = true;
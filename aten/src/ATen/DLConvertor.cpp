@@ -99,6 +99,8 @@ DLContext getDLContext(const Tensor& tensor, const int64_t& device_id) {
 static Device getATenDevice(const DLContext& ctx) {
   switch (ctx.device_type) {
     case DLDeviceType::kDLCPU:
+    // pinned host memory is CPU memory, which is_pinned() recognizes
+    case DLDeviceType::kDLCPUPinned:
       return at::Device(DeviceType::CPU);
 #ifndef USE_ROCM
     // if we are compiled under HIP, we cannot do cuda
@@ -214,14 +216,16 @@ Tensor fromDLPack(const DLManagedTensor* src) {
   auto deleter = [src](void* self) {
     src->deleter(const_cast<DLManagedTensor*>(src));
   };
+  // The data of a DLTensor starts byte_offset bytes after its data pointer.
+  void* data = static_cast<char*>(src->dl_tensor.data) + src->dl_tensor.byte_offset;
   if (!src->dl_tensor.strides) {
-    return at::from_blob(src->dl_tensor.data,
+    return at::from_blob(data,
         IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
         deleter,
         at::device(device).dtype(stype));
   }
   return at::from_blob(
-      src->dl_tensor.data,
+      data,
       IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
       IntArrayRef(src->dl_tensor.strides, src->dl_tensor.ndim),
       deleter,
@@ -1,19 +1,70 @@
 #pragma once
 
 #include <ATen/Parallel.h>
+#include <c10/core/WorkStealingThreadPool.h>
 #include <c10/core/thread_pool.h>
+#include <c10/util/cpu_affinity.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace at {
 
+namespace internal {
+// Throws unless every one of cpus can be pinned to. Leaves the affinity of
+// the calling thread as it was.
+CAFFE2_API void check_cpus(const std::vector<int>& cpus);
+
+// Sets up a pool thread. The i-th thread to start is pinned to
+// cpus[i % cpus.size()], if cpus are given.
+inline std::function<void()> pool_thread_init(
+    int numa_node_id,
+    std::vector<int> cpus) {
+  auto next_thread = std::make_shared<std::atomic<size_t>>(0);
+  return [numa_node_id, cpus, next_thread]() {
+    c10::setThreadName("PTThreadPool");
+    c10::NUMABind(numa_node_id);
+    if (!cpus.empty()) {
+      // Checked by set_intraop_cpus()/set_interop_cpus() already, a pool
+      // thread must not throw.
+      c10::SetThreadAffinity({cpus[(*next_thread)++ % cpus.size()]});
+    }
+    at::init_num_threads();
+  };
+}
+} // namespace internal
+
 class CAFFE2_API PTThreadPool : public c10::ThreadPool {
 public:
   explicit PTThreadPool(
       int pool_size,
-      int numa_node_id = -1)
-    : c10::ThreadPool(pool_size, numa_node_id, [](){
-        c10::setThreadName("PTThreadPool");
-        at::init_num_threads();
-      }) {}
+      int numa_node_id = -1,
+      std::vector<int> cpus = {})
+    : c10::ThreadPool(
+          pool_size,
+          numa_node_id,
+          internal::pool_thread_init(numa_node_id, std::move(cpus))) {}
+};
+
+class CAFFE2_API PTWorkStealingThreadPool : public c10::WorkStealingThreadPool {
+public:
+  explicit PTWorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1,
+      std::vector<int> cpus = {})
+    : c10::WorkStealingThreadPool(
+          pool_size,
+          numa_node_id,
+          internal::pool_thread_init(numa_node_id, std::move(cpus))) {}
 };
 
+// Creates a PTThreadPool, or a PTWorkStealingThreadPool if the environment
+// variable PYTORCH_THREAD_POOL is set to work_stealing. The intra-op and
+// inter-op pools are both created by this.
+CAFFE2_API std::shared_ptr<c10::TaskThreadPoolBase> create_thread_pool(
+    int pool_size,
+    int numa_node_id = -1,
+    std::vector<int> cpus = {});
+
 } // namespace at
@@ -131,6 +131,10 @@ CAFFE2_API int get_num_interop_threads();
 CAFFE2_API void launch(std::function<void()> func);
 namespace internal {
 void launch_no_thread_state(std::function<void()> fn);
+
+// Whether an inter-op thread is idle, i.e. whether a task launched now would
+// start right away rather than wait in the queue
+CAFFE2_API bool _interop_pool_has_idle_threads();
 } // namespace internal
 
 // Launches intra-op parallel task
@@ -143,6 +147,82 @@ CAFFE2_API std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 // Returns number of intra-op threads used by default
 CAFFE2_API int intraop_default_num_threads();
 
+// Binds the intra-op threads and the calling thread, which takes part in
+// every parallel region it starts, to the CPUs and memory of a NUMA node, so
+// that the CPU allocator places the tensors they create on that node.
+// Has no effect unless NUMA is enabled, see c10::SetNUMAEnabled. With the
+// native backend it has to be called before parallel work has started.
+CAFFE2_API void set_intraop_numa_node(int);
+
+// Returns the NUMA node intra-op threads are bound to, or -1
+CAFFE2_API int get_intraop_numa_node();
+
+// Pins the calling thread to the first of cpus and the intra-op threads to
+// the others, one CPU per thread, round robin. With the native backend it
+// has to be called before parallel work has started, and the
+// PYTORCH_INTRAOP_CPUS and PYTORCH_INTRAOP_NUMA_NODE environment variables
+// act like calling it, or set_intraop_numa_node, from the thread that
+// starts the first parallel region. With TBB only the calling thread is
+// pinned, to all of cpus.
+CAFFE2_API void set_intraop_cpus(const std::vector<int>& cpus);
+
+// Returns the CPUs intra-op threads are pinned to, empty if they are not
+CAFFE2_API std::vector<int> get_intraop_cpus();
+
+// Pins the inter-op threads to cpus, one CPU per thread, round robin. Has to
+// be called before inter-op work has started, PYTORCH_INTEROP_CPUS sets it
+// in the environment.
+CAFFE2_API void set_interop_cpus(const std::vector<int>& cpus);
+
+// Returns the CPUs inter-op threads are pinned to, empty if they are not
+CAFFE2_API std::vector<int> get_interop_cpus();
+
+// Creates a named intra-op pool of num_threads threads, counting the thread
+// that starts a parallel region, so that the requests of one model do not
+// compete for threads with the others served in the same process. Named
+// pools live until the process exits. They only get threads of their own
+// with the native backend, the other backends keep using their shared pool.
+CAFFE2_API void create_intraop_pool(const std::string& name, int num_threads);
+
+// Runs the parallel regions the calling thread starts on the named pool, or
+// on the default one for "". The choice is part of ThreadLocalState, so it
+// follows at::launch, JIT forks and the autograd engine.
+CAFFE2_API void set_current_intraop_pool(const std::string& name);
+
+// Returns the name of the calling thread's intra-op pool, "" for the default
+CAFFE2_API std::string get_current_intraop_pool();
+
+namespace internal {
+// At most this many intra-op pools, id 0 is the default pool
+constexpr int kMaxIntraopPools = 64;
+
+CAFFE2_API int _get_intraop_pool_id();
+CAFFE2_API void _set_intraop_pool_id(int id);
+
+// Number of threads of a named pool, counting the calling thread
+CAFFE2_API int _get_intraop_pool_num_threads(int id);
+} // namespace internal
+
+// Selects a named intra-op pool for the current scope, see
+// set_current_intraop_pool
+class CAFFE2_API IntraopPoolGuard {
+ public:
+  explicit IntraopPoolGuard(const std::string& name)
+      : prev_id_(internal::_get_intraop_pool_id()) {
+    set_current_intraop_pool(name);
+  }
+
+  ~IntraopPoolGuard() {
+    internal::_set_intraop_pool_id(prev_id_);
+  }
+
+  IntraopPoolGuard(const IntraopPoolGuard&) = delete;
+  IntraopPoolGuard& operator=(const IntraopPoolGuard&) = delete;
+
+ private:
+  int prev_id_;
+};
+
 } // namespace at
 
 #if AT_PARALLEL_OPENMP
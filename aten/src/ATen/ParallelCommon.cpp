@@ -4,6 +4,9 @@
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
@@ -40,6 +43,24 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+std::string cpu_list_or_not_set(const std::vector<int>& cpus) {
+  return cpus.empty() ? "[not set]" : c10::FormatCPUList(cpus);
+}
+
+struct NamedIntraopPool {
+  std::string name;
+  int num_threads = 0;
+};
+
+// Pools are only added, under intraop_pools_mutex, and never change after
+// that, so a thread that got an id reads its pool without a lock.
+std::mutex intraop_pools_mutex;
+std::array<NamedIntraopPool, internal::kMaxIntraopPools> intraop_pools;
+std::atomic<int> num_intraop_pools{1};
+
+// intra-op pool of the parallel regions started by this thread
+thread_local int intraop_pool_id = 0;
+
 } // namespace
 
 std::string get_parallel_info() {
@@ -49,6 +70,17 @@ std::string get_parallel_info() {
      << at::get_num_threads() << std::endl;
   ss << "\tat::get_num_interop_threads() : "
      << at::get_num_interop_threads() << std::endl;
+  ss << "\tat::get_intraop_numa_node() : "
+     << at::get_intraop_numa_node() << std::endl;
+  ss << "\tat::get_intraop_cpus() : "
+     << cpu_list_or_not_set(at::get_intraop_cpus()) << std::endl;
+  ss << "\tat::get_interop_cpus() : "
+     << cpu_list_or_not_set(at::get_interop_cpus()) << std::endl;
+  ss << "\tat::get_current_intraop_pool() : "
+     << (intraop_pool_id == 0 ? "[default]" : intraop_pools[intraop_pool_id].name)
+     << std::endl;
+  ss << "\tcurrent thread affinity : "
+     << cpu_list_or_not_set(c10::GetThreadAffinity()) << std::endl;
 
   ss << at::get_openmp_version() << std::endl;
 #ifdef _OPENMP
@@ -70,6 +102,14 @@ std::string get_parallel_info() {
      << get_env_var("OMP_NUM_THREADS", "[not set]") << std::endl;
   ss << "\tMKL_NUM_THREADS : "
      << get_env_var("MKL_NUM_THREADS", "[not set]") << std::endl;
+  ss << "\tPYTORCH_THREAD_POOL : "
+     << get_env_var("PYTORCH_THREAD_POOL", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTRAOP_CPUS : "
+     << get_env_var("PYTORCH_INTRAOP_CPUS", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTRAOP_NUMA_NODE : "
+     << get_env_var("PYTORCH_INTRAOP_NUMA_NODE", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTEROP_CPUS : "
+     << get_env_var("PYTORCH_INTEROP_CPUS", "[not set]") << std::endl;
 
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
@@ -107,4 +147,63 @@ int intraop_default_num_threads() {
 #endif
 }
 
+void create_intraop_pool(const std::string& name, int num_threads) {
+  TORCH_CHECK(!name.empty(), "Expected a non-empty intra-op pool name");
+  TORCH_CHECK(num_threads > 0, "Expected positive number of threads");
+#if !AT_PARALLEL_NATIVE || defined(C10_MOBILE)
+  TORCH_WARN_ONCE(
+      "Named intra-op pools share the threads of the default pool, "
+      "they only get threads of their own with the native parallel backend");
+#endif
+  std::lock_guard<std::mutex> guard(intraop_pools_mutex);
+  const int id = num_intraop_pools.load();
+  for (int i = 1; i < id; i++) {
+    TORCH_CHECK(
+        intraop_pools[i].name != name,
+        "Intra-op pool ", name, " already exists");
+  }
+  TORCH_CHECK(
+      id < internal::kMaxIntraopPools,
+      "Cannot create more than ", internal::kMaxIntraopPools - 1,
+      " intra-op pools");
+  intraop_pools[id].name = name;
+  intraop_pools[id].num_threads = num_threads;
+  num_intraop_pools.store(id + 1);
+}
+
+void set_current_intraop_pool(const std::string& name) {
+  if (name.empty()) {
+    intraop_pool_id = 0;
+    return;
+  }
+  const int num_pools = num_intraop_pools.load();
+  for (int i = 1; i < num_pools; i++) {
+    if (intraop_pools[i].name == name) {
+      intraop_pool_id = i;
+      return;
+    }
+  }
+  TORCH_CHECK(false, "Unknown intra-op pool ", name);
+}
+
+std::string get_current_intraop_pool() {
+  return intraop_pools[intraop_pool_id].name;
+}
+
+namespace internal {
+int _get_intraop_pool_id() {
+  return intraop_pool_id;
+}
+
+void _set_intraop_pool_id(int id) {
+  TORCH_INTERNAL_ASSERT(id >= 0 && id < num_intraop_pools.load());
+  intraop_pool_id = id;
+}
+
+int _get_intraop_pool_num_threads(int id) {
+  TORCH_INTERNAL_ASSERT(id > 0 && id < num_intraop_pools.load());
+  return intraop_pools[id].num_threads;
+}
+} // namespace internal
+
 } // namespace at
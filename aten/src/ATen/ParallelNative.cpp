@@ -2,6 +2,7 @@
 #if AT_PARALLEL_NATIVE
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
+#include <c10/util/cpu_affinity.h>
 
 #ifndef C10_MOBILE
 #include <c10/core/thread_pool.h>
@@ -9,7 +10,13 @@
 #include <caffe2/utils/threadpool/pthreadpool-cpp.h>
 #endif // C10_MOBILE
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -36,10 +43,26 @@ void _set_thread_num(size_t thread_num) {
   thread_num_ = thread_num;
 }
 
-void _unset_thread_num() {
-  thread_num_ = 0;
+// NUMA node the intra-op threads are bound to, -1 if none
+std::atomic<int> intraop_numa_node{-1};
+
+// CPUs the intra-op threads are pinned to, the first one for the calling
+// thread, empty if none
+std::mutex intraop_cpus_mutex;
+std::vector<int> intraop_cpus;
+
+bool _adaptive_grain_size_from_env() {
+  const char* value = std::getenv("PYTORCH_ADAPTIVE_GRAIN_SIZE");
+  return value != nullptr && strcmp(value, "1") == 0;
 }
 
+// see GrainSizeTuner
+std::atomic<bool> adaptive_grain_size{_adaptive_grain_size_from_env()};
+
+// Calls of a call site that are all timed, later ones are sampled.
+constexpr uint64_t kGrainSizeWarmupCalls = 8;
+constexpr uint64_t kGrainSizeSampleInterval = 16;
+
 #ifndef C10_MOBILE
 
 const int NOT_SET = -1;
@@ -65,28 +88,170 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
+// Applies PYTORCH_INTRAOP_NUMA_NODE and PYTORCH_INTRAOP_CPUS to the calling
+// thread, unless set_intraop_numa_node() or set_intraop_cpus() were called.
+void _apply_intraop_placement_from_env() {
+  const char* numa_node = std::getenv("PYTORCH_INTRAOP_NUMA_NODE");
+  if (intraop_numa_node.load() < 0 && numa_node != nullptr &&
+      strcmp(numa_node, "") != 0) {
+    char* end = nullptr;
+    const long node = std::strtol(numa_node, &end, 10);
+    if (end != numa_node && *end == '\0' && node >= 0) {
+      c10::NUMABind(node);
+      intraop_numa_node.store(node);
+    } else {
+      TORCH_WARN("Ignoring invalid PYTORCH_INTRAOP_NUMA_NODE value ", numa_node);
+    }
+  }
+  const char* cpu_list = std::getenv("PYTORCH_INTRAOP_CPUS");
+  std::lock_guard<std::mutex> guard(intraop_cpus_mutex);
+  if (intraop_cpus.empty() && cpu_list != nullptr &&
+      strcmp(cpu_list, "") != 0) {
+    try {
+      auto cpus = c10::ParseCPUList(cpu_list);
+      internal::check_cpus(cpus);
+      c10::SetThreadAffinity({cpus[0]});
+      intraop_cpus = cpus;
+    } catch (const c10::Error& e) {
+      TORCH_WARN("Ignoring PYTORCH_INTRAOP_CPUS: ", e.msg());
+    }
+  }
+}
+
+std::shared_ptr<TaskThreadPoolBase> _create_intraop_pool() {
+  int pool_size = _num_pool_threads(num_intraop_threads.exchange(CONSUMED));
+  _apply_intraop_placement_from_env();
+  int numa_node_id = intraop_numa_node.load();
+  std::vector<int> cpus = get_intraop_cpus();
+  if (numa_node_id >= 0 || !cpus.empty()) {
+    // The calling thread keeps the first CPU.
+    if (!cpus.empty()) {
+      std::rotate(cpus.begin(), cpus.begin() + 1, cpus.end());
+    }
+    // the registry creators take no NUMA node or CPUs
+    return create_thread_pool(pool_size, numa_node_id, cpus);
+  }
+  return ThreadPoolRegistry()->Create(
+      "C10",
+      /* device_id */ 0,
+      /* pool_size */ pool_size,
+      /* create_new */ true); // create a separate thread pool for intra-op
+}
+
 TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+  static std::shared_ptr<TaskThreadPoolBase> pool = _create_intraop_pool();
   return *pool;
 }
 
+// Threads of the named intra-op pools, created on first use and never
+// destroyed, like the default pool
+std::mutex named_intraop_pools_mutex;
+std::vector<std::shared_ptr<TaskThreadPoolBase>> named_intraop_pool_owners;
+std::array<std::atomic<TaskThreadPoolBase*>, internal::kMaxIntraopPools>
+    named_intraop_pools{};
+
+TaskThreadPoolBase& _get_named_intraop_pool(int id) {
+  TaskThreadPoolBase* pool = named_intraop_pools[id].load();
+  if (C10_LIKELY(pool != nullptr)) {
+    return *pool;
+  }
+  std::lock_guard<std::mutex> guard(named_intraop_pools_mutex);
+  pool = named_intraop_pools[id].load();
+  if (pool == nullptr) {
+    // minus one because of the master thread, placed like the default pool
+    named_intraop_pool_owners.push_back(create_thread_pool(
+        internal::_get_intraop_pool_num_threads(id) - 1,
+        intraop_numa_node.load()));
+    pool = named_intraop_pool_owners.back().get();
+    named_intraop_pools[id].store(pool);
+  }
+  return *pool;
+}
+
+// The pool parallel regions of the calling thread run on
+TaskThreadPoolBase& _get_current_intraop_pool(int id) {
+  return id == 0 ? _get_intraop_pool() : _get_named_intraop_pool(id);
+}
+
 #endif // C10_MOBILE
 
-// Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
-// `fn` will be called with params: (thread_pool_task_id, task_id).
-void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
+// RAII guard helps to support in_parallel_region() and get_thread_num() API.
+// Restores the previous state, a thread can run a nested region inside a
+// task of another one.
+struct ParallelRegionGuard {
+  ParallelRegionGuard(int64_t task_id)
+      : prev_in_parallel_region_(in_parallel_region_),
+        prev_thread_num_(thread_num_) {
+    _set_thread_num(task_id);
+    _set_in_parallel_region(true);
+  }
+
+  ~ParallelRegionGuard() {
+    _set_in_parallel_region(prev_in_parallel_region_);
+    _set_thread_num(prev_thread_num_);
+  }
+
+ private:
+  bool prev_in_parallel_region_;
+  size_t prev_thread_num_;
+};
+
 #ifndef C10_MOBILE
-  for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+
+// A parallel region, shared by the thread that started it and the pool
+// tasks that help with it. Every participating thread takes tasks from
+// next_task until none are left, so the region never waits for a task that
+// has not started, and inner regions cannot deadlock. A helper may only
+// start after the region is finished and the caller returned, so the state
+// is reference counted, but f is only called while tasks are left.
+struct ParallelRegion {
+  const std::function<void(int64_t, int64_t, size_t)>* f;
+  int64_t begin;
+  int64_t end;
+  size_t chunk_size;
+  size_t num_tasks;
+  std::atomic<size_t> next_task{0};
+  std::atomic<size_t> remaining;
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  void run_tasks() {
+    size_t task_id;
+    while ((task_id = next_task++) < num_tasks) {
+      int64_t local_start = begin + task_id * chunk_size;
+      if (local_start < end) {
+        int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+        try {
+          ParallelRegionGuard guard(task_id);
+          (*f)(local_start, local_end, task_id);
+        } catch (...) {
+          if (!err_flag.test_and_set()) {
+            eptr = std::current_exception();
+          }
+        }
+      }
+      if (--remaining == 0) {
+        std::unique_lock<std::mutex> lk(mutex);
+        cv.notify_one();
+      }
+    }
   }
-  // Run the first task on the current thread directly.
-  fn(0, 0);
+};
+
+bool _is_work_stealing_pool() {
+  static const bool work_stealing =
+      dynamic_cast<c10::WorkStealingThreadPool*>(&_get_intraop_pool()) !=
+      nullptr;
+  return work_stealing;
+}
+
 #else
+
+// Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
+// `fn` will be called with params: (thread_pool_task_id, task_id).
+void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
   caffe2::PThreadPool* const pool = caffe2::pthreadpool();
   TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!");
 
@@ -96,21 +261,9 @@ void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
     [&fn](const size_t task_id) {
       fn(0 /* unused */, task_id);
     }, range);
-#endif // C10_MOBILE
 }
 
-// RAII guard helps to support in_parallel_region() and get_thread_num() API.
-struct ParallelRegionGuard {
-  ParallelRegionGuard(int64_t task_id) {
-    _set_thread_num(task_id);
-    _set_in_parallel_region(true);
-  }
-
-  ~ParallelRegionGuard() {
-    _set_in_parallel_region(false);
-    _unset_thread_num();
-  }
-};
+#endif // C10_MOBILE
 
 } // namespace
 
@@ -127,6 +280,43 @@ void _parallel_run(
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
 
+#ifndef C10_MOBILE
+  auto region = std::make_shared<ParallelRegion>();
+  region->f = &f;
+  region->begin = begin;
+  region->end = end;
+  region->chunk_size = chunk_size;
+  region->num_tasks = num_tasks;
+  region->remaining = num_tasks;
+
+  const int pool_id = internal::_get_intraop_pool_id();
+  auto& pool = _get_current_intraop_pool(pool_id);
+  size_t num_helpers = num_tasks - 1;
+  if (in_parallel_region()) {
+    // Only idle threads join a nested region, the others are busy with the
+    // enclosing one already.
+    num_helpers = std::min(num_helpers, pool.numAvailable());
+  }
+  for (size_t i = 0; i < num_helpers; ++i) {
+    pool.run([region, pool_id]() {
+      // The threads of a pool only run its tasks, nested regions stay on it.
+      internal::_set_intraop_pool_id(pool_id);
+      region->run_tasks();
+    });
+  }
+  region->run_tasks();
+
+  // Wait for the tasks other threads took to finish.
+  {
+    std::unique_lock<std::mutex> lk(region->mutex);
+    while (region->remaining != 0) {
+      region->cv.wait(lk);
+    }
+  }
+  if (region->eptr) {
+    std::rethrow_exception(region->eptr);
+  }
+#else
   struct {
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
@@ -169,6 +359,58 @@ void _parallel_run(
   if (state.eptr) {
     std::rethrow_exception(state.eptr);
   }
+#endif // C10_MOBILE
+}
+
+constexpr int64_t GrainSizeTuner::kAdaptiveTaskNs;
+
+bool _adaptive_grain_size_enabled() {
+  return adaptive_grain_size.load(std::memory_order_relaxed);
+}
+
+void _set_adaptive_grain_size(bool enabled) {
+  adaptive_grain_size.store(enabled);
+}
+
+int64_t GrainSizeTuner::grain_size(int64_t grain_size) const {
+  const double ns_per_element =
+      ns_per_element_.load(std::memory_order_relaxed);
+  if (ns_per_element <= 0) {
+    return grain_size;
+  }
+  // Bounded, so that very cheap elements do not overflow.
+  const double tuned = std::min(
+      std::ceil(kAdaptiveTaskNs / ns_per_element), (double)(int64_t{1} << 48));
+  return std::max((int64_t)tuned, (int64_t)1);
+}
+
+bool GrainSizeTuner::sample() {
+  const uint64_t calls = calls_.fetch_add(1, std::memory_order_relaxed);
+  return calls < kGrainSizeWarmupCalls ||
+      calls % kGrainSizeSampleInterval == 0;
+}
+
+void GrainSizeTuner::record(int64_t elements, int64_t ns) {
+  if (elements <= 0) {
+    return;
+  }
+  const double sample = std::max(ns, (int64_t)1) / (double)elements;
+  // Concurrent tasks may overwrite each other's update, which only loses a
+  // sample.
+  const double average = ns_per_element_.load(std::memory_order_relaxed);
+  ns_per_element_.store(
+      average == 0 ? sample : average + (sample - average) / 8,
+      std::memory_order_relaxed);
+}
+
+bool _can_nest_parallel_region() {
+#ifndef C10_MOBILE
+  return _is_work_stealing_pool() &&
+      _get_current_intraop_pool(internal::_get_intraop_pool_id())
+          .numAvailable() > 0;
+#else
+  return false;
+#endif // C10_MOBILE
 }
 
 } // namespace internal
@@ -215,6 +457,10 @@ void set_num_threads(int nthreads) {
 
 int get_num_threads() {
 #ifndef C10_MOBILE
+  const int pool_id = internal::_get_intraop_pool_id();
+  if (pool_id != 0) {
+    return internal::_get_intraop_pool_num_threads(pool_id);
+  }
   // not initializing pool unnecessarily,
   // because pool cannot be resized after initialization
   int nthreads = num_intraop_threads.load();
@@ -233,16 +479,56 @@ int get_num_threads() {
 #endif // C10_MOBILE
 }
 
+void set_intraop_numa_node(int numa_node_id) {
+  TORCH_CHECK(numa_node_id >= 0, "Expected a non-negative NUMA node id");
+#ifndef C10_MOBILE
+  TORCH_CHECK(num_intraop_threads.load() != CONSUMED,
+      "Cannot set the NUMA node of intraop threads "
+      "after parallel work has started when using native parallel backend");
+#endif // C10_MOBILE
+  c10::NUMABind(numa_node_id);
+  intraop_numa_node.store(numa_node_id);
+}
+
+int get_intraop_numa_node() {
+  return c10::IsNUMAEnabled() ? intraop_numa_node.load() : -1;
+}
+
+void set_intraop_cpus(const std::vector<int>& cpus) {
+#ifndef C10_MOBILE
+  TORCH_CHECK(num_intraop_threads.load() != CONSUMED,
+      "Cannot set the CPUs of intraop threads "
+      "after parallel work has started when using native parallel backend");
+#endif // C10_MOBILE
+  internal::check_cpus(cpus);
+#ifndef C10_MOBILE
+  c10::SetThreadAffinity({cpus[0]});
+#else
+  // The pthreadpool threads cannot be pinned.
+  c10::SetThreadAffinity(cpus);
+  TORCH_WARN_ONCE(
+      "set_intraop_cpus only pins the calling thread on mobile");
+#endif // C10_MOBILE
+  std::lock_guard<std::mutex> guard(intraop_cpus_mutex);
+  intraop_cpus = cpus;
+}
+
+std::vector<int> get_intraop_cpus() {
+  std::lock_guard<std::mutex> guard(intraop_cpus_mutex);
+  return intraop_cpus;
+}
+
 int get_thread_num() {
   return thread_num_;
 }
 
 bool in_parallel_region() {
 #ifndef C10_MOBILE
+  const int pool_id = internal::_get_intraop_pool_id();
   return in_parallel_region_ || (
-    num_intraop_threads.load() == CONSUMED &&
+    (pool_id != 0 || num_intraop_threads.load() == CONSUMED) &&
     // Needed as intraop_launch() doesn't set in_parallel_region().
-    _get_intraop_pool().inThreadPool()
+    _get_current_intraop_pool(pool_id).inThreadPool()
   );
 #else
   return in_parallel_region_;
@@ -252,7 +538,11 @@ bool in_parallel_region() {
 void intraop_launch(std::function<void()> func) {
 #ifndef C10_MOBILE
   if (!in_parallel_region() && get_num_threads() > 1) {
-    _get_intraop_pool().run(func);
+    const int pool_id = internal::_get_intraop_pool_id();
+    _get_current_intraop_pool(pool_id).run([func, pool_id]() {
+      internal::_set_intraop_pool_id(pool_id);
+      func();
+    });
   } else {
     // execute inline if we're in parallel region
     func();
@@ -269,8 +559,10 @@ std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 #ifndef C10_MOBILE
   auto future = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
   if (!in_parallel_region() && get_num_threads() > 1) {
-    _get_intraop_pool().run(
-      [func, future]() {
+    const int pool_id = internal::_get_intraop_pool_id();
+    _get_current_intraop_pool(pool_id).run(
+      [func, future, pool_id]() {
+        internal::_set_intraop_pool_id(pool_id);
         func();
         future->markCompleted();
       }
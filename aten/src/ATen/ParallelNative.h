@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <exception>
 
@@ -28,19 +30,93 @@ CAFFE2_API void _parallel_run(
   const int64_t grain_size,
   const std::function<void(int64_t, int64_t, size_t)>& f);
 
+// Whether a parallel region started inside another one can use idle
+// intra-op threads, only with the work-stealing thread pool.
+CAFFE2_API bool _can_nest_parallel_region();
+
+// Adaptive grain size: with PYTORCH_ADAPTIVE_GRAIN_SIZE=1, or after
+// _set_adaptive_grain_size(true), every parallel_for and parallel_reduce
+// call site measures how long its elements take, and replaces the grain
+// size it passes with one that makes every task run for about
+// kAdaptiveTaskNs.
+CAFFE2_API bool _adaptive_grain_size_enabled();
+CAFFE2_API void _set_adaptive_grain_size(bool enabled);
+
+// Timing statistics of one call site.
+class CAFFE2_API GrainSizeTuner {
+ public:
+  // Long enough to hide the cost of handing a task to another thread.
+  static constexpr int64_t kAdaptiveTaskNs = 50000;
+
+  // The grain size to use, grain_size until the first measurement.
+  int64_t grain_size(int64_t grain_size) const;
+  // Whether to time the next call, all of the first calls and then a
+  // sample, which keeps reading the clock off the path of tiny calls.
+  bool sample();
+  void record(int64_t elements, int64_t ns);
+
+ private:
+  std::atomic<uint64_t> calls_{0};
+  // moving average, 0 until the first measurement
+  std::atomic<double> ns_per_element_{0};
+};
+
+// Times a range of elements for tuner, does nothing without a tuner.
+class GrainSizeTimer {
+ public:
+  GrainSizeTimer(GrainSizeTuner* tuner, int64_t elements)
+      : tuner_(tuner), elements_(elements) {
+    if (tuner_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~GrainSizeTimer() {
+    if (tuner_ != nullptr) {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_);
+      tuner_->record(elements_, ns.count());
+    }
+  }
+
+ private:
+  GrainSizeTuner* tuner_;
+  int64_t elements_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// The tuner of the calling parallel_for or parallel_reduce, nullptr unless
+// the adaptive grain size is enabled. One per call site, as every lambda
+// has its own type.
+template <class F>
+inline GrainSizeTuner* _call_site_tuner() {
+  if (C10_LIKELY(!_adaptive_grain_size_enabled())) {
+    return nullptr;
+  }
+  static GrainSizeTuner tuner;
+  return &tuner;
+}
+
 } // namespace internal
 
 template <class F>
 inline void parallel_for(
     const int64_t begin,
     const int64_t end,
-    const int64_t grain_size,
+    int64_t grain_size,
     const F& f) {
   TORCH_CHECK(grain_size >= 0);
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  internal::GrainSizeTuner* timed = nullptr;
+  if (auto tuner = internal::_call_site_tuner<F>()) {
+    grain_size = tuner->grain_size(grain_size);
+    timed = tuner->sample() ? tuner : nullptr;
+  }
+  if ((end - begin) < grain_size ||
+      (in_parallel_region() && !internal::_can_nest_parallel_region())) {
+    internal::GrainSizeTimer timer(timed, end - begin);
     f(begin, end);
     return;
   }
@@ -48,7 +124,8 @@ inline void parallel_for(
       begin,
       end,
       grain_size,
-      [f](int64_t start, int64_t end, size_t /* unused */) {
+      [f, timed](int64_t start, int64_t end, size_t /* unused */) {
+        internal::GrainSizeTimer timer(timed, end - start);
         f(start, end);
       }
   );
@@ -58,7 +135,7 @@ template <class scalar_t, class F, class SF>
 inline scalar_t parallel_reduce(
     const int64_t begin,
     const int64_t end,
-    const int64_t grain_size,
+    int64_t grain_size,
     const scalar_t ident,
     const F& f,
     const SF& sf) {
@@ -66,7 +143,14 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  internal::GrainSizeTuner* timed = nullptr;
+  if (auto tuner = internal::_call_site_tuner<F>()) {
+    grain_size = tuner->grain_size(grain_size);
+    timed = tuner->sample() ? tuner : nullptr;
+  }
+  if ((end - begin) < grain_size ||
+      (in_parallel_region() && !internal::_can_nest_parallel_region())) {
+    internal::GrainSizeTimer timer(timed, end - begin);
     return f(begin, end, ident);
   }
   size_t num_tasks, chunk_size;
@@ -78,7 +162,9 @@ inline scalar_t parallel_reduce(
       begin,
       end,
       grain_size,
-      [f, ident, results_data](int64_t start, int64_t end, size_t task_id) {
+      [f, ident, results_data, timed](
+          int64_t start, int64_t end, size_t task_id) {
+        internal::GrainSizeTimer timer(timed, end - start);
         results_data[task_id] = f(start, end, ident);
       }
   );
@@ -27,6 +27,8 @@ static thread_local tbb::task_group tg_;
 std::mutex global_thread_mutex_;
 std::shared_ptr<tbb::global_control> global_thread_limit_ = nullptr;
 std::atomic<int> num_intraop_threads_{-1};
+std::atomic<int> intraop_numa_node_{-1};
+std::vector<int> intraop_cpus_;
 
 void _internal_set_num_threads(int nthreads) {
   TORCH_INTERNAL_ASSERT(nthreads > 0);
@@ -69,6 +71,38 @@ int get_num_threads() {
   return tbb::this_task_arena::max_concurrency();
 }
 
+void set_intraop_numa_node(int numa_node_id) {
+  TORCH_CHECK(numa_node_id >= 0, "Expected a non-negative NUMA node id");
+  c10::NUMABind(numa_node_id);
+  intraop_numa_node_.store(numa_node_id);
+  if (c10::IsNUMAEnabled()) {
+    TORCH_WARN_ONCE(
+        "set_intraop_numa_node only binds the calling thread "
+        "when using TBB parallel backend");
+  }
+}
+
+int get_intraop_numa_node() {
+  return c10::IsNUMAEnabled() ? intraop_numa_node_.load() : -1;
+}
+
+void set_intraop_cpus(const std::vector<int>& cpus) {
+  internal::check_cpus(cpus);
+  c10::SetThreadAffinity(cpus);
+  {
+    std::lock_guard<std::mutex> guard(global_thread_mutex_);
+    intraop_cpus_ = cpus;
+  }
+  TORCH_WARN_ONCE(
+      "set_intraop_cpus only pins the calling thread "
+      "when using TBB parallel backend");
+}
+
+std::vector<int> get_intraop_cpus() {
+  std::lock_guard<std::mutex> guard(global_thread_mutex_);
+  return intraop_cpus_;
+}
+
 int get_thread_num() {
   return tbb::this_task_arena::current_thread_index();
 }
@@ -1,8 +1,12 @@
 #include <ATen/Config.h>
 #if AT_PARALLEL_OPENMP
 #include <ATen/Parallel.h>
+#include <ATen/PTThreadPool.h>
+#include <c10/util/cpu_affinity.h>
+#include <c10/util/numa.h>
 
 #include <atomic>
+#include <mutex>
 
 #ifdef TH_BLAS_MKL
 #include <mkl.h>
@@ -14,6 +18,13 @@ namespace {
 // Number of threads set by the user
 std::atomic<int> num_threads{-1};
 
+// NUMA node the intra-op threads are bound to, -1 if none
+std::atomic<int> intraop_numa_node{-1};
+
+// CPUs the intra-op threads are pinned to, empty if none
+std::mutex intraop_cpus_mutex;
+std::vector<int> intraop_cpus;
+
 } // namespace
 
 void init_num_threads() {
@@ -63,6 +74,44 @@ int get_num_threads() {
 #endif
 }
 
+void set_intraop_numa_node(int numa_node_id) {
+  TORCH_CHECK(numa_node_id >= 0, "Expected a non-negative NUMA node id");
+  // Binding the calling thread first also validates the node id, nothing
+  // may throw inside the parallel region below.
+  c10::NUMABind(numa_node_id);
+  intraop_numa_node.store(numa_node_id);
+#ifdef _OPENMP
+  // The OpenMP runtime keeps the threads of a team alive, so binding each of
+  // them once sticks for the later parallel regions of this thread.
+  if (c10::IsNUMAEnabled()) {
+#pragma omp parallel
+    c10::NUMABind(numa_node_id);
+  }
+#endif
+}
+
+int get_intraop_numa_node() {
+  return c10::IsNUMAEnabled() ? intraop_numa_node.load() : -1;
+}
+
+void set_intraop_cpus(const std::vector<int>& cpus) {
+  internal::check_cpus(cpus);
+  c10::SetThreadAffinity({cpus[0]});
+#ifdef _OPENMP
+  // Like the NUMA binding above, sticks to the threads of the team. The
+  // calling thread is thread 0.
+#pragma omp parallel
+  c10::SetThreadAffinity({cpus[omp_get_thread_num() % cpus.size()]});
+#endif
+  std::lock_guard<std::mutex> guard(intraop_cpus_mutex);
+  intraop_cpus = cpus;
+}
+
+std::vector<int> get_intraop_cpus() {
+  std::lock_guard<std::mutex> guard(intraop_cpus_mutex);
+  return intraop_cpus;
+}
+
 int get_thread_num() {
 #ifdef _OPENMP
   return omp_get_thread_num();
@@ -3,8 +3,12 @@
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
 #include <ATen/ThreadLocalState.h>
+#include <c10/util/cpu_affinity.h>
 
 #include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
 
 namespace at {
 
@@ -19,18 +23,72 @@ const int CONSUMED = -2;
 // NOT_SET -> CONSUMED
 std::atomic<int> num_interop_threads{NOT_SET};
 
+// CPUs the inter-op threads are pinned to, empty if none
+std::mutex interop_cpus_mutex;
+std::vector<int> interop_cpus;
+
+std::vector<int> interop_cpus_from_env() {
+  const char* value = std::getenv("PYTORCH_INTEROP_CPUS");
+  if (value == nullptr || strcmp(value, "") == 0) {
+    return {};
+  }
+  try {
+    auto cpus = c10::ParseCPUList(value);
+    internal::check_cpus(cpus);
+    return cpus;
+  } catch (const c10::Error& e) {
+    TORCH_WARN("Ignoring PYTORCH_INTEROP_CPUS: ", e.msg());
+    return {};
+  }
+}
+
+std::shared_ptr<TaskThreadPoolBase> create_interop_pool() {
+  int pool_size = num_interop_threads.exchange(CONSUMED);
+  std::vector<int> cpus;
+  {
+    std::lock_guard<std::mutex> guard(interop_cpus_mutex);
+    if (interop_cpus.empty()) {
+      interop_cpus = interop_cpus_from_env();
+    }
+    cpus = interop_cpus;
+  }
+  if (!cpus.empty()) {
+    // the registry creators take no CPUs
+    return create_thread_pool(pool_size, -1, cpus);
+  }
+  return ThreadPoolRegistry()->Create(
+      "C10",
+      /* device_id */ 0,
+      /* pool_size */ pool_size,
+      /* create_new */ true);
+}
+
 // thread pool global instance is hidden,
 // users should use at::launch and get/set_num_interop_threads interface
 TaskThreadPoolBase& get_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ num_interop_threads.exchange(CONSUMED),
-          /* create_new */ true);
+  static std::shared_ptr<TaskThreadPoolBase> pool = create_interop_pool();
   return *pool;
 }
 
+bool use_work_stealing_thread_pool() {
+  static const bool enabled = []() {
+    const char* value = std::getenv("PYTORCH_THREAD_POOL");
+    if (value == nullptr || strcmp(value, "") == 0 ||
+        strcmp(value, "default") == 0) {
+      return false;
+    }
+    if (strcmp(value, "work_stealing") == 0) {
+      return true;
+    }
+    TORCH_WARN(
+        "Ignoring invalid PYTORCH_THREAD_POOL value ",
+        value,
+        ", expected default or work_stealing");
+    return false;
+  }();
+  return enabled;
+}
+
 // Factory function for ThreadPoolRegistry
 std::shared_ptr<TaskThreadPoolBase> create_c10_threadpool(
     int device_id,
@@ -40,13 +98,37 @@ std::shared_ptr<TaskThreadPoolBase> create_c10_threadpool(
   TORCH_CHECK(device_id == 0);
   // Create new thread pool
   TORCH_CHECK(create_new);
-  return std::make_shared<PTThreadPool>(pool_size);
+  return create_thread_pool(pool_size);
 }
 
 } // namespace
 
+std::shared_ptr<TaskThreadPoolBase> create_thread_pool(
+    int pool_size,
+    int numa_node_id,
+    std::vector<int> cpus) {
+  if (use_work_stealing_thread_pool()) {
+    return std::make_shared<PTWorkStealingThreadPool>(
+        pool_size, numa_node_id, std::move(cpus));
+  }
+  return std::make_shared<PTThreadPool>(
+      pool_size, numa_node_id, std::move(cpus));
+}
+
 C10_REGISTER_CREATOR(ThreadPoolRegistry, C10, create_c10_threadpool);
 
+namespace internal {
+void check_cpus(const std::vector<int>& cpus) {
+  TORCH_CHECK(!cpus.empty(), "Expected a non-empty list of CPUs");
+  auto prev_affinity = c10::GetThreadAffinity();
+  for (int cpu : cpus) {
+    TORCH_CHECK(
+        c10::SetThreadAffinity({cpu}), "Cannot pin threads to CPU ", cpu);
+  }
+  c10::SetThreadAffinity(prev_affinity);
+}
+} // namespace internal
+
 void set_num_interop_threads(int nthreads) {
   TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
 
@@ -56,6 +138,20 @@ void set_num_interop_threads(int nthreads) {
       "has started or set_num_interop_threads called");
 }
 
+void set_interop_cpus(const std::vector<int>& cpus) {
+  TORCH_CHECK(num_interop_threads.load() != CONSUMED,
+      "Error: cannot set the CPUs of interop threads after parallel work "
+      "has started");
+  internal::check_cpus(cpus);
+  std::lock_guard<std::mutex> guard(interop_cpus_mutex);
+  interop_cpus = cpus;
+}
+
+std::vector<int> get_interop_cpus() {
+  std::lock_guard<std::mutex> guard(interop_cpus_mutex);
+  return interop_cpus;
+}
+
 int get_num_interop_threads() {
   int nthreads = num_interop_threads.load();
   if (nthreads > 0) {
@@ -76,6 +172,14 @@ void launch_no_thread_state(std::function<void()> fn) {
   get_pool().run(std::move(fn));
 #endif
 }
+
+bool _interop_pool_has_idle_threads() {
+#if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
+  return false;
+#else
+  return get_pool().numAvailable() > 0;
+#endif
+}
 } // namespace internal
 
 void launch(std::function<void()> func) {
@@ -113,6 +113,31 @@ void SparseTensorImpl::set_indices_and_values_unsafe(const Tensor& indices, cons
   AT_ASSERT(values_.device() == indices_.device());
 
   coalesced_ = false;
+  clear_csr();
+}
+
+SparseCSR SparseTensorImpl::csr(
+    ScalarType index_type,
+    const std::function<SparseCSR(const Tensor& indices)>& build) const {
+  TORCH_INTERNAL_ASSERT(sparse_dim_ == 2 && dense_dim_ == 0);
+  // In-place ops bump the version of the tensor they modify, that is the
+  // version of this tensor for its own in-place ops and the version of the
+  // indices for the ops on them.
+  const uint32_t version = version_counter().current_version();
+  const uint32_t indices_version =
+      indices_.unsafeGetTensorImpl()->version_counter().current_version();
+  std::lock_guard<std::mutex> guard(csr_mutex_);
+  if (!csr_indices_.is_same(indices_) || !sizes().equals(csr_sizes_) ||
+      csr_version_ != version || csr_indices_version_ != indices_version ||
+      csr_.crow_indices.scalar_type() != index_type) {
+    csr_ = build(indices_);
+    TORCH_INTERNAL_ASSERT(csr_.crow_indices.scalar_type() == index_type);
+    csr_indices_ = indices_;
+    csr_sizes_ = sizes().vec();
+    csr_version_ = version;
+    csr_indices_version_ = indices_version;
+  }
+  return csr_;
 }
 
 
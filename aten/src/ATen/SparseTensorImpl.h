@@ -4,7 +4,20 @@
 #include <c10/core/TensorImpl.h>
 #include <c10/util/Exception.h>
 
+#include <functional>
+#include <mutex>
+
 namespace at {
+
+// Compressed sparse row form of the indices of a 2-D sparse tensor
+struct SparseCSR {
+  Tensor crow_indices; // size(0) + 1 row pointers into col_indices
+  Tensor col_indices; // the column of every entry, in row order
+  // The position of every entry in indices and values, undefined when the
+  // entries already are in row order
+  Tensor permutation;
+};
+
 struct CAFFE2_API SparseTensorImpl : public TensorImpl {
   // Stored in COO format, indices + values.
 
@@ -29,6 +42,15 @@ struct CAFFE2_API SparseTensorImpl : public TensorImpl {
   // because many algorithms proceed by merging two sorted lists (of indices).
   bool coalesced_ = false;
 
+  // The CSR form is cached with the indices, sizes and versions it was
+  // built from, see csr()
+  mutable std::mutex csr_mutex_;
+  mutable SparseCSR csr_;
+  mutable Tensor csr_indices_;
+  mutable std::vector<int64_t> csr_sizes_;
+  mutable uint32_t csr_version_ = 0;
+  mutable uint32_t csr_indices_version_ = 0;
+
 public:
   // Public for now...
   explicit SparseTensorImpl(at::DispatchKeySet, const caffe2::TypeMeta&);
@@ -56,7 +78,7 @@ public:
   // respect to indices and values
   void raw_resize_(int64_t sparse_dim, int64_t dense_dim, IntArrayRef size) {
     TORCH_CHECK(allow_tensor_metadata_change(), "raw_resize_ ", err_msg_tensor_metadata_change_not_allowed);
-    sizes_ = size.vec();
+    sizes_and_strides_.set_sizes(size);
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
     refresh_numel();
@@ -126,7 +148,7 @@ public:
         "shrinking the size of dense dimensions (from ", dense_size_original, " to ", dense_size_new, ") on a non-empty sparse tensor is not supported.\n", alt_options_msg);
     }
 
-    if ((!size.equals(sizes_)) || (sparse_dim != sparse_dim_) || (dense_dim != dense_dim_)) {
+    if ((!size.equals(sizes_and_strides_.sizes_arrayref())) || (sparse_dim != sparse_dim_) || (dense_dim != dense_dim_)) {
       auto nnz = values().size(0);
       std::vector<int64_t> values_size = {nnz};
       auto dense_size = size.slice(sparse_dim);
@@ -135,7 +157,7 @@ public:
       indices_.resize_({sparse_dim, nnz});
     }
 
-    sizes_ = size.vec();
+    sizes_and_strides_.set_sizes(size);
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
     refresh_numel();
@@ -146,7 +168,7 @@ public:
     TORCH_CHECK(allow_tensor_metadata_change(), "resize_and_clear_ ", err_msg_tensor_metadata_change_not_allowed);
     TORCH_CHECK(sparse_dim + dense_dim == static_cast<int64_t>(size.size()), "number of dimensions must be sparse_dim (", sparse_dim, ") + dense_dim (", dense_dim, "), but got ", size.size());
 
-    sizes_ = size.vec();
+    sizes_and_strides_.set_sizes(size);
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
 
@@ -170,6 +192,7 @@ public:
     AT_ASSERT(new_nnz <= nnz());
     indices_ = indices_.narrow(1, 0, new_nnz);
     values_ = values_.narrow(0, 0, new_nnz);
+    clear_csr();
   }
 
   // Takes indices and values and directly puts them into the sparse tensor, no copy.
@@ -181,6 +204,14 @@ public:
   // make it happen
   void set_indices_and_values_unsafe(const Tensor& indices, const Tensor& values);
 
+  // Returns the CSR form of the indices of a 2-D tensor, with index_type
+  // indices. It is built by build from the indices on the first call, and
+  // again once the tensor or its indices are modified, so that repeated
+  // products with the same matrix convert it only once.
+  SparseCSR csr(
+      ScalarType index_type,
+      const std::function<SparseCSR(const Tensor& indices)>& build) const;
+
   /**
    * Return a TensorImpl that is a shallow-copy of this TensorImpl.
    *
@@ -239,6 +270,12 @@ private:
     dest_sparse_impl->values_ = src_sparse_impl->values();
     dest_sparse_impl->coalesced_ = src_sparse_impl->coalesced();
   }
+
+  void clear_csr() {
+    std::lock_guard<std::mutex> guard(csr_mutex_);
+    csr_ = SparseCSR();
+    csr_indices_.reset();
+  }
 };
 
 } // namespace at
@@ -4,6 +4,7 @@
 #include <ATen/core/grad_mode.h>
 #endif
 
+#include <ATen/Parallel.h>
 #include <ATen/record_function.h>
 
 namespace at {
@@ -11,7 +12,8 @@ namespace at {
 ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
     : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
       debug_info_(c10::ThreadLocalDebugInfo::current()),
-      observers_enabled_(at::isRecordFunctionEnabled()) {
+      observers_enabled_(at::isRecordFunctionEnabled()),
+      intraop_pool_id_(at::internal::_get_intraop_pool_id()) {
   callbacks_ = _getTLSCallbacks();
 
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
@@ -35,6 +37,8 @@ void ThreadLocalState::setThreadLocalState(
 
   at::enableRecordFunction(state.observers_enabled_);
 
+  at::internal::_set_intraop_pool_id(state.intraop_pool_id_);
+
   c10::ThreadLocalDebugInfo::_forceCurrentDebugInfo(state.debug_info_);
 
   c10::impl::_force_tls_local_dispatch_key_set(state.dispatch_key_);
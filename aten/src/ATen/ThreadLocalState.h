@@ -35,6 +35,9 @@ class TORCH_API ThreadLocalState {
 
   bool observers_enabled_ = false;
 
+  // Named intra-op pool, see at::IntraopPoolGuard
+  int intraop_pool_id_ = 0;
+
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
   bool keep_grad_mode_ = true;
   bool grad_mode_enabled_;
@@ -0,0 +1,158 @@
+// The ops of benchmarks/operator_benchmark/pt on the same shapes, called
+// through the ATen C++ API. Unlike the Python suite these do not pay for the
+// Python bindings, so that regressions of the kernels and the dispatcher show
+// on small shapes too. Run with --benchmark_format=json, or
+// --benchmark_out=<file> --benchmark_out_format=json, to track the results.
+
+#include <ATen/ATen.h>
+#include <ATen/benchmarks/operator_benchmark_configs.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// cat_test.py
+static void cat(
+    benchmark::State& state,
+    const std::vector<int64_t>& sizes,
+    int64_t num_inputs,
+    int64_t dim) {
+  std::vector<at::Tensor> inputs;
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    inputs.push_back(at::rand(sizes));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::cat(inputs, dim));
+  }
+}
+
+BENCHMARK_CAPTURE(cat, sizes_1_1_1_N2_dim0, {1, 1, 1}, 2, 0);
+BENCHMARK_CAPTURE(cat, sizes_512_512_2_N2_dim1, {512, 512, 2}, 2, 1);
+BENCHMARK_CAPTURE(cat, sizes_128_1024_2_N2_dim1, {128, 1024, 2}, 2, 1);
+BENCHMARK_CAPTURE(cat, sizes_1024_1024_2_N2_dim0, {1024, 1024, 2}, 2, 0);
+BENCHMARK_CAPTURE(cat, sizes_1025_1023_2_N2_dim1, {1025, 1023, 2}, 2, 1);
+BENCHMARK_CAPTURE(cat, sizes_1024_1024_2_N2_dim2, {1024, 1024, 2}, 2, 2);
+BENCHMARK_CAPTURE(cat, sizes_64_32_4_16_32_N2_dim2, {64, 32, 4, 16, 32}, 2, 2);
+BENCHMARK_CAPTURE(cat, sizes_16_32_4_16_32_N8_dim2, {16, 32, 4, 16, 32}, 8, 2);
+BENCHMARK_CAPTURE(cat, sizes_9_31_5_15_33_N17_dim4, {9, 31, 5, 15, 33}, 17, 4);
+
+// gather_test.py
+static void gather(benchmark::State& state) {
+  const int64_t m = state.range(0);
+  const int64_t n = state.range(1);
+  const int64_t dim = state.range(2);
+
+  at::Tensor input = at::rand({m, n});
+  at::Tensor index = at::randint(dim == 0 ? m : n, {m, n}, at::kLong);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::gather(input, dim, index));
+  }
+}
+
+static void GatherConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "dim"});
+  b->Args({256, 512, 0});
+  b->Args({512, 512, 1});
+  for (int64_t m : {128, 1024}) {
+    for (int64_t n : {128, 1024}) {
+      for (int64_t dim : {0, 1}) {
+        b->Args({m, n, dim});
+      }
+    }
+  }
+}
+
+BENCHMARK(gather)->Apply(GatherConfigs);
+
+// embeddingbag_test.py
+static void embedding_bag(benchmark::State& state) {
+  const int64_t embeddingbags = state.range(0);
+  const int64_t dim = state.range(1);
+  const int64_t input_size = state.range(2);
+  const bool include_last_offset = state.range(3);
+
+  at::Tensor weight = at::randn({embeddingbags, dim});
+  at::Tensor indices = at::randint(embeddingbags, {input_size}, at::kLong);
+  at::Tensor offsets = at::tensor({int64_t{0}, input_size}, at::kLong);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::embedding_bag(
+        weight,
+        indices,
+        offsets,
+        /*scale_grad_by_freq=*/false,
+        /*mode=sum*/ 0,
+        /*sparse=*/true,
+        /*per_sample_weights=*/{},
+        include_last_offset));
+  }
+}
+
+BENCHMARK(embedding_bag)->Apply(EmbeddingBagShortConfigs);
+
+// softmax_test.py: Softmax and Softmax2d both reduce over the channels
+static void SoftmaxConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "H", "W"});
+  b->Args({1, 3, 256, 256});
+  b->Args({4, 3, 256, 256});
+  for (int64_t n : {8, 16}) {
+    for (int64_t h : {256, 512}) {
+      for (int64_t w : {256, 512}) {
+        b->Args({n, 3, h, w});
+      }
+    }
+  }
+}
+
+static void softmax(benchmark::State& state) {
+  at::Tensor input = at::rand(
+      {state.range(0), state.range(1), state.range(2), state.range(3)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::softmax(input, 1));
+  }
+}
+
+static void log_softmax(benchmark::State& state) {
+  at::Tensor input = at::rand(
+      {state.range(0), state.range(1), state.range(2), state.range(3)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::log_softmax(input, 1));
+  }
+}
+
+BENCHMARK(softmax)->Apply(SoftmaxConfigs);
+BENCHMARK(log_softmax)->Apply(SoftmaxConfigs);
+
+// layernorm_test.py
+static void layer_norm(benchmark::State& state, const std::vector<int64_t>& dims) {
+  at::Tensor input = (at::rand(dims) - 0.5) * 256;
+  const std::vector<int64_t> normalized_shape(dims.begin() + 1, dims.end());
+  at::Tensor weight = at::rand(normalized_shape);
+  at::Tensor bias = at::rand(normalized_shape);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        at::layer_norm(input, normalized_shape, weight, bias, 1e-5));
+  }
+}
+
+BENCHMARK_CAPTURE(layer_norm, dims_1_8_16, {1, 8, 16});
+BENCHMARK_CAPTURE(layer_norm, dims_8_8_16, {8, 8, 16});
+BENCHMARK_CAPTURE(layer_norm, dims_32_8_16, {32, 8, 16});
+BENCHMARK_CAPTURE(layer_norm, dims_64_128_56_56, {64, 128, 56, 56});
+
+// linear_test.py
+static void linear(benchmark::State& state) {
+  const int64_t n = state.range(0);
+  const int64_t in = state.range(1);
+  const int64_t out = state.range(2);
+
+  at::Tensor input = at::rand({n, in});
+  at::Tensor weight = at::rand({out, in});
+  at::Tensor bias = at::rand({out});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::linear(input, weight, bias));
+  }
+}
+
+BENCHMARK(linear)->Apply(LinearConfigs);
+
+BENCHMARK_MAIN();
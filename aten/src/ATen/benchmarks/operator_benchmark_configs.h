@@ -0,0 +1,37 @@
+#pragma once
+
+// Shapes shared by multiple op benchmarks, as in
+// benchmarks/operator_benchmark/pt/configs.py, so that the C++ results can be
+// compared with the Python ones config by config. Only the CPU configs are
+// kept.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+// linear_configs_short + linear_configs_long
+static void LinearConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "IN", "OUT"});
+  b->Args({1, 1, 1});
+  b->Args({4, 256, 128});
+  b->Args({16, 512, 256});
+  for (int64_t n : {32, 64}) {
+    for (int64_t in : {128, 512}) {
+      for (int64_t out : {64, 128}) {
+        b->Args({n, in, out});
+      }
+    }
+  }
+}
+
+// embeddingbag_short_configs, with mode=sum, offset=0 and dim=64
+static void EmbeddingBagShortConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"embeddingbags", "dim", "input_size", "include_last_offset"});
+  for (int64_t embeddingbags : {10, 120, 1000, 2300}) {
+    for (int64_t input_size : {8, 16, 64}) {
+      for (int64_t include_last_offset : {1, 0}) {
+        b->Args({embeddingbags, 64, input_size, include_last_offset});
+      }
+    }
+  }
+}
@@ -0,0 +1,224 @@
+// The quantized ops of benchmarks/operator_benchmark/pt on the same shapes,
+// called through the ATen C++ API and the dispatcher. See
+// operator_benchmark.cpp.
+
+#include <ATen/ATen.h>
+#include <ATen/benchmarks/operator_benchmark_configs.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <ATen/native/quantized/cpu/packed_params.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+
+// The dtype arguments of the benchmarks index into these.
+const c10::ScalarType kQTypes[] = {at::kQUInt8, at::kQInt8, at::kQInt32};
+
+// The quantized ops have no at:: functions, they are looked up once.
+template <typename FuncType>
+c10::TypedOperatorHandle<FuncType> quantizedOp(const char* name) {
+  return c10::Dispatcher::singleton()
+      .findSchemaOrThrow(name, "")
+      .typed<FuncType>();
+}
+
+c10::intrusive_ptr<LinearPackedParamsBase> prepackLinearWeight(
+    int64_t in,
+    int64_t out) {
+  static const auto op = quantizedOp<c10::intrusive_ptr<LinearPackedParamsBase>(
+      at::Tensor, c10::optional<at::Tensor>)>("quantized::linear_prepack");
+  at::Tensor qweight = at::quantize_per_tensor(
+      at::randn({out, in}), 1.0 / 255, 0, at::kQInt8);
+  return op.call(qweight, c10::nullopt);
+}
+
+// Makes the last dimension the outermost one in memory.
+at::Tensor nonContiguous(const at::Tensor& qx) {
+  std::vector<int64_t> permute_dims;
+  for (int64_t d = qx.dim() - 1; d >= 0; --d) {
+    permute_dims.push_back(d);
+  }
+  return qx.permute(permute_dims).contiguous().permute(permute_dims);
+}
+
+} // namespace
+
+// qlinear_test.py: QLinear
+static void qlinear(benchmark::State& state) {
+  static const auto op = quantizedOp<at::Tensor(
+      at::Tensor,
+      const c10::intrusive_ptr<LinearPackedParamsBase>&,
+      double,
+      int64_t)>("quantized::linear");
+  const int64_t n = state.range(0);
+  const int64_t in = state.range(1);
+  const int64_t out = state.range(2);
+
+  at::Tensor qinput =
+      at::quantize_per_tensor(at::randn({n, in}), 1.0 / 255, 0, at::kQUInt8);
+  const auto packed_weight = prepackLinearWeight(in, out);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(qinput, packed_weight, 1.0 / 255, 0));
+  }
+}
+
+// qlinear_test.py: QDynamicLinear
+static void qlinear_dynamic(benchmark::State& state) {
+  static const auto op = quantizedOp<at::Tensor(
+      at::Tensor, const c10::intrusive_ptr<LinearPackedParamsBase>&, bool)>(
+      "quantized::linear_dynamic");
+  const int64_t n = state.range(0);
+  const int64_t in = state.range(1);
+  const int64_t out = state.range(2);
+
+  at::Tensor input = at::randn({n, in});
+  const auto packed_weight = prepackLinearWeight(in, out);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        op.call(input, packed_weight, /*reduce_range=*/true));
+  }
+}
+
+BENCHMARK(qlinear)->Apply(LinearConfigs);
+BENCHMARK(qlinear_dynamic)->Apply(LinearConfigs);
+
+// qcat_test.py, with contig 0 for none, 1 for one and 2 for all of the inputs
+static void qcat(benchmark::State& state) {
+  static const auto op = quantizedOp<at::Tensor(
+      const c10::List<at::Tensor>&,
+      int64_t,
+      c10::optional<double>,
+      c10::optional<int64_t>)>("quantized::cat");
+  const int64_t m = state.range(0);
+  const int64_t n = state.range(1);
+  const int64_t k = state.range(2);
+  const int64_t dim = state.range(3);
+  const int64_t contig = state.range(4);
+  const auto dtype = kQTypes[state.range(5)];
+
+  at::Tensor qinput = at::quantize_per_tensor(
+      (at::rand({m, n, k}) - 0.5) * 256, 1.0, 0, dtype);
+  at::Tensor qinput_non_contig = nonContiguous(qinput);
+  const c10::List<at::Tensor> inputs({
+      contig == 0 ? qinput_non_contig : qinput,
+      contig == 2 ? qinput : qinput_non_contig,
+  });
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(inputs, dim, 1.0, 0));
+  }
+}
+
+static void QCatConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "dim", "contig", "dtype"});
+  for (int64_t contig : {2, 1, 0}) {
+    for (int64_t dtype : {0, 1, 2}) {
+      b->Args({256, 512, 1, 0, contig, dtype});
+      b->Args({512, 512, 2, 1, contig, dtype});
+    }
+  }
+  for (int64_t m : {128, 1024}) {
+    for (int64_t n : {128, 1024}) {
+      for (int64_t k : {1, 2}) {
+        for (int64_t dim : {0, 1, 2}) {
+          for (int64_t contig : {2, 1, 0}) {
+            b->Args({m, n, k, dim, contig, 0});
+          }
+        }
+      }
+    }
+  }
+}
+
+BENCHMARK(qcat)->Apply(QCatConfigs);
+
+// qembeddingbag_test.py, on the 8-bit rowwise packed weight
+static void qembedding_bag(benchmark::State& state) {
+  static const auto prepack = quantizedOp<at::Tensor(const at::Tensor&)>(
+      "quantized::embedding_bag_byte_prepack");
+  static const auto op = quantizedOp<at::Tensor(
+      const at::Tensor&,
+      const at::Tensor&,
+      const c10::optional<at::Tensor>&,
+      bool,
+      int64_t,
+      bool,
+      const c10::optional<at::Tensor>&,
+      bool)>("quantized::embedding_bag_byte_rowwise_offsets");
+  const int64_t embeddingbags = state.range(0);
+  const int64_t dim = state.range(1);
+  const int64_t input_size = state.range(2);
+  const bool include_last_offset = state.range(3);
+
+  at::Tensor packed_weight = prepack.call(at::randn({embeddingbags, dim}));
+  at::Tensor indices = at::randint(embeddingbags, {input_size}, at::kLong);
+  c10::optional<at::Tensor> offsets =
+      at::tensor({int64_t{0}, input_size}, at::kLong);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(
+        packed_weight,
+        indices,
+        offsets,
+        /*scale_grad_by_freq=*/false,
+        /*mode=sum*/ 0,
+        /*sparse=*/true,
+        /*per_sample_weights=*/c10::nullopt,
+        include_last_offset));
+  }
+}
+
+BENCHMARK(qembedding_bag)->Apply(EmbeddingBagShortConfigs);
+
+// qactivation_test.py: relu, on the short configs, which are not contiguous
+static void qrelu(
+    benchmark::State& state,
+    const std::vector<int64_t>& dims) {
+  const auto dtype = kQTypes[state.range(0)];
+  at::Tensor qinput =
+      at::quantize_per_tensor((at::rand(dims) - 0.5) * 256, 1.0, 0, dtype);
+  qinput = nonContiguous(qinput);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::relu(qinput));
+  }
+}
+
+static void QTypeConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"dtype"});
+  for (int64_t dtype : {0, 1, 2}) {
+    b->Args({dtype});
+  }
+}
+
+BENCHMARK_CAPTURE(qrelu, dims_3_4_5, {3, 4, 5})->Apply(QTypeConfigs);
+BENCHMARK_CAPTURE(qrelu, dims_2_3_4_5, {2, 3, 4, 5})->Apply(QTypeConfigs);
+BENCHMARK_CAPTURE(qrelu, dims_512_512, {512, 512})->Apply(QTypeConfigs);
+BENCHMARK_CAPTURE(qrelu, dims_256_1024, {256, 1024})->Apply(QTypeConfigs);
+
+// qarithmetic_test.py: add
+static void qadd(benchmark::State& state) {
+  static const auto op =
+      quantizedOp<at::Tensor(at::Tensor, at::Tensor, double, int64_t)>(
+          "quantized::add");
+  const int64_t n = state.range(0);
+  const auto dtype = kQTypes[state.range(1)];
+
+  at::Tensor qinput =
+      at::quantize_per_tensor((at::rand({n, n}) - 0.5) * 256, 1.0, 0, dtype);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(qinput, qinput, 1.0, 0));
+  }
+}
+
+static void QArithmeticConfigs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "dtype"});
+  for (int64_t n : {2, 8, 64, 512}) {
+    for (int64_t dtype : {0, 1, 2}) {
+      b->Args({n, dtype});
+    }
+  }
+}
+
+BENCHMARK(qadd)->Apply(QArithmeticConfigs);
+
+BENCHMARK_MAIN();
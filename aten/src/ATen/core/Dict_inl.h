@@ -5,6 +5,16 @@
 namespace c10 {
 namespace detail {
 inline bool DictKeyEqualTo::operator()(const IValue& lhs, const IValue& rhs) const {
+  // The keys of a Dict almost always have the same type, check the common
+  // ones without going through the generic IValue comparison.
+  if (lhs.isString() && rhs.isString()) {
+    return lhs.internalToPointer() == rhs.internalToPointer() ||
+        (lhs.toStringHash() == rhs.toStringHash() &&
+         lhs.toStringRef() == rhs.toStringRef());
+  }
+  if (lhs.isInt() && rhs.isInt()) {
+    return lhs.toInt() == rhs.toInt();
+  }
   if (lhs.isTensor() && rhs.isTensor()) {
     // for tensors, we compare only by identity (following how it's done in Python).
     return lhs.is(rhs);
@@ -38,9 +48,9 @@ namespace detail {
 
 inline size_t DictKeyHash::operator()(const IValue& ivalue) const {
   if (ivalue.isInt()) {
-    return std::hash<int>()(ivalue.toInt());
+    return std::hash<int64_t>()(ivalue.toInt());
   } else if (ivalue.isString()) {
-    return std::hash<std::string>()(ivalue.toStringRef());
+    return ivalue.toStringHash();
   } else if (ivalue.isDouble()) {
     return std::hash<double>()(ivalue.toDouble());
   } else if (ivalue.isBool()) {
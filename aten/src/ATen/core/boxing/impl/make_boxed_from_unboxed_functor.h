@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ATen/core/DimVector.h>
 #include <ATen/core/ivalue.h>
 #include <ATen/core/stack.h>
 #include <c10/util/Metaprogramming.h>
@@ -273,6 +274,30 @@ namespace impl {
       return ivalue_to_arg<std::vector<T>, AllowDeprecatedTypes>::call(std::move(v));
     }
   };
+  // int[] and float[] arguments are mostly short (sizes, strides, dims), so they are copied
+  // into a SmallVector that doesn't allocate for them. The list is moved out of the stack,
+  // which saves the refcount bump. SmallVector<T> is implicitly convertible to ArrayRef<T>.
+  template<class T>
+  SmallVector<T, at::kDimVectorStaticSize> list_to_small_vector(c10::List<T> list) {
+    SmallVector<T, at::kDimVectorStaticSize> result;
+    result.reserve(list.size());
+    for (size_t i = 0, N = list.size(); i < N; ++i) {
+      result.push_back(list.get(i));
+    }
+    return result;
+  }
+  template<bool AllowDeprecatedTypes>
+  struct ivalue_to_arg<ArrayRef<int64_t>, AllowDeprecatedTypes> final {
+    static SmallVector<int64_t, at::kDimVectorStaticSize> call(IValue&& v) {
+      return list_to_small_vector(std::move(v).toIntList());
+    }
+  };
+  template<bool AllowDeprecatedTypes>
+  struct ivalue_to_arg<ArrayRef<double>, AllowDeprecatedTypes> final {
+    static SmallVector<double, at::kDimVectorStaticSize> call(IValue&& v) {
+      return list_to_small_vector(std::move(v).toDoubleList());
+    }
+  };
   template<bool AllowDeprecatedTypes>
   struct ivalue_to_arg<optional<ArrayRef<int64_t>>, AllowDeprecatedTypes> final {
     // If an argument is optional<ArrayRef<int64_t>>, convert the IValue to a optional<std::vector<int64_t>> and pass that
@@ -347,18 +372,33 @@ namespace impl {
   }
 
   // push_outputs
+  // replace_inputs drops the num_inputs arguments on top of the stack and pushes the outputs.
+  // A single output is written into the slot of the first argument instead, so that
+  // the stack doesn't shrink and grow again around every call.
 
   template<class OutputType, bool AllowDeprecatedTypes>
   struct push_outputs final {
     static void call(OutputType&& output, Stack* stack) {
       torch::jit::push(*stack, return_to_ivalue<OutputType, AllowDeprecatedTypes>(std::forward<OutputType>(output)));
     }
+    static void replace_inputs(OutputType&& output, size_t num_inputs, Stack* stack) {
+      if (num_inputs == 0) {
+        call(std::forward<OutputType>(output), stack);
+        return;
+      }
+      torch::jit::peek(*stack, 0, num_inputs) = return_to_ivalue<OutputType, AllowDeprecatedTypes>(std::forward<OutputType>(output));
+      torch::jit::drop(*stack, num_inputs - 1);
+    }
   };
   template<class... OutputTypes, bool AllowDeprecatedTypes>
   struct push_outputs<std::tuple<OutputTypes...>, AllowDeprecatedTypes> final {
     static void call(std::tuple<OutputTypes...>&& output, Stack* stack) {
       call_(std::move(output), stack, std::make_index_sequence<sizeof...(OutputTypes)>());
     }
+    static void replace_inputs(std::tuple<OutputTypes...>&& output, size_t num_inputs, Stack* stack) {
+      torch::jit::drop(*stack, num_inputs);
+      call(std::move(output), stack);
+    }
 
   private:
     template<size_t... indices>
@@ -390,8 +430,7 @@ namespace impl {
         // and don't get a dangling reference. This is only required because some kernels still return `Tensor&`.
         using ReturnType_ = std::decay_t<typename decltype(delay_check)::template type_identity<ReturnType>>;
         ReturnType_ output = call_functor_with_args_from_stack<KernelFunctor, AllowDeprecatedTypes>(functor_, delay_check(stack));
-        torch::jit::drop(*stack, num_inputs);
-        push_outputs<ReturnType_, AllowDeprecatedTypes>::call(std::move(output), stack);
+        push_outputs<ReturnType_, AllowDeprecatedTypes>::replace_inputs(std::move(output), num_inputs, stack);
       }, /* else */ [&] {
         call_functor_with_args_from_stack<KernelFunctor, AllowDeprecatedTypes>(functor_, stack);
         torch::jit::drop(*stack, num_inputs);
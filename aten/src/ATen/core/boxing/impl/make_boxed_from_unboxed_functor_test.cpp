@@ -431,6 +431,36 @@ TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernelWithIntListInput_wi
   EXPECT_EQ(3, outputs[0].toInt());
 }
 
+struct KernelWithIntArrayRefInputWithOutput final : OperatorKernel {
+  int64_t operator()(Tensor, c10::ArrayRef<int64_t> input1) {
+    int64_t sum = 0;
+    for (int64_t v : input1) {
+      sum += v;
+    }
+    return sum;
+  }
+};
+
+TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernelWithIntArrayRefInput_withOutput_whenRegistered_thenCanBeCalled) {
+  auto registrar = RegisterOperators()
+      .op("_test::int_list_input(Tensor dummy, int[] input) -> int", RegisterOperators::options().kernel<KernelWithIntArrayRefInputWithOutput>(DispatchKey::CPU));
+
+  auto op = c10::Dispatcher::singleton().findSchema({"_test::int_list_input", ""});
+  ASSERT_TRUE(op.has_value());
+
+  // longer than the inline capacity of the SmallVector the list is copied into
+  auto outputs = callOp(*op, dummyTensor(DispatchKey::CPU), c10::List<int64_t>({1, 2, 3, 4, 5, 6, 7}));
+  EXPECT_EQ(1, outputs.size());
+  EXPECT_EQ(28, outputs[0].toInt());
+
+  // the output replaces the inputs, the values below them stay untouched
+  Stack stack{c10::IValue(5), dummyTensor(DispatchKey::CPU), c10::List<int64_t>({2, 4})};
+  op->callBoxed(&stack);
+  ASSERT_EQ(2, stack.size());
+  EXPECT_EQ(5, stack[0].toInt());
+  EXPECT_EQ(6, stack[1].toInt());
+}
+
 struct KernelWithTensorListInputWithoutOutput final : OperatorKernel {
   void operator()(const c10::List<Tensor>& input1) {
     captured_input_list_size = input1.size();
@@ -214,6 +214,10 @@ public:
 private:
   Dispatcher();
 
+  // Rest of callWithDispatchKey when RecordFunction callbacks may need to run
+  template<class Return, class... Args>
+  Return callWithDispatchKeySlowPath(const TypedOperatorHandle<Return (Args...)>& op, DispatchKey dispatchKey, const KernelFunction& kernel, Args... args) const;
+
   OperatorHandle findOrRegisterSchema_(FunctionSchema&& schema);
   OperatorHandle findOrRegisterName_(const OperatorName& op_name);
 
@@ -338,11 +342,8 @@ template<class... Args> inline void unused_arg_(const Args&...) {}
 }
 
 template<class Return, class... Args>
-inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, Args... args) const {
+C10_NOINLINE Return Dispatcher::callWithDispatchKeySlowPath(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, const KernelFunction& kernel, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
-  const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
-
-#ifndef PYTORCH_DISABLE_PER_OP_PROFILING
   // Check if we need to run callbacks registered with RecordFunction
   // If true and callbacks need inputs, we box the arguments and pass
   // them into the callbacks and also into the kernel call
@@ -366,7 +367,19 @@ inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(A
       }
     }
   }
-#endif  // PYTORCH_DISABLE_PER_OP_PROFILING
+  return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
+}
+
+template<class Return, class... Args>
+inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, Args... args) const {
+  detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
+  const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
+
+  // Only construct RecordFunction when some thread has callbacks, see
+  // at::shouldRunRecordFunction; always false with PYTORCH_DISABLE_PER_OP_PROFILING
+  if (at::shouldRunRecordFunction()) {
+    return callWithDispatchKeySlowPath<Return, Args...>(op, dispatchKey, kernel, std::forward<Args>(args)...);
+  }
   return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
 
@@ -400,23 +413,25 @@ inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const
   auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyBoxed(stack);
   const auto& kernel = entry.lookup(dispatchKey);
 
-#ifndef PYTORCH_DISABLE_PER_OP_PROFILING
-  // using already existing stack to record function execution in observers
-  at::RecordFunction guard(at::RecordScope::FUNCTION);
-  if (C10_UNLIKELY(guard.active)) {
-    if (shouldRecord(dispatchKey) && entry.isObserved()) {
-      int64_t seq_num = -1;
-      if (dispatchKey == DispatchKey::Autograd && at::GradMode::is_enabled()) {
-        seq_num = at::sequence_number::peek();
-      }
-      if (guard.needs_inputs) {
-        guard.before(op.schema().name(), *stack, seq_num);
-      } else {
-        guard.before(op.schema().name(), seq_num);
+  if (at::shouldRunRecordFunction()) {
+    // using already existing stack to record function execution in observers
+    at::RecordFunction guard(at::RecordScope::FUNCTION);
+    if (C10_UNLIKELY(guard.active)) {
+      if (shouldRecord(dispatchKey) && entry.isObserved()) {
+        int64_t seq_num = -1;
+        if (dispatchKey == DispatchKey::Autograd && at::GradMode::is_enabled()) {
+          seq_num = at::sequence_number::peek();
+        }
+        if (guard.needs_inputs) {
+          guard.before(op.schema().name(), *stack, seq_num);
+        } else {
+          guard.before(op.schema().name(), seq_num);
+        }
       }
     }
+    kernel.callBoxed(op, stack);
+    return;
   }
-#endif  // PYTORCH_DISABLE_PER_OP_PROFILING
   kernel.callBoxed(op, stack);
 }
 
@@ -35,6 +35,7 @@ namespace c10 {
   _(prim, FusionGroup)               \
   _(prim, CudaFusionGroup)           \
   _(prim, FunctionalGraph)           \
+  _(prim, MemoizedGraph)             \
   _(prim, DifferentiableGraph)       \
   _(prim, If)                        \
   _(prim, Jump) /* debug */          \
@@ -99,6 +100,7 @@ namespace c10 {
   _(prim, ConstantChunk)             \
   _(prim, MMTreeReduce)              \
   _(prim, MMBatchSide)               \
+  _(prim, MMBatchHorizontal)         \
   _(prim, min)                       \
   _(prim, max)                       \
   _(prim, abs)                       \
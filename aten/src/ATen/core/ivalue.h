@@ -404,6 +404,8 @@ struct CAFFE2_API IValue final {
   c10::intrusive_ptr<ivalue::ConstantString> toString() &&;
   c10::intrusive_ptr<ivalue::ConstantString> toString() const &;
   const std::string& toStringRef() const;
+  // std::hash of the string, which is only computed once per string.
+  size_t toStringHash() const;
   c10::optional<std::reference_wrapper<const std::string>> toOptionalStringRef() const;
 
   // DoubleList
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <type_traits>
 
@@ -166,6 +167,10 @@ using Shared = c10::intrusive_ptr<T>;
 struct CAFFE2_API ConstantString final : c10::intrusive_ptr_target {
  private:
   const std::string str_;
+  // Computed on first use, e.g. when the string is a key of a Dict, which
+  // then doesn't hash it again when looking it up or rehashing. 0 means not
+  // computed yet, so that a string hashing to 0 is just hashed every time.
+  mutable std::atomic<size_t> hash_{0};
  public:
   ConstantString(std::string str)
   : str_(std::move(str)) {}
@@ -173,6 +178,14 @@ struct CAFFE2_API ConstantString final : c10::intrusive_ptr_target {
   const std::string & string() const {
     return str_;
   }
+  size_t hash() const {
+    size_t hash = hash_.load(std::memory_order_relaxed);
+    if (hash == 0) {
+      hash = std::hash<std::string>()(str_);
+      hash_.store(hash, std::memory_order_relaxed);
+    }
+    return hash;
+  }
   operator const std::string & () const {
     return string();
   }
@@ -1044,6 +1057,10 @@ inline const std::string& IValue::toStringRef() const {
   AT_ASSERT(isString(), "Expected String but got ", tagKind());
   return static_cast<const c10::ivalue::ConstantString*>(payload.as_intrusive_ptr)->string();
 }
+inline size_t IValue::toStringHash() const {
+  AT_ASSERT(isString(), "Expected String but got ", tagKind());
+  return static_cast<const c10::ivalue::ConstantString*>(payload.as_intrusive_ptr)->hash();
+}
 inline c10::optional<std::reference_wrapper<const std::string>> IValue::toOptionalStringRef() const {
   if (isNone()) {
     return c10::nullopt;
@@ -570,6 +570,33 @@ bool is_null_or_equal(c10::optional<T> a, c10::IntArrayRef b) {
   return !a.has_value() || a.value() == b;
 }
 
+// Within a known rank, stride properties that are not known, like the stride
+// of a dimension whose size varies, match any value.
+static bool matchStrideProps(
+    const VaryingShape<Stride>& expected,
+    const VaryingShape<Stride>& actual) {
+  if (!expected.size() || !actual.size() ||
+      *expected.size() != *actual.size()) {
+    return expected == actual;
+  }
+  for (size_t i = 0; i < *expected.size(); i++) {
+    if (!expected[i]) {
+      continue;
+    }
+    if (!actual[i]) {
+      return false;
+    }
+    const Stride& e = *expected[i];
+    const Stride& a = *actual[i];
+    if ((e.stride_index_ && e.stride_index_ != a.stride_index_) ||
+        (e.contiguous_ && e.contiguous_ != a.contiguous_) ||
+        (e.stride_ && e.stride_ != a.stride_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool TensorType::matchTensor(const at::Tensor& t) {
   bool undef = undefined().value_or(!t.defined());
   if (undef != !t.defined()) {
@@ -586,7 +613,7 @@ bool TensorType::matchTensor(const at::Tensor& t) {
   // Here we know t.defined() == true and compare all other properties.
   bool rg = at::GradMode::is_enabled() && t.requires_grad();
   bool matched_strides = (!t.has_storage() && !stride_properties().isComplete())
-    || stride_properties() == computeStrideProps(t.sizes(), t.strides(), t.is_contiguous());
+    || matchStrideProps(stride_properties(), computeStrideProps(t.sizes(), t.strides(), t.is_contiguous()));
   return scalarType().value_or(t.scalar_type()) == t.scalar_type()
     && device().value_or(t.device()) == t.device()
     && requiresGrad().value_or(rg) == rg
@@ -19,6 +19,7 @@
 #include <cmath>
 #include <type_traits>
 #include <bitset>
+#include <tuple>
 
 #include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/Utils.h>
@@ -33,6 +34,16 @@
 #include <c10/util/TypeCast.h>
 #include <c10/macros/Macros.h>
 
+// The width in bytes of the vector registers Vec256 is built on. It is twice
+// that under AVX512, where every Vec256<T> holds 512 bits, so that the
+// kernels written against Vec256<T>::size() pick up the wider registers
+// without changes.
+#if defined(CPU_CAPABILITY_AVX512)
+#define VECTOR_WIDTH 64
+#else
+#define VECTOR_WIDTH 32
+#endif
+
 #if defined(__GNUC__)
 #define __at_align32__ __attribute__((aligned(32)))
 #elif defined(_WIN32)
@@ -74,7 +85,7 @@ using int_same_size_t = typename int_of_size<sizeof(T)>::type;
 template <class T>
 struct Vec256 {
 private:
-  __at_align32__ T values[32 / sizeof(T)];
+  __at_align32__ T values[VECTOR_WIDTH / sizeof(T)];
 public:
   using value_type = T;
   // Note [constexpr static function to avoid odr-usage compiler bug]
@@ -110,7 +121,7 @@ public:
   // identifier is odr-used or not, and in any case it's hard to tell if
   // a variable is odr-used or not.  So best to just cut the problem at the root.
   static constexpr int size() {
-    return 32 / sizeof(T);
+    return VECTOR_WIDTH / sizeof(T);
   }
   Vec256() : values{0} {}
   Vec256(T val) {
@@ -180,7 +191,7 @@ public:
   }
   static Vec256<T> loadu(const void* ptr) {
     Vec256 vec;
-    std::memcpy(vec.values, ptr, 32);
+    std::memcpy(vec.values, ptr, VECTOR_WIDTH);
     return vec;
   }
   static Vec256<T> loadu(const void* ptr, int64_t count) {
@@ -701,7 +712,7 @@ inline Vec256<T> operator^(const Vec256<T>& a, const Vec256<T>& b) {
 
 template<class T, typename Op>
 static inline Vec256<T> bitwise_binary_op(const Vec256<T> &a, const Vec256<T> &b, Op op) {
-  static constexpr uint32_t element_no = 32 / sizeof(intmax_t);
+  static constexpr uint32_t element_no = VECTOR_WIDTH / sizeof(intmax_t);
   __at_align32__ intmax_t buffer[element_no];
   const intmax_t *a_ptr = reinterpret_cast<const intmax_t*>((const T*) a);
   const intmax_t *b_ptr = reinterpret_cast<const intmax_t*>((const T*) b);
@@ -1060,11 +1060,11 @@ struct Vec256QuantizedConverter {
   }
 
   static constexpr int float_num_vecs() {
-    return size() / 8;
+    return size() / Vec256<float>::size();
   }
 
   static constexpr int int_num_vecs() {
-    return size() / 8;
+    return size() / Vec256<float>::size();
   }
 
   using float_vec_return_type = float_vec_return_type_;
@@ -1092,20 +1092,18 @@ struct Vec256QuantizedConverter {
       Vec256<float> zero_point,
       Vec256<float> scale_zp_premul) const {
     float_vec_return_type rv;
+    // the SIMD Vec256<float> specializations have no element access
+    float scale_vals[Vec256<float>::size()];
+    float zero_point_vals[Vec256<float>::size()];
+    scale.store(scale_vals);
+    zero_point.store(zero_point_vals);
     for (int i = 0; i < float_num_vecs(); ++i) {
-      float tmp_vals[8];
-      for (int j = 0; j < 8; ++j) {
+      float tmp_vals[Vec256<float>::size()];
+      for (int j = 0; j < Vec256<float>::size(); ++j) {
         tmp_vals[j] = at::native::dequantize_val<T>(
-            scale[j], zero_point[j], T(vals[8 * i + j]));
+            scale_vals[j], zero_point_vals[j], T(vals[Vec256<float>::size() * i + j]));
       }
-      rv[i] = Vec256<float>(tmp_vals[0],
-          tmp_vals[1],
-          tmp_vals[2],
-          tmp_vals[3],
-          tmp_vals[4],
-          tmp_vals[5],
-          tmp_vals[6],
-          tmp_vals[7]);
+      rv[i] = Vec256<float>::loadu(tmp_vals);
     }
     return rv;
   }
@@ -1126,25 +1124,25 @@ struct Vec256<c10::qint32> : public Vec256QuantizedConverter<
                                  c10::qint32,
                                  std::array<Vec256<float>, 1>,
                                  std::array<Vec256<c10::qint32>, 1>,
-                                 8> {
+                                 VECTOR_WIDTH / 4> {
   Vec256()
       : Vec256QuantizedConverter<
             c10::qint32,
             std::array<Vec256<float>, 1>,
             std::array<Vec256<c10::qint32>, 1>,
-            8>() {}
+            VECTOR_WIDTH / 4>() {}
   Vec256(c10::qint32 val)
       : Vec256QuantizedConverter<
             c10::qint32,
             std::array<Vec256<float>, 1>,
             std::array<Vec256<c10::qint32>, 1>,
-            8>(val) {}
+            VECTOR_WIDTH / 4>(val) {}
   Vec256(const void* ptr)
       : Vec256QuantizedConverter<
             c10::qint32,
             std::array<Vec256<float>, 1>,
             std::array<Vec256<c10::qint32>, 1>,
-            8>(ptr) {}
+            VECTOR_WIDTH / 4>(ptr) {}
 
   static Vec256<c10::qint32> loadu(const void* ptr) {
     return Vec256<c10::qint32>(ptr);
@@ -1156,10 +1154,11 @@ struct Vec256<c10::qint32> : public Vec256QuantizedConverter<
       int32_t zero_point,
       float inverse_scale) {
     std::array<value_type, size()> qvals;
-    std::array<float, float_num_vecs() * 8> float_vals;
+    std::array<float, float_num_vecs() * Vec256<float>::size()> float_vals;
 
     for (int i = 0; i < float_num_vecs(); ++i) {
-      rhs[i].store(&float_vals[i * 8], 8);
+      rhs[i].store(
+          &float_vals[i * Vec256<float>::size()], Vec256<float>::size());
     }
 
     at::native::quantize_vec<c10::qint32, /*precision=*/32>(
@@ -1167,7 +1166,7 @@ struct Vec256<c10::qint32> : public Vec256QuantizedConverter<
         zero_point,
         float_vals.data(),
         (c10::qint32*)qvals.data(),
-        8 * float_num_vecs());
+        Vec256<float>::size() * float_num_vecs());
 
     return Vec256<c10::qint32>::loadu(qvals.data());
   }
@@ -1258,25 +1257,25 @@ struct Vec256<c10::qint8> : public Vec256QuantizedConverter<
                                 c10::qint8,
                                 std::array<Vec256<float>, 4>,
                                 std::array<Vec256<c10::qint32>, 4>,
-                                32> {
+                                VECTOR_WIDTH> {
   Vec256()
       : Vec256QuantizedConverter<
             c10::qint8,
             std::array<Vec256<float>, 4>,
             std::array<Vec256<c10::qint32>, 4>,
-            32>() {}
+            VECTOR_WIDTH>() {}
   Vec256(c10::qint8 val)
       : Vec256QuantizedConverter<
             c10::qint8,
             std::array<Vec256<float>, 4>,
             std::array<Vec256<c10::qint32>, 4>,
-            32>(val) {}
+            VECTOR_WIDTH>(val) {}
   Vec256(const void* ptr)
       : Vec256QuantizedConverter<
             c10::qint8,
             std::array<Vec256<float>, 4>,
             std::array<Vec256<c10::qint32>, 4>,
-            32>(ptr) {}
+            VECTOR_WIDTH>(ptr) {}
 
   static Vec256<c10::qint8> loadu(const void* ptr) {
     return Vec256<c10::qint8>(ptr);
@@ -1288,10 +1287,11 @@ struct Vec256<c10::qint8> : public Vec256QuantizedConverter<
       int32_t zero_point,
       float inverse_scale) {
     std::array<value_type, size()> qvals;
-    std::array<float, float_num_vecs() * 8> float_vals;
+    std::array<float, float_num_vecs() * Vec256<float>::size()> float_vals;
 
     for (int i = 0; i < float_num_vecs(); ++i) {
-      rhs[i].store(&float_vals[i * 8], 8);
+      rhs[i].store(
+          &float_vals[i * Vec256<float>::size()], Vec256<float>::size());
     }
 
     at::native::quantize_vec<c10::qint8>(
@@ -1299,7 +1299,7 @@ struct Vec256<c10::qint8> : public Vec256QuantizedConverter<
         zero_point,
         float_vals.data(),
         (c10::qint8*)qvals.data(),
-        8 * float_num_vecs());
+        Vec256<float>::size() * float_num_vecs());
 
     return Vec256<c10::qint8>::loadu(qvals.data());
   }
@@ -1378,25 +1378,25 @@ struct Vec256<c10::quint8> : public Vec256QuantizedConverter<
                                  c10::quint8,
                                  std::array<Vec256<float>, 4>,
                                  std::array<Vec256<c10::qint32>, 4>,
-                                 32> {
+                                 VECTOR_WIDTH> {
   Vec256()
       : Vec256QuantizedConverter<
             c10::quint8,
             std::array<Vec256<float>, 4>,
             std::array<Vec256<c10::qint32>, 4>,
-            32>() {}
+            VECTOR_WIDTH>() {}
   Vec256(c10::quint8 val)
       : Vec256QuantizedConverter<
             c10::quint8,
             std::array<Vec256<float>, 4>,
             std::array<Vec256<c10::qint32>, 4>,
-            32>(val) {}
+            VECTOR_WIDTH>(val) {}
   Vec256(const void* ptr)
       : Vec256QuantizedConverter<
             c10::quint8,
             std::array<Vec256<float>, 4>,
             std::array<Vec256<c10::qint32>, 4>,
-            32>(ptr) {}
+            VECTOR_WIDTH>(ptr) {}
 
   static Vec256<c10::quint8> loadu(const void* ptr) {
     return Vec256<c10::quint8>(ptr);
@@ -1408,10 +1408,11 @@ struct Vec256<c10::quint8> : public Vec256QuantizedConverter<
       int32_t zero_point,
       float inverse_scale) {
     std::array<value_type, size()> qvals;
-    std::array<float, float_num_vecs() * 8> float_vals;
+    std::array<float, float_num_vecs() * Vec256<float>::size()> float_vals;
 
     for (int i = 0; i < float_num_vecs(); ++i) {
-      rhs[i].store(&float_vals[i * 8], 8);
+      rhs[i].store(
+          &float_vals[i * Vec256<float>::size()], Vec256<float>::size());
     }
 
     at::native::quantize_vec<c10::quint8>(
@@ -1419,7 +1420,7 @@ struct Vec256<c10::quint8> : public Vec256QuantizedConverter<
         zero_point,
         float_vals.data(),
         (c10::quint8*)qvals.data(),
-        8 * float_num_vecs());
+        Vec256<float>::size() * float_num_vecs());
 
     return Vec256<c10::quint8>::loadu(qvals.data());
   }
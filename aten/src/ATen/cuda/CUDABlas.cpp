@@ -4,6 +4,13 @@
 
 #include <ATen/cuda/CUDABlas.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && !defined(__HIP_PLATFORM_HCC__)
+#include <cublasLt.h>
+#endif
+
+#include <memory>
 
 #define CUDABLAS_POSINT_CHECK(FD, X)         \
   TORCH_CHECK(                               \
@@ -329,6 +336,267 @@ void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
 }
 #endif
 
+#ifndef __HIP_PLATFORM_HCC__
+#define GEMM_BATCHED_CHECK_ARGVALUES(Dtype)                    \
+  do {                                                         \
+    GEMM_CHECK_ARGVALUES(Dtype);                               \
+    CUDABLAS_NONNEGINT_CHECK(gemm_batched<Dtype>, batch_count); \
+  } while (0)
+
+template <>
+void gemm_batched<double>(CUDABLAS_GEMM_BATCHED_ARGTYPES(double)) {
+  globalContext().alertCuBLASConfigNotDeterministic();
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  GEMM_BATCHED_CHECK_ARGVALUES(double);
+  TORCH_CUDABLAS_CHECK(cublasDgemmBatched(
+      handle, opa, opb, m, n, k, &alpha, a, lda, b, ldb, &beta, c, ldc, batch_count));
+}
+
+template <>
+void gemm_batched<float>(CUDABLAS_GEMM_BATCHED_ARGTYPES(float)) {
+  globalContext().alertCuBLASConfigNotDeterministic();
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  GEMM_BATCHED_CHECK_ARGVALUES(float);
+  TORCH_CUDABLAS_CHECK(cublasSgemmBatched(
+      handle, opa, opb, m, n, k, &alpha, a, lda, b, ldb, &beta, c, ldc, batch_count));
+}
+
+template <>
+void gemm_batched<at::Half>(CUDABLAS_GEMM_BATCHED_ARGTYPES(at::Half)) {
+  globalContext().alertCuBLASConfigNotDeterministic();
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  float falpha = alpha;
+  float fbeta = beta;
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  GEMM_BATCHED_CHECK_ARGVALUES(at::Half);
+#if defined(CUDA_VERSION) && CUDA_VERSION < 11000
+  // As in gemm<at::Half>, tensor cores need to be enabled manually before CUDA 11.
+  TORCH_CUDABLAS_CHECK(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
+#endif  // CUDA_VERSION < 11000
+  // Accumulates in fp32, like gemm<at::Half>.
+  TORCH_CUDABLAS_CHECK(cublasGemmBatchedEx(
+      handle,
+      opa,
+      opb,
+      m,
+      n,
+      k,
+      &falpha,
+      reinterpret_cast<const void* const*>(a),
+      CUDA_R_16F,
+      lda,
+      reinterpret_cast<const void* const*>(b),
+      CUDA_R_16F,
+      ldb,
+      &fbeta,
+      reinterpret_cast<void* const*>(c),
+      CUDA_R_16F,
+      ldc,
+      batch_count,
+      CUDA_R_32F,
+      CUBLAS_GEMM_DFALT_TENSOR_OP));
+#if defined(CUDA_VERSION) && CUDA_VERSION < 11000
+  TORCH_CUDABLAS_CHECK(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
+#endif  // CUDA_VERSION < 11000
+}
+#endif // __HIP_PLATFORM_HCC__
+
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && !defined(__HIP_PLATFORM_HCC__)
+namespace {
+
+// The types of the operands, of the computation and of alpha for cuBLASLt
+template <typename Dtype>
+struct CuBlasLtTypes;
+
+template <>
+struct CuBlasLtTypes<double> {
+  using scale_t = double;
+  static constexpr cudaDataType_t data_type = CUDA_R_64F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_64F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_64F;
+};
+
+template <>
+struct CuBlasLtTypes<float> {
+  using scale_t = float;
+  static constexpr cudaDataType_t data_type = CUDA_R_32F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+// Accumulates in fp32, like gemm<at::Half>
+template <>
+struct CuBlasLtTypes<at::Half> {
+  using scale_t = float;
+  static constexpr cudaDataType_t data_type = CUDA_R_16F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+template <>
+struct CuBlasLtTypes<at::BFloat16> {
+  using scale_t = float;
+  static constexpr cudaDataType_t data_type = CUDA_R_16BF;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+// Destroys a cuBLASLt descriptor, T being the opaque type it points to
+template <typename T, cublasStatus_t (*destroy)(T*)>
+struct CuBlasLtDeleter {
+  void operator()(T* descriptor) {
+    if (descriptor != nullptr) {
+      destroy(descriptor);
+    }
+  }
+};
+
+using CuBlasLtMatmulDescriptor = std::unique_ptr<
+    cublasLtMatmulDescOpaque_t,
+    CuBlasLtDeleter<cublasLtMatmulDescOpaque_t, &cublasLtMatmulDescDestroy>>;
+using CuBlasLtMatrixLayout = std::unique_ptr<
+    cublasLtMatrixLayoutOpaque_t,
+    CuBlasLtDeleter<cublasLtMatrixLayoutOpaque_t, &cublasLtMatrixLayoutDestroy>>;
+using CuBlasLtMatmulPreference = std::unique_ptr<
+    cublasLtMatmulPreferenceOpaque_t,
+    CuBlasLtDeleter<cublasLtMatmulPreferenceOpaque_t, &cublasLtMatmulPreferenceDestroy>>;
+
+CuBlasLtMatrixLayout make_matrix_layout(
+    cudaDataType_t type,
+    int64_t rows,
+    int64_t cols,
+    int64_t ld) {
+  cublasLtMatrixLayout_t layout = nullptr;
+  TORCH_CUDABLAS_CHECK(cublasLtMatrixLayoutCreate(&layout, type, rows, cols, ld));
+  return CuBlasLtMatrixLayout(layout);
+}
+
+// The workspace cuBLASLt may use to pick faster algorithms
+constexpr size_t kCuBlasLtWorkspaceSize = 1024 * 1024;
+
+template <typename Dtype>
+void gemm_and_bias_impl(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)) {
+  using Types = CuBlasLtTypes<Dtype>;
+  using scale_t = typename Types::scale_t;
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  GEMM_CHECK_ARGVALUES(Dtype);
+  globalContext().alertCuBLASConfigNotDeterministic();
+
+  cublasLtMatmulDesc_t raw_desc = nullptr;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescCreate(
+      &raw_desc, Types::compute_type, Types::scale_type));
+  CuBlasLtMatmulDescriptor desc(raw_desc);
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      raw_desc, CUBLASLT_MATMUL_DESC_TRANSA, &opa, sizeof(opa)));
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      raw_desc, CUBLASLT_MATMUL_DESC_TRANSB, &opb, sizeof(opb)));
+  cublasLtEpilogue_t epilogue =
+      activation == GEMMAndBiasActivationEpilogue::RELU
+      ? CUBLASLT_EPILOGUE_RELU_BIAS
+      : CUBLASLT_EPILOGUE_BIAS;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      raw_desc, CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue, sizeof(epilogue)));
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      raw_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias, sizeof(bias)));
+
+  const bool transa_ = opa != CUBLAS_OP_N;
+  const bool transb_ = opb != CUBLAS_OP_N;
+  auto a_layout = make_matrix_layout(
+      Types::data_type, transa_ ? k : m, transa_ ? m : k, lda);
+  auto b_layout = make_matrix_layout(
+      Types::data_type, transb_ ? n : k, transb_ ? k : n, ldb);
+  auto c_layout = make_matrix_layout(Types::data_type, m, n, ldc);
+
+  cublasLtMatmulPreference_t raw_preference = nullptr;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceCreate(&raw_preference));
+  CuBlasLtMatmulPreference preference(raw_preference);
+  uint64_t workspace_size = kCuBlasLtWorkspaceSize;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+      raw_preference,
+      CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+      &workspace_size,
+      sizeof(workspace_size)));
+
+  // The cuBLAS handle can be used as a cuBLASLt one
+  cublasLtHandle_t handle =
+      reinterpret_cast<cublasLtHandle_t>(at::cuda::getCurrentCUDABlasHandle());
+  cublasLtMatmulHeuristicResult_t heuristic = {};
+  int num_results = 0;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulAlgoGetHeuristic(
+      handle,
+      raw_desc,
+      a_layout.get(),
+      b_layout.get(),
+      c_layout.get(),
+      c_layout.get(),
+      raw_preference,
+      1,
+      &heuristic,
+      &num_results));
+  if (num_results == 0) {
+    TORCH_CUDABLAS_CHECK(CUBLAS_STATUS_NOT_SUPPORTED);
+  }
+
+  auto workspace = c10::cuda::CUDACachingAllocator::get()->allocate(
+      heuristic.workspaceSize);
+  const scale_t alpha_val = alpha;
+  const scale_t beta_val = 0;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmul(
+      handle,
+      raw_desc,
+      &alpha_val,
+      a,
+      a_layout.get(),
+      b,
+      b_layout.get(),
+      &beta_val,
+      c,
+      c_layout.get(),
+      c,
+      c_layout.get(),
+      &heuristic.algo,
+      workspace.get(),
+      heuristic.workspaceSize,
+      at::cuda::getCurrentCUDAStream()));
+}
+
+} // anonymous namespace
+
+template <>
+void gemm_and_bias<double>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(double)) {
+  gemm_and_bias_impl<double>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc, activation);
+}
+
+template <>
+void gemm_and_bias<float>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(float)) {
+  gemm_and_bias_impl<float>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc, activation);
+}
+
+template <>
+void gemm_and_bias<at::Half>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::Half)) {
+  gemm_and_bias_impl<at::Half>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc, activation);
+}
+
+template <>
+void gemm_and_bias<at::BFloat16>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::BFloat16)) {
+  gemm_and_bias_impl<at::BFloat16>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc, activation);
+}
+#endif // CUDA_VERSION >= 11000 && !__HIP_PLATFORM_HCC__
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define GEMV_CHECK_ARGVALUES(Dtype)           \
@@ -5,10 +5,16 @@
     gemm<Dtype>(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c,
   ldc)
 
+    gemm_batched<Dtype>(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta,
+  c, ldc, batch_count)
+
     gemv<Dtype>(transa, m, n, alpha, a, lda, x, incx, beta, y, incy)
 
     dot<Dtype>(n, x, incx, y, incy, result)
 
+    gemm_and_bias<Dtype>(transa, transb, m, n, k, alpha, a, lda, b, ldb, bias,
+  c, ldc, activation)
+
   where Dtype is double, float, at::Half or at::BFloat16 (ROCm, NOT for dot).
   The functions are available in at::cuda::blas namespace.
  */
@@ -69,6 +75,71 @@ template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16));
 #endif
 
+// Runs batch_count gemms of the same shape at once. a, b and c are arrays
+// of batch_count matrix pointers in device memory; unlike strided batched
+// gemm the matrices may live anywhere. Not available on ROCm.
+#define CUDABLAS_GEMM_BATCHED_ARGTYPES(Dtype)                                   \
+  char transa, char transb, int64_t m, int64_t n, int64_t k, Dtype alpha,       \
+      const Dtype* const a[], int64_t lda, const Dtype* const b[], int64_t ldb, \
+      Dtype beta, Dtype* const c[], int64_t ldc, int64_t batch_count
+
+template <typename Dtype>
+inline void gemm_batched(CUDABLAS_GEMM_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::gemm_batched: not implemented for ", typeid(Dtype).name());
+}
+
+#ifndef __HIP_PLATFORM_HCC__
+template <>
+void gemm_batched<double>(CUDABLAS_GEMM_BATCHED_ARGTYPES(double));
+template <>
+void gemm_batched<float>(CUDABLAS_GEMM_BATCHED_ARGTYPES(float));
+template <>
+void gemm_batched<at::Half>(CUDABLAS_GEMM_BATCHED_ARGTYPES(at::Half));
+#endif
+
+// The activations which gemm_and_bias can apply in the epilogue of the gemm.
+// There is no GELU: the one of cuBLASLt is the tanh approximation.
+enum class GEMMAndBiasActivationEpilogue {
+  None,
+  RELU,
+};
+
+// Whether gemm_and_bias is available: it uses cuBLASLt, whose bias epilogues
+// need CUDA 11.
+constexpr bool gemm_and_bias_available() {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && !defined(__HIP_PLATFORM_HCC__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Computes c = activation(alpha * op(a) * op(b) + bias) with a single cuBLASLt
+// matmul, where the bias of length m is added to every column of c, instead of
+// writing the product and reading it back to add the bias and apply the
+// activation. Only call it if gemm_and_bias_available().
+#define CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)                              \
+  char transa, char transb, int64_t m, int64_t n, int64_t k, Dtype alpha,   \
+      const Dtype *a, int64_t lda, const Dtype *b, int64_t ldb,             \
+      const Dtype *bias, Dtype *c, int64_t ldc,                             \
+      GEMMAndBiasActivationEpilogue activation
+
+template <typename Dtype>
+inline void gemm_and_bias(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::gemm_and_bias: not implemented for ", typeid(Dtype).name());
+}
+
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && !defined(__HIP_PLATFORM_HCC__)
+template <>
+void gemm_and_bias<double>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(double));
+template <>
+void gemm_and_bias<float>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(float));
+template <>
+void gemm_and_bias<at::Half>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::Half));
+template <>
+void gemm_and_bias<at::BFloat16>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::BFloat16));
+#endif
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define CUDABLAS_GEMV_ARGTYPES(Dtype)                                         \
@@ -144,11 +144,64 @@ uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
  * See Note [Acquire lock when using random generators]
  */
 std::pair<uint64_t, uint64_t> CUDAGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  TORCH_CHECK(!graph_expects_this_gen_,
+              "This random op does not support CUDA graph capture yet, since it reads "
+              "the philox seed and offset by value. Kernels that should be capturable "
+              "must use philox_cuda_state instead.");
   uint64_t offset = this->philox_offset_per_thread_;
   this->philox_offset_per_thread_ += increment;
   return std::make_pair(this->seed_, offset);
 }
 
+/**
+ * Gets the philox state to be passed to a kernel that calls
+ * at::cuda::philox::unpack. Outside of graph capture this is the seed and
+ * offset philox_engine_inputs would return. During capture the offset
+ * advances the graph's private counter instead of philox_offset_per_thread_,
+ * see Note [CUDA Graph-safe RNG states].
+ *
+ * The increment is rounded up to a multiple of 4 so that every kernel in a
+ * graph starts at a fresh 128 bit philox output, as it would eagerly.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+PhiloxCudaState CUDAGeneratorImpl::philox_cuda_state(uint64_t increment) {
+  if (graph_expects_this_gen_) {
+    increment = ((increment + 3) / 4) * 4;
+    uint64_t offset = this->offset_intragraph_;
+    this->offset_intragraph_ += increment;
+    return PhiloxCudaState(this->seed_extragraph_,
+                           this->offset_extragraph_,
+                           offset);
+  }
+  auto seeds = philox_engine_inputs(increment);
+  return PhiloxCudaState(seeds.first, seeds.second);
+}
+
+/**
+ * Called by CUDAGraph to prepare this instance for a graph capture.
+ * seed_extragraph and offset_extragraph point to device memory owned by the
+ * graph that it fills in before every replay.
+ */
+void CUDAGeneratorImpl::capture_prologue(int64_t* seed_extragraph, int64_t* offset_extragraph) {
+  TORCH_CHECK(!graph_expects_this_gen_,
+              "This generator is already used by a CUDA graph capture in progress.");
+  seed_extragraph_ = seed_extragraph;
+  offset_extragraph_ = offset_extragraph;
+  offset_intragraph_ = 0;
+  graph_expects_this_gen_ = true;
+}
+
+/**
+ * Called by CUDAGraph to finalize a graph capture. Returns the total philox
+ * offset the captured kernels consume, by which every replay advances
+ * philox_offset_per_thread_.
+ */
+uint64_t CUDAGeneratorImpl::capture_epilogue() {
+  graph_expects_this_gen_ = false;
+  return offset_intragraph_;
+}
+
 /*
  * Gets the DeviceType of CUDAGeneratorImpl.
  * Used for type checking during run time.
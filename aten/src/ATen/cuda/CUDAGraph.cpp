@@ -0,0 +1,180 @@
+#include <ATen/cuda/CUDAGraph.h>
+
+#include <ATen/ATen.h>
+#include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/Utils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace at {
+namespace cuda {
+
+namespace {
+
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+// Id of the next private pool. 0 is reserved for "use a new pool".
+std::atomic<c10::cuda::CUDACachingAllocator::MempoolId_t> next_mempool_id{1};
+
+CUDAGeneratorImpl* default_generator() {
+  return get_generator_or_default<CUDAGeneratorImpl>(
+      c10::nullopt, cuda::detail::getDefaultCUDAGenerator());
+}
+#endif
+
+} // namespace
+
+CUDAGraph::CUDAGraph() {
+#if !defined(CUDA_VERSION) || CUDA_VERSION < 11000
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+void CUDAGraph::capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool) {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  TORCH_CHECK(!has_graph_exec_ && !uses_pool_,
+              "This CUDAGraph instance already owns a captured graph. "
+              "To capture a new graph, create a new instance or call reset() first.");
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  TORCH_CHECK(stream != at::cuda::getDefaultCUDAStream(),
+              "CUDA graphs must be captured on a non-default stream. "
+              "(However, after capture, it's ok to replay them on the default stream.)");
+
+  // Allocated before the capture starts, so they come from the regular pools
+  // and stay alive as long as this graph.
+  auto options = TensorOptions().device(at::kCUDA).dtype(at::kLong);
+  seed_extragraph_ = at::empty({1}, options);
+  offset_extragraph_ = at::empty({1}, options);
+
+  capture_stream_ = stream;
+  capture_dev_ = c10::cuda::current_device();
+  mempool_id_ = pool != 0 ? pool : next_mempool_id++;
+
+  auto gen = default_generator();
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->capture_prologue(seed_extragraph_.data_ptr<int64_t>(),
+                          offset_extragraph_.data_ptr<int64_t>());
+  }
+
+  c10::cuda::CUDACachingAllocator::notifyCaptureBegin(capture_dev_, stream, mempool_id_);
+  uses_pool_ = true;
+
+  // Global mode makes CUDA reject calls from any thread that would be unsafe
+  // during capture, such as synchronizing with the capturing stream.
+  cudaError_t err = cudaStreamBeginCapture(stream, cudaStreamCaptureModeGlobal);
+  if (err != cudaSuccess) {
+    c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_dev_, stream);
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->capture_epilogue();
+  }
+  AT_CUDA_CHECK(err);
+#else
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  auto stream = at::cuda::getCurrentCUDAStream();
+  TORCH_CHECK(capture_stream_.has_value() && stream == *capture_stream_,
+              "Capture must end on the same stream it began on.");
+
+  cudaGraph_t graph = NULL;
+  cudaError_t err = cudaStreamEndCapture(stream, &graph);
+
+  // The allocator and the generator leave capture mode even if the capture
+  // failed, so that eager work can go on.
+  c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_dev_, stream);
+  auto gen = default_generator();
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    wholegraph_increment_ = gen->capture_epilogue();
+  }
+
+  AT_CUDA_CHECK(err);
+  TORCH_CHECK(graph != NULL, "Invalid capture.");
+  graph_ = graph;
+
+  // The instantiated graph holds everything replay needs, so the graph
+  // itself is not kept around.
+  err = cudaGraphInstantiate(&graph_exec_, graph_, NULL, NULL, 0);
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  graph_ = NULL;
+  AT_CUDA_CHECK(err);
+  has_graph_exec_ = true;
+#else
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+void CUDAGraph::replay() {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  TORCH_CHECK(has_graph_exec_,
+              "Called CUDAGraph::replay without a preceding successful capture.");
+
+  c10::OptionalDeviceGuard device_guard{capture_stream_->device()};
+
+  if (wholegraph_increment_ > 0) {
+    // Claims the graph's share of the philox sequence, as any RNG consumer
+    // launching the captured kernels eagerly would.
+    auto gen = default_generator();
+    std::pair<uint64_t, uint64_t> seeds;
+    {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(gen->mutex_);
+      seeds = gen->philox_engine_inputs(wholegraph_increment_);
+    }
+    seed_extragraph_.fill_(static_cast<int64_t>(seeds.first));
+    offset_extragraph_.fill_(static_cast<int64_t>(seeds.second));
+  }
+
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, at::cuda::getCurrentCUDAStream()));
+#else
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+void CUDAGraph::reset() {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  // The private pool is only released once every graph sharing it is reset
+  // and the memory the replays use cannot be touched by them any more.
+  if (uses_pool_) {
+    c10::cuda::CUDACachingAllocator::notifyCaptureDestroy(capture_dev_, mempool_id_);
+    uses_pool_ = false;
+  }
+  if (has_graph_exec_) {
+    AT_CUDA_CHECK(cudaGraphExecDestroy(graph_exec_));
+    graph_exec_ = NULL;
+    has_graph_exec_ = false;
+  }
+  wholegraph_increment_ = 0;
+#else
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+c10::cuda::CUDACachingAllocator::MempoolId_t CUDAGraph::pool() {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  TORCH_CHECK(has_graph_exec_,
+              "Called CUDAGraph::pool() without a preceding successful capture.");
+#else
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+  return mempool_id_;
+}
+
+CUDAGraph::~CUDAGraph() {
+  try {
+    reset();
+  } catch (...) { /* No throw */ }
+}
+
+} // namespace cuda
+} // namespace at
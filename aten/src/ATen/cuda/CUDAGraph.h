@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cuda_runtime_api.h>
+
+namespace at {
+namespace cuda {
+
+/*
+* CUDAGraph records the kernels a static-shape workload launches on one
+* stream into a CUDA graph and replays them with a single launch, which
+* removes the CPU launch overhead of small inference batches.
+*
+* Capture runs on the current stream, which must not be the default stream.
+* During capture:
+*   - allocations on the capturing stream come from a private memory pool
+*     that stays reserved for the graph until reset(), so the addresses baked
+*     into the graph remain valid (see Note [Interaction with CUDA graph
+*     capture] in CUDACachingAllocator.cpp). Graphs that are replayed in a
+*     fixed order may share a pool by passing pool() of an earlier graph to
+*     capture_begin.
+*   - random ops drawing from the default CUDA generator read their seed and
+*     offset from device memory the graph refills before every replay, so
+*     each replay draws fresh numbers and advances the generator just like
+*     running the ops eagerly (see Note [CUDA Graph-safe RNG states]). Ops
+*     that still take the philox state by value refuse to be captured.
+*
+* Replays read and write the same memory as the captured run, so inputs are
+* fed by copying into the tensors used during capture and outputs are read
+* from the tensors it produced. Requires CUDA 11.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  // pool == 0 captures into a new private pool
+  void capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool = 0);
+  void capture_end();
+  void replay();
+  void reset();
+  c10::cuda::CUDACachingAllocator::MempoolId_t pool();
+
+ protected:
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  cudaGraph_t graph_ = NULL;
+  cudaGraphExec_t graph_exec_ = NULL;
+#endif
+
+  // set between a successful capture_end and reset
+  bool has_graph_exec_ = false;
+
+  // whether this graph holds a use of the private pool mempool_id_
+  bool uses_pool_ = false;
+  c10::cuda::CUDACachingAllocator::MempoolId_t mempool_id_ = 0;
+
+  // stream and device the graph was captured on
+  c10::optional<at::cuda::CUDAStream> capture_stream_;
+  int capture_dev_ = -1;
+
+  // device-side philox seed and offset read by the captured kernels
+  at::Tensor seed_extragraph_;
+  at::Tensor offset_extragraph_;
+
+  // philox offset the captured kernels consume per replay
+  uint64_t wholegraph_increment_ = 0;
+};
+
+} // namespace cuda
+} // namespace at
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ATen/CUDAGeneratorImpl.h>
+
+#include <utility>
+
+namespace at {
+namespace cuda {
+namespace philox {
+
+// Returns the (seed, offset) pair a kernel passes to curand_init. A state
+// captured into a CUDA graph reads both from device memory, so each replay
+// sees the values the graph filled in right before it was launched.
+// See Note [CUDA Graph-safe RNG states].
+__device__ __forceinline__ std::pair<uint64_t, uint64_t>
+unpack(at::PhiloxCudaState arg) {
+  if (arg.captured_) {
+    return std::make_pair(
+        static_cast<uint64_t>(*arg.seed_extragraph_),
+        static_cast<uint64_t>(*arg.offset_extragraph_) + arg.offset_intragraph_);
+  } else {
+    return std::make_pair(arg.seed_, arg.offset_);
+  }
+}
+
+} // namespace philox
+} // namespace cuda
+} // namespace at
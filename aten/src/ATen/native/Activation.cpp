@@ -7,6 +7,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/native/xnnpack/Engine.h>
 
 namespace at { namespace native {
 
@@ -141,6 +142,11 @@ Tensor elu_backward(
 }
 
 Tensor hardswish(const Tensor& self) {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_hardswish(self)) {
+    return xnnpack::hardswish(self);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::unary_op(result, self);
   hardswish_stub(iter.device_type(), iter);
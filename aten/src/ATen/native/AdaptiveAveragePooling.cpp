@@ -1,21 +1,18 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/AdaptivePooling.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <tuple>
 
 
 namespace at {
 namespace native {
 
-namespace {
-
-  inline int start_index(int a, int b, int c) {
-    return (int)std::floor((float)(a * c) / b);
-  }
+DEFINE_DISPATCH(adaptive_avg_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(adaptive_avg_pool2d_backward_channels_last_kernel);
 
-  inline int end_index(int a, int b, int c) {
-    return (int)std::ceil((float)((a + 1) * c) / b);
-  }
+namespace {
 
   template <typename scalar_t>
   static void adaptive_avg_pool2d_single_out_frame(
@@ -129,6 +126,13 @@ namespace {
     auto osizeH = output_size[0];
     auto osizeW = output_size[1];
 
+    if (input.ndimension() == 4 && input.scalar_type() != kHalf &&
+        input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+      output.resize_({input.size(-4), sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+      adaptive_avg_pool2d_channels_last_kernel(kCPU, output, input, output_size);
+      return;
+    }
+
     /* resize output */
     if (input.ndimension() == 3 || input.size(-4) == 1)
     {
@@ -260,6 +264,13 @@ namespace {
     int osizeH = gradOutput_.size(-2);
     int osizeW = gradOutput_.size(-1);
 
+    if (input.ndimension() == 4 && input.scalar_type() != kHalf &&
+        input.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+        gradInput.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+      adaptive_avg_pool2d_backward_channels_last_kernel(kCPU, gradInput, gradOutput_);
+      return gradInput;
+    }
+
     /* get contiguous gradOutput */
     auto gradOutput = gradOutput_.contiguous();
 
@@ -329,7 +340,13 @@ namespace {
       return at::mkldnn_adaptive_avg_pool2d(input, output_size);
     }
 
-    // TODO: fastpath for Channels_last should be explored later;
+#if defined(C10_MOBILE)
+    if (xnnpack::use_global_average_pool(input, output_size)) {
+      return xnnpack::global_average_pool(input);
+    }
+#endif
+
+    // channels last inputs are handled by the NHWC kernel of _adaptive_avg_pool2d
     if (input.suggest_memory_format() == at::MemoryFormat::Contiguous && !input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
       // in this case, adaptive pooling is just computing mean over hw
       // dimensions, which can be done more efficiently
@@ -357,7 +374,9 @@ namespace {
     const Tensor& gradOutput,
     const Tensor& input)
   {
-    auto gradInput = at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    auto gradInput = at::zeros_like(input, input.scalar_type() != kHalf
+        ? input.suggest_memory_format()
+        : LEGACY_CONTIGUOUS_MEMORY_FORMAT);
     adaptive_avg_pool2d_backward_out_cpu_template(
       gradInput, gradOutput, input);
     return gradInput;
@@ -5,6 +5,7 @@
 #include <ATen/ExpandUtils.h>
 
 #include <ATen/native/LinearAlgebraUtils.h>
+#include <ATen/native/SmallLinearAlgebra.h>
 #include <ATen/native/cpu/zmath.h>
 #include <ATen/Parallel.h>
 
@@ -305,6 +306,12 @@ template<> void lapackLuSolve<float>(char trans, int n, int nrhs, float *a, int
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
+// The matrices of at most kSmallMatrixMaxSize are handled by the kernels of
+// SmallLinearAlgebra.h, in parallel over the batch
+static inline int64_t smallMatrixGrainSize(int64_t n) {
+  return std::max<int64_t>(at::internal::GRAIN_SIZE / (n * n * n), 1);
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template<typename scalar_t>
@@ -336,13 +343,35 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
 #endif
 }
 
+template<typename scalar_t>
+static void apply_small_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
+  auto A_data = A.data_ptr<scalar_t>();
+  auto b_data = b.data_ptr<scalar_t>();
+  auto A_mat_stride = matrixStride(A);
+  auto b_mat_stride = matrixStride(b);
+  auto n = A.size(-2);
+  auto nrhs = b.size(-1);
+
+  at::parallel_for(0, batchCount(A), smallMatrixGrainSize(n), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      infos[i] = small_solve(n, &A_data[i * A_mat_stride], &b_data[i * b_mat_stride], nrhs);
+    }
+  });
+}
+
 std::tuple<Tensor, Tensor> _solve_helper_cpu(const Tensor& self, const Tensor& A) {
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
   std::vector<int64_t> infos(batchCount(self), 0);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cpu", [&]{
-    apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
-  });
+  if (useSmallMatrixKernels(A.size(-1)) && !isComplexType(A.scalar_type())) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cpu", [&]{
+      apply_small_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cpu", [&]{
+      apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "solve_cpu");
   } else {
@@ -416,12 +445,31 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
 #endif
 }
 
+template <typename scalar_t>
+static void apply_small_inverse(Tensor& self, std::vector<int64_t>& infos) {
+  auto self_data = self.data_ptr<scalar_t>();
+  auto self_matrix_stride = matrixStride(self);
+  auto n = self.size(-2);
+
+  at::parallel_for(0, batchCount(self), smallMatrixGrainSize(n), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      infos[i] = small_inverse(n, &self_data[i * self_matrix_stride]);
+    }
+  });
+}
+
 Tensor _inverse_helper_cpu(const Tensor& self) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "inverse_cpu", [&]{
-    apply_inverse<scalar_t>(self_working_copy, infos);
-  });
+  if (useSmallMatrixKernels(self.size(-1)) && !isComplexType(self.scalar_type())) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cpu", [&]{
+      apply_small_inverse<scalar_t>(self_working_copy, infos);
+    });
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "inverse_cpu", [&]{
+      apply_inverse<scalar_t>(self_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "inverse_cpu");
   } else {
@@ -535,12 +583,31 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
 #endif
 }
 
+template<typename scalar_t>
+static void apply_small_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos) {
+  auto self_data = self.data_ptr<scalar_t>();
+  auto self_matrix_stride = matrixStride(self);
+  auto n = self.size(-2);
+
+  at::parallel_for(0, batchCount(self), smallMatrixGrainSize(n), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      infos[i] = small_cholesky(n, &self_data[i * self_matrix_stride], upper);
+    }
+  });
+}
+
 Tensor _cholesky_helper_cpu(const Tensor& self, bool upper) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
-    apply_cholesky<scalar_t>(self_working_copy, upper, infos);
-  });
+  if (useSmallMatrixKernels(self.size(-1)) && !isComplexType(self.scalar_type())) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
+      apply_small_cholesky<scalar_t>(self_working_copy, upper, infos);
+    });
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
+      apply_cholesky<scalar_t>(self_working_copy, upper, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "cholesky_cpu");
   } else {
@@ -596,6 +663,22 @@ static void apply_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
 #endif
 }
 
+template<typename scalar_t>
+static void apply_small_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
+  auto self_data = self.data_ptr<scalar_t>();
+  auto pivots_data = pivots.data_ptr<int>();
+  auto infos_data = infos.data_ptr<int>();
+  auto self_matrix_stride = matrixStride(self);
+  auto pivots_matrix_stride = pivots.size(-1);
+  auto n = self.size(-1);
+
+  at::parallel_for(0, batchCount(self), smallMatrixGrainSize(n), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      infos_data[i] = small_lu(n, &self_data[i * self_matrix_stride], &pivots_data[i * pivots_matrix_stride]);
+    }
+  });
+}
+
 std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cpu(const Tensor& self, bool pivot, bool check_errors) {
   TORCH_CHECK(pivot, "lu without pivoting is not implemented on the CPU");
   TORCH_CHECK(self.dim() >= 2,
@@ -615,9 +698,15 @@ std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cpu(const Tensor& self, bool pi
     self_working_copy = at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   } else {
     self_working_copy = cloneBatchedColumnMajor(self);
-    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_cpu", [&]{
-      apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
-    });
+    if (m == n && useSmallMatrixKernels(n) && !isComplexType(self.scalar_type())) {
+      AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cpu", [&]{
+        apply_small_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
+      });
+    } else {
+      AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_cpu", [&]{
+        apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
+      });
+    }
   }
   if (check_errors) {
     if (self.dim() > 2) {
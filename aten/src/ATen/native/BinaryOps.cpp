@@ -7,6 +7,7 @@
 #include <ATen/MemoryOverlap.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/xnnpack/Engine.h>
 
 #include <torch/library.h>
 
@@ -57,6 +58,11 @@ Tensor& add_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar
 }
 
 Tensor add(const Tensor& self, const Tensor& other, Scalar alpha) {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_add(self, other, alpha)) {
+    return xnnpack::add(self, other, alpha);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::binary_op(result, self, other);
   alpha_check(iter.dtype(), alpha);
@@ -243,6 +249,11 @@ Tensor& mul_out(Tensor& result, const Tensor& self, const Tensor& other) {
 }
 
 Tensor mul(const Tensor& self, const Tensor& other) {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_multiply(self, other)) {
+    return xnnpack::multiply(self, other);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::binary_op(result, self, other);
   mul_stub(iter.device_type(), iter);
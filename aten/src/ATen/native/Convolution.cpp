@@ -1,12 +1,18 @@
+#include <chrono>
 #include <limits>
+#include <mutex>
+#include <sstream>
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/ConvolutionBenchmark.h>
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
 #include <ATen/native/xnnpack/Engine.h>
 
 #include <ATen/Config.h>
+#include <ATen/core/grad_mode.h>
 #include <c10/macros/Macros.h>
 
 #if AT_NNPACK_ENABLED()
@@ -48,6 +54,7 @@ struct ConvParams {
   bool use_nnpack(const at::Tensor& input) const;
   bool use_xnnpack(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool is_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
+  bool use_cpu_conv_benchmark(const at::Tensor& input, const at::Tensor& weight) const;
 };
 
 std::ostream& operator<<(std::ostream & out, const ConvParams& params) {
@@ -271,6 +278,17 @@ auto ConvParams::use_xnnpack(
                 groups,
                 transposed);
   }
+  // Transposed convolutions of any groups, which otherwise end up in the
+  // slow im2col based kernels.
+  return xnnpack::use_convolution2d(
+      input,
+      weight,
+      bias,
+      padding,
+      stride,
+      dilation,
+      groups,
+      transposed);
 #endif
   return false;
 }
@@ -289,6 +307,17 @@ auto ConvParams::is_depthwise(
 }
 
 // Check workload to activate fast depthwise FP16 cudnn conv kernels
+auto ConvParams::use_cpu_conv_benchmark(
+        const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  return at::globalContext().benchmarkCPUConv() &&
+         input.options().backend() == at::Backend::CPU &&
+         input.scalar_type() == kFloat &&
+         weight.options().backend() == at::Backend::CPU &&
+         weight.scalar_type() == kFloat &&
+         input.ndimension() == 4 &&
+         !transposed;
+}
+
 bool check_cudnn_depthwise_workload(const at::Tensor& input, int stride) {
   int w = input.size(3);  // same as h
   int ch = input.size(1);
@@ -533,6 +562,194 @@ static at::Tensor subtensor(at::Tensor& tensor, int dim, int groups, int g) {
 }
 
 
+// Note [CPU convolution benchmarking]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The CPU implementation of a convolution is picked by the heuristics of
+// ConvParams::use_mkldnn, use_nnpack etc., which can be far from the fastest
+// choice for a given shape. When at::globalContext().benchmarkCPUConv() is
+// set (torch.backends.cpu.conv_benchmark), the first convolution of each
+// configuration instead times every implementation available for it, like
+// cudnn.benchmark does, and that configuration then always uses the fastest
+// one. The choices are cached by a string key of the configuration, which
+// includes the number of threads, and can be exported and loaded again with
+// the functions of ConvolutionBenchmark.h. Only non transposed 2d (and 1d,
+// which are run as 2d) convolutions of dense float tensors are benchmarked.
+
+enum class CPUConvBackend { Native, Mkldnn, Nnpack, Xnnpack, Winograd, NumBackends };
+
+constexpr const char* kCPUConvBackendNames[] = {"native", "mkldnn", "nnpack", "xnnpack", "winograd"};
+
+static std::string cpu_conv_benchmark_key(
+    const Tensor& input, const Tensor& weight, const Tensor& bias, const ConvParams& params) {
+  std::ostringstream key;
+  key << "input=" << input.sizes()
+      << " weight=" << weight.sizes()
+      << " bias=" << bias.defined()
+      << " stride=" << IntArrayRef{params.stride}
+      << " padding=" << IntArrayRef{params.padding}
+      << " dilation=" << IntArrayRef{params.dilation}
+      << " groups=" << params.groups
+      << " channels_last=" << (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast)
+      << " threads=" << at::get_num_threads();
+  return key.str();
+}
+
+static std::vector<CPUConvBackend> available_cpu_conv_backends(
+    const Tensor& input, const Tensor& weight, const Tensor& bias, const ConvParams& params) {
+  std::vector<CPUConvBackend> backends = {CPUConvBackend::Native};
+#if AT_MKLDNN_ENABLED()
+  if (at::globalContext().userEnabledMkldnn()) {
+    backends.push_back(CPUConvBackend::Mkldnn);
+  }
+#endif
+#if AT_NNPACK_ENABLED()
+  if (at::_nnpack_available() && params.groups == 1 && !params.is_dilated()) {
+    backends.push_back(CPUConvBackend::Nnpack);
+  }
+#endif
+  if (params.use_xnnpack(input, weight, bias)) {
+    backends.push_back(CPUConvBackend::Xnnpack);
+  }
+  if (params.use_cpu_depthwise3x3_winograd(input, weight, bias)) {
+    backends.push_back(CPUConvBackend::Winograd);
+  }
+  return backends;
+}
+
+static at::Tensor cpu_conv_with_backend(
+    CPUConvBackend backend, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    const ConvParams& params) {
+  switch (backend) {
+    case CPUConvBackend::Mkldnn:
+#if AT_MKLDNN_ENABLED()
+      return at::mkldnn_convolution(input.contiguous(), weight.contiguous(), bias.defined() ? bias.contiguous() : bias,
+                                    params.padding, params.stride, params.dilation, params.groups);
+#else
+      break;
+#endif
+    case CPUConvBackend::Nnpack:
+#if AT_NNPACK_ENABLED()
+      return at::_nnpack_spatial_convolution(input.contiguous(), weight, bias, params.padding, params.stride);
+#else
+      break;
+#endif
+    case CPUConvBackend::Xnnpack:
+      return xnnpack::convolution2d(
+          input, weight, bias, params.padding, params.stride, params.dilation, params.groups);
+    case CPUConvBackend::Winograd:
+      return convolution_depthwise3x3_winograd_stub(
+          input.device().type(), input, weight, bias, params.stride, params.padding, params.groups);
+    case CPUConvBackend::Native: {
+      // The im2col kernels of _convolution_nogroup, without its NNPACK path
+      const auto conv_nogroup = [&](const Tensor& input_g, const Tensor& weight_g, const Tensor& bias_g) {
+        auto kernel_size = weight_g.sizes().slice(2);
+        if (params.is_dilated()) {
+          return at::slow_conv_dilated2d(
+              input_g, weight_g, kernel_size, bias_g, params.stride, params.padding, params.dilation);
+        }
+        return at::thnn_conv2d(input_g, weight_g, kernel_size, bias_g, params.stride, params.padding);
+      };
+      auto input_c = input.contiguous();
+      if (params.groups == 1) {
+        return conv_nogroup(input_c, weight, bias);
+      }
+      auto weight_c = weight;
+      auto bias_c = bias;
+      std::vector<Tensor> outputs(params.groups);
+      for (int g = 0; g < params.groups; ++g) {
+        outputs[g] = conv_nogroup(
+            subtensor(input_c, 1, params.groups, g),
+            subtensor(weight_c, 0, params.groups, g),
+            subtensor(bias_c, 0, params.groups, g));
+      }
+      return at::cat(outputs, 1);
+    }
+    default:
+      break;
+  }
+  TORCH_INTERNAL_ASSERT(false, "CPU convolution backend ", kCPUConvBackendNames[static_cast<int>(backend)],
+                        " is not available");
+}
+
+static std::mutex cpu_conv_benchmark_mutex;
+
+// Requires cpu_conv_benchmark_mutex.
+static std::unordered_map<std::string, CPUConvBackend>& cpu_conv_benchmark_cache() {
+  static std::unordered_map<std::string, CPUConvBackend> cache;
+  return cache;
+}
+
+static CPUConvBackend cpu_conv_benchmark_backend(
+    const Tensor& input, const Tensor& weight, const Tensor& bias, const ConvParams& params) {
+  const auto backends = available_cpu_conv_backends(input, weight, bias, params);
+  const std::string key = cpu_conv_benchmark_key(input, weight, bias, params);
+  {
+    std::lock_guard<std::mutex> lock(cpu_conv_benchmark_mutex);
+    auto& cache = cpu_conv_benchmark_cache();
+    auto it = cache.find(key);
+    if (it != cache.end() && std::find(backends.begin(), backends.end(), it->second) != backends.end()) {
+      return it->second;
+    }
+  }
+
+  at::NoGradGuard no_grad;
+  CPUConvBackend best = CPUConvBackend::Native;
+  double best_time = std::numeric_limits<double>::infinity();
+  for (const auto backend : backends) {
+    try {
+      // The first run also does the allocations and the reorders of the
+      // weight, which are not timed.
+      cpu_conv_with_backend(backend, input, weight, bias, params);
+      const auto start = std::chrono::steady_clock::now();
+      cpu_conv_with_backend(backend, input, weight, bias, params);
+      const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+      if (time.count() < best_time) {
+        best = backend;
+        best_time = time.count();
+      }
+    } catch (const c10::Error&) {
+      // Skip the implementations which do not support this configuration,
+      // the native one supports all of them.
+      if (backend == CPUConvBackend::Native) {
+        throw;
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(cpu_conv_benchmark_mutex);
+  cpu_conv_benchmark_cache()[key] = best;
+  return best;
+}
+
+std::unordered_map<std::string, std::string> getCPUConvBenchmarkCache() {
+  std::lock_guard<std::mutex> lock(cpu_conv_benchmark_mutex);
+  std::unordered_map<std::string, std::string> choices;
+  for (const auto& choice : cpu_conv_benchmark_cache()) {
+    choices.emplace(choice.first, kCPUConvBackendNames[static_cast<int>(choice.second)]);
+  }
+  return choices;
+}
+
+void loadCPUConvBenchmarkCache(const std::unordered_map<std::string, std::string>& choices) {
+  std::unordered_map<std::string, CPUConvBackend> backends;
+  for (const auto& choice : choices) {
+    const auto names_end = kCPUConvBackendNames + static_cast<int>(CPUConvBackend::NumBackends);
+    const auto name = std::find(kCPUConvBackendNames, names_end, choice.second);
+    TORCH_CHECK(name != names_end, "unknown CPU convolution backend ", choice.second,
+                " for the configuration ", choice.first);
+    backends.emplace(choice.first, static_cast<CPUConvBackend>(name - kCPUConvBackendNames));
+  }
+  std::lock_guard<std::mutex> lock(cpu_conv_benchmark_mutex);
+  for (const auto& backend : backends) {
+    cpu_conv_benchmark_cache()[backend.first] = backend.second;
+  }
+}
+
+void clearCPUConvBenchmarkCache() {
+  std::lock_guard<std::mutex> lock(cpu_conv_benchmark_mutex);
+  cpu_conv_benchmark_cache().clear();
+}
+
 at::Tensor conv1d(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
     IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
@@ -716,6 +933,10 @@ at::Tensor _convolution(
           input.contiguous(), weight, bias,
           params.padding, params.stride, params.dilation, params.groups, params.benchmark, params.deterministic);
     }
+  } else if (params.use_cpu_conv_benchmark(input, weight)) {
+    // See Note [CPU convolution benchmarking]
+    const auto backend = cpu_conv_benchmark_backend(input, weight, bias, params);
+    output = cpu_conv_with_backend(backend, input, weight, bias, params);
   } else if (params.use_mkldnn(input, weight)) {
 #if AT_MKLDNN_ENABLED()
     TORCH_CHECK(input.options().type_equal(weight.options()),
@@ -736,14 +957,26 @@ at::Tensor _convolution(
   } else if (params.use_xnnpack(input, weight, bias)) {
     // Using prepacked conv is preferred, but XNNPACK is still the fastest
     // option for NHWC.
-    output = xnnpack::convolution2d(
-        input,
-        weight,
-        bias,
-        params.padding,
-        params.stride,
-        params.dilation,
-        params.groups);
+    if (params.transposed) {
+      output = xnnpack::convolution2d_transpose(
+          input,
+          weight,
+          bias,
+          params.padding,
+          params.output_padding,
+          params.stride,
+          params.dilation,
+          params.groups);
+    } else {
+      output = xnnpack::convolution2d(
+          input,
+          weight,
+          bias,
+          params.padding,
+          params.stride,
+          params.dilation,
+          params.groups);
+    }
   } else if (params.use_cpu_depthwise3x3_winograd(input, weight, bias)) {
     output = convolution_depthwise3x3_winograd_stub(
         input.device().type(),
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace at { namespace native {
+
+// The CPU convolution implementations chosen by benchmarking, by
+// configuration, see Note [CPU convolution benchmarking] in Convolution.cpp.
+// The implementations are "native", "mkldnn", "nnpack", "xnnpack" and
+// "winograd".
+CAFFE2_API std::unordered_map<std::string, std::string> getCPUConvBenchmarkCache();
+
+// Adds the given choices, e.g. the ones of another process with the same
+// build and number of threads. A choice which is not available for its
+// configuration is benchmarked again.
+CAFFE2_API void loadCPUConvBenchmarkCache(const std::unordered_map<std::string, std::string>& choices);
+
+CAFFE2_API void clearCPUConvBenchmarkCache();
+
+}}  // namespace at::native
@@ -9,6 +9,9 @@
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(max_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(max_pool2d_backward_channels_last_kernel);
+
 namespace {
 
 template <typename scalar_t>
@@ -171,6 +174,17 @@ void max_pool2d_with_indices_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
+  if (input_.ndimension() == 4 &&
+      input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    Tensor input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    indices.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    max_pool2d_channels_last_kernel(
+      kCPU, output, indices, input,
+      kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+    return;
+  }
+
   /* get contiguous input */
   Tensor input = input_.contiguous();
 
@@ -333,11 +347,20 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   TORCH_CHECK((input.ndimension() == 3 || input.ndimension() == 4),
     "non-empty 3D or 4D (batch mode) tensor expected for input");
 
+  const bool channels_last = input.ndimension() == 4 &&
+      input.suggest_memory_format() == at::MemoryFormat::ChannelsLast;
+
   /* get contiguous gradOutput */
-  const Tensor gradOutput = gradOutput_.contiguous();
+  const Tensor gradOutput = channels_last
+      ? gradOutput_.contiguous(at::MemoryFormat::ChannelsLast)
+      : gradOutput_.contiguous();
 
   /* resize */
-  gradInput.resize_as_(input);
+  if (channels_last) {
+    gradInput.resize_as_(input, at::MemoryFormat::ChannelsLast);
+  } else {
+    gradInput.resize_as_(input);
+  }
   gradInput.zero_();
 
   /* sizes */
@@ -363,7 +386,12 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
     outputHeight_for_shape_check, outputWidth_for_shape_check);
 
   /* backprop */
-  if (input.ndimension() == 3)
+  if (channels_last)
+  {
+    max_pool2d_backward_channels_last_kernel(
+      kCPU, gradInput, gradOutput, indices.contiguous(at::MemoryFormat::ChannelsLast));
+  }
+  else if (input.ndimension() == 3)
   {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
       "max_pool2d_with_indices_backward",
@@ -495,7 +523,7 @@ Tensor max_pool2d_with_indices_backward_cpu(
   bool ceil_mode,
   const Tensor& indices)
 {
-  auto gradInput = at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto gradInput = at::zeros_like(input, input.suggest_memory_format());
   max_pool2d_with_indices_backward_out_cpu_template(
     gradInput,
     gradOutput_,
@@ -12,6 +12,7 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -41,6 +42,31 @@ static void make_offset2bag(const Tensor &offsets, const Tensor &indices, Tensor
 
 namespace {
 
+// Runs f(bag, begin, end) for every bag in parallel, where [begin, end) are
+// the positions in `indices` that make up the bag. Every bag writes only to
+// its own row of the output, so bags can be reduced independently.
+template <typename func_t>
+void parallel_for_each_bag(
+    const Tensor& offsets,
+    int64_t numel,
+    bool include_last_offset,
+    int64_t ddim,
+    const func_t& f) {
+  auto* offsets_data = offsets.data_ptr<int64_t>();
+  int64_t num_bags = include_last_offset ? offsets.numel() - 1 : offsets.numel();
+  if (num_bags <= 0) {
+    return;
+  }
+  int64_t work_per_bag = std::max<int64_t>(ddim * (numel / num_bags), 1);
+  int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / work_per_bag, 1);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t bag = start; bag < end; bag++) {
+      int64_t bag_end = bag + 1 < offsets.numel() ? offsets_data[bag + 1] : numel;
+      f(bag, offsets_data[bag], bag_end);
+    }
+  });
+}
+
 bool isFastPathIndexSelect(const Tensor& src, Tensor& output) {
   return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1;
 }
@@ -57,10 +83,9 @@ void index_select_add(const Tensor &select_indices,
                              const Tensor &add_indices,
                              const Tensor &src,
                              Tensor &output,
-                             const Tensor& /*offsets*/,
-                             bool /*include_last_offset*/) {
+                             const Tensor& offsets,
+                             bool include_last_offset) {
   AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto* add_indices_data = add_indices.data_ptr<int64_t>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
   auto* src_data = src.data_ptr<T>();
   auto* output_data = output.data_ptr<T>();
@@ -71,11 +96,16 @@ void index_select_add(const Tensor &select_indices,
   auto output_stride0 = output.stride(0);
   auto output_stride1 = output.stride(1);
 
-  for (int64_t i = 0; i < numel; i++) {
-    THBlas_axpy<T>(ddim, 1,
-            src_data + src_stride0 * select_indices_data[i], src_stride1,
-            output_data + output_stride0 * add_indices_data[i], output_stride1);
-  }
+  // add_indices maps each position to its bag, i.e. to the bag of offsets
+  // it falls in, so the bags can be summed in parallel
+  parallel_for_each_bag(offsets, numel, include_last_offset, ddim,
+      [&](int64_t bag, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      THBlas_axpy<T>(ddim, 1,
+              src_data + src_stride0 * select_indices_data[i], src_stride1,
+              output_data + output_stride0 * bag, output_stride1);
+    }
+  });
 }
 
 template<>
@@ -148,21 +178,23 @@ void index_select_add<float>(const Tensor &select_indices,
         });
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto* add_indices_data = add_indices.data_ptr<int64_t>();
     auto src_stride0 = src.stride(0);
     auto src_stride1 = src.stride(1);
     auto output_stride0 = output.stride(0);
     auto output_stride1 = output.stride(1);
     auto numel = add_indices.numel();
-    for (int64_t i = 0; i < numel; i++) {
-      THBlas_axpy<float>(
-          ddim,
-          1,
-          src_data + src_stride0 * select_indices_data[i],
-          src_stride1,
-          output_data + output_stride0 * add_indices_data[i],
-          output_stride1);
-    }
+    parallel_for_each_bag(offsets, numel, include_last_offset, ddim,
+        [&](int64_t bag, int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        THBlas_axpy<float>(
+            ddim,
+            1,
+            src_data + src_stride0 * select_indices_data[i],
+            src_stride1,
+            output_data + output_stride0 * bag,
+            output_stride1);
+      }
+    });
   }
 }
 
@@ -176,10 +208,9 @@ static void index_select_scale_add(const Tensor &select_indices,
                                    const Tensor &scale,
                                    const Tensor &src,
                                    Tensor &output,
-                                   const Tensor& /*offsets*/,
-                                   bool /*include_last_offset*/) {
+                                   const Tensor& offsets,
+                                   bool include_last_offset) {
   AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto* add_indices_data = add_indices.data_ptr<int64_t>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
   auto* src_data = src.data_ptr<T>();
   auto* output_data = output.data_ptr<T>();
@@ -193,14 +224,17 @@ static void index_select_scale_add(const Tensor &select_indices,
   auto* scale_data = scale.data_ptr<T>();
   auto scale_stride = scale.stride(0);
 
-  for (int64_t i = 0; i < numel; i++) {
-    auto* src_base = src_data + src_stride0 * select_indices_data[i];
-    auto* output_base = output_data + output_stride0 * add_indices_data[i];
-    auto scale = scale_data[i * scale_stride];
-    for (int64_t j = 0; j < ddim; j++) {
-      output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
+  parallel_for_each_bag(offsets, numel, include_last_offset, ddim,
+      [&](int64_t bag, int64_t begin, int64_t end) {
+    auto* output_base = output_data + output_stride0 * bag;
+    for (int64_t i = begin; i < end; i++) {
+      auto* src_base = src_data + src_stride0 * select_indices_data[i];
+      auto scale = scale_data[i * scale_stride];
+      for (int64_t j = 0; j < ddim; j++) {
+        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
+      }
     }
-  }
+  });
 }
 
 template<>
@@ -275,7 +309,6 @@ void index_select_scale_add<float>(const Tensor &select_indices,
         });
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto* add_indices_data = add_indices.data_ptr<int64_t>();
     auto src_stride0 = src.stride(0);
     auto src_stride1 = src.stride(1);
     auto output_stride0 = output.stride(0);
@@ -283,16 +316,78 @@ void index_select_scale_add<float>(const Tensor &select_indices,
     auto scale_stride = scale.stride(0);
     auto numel = add_indices.numel();
 
+    parallel_for_each_bag(offsets, numel, include_last_offset, ddim,
+        [&](int64_t bag, int64_t begin, int64_t end) {
+      auto* output_base = output_data + output_stride0 * bag;
+      for (int64_t i = begin; i < end; i++) {
+        auto* src_base = src_data + src_stride0 * select_indices_data[i];
+        auto scale = scale_data[i * scale_stride];
+        for (int64_t j = 0; j < ddim; j++) {
+          output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
+        }
+      }
+    });
+  }
+}
 
-    for (int64_t i = 0; i < numel; i++) {
+// Sums (optionally scaled) rows of a Half embedding table. Rows are
+// accumulated in float and every output element is rounded to Half once, so
+// long bags do not lose precision to repeated Half additions.
+static void index_select_add_half(const Tensor &select_indices,
+                                  const Tensor &scale,
+                                  const Tensor &src,
+                                  Tensor &output,
+                                  const Tensor& offsets,
+                                  bool include_last_offset) {
+  auto* select_indices_data = select_indices.data_ptr<int64_t>();
+  auto* src_data = src.data_ptr<at::Half>();
+  auto* output_data = output.data_ptr<at::Half>();
+  auto* scale_data = scale.defined() ? scale.data_ptr<at::Half>() : nullptr;
+  auto scale_stride = scale.defined() ? scale.stride(0) : 0;
+  int64_t ddim = src.size(1);
+  auto src_stride0 = src.stride(0);
+  auto src_stride1 = src.stride(1);
+  auto output_stride0 = output.stride(0);
+  auto output_stride1 = output.stride(1);
+
+  parallel_for_each_bag(offsets, select_indices.numel(), include_last_offset, ddim,
+      [&](int64_t bag, int64_t begin, int64_t end) {
+    std::vector<float> acc(ddim, 0.f);
+    for (int64_t i = begin; i < end; i++) {
       auto* src_base = src_data + src_stride0 * select_indices_data[i];
-      auto* output_base = output_data + output_stride0 * add_indices_data[i];
-      auto scale = scale_data[i * scale_stride];
+      float row_scale = scale_data ? static_cast<float>(scale_data[i * scale_stride]) : 1.f;
       for (int64_t j = 0; j < ddim; j++) {
-        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
+        acc[j] += static_cast<float>(src_base[j * src_stride1]) * row_scale;
       }
     }
-  }
+    auto* output_base = output_data + output_stride0 * bag;
+    for (int64_t j = 0; j < ddim; j++) {
+      output_base[j * output_stride1] = static_cast<at::Half>(acc[j]);
+    }
+  });
+}
+
+template<>
+void index_select_add<at::Half>(const Tensor &select_indices,
+                                const Tensor &add_indices,
+                                const Tensor &src,
+                                Tensor &output,
+                                const Tensor& offsets,
+                                bool include_last_offset) {
+  AT_ASSERT(select_indices.numel() == add_indices.numel());
+  index_select_add_half(select_indices, Tensor(), src, output, offsets, include_last_offset);
+}
+
+template<>
+void index_select_scale_add<at::Half>(const Tensor &select_indices,
+                                      const Tensor &add_indices,
+                                      const Tensor &scale,
+                                      const Tensor &src,
+                                      Tensor &output,
+                                      const Tensor& offsets,
+                                      bool include_last_offset) {
+  AT_ASSERT(select_indices.numel() == add_indices.numel());
+  index_select_add_half(select_indices, scale, src, output, offsets, include_last_offset);
 }
 
 }  // namespace
@@ -382,7 +477,6 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
       at::zeros({numBags, featureSize}, indices.options());
 
   auto* indices_data = indices.data_ptr<int64_t>();
-  auto* offset2bag_data = offset2bag.data_ptr<int64_t>();
 
   auto* max_indices_data = max_indices.data_ptr<int64_t>();
   auto max_indices_stride = max_indices.stride(0);
@@ -393,22 +487,24 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
   auto weight_stride1 = weight.stride(1);
   auto output_stride = output.stride(0);
 
-  for (int i = 0; i < numIndices; i++) {
-    auto bag = offset2bag_data[i];
-    auto word_idx = indices_data[i];
+  parallel_for_each_bag(offsets, numIndices, include_last_offset, featureSize,
+      [&](int64_t bag, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      auto word_idx = indices_data[i];
 
-    for (int dim = 0; dim < featureSize; dim++) {
-      auto& current_item = output_data[output_stride * bag + dim];
-      auto weight_item =
-          weight_data[weight_stride0 * word_idx + dim * weight_stride1];
-      bool is_first_for_bag = (i == 0) || offset2bag_data[i - 1] != bag;
+      for (int64_t dim = 0; dim < featureSize; dim++) {
+        auto& current_item = output_data[output_stride * bag + dim];
+        auto weight_item =
+            weight_data[weight_stride0 * word_idx + dim * weight_stride1];
+        bool is_first_for_bag = i == begin;
 
-      if (is_first_for_bag || weight_item > current_item) {
-        current_item = weight_item;
-        max_indices_data[max_indices_stride * bag + dim] = word_idx;
+        if (is_first_for_bag || weight_item > current_item) {
+          current_item = weight_item;
+          max_indices_data[max_indices_stride * bag + dim] = word_idx;
+        }
       }
     }
-  }
+  });
 
   return std::tuple<Tensor, Tensor, Tensor, Tensor>(
       output, offset2bag, bag_size, max_indices);
@@ -429,7 +525,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
   auto offsets_arg = TensorArg(offsets, "offsets", 1);
   checkScalarType("embedding_bag", offsets_arg, kLong);
   auto weight_arg = TensorArg(weight, "weight", 1);
-  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble});
+  checkScalarTypes("embedding_bag", weight_arg, {kHalf, kFloat, kDouble});
   int64_t offset_0 = offsets.data_ptr<int64_t>()[0];
   int64_t offset_n = offsets.data_ptr<int64_t>()[offsets.size(0)-1];
   TORCH_CHECK(offset_0 == 0, "offsets[0] has to be 0, i.e., the first sequence "
@@ -501,7 +597,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> _embedding_bag_cpu_impl(
   }
 
   if (mode == MODE_MEAN || mode == MODE_SUM) {
-    AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_cpu", [&]() {
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(weight.scalar_type(), "embedding_bag_cpu", [&]() {
       if (per_sample_weights.defined()) {
         AT_ASSERT(mode == MODE_SUM);
         index_select_scale_add<scalar_t>(
@@ -898,5 +994,155 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+// Fused embedding_bag backward and optimizer step.
+//
+// Instead of materializing the (num_weights x D) dense gradient, or the
+// (num_indices x D) rows of a sparse one, the positions of `indices` are
+// grouped by the embedding row they read. Each row's gradient is then
+// accumulated in a small per-thread buffer and handed straight to `update`,
+// which applies the optimizer step to that row of `weight` in place. Rows are
+// distinct across groups, so threads never touch the same row.
+template <typename scalar_t, typename update_t>
+static void _embedding_bag_backward_update_cpu_template(
+    const Tensor& weight,
+    const Tensor& grad_,
+    const Tensor& indices_,
+    const Tensor& offsets_,
+    int64_t mode,
+    const Tensor& per_sample_weights_,
+    bool include_last_offset,
+    const update_t& update) {
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      "embedding_bag_backward_update: only mode='sum' and mode='mean' are supported");
+  auto indices_arg = TensorArg(indices_, "indices", 1);
+  checkScalarType("embedding_bag_backward_update", indices_arg, kLong);
+  auto offsets_arg = TensorArg(offsets_, "offsets", 1);
+  checkScalarType("embedding_bag_backward_update", offsets_arg, kLong);
+  TORCH_CHECK(weight.dim() == 2 && weight.is_contiguous(),
+      "embedding_bag_backward_update: weight must be a contiguous 2-D tensor");
+  int64_t ddim = weight.size(1);
+  int64_t num_bags = include_last_offset ? offsets_.numel() - 1 : offsets_.numel();
+  TORCH_CHECK(grad_.dim() == 2 && grad_.size(0) == num_bags && grad_.size(1) == ddim,
+      "embedding_bag_backward_update: expected grad of size [", num_bags, ", ", ddim,
+      "] but got ", grad_.sizes());
+
+  auto grad = grad_.contiguous();
+  auto offsets = offsets_.contiguous();
+  Tensor per_sample_weights;
+  if (per_sample_weights_.defined()) {
+    TORCH_CHECK(mode == MODE_SUM,
+        "embedding_bag_backward_update: per_sample_weights only supported with mode='sum'");
+    TORCH_CHECK(per_sample_weights_.numel() == indices_.numel());
+    per_sample_weights = per_sample_weights_.contiguous();
+  }
+  int64_t numel = indices_.numel();
+  if (numel == 0 || num_bags <= 0) {
+    return;
+  }
+
+  // bag of every position, and the scale its gradient row is multiplied by
+  auto* offsets_data = offsets.data_ptr<int64_t>();
+  std::vector<int64_t> offset2bag(numel);
+  std::vector<scalar_t> scale(numel, 1);
+  for (int64_t bag = 0; bag < num_bags; bag++) {
+    int64_t begin = offsets_data[bag];
+    int64_t end = bag + 1 < offsets.numel() ? offsets_data[bag + 1] : numel;
+    TORCH_CHECK(0 <= begin && begin <= end && end <= numel,
+        "embedding_bag_backward_update: offsets must be non-decreasing and at most ", numel);
+    for (int64_t i = begin; i < end; i++) {
+      offset2bag[i] = bag;
+      if (mode == MODE_MEAN) {
+        scale[i] = scalar_t(1) / (end - begin);
+      }
+    }
+  }
+  if (per_sample_weights.defined()) {
+    auto* per_sample_weights_data = per_sample_weights.data_ptr<scalar_t>();
+    for (int64_t i = 0; i < numel; i++) {
+      scale[i] = per_sample_weights_data[i];
+    }
+  }
+
+  auto ind_sort = indices_.contiguous().sort();
+  auto sorted_indices = std::get<0>(ind_sort);
+  auto sorted_positions = std::get<1>(ind_sort);
+  auto* sorted_indices_data = sorted_indices.data_ptr<int64_t>();
+  auto* sorted_positions_data = sorted_positions.data_ptr<int64_t>();
+  TORCH_CHECK_INDEX(sorted_indices_data[0] >= 0 && sorted_indices_data[numel - 1] < weight.size(0),
+      "embedding_bag_backward_update: index out of range in weight");
+
+  // segment_starts[k] is the first sorted position reading the k-th distinct row
+  std::vector<int64_t> segment_starts;
+  for (int64_t i = 0; i < numel; i++) {
+    if (i == 0 || sorted_indices_data[i] != sorted_indices_data[i - 1]) {
+      segment_starts.push_back(i);
+    }
+  }
+  int64_t num_segments = segment_starts.size();
+  segment_starts.push_back(numel);
+
+  auto* grad_data = grad.data_ptr<scalar_t>();
+  auto* weight_data = weight.data_ptr<scalar_t>();
+  int64_t work_per_segment = std::max<int64_t>(ddim * (numel / num_segments), 1);
+  int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / work_per_segment, 1);
+  at::parallel_for(0, num_segments, grain_size, [&](int64_t start, int64_t end) {
+    std::vector<scalar_t> row_grad(ddim);
+    for (int64_t k = start; k < end; k++) {
+      std::fill(row_grad.begin(), row_grad.end(), scalar_t(0));
+      for (int64_t j = segment_starts[k]; j < segment_starts[k + 1]; j++) {
+        int64_t position = sorted_positions_data[j];
+        THBlas_axpy<scalar_t>(ddim, scale[position],
+            grad_data + ddim * offset2bag[position], 1, row_grad.data(), 1);
+      }
+      int64_t row = sorted_indices_data[segment_starts[k]];
+      update(row, weight_data + ddim * row, row_grad.data(), ddim);
+    }
+  });
+}
+
+Tensor& _embedding_bag_backward_sgd_cpu_(
+    Tensor& weight, const Tensor& grad, const Tensor& indices,
+    const Tensor& offsets, int64_t mode, const Tensor& per_sample_weights,
+    bool include_last_offset, double lr) {
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_backward_sgd", [&] {
+    auto lr_ = static_cast<scalar_t>(lr);
+    _embedding_bag_backward_update_cpu_template<scalar_t>(
+        weight, grad, indices, offsets, mode, per_sample_weights, include_last_offset,
+        [lr_](int64_t /*row*/, scalar_t* w, const scalar_t* g, int64_t n) {
+          for (int64_t i = 0; i < n; i++) {
+            w[i] -= lr_ * g[i];
+          }
+        });
+  });
+  return weight;
+}
+
+// Matches torch.optim.Adagrad (without lr decay or weight decay) on the rows
+// that received a gradient: state_sum += g * g, w -= lr * g / (sqrt(state_sum) + eps).
+Tensor& _embedding_bag_backward_adagrad_cpu_(
+    Tensor& weight, Tensor& state_sum, const Tensor& grad, const Tensor& indices,
+    const Tensor& offsets, int64_t mode, const Tensor& per_sample_weights,
+    bool include_last_offset, double lr, double eps) {
+  TORCH_CHECK(state_sum.sizes() == weight.sizes() && state_sum.is_contiguous() &&
+      state_sum.scalar_type() == weight.scalar_type(),
+      "embedding_bag_backward_adagrad: state_sum must be a contiguous tensor "
+      "with the size and dtype of weight");
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_backward_adagrad", [&] {
+    auto lr_ = static_cast<scalar_t>(lr);
+    auto eps_ = static_cast<scalar_t>(eps);
+    auto* state_sum_data = state_sum.data_ptr<scalar_t>();
+    _embedding_bag_backward_update_cpu_template<scalar_t>(
+        weight, grad, indices, offsets, mode, per_sample_weights, include_last_offset,
+        [=](int64_t row, scalar_t* w, const scalar_t* g, int64_t n) {
+          scalar_t* h = state_sum_data + row * n;
+          for (int64_t i = 0; i < n; i++) {
+            h[i] += g[i] * g[i];
+            w[i] -= lr_ * g[i] / (std::sqrt(h[i]) + eps_);
+          }
+        });
+  });
+  return weight;
+}
 }
 } // namespace at::native
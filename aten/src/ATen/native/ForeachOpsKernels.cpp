@@ -1,23 +1,157 @@
+#include <cmath>
+
 #include <ATen/ATen.h>
 #include <ATen/native/ForeachUtils.h>
 
 namespace at { namespace native {
 
-std::vector<Tensor> foreach_tensor_add_scalar_kernel_slow(TensorList tensors, Scalar scalar) {
-  verify_list(tensors);
+#define FOREACH_BINARY_OP_SCALAR(NAME)                                                                 \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_slow(TensorList tensors, Scalar scalar) {   \
+  verify_list(tensors);                                                                                \
+                                                                                                       \
+  std::vector<Tensor> result;                                                                          \
+  for (const auto& t : tensors) {                                                                      \
+    result.emplace_back(t.NAME(scalar));                                                               \
+  }                                                                                                    \
+  return result;                                                                                       \
+}                                                                                                      \
+                                                                                                       \
+void foreach_tensor_##NAME##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {                 \
+  verify_list(tensors);                                                                                \
+                                                                                                       \
+  for (auto& t : tensors) {                                                                            \
+    t.NAME##_(scalar);                                                                                 \
+  }                                                                                                    \
+}
+
+#define FOREACH_BINARY_OP_LIST(NAME)                                                                   \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_slow(TensorList tensors1, TensorList tensors2) { \
+  verify_list({tensors1, tensors2});                                                                   \
+                                                                                                       \
+  std::vector<Tensor> result;                                                                          \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                       \
+    result.emplace_back(tensors1[i].NAME(tensors2[i]));                                                \
+  }                                                                                                    \
+  return result;                                                                                       \
+}                                                                                                      \
+                                                                                                       \
+void foreach_tensor_##NAME##_list_kernel_slow_(TensorList tensors1, TensorList tensors2) {            \
+  verify_list({tensors1, tensors2});                                                                   \
+                                                                                                       \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                       \
+    tensors1[i].NAME##_(tensors2[i]);                                                                  \
+  }                                                                                                    \
+}
+
+#define FOREACH_UNARY_OP(NAME)                                                                         \
+std::vector<Tensor> foreach_tensor_##NAME##_slow(TensorList tensors) {                                \
+  verify_list(tensors);                                                                                \
+                                                                                                       \
+  std::vector<Tensor> result;                                                                          \
+  for (const auto& t : tensors) {                                                                      \
+    result.emplace_back(t.NAME());                                                                     \
+  }                                                                                                    \
+  return result;                                                                                       \
+}                                                                                                      \
+                                                                                                       \
+void foreach_tensor_##NAME##_slow_(TensorList tensors) {                                              \
+  verify_list(tensors);                                                                                \
+                                                                                                       \
+  for (auto& t : tensors) {                                                                            \
+    t.NAME##_();                                                                                       \
+  }                                                                                                    \
+}
 
-  std::vector<Tensor> result;
-  for (const auto& t : tensors) {
-    result.emplace_back(t.add(scalar));
+#define FOREACH_POINTWISE_OP(NAME)                                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_slow(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+  verify_list({input, tensors1, tensors2});                                                            \
+                                                                                                       \
+  std::vector<Tensor> result;                                                                          \
+  for (size_t i = 0; i < input.size(); i++) {                                                          \
+    result.emplace_back(input[i].NAME(tensors1[i], tensors2[i], scalar));                              \
+  }                                                                                                    \
+  return result;                                                                                       \
+}                                                                                                      \
+                                                                                                       \
+void foreach_tensor_##NAME##_slow_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+  verify_list({input, tensors1, tensors2});                                                            \
+                                                                                                       \
+  for (size_t i = 0; i < input.size(); i++) {                                                          \
+    input[i].NAME##_(tensors1[i], tensors2[i], scalar);                                                \
+  }                                                                                                    \
+}
+
+FOREACH_BINARY_OP_SCALAR(add)
+FOREACH_BINARY_OP_SCALAR(sub)
+FOREACH_BINARY_OP_SCALAR(mul)
+FOREACH_BINARY_OP_SCALAR(div)
+FOREACH_BINARY_OP_LIST(add)
+FOREACH_BINARY_OP_LIST(sub)
+FOREACH_BINARY_OP_LIST(mul)
+FOREACH_BINARY_OP_LIST(div)
+FOREACH_UNARY_OP(sqrt)
+FOREACH_UNARY_OP(exp)
+FOREACH_POINTWISE_OP(addcmul)
+FOREACH_POINTWISE_OP(addcdiv)
+
+// Reference implementations of the fused optimizer steps. They follow
+// torch.optim.Adam (without amsgrad) and torch.optim.SGD op for op, and are
+// what the CUDA kernels fall back to when the fast route does not apply.
+void fused_adam_slow_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    int64_t step) {
+  verify_list({params, grads, exp_avgs, exp_avg_sqs});
+  TORCH_CHECK(step > 0, "_fused_adam_: expected step to be positive, got ", step);
+
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  for (size_t i = 0; i < params.size(); i++) {
+    auto grad = weight_decay != 0 ? grads[i].add(params[i], weight_decay) : grads[i];
+    exp_avgs[i].mul_(beta1).add_(grad, 1 - beta1);
+    exp_avg_sqs[i].mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+    auto denom = exp_avg_sqs[i].sqrt().div_(std::sqrt(bias_correction2)).add_(eps);
+    params[i].addcdiv_(exp_avgs[i], denom, -lr / bias_correction1);
   }
-  return result;
 }
 
-void foreach_tensor_add_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {
-  verify_list(tensors);
+void fused_sgd_slow_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool first_run) {
+  if (momentum != 0) {
+    verify_list({params, grads, momentum_buffers});
+  } else {
+    verify_list({params, grads});
+  }
+  TORCH_CHECK(!nesterov || (momentum > 0 && dampening == 0),
+              "_fused_sgd_: nesterov momentum requires a momentum and zero dampening");
 
-  for (auto& t : tensors) {
-    t.add_(scalar);
+  for (size_t i = 0; i < params.size(); i++) {
+    auto d_p = weight_decay != 0 ? grads[i].add(params[i], weight_decay) : grads[i];
+    if (momentum != 0) {
+      const auto& buf = momentum_buffers[i];
+      if (first_run) {
+        buf.copy_(d_p);
+      } else {
+        buf.mul_(momentum).add_(d_p, 1 - dampening);
+      }
+      d_p = nesterov ? d_p.add(buf, momentum) : buf;
+    }
+    params[i].add_(d_p, -lr);
   }
 }
 
@@ -14,11 +14,32 @@ void verify_list(TensorList tensors) {
   }
 }
 
-// To go via 'fast' path, several conditions must be satisfied 
+// All lists must be non-empty, of the same length and dtype, and the i-th
+// tensors of every list must have the same sizes.
+void verify_list(ArrayRef<TensorList> tensor_lists) {
+  TORCH_CHECK(tensor_lists.size() > 0, "Expected at least one tensor list.");
+  verify_list(tensor_lists[0]);
+  auto expected_dtype = tensor_lists[0][0].dtype();
+
+  for (const auto& tensors : tensor_lists) {
+    TORCH_CHECK(tensors.size() == tensor_lists[0].size(),
+                "Tensor lists must have the same number of tensors, got ",
+                tensor_lists[0].size(), " and ", tensors.size());
+
+    for (size_t i = 0; i < tensors.size(); i++) {
+      TORCH_CHECK(tensors[i].dtype() == expected_dtype, "All tensors in the tensor list must have the same dtype.");
+      TORCH_CHECK(tensors[i].sizes() == tensor_lists[0][i].sizes(),
+                  "Corresponding tensors in lists must have the same size, got ",
+                  tensor_lists[0][i].sizes(), " and ", tensors[i].sizes());
+    }
+  }
+}
+
+// To go via 'fast' path, several conditions must be satisfied
 // - All tensors must have strided layout
 // - All tensors must be non-overlapping and dense
 // - Resulting tensor must have the same dtype as the input one
-bool check_fast_route(TensorList tensors, Scalar scalar) {
+bool check_fast_route(TensorList tensors, Scalar scalar, bool promotes_integer_to_float = false) {
   TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
   auto expected_device = tensors[0].device();
 
@@ -45,10 +66,48 @@ bool check_fast_route(TensorList tensors, Scalar scalar) {
       return false;
     }
 
-    // integral scalar + boolean tensor will result in integral tensor 
+    // integral scalar + boolean tensor will result in integral tensor
     if (scalar.isIntegral(/*includeBool*/ false) && t.dtype() == at::kBool) {
       return false;
     }
+
+    // e.g. true division turns an integral tensor into a float tensor
+    if (promotes_integer_to_float && at::isIntegralType(t.scalar_type(), /*includeBool*/ true)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Multi-tensor kernels walk the underlying storage of corresponding tensors
+// in lockstep, so on top of the single list conditions above they must share
+// device, dtype and strides.
+bool check_fast_route(ArrayRef<TensorList> tensor_lists) {
+  TORCH_CHECK(tensor_lists.size() > 0 && tensor_lists[0].size() > 0,
+              "Tensor list must have at least one tensor.");
+  auto expected_device = tensor_lists[0][0].device();
+  auto expected_dtype = tensor_lists[0][0].dtype();
+
+  for (const auto& tensors : tensor_lists) {
+    for (size_t i = 0; i < tensors.size(); i++) {
+      const auto& t = tensors[i];
+      if (t.device() != expected_device || t.dtype() != expected_dtype) {
+        return false;
+      }
+
+      if (t.layout() != at::kStrided) {
+        return false;
+      }
+
+      if (!t.is_non_overlapping_and_dense()) {
+        return false;
+      }
+
+      if (t.strides() != tensor_lists[0][i].strides()) {
+        return false;
+      }
+    }
   }
 
   return true;
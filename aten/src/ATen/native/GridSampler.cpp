@@ -640,6 +640,14 @@ _grid_sampler_2d_cpu_fallback_backward(const Tensor& grad_output,
 Tensor grid_sampler_2d_cpu(const Tensor& input, const Tensor& grid,
                            int64_t interpolation_mode, int64_t padding_mode,
                            bool align_corners) {
+  // Half and BFloat16 have no Vec256 arithmetic, so sample in float with the
+  // vectorized kernel and round the result once.
+  if (input.scalar_type() == kHalf || input.scalar_type() == kBFloat16) {
+    return grid_sampler_2d_cpu(
+      input.to(kFloat), grid.to(kFloat), interpolation_mode, padding_mode,
+      align_corners).to(input.scalar_type());
+  }
+
   // AVX gather instructions use signed 32-bit offsets to gather float values.
   // Check for possible overflow and fallback to scalar implementation
   if (input.scalar_type() != kDouble) {
@@ -682,6 +690,15 @@ Tensor grid_sampler_3d_cpu(const Tensor& input, const Tensor& grid,
 std::tuple<Tensor, Tensor>
 grid_sampler_2d_backward_cpu(const Tensor& grad_output, const Tensor& input, const Tensor& grid,
                              int64_t interpolation_mode, int64_t padding_mode, bool align_corners) {
+  // Reduced precision is computed in float, as in grid_sampler_2d_cpu.
+  if (input.scalar_type() == kHalf || input.scalar_type() == kBFloat16) {
+    Tensor grad_input, grad_grid;
+    std::tie(grad_input, grad_grid) = grid_sampler_2d_backward_cpu(
+      grad_output.to(kFloat), input.to(kFloat), grid.to(kFloat),
+      interpolation_mode, padding_mode, align_corners);
+    return std::make_tuple(grad_input.to(input.scalar_type()), grad_grid.to(grid.scalar_type()));
+  }
+
   // AVX gather instructions use signed 32-bit offsets to gather float values.
   // Check for possible overflow and fallback to scalar implementation
   if (input.scalar_type() != kDouble) {
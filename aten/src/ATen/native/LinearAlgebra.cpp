@@ -375,6 +375,11 @@ Tensor &addmm_cpu_(Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar
   return addmm_cpu_out(self, self, mat1, mat2, beta, alpha);
 }
 
+Tensor addmm_activation_cpu(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha, bool use_gelu) {
+  Tensor result = addmm_cpu(self, mat1, mat2, beta, alpha);
+  return use_gelu ? at::gelu(result) : at::relu_(result);
+}
+
 Tensor& mm_cpu_out(Tensor & result, const Tensor & self, const Tensor & mat2) {
   TORCH_CHECK(self.dim() == 2, "self must be a matrix");
   TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix");
@@ -389,6 +394,30 @@ Tensor mm_cpu(const Tensor & self, const Tensor & mat2) {
   return addmm_cpu_out(result, result, self, mat2, 0, 1);
 }
 
+// Multiplies every pair self[i] @ mat2[i] of a list of matrices with
+// different sizes. On CUDA the products are computed by batched cuBLAS calls
+// when no gradient is needed, see _grouped_mm_cuda; otherwise every pair goes
+// through mm so autograd records it.
+std::vector<Tensor> grouped_mm(TensorList self, TensorList mat2) {
+  TORCH_CHECK(self.size() == mat2.size(),
+              "grouped_mm: expected the same number of tensors in self and mat2, got ",
+              self.size(), " and ", mat2.size());
+  bool use_grouped = !self.empty();
+  for (size_t i = 0; i < self.size() && use_grouped; i++) {
+    use_grouped = self[i].is_cuda() && mat2[i].is_cuda() &&
+        !(at::GradMode::is_enabled() && (self[i].requires_grad() || mat2[i].requires_grad()));
+  }
+  if (use_grouped) {
+    return at::_grouped_mm(self, mat2);
+  }
+  std::vector<Tensor> result;
+  result.reserve(self.size());
+  for (size_t i = 0; i < self.size(); i++) {
+    result.push_back(at::mm(self[i], mat2[i]));
+  }
+  return result;
+}
+
 template <typename scalar_t, bool is_bmm>
 inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const Tensor& mat2, Scalar beta_, Scalar alpha_) {
   int64_t bs = result.size(0);
@@ -484,15 +513,16 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
 
   if (contraction_size * res_rows * res_cols < 400) {
     if (is_bmm_out) {
-      AT_DISPATCH_ALL_TYPES_AND_COMPLEX(batch1.scalar_type(), "bmm", [&] {
+      AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
         });
     } else {
-      AT_DISPATCH_ALL_TYPES_AND_COMPLEX(batch1.scalar_type(), "baddbmm", [&] {
+      AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, batch1.scalar_type(), "baddbmm", [&] {
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && (at::native::is_floating_point(self_or_result) ||
+  } else if (at::hasMKL() && ((at::native::is_floating_point(self_or_result) &&
+               self_or_result.scalar_type() != kBFloat16) || // MKL has no bfloat16 batch gemm
             at::native::is_complex(self_or_result))
             && batch_items_contiguous_or_transposed(batch1)
             && batch_items_contiguous_or_transposed(batch2)
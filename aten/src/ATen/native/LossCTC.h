@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The recursions of the CPU CTC loss, after LossCTC.cpp checked the arguments.
+// Target s of batch item b is at tg_batch_offsets[b] + s * tg_target_stride
+// of targets, which is int or long.
+using ctc_loss_fn = void(*)(
+    Tensor& neg_log_likelihood,
+    Tensor& log_alpha,
+    const Tensor& log_probs,
+    const Tensor& targets,
+    IntArrayRef input_lengths,
+    IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride,
+    int64_t BLANK);
+
+// grad is contiguous and zero filled.
+using ctc_loss_backward_fn = void(*)(
+    Tensor& grad,
+    const Tensor& grad_out,
+    const Tensor& log_probs,
+    const Tensor& targets,
+    IntArrayRef input_lengths,
+    IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood,
+    const Tensor& log_alpha,
+    int64_t BLANK,
+    bool zero_infinity);
+
+DECLARE_DISPATCH(ctc_loss_fn, ctc_loss_stub);
+DECLARE_DISPATCH(ctc_loss_backward_fn, ctc_loss_backward_stub);
+
+}} // namespace at::native
@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/cpu/SoftmaxKernel.h>
 
 namespace at {
 namespace native {
@@ -393,6 +394,92 @@ Tensor nll_loss_backward_cpu(
   return grad_input;
 }
 
+std::tuple<Tensor, Tensor> _log_softmax_nll_loss_forward_cpu(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index) {
+  TORCH_CHECK(
+      self.dim() == 2, "_log_softmax_nll_loss: expected 2D input, but got ", self.dim(), "D");
+  TORCH_CHECK(
+      target.dim() == 1,
+      "1D target tensor expected, multi-target not supported");
+  TORCH_CHECK(
+      self.size(0) == target.size(0),
+      "size mismatch (got input: ",
+      self.sizes(),
+      ", target: ",
+      target.sizes(),
+      ")")
+  TORCH_CHECK(
+      !weight.defined() || weight.numel() == self.size(-1),
+      "weight tensor should be defined either for all or no classes");
+
+  const auto batch_size = self.size(0);
+  const auto n_classes = self.size(1);
+  auto input = self.contiguous();
+  auto target_contiguous = target.contiguous();
+  auto weight_contiguous = optional_contiguous(weight);
+
+  // log_softmax(self)[i][t] == self[i][t] - logsumexp(self[i]), so only the
+  // logsumexp of every row is needed
+  auto lse = at::empty({batch_size}, input.options());
+  if (input.numel() > 0) {
+    logsumexp_lastdim_kernel(kCPU, lse, input);
+  }
+
+  auto output = at::empty({batch_size}, input.options());
+  auto total_weight = at::empty({}, input.options());
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "log_softmax_nll_loss_forward", [&] {
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    const scalar_t* lse_data = lse.data_ptr<scalar_t>();
+    const int64_t* target_data = target_contiguous.data_ptr<int64_t>();
+    const scalar_t* weight_data = optional_data<scalar_t>(weight_contiguous);
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+
+    at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+      for (auto i = start; i < end; i++) {
+        const auto cur_target = target_data[i];
+        if (cur_target == ignore_index) {
+          output_data[i] = 0;
+          continue;
+        }
+        TORCH_CHECK_INDEX(
+            cur_target >= 0 && cur_target < n_classes,
+            "Target ",
+            cur_target,
+            " is out of bounds.");
+        scalar_t cur_weight = weight_data != nullptr ? weight_data[cur_target]
+                                                     : static_cast<scalar_t>(1);
+        output_data[i] = (lse_data[i] - input_data[i * n_classes + cur_target]) * cur_weight;
+      }
+    });
+
+    // same serial accumulation order as nll_loss
+    scalar_t output_val = 0;
+    scalar_t total_weight_val = 0;
+    for (int64_t i = 0; i < batch_size; i++) {
+      const auto cur_target = target_data[i];
+      if (cur_target != ignore_index) {
+        total_weight_val +=
+            weight_data != nullptr ? weight_data[cur_target] : static_cast<scalar_t>(1);
+        output_val += output_data[i];
+      }
+    }
+    *total_weight.data_ptr<scalar_t>() = total_weight_val;
+    if (reduction != Reduction::None) {
+      if (reduction == Reduction::Mean &&
+          (total_weight_val != 0 || input.numel() == 0)) {
+        // allow NaN result for total_weight_val == 0 case, see #15870
+        output_val /= total_weight_val;
+      }
+      output = at::empty({}, input.options()).fill_(output_val);
+    }
+  });
+  return std::make_tuple(output, total_weight);
+}
+
 Tensor & nll_loss_out(Tensor & output, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index) {
   Tensor total_weight = at::empty({0}, self.options());
   return std::get<0>(at::nll_loss_forward_out(output, total_weight, self, target, weight, reduction, ignore_index));
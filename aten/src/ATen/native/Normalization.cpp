@@ -17,6 +17,9 @@ static const int MIOPEN_DIM_MAX = 5;
 namespace at { namespace native {
 
 DEFINE_DISPATCH(batch_norm_cpu_inference_contiguous_stub);
+DEFINE_DISPATCH(batch_norm_cpu_channels_last_stub);
+DEFINE_DISPATCH(batch_norm_cpu_collect_stats_channels_last_stub);
+DEFINE_DISPATCH(batch_norm_cpu_backward_channels_last_stub);
 
 namespace {
   void check_dims_match_num_input_features(const char* arg_name, int64_t expected, int64_t actual){
@@ -30,6 +33,17 @@ namespace {
     }
     return t;
   }
+
+  // ChannelsLast and ChannelsLast3d tensors store C innermost, so the channels
+  // last kernels can treat them as a {numel / C, C} matrix.
+  static inline bool is_channels_last_contiguous(const Tensor& t) {
+    return t.is_contiguous(at::MemoryFormat::ChannelsLast) ||
+        t.is_contiguous(at::MemoryFormat::ChannelsLast3d);
+  }
+
+  static inline bool is_contiguous_if_defined(const Tensor& t) {
+    return !t.defined() || t.is_contiguous();
+  }
 }
 
 // TensorAccessor when it is defined to work around undefined...
@@ -90,58 +104,6 @@ void batch_norm_cpu_inference_collect_linear_and_constant_terms(
   }
 }
 
-/// A fast path for CPU inference when all tensors are channels last contiguous.
-/// This code achieves machine bandwidth peak without AVX support.
-/// If this changes for future architectures, we can move it to the cpu/
-/// directory.
-template<typename scalar_t>
-void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
-    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    const Tensor& mean, const Tensor& variance, double eps) {
-
-  int64_t n_batch = input.size(0);
-  int64_t n_channel = input.size(1);
-  int64_t image_size = input.numel() / n_batch / n_channel;
-
-  scalar_t* output_data = output.data_ptr<scalar_t>();
-  const scalar_t* input_data = input.data_ptr<scalar_t>();
-
-  Tensor alpha = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor beta = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
-  scalar_t* beta_data = beta.data_ptr<scalar_t>();
-
-  batch_norm_cpu_inference_collect_linear_and_constant_terms<scalar_t>(
-      alpha_data, beta_data, n_channel, weight, bias, mean, variance, eps);
-
-  // Apply the linear terms to the input,
-  // output(n, c, h, w) = input(n, c, h, w) * alpha(c) + beta(c)
-  // No need to use parallel_for as this function is supposed to be
-  // memory-limited.
-  // Keep the loop struture simple to make sure compiler vectorization kicks in.
-  if (n_channel != 1) {
-    for (int64_t n = 0; n < n_batch; ++n) {
-      for (int64_t i = 0; i < image_size; ++i) {
-        for (int64_t c = 0; c < n_channel; ++c) {
-          // Keep all the offset calculation within the inner loop for
-          // simplicity. Compilers are very good at hoisting the common part
-          // outside.
-          int64_t offset = n * image_size * n_channel + i * n_channel + c;
-          output_data[offset] = input_data[offset] * alpha_data[c] + beta_data[c];
-        }
-      }
-    }
-  } else {
-    // n_channel == 1
-    for (int64_t n = 0; n < n_batch; ++n) {
-      for (int64_t i = 0; i < image_size; ++i) {
-        int64_t offset = n * image_size + i;
-        output_data[offset] = input_data[offset] * alpha_data[0] + beta_data[0];
-      }
-    }
-  }
-}
-
 template<typename scalar_t>
 std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -163,15 +125,34 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
   }
 
   // Check if we should use the fast path for channel last memory format
-  if (!train && input.is_contiguous(at::MemoryFormat::ChannelsLast)
-      && (!weight.defined() || weight.is_contiguous())
-      && (!bias.defined() || bias.is_contiguous())
-      && running_mean.is_contiguous()
-      && running_var.is_contiguous()) {
-
-    Tensor output = at::empty_like(input, at::MemoryFormat::ChannelsLast);
-    batch_norm_cpu_inference_channels_last<scalar_t>(
-      output, input, weight, bias, running_mean, running_var, eps);
+  if (is_channels_last_contiguous(input)
+      && is_contiguous_if_defined(weight)
+      && is_contiguous_if_defined(bias)
+      && (train ? save_mean.is_contiguous() && save_invstd.is_contiguous()
+                : running_mean.is_contiguous() && running_var.is_contiguous())) {
+
+    int64_t n_channel = input.size(1);
+    Tensor output = at::empty_like(input, input.suggest_memory_format());
+    Tensor alpha = at::empty({n_channel}, input.options());
+    Tensor beta = at::empty({n_channel}, input.options());
+    scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+    scalar_t* beta_data = beta.data_ptr<scalar_t>();
+    if (train) {
+      const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+      const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+      const scalar_t* mean_data = save_mean.data_ptr<scalar_t>();
+      const scalar_t* invstd_data = save_invstd.data_ptr<scalar_t>();
+      for (int64_t c = 0; c < n_channel; c++) {
+        scalar_t weight_v = weight_data ? weight_data[c] : 1;
+        scalar_t bias_v = bias_data ? bias_data[c] : 0;
+        alpha_data[c] = invstd_data[c] * weight_v;
+        beta_data[c] = bias_v - mean_data[c] * alpha_data[c];
+      }
+    } else {
+      batch_norm_cpu_inference_collect_linear_and_constant_terms<scalar_t>(
+          alpha_data, beta_data, n_channel, weight, bias, running_mean, running_var, eps);
+    }
+    batch_norm_cpu_channels_last_stub(kCPU, output, input, alpha, beta);
     return std::make_tuple(output, save_mean, save_invstd);
   }
 
@@ -230,6 +211,26 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (is_channels_last_contiguous(input)) {
+    Tensor var_sum = at::empty({n_input}, input.options());
+    batch_norm_cpu_collect_stats_channels_last_stub(kCPU, save_mean, var_sum, input);
+    auto var_sum_a = var_sum.accessor<scalar_t, 1>();
+    for (int64_t f = 0; f < n_input; ++f) {
+      accscalar_t var_sum_v = var_sum_a[f];
+      save_var_transform_a[f] = VarTransform<accscalar_t>{}(var_sum_v / n, eps);
+
+      // update running averages
+      if (running_mean.defined()) {
+        running_mean_a[f] = momentum * save_mean_a[f] + (1 - momentum) * running_mean_a[f];
+      }
+      if (running_var.defined()) {
+        accscalar_t unbiased_var = var_sum_v / (n - 1);
+        running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
+      }
+    }
+    return std::make_tuple(save_mean, save_var_transform);
+  }
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -279,8 +280,15 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_input;
   Tensor grad_weight;
   Tensor grad_bias;
+  const bool channels_last = is_channels_last_contiguous(input)
+      && grad_out_.is_contiguous(input.suggest_memory_format())
+      && is_contiguous_if_defined(weight)
+      && (train ? save_mean.is_contiguous() && save_invstd.is_contiguous()
+                : running_mean.is_contiguous() && running_var.is_contiguous());
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    grad_input = channels_last
+        ? at::empty_like(input, input.suggest_memory_format())
+        : at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -302,6 +310,20 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (channels_last) {
+    Tensor mean = train ? save_mean : running_mean;
+    Tensor invstd = save_invstd;
+    if (!train) {
+      invstd = at::empty({n_input}, input.options());
+      auto invstd_a = invstd.accessor<scalar_t, 1>();
+      for (int64_t f = 0; f < n_input; ++f) {
+        invstd_a[f] = 1 / std::sqrt(running_var_a[f] + eps);
+      }
+    }
+    batch_norm_cpu_backward_channels_last_stub(kCPU, grad_input, grad_weight, grad_bias,
+        grad_out_, input, weight, mean, invstd, train);
+    return std::make_tuple(grad_input, grad_weight, grad_bias);
+  }
 
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t f = b_begin; f < b_end; ++f) {
@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/div_rtn.h>
+#include <ATen/native/DispatchStub.h>
 #include <tuple>
 
 #pragma once
@@ -9,6 +10,15 @@
 namespace at {
 namespace native {
 
+using max_pool2d_fn = void(*)(Tensor& output, Tensor& indices, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH, int dilationW, int dilationH);
+using max_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output, const Tensor& indices);
+
+// NHWC kernels: a channels last input is pooled without converting it to
+// NCHW, every output pixel is computed for all channels at once.
+DECLARE_DISPATCH(max_pool2d_fn, max_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(max_pool2d_backward_fn, max_pool2d_backward_channels_last_kernel);
+
 namespace {
 
 template <typename dest_t, typename src_t>
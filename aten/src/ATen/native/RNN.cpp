@@ -2,6 +2,8 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
@@ -642,6 +644,64 @@ tpair_of<Tensor> hidden_slice(const tpair_of<Tensor>& t, int64_t start, int64_t
                          hidden_slice(std::get<1>(t), start, end));
 }
 
+// The gates of LSTM and GRU cells on CPU go through one kernel rather than a
+// chain of pointwise ops. The gates come out of linear layers on every path:
+// float, fp16 and int8 weights, so the quantized RNNs take it too. When
+// autograd records the cell, it goes through _thnn_fused_lstm_cell and
+// _thnn_fused_gru_cell instead, which keep a workspace for their fused
+// backward.
+bool use_fused_cell_cpu(const Tensor& input_gates, const Tensor& hidden_gates, TensorList hiddens) {
+  if (!input_gates.device().is_cpu() || input_gates.dim() != 2 ||
+      input_gates.sizes() != hidden_gates.sizes()) {
+    return false;
+  }
+  const auto type = input_gates.scalar_type();
+  if (type != kFloat && type != kDouble) {
+    return false;
+  }
+  std::vector<Tensor> tensors(hiddens.begin(), hiddens.end());
+  tensors.insert(tensors.end(), {input_gates, hidden_gates});
+  for (const auto& t : tensors) {
+    if (t.scalar_type() != type || t.dim() != 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool cell_requires_grad(TensorList tensors) {
+  return GradMode::is_enabled() &&
+      std::any_of(tensors.begin(), tensors.end(), [](const Tensor& t) { return t.requires_grad(); });
+}
+
+tpair_of<Tensor> fused_lstm_cell_cpu(
+    const Tensor& input_gates, const Tensor& hidden_gates, const Tensor& cx) {
+  if (cell_requires_grad({input_gates, hidden_gates, cx})) {
+    auto result = at::_thnn_fused_lstm_cell(input_gates, hidden_gates, cx);
+    return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
+  }
+  auto cx_ = cx.contiguous();
+  auto hy = at::empty_like(cx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto cy = at::empty_like(cx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor no_workspace;
+  lstm_cell_cpu_stub(
+      kCPU, hy, cy, no_workspace, input_gates.contiguous(), hidden_gates.contiguous(), Tensor(), Tensor(), cx_);
+  return std::make_tuple(std::move(hy), std::move(cy));
+}
+
+Tensor fused_gru_cell_cpu(
+    const Tensor& input_gates, const Tensor& hidden_gates, const Tensor& hx) {
+  if (cell_requires_grad({input_gates, hidden_gates, hx})) {
+    return std::get<0>(at::_thnn_fused_gru_cell(input_gates, hidden_gates, hx));
+  }
+  auto hx_ = hx.contiguous();
+  auto hy = at::empty_like(hx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor no_workspace;
+  gru_cell_cpu_stub(
+      kCPU, hy, no_workspace, input_gates.contiguous(), hidden_gates.contiguous(), Tensor(), Tensor(), hx_);
+  return hy;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // CELL IMPLEMENTATIONS
 //
@@ -705,8 +765,12 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
     }
 
-    const auto gates = params.linear_hh(hx).add_(
-        pre_compute_input ? input : params.linear_ih(input));
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hx);
+    if (use_fused_cell_cpu(igates, hgates, {hx, cx})) {
+      return fused_lstm_cell_cpu(igates, hgates, cx);
+    }
+    const auto gates = hgates.add_(igates);
     auto chunked_gates = gates.unsafe_chunk(4, 1);
     auto ingate = chunked_gates[0].sigmoid_();
     auto forgetgate = chunked_gates[1].sigmoid_();
@@ -737,10 +801,13 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
-    const auto chunked_igates = pre_compute_input
-        ? input.unsafe_chunk(3, 1)
-        : params.linear_ih(input).unsafe_chunk(3, 1);
-    auto chunked_hgates = params.linear_hh(hidden).unsafe_chunk(3, 1);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hidden);
+    if (use_fused_cell_cpu(igates, hgates, {hidden})) {
+      return fused_gru_cell_cpu(igates, hgates, hidden);
+    }
+    const auto chunked_igates = igates.unsafe_chunk(3, 1);
+    auto chunked_hgates = hgates.unsafe_chunk(3, 1);
     const auto reset_gate =
         chunked_hgates[0].add_(chunked_igates[0]).sigmoid_();
     const auto input_gate =
@@ -780,6 +847,75 @@ struct Layer {
       const param_type& params) const = 0;
 };
 
+// Whole layers of LSTM and GRU cells on CUDA can run as a single persistent
+// kernel, see Note [Persistent RNN] in cuda/RNN.cu. The kernels have no
+// backward, so they are only used when nothing requires grad.
+bool use_persistent_rnn(const Tensor& input, TensorList hiddens, const CellParams& params) {
+  if (!input.is_cuda() || input.dim() != 3) {
+    return false;
+  }
+  const auto type = input.scalar_type();
+  if (type != kFloat && type != kDouble && type != kHalf) {
+    return false;
+  }
+  std::vector<Tensor> tensors(hiddens.begin(), hiddens.end());
+  tensors.insert(tensors.end(), {input, params.w_ih, params.w_hh, params.b_ih_, params.b_hh_});
+  for (const auto& t : tensors) {
+    if (t.defined() && (t.scalar_type() != type || (GradMode::is_enabled() && t.requires_grad()))) {
+      return false;
+    }
+  }
+  const int64_t hidden_size = params.w_hh.size(1);
+  return persistent_rnn_fits(params.w_hh.size(0), hidden_size, hidden_size, /*has_proj=*/false, type);
+}
+
+// Runs the layer of the given cell over all of inputs with one kernel and
+// returns true, or returns false if the cell or the layer does not qualify.
+template<typename hidden_type, typename cell_params>
+bool try_persistent_layer(
+    const Cell<hidden_type, cell_params>& cell,
+    const Tensor& inputs,
+    const hidden_type& input_hidden,
+    const cell_params& params,
+    LayerOutput<Tensor, hidden_type>& output) {
+  return false;
+}
+
+bool try_persistent_layer(
+    const Cell<tpair_of<Tensor>, CellParams>& cell,
+    const Tensor& inputs,
+    const tpair_of<Tensor>& input_hidden,
+    const CellParams& params,
+    LayerOutput<Tensor, tpair_of<Tensor>>& output) {
+  const auto& hx = std::get<0>(input_hidden);
+  const auto& cx = std::get<1>(input_hidden);
+  if (!dynamic_cast<const LSTMCell<CellParams>*>(&cell) ||
+      !use_persistent_rnn(inputs, {hx, cx}, params)) {
+    return false;
+  }
+  auto result = at::_thnn_persistent_lstm(
+      params.linear_ih(inputs), hx, cx, params.w_hh, params.b_hh());
+  output = {std::move(std::get<0>(result)),
+            std::make_tuple(std::move(std::get<1>(result)), std::move(std::get<2>(result)))};
+  return true;
+}
+
+bool try_persistent_layer(
+    const Cell<Tensor, CellParams>& cell,
+    const Tensor& inputs,
+    const Tensor& input_hidden,
+    const CellParams& params,
+    LayerOutput<Tensor, Tensor>& output) {
+  if (!dynamic_cast<const GRUCell<CellParams>*>(&cell) ||
+      !use_persistent_rnn(inputs, {input_hidden}, params)) {
+    return false;
+  }
+  auto result = at::_thnn_persistent_gru(
+      params.linear_ih(inputs), input_hidden, params.w_hh, params.b_hh());
+  output = {std::move(std::get<0>(result)), std::move(std::get<1>(result))};
+  return true;
+}
+
 template<typename hidden_type, typename cell_params>
 struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
   using output_type =
@@ -814,6 +950,10 @@ struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
       return {at::stack(unstacked_output.outputs, 0),
               unstacked_output.final_hidden};
     }
+    output_type persistent_output;
+    if (try_persistent_layer(cell_, inputs, input_hidden, params, persistent_output)) {
+      return persistent_output;
+    }
     auto unstacked_output = (*this)(inputs.unbind(0), input_hidden, params);
     return {at::stack(unstacked_output.outputs, 0),
             unstacked_output.final_hidden};
@@ -1120,6 +1260,11 @@ std::tuple<io_type, Tensor, Tensor> _lstm_impl(
 
 } // anonymous namespace
 
+DEFINE_DISPATCH(lstm_cell_cpu_stub);
+DEFINE_DISPATCH(gru_cell_cpu_stub);
+DEFINE_DISPATCH(lstm_cell_backward_cpu_stub);
+DEFINE_DISPATCH(gru_cell_backward_cpu_stub);
+
 bool _use_cudnn_rnn_flatten_weight() {
   return detail::getCUDAHooks().compiledWithCuDNN();
 }
@@ -1548,6 +1693,112 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_differentiable_gru_cell
                          std::move(grad_hx), std::move(grad_input_bias), std::move(grad_hidden_bias));
 }
 
+static void check_fused_cell_cpu(
+    CheckedFrom c, const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& prev_hidden, int64_t factor) {
+  TensorArg input_gates_arg{input_gates, "input_gates", 1}, hidden_gates_arg{hidden_gates, "hidden_gates", 2},
+            prev_hidden_arg{prev_hidden, "prev_hidden", 5};
+  checkDim(c, input_gates_arg, 2);
+  checkSameSize(c, input_gates_arg, hidden_gates_arg);
+  checkSize(c, prev_hidden_arg, {input_gates.size(0), input_gates.size(1) / factor});
+  checkNumel(c, input_gates_arg, prev_hidden.numel() * factor);
+  checkAllSameType(c, {input_gates_arg, hidden_gates_arg, prev_hidden_arg});
+  TORCH_CHECK(input_bias.defined() == hidden_bias.defined(),
+              c, ": expected either both or none of the biases");
+  if (input_bias.defined()) {
+    TensorArg input_bias_arg{input_bias, "input_bias", 3}, hidden_bias_arg{hidden_bias, "hidden_bias", 4};
+    checkDim(c, input_bias_arg, 1);
+    checkNumel(c, input_bias_arg, input_gates.size(1));
+    checkSameSize(c, input_bias_arg, hidden_bias_arg);
+    checkAllSameType(c, {input_gates_arg, input_bias_arg, hidden_bias_arg});
+  }
+}
+
+std::tuple<Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_cpu(
+    const Tensor& input_gates, const Tensor& hidden_gates, const Tensor& cx,
+    const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_cpu("_thnn_fused_lstm_cell_cpu", input_gates, hidden_gates,
+                       input_bias, hidden_bias, cx, /*factor=*/4);
+  auto cx_ = cx.contiguous();
+  auto workspace = at::empty_like(input_gates, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto hy = at::empty_like(cx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto cy = at::empty_like(cx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  lstm_cell_cpu_stub(
+      kCPU, hy, cy, workspace, input_gates.contiguous(), hidden_gates.contiguous(),
+      input_bias.defined() ? input_bias.contiguous() : input_bias,
+      hidden_bias.defined() ? hidden_bias.contiguous() : hidden_bias, cx_);
+  return std::make_tuple(std::move(hy), std::move(cy), std::move(workspace));
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_backward_cpu(
+    const Tensor& grad_hy, const Tensor& grad_cy,
+    const Tensor& cx, const Tensor& cy,
+    const Tensor& workspace, bool has_bias) {
+  if (!grad_hy.defined() && !grad_cy.defined()) {
+    return std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>();
+  }
+  CheckedFrom c = "_thnn_fused_lstm_cell_backward_cpu";
+  TensorArg cx_arg{cx, "cx", 3}, cy_arg{cy, "cy", 4}, workspace_arg{workspace, "workspace", 5};
+  checkDim(c, cx_arg, 2);
+  checkSameSize(c, cx_arg, cy_arg);
+  checkSize(c, workspace_arg, {cx.size(0), 4 * cx.size(1)});
+  if (grad_hy.defined()) {
+    checkSameSize(c, TensorArg{grad_hy, "grad_hy", 1}, cx_arg);
+  }
+  if (grad_cy.defined()) {
+    checkSameSize(c, TensorArg{grad_cy, "grad_cy", 2}, cx_arg);
+  }
+  auto cx_ = cx.contiguous();
+  auto grad_gates = at::empty_like(workspace, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto grad_cx = at::empty_like(cx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  lstm_cell_backward_cpu_stub(
+      kCPU, grad_gates, grad_cx,
+      grad_hy.defined() ? grad_hy.contiguous() : grad_hy,
+      grad_cy.defined() ? grad_cy.contiguous() : grad_cy,
+      cx_, cy.contiguous(), workspace.contiguous());
+  auto grad_bias = has_bias ? grad_gates.sum(0, /*keepdim=*/false) : at::Tensor{};
+  return std::make_tuple(grad_gates, grad_gates, std::move(grad_cx), grad_bias, grad_bias);
+}
+
+// hy and the workspace of the fused GRU cells, see gru_cell_fn in RNN.h
+static constexpr int64_t kGRUWorkspaceMultiplier = 5;
+
+std::tuple<Tensor, Tensor> _thnn_fused_gru_cell_cpu(
+    const Tensor& input_gates, const Tensor& hidden_gates, const Tensor& hx,
+    const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_cpu("_thnn_fused_gru_cell_cpu", input_gates, hidden_gates,
+                       input_bias, hidden_bias, hx, /*factor=*/3);
+  auto hx_ = hx.contiguous();
+  auto workspace = at::empty({hx.size(0), hx.size(1) * kGRUWorkspaceMultiplier}, hx.options());
+  auto hy = at::empty_like(hx_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  gru_cell_cpu_stub(
+      kCPU, hy, workspace, input_gates.contiguous(), hidden_gates.contiguous(),
+      input_bias.defined() ? input_bias.contiguous() : input_bias,
+      hidden_bias.defined() ? hidden_bias.contiguous() : hidden_bias, hx_);
+  return std::make_tuple(std::move(hy), std::move(workspace));
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_gru_cell_backward_cpu(
+    const Tensor& grad_hy, const Tensor& workspace, bool has_bias) {
+  CheckedFrom c = "_thnn_fused_gru_cell_backward_cpu";
+  TensorArg grad_hy_arg{grad_hy, "grad_hy", 1}, workspace_arg{workspace, "workspace", 2};
+  checkDim(c, grad_hy_arg, 2);
+  checkSize(c, workspace_arg, {grad_hy.size(0), grad_hy.size(1) * kGRUWorkspaceMultiplier});
+  const int64_t hidden_size = grad_hy.size(1);
+  auto grad_input_gates = at::empty({grad_hy.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hidden_gates = at::empty({grad_hy.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hx = at::empty_like(grad_hy, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  gru_cell_backward_cpu_stub(
+      kCPU, grad_input_gates, grad_hidden_gates, grad_hx, grad_hy.contiguous(), workspace.contiguous());
+  Tensor grad_input_bias, grad_hidden_bias;
+  if (has_bias) {
+    grad_input_bias = grad_input_gates.sum(0, /*keepdim=*/false);
+    grad_hidden_bias = grad_hidden_gates.sum(0, /*keepdim=*/false);
+  }
+  return std::make_tuple(std::move(grad_input_gates), std::move(grad_hidden_gates),
+                         std::move(grad_hx), std::move(grad_input_bias), std::move(grad_hidden_bias));
+}
+
 Tensor gru_cell(
     const Tensor& input, const Tensor& hx,
     const Tensor& w_ih, const Tensor& w_hh, const Tensor& b_ih, const Tensor& b_hh) {
@@ -27,6 +27,53 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// The pointwise part of an LSTM or GRU cell, from the gates of the input and
+// of the hidden state to the new hidden state, in one pass on CPU. Takes
+// contiguous tensors of one floating type. The biases are either both
+// undefined or both defined, and the workspace for the backward, laid out as
+// the one of _thnn_fused_lstm_cell and _thnn_fused_gru_cell on CUDA, is only
+// written when it is defined.
+using lstm_cell_fn = void(*)(Tensor& hy, Tensor& cy, Tensor& workspace, const Tensor& input_gates, const Tensor& hidden_gates,
+                             const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& cx);
+using gru_cell_fn = void(*)(Tensor& hy, Tensor& workspace, const Tensor& input_gates, const Tensor& hidden_gates,
+                            const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& hx);
+// The gradients of the gates from the workspace. Either of grad_hy and
+// grad_cy can be undefined.
+using lstm_cell_backward_fn = void(*)(Tensor& grad_gates, Tensor& grad_cx, const Tensor& grad_hy, const Tensor& grad_cy,
+                                      const Tensor& cx, const Tensor& cy, const Tensor& workspace);
+using gru_cell_backward_fn = void(*)(Tensor& grad_input_gates, Tensor& grad_hidden_gates, Tensor& grad_hx,
+                                     const Tensor& grad_hy, const Tensor& workspace);
+
+DECLARE_DISPATCH(lstm_cell_fn, lstm_cell_cpu_stub);
+DECLARE_DISPATCH(gru_cell_fn, gru_cell_cpu_stub);
+DECLARE_DISPATCH(lstm_cell_backward_fn, lstm_cell_backward_cpu_stub);
+DECLARE_DISPATCH(gru_cell_backward_fn, gru_cell_backward_cpu_stub);
+
+// Shared memory one block of the persistent RNN kernels needs: the
+// hidden-to-hidden (and projection) weights of the layer in the input type
+// plus the state of one batch entry in the accumulate type, see
+// [Persistent RNN] in cuda/RNN.cu. output_size is the projection size of an
+// LSTM with projections and the hidden size otherwise.
+inline int64_t persistent_rnn_shared_memory_size(
+    int64_t gate_size, int64_t hidden_size, int64_t output_size, bool has_proj, ScalarType type) {
+  const int64_t acc_size = type == kDouble ? 8 : 4;
+  const int64_t state = output_size + 2 * hidden_size + gate_size;
+  const int64_t weights = gate_size * output_size + (has_proj ? hidden_size * output_size : 0);
+  return state * acc_size + weights * elementSize(type);
+}
+
+// Limits that hold on every supported GPU without opting in to more shared
+// memory per block. A block has one thread per gate.
+constexpr int64_t kPersistentRNNMaxSharedMemory = 48 * 1024;
+constexpr int64_t kPersistentRNNMaxThreads = 1024;
+
+inline bool persistent_rnn_fits(
+    int64_t gate_size, int64_t hidden_size, int64_t output_size, bool has_proj, ScalarType type) {
+  return gate_size <= kPersistentRNNMaxThreads &&
+      persistent_rnn_shared_memory_size(gate_size, hidden_size, output_size, has_proj, type) <=
+          kPersistentRNNMaxSharedMemory;
+}
+
 inline void check_attributes(const Tensor& input, const TensorList& params, const TensorList& hiddens, bool check_dtype=false) {
   auto input_device = input.device();
   auto input_dtype = input.scalar_type();
@@ -34,6 +34,7 @@ DEFINE_DISPATCH(and_stub);
 DEFINE_DISPATCH(or_stub);
 DEFINE_DISPATCH(min_values_stub);
 DEFINE_DISPATCH(max_values_stub);
+DEFINE_DISPATCH(aminmax_stub);
 DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
@@ -657,6 +658,23 @@ Tensor amax(const Tensor& self, IntArrayRef dim, bool keepdim) {
   return at::amax_out(result, self, dim, keepdim);
 }
 
+std::tuple<Tensor&, Tensor&> _aminmax_out(Tensor& min, Tensor& max, const Tensor& self, IntArrayRef dim, bool keepdim) {
+  TORCH_CHECK(!self.is_complex(), "_aminmax is not yet implemented for complex tensors.");
+  TORCH_CHECK(self.scalar_type() == min.scalar_type() && self.scalar_type() == max.scalar_type(),
+              "Illegal dtype for self, and out:", self.scalar_type(), min.scalar_type(), max.scalar_type());
+  auto iter = make_reduction("_aminmax", min, max, self, dim, keepdim, self.scalar_type());
+  TORCH_CHECK(iter.numel() > 0, "operation does not have an identity");
+  aminmax_stub(iter.device_type(), iter);
+  return std::tuple<Tensor&, Tensor&>(min, max);
+}
+
+std::tuple<Tensor, Tensor> _aminmax(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  Tensor min = at::empty({0}, self.options());
+  Tensor max = at::empty({0}, self.options());
+  at::_aminmax_out(min, max, self, dim, keepdim);
+  return std::tuple<Tensor, Tensor>(min, max);
+}
+
 Tensor& argmax_out(Tensor& result, const Tensor& self, c10::optional<int64_t> dim, bool keepdim) {
   TORCH_CHECK(self.numel() > 0, "cannot perform reduction function argmax on a "
       "tensor with no elements because the operation does not have an identity");
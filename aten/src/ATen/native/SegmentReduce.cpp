@@ -0,0 +1,65 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/WrapDimUtils.h>
+
+#include <ATen/native/SegmentReduce.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(segment_reduce_stub);
+
+namespace {
+
+SegmentReductionType get_segment_reduction_type(const std::string& reduce) {
+  if (reduce == "max") {
+    return SegmentReductionType::MAX;
+  } else if (reduce == "mean") {
+    return SegmentReductionType::MEAN;
+  } else if (reduce == "min") {
+    return SegmentReductionType::MIN;
+  } else if (reduce == "sum") {
+    return SegmentReductionType::SUM;
+  }
+  TORCH_CHECK(false, "segment_reduce: reduce must be one of \"max\", \"mean\", \"min\" or \"sum\", but got \"", reduce, "\"");
+}
+
+} // namespace
+
+// The segments are given by offsets rather than by lengths, so that the
+// kernels find the segment of every output without a scan, and the checks
+// below don't need one either. They read offsets on the host, which
+// synchronizes with a CUDA device, like repeat_interleave does.
+Tensor segment_reduce_kernel(const Tensor& data, std::string reduce, const Tensor& offsets, int64_t axis) {
+  const auto reduction = get_segment_reduction_type(reduce);
+  TORCH_CHECK(data.dim() > 0, "segment_reduce: data must have at least one dimension");
+  axis = maybe_wrap_dim(axis, data.dim());
+  TORCH_CHECK(offsets.dim() == 1 && offsets.numel() > 0,
+      "segment_reduce: offsets must be a non empty 1-D tensor, but got one of sizes ", offsets.sizes());
+  TORCH_CHECK(offsets.scalar_type() == kLong,
+      "segment_reduce: offsets must be a long tensor, but got one of type ", offsets.scalar_type());
+  TORCH_CHECK(offsets.device() == data.device(),
+      "segment_reduce: offsets must be on the device of data (", data.device(), "), but are on ", offsets.device());
+  TORCH_CHECK(at::isFloatingType(data.scalar_type()),
+      "segment_reduce: data must be a floating point tensor, but got one of type ", data.scalar_type());
+
+  const int64_t size = data.size(axis);
+  const int64_t num_segments = offsets.numel() - 1;
+  const auto offsets_ = offsets.contiguous();
+  TORCH_CHECK(offsets_[0].item<int64_t>() == 0 && offsets_[num_segments].item<int64_t>() == size,
+      "segment_reduce: offsets must start at 0 and end at the size of data in axis (", size, ")");
+  TORCH_CHECK(num_segments == 0 || (offsets_.slice(0, 1) >= offsets_.slice(0, 0, -1)).all().item<bool>(),
+      "segment_reduce: offsets must be non decreasing");
+
+  auto output_sizes = data.sizes().vec();
+  output_sizes[axis] = num_segments;
+  Tensor output = at::empty(output_sizes, data.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  const int64_t outer_size = c10::size_to_dim_(axis, data.sizes());
+  const int64_t inner_size = c10::size_from_dim_(axis + 1, data.sizes());
+  segment_reduce_stub(data.device().type(), output, data.contiguous(), reduction, offsets_, outer_size, inner_size);
+  return output;
+}
+
+}} // namespace at::native
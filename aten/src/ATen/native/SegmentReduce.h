@@ -0,0 +1,59 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <limits>
+
+namespace at { namespace native {
+
+enum class SegmentReductionType { MAX, MEAN, MIN, SUM };
+
+// Reduces the segments [offsets[s], offsets[s + 1]) of the middle dimension of
+// data, a contiguous (outer_size, size, inner_size) tensor, into output, a
+// contiguous (outer_size, num_segments, inner_size) tensor. offsets is a long
+// tensor on the device of data which SegmentReduce.cpp checked.
+using segment_reduce_fn = void(*)(
+    Tensor& output,
+    const Tensor& data,
+    SegmentReductionType reduction,
+    const Tensor& offsets,
+    int64_t outer_size,
+    int64_t inner_size);
+
+DECLARE_DISPATCH(segment_reduce_fn, segment_reduce_stub);
+
+// The value of an empty segment before the mean divides it by its length,
+// which makes the mean of an empty segment NaN.
+template <typename acc_t>
+C10_HOST_DEVICE inline acc_t segment_reduce_identity(SegmentReductionType reduction) {
+  switch (reduction) {
+    case SegmentReductionType::MAX:
+      return -std::numeric_limits<acc_t>::infinity();
+    case SegmentReductionType::MIN:
+      return std::numeric_limits<acc_t>::infinity();
+    default:
+      return acc_t(0);
+  }
+}
+
+// max and min propagate NaN like torch.max and torch.min
+template <typename acc_t>
+C10_HOST_DEVICE inline acc_t segment_reduce_combine(SegmentReductionType reduction, acc_t a, acc_t b) {
+  switch (reduction) {
+    case SegmentReductionType::MAX:
+      return (_isnan(a) || a > b) ? a : b;
+    case SegmentReductionType::MIN:
+      return (_isnan(a) || a < b) ? a : b;
+    default:
+      return a + b;
+  }
+}
+
+template <typename acc_t>
+C10_HOST_DEVICE inline acc_t segment_reduce_finalize(SegmentReductionType reduction, acc_t acc, int64_t length) {
+  return reduction == SegmentReductionType::MEAN ? acc / static_cast<acc_t>(length) : acc;
+}
+
+}} // namespace at::native
@@ -340,6 +340,40 @@ struct NanSumOps {
 #endif
 };
 
+// Finds the smallest and the largest element together, so both come out of
+// a single pass over the input. A NaN anywhere makes both results NaN.
+// project returns res_t (a tuple on CPU, a pair on CUDA) holding (min, max),
+// which the reduction writes to its first and second output.
+template <typename scalar_t, typename acc_scalar_t, typename res_t>
+struct MinMaxOps {
+  using acc_t = detail::pair<acc_scalar_t, acc_scalar_t>;
+
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return combine(acc, acc_t(data, data));
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return acc_t(
+        (at::_isnan(a.first) || a.first < b.first) ? a.first : b.first,
+        (at::_isnan(a.second) || a.second > b.second) ? a.second : b.second);
+  }
+
+  inline C10_DEVICE res_t project(acc_t acc) const {
+    return res_t(acc.first, acc.second);
+  }
+
+  static C10_DEVICE acc_t translate_idx(acc_t acc, int64_t /*base_idx*/) {
+    return acc;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t acc, int offset) const {
+    return acc_t(WARP_SHFL_DOWN(acc.first, offset),
+                 WARP_SHFL_DOWN(acc.second, offset));
+  }
+#endif
+};
+
 namespace detail {
 
 template <typename scalar_t>
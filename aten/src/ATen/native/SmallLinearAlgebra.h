@@ -0,0 +1,239 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <cmath>
+#include <cstdint>
+
+// Kernels for batches of tiny square matrices, used by BatchLinearAlgebra.cpp
+// and cuda/BatchLinearAlgebra.cu instead of calling LAPACK or MAGMA once per
+// matrix, which costs much more than the arithmetic for such sizes. Each call
+// handles one column major matrix whose size is a template parameter, so that
+// the loops are unrolled and the matrix is copied to registers: the rows are
+// only indexed by constants, also when they are swapped. The results are the
+// ones of the unblocked LAPACK routines, including the pivots and infos.
+
+namespace at { namespace native {
+
+// The largest size of the matrices handled by these kernels
+constexpr int64_t kSmallMatrixMaxSize = 4;
+
+static inline bool useSmallMatrixKernels(int64_t n) {
+  return n >= 1 && n <= kSmallMatrixMaxSize;
+}
+
+namespace detail {
+
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline void copy_matrix(scalar_t* dst, const scalar_t* src) {
+#pragma unroll
+  for (int i = 0; i < N * N; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline int lu_factor(scalar_t* a, int* ipiv) {
+  int info = 0;
+#pragma unroll
+  for (int j = 0; j < N; j++) {
+    int p = j;
+    scalar_t pivot = a[j + j * N];
+#pragma unroll
+    for (int i = j + 1; i < N; i++) {
+      if (std::abs(a[i + j * N]) > std::abs(pivot)) {
+        p = i;
+        pivot = a[i + j * N];
+      }
+    }
+    ipiv[j] = p + 1;
+    if (pivot != scalar_t(0)) {
+#pragma unroll
+      for (int i = j + 1; i < N; i++) {
+        if (i == p) {
+#pragma unroll
+          for (int k = 0; k < N; k++) {
+            const scalar_t tmp = a[j + k * N];
+            a[j + k * N] = a[i + k * N];
+            a[i + k * N] = tmp;
+          }
+        }
+      }
+#pragma unroll
+      for (int i = j + 1; i < N; i++) {
+        a[i + j * N] /= a[j + j * N];
+      }
+    } else if (info == 0) {
+      info = j + 1;
+    }
+#pragma unroll
+    for (int k = j + 1; k < N; k++) {
+#pragma unroll
+      for (int i = j + 1; i < N; i++) {
+        a[i + k * N] -= a[i + j * N] * a[j + k * N];
+      }
+    }
+  }
+  return info;
+}
+
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline void lu_solve(const scalar_t* lu, const int* ipiv, scalar_t* b, int64_t nrhs) {
+  for (int64_t c = 0; c < nrhs; c++) {
+    scalar_t x[N];
+#pragma unroll
+    for (int i = 0; i < N; i++) {
+      x[i] = b[i + c * N];
+    }
+#pragma unroll
+    for (int i = 0; i < N; i++) {
+      const int p = ipiv[i] - 1;
+#pragma unroll
+      for (int r = i + 1; r < N; r++) {
+        if (r == p) {
+          const scalar_t tmp = x[i];
+          x[i] = x[r];
+          x[r] = tmp;
+        }
+      }
+    }
+#pragma unroll
+    for (int i = 1; i < N; i++) {
+#pragma unroll
+      for (int k = 0; k < i; k++) {
+        x[i] -= lu[i + k * N] * x[k];
+      }
+    }
+#pragma unroll
+    for (int i = N - 1; i >= 0; i--) {
+#pragma unroll
+      for (int k = i + 1; k < N; k++) {
+        x[i] -= lu[i + k * N] * x[k];
+      }
+      x[i] /= lu[i + i * N];
+    }
+#pragma unroll
+    for (int i = 0; i < N; i++) {
+      b[i + c * N] = x[i];
+    }
+  }
+}
+
+template <int N, bool upper, typename scalar_t>
+C10_HOST_DEVICE inline int cholesky_factor(scalar_t* a) {
+  // (i, j) of the lower triangle is (j, i) of the upper one
+  constexpr int row_stride = upper ? N : 1;
+  constexpr int col_stride = upper ? 1 : N;
+#pragma unroll
+  for (int j = 0; j < N; j++) {
+    scalar_t d = a[j * row_stride + j * col_stride];
+#pragma unroll
+    for (int k = 0; k < j; k++) {
+      d -= a[j * row_stride + k * col_stride] * a[j * row_stride + k * col_stride];
+    }
+    if (!(d > scalar_t(0))) {
+      a[j * row_stride + j * col_stride] = d;
+      return j + 1;
+    }
+    d = std::sqrt(d);
+    a[j * row_stride + j * col_stride] = d;
+#pragma unroll
+    for (int i = j + 1; i < N; i++) {
+      scalar_t s = a[i * row_stride + j * col_stride];
+#pragma unroll
+      for (int k = 0; k < j; k++) {
+        s -= a[i * row_stride + k * col_stride] * a[j * row_stride + k * col_stride];
+      }
+      a[i * row_stride + j * col_stride] = s / d;
+    }
+  }
+  return 0;
+}
+
+} // namespace detail
+
+// LU decomposition with partial pivoting of a, like getf2. ipiv is 1-based.
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline int small_lu(scalar_t* a, int* ipiv) {
+  scalar_t lu[N * N];
+  detail::copy_matrix<N>(lu, a);
+  const int info = detail::lu_factor<N>(lu, ipiv);
+  detail::copy_matrix<N>(a, lu);
+  return info;
+}
+
+// Solves a * x = b for the nrhs columns of b, leaving the LU decomposition
+// of a in a, like gesv.
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline int small_solve(scalar_t* a, scalar_t* b, int64_t nrhs) {
+  scalar_t lu[N * N];
+  int ipiv[N];
+  detail::copy_matrix<N>(lu, a);
+  const int info = detail::lu_factor<N>(lu, ipiv);
+  detail::copy_matrix<N>(a, lu);
+  if (info == 0) {
+    detail::lu_solve<N>(lu, ipiv, b, nrhs);
+  }
+  return info;
+}
+
+// Replaces a by its inverse, like getrf followed by getri.
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline int small_inverse(scalar_t* a) {
+  scalar_t lu[N * N];
+  int ipiv[N];
+  detail::copy_matrix<N>(lu, a);
+  const int info = detail::lu_factor<N>(lu, ipiv);
+  if (info == 0) {
+#pragma unroll
+    for (int i = 0; i < N * N; i++) {
+      a[i] = (i % (N + 1) == 0) ? scalar_t(1) : scalar_t(0);
+    }
+    detail::lu_solve<N>(lu, ipiv, a, N);
+  }
+  return info;
+}
+
+// Cholesky decomposition of the lower triangle of a, or of the upper one,
+// like potf2. The other triangle is left as is.
+template <int N, typename scalar_t>
+C10_HOST_DEVICE inline int small_cholesky(scalar_t* a, bool upper) {
+  scalar_t l[N * N];
+  detail::copy_matrix<N>(l, a);
+  const int info = upper ? detail::cholesky_factor<N, true>(l) : detail::cholesky_factor<N, false>(l);
+  detail::copy_matrix<N>(a, l);
+  return info;
+}
+
+// The same for a size known at runtime, which is at most kSmallMatrixMaxSize.
+#define AT_SMALL_MATRIX_SWITCH(n, NAME, ...) \
+  switch (n) {                               \
+    case 1: return NAME<1>(__VA_ARGS__);     \
+    case 2: return NAME<2>(__VA_ARGS__);     \
+    case 3: return NAME<3>(__VA_ARGS__);     \
+    default: return NAME<4>(__VA_ARGS__);    \
+  }
+
+template <typename scalar_t>
+C10_HOST_DEVICE inline int small_lu(int64_t n, scalar_t* a, int* ipiv) {
+  AT_SMALL_MATRIX_SWITCH(n, small_lu, a, ipiv);
+}
+
+template <typename scalar_t>
+C10_HOST_DEVICE inline int small_solve(int64_t n, scalar_t* a, scalar_t* b, int64_t nrhs) {
+  AT_SMALL_MATRIX_SWITCH(n, small_solve, a, b, nrhs);
+}
+
+template <typename scalar_t>
+C10_HOST_DEVICE inline int small_inverse(int64_t n, scalar_t* a) {
+  AT_SMALL_MATRIX_SWITCH(n, small_inverse, a);
+}
+
+template <typename scalar_t>
+C10_HOST_DEVICE inline int small_cholesky(int64_t n, scalar_t* a, bool upper) {
+  AT_SMALL_MATRIX_SWITCH(n, small_cholesky, a, upper);
+}
+
+#undef AT_SMALL_MATRIX_SWITCH
+
+}}  // namespace at::native
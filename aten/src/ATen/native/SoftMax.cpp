@@ -1,10 +1,12 @@
 #include <ATen/ATen.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/ExpandUtils.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/WrapDimUtils.h>
 #include <ATen/native/cpu/SoftmaxKernel.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <ATen/NamedTensorUtils.h>
 
 namespace at {
@@ -119,6 +121,11 @@ void host_softmax_backward(
 
 Tensor softmax_cpu(const Tensor& input_, const int64_t dim_, const bool half_to_float) {
   AT_ASSERTM(!half_to_float, "softmax with half to float conversion is not supported on CPU");
+#if defined(C10_MOBILE)
+  if (xnnpack::use_softmax(input_, dim_, half_to_float)) {
+    return xnnpack::softmax(input_, dim_);
+  }
+#endif
   auto input = input_.contiguous();
   Tensor output = at::native::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   int64_t dim = maybe_wrap_dim(dim_, input.dim());
@@ -134,9 +141,9 @@ Tensor softmax_cpu(const Tensor& input_, const int64_t dim_, const bool half_to_
   if (input.ndimension() > 0 && dim == input.ndimension() - 1) {
     softmax_lastdim_kernel(kCPU, output, input);
   } else {
-    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "softmax", [&] {
-      host_softmax<scalar_t, false>(output, input, dim);
-    });
+    AT_DISPATCH_FLOATING_TYPES_AND(
+        at::ScalarType::BFloat16, input.scalar_type(), "softmax",
+        [&] { host_softmax<scalar_t, false>(output, input, dim); });
   }
   return output;
 }
@@ -190,9 +197,11 @@ Tensor softmax_backward_cpu(
   if (grad.ndimension() > 0 && dim == grad.ndimension() - 1) {
     softmax_backward_lastdim_kernel(kCPU, grad_input, grad, output);
   } else {
-    AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "softmax_backward", [&] {
-      host_softmax_backward<scalar_t, false>(grad_input, grad, output, dim);
-    });
+    AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::BFloat16, grad.scalar_type(),
+                                   "softmax_backward", [&] {
+                                     host_softmax_backward<scalar_t, false>(
+                                         grad_input, grad, output, dim);
+                                   });
   }
   return grad_input;
 }
@@ -277,10 +286,32 @@ Tensor log_softmax(const Tensor& input_, const int64_t dim_, c10::optional<Scala
   return result;
 }
 
+// softmax(self * scale + mask) over the last dimension, the attention
+// probabilities of a transformer. A boolean mask removes the positions where it
+// is true instead of being added. On CUDA the three steps run as one kernel.
+Tensor scale_mask_softmax(const Tensor& self, const Tensor& mask, double scale) {
+  TORCH_CHECK(self.dim() > 0, "scale_mask_softmax: expected a tensor with at least one dimension");
+  TORCH_CHECK(is_expandable_to(mask.sizes(), self.sizes()),
+              "scale_mask_softmax: mask of size ", mask.sizes(),
+              " is not broadcastable to the input size ", self.sizes());
+  const bool is_bool_mask = mask.scalar_type() == ScalarType::Bool;
+  // an additive mask is applied in the dtype of the input
+  auto mask_ = is_bool_mask ? mask : mask.to(self.scalar_type());
+  if (self.is_cuda()) {
+    return at::_scale_mask_softmax(self, mask_, scale);
+  }
+  auto scaled = self * scale;
+  auto masked = is_bool_mask
+      ? scaled.masked_fill(mask_, -std::numeric_limits<double>::infinity())
+      : scaled + mask_;
+  return at::_softmax(masked, -1, false);
+}
+
 DEFINE_DISPATCH(softmax_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_lastdim_kernel);
 DEFINE_DISPATCH(softmax_backward_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_backward_lastdim_kernel);
+DEFINE_DISPATCH(logsumexp_lastdim_kernel);
 
 Tensor softmax(const Tensor& self, Dimname dim, optional<ScalarType> dtype) {
   return at::softmax(self, dimname_to_position(self, dim), dtype);
@@ -1,6 +1,8 @@
 #include <ATen/native/Sorting.h>
 
 #include <ATen/ATen.h>
+#include <ATen/LegacyTHFunctionsCPU.h>
+#include <ATen/MemoryOverlap.h>
 #include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
@@ -327,6 +329,47 @@ Tensor quantile(
   return at::quantile(self, at::scalar_tensor(q, self.options()), _dim, keepdim);
 }
 
+// A single slice (e.g. sorting a 1-d tensor) goes to the parallel sort_stub,
+// everything else to the TH implementation, which sorts slices one by one.
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  const ScalarType dtype = self.scalar_type();
+  const bool single_slice =
+      self.dim() == 0 || self.numel() == self.size(dim);
+  const bool supported_dtype =
+      isIntegralType(dtype, /*includeBool=*/false) ||
+      dtype == kFloat || dtype == kDouble || dtype == kHalf;
+  if (single_slice && supported_dtype &&
+      self.numel() >= SORT_PARALLEL_MIN_NUMEL &&
+      values.scalar_type() == dtype && indices.scalar_type() == kLong) {
+    values.resize_(self.sizes());
+    indices.resize_(self.sizes());
+    if (values.is_contiguous() && indices.is_contiguous()) {
+      // The kernel gathers from self while it writes values
+      Tensor input = get_overlap_status(values, self) == MemOverlapStatus::NO ?
+          self.contiguous() : self.clone(at::MemoryFormat::Contiguous);
+      sort_stub(kCPU, values, indices, input, descending);
+      return std::forward_as_tuple(values, indices);
+    }
+  }
+  return legacy::cpu::_th_sort_out(values, indices, self, dim, descending);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  at::native::sort_out_cpu(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
 std::tuple<Tensor&, Tensor&> topk_out_cpu(
     Tensor& values,
     Tensor& indices,
@@ -448,6 +491,7 @@ Tensor median_cpu(const Tensor& self) {
 }
 
 DEFINE_DISPATCH(topk_stub);
+DEFINE_DISPATCH(sort_stub);
 
 } // namespace native
 } // namespace at
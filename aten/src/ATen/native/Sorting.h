@@ -6,7 +6,13 @@
 namespace at { namespace native {
 
 using topk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool, bool);
+// Sorts a single contiguous slice: (values, indices, self, descending)
+using sort_fn = void(*)(Tensor&, Tensor&, const Tensor&, bool);
 
 DECLARE_DISPATCH(topk_fn, topk_stub);
+DECLARE_DISPATCH(sort_fn, sort_stub);
+
+// Below this many elements the per-slice TH sort is already fast enough
+constexpr int64_t SORT_PARALLEL_MIN_NUMEL = 1 << 16;
 
 }} // at::native
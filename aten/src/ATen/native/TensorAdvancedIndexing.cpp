@@ -70,6 +70,7 @@ namespace at { namespace native {
 DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_put_stub);
 DEFINE_DISPATCH(index_put_accum_stub);
+DEFINE_DISPATCH(index_add_stub);
 DEFINE_DISPATCH(masked_fill_stub);
 REGISTER_NO_CPU_DISPATCH(index_put_accum_stub, index_put_accum_fn);
 DEFINE_DISPATCH(masked_select_serial_stub);
@@ -374,6 +375,18 @@ Tensor& index_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const T
     }
     auto selfSlice = self.select(dim, 0);
     auto sourceSlice = source.select(dim, 0);
+
+    // rows of plain numeric types that can be added with raw pointers are
+    // handled by a parallel, vectorized kernel
+    auto self_type = self.scalar_type();
+    if (selfSlice.is_contiguous() && sourceSlice.is_contiguous() &&
+        selfSlice.sizes().equals(sourceSlice.sizes()) &&
+        self_type != ScalarType::Bool && self_type != ScalarType::Half && self_type != ScalarType::BFloat16 &&
+        get_overlap_status(self, source) == MemOverlapStatus::NO) {
+      index_add_stub(kCPU, self, dim, index_contig, source);
+      return self;
+    }
+
     auto self_stride_bytes = self.stride(dim) * elementSize(self.scalar_type());
     auto source_stride_bytes = source.stride(dim) * elementSize(source.scalar_type());
     auto self_dim_size = self.size(dim);
@@ -414,6 +427,22 @@ Tensor index_add(const Tensor & self, int64_t dim, const Tensor & index, const T
   return self.clone(at::MemoryFormat::Preserve).index_add_(dim, index, source);
 }
 
+// How many rows ahead index_select prefetches the rows it gathers.
+constexpr int64_t kIndexSelectPrefetch = 8;
+
+// Hint the cache lines of a row of self into cache ahead of reading it. Only
+// the first few lines are requested; the hardware prefetcher picks up the
+// rest of a long, sequential row by itself.
+static inline void prefetch_row(const char* ptr, int64_t nbytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  constexpr int64_t kCacheLine = 64;
+  const int64_t span = std::min<int64_t>(nbytes, 4 * kCacheLine);
+  for (int64_t off = 0; off < span; off += kCacheLine) {
+    __builtin_prefetch(ptr + off, /*rw=*/0, /*locality=*/1);
+  }
+#endif
+}
+
 Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -481,6 +510,14 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
           for (int64_t i = start; i < end; i++) {
             auto self_i = index_data[i];
             TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
+            // the rows are gathered from random places in self, so start
+            // fetching an upcoming row while this one is copied
+            if (i + kIndexSelectPrefetch < end) {
+              auto next_i = index_data[i + kIndexSelectPrefetch];
+              if ((next_i >= 0) && (next_i < self_dim_size)) {
+                prefetch_row(static_cast<char*>(selfSlice_data) + next_i * self_stride_bytes, slice_size_bytes);
+              }
+            }
             auto self_data = static_cast<char*>(selfSlice_data) + self_i * self_stride_bytes;
             auto result_data = static_cast<char*>(resultSlice_data) + i * result_stride_bytes;
             memcpy(result_data, self_data, slice_size_bytes);
@@ -500,12 +537,14 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
       auto self_data_ptr = self.data_ptr<scalar_t>();
       auto result_data_ptr = result.data_ptr<scalar_t>();
       auto self_numel = self.numel();
-      for (auto i = 0; i < numel; i++) {
-        auto self_i = index_data[i];
-        TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_numel), "index out of range in self");
-        scalar_t *self_ip = self_data_ptr + self_i * self_stride;
-        *(result_data_ptr + i * result_stride) = *self_ip;
-      }
+      at::parallel_for(0, numel, at::internal::GRAIN_SIZE, [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; i++) {
+          auto self_i = index_data[i];
+          TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_numel), "index out of range in self");
+          scalar_t *self_ip = self_data_ptr + self_i * self_stride;
+          *(result_data_ptr + i * result_stride) = *self_ip;
+        }
+      });
     });
   }
 
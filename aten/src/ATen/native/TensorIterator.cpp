@@ -1,6 +1,7 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <unordered_map>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/TypeProperties.h>
@@ -1070,14 +1071,9 @@ int TensorIterator::get_dim_to_split() const {
   return dim_to_split;
 }
 
-bool TensorIterator::fast_set_up(const TensorIteratorConfig& config) {
-  // This function tries to do a fast setup to avoid needless reordering of dimensions and tracking output strides
-  // Return true if it can do fast setup or false otherwise
-  // TODO enable fast handling for reductions
-  FastSetupType setup_type = compute_fast_setup_type(config);
-  if (setup_type == FastSetupType::NONE) {
-    return false;
-  }
+void TensorIterator::fast_set_up(FastSetupType setup_type) {
+  // This function does a fast setup to avoid needless reordering of dimensions and tracking output strides
+  // setup_type is computed by compute_fast_setup_type and must not be NONE
 
   // allocate memory for output, memory format depends on setup_type
   switch (setup_type) {
@@ -1150,7 +1146,6 @@ bool TensorIterator::fast_set_up(const TensorIteratorConfig& config) {
       op.stride_bytes[0] = element_size_in_bytes;
     }
   }
-  return true;
 }
 
 FastSetupType TensorIterator::compute_fast_setup_type(const TensorIteratorConfig& config) {
@@ -1205,6 +1200,180 @@ FastSetupType TensorIterator::compute_fast_setup_type(const TensorIteratorConfig
   return FastSetupType::NONE;
 }
 
+// [TensorIterator plan cache]
+// Laying out the operands, i.e. the fast setup or computing the strides,
+// reordering and coalescing the dimensions, only depends on the shape, the
+// operands' sizes, strides and element sizes, and on which outputs have to be
+// allocated or resized. For tiny tensors it costs more than the kernel, so
+// each thread caches the resulting plan, keyed by exactly those properties,
+// and replays it when the same signature is seen again. Everything else in
+// build() (overlap checks, type promotion, name inference) still runs for
+// every iterator.
+struct TensorIteratorPlan {
+  // the fast setup to replay, or NONE if the plan was computed by the
+  // generic setup below
+  FastSetupType setup_type = FastSetupType::NONE;
+  DimVector perm;
+  DimVector shape;
+  SmallVector<TensorIterator::StrideVector, 4> stride_bytes;
+  // sizes and strides of the outputs allocate_or_resize_outputs allocated or
+  // resized, empty for the other operands
+  SmallVector<DimVector, 4> output_sizes;
+  SmallVector<DimVector, 4> output_strides;
+  bool contiguous_outputs = false;
+  bool has_coalesced_dimensions = false;
+};
+
+namespace {
+
+// Plans are dropped all at once when the cache is full, workloads that
+// repeat signatures refill it quickly
+constexpr size_t kMaxCachedPlans = 256;
+
+struct PlanKeyHash {
+  size_t operator()(const std::vector<int64_t>& key) const {
+    size_t h = key.size();
+    for (int64_t v : key) {
+      h ^= std::hash<int64_t>()(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+  }
+};
+
+struct PlanCache {
+  std::unordered_map<std::vector<int64_t>, TensorIteratorPlan, PlanKeyHash> plans;
+  TensorIteratorPlanCacheStats stats;
+  // reused across lookups to avoid allocating a key on every hit
+  std::vector<int64_t> key;
+};
+
+PlanCache& plan_cache() {
+  static thread_local PlanCache cache;
+  return cache;
+}
+
+} // namespace
+
+TensorIteratorPlanCacheStats tensor_iterator_plan_cache_stats() {
+  return plan_cache().stats;
+}
+
+void clear_tensor_iterator_plan_cache() {
+  auto& cache = plan_cache();
+  cache.plans.clear();
+  cache.stats = TensorIteratorPlanCacheStats();
+}
+
+void TensorIterator::compute_plan_key(std::vector<int64_t>& key, const TensorIteratorConfig& config) const {
+  key.clear();
+  key.push_back(is_reduction_);
+  key.push_back(all_ops_same_shape_);
+  key.push_back(config.static_shape_.has_value());
+  key.push_back(ndim());
+  key.insert(key.end(), shape_.begin(), shape_.end());
+  for (const auto& op : operands_) {
+    key.push_back(op.tensor.defined() | op.is_output << 1 | op.will_resize << 2);
+    if (!op.tensor.defined()) {
+      key.push_back(elementSize(op.target_dtype));
+      continue;
+    }
+    key.push_back(op.tensor.element_size());
+    key.push_back(op.tensor.dim());
+    key.insert(key.end(), op.tensor.sizes().begin(), op.tensor.sizes().end());
+    key.insert(key.end(), op.tensor.strides().begin(), op.tensor.strides().end());
+  }
+}
+
+void TensorIterator::record_plan(TensorIteratorPlan& plan) const {
+  plan.perm = perm_;
+  plan.shape = shape_;
+  plan.has_coalesced_dimensions = has_coalesced_dimensions_;
+  for (const auto& op : operands_) {
+    plan.stride_bytes.push_back(op.stride_bytes);
+  }
+}
+
+void TensorIterator::apply_plan(const TensorIteratorPlan& plan) {
+  if (plan.setup_type != FastSetupType::NONE) {
+    fast_set_up(plan.setup_type);
+    return;
+  }
+  // same allocations as allocate_or_resize_outputs
+  for (int i = 0; i < num_outputs_; i++) {
+    auto& op = operands_[i];
+    if (op.tensor.defined() && !op.will_resize) {
+      continue;
+    }
+    const auto& sizes = plan.output_sizes[i];
+    const auto& strides = plan.output_strides[i];
+    if (!op.tensor.defined()) {
+      op.tensor = plan.contiguous_outputs
+          ? at::empty(sizes, op.options())
+          : at::empty_strided(sizes, strides, op.options());
+    } else {
+      at::native::resize_output(op.tensor, sizes);
+      if (!plan.contiguous_outputs) {
+        op.tensor.as_strided_(sizes, strides);
+      }
+    }
+    op.current_dtype = op.target_dtype;
+  }
+  perm_ = plan.perm;
+  shape_ = plan.shape;
+  has_coalesced_dimensions_ = plan.has_coalesced_dimensions;
+  for (int i = 0; i < ntensors(); i++) {
+    operands_[i].stride_bytes = plan.stride_bytes[i];
+  }
+}
+
+void TensorIterator::set_up_layout(const TensorIteratorConfig& config) {
+  auto& cache = plan_cache();
+  compute_plan_key(cache.key, config);
+  auto it = cache.plans.find(cache.key);
+  if (it != cache.plans.end()) {
+    cache.stats.hits++;
+    apply_plan(it->second);
+    return;
+  }
+  cache.stats.misses++;
+
+  TensorIteratorPlan plan;
+  // try fast setup output tensor, if failed, fallback to normal setup
+  // TODO enable fast handling for reductions
+  plan.setup_type = compute_fast_setup_type(config);
+  if (plan.setup_type != FastSetupType::NONE) {
+    fast_set_up(plan.setup_type);
+  } else {
+    SmallVector<bool, 4> allocated;
+    for (int i = 0; i < num_outputs_; i++) {
+      allocated.push_back(!operands_[i].tensor.defined() || operands_[i].will_resize);
+    }
+    // compute each tensor's stride after broadcasting
+    compute_strides(config);
+    // re-order dimensions to improve coalescing
+    reorder_dimensions(config);
+    plan.contiguous_outputs = true;
+    for (int i = 0; i < ndim(); i++) {
+      plan.contiguous_outputs &= perm_[i] == ndim() - i - 1;
+    }
+    // allocate the output tensor if it's not provided
+    allocate_or_resize_outputs();
+    for (int i = 0; i < num_outputs_; i++) {
+      const auto& tensor = operands_[i].tensor;
+      plan.output_sizes.emplace_back(allocated[i] ? tensor.sizes() : IntArrayRef());
+      plan.output_strides.emplace_back(allocated[i] ? tensor.strides() : IntArrayRef());
+    }
+    // coalesce adjacent dimensions when possible
+    coalesce_dimensions();
+    record_plan(plan);
+  }
+
+  if (cache.plans.size() >= kMaxCachedPlans) {
+    cache.plans.clear();
+  }
+  cache.plans.emplace(cache.key, std::move(plan));
+}
+
 TensorIterator::TensorIterator(TensorIteratorConfig& config) {
   build(config);
 }
@@ -1228,17 +1397,9 @@ void TensorIterator::build(TensorIteratorConfig& config) {
   mark_resize_outputs(config);
   // compute the result dtype and device
   compute_types(config);
-  // try fast setup output tensor, if failed, fallback to normal setup
-  if (!fast_set_up(config)) {
-    // compute each tensor's stride after broadcasting
-    compute_strides(config);
-    // re-order dimensions to improve coalescing
-    reorder_dimensions(config);
-    // allocate the output tensor if it's not provided
-    allocate_or_resize_outputs();
-    // coalesce adjacent dimensions when possible
-    coalesce_dimensions();
-  }
+  // set up the output tensors and iteration layout, replaying a cached plan
+  // if this thread has seen the same operand signature before
+  set_up_layout(config);
   // perform name inference
   propagate_names_to_outputs();
 
@@ -131,6 +131,18 @@ enum class FastSetupType : uint8_t {
 };
 
 class TensorIteratorConfig;
+struct TensorIteratorPlan;
+
+// Statistics of the calling thread's cache of iteration plans, see
+// [TensorIterator plan cache] in TensorIterator.cpp
+struct TensorIteratorPlanCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+};
+
+CAFFE2_API TensorIteratorPlanCacheStats tensor_iterator_plan_cache_stats();
+// Drops the calling thread's cached plans and resets its statistics.
+CAFFE2_API void clear_tensor_iterator_plan_cache();
 
 struct CAFFE2_API TensorIterator {
   using DimMask = std::bitset<64>;
@@ -309,8 +321,12 @@ protected:
   void compute_types(const TensorIteratorConfig&);
   ScalarType compute_common_dtype();
   void allocate_or_resize_outputs();
-  bool fast_set_up(const TensorIteratorConfig&);
+  void fast_set_up(FastSetupType setup_type);
   FastSetupType compute_fast_setup_type(const TensorIteratorConfig&);
+  void set_up_layout(const TensorIteratorConfig&);
+  void compute_plan_key(std::vector<int64_t>& key, const TensorIteratorConfig&) const;
+  void record_plan(TensorIteratorPlan& plan) const;
+  void apply_plan(const TensorIteratorPlan& plan);
   void compute_names(const TensorIteratorConfig&);
   void propagate_names_to_outputs();
   void coalesce_dimensions();
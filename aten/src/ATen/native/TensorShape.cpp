@@ -21,7 +21,7 @@
 namespace at {
 namespace native {
 
-DEFINE_DISPATCH(cat_serial_stub);
+DEFINE_DISPATCH(cat_contig_stub);
 
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
   TORCH_CHECK(shape_tensor.dim() == 1);
@@ -176,12 +176,11 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
     return result;
   }
 
-  // fast path for single thread when both inputs and result are contiguous and not empty
+  // fast path when both inputs and result are contiguous and not empty: block
+  // copies of raw bytes, parallelized over the outer dimension
   allContiguous = allContiguous && result.is_contiguous(first_tensor_mem_format);
-  bool use_serial_kernel = result.numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1;
-  ScalarType dtype = notSkippedTensor.scalar_type();
-  if (use_serial_kernel && allContiguous && no_type_promotion && (dtype == ScalarType::Double || dtype == ScalarType::Float)) {
-    cat_serial_stub(kCPU, result, tensors, dim);
+  if (allContiguous && no_type_promotion) {
+    cat_contig_stub(kCPU, result, tensors, dim);
     return result;
   }
 
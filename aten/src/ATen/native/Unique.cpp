@@ -2,17 +2,43 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Sorting.h>
+#include <c10/util/flat_hash_map.h>
 
-#include <set>
+#include <algorithm>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <type_traits>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Chunks of the input that are scanned by one task each. The chunking only
+// depends on the input size and the thread count, so results are stable for a
+// given configuration.
+inline int64_t unique_num_chunks(int64_t numel) {
+  return std::max<int64_t>(
+      std::min<int64_t>(at::get_num_threads(), divup(numel, internal::GRAIN_SIZE)), 1);
+}
+
+// Parallel hash-based unique
+// --------------------------
+// Elements are partitioned by a hash of their value, so equal values always
+// end up in the same partition and partitions can be deduplicated
+// independently with a flat hash map:
+//   1. every chunk of the input counts how many of its elements go to each
+//      partition, and the counts become per-chunk write offsets;
+//   2. every chunk scatters its element indices into their partitions, which
+//      keeps input order inside a partition;
+//   3. every partition assigns local ids in order of first appearance and
+//      counts occurrences;
+//   4. partitions are concatenated and local ids are offset into global ids.
+// With sorted=True the (usually much smaller) set of unique values is sorted
+// afterwards and the inverse indices and counts are permuted to match.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,53 +48,162 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
-
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
+  const bool need_inverse = return_inverse || return_counts;
+  if (need_inverse) {
+    inverse_indices.resize_(input.sizes());
+  }
+  if (numel == 0) {
+    return std::make_tuple(at::empty({0}, input.options()), inverse_indices, counts);
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+  const int64_t nchunks = unique_num_chunks(numel);
+  const int64_t chunk_size = divup(numel, nchunks);
+  // A few partitions per thread so that skewed partitions still balance
+  int part_bits = 0;
+  if (nchunks > 1) {
+    while ((int64_t(1) << part_bits) < 4 * at::get_num_threads()) {
+      part_bits++;
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+  }
+  const int64_t nparts = int64_t(1) << part_bits;
+  auto part_of = [part_bits](scalar_t value) -> int64_t {
+    if (part_bits == 0) {
+      return 0;
     }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+    // Fibonacci hashing spreads identity hashes (e.g. of integers) evenly
+    const uint64_t h = static_cast<uint64_t>(std::hash<scalar_t>()(value));
+    return static_cast<int64_t>((h * 0x9E3779B97F4A7C15ull) >> (64 - part_bits));
+  };
+
+  // 1. per-chunk partition histograms, turned into write offsets
+  std::vector<int64_t> offsets(nchunks * nparts, 0);
+  at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      int64_t* hist = offsets.data() + c * nparts;
+      const int64_t hi = std::min(numel, (c + 1) * chunk_size);
+      for (int64_t i = c * chunk_size; i < hi; ++i) {
+        hist[part_of(input_data[i])]++;
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    }
+  });
+  std::vector<int64_t> part_begin(nparts + 1, 0);
+  int64_t offset = 0;
+  for (int64_t p = 0; p < nparts; ++p) {
+    part_begin[p] = offset;
+    for (int64_t c = 0; c < nchunks; ++c) {
+      const int64_t count = offsets[c * nparts + p];
+      offsets[c * nparts + p] = offset;
+      offset += count;
+    }
+  }
+  part_begin[nparts] = numel;
+
+  // 2. group element indices by partition
+  std::vector<int64_t> order(numel);
+  at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      int64_t* pos = offsets.data() + c * nparts;
+      const int64_t hi = std::min(numel, (c + 1) * chunk_size);
+      for (int64_t i = c * chunk_size; i < hi; ++i) {
+        order[pos[part_of(input_data[i])]++] = i;
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    }
+  });
+
+  // 3. deduplicate every partition on its own
+  int64_t* inverse_data = need_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+  std::vector<std::vector<scalar_t>> part_values(nparts);
+  std::vector<std::vector<int64_t>> part_counts(nparts);
+  at::parallel_for(0, nparts, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; ++p) {
+      ska::flat_hash_map<scalar_t, int64_t> local_ids;
+      auto& values = part_values[p];
+      auto& cnts = part_counts[p];
+      for (int64_t k = part_begin[p]; k < part_begin[p + 1]; ++k) {
+        const int64_t i = order[k];
+        // NaN never compares equal, so every NaN becomes its own entry
+        auto it = local_ids.emplace(input_data[i], static_cast<int64_t>(values.size()));
+        if (it.second) {
+          values.push_back(input_data[i]);
+          cnts.push_back(0);
+        }
+        const int64_t id = it.first->second;
+        cnts[id]++;
+        if (inverse_data) {
+          inverse_data[i] = id;
+        }
       }
     }
+  });
+
+  // 4. concatenate the partitions
+  std::vector<int64_t> unique_begin(nparts + 1, 0);
+  for (int64_t p = 0; p < nparts; ++p) {
+    unique_begin[p + 1] = unique_begin[p] + static_cast<int64_t>(part_values[p].size());
+  }
+  const int64_t num_unique = unique_begin[nparts];
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  if (return_counts) {
+    counts.resize_({num_unique});
+  }
+  int64_t* counts_data = return_counts ? counts.data_ptr<int64_t>() : nullptr;
+  at::parallel_for(0, nparts, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; ++p) {
+      const int64_t base = unique_begin[p];
+      std::copy(part_values[p].begin(), part_values[p].end(), output_data + base);
+      if (counts_data) {
+        std::copy(part_counts[p].begin(), part_counts[p].end(), counts_data + base);
+      }
+      if (inverse_data && base != 0) {
+        for (int64_t k = part_begin[p]; k < part_begin[p + 1]; ++k) {
+          inverse_data[order[k]] += base;
+        }
+      }
+    }
+  });
+
+  if (sorted && num_unique > 1) {
+    Tensor perm;
+    // sort() does not support bool on CPU, and there are at most two values
+    if (!std::is_same<scalar_t, bool>::value && num_unique >= SORT_PARALLEL_MIN_NUMEL) {
+      std::tie(output, perm) = output.sort();
+    } else {
+      perm = at::arange(num_unique, input.options().dtype(kLong));
+      int64_t* perm_data = perm.data_ptr<int64_t>();
+      std::sort(perm_data, perm_data + num_unique, [output_data](int64_t a, int64_t b) {
+        // NaN last, like sort()
+        return (!_isnan(output_data[a]) && _isnan(output_data[b])) ||
+            (output_data[a] < output_data[b]);
+      });
+      output = output.index_select(0, perm);
+    }
+    if (return_counts) {
+      counts = counts.index_select(0, perm);
+    }
+    if (inverse_data) {
+      const int64_t* perm_data = perm.data_ptr<int64_t>();
+      std::vector<int64_t> rank(num_unique);
+      at::parallel_for(0, num_unique, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t j = begin; j < end; ++j) {
+          rank[perm_data[j]] = j;
+        }
+      });
+      at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          inverse_data[i] = rank[inverse_data[i]];
+        }
+      });
+    }
   }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
+// Runs are found in parallel: every chunk counts the runs that start inside
+// it, a prefix sum over the chunks gives their global ids, and a second pass
+// writes the outputs.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
     const Tensor& self,
@@ -87,33 +222,60 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
 
   if (numel > 0) {
     scalar_t *output_data = output.data_ptr<scalar_t>();
-    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();;
-    int64_t *counts_data = nullptr;
-    *output_data = *input_data;
-
-    if (return_counts) {
-      counts.resize_({numel});
-      counts_data = counts.data_ptr<int64_t>();
-    }
-    scalar_t *p = output_data;
-    int64_t *q = counts_data;
-    int64_t last = 0;
-    for (int64_t i = 0; i < numel; i++) {
-      if (input_data[i] != *p) {
-        *(++p) = input_data[i];
-        if (return_counts) {
-          *(q++) = i - last;
-          last = i;
+    int64_t *inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+    // NaN != NaN, so consecutive NaNs are separate runs
+    auto is_run_start = [input_data](int64_t i) -> bool {
+      return i == 0 || input_data[i] != input_data[i - 1];
+    };
+
+    const int64_t nchunks = unique_num_chunks(numel);
+    const int64_t chunk_size = divup(numel, nchunks);
+    std::vector<int64_t> chunk_runs(nchunks + 1, 0);
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        const int64_t hi = std::min(numel, (c + 1) * chunk_size);
+        int64_t runs = 0;
+        for (int64_t i = c * chunk_size; i < hi; ++i) {
+          runs += is_run_start(i);
         }
+        chunk_runs[c + 1] = runs;
       }
-      if (return_inverse) {
-        inverse_data[i] = p - output_data;
-      }
+    });
+    for (int64_t c = 0; c < nchunks; ++c) {
+      chunk_runs[c + 1] += chunk_runs[c];
     }
-    int64_t output_size = p - output_data + 1;
+    const int64_t output_size = chunk_runs[nchunks];
+
+    std::vector<int64_t> run_starts(return_counts ? output_size : 0);
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        const int64_t hi = std::min(numel, (c + 1) * chunk_size);
+        // id of the run containing the first element of the chunk
+        int64_t id = chunk_runs[c] - 1;
+        for (int64_t i = c * chunk_size; i < hi; ++i) {
+          if (is_run_start(i)) {
+            ++id;
+            output_data[id] = input_data[i];
+            if (return_counts) {
+              run_starts[id] = i;
+            }
+          }
+          if (inverse_data) {
+            inverse_data[i] = id;
+          }
+        }
+      }
+    });
+
     if (return_counts) {
-      *q = numel - last;
       counts.resize_({output_size});
+      int64_t* counts_data = counts.data_ptr<int64_t>();
+      at::parallel_for(0, output_size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t j = begin; j < end; ++j) {
+          const int64_t next = j + 1 < output_size ? run_starts[j + 1] : numel;
+          counts_data[j] = next - run_starts[j];
+        }
+      });
     }
     output.resize_({output_size});
   }
@@ -88,7 +88,8 @@ static void upsample_nearest3d_backward_out_cpu_template(
       output_width);
 
   grad_input.resize_(
-      {nbatch, channels, input_depth, input_height, input_width});
+      {nbatch, channels, input_depth, input_height, input_width},
+      grad_output.suggest_memory_format());
   grad_input.zero_();
 
   upsample_nearest3d_backward_kernel(kCPU, grad_input, grad_output, scales_d, scales_h, scales_w);
@@ -93,7 +93,8 @@ static void upsample_trilinear3d_backward_out_cpu_template(
       output_width);
 
   grad_input.resize_(
-      {nbatch, channels, input_depth, input_height, input_width});
+      {nbatch, channels, input_depth, input_height, input_width},
+      grad_output.suggest_memory_format());
   grad_input.zero_();
 
   upsample_trilinear3d_backward_kernel(kCPU, grad_input, grad_output, align_corners, scales_d, scales_h, scales_w);
@@ -12,6 +12,25 @@ using batch_norm_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
 
 DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_inference_contiguous_stub);
 
+// Kernels for inputs whose channels are the innermost dimension
+// (ChannelsLast / ChannelsLast3d). They treat the input as a
+// {numel / C, C} matrix and vectorize along C.
+//
+// output = input * alpha[c] + beta[c]
+using batch_norm_channels_last_fn = void (*)(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta);
+// mean[c] and var_sum[c] = sum((input - mean[c])^2)
+using batch_norm_collect_stats_fn = void (*)(Tensor& mean, Tensor& var_sum,
+    const Tensor& input);
+// grad_input, grad_weight and grad_bias may be undefined
+using batch_norm_backward_fn = void (*)(Tensor& grad_input, Tensor& grad_weight,
+    Tensor& grad_bias, const Tensor& grad_output, const Tensor& input,
+    const Tensor& weight, const Tensor& mean, const Tensor& invstd, bool train);
+
+DECLARE_DISPATCH(batch_norm_channels_last_fn, batch_norm_cpu_channels_last_stub);
+DECLARE_DISPATCH(batch_norm_collect_stats_fn, batch_norm_cpu_collect_stats_channels_last_stub);
+DECLARE_DISPATCH(batch_norm_backward_fn, batch_norm_cpu_backward_channels_last_stub);
+
 } // namespace native
 
 } // namespace at
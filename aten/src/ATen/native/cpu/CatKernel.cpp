@@ -1,67 +1,75 @@
 #include <ATen/ATen.h>
 
-#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace at { namespace native {
 
 namespace {
 
+// All inputs and the result are contiguous in the same memory format, so for
+// every index of the dimensions outside `dim` (in memory order) the result
+// holds one contiguous row made of one contiguous block from each input. The
+// block geometry only depends on the shapes and is computed once up front.
 struct InputMeta {
-  void* data_ptr;
-  int64_t inner_size;
-
-  InputMeta(const Tensor& t, int64_t dim, int64_t inner)
-    : data_ptr(t.data_ptr())
-    , inner_size(t.size(dim) * inner) {}
+  const char* data_ptr;
+  // bytes copied from this input for each outer index
+  int64_t inner_bytes;
+  // where those bytes start inside a result row
+  int64_t offset_bytes;
 };
 
-template <typename scalar_t>
-void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
-  int64_t outer = result.numel() / (result.size(dim) * result.stride(dim));
-  scalar_t* result_data = result.data_ptr<scalar_t>();
-  int64_t ninputs = tensors.size();
+void cat_contig_kernel(Tensor& result, TensorList tensors, int64_t dim) {
+  const int64_t elem_size = result.element_size();
+  const int64_t inner = result.stride(dim);
+  const int64_t row_elems = result.size(dim) * inner;
+  const int64_t row_bytes = row_elems * elem_size;
+  const int64_t outer = result.numel() / row_elems;
+
   std::vector<InputMeta> inputs;
-  inputs.reserve(ninputs);
+  inputs.reserve(tensors.size());
+  int64_t offset_bytes = 0;
   for (auto const &tensor : tensors) {
-    inputs.emplace_back(tensor, dim, result.stride(dim));
+    if (tensor.numel() == 0) {
+      continue;
+    }
+    const int64_t inner_bytes = tensor.size(dim) * inner * elem_size;
+    inputs.push_back({static_cast<const char*>(tensor.data_ptr()), inner_bytes, offset_bytes});
+    offset_bytes += inner_bytes;
+  }
+  const int64_t ninputs = inputs.size();
+  if (ninputs == 0) {
+    return;
   }
 
-  using Vec = vec256::Vec256<scalar_t>;
-  scalar_t* result_ptr = result_data;
-  for (int64_t i = 0; i < outer; ++i) {
-    for (int64_t j = 0; j < ninputs; j++) {
-      int64_t local_inner = inputs[j].inner_size;
-      scalar_t* input_ptr = (scalar_t*)(inputs[j].data_ptr) + i * local_inner;
-      if (local_inner < Vec::size()) {
-        #ifndef _MSC_VER
-        # pragma unroll
-        #endif
-        for (int64_t k = 0; k < local_inner; k++) {
-          result_ptr[k] = input_ptr[k];
-        }
-      } else {
-        vec256::map(
-            [](Vec x) { return x; },
-            result_ptr,
-            input_ptr,
-            local_inner);
+  // Work items are (outer index, input) pairs, each a single block copy.
+  // Flattening them lets us parallelize both a tall cat (large outer) and a
+  // cat of many inputs along the outermost dimension (outer == 1).
+  char* result_data = static_cast<char*>(result.data_ptr());
+  const int64_t block_elems = std::max<int64_t>(row_elems / ninputs, 1);
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / block_elems, 1);
+  at::parallel_for(0, outer * ninputs, grain_size, [&](int64_t begin, int64_t end) {
+    int64_t i = begin / ninputs;
+    int64_t j = begin % ninputs;
+    for (int64_t k = begin; k < end; ++k) {
+      const InputMeta& input = inputs[j];
+      std::memcpy(
+          result_data + i * row_bytes + input.offset_bytes,
+          input.data_ptr + i * input.inner_bytes,
+          input.inner_bytes);
+      if (++j == ninputs) {
+        j = 0;
+        ++i;
       }
-      result_ptr += local_inner;
     }
-  }
-}
-
-void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
-  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cat_serial_kernel", [&]() {
-    cat_serial_kernel_impl<scalar_t>(result, tensors, dim);
   });
 }
 
 } // anonymous namespace
 
-REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_contig_stub, &cat_contig_kernel);
 
 }} // at::native
@@ -5,7 +5,9 @@
 
 namespace at { namespace native {
 
-using cat_serial_fn = void(*)(Tensor &, TensorList, int64_t);
-DECLARE_DISPATCH(cat_serial_fn, cat_serial_stub);
+// Concatenates inputs that are all contiguous in the result's memory format
+// and have the result's dtype.
+using cat_contig_fn = void(*)(Tensor &, TensorList, int64_t);
+DECLARE_DISPATCH(cat_contig_fn, cat_contig_stub);
 
 }}  // namespace at::native
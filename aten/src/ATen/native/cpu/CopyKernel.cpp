@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -10,9 +12,171 @@ namespace at {
 namespace native {
 namespace {
 
+// Transposed copies
+// -----------------
+// x.t().contiguous(), NCHW <-> NHWC conversions and similar permutes end up
+// as a copy whose output is contiguous along one dimension while the input is
+// contiguous along another. The generic loop walks the input with a large
+// stride, touching a new cache line for every element. Instead we copy tile by
+// tile: a tile of the input fits in L1, so every line is reused for all the
+// elements in it, and the tiles are spread across threads.
+//
+// After coalescing, TensorIterator orders dimensions by output stride, so the
+// pattern we look for is a 2-d iterator (plus an optional batch dimension)
+// where dim 0 is contiguous in the output and dim 1 is contiguous in the input.
+// Elements are moved as raw bits, so only the element size matters.
+
+static bool is_transpose_copy(const TensorIterator& iter) {
+  constexpr int64_t MIN_SZ = 60 * 60;
+  constexpr int64_t MIN_DIM = 8;
+  if (iter.ndim() != 2 && iter.ndim() != 3) {
+    return false;
+  }
+  const int64_t elem_size = iter.element_size(0);
+  if (elem_size != 1 && elem_size != 2 && elem_size != 4 && elem_size != 8) {
+    return false;
+  }
+  const auto out_strides = iter.strides(0);
+  const auto in_strides = iter.strides(1);
+  const auto shape = iter.shape();
+  return out_strides[0] == elem_size && in_strides[1] == elem_size &&
+      out_strides[1] % elem_size == 0 && in_strides[0] % elem_size == 0 &&
+      in_strides[0] > elem_size && shape[0] >= MIN_DIM && shape[1] >= MIN_DIM &&
+      iter.numel() >= MIN_SZ;
+}
+
+// out[a + b * out_stride] = in[a * in_stride + b] for a < n0, b < n1
+template <typename scalar_t>
+static inline void transpose_tile_scalar(
+    const scalar_t* in, scalar_t* out, int64_t n0, int64_t n1,
+    int64_t in_stride, int64_t out_stride) {
+  for (int64_t b = 0; b < n1; ++b) {
+    for (int64_t a = 0; a < n0; ++a) {
+      out[a + b * out_stride] = in[a * in_stride + b];
+    }
+  }
+}
+
+template <typename scalar_t>
+static inline void transpose_tile(
+    const scalar_t* in, scalar_t* out, int64_t n0, int64_t n1,
+    int64_t in_stride, int64_t out_stride) {
+  transpose_tile_scalar(in, out, n0, n1, in_stride, out_stride);
+}
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+// 8x8 blocks of 32-bit elements are transposed in registers. The data is only
+// shuffled, never used in arithmetic, so going through __m256 is exact for any
+// 32-bit type.
+static inline void transpose_8x8_32bit(
+    const float* in, float* out, int64_t in_stride, int64_t out_stride) {
+  __m256 r0 = _mm256_loadu_ps(in + 0 * in_stride);
+  __m256 r1 = _mm256_loadu_ps(in + 1 * in_stride);
+  __m256 r2 = _mm256_loadu_ps(in + 2 * in_stride);
+  __m256 r3 = _mm256_loadu_ps(in + 3 * in_stride);
+  __m256 r4 = _mm256_loadu_ps(in + 4 * in_stride);
+  __m256 r5 = _mm256_loadu_ps(in + 5 * in_stride);
+  __m256 r6 = _mm256_loadu_ps(in + 6 * in_stride);
+  __m256 r7 = _mm256_loadu_ps(in + 7 * in_stride);
+
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+  _mm256_storeu_ps(out + 0 * out_stride, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(out + 1 * out_stride, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(out + 2 * out_stride, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(out + 3 * out_stride, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(out + 4 * out_stride, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(out + 5 * out_stride, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(out + 6 * out_stride, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(out + 7 * out_stride, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+template <>
+inline void transpose_tile<int32_t>(
+    const int32_t* in, int32_t* out, int64_t n0, int64_t n1,
+    int64_t in_stride, int64_t out_stride) {
+  const int64_t n0_vec = n0 - n0 % 8;
+  const int64_t n1_vec = n1 - n1 % 8;
+  for (int64_t a = 0; a < n0_vec; a += 8) {
+    for (int64_t b = 0; b < n1_vec; b += 8) {
+      transpose_8x8_32bit(
+          reinterpret_cast<const float*>(in + a * in_stride + b),
+          reinterpret_cast<float*>(out + a + b * out_stride),
+          in_stride, out_stride);
+    }
+  }
+  // Leftover columns and rows
+  transpose_tile_scalar(
+      in + n1_vec, out + n1_vec * out_stride, n0, n1 - n1_vec, in_stride, out_stride);
+  transpose_tile_scalar(
+      in + n0_vec * in_stride, out + n0_vec, n0 - n0_vec, n1_vec, in_stride, out_stride);
+}
+#endif
+
+template <typename scalar_t>
+static void transpose_copy_kernel(TensorIterator& iter) {
+  // Keep a tile around 16KB so the input and output tiles both stay in L1
+  constexpr int64_t BLOCK_SZ = sizeof(scalar_t) == 1 ? 128 : (sizeof(scalar_t) == 8 ? 32 : 64);
+  constexpr int64_t elem_size = sizeof(scalar_t);
+  const auto shape = iter.shape();
+  const auto out_strides = iter.strides(0);
+  const auto in_strides = iter.strides(1);
+  const int64_t n0 = shape[0];
+  const int64_t n1 = shape[1];
+  const int64_t nbatch = iter.ndim() == 3 ? shape[2] : 1;
+  const int64_t out_batch_stride = iter.ndim() == 3 ? out_strides[2] : 0;
+  const int64_t in_batch_stride = iter.ndim() == 3 ? in_strides[2] : 0;
+  const int64_t out_stride = out_strides[1] / elem_size;
+  const int64_t in_stride = in_strides[0] / elem_size;
+  char* out_data = static_cast<char*>(iter.data_ptr(0));
+  const char* in_data = static_cast<const char*>(iter.data_ptr(1));
+
+  const int64_t tiles0 = divup(n0, BLOCK_SZ);
+  const int64_t tiles1 = divup(n1, BLOCK_SZ);
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / (BLOCK_SZ * BLOCK_SZ), 1);
+  at::parallel_for(0, nbatch * tiles0 * tiles1, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; ++t) {
+      const int64_t batch = t / (tiles0 * tiles1);
+      const int64_t a = (t / tiles1) % tiles0 * BLOCK_SZ;
+      const int64_t b = t % tiles1 * BLOCK_SZ;
+      const auto* in = reinterpret_cast<const scalar_t*>(in_data + batch * in_batch_stride) +
+          a * in_stride + b;
+      auto* out = reinterpret_cast<scalar_t*>(out_data + batch * out_batch_stride) +
+          a + b * out_stride;
+      transpose_tile<scalar_t>(
+          in, out, std::min(BLOCK_SZ, n0 - a), std::min(BLOCK_SZ, n1 - b),
+          in_stride, out_stride);
+    }
+  });
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
   if (dtype == iter.dtype(1)) {
+    if (is_transpose_copy(iter)) {
+      switch (iter.element_size(0)) {
+        case 1: return transpose_copy_kernel<int8_t>(iter);
+        case 2: return transpose_copy_kernel<int16_t>(iter);
+        case 4: return transpose_copy_kernel<int32_t>(iter);
+        case 8: return transpose_copy_kernel<int64_t>(iter);
+      }
+    }
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
     } else if (dtype == ScalarType::BFloat16) {
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <ATen/Context.h>
 #include <ATen/Dispatch.h>
 #include <ATen/CPUApplyUtils.h>
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <limits>
@@ -81,6 +85,76 @@ struct RandomKernel {
   }
 };
 
+// ==================================================== Philox ========================================================
+
+// Note [Philox CPU generation]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// When at::globalContext().philoxCPURNG() is set, uniform_, normal_ and
+// bernoulli_ do not draw their numbers one after the other from the generator
+// while holding its lock. They take a single 64 bit seed from it instead, and
+// element i of the output is computed from the 32 bit words
+// i * words_per_element, i * words_per_element + 1, ... of the Philox stream
+// of that seed. Philox is counter based, so every chunk of a parallel_for
+// skips to its first word in constant time, and the numbers only depend on the
+// seed, not on the number of threads or on the chunks. The state of the
+// generator remains the mt19937 one, which get_state and set_state handle.
+
+// The words of the Philox stream of a seed, from first_word on, for the
+// distributions of DistributionsHelper.h. It has no cached normal samples, so
+// every element consumes the same number of words.
+struct PhiloxCPUStream {
+  PhiloxCPUStream(uint64_t seed, uint64_t first_word) : engine_(seed, 0, first_word / 4) {
+    for (uint64_t i = 0; i < first_word % 4; i++) {
+      engine_();
+    }
+  }
+  uint32_t random() {
+    return engine_();
+  }
+  uint64_t random64() {
+    const uint32_t hi = engine_();
+    const uint32_t lo = engine_();
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+  }
+
+ private:
+  at::Philox4_32_10 engine_;
+};
+
+// Generating one element costs about as much as the MKL bernoulli, see
+// bernoulli_scalar_kernel in UnaryOpsKernel.cpp.
+constexpr int64_t kPhiloxGrainSize = 800;
+
+template<typename RNG>
+uint64_t philox_seed(RNG generator) {
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  return generator->random64();
+}
+
+// Sets element i of self, in the order of a contiguous tensor, to
+// f(i, stream), where stream starts at the word i * words_per_element.
+template<typename scalar_t, typename F>
+void philox_fill(Tensor& self, uint64_t seed, int64_t words_per_element, const F& f) {
+  Tensor out = self.is_contiguous() ? self : at::empty(self.sizes(), self.options());
+  scalar_t* data = out.data_ptr<scalar_t>();
+  at::parallel_for(0, out.numel(), kPhiloxGrainSize, [&](int64_t begin, int64_t end) {
+    PhiloxCPUStream stream(seed, begin * words_per_element);
+    for (int64_t i = begin; i < end; i++) {
+      data[i] = f(i, &stream);
+    }
+  });
+  if (!out.is_same(self)) {
+    self.copy_(out);
+  }
+}
+
+// The number of words of a uniform_real_distribution<scalar_t>.
+template<typename scalar_t>
+constexpr int64_t uniform_words() {
+  return std::is_same<scalar_t, double>::value ? 2 : 1;
+}
+
 // ==================================================== Normal ========================================================
 
 #ifdef CPU_CAPABILITY_AVX2
@@ -170,8 +244,72 @@ void normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, RNG gene
   }
 }
 
+template <typename scalar_t>
+static void normal_fill_16_philox(scalar_t *data, const scalar_t mean, const scalar_t std) {
+  normal_fill_16<scalar_t>(data, mean, std);
+}
+
+#ifdef CPU_CAPABILITY_AVX2
+static void normal_fill_16_philox(float *data, const float mean, const float std) {
+  const __m256 two_pi = _mm256_set1_ps(2.0f * M_PI);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 minus_two = _mm256_set1_ps(-2.0f);
+  const __m256 mean_v = _mm256_set1_ps(mean);
+  const __m256 std_v = _mm256_set1_ps(std);
+  normal_fill_16_AVX2(data, &two_pi, &one, &minus_two, &mean_v, &std_v);
+}
+#endif
+
+// normal_fill in parallel, see Note [Philox CPU generation]. The blocks of 16
+// start at multiples of 16 as in normal_fill, so that the chunks do not
+// change them.
+template <typename scalar_t>
+void normal_fill_philox(Tensor& self, const scalar_t mean, const scalar_t std, uint64_t seed) {
+  scalar_t *data = self.data_ptr<scalar_t>();
+  const int64_t size = self.numel();
+  const auto fill_uniform = [seed](scalar_t *dst, int64_t first, int64_t n) {
+    PhiloxCPUStream stream(seed, first * uniform_words<scalar_t>());
+    at::uniform_real_distribution<scalar_t> uniform(0, 1);
+    for (int64_t i = 0; i < n; ++i) {
+      dst[i] = uniform(&stream);
+    }
+  };
+  at::parallel_for(0, size / 16, kPhiloxGrainSize / 16, [&](int64_t begin, int64_t end) {
+    fill_uniform(data + begin * 16, begin * 16, (end - begin) * 16);
+    for (int64_t i = begin; i < end; ++i) {
+      normal_fill_16_philox(data + i * 16, mean, std);
+    }
+  });
+  if (size % 16 != 0) {
+    // Recompute the last 16 values, from the words after those of the
+    // elements.
+    fill_uniform(data + size - 16, size, 16);
+    normal_fill_16_philox(data + size - 16, mean, std);
+  }
+}
+
+template<typename RNG>
+void normal_kernel_philox(Tensor& self, double mean, double std, RNG generator) {
+  const uint64_t seed = philox_seed(generator);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "normal_kernel_cpu", [&] {
+    if (self.numel() >= 16 && self.is_contiguous()) {
+      normal_fill_philox<scalar_t>(self, static_cast<scalar_t>(mean), static_cast<scalar_t>(std), seed);
+    } else {
+      // normal_distribution<double> takes two random64
+      philox_fill<scalar_t>(self, seed, 4, [mean, std](int64_t, PhiloxCPUStream* stream) -> scalar_t {
+        at::normal_distribution<double> normal(mean, std);
+        return static_cast<scalar_t>(normal(stream));
+      });
+    }
+  });
+}
+
 template<typename RNG>
 void normal_kernel(Tensor& self, double mean, double std, RNG generator) {
+  if (at::globalContext().philoxCPURNG()) {
+    normal_kernel_philox(self, mean, std, generator);
+    return;
+  }
   auto size = self.numel();
   if (self.scalar_type() == ScalarType::Float && size >= 16 && self.is_contiguous()) {
 #ifdef CPU_CAPABILITY_AVX2
@@ -209,9 +347,19 @@ struct NormalKernel {
 template<typename RNG>
 void uniform_kernel(TensorIterator& iter, double from_, double to_, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, iter.dtype(), "uniform_kernel_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
     auto from = static_cast<scalar_t>(from_);
     auto to = static_cast<scalar_t>(to_);
+    if (at::globalContext().philoxCPURNG()) {
+      // See Note [Philox CPU generation]
+      Tensor self = iter.tensor(0);
+      philox_fill<scalar_t>(self, philox_seed(generator), uniform_words<scalar_t>(),
+                            [from, to](int64_t, PhiloxCPUStream* stream) -> scalar_t {
+        at::uniform_real_distribution<scalar_t> uniform(from, to);
+        return static_cast<scalar_t>(uniform(stream));
+      });
+      return;
+    }
+    std::lock_guard<std::mutex> lock(generator->mutex_);
     at::uniform_real_distribution<scalar_t> uniform(from, to);
     cpu_serial_kernel(iter, [&uniform, generator]() -> scalar_t {
       return static_cast<scalar_t>(uniform(generator));
@@ -311,9 +459,30 @@ struct ExponentialKernel {
 template<typename RNG>
 void bernoulli_kernel(Tensor& self, const Tensor& p_, RNG generator) {
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_tensor_cpu_self_", [&] {
+    using self_t = scalar_t;
+    if (at::globalContext().philoxCPURNG()) {
+      // See Note [Philox CPU generation]
+      const uint64_t seed = philox_seed(generator);
+      auto p = std::get<0>(expand_inplace(self, p_.to(kCPU))).contiguous();
+      if (p.scalar_type() == kDouble) {
+        const double* p_data = p.data_ptr<double>();
+        philox_fill<self_t>(self, seed, uniform_words<double>(), [p_data](int64_t i, PhiloxCPUStream* stream) -> self_t {
+          at::bernoulli_distribution<double> bernoulli(p_data[i]);
+          return static_cast<self_t>(bernoulli(stream));
+        });
+      } else {
+        AT_DISPATCH_FLOATING_TYPES(p.scalar_type(), "bernoulli_tensor_cpu_p_", [&] {
+          const scalar_t* p_data = p.data_ptr<scalar_t>();
+          philox_fill<self_t>(self, seed, uniform_words<float>(), [p_data](int64_t i, PhiloxCPUStream* stream) -> self_t {
+            at::bernoulli_distribution<float> bernoulli(p_data[i]);
+            return static_cast<self_t>(bernoulli(stream));
+          });
+        });
+      }
+      return;
+    }
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
-    using self_t = scalar_t;
     auto p = std::get<0>(expand_inplace(self, p_.to(kCPU)));
     auto iter = TensorIteratorConfig()
         .add_output(self)
@@ -340,6 +509,16 @@ void bernoulli_kernel(Tensor& self, const Tensor& p_, RNG generator) {
 template<typename RNG>
 void bernoulli_kernel(Tensor& self, double p, RNG generator) {
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+    if (at::globalContext().philoxCPURNG()) {
+      // See Note [Philox CPU generation]. A float p, as on CUDA, takes half
+      // the words of a double one.
+      philox_fill<scalar_t>(self, philox_seed(generator), uniform_words<float>(),
+                            [p](int64_t, PhiloxCPUStream* stream) -> scalar_t {
+        at::bernoulli_distribution<float> bernoulli(p);
+        return static_cast<scalar_t>(bernoulli(stream));
+      });
+      return;
+    }
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
     auto iter = TensorIterator::nullary_op(self);
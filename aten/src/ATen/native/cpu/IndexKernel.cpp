@@ -1,11 +1,14 @@
 #include <ATen/native/TensorAdvancedIndexing.h>
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <iostream>
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/native/cpu/AtomicAddFloat.h>
 
 namespace at { namespace native {
@@ -241,10 +244,78 @@ void masked_select_kernel(TensorIterator& iter, int64_t result_stride) {
     });
 }
 
+// self.select(dim, index[i]) += source.select(dim, i), where the selected
+// slices of self and source are contiguous with the same shape.
+//
+// Rows of self are never written concurrently, and each element receives its
+// contributions in index order, so the result matches the serial loop exactly.
+void index_add_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& source) {
+  const int64_t numel = index.numel();
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  for (int64_t i = 0; i < numel; i++) {
+    const int64_t self_i = index_data[i];
+    TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
+  }
+  if (numel == 0 || self.numel() == 0) {
+    return;
+  }
+  const int64_t slice_size = self.numel() / self_dim_size;
+  const int64_t self_stride = self.stride(dim);
+  const int64_t source_stride = source.stride(dim);
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "index_add_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    scalar_t* self_data = self.data_ptr<scalar_t>();
+    const scalar_t* source_data = source.data_ptr<scalar_t>();
+    auto add_row = [&](int64_t i, int64_t begin, int64_t end) {
+      scalar_t* dst = self_data + index_data[i] * self_stride + begin;
+      const scalar_t* src = source_data + i * source_stride + begin;
+      vec256::map2([](Vec x, Vec y) { return x + y; }, dst, dst, src, end - begin);
+    };
+
+    const int64_t nparts = std::min<int64_t>(at::get_num_threads(), self_dim_size);
+    if (slice_size >= internal::GRAIN_SIZE || nparts <= 1 || at::in_parallel_region() ||
+        numel * slice_size < internal::GRAIN_SIZE) {
+      // Wide rows, or too little work to partition: split the rows into
+      // column blocks and give each thread one block of every row.
+      at::parallel_for(0, slice_size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = 0; i < numel; i++) {
+          add_row(i, begin, end);
+        }
+      });
+      return;
+    }
+
+    // Narrow rows (e.g. embedding gradients): partition the rows of self into
+    // nparts contiguous ranges and bucket the index positions by the range
+    // they write to, keeping their original order within a bucket.
+    auto part_of = [&](int64_t row) { return row * nparts / self_dim_size; };
+    std::vector<int64_t> offsets(nparts + 1, 0);
+    for (int64_t i = 0; i < numel; i++) {
+      offsets[part_of(index_data[i]) + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<int64_t> order(numel);
+    std::vector<int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (int64_t i = 0; i < numel; i++) {
+      order[cursor[part_of(index_data[i])]++] = i;
+    }
+    at::parallel_for(0, nparts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        for (int64_t k = offsets[p]; k < offsets[p + 1]; k++) {
+          add_row(order[k], 0, slice_size);
+        }
+      }
+    });
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(index_stub, &index_kernel);
 REGISTER_DISPATCH(index_put_stub, &index_put_kernel);
+REGISTER_DISPATCH(index_add_stub, &index_add_kernel);
 REGISTER_DISPATCH(masked_fill_stub, &masked_fill_kernel);
 REGISTER_DISPATCH(masked_select_serial_stub, &masked_select_serial_kernel);
 REGISTER_DISPATCH(masked_select_stub, &masked_select_kernel);
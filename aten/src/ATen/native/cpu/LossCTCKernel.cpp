@@ -0,0 +1,320 @@
+// The alpha and beta recursions of the CPU CTC loss, see LossCTC.cpp for the
+// equations of Graves et al [1] they follow.
+// 1. Graves et al: http://www.cs.toronto.edu/~graves/icml_2006.pdf
+//
+// The batch items are independent and split between the threads. Within an
+// item, a row of alphas (or betas) only depends on the previous one, so the
+// row is computed with Vec256 over s, from the previous row padded with -inf
+// for the states before the first (after the last, for the betas). The
+// backward keeps two rows of betas instead of all of them, and collects the
+// occupation probabilities of eq (16) right away rather than their logs.
+
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/LossCTC.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec256;
+
+// The augmented targets l' of a batch item, and for each s the log of whether
+// the transition from s - 2 to s of eq (6) is allowed: 0 or -inf. There are
+// two more -inf at the end, so that the masks of the transitions from s + 2
+// to s of eq (10) start at skip_mask + 2.
+template <typename scalar_t, typename target_t>
+void get_target_primes(
+    const target_t* targets, int64_t offset, int64_t stride, int64_t target_length, int64_t BLANK,
+    std::vector<int64_t>& target_primes, std::vector<scalar_t>& skip_mask) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t num_states = 2 * target_length + 1;
+  target_primes.resize(num_states);
+  skip_mask.assign(num_states + 2, neginf);
+  for (int64_t s = 0; s < num_states; s++) {
+    target_primes[s] = (s % 2 == 0) ? BLANK : targets[offset + stride * (s / 2)];
+    if (s > 1 && target_primes[s] != target_primes[s - 2]) {
+      skip_mask[s] = 0;
+    }
+  }
+}
+
+// log(exp(la1) + exp(la2) + exp(la3 + la3_mask)) + log_probs for n states,
+// the assignment of eq (6) and (10). We keep track of the maximum for the
+// logsumexp calculation.
+template <typename scalar_t>
+void log_add3_row(
+    scalar_t* out, const scalar_t* la1, const scalar_t* la2, const scalar_t* la3,
+    const scalar_t* la3_mask, const scalar_t* log_probs, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec neginf(-std::numeric_limits<scalar_t>::infinity());
+  const Vec zero(scalar_t(0));
+  for (int64_t s = 0; s < n; s += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), n - s);
+    const Vec a1 = Vec::loadu(la1 + s, count);
+    const Vec a2 = Vec::loadu(la2 + s, count);
+    const Vec a3 = Vec::loadu(la3 + s, count) + Vec::loadu(la3_mask + s, count);
+    Vec lamax = maximum(maximum(a1, a2), a3);
+    // cannot do neginf-neginf
+    lamax = Vec::blendv(lamax, zero, lamax == neginf);
+    const Vec sum = (a1 - lamax).exp() + (a2 - lamax).exp() + (a3 - lamax).exp();
+    (sum.log() + lamax + Vec::loadu(log_probs + s, count)).store(out + s, count);
+  }
+}
+
+// exp(log_alpha + log_beta + nll - log_probs) for n states: the terms of the
+// sum of eq (16), divided by the likelihood, whose log is -nll.
+template <typename scalar_t>
+void occupation_row(
+    scalar_t* out, const scalar_t* log_alpha, const scalar_t* log_beta,
+    const scalar_t* log_probs, scalar_t nll, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec nll_vec(nll);
+  for (int64_t s = 0; s < n; s += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), n - s);
+    const Vec x = Vec::loadu(log_alpha + s, count) + Vec::loadu(log_beta + s, count) +
+        nll_vec - Vec::loadu(log_probs + s, count);
+    x.exp().store(out + s, count);
+  }
+}
+
+// log_probs of the augmented targets at time t of a batch item
+template <typename scalar_t, typename accessor_t>
+void gather_log_probs(
+    scalar_t* out, const accessor_t& log_probs_t, const std::vector<int64_t>& target_primes) {
+  for (size_t s = 0; s < target_primes.size(); s++) {
+    out[s] = log_probs_t[target_primes[s]];
+  }
+}
+
+// The alphas of section 4.1, in log space. This returns the loss and the
+// alphas, which are kept for the backward.
+template <typename scalar_t, typename target_t>
+void ctc_loss_kernel_impl(
+    Tensor& neg_log_likelihood, Tensor& log_alpha, const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths, IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride, int64_t BLANK) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t batch_size = log_probs.size(1);
+
+  auto lpp = log_probs.permute({1, 0, 2});
+  auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
+  auto log_alpha_a_global = log_alpha.accessor<scalar_t, 3>();
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+
+  // the default of the first row, see below for the three equations for
+  // alpha_1 above eq (6)
+  log_alpha.narrow(1, 0, 1).fill_(neginf);
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    std::vector<int64_t> target_primes;
+    std::vector<scalar_t> skip_mask, log_probs_row, alpha_rows;
+    for (int64_t b = start; b < end; b++) {
+      const int64_t input_length = input_lengths[b];
+      const int64_t target_length = target_lengths[b];
+      const int64_t num_states = 2 * target_length + 1;
+      auto log_probs_a = log_probs_a_global[b];
+      auto log_alpha_a = log_alpha_a_global[b];
+      get_target_primes(
+          targets_data, tg_batch_offsets[b], tg_target_stride, target_length, BLANK,
+          target_primes, skip_mask);
+      log_probs_row.resize(num_states);
+      // the previous and the current row, each after two -inf for s - 1 and
+      // s - 2 of s = 0
+      alpha_rows.assign(2 * (num_states + 2), neginf);
+      scalar_t* prev = alpha_rows.data() + 2;
+      scalar_t* cur = prev + num_states + 2;
+
+      // the first two items of alpha_t above eq (6)
+      prev[0] = log_alpha_a[0][0] = log_probs_a[0][BLANK];
+      if (target_length > 0) {
+        prev[1] = log_alpha_a[0][1] = log_probs_a[0][target_primes[1]];
+      }
+
+      // now the loop over the inputs
+      for (int64_t t = 1; t < input_length; t++) {
+        gather_log_probs(log_probs_row.data(), log_probs_a[t], target_primes);
+        log_add3_row(cur, prev, prev - 1, prev - 2, skip_mask.data(), log_probs_row.data(), num_states);
+        std::copy(cur, cur + num_states, log_alpha_a[t].data());
+        std::swap(prev, cur);
+      }
+      // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
+      if (target_length == 0) {
+        // if the target is empty then there is no preceding BLANK state and hence there is no path to merge
+        neg_log_likelihood_a[b] = -prev[0];
+      } else {
+        scalar_t l1 = prev[target_length * 2];
+        scalar_t l2 = prev[target_length * 2 - 1];
+        scalar_t m = std::max(l1, l2);
+        m = ((m == neginf) ? 0 : m);
+        scalar_t log_likelihood = std::log(std::exp(l1 - m) + std::exp(l2 - m)) + m;
+        neg_log_likelihood_a[b] = -log_likelihood;
+      }
+    }
+  });
+}
+
+// This is the backward. It consists of two phases:
+// a) computing the beta analogous to the alphas in the forward (backward half of the forward-backward algorithm) (eq (10) and (11))
+//    and collecting the occupation probabilities of all s per activation, the sum of eq (16)
+// b) wrapping the gradient, in parallel over the time steps as well
+template <typename scalar_t, typename target_t>
+void ctc_loss_backward_kernel_impl(
+    Tensor& grad, const Tensor& grad_out, const Tensor& log_probs_, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths, IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride, const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+    int64_t BLANK, bool zero_infinity) {
+  constexpr scalar_t inf = std::numeric_limits<scalar_t>::infinity();
+  constexpr scalar_t neginf = -inf;
+  const int64_t max_input_length = log_probs_.size(0);
+  const int64_t batch_size = log_probs_.size(1);
+  const int64_t num_labels = log_probs_.size(2);
+
+  auto log_probs = log_probs_.contiguous();
+  auto lpp = log_probs.permute({1, 0, 2});
+  auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
+  auto log_alpha_a_global = log_alpha.accessor<scalar_t, 3>();
+  auto gp = grad.permute({1, 0, 2});
+  auto grad_a_global = gp.accessor<scalar_t, 3>();
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+  auto grad_out_a = grad_out.accessor<scalar_t, 1>();
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    std::vector<int64_t> target_primes;
+    std::vector<scalar_t> skip_mask, log_probs_row, beta_rows, occupation;
+    for (int64_t b = start; b < end; b++) {
+      const scalar_t nll = neg_log_likelihood_a[b];
+      const int64_t input_length = input_lengths[b];
+      // the gradient of an infinite loss is set in b)
+      if (nll == inf || input_length == 0) {
+        continue;
+      }
+      const int64_t target_length = target_lengths[b];
+      const int64_t num_states = 2 * target_length + 1;
+      auto log_probs_a = log_probs_a_global[b];
+      auto log_alpha_a = log_alpha_a_global[b];
+      auto grad_a = grad_a_global[b];
+      get_target_primes(
+          targets_data, tg_batch_offsets[b], tg_target_stride, target_length, BLANK,
+          target_primes, skip_mask);
+      log_probs_row.resize(num_states);
+      occupation.resize(num_states);
+      // the next and the current row, each before two -inf for s + 1 and
+      // s + 2 of the last s
+      beta_rows.assign(2 * (num_states + 2), neginf);
+      scalar_t* next = beta_rows.data();
+      scalar_t* cur = next + num_states + 2;
+
+      // collected[b, t, target'[s]] += alpha[t, s] * beta[t, s] / (y[t, target'[s]] * p)
+      // in contrast to the cuda implementation, we only parallelize over the batch, so we don't have a concurrency
+      // issue (several s can map to the same target character)
+      auto collect = [&](int64_t t, const scalar_t* log_beta) {
+        occupation_row(occupation.data(), log_alpha_a[t].data(), log_beta, log_probs_row.data(), nll, num_states);
+        auto grad_t = grad_a[t];
+        for (int64_t s = 0; s < num_states; s++) {
+          grad_t[target_primes[s]] += occupation[s];
+        }
+      };
+
+      // the initialization of beta before eq (10)
+      // here we do the fill for each batch item separately, as the input lengths will differ, so the t in which
+      // we start varies
+      gather_log_probs(log_probs_row.data(), log_probs_a[input_length - 1], target_primes);
+      next[2 * target_length] = log_probs_row[2 * target_length];
+      if (target_length > 0) {
+        next[2 * target_length - 1] = log_probs_row[2 * target_length - 1];
+      }
+      collect(input_length - 1, next);
+
+      // now loop applying eq (10) / (11)
+      for (int64_t t = input_length - 2; t >= 0; t--) {
+        gather_log_probs(log_probs_row.data(), log_probs_a[t], target_primes);
+        log_add3_row(cur, next, next + 1, next + 2, skip_mask.data() + 2, log_probs_row.data(), num_states);
+        collect(t, cur);
+        std::swap(next, cur);
+      }
+    }
+  });
+
+  // now grad has the sum of eq (16)
+  // now we wrap up the calculation by adding in the remaining items of eq (16)
+  // grad is the output gradient, nll is the loss. Note that the likelihood -nll is the Z of eq (16)
+  using Vec = Vec256<scalar_t>;
+  const scalar_t* log_probs_data = log_probs.data_ptr<scalar_t>();
+  scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, num_labels));
+  at::parallel_for(0, max_input_length * batch_size, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      const int64_t t = i / batch_size;
+      const int64_t b = i % batch_size;
+      const scalar_t nll = neg_log_likelihood_a[b];
+      scalar_t* grad_row = grad_data + i * num_labels;
+      // the remainder stays zero
+      if (t >= input_lengths[b] || (zero_infinity && nll == inf)) {
+        continue;
+      }
+      if (nll == inf) {
+        std::fill(grad_row, grad_row + num_labels, std::numeric_limits<scalar_t>::quiet_NaN());
+        continue;
+      }
+      const scalar_t* log_probs_row = log_probs_data + i * num_labels;
+      const Vec gr(grad_out_a[b]);
+      for (int64_t c = 0; c < num_labels; c += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), num_labels - c);
+        const Vec lp = Vec::loadu(log_probs_row + c, count);
+        ((lp.exp() - Vec::loadu(grad_row + c, count)) * gr).store(grad_row + c, count);
+      }
+    }
+  });
+}
+
+void ctc_loss_kernel(
+    Tensor& neg_log_likelihood, Tensor& log_alpha, const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths, IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride, int64_t BLANK) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_kernel_impl<scalar_t, int64_t>(
+          neg_log_likelihood, log_alpha, log_probs, targets, input_lengths, target_lengths,
+          tg_batch_offsets, tg_target_stride, BLANK);
+    } else {
+      ctc_loss_kernel_impl<scalar_t, int>(
+          neg_log_likelihood, log_alpha, log_probs, targets, input_lengths, target_lengths,
+          tg_batch_offsets, tg_target_stride, BLANK);
+    }
+  });
+}
+
+void ctc_loss_backward_kernel(
+    Tensor& grad, const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths, IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride, const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+    int64_t BLANK, bool zero_infinity) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_backward_kernel_impl<scalar_t, int64_t>(
+          grad, grad_out, log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+          tg_target_stride, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+    } else {
+      ctc_loss_backward_kernel_impl<scalar_t, int>(
+          grad, grad_out, log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+          tg_target_stride, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(ctc_loss_stub, &ctc_loss_kernel);
+REGISTER_DISPATCH(ctc_loss_backward_stub, &ctc_loss_backward_kernel);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,369 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/RNN.h>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec256;
+
+// Wraps a single value with the part of the Vec256 interface the cells use,
+// for the columns past the last full vector
+template <typename T>
+struct SingleValue {
+  T value;
+  SingleValue(T v) : value(v) {}
+  static SingleValue loadu(const T* ptr) {
+    return SingleValue(*ptr);
+  }
+  void store(T* ptr) const {
+    *ptr = value;
+  }
+  SingleValue operator+(const SingleValue& other) const {
+    return value + other.value;
+  }
+  SingleValue operator-(const SingleValue& other) const {
+    return value - other.value;
+  }
+  SingleValue operator*(const SingleValue& other) const {
+    return value * other.value;
+  }
+};
+
+template <typename T>
+inline SingleValue<T> sigmoid(SingleValue<T> x) {
+  return T(1) / (T(1) + std::exp(-x.value));
+}
+
+template <typename T>
+inline Vec256<T> sigmoid(Vec256<T> x) {
+  return (Vec256<T>(T(1)) + (Vec256<T>(T(0)) - x).exp()).reciprocal();
+}
+
+template <typename T>
+inline SingleValue<T> tanh(SingleValue<T> x) {
+  return std::tanh(x.value);
+}
+
+template <typename T>
+inline Vec256<T> tanh(Vec256<T> x) {
+  return x.tanh();
+}
+
+// Rows of the batch are independent, split them so that every task touches
+// at least GRAIN_SIZE gate values
+inline int64_t rows_grain_size(int64_t gates_per_row) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, gates_per_row));
+}
+
+// The gate at offset of a row, plus the biases if there are any
+template <typename V, typename T>
+inline V load_gate(const T* input_gates, const T* hidden_gates,
+                   const T* input_bias, const T* hidden_bias, int64_t offset) {
+  V gate = V::loadu(input_gates + offset) + V::loadu(hidden_gates + offset);
+  if (input_bias) {
+    gate = gate + V::loadu(input_bias + offset) + V::loadu(hidden_bias + offset);
+  }
+  return gate;
+}
+
+// Columns j to j + V::size() of a row. Gate k of column j is at
+// k * hidden_size + j, in the ifgo order of the LSTM weights. The activated
+// gates go to the workspace when there is one, for the backward.
+template <typename V, typename T>
+inline void lstm_column(
+    const T* input_gates,
+    const T* hidden_gates,
+    const T* input_bias,
+    const T* hidden_bias,
+    const T* cx,
+    T* hy,
+    T* cy,
+    T* workspace,
+    int64_t hidden_size,
+    int64_t j) {
+  auto gate = [&](int64_t k) {
+    return load_gate<V>(input_gates, hidden_gates, input_bias, hidden_bias, k * hidden_size + j);
+  };
+  const V ingate = sigmoid(gate(0));
+  const V forgetgate = sigmoid(gate(1));
+  const V cellgate = tanh(gate(2));
+  const V outgate = sigmoid(gate(3));
+  const V c = forgetgate * V::loadu(cx + j) + ingate * cellgate;
+  c.store(cy + j);
+  (outgate * tanh(c)).store(hy + j);
+  if (workspace) {
+    ingate.store(workspace + j);
+    forgetgate.store(workspace + hidden_size + j);
+    cellgate.store(workspace + 2 * hidden_size + j);
+    outgate.store(workspace + 3 * hidden_size + j);
+  }
+}
+
+void lstm_cell_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    Tensor& workspace,
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& cx) {
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* input_gates_data = input_gates.data_ptr<scalar_t>();
+    const scalar_t* hidden_gates_data = hidden_gates.data_ptr<scalar_t>();
+    const scalar_t* input_bias_data = input_bias.defined() ? input_bias.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* hidden_bias_data = hidden_bias.defined() ? hidden_bias.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    scalar_t* cy_data = cy.data_ptr<scalar_t>();
+    scalar_t* workspace_data = workspace.defined() ? workspace.data_ptr<scalar_t>() : nullptr;
+    at::parallel_for(
+        0, batch_size, rows_grain_size(4 * hidden_size), [&](int64_t begin, int64_t end) {
+          for (int64_t b = begin; b < end; b++) {
+            const scalar_t* ig = input_gates_data + b * 4 * hidden_size;
+            const scalar_t* hg = hidden_gates_data + b * 4 * hidden_size;
+            const scalar_t* c = cx_data + b * hidden_size;
+            scalar_t* h_out = hy_data + b * hidden_size;
+            scalar_t* c_out = cy_data + b * hidden_size;
+            scalar_t* w = workspace_data ? workspace_data + b * 4 * hidden_size : nullptr;
+            int64_t j = 0;
+            for (; j + Vec::size() <= hidden_size; j += Vec::size()) {
+              lstm_column<Vec>(ig, hg, input_bias_data, hidden_bias_data, c, h_out, c_out, w, hidden_size, j);
+            }
+            for (; j < hidden_size; j++) {
+              lstm_column<SingleValue<scalar_t>>(
+                  ig, hg, input_bias_data, hidden_bias_data, c, h_out, c_out, w, hidden_size, j);
+            }
+          }
+        });
+  });
+}
+
+// The gradients of the gates before the activations, from the activated gates
+// of the workspace, as in lstm_cell_backward of cuda/RNN.cu
+template <typename V, typename T>
+inline void lstm_backward_column(
+    const T* grad_hy,
+    const T* grad_cy,
+    const T* cx,
+    const T* cy,
+    const T* workspace,
+    T* grad_gates,
+    T* grad_cx,
+    int64_t hidden_size,
+    int64_t j) {
+  const V one(T(1));
+  const V ingate = V::loadu(workspace + j);
+  const V forgetgate = V::loadu(workspace + hidden_size + j);
+  const V cellgate = V::loadu(workspace + 2 * hidden_size + j);
+  const V outgate = V::loadu(workspace + 3 * hidden_size + j);
+  const V go = grad_hy ? V::loadu(grad_hy + j) : V(T(0));
+  const V goc = grad_cy ? V::loadu(grad_cy + j) : V(T(0));
+  const V tanh_cy = tanh(V::loadu(cy + j));
+  const V gcx = go * outgate * (one - tanh_cy * tanh_cy) + goc;
+  (gcx * cellgate * (one - ingate) * ingate).store(grad_gates + j);
+  (gcx * V::loadu(cx + j) * (one - forgetgate) * forgetgate).store(grad_gates + hidden_size + j);
+  (gcx * ingate * (one - cellgate * cellgate)).store(grad_gates + 2 * hidden_size + j);
+  (go * tanh_cy * (one - outgate) * outgate).store(grad_gates + 3 * hidden_size + j);
+  (gcx * forgetgate).store(grad_cx + j);
+}
+
+void lstm_cell_backward_kernel(
+    Tensor& grad_gates,
+    Tensor& grad_cx,
+    const Tensor& grad_hy,
+    const Tensor& grad_cy,
+    const Tensor& cx,
+    const Tensor& cy,
+    const Tensor& workspace) {
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_backward_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* grad_hy_data = grad_hy.defined() ? grad_hy.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* grad_cy_data = grad_cy.defined() ? grad_cy.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+    const scalar_t* cy_data = cy.data_ptr<scalar_t>();
+    const scalar_t* workspace_data = workspace.data_ptr<scalar_t>();
+    scalar_t* grad_gates_data = grad_gates.data_ptr<scalar_t>();
+    scalar_t* grad_cx_data = grad_cx.data_ptr<scalar_t>();
+    at::parallel_for(
+        0, batch_size, rows_grain_size(4 * hidden_size), [&](int64_t begin, int64_t end) {
+          for (int64_t b = begin; b < end; b++) {
+            const scalar_t* gh = grad_hy_data ? grad_hy_data + b * hidden_size : nullptr;
+            const scalar_t* gc = grad_cy_data ? grad_cy_data + b * hidden_size : nullptr;
+            const scalar_t* c = cx_data + b * hidden_size;
+            const scalar_t* c_out = cy_data + b * hidden_size;
+            const scalar_t* w = workspace_data + b * 4 * hidden_size;
+            scalar_t* g_gates = grad_gates_data + b * 4 * hidden_size;
+            scalar_t* g_c = grad_cx_data + b * hidden_size;
+            int64_t j = 0;
+            for (; j + Vec::size() <= hidden_size; j += Vec::size()) {
+              lstm_backward_column<Vec>(gh, gc, c, c_out, w, g_gates, g_c, hidden_size, j);
+            }
+            for (; j < hidden_size; j++) {
+              lstm_backward_column<SingleValue<scalar_t>>(gh, gc, c, c_out, w, g_gates, g_c, hidden_size, j);
+            }
+          }
+        });
+  });
+}
+
+// Gates are in the rzn order of the GRU weights, the candidate n applies the
+// reset gate to the hidden part only. The workspace, when there is one, gets
+// the reset, input and new gates, hx and the hidden part of n, in the layout
+// of gru_cell_forward in cuda/RNN.cu.
+template <typename V, typename T>
+inline void gru_column(
+    const T* input_gates,
+    const T* hidden_gates,
+    const T* input_bias,
+    const T* hidden_bias,
+    const T* hx,
+    T* hy,
+    T* workspace,
+    int64_t hidden_size,
+    int64_t j) {
+  const V resetgate = sigmoid(
+      load_gate<V>(input_gates, hidden_gates, input_bias, hidden_bias, j));
+  const V inputgate = sigmoid(
+      load_gate<V>(input_gates, hidden_gates, input_bias, hidden_bias, hidden_size + j));
+  V input_new = V::loadu(input_gates + 2 * hidden_size + j);
+  V hidden_new = V::loadu(hidden_gates + 2 * hidden_size + j);
+  if (input_bias) {
+    input_new = input_new + V::loadu(input_bias + 2 * hidden_size + j);
+    hidden_new = hidden_new + V::loadu(hidden_bias + 2 * hidden_size + j);
+  }
+  const V newgate = tanh(input_new + resetgate * hidden_new);
+  const V h = V::loadu(hx + j);
+  ((h - newgate) * inputgate + newgate).store(hy + j);
+  if (workspace) {
+    resetgate.store(workspace + j);
+    inputgate.store(workspace + hidden_size + j);
+    newgate.store(workspace + 2 * hidden_size + j);
+    h.store(workspace + 3 * hidden_size + j);
+    hidden_new.store(workspace + 4 * hidden_size + j);
+  }
+}
+
+void gru_cell_kernel(
+    Tensor& hy,
+    Tensor& workspace,
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& hx) {
+  const int64_t batch_size = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_cell_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* input_gates_data = input_gates.data_ptr<scalar_t>();
+    const scalar_t* hidden_gates_data = hidden_gates.data_ptr<scalar_t>();
+    const scalar_t* input_bias_data = input_bias.defined() ? input_bias.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* hidden_bias_data = hidden_bias.defined() ? hidden_bias.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    scalar_t* workspace_data = workspace.defined() ? workspace.data_ptr<scalar_t>() : nullptr;
+    at::parallel_for(
+        0, batch_size, rows_grain_size(3 * hidden_size), [&](int64_t begin, int64_t end) {
+          for (int64_t b = begin; b < end; b++) {
+            const scalar_t* ig = input_gates_data + b * 3 * hidden_size;
+            const scalar_t* hg = hidden_gates_data + b * 3 * hidden_size;
+            const scalar_t* h = hx_data + b * hidden_size;
+            scalar_t* h_out = hy_data + b * hidden_size;
+            scalar_t* w = workspace_data ? workspace_data + b * 5 * hidden_size : nullptr;
+            int64_t j = 0;
+            for (; j + Vec::size() <= hidden_size; j += Vec::size()) {
+              gru_column<Vec>(ig, hg, input_bias_data, hidden_bias_data, h, h_out, w, hidden_size, j);
+            }
+            for (; j < hidden_size; j++) {
+              gru_column<SingleValue<scalar_t>>(
+                  ig, hg, input_bias_data, hidden_bias_data, h, h_out, w, hidden_size, j);
+            }
+          }
+        });
+  });
+}
+
+// As gru_cell_backward of cuda/RNN.cu
+template <typename V, typename T>
+inline void gru_backward_column(
+    const T* grad_hy,
+    const T* workspace,
+    T* grad_input_gates,
+    T* grad_hidden_gates,
+    T* grad_hx,
+    int64_t hidden_size,
+    int64_t j) {
+  const V one(T(1));
+  const V resetgate = V::loadu(workspace + j);
+  const V inputgate = V::loadu(workspace + hidden_size + j);
+  const V newgate = V::loadu(workspace + 2 * hidden_size + j);
+  const V hx = V::loadu(workspace + 3 * hidden_size + j);
+  const V hidden_new = V::loadu(workspace + 4 * hidden_size + j);
+  const V go = V::loadu(grad_hy + j);
+  const V gig = go * (hx - newgate) * (one - inputgate) * inputgate;
+  const V gin = go * (one - inputgate) * (one - newgate * newgate);
+  const V grg = gin * hidden_new * (one - resetgate) * resetgate;
+  grg.store(grad_input_gates + j);
+  gig.store(grad_input_gates + hidden_size + j);
+  gin.store(grad_input_gates + 2 * hidden_size + j);
+  grg.store(grad_hidden_gates + j);
+  gig.store(grad_hidden_gates + hidden_size + j);
+  (gin * resetgate).store(grad_hidden_gates + 2 * hidden_size + j);
+  (go * inputgate).store(grad_hx + j);
+}
+
+void gru_cell_backward_kernel(
+    Tensor& grad_input_gates,
+    Tensor& grad_hidden_gates,
+    Tensor& grad_hx,
+    const Tensor& grad_hy,
+    const Tensor& workspace) {
+  const int64_t batch_size = grad_hy.size(0);
+  const int64_t hidden_size = grad_hy.size(1);
+  AT_DISPATCH_FLOATING_TYPES(grad_hy.scalar_type(), "gru_cell_backward_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* grad_hy_data = grad_hy.data_ptr<scalar_t>();
+    const scalar_t* workspace_data = workspace.data_ptr<scalar_t>();
+    scalar_t* grad_input_gates_data = grad_input_gates.data_ptr<scalar_t>();
+    scalar_t* grad_hidden_gates_data = grad_hidden_gates.data_ptr<scalar_t>();
+    scalar_t* grad_hx_data = grad_hx.data_ptr<scalar_t>();
+    at::parallel_for(
+        0, batch_size, rows_grain_size(3 * hidden_size), [&](int64_t begin, int64_t end) {
+          for (int64_t b = begin; b < end; b++) {
+            const scalar_t* gh = grad_hy_data + b * hidden_size;
+            const scalar_t* w = workspace_data + b * 5 * hidden_size;
+            scalar_t* g_ig = grad_input_gates_data + b * 3 * hidden_size;
+            scalar_t* g_hg = grad_hidden_gates_data + b * 3 * hidden_size;
+            scalar_t* g_h = grad_hx_data + b * hidden_size;
+            int64_t j = 0;
+            for (; j + Vec::size() <= hidden_size; j += Vec::size()) {
+              gru_backward_column<Vec>(gh, w, g_ig, g_hg, g_h, hidden_size, j);
+            }
+            for (; j < hidden_size; j++) {
+              gru_backward_column<SingleValue<scalar_t>>(gh, w, g_ig, g_hg, g_h, hidden_size, j);
+            }
+          }
+        });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_cell_cpu_stub, &lstm_cell_kernel);
+REGISTER_DISPATCH(lstm_cell_backward_cpu_stub, &lstm_cell_backward_kernel);
+REGISTER_DISPATCH(gru_cell_cpu_stub, &gru_cell_kernel);
+REGISTER_DISPATCH(gru_cell_backward_cpu_stub, &gru_cell_backward_kernel);
+
+} // namespace native
+} // namespace at
@@ -162,6 +162,10 @@ struct all_same : guts::conjunction<
 // combine: (acc_t, acc_t) -> acc_t combines two accumulated values into one.
 // project: acc_t -> out_t finishes the reduction, getting the required output.
 //
+// When the iterator has several outputs, out_t is a std::tuple and element i
+// is written to output i, so a single pass over the input can produce several
+// results (see WelfordOps for var_mean and MinMaxOps for _aminmax).
+//
 // Additionally, acc_t must be default-constructible:
 // acc_t {} is an identity for combine,
 // and project(acc_t {}) is the value of the operation on zero elements.
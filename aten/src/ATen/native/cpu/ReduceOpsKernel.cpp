@@ -308,6 +308,15 @@ static void max_values_kernel_impl(TensorIterator& iter) {
   });
 }
 
+static void aminmax_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES_AND2(kHalf, kBool, iter.dtype(), "aminmax_cpu", [&iter] {
+    binary_kernel_reduce(
+      iter,
+      MinMaxOps<scalar_t, scalar_t, std::tuple<scalar_t, scalar_t>>{},
+      std::pair<scalar_t, scalar_t>(upper_bound<scalar_t>(), lower_bound<scalar_t>()));
+  });
+}
+
 static void argmax_kernel_impl(TensorIterator &iter) {
   AT_DISPATCH_ALL_TYPES_AND(kHalf, iter.dtype(1), "argmax_cpu", [&] {
     binary_kernel_reduce(
@@ -337,6 +346,7 @@ REGISTER_DISPATCH(and_stub, &and_kernel_impl);
 REGISTER_DISPATCH(or_stub, &or_kernel_impl);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_impl);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
@@ -0,0 +1,75 @@
+// The CPU kernel of segment_reduce, see SegmentReduce.h. The (outer, segment)
+// pairs are split between the threads. A segment is reduced row after row
+// into a row of inner_size accumulators, so that the innermost loop walks
+// contiguous memory and can be vectorized by the compiler.
+
+#include <ATen/ATen.h>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/SegmentReduce.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at { namespace native {
+namespace {
+
+template <typename scalar_t>
+void segment_reduce_cpu_kernel(
+    Tensor& output,
+    const Tensor& data,
+    SegmentReductionType reduction,
+    const Tensor& offsets,
+    int64_t outer_size,
+    int64_t inner_size) {
+  using acc_t = at::acc_type<scalar_t, /*is_cuda=*/false>;
+  const int64_t size = data.numel() / (outer_size * inner_size);
+  const int64_t num_segments = offsets.numel() - 1;
+  const scalar_t* data_ptr = data.data_ptr<scalar_t>();
+  const int64_t* offsets_ptr = offsets.data_ptr<int64_t>();
+  scalar_t* output_ptr = output.data_ptr<scalar_t>();
+  // the average number of values of an output row
+  const int64_t segment_numel = std::max<int64_t>(1, size * inner_size / num_segments);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / segment_numel);
+
+  at::parallel_for(0, outer_size * num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<acc_t> acc(inner_size);
+    for (int64_t k = begin; k < end; k++) {
+      const int64_t o = k / num_segments;
+      const int64_t s = k % num_segments;
+      const int64_t start = offsets_ptr[s];
+      const int64_t stop = offsets_ptr[s + 1];
+      std::fill(acc.begin(), acc.end(), segment_reduce_identity<acc_t>(reduction));
+      for (int64_t j = start; j < stop; j++) {
+        const scalar_t* row = data_ptr + (o * size + j) * inner_size;
+        for (int64_t i = 0; i < inner_size; i++) {
+          acc[i] = segment_reduce_combine<acc_t>(reduction, acc[i], static_cast<acc_t>(row[i]));
+        }
+      }
+      scalar_t* out_row = output_ptr + k * inner_size;
+      for (int64_t i = 0; i < inner_size; i++) {
+        out_row[i] = static_cast<scalar_t>(segment_reduce_finalize<acc_t>(reduction, acc[i], stop - start));
+      }
+    }
+  });
+}
+
+void segment_reduce_kernel_impl(
+    Tensor& output,
+    const Tensor& data,
+    SegmentReductionType reduction,
+    const Tensor& offsets,
+    int64_t outer_size,
+    int64_t inner_size) {
+  AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, data.scalar_type(), "segment_reduce_cpu", [&] {
+    segment_reduce_cpu_kernel<scalar_t>(output, data, reduction, offsets, outer_size, inner_size);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_kernel_impl);
+
+}} // namespace at::native
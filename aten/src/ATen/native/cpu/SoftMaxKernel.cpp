@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <numeric>
 
 #include <ATen/Dispatch.h>
@@ -22,6 +24,71 @@
 namespace at { namespace native {
 namespace {
 
+// Online normalizer: a single sweep over a row computes both its max and
+// sum(exp(x - max)). Every vector lane keeps a running max m and the sum s of
+// exp(x - m), and s is rescaled by exp(m_old - m_new) when m grows. The max of
+// a block of kOnlineBlock vectors is found first, while the block sits in L1,
+// so the rescale costs one exp per block rather than one per element.
+//
+// Lanes that have only seen -inf (e.g. masked positions, or the padding of a
+// partial vector) shift by 0 instead of by their max, which keeps them at 0
+// instead of producing NaN from -inf - -inf.
+template <typename scalar_t>
+inline void _vec_online_max_sum(
+    const scalar_t* input_data,
+    int64_t dim_size,
+    scalar_t& max_out,
+    scalar_t& sum_out) {
+  using Vec = vec256::Vec256<scalar_t>;
+  static constexpr int64_t kOnlineBlock = 8;
+  const Vec neg_inf(-std::numeric_limits<scalar_t>::infinity());
+  auto shift_of = [&neg_inf](const Vec& m) {
+    return Vec::blendv(m, Vec(0), m == neg_inf);
+  };
+
+  Vec max_vec = neg_inf;
+  Vec sum_vec(0);
+  int64_t d = 0;
+  for (; d + kOnlineBlock * Vec::size() <= dim_size; d += kOnlineBlock * Vec::size()) {
+    Vec block_max = Vec::loadu(input_data + d);
+    for (int64_t k = 1; k < kOnlineBlock; k++) {
+      block_max = vec256::maximum(block_max, Vec::loadu(input_data + d + k * Vec::size()));
+    }
+    Vec new_max = vec256::maximum(max_vec, block_max);
+    Vec shift = shift_of(new_max);
+    Vec acc = sum_vec * (max_vec - shift).exp();
+    for (int64_t k = 0; k < kOnlineBlock; k++) {
+      acc = acc + (Vec::loadu(input_data + d + k * Vec::size()) - shift).exp();
+    }
+    max_vec = new_max;
+    sum_vec = acc;
+  }
+  for (; d < dim_size; d += Vec::size()) {
+    int64_t count = std::min<int64_t>(dim_size - d, Vec::size());
+    Vec x = Vec::set(neg_inf, Vec::loadu(input_data + d, count), count);
+    Vec new_max = vec256::maximum(max_vec, x);
+    Vec shift = shift_of(new_max);
+    sum_vec = sum_vec * (max_vec - shift).exp() + (x - shift).exp();
+    max_vec = new_max;
+  }
+
+  // combine the lanes
+  scalar_t lanes[Vec::size()];
+  max_vec.store(lanes);
+  scalar_t max_input = lanes[0];
+  for (int64_t k = 1; k < Vec::size(); k++) {
+    max_input = std::max(max_input, lanes[k]);
+  }
+  sum_vec = sum_vec * (max_vec - shift_of(Vec(max_input))).exp();
+  sum_vec.store(lanes);
+  scalar_t sum = lanes[0];
+  for (int64_t k = 1; k < Vec::size(); k++) {
+    sum += lanes[k];
+  }
+  max_out = max_input;
+  sum_out = sum;
+}
+
 template <typename scalar_t>
 inline void _vec_log_softmax_lastdim(
     scalar_t* input_data_base,
@@ -47,21 +114,11 @@ inline void _vec_log_softmax_lastdim(
             loop_end = end - ii;
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
-            scalar_t* input_data = input_data_base + i * dim_size;
-            max_input_arr[j] = vec256::reduce_all<scalar_t>(
-                [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
-                input_data,
-                dim_size);
-          }
-          for (int64_t j = 0; j < loop_end; j++) {
-            int64_t i = ii + j;
-            scalar_t* input_data = input_data_base + i * dim_size;
-            scalar_t max_input = max_input_arr[j];
-            tmp_sum_scalar[j] = vec256::map_reduce_all<scalar_t>(
-                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
-                [](Vec x, Vec y) { return x + y; },
-                input_data,
-                dim_size);
+            _vec_online_max_sum(
+                input_data_base + i * dim_size,
+                dim_size,
+                max_input_arr[j],
+                tmp_sum_scalar[j]);
           }
           // See [Note AVX-SSE transitions] for why this should call the
           // vectorized version (aside from perf improvements).
@@ -76,7 +133,7 @@ inline void _vec_log_softmax_lastdim(
             scalar_t* output_data = output_data_base + i * dim_size;
             scalar_t tmp_sum = tmp_sum_scalar[j];
             scalar_t max_input = max_input_arr[j];
-            
+
             // It's necessary to keep the order of the operations below.
             // In some cases that input is large digits and the difference
             // is small, if we compute `max_input` plus `tmp_sum` before,
@@ -92,6 +149,8 @@ inline void _vec_log_softmax_lastdim(
       });
 }
 
+// The row is read once by the online normalizer and once more to write the
+// output; for rows that fit in cache the second read is served from it.
 template <typename scalar_t>
 inline void _vec_softmax_lastdim(
     scalar_t* input_data_base,
@@ -111,27 +170,145 @@ inline void _vec_softmax_lastdim(
         for (int64_t i = begin; i < end; i++) {
           scalar_t* input_data = input_data_base + i * dim_size;
           scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t max_input = vec256::reduce_all<scalar_t>(
-              [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
-              input_data,
-              dim_size);
+          scalar_t max_input;
+          scalar_t tmp_sum;
+          _vec_online_max_sum(input_data, dim_size, max_input, tmp_sum);
+          tmp_sum = 1 / tmp_sum;
           vec256::map(
-              [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+              [max_input, tmp_sum](Vec x) { return (x - Vec(max_input)).exp() * Vec(tmp_sum); },
               output_data,
               input_data,
               dim_size);
-          scalar_t tmp_sum = vec256::reduce_all<scalar_t>(
-              [](Vec x, Vec y) { return x + y; }, output_data, dim_size);
+        }
+      });
+}
+
+// BFloat16 rows are widened into a float buffer so the max, the sum of
+// exponentials and the normalization all run in fp32; only the final output
+// is rounded back to BFloat16.
+template <>
+inline void _vec_log_softmax_lastdim<BFloat16>(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<float>;
+  static constexpr int64_t CHUNK_SIZE = (128 / sizeof(float)) * Vec::size();
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
+  if (grain_size < CHUNK_SIZE)
+    grain_size = CHUNK_SIZE;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<float[]> buffer(new float[dim_size]);
+        float* buffer_data = buffer.get();
+        for (int64_t ii = begin; ii < end; ii += CHUNK_SIZE) {
+          float tmp_sum_scalar[CHUNK_SIZE];
+          float max_input_arr[CHUNK_SIZE];
+          int64_t loop_end = CHUNK_SIZE;
+          if (ii + CHUNK_SIZE > end)
+            loop_end = end - ii;
+          for (int64_t j = 0; j < loop_end; j++) {
+            int64_t i = ii + j;
+            vec256::convert(input_data_base + i * dim_size, buffer_data, dim_size);
+            _vec_online_max_sum(buffer_data, dim_size, max_input_arr[j], tmp_sum_scalar[j]);
+          }
+          // See [Note AVX-SSE transitions] for why this should call the
+          // vectorized version (aside from perf improvements).
+          vec256::map(
+              [](Vec x) { return x.log(); },
+              tmp_sum_scalar,
+              tmp_sum_scalar,
+              loop_end);
+          for (int64_t j = 0; j < loop_end; j++) {
+            int64_t i = ii + j;
+            float tmp_sum = tmp_sum_scalar[j];
+            float max_input = max_input_arr[j];
+            vec256::convert(input_data_base + i * dim_size, buffer_data, dim_size);
+            // Same order of operations as the generic kernel above.
+            vec256::map(
+                [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
+                buffer_data,
+                buffer_data,
+                dim_size);
+            vec256::convert(buffer_data, output_data_base + i * dim_size, dim_size);
+          }
+        }
+      });
+}
+
+template <>
+inline void _vec_softmax_lastdim<BFloat16>(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<float[]> buffer(new float[dim_size]);
+        float* buffer_data = buffer.get();
+        for (int64_t i = begin; i < end; i++) {
+          vec256::convert(input_data_base + i * dim_size, buffer_data, dim_size);
+          float max_input;
+          float tmp_sum;
+          _vec_online_max_sum(buffer_data, dim_size, max_input, tmp_sum);
           tmp_sum = 1 / tmp_sum;
           vec256::map(
-              [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
-              output_data,
-              output_data,
+              [max_input, tmp_sum](Vec x) { return (x - Vec(max_input)).exp() * Vec(tmp_sum); },
+              buffer_data,
+              buffer_data,
               dim_size);
+          vec256::convert(buffer_data, output_data_base + i * dim_size, dim_size);
         }
       });
 }
 
+// log(sum(exp(x))) of every row, without writing anything of the row's size.
+template <typename scalar_t>
+inline void _vec_logsumexp_lastdim(
+    const scalar_t* input_data_base,
+    scalar_t* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<scalar_t[]> max_input(new scalar_t[end - begin]);
+        for (int64_t i = begin; i < end; i++) {
+          _vec_online_max_sum(
+              input_data_base + i * dim_size,
+              dim_size,
+              max_input[i - begin],
+              output_data_base[i]);
+        }
+        // See [Note AVX-SSE transitions]
+        vec256::map2(
+            [](Vec sum, Vec max) { return sum.log() + max; },
+            output_data_base + begin,
+            output_data_base + begin,
+            max_input.get(),
+            end - begin);
+      });
+}
+
 template <typename scalar_t, bool log_softmax>
 inline void _vec_host_softmax_backward_lastdim(
     scalar_t* grad_input_data_base,
@@ -224,9 +401,10 @@ struct vec_host_softmax_backward_lastdim {
 };
 
 static void softmax_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "softmax_lastdim_kernel_impl", [&] {
-    vec_host_softmax_lastdim<scalar_t, false>::apply(result, self);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_lastdim_kernel_impl",
+      [&] { vec_host_softmax_lastdim<scalar_t, false>::apply(result, self); });
 }
 
 static void log_softmax_lastdim_kernel_impl(
@@ -242,8 +420,9 @@ static void softmax_backward_lastdim_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad,
     const Tensor& output) {
-  AT_DISPATCH_FLOATING_TYPES(
-      grad.scalar_type(), "softmax_backward_lastdim_kernel_impl", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "softmax_backward_lastdim_kernel_impl", [&] {
         vec_host_softmax_backward_lastdim<scalar_t, false>::apply(
             grad_input, grad, output);
       });
@@ -261,6 +440,17 @@ static void log_softmax_backward_lastdim_kernel_impl(
       });
 }
 
+// result[i] = logsumexp(self[i, :]) for a contiguous 2-D self
+static void logsumexp_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logsumexp_lastdim_kernel_impl", [&] {
+    _vec_logsumexp_lastdim(
+        self.data_ptr<scalar_t>(),
+        result.data_ptr<scalar_t>(),
+        self.size(0),
+        self.size(1));
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(softmax_lastdim_kernel, &softmax_lastdim_kernel_impl);
@@ -271,5 +461,6 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(
     log_softmax_backward_lastdim_kernel,
     &log_softmax_backward_lastdim_kernel_impl);
+REGISTER_DISPATCH(logsumexp_lastdim_kernel, &logsumexp_lastdim_kernel_impl);
 
 }} // namespace at::native
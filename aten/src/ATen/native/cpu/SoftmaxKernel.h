@@ -13,6 +13,8 @@ DECLARE_DISPATCH(forward_fn, softmax_lastdim_kernel);
 DECLARE_DISPATCH(forward_fn, log_softmax_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, softmax_backward_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, log_softmax_backward_lastdim_kernel);
+// logsumexp over the last dim of a contiguous 2-D tensor, in a single pass
+DECLARE_DISPATCH(forward_fn, logsumexp_lastdim_kernel);
 
 }
 }
@@ -5,6 +5,11 @@
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
 namespace at { namespace native {
 
 namespace {
@@ -83,8 +88,227 @@ static void topk_kernel(
   });
 }
 
+// Parallel sort of a single slice
+// -------------------------------
+// sort() on a 1-d tensor, or on a tensor with a single slice along dim, has
+// nothing to parallelize across slices, so we parallelize within the slice.
+// Integral and floating point keys use a stable LSD radix sort; Half uses a
+// parallel merge sort. Both put NaN last in ascending order and first in
+// descending order, like the TH quicksort.
+
+// Maps a value to an unsigned key whose unsigned ordering matches the value
+// ordering, with NaN above everything.
+template <typename scalar_t, typename Enable = void>
+struct RadixKey;
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_integral<scalar_t>::value>::type> {
+  using key_t = typename std::make_unsigned<scalar_t>::type;
+  static key_t encode(scalar_t x) {
+    constexpr key_t sign_bit = std::is_signed<scalar_t>::value ?
+        key_t(key_t(1) << (sizeof(key_t) * 8 - 1)) : key_t(0);
+    return static_cast<key_t>(x) ^ sign_bit;
+  }
+};
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_floating_point<scalar_t>::value>::type> {
+  using key_t = typename std::conditional<sizeof(scalar_t) == 4, uint32_t, uint64_t>::type;
+  static key_t encode(scalar_t x) {
+    constexpr key_t sign_bit = key_t(1) << (sizeof(key_t) * 8 - 1);
+    if (_isnan(x)) {
+      return ~key_t(0);
+    }
+    key_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    // Negative values are flipped entirely so larger magnitudes sort first;
+    // positive values only get the sign bit set so they sort above them.
+    return (bits & sign_bit) ? key_t(~bits) : key_t(bits | sign_bit);
+  }
+};
+
+// Stable LSD radix sort of (key, index) pairs on 8-bit digits. Every pass
+// builds per-chunk digit histograms in parallel, turns them into per-chunk
+// scatter offsets, then scatters the chunks in parallel. Chunks are fixed up
+// front, so the result does not depend on how threads are scheduled. Passes in
+// which all keys share the same digit are skipped, which makes keys with a
+// small range (e.g. ids stored as int64) cheap.
+template <typename key_t>
+static void radix_sort_pairs(
+    key_t*& keys, int64_t*& vals, key_t*& keys_tmp, int64_t*& vals_tmp, int64_t n) {
+  constexpr int RADIX_BITS = 8;
+  constexpr int64_t RADIX = 1 << RADIX_BITS;
+  const int64_t nchunks = std::max<int64_t>(
+      std::min<int64_t>(at::get_num_threads(), divup(n, internal::GRAIN_SIZE)), 1);
+  const int64_t chunk_size = divup(n, nchunks);
+  std::vector<int64_t> hist(nchunks * RADIX);
+
+  for (int64_t pass = 0; pass < static_cast<int64_t>(sizeof(key_t)); ++pass) {
+    const int shift = pass * RADIX_BITS;
+    std::fill(hist.begin(), hist.end(), 0);
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        int64_t* h = hist.data() + c * RADIX;
+        const int64_t hi = std::min(n, (c + 1) * chunk_size);
+        for (int64_t i = c * chunk_size; i < hi; ++i) {
+          h[(keys[i] >> shift) & (RADIX - 1)]++;
+        }
+      }
+    });
+
+    bool trivial = false;
+    for (int64_t d = 0; d < RADIX && !trivial; ++d) {
+      int64_t total = 0;
+      for (int64_t c = 0; c < nchunks; ++c) {
+        total += hist[c * RADIX + d];
+      }
+      trivial = total == n;
+    }
+    if (trivial) {
+      continue;
+    }
+
+    int64_t offset = 0;
+    for (int64_t d = 0; d < RADIX; ++d) {
+      for (int64_t c = 0; c < nchunks; ++c) {
+        const int64_t count = hist[c * RADIX + d];
+        hist[c * RADIX + d] = offset;
+        offset += count;
+      }
+    }
+
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        int64_t* h = hist.data() + c * RADIX;
+        const int64_t hi = std::min(n, (c + 1) * chunk_size);
+        for (int64_t i = c * chunk_size; i < hi; ++i) {
+          const int64_t pos = h[(keys[i] >> shift) & (RADIX - 1)]++;
+          keys_tmp[pos] = keys[i];
+          vals_tmp[pos] = vals[i];
+        }
+      }
+    });
+    std::swap(keys, keys_tmp);
+    std::swap(vals, vals_tmp);
+  }
+}
+
+template <typename scalar_t>
+static void radix_sort_kernel(
+    const scalar_t* self_data, scalar_t* values_data, int64_t* indices_data,
+    int64_t n, bool descending) {
+  using key_t = typename RadixKey<scalar_t>::key_t;
+  std::vector<key_t> keys_buf(n), keys_tmp_buf(n);
+  std::vector<int64_t> vals_buf(n), vals_tmp_buf(n);
+  key_t* keys = keys_buf.data();
+  key_t* keys_tmp = keys_tmp_buf.data();
+  int64_t* vals = vals_buf.data();
+  int64_t* vals_tmp = vals_tmp_buf.data();
+
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const key_t key = RadixKey<scalar_t>::encode(self_data[i]);
+      // Inverting the key reverses the order while keeping equal keys stable
+      keys[i] = descending ? key_t(~key) : key;
+      vals[i] = i;
+    }
+  });
+
+  radix_sort_pairs(keys, vals, keys_tmp, vals_tmp, n);
+
+  // Gather the values from the input so they are bit-exact (e.g. NaN payloads)
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      indices_data[i] = vals[i];
+      values_data[i] = self_data[vals[i]];
+    }
+  });
+}
+
+// Each thread sorts a fixed chunk with std::sort, then adjacent runs are
+// merged pairwise in parallel until a single run is left. Ties are broken by
+// index so the result is stable and independent of the thread count.
+template <typename scalar_t>
+static void merge_sort_kernel(
+    const scalar_t* self_data, scalar_t* values_data, int64_t* indices_data,
+    int64_t n, bool descending) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  auto less = [descending](const elem_t& x, const elem_t& y) -> bool {
+    const bool x_nan = _isnan<scalar_t>(x.first);
+    const bool y_nan = _isnan<scalar_t>(y.first);
+    if (x_nan || y_nan) {
+      if (x_nan && y_nan) {
+        return x.second < y.second;
+      }
+      // NaN is the largest value
+      return descending ? x_nan : y_nan;
+    }
+    if (x.first != y.first) {
+      return descending ? x.first > y.first : x.first < y.first;
+    }
+    return x.second < y.second;
+  };
+
+  std::vector<elem_t> buf(n), tmp(n);
+  const int64_t nchunks = std::max<int64_t>(
+      std::min<int64_t>(at::get_num_threads(), divup(n, internal::GRAIN_SIZE)), 1);
+  const int64_t chunk_size = divup(n, nchunks);
+  at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t lo = c * chunk_size;
+      const int64_t hi = std::min(n, lo + chunk_size);
+      for (int64_t i = lo; i < hi; ++i) {
+        buf[i] = elem_t(self_data[i], i);
+      }
+      std::sort(buf.begin() + lo, buf.begin() + hi, less);
+    }
+  });
+
+  for (int64_t width = chunk_size; width < n; width *= 2) {
+    const int64_t npairs = divup(n, 2 * width);
+    at::parallel_for(0, npairs, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        const int64_t lo = p * 2 * width;
+        const int64_t mid = std::min(n, lo + width);
+        const int64_t hi = std::min(n, lo + 2 * width);
+        std::merge(buf.begin() + lo, buf.begin() + mid,
+                   buf.begin() + mid, buf.begin() + hi,
+                   tmp.begin() + lo, less);
+      }
+    });
+    std::swap(buf, tmp);
+  }
+
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      values_data[i] = buf[i].first;
+      indices_data[i] = buf[i].second;
+    }
+  });
+}
+
+// values, indices and self are contiguous and hold a single slice
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    bool descending) {
+  const int64_t n = self.numel();
+  int64_t* indices_data = indices.data_ptr<int64_t>();
+  if (self.scalar_type() == kHalf) {
+    merge_sort_kernel<at::Half>(
+        self.data_ptr<at::Half>(), values.data_ptr<at::Half>(), indices_data, n, descending);
+    return;
+  }
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "sort_cpu", [&] {
+    radix_sort_kernel<scalar_t>(
+        self.data_ptr<scalar_t>(), values.data_ptr<scalar_t>(), indices_data, n, descending);
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 
 }} //at::native
@@ -4,36 +4,12 @@
 #include <ATen/native/UpSample.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/cpu/utils.h>
 
 namespace at {
 namespace native {
 namespace {
 
-template <typename T>
-inline T data_index_init(T offset) {
-  return offset;
-}
-
-template <typename T, typename... Args>
-inline T data_index_init(T offset, T &x, const T &X, Args &&... args) {
-  offset = data_index_init(offset, std::forward<Args>(args)...);
-  x = offset % X;
-  return offset / X;
-}
-
-inline bool data_index_step() {
-  return true;
-}
-
-template <typename T, typename... Args>
-inline bool data_index_step(T &x, const T &X, Args &&... args) {
-  if (data_index_step(std::forward<Args>(args)...)) {
-    x = ((x + 1) == X) ? 0 : (x + 1);
-    return x == 0;
-  }
-  return false;
-}
-
 static inline int64_t nearest_idx(
     int64_t output_index,
     int64_t input_size,
@@ -322,6 +298,79 @@ void cpu_upsample_nearest_backward(
   }
 }
 
+template <typename scalar_t, typename scale_type>
+void cpu_upsample_nearest_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    const scale_type& scales) {
+  TORCH_CHECK(grad_input_.dtype() == grad_output_.dtype(), "expected dtype ", grad_output_.dtype(),
+              " for `grad_input` but got dtype ", grad_input_.dtype());
+
+  auto ndim = grad_output_.ndimension();
+  TORCH_CHECK(ndim >=4 && ndim <= 5, "Upsample with NHWC format supports tensors with 4 or 5 dims.")
+
+  auto channels_last_memory_format = ndim == 4 ? at::MemoryFormat::ChannelsLast : at::MemoryFormat::ChannelsLast3d;
+  auto grad_output = grad_output_.contiguous(channels_last_memory_format);
+  auto grad_input = grad_input_.contiguous(channels_last_memory_format);
+
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto input_sizes = grad_input.sizes().vec();
+  auto output_sizes = grad_output.sizes().vec();
+
+  int64_t num_batches =  input_sizes[0];
+  int64_t channels =  input_sizes[1];
+  int64_t input_depth = (ndim == 5) ? input_sizes[2] : 1;
+  int64_t output_depth = (ndim == 5) ? output_sizes[2] : 1;
+  int64_t input_height = input_sizes[ndim - 2];
+  int64_t output_height = output_sizes[ndim - 2];
+  int64_t input_width = input_sizes[ndim - 1];
+  int64_t output_width = output_sizes[ndim - 1];
+  int64_t input_slice_size = input_depth * input_height * input_width * channels;
+  int64_t output_slice_size = output_depth * output_height * output_width * channels;
+
+  TORCH_CHECK(channels > 0, "expected input and output channels greater than 0 but got ", channels);
+
+  using Vec = vec256::Vec256<scalar_t>;
+  auto acc = [](scalar_t* gin, const scalar_t* gout, int64_t size) {
+    int64_t d = 0;
+    for (; d < size - (size % Vec::size()); d += Vec::size()) {
+      Vec gin_vec = Vec::loadu(gin + d) + Vec::loadu(gout + d);
+      gin_vec.store(gin + d);
+    }
+    for (; d < size; d++) {
+      gin[d] += gout[d];
+    }
+  };
+
+  // Every output pixel of batch n scatters into the same image of
+  // grad_input, so the work is split over batches to keep it race free.
+  auto loop = [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; n++) {
+      for (int64_t od = 0; od < output_depth; od++) {
+        int64_t id = (ndim == 5) ? nearest_idx(od, input_depth, output_depth, scales[0]) : 0;
+        for (int64_t oh = 0; oh < output_height; oh++) {
+          int64_t ih = nearest_idx(oh, input_height, output_height, scales[ndim - 4]);
+          for (int64_t ow = 0; ow < output_width; ow++) {
+            int64_t iw = nearest_idx(ow, input_width, output_width, scales[ndim - 3]);
+            const scalar_t* grad_output_ptr = grad_output_data + n * output_slice_size +
+                ((od * output_height + oh) * output_width + ow) * channels;
+            scalar_t* grad_input_ptr = grad_input_data + n * input_slice_size +
+                ((id * input_height + ih) * input_width + iw) * channels;
+            acc(grad_input_ptr, grad_output_ptr, channels);
+          }
+        }
+      }
+    }
+  };
+
+  at::parallel_for(0, num_batches, at::internal::GRAIN_SIZE / output_slice_size, loop);
+
+  if (!grad_input_.is_contiguous(channels_last_memory_format)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
 using scale_t = std::vector<c10::optional<double>>;
 void upsample_nearest1d_kernel_impl(
     Tensor& output,
@@ -379,9 +428,15 @@ void upsample_nearest2d_backward_kernel_impl(
     const Tensor& grad_output,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
-  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_nearest2d_backward", [&] {
-    cpu_upsample_nearest_backward<scalar_t, scale_t>(grad_input, grad_output, {scales_h, scales_w});
-  });
+  if (grad_output.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_nearest2d_backward_channels_last", [&] {
+      cpu_upsample_nearest_backward_channels_last<scalar_t, scale_t>(grad_input, grad_output, {scales_h, scales_w});
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_nearest2d_backward", [&] {
+      cpu_upsample_nearest_backward<scalar_t, scale_t>(grad_input, grad_output, {scales_h, scales_w});
+    });
+  }
 }
 
 void upsample_nearest3d_backward_kernel_impl(
@@ -390,9 +445,15 @@ void upsample_nearest3d_backward_kernel_impl(
     c10::optional<double> scales_d,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
-  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_nearest3d_backward", [&] {
-    cpu_upsample_nearest_backward<scalar_t, scale_t>(grad_input, grad_output, {scales_d, scales_h, scales_w});
-  });
+  if (grad_output.is_contiguous(at::MemoryFormat::ChannelsLast3d)) {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_nearest3d_backward_channels_last", [&] {
+      cpu_upsample_nearest_backward_channels_last<scalar_t, scale_t>(grad_input, grad_output, {scales_d, scales_h, scales_w});
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_nearest3d_backward", [&] {
+      cpu_upsample_nearest_backward<scalar_t, scale_t>(grad_input, grad_output, {scales_d, scales_h, scales_w});
+    });
+  }
 }
 
 } // anonymous namespace
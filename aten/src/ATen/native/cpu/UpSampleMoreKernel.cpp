@@ -4,6 +4,8 @@
 #include <ATen/native/UpSample.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/native/cpu/utils.h>
 
 namespace at {
 namespace native {
@@ -484,12 +486,358 @@ void cpu_upsample_linear_backward(
   }
 }
 
+template <typename scalar_t, typename scale_type>
+void cpu_upsample_linear_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    bool align_corners,
+    const scale_type& scales) {
+  TORCH_CHECK(grad_input_.dtype() == grad_output_.dtype(), "expected dtype ", grad_output_.dtype(),
+              " for `grad_input` but got dtype ", grad_input_.dtype());
+
+  auto ndim = grad_output_.ndimension();
+  TORCH_CHECK(ndim >=4 && ndim <= 5, "Upsample with NHWC format supports tensors with 4 or 5 dims.")
+
+  auto channels_last_memory_format = ndim == 4 ? at::MemoryFormat::ChannelsLast : at::MemoryFormat::ChannelsLast3d;
+  auto grad_output = grad_output_.contiguous(channels_last_memory_format);
+  auto grad_input = grad_input_.contiguous(channels_last_memory_format);
+
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto input_sizes = grad_input.sizes().vec();
+  auto output_sizes = grad_output.sizes().vec();
+
+  int64_t num_batches =  input_sizes[0];
+  int64_t channels =  input_sizes[1];
+  int64_t input_depth = (ndim == 5) ? input_sizes[2] : 1;
+  int64_t output_depth = (ndim == 5) ? output_sizes[2] : 1;
+  int64_t input_height = input_sizes[ndim - 2];
+  int64_t output_height = output_sizes[ndim - 2];
+  int64_t input_width = input_sizes[ndim - 1];
+  int64_t output_width = output_sizes[ndim - 1];
+
+  TORCH_CHECK(channels > 0, "expected input and output channels greater than 0 but got ", channels);
+  int64_t input_slice_size = input_depth * input_height * input_width * channels;
+  int64_t output_slice_size = output_depth * output_height * output_width * channels;
+
+  using Vec = vec256::Vec256<scalar_t>;
+  // gin[d] += lambda * gout[d] over the channels
+  auto acc = [](scalar_t* gin, const scalar_t* gout, scalar_t lambda, int64_t size) {
+    int64_t d = 0;
+    for (; d < size - (size % Vec::size()); d += Vec::size()) {
+      Vec gin_vec = Vec::loadu(gin + d) + Vec(lambda) * Vec::loadu(gout + d);
+      gin_vec.store(gin + d);
+    }
+    for (; d < size; d++) {
+      gin[d] += lambda * gout[d];
+    }
+  };
+
+  // Output pixels of one batch scatter into overlapping input pixels, so the
+  // work is split over batches.
+  auto loop2d = [&](int64_t begin, int64_t end) {
+    const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+        input_height, output_height, align_corners, scales[0]);
+    const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+        input_width, output_width, align_corners, scales[1]);
+
+    auto input_indexr = [=](int64_t n, int64_t h, int64_t w) {
+      return grad_input_data + n * input_slice_size +
+          h * input_width * channels + w * channels;
+    };
+
+    int64_t ih0, ih1, iw0, iw1;
+    scalar_t h0lambda, h1lambda, w0lambda, w1lambda;
+    for (int64_t n = begin; n < end; n++) {
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        compute_source_index_and_lambda(
+            ih0, ih1, h0lambda, h1lambda, height_scale, oh, input_height, output_height, align_corners);
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          compute_source_index_and_lambda(
+              iw0, iw1, w0lambda, w1lambda, width_scale, ow, input_width, output_width, align_corners);
+          const scalar_t* gout = grad_output_data + n * output_slice_size +
+              oh * output_width * channels + ow * channels;
+          acc(input_indexr(n, ih0, iw0), gout, h0lambda * w0lambda, channels); /* i00 */
+          acc(input_indexr(n, ih0, iw1), gout, h0lambda * w1lambda, channels); /* i01 */
+          acc(input_indexr(n, ih1, iw0), gout, h1lambda * w0lambda, channels); /* i10 */
+          acc(input_indexr(n, ih1, iw1), gout, h1lambda * w1lambda, channels); /* i11 */
+        }
+      }
+    }
+  };
+
+  auto loop3d = [&](int64_t begin, int64_t end) {
+    const scalar_t depth_scale = area_pixel_compute_scale<scalar_t>(
+        input_depth, output_depth, align_corners, scales[0]);
+    const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+        input_height, output_height, align_corners, scales[1]);
+    const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+        input_width, output_width, align_corners, scales[2]);
+
+    auto input_indexr = [=](int64_t n, int64_t d, int64_t h, int64_t w) {
+      return grad_input_data + n * input_slice_size +
+          d * input_height * input_width * channels +
+          h * input_width * channels + w * channels;
+    };
+
+    int64_t id0, id1, ih0, ih1, iw0, iw1;
+    scalar_t d0lambda, d1lambda, h0lambda, h1lambda, w0lambda, w1lambda;
+    for (int64_t n = begin; n < end; n++) {
+      for (int64_t od = 0; od < output_depth; od++) {
+        compute_source_index_and_lambda(
+            id0, id1, d0lambda, d1lambda, depth_scale, od, input_depth, output_depth, align_corners);
+        for (int64_t oh = 0; oh < output_height; oh++) {
+          compute_source_index_and_lambda(
+              ih0, ih1, h0lambda, h1lambda, height_scale, oh, input_height, output_height, align_corners);
+          for (int64_t ow = 0; ow < output_width; ow++) {
+            compute_source_index_and_lambda(
+                iw0, iw1, w0lambda, w1lambda, width_scale, ow, input_width, output_width, align_corners);
+            const scalar_t* gout = grad_output_data + n * output_slice_size +
+                od * output_height * output_width * channels +
+                oh * output_width * channels + ow * channels;
+            acc(input_indexr(n, id0, ih0, iw0), gout, d0lambda * h0lambda * w0lambda, channels); /* i000 */
+            acc(input_indexr(n, id0, ih0, iw1), gout, d0lambda * h0lambda * w1lambda, channels); /* i001 */
+            acc(input_indexr(n, id0, ih1, iw0), gout, d0lambda * h1lambda * w0lambda, channels); /* i010 */
+            acc(input_indexr(n, id0, ih1, iw1), gout, d0lambda * h1lambda * w1lambda, channels); /* i011 */
+            acc(input_indexr(n, id1, ih0, iw0), gout, d1lambda * h0lambda * w0lambda, channels); /* i100 */
+            acc(input_indexr(n, id1, ih0, iw1), gout, d1lambda * h0lambda * w1lambda, channels); /* i101 */
+            acc(input_indexr(n, id1, ih1, iw0), gout, d1lambda * h1lambda * w0lambda, channels); /* i110 */
+            acc(input_indexr(n, id1, ih1, iw1), gout, d1lambda * h1lambda * w1lambda, channels); /* i111 */
+          }
+        }
+      }
+    }
+  };
+
+  if (ndim == 4) {
+    // upsample bilinear 2d
+    at::parallel_for(0, num_batches, at::internal::GRAIN_SIZE / output_slice_size / 4, loop2d);
+  } else {
+    // upsample trilinear 3d
+    TORCH_INTERNAL_ASSERT(ndim == 5);
+    at::parallel_for(0, num_batches, at::internal::GRAIN_SIZE / output_slice_size / 8, loop3d);
+  }
+
+  if (!grad_input_.is_contiguous(channels_last_memory_format)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+// Bicubic interpolation is separable: every output pixel is a 4x4 tap
+// window whose weights are the product of a row weight and a column weight.
+// The taps (clamped to the border like upsample_get_value_bounded) and the
+// weights only depend on the output index, so they are computed once per
+// output row and column.
+template <typename scalar_t>
+static void compute_cubic_taps(
+    int64_t* indices,
+    scalar_t* weights,
+    scalar_t scale,
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners) {
+  for (int64_t o = 0; o < output_size; o++) {
+    const scalar_t real_index = area_pixel_compute_source_index<scalar_t>(
+        scale, o, align_corners, /*cubic=*/true);
+    const int64_t input_index = static_cast<int64_t>(std::floor(real_index));
+    get_cubic_upsample_coefficients<scalar_t>(weights + o * 4, real_index - input_index);
+    for (int64_t k = 0; k < 4; k++) {
+      indices[o * 4 + k] = std::max(std::min(input_index - 1 + k, input_size - 1), static_cast<int64_t>(0));
+    }
+  }
+}
+
+template <typename scalar_t, typename scale_type>
+void cpu_upsample_bicubic2d(
+    Tensor& output_,
+    const Tensor& input_,
+    bool align_corners,
+    const scale_type& scales) {
+  TORCH_CHECK(input_.dtype() == output_.dtype(), "expected dtype ", input_.dtype(),
+              " for `output` but got dtype ", output_.dtype());
+  using Vec = vec256::Vec256<scalar_t>;
+
+  int64_t channels = input_.size(0) * input_.size(1);
+  int64_t input_height = input_.size(2);
+  int64_t input_width = input_.size(3);
+  int64_t output_height = output_.size(2);
+  int64_t output_width = output_.size(3);
+
+  // Special case: input/output same size, just copy
+  if (input_height == output_height && input_width == output_width) {
+    output_.copy_(input_);
+    return;
+  }
+
+  auto input = input_.contiguous();
+  auto output = output_.contiguous();
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+
+  const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+      input_height, output_height, align_corners, scales[0]);
+  const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+      input_width, output_width, align_corners, scales[1]);
+  std::vector<int64_t> iy(output_height * 4);
+  std::vector<scalar_t> wy(output_height * 4);
+  std::vector<int64_t> ix(output_width * 4);
+  std::vector<scalar_t> wx(output_width * 4);
+  compute_cubic_taps<scalar_t>(iy.data(), wy.data(), height_scale, input_height, output_height, align_corners);
+  compute_cubic_taps<scalar_t>(ix.data(), wx.data(), width_scale, input_width, output_width, align_corners);
+
+  // parallel on dim of N * C and output rows; each output row first blends
+  // its four input rows into one buffer (contiguous, vectorized), then
+  // filters that buffer horizontally.
+  int64_t grain_size = at::internal::GRAIN_SIZE / std::max(output_width * 4 + input_width * 4, static_cast<int64_t>(1));
+  at::parallel_for(0, channels * output_height, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> row(input_width);
+    int64_t c = 0;
+    int64_t oh = 0;
+    data_index_init(begin, c, channels, oh, output_height);
+
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* in = input_data + c * input_height * input_width;
+      const int64_t* y = iy.data() + oh * 4;
+      const scalar_t* w = wy.data() + oh * 4;
+      const scalar_t* in0 = in + y[0] * input_width;
+      const scalar_t* in1 = in + y[1] * input_width;
+      const scalar_t* in2 = in + y[2] * input_width;
+      const scalar_t* in3 = in + y[3] * input_width;
+
+      int64_t d = 0;
+      for (; d < input_width - (input_width % Vec::size()); d += Vec::size()) {
+        Vec row_vec = Vec::loadu(in0 + d) * Vec(w[0]) + Vec::loadu(in1 + d) * Vec(w[1]) +
+            Vec::loadu(in2 + d) * Vec(w[2]) + Vec::loadu(in3 + d) * Vec(w[3]);
+        row_vec.store(row.data() + d);
+      }
+      for (; d < input_width; d++) {
+        row[d] = in0[d] * w[0] + in1[d] * w[1] + in2[d] * w[2] + in3[d] * w[3];
+      }
+
+      scalar_t* out = output_data + i * output_width;
+      for (int64_t ow = 0; ow < output_width; ow++) {
+        const int64_t* x = ix.data() + ow * 4;
+        const scalar_t* v = wx.data() + ow * 4;
+        out[ow] = row[x[0]] * v[0] + row[x[1]] * v[1] + row[x[2]] * v[2] + row[x[3]] * v[3];
+      }
+
+      // move on to next output index
+      data_index_step(c, channels, oh, output_height);
+    }
+  });
+
+  if (!output_.is_contiguous()) {
+    output_.copy_(output);
+  }
+}
+
+template <typename scalar_t, typename scale_type>
+void cpu_upsample_bicubic2d_backward(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    bool align_corners,
+    const scale_type& scales) {
+  TORCH_CHECK(grad_input_.dtype() == grad_output_.dtype(), "expected dtype ", grad_output_.dtype(),
+              " for `grad_input` but got dtype ", grad_input_.dtype());
+  using Vec = vec256::Vec256<scalar_t>;
+
+  int64_t channels = grad_input_.size(0) * grad_input_.size(1);
+  int64_t input_height = grad_input_.size(2);
+  int64_t input_width = grad_input_.size(3);
+  int64_t output_height = grad_output_.size(2);
+  int64_t output_width = grad_output_.size(3);
+
+  // Special case: input/output same size, just copy
+  if (input_height == output_height && input_width == output_width) {
+    grad_input_.copy_(grad_output_);
+    return;
+  }
+
+  auto grad_output = grad_output_.contiguous();
+  auto grad_input = grad_input_.contiguous();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+
+  const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+      input_height, output_height, align_corners, scales[0]);
+  const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+      input_width, output_width, align_corners, scales[1]);
+  std::vector<int64_t> iy(output_height * 4);
+  std::vector<scalar_t> wy(output_height * 4);
+  std::vector<int64_t> ix(output_width * 4);
+  std::vector<scalar_t> wx(output_width * 4);
+  compute_cubic_taps<scalar_t>(iy.data(), wy.data(), height_scale, input_height, output_height, align_corners);
+  compute_cubic_taps<scalar_t>(ix.data(), wx.data(), width_scale, input_width, output_width, align_corners);
+
+  // parallel on dim of N * C; output rows of one plane scatter into shared
+  // input rows. Each output row is first scattered horizontally into a
+  // buffer, which is then added to its four input rows with vectorized axpys.
+  int64_t output_slice_size = output_height * output_width;
+  at::parallel_for(0, channels, at::internal::GRAIN_SIZE / output_slice_size / 16, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> row(input_width);
+    for (int64_t c = begin; c < end; c++) {
+      scalar_t* gin = grad_input_data + c * input_height * input_width;
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        const scalar_t* gout = grad_output_data + c * output_slice_size + oh * output_width;
+        std::fill(row.begin(), row.end(), scalar_t(0));
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          const int64_t* x = ix.data() + ow * 4;
+          const scalar_t* v = wx.data() + ow * 4;
+          const scalar_t g = gout[ow];
+          row[x[0]] += g * v[0];
+          row[x[1]] += g * v[1];
+          row[x[2]] += g * v[2];
+          row[x[3]] += g * v[3];
+        }
+        for (int64_t k = 0; k < 4; k++) {
+          scalar_t* gin_row = gin + iy[oh * 4 + k] * input_width;
+          const Vec w_vec(wy[oh * 4 + k]);
+          vec256::map2(
+              [w_vec](Vec x, Vec y) { return x + y * w_vec; },
+              gin_row,
+              gin_row,
+              row.data(),
+              input_width);
+        }
+      }
+    }
+  });
+
+  if (!grad_input_.is_contiguous()) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+// Half and BFloat16 have no Vec256 arithmetic here, so reduced precision
+// inputs run the float kernel on an upcast copy and are rounded once at the
+// end, instead of accumulating every tap in 16 bits. The float copies keep
+// the memory format of the originals so the channels last paths still apply.
+template <typename func_t>
+void upsample_reduced_precision(Tensor& output, const Tensor& input, bool accumulate, const func_t& f) {
+  auto input_float = input.to(kFloat);
+  auto output_float = accumulate
+      ? output.to(kFloat)
+      : at::empty_like(output, output.options().dtype(kFloat));
+  f(output_float, input_float);
+  output.copy_(output_float);
+}
+
+static inline bool is_reduced_floating_point(ScalarType dtype) {
+  return dtype == kHalf || dtype == kBFloat16;
+}
+
 using scale_t = std::vector<c10::optional<double>>;
 void upsample_linear1d_kernel_impl(
     Tensor& output,
     const Tensor& input,
     bool align_corners,
     c10::optional<double> scales_w) {
+  if (is_reduced_floating_point(input.scalar_type())) {
+    upsample_reduced_precision(output, input, /*accumulate=*/false, [&](Tensor& out, const Tensor& in) {
+      upsample_linear1d_kernel_impl(out, in, align_corners, scales_w);
+    });
+    return;
+  }
   AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_linear1d", [&] {
     cpu_upsample_linear<scalar_t, scale_t>(output, input, align_corners, {scales_w});
   });
@@ -501,6 +849,12 @@ void upsample_bilinear2d_kernel_impl(
     bool align_corners,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
+  if (is_reduced_floating_point(input.scalar_type())) {
+    upsample_reduced_precision(output, input, /*accumulate=*/false, [&](Tensor& out, const Tensor& in) {
+      upsample_bilinear2d_kernel_impl(out, in, align_corners, scales_h, scales_w);
+    });
+    return;
+  }
   if (input.is_contiguous(at::MemoryFormat::ChannelsLast)) {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_bilinear2d_channels_last", [&] {
       cpu_upsample_linear_channels_last<scalar_t, scale_t>(output, input, align_corners, {scales_h, scales_w});
@@ -519,6 +873,12 @@ void upsample_trilinear3d_kernel_impl(
     c10::optional<double> scales_d,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
+  if (is_reduced_floating_point(input.scalar_type())) {
+    upsample_reduced_precision(output, input, /*accumulate=*/false, [&](Tensor& out, const Tensor& in) {
+      upsample_trilinear3d_kernel_impl(out, in, align_corners, scales_d, scales_h, scales_w);
+    });
+    return;
+  }
   if (input.is_contiguous(at::MemoryFormat::ChannelsLast3d)) {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_trilinear3d_channels_last", [&] {
       cpu_upsample_linear_channels_last<scalar_t, scale_t>(output, input, align_corners, {scales_d, scales_h, scales_w});
@@ -535,6 +895,12 @@ void upsample_linear1d_backward_kernel_impl(
     const Tensor& grad_output,
     bool align_corners,
     c10::optional<double> scales_w) {
+  if (is_reduced_floating_point(grad_output.scalar_type())) {
+    upsample_reduced_precision(grad_input, grad_output, /*accumulate=*/true, [&](Tensor& gin, const Tensor& gout) {
+      upsample_linear1d_backward_kernel_impl(gin, gout, align_corners, scales_w);
+    });
+    return;
+  }
   AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_linear1d_backward", [&] {
     cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_w});
   });
@@ -546,9 +912,21 @@ void upsample_bilinear2d_backward_kernel_impl(
     bool align_corners,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
-  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bilinear2d_backward", [&] {
-    cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
-  });
+  if (is_reduced_floating_point(grad_output.scalar_type())) {
+    upsample_reduced_precision(grad_input, grad_output, /*accumulate=*/true, [&](Tensor& gin, const Tensor& gout) {
+      upsample_bilinear2d_backward_kernel_impl(gin, gout, align_corners, scales_h, scales_w);
+    });
+    return;
+  }
+  if (grad_output.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bilinear2d_backward_channels_last", [&] {
+      cpu_upsample_linear_backward_channels_last<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bilinear2d_backward", [&] {
+      cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
+    });
+  }
 }
 
 void upsample_trilinear3d_backward_kernel_impl(
@@ -558,8 +936,54 @@ void upsample_trilinear3d_backward_kernel_impl(
     c10::optional<double> scales_d,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
-  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_trilinear3d_backward", [&] {
-    cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_d, scales_h, scales_w});
+  if (is_reduced_floating_point(grad_output.scalar_type())) {
+    upsample_reduced_precision(grad_input, grad_output, /*accumulate=*/true, [&](Tensor& gin, const Tensor& gout) {
+      upsample_trilinear3d_backward_kernel_impl(gin, gout, align_corners, scales_d, scales_h, scales_w);
+    });
+    return;
+  }
+  if (grad_output.is_contiguous(at::MemoryFormat::ChannelsLast3d)) {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_trilinear3d_backward_channels_last", [&] {
+      cpu_upsample_linear_backward_channels_last<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_d, scales_h, scales_w});
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_trilinear3d_backward", [&] {
+      cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_d, scales_h, scales_w});
+    });
+  }
+}
+
+void upsample_bicubic2d_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  if (is_reduced_floating_point(input.scalar_type())) {
+    upsample_reduced_precision(output, input, /*accumulate=*/false, [&](Tensor& out, const Tensor& in) {
+      upsample_bicubic2d_kernel_impl(out, in, align_corners, scales_h, scales_w);
+    });
+    return;
+  }
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_bicubic2d", [&] {
+    cpu_upsample_bicubic2d<scalar_t, scale_t>(output, input, align_corners, {scales_h, scales_w});
+  });
+}
+
+void upsample_bicubic2d_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  if (is_reduced_floating_point(grad_output.scalar_type())) {
+    upsample_reduced_precision(grad_input, grad_output, /*accumulate=*/true, [&](Tensor& gin, const Tensor& gout) {
+      upsample_bicubic2d_backward_kernel_impl(gin, gout, align_corners, scales_h, scales_w);
+    });
+    return;
+  }
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bicubic2d_backward", [&] {
+    cpu_upsample_bicubic2d_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
   });
 }
 
@@ -571,6 +995,8 @@ REGISTER_DISPATCH(upsample_trilinear3d_kernel, &upsample_trilinear3d_kernel_impl
 REGISTER_DISPATCH(upsample_linear1d_backward_kernel, &upsample_linear1d_backward_kernel_impl);
 REGISTER_DISPATCH(upsample_bilinear2d_backward_kernel, &upsample_bilinear2d_backward_kernel_impl);
 REGISTER_DISPATCH(upsample_trilinear3d_backward_kernel, &upsample_trilinear3d_backward_kernel_impl);
+REGISTER_DISPATCH(upsample_bicubic2d_kernel, &upsample_bicubic2d_kernel_impl);
+REGISTER_DISPATCH(upsample_bicubic2d_backward_kernel, &upsample_bicubic2d_backward_kernel_impl);
 
 } // namespace native
 } // namespace at
@@ -1,8 +1,13 @@
 #include <ATen/native/batch_norm.h>
 
+#include <algorithm>
+
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 
@@ -107,8 +112,242 @@ void batch_norm_cpu_inference_contiguous_kernel(Tensor& output, const Tensor& in
   });
 }
 
+/// The {numel / C, C} row range is reduced in at most kMaxChannelsLastChunks
+/// chunks whose bounds only depend on the number of rows, and the partial
+/// sums of the chunks are added up in order. This keeps the statistics
+/// independent of the number of threads.
+constexpr int64_t kMaxChannelsLastChunks = 64;
+
+inline int64_t channels_last_num_chunks(int64_t loop_size) {
+  return std::min(std::max(loop_size, int64_t(1)), kMaxChannelsLastChunks);
+}
+
+template<typename scalar_t>
+void batch_norm_cpu_channels_last_impl(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta) {
+
+  using Vec = Vec256<scalar_t>;
+  int64_t n_channel = input.size(1);
+  int64_t loop_size = input.numel() / std::max(n_channel, int64_t(1));
+
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+  const scalar_t* beta_data = beta.data_ptr<scalar_t>();
+
+  // output(n, h, w, c) = input(n, h, w, c) * alpha(c) + beta(c)
+  at::parallel_for(0, loop_size, at::internal::GRAIN_SIZE / std::max(n_channel, int64_t(1)),
+      [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      vec256::map3<scalar_t>(
+          [](Vec x, Vec alpha, Vec beta) { return x * alpha + beta; },
+          output_data + i * n_channel,
+          input_data + i * n_channel,
+          alpha_data,
+          beta_data,
+          n_channel);
+    }
+  });
+}
+
+template<typename scalar_t>
+void batch_norm_cpu_collect_stats_channels_last_impl(Tensor& mean, Tensor& var_sum,
+    const Tensor& input) {
+
+  using Vec = Vec256<scalar_t>;
+  using accscalar_t = at::acc_type<scalar_t, false>;
+  int64_t n_channel = input.size(1);
+  int64_t loop_size = input.numel() / std::max(n_channel, int64_t(1));
+  const int64_t num_chunks = channels_last_num_chunks(loop_size);
+  const int64_t chunk_size = (loop_size + num_chunks - 1) / num_chunks;
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* mean_data = mean.data_ptr<scalar_t>();
+  scalar_t* var_sum_data = var_sum.data_ptr<scalar_t>();
+
+  Tensor buffer = at::zeros({num_chunks, n_channel}, input.options());
+  scalar_t* buffer_data = buffer.data_ptr<scalar_t>();
+
+  auto reduce_chunks = [&](scalar_t* out, accscalar_t scale) {
+    for (int64_t c = 0; c < n_channel; c++) {
+      accscalar_t sum = 0;
+      for (int64_t chunk = 0; chunk < num_chunks; chunk++) {
+        sum += buffer_data[chunk * n_channel + c];
+      }
+      out[c] = sum * scale;
+    }
+  };
+
+  // Two passes like the NCHW kernel: mean first, then the sum of the
+  // squared deviations from it.
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      scalar_t* sum_ptr = buffer_data + chunk * n_channel;
+      const int64_t row_end = std::min(loop_size, (chunk + 1) * chunk_size);
+      for (int64_t i = chunk * chunk_size; i < row_end; i++) {
+        vec256::map2<scalar_t>(
+            [](Vec sum, Vec x) { return sum + x; },
+            sum_ptr,
+            sum_ptr,
+            input_data + i * n_channel,
+            n_channel);
+      }
+    }
+  });
+  reduce_chunks(mean_data, accscalar_t(1) / loop_size);
+
+  buffer.zero_();
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      scalar_t* sum_ptr = buffer_data + chunk * n_channel;
+      const int64_t row_end = std::min(loop_size, (chunk + 1) * chunk_size);
+      for (int64_t i = chunk * chunk_size; i < row_end; i++) {
+        vec256::map3<scalar_t>(
+            [](Vec sum, Vec x, Vec mean) { return sum + (x - mean) * (x - mean); },
+            sum_ptr,
+            sum_ptr,
+            input_data + i * n_channel,
+            mean_data,
+            n_channel);
+      }
+    }
+  });
+  reduce_chunks(var_sum_data, accscalar_t(1));
+}
+
+template<typename scalar_t>
+void batch_norm_cpu_backward_channels_last_impl(Tensor& grad_input, Tensor& grad_weight,
+    Tensor& grad_bias, const Tensor& grad_output, const Tensor& input,
+    const Tensor& weight, const Tensor& mean, const Tensor& invstd, bool train) {
+
+  using Vec = Vec256<scalar_t>;
+  using accscalar_t = at::acc_type<scalar_t, false>;
+  int64_t n_channel = input.size(1);
+  int64_t loop_size = input.numel() / std::max(n_channel, int64_t(1));
+  const int64_t num_chunks = channels_last_num_chunks(loop_size);
+  const int64_t chunk_size = (loop_size + num_chunks - 1) / num_chunks;
+
+  const scalar_t* grad_output_data = grad_output.data_ptr<scalar_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* mean_data = mean.data_ptr<scalar_t>();
+  const scalar_t* invstd_data = invstd.data_ptr<scalar_t>();
+
+  // sum(dy) and dotp = sum((x - mean) * dy) per channel, reduced per chunk
+  // in one sweep over input and grad_output
+  Tensor buffer = at::zeros({2, num_chunks, n_channel}, input.options());
+  scalar_t* buffer_data = buffer.data_ptr<scalar_t>();
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      scalar_t* sum_ptr = buffer_data + chunk * n_channel;
+      scalar_t* dotp_ptr = buffer_data + (num_chunks + chunk) * n_channel;
+      const int64_t row_end = std::min(loop_size, (chunk + 1) * chunk_size);
+      for (int64_t i = chunk * chunk_size; i < row_end; i++) {
+        const scalar_t* dy_ptr = grad_output_data + i * n_channel;
+        const scalar_t* x_ptr = input_data + i * n_channel;
+        int64_t d = 0;
+        for (; d < n_channel; d += Vec::size()) {
+          const int64_t count = std::min(int64_t(Vec::size()), n_channel - d);
+          const Vec dy_vec = Vec::loadu(dy_ptr + d, count);
+          const Vec x_vec = Vec::loadu(x_ptr + d, count);
+          const Vec mean_vec = Vec::loadu(mean_data + d, count);
+          const Vec sum_vec = Vec::loadu(sum_ptr + d, count) + dy_vec;
+          const Vec dotp_vec = Vec::loadu(dotp_ptr + d, count) + (x_vec - mean_vec) * dy_vec;
+          sum_vec.store(sum_ptr + d, count);
+          dotp_vec.store(dotp_ptr + d, count);
+        }
+      }
+    }
+  });
+
+  // dx = dy * a(c) + x * b(c) + d(c), where, in training mode,
+  //   a(c) = invstd(c) * w(c)
+  //   b(c) = -dotp(c) * invstd(c)^2 / n * a(c)
+  //   d(c) = (mean(c) * dotp(c) * invstd(c)^2 / n - sum(c) / n) * a(c)
+  // and b(c) = d(c) = 0 in evaluation mode.
+  Tensor coefficients = at::empty({3, n_channel}, input.options());
+  scalar_t* a_data = coefficients.data_ptr<scalar_t>();
+  scalar_t* b_data = a_data + n_channel;
+  scalar_t* d_data = b_data + n_channel;
+  scalar_t* grad_weight_data = grad_weight.defined() ? grad_weight.data_ptr<scalar_t>() : nullptr;
+  scalar_t* grad_bias_data = grad_bias.defined() ? grad_bias.data_ptr<scalar_t>() : nullptr;
+  for (int64_t c = 0; c < n_channel; c++) {
+    accscalar_t sum = 0;
+    accscalar_t dotp = 0;
+    for (int64_t chunk = 0; chunk < num_chunks; chunk++) {
+      sum += buffer_data[chunk * n_channel + c];
+      dotp += buffer_data[(num_chunks + chunk) * n_channel + c];
+    }
+    const scalar_t invstd_v = invstd_data[c];
+    const scalar_t w = weight_data ? weight_data[c] : scalar_t(1);
+    if (grad_weight_data) {
+      grad_weight_data[c] = dotp * invstd_v;
+    }
+    if (grad_bias_data) {
+      grad_bias_data[c] = sum;
+    }
+    a_data[c] = invstd_v * w;
+    if (train) {
+      const accscalar_t k = dotp * invstd_v * invstd_v / loop_size;
+      const accscalar_t grad_mean = sum / loop_size;
+      b_data[c] = -k * a_data[c];
+      d_data[c] = (mean_data[c] * k - grad_mean) * a_data[c];
+    } else {
+      b_data[c] = scalar_t(0);
+      d_data[c] = scalar_t(0);
+    }
+  }
+
+  if (!grad_input.defined()) {
+    return;
+  }
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+  at::parallel_for(0, loop_size, at::internal::GRAIN_SIZE / std::max(n_channel, int64_t(1)),
+      [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* dy_ptr = grad_output_data + i * n_channel;
+      const scalar_t* x_ptr = input_data + i * n_channel;
+      scalar_t* dx_ptr = grad_input_data + i * n_channel;
+      int64_t d = 0;
+      for (; d < n_channel; d += Vec::size()) {
+        const int64_t count = std::min(int64_t(Vec::size()), n_channel - d);
+        const Vec dx_vec = Vec::loadu(dy_ptr + d, count) * Vec::loadu(a_data + d, count) +
+            Vec::loadu(x_ptr + d, count) * Vec::loadu(b_data + d, count) +
+            Vec::loadu(d_data + d, count);
+        dx_vec.store(dx_ptr + d, count);
+      }
+    }
+  });
+}
+
+void batch_norm_cpu_channels_last_kernel(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_channels_last", [&] {
+    batch_norm_cpu_channels_last_impl<scalar_t>(output, input, alpha, beta);
+  });
+}
+
+void batch_norm_cpu_collect_stats_channels_last_kernel(Tensor& mean, Tensor& var_sum,
+    const Tensor& input) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_collect_stats_channels_last", [&] {
+    batch_norm_cpu_collect_stats_channels_last_impl<scalar_t>(mean, var_sum, input);
+  });
+}
+
+void batch_norm_cpu_backward_channels_last_kernel(Tensor& grad_input, Tensor& grad_weight,
+    Tensor& grad_bias, const Tensor& grad_output, const Tensor& input,
+    const Tensor& weight, const Tensor& mean, const Tensor& invstd, bool train) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_backward_channels_last", [&] {
+    batch_norm_cpu_backward_channels_last_impl<scalar_t>(grad_input, grad_weight, grad_bias,
+        grad_output, input, weight, mean, invstd, train);
+  });
+}
+
 }// anonymous namespace
 
 REGISTER_DISPATCH(batch_norm_cpu_inference_contiguous_stub, &batch_norm_cpu_inference_contiguous_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_channels_last_stub, &batch_norm_cpu_channels_last_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_collect_stats_channels_last_stub, &batch_norm_cpu_collect_stats_channels_last_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_backward_channels_last_stub, &batch_norm_cpu_backward_channels_last_kernel);
 
 }} // namespace at::native
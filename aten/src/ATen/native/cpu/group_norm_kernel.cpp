@@ -2,12 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <numeric>
+#include <tuple>
 
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/cpu/moments_utils.h>
 
 namespace at {
 namespace native {
@@ -38,34 +42,15 @@ void GroupNormKernelImplInternal(
   T* Y_data = Y->data_ptr<T>();
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
-  const T s = T(1) / static_cast<T>(D * HxW);
   const bool gamma_null = (gamma_data == nullptr);
   const bool beta_null = beta_data == nullptr;
 
   at::parallel_for(0, N * G, 1, [&](int64_t start, int64_t end) {
-    constexpr int64_t K = vec256::Vec256<T>::size();
-    const int64_t inner_size = D * HxW / K * K;
-    std::array<T, K> mean_arr;
-    std::array<T, K> rstd_arr;
     for (int64_t i = start; i < end; ++i) {
       const T* X_ptr = X_data + i * D * HxW;
-      vec256::Vec256<T> mean_vec(0);
-      vec256::Vec256<T> rstd_vec(0);
-      for (int64_t j = 0; j < inner_size; j += K) {
-        const vec256::Vec256<T> x_vec = vec256::Vec256<T>::loadu(X_ptr + j);
-        mean_vec = mean_vec + x_vec;
-        rstd_vec = rstd_vec + x_vec * x_vec;
-      }
-      mean_vec.store(mean_arr.data());
-      rstd_vec.store(rstd_arr.data());
-      T mean_val = std::accumulate(mean_arr.cbegin(), mean_arr.cend(), T(0));
-      T rstd_val = std::accumulate(rstd_arr.cbegin(), rstd_arr.cend(), T(0));
-      for (int64_t j = inner_size; j < D * HxW; ++j) {
-        mean_val += X_ptr[j];
-        rstd_val += X_ptr[j] * X_ptr[j];
-      }
-      mean_val *= s;
-      rstd_val = std::max(rstd_val * s - mean_val * mean_val, T(0));
+      T mean_val;
+      T rstd_val;
+      std::tie(mean_val, rstd_val) = RowwiseMoments(X_ptr, D * HxW);
       rstd_val = T(1) / std::sqrt(rstd_val + eps);
 
       const int64_t g = i % G;
@@ -75,9 +60,13 @@ void GroupNormKernelImplInternal(
         const T bias = -scale * mean_val + (beta_null ? T(0) : beta_data[c]);
         X_ptr = X_data + (i * D + j) * HxW;
         T* Y_ptr = Y_data + (i * D + j) * HxW;
-        for (int64_t k = 0; k < HxW; ++k) {
-          Y_ptr[k] = scale * X_ptr[k] + bias;
-        }
+        vec256::map(
+            [scale, bias](vec256::Vec256<T> x) {
+              return x * vec256::Vec256<T>(scale) + vec256::Vec256<T>(bias);
+            },
+            Y_ptr,
+            X_ptr,
+            HxW);
       }
       mean_data[i] = mean_val;
       rstd_data[i] = rstd_val;
@@ -206,9 +195,15 @@ void GroupNormInputBackward(
         const T* X_ptr = X + (i * D + j) * HxW;
         T* dX_ptr = dX + (i * D + j) * HxW;
         const T c1 = rstd[i] * (gamma_null ? T(1) : gamma[c]);
-        for (int64_t k = 0; k < HxW; ++k) {
-          dX_ptr[k] = c1 * dY_ptr[k] + c2 * X_ptr[k] + c3;
-        }
+        vec256::map2(
+            [c1, c2, c3](vec256::Vec256<T> dy, vec256::Vec256<T> x) {
+              return vec256::Vec256<T>(c1) * dy + vec256::Vec256<T>(c2) * x +
+                  vec256::Vec256<T>(c3);
+            },
+            dX_ptr,
+            dY_ptr,
+            X_ptr,
+            HxW);
       }
     }
   });
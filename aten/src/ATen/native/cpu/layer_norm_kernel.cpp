@@ -1,12 +1,16 @@
 #include <ATen/native/layer_norm.h>
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <tuple>
 
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/cpu/moments_utils.h>
 #include <ATen/Parallel.h>
 
 namespace at {
@@ -35,24 +39,15 @@ void LayerNormKernelImplInternal(
   T* Y_data = Y->data_ptr<T>();
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
-  const T c = T(1) / static_cast<T>(N);
   const bool gamma_null = gamma_data == nullptr;
   const bool beta_null = beta_data == nullptr;
   at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
       T* X_ptr = X_data + i * N;
       T* Y_ptr = Y_data + i * N;
-      T mean_val = vec256::reduce_all<T>(
-          [](Vec& x, Vec& y) { return x + y; },
-          X_ptr,
-          N);
-      T rstd_val = vec256::map_reduce_all<T>(
-          [](Vec x) { return x * x; },
-          [](Vec x, Vec y) { return x + y; },
-          X_ptr,
-          N);
-      mean_val *= c;
-      rstd_val = std::max(rstd_val * c - mean_val * mean_val, T(0));
+      T mean_val;
+      T rstd_val;
+      std::tie(mean_val, rstd_val) = RowwiseMoments(X_ptr, N);
       rstd_val = T(1) / std::sqrt(rstd_val + eps);
       const T scale = rstd_val;
       const T bias = -rstd_val * mean_val;
@@ -79,6 +74,68 @@ void LayerNormKernelImplInternal(
   });
 }
 
+// BFloat16 input is normalized in fp32: each row is widened into a float
+// buffer, the moments and the affine transform are computed on the buffer,
+// and only Y, mean and rstd are rounded back to BFloat16.
+void LayerNormKernelImplBFloat16(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    float eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using Vec = vec256::Vec256<float>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK(!gamma.defined() || gamma.numel() == N);
+  DCHECK(!beta.defined() || beta.numel() == N);
+  const BFloat16* X_data = X.data_ptr<BFloat16>();
+  BFloat16* Y_data = Y->data_ptr<BFloat16>();
+  BFloat16* mean_data = mean->data_ptr<BFloat16>();
+  BFloat16* rstd_data = rstd->data_ptr<BFloat16>();
+  const Tensor gamma_fp32 = gamma.defined() ? gamma.to(kFloat) : gamma;
+  const Tensor beta_fp32 = beta.defined() ? beta.to(kFloat) : beta;
+  const float* gamma_data = gamma_fp32.defined() ? gamma_fp32.data_ptr<float>() : nullptr;
+  const float* beta_data = beta_fp32.defined() ? beta_fp32.data_ptr<float>() : nullptr;
+  const bool gamma_null = gamma_data == nullptr;
+  const bool beta_null = beta_data == nullptr;
+  at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
+    std::unique_ptr<float[]> buffer(new float[N]);
+    float* X_buf = buffer.get();
+    for (int64_t i = start; i < end; ++i) {
+      vec256::convert(X_data + i * N, X_buf, N);
+      float mean_val;
+      float rstd_val;
+      std::tie(mean_val, rstd_val) = RowwiseMoments(X_buf, N);
+      rstd_val = 1.0f / std::sqrt(rstd_val + eps);
+      const float scale = rstd_val;
+      const float bias = -rstd_val * mean_val;
+      if (gamma_null || beta_null) {
+        for (int64_t j = 0; j < N; ++j) {
+          const float gamma_v = gamma_null ? 1.0f : gamma_data[j];
+          const float beta_v = beta_null ? 0.0f : beta_data[j];
+          X_buf[j] = (X_buf[j] * scale + bias) * gamma_v + beta_v;
+        }
+      } else {
+        vec256::map3<float>(
+            [scale, bias](Vec x, Vec gamma, Vec beta) {
+              return (x * Vec(scale) + Vec(bias)) * gamma + beta;
+            },
+            X_buf,
+            X_buf,
+            gamma_data,
+            beta_data,
+            N);
+      }
+      vec256::convert(X_buf, Y_data + i * N, N);
+      mean_data[i] = mean_val;
+      rstd_data[i] = rstd_val;
+    }
+  });
+}
+
 void LayerNormKernelImpl(
     const Tensor& X,
     const Tensor& gamma,
@@ -89,6 +146,11 @@ void LayerNormKernelImpl(
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
+  if (X.scalar_type() == kBFloat16) {
+    LayerNormKernelImplBFloat16(
+        X, gamma, beta, M, N, static_cast<float>(eps), Y, mean, rstd);
+    return;
+  }
   AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "LayerNormKernelImpl", [&]() {
     LayerNormKernelImplInternal<scalar_t>(
         X, gamma, beta, M, N, static_cast<scalar_t>(eps), Y, mean, rstd);
@@ -128,113 +190,97 @@ void LayerNormBackwardKernelImplInternal(
   const bool dbeta_null = dbeta_data == nullptr;
 
   // 1. Use two path parallel reduction for dgamma and dbeta:
-  //    First path: allocate an immediate buffer of size {2, max_threads, N},
-  //        dgamma_buffer = buffer[0], dbeta_buffer = buffer[1]
-  //    Parallel along dim0 and reduce dY and X along dim0 to buffer.
-  //    Second path: parallel along dim1 and reduce buffer to dgamma and dbeta.
+  //    First path: split the M rows into num_chunks fixed chunks and reduce
+  //        dY and X of each chunk into an immediate buffer of size
+  //        {2, num_chunks, N}, dgamma_buffer = buffer[0],
+  //        dbeta_buffer = buffer[1].
+  //    Second path: parallel along dim1 and reduce buffer to dgamma and dbeta
+  //        in chunk order.
+  //    The chunking only depends on M, so the result does not depend on the
+  //    number of threads or on how parallel_for schedules the chunks.
   //
-  // 2. Fuse first path of dgamma/dbeta with dX to reuse X[i] and dY[i] in L1 cache.
+  // 2. Fuse first path of dgamma/dbeta with the ds/db reductions so that
+  //    X[i] and dY[i] are read once for all four, then compute dX[i] while
+  //    the row is still in L1 cache.
   //
-  int num_threads = at::get_num_threads();
+  constexpr int64_t K = Vec::size();
+  constexpr int64_t kMaxChunks = 64;
+  const int64_t num_chunks = std::min(std::max(M, int64_t(1)), kMaxChunks);
+  const int64_t chunk_size = (M + num_chunks - 1) / num_chunks;
   Tensor buffer = at::empty({0}, X.options());
   T* buffer_data = nullptr;
   if (!dgamma_null || !dbeta_null) {
     // zero the immediate buffer and skip zero dgamma and dbeta
-    buffer.resize_({2, num_threads, N}).zero_();
+    buffer.resize_({2, num_chunks, N}).zero_();
     buffer_data = buffer.template data_ptr<T>();
   }
 
   // First path of dgamma/dbeta and dX
-  at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
-    int tid = at::get_thread_num();
-    TORCH_CHECK(tid < num_threads,
-                "expect thread id smaller than ", num_threads, ", got thread id ", tid);
-    T* dgamma_buffer_ptr = dgamma_null ? nullptr : buffer_data + tid * N;
-    T* dbeta_buffer_ptr = dbeta_null ? nullptr : buffer_data + num_threads * N + tid * N;
-    for (int64_t i = start; i < end; ++i) {
-      const T* dY_ptr = dY_data + i * N;
-      const T* X_ptr = X_data + i * N;
-      if (!dgamma_null) {
+  at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    for (int64_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+      T* dgamma_buffer_ptr = dgamma_null ? nullptr : buffer_data + chunk * N;
+      T* dbeta_buffer_ptr =
+          dbeta_null ? nullptr : buffer_data + num_chunks * N + chunk * N;
+      const int64_t row_end = std::min(M, (chunk + 1) * chunk_size);
+      for (int64_t i = chunk * chunk_size; i < row_end; ++i) {
+        const T* dY_ptr = dY_data + i * N;
+        const T* X_ptr = X_data + i * N;
         const T a = rstd_data[i];
         const T b = -a * mean_data[i];
         // Scalar math:
         // for (int64_t j = 0; j < N; ++j) {
-        //   dgamma_data[j] += dY_ptr[j] * (a * X_ptr[j] + b);
-        // }
-        vec256::map3<T>(
-            [a, b](Vec dgamma, Vec dy, Vec x) { return dgamma + dy * (Vec(a) * x + Vec(b)); },
-            dgamma_buffer_ptr,
-            dgamma_buffer_ptr,
-            dY_ptr,
-            X_ptr,
-            N);
-      }
-      if (!dbeta_null) {
-        // Scalar math:
-        // for (int64_t j = 0; j < N; ++j) {
-        //   dbeta_data[j] += dY_ptr[j];
-        // }
-        vec256::map2<T>(
-            [](Vec dbeta, Vec dy) { return dbeta + dy; },
-            dbeta_buffer_ptr,
-            dbeta_buffer_ptr,
-            dY_ptr,
-            N);
-      }
-      if (!dX_null) {
-        T* dX_ptr = dX_data + i * N;
-        T ds = T(0);
-        T db = T(0);
-        // Scalar math:
-        // for (int64_t j = 0; j < N; ++j) {
         //   const T gamma_v = gamma_null ? T(1) : gamma_data[j];
         //   ds += dY_ptr[j] * X_ptr[j] * gamma_v;
         //   db += dY_ptr[j] * gamma_v;
+        //   dgamma_data[j] += dY_ptr[j] * (a * X_ptr[j] + b);
+        //   dbeta_data[j] += dY_ptr[j];
         // }
-        if (gamma_null) {
-          ds = vec256::map2_reduce_all<T>(
-              [](Vec x, Vec y) { return x * y; },
-              [](Vec x, Vec y) { return x + y; },
-              dY_ptr,
-              X_ptr,
-              N);
-          db = vec256::reduce_all<T>(
-              [](Vec& x, Vec& y) { return x + y; },
-              dY_ptr,
-              N);
-        } else {
-          ds = vec256::map3_reduce_all<T>(
-              [](Vec x, Vec y, Vec z) { return x * y * z; },
-              [](Vec x, Vec y) { return x + y; },
-              dY_ptr,
-              X_ptr,
-              gamma_data,
-              N);
-          db = vec256::map2_reduce_all<T>(
-              [](Vec x, Vec y) { return x * y; },
-              [](Vec x, Vec y) { return x + y; },
-              dY_ptr,
-              gamma_data,
-              N);
+        // The tail is loaded zero-filled, so it adds nothing to ds and db.
+        Vec ds_vec(0);
+        Vec db_vec(0);
+        for (int64_t j = 0; j < N; j += K) {
+          const int64_t n = std::min(K, N - j);
+          const Vec dy_vec = Vec::loadu(dY_ptr + j, n);
+          const Vec x_vec = Vec::loadu(X_ptr + j, n);
+          const Vec dy_gamma_vec =
+              gamma_null ? dy_vec : dy_vec * Vec::loadu(gamma_data + j, n);
+          ds_vec = ds_vec + dy_gamma_vec * x_vec;
+          db_vec = db_vec + dy_gamma_vec;
+          if (!dgamma_null) {
+            const Vec dgamma_vec = Vec::loadu(dgamma_buffer_ptr + j, n) +
+                dy_vec * (Vec(a) * x_vec + Vec(b));
+            dgamma_vec.store(dgamma_buffer_ptr + j, n);
+          }
+          if (!dbeta_null) {
+            const Vec dbeta_vec = Vec::loadu(dbeta_buffer_ptr + j, n) + dy_vec;
+            dbeta_vec.store(dbeta_buffer_ptr + j, n);
+          }
         }
-        const T a = rstd_data[i];
-        const T b = (db * mean_data[i] - ds) * a * a * a * scale;
-        const T c = -b * mean_data[i] - db * a * scale;
+        if (dX_null) {
+          continue;
+        }
+        T* dX_ptr = dX_data + i * N;
+        const T ds = vec256::vec_reduce_all<T>(
+            [](Vec& x, Vec& y) { return x + y; }, ds_vec, K);
+        const T db = vec256::vec_reduce_all<T>(
+            [](Vec& x, Vec& y) { return x + y; }, db_vec, K);
+        const T c1 = (db * mean_data[i] - ds) * a * a * a * scale;
+        const T c2 = -c1 * mean_data[i] - db * a * scale;
         // Scalar math:
         // for (int64_t j = 0; j < N; ++j) {
         //   const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        //   dX_ptr[j] = a * dY_ptr[j] * gamma_v + b * X_ptr[j] + c;
+        //   dX_ptr[j] = a * dY_ptr[j] * gamma_v + c1 * X_ptr[j] + c2;
         // }
         if (gamma_null) {
           vec256::map2<T>(
-              [a, b, c](Vec dy, Vec x) { return Vec(a) * dy + Vec(b) * x + Vec(c); },
+              [a, c1, c2](Vec dy, Vec x) { return Vec(a) * dy + Vec(c1) * x + Vec(c2); },
               dX_ptr,
               dY_ptr,
               X_ptr,
               N);
         } else {
           vec256::map3<T>(
-              [a, b, c](Vec dy, Vec gamma, Vec x) { return Vec(a) * dy * gamma + Vec(b) * x + Vec(c); },
+              [a, c1, c2](Vec dy, Vec gamma, Vec x) { return Vec(a) * dy * gamma + Vec(c1) * x + Vec(c2); },
               dX_ptr,
               dY_ptr,
               gamma_data,
@@ -251,9 +297,9 @@ void LayerNormBackwardKernelImplInternal(
       for (int64_t j = start; j < end; ++j) {
         T dgamma_v = T(0);
         T dbeta_v = T(0);
-        for (int64_t i = 0; i < num_threads; ++i) {
+        for (int64_t i = 0; i < num_chunks; ++i) {
           dgamma_v += buffer_data[i * N + j];
-          dbeta_v += buffer_data[num_threads * N + i * N + j];
+          dbeta_v += buffer_data[num_chunks * N + i * N + j];
         }
         if (!dgamma_null) {
           dgamma_data[j] = dgamma_v;
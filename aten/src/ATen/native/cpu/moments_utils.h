@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+namespace {
+
+// Merges the Welford state (mean_b, m2_b, n_b) into (mean_a, m2_a, n_a)
+// using Chan's pairwise update.
+template <typename T>
+inline void WelfordCombine(
+    T& mean_a,
+    T& m2_a,
+    int64_t& n_a,
+    T mean_b,
+    T m2_b,
+    int64_t n_b) {
+  if (n_b == 0) {
+    return;
+  }
+  const int64_t n = n_a + n_b;
+  const T nb_over_n = static_cast<T>(n_b) / static_cast<T>(n);
+  const T delta = mean_b - mean_a;
+  mean_a += delta * nb_over_n;
+  m2_a += m2_b + delta * delta * static_cast<T>(n_a) * nb_over_n;
+  n_a = n;
+}
+
+// Computes the mean and the biased variance of X[0:N] in a single pass.
+//
+// Every lane of a Vec256 runs its own Welford recurrence over the strided
+// elements it sees; since all lanes see the same number of elements the
+// reciprocal count is shared. Lanes are then merged with Chan's formula and
+// the remaining tail is folded in element by element. Unlike the
+// E[x^2] - E[x]^2 form this does not cancel catastrophically when the mean
+// is large compared to the spread.
+template <typename T>
+std::pair<T, T> RowwiseMoments(const T* X, int64_t N) {
+  using Vec = vec256::Vec256<T>;
+  constexpr int64_t K = Vec::size();
+  const int64_t n = N / K;
+  T mean = T(0);
+  T m2 = T(0);
+  int64_t count = 0;
+  if (n > 0) {
+    Vec mean_vec(0);
+    Vec m2_vec(0);
+    for (int64_t i = 0; i < n; ++i) {
+      const Vec x_vec = Vec::loadu(X + i * K);
+      const Vec delta_vec = x_vec - mean_vec;
+      mean_vec = mean_vec + delta_vec * Vec(T(1) / static_cast<T>(i + 1));
+      m2_vec = m2_vec + delta_vec * (x_vec - mean_vec);
+    }
+    __at_align32__ T mean_arr[K];
+    __at_align32__ T m2_arr[K];
+    mean_vec.store(mean_arr);
+    m2_vec.store(m2_arr);
+    mean = mean_arr[0];
+    m2 = m2_arr[0];
+    count = n;
+    for (int64_t k = 1; k < K; ++k) {
+      WelfordCombine(mean, m2, count, mean_arr[k], m2_arr[k], n);
+    }
+  }
+  for (int64_t i = n * K; i < N; ++i) {
+    const T delta = X[i] - mean;
+    ++count;
+    mean += delta / static_cast<T>(count);
+    m2 += delta * (X[i] - mean);
+  }
+  const T var = N > 0 ? m2 / static_cast<T>(N) : T(0);
+  return std::make_pair(mean, var > T(0) ? var : T(0));
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <utility>
+
+namespace at {
+namespace native {
+namespace {
+
+// Helpers to walk a flattened index range [begin, end) over a set of nested
+// dimensions, innermost last:
+//
+//   data_index_init(begin, n, N, h, H, w, W);
+//   for (int64_t i = begin; i < end; i++) {
+//     ...
+//     data_index_step(n, N, h, H, w, W);
+//   }
+template <typename T>
+inline T data_index_init(T offset) {
+  return offset;
+}
+
+template <typename T, typename... Args>
+inline T data_index_init(T offset, T &x, const T &X, Args &&... args) {
+  offset = data_index_init(offset, std::forward<Args>(args)...);
+  x = offset % X;
+  return offset / X;
+}
+
+inline bool data_index_step() {
+  return true;
+}
+
+template <typename T, typename... Args>
+inline bool data_index_step(T &x, const T &X, Args &&... args) {
+  if (data_index_step(std::forward<Args>(args)...)) {
+    x = ((x + 1) == X) ? 0 : (x + 1);
+    return x == 0;
+  }
+  return false;
+}
+
+} // namespace
+} // namespace native
+} // namespace at
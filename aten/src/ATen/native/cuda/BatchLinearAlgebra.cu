@@ -7,6 +7,7 @@
 #include <ATen/cuda/detail/IndexUtils.cuh>
 
 #include <ATen/native/LinearAlgebraUtils.h>
+#include <ATen/native/SmallLinearAlgebra.h>
 #include <ATen/native/cuda/MiscUtils.h>
 
 #include <THC/THC.h> // for USE_MAGMA
@@ -528,6 +529,122 @@ void magmaLuSolveBatched<float>(
   auto storage_##name = pin_memory<type>(size); \
   name = static_cast<type*>(storage_##name.data());
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ small matrices ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// The matrices of at most kSmallMatrixMaxSize are handled by the kernels of
+// SmallLinearAlgebra.h, one thread per matrix, in a single launch for the
+// whole batch. They do not need MAGMA.
+
+constexpr int kSmallMatrixThreads = 128;
+
+static inline dim3 smallMatrixGrid(int64_t batch_size) {
+  return dim3(cuda::ATenCeilDiv(batch_size, static_cast<int64_t>(kSmallMatrixThreads)));
+}
+
+static void copySmallMatrixInfos(const Tensor& infos_tensor, std::vector<int64_t>& infos) {
+  auto infos_cpu = infos_tensor.to(at::kCPU);
+  auto infos_data = infos_cpu.data_ptr<int>();
+  for (size_t i = 0; i < infos.size(); i++) {
+    infos[i] = infos_data[i];
+  }
+}
+
+template <typename scalar_t>
+__global__ void small_solve_kernel(
+    scalar_t* A_data, scalar_t* b_data, int* infos_data, int64_t n, int64_t nrhs,
+    int64_t A_mat_stride, int64_t b_mat_stride, int64_t batch_size) {
+  const int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (i < batch_size) {
+    infos_data[i] = small_solve(n, &A_data[i * A_mat_stride], &b_data[i * b_mat_stride], nrhs);
+  }
+}
+
+template <typename scalar_t>
+__global__ void small_inverse_kernel(
+    scalar_t* self_data, int* infos_data, int64_t n, int64_t self_mat_stride, int64_t batch_size) {
+  const int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (i < batch_size) {
+    infos_data[i] = small_inverse(n, &self_data[i * self_mat_stride]);
+  }
+}
+
+template <typename scalar_t>
+__global__ void small_cholesky_kernel(
+    scalar_t* self_data, int* infos_data, int64_t n, bool upper, int64_t self_mat_stride, int64_t batch_size) {
+  const int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (i < batch_size) {
+    infos_data[i] = small_cholesky(n, &self_data[i * self_mat_stride], upper);
+  }
+}
+
+template <typename scalar_t>
+__global__ void small_lu_kernel(
+    scalar_t* self_data, int* pivots_data, int* infos_data, int64_t n,
+    int64_t self_mat_stride, int64_t pivots_mat_stride, int64_t batch_size) {
+  const int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (i < batch_size) {
+    infos_data[i] = small_lu(n, &self_data[i * self_mat_stride], &pivots_data[i * pivots_mat_stride]);
+  }
+}
+
+template <typename scalar_t>
+static void apply_small_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
+  auto batch_size = batchCount(A);
+  if (batch_size == 0) {
+    return;
+  }
+  auto infos_tensor = at::empty({batch_size}, A.options().dtype(at::kInt));
+  auto stream = at::cuda::getCurrentCUDAStream();
+  small_solve_kernel<scalar_t><<<smallMatrixGrid(batch_size), kSmallMatrixThreads, 0, stream>>>(
+      A.data_ptr<scalar_t>(), b.data_ptr<scalar_t>(), infos_tensor.data_ptr<int>(),
+      A.size(-2), b.size(-1), matrixStride(A), matrixStride(b), batch_size);
+  AT_CUDA_CHECK(cudaGetLastError());
+  copySmallMatrixInfos(infos_tensor, infos);
+}
+
+template <typename scalar_t>
+static void apply_small_inverse(Tensor& self, std::vector<int64_t>& infos) {
+  auto batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  auto infos_tensor = at::empty({batch_size}, self.options().dtype(at::kInt));
+  auto stream = at::cuda::getCurrentCUDAStream();
+  small_inverse_kernel<scalar_t><<<smallMatrixGrid(batch_size), kSmallMatrixThreads, 0, stream>>>(
+      self.data_ptr<scalar_t>(), infos_tensor.data_ptr<int>(),
+      self.size(-2), matrixStride(self), batch_size);
+  AT_CUDA_CHECK(cudaGetLastError());
+  copySmallMatrixInfos(infos_tensor, infos);
+}
+
+template <typename scalar_t>
+static void apply_small_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos) {
+  auto batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  auto infos_tensor = at::empty({batch_size}, self.options().dtype(at::kInt));
+  auto stream = at::cuda::getCurrentCUDAStream();
+  small_cholesky_kernel<scalar_t><<<smallMatrixGrid(batch_size), kSmallMatrixThreads, 0, stream>>>(
+      self.data_ptr<scalar_t>(), infos_tensor.data_ptr<int>(),
+      self.size(-2), upper, matrixStride(self), batch_size);
+  AT_CUDA_CHECK(cudaGetLastError());
+  copySmallMatrixInfos(infos_tensor, infos);
+}
+
+template <typename scalar_t>
+static void apply_small_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
+  auto batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  auto stream = at::cuda::getCurrentCUDAStream();
+  small_lu_kernel<scalar_t><<<smallMatrixGrid(batch_size), kSmallMatrixThreads, 0, stream>>>(
+      self.data_ptr<scalar_t>(), pivots.data_ptr<int>(), infos.data_ptr<int>(),
+      self.size(-1), matrixStride(self), pivots.size(-1), batch_size);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template <typename scalar_t>
@@ -609,7 +726,11 @@ std::tuple<Tensor, Tensor> _solve_helper_cuda(const Tensor& self, const Tensor&
   auto A_working_copy = cloneBatchedColumnMajor(A);
   std::vector<int64_t> infos(batchCount(self), 0);
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cuda", [&]{
-    apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    if (useSmallMatrixKernels(A.size(-1))) {
+      apply_small_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    } else {
+      apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    }
   });
   if (self.dim() > 2) {
     batchCheckErrors(infos, "solve_cuda");
@@ -715,7 +836,17 @@ AT_ERROR("inverse: MAGMA library not found in "
 
 Tensor _inverse_helper_cuda(const Tensor& self) {
   auto self_inv_working_copy = cloneBatchedColumnMajor(self);
-  if (self.dim() > 2) {
+  if (useSmallMatrixKernels(self.size(-1))) {
+    std::vector<int64_t> infos(batchCount(self), 0);
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cuda", [&]{
+      apply_small_inverse<scalar_t>(self_inv_working_copy, infos);
+    });
+    if (self.dim() > 2) {
+      batchCheckErrors(infos, "inverse_cuda");
+    } else {
+      singleCheckErrors(infos[0], "inverse_cuda");
+    }
+  } else if (self.dim() > 2) {
     std::vector<int64_t> infos(batchCount(self), 0);
     auto self_working_copy = cloneBatchedColumnMajor(self);
     AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cuda", [&]{
@@ -887,7 +1018,11 @@ Tensor _cholesky_helper_cuda(const Tensor& self, bool upper) {
   }
 
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cuda", [&]{
-    apply_cholesky<scalar_t>(self_working_copy, false, infos);
+    if (useSmallMatrixKernels(self.size(-1))) {
+      apply_small_cholesky<scalar_t>(self_working_copy, false, infos);
+    } else {
+      apply_cholesky<scalar_t>(self_working_copy, false, infos);
+    }
   });
   if (self.dim() > 2) {
     batchCheckErrors(infos, "cholesky_cuda");
@@ -985,7 +1120,11 @@ std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cuda(const Tensor& self, bool p
   } else {
     self_working_copy = cloneBatchedColumnMajor(self);
     AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
+      if (pivot && m == n && useSmallMatrixKernels(n)) {
+        apply_small_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
+      } else {
         apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor, pivot);
+      }
     });
   }
   if (check_errors) {
@@ -30,6 +30,7 @@
 
 #include <type_traits>
 #include <tuple>
+#include <utility>
 
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
@@ -79,6 +80,24 @@ __global__ void vectorized_elementwise_kernel(int N, func_t f, array_t data) {
   }
 }
 
+template<int vec_size, bool cast, typename func_t, typename array_t, typename period_array_t, typename dtype_array_t, typename inp_calc_t, typename loader_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void vectorized_broadcast_elementwise_kernel(int N, func_t f, array_t data, period_array_t periods,
+                                                        dtype_array_t dtypes, inp_calc_t ic, loader_t l) {
+  using traits = function_traits<func_t>;
+  int remaining = N - block_work_size * blockIdx.x;
+
+  if (remaining < block_work_size) {  // the remainder goes through the offset calculator like the unrolled kernel
+    auto output_calc = TrivialOffsetCalculator<1>();
+    auto storer = memory::StoreWithoutCast();
+    auto policy = memory::policies::unroll<array_t, inp_calc_t, decltype(output_calc), loader_t, memory::StoreWithoutCast>(
+      data, remaining, ic, output_calc, l, storer);
+    elementwise_kernel_helper(f, policy);
+  } else {
+    elementwise_kernel_helper(f, memory::policies::vectorized_broadcast<vec_size, array_t, traits::arity, cast>(data, periods, dtypes));
+  }
+}
+
 template<typename func_t, typename array_t, typename inp_calc_t, typename out_calc_t, typename loader_t, typename storer_t>
 C10_LAUNCH_BOUNDS_1(num_threads)
 __global__ void unrolled_elementwise_kernel(int N, func_t f, array_t data,
@@ -130,6 +149,194 @@ static inline void launch_unrolled_kernel(int64_t N, const func_t& f, array_t da
   AT_CUDA_CHECK(cudaGetLastError());
 }
 
+// Note [64-bit indexing in gpu_kernel]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The kernels above index the elements and their offsets in 32 bits, which is
+// faster. An iterator which needs more used to be split by
+// with_32bit_indexing into sub-iterators of at most 2^31 elements and bytes,
+// each one with its own checks and launch, down to hundreds of launches for
+// an embedding with billions of elements. gpu_kernel_impl_64 runs it in a
+// single launch instead:
+//
+//  - A contiguous iterator without casts moves the data pointers of every
+//    block to its first element in 64 bits, so that the vectorized policy
+//    keeps its 32-bit offsets within the block.
+//  - Every other iterator goes through unrolled_elementwise_kernel_64, whose
+//    linear index and offset calculators are 64-bit.
+
+template<typename traits, typename array_t, size_t... INDEX>
+__device__ inline void advance_data(array_t& data, int64_t n, std::index_sequence<INDEX...>) {
+  data[0] += n * sizeof(typename traits::result_type);
+  // data holds the output and then the inputs
+  (void)std::initializer_list<int>{
+    (data[INDEX + 1] += n * sizeof(typename traits::template arg<INDEX>::type), 0)...};
+}
+
+template<int vec_size, typename func_t, typename array_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void vectorized_elementwise_kernel_64(int64_t N, func_t f, array_t data) {
+  using traits = function_traits<func_t>;
+  int64_t block_start = static_cast<int64_t>(blockIdx.x) * block_work_size;
+  advance_data<traits>(data, block_start, std::make_index_sequence<traits::arity>());
+  int64_t remaining = N - block_start;
+
+  if (remaining < block_work_size) {
+    auto input_calc = TrivialOffsetCalculator<traits::arity>();
+    auto output_calc = TrivialOffsetCalculator<1>();
+    auto loader = memory::LoadWithoutCast();
+    auto storer = memory::StoreWithoutCast();
+    auto policy = memory::policies::unroll<array_t, decltype(input_calc), decltype(output_calc),
+                                           memory::LoadWithoutCast, memory::StoreWithoutCast>(
+      data, static_cast<int>(remaining), input_calc, output_calc, loader, storer);
+    elementwise_kernel_helper(f, policy, 0);
+  } else {
+    elementwise_kernel_helper(f, memory::policies::vectorized<vec_size, array_t>(data), 0);
+  }
+}
+
+template<typename args_t, typename array_t, typename offset_t, typename loader_t, size_t... INDEX>
+__device__ inline args_t load_args(const array_t& data, const offset_t& offsets, loader_t& loader,
+                                   std::index_sequence<INDEX...>) {
+  return args_t(loader.template load<std::tuple_element_t<INDEX, args_t>>(
+      data[INDEX + 1], offsets[INDEX], INDEX)...);
+}
+
+template<typename func_t, typename array_t, typename inp_calc_t, typename out_calc_t, typename loader_t, typename storer_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void unrolled_elementwise_kernel_64(int64_t N, func_t f, array_t data,
+                                               inp_calc_t ic, out_calc_t oc, loader_t l, storer_t s)
+{
+  using traits = function_traits<func_t>;
+  using return_t = typename traits::result_type;
+  using args_t = typename traits::ArgsTuple;
+  int64_t block_start = static_cast<int64_t>(blockIdx.x) * block_work_size;
+
+  args_t args[thread_work_size];
+  #pragma unroll
+  for (int i = 0; i < thread_work_size; i++) {
+    int64_t linear_idx = block_start + threadIdx.x + i * num_threads;
+    if (linear_idx < N) {
+      args[i] = load_args<args_t>(data, ic.get(linear_idx), l, std::make_index_sequence<traits::arity>());
+    }
+  }
+
+  #pragma unroll
+  for (int i = 0; i < thread_work_size; i++) {
+    int64_t linear_idx = block_start + threadIdx.x + i * num_threads;
+    if (linear_idx < N) {
+      return_t result = c10::guts::apply(f, args[i]);
+      s.store(result, data[0], oc.get(linear_idx)[0]);
+    }
+  }
+}
+
+template<typename func_t, typename array_t, typename inp_calc_t, typename out_calc_t, typename loader_t, typename storer_t>
+static inline void launch_unrolled_kernel_64(int64_t N, const func_t& f, array_t data,
+                                             inp_calc_t ic, out_calc_t oc, loader_t l, storer_t s)
+{
+  int64_t grid = (N + block_work_size - 1) / block_work_size;
+  TORCH_INTERNAL_ASSERT(N > 0 && grid <= std::numeric_limits<int32_t>::max());
+  auto stream = at::cuda::getCurrentCUDAStream();
+  unrolled_elementwise_kernel_64<func_t, array_t><<<grid, num_threads, 0, stream>>>(N, f, data, ic, oc, l, s);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+// Number of elements after which input `arg` of iter repeats itself, given
+// that it is contiguous in its innermost dimensions and broadcast (stride 0)
+// in the others. A fully contiguous input repeats after numel elements and a
+// broadcast scalar after one. Returns -1 for any other layout.
+static inline int64_t broadcast_period(const TensorIterator& iter, int arg) {
+  auto shape = iter.shape();
+  auto strides = iter.strides(arg);
+  int64_t element_size = iter.element_size(arg);
+  int64_t period = 1;
+  int dim = 0;
+  for (; dim < iter.ndim(); dim++) {
+    if (shape[dim] == 1) {
+      continue;
+    }
+    if (strides[dim] != period * element_size) {
+      break;
+    }
+    period *= shape[dim];
+  }
+  for (; dim < iter.ndim(); dim++) {
+    if (shape[dim] != 1 && strides[dim] != 0) {
+      return -1;
+    }
+  }
+  return period;
+}
+
+// Loader for the remainder of a vectorized_broadcast_elementwise_kernel.
+template<int arity, typename dtype_array_t>
+static inline memory::LoadWithoutCast make_broadcast_loader(dtype_array_t dtypes, std::false_type /* cast */) {
+  return memory::LoadWithoutCast();
+}
+
+template<int arity, typename dtype_array_t>
+static inline memory::LoadWithCast<arity> make_broadcast_loader(dtype_array_t dtypes, std::true_type /* cast */) {
+  return memory::LoadWithCast<arity>(dtypes);
+}
+
+// Vectorized launch for a contiguous output whose inputs are contiguous,
+// broadcast scalars or broadcast along their leading dimensions only, such as
+// `x + bias` with x of shape (N, C) and bias of shape (C). With cast the
+// inputs may have other dtypes than the arguments of f, which they are
+// converted to after the vector loads. Returns false without launching when
+// the layout does not allow vector accesses, leaving it to the unrolled
+// kernel.
+template<bool cast, typename func_t, typename array_t>
+static inline bool launch_vectorized_broadcast_kernel(TensorIterator& iter, const func_t& f, array_t data) {
+  using traits = function_traits<func_t>;
+  constexpr int arity = traits::arity;
+  int64_t numel = iter.numel();
+  TORCH_INTERNAL_ASSERT(numel > 0 && numel <= std::numeric_limits<int32_t>::max());
+
+  if (broadcast_period(iter, 0) != numel) {
+    return false;
+  }
+  int vec_size = memory::can_vectorize_up_to(data[0], iter.element_size(0));
+  at::detail::Array<int64_t, std::max<int>(arity, 1)> periods;
+  at::detail::Array<ScalarType, std::max<int>(arity, 1)> dtypes;
+  for (int i = 0; i < arity; i++) {
+    int arg = i + 1;
+    dtypes[i] = iter.dtype(arg);
+    periods[i] = broadcast_period(iter, arg);
+    if (periods[i] < 0 || (cast && (isComplexType(dtypes[i]) || isQIntType(dtypes[i])))) {
+      return false;
+    }
+    if (periods[i] != 1) {
+      vec_size = std::min(vec_size, memory::can_vectorize_up_to(data[arg], iter.element_size(arg)));
+      while (periods[i] < numel && periods[i] % vec_size != 0) {
+        vec_size /= 2;
+      }
+    }
+  }
+  if (vec_size == 1) {
+    return false;
+  }
+
+  at::detail::Array<IntDivider<uint32_t>, std::max<int>(arity, 1)> period_dividers;
+  for (int i = 0; i < arity; i++) {
+    period_dividers[i] = IntDivider<uint32_t>(periods[i]);
+  }
+  auto input_calc = make_input_offset_calculator<arity>(iter);
+  auto loader = make_broadcast_loader<arity>(dtypes, std::integral_constant<bool, cast>());
+  int64_t grid = (numel + block_work_size - 1) / block_work_size;
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  if (vec_size == 4) {
+    vectorized_broadcast_elementwise_kernel<4, cast><<<grid, num_threads, 0, stream>>>(
+        numel, f, data, period_dividers, dtypes, input_calc, loader);
+  } else {
+    vectorized_broadcast_elementwise_kernel<2, cast><<<grid, num_threads, 0, stream>>>(
+        numel, f, data, period_dividers, dtypes, input_calc, loader);
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+  return true;
+}
+
 template <typename func_t>
 void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   using traits = function_traits<func_t>;
@@ -153,7 +360,7 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   if (!dynamic_casting) {
     if (contiguous) {
       launch_vectorized_kernel(numel, f, data);
-    } else {
+    } else if (!launch_vectorized_broadcast_kernel</*cast=*/false>(iter, f, data)) {
       auto input_offset_calculator = make_input_offset_calculator<traits::arity>(iter);
       auto output_offset_calculator = make_output_offset_calculator(iter);
       auto loader = memory::LoadWithoutCast();
@@ -161,6 +368,12 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
       launch_unrolled_kernel(numel, f, data, input_offset_calculator, output_offset_calculator, loader, storer);
     }
   } else {
+    // Only the inputs are converted in vector registers, an output of another
+    // dtype than f returns still takes the unrolled kernel.
+    if (iter.dtype(0) == c10::CppTypeToScalarType<arg0_t>::value &&
+        launch_vectorized_broadcast_kernel</*cast=*/true>(iter, f, data)) {
+      return;
+    }
     at::detail::Array<ScalarType, traits::arity> dtypes;
     for (int i = 0; i < traits::arity; i++) {
       dtypes[i] = iter.tensor(i + 1).scalar_type();
@@ -179,4 +392,63 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   }
 }
 
+template <typename func_t>
+void gpu_kernel_impl_64(TensorIterator& iter, const func_t& f) {
+  using traits = function_traits<func_t>;
+  constexpr int ntensors = traits::arity + 1;
+  using array_t = at::detail::Array<char*, ntensors>;
+
+  TORCH_INTERNAL_ASSERT(iter.ninputs() == traits::arity);
+  TORCH_INTERNAL_ASSERT(iter.noutputs() == 1);
+
+  array_t data;
+  for (int i = 0; i < ntensors; i++) {
+    data[i] = (char*)iter.data_ptr(i);
+  }
+
+  int64_t numel = iter.numel();
+  bool contiguous = iter.is_contiguous();
+  bool dynamic_casting = needs_dynamic_casting<func_t>::check(iter);
+
+  if (!dynamic_casting) {
+    auto loader = memory::LoadWithoutCast();
+    auto storer = memory::StoreWithoutCast();
+    if (contiguous) {
+      int64_t grid = (numel + block_work_size - 1) / block_work_size;
+      TORCH_INTERNAL_ASSERT(grid <= std::numeric_limits<int32_t>::max());
+      auto stream = at::cuda::getCurrentCUDAStream();
+      switch (memory::can_vectorize_up_to<func_t>(data)) {
+      case 4:
+        vectorized_elementwise_kernel_64<4, func_t, array_t><<<grid, num_threads, 0, stream>>>(numel, f, data);
+        break;
+      case 2:
+        vectorized_elementwise_kernel_64<2, func_t, array_t><<<grid, num_threads, 0, stream>>>(numel, f, data);
+        break;
+      default:
+        launch_unrolled_kernel_64(numel, f, data, TrivialOffsetCalculator<traits::arity, uint64_t>(),
+                                  TrivialOffsetCalculator<1, uint64_t>(), loader, storer);
+        return;
+      }
+      AT_CUDA_CHECK(cudaGetLastError());
+    } else {
+      launch_unrolled_kernel_64(numel, f, data, make_input_offset_calculator<traits::arity, uint64_t>(iter),
+                                make_output_offset_calculator<1, uint64_t>(iter), loader, storer);
+    }
+  } else {
+    at::detail::Array<ScalarType, traits::arity> dtypes;
+    for (int i = 0; i < traits::arity; i++) {
+      dtypes[i] = iter.tensor(i + 1).scalar_type();
+    }
+    auto loader = memory::LoadWithCast<traits::arity>(dtypes);
+    auto storer = memory::StoreWithCast(iter.tensor(0).scalar_type());
+    if (contiguous) {
+      launch_unrolled_kernel_64(numel, f, data, TrivialOffsetCalculator<traits::arity, uint64_t>(),
+                                TrivialOffsetCalculator<1, uint64_t>(), loader, storer);
+    } else {
+      launch_unrolled_kernel_64(numel, f, data, make_input_offset_calculator<traits::arity, uint64_t>(iter),
+                                make_output_offset_calculator<1, uint64_t>(iter), loader, storer);
+    }
+  }
+}
+
 }} // namespace at::native
@@ -5,6 +5,8 @@
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <stdexcept>
@@ -335,10 +337,15 @@ public:
 
   int64_t workspace_size() const { return ws_size; }
 
+  // The stream and work area are state of the plan, so setting them and
+  // executing the plan has to happen under this lock when the plan is shared.
+  std::mutex& exec_mutex() const { return exec_mutex_; }
+
 private:
   std::unique_ptr<cufftHandle, CuFFTHandleDeleter> plan_ptr;
   bool clone_input;
   int64_t ws_size;
+  mutable std::mutex exec_mutex_;
 };
 
 #if CUDA_VERSION < 10000
@@ -358,14 +365,22 @@ static_assert(CUFFT_MAX_PLAN_NUM >= 0 && CUFFT_MAX_PLAN_NUM <= std::numeric_limi
 static_assert(CUFFT_DEFAULT_CACHE_SIZE >= 0 && CUFFT_DEFAULT_CACHE_SIZE <= CUFFT_MAX_PLAN_NUM,
               "CUFFT_DEFAULT_CACHE_SIZE not in [0, CUFFT_MAX_PLAN_NUM] range");
 
+struct CuFFTPlanCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  int64_t evictions = 0;
+};
+
 // This cache assumes that the mapping from key to value never changes.
-// This is **NOT** thread-safe. Please use a mutex when using it **AND** the
-// value returned from try_emplace_value.
+// This is **NOT** thread-safe. Please use a mutex when using it.
+// The configs are shared, so one that is evicted while another thread still
+// executes it stays alive until that thread is done; executing a config needs
+// its exec_mutex instead of the cache mutex.
 // The contract of using this cache is that try_emplace_value should only be
 // used when the max_size is positive.
 class CuFFTParamsLRUCache {
 public:
-  using kv_t = typename std::pair<CuFFTParams, CuFFTConfig>;
+  using kv_t = typename std::pair<CuFFTParams, std::shared_ptr<CuFFTConfig>>;
   using map_t = typename std::unordered_map<std::reference_wrapper<CuFFTParams>,
                                             typename std::list<kv_t>::iterator,
                                             ParamsHash<CuFFTParams>,
@@ -382,44 +397,50 @@ public:
   CuFFTParamsLRUCache(CuFFTParamsLRUCache&& other) noexcept :
     _usage_list(std::move(other._usage_list)),
     _cache_map(std::move(other._cache_map)),
-    _max_size(other._max_size) {}
+    _max_size(other._max_size),
+    _stats(other._stats) {}
 
   CuFFTParamsLRUCache& operator=(CuFFTParamsLRUCache&& other) noexcept {
     _usage_list = std::move(other._usage_list);
     _cache_map = std::move(other._cache_map);
     _max_size = other._max_size;
+    _stats = other._stats;
     return *this;
   }
 
   // If key is in this cache, return the cached config. Otherwise, emplace the
   // config in this cache using value_args and return it.
-  // Return const reference because CuFFTConfig shouldn't be tampered with once
-  // created.
+  // Return pointer to const because CuFFTConfig shouldn't be tampered with
+  // once created.
   // This is similar to c++ 17 try_emplace.
   template<typename K, class ...VArgs>
-  const CuFFTConfig &try_emplace_value(K&& key, VArgs&&... value_args) {
+  std::shared_ptr<const CuFFTConfig> try_emplace_value(K&& key, VArgs&&... value_args) {
     AT_ASSERT(_max_size > 0);
 
     map_kkv_iter_t map_it = _cache_map.find(key);
     // Hit, put to list front
     if (map_it != _cache_map.end()) {
+      _stats.hits++;
       _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
       return map_it->second->second;
     }
 
-    // Miss
+    // Miss. Create the plan first so that a failing plan creation leaves the
+    // cache untouched.
+    _stats.misses++;
+    auto config = std::make_shared<CuFFTConfig>(std::forward<VArgs>(value_args)...);
+
     // remove if needed
     if (_usage_list.size() >= _max_size) {
       auto last = _usage_list.end();
       last--;
       _cache_map.erase(last->first);
       _usage_list.pop_back();
+      _stats.evictions++;
     }
 
-    // construct new plan at list front, then insert into _cache_map
-    _usage_list.emplace_front(std::piecewise_construct,
-                       std::forward_as_tuple(key),
-                       std::forward_as_tuple(value_args...));
+    // insert new plan at list front, then insert into _cache_map
+    _usage_list.emplace_front(std::forward<K>(key), std::move(config));
     auto kv_it = _usage_list.begin();
     _cache_map.emplace(std::piecewise_construct,
                 std::forward_as_tuple(kv_it->first),
@@ -427,9 +448,11 @@ public:
     return kv_it->second;
   }
 
+  // Also resets the statistics.
   void clear() {
     _cache_map.clear();
     _usage_list.clear();
+    _stats = CuFFTPlanCacheStats();
   }
 
   void resize(int64_t new_size) {
@@ -441,6 +464,7 @@ public:
         delete_it--;
         _cache_map.erase(delete_it->first);
       }
+      _stats.evictions += cur_size - _max_size;
       _usage_list.erase(delete_it, _usage_list.end());
     }
   }
@@ -449,6 +473,8 @@ public:
 
   size_t max_size() const noexcept { return _max_size; }
 
+  CuFFTPlanCacheStats stats() const { return _stats; }
+
   std::mutex mutex;
 
 private:
@@ -467,6 +493,7 @@ private:
   std::list<kv_t> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  CuFFTPlanCacheStats _stats;
 };
 
 // Since ATen is separated into CPU build and CUDA build, we need a way to call
@@ -479,5 +506,8 @@ int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index);
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size);
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index);
 void cufft_clear_plan_cache_impl(int64_t device_index);
+// Hits, misses and evictions of the cache of a device since it was last
+// cleared. Only available from C++.
+CuFFTPlanCacheStats cufft_get_plan_cache_stats_impl(int64_t device_index);
 
 }}} // namespace at::native::detail
@@ -268,6 +268,10 @@ Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indice
     return grad_weight;
   }
 
+  if (use_embedding_backward_atomic(grad.scalar_type(), scale_grad_by_freq, num_indices, num_weights)) {
+    return embedding_backward_cuda_atomic_kernel(grad, indices.contiguous().view(-1), num_weights, padding_idx);
+  }
+
   auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   auto orig_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   using device_ptr = thrust::device_ptr<int64_t>;
@@ -12,6 +12,7 @@
 #include <THC/THCAtomics.cuh>
 
 #include <thrust/execution_policy.h>
+#include <thrust/sort.h>
 #include <thrust/unique.h>
 
 #include <c10/macros/Macros.h>
@@ -179,8 +180,183 @@ __global__ void sum_and_scatter(
   }
 }
 
+// The scale of row i of the indices, and the row of the gradient it reads.
+template <typename scalar_t, typename accscalar_t>
+__device__ __forceinline__ void atomic_grad_row(
+    int64_t i, const int64_t* offset2bag, bool mode_mean, const int64_t* bag_size,
+    const scalar_t* per_sample_weights, int64_t per_sample_weights_stride,
+    int64_t& src_row, accscalar_t& scale) {
+  src_row = offset2bag ? offset2bag[i] : i;
+  scale = 1;
+  if (per_sample_weights) {
+    scale *= static_cast<accscalar_t>(per_sample_weights[i * per_sample_weights_stride]);
+  }
+  if (mode_mean) {
+    scale /= bag_size[src_row];
+  }
+}
+
+// A block handles C10_WARP_SIZE columns of every row of grad_weight in
+// shared memory, where its warps add the rows of their indices. The sums go
+// to grad_weight at the end, one atomic per row and column in every block.
+template <typename scalar_t, typename accscalar_t>
+__global__ void embedding_backward_shared_kernel(
+    const int64_t* indices, const scalar_t* grad, scalar_t* grad_weight,
+    int64_t numel, int64_t stride, int64_t num_weights, int64_t padding_idx,
+    const int64_t* offset2bag, bool mode_mean, const int64_t* bag_size,
+    const scalar_t* per_sample_weights, int64_t per_sample_weights_stride) {
+  extern __shared__ char buf[];
+  accscalar_t* smem = reinterpret_cast<accscalar_t*>(buf);
+  const int tid = threadIdx.x + threadIdx.y * blockDim.x;
+  for (int64_t i = tid; i < num_weights * C10_WARP_SIZE; i += blockDim.x * blockDim.y) {
+    smem[i] = 0;
+  }
+  __syncthreads();
+
+  const int64_t feature = blockIdx.x * C10_WARP_SIZE + threadIdx.x;
+  if (feature < stride) {
+    for (int64_t i = blockIdx.y * blockDim.y + threadIdx.y; i < numel; i += gridDim.y * blockDim.y) {
+      const int64_t row = indices[i];
+      if (row == padding_idx) {
+        continue;
+      }
+      int64_t src_row;
+      accscalar_t scale;
+      atomic_grad_row(i, offset2bag, mode_mean, bag_size, per_sample_weights,
+                      per_sample_weights_stride, src_row, scale);
+      gpuAtomicAdd(&smem[row * C10_WARP_SIZE + threadIdx.x],
+                   static_cast<accscalar_t>(grad[src_row * stride + feature]) * scale);
+    }
+  }
+  __syncthreads();
+
+  if (feature < stride) {
+    for (int64_t row = threadIdx.y; row < num_weights; row += blockDim.y) {
+      const accscalar_t sum = smem[row * C10_WARP_SIZE + threadIdx.x];
+      if (sum != 0) {
+        gpuAtomicAdd(&grad_weight[row * stride + feature], static_cast<scalar_t>(sum));
+      }
+    }
+  }
+}
+
+__device__ __forceinline__ int first_lane(unsigned long long int mask) {
+  return __ffsll(mask) - 1;
+}
+
+__device__ __forceinline__ int first_lane(unsigned int mask) {
+  return __ffs(mask) - 1;
+}
+
+// Every warp takes C10_WARP_SIZE indices at a time, a lane loads each. For
+// every distinct row among them, the lowest lane hitting it leads: the warp
+// sums the rows of the gradient of all the lanes hitting it, C10_WARP_SIZE
+// columns at a time, and adds the sum to grad_weight with one atomic.
+template <typename scalar_t, typename accscalar_t>
+__global__ void embedding_backward_warp_atomic_kernel(
+    const int64_t* indices, const scalar_t* grad, scalar_t* grad_weight,
+    int64_t numel, int64_t stride, int64_t padding_idx,
+    const int64_t* offset2bag, bool mode_mean, const int64_t* bag_size,
+    const scalar_t* per_sample_weights, int64_t per_sample_weights_stride) {
+  const int64_t feature = blockIdx.x * C10_WARP_SIZE + threadIdx.x;
+  const int64_t chunk_stride = static_cast<int64_t>(gridDim.y) * blockDim.y * C10_WARP_SIZE;
+  for (int64_t chunk = (blockIdx.y * blockDim.y + threadIdx.y) * C10_WARP_SIZE; chunk < numel;
+       chunk += chunk_stride) {
+    const int64_t i = chunk + threadIdx.x;
+    const bool valid = i < numel;
+    int64_t lane_row = padding_idx;
+    int64_t lane_src_row = 0;
+    accscalar_t lane_scale = 0;
+    if (valid) {
+      lane_row = indices[i];
+      atomic_grad_row(i, offset2bag, mode_mean, bag_size, per_sample_weights,
+                      per_sample_weights_stride, lane_src_row, lane_scale);
+    }
+    const int n = static_cast<int>(numel - chunk < C10_WARP_SIZE ? numel - chunk : C10_WARP_SIZE);
+    for (int k = 0; k < n; k++) {
+      // row and peers are the same for the whole warp
+      const int64_t row = WARP_SHFL(lane_row, k);
+      auto peers = WARP_BALLOT(valid && lane_row == row);
+      if (first_lane(peers) != k || row == padding_idx) {
+        continue;
+      }
+      accscalar_t sum = 0;
+      while (peers) {
+        const int lane = first_lane(peers);
+        const int64_t src_row = WARP_SHFL(lane_src_row, lane);
+        const accscalar_t scale = WARP_SHFL(lane_scale, lane);
+        if (feature < stride) {
+          sum += static_cast<accscalar_t>(grad[src_row * stride + feature]) * scale;
+        }
+        peers &= peers - 1;
+      }
+      if (feature < stride) {
+        gpuAtomicAdd(&grad_weight[row * stride + feature], static_cast<scalar_t>(sum));
+      }
+    }
+  }
+}
+
 } // anon namespace
 
+Tensor embedding_backward_cuda_atomic_kernel(
+        const Tensor &grad,
+        const Tensor &indices,
+        int64_t num_weights,
+        int padding_idx,
+        bool mode_mean,
+        const Tensor &offset2bag,
+        const Tensor &bag_size,
+        const Tensor &per_sample_weights) {
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const int64_t numel = indices.numel();
+  auto grad_weight = at::zeros({num_weights, grad.size(-1)}, grad.options());
+  const int64_t stride = grad_weight.stride(0);
+  if (numel == 0 || stride == 0) {
+    return grad_weight;
+  }
+
+  constexpr int warps_per_block = 8;
+  const dim3 block(C10_WARP_SIZE, warps_per_block);
+  const int64_t feature_blocks = ceil_div(stride, C10_WARP_SIZE);
+  const int64_t max_blocks = 65535;
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+    grad.scalar_type(), "embedding_backward_cuda_atomic", [&] {
+      AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "embedding_backward_cuda_atomic", [&] {
+        using accscalar_t = acc_type<scalar_t, true>;
+        const int64_t* offset2bag_data = offset2bag.defined() ? offset2bag.data_ptr<int64_t>() : nullptr;
+        const int64_t* bag_size_data = bag_size.defined() ? bag_size.data_ptr<int64_t>() : nullptr;
+        const scalar_t* per_sample_weights_data =
+            per_sample_weights.defined() ? per_sample_weights.data_ptr<scalar_t>() : nullptr;
+        const int64_t per_sample_weights_stride =
+            per_sample_weights.defined() ? per_sample_weights.stride(0) : 0;
+        const size_t smem_bytes = num_weights * C10_WARP_SIZE * sizeof(accscalar_t);
+        if (smem_bytes <= kEmbeddingBackwardMaxSharedMemBytes) {
+          // every block flushes all of its rows, so only take enough blocks
+          // to fill the device
+          const int64_t index_blocks = std::min<int64_t>(
+              ceil_div(numel, warps_per_block),
+              std::max<int64_t>(1, 2 * at::cuda::getCurrentDeviceProperties()->multiProcessorCount / feature_blocks));
+          const dim3 grid(feature_blocks, index_blocks);
+          embedding_backward_shared_kernel<scalar_t, accscalar_t><<<grid, block, smem_bytes, stream>>>(
+              indices.data_ptr<int64_t>(), grad.data_ptr<scalar_t>(), grad_weight.data_ptr<scalar_t>(),
+              numel, stride, num_weights, padding_idx, offset2bag_data, mode_mean, bag_size_data,
+              per_sample_weights_data, per_sample_weights_stride);
+        } else {
+          const dim3 grid(feature_blocks,
+                          std::min<int64_t>(ceil_div(numel, warps_per_block * C10_WARP_SIZE), max_blocks));
+          embedding_backward_warp_atomic_kernel<scalar_t, accscalar_t><<<grid, block, 0, stream>>>(
+              indices.data_ptr<int64_t>(), grad.data_ptr<scalar_t>(), grad_weight.data_ptr<scalar_t>(),
+              numel, stride, padding_idx, offset2bag_data, mode_mean, bag_size_data,
+              per_sample_weights_data, per_sample_weights_stride);
+        }
+        AT_CUDA_CHECK(cudaGetLastError());
+      });
+    });
+  return grad_weight;
+}
+
 Tensor embedding_backward_cuda_kernel(
         const Tensor &grad,
         const Tensor &orig_indices,
@@ -323,4 +499,35 @@ Tensor embedding_backward_cuda_kernel(
   return grad_weight;
 }
 
+Tensor sorted_index_sum_cuda_kernel(
+    const Tensor &index,
+    const Tensor &src,
+    int64_t num_rows) {
+  TORCH_INTERNAL_ASSERT(index.dim() == 1 && src.dim() == 2 && src.is_contiguous());
+  const ptrdiff_t numel = index.numel();
+  if (numel == 0) {
+    return at::zeros({num_rows, src.size(1)}, src.options());
+  }
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(stream);
+  using device_ptr = thrust::device_ptr<int64_t>;
+
+  auto sorted_indices = at::empty_like(index, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto orig_indices = at::empty_like(index, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  sorted_indices.copy_(index);
+
+  // The order of the rows within a segment is the order they are summed in,
+  // so the sort has to be stable to keep the result reproducible.
+  auto count_iter = thrust::counting_iterator<int64_t>(0);
+  auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
+  thrust::copy(policy, count_iter, count_iter + numel, orig_data);
+  auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
+  thrust::stable_sort_by_key(policy, sorted_data, sorted_data + numel, orig_data);
+
+  return embedding_backward_cuda_kernel(
+      src, orig_indices, sorted_indices, /*count=*/Tensor(), num_rows);
+}
+
 }}
@@ -33,4 +33,76 @@ Tensor embedding_backward_cuda_kernel(
     const Tensor &bag_size = Tensor(),
     const Tensor &per_sample_weights = Tensor());
 
+// Sums the rows of the contiguous (n, stride) `src` that share a value of
+// the contiguous 1-d `index` into a (num_rows, stride) tensor. The indices
+// must lie in [0, num_rows). The rows are sorted by index and every output
+// row is reduced in a fixed order in acc_type, so unlike an atomicAdd
+// scatter the result is the same on every run.
+Tensor sorted_index_sum_cuda_kernel(
+    const Tensor &index,
+    const Tensor &src,
+    int64_t num_rows);
+
+// The same gradient as embedding_backward_cuda_kernel, without the count of
+// scale_grad_by_freq, accumulated straight into grad_weight with atomics
+// rather than by sorting the indices. Row i of grad, or row offset2bag[i] for
+// bags, goes to row indices[i]. A block accumulates into shared memory first
+// when the whole grad_weight fits (see kEmbeddingBackwardMaxSharedMemBytes),
+// otherwise every warp sums the rows of its indices that hit the same row of
+// grad_weight, so that hot indices cost one atomic per warp each.
+Tensor embedding_backward_cuda_atomic_kernel(
+    const Tensor &grad,
+    const Tensor &indices,
+    int64_t num_weights,
+    int padding_idx = -1,
+    bool mode_mean = false,
+    const Tensor &offset2bag = Tensor(),
+    const Tensor &bag_size = Tensor(),
+    const Tensor &per_sample_weights = Tensor());
+
+// The most shared memory a block of embedding_backward_cuda_atomic_kernel
+// takes for its accumulators: a warp size of columns of every row of
+// grad_weight
+constexpr int64_t kEmbeddingBackwardMaxSharedMemBytes = 32 * 1024;
+// Beyond this many indices per row of grad_weight on average, sorting them
+// beats colliding atomics
+constexpr int64_t kEmbeddingBackwardMaxAtomicHits = 4;
+
+// The sorting paths are deterministic, so they are kept when deterministic
+// results were requested. Small vocabularies take the shared memory path
+// for all the types, larger ones with few indices per row the warp
+// aggregated atomics, but not for Half whose atomics are emulated.
+inline bool use_embedding_backward_atomic(
+    ScalarType type, bool scale_grad_by_freq, int64_t num_indices, int64_t num_weights) {
+  if (globalContext().deterministic() || scale_grad_by_freq || num_indices == 0) {
+    return false;
+  }
+  const int64_t acc_size = type == kDouble ? sizeof(double) : sizeof(float);
+  if (num_weights * C10_WARP_SIZE * acc_size <= kEmbeddingBackwardMaxSharedMemBytes) {
+    return true;
+  }
+  return (type == kFloat || type == kDouble) &&
+      num_indices <= kEmbeddingBackwardMaxAtomicHits * num_weights;
+}
+
+// index_add_ and scatter_add_ reduce with sorted_index_sum_cuda_kernel
+// rather than atomics when deterministic results were requested, and for
+// Half when there are at least kSortedIndexSumMinHits indices per output
+// row on average: Half atomics are emulated with a compare-and-swap loop
+// that serializes on colliding addresses.
+constexpr int64_t kSortedIndexSumMinHits = 4;
+
+inline bool use_sorted_index_sum(ScalarType type, int64_t num_indices, int64_t num_rows) {
+  const bool supported = type == kFloat || type == kDouble || type == kHalf
+#ifdef __HIP_PLATFORM_HCC__
+      || type == kBFloat16
+#endif
+      ;
+  if (!supported || num_indices == 0) {
+    return false;
+  }
+  return globalContext().deterministic() ||
+      (type == kHalf && num_indices >= kSortedIndexSumMinHits * num_rows);
+}
+
 }}
\ No newline at end of file
@@ -131,6 +131,11 @@ Tensor embedding_bag_backward_cuda_sum_avg(
     return at::zeros({num_weights, grad.size(1)}, grad.options());
   }
 
+  if (use_embedding_backward_atomic(grad.scalar_type(), scale_grad_by_freq, numel, num_weights)) {
+    return embedding_backward_cuda_atomic_kernel(grad, indices, num_weights, /* padding_idx= */ -1,
+        mode == MODE_MEAN, offset2bag, bag_size, per_sample_weights);
+  }
+
   int64_t stride = grad_weight.stride(0);
 
   auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -0,0 +1,72 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op(TensorList tensors1, TensorList tensors2) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    std::vector<at::Tensor> vec_res;
+    for (const auto& t: tensors1) {
+        vec_res.emplace_back(at::native::empty_like(t));
+    }
+
+    tensor_lists.emplace_back(std::move(tensors1.vec()));
+    tensor_lists.emplace_back(std::move(tensors2.vec()));
+    tensor_lists.emplace_back(std::move(vec_res));
+
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kBFloat16, kHalf, tensors1[0].scalar_type(), "foreach_binary_op_list_cuda", [&]() {
+        multi_tensor_apply<3>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 3, /* r_args_depth */ 2, /* res_arg_index */ 2>(),
+                              BinaryOpList<scalar_t, Op>());
+    });
+    return tensor_lists[2];
+}
+
+template<template<class> class Op>
+void foreach_binary_op_(TensorList tensors1, TensorList tensors2) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    tensor_lists.emplace_back(std::move(tensors1.vec()));
+    tensor_lists.emplace_back(std::move(tensors2.vec()));
+
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kBFloat16, kHalf, tensors1[0].scalar_type(), "foreach_binary_op_list_cuda_", [&]() {
+        multi_tensor_apply<2>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 2, /* r_args_depth */ 2, /* res_arg_index */ 0>(),
+                              BinaryOpList<scalar_t, Op>());
+    });
+}
+
+// Both lists share a dtype (see verify_list), so the only promotions are the
+// ones of the op itself: sub rejects boolean tensors and true division turns
+// integral tensors into float ones. Those take the slow route.
+#define FOREACH_BINARY_OP_LIST(NAME, OP, PROMOTES_INTEGER_TO_FLOAT, REJECTS_BOOL)                        \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_cuda(TensorList tensors1, TensorList tensors2) {  \
+    verify_list({tensors1, tensors2});                                                                   \
+    const auto dtype = tensors1[0].scalar_type();                                                        \
+    if (!check_fast_route({tensors1, tensors2}) ||                                                       \
+        (PROMOTES_INTEGER_TO_FLOAT && at::isIntegralType(dtype, /*includeBool*/ true)) ||                \
+        (REJECTS_BOOL && dtype == kBool)) {                                                              \
+        return at::native::foreach_tensor_##NAME##_list_kernel_slow(tensors1, tensors2);                 \
+    }                                                                                                    \
+                                                                                                         \
+    return foreach_binary_op<OP>(tensors1, tensors2);                                                    \
+}                                                                                                        \
+                                                                                                         \
+void foreach_tensor_##NAME##_list_kernel_cuda_(TensorList tensors1, TensorList tensors2) {                \
+    verify_list({tensors1, tensors2});                                                                   \
+    const auto dtype = tensors1[0].scalar_type();                                                        \
+    if (!check_fast_route({tensors1, tensors2}) ||                                                       \
+        (PROMOTES_INTEGER_TO_FLOAT && at::isIntegralType(dtype, /*includeBool*/ true)) ||                \
+        (REJECTS_BOOL && dtype == kBool)) {                                                              \
+        return at::native::foreach_tensor_##NAME##_list_kernel_slow_(tensors1, tensors2);                \
+    }                                                                                                    \
+                                                                                                         \
+    foreach_binary_op_<OP>(tensors1, tensors2);                                                          \
+}
+
+FOREACH_BINARY_OP_LIST(add, AddOp, false, false)
+FOREACH_BINARY_OP_LIST(sub, SubOp, false, true)
+FOREACH_BINARY_OP_LIST(mul, MulOp, false, false)
+FOREACH_BINARY_OP_LIST(div, DivOp, true, false)
+
+}} // namespace at::native
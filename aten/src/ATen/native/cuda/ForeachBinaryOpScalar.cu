@@ -0,0 +1,68 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op(TensorList tensors, Scalar scalar) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    std::vector<at::Tensor> vec_res;
+    for (const auto& t: tensors) {
+        vec_res.emplace_back(at::native::empty_like(t));
+    }
+
+    tensor_lists.emplace_back(std::move(tensors.vec()));
+    tensor_lists.emplace_back(std::move(vec_res));
+
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kBFloat16, kHalf, tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda", [&]() {
+        using opmath_t = acc_type<scalar_t, true>;
+        multi_tensor_apply<2>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 2, /* r_args_depth */ 1, /* res_arg_index */ 1>(),
+                              BinaryOpScalar<scalar_t, Op>{scalar.to<opmath_t>()});
+    });
+    return tensor_lists[1];
+}
+
+template<template<class> class Op>
+void foreach_binary_op_(TensorList tensors, Scalar scalar) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    tensor_lists.emplace_back(std::move(tensors.vec()));
+
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kBFloat16, kHalf, tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda_", [&]() {
+        using opmath_t = acc_type<scalar_t, true>;
+        multi_tensor_apply<1>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 1, /* r_args_depth */ 1, /* res_arg_index */ 0>(),
+                              BinaryOpScalar<scalar_t, Op>{scalar.to<opmath_t>()});
+    });
+}
+
+// sub rejects boolean tensors and true division promotes integral tensors to
+// float, so those cases take the slow route, which raises or promotes the
+// same way the single tensor ops do.
+#define FOREACH_BINARY_OP_SCALAR(NAME, OP, PROMOTES_INTEGER_TO_FLOAT, REJECTS_BOOL)                      \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_cuda(TensorList tensors, Scalar scalar) {       \
+    verify_list(tensors);                                                                                \
+    if (!check_fast_route(tensors, scalar, PROMOTES_INTEGER_TO_FLOAT) ||                                 \
+        (REJECTS_BOOL && tensors[0].scalar_type() == kBool)) {                                           \
+        return at::native::foreach_tensor_##NAME##_scalar_kernel_slow(tensors, scalar);                  \
+    }                                                                                                    \
+                                                                                                         \
+    return foreach_binary_op<OP>(tensors, scalar);                                                       \
+}                                                                                                        \
+                                                                                                         \
+void foreach_tensor_##NAME##_scalar_kernel_cuda_(TensorList tensors, Scalar scalar) {                     \
+    verify_list(tensors);                                                                                \
+    if (!check_fast_route(tensors, scalar, PROMOTES_INTEGER_TO_FLOAT) ||                                 \
+        (REJECTS_BOOL && tensors[0].scalar_type() == kBool)) {                                           \
+        return at::native::foreach_tensor_##NAME##_scalar_kernel_slow_(tensors, scalar);                 \
+    }                                                                                                    \
+                                                                                                         \
+    foreach_binary_op_<OP>(tensors, scalar);                                                             \
+}
+
+FOREACH_BINARY_OP_SCALAR(add, AddOp, false, false)
+FOREACH_BINARY_OP_SCALAR(sub, SubOp, false, true)
+FOREACH_BINARY_OP_SCALAR(mul, MulOp, false, false)
+FOREACH_BINARY_OP_SCALAR(div, DivOp, true, false)
+
+}} // namespace at::native
@@ -1,3 +1,4 @@
+#include <ATen/AccumulateType.h>
 #include <ATen/native/ForeachUtils.h>
 #include <ATen/native/cuda/MultiTensorApply.cuh>
 
@@ -5,122 +6,230 @@ namespace at { namespace native {
 
 namespace {
 
+// Fetches this block's chunk of every list and reports whether all of them
+// can be accessed with vectorized loads and stores.
+template<int depth, typename T>
+__device__ __forceinline__ bool init_args(
+    T** args,
+    TensorListMetadata<depth>& tl,
+    int chunk_idx,
+    int chunk_size,
+    int tensor_loc) {
+        bool all_aligned = true;
+#pragma unroll
+        for (int i = 0; i < depth; i++) {
+            args[i] = (T*)tl.addresses[i][tensor_loc];
+            args[i] += chunk_idx * chunk_size;
+
+            if (!is_aligned(args[i])) {
+                all_aligned = false;
+            }
+        }
+        return all_aligned;
+}
+
+template<int depth, typename T>
+__device__ __forceinline__ void load_args(T r_args[][kILP], T** args, int i_start, int chunk_size, int n) {
+#pragma unroll
+    for(int ii = 0; ii < kILP; ii++) {
+        int i = i_start + threadIdx.x + ii * blockDim.x;
+#pragma unroll
+        for (int r = 0; r < depth; r++) {
+            r_args[r][ii] = 0;
+            if(i < n && i < chunk_size) {
+                r_args[r][ii] = args[r][i];
+            }
+        }
+    }
+}
+
 template<typename T>
-struct AddScalarFunctor_ {
-    __device__ void operator() (
+__device__ __forceinline__ void store_args(T* dst, T* src, int i_start, int chunk_size, int n) {
+#pragma unroll
+    for(int ii = 0; ii < kILP; ii++) {
+        int i = i_start + threadIdx.x + ii * blockDim.x;
+        if(i < n && i < chunk_size) {
+            dst[i] = src[ii];
+        }
+    }
+}
+
+template<typename T, typename Op>
+__device__ __forceinline__ T apply_op(const Op& op, T (&r_args)[1][kILP], int ii) {
+    return op(r_args[0][ii]);
+}
+
+template<typename T, typename Op>
+__device__ __forceinline__ T apply_op(const Op& op, T (&r_args)[2][kILP], int ii) {
+    return op(r_args[0][ii], r_args[1][ii]);
+}
+
+template<typename T, typename Op>
+__device__ __forceinline__ T apply_op(const Op& op, T (&r_args)[3][kILP], int ii) {
+    return op(r_args[0][ii], r_args[1][ii], r_args[2][ii]);
+}
+
+// Computes out = op(in_0, ..., in_{r_args_depth - 1}) elementwise, where the
+// inputs are the first r_args_depth lists of the metadata and the output is
+// list res_arg_index. In-place ops pass res_arg_index == 0 and depth ==
+// r_args_depth; out-of-place ops carry the output as one extra list.
+template<typename T, int depth, int r_args_depth, int res_arg_index>
+struct ElementwiseOpFunctor {
+    template<typename Op>
+    __device__ __forceinline__ void operator() (
         int chunk_size,
-        TensorListMetadata<1>& tl,
-        T scalar) {
+        TensorListMetadata<depth>& tl,
+        Op op) {
             int tensor_loc = tl.block_to_tensor[blockIdx.x];
             int chunk_idx = tl.block_to_chunk[blockIdx.x];
             int n = tl.sizes[tensor_loc];
 
-            T* x = (T*)tl.addresses[0][tensor_loc];
-            x += chunk_idx * chunk_size;
-
+            T* args[depth];
+            bool all_aligned = init_args<depth>(args, tl, chunk_idx, chunk_size, tensor_loc);
             n -= chunk_idx * chunk_size;
 
-            T r_x[kILP];
+            T r_args[r_args_depth][kILP];
 
             // to make things simple, we put aligned case in a different code path
-            if(n % kILP == 0 && chunk_size % kILP == 0 && is_aligned(x)) {
+            if(n % kILP == 0 && chunk_size % kILP == 0 && all_aligned) {
                 for(int i_start = threadIdx.x; i_start * kILP < n && i_start * kILP < chunk_size; i_start += blockDim.x) {
                     // load
-                    load_store(r_x, x, 0 , i_start);
+#pragma unroll
+                    for (int r = 0; r < r_args_depth; r++) {
+                        load_store(r_args[r], args[r], 0, i_start);
+                    }
 #pragma unroll
                     for(int ii = 0; ii < kILP; ii++) {
-                        r_x[ii] = static_cast<T>(r_x[ii]) + scalar;
+                        r_args[0][ii] = apply_op(op, r_args, ii);
                     }
                     // store
-                    load_store(x, r_x, i_start, 0);
+                    load_store(args[res_arg_index], r_args[0], i_start, 0);
                 }
             }
             else {
                 // Non-divergent exit condition for __syncthreads, not necessary here
                 for(int i_start = 0; i_start < n && i_start < chunk_size; i_start += blockDim.x * kILP) {
+                    load_args<r_args_depth>(r_args, args, i_start, chunk_size, n);
 #pragma unroll
                     for(int ii = 0; ii < kILP; ii++) {
-                        r_x[ii] = 0;
-                        int i = i_start + threadIdx.x + ii * blockDim.x;
-                        if(i < n && i < chunk_size) {
-                            r_x[ii] = x[i];
-                        }
-                    }
-#pragma unroll
-                    for(int ii = 0; ii < kILP; ii++) {
-                        r_x[ii] = static_cast<T>(r_x[ii]) + scalar;
-                    }
-#pragma unroll
-                    for(int ii = 0; ii < kILP; ii++) {
-                        int i = i_start + threadIdx.x + ii * blockDim.x;
-                        if(i < n && i < chunk_size)
-                            x[i] = r_x[ii];
+                        r_args[0][ii] = apply_op(op, r_args, ii);
                     }
+                    store_args(args[res_arg_index], r_args[0], i_start, chunk_size, n);
                 }
             }
         }
 };
 
-template<typename T>
-struct AddScalarFunctor {
-    __device__ void operator() (
+// Loads every list, lets op update the registers of one element in place
+// and writes back the lists whose bit is set in store_mask. This is what the
+// fused optimizer steps use: the gradients are read only while parameters
+// and optimizer state are both read and written.
+template<typename T, int depth, int store_mask>
+struct UpdateFunctor {
+    template<typename Op>
+    __device__ __forceinline__ void operator() (
         int chunk_size,
-        TensorListMetadata<2>& tl,
-        T scalar) {
+        TensorListMetadata<depth>& tl,
+        Op op) {
             int tensor_loc = tl.block_to_tensor[blockIdx.x];
             int chunk_idx = tl.block_to_chunk[blockIdx.x];
             int n = tl.sizes[tensor_loc];
 
-            T* x = (T*)tl.addresses[0][tensor_loc];
-            x += chunk_idx * chunk_size;
-
-            T* out = (T*)tl.addresses[1][tensor_loc];
-            out += chunk_idx * chunk_size;
-
+            T* args[depth];
+            bool all_aligned = init_args<depth>(args, tl, chunk_idx, chunk_size, tensor_loc);
             n -= chunk_idx * chunk_size;
 
-            T r_x[kILP];
-            T r_out[kILP];
+            T r_args[depth][kILP];
 
-            // to make things simple, we put aligned case in a different code path
-            if(n % kILP == 0 && chunk_size % kILP == 0 && is_aligned(x) && is_aligned(out)) {
+            if(n % kILP == 0 && chunk_size % kILP == 0 && all_aligned) {
                 for(int i_start = threadIdx.x; i_start * kILP < n && i_start * kILP < chunk_size; i_start += blockDim.x) {
-                    // load
-                    load_store(r_x, x, 0 , i_start);
+#pragma unroll
+                    for (int r = 0; r < depth; r++) {
+                        load_store(r_args[r], args[r], 0, i_start);
+                    }
 #pragma unroll
                     for(int ii = 0; ii < kILP; ii++) {
-                        r_out[ii] = static_cast<T>(r_x[ii]) + scalar;
+                        op(r_args, ii);
+                    }
+#pragma unroll
+                    for (int r = 0; r < depth; r++) {
+                        if (store_mask & (1 << r)) {
+                            load_store(args[r], r_args[r], i_start, 0);
+                        }
                     }
-                    // store
-                    load_store(out, r_out, i_start, 0);
                 }
             }
             else {
-                // Non-divergent exit condition for __syncthreads, not necessary here
                 for(int i_start = 0; i_start < n && i_start < chunk_size; i_start += blockDim.x * kILP) {
+                    load_args<depth>(r_args, args, i_start, chunk_size, n);
 #pragma unroll
                     for(int ii = 0; ii < kILP; ii++) {
-                        r_x[ii] = 0;
-                        int i = i_start + threadIdx.x + ii * blockDim.x;
-                        if(i < n && i < chunk_size) {
-                            r_x[ii] = x[i];
-                        }
-                    }
-#pragma unroll
-                    for(int ii = 0; ii < kILP; ii++) {
-                        r_out[ii] = static_cast<T>(r_x[ii]) + scalar;
+                        op(r_args, ii);
                     }
 #pragma unroll
-                    for(int ii = 0; ii < kILP; ii++) {
-                        int i = i_start + threadIdx.x + ii * blockDim.x;
-                        if(i < n && i < chunk_size)
-                            out[i] = r_out[ii];
+                    for (int r = 0; r < depth; r++) {
+                        if (store_mask & (1 << r)) {
+                            store_args(args[r], r_args[r], i_start, chunk_size, n);
+                        }
                     }
                 }
             }
         }
 };
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Elementwise ops ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Applied to single elements by the functors above. Reduced precision types
+// are computed in their accumulate type and rounded once on the way out.
+
+template<typename T> struct AddOp { __device__ __forceinline__ T operator()(T a, T b) const { return a + b; } };
+template<typename T> struct SubOp { __device__ __forceinline__ T operator()(T a, T b) const { return a - b; } };
+template<typename T> struct MulOp { __device__ __forceinline__ T operator()(T a, T b) const { return a * b; } };
+template<typename T> struct DivOp { __device__ __forceinline__ T operator()(T a, T b) const { return a / b; } };
+
+template<typename T, template<typename> class Op>
+struct BinaryOpScalar {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    opmath_t scalar;
+
+    __device__ __forceinline__ T operator()(T a) const {
+        return static_cast<T>(Op<opmath_t>()(static_cast<opmath_t>(a), scalar));
+    }
+};
+
+template<typename T, template<typename> class Op>
+struct BinaryOpList {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+
+    __device__ __forceinline__ T operator()(T a, T b) const {
+        return static_cast<T>(Op<opmath_t>()(static_cast<opmath_t>(a), static_cast<opmath_t>(b)));
+    }
+};
+
+template<typename T> struct SqrtOp { __device__ __forceinline__ T operator()(T a) const { return ::sqrt(a); } };
+template<typename T> struct ExpOp { __device__ __forceinline__ T operator()(T a) const { return ::exp(a); } };
+
+template<typename T, template<typename> class Op>
+struct UnaryOp {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+
+    __device__ __forceinline__ T operator()(T a) const {
+        return static_cast<T>(Op<opmath_t>()(static_cast<opmath_t>(a)));
+    }
+};
+
+// input + value * op(tensor1, tensor2), i.e. addcmul with MulOp and addcdiv
+// with DivOp.
+template<typename T, template<typename> class Op>
+struct PointwiseOp {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    opmath_t value;
+
+    __device__ __forceinline__ T operator()(T a, T b, T c) const {
+        return static_cast<T>(static_cast<opmath_t>(a) +
+            value * Op<opmath_t>()(static_cast<opmath_t>(b), static_cast<opmath_t>(c)));
+    }
+};
+
 } // namespace
 
 }} // namespace at::native
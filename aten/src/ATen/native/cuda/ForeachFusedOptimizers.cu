@@ -0,0 +1,166 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+// One Adam step on one element, see fused_adam_slow_ for the reference.
+// r_args holds param, grad, exp_avg and exp_avg_sq in that order.
+template<typename T>
+struct AdamOp {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    opmath_t lr;
+    opmath_t beta1;
+    opmath_t beta2;
+    opmath_t weight_decay;
+    opmath_t eps;
+    opmath_t bias_correction1;
+    opmath_t bias_correction2_sqrt;
+
+    __device__ __forceinline__ void operator()(T (&r_args)[4][kILP], int ii) const {
+        const opmath_t param = static_cast<opmath_t>(r_args[0][ii]);
+        const opmath_t grad = static_cast<opmath_t>(r_args[1][ii]) + weight_decay * param;
+        const opmath_t exp_avg = beta1 * static_cast<opmath_t>(r_args[2][ii]) + (1 - beta1) * grad;
+        const opmath_t exp_avg_sq = beta2 * static_cast<opmath_t>(r_args[3][ii]) + (1 - beta2) * grad * grad;
+        const opmath_t denom = ::sqrt(exp_avg_sq) / bias_correction2_sqrt + eps;
+        r_args[0][ii] = static_cast<T>(param - (lr / bias_correction1) * exp_avg / denom);
+        r_args[2][ii] = static_cast<T>(exp_avg);
+        r_args[3][ii] = static_cast<T>(exp_avg_sq);
+    }
+};
+
+// r_args holds param and grad.
+template<typename T>
+struct SGDOp {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    opmath_t lr;
+    opmath_t weight_decay;
+
+    __device__ __forceinline__ void operator()(T (&r_args)[2][kILP], int ii) const {
+        const opmath_t param = static_cast<opmath_t>(r_args[0][ii]);
+        const opmath_t d_p = static_cast<opmath_t>(r_args[1][ii]) + weight_decay * param;
+        r_args[0][ii] = static_cast<T>(param - lr * d_p);
+    }
+};
+
+// r_args holds param, grad and momentum_buffer.
+template<typename T>
+struct SGDMomentumOp {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    opmath_t lr;
+    opmath_t weight_decay;
+    opmath_t momentum;
+    opmath_t dampening;
+    bool nesterov;
+    bool first_run;
+
+    __device__ __forceinline__ void operator()(T (&r_args)[3][kILP], int ii) const {
+        const opmath_t param = static_cast<opmath_t>(r_args[0][ii]);
+        opmath_t d_p = static_cast<opmath_t>(r_args[1][ii]) + weight_decay * param;
+        const opmath_t buf = first_run
+            ? d_p
+            : momentum * static_cast<opmath_t>(r_args[2][ii]) + (1 - dampening) * d_p;
+        d_p = nesterov ? d_p + momentum * buf : buf;
+        r_args[0][ii] = static_cast<T>(param - lr * d_p);
+        r_args[2][ii] = static_cast<T>(buf);
+    }
+};
+
+} // namespace
+
+void fused_adam_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    int64_t step) {
+    verify_list({params, grads, exp_avgs, exp_avg_sqs});
+    TORCH_CHECK(step > 0, "_fused_adam_: expected step to be positive, got ", step);
+
+    if (!check_fast_route({params, grads, exp_avgs, exp_avg_sqs}) || !at::isFloatingType(params[0].scalar_type())) {
+        return at::native::fused_adam_slow_(
+            params, grads, exp_avgs, exp_avg_sqs, lr, beta1, beta2, weight_decay, eps, step);
+    }
+
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    tensor_lists.emplace_back(std::move(params.vec()));
+    tensor_lists.emplace_back(std::move(grads.vec()));
+    tensor_lists.emplace_back(std::move(exp_avgs.vec()));
+    tensor_lists.emplace_back(std::move(exp_avg_sqs.vec()));
+
+    // The bias corrections only depend on the step, compute them once on the host.
+    const double bias_correction1 = 1 - std::pow(beta1, step);
+    const double bias_correction2_sqrt = std::sqrt(1 - std::pow(beta2, step));
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, params[0].scalar_type(), "fused_adam_cuda_", [&]() {
+        using opmath_t = acc_type<scalar_t, true>;
+        AdamOp<scalar_t> op{
+            static_cast<opmath_t>(lr),
+            static_cast<opmath_t>(beta1),
+            static_cast<opmath_t>(beta2),
+            static_cast<opmath_t>(weight_decay),
+            static_cast<opmath_t>(eps),
+            static_cast<opmath_t>(bias_correction1),
+            static_cast<opmath_t>(bias_correction2_sqrt)};
+        // params, exp_avgs and exp_avg_sqs are written back, grads are not.
+        multi_tensor_apply<4>(tensor_lists, UpdateFunctor<scalar_t, /* depth */ 4, /* store_mask */ 0b1101>(), op);
+    });
+}
+
+void fused_sgd_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool first_run) {
+    if (momentum != 0) {
+        verify_list({params, grads, momentum_buffers});
+    } else {
+        verify_list({params, grads});
+    }
+    TORCH_CHECK(!nesterov || (momentum > 0 && dampening == 0),
+                "_fused_sgd_: nesterov momentum requires a momentum and zero dampening");
+
+    const bool fast_route = momentum != 0
+        ? check_fast_route({params, grads, momentum_buffers})
+        : check_fast_route({params, grads});
+    if (!fast_route || !at::isFloatingType(params[0].scalar_type())) {
+        return at::native::fused_sgd_slow_(
+            params, grads, momentum_buffers, lr, momentum, dampening, weight_decay, nesterov, first_run);
+    }
+
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    tensor_lists.emplace_back(std::move(params.vec()));
+    tensor_lists.emplace_back(std::move(grads.vec()));
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, params[0].scalar_type(), "fused_sgd_cuda_", [&]() {
+        using opmath_t = acc_type<scalar_t, true>;
+        if (momentum != 0) {
+            tensor_lists.emplace_back(momentum_buffers.vec());
+            SGDMomentumOp<scalar_t> op{
+                static_cast<opmath_t>(lr),
+                static_cast<opmath_t>(weight_decay),
+                static_cast<opmath_t>(momentum),
+                static_cast<opmath_t>(dampening),
+                nesterov,
+                first_run};
+            // params and momentum_buffers are written back, grads are not.
+            multi_tensor_apply<3>(tensor_lists, UpdateFunctor<scalar_t, /* depth */ 3, /* store_mask */ 0b101>(), op);
+        } else {
+            SGDOp<scalar_t> op{static_cast<opmath_t>(lr), static_cast<opmath_t>(weight_decay)};
+            multi_tensor_apply<2>(tensor_lists, UpdateFunctor<scalar_t, /* depth */ 2, /* store_mask */ 0b01>(), op);
+        }
+    });
+}
+
+}} // namespace at::native
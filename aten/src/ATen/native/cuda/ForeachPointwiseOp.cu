@@ -0,0 +1,69 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_pointwise_op(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    std::vector<at::Tensor> vec_res;
+    for (const auto& t: input) {
+        vec_res.emplace_back(at::native::empty_like(t));
+    }
+
+    tensor_lists.emplace_back(std::move(input.vec()));
+    tensor_lists.emplace_back(std::move(tensors1.vec()));
+    tensor_lists.emplace_back(std::move(tensors2.vec()));
+    tensor_lists.emplace_back(std::move(vec_res));
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, input[0].scalar_type(), "foreach_pointwise_op_cuda", [&]() {
+        using opmath_t = acc_type<scalar_t, true>;
+        multi_tensor_apply<4>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 4, /* r_args_depth */ 3, /* res_arg_index */ 3>(),
+                              PointwiseOp<scalar_t, Op>{scalar.to<opmath_t>()});
+    });
+    return tensor_lists[3];
+}
+
+template<template<class> class Op>
+void foreach_pointwise_op_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    tensor_lists.emplace_back(std::move(input.vec()));
+    tensor_lists.emplace_back(std::move(tensors1.vec()));
+    tensor_lists.emplace_back(std::move(tensors2.vec()));
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, input[0].scalar_type(), "foreach_pointwise_op_cuda_", [&]() {
+        using opmath_t = acc_type<scalar_t, true>;
+        multi_tensor_apply<3>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 3, /* r_args_depth */ 3, /* res_arg_index */ 0>(),
+                              PointwiseOp<scalar_t, Op>{scalar.to<opmath_t>()});
+    });
+}
+
+// Only floating point lists take the fast route; integral addcdiv is an
+// error and the rest match the single tensor ops through the slow route.
+#define FOREACH_POINTWISE_OP(NAME, OP)                                                                   \
+std::vector<Tensor> foreach_tensor_##NAME##_cuda(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+    verify_list({input, tensors1, tensors2});                                                            \
+    if (!check_fast_route({input, tensors1, tensors2}) ||                                                \
+        !at::isFloatingType(input[0].scalar_type()) || scalar.isComplex()) {                             \
+        return at::native::foreach_tensor_##NAME##_slow(input, tensors1, tensors2, scalar);              \
+    }                                                                                                    \
+                                                                                                         \
+    return foreach_pointwise_op<OP>(input, tensors1, tensors2, scalar);                                  \
+}                                                                                                        \
+                                                                                                         \
+void foreach_tensor_##NAME##_cuda_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+    verify_list({input, tensors1, tensors2});                                                            \
+    if (!check_fast_route({input, tensors1, tensors2}) ||                                                \
+        !at::isFloatingType(input[0].scalar_type()) || scalar.isComplex()) {                             \
+        return at::native::foreach_tensor_##NAME##_slow_(input, tensors1, tensors2, scalar);             \
+    }                                                                                                    \
+                                                                                                         \
+    foreach_pointwise_op_<OP>(input, tensors1, tensors2, scalar);                                        \
+}
+
+FOREACH_POINTWISE_OP(addcmul, MulOp)
+FOREACH_POINTWISE_OP(addcdiv, DivOp)
+
+}} // namespace at::native
@@ -0,0 +1,61 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_unary_op(TensorList tensors) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    std::vector<at::Tensor> vec_res;
+    for (const auto& t: tensors) {
+        vec_res.emplace_back(at::native::empty_like(t));
+    }
+
+    tensor_lists.emplace_back(std::move(tensors.vec()));
+    tensor_lists.emplace_back(std::move(vec_res));
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, tensors[0].scalar_type(), "foreach_unary_op_cuda", [&]() {
+        multi_tensor_apply<2>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 2, /* r_args_depth */ 1, /* res_arg_index */ 1>(),
+                              UnaryOp<scalar_t, Op>());
+    });
+    return tensor_lists[1];
+}
+
+template<template<class> class Op>
+void foreach_unary_op_(TensorList tensors) {
+    std::vector<std::vector<at::Tensor>> tensor_lists;
+    tensor_lists.emplace_back(std::move(tensors.vec()));
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, tensors[0].scalar_type(), "foreach_unary_op_cuda_", [&]() {
+        multi_tensor_apply<1>(tensor_lists,
+                              ElementwiseOpFunctor<scalar_t, /* depth */ 1, /* r_args_depth */ 1, /* res_arg_index */ 0>(),
+                              UnaryOp<scalar_t, Op>());
+    });
+}
+
+// Integral tensors are promoted to float and complex ones use their own
+// math, both are left to the slow route.
+#define FOREACH_UNARY_OP(NAME, OP)                                                                       \
+std::vector<Tensor> foreach_tensor_##NAME##_cuda(TensorList tensors) {                                   \
+    verify_list(tensors);                                                                                \
+    if (!check_fast_route({tensors}) || !at::isFloatingType(tensors[0].scalar_type())) {                 \
+        return at::native::foreach_tensor_##NAME##_slow(tensors);                                        \
+    }                                                                                                    \
+                                                                                                         \
+    return foreach_unary_op<OP>(tensors);                                                                \
+}                                                                                                        \
+                                                                                                         \
+void foreach_tensor_##NAME##_cuda_(TensorList tensors) {                                                 \
+    verify_list(tensors);                                                                                \
+    if (!check_fast_route({tensors}) || !at::isFloatingType(tensors[0].scalar_type())) {                 \
+        return at::native::foreach_tensor_##NAME##_slow_(tensors);                                       \
+    }                                                                                                    \
+                                                                                                         \
+    foreach_unary_op_<OP>(tensors);                                                                      \
+}
+
+FOREACH_UNARY_OP(sqrt, SqrtOp)
+FOREACH_UNARY_OP(exp, ExpOp)
+
+}} // namespace at::native
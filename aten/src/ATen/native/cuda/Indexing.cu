@@ -1,5 +1,6 @@
 #include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/native/IndexingUtils.h>
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
@@ -426,8 +427,6 @@ bool indexShouldBeMajor(cuda::detail::TensorInfo<scalar_t, unsigned int> &info,
 }
 
 Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
-  // Nondeterministic because of atomicAdd usage
-  globalContext().alertNotDeterministic("index_add_cuda_");
   dim = maybe_wrap_dim(dim, self.dim());
 
   TensorArg self_arg{self, "self", 1}, index_arg{index, "index", 3}, source_arg{source, "source", 4};
@@ -467,6 +466,34 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   if (sliceSize == 0) {
     return self;
   }
+
+  if (use_sorted_index_sum(self.scalar_type(), numIndex, selfAddDimSize)) {
+    // Sum the source slices of every destination slice in a fixed order and
+    // add the sums to self in one pass.
+    TORCH_CHECK_INDEX(index.min().item<int64_t>() >= 0 &&
+                      index.max().item<int64_t>() < selfAddDimSize,
+                      "index_add_(): index out of range for self of size ", selfAddDimSize,
+                      " at dimension ", dim);
+    // Move dim to the front keeping the order of the other dims, so that
+    // slices are flattened the same way as in the kernels below.
+    auto dim_first = [dim](const Tensor& t) {
+      std::vector<int64_t> perm{dim};
+      for (int64_t d = 0; d < t.dim(); d++) {
+        if (d != dim) {
+          perm.push_back(d);
+        }
+      }
+      return t.permute(perm);
+    };
+    Tensor self_t = dim_first(self_);
+    Tensor source_rows = dim_first(source_).contiguous().view({numIndex, sliceSize});
+    Tensor sums = sorted_index_sum_cuda_kernel(index.reshape(-1), source_rows, selfAddDimSize);
+    self_t.add_(sums.view(self_t.sizes()));
+    return self;
+  }
+
+  // Nondeterministic because of atomicAdd usage
+  globalContext().alertNotDeterministic("index_add_cuda_");
   const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
   bool indContig = index.is_contiguous();
 
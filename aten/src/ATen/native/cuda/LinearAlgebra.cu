@@ -2,6 +2,10 @@
 #include <ATen/LegacyTHFunctionsCUDA.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/cuda/CUDABlas.h>
+#include <ATen/cuda/CUDAContext.h>
+
+#include <map>
+#include <tuple>
 
 namespace at { namespace native {
 
@@ -173,6 +177,61 @@ Tensor& addmm__cuda(Tensor& self, const Tensor& mat1, const Tensor& mat2,
   return self;
 }
 
+// The bias, and the activation if it is relu, go to the epilogue of a cuBLASLt
+// gemm when the bias is a contiguous vector broadcast over the rows, which is
+// the case of linear layers, and beta is 1; otherwise this is addmm followed
+// by the activation. gelu always is a separate kernel, as the one of cuBLASLt
+// is only the tanh approximation.
+Tensor addmm_activation_cuda(const Tensor& self, const Tensor& mat1, const Tensor& mat2,
+                             Scalar beta, Scalar alpha, bool use_gelu) {
+  TORCH_CHECK(mat1.dim() == 2 && mat2.dim() == 2, "tensors must be 2-D");
+  TORCH_CHECK(mat1.size(1) == mat2.size(0), "mat1 dim 1 must match mat2 dim 0");
+  TensorArg args[]{{self, "self", 0}, {mat1, "mat1", 1}, {mat2, "mat2", 2}};
+  checkAllSameGPU("_addmm_activation", args);
+  const auto activation = use_gelu
+      ? at::cuda::blas::GEMMAndBiasActivationEpilogue::None
+      : at::cuda::blas::GEMMAndBiasActivationEpilogue::RELU;
+  const auto scalar_type = mat1.scalar_type();
+  const bool use_epilogue = at::cuda::blas::gemm_and_bias_available() &&
+      (scalar_type == kDouble || scalar_type == kFloat ||
+       scalar_type == kHalf || scalar_type == kBFloat16) &&
+      mat2.scalar_type() == scalar_type && self.scalar_type() == scalar_type &&
+      self.dim() == 1 && self.size(0) == mat2.size(1) && self.stride(0) == 1 &&
+      beta.to<double>() == 1.0 &&
+      mat1.size(0) > 0 && mat1.size(1) > 0 && mat2.size(1) > 0;
+  if (!use_epilogue) {
+    Tensor result = addmm_cuda(self, mat1, mat2, beta, alpha);
+    return use_gelu ? at::gelu(result) : at::relu_(result);
+  }
+
+  // The result is row major, so compute its column major transpose
+  // mat2^T @ mat1^T, whose rows get the bias.
+  Tensor result = at::empty({mat1.size(0), mat2.size(1)}, mat1.options());
+  Tensor mat1_ = mat1;
+  Tensor mat2_ = mat2;
+  bool row_major_mat1;
+  bool row_major_mat2;
+  mat1_ = prepare_matrix_for_cublas(mat1_, row_major_mat1);
+  mat2_ = prepare_matrix_for_cublas(mat2_, row_major_mat2);
+  const int64_t m = mat2.size(1);
+  const int64_t n = mat1.size(0);
+  const int64_t k = mat1.size(1);
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, scalar_type, "addmm_activation_cuda", [&] {
+    at::cuda::blas::gemm_and_bias<scalar_t>(
+      row_major_mat2 ? 'n' : 't',
+      row_major_mat1 ? 'n' : 't',
+      m, n, k,
+      alpha.to<scalar_t>(),
+      mat2_.data_ptr<scalar_t>(), mat2_.stride(row_major_mat2 ? 0 : 1),
+      mat1_.data_ptr<scalar_t>(), mat1_.stride(row_major_mat1 ? 0 : 1),
+      self.data_ptr<scalar_t>(),
+      result.data_ptr<scalar_t>(), m,
+      activation
+    );
+  });
+  return use_gelu ? at::gelu(result) : result;
+}
+
 template<typename scalar_t>
 void addr_impl_ger_cuda(Tensor &out, const Tensor &self,
                         const Tensor& vec1, const Tensor& vec2,
@@ -352,6 +411,143 @@ Tensor addbmm_cuda(const Tensor& self,
   return out;
 }
 
+namespace {
+
+// Describes a row-major matrix as a cuBLAS operand holding its transpose, see
+// addmm_out_cuda_impl: cuBLAS computes C^T = B^T A^T for row-major C = A B.
+struct GroupedGemmOperand {
+  Tensor tensor;
+  char trans;
+  int64_t ld;
+};
+
+GroupedGemmOperand prepare_grouped_gemm_operand(const Tensor& tensor) {
+  const int64_t rows = tensor.size(0);
+  const int64_t cols = tensor.size(1);
+  if (tensor.stride(1) == 1 && tensor.stride(0) >= std::max<int64_t>(1, cols)) {
+    return {tensor, 'n', tensor.stride(0)};
+  } else if (tensor.stride(0) == 1 && tensor.stride(1) >= std::max<int64_t>(1, rows)) {
+    return {tensor, 't', tensor.stride(1)};
+  }
+  return {tensor.contiguous(), 'n', std::max<int64_t>(1, cols)};
+}
+
+// gemms that can share a single batched cuBLAS call
+using GroupedGemmKey = std::tuple<int64_t, int64_t, int64_t, char, char, int64_t, int64_t>;
+
+} // anonymous namespace
+
+// Multiplies every pair self[i] @ mat2[i]. The pairs are bucketed by shape and
+// layout and every bucket is computed by one batched cuBLAS call, the matrix
+// pointers of all buckets going to the device in a single copy. Workloads
+// whose pairs share a few distinct shapes, such as the experts of a
+// mixture-of-experts layer or per-table projections, hence run in a few
+// launches instead of one per pair.
+std::vector<Tensor> _grouped_mm_cuda(TensorList self, TensorList mat2) {
+  TORCH_CHECK(self.size() == mat2.size(),
+              "_grouped_mm: expected the same number of tensors in self and mat2, got ",
+              self.size(), " and ", mat2.size());
+  std::vector<Tensor> result;
+  result.reserve(self.size());
+  if (self.empty()) {
+    return result;
+  }
+
+  const auto scalar_type = self[0].scalar_type();
+  for (size_t i = 0; i < self.size(); i++) {
+    TORCH_CHECK(self[i].dim() == 2 && mat2[i].dim() == 2,
+                "_grouped_mm: expected 2-D tensors, got ", self[i].dim(), "-D and ",
+                mat2[i].dim(), "-D tensors for pair ", i);
+    TORCH_CHECK(self[i].size(1) == mat2[i].size(0),
+                "_grouped_mm: size mismatch for pair ", i, ", got ",
+                self[i].sizes(), " and ", mat2[i].sizes());
+    TORCH_CHECK(self[i].scalar_type() == scalar_type && mat2[i].scalar_type() == scalar_type,
+                "_grouped_mm: expected all tensors to have dtype ", scalar_type);
+    TORCH_CHECK(self[i].is_cuda() && mat2[i].is_cuda() &&
+                self[i].device() == self[0].device() && mat2[i].device() == self[0].device(),
+                "_grouped_mm: expected all tensors to be on ", self[0].device());
+  }
+
+  bool use_batched = scalar_type == kFloat || scalar_type == kDouble ||
+      (scalar_type == kHalf && at::cuda::getCurrentDeviceProperties()->major >= 5);
+#ifdef __HIP_PLATFORM_HCC__
+  use_batched = false;
+#endif
+  if (!use_batched) {
+    for (size_t i = 0; i < self.size(); i++) {
+      result.push_back(at::mm(self[i], mat2[i]));
+    }
+    return result;
+  }
+
+  std::map<GroupedGemmKey, std::vector<size_t>> groups;
+  std::vector<GroupedGemmOperand> a_ops;
+  std::vector<GroupedGemmOperand> b_ops;
+  a_ops.reserve(self.size());
+  b_ops.reserve(self.size());
+  for (size_t i = 0; i < self.size(); i++) {
+    const int64_t m = self[i].size(0);
+    const int64_t k = self[i].size(1);
+    const int64_t n = mat2[i].size(1);
+    if (m == 0 || n == 0 || k == 0) {
+      result.push_back(at::zeros({m, n}, self[i].options()));
+      a_ops.push_back({});
+      b_ops.push_back({});
+      continue;
+    }
+    result.push_back(at::empty({m, n}, self[i].options()));
+    a_ops.push_back(prepare_grouped_gemm_operand(self[i]));
+    b_ops.push_back(prepare_grouped_gemm_operand(mat2[i]));
+    groups[GroupedGemmKey(m, n, k, a_ops[i].trans, b_ops[i].trans, a_ops[i].ld, b_ops[i].ld)]
+        .push_back(i);
+  }
+  if (groups.empty()) {
+    return result;
+  }
+
+  // Pointer arrays of all groups, a, b then c for each group in turn.
+  int64_t num_gemms = 0;
+  for (const auto& group : groups) {
+    num_gemms += group.second.size();
+  }
+  Tensor host_ptrs = at::empty({3 * num_gemms}, at::TensorOptions(kCPU).dtype(kLong).pinned_memory(true));
+  int64_t* host_ptrs_data = host_ptrs.data_ptr<int64_t>();
+  int64_t pos = 0;
+  for (const auto& group : groups) {
+    for (size_t i : group.second) {
+      host_ptrs_data[pos++] = reinterpret_cast<int64_t>(a_ops[i].tensor.data_ptr());
+    }
+    for (size_t i : group.second) {
+      host_ptrs_data[pos++] = reinterpret_cast<int64_t>(b_ops[i].tensor.data_ptr());
+    }
+    for (size_t i : group.second) {
+      host_ptrs_data[pos++] = reinterpret_cast<int64_t>(result[i].data_ptr());
+    }
+  }
+  Tensor dev_ptrs = host_ptrs.to(self[0].device(), /*non_blocking=*/true);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(scalar_type, "_grouped_mm_cuda", [&] {
+    auto ptrs = reinterpret_cast<scalar_t**>(dev_ptrs.data_ptr<int64_t>());
+    for (const auto& group : groups) {
+      int64_t m, n, k, lda, ldb;
+      char transa, transb;
+      std::tie(m, n, k, transa, transb, lda, ldb) = group.first;
+      const int64_t count = group.second.size();
+      // C^T (n x m) = B^T (n x k) A^T (k x m)
+      at::cuda::blas::gemm_batched<scalar_t>(
+          transb, transa, n, m, k,
+          scalar_t(1),
+          ptrs + count, ldb,
+          ptrs, lda,
+          scalar_t(0),
+          ptrs + 2 * count, n,
+          count);
+      ptrs += 3 * count;
+    }
+  });
+  return result;
+}
+
 Tensor dot_cuda(const Tensor& self, const Tensor& other) {
   at::NoNamesGuard guard;
 
@@ -19,8 +19,8 @@ constexpr int block_work_size = BLOCK_WORK_SIZE;
 
 namespace at { namespace native {
 
-template<int N>
-static OffsetCalculator<N> make_input_offset_calculator(const TensorIterator& iter) {
+template<int N, typename index_t = uint32_t>
+static OffsetCalculator<N, index_t> make_input_offset_calculator(const TensorIterator& iter) {
   // array size can not be 0, this happens when N == 0
   constexpr int array_size = std::max<int>(N, 1);
   TORCH_INTERNAL_ASSERT(N == iter.ntensors() - iter.noutputs());
@@ -30,11 +30,11 @@ static OffsetCalculator<N> make_input_offset_calculator(const TensorIterator& it
     strides[i] = iter.strides(i + iter.noutputs()).data();
     element_sizes[i] = iter.element_size(i + iter.noutputs());
   }
-  return OffsetCalculator<N>(iter.ndim(), iter.shape().data(), strides.data(), element_sizes);
+  return OffsetCalculator<N, index_t>(iter.ndim(), iter.shape().data(), strides.data(), element_sizes);
 }
 
-template <int num_outputs = 1>
-static OffsetCalculator<num_outputs> make_output_offset_calculator(const TensorIterator& iter) {
+template <int num_outputs = 1, typename index_t = uint32_t>
+static OffsetCalculator<num_outputs, index_t> make_output_offset_calculator(const TensorIterator& iter) {
   TORCH_INTERNAL_ASSERT(num_outputs == iter.noutputs());
   std::array<const int64_t*, num_outputs> strides;
   int64_t element_sizes[num_outputs];
@@ -42,17 +42,17 @@ static OffsetCalculator<num_outputs> make_output_offset_calculator(const TensorI
     strides[i] = iter.strides(i).data();
     element_sizes[i] = iter.element_size(i);
   }
-  return OffsetCalculator<num_outputs>(iter.ndim(), iter.shape().data(), strides.data(), element_sizes);
+  return OffsetCalculator<num_outputs, index_t>(iter.ndim(), iter.shape().data(), strides.data(), element_sizes);
 }
 
+// idx is the index of the block of work in the data of the policy, which is
+// the block index unless the kernel moved the data to the block.
 template<typename func_t, typename policy_t>
-__device__ inline void elementwise_kernel_helper(func_t f, policy_t policy) {
+__device__ inline void elementwise_kernel_helper(func_t f, policy_t policy, int idx) {
   using traits = function_traits<func_t>;
   using return_t = typename traits::result_type;
   using args_t = typename traits::ArgsTuple;
 
-  int idx = blockIdx.x;
-
   return_t results[thread_work_size];
   args_t args[thread_work_size];
 
@@ -71,6 +71,11 @@ __device__ inline void elementwise_kernel_helper(func_t f, policy_t policy) {
   policy.store(results, idx);
 }
 
+template<typename func_t, typename policy_t>
+__device__ inline void elementwise_kernel_helper(func_t f, policy_t policy) {
+  elementwise_kernel_helper(f, policy, blockIdx.x);
+}
+
 }}  // namespace at::native
 
 // Note:
@@ -99,9 +104,14 @@ void gpu_kernel(TensorIterator& iter, const func_t& f) {
   }
 
   if (!iter.can_use_32bit_indexing()) {
+#ifndef __HIP_PLATFORM_HCC__
+    // See Note [64-bit indexing in gpu_kernel]
+    gpu_kernel_impl_64(iter, f);
+#else
     for (auto& sub_iter : iter.with_32bit_indexing()) {
       gpu_kernel(sub_iter, f);
     }
+#endif
     return;
   }
 
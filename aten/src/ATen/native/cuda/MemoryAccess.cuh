@@ -65,6 +65,30 @@ struct vectorized_load_helper {
   }
 };
 
+template<int arg_index>
+struct vectorized_broadcast_load_helper {
+  template <typename args_t, typename policy_t>
+  static __device__ void apply(policy_t &self, args_t *args, int idx) {
+    using arg_t = std::tuple_element_t<arg_index, args_t>;
+    auto args_accessor = [&args] __device__ (int thread_unroll_idx) -> arg_t & { return std::get<arg_index>(args[thread_unroll_idx]); };
+    self.template load_single_arg<arg_t>(args_accessor, arg_index, idx);
+  }
+};
+
+template <typename dest_t, typename src_t>
+struct element_cast {
+  static __device__ inline dest_t apply(src_t value) {
+    return c10::static_cast_with_inter_type<dest_t, src_t>::apply(value);
+  }
+};
+
+template <typename scalar_t>
+struct element_cast<scalar_t, scalar_t> {
+  static __device__ inline scalar_t apply(scalar_t value) {
+    return value;
+  }
+};
+
 template<int arg_index>
 struct unroll_load_helper {
   template <typename args_t, typename policy_t, typename offset_t, typename loader_t>
@@ -91,9 +115,12 @@ struct multi_outputs_store_helper {
 
 }  // namespace detail
 
+// The offsets of the loaders and storers are in elements. They are 32-bit,
+// except in the kernels for iterators which need 64-bit indexing, see
+// Note [64-bit indexing in gpu_kernel].
 struct LoadWithoutCast {
-  template<typename scalar_t>
-  __device__ scalar_t load(char *base_ptr, uint32_t offset, int arg) {
+  template<typename scalar_t, typename offset_t>
+  __device__ scalar_t load(char *base_ptr, offset_t offset, int arg) {
     return *(reinterpret_cast<scalar_t *>(base_ptr) + offset);
   }
 };
@@ -115,16 +142,16 @@ struct LoadWithCast {
     }
   }
 
-  template<typename scalar_t>
-  __device__ scalar_t load(char *base_ptr, uint32_t offset, int arg) {
+  template<typename scalar_t, typename offset_t>
+  __device__ scalar_t load(char *base_ptr, offset_t offset, int arg) {
     void *ptr = base_ptr + element_sizes[arg] * offset;
     return c10::fetch_and_cast<scalar_t>(dtypes[arg], ptr);
   }
 };
 
 struct StoreWithoutCast {
-  template<typename scalar_t>
-  __device__ void store(scalar_t value, char *base_ptr, uint32_t offset) {
+  template<typename scalar_t, typename offset_t>
+  __device__ void store(scalar_t value, char *base_ptr, offset_t offset) {
     *(reinterpret_cast<scalar_t *>(base_ptr) + offset) = value;
   }
 };
@@ -133,8 +160,8 @@ struct StoreWithCast {
   at::ScalarType dtype;
   uint32_t element_size;
   StoreWithCast(at::ScalarType dtype): dtype(dtype), element_size(c10::elementSize(dtype)) {}
-  template<typename scalar_t>
-  __device__ void store(scalar_t value, char *base_ptr, uint32_t offset) {
+  template<typename scalar_t, typename offset_t>
+  __device__ void store(scalar_t value, char *base_ptr, offset_t offset) {
     void *ptr = base_ptr + element_size * offset;
     c10::cast_and_store<scalar_t>(dtype, ptr, value);
   }
@@ -259,6 +286,80 @@ struct vectorized {
   }
 };
 
+// Vectorized access for a contiguous output whose inputs need not be
+// contiguous: input i repeats every periods[i] elements, so a contiguous
+// input has a period of at least N, a bias added along the leading
+// dimensions repeats every row and a broadcast scalar has a period of 1 and
+// is read once per thread. A period other than 1 must be a multiple of
+// vec_size unless it covers the whole output, so that no vector crosses it.
+// With cast set the inputs are read in their own dtypes and converted to the
+// argument types of the functor after the vector loads.
+template <int vec_size, typename data_t, int ninputs, bool cast>
+struct vectorized_broadcast : vectorized<vec_size, data_t> {
+  using period_array_t = at::detail::Array<IntDivider<uint32_t>, std::max<int>(ninputs, 1)>;
+  using dtype_array_t = at::detail::Array<at::ScalarType, std::max<int>(ninputs, 1)>;
+  static constexpr int loop_size = thread_work_size / vec_size;
+
+  period_array_t periods;
+  dtype_array_t dtypes;
+
+  __device__ vectorized_broadcast(data_t data, period_array_t periods, dtype_array_t dtypes) :
+    vectorized<vec_size, data_t>(data), periods(periods), dtypes(dtypes) {}
+
+  template<typename src_t, typename arg_t, typename accessor_t>
+  __device__ inline void load_vectors(accessor_t to, int arg, int idx) {
+    using vec_t = aligned_vector<src_t, vec_size>;
+    const src_t *from = reinterpret_cast<const src_t *>(this->data[arg + 1]);
+    if (periods[arg].divisor == 1) {
+      arg_t value = detail::element_cast<arg_t, src_t>::apply(*from);
+      #pragma unroll
+      for (int i = 0; i < thread_work_size; i++) {
+        to(i) = value;
+      }
+      return;
+    }
+    int thread_idx = threadIdx.x;
+    #pragma unroll
+    for (int i = 0; i < loop_size; i++) {
+      uint32_t linear_idx = block_work_size * idx + (thread_idx + i * num_threads) * vec_size;
+      vec_t v = *reinterpret_cast<const vec_t *>(from + periods[arg].mod(linear_idx));
+      #pragma unroll
+      for (int j = 0; j < vec_size; j++) {
+        to(vec_size * i + j) = detail::element_cast<arg_t, src_t>::apply(v.val[j]);
+      }
+    }
+  }
+
+  template<typename arg_t, typename accessor_t>
+  __device__ inline void load_single_arg(accessor_t to, int arg, int idx, std::false_type /* cast */) {
+    load_vectors<arg_t, arg_t>(to, arg, idx);
+  }
+
+  template<typename arg_t, typename accessor_t>
+  __device__ inline void load_single_arg(accessor_t to, int arg, int idx, std::true_type /* cast */) {
+    // The dtypes are the same for every thread, so this does not diverge.
+    switch (dtypes[arg]) {
+#define LOAD_VECTORS_CASE(type, scalartype) \
+      case ScalarType::scalartype: load_vectors<type, arg_t>(to, arg, idx); return;
+      AT_FORALL_SCALAR_TYPES_AND3(Bool, Half, BFloat16, LOAD_VECTORS_CASE)
+#undef LOAD_VECTORS_CASE
+      default:
+        CUDA_KERNEL_ASSERT(false);
+    }
+  }
+
+  template<typename arg_t, typename accessor_t>
+  __device__ inline void load_single_arg(accessor_t to, int arg, int idx) {
+    load_single_arg<arg_t>(to, arg, idx, std::integral_constant<bool, cast>());
+  }
+
+  template<typename args_t>
+  __device__ inline void load(args_t *args, int idx) {
+    constexpr int arity = std::tuple_size<args_t>::value;
+    detail::static_unroll<detail::vectorized_broadcast_load_helper, arity>::with_args(*this, args, idx);
+  }
+};
+
 template <typename data_t, typename inp_calc_t, typename out_calc_t, int num_outputs>
 struct multi_outputs_unroll : unroll<data_t, inp_calc_t, out_calc_t, LoadWithoutCast, StoreWithoutCast, num_outputs> {
 
@@ -299,6 +400,17 @@ inline C10_HOST_DEVICE int can_vectorize_up_to(char *pointer) {
   return 1;
 }
 
+// The same for an operand whose element size is only known at runtime.
+inline int can_vectorize_up_to(char *pointer, int64_t element_size) {
+  uint64_t address = reinterpret_cast<uint64_t>(pointer);
+  if (address % (element_size * 4) == 0) {
+    return 4;
+  } else if (address % (element_size * 2) == 0) {
+    return 2;
+  }
+  return 1;
+}
+
 template<int i>
 struct can_vectorize_up_to_helper {
   template <typename array_t, typename traits>
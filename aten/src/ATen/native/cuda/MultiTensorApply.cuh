@@ -60,6 +60,12 @@ void multi_tensor_apply(
         int loc_block_info = 0;
         int loc_tensor_info = 0;
         for(size_t t = 0; t < n_tensors; t++) {
+            // Empty tensors have no chunks; skip them so that they neither take
+            // a metadata slot nor keep the trailing blocks from being launched.
+            if (tensor_lists[0][t].numel() == 0) {
+                continue;
+            }
+
             tensorListMeta.sizes[loc_tensor_info] = tensor_lists[0][t].numel();
             for (int d = 0; d < depth; d++) {
                 tensorListMeta.addresses[d][loc_tensor_info] = tensor_lists[d][t].data_ptr();
@@ -75,9 +81,8 @@ void multi_tensor_apply(
                 bool tensors_full = (loc_tensor_info == depth_to_max_tensors[depth-1] &&
                     chunk == chunks - 1);
                 bool blocks_full = (loc_block_info == depth_to_max_blocks[depth-1]);
-                bool last_chunk = (t == n_tensors - 1 && chunk == chunks - 1);
 
-                if (tensors_full || blocks_full || last_chunk) {
+                if (tensors_full || blocks_full) {
                     multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
                         tensorListMeta,
                         callable,
@@ -88,7 +93,7 @@ void multi_tensor_apply(
                     // Reset.
                     loc_block_info = 0;
                     if(chunk == chunks - 1) {
-                        loc_tensor_info = 0; 
+                        loc_tensor_info = 0;
                     }
                     else {
                         tensorListMeta.sizes[0] = tensorListMeta.sizes[loc_tensor_info-1];
@@ -100,6 +105,16 @@ void multi_tensor_apply(
                 }
             }
         }
+
+        // Launch whatever is left over from the last tensors.
+        if (loc_block_info != 0) {
+            multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+                tensorListMeta,
+                callable,
+                args...);
+
+            AT_CUDA_CHECK(cudaGetLastError());
+        }
     }
 } // namespace
 }} // at::native
@@ -43,8 +43,42 @@ __device__ __forceinline__ void warp_reduce(acc_t* sum) {
     }
 }
 
+// Reduces one value per thread over the whole block. Every thread gets the result.
+// shared must hold BLOCK_THREADS / C10_WARP_SIZE values.
+template <typename acc_t, int BLOCK_THREADS, template<typename> class ReduceOp>
+__device__ __forceinline__ acc_t block_reduce(acc_t val, acc_t* shared) {
+    constexpr int WARPS = BLOCK_THREADS / C10_WARP_SIZE;
+    ReduceOp<acc_t> r;
+    warp_reduce<acc_t, 1, C10_WARP_SIZE, ReduceOp>(&val);
+    if (threadIdx.x % C10_WARP_SIZE == 0) {
+        shared[threadIdx.x / C10_WARP_SIZE] = val;
+    }
+    __syncthreads();
+    val = shared[0];
+    #pragma unroll
+    for (int w = 1;  w < WARPS;  ++w) {
+        val = r(val, shared[w]);
+    }
+    // shared is reused by the next reduction
+    __syncthreads();
+    return val;
+}
+
+// Masks of the fused scale + mask + softmax. A boolean mask drops the positions
+// where it is true, any other mask is added to the scaled input.
+template <typename acc_t>
+__device__ __forceinline__ acc_t apply_mask(acc_t x, bool m) {
+    return m ? -std::numeric_limits<acc_t>::infinity() : x;
+}
+
+template <typename acc_t, typename mask_t>
+__device__ __forceinline__ acc_t apply_mask(acc_t x, mask_t m) {
+    return x + static_cast<acc_t>(m);
+}
+
 // The softmax_warp_* methods perform softmax forward and backward propagation on samples spanning the fast dimension.
-// Each sample contains element_count scalar elements. element_count can be any integer value <= 1024.
+// Each sample contains element_count scalar elements. element_count can be any integer value <= 1024;
+// longer samples, up to 8192 elements, are handled by the softmax_block_* methods below.
 // The template arguments have the following meaning:
 // One "WARP" works on one "BATCH". One "BATCH" contains "WARP_BATCH" samples.
 // WARP_BATCH is equal to 1 when element_count is large, and > 1 when element_count is small.
@@ -60,9 +94,11 @@ __device__ __forceinline__ void warp_reduce(acc_t* sum) {
 // input_t=half,  acc_t=float, output_t=half  => read half tensor, float accumulators, write half tensor.
 // input_t=half,  acc_t=float, output_t=float => read half tensor, float accumulators, write float tensor.
 // input_t_float, acc_t=float, output_t=half  => read float tensor, float accumulators, write half tensor.
+// When is_masked is set the input is multiplied by scale and masked with row (sample % mask_batch_size)
+// of mask before the softmax, see apply_mask. The backward methods multiply the gradient by scale.
 
-template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax>
-__global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batch_size, int stride, int element_count)
+template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax, bool is_masked, typename mask_t>
+__global__ void softmax_warp_forward(output_t *dst, const input_t *src, const mask_t *mask, int mask_batch_size, acc_t scale, int batch_size, int stride, int element_count)
 {
     // WARP_SIZE and WARP_BATCH must match the return values batches_per_warp and warp_size of method warp_softmax_forward_kernel.
     constexpr int next_power_of_two = 1 << log2_elements;
@@ -93,10 +129,14 @@ __global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batc
     acc_t elements[WARP_BATCH][WARP_ITERATIONS];
     for (int i = 0;  i < WARP_BATCH;  ++i) {
         int batch_element_count = (i >= local_batches) ? 0 : element_count;
+        const mask_t *mask_row = is_masked ? mask + ((first_batch + i) % mask_batch_size) * element_count + local_idx : nullptr;
         for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
             int element_index = local_idx + it * WARP_SIZE;
             if (element_index < batch_element_count) {
                 elements[i][it] = src[i*element_count+it*WARP_SIZE];
+                if (is_masked) {
+                    elements[i][it] = apply_mask(elements[i][it] * scale, mask_row[it*WARP_SIZE]);
+                }
             } else {
                 elements[i][it] = -std::numeric_limits<acc_t>::infinity();
             }
@@ -153,7 +193,7 @@ __global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batc
 }
 
 template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax>
-__global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad, const input_t *output, int batch_size, int stride, int element_count)
+__global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad, const input_t *output, acc_t scale, int batch_size, int stride, int element_count)
 {
     // WARP_SIZE and WARP_BATCH must match the return values batches_per_warp and warp_size of method warp_softmax_backward_kernel.
     constexpr int next_power_of_two = 1 << log2_elements;
@@ -222,21 +262,142 @@ __global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad,
             if (element_index < element_count) {
                 // compute gradients
                 if (is_log_softmax) {
-                    gradInput[i*element_count+it*WARP_SIZE] = (grad_reg[i][it] - std::exp(output_reg[i][it]) * sum[i]);
+                    gradInput[i*element_count+it*WARP_SIZE] = scale * (grad_reg[i][it] - std::exp(output_reg[i][it]) * sum[i]);
                 } else {
-                    gradInput[i*element_count+it*WARP_SIZE] = (grad_reg[i][it] - output_reg[i][it] * sum[i]);
+                    gradInput[i*element_count+it*WARP_SIZE] = scale * (grad_reg[i][it] - output_reg[i][it] * sum[i]);
                 }
             }
         }
     }
 }
 
+// The softmax_block_* methods handle samples of 1024 < element_count <= 8192 elements, which no longer fit
+// in the registers of a single warp. One block works on one sample and keeps it in the registers of all its
+// BLOCK_THREADS threads, ITERATIONS elements each, so the sample is still read from global memory only once.
+// Reductions go through shared memory between the warps of the block. The arguments have the same meaning
+// as for the softmax_warp_* methods.
+
+template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax, bool is_masked, typename mask_t>
+__global__ void softmax_block_forward(output_t *dst, const input_t *src, const mask_t *mask, int mask_batch_size, acc_t scale, int stride, int element_count)
+{
+    // ITERATIONS and BLOCK_THREADS must match the values used by dispatch_softmax_forward_impl.
+    constexpr int next_power_of_two = 1 << log2_elements;
+    constexpr int ITERATIONS = 16;
+    constexpr int BLOCK_THREADS = next_power_of_two / ITERATIONS;
+    __shared__ acc_t shared[BLOCK_THREADS / C10_WARP_SIZE];
+
+    int batch = blockIdx.x;
+    int local_idx = threadIdx.x;
+    src += batch * stride + local_idx;
+    dst += batch * stride + local_idx;
+    if (is_masked) {
+        mask += (batch % mask_batch_size) * element_count + local_idx;
+    }
+
+    acc_t elements[ITERATIONS];
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = local_idx + it * BLOCK_THREADS;
+        if (element_index < element_count) {
+            elements[it] = src[it*BLOCK_THREADS];
+            if (is_masked) {
+                elements[it] = apply_mask(elements[it] * scale, mask[it*BLOCK_THREADS]);
+            }
+        } else {
+            elements[it] = -std::numeric_limits<acc_t>::infinity();
+        }
+    }
+
+    acc_t max_value = elements[0];
+    #pragma unroll
+    for (int it = 1;  it < ITERATIONS;  ++it) {
+        max_value = (max_value > elements[it]) ? max_value : elements[it];
+    }
+    max_value = block_reduce<acc_t, BLOCK_THREADS, Max>(max_value, shared);
+
+    acc_t sum = 0;
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        if (is_log_softmax) {
+            sum += std::exp(elements[it] - max_value);
+        } else {
+            elements[it] = std::exp(elements[it] - max_value);
+            sum += elements[it];
+        }
+    }
+    sum = block_reduce<acc_t, BLOCK_THREADS, Add>(sum, shared);
+
+    if (is_log_softmax) sum = std::log(sum);
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = local_idx + it * BLOCK_THREADS;
+        if (element_index < element_count) {
+            if (is_log_softmax) {
+                dst[it*BLOCK_THREADS] = elements[it] - max_value - sum;
+            } else {
+                dst[it*BLOCK_THREADS] = elements[it] / sum;
+            }
+        }
+    }
+}
+
+template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax>
+__global__ void softmax_block_backward(output_t *gradInput, const input_t *grad, const input_t *output, acc_t scale, int stride, int element_count)
+{
+    // ITERATIONS and BLOCK_THREADS must match the values used by dispatch_softmax_backward_impl.
+    constexpr int next_power_of_two = 1 << log2_elements;
+    constexpr int ITERATIONS = 16;
+    constexpr int BLOCK_THREADS = next_power_of_two / ITERATIONS;
+    __shared__ acc_t shared[BLOCK_THREADS / C10_WARP_SIZE];
+
+    int thread_offset = blockIdx.x * stride + threadIdx.x;
+    grad += thread_offset;
+    output += thread_offset;
+    gradInput += thread_offset;
+
+    acc_t grad_reg[ITERATIONS];
+    acc_t output_reg[ITERATIONS];
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = threadIdx.x + it * BLOCK_THREADS;
+        if (element_index < element_count) {
+            grad_reg[it] = grad[it*BLOCK_THREADS];
+            output_reg[it] = output[it*BLOCK_THREADS];
+        } else {
+            grad_reg[it] = acc_t(0);
+            output_reg[it] = acc_t(0);
+        }
+    }
+
+    acc_t sum = grad_reg[0];
+    #pragma unroll
+    for (int it = 1;  it < ITERATIONS;  ++it) {
+        sum += grad_reg[it];
+    }
+    sum = block_reduce<acc_t, BLOCK_THREADS, Add>(sum, shared);
+
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = threadIdx.x + it * BLOCK_THREADS;
+        if (element_index < element_count) {
+            if (is_log_softmax) {
+                gradInput[it*BLOCK_THREADS] = scale * (grad_reg[it] - std::exp(output_reg[it]) * sum);
+            } else {
+                gradInput[it*BLOCK_THREADS] = scale * (grad_reg[it] - output_reg[it] * sum);
+            }
+        }
+    }
+}
+
 } // end of anonymous namespace
 
-template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
-void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_elements, int softmax_elements_stride, int batch_count)
+// Longest sample the persistent softmax kernels handle.
+constexpr int max_persistent_softmax_elements = 8192;
+
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax, bool is_masked, typename mask_t>
+void dispatch_softmax_forward_impl(output_t *dst, const input_t *src, const mask_t *mask, int mask_batch_size, acc_t scale, int softmax_elements, int softmax_elements_stride, int batch_count)
 {
-    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= 1024 );
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= max_persistent_softmax_elements );
     if (softmax_elements == 0) {
         return;
     } else {
@@ -249,6 +410,9 @@ void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_ele
         // This value must match the WARP_BATCH constexpr value computed inside softmax_warp_forward.
         int batches_per_warp = (next_power_of_two <= 128) ? 2 : 1;
 
+        // This value must match the ITERATIONS constexpr value of softmax_block_forward.
+        constexpr int block_iterations = 16;
+
         // use 128 threads per block to maximimize gpu utilization
         constexpr int threads_per_block = 128;
 
@@ -259,48 +423,60 @@ void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_ele
         // Launch code would be more elegant if C++ supported FOR CONSTEXPR
         switch (log2_elements) {
             case 0: // 1
-                softmax_warp_forward<input_t, output_t, acc_t, 0, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 0, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 1: // 2
-                softmax_warp_forward<input_t, output_t, acc_t, 1, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 1, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 2: // 4
-                softmax_warp_forward<input_t, output_t, acc_t, 2, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 2, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 3: // 8
-                softmax_warp_forward<input_t, output_t, acc_t, 3, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 3, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 4: // 16
-                softmax_warp_forward<input_t, output_t, acc_t, 4, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 4, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 5: // 32
-                softmax_warp_forward<input_t, output_t, acc_t, 5, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 5, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 6: // 64
-                softmax_warp_forward<input_t, output_t, acc_t, 6, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 6, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 7: // 128
-                softmax_warp_forward<input_t, output_t, acc_t, 7, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 7, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 8: // 256
-                softmax_warp_forward<input_t, output_t, acc_t, 8, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 8, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 9: // 512
-                softmax_warp_forward<input_t, output_t, acc_t, 9, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 9, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 10: // 1024
-                softmax_warp_forward<input_t, output_t, acc_t, 10, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+                softmax_warp_forward<input_t, output_t, acc_t, 10, is_log_softmax, is_masked, mask_t>
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, batch_count, softmax_elements_stride, softmax_elements);
+                break;
+            case 11: // 2048
+                softmax_block_forward<input_t, output_t, acc_t, 11, is_log_softmax, is_masked, mask_t>
+                    <<<batch_count, (1 << 11) / block_iterations, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, softmax_elements_stride, softmax_elements);
+                break;
+            case 12: // 4096
+                softmax_block_forward<input_t, output_t, acc_t, 12, is_log_softmax, is_masked, mask_t>
+                    <<<batch_count, (1 << 12) / block_iterations, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, softmax_elements_stride, softmax_elements);
+                break;
+            case 13: // 8192
+                softmax_block_forward<input_t, output_t, acc_t, 13, is_log_softmax, is_masked, mask_t>
+                    <<<batch_count, (1 << 13) / block_iterations, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, mask, mask_batch_size, scale, softmax_elements_stride, softmax_elements);
                 break;
             default:
                 break;
@@ -309,9 +485,25 @@ void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_ele
 }
 
 template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
-void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const input_t *output, int softmax_elements, int softmax_elements_stride, int batch_count)
+void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    dispatch_softmax_forward_impl<input_t, output_t, acc_t, is_log_softmax, /*is_masked=*/false, bool>(
+        dst, src, /*mask=*/nullptr, /*mask_batch_size=*/1, /*scale=*/acc_t(1), softmax_elements, softmax_elements_stride, batch_count);
+}
+
+// softmax(src * scale masked by mask) over samples of softmax_elements elements. mask holds mask_batch_size
+// contiguous samples, sample i of src uses sample (i % mask_batch_size) of mask.
+template<typename input_t, typename output_t, typename acc_t, typename mask_t>
+void dispatch_scale_mask_softmax_forward(output_t *dst, const input_t *src, const mask_t *mask, int mask_batch_size, acc_t scale, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    dispatch_softmax_forward_impl<input_t, output_t, acc_t, /*is_log_softmax=*/false, /*is_masked=*/true, mask_t>(
+        dst, src, mask, mask_batch_size, scale, softmax_elements, softmax_elements_stride, batch_count);
+}
+
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_backward_impl(output_t *grad_input, const input_t *grad, const input_t *output, acc_t scale, int softmax_elements, int softmax_elements_stride, int batch_count)
 {
-    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= 1024 );
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= max_persistent_softmax_elements );
     if (softmax_elements == 0) {
        return;
     } else {
@@ -324,6 +516,9 @@ void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const
         // This value must match the WARP_BATCH constexpr value computed inside softmax_warp_backward.
         int batches_per_warp = (next_power_of_two <= 128) ? 2 : 1;
 
+        // This value must match the ITERATIONS constexpr value of softmax_block_backward.
+        constexpr int block_iterations = 16;
+
         // use 128 threads per block to maximimize gpu utilization
         constexpr int threads_per_block = 128;
 
@@ -335,47 +530,59 @@ void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const
         switch (log2_elements) {
             case 0: // 1
                 softmax_warp_backward<input_t, output_t, acc_t, 0, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 1: // 2
                 softmax_warp_backward<input_t, output_t, acc_t, 1, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 2: // 4
                 softmax_warp_backward<input_t, output_t, acc_t, 2, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 3: // 8
                 softmax_warp_backward<input_t, output_t, acc_t, 3, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 4: // 16
                 softmax_warp_backward<input_t, output_t, acc_t, 4, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 5: // 32
                 softmax_warp_backward<input_t, output_t, acc_t, 5, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 6: // 64
                 softmax_warp_backward<input_t, output_t, acc_t, 6, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 7: // 128
                 softmax_warp_backward<input_t, output_t, acc_t, 7, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 8: // 256
                 softmax_warp_backward<input_t, output_t, acc_t, 8, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 9: // 512
                 softmax_warp_backward<input_t, output_t, acc_t, 9, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
                 break;
             case 10: // 1024
                 softmax_warp_backward<input_t, output_t, acc_t, 10, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, batch_count, softmax_elements_stride, softmax_elements);
+                break;
+            case 11: // 2048
+                softmax_block_backward<input_t, output_t, acc_t, 11, is_log_softmax>
+                    <<<batch_count, (1 << 11) / block_iterations, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, softmax_elements_stride, softmax_elements);
+                break;
+            case 12: // 4096
+                softmax_block_backward<input_t, output_t, acc_t, 12, is_log_softmax>
+                    <<<batch_count, (1 << 12) / block_iterations, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, softmax_elements_stride, softmax_elements);
+                break;
+            case 13: // 8192
+                softmax_block_backward<input_t, output_t, acc_t, 13, is_log_softmax>
+                    <<<batch_count, (1 << 13) / block_iterations, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, scale, softmax_elements_stride, softmax_elements);
                 break;
             default:
                 break;
@@ -383,3 +590,18 @@ void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const
     }
 }
 
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const input_t *output, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    dispatch_softmax_backward_impl<input_t, output_t, acc_t, is_log_softmax>(
+        grad_input, grad, output, /*scale=*/acc_t(1), softmax_elements, softmax_elements_stride, batch_count);
+}
+
+// scale * (grad - output * sum(grad)), the backward of dispatch_scale_mask_softmax_forward when grad is
+// the incoming gradient multiplied by output, as for dispatch_softmax_backward.
+template<typename input_t, typename output_t, typename acc_t>
+void dispatch_scale_mask_softmax_backward(output_t *grad_input, const input_t *grad, const input_t *output, acc_t scale, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    dispatch_softmax_backward_impl<input_t, output_t, acc_t, /*is_log_softmax=*/false>(
+        grad_input, grad, output, scale, softmax_elements, softmax_elements_stride, batch_count);
+}
@@ -4,6 +4,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/native/RNN.h>
 #include <c10/macros/Macros.h>
 
 namespace at { namespace native {
@@ -482,6 +483,185 @@ void gru_backward_impl(const Tensor& grad_hy, const Tensor& workspace,
   }
 }
 
+// Note [Persistent RNN]
+// Without cuDNN a CUDA RNN layer costs a hidden-to-hidden matmul and a fused
+// cell kernel per timestep, which for small hidden sizes is dominated by
+// launch latency. The persistent kernels run a whole layer in one launch:
+// block b runs every timestep of batch entry b, keeps the hidden-to-hidden
+// weights (and the projection of an LSTM with projections) in shared memory
+// and the state in shared memory in the accumulate type. One thread per gate
+// computes that gate's row of the hidden-to-hidden product. The input-to-hidden
+// product of all timesteps is computed beforehand with a single matmul.
+// The hidden and cell state are rounded to the input type after every step,
+// as the per-timestep cells do. There is no backward; the layers in RNN.cpp
+// use these kernels only when nothing requires grad.
+
+namespace kernel {
+
+template <typename scalar_t, typename accscalar_t>
+__global__ void persistent_lstm_forward(
+    const scalar_t* __restrict__ input_gates,  // [seq_length, batch_size, 4 * hidden_size]
+    const scalar_t* __restrict__ hidden_bias,  // [4 * hidden_size] or nullptr
+    const scalar_t* __restrict__ hx,           // [batch_size, output_size]
+    const scalar_t* __restrict__ cx,           // [batch_size, hidden_size]
+    const scalar_t* __restrict__ w_hh,         // [4 * hidden_size, output_size]
+    const scalar_t* __restrict__ w_hr,         // [output_size, hidden_size] or nullptr
+    scalar_t* __restrict__ output,             // [seq_length, batch_size, output_size]
+    scalar_t* __restrict__ hy,                 // [batch_size, output_size]
+    scalar_t* __restrict__ cy,                 // [batch_size, hidden_size]
+    int64_t seq_length,
+    int batch_size,
+    int hidden_size,
+    int output_size) {
+  extern __shared__ __align__(sizeof(double)) unsigned char smem[];
+  const int gate_size = 4 * hidden_size;
+  // Layout follows persistent_rnn_shared_memory_size.
+  accscalar_t* h_s = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* c_s = h_s + output_size;
+  accscalar_t* y_s = c_s + hidden_size;  // the output before the projection
+  accscalar_t* gates_s = y_s + hidden_size;
+  // Transposed, so that consecutive threads read consecutive gates.
+  scalar_t* w_hh_s = reinterpret_cast<scalar_t*>(gates_s + gate_size);
+  scalar_t* w_hr_s = w_hh_s + gate_size * output_size;
+
+  const int b = blockIdx.x;
+  for (int i = threadIdx.x; i < gate_size * output_size; i += blockDim.x) {
+    w_hh_s[(i % output_size) * gate_size + i / output_size] = w_hh[i];
+  }
+  if (w_hr != nullptr) {
+    for (int i = threadIdx.x; i < output_size * hidden_size; i += blockDim.x) {
+      w_hr_s[(i % hidden_size) * output_size + i / hidden_size] = w_hr[i];
+    }
+  }
+  for (int i = threadIdx.x; i < output_size; i += blockDim.x) {
+    h_s[i] = static_cast<accscalar_t>(hx[b * output_size + i]);
+  }
+  for (int i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+    c_s[i] = static_cast<accscalar_t>(cx[b * hidden_size + i]);
+  }
+  __syncthreads();
+
+  for (int64_t t = 0; t < seq_length; t++) {
+    const scalar_t* step_gates = input_gates + (t * batch_size + b) * gate_size;
+    scalar_t* step_output = output + (t * batch_size + b) * output_size;
+
+    for (int j = threadIdx.x; j < gate_size; j += blockDim.x) {
+      accscalar_t acc = static_cast<accscalar_t>(step_gates[j]);
+      if (hidden_bias != nullptr) {
+        acc += static_cast<accscalar_t>(hidden_bias[j]);
+      }
+      for (int k = 0; k < output_size; k++) {
+        acc += static_cast<accscalar_t>(w_hh_s[k * gate_size + j]) * h_s[k];
+      }
+      gates_s[j] = acc;
+    }
+    __syncthreads();
+
+    for (int m = threadIdx.x; m < hidden_size; m += blockDim.x) {
+      accscalar_t ingate = sigmoid(gates_s[m]);
+      accscalar_t forgetgate = sigmoid(gates_s[hidden_size + m]);
+      accscalar_t cellgate = ::tanh(gates_s[2 * hidden_size + m]);
+      accscalar_t outgate = sigmoid(gates_s[3 * hidden_size + m]);
+      scalar_t c = static_cast<scalar_t>(forgetgate * c_s[m] + ingate * cellgate);
+      c_s[m] = static_cast<accscalar_t>(c);
+      scalar_t y = static_cast<scalar_t>(outgate * ::tanh(c_s[m]));
+      if (w_hr != nullptr) {
+        y_s[m] = static_cast<accscalar_t>(y);
+      } else {
+        h_s[m] = static_cast<accscalar_t>(y);
+        step_output[m] = y;
+      }
+    }
+    __syncthreads();
+
+    if (w_hr != nullptr) {
+      for (int p = threadIdx.x; p < output_size; p += blockDim.x) {
+        accscalar_t acc = 0;
+        for (int m = 0; m < hidden_size; m++) {
+          acc += static_cast<accscalar_t>(w_hr_s[m * output_size + p]) * y_s[m];
+        }
+        scalar_t h = static_cast<scalar_t>(acc);
+        h_s[p] = static_cast<accscalar_t>(h);
+        step_output[p] = h;
+      }
+      __syncthreads();
+    }
+  }
+
+  for (int i = threadIdx.x; i < output_size; i += blockDim.x) {
+    hy[b * output_size + i] = static_cast<scalar_t>(h_s[i]);
+  }
+  for (int i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+    cy[b * hidden_size + i] = static_cast<scalar_t>(c_s[i]);
+  }
+}
+
+template <typename scalar_t, typename accscalar_t>
+__global__ void persistent_gru_forward(
+    const scalar_t* __restrict__ input_gates,  // [seq_length, batch_size, 3 * hidden_size]
+    const scalar_t* __restrict__ hidden_bias,  // [3 * hidden_size] or nullptr
+    const scalar_t* __restrict__ hx,           // [batch_size, hidden_size]
+    const scalar_t* __restrict__ w_hh,         // [3 * hidden_size, hidden_size]
+    scalar_t* __restrict__ output,             // [seq_length, batch_size, hidden_size]
+    scalar_t* __restrict__ hy,                 // [batch_size, hidden_size]
+    int64_t seq_length,
+    int batch_size,
+    int hidden_size) {
+  extern __shared__ __align__(sizeof(double)) unsigned char smem[];
+  const int gate_size = 3 * hidden_size;
+  // Same layout as the LSTM, the cell state and projection input are unused.
+  accscalar_t* h_s = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* gates_s = h_s + 3 * hidden_size;
+  scalar_t* w_hh_s = reinterpret_cast<scalar_t*>(gates_s + gate_size);
+
+  const int b = blockIdx.x;
+  for (int i = threadIdx.x; i < gate_size * hidden_size; i += blockDim.x) {
+    w_hh_s[(i % hidden_size) * gate_size + i / hidden_size] = w_hh[i];
+  }
+  for (int i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+    h_s[i] = static_cast<accscalar_t>(hx[b * hidden_size + i]);
+  }
+  __syncthreads();
+
+  for (int64_t t = 0; t < seq_length; t++) {
+    const scalar_t* step_gates = input_gates + (t * batch_size + b) * gate_size;
+    scalar_t* step_output = output + (t * batch_size + b) * hidden_size;
+
+    for (int j = threadIdx.x; j < gate_size; j += blockDim.x) {
+      accscalar_t acc = hidden_bias != nullptr ? static_cast<accscalar_t>(hidden_bias[j]) : accscalar_t(0);
+      for (int k = 0; k < hidden_size; k++) {
+        acc += static_cast<accscalar_t>(w_hh_s[k * gate_size + j]) * h_s[k];
+      }
+      gates_s[j] = acc;
+    }
+    __syncthreads();
+
+    for (int m = threadIdx.x; m < hidden_size; m += blockDim.x) {
+      accscalar_t resetgate = sigmoid(static_cast<accscalar_t>(step_gates[m]) + gates_s[m]);
+      accscalar_t inputgate = sigmoid(
+          static_cast<accscalar_t>(step_gates[hidden_size + m]) + gates_s[hidden_size + m]);
+      accscalar_t newgate = ::tanh(static_cast<accscalar_t>(step_gates[2 * hidden_size + m]) +
+                                   resetgate * gates_s[2 * hidden_size + m]);
+      scalar_t h = static_cast<scalar_t>(newgate + inputgate * (h_s[m] - newgate));
+      h_s[m] = static_cast<accscalar_t>(h);
+      step_output[m] = h;
+    }
+    __syncthreads();
+  }
+
+  for (int i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+    hy[b * hidden_size + i] = static_cast<scalar_t>(h_s[i]);
+  }
+}
+
+} // namespace kernel
+
+int persistent_rnn_threads(int64_t gate_size) {
+  const int64_t warp = at::cuda::warp_size();
+  return static_cast<int>(std::min<int64_t>(
+      (gate_size + warp - 1) / warp * warp, kPersistentRNNMaxThreads));
+}
+
 } // anonymous namespace
 
 // Note [64-bit index math check elision]
@@ -609,4 +789,128 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_gru_cell_backward
   return std::make_tuple(grad_input_gates, grad_hidden_gates, grad_hx, grad_input_bias, grad_hidden_bias);
 }
 
+// Runs a whole LSTM layer, see Note [Persistent RNN]. input_gates holds the
+// input-to-hidden products of all timesteps including the input bias. With
+// w_hr the layer is an LSTM with projections: the hidden state is
+// w_hr (outgate * tanh(cy)) of size w_hr.size(0).
+std::tuple<Tensor, Tensor, Tensor> _thnn_persistent_lstm_cuda(
+      const Tensor& input_gates, const Tensor& hx, const Tensor& cx,
+      const Tensor& w_hh, const Tensor& hidden_bias, const Tensor& w_hr) {
+  CheckedFrom c = "_thnn_persistent_lstm_cuda";
+  TensorArg input_gates_arg{input_gates, "input_gates", 1}, hx_arg{hx, "hx", 2},
+            cx_arg{cx, "cx", 3}, w_hh_arg{w_hh, "w_hh", 4},
+            hidden_bias_arg{hidden_bias, "hidden_bias", 5}, w_hr_arg{w_hr, "w_hr", 6};
+  checkDim(c, input_gates_arg, 3);
+  checkDim(c, cx_arg, 2);
+  const int64_t seq_length = input_gates.size(0);
+  const int64_t batch_size = input_gates.size(1);
+  const int64_t hidden_size = cx.size(1);
+  const int64_t gate_size = 4 * hidden_size;
+  const int64_t output_size = w_hr.defined() ? w_hr.size(0) : hidden_size;
+  checkSize(c, input_gates_arg, {seq_length, batch_size, gate_size});
+  checkSize(c, hx_arg, {batch_size, output_size});
+  checkSize(c, cx_arg, {batch_size, hidden_size});
+  checkSize(c, w_hh_arg, {gate_size, output_size});
+  if (hidden_bias.defined()) {
+    checkNumel(c, hidden_bias_arg, gate_size);
+  }
+  if (w_hr.defined()) {
+    checkSize(c, w_hr_arg, {output_size, hidden_size});
+  }
+  checkAllSameType(c, {input_gates_arg, hx_arg, cx_arg, w_hh_arg, hidden_bias_arg, w_hr_arg});
+  checkAllSameGPU(c, {input_gates_arg, hx_arg, cx_arg, w_hh_arg, hidden_bias_arg, w_hr_arg});
+  TORCH_CHECK(persistent_rnn_fits(gate_size, hidden_size, output_size, w_hr.defined(), input_gates.scalar_type()),
+              "_thnn_persistent_lstm_cuda: the weights of a layer with hidden size ", hidden_size,
+              " and output size ", output_size, " do not fit in the shared memory of one block");
+
+  auto output = at::empty({seq_length, batch_size, output_size}, input_gates.options());
+  auto hy = at::empty({batch_size, output_size}, input_gates.options());
+  auto cy = at::empty({batch_size, hidden_size}, input_gates.options());
+  if (batch_size == 0) {
+    return std::make_tuple(output, hy, cy);
+  }
+
+  auto input_gates_c = input_gates.contiguous();
+  auto hx_c = hx.contiguous();
+  auto cx_c = cx.contiguous();
+  auto w_hh_c = w_hh.contiguous();
+  auto hidden_bias_c = hidden_bias.defined() ? hidden_bias.contiguous() : hidden_bias;
+  auto w_hr_c = w_hr.defined() ? w_hr.contiguous() : w_hr;
+  const int threads = persistent_rnn_threads(gate_size);
+  const size_t smem = persistent_rnn_shared_memory_size(
+      gate_size, hidden_size, output_size, w_hr.defined(), input_gates.scalar_type());
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input_gates.scalar_type(), "_thnn_persistent_lstm_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    kernel::persistent_lstm_forward<scalar_t, accscalar_t><<<batch_size, threads, smem, stream>>>(
+        input_gates_c.data_ptr<scalar_t>(),
+        hidden_bias_c.defined() ? hidden_bias_c.data_ptr<scalar_t>() : nullptr,
+        hx_c.data_ptr<scalar_t>(),
+        cx_c.data_ptr<scalar_t>(),
+        w_hh_c.data_ptr<scalar_t>(),
+        w_hr_c.defined() ? w_hr_c.data_ptr<scalar_t>() : nullptr,
+        output.data_ptr<scalar_t>(),
+        hy.data_ptr<scalar_t>(),
+        cy.data_ptr<scalar_t>(),
+        seq_length, batch_size, hidden_size, output_size);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+  return std::make_tuple(output, hy, cy);
+}
+
+// Runs a whole GRU layer, see Note [Persistent RNN]. input_gates holds the
+// input-to-hidden products of all timesteps including the input bias.
+std::tuple<Tensor, Tensor> _thnn_persistent_gru_cuda(
+      const Tensor& input_gates, const Tensor& hx,
+      const Tensor& w_hh, const Tensor& hidden_bias) {
+  CheckedFrom c = "_thnn_persistent_gru_cuda";
+  TensorArg input_gates_arg{input_gates, "input_gates", 1}, hx_arg{hx, "hx", 2},
+            w_hh_arg{w_hh, "w_hh", 3}, hidden_bias_arg{hidden_bias, "hidden_bias", 4};
+  checkDim(c, input_gates_arg, 3);
+  checkDim(c, hx_arg, 2);
+  const int64_t seq_length = input_gates.size(0);
+  const int64_t batch_size = input_gates.size(1);
+  const int64_t hidden_size = hx.size(1);
+  const int64_t gate_size = 3 * hidden_size;
+  checkSize(c, input_gates_arg, {seq_length, batch_size, gate_size});
+  checkSize(c, hx_arg, {batch_size, hidden_size});
+  checkSize(c, w_hh_arg, {gate_size, hidden_size});
+  if (hidden_bias.defined()) {
+    checkNumel(c, hidden_bias_arg, gate_size);
+  }
+  checkAllSameType(c, {input_gates_arg, hx_arg, w_hh_arg, hidden_bias_arg});
+  checkAllSameGPU(c, {input_gates_arg, hx_arg, w_hh_arg, hidden_bias_arg});
+  TORCH_CHECK(persistent_rnn_fits(gate_size, hidden_size, hidden_size, /*has_proj=*/false, input_gates.scalar_type()),
+              "_thnn_persistent_gru_cuda: the weights of a layer with hidden size ", hidden_size,
+              " do not fit in the shared memory of one block");
+
+  auto output = at::empty({seq_length, batch_size, hidden_size}, input_gates.options());
+  auto hy = at::empty({batch_size, hidden_size}, input_gates.options());
+  if (batch_size == 0) {
+    return std::make_tuple(output, hy);
+  }
+
+  auto input_gates_c = input_gates.contiguous();
+  auto hx_c = hx.contiguous();
+  auto w_hh_c = w_hh.contiguous();
+  auto hidden_bias_c = hidden_bias.defined() ? hidden_bias.contiguous() : hidden_bias;
+  const int threads = persistent_rnn_threads(gate_size);
+  const size_t smem = persistent_rnn_shared_memory_size(
+      gate_size, hidden_size, hidden_size, /*has_proj=*/false, input_gates.scalar_type());
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input_gates.scalar_type(), "_thnn_persistent_gru_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    kernel::persistent_gru_forward<scalar_t, accscalar_t><<<batch_size, threads, smem, stream>>>(
+        input_gates_c.data_ptr<scalar_t>(),
+        hidden_bias_c.defined() ? hidden_bias_c.data_ptr<scalar_t>() : nullptr,
+        hx_c.data_ptr<scalar_t>(),
+        w_hh_c.data_ptr<scalar_t>(),
+        output.data_ptr<scalar_t>(),
+        hy.data_ptr<scalar_t>(),
+        seq_length, batch_size, hidden_size);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+  return std::make_tuple(output, hy);
+}
+
 }} // namespace at::native
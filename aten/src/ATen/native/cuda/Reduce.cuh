@@ -608,10 +608,12 @@ struct ReduceOp {
         }
       }
       dim_x = warpSize;
+      __syncthreads();
     }
 
-    __syncthreads();
-
+    // When a row is reduced by at most a warp the lanes only exchange values
+    // through shuffles, so the threads of the block need not wait for each
+    // other.
     for (int offset = 1; offset < dim_x; offset <<= 1) {
       #pragma unroll
       for (int i = 0; i < output_vec_size; i++) {
@@ -1046,13 +1048,33 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
     }
   }
 
+  // Short rows reduced along their contiguous dimension, e.g. sum(-1) of a
+  // (1M, 64) tensor, would leave every lane of a warp with one or two values,
+  // so that the shuffles between them cost more than the loads. A row of up to
+  // kThreadPerRowMaxSize values is reduced by a single thread, which needs no
+  // shuffles at all. A row of up to kLanesPerRowMaxSize values is reduced by
+  // just enough lanes, packing several rows in a warp, that each lane reduces
+  // at least kMinValuesPerLane of them.
+  constexpr int64_t kThreadPerRowMaxSize = 16;
+  constexpr int64_t kLanesPerRowMaxSize = 128;
+  constexpr int64_t kMinValuesPerLane = 4;
+  const bool short_rows = iter.ndim() > 0 && reduction_on_fastest_striding_dimension &&
+      !config.vectorize_input && num_outputs >= at::cuda::warp_size();
+  const bool thread_per_row = short_rows && inputs_per_output <= kThreadPerRowMaxSize;
+
   // Adjust block_width and block_height
-  config.set_block_dimension(dim0, dim1);
+  if (thread_per_row) {
+    config.set_block_dimension(num_outputs, num_outputs);
+  } else if (short_rows && dim0 <= kLanesPerRowMaxSize) {
+    config.set_block_dimension(div_up(dim0, kMinValuesPerLane), dim1);
+  } else {
+    config.set_block_dimension(dim0, dim1);
+  }
 
   int block_width = config.block_width;
   int block_height = config.block_height;
 
-  if (iter.ndim() == 0 || reduction_on_fastest_striding_dimension) {
+  if (iter.ndim() == 0 || (reduction_on_fastest_striding_dimension && !thread_per_row)) {
     // Split the input across lanes if the input is contiguous in the reduced
     // dimension. This will require reduction between threads using warp
     // shuffle instructions and shared memory (if block_width > warpSize).
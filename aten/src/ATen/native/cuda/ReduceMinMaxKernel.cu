@@ -41,6 +41,26 @@ void min_values_kernel_cuda(TensorIterator& iter) {
   });
 }
 
+template <typename scalar_t, typename acc_t=scalar_t>
+void aminmax_kernel_cuda_impl(TensorIterator& iter) {
+  gpu_reduce_kernel<scalar_t, scalar_t>(
+    iter,
+    MinMaxOps<scalar_t, acc_t, thrust::pair<scalar_t, scalar_t>>{},
+    thrust::pair<acc_t, acc_t>(at::numeric_limits<acc_t>::upper_bound(), at::numeric_limits<acc_t>::lower_bound()));
+}
+
+void aminmax_kernel_cuda(TensorIterator& iter) {
+  if (iter.dtype() == kHalf) {
+    // Instead of implementing is_nan and warp_shfl_down
+    // we can convert halves to float and do all the operations in float
+    aminmax_kernel_cuda_impl<at::Half, float>(iter);
+  } else {
+    AT_DISPATCH_ALL_TYPES_AND(kBool, iter.dtype(), "aminmax_cuda", [&]() {
+      aminmax_kernel_cuda_impl<scalar_t>(iter);
+    });
+  }
+}
+
 template <typename scalar_t, typename acc_t=scalar_t>
 void argmax_kernel_cuda_impl(TensorIterator& iter) {
   gpu_reduce_kernel<scalar_t, int64_t>(
@@ -119,6 +139,7 @@ static void max_all_kernel_impl(Tensor& result, const Tensor& input) {
 
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_cuda);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_cuda);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_cuda);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_cuda);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_cuda);
 REGISTER_DISPATCH(min_stub, &min_kernel_impl);
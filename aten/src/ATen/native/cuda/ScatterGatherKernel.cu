@@ -7,6 +7,7 @@
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
 
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
 #include <ATen/native/cuda/Loops.cuh>
 #include <ATen/cuda/detail/OffsetCalculator.cuh>
 #include <ATen/cuda/CUDAContext.h>
@@ -302,7 +303,53 @@ void scatter_fill_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, Sc
   );
 }
 
+// scatter_add_ as a sum by destination element: the offset every element of
+// src is added to in a contiguous self is sorted on, and the sums are added
+// to self at once.
+static void scatter_add_sorted_cuda(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  scatter_gather_dtype_check("scatter_add_cuda_", self, index, src);
+  scatter_shape_check(self, dim, index, src);
+
+  Tensor self_ = self.dim() == 0 ? self.view(1) : self;
+  Tensor index_ = index.dim() == 0 ? index.view(1) : index;
+  Tensor src_ = src.dim() == 0 ? src.view(1) : src;
+
+  TORCH_CHECK_INDEX(index.min().item<int64_t>() >= 0 &&
+                    index.max().item<int64_t>() < self_.size(dim),
+                    "scatter_add_(): index out of range for self of size ", self_.size(dim),
+                    " at dimension ", dim);
+
+  // offset = sum over d of (d == dim ? index : coordinate d) * stride d
+  std::vector<int64_t> strides(self_.dim());
+  int64_t stride = 1;
+  for (int64_t d = self_.dim() - 1; d >= 0; d--) {
+    strides[d] = stride;
+    stride *= self_.size(d);
+  }
+  Tensor offsets = index_ * strides[dim];
+  for (int64_t d = 0; d < index_.dim(); d++) {
+    if (d == dim || index_.size(d) == 1) {
+      continue;
+    }
+    std::vector<int64_t> shape(index_.dim(), 1);
+    shape[d] = index_.size(d);
+    offsets = offsets + at::arange(index_.size(d), index_.options()).mul_(strides[d]).view(shape);
+  }
+
+  // Only the part of src covered by index is scattered.
+  Tensor values = src_.as_strided(index_.sizes(), src_.strides(), src_.storage_offset())
+      .contiguous().view({-1, 1});
+  Tensor sums = sorted_index_sum_cuda_kernel(offsets.reshape(-1), values, self_.numel());
+  self_.add_(sums.view(self_.sizes()));
+}
+
 void scatter_add_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  if (self.numel() > 0 &&
+      use_sorted_index_sum(self.scalar_type(), index.numel(), self.numel())) {
+    scatter_add_sorted_cuda(self, dim, index, src);
+    return;
+  }
   // Nondeterministic because of atomicAdd usage
   globalContext().alertNotDeterministic("scatter_add_cuda_kernel");
   cuda_scatter_gather_base_kernel</*is_scatter_like=*/true, /*cast_to_opaque=*/false>()(
@@ -0,0 +1,120 @@
+// The CUDA kernels of segment_reduce, see SegmentReduce.h. With an inner
+// dimension, a thread reduces an output element, and the threads of a warp
+// read contiguous elements of the rows of the same segment. Without one, the
+// values of a segment are contiguous, and a warp reduces the segment when
+// there are enough of them to keep its lanes busy: a thread per segment would
+// read strided memory and leave the threads of long segments far behind the
+// others.
+
+#include <ATen/ATen.h>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/DeviceUtils.cuh>
+#include <ATen/native/SegmentReduce.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+namespace {
+
+// The average segment length from which a warp reduces a segment
+constexpr int64_t kMinSegmentLengthPerWarp = 16;
+constexpr int kWarpsPerBlock = 4;
+constexpr int kThreadsPerBlock = 256;
+
+template <typename scalar_t, typename acc_t>
+__global__ void segment_reduce_thread_kernel(
+    scalar_t* output,
+    const scalar_t* data,
+    const int64_t* offsets,
+    SegmentReductionType reduction,
+    int64_t num_segments,
+    int64_t size,
+    int64_t inner_size,
+    int64_t output_numel) {
+  for (int64_t idx = blockIdx.x * (int64_t)blockDim.x + threadIdx.x; idx < output_numel;
+       idx += (int64_t)blockDim.x * gridDim.x) {
+    const int64_t i = idx % inner_size;
+    const int64_t s = (idx / inner_size) % num_segments;
+    const int64_t o = idx / (inner_size * num_segments);
+    const int64_t start = offsets[s];
+    const int64_t stop = offsets[s + 1];
+    const scalar_t* values = data + o * size * inner_size + i;
+    acc_t acc = segment_reduce_identity<acc_t>(reduction);
+    for (int64_t j = start; j < stop; j++) {
+      acc = segment_reduce_combine<acc_t>(reduction, acc, static_cast<acc_t>(values[j * inner_size]));
+    }
+    output[idx] = static_cast<scalar_t>(segment_reduce_finalize<acc_t>(reduction, acc, stop - start));
+  }
+}
+
+// blockDim is (C10_WARP_SIZE, kWarpsPerBlock), inner_size is 1.
+template <typename scalar_t, typename acc_t>
+__global__ void segment_reduce_warp_kernel(
+    scalar_t* output,
+    const scalar_t* data,
+    const int64_t* offsets,
+    SegmentReductionType reduction,
+    int64_t num_segments,
+    int64_t size,
+    int64_t output_numel) {
+  for (int64_t k = blockIdx.x * (int64_t)blockDim.y + threadIdx.y; k < output_numel;
+       k += (int64_t)blockDim.y * gridDim.x) {
+    const int64_t s = k % num_segments;
+    const int64_t o = k / num_segments;
+    const int64_t start = offsets[s];
+    const int64_t stop = offsets[s + 1];
+    const scalar_t* values = data + o * size;
+    acc_t acc = segment_reduce_identity<acc_t>(reduction);
+    for (int64_t j = start + threadIdx.x; j < stop; j += C10_WARP_SIZE) {
+      acc = segment_reduce_combine<acc_t>(reduction, acc, static_cast<acc_t>(values[j]));
+    }
+#pragma unroll
+    for (int offset = C10_WARP_SIZE / 2; offset > 0; offset /= 2) {
+      acc = segment_reduce_combine<acc_t>(reduction, acc, WARP_SHFL_DOWN(acc, offset));
+    }
+    if (threadIdx.x == 0) {
+      output[k] = static_cast<scalar_t>(segment_reduce_finalize<acc_t>(reduction, acc, stop - start));
+    }
+  }
+}
+
+void segment_reduce_kernel_impl(
+    Tensor& output,
+    const Tensor& data,
+    SegmentReductionType reduction,
+    const Tensor& offsets,
+    int64_t outer_size,
+    int64_t inner_size) {
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t size = data.numel() / (outer_size * inner_size);
+  const int64_t output_numel = output.numel();
+  const bool warp_per_segment = inner_size == 1 && size >= kMinSegmentLengthPerWarp * num_segments;
+  const int64_t max_blocks = at::cuda::getCurrentDeviceProperties()->multiProcessorCount * 32;
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, data.scalar_type(), "segment_reduce_cuda", [&] {
+    using acc_t = acc_type<scalar_t, true>;
+    if (warp_per_segment) {
+      const dim3 block(C10_WARP_SIZE, kWarpsPerBlock);
+      const int64_t grid = std::min(max_blocks, (output_numel + kWarpsPerBlock - 1) / kWarpsPerBlock);
+      segment_reduce_warp_kernel<scalar_t, acc_t><<<grid, block, 0, stream>>>(
+          output.data_ptr<scalar_t>(), data.data_ptr<scalar_t>(), offsets.data_ptr<int64_t>(),
+          reduction, num_segments, size, output_numel);
+    } else {
+      const int64_t grid = std::min(max_blocks, (output_numel + kThreadsPerBlock - 1) / kThreadsPerBlock);
+      segment_reduce_thread_kernel<scalar_t, acc_t><<<grid, kThreadsPerBlock, 0, stream>>>(
+          output.data_ptr<scalar_t>(), data.data_ptr<scalar_t>(), offsets.data_ptr<int64_t>(),
+          reduction, num_segments, size, inner_size, output_numel);
+    }
+    AT_CUDA_CHECK(cudaGetLastError()); // catch launch errors
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_kernel_impl);
+
+}} // namespace at::native
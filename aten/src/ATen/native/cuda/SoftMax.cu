@@ -712,7 +712,7 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
       AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "host_softmax", [&] {
       using accscalar_t = acc_type<scalar_t, true>;
       if (!half_to_float) {
-        if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+        if (dim_size <= max_persistent_softmax_elements && dim_size*sizeof(scalar_t) <= max_persistent_softmax_elements*sizeof(float)) {
           dispatch_softmax_forward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
@@ -724,7 +724,7 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
           );
         }
       } else {
-        if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+        if (dim_size <= max_persistent_softmax_elements && dim_size*sizeof(scalar_t) <= max_persistent_softmax_elements*sizeof(float)) {
           dispatch_softmax_forward<scalar_t, accscalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
@@ -802,7 +802,7 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
     AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "host_softmax_backward", [&] {
     using accscalar_t = acc_type<scalar_t, true>;
     if (!half_to_float) {
-      if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+      if (dim_size <= max_persistent_softmax_elements && dim_size*sizeof(scalar_t) <= max_persistent_softmax_elements*sizeof(float)) {
         dispatch_softmax_backward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
       } else {
@@ -814,7 +814,7 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
         );
       }
     } else {
-      if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+      if (dim_size <= max_persistent_softmax_elements && dim_size*sizeof(scalar_t) <= max_persistent_softmax_elements*sizeof(float)) {
         dispatch_softmax_backward<accscalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<accscalar_t>(), output.data_ptr<accscalar_t>(), dim_size, dim_size, outer_size);
       } else {
@@ -892,5 +892,79 @@ Tensor softmax_backward_cuda(const Tensor &grad, const Tensor &output, int64_t d
   return host_softmax_backward<SoftMaxBackwardEpilogue,false>(tmp, output, dim, half_to_float);
 }
 
+Tensor scale_mask_softmax_cuda(const Tensor& input_, const Tensor& mask_, double scale){
+  TORCH_CHECK(input_.dim() > 0, "_scale_mask_softmax: expected a tensor with at least one dimension");
+  TORCH_CHECK(mask_.scalar_type() == ScalarType::Bool || mask_.scalar_type() == input_.scalar_type(),
+              "_scale_mask_softmax: expected a boolean mask or a mask of the input dtype ",
+              input_.scalar_type(), ", but got ", mask_.scalar_type());
+  const bool is_bool_mask = mask_.scalar_type() == ScalarType::Bool;
+  const int64_t dim_size = input_.size(-1);
+  if (dim_size > max_persistent_softmax_elements) {
+    auto scaled = input_ * scale;
+    auto masked = is_bool_mask
+        ? scaled.masked_fill(mask_, -std::numeric_limits<double>::infinity())
+        : scaled + mask_;
+    return at::_softmax(masked, -1, false);
+  }
+  auto input = input_.contiguous();
+  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (input.numel() == 0) {
+    return output;
+  }
+  // A mask that only broadcasts over leading dimensions, e.g. one (L, L) mask for
+  // every head and batch, is read in place: row i of the input uses row
+  // i % mask_batch_size of the mask. Any other mask is expanded first.
+  auto mask = mask_;
+  while (mask.dim() > 0 && mask.size(0) == 1) {
+    mask = mask.squeeze(0);
+  }
+  if (mask.dim() == 0 || mask.sizes() != input.sizes().slice(input.dim() - mask.dim())) {
+    mask = mask_.expand(input.sizes());
+  }
+  mask = mask.contiguous();
+  const int64_t outer_size = input.numel() / dim_size;
+  const int64_t mask_batch_size = mask.numel() / dim_size;
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, input.scalar_type(), "scale_mask_softmax", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "scale_mask_softmax", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      if (is_bool_mask) {
+        dispatch_scale_mask_softmax_forward<scalar_t, scalar_t, accscalar_t, bool>(
+            output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), mask.data_ptr<bool>(), mask_batch_size,
+            static_cast<accscalar_t>(scale), dim_size, dim_size, outer_size);
+      } else {
+        dispatch_scale_mask_softmax_forward<scalar_t, scalar_t, accscalar_t, scalar_t>(
+            output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), mask.data_ptr<scalar_t>(), mask_batch_size,
+            static_cast<accscalar_t>(scale), dim_size, dim_size, outer_size);
+      }
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+Tensor scale_mask_softmax_backward_cuda(const Tensor& grad, const Tensor& output_, double scale){
+  const int64_t dim_size = output_.size(-1);
+  auto output = output_.contiguous();
+  Tensor tmp = (grad * output).contiguous();
+  if (dim_size > max_persistent_softmax_elements) {
+    return host_softmax_backward<SoftMaxBackwardEpilogue,false>(tmp, output, -1, false).mul_(scale);
+  }
+  Tensor gI = at::empty_like(output, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (output.numel() == 0) {
+    return gI;
+  }
+  const int64_t outer_size = output.numel() / dim_size;
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, output.scalar_type(), "scale_mask_softmax_backward", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "scale_mask_softmax_backward", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      dispatch_scale_mask_softmax_backward<scalar_t, scalar_t, accscalar_t>(
+          gI.data_ptr<scalar_t>(), tmp.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(),
+          static_cast<accscalar_t>(scale), dim_size, dim_size, outer_size);
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return gI;
+}
+
 }
 }
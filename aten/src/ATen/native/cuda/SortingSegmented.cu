@@ -0,0 +1,247 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/LegacyTHFunctionsCUDA.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/NumericLimits.cuh>
+#include <ATen/native/SortingUtils.h>
+#include <c10/macros/Macros.h>
+
+#include <cub/block/block_load.cuh>
+#include <cub/block/block_radix_sort.cuh>
+
+#include <limits>
+#include <type_traits>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Segmented sort: one block sorts one slice with a block-wide radix sort.
+// The slice is read from global memory once, kept in registers while it is
+// sorted and the first k elements are written back, so a single launch
+// handles thousands of short slices (beam search, per-row ranking) with no
+// temporary storage. The legacy paths either sort one slice per block with a
+// bitonic network in shared memory (slices up to 2048 elements) or fall back
+// to a global Thrust sort of all slices at once, and topk runs a multi-pass
+// radix selection per slice before sorting the selected elements.
+
+// Longest slices one block sorts. 8 byte keys need twice the shared memory.
+constexpr int64_t kSegmentedSortMaxSize = 8192;
+constexpr int64_t kSegmentedSortMaxSizeWide = 4096;
+
+template <typename scalar_t, bool is_floating_point = std::is_floating_point<scalar_t>::value>
+struct SegmentedSortKey {
+  static __device__ __forceinline__ scalar_t canonicalize(scalar_t v) {
+    return v;
+  }
+  // the key that sorts after every other one in ascending order
+  static __device__ __forceinline__ scalar_t last() {
+    return at::numeric_limits<scalar_t>::upper_bound();
+  }
+};
+
+// NaN sorts after every other value, as in the other CUDA sorts. Radix
+// sorting orders NaNs by their bit pattern, so they are all mapped to the
+// same positive NaN on load.
+template <typename scalar_t>
+struct SegmentedSortKey<scalar_t, true> {
+  static __device__ __forceinline__ scalar_t canonicalize(scalar_t v) {
+    return v != v ? static_cast<scalar_t>(NAN) : v;
+  }
+  static __device__ __forceinline__ scalar_t last() {
+    return static_cast<scalar_t>(NAN);
+  }
+};
+
+// Sorts the n elements of every contiguous row of keys and writes the first k
+// of them with their positions in the row to the contiguous rows of values
+// and indices.
+template <typename scalar_t, int BLOCK_THREADS, int ITEMS_PER_THREAD>
+C10_LAUNCH_BOUNDS_1(BLOCK_THREADS)
+__global__ void segmentedSortKernel(
+    const scalar_t* keys,
+    scalar_t* values,
+    int64_t* indices,
+    int n,
+    int k,
+    bool descending) {
+  using BlockLoad = cub::BlockLoad<scalar_t, BLOCK_THREADS, ITEMS_PER_THREAD, cub::BLOCK_LOAD_TRANSPOSE>;
+  using BlockSort = cub::BlockRadixSort<scalar_t, BLOCK_THREADS, ITEMS_PER_THREAD, int>;
+  __shared__ union {
+    typename BlockLoad::TempStorage load;
+    typename BlockSort::TempStorage sort;
+  } storage;
+
+  const int64_t row = blockIdx.x;
+  keys += row * n;
+  values += row * k;
+  indices += row * k;
+
+  // The tile is padded past n with the key that sorts last in the requested
+  // direction. Padding sits behind all real elements in the blocked
+  // arrangement and the radix sort is stable, so real elements equal to the
+  // padding key still come first.
+  const scalar_t pad = descending
+      ? at::numeric_limits<scalar_t>::lower_bound()
+      : SegmentedSortKey<scalar_t>::last();
+  scalar_t tile[ITEMS_PER_THREAD];
+  int position[ITEMS_PER_THREAD];
+  BlockLoad(storage.load).Load(keys, tile, n, pad);
+  #pragma unroll
+  for (int i = 0; i < ITEMS_PER_THREAD; i++) {
+    tile[i] = SegmentedSortKey<scalar_t>::canonicalize(tile[i]);
+    position[i] = threadIdx.x * ITEMS_PER_THREAD + i;
+  }
+  __syncthreads();
+
+  if (descending) {
+    BlockSort(storage.sort).SortDescendingBlockedToStriped(tile, position);
+  } else {
+    BlockSort(storage.sort).SortBlockedToStriped(tile, position);
+  }
+
+  #pragma unroll
+  for (int i = 0; i < ITEMS_PER_THREAD; i++) {
+    const int rank = i * BLOCK_THREADS + threadIdx.x;
+    if (rank < k) {
+      values[rank] = tile[i];
+      indices[rank] = position[i];
+    }
+  }
+}
+
+template <typename scalar_t>
+void launch_segmented_sort(
+    const Tensor& keys,
+    Tensor& values,
+    Tensor& indices,
+    int64_t n,
+    int64_t k,
+    bool descending) {
+  const int64_t rows = keys.numel() / n;
+  const scalar_t* keys_data = keys.data_ptr<scalar_t>();
+  scalar_t* values_data = values.data_ptr<scalar_t>();
+  int64_t* indices_data = indices.data_ptr<int64_t>();
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+#define LAUNCH_SEGMENTED_SORT(THREADS, ITEMS)                              \
+  segmentedSortKernel<scalar_t, THREADS, ITEMS>                            \
+      <<<rows, THREADS, 0, stream>>>(                                      \
+          keys_data, values_data, indices_data, n, k, descending)
+
+  // The tile of a block holds THREADS * ITEMS elements. The largest tile is
+  // only used for keys of at most 4 bytes, see kSegmentedSortMaxSizeWide.
+  if (n <= 128) {
+    LAUNCH_SEGMENTED_SORT(32, 4);
+  } else if (n <= 512) {
+    LAUNCH_SEGMENTED_SORT(64, 8);
+  } else if (n <= 1024) {
+    LAUNCH_SEGMENTED_SORT(128, 8);
+  } else if (n <= 2048) {
+    LAUNCH_SEGMENTED_SORT(256, 8);
+  } else if (n <= 4096) {
+    LAUNCH_SEGMENTED_SORT(256, 16);
+  } else {
+    LAUNCH_SEGMENTED_SORT(512, sizeof(scalar_t) > 4 ? 8 : 16);
+  }
+#undef LAUNCH_SEGMENTED_SORT
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+bool can_use_segmented_sort(const Tensor& self, int64_t dim) {
+  if (self.dim() == 0 || self.numel() == 0) {
+    return false;
+  }
+  const auto type = self.scalar_type();
+  if (type != kFloat && type != kDouble &&
+      !at::isIntegralType(type, /*includeBool=*/false)) {
+    return false;
+  }
+  const int64_t n = self.size(dim);
+  const int64_t max_size = elementSize(type) > 4 ? kSegmentedSortMaxSizeWide : kSegmentedSortMaxSize;
+  return n <= max_size &&
+      self.numel() / n <= std::numeric_limits<int>::max();
+}
+
+// Sorts self along dim and writes the first k elements of every slice to
+// values and indices, which already have their final sizes.
+void segmented_sort(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    int64_t k,
+    bool descending) {
+  const int64_t n = self.size(dim);
+  Tensor keys = self.transpose(dim, -1).contiguous();
+  Tensor values_t = values.transpose(dim, -1);
+  Tensor indices_t = indices.transpose(dim, -1);
+  const bool write_direct = values_t.is_contiguous() && indices_t.is_contiguous();
+  Tensor sorted_values = write_direct ? values_t : at::empty(values_t.sizes(), values.options());
+  Tensor sorted_indices = write_direct ? indices_t : at::empty(indices_t.sizes(), indices.options());
+
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "segmented_sort", [&] {
+    launch_segmented_sort<scalar_t>(keys, sorted_values, sorted_indices, n, k, descending);
+  });
+
+  if (!write_direct) {
+    values_t.copy_(sorted_values);
+    indices_t.copy_(sorted_indices);
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> sort_out_cuda(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  // Slices the bitonic sort handles in place keep doing so unless they are
+  // already laid out as contiguous rows.
+  const bool is_rows = dim == self.dim() - 1 && self.is_contiguous();
+  if (can_use_segmented_sort(self, dim) &&
+      (is_rows || self.size(dim) > 2048)) {
+    _allocate_or_resize_output_with_indices(values, indices, self, dim, self.size(dim));
+    segmented_sort(values, indices, self, dim, self.size(dim), descending);
+    return std::forward_as_tuple(values, indices);
+  }
+  return legacy::cuda::_th_sort_out(values, indices, self, dim_, descending);
+}
+
+std::tuple<Tensor, Tensor> sort_cuda(const Tensor& self, int64_t dim, bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  sort_out_cuda(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> topk_out_cuda(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim_,
+    bool largest,
+    bool sorted) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  // Sorting a slice that fits in one block costs a single pass over it, less
+  // than the radix selection, and the result comes out sorted.
+  if (can_use_segmented_sort(self, dim)) {
+    TORCH_CHECK(k >= 0 && k <= self.size(dim), "selected index k out of range");
+    _allocate_or_resize_output_with_indices(values, indices, self, dim, k);
+    if (k > 0) {
+      segmented_sort(values, indices, self, dim, k, largest);
+    }
+    return std::forward_as_tuple(values, indices);
+  }
+  return legacy::cuda::_th_topk_out(values, indices, self, k, dim_, largest, sorted);
+}
+
+} // namespace native
+} // namespace at
@@ -188,11 +188,23 @@ static inline Tensor _run_cufft(
   // set output
   auto output = at::empty(output_sizes, input.options());
 
+  // Cached plans can be shared by threads running on different streams. The
+  // plan is bound to this call's stream and work area only while the lock is
+  // held; the execution itself is queued on the stream, so the lock does not
+  // wait for the GPU.
+  std::unique_lock<std::mutex> exec_lock(config.exec_mutex());
+
   // set to current stream
   CUFFT_CHECK(cufftSetStream(plan, at::cuda::getCurrentCUDAStream()));
 
-  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
-  CUFFT_CHECK(cufftSetWorkArea(plan, ws.data_ptr()));
+  // The work area comes from the caching allocator for this execution only.
+  // Freeing it is ordered on the current stream, so plans executed on the
+  // same stream reuse the same block and idle plans hold no memory.
+  Tensor ws;
+  if (config.workspace_size() > 0) {
+    ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
+    CUFFT_CHECK(cufftSetWorkArea(plan, ws.data_ptr()));
+  }
 
   // run
 #ifdef __HIP_PLATFORM_HCC__
@@ -234,6 +246,7 @@ static inline Tensor _run_cufft(
   CUFFT_CHECK(cufftXtExec(plan, input.data_ptr(), output.data_ptr(),
     inverse ? CUFFT_INVERSE : CUFFT_FORWARD));
 #endif
+  exec_lock.unlock();
 
   // rescale if needed by normalized flag or inverse transform
   auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
@@ -299,7 +312,9 @@ void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size)
     "cufft_set_plan_cache_max_size: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).resize(max_size);
+  CuFFTParamsLRUCache& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.resize(max_size);
 }
 
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index) {
@@ -307,7 +322,9 @@ int64_t cufft_get_plan_cache_size_impl(int64_t device_index) {
     "cufft_get_plan_cache_size: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).size();
+  CuFFTParamsLRUCache& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.size();
 }
 
 void cufft_clear_plan_cache_impl(int64_t device_index) {
@@ -315,7 +332,19 @@ void cufft_clear_plan_cache_impl(int64_t device_index) {
     "cufft_clear_plan_cache: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).clear();
+  CuFFTParamsLRUCache& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.clear();
+}
+
+CuFFTPlanCacheStats cufft_get_plan_cache_stats_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_stats: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  CuFFTParamsLRUCache& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.stats();
 }
 
 } // namespace at::native::detail
@@ -370,13 +399,20 @@ Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
     CuFFTParams params;
     setCuFFTParams(&params, input, signal_ndim, complex_input,
       complex_output, checked_signal_sizes, onesided);
-    std::lock_guard<std::mutex> guard(plan_cache.mutex);
-    if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
-      const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(params),
-                                             input, signal_ndim, complex_input,
-                                             complex_output, checked_signal_sizes,
-                                             onesided, output_sizes);
-      return _run_cufft(config, input, signal_ndim, complex_input,
+    // The cache lock only covers the lookup. The shared config stays valid
+    // if it is evicted meanwhile, and _run_cufft locks the plan itself.
+    std::shared_ptr<const CuFFTConfig> config;
+    {
+      std::lock_guard<std::mutex> guard(plan_cache.mutex);
+      if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
+        config = plan_cache.try_emplace_value(std::move(params),
+                                              input, signal_ndim, complex_input,
+                                              complex_output, checked_signal_sizes,
+                                              onesided, output_sizes);
+      }
+    }
+    if (config) {
+      return _run_cufft(*config, input, signal_ndim, complex_input,
                         complex_output, inverse, checked_signal_sizes, normalized,
                         onesided, output_sizes, input_was_cloned);
     }
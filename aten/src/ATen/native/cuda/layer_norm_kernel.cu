@@ -2,15 +2,19 @@
 
 #include <ATen/ATen.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/CUDAGeneratorImpl.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <ATen/native/cuda/block_reduce.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
 
+#include <curand_kernel.h>
+
 namespace at {
 namespace native {
 
@@ -18,6 +22,8 @@ namespace {
 
 constexpr int kCUDANumThreads = 256;
 constexpr int kColwiseReduceTileSize = 32;
+// Philox produces four uniforms per call, see fused_dropout_kernel.
+constexpr int kDropoutUnroll = 4;
 
 template <typename T>
 __global__ void RowwiseMomentsCUDAKernel(
@@ -71,6 +77,79 @@ __global__ void LayerNormForwardCUDAKernel(
   }
 }
 
+// Computes H = R + X * mask / p and Y = layer_norm(H) for one row per block,
+// so the dropout output and the residual sum never take a round trip through
+// global memory before the statistics are known. H and mask are saved for
+// the backward pass. p is the keep probability, as in _fused_dropout.
+template <typename T>
+__global__ void DropoutAddLayerNormForwardCUDAKernel(
+    int64_t N,
+    acc_type<T, true> p,
+    acc_type<T, true> eps,
+    const T* X,
+    const T* R,
+    const T* gamma,
+    const T* beta,
+    PhiloxCudaState philox_args,
+    T* Y,
+    T* H,
+    uint8_t* mask,
+    T* mean,
+    T* rstd) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC m_shared[C10_WARP_SIZE];
+  __shared__ T_ACC v_shared[C10_WARP_SIZE];
+  __shared__ T_ACC moments[2];
+  const int64_t i = blockIdx.x;
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  curandStatePhilox4_32_10_t state;
+  curand_init(seeds.first, i * blockDim.x + threadIdx.x, seeds.second, &state);
+  const T_ACC scale = T_ACC(1) / p;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j0 = threadIdx.x; j0 < N; j0 += blockDim.x * kDropoutUnroll) {
+    float4 rand = curand_uniform4(&state);
+#pragma unroll
+    for (int k = 0; k < kDropoutUnroll; ++k) {
+      const int64_t j = j0 + k * blockDim.x;
+      if (j < N) {
+        const int64_t index = i * N + j;
+        const bool keep = (&rand.x)[k] < p;
+        const T h = static_cast<T_ACC>(R[index]) +
+            (keep ? static_cast<T_ACC>(X[index]) * scale : T_ACC(0));
+        H[index] = h;
+        mask[index] = keep;
+        sum1 += static_cast<T_ACC>(h);
+        sum2 += static_cast<T_ACC>(h) * static_cast<T_ACC>(h);
+      }
+    }
+  }
+  sum1 = cuda_utils::BlockReduceSum<T_ACC>(sum1, m_shared);
+  sum2 = cuda_utils::BlockReduceSum<T_ACC>(sum2, v_shared);
+  if (threadIdx.x == 0) {
+    const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
+    sum1 *= s;
+    sum2 = c10::cuda::compat::max(sum2 * s - sum1 * sum1, T_ACC(0));
+    mean[i] = sum1;
+    rstd[i] = c10::cuda::compat::rsqrt(sum2 + eps);
+    moments[0] = static_cast<T_ACC>(mean[i]);
+    moments[1] = static_cast<T_ACC>(rstd[i]);
+  }
+  __syncthreads();
+  const T_ACC mean_v = moments[0];
+  const T_ACC rstd_v = moments[1];
+  // Every thread only reads back the elements of H it wrote above.
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    const T_ACC gamma_v =
+        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+    const T_ACC beta_v =
+        beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta[j]);
+    Y[index] = (static_cast<T_ACC>(H[index]) - mean_v) * rstd_v * gamma_v +
+        beta_v;
+  }
+}
+
 template <typename T>
 __global__ void ComputeInternalGradientsCUDAKernel(
     int64_t N,
@@ -302,6 +381,50 @@ void LayerNormKernelImpl(
       });
 }
 
+template <typename T>
+void DropoutAddLayerNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    double p,
+    double eps,
+    PhiloxCudaState philox_args,
+    Tensor* Y,
+    Tensor* H,
+    Tensor* mask,
+    Tensor* mean,
+    Tensor* rstd) {
+  using T_ACC = acc_type<T, true>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK_EQ(R.numel(), M * N);
+  DCHECK(!gamma.defined() || gamma.numel() == N);
+  DCHECK(!beta.defined() || beta.numel() == N);
+  const T* X_data = X.data_ptr<T>();
+  const T* R_data = R.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  DropoutAddLayerNormForwardCUDAKernel<T>
+      <<<M, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+          N,
+          static_cast<T_ACC>(p),
+          static_cast<T_ACC>(eps),
+          X_data,
+          R_data,
+          gamma_data,
+          beta_data,
+          philox_args,
+          Y->data_ptr<T>(),
+          H->data_ptr<T>(),
+          mask->data_ptr<uint8_t>(),
+          mean->data_ptr<T>(),
+          rstd->data_ptr<T>());
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
 template <typename T>
 void LayerNormBackwardKernelImplInternal(
     const Tensor& dY,
@@ -465,6 +588,88 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cuda(
 }
 
 
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_cuda(
+    const Tensor& input,
+    const Tensor& residual,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double p,
+    double eps,
+    c10::optional<Generator> gen_) {
+  TORCH_CHECK(input.sizes() == residual.sizes(),
+              "_fused_dropout_add_layer_norm: expected input and residual to have the same size, got ",
+              input.sizes(), " and ", residual.sizes());
+  TORCH_CHECK(input.scalar_type() == residual.scalar_type(),
+              "_fused_dropout_add_layer_norm: expected input and residual to have the same dtype, got ",
+              input.scalar_type(), " and ", residual.scalar_type());
+  TORCH_CHECK(p > 0 && p <= 1,
+              "_fused_dropout_add_layer_norm: expected keep probability in (0, 1], got ", p);
+  auto gen = get_generator_or_default<CUDAGeneratorImpl>(gen_, cuda::detail::getDefaultCUDAGenerator());
+  Tensor X = input.contiguous();
+  Tensor R = residual.contiguous();
+  Tensor Y = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor H = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor mask = at::empty(X.sizes(), X.options().dtype(kByte));
+  Tensor mean = at::empty({M}, X.options());
+  Tensor rstd = at::empty({M}, X.options());
+  if (M > 0 && N > 0) {
+    // Number of uniforms each thread draws, to offset the philox counter.
+    const int64_t counter_offset =
+        ((N - 1) / (cuda_utils::kCUDABlockReduceNumThreads * kDropoutUnroll) + 1) * kDropoutUnroll;
+    PhiloxCudaState rng_engine_inputs;
+    {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(gen->mutex_);
+      rng_engine_inputs = gen->philox_cuda_state(counter_offset);
+    }
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+        X.scalar_type(), "DropoutAddLayerNormKernelImpl", [&]() {
+          AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "DropoutAddLayerNormKernelImpl", [&] {
+            DropoutAddLayerNormKernelImplInternal<scalar_t>(
+                X, R, gamma, beta, M, N, p, eps, rng_engine_inputs,
+                &Y, &H, &mask, &mean, &rstd);
+          });
+        });
+  }
+  return std::make_tuple(
+      std::move(Y), std::move(H), std::move(mask), std::move(mean), std::move(rstd));
+}
+
+// The layer norm gradient with respect to H is the gradient of the residual;
+// the input gradient additionally goes through the dropout mask.
+std::tuple<Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_backward_cuda(
+    const Tensor& dY,
+    const Tensor& H,
+    const Tensor& mask,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    double p,
+    std::array<bool, 4> grad_input_mask) {
+  Tensor dH;
+  Tensor dgamma;
+  Tensor dbeta;
+  std::tie(dH, dgamma, dbeta) = layer_norm_backward_cuda(
+      dY.contiguous(), H, mean, rstd, gamma, M, N,
+      {grad_input_mask[0] || grad_input_mask[1], grad_input_mask[2], grad_input_mask[3]});
+  Tensor dX;
+  if (grad_input_mask[0]) {
+    dX = at::_masked_scale(dH, mask, 1.0 / p);
+  }
+  return std::make_tuple(
+      std::move(dX),
+      grad_input_mask[1] ? std::move(dH) : Tensor(),
+      std::move(dgamma),
+      std::move(dbeta));
+}
+
+
 REGISTER_DISPATCH(LayerNormKernel, &LayerNormKernelImpl);
 REGISTER_DISPATCH(LayerNormBackwardKernel, &LayerNormBackwardKernelImpl);
 
@@ -80,6 +80,8 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
 #include <ATen/cudnn/Utils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cudnn/ConvBenchmarkCache.h>
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <ATen/TensorUtils.h>
@@ -88,8 +90,12 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <stdint.h>
 #include <unordered_map>
 
@@ -215,6 +221,9 @@ struct ConvolutionParams
   int dilation[max_dim];
   int64_t groups;
   bool deterministic;
+  // major * 10 + minor, the algorithms found for one GPU architecture are
+  // not the best ones for another. See Note [Persistent benchmark cache]
+  int compute_capability;
   // NB: transposed purposely omitted: transposed just swaps
   // forward and backward, so you can reuse the benchmark entry,
 };
@@ -250,6 +259,8 @@ void setConvolutionParams(
   // CuDNN, but it doesn't seem worth the effort to actually do this.
   params->groups = groups;
   params->deterministic = deterministic;
+  const auto* prop = at::cuda::getCurrentDeviceProperties();
+  params->compute_capability = prop->major * 10 + prop->minor;
 }
 
 // Convenience struct for passing around descriptors and data
@@ -298,6 +309,156 @@ BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// Note [Persistent benchmark cache]
+// Benchmarking every new convolution shape is slow, and each process of a job
+// repeats it. The cache can be saved to a file with
+// torch.backends.cudnn.save_benchmark_cache and loaded by the next processes,
+// also from the TORCH_CUDNN_BENCHMARK_CACHE environment variable the first
+// time a convolution is benchmarked. The file starts with
+//
+//     cudnn_benchmark_cache <format> <cuDNN version> <sizeof(ConvolutionParams)>
+//
+// and an algorithm found by another cuDNN version is not trusted, so such a
+// file loads no entries. The GPU architecture is in the ConvolutionParams.
+// Each following line is one entry:
+//
+//     <fwd|bwd_data|bwd_filter> <hex of the ConvolutionParams bytes> <algo> <mathType> <memory> <determinism>
+//
+// The params are compared bytewise like in ParamsHash, and
+// setConvolutionParams zeroes their padding, so the bytes are the key.
+
+constexpr const char* kBenchmarkCacheMagic = "cudnn_benchmark_cache";
+constexpr int kBenchmarkCacheFormat = 1;
+
+template <typename T>
+size_t writeBenchmarkCache(std::ostream& out, const char* kind, BenchmarkCache<T>& cache) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  for (const auto& entry : cache.map) {
+    out << kind << ' ';
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&entry.first);
+    for (size_t i = 0; i < sizeof(ConvolutionParams); ++i) {
+      out << kHexDigits[bytes[i] >> 4] << kHexDigits[bytes[i] & 0xf];
+    }
+    out << ' ' << static_cast<int>(entry.second.algo)
+        << ' ' << static_cast<int>(entry.second.mathType)
+        << ' ' << entry.second.memory
+        << ' ' << static_cast<int>(entry.second.determinism) << '\n';
+  }
+  return cache.map.size();
+}
+
+// Returns whether the entry was added.
+template <typename T>
+bool readBenchmarkCacheEntry(std::istream& in, BenchmarkCache<T>& cache) {
+  std::string hex;
+  int algo, mathType, determinism;
+  size_t memory;
+  in >> hex >> algo >> mathType >> memory >> determinism;
+  TORCH_CHECK(in && hex.size() == 2 * sizeof(ConvolutionParams),
+              "malformed entry in the cuDNN benchmark cache");
+  ConvolutionParams params;
+  auto* bytes = reinterpret_cast<uint8_t*>(&params);
+  for (size_t i = 0; i < sizeof(ConvolutionParams); ++i) {
+    bytes[i] = static_cast<uint8_t>(std::stoi(hex.substr(2 * i, 2), nullptr, 16));
+  }
+  T perf;
+  memset(&perf, 0, sizeof(perf));
+  perf.algo = static_cast<decltype(perf.algo)>(algo);
+  perf.status = CUDNN_STATUS_SUCCESS;
+  perf.memory = memory;
+  perf.determinism = static_cast<cudnnDeterminism_t>(determinism);
+  perf.mathType = static_cast<cudnnMathType_t>(mathType);
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  return cache.map.emplace(params, perf).second;
+}
+
+size_t readBenchmarkCache(std::istream& in) {
+  std::string magic;
+  int format;
+  size_t version, params_size;
+  in >> magic >> format >> version >> params_size;
+  TORCH_CHECK(in && magic == kBenchmarkCacheMagic,
+              "not a cuDNN benchmark cache file");
+  if (format != kBenchmarkCacheFormat || version != cudnnGetVersion() ||
+      params_size != sizeof(ConvolutionParams)) {
+    return 0;
+  }
+  size_t added = 0;
+  std::string kind;
+  while (in >> kind) {
+    if (kind == "fwd") {
+      added += readBenchmarkCacheEntry(in, fwd_algos);
+    } else if (kind == "bwd_data") {
+      added += readBenchmarkCacheEntry(in, bwd_data_algos);
+    } else if (kind == "bwd_filter") {
+      added += readBenchmarkCacheEntry(in, bwd_filter_algos);
+    } else {
+      TORCH_CHECK(false, "unknown entry kind in the cuDNN benchmark cache: ", kind);
+    }
+  }
+  return added;
+}
+
+void loadBenchmarkCacheFromEnv() {
+  static const bool loaded = [] {
+    const char* path = std::getenv("TORCH_CUDNN_BENCHMARK_CACHE");
+    if (path && *path) {
+      std::ifstream in(path);
+      if (in) {
+        try {
+          readBenchmarkCache(in);
+        } catch (const c10::Error& e) {
+          TORCH_WARN("ignoring the cuDNN benchmark cache ", path, ": ", e.what_without_backtrace());
+        }
+      }
+    }
+    return true;
+  }();
+  (void)loaded;
+}
+
+namespace cudnn_conv {
+
+size_t load_benchmark_cache(const std::string& path) {
+  std::ifstream in(path);
+  TORCH_CHECK(in, "could not open the cuDNN benchmark cache ", path);
+  return readBenchmarkCache(in);
+}
+
+// The file is replaced atomically, so that processes saving to the same
+// path concurrently do not corrupt it.
+size_t save_benchmark_cache(const std::string& path) {
+  {
+    std::ifstream in(path);
+    if (in) {
+      readBenchmarkCache(in);
+    }
+  }
+  const std::string tmp_path = path + ".tmp" + std::to_string(std::random_device{}());
+  size_t saved = 0;
+  {
+    std::ofstream out(tmp_path);
+    TORCH_CHECK(out, "could not write the cuDNN benchmark cache ", tmp_path);
+    out << kBenchmarkCacheMagic << ' ' << kBenchmarkCacheFormat << ' '
+        << cudnnGetVersion() << ' ' << sizeof(ConvolutionParams) << '\n';
+    saved += writeBenchmarkCache(out, "fwd", fwd_algos);
+    saved += writeBenchmarkCache(out, "bwd_data", bwd_data_algos);
+    saved += writeBenchmarkCache(out, "bwd_filter", bwd_filter_algos);
+    out.close();
+    TORCH_CHECK(out, "could not write the cuDNN benchmark cache ", tmp_path);
+  }
+#ifdef _WIN32
+  // rename does not replace an existing file on Windows
+  std::remove(path.c_str());
+#endif
+  TORCH_CHECK(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+              "could not replace the cuDNN benchmark cache ", path);
+  return saved;
+}
+
+} // namespace cudnn_conv
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
@@ -665,6 +826,9 @@ public:
 
   void try_all(std::function<void (const perf_t &perf)> f) {
     bool only_use_default = args.params.deterministic && !benchmark;
+    if (benchmark) {
+      loadBenchmarkCacheFromEnv();
+    }
 
     auto& cache = search::cache();
     perf_t algoPerf;
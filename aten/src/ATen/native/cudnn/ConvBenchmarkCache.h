@@ -0,0 +1,24 @@
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <string>
+
+// Declares the persistence of the benchmark cache of Conv.cpp, which is used
+// by external consumers. See Note [Persistent benchmark cache]
+namespace at {
+namespace native {
+namespace cudnn_conv {
+
+// Writes the algorithms found so far to path, together with the entries
+// already in that file. Returns the number of entries written.
+TORCH_CUDA_API size_t save_benchmark_cache(const std::string& path);
+
+// Adds the entries of path which are not in the cache yet. Returns the number
+// of entries added, which is 0 when the file was written by another cuDNN
+// version.
+TORCH_CUDA_API size_t load_benchmark_cache(const std::string& path);
+
+} // namespace cudnn_conv
+} // namespace native
+} // namespace at
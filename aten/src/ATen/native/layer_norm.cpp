@@ -79,6 +79,48 @@ Tensor layer_norm(
   return std::get<0>(at::native_layer_norm(X, gamma, beta, M, N, eps));
 }
 
+// layer_norm(residual + dropout(input, p)), the post-norm step of a
+// transformer block. p is the drop probability as in dropout; on CUDA the
+// three ops run as a single kernel per row.
+Tensor dropout_add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double p,
+    double eps,
+    bool train,
+    c10::optional<Generator> gen) {
+  TORCH_CHECK(p >= 0 && p <= 1,
+              "dropout probability has to be between 0 and 1, but got ", p);
+  TORCH_CHECK(input.sizes() == residual.sizes(),
+              "dropout_add_layer_norm: expected input and residual to have the same size, got ",
+              input.sizes(), " and ", residual.sizes());
+
+  if (input.is_cuda() && train && p > 0 && p < 1 && input.numel() > 0 &&
+      residual.scalar_type() == input.scalar_type()) {
+    auto inputs = _prepare_layer_norm_inputs(input, normalized_shape, weight, bias);
+    auto X = std::get<0>(inputs);
+    auto gamma = std::get<1>(inputs);
+    auto beta = std::get<2>(inputs);
+    auto M = std::get<3>(inputs);
+    auto N = std::get<4>(inputs);
+
+    return std::get<0>(at::_fused_dropout_add_layer_norm(
+        X, residual.contiguous(), gamma, beta, M, N, 1 - p, eps, gen));
+  }
+
+  Tensor hidden;
+  if (train && p > 0) {
+    auto noise = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT).bernoulli_(1 - p, gen);
+    hidden = p == 1 ? residual + input * noise : residual + input * noise.div_(1 - p);
+  } else {
+    hidden = residual + input;
+  }
+  return at::layer_norm(hidden, normalized_shape, weight, bias, eps);
+}
+
 DEFINE_DISPATCH(LayerNormKernel);
 DEFINE_DISPATCH(LayerNormBackwardKernel);
 
@@ -35,9 +35,12 @@ std::tuple<Tensor, Tensor, Tensor> mkldnn_convolution_backward(
 #else // AT_MKLDNN_EBABLED
 
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/PrimitiveCache.h>
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/ConvUtils.h>
 
+#include <unordered_map>
+
 namespace {
 // Helper function for getting an ideep tensor out of an aten Tensor.
 // Note in case the aten Tensor is a dense tensor, the returned ideep
@@ -51,6 +54,11 @@ inline ideep::tensor get_mkldnn_tensor(const at::Tensor& tensor) {
     return at::native::itensor_view_from_dense(tensor);
   }
 }
+
+struct ConvolutionPrimitive {
+  dnnl::convolution_forward::primitive_desc desc;
+  dnnl::convolution_forward primitive;
+};
 }
 
 namespace at { namespace native {
@@ -70,31 +78,84 @@ ideep::tensor _mkldnn_convolution(
   std::vector<int64_t> output_sizes =
       conv_output_size(input_size, kernel_size, padding, stride, dilation);
 
+  const auto data_type = x.get_data_type();
+  const bool with_bias = b.has_value();
+
+  // The primitive is created for the `any` formats, so that MKL-DNN picks the
+  // blocked formats it computes fastest with; the formats the tensors are in
+  // are not part of the key, they are reordered as needed.
+  thread_local PrimitiveCache<ConvolutionPrimitive> cache;
+  const ConvolutionPrimitive conv = cache.get_or_create(
+      make_primitive_cache_key(
+          input_size,
+          kernel_size,
+          padding,
+          stride,
+          dilation,
+          groups,
+          with_bias,
+          data_type),
+      [&]() {
+        using tag = ideep::format_tag;
+        ideep::dims weights_size{kernel_size.cbegin(), kernel_size.cend()};
+        if (groups > 1) {
+          weights_size[0] /= groups;
+          weights_size.insert(weights_size.begin(), groups);
+        }
+        // MKL-DNN counts the dilation from 0, for a dense kernel
+        ideep::dims dilates;
+        for (const auto d : dilation) {
+          dilates.push_back(d - 1);
+        }
+        const ideep::tensor::desc src_desc(input_size, data_type, tag::any);
+        const ideep::tensor::desc weights_desc(weights_size, data_type, tag::any);
+        const ideep::tensor::desc dst_desc(output_sizes, data_type, tag::any);
+        const ideep::dims strides{stride.begin(), stride.end()};
+        const ideep::dims paddings{padding.begin(), padding.end()};
+
+        auto desc = with_bias
+            ? dnnl::convolution_forward::desc(
+                  dnnl::prop_kind::forward,
+                  dnnl::algorithm::convolution_direct,
+                  src_desc,
+                  weights_desc,
+                  ideep::tensor::desc({kernel_size[0]}, data_type, tag::any),
+                  dst_desc,
+                  strides,
+                  dilates,
+                  paddings,
+                  paddings)
+            : dnnl::convolution_forward::desc(
+                  dnnl::prop_kind::forward,
+                  dnnl::algorithm::convolution_direct,
+                  src_desc,
+                  weights_desc,
+                  dst_desc,
+                  strides,
+                  dilates,
+                  paddings,
+                  paddings);
+        dnnl::convolution_forward::primitive_desc primitive_desc(
+            desc, ideep::engine::cpu_engine());
+        return ConvolutionPrimitive{
+            primitive_desc, dnnl::convolution_forward(primitive_desc)};
+      });
+
+  const ideep::tensor src = x.reorder_if_differ_in(conv.desc.src_desc());
+  const ideep::tensor weights =
+      w.make_grouped_weights(groups).reorder_if_differ_in(
+          conv.desc.weights_desc());
   ideep::tensor y;
-  if (b.has_value()) {
-    ideep::convolution_forward::compute(
-        x,
-        w,
-        b.value(),
-        {output_sizes.cbegin(), output_sizes.cend()},
-        y,
-        {stride.begin(), stride.end()},
-        {dilation.begin(), dilation.end()},
-        {padding.begin(), padding.end()},
-        {padding.begin(), padding.end()},
-        groups);
-  } else {
-    ideep::convolution_forward::compute(
-        x,
-        w,
-        {output_sizes.cbegin(), output_sizes.cend()},
-        y,
-        {stride.begin(), stride.end()},
-        {dilation.begin(), dilation.end()},
-        {padding.begin(), padding.end()},
-        {padding.begin(), padding.end()},
-        groups);
+  y.init(conv.desc.dst_desc());
+
+  std::unordered_map<int, dnnl::memory> args{
+      {DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, weights}, {DNNL_ARG_DST, y}};
+  ideep::tensor bias;
+  if (with_bias) {
+    bias = b.value().reorder_if_differ_in(conv.desc.bias_desc());
+    args.insert({DNNL_ARG_BIAS, bias});
   }
+  conv.primitive.execute(ideep::stream::default_stream(), args);
   return y;
 }
 
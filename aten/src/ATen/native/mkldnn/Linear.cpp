@@ -20,10 +20,22 @@ Tensor mkldnn_linear(
 #else // AT_MKLDNN_EBABLED
 
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/PrimitiveCache.h>
+
+#include <unordered_map>
 
 namespace at {
 namespace native {
 
+namespace {
+
+struct InnerProductPrimitive {
+  dnnl::inner_product_forward::primitive_desc desc;
+  dnnl::inner_product_forward primitive;
+};
+
+} // namespace
+
 Tensor mkldnn_linear(
     const Tensor& self,
     const Tensor& weight,
@@ -40,13 +52,51 @@ Tensor mkldnn_linear(
   const ideep::tensor x = itensor_from_mkldnn(self_reshaped);
   const ideep::tensor w = itensor_from_mkldnn(weight);
 
+  const auto data_type = x.get_data_type();
+  const bool with_bias = bias.defined();
+  const ideep::dims src_size = x.get_dims();
+  const ideep::dims weights_size = w.get_dims();
+
+  // Created for the `any` formats, like the convolution primitives.
+  thread_local PrimitiveCache<InnerProductPrimitive> cache;
+  const InnerProductPrimitive inner_product = cache.get_or_create(
+      make_primitive_cache_key(src_size, weights_size, with_bias, data_type),
+      [&]() {
+        using tag = ideep::format_tag;
+        const ideep::tensor::desc src_desc(src_size, data_type, tag::any);
+        const ideep::tensor::desc weights_desc(weights_size, data_type, tag::any);
+        const ideep::tensor::desc dst_desc(
+            {src_size[0], weights_size[0]}, data_type, tag::any);
+        auto desc = with_bias
+            ? dnnl::inner_product_forward::desc(
+                  dnnl::prop_kind::forward,
+                  src_desc,
+                  weights_desc,
+                  ideep::tensor::desc({weights_size[0]}, data_type, tag::any),
+                  dst_desc)
+            : dnnl::inner_product_forward::desc(
+                  dnnl::prop_kind::forward, src_desc, weights_desc, dst_desc);
+        dnnl::inner_product_forward::primitive_desc primitive_desc(
+            desc, ideep::engine::cpu_engine());
+        return InnerProductPrimitive{
+            primitive_desc, dnnl::inner_product_forward(primitive_desc)};
+      });
+
+  const ideep::tensor src = x.reorder_if_differ_in(inner_product.desc.src_desc());
+  const ideep::tensor weights =
+      w.reorder_if_differ_in(inner_product.desc.weights_desc());
   ideep::tensor y;
-  if (bias.defined()) {
-    const ideep::tensor b = itensor_from_mkldnn(bias);
-    ideep::inner_product_forward::compute(x, w, b, y);
-  } else {
-    ideep::inner_product_forward::compute(x, w, y);
+  y.init(inner_product.desc.dst_desc());
+
+  std::unordered_map<int, dnnl::memory> args{
+      {DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, weights}, {DNNL_ARG_DST, y}};
+  ideep::tensor b;
+  if (with_bias) {
+    b = itensor_from_mkldnn(bias).reorder_if_differ_in(
+        inner_product.desc.bias_desc());
+    args.insert({DNNL_ARG_BIAS, b});
   }
+  inner_product.primitive.execute(ideep::stream::default_stream(), args);
 
   auto input_size = self.sizes();
   std::vector<int64_t> output_size(input_size.begin(), input_size.end() - 1);
@@ -1,11 +1,15 @@
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/PrimitiveCache.h>
 #include <ATen/OpaqueTensorImpl.h>
 #include <c10/core/Allocator.h>
+#include <c10/util/string_utils.h>
 
 #if AT_MKLDNN_ENABLED()
 
 #include <ideep.hpp>
 
+#include <cstdlib>
+
 namespace at { namespace native {
 
 /**
@@ -73,6 +77,24 @@ ideep::tensor itensor_view_from_dense(const Tensor& tensor) {
            ideep::tensor::data_type::f32},
           tensor.template data_ptr<float>()};
 }
+
+size_t mkldnn_primitive_cache_capacity() {
+  static const size_t capacity = [] {
+    const char* value = std::getenv("TORCH_MKLDNN_PRIMITIVE_CACHE_CAPACITY");
+    if (value == nullptr) {
+      return size_t(1024);
+    }
+    try {
+      const int capacity = c10::stoi(value);
+      TORCH_CHECK(capacity >= 0);
+      return static_cast<size_t>(capacity);
+    } catch (const std::exception& e) {
+      TORCH_WARN("Invalid TORCH_MKLDNN_PRIMITIVE_CACHE_CAPACITY variable value, ", e.what());
+    }
+    return size_t(1024);
+  }();
+  return capacity;
+}
 }}
 
 #endif // AT_MKLDNN_ENABLED()
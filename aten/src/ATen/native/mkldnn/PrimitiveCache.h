@@ -0,0 +1,102 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+
+#if AT_MKLDNN_ENABLED()
+#include <ideep.hpp>
+
+#include <list>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace at { namespace native {
+
+/**
+ * Key of a cached MKL-DNN primitive: the shapes, data types and attributes
+ * of the problem it was created for, flattened into integers. Sequences are
+ * prefixed with their length, so that keys of different problems differ.
+ */
+using PrimitiveCacheKey = std::vector<int64_t>;
+
+inline void append_to_primitive_cache_key(PrimitiveCacheKey& key, IntArrayRef values) {
+  key.push_back(values.size());
+  key.insert(key.end(), values.begin(), values.end());
+}
+
+template <typename T, typename = typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+inline void append_to_primitive_cache_key(PrimitiveCacheKey& key, T value) {
+  key.push_back(static_cast<int64_t>(value));
+}
+
+inline void append_to_primitive_cache_key(PrimitiveCacheKey& key, const std::vector<int64_t>& values) {
+  append_to_primitive_cache_key(key, IntArrayRef(values));
+}
+
+inline void make_primitive_cache_key_impl(PrimitiveCacheKey& /* key */) {}
+
+template <typename T, typename... Args>
+inline void make_primitive_cache_key_impl(PrimitiveCacheKey& key, const T& value, const Args&... args) {
+  append_to_primitive_cache_key(key, value);
+  make_primitive_cache_key_impl(key, args...);
+}
+
+template <typename... Args>
+inline PrimitiveCacheKey make_primitive_cache_key(const Args&... args) {
+  PrimitiveCacheKey key;
+  make_primitive_cache_key_impl(key, args...);
+  return key;
+}
+
+// Number of primitives each cache keeps, from TORCH_MKLDNN_PRIMITIVE_CACHE_CAPACITY.
+// 0 disables caching.
+CAFFE2_API size_t mkldnn_primitive_cache_capacity();
+
+/**
+ * An LRU cache of MKL-DNN primitives and their descriptors.
+ *
+ * Creating a primitive descriptor and its primitive, which JIT compiles the
+ * kernel for the problem, often costs more than running it on the small
+ * inputs of inference. A cache is meant to be a `thread_local` of the op using
+ * it, so it is not synchronized.
+ */
+template <typename Value>
+class PrimitiveCache {
+ public:
+  PrimitiveCache() : capacity_(mkldnn_primitive_cache_capacity()) {}
+
+  // Returns the primitive cached under `key`, after creating it with
+  // `create` if it is not.
+  template <typename Create>
+  Value get_or_create(const PrimitiveCacheKey& key, const Create& create) {
+    if (capacity_ == 0) {
+      return create();
+    }
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+    entries_.emplace_front(key, create());
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    return entries_.front().second;
+  }
+
+ private:
+  using Entry = std::pair<PrimitiveCacheKey, Value>;
+
+  const size_t capacity_;
+  // most recently used first
+  std::list<Entry> entries_;
+  std::map<PrimitiveCacheKey, typename std::list<Entry>::iterator> index_;
+};
+
+}}
+
+#endif // AT_MKLDNN_ENABLED()
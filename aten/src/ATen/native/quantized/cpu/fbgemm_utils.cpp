@@ -373,12 +373,20 @@ torch::class_<LinearPackedParamsBase> register_linear_params() {
 #endif // USE_FBGEMM
 #ifdef USE_PYTORCH_QNNPACK
                 if (at::globalContext().qEngine() == at::QEngine::QNNPACK) {
-                  TORCH_CHECK(
-                      weight.scalar_type() == at::kQInt8,
-                      "QNNPACK only supports INT8 bit width currently. Got ",
-                      c10::toString(weight.scalar_type()));
-                  return PackedLinearWeightsQnnp::prepack(
-                      std::move(weight), std::move(bias));
+                  if (weight.scalar_type() == at::kQInt8) {
+                    return PackedLinearWeightsQnnp::prepack(
+                        std::move(weight), std::move(bias));
+                  } else if (weight.scalar_type() == at::kFloat) {
+                    // NB: fp16 weight is serialized as float
+                    return PackedLinearWeightFp16Qnnp::prepack(
+                        std::move(weight), std::move(bias));
+                  } else {
+                    TORCH_CHECK(
+                        false,
+                        "Unsupported data type",
+                        c10::toString(weight.scalar_type()),
+                        " in serialized LinearPackedParams object!");
+                  }
                 }
 #endif // USE_PYTORCH_QNNPACK
                 TORCH_CHECK(false, "Unknown qengine");
@@ -1,9 +1,11 @@
 #include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
 #include <torch/library.h>
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -28,13 +30,19 @@ inline void check_inputs(const Tensor& qa, const Tensor& qb) {
   TORCH_CHECK(
       qa.qscheme() == qb.qscheme(),
       "Both inputs to Add must have the same quantization shceme.");
-  TORCH_CHECK(qa.numel() == qb.numel(), "Add operands must be the same size!");
   TORCH_CHECK(
       qa.scalar_type() == qb.scalar_type(),
       "Add operands should have same data type.");
 }
 
-// Note: out is assumed to be the same size as self and other.
+inline void check_out(const Tensor& qa, const Tensor& qb, const Tensor& out) {
+  check_inputs(qa, out);
+  TORCH_CHECK(
+      out.sizes().equals(infer_size(qa.sizes(), qb.sizes())),
+      "Add output must have the broadcast size of the operands!");
+}
+
+// Note: self and other are broadcast to the size of out by TensorIterator.
 // Note: Addition is only supported when self, other, out are of the same dtype.
 template <bool ReLUFused = false>
 Tensor _add_out(Tensor& out, const Tensor& self, const Tensor& other) {
@@ -211,12 +219,13 @@ Tensor qadd(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
   check_inputs(qa, qb);
 #ifdef USE_PYTORCH_QNNPACK
   if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
-      qa.scalar_type() == kQUInt8 && qb.scalar_type() == kQUInt8) {
+      qa.scalar_type() == kQUInt8 && qb.scalar_type() == kQUInt8 &&
+      qa.sizes() == qb.sizes()) {
     return qnnpack_add<ReLUFused>(qa, qb, scale, zero_point);
   }
 #endif
   auto qc = at::_empty_affine_quantized(
-      qa.sizes(),
+      DimVector(infer_size(qa.sizes(), qb.sizes())),
       at::device(kCPU)
          .dtype(qa.scalar_type())
          .memory_format(qa.suggest_memory_format()),
@@ -229,7 +238,7 @@ Tensor qadd(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
 template <bool ReLUFused = false>
 Tensor qadd_out(Tensor qa, Tensor qb, Tensor out) {
   check_inputs(qa, qb);
-  check_inputs(qa, out);
+  check_out(qa, qb, out);
   return _add_out<ReLUFused>(out, qa, qb);
 }
 
@@ -246,6 +255,7 @@ Tensor qadd_scalar(Tensor qa, Scalar b) {
 template <bool ReLUFused = false>
 Tensor qadd_scalar_out(Tensor qa, Scalar b, Tensor out) {
   check_inputs(qa, out);
+  TORCH_CHECK(qa.sizes() == out.sizes(), "Add operands must be the same size!");
   return _add_scalar_out<ReLUFused>(out, qa, b);
 }
 
@@ -265,6 +275,22 @@ Tensor qadd_scalar_tensor_out(Tensor qa, Tensor b, Tensor out) {
   return qadd_scalar_out(qa, b.item(), out);
 }
 
+// quantized::conv2d followed by quantized::add(_relu) of its output, e.g. a
+// residual connection. The output of the convolution is only an intermediate,
+// which is released as soon as the add ran.
+template <bool ReLUFused = false>
+Tensor qconv2d_add(
+    Tensor qx,
+    const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+    Tensor qother,
+    double conv_scale,
+    int64_t conv_zero_point,
+    double scale,
+    int64_t zero_point) {
+  auto qconv = packed_weight->apply(qx, conv_scale, conv_zero_point);
+  return qadd<ReLUFused>(std::move(qconv), std::move(qother), scale, zero_point);
+}
+
 TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("add",                 TORCH_FN(qadd</*ReLUFused=*/false>));
   m.impl("add.out",             TORCH_FN(qadd_out</*ReLUFused=*/false>));
@@ -274,6 +300,8 @@ TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("add_relu.out",        TORCH_FN(qadd_out</*ReLUFused=*/true>));
   m.impl("add_relu.Scalar",     TORCH_FN(qadd_scalar</*ReLUFused=*/true>));
   m.impl("add_relu.Scalar_out", TORCH_FN(qadd_scalar_out</*ReLUFused=*/true>));
+  m.impl("conv2d_add",          TORCH_FN(qconv2d_add</*ReLUFused=*/false>));
+  m.impl("conv2d_add_relu",     TORCH_FN(qconv2d_add</*ReLUFused=*/true>));
   // deprecated functions, kept for backward compatibility
   m.impl("add_out",             TORCH_FN(qadd_out</*ReLUFused=*/false>));
   m.impl("add_relu_out",        TORCH_FN(qadd_out</*ReLUFused=*/true>));
@@ -9,151 +9,86 @@
 
 #include <ATen/Parallel.h>
 
-torch::class_<EmbeddingPackedParamsBase> register_embedding_params();
-
-at::Tensor PackedEmbeddingBagWeight::embeddingbag_byte(
-    const at::Tensor& indices,
-    const c10::optional<at::Tensor>& offsets_in,
-    bool sparse,
-    const c10::optional<at::Tensor>& per_sample_weights_,
-    bool include_last_offset) {
-
-  TORCH_CHECK(offsets_in.has_value(), "embedding_bag_byte_rowwise_offsets expects offsets to be set");
-  auto offsets = offsets_in.value();
-  auto offsets_data = offsets.data_ptr<int64_t>();
-  const auto indices_data = indices.data_ptr<int64_t>();
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
-  const auto weight_data = packed_w.data_ptr<uint8_t>();
+torch::class_<EmbeddingPackedParamsBase> register_embedding_params();
 
-  const int64_t N = packed_w.size(0);
-  const int64_t D =
-      packed_w.size(1) - 8; // NB: -8 to account for scale and bias
-  const int64_t M = offsets.size(0);
+namespace {
 
-  int64_t output_size = M - 1;
-  std::vector<int64_t> offsets_include_last;
-
-  if (!include_last_offset) {
-    output_size = M;
-    offsets_include_last.resize(M + 1);
-    std::memcpy(
-        offsets_include_last.data(),
-        offsets.data_ptr<int64_t>(),
-        sizeof(int64_t) * M);
-    offsets_include_last[M] = indices.numel();
-    offsets_data = offsets_include_last.data();
+// Offsets of the bags with the end of the last bag appended, so that bag m
+// is indices[offsets[m], offsets[m + 1]).
+template <typename OffsetType, typename T>
+const OffsetType* offsets_with_last(
+    const T* offsets_data,
+    int64_t M,
+    int64_t num_indices,
+    bool include_last_offset,
+    std::vector<OffsetType>& storage) {
+  TORCH_CHECK(
+      !include_last_offset || M > 0,
+      "include_last_offset expects at least one offset");
+  if (include_last_offset && std::is_same<OffsetType, T>::value) {
+    return reinterpret_cast<const OffsetType*>(offsets_data);
   }
-
-  std::vector<int64_t> shape = {output_size, D};
-  auto output = at::empty(shape, packed_w.options().dtype(at::kFloat));
-  auto* output_data = output.data_ptr<float>();
-
-#ifdef USE_FBGEMM
-
-  auto kernel_i8_i64 =
-      fbgemm::GenerateEmbeddingSpMDM<uint8_t, int64_t, int64_t>(
-          /*block_size=*/D,
-          /*has_weight=*/per_sample_weights_.has_value(),
-          /*normalize_by_lengths=*/false,
-          /*prefetch=*/16, // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-          /*is_weight_positional=*/false,
-          /*use_offsets=*/true);
-
-  if (packed_w.is_contiguous()) {
-    at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-          bool success = kernel_i8_i64(
-              /*output_size=*/end_idx - start_idx,
-              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-              /*data_size=*/N,
-              /*input=*/weight_data,
-              /*indices=*/indices_data + offsets_data[start_idx],
-              /*offsets_or_lengths=*/offsets_data + start_idx,
-              /*weights=*/
-              per_sample_weights_
-                  ? per_sample_weights_.value().data_ptr<float>() +
-                      offsets_data[start_idx]
-                  : nullptr,
-              /*out=*/output_data + start_idx * D);
-
-          TORCH_CHECK(
-              success,
-              "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
-        });
-  } else {
-    auto weight_contig = packed_w.contiguous();
-    const auto weight_data_contig = weight_contig.data_ptr<uint8_t>();
-    at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-          bool success = kernel_i8_i64(
-              /*output_size=*/end_idx - start_idx,
-              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-              /*data_size=*/N,
-              /*input=*/weight_data_contig,
-              /*indices=*/indices_data + offsets_data[start_idx],
-              /*offsets_or_lengths=*/offsets_data + start_idx,
-              /*weights=*/
-              per_sample_weights_
-                  ? per_sample_weights_.value().data_ptr<float>() +
-                      offsets_data[start_idx]
-                  : nullptr,
-              /*out=*/output_data + start_idx * D);
-          TORCH_CHECK(
-              success,
-              "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
-        });
+  const int64_t num_bags = include_last_offset ? M - 1 : M;
+  storage.resize(num_bags + 1);
+  for (int64_t m = 0; m < num_bags; ++m) {
+    storage[m] = offsets_data[m];
   }
-#endif
-  // TODO add default (non-FBGEMM) implementation.
-  return output;
+  storage[num_bags] =
+      include_last_offset ? offsets_data[num_bags] : num_indices;
+  return storage.data();
 }
 
-namespace at {
-namespace native {
-namespace {
-
-Tensor embedding_bag_byte_rowwise_offsets(
-    const Tensor& weight,
-    const Tensor& indices,
-    const c10::optional<Tensor>& offsets_in,
-    const bool /* scale_grad_by_freq */,
-    const int64_t /* mode */,
-    bool /* sparse */,
-    const c10::optional<Tensor>& per_sample_weights_,
+at::Tensor& embedding_bag_byte_helper(
+    at::Tensor& output,
+    const at::Tensor& weight,
+    const at::Tensor& indices,
+    const c10::optional<at::Tensor>& offsets_in,
+    const c10::optional<at::Tensor>& per_sample_weights_,
     bool include_last_offset) {
   TORCH_CHECK(weight.scalar_type() == at::kByte);
   TORCH_CHECK(weight.ndimension() == 2);
-  TORCH_CHECK(offsets_in.has_value(), "embedding_bag_byte_rowwise_offsets expects offsets to be set");
+  TORCH_CHECK(
+      offsets_in.has_value(),
+      "embedding_bag_byte_rowwise_offsets expects offsets to be set");
+  const auto& offsets = offsets_in.value();
+  TORCH_CHECK(offsets.ndimension() == 1);
 
-  auto offsets = offsets_in.value();
-  auto offsets_data = offsets.data_ptr<int64_t>();
-  const auto weight_data = weight.data_ptr<uint8_t>();
-  const auto indices_data = indices.data_ptr<int64_t>();
+  const at::Tensor weight_contig = weight.contiguous();
+  const auto weight_data = weight_contig.data_ptr<uint8_t>();
+  const at::Tensor indices_contig = indices.contiguous();
+  const auto indices_data = indices_contig.data_ptr<int64_t>();
+  const at::Tensor offsets_contig = offsets.contiguous();
 
   const int64_t N = weight.size(0);
   const int64_t D = weight.size(1) - 8; // NB: -8 to account for scale and bias
   const int64_t M = offsets.size(0);
 
-  int64_t output_size = M - 1;
-  std::vector<int64_t> offsets_include_last;
-
-  if (!include_last_offset) {
-    output_size = M;
-    offsets_include_last.resize(M + 1);
-    std::memcpy(
-        offsets_include_last.data(),
-        offsets.data_ptr<int64_t>(),
-        sizeof(int64_t) * M);
-    offsets_include_last[M] = indices.numel();
-    offsets_data = offsets_include_last.data();
+  std::vector<int64_t> offsets_storage;
+  const int64_t* offsets_data = offsets_with_last<int64_t>(
+      offsets_contig.data_ptr<int64_t>(),
+      M,
+      indices.numel(),
+      include_last_offset,
+      offsets_storage);
+  const int64_t output_size = include_last_offset ? M - 1 : M;
+
+  at::Tensor per_sample_weights;
+  const float* per_sample_weights_data = nullptr;
+  if (per_sample_weights_.has_value()) {
+    per_sample_weights = per_sample_weights_.value().contiguous();
+    per_sample_weights_data = per_sample_weights.data_ptr<float>();
   }
 
-  std::vector<int64_t> shape = {output_size, D};
-  auto output = at::empty(shape, weight.options().dtype(at::kFloat));
+  output.resize_({output_size, D});
   auto* output_data = output.data_ptr<float>();
 
+  // Bags are independent, each task sums a contiguous range of them and reads
+  // the offsets of its first bag, so no bag is split across threads
 #ifdef USE_FBGEMM
-
   auto kernel_i8_i64 =
       fbgemm::GenerateEmbeddingSpMDM<uint8_t, int64_t, int64_t>(
           /*block_size=*/D,
@@ -163,84 +98,73 @@ Tensor embedding_bag_byte_rowwise_offsets(
           /*is_weight_positional=*/false,
           /*use_offsets=*/true);
 
-  if (weight.is_contiguous()) {
-    at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-          bool success = kernel_i8_i64(
-              /*output_size=*/end_idx - start_idx,
-              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-              /*data_size=*/N,
-              /*input=*/weight_data,
-              /*indices=*/indices_data + offsets_data[start_idx],
-              /*offsets_or_lengths=*/offsets_data + start_idx,
-              /*weights=*/
-              per_sample_weights_
-                  ? per_sample_weights_.value().data_ptr<float>() +
-                      offsets_data[start_idx]
-                  : nullptr,
-              /*out=*/output_data + start_idx * D);
+  at::parallel_for(
+      0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        bool success = kernel_i8_i64(
+            /*output_size=*/end_idx - start_idx,
+            /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+            /*data_size=*/N,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + offsets_data[start_idx],
+            /*offsets_or_lengths=*/offsets_data + start_idx,
+            /*weights=*/
+            per_sample_weights_data
+                ? per_sample_weights_data + offsets_data[start_idx]
+                : nullptr,
+            /*out=*/output_data + start_idx * D);
 
-          TORCH_CHECK(
-              success,
-              "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
-        });
-  } else {
-    auto weight_contig = weight.contiguous();
-    const auto weight_data_contig = weight_contig.data_ptr<uint8_t>();
-    at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-          bool success = kernel_i8_i64(
-              /*output_size=*/end_idx - start_idx,
-              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-              /*data_size=*/N,
-              /*input=*/weight_data_contig,
-              /*indices=*/indices_data + offsets_data[start_idx],
-              /*offsets_or_lengths=*/offsets_data + start_idx,
-              /*weights=*/
-              per_sample_weights_
-                  ? per_sample_weights_.value().data_ptr<float>() +
-                      offsets_data[start_idx]
-                  : nullptr,
-              /*out=*/output_data + start_idx * D);
-          TORCH_CHECK(
-              success,
-              "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
-        });
-  }
+        TORCH_CHECK(
+            success,
+            "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
+      });
+#else
+  at::parallel_for(
+      0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t m = start_idx; m < end_idx; ++m) {
+          float* output_row = output_data + m * D;
+          std::fill(output_row, output_row + D, 0.0f);
+          for (int64_t i = offsets_data[m]; i < offsets_data[m + 1]; ++i) {
+            const int64_t idx = indices_data[i];
+            TORCH_CHECK((idx >= 0 && idx < N), "Invalid indices data");
+            const uint8_t* input_row = weight_data + idx * (D + 8);
+            const float* scale_bias =
+                reinterpret_cast<const float*>(input_row + D);
+            const float weight_val =
+                per_sample_weights_data ? per_sample_weights_data[i] : 1.0f;
+            const float scale = weight_val * scale_bias[0];
+            const float bias = weight_val * scale_bias[1];
+            for (int64_t j = 0; j < D; ++j) {
+              output_row[j] = fma(scale, input_row[j], output_row[j] + bias);
+            }
+          }
+        }
+      });
 #endif
   return output;
 }
 
-Tensor embedding_bag_4bit_rowwise_offsets(
-    const Tensor& weight,
-    const Tensor& indices,
-    const c10::optional<Tensor>& offsets_in,
-    const bool /* scale_grad_by_freq */,
-    const int64_t /* mode */,
+at::Tensor& embedding_bag_4bit_helper(
+    at::Tensor& output,
+    const at::Tensor& weight,
+    const at::Tensor& indices,
+    const c10::optional<at::Tensor>& offsets_in,
     bool sparse,
-    const c10::optional<Tensor>& per_sample_weights_,
-    const c10::optional<Tensor>& compressed_indices_mapping,
+    const c10::optional<at::Tensor>& per_sample_weights_,
+    const c10::optional<at::Tensor>& compressed_indices_mapping,
     bool include_last_offset) {
-  TORCH_CHECK(offsets_in.has_value(), "embedding_bag_4bit_rowwise_offsets expects offsets to be set");
-
+  TORCH_CHECK(
+      offsets_in.has_value(),
+      "embedding_bag_4bit_rowwise_offsets expects offsets to be set");
   TORCH_CHECK(weight.ndimension() == 2);
   TORCH_CHECK(indices.ndimension() == 1);
-
-  auto offsets = offsets_in.value();
+  const auto& offsets = offsets_in.value();
   TORCH_CHECK(offsets.ndimension() == 1);
 
-  // FBGEMM expects the offsets to be of int type.
-  at::Tensor offsets_new = offsets.toType(ScalarType::Int);
-
-  auto offsets_data = offsets_new.data_ptr<int>();
-  const auto weight_data = weight.data_ptr<uint8_t>();
-  uint8_t* input_data = nullptr;
-  if (!weight.is_contiguous()) {
-    auto weight_contig = weight.contiguous();
-    input_data = weight_contig.data_ptr<uint8_t>();
-  } else {
-    input_data = weight.data_ptr<uint8_t>();
-  }
+  const at::Tensor weight_contig = weight.contiguous();
+  const auto input_data = weight_contig.data_ptr<uint8_t>();
+  const at::Tensor indices_contig = indices.contiguous();
+  const auto indices_data = indices_contig.data_ptr<int64_t>();
+  const at::Tensor offsets_contig = offsets.contiguous();
 
   // Get compressed indices for sparse op.
   int32_t* compressed_indices_mapping_data = nullptr;
@@ -251,33 +175,32 @@ Tensor embedding_bag_4bit_rowwise_offsets(
         compressed_indices_mapping.value().data_ptr<int32_t>();
   }
 
-  const auto indices_data = indices.data_ptr<int64_t>();
   const int64_t N = weight.size(0);
   const int64_t D =
       (weight.size(1) - 4) * 2; // NB: 2-byte fp16 scale and 2-byte zero_offset
   const int64_t M = offsets.size(0);
 
-  int64_t output_size = M - 1;
-  std::vector<int> offsets_include_last_val;
-  if (!include_last_offset) {
-    output_size = M;
-    offsets_include_last_val.resize(M + 1);
-    // Avoid `null pointer passed as argument 2` ASAN violation when ofests
-    // tensor is empty.
-    if (M > 0) {
-      std::memcpy(
-          offsets_include_last_val.data(), offsets_data, sizeof(int) * M);
-    }
-    offsets_include_last_val[M] = indices.numel();
-    offsets_data = offsets_include_last_val.data();
+  // FBGEMM expects the offsets to be of int type.
+  std::vector<int> offsets_storage;
+  const int* offsets_data = offsets_with_last<int>(
+      offsets_contig.data_ptr<int64_t>(),
+      M,
+      indices.numel(),
+      include_last_offset,
+      offsets_storage);
+  const int64_t output_size = include_last_offset ? M - 1 : M;
+
+  at::Tensor per_sample_weights;
+  const float* per_sample_weights_data = nullptr;
+  if (per_sample_weights_.has_value()) {
+    per_sample_weights = per_sample_weights_.value().contiguous();
+    per_sample_weights_data = per_sample_weights.data_ptr<float>();
   }
 
-  const std::vector<int64_t> shape = {output_size, D};
-  auto output = at::empty(shape, weight.options().dtype(at::kFloat));
+  output.resize_({output_size, D});
   auto* output_data = output.data_ptr<float>();
-  const int64_t block_size = output.size(1);
+  const int64_t block_size = D;
   TORCH_CHECK(block_size % 2 == 0, "block size must be divisible by 2");
-  const int index_size = indices.numel();
   constexpr int prefetch_distance = 16;
 #ifdef USE_FBGEMM
   if (!sparse) {
@@ -291,22 +214,25 @@ Tensor embedding_bag_4bit_rowwise_offsets(
         /*is_weight_positional=*/false,
         /*use_offsets=*/true);
 
-    bool success = kernel_64_(
-        /*output_size=*/output_size,
-        /*index_size=*/index_size,
-        /*data_size=*/N,
-        /*input=*/input_data,
-        /*indices=*/indices_data,
-        /*offsets=*/offsets_data,
-        /*weights=*/
-        per_sample_weights_.has_value()
-            ? per_sample_weights_.value().data_ptr<float>()
-            : nullptr,
-        /*output=*/output_data);
-
-    TORCH_CHECK(
-        success,
-        "FBGEMM GenerateEmbeddingSpMDMNBit kernel failed for 4-bit input");
+    at::parallel_for(
+        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+          bool success = kernel_64_(
+              /*output_size=*/end_idx - start_idx,
+              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+              /*data_size=*/N,
+              /*input=*/input_data,
+              /*indices=*/indices_data + offsets_data[start_idx],
+              /*offsets=*/offsets_data + start_idx,
+              /*weights=*/
+              per_sample_weights_data
+                  ? per_sample_weights_data + offsets_data[start_idx]
+                  : nullptr,
+              /*output=*/output_data + start_idx * block_size);
+
+          TORCH_CHECK(
+              success,
+              "FBGEMM GenerateEmbeddingSpMDMNBit kernel failed for 4-bit input");
+        });
   } else {
     auto kernel_64_ =
         fbgemm::GenerateEmbeddingSpMDMNBitRowWiseSparse<std::int64_t>(
@@ -317,87 +243,135 @@ Tensor embedding_bag_4bit_rowwise_offsets(
             /*prefetch distance*/ prefetch_distance,
             /*is_weight_positional*/ false,
             /*use_offsets*/ true);
-    bool success = kernel_64_(
-        /*output_size=*/output_size,
-        /*index_size=*/index_size,
-        /*data_size=*/compressed_index_size,
-        /*input=*/weight_data,
-        /*indices=*/indices_data,
-        /*offsets=*/offsets_data,
-        /*weights=*/
-        per_sample_weights_.has_value()
-            ? per_sample_weights_.value().data_ptr<float>()
-            : nullptr,
-        /*output=*/output_data,
-        /*compressed_indices_table=*/compressed_indices_mapping_data);
-    TORCH_CHECK(
-        success,
-        "FBGEMM GenerateEmbeddingSpMDMNBitRowWiseSparse kernel failed for 4-bit input");
+
+    at::parallel_for(
+        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+          bool success = kernel_64_(
+              /*output_size=*/end_idx - start_idx,
+              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+              /*data_size=*/compressed_index_size,
+              /*input=*/input_data,
+              /*indices=*/indices_data + offsets_data[start_idx],
+              /*offsets=*/offsets_data + start_idx,
+              /*weights=*/
+              per_sample_weights_data
+                  ? per_sample_weights_data + offsets_data[start_idx]
+                  : nullptr,
+              /*output=*/output_data + start_idx * block_size,
+              /*compressed_indices_table=*/compressed_indices_mapping_data);
+          TORCH_CHECK(
+              success,
+              "FBGEMM GenerateEmbeddingSpMDMNBitRowWiseSparse kernel failed for 4-bit input");
+        });
   }
 #else
+  const int64_t row_bytes = weight.size(1);
+  at::parallel_for(
+      0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t m = start_idx; m < end_idx; ++m) {
+          float* output_row = output_data + m * block_size;
+          std::fill(output_row, output_row + block_size, 0.0f);
+          for (int64_t i = offsets_data[m]; i < offsets_data[m + 1]; ++i) {
+            int64_t idx;
+            if (!sparse) {
+              idx = indices_data[i];
+              TORCH_CHECK((idx >= 0 && idx < N), "Invalid indices data");
+            } else {
+              int64_t uncompressed_idx = indices_data[i];
+              TORCH_CHECK(
+                  uncompressed_idx >= 0 &&
+                      uncompressed_idx < compressed_index_size,
+                  "Invalid indices data for Sparse Op.")
+              idx = compressed_indices_mapping_data[uncompressed_idx];
+              if (idx == -1) {
+                continue;
+              }
+            }
+            const uint8_t* input_row = input_data + idx * row_bytes;
+            const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+                input_row + row_bytes - 2 * sizeof(at::Half));
+
+            const float weight_val =
+                per_sample_weights_data ? per_sample_weights_data[i] : 1.0f;
+            const float scale = weight_val * scale_bias[0];
+            const float bias = weight_val * scale_bias[1];
+
+            for (int64_t j = 0; j < block_size; ++j) {
+              uint8_t quantized =
+                  input_row[j / /*NUM_ELEM_PER_BYTE*/ 2];
+              quantized >>= (j % 2) * 4;
+              quantized &= (1 << 4) - 1;
+
+              output_row[j] = fma(scale, quantized, output_row[j] + bias);
+            }
+          }
+        }
+      });
+#endif
+  return output;
+}
 
-  auto accessor = offsets.accessor<int64_t, 1>();
-  std::vector<int> lengths_data;
+} // namespace
 
-  int64_t lower = accessor[0];
-  for (int64_t i = 1; i < offsets.numel(); ++i) {
-    lengths_data.push_back(accessor[i] - lower);
-    lower = accessor[i];
-  }
-  if (!include_last_offset) {
-    lengths_data.push_back(indices.numel() - lower);
-  }
+at::Tensor PackedEmbeddingBagWeight::embeddingbag_byte(
+    const at::Tensor& indices,
+    const c10::optional<at::Tensor>& offsets_in,
+    bool sparse,
+    const c10::optional<at::Tensor>& per_sample_weights_,
+    bool include_last_offset) {
+  auto output = at::empty({0}, packed_w.options().dtype(at::kFloat));
+  return embedding_bag_byte_helper(
+      output,
+      packed_w,
+      indices,
+      offsets_in,
+      per_sample_weights_,
+      include_last_offset);
+}
 
-  int64_t current = 0;
-  float* per_sample_weights_data;
-  if (per_sample_weights_.has_value()) {
-    per_sample_weights_data = per_sample_weights_.value().data_ptr<float>();
-  }
-  for (int m = 0; m < output_size; ++m) {
-    memset(output_data, 0, block_size * sizeof(float));
-    TORCH_CHECK(
-        current + lengths_data[m] <= index_size,
-        "Expect the lengths data to be less than indices size");
-
-    for (int i = 0; i < lengths_data[m]; ++i, ++current) {
-      int64_t idx;
-      if (!sparse) {
-        idx = indices_data[current];
-        TORCH_CHECK((idx >= 0 && idx < N), "Invalid indices data");
-      } else {
-        int64_t uncompressed_idx = indices_data[current];
-        TORCH_CHECK(
-            uncompressed_idx >= 0 && uncompressed_idx < compressed_index_size,
-            "Invalid indices data for Sparse Op.")
-        idx = compressed_indices_mapping_data[uncompressed_idx];
-        if (idx == -1) {
-          continue;
-        }
-      }
-      const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
-          input_data + (idx + 1) * weight.size(1) - 2 * sizeof(at::Half));
-
-      float weight_val = 1.0f;
-      if (per_sample_weights_.has_value()) {
-        weight_val = per_sample_weights_data[current];
-      }
-      const float scale = weight_val * scale_bias[0];
-      const float bias = weight_val * scale_bias[1];
-
-      for (int j = 0; j < block_size; ++j) {
-        uint8_t quantized =
-            input_data[idx * weight.size(1) + j / /*NUM_ELEM_PER_BYTE*/ 2];
-        quantized >>= (j % 2) * 4;
-        quantized &= (1 << 4) - 1;
-
-        output_data[j] = fma(scale, quantized, output_data[j] + bias);
-      }
-    } // for each i
-    output_data += block_size;
-  } // for each m
+namespace at {
+namespace native {
+namespace {
 
-#endif
-  return output;
+Tensor embedding_bag_byte_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    const bool /* scale_grad_by_freq */,
+    const int64_t /* mode */,
+    bool /* sparse */,
+    const c10::optional<Tensor>& per_sample_weights_,
+    bool include_last_offset) {
+  auto output = at::empty({0}, weight.options().dtype(at::kFloat));
+  return embedding_bag_byte_helper(
+      output,
+      weight,
+      indices,
+      offsets_in,
+      per_sample_weights_,
+      include_last_offset);
+}
+
+Tensor embedding_bag_4bit_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    const bool /* scale_grad_by_freq */,
+    const int64_t /* mode */,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  auto output = at::empty({0}, weight.options().dtype(at::kFloat));
+  return embedding_bag_4bit_helper(
+      output,
+      weight,
+      indices,
+      offsets_in,
+      sparse,
+      per_sample_weights_,
+      compressed_indices_mapping,
+      include_last_offset);
 }
 
 template <int bit_rate>
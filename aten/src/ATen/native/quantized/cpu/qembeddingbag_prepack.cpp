@@ -114,26 +114,30 @@ Tensor qembeddingbag_byte_prepack(const Tensor& weight) {
       weight_contig.suggest_memory_format());
   auto* output_data = output.data_ptr<uint8_t>();
 
-  for (std::size_t row = 0; row < embedding_rows; ++row) {
-    const float* input_row = weight_data + row * embedding_cols;
-    std::uint8_t* output_row = output_data + row * output_columns;
-    float* output_row_scale_zp =
-        reinterpret_cast<float*>(output_row + embedding_cols);
-
-    float minimum_element =
-        *std::min_element(input_row, input_row + embedding_cols);
-    float maximum_element =
-        *std::max_element(input_row, input_row + embedding_cols);
-    float range = maximum_element - minimum_element;
-
-    output_row_scale_zp[0] = range / 255.0f;
-    output_row_scale_zp[1] = minimum_element;
-    const auto inverse_scale = 255.0f / (range + kEpsilon);
-    for (std::size_t col = 0; col < embedding_cols; ++col) {
-      output_row[col] =
-          lrintf((input_row[col] - minimum_element) * inverse_scale);
-    } // embedding_cols
-  } // embedding_rows
+  // Rows are quantized independently
+  at::parallel_for(
+      0, embedding_rows, 1, [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t row = start_idx; row < end_idx; ++row) {
+          const float* input_row = weight_data + row * embedding_cols;
+          std::uint8_t* output_row = output_data + row * output_columns;
+          float* output_row_scale_zp =
+              reinterpret_cast<float*>(output_row + embedding_cols);
+
+          float minimum_element =
+              *std::min_element(input_row, input_row + embedding_cols);
+          float maximum_element =
+              *std::max_element(input_row, input_row + embedding_cols);
+          float range = maximum_element - minimum_element;
+
+          output_row_scale_zp[0] = range / 255.0f;
+          output_row_scale_zp[1] = minimum_element;
+          const auto inverse_scale = 255.0f / (range + kEpsilon);
+          for (int64_t col = 0; col < embedding_cols; ++col) {
+            output_row[col] =
+                lrintf((input_row[col] - minimum_element) * inverse_scale);
+          } // embedding_cols
+        } // embedding_rows
+      });
   return output;
 }
 
@@ -143,7 +147,7 @@ Tensor _qembeddingbag_nbit_prepack_helper(const Tensor& weight, int BIT_RATE) {
 
   Tensor weight_contig = weight.contiguous(weight.suggest_memory_format());
 
-  const auto weight_data = weight.data_ptr<float>();
+  const auto weight_data = weight_contig.data_ptr<float>();
   TORCH_CHECK(
     BIT_RATE == 4 || BIT_RATE == 2,
     "BIT_RATE must be either 2 or 4 to use 'qembeddingbag_nbit_prepack'."
@@ -174,53 +178,56 @@ Tensor _qembeddingbag_nbit_prepack_helper(const Tensor& weight, int BIT_RATE) {
   auto* output_data = output.data_ptr<uint8_t>();
   const auto output_columns = output.size(output.dim() - 1);
 
-  for (int row = 0; row < embedding_rows; ++row) {
-    const float* input_row = weight_data + row * embedding_cols;
-    std::uint8_t* output_row = output_data + row * output_columns;
-
-    float Xmin = *std::min_element(input_row, input_row + embedding_cols);
-    float Xmax = *std::max_element(input_row, input_row + embedding_cols);
-
-    Xmin = static_cast<at::Half>(Xmin);
-    const float range = Xmax - Xmin;
-
-    // Set scale to 1.0f for the corner case of Xmax == Xmin .
-    // Any non-zero scale would work because during quantization
-    // (X - Xmin) / scale will be 0 for all X unless scale is 0.
-    at::Half scale = range == 0 ? 1.0f : range / ((1 << BIT_RATE) - 1);
-    float inverse_scale = scale == 0 ? 1.0f : 1.0f / scale;
-    if (scale == 0 || std::isinf(inverse_scale)) {
-      // Corner case handling when Xmax == Xmin
-      // Any scale would work because X - Xmin will be 0 for all X
-      scale = 1.0f;
-      inverse_scale = 1.0f;
-    }
-
-    // Update the scale and zero_point of each row.
-    at::Half* output_row_scale_zp = reinterpret_cast<at::Half*>(
-        output_row +
-        (embedding_cols + NUM_ELEM_PER_BYTE - 1) / NUM_ELEM_PER_BYTE);
-
-    output_row_scale_zp[0] = scale;
-    output_row_scale_zp[1] = Xmin;
-
-    // Pack the weight values.
-    for (int col = 0; col < embedding_cols; ++col) {
-      float X = input_row[col];
-      std::uint8_t quantized = std::max(
-          0,
-          std::min<int>(
-              lrintf((X - Xmin) * inverse_scale), (1 << BIT_RATE) - 1));
-      // We pack 2 4-bit values in a byte. Index 0 is packed in the lower 4-bits
-      // and index 1 is packed in the upper 4-bits.
-      if (col % NUM_ELEM_PER_BYTE == 0) {
-        output_row[col / NUM_ELEM_PER_BYTE] = quantized;
-      } else {
-        output_row[col / NUM_ELEM_PER_BYTE] |=
-            (quantized << ((col % NUM_ELEM_PER_BYTE) * BIT_RATE));
-      }
-    } // embedding_cols
-  } // embedding_rows
+  at::parallel_for(
+      0, embedding_rows, 1, [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t row = start_idx; row < end_idx; ++row) {
+          const float* input_row = weight_data + row * embedding_cols;
+          std::uint8_t* output_row = output_data + row * output_columns;
+
+          float Xmin = *std::min_element(input_row, input_row + embedding_cols);
+          float Xmax = *std::max_element(input_row, input_row + embedding_cols);
+
+          Xmin = static_cast<at::Half>(Xmin);
+          const float range = Xmax - Xmin;
+
+          // Set scale to 1.0f for the corner case of Xmax == Xmin .
+          // Any non-zero scale would work because during quantization
+          // (X - Xmin) / scale will be 0 for all X unless scale is 0.
+          at::Half scale = range == 0 ? 1.0f : range / ((1 << BIT_RATE) - 1);
+          float inverse_scale = scale == 0 ? 1.0f : 1.0f / scale;
+          if (scale == 0 || std::isinf(inverse_scale)) {
+            // Corner case handling when Xmax == Xmin
+            // Any scale would work because X - Xmin will be 0 for all X
+            scale = 1.0f;
+            inverse_scale = 1.0f;
+          }
+
+          // Update the scale and zero_point of each row.
+          at::Half* output_row_scale_zp = reinterpret_cast<at::Half*>(
+              output_row +
+              (embedding_cols + NUM_ELEM_PER_BYTE - 1) / NUM_ELEM_PER_BYTE);
+
+          output_row_scale_zp[0] = scale;
+          output_row_scale_zp[1] = Xmin;
+
+          // Pack the weight values.
+          for (int col = 0; col < embedding_cols; ++col) {
+            float X = input_row[col];
+            std::uint8_t quantized = std::max(
+                0,
+                std::min<int>(
+                    lrintf((X - Xmin) * inverse_scale), (1 << BIT_RATE) - 1));
+            // We pack 2 4-bit values in a byte. Index 0 is packed in the lower 4-bits
+            // and index 1 is packed in the upper 4-bits.
+            if (col % NUM_ELEM_PER_BYTE == 0) {
+              output_row[col / NUM_ELEM_PER_BYTE] = quantized;
+            } else {
+              output_row[col / NUM_ELEM_PER_BYTE] |=
+                  (quantized << ((col % NUM_ELEM_PER_BYTE) * BIT_RATE));
+            }
+          } // embedding_cols
+        } // embedding_rows
+      });
   return output;
 }
 
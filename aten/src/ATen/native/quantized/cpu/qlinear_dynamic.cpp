@@ -352,6 +352,65 @@ at::Tensor PackedLinearWeightsQnnp::apply_dynamic_relu(at::Tensor input, bool re
   return apply_dynamic_impl</*ReluFused=*/true>(std::move(input));
 }
 
+template <bool ReluFused>
+at::Tensor PackedLinearWeightFp16Qnnp::apply_dynamic_impl(at::Tensor input) {
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "quantized::linear_dynamic_fp16(): Input tensor rank should be >= 2");
+  const int64_t K = weight.size(1);
+  const int64_t N = weight.size(0);
+  TORCH_CHECK(
+      input.size(input.dim() - 1) == K,
+      "quantized::linear_dynamic_fp16(): Input has ",
+      input.size(input.dim() - 1),
+      " features, the weight has ",
+      K);
+
+  const at::Tensor input_contig = input.contiguous().to(at::kFloat);
+  const int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+  const at::Tensor input_2d = input_contig.view({M, K});
+  at::Tensor output = at::empty({M, N}, input.options().dtype(at::kFloat));
+
+  // Widen the weight a block of output channels at a time, so that the float
+  // copy stays in cache while the GEMM runs over it
+  constexpr int64_t kBlockBytes = 256 * 1024;
+  const int64_t block =
+      std::max<int64_t>(8, kBlockBytes / (std::max<int64_t>(1, K) * sizeof(float)));
+  for (int64_t n = 0; n < N; n += block) {
+    const int64_t rows = std::min(block, N - n);
+    const at::Tensor weight_block = weight.narrow(0, n, rows).to(at::kFloat);
+    at::Tensor output_block = output.narrow(1, n, rows);
+    if (bias_.has_value()) {
+      at::addmm_out(
+          output_block,
+          bias_->narrow(0, n, rows),
+          input_2d,
+          weight_block.t());
+    } else {
+      at::mm_out(output_block, input_2d, weight_block.t());
+    }
+  }
+  if (ReluFused) {
+    output.relu_();
+  }
+
+  std::vector<int64_t> output_size = input.sizes().vec();
+  output_size.back() = N;
+  return output.view(output_size);
+}
+
+at::Tensor PackedLinearWeightFp16Qnnp::apply_dynamic(at::Tensor input, bool reduce_range) {
+  return apply_dynamic_impl</*ReluFused=*/false>(std::move(input));
+}
+
+at::Tensor PackedLinearWeightFp16Qnnp::apply_dynamic_relu(at::Tensor input, bool reduce_range) {
+  return apply_dynamic_impl</*ReluFused=*/true>(std::move(input));
+}
+
+void PackedLinearWeightFp16Qnnp::set_bias(c10::optional<at::Tensor> bias) {
+  bias_ = std::move(bias);
+}
+
 #endif // USE_PYTORCH_QNNPACK
 
 #ifdef USE_FBGEMM
@@ -428,30 +487,28 @@ class QLinearDynamicInt8 final {
 template <bool ReluFused>
 class QLinearDynamicFp16 final {
  public:
-#ifdef USE_FBGEMM
   static at::Tensor run(
       at::Tensor input,
       const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight) {
+    auto& ctx = at::globalContext();
+    TORCH_INTERNAL_ASSERT(!ReluFused);
+#ifdef USE_PYTORCH_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return packed_weight->apply_dynamic(std::move(input));
+    }
+#endif // USE_PYTORCH_QNNPACK
+#ifdef USE_FBGEMM
     // We make a strong guarantee that models using these operators will have
     // the same numerics across different machines. Therefore, we do not provide
     // a fallback path and rather fail loudly if we cannot run FBGEMM.
     TORCH_CHECK(
         fbgemm::fbgemmSupportedCPU(), "Your CPU doesn't support FBGEMM.");
-
-    TORCH_INTERNAL_ASSERT(!ReluFused);
     return packed_weight->apply_dynamic(std::move(input));
-  }
 #else // USE_FBGEMM
-  static at::Tensor run(
-      at::Tensor /* input */,
-      const c10::intrusive_ptr<LinearPackedParamsBase>& /* packed_weight */) {
-    // We make a strong guarantee that models using these operators will have
-    // the same numerics across different machines. Therefore, we do not provide
-    // a fallback path and rather fail loudly if we cannot run FBGEMM.
     TORCH_CHECK(
         false, "This PyTorch installation was not built with FBGEMM operators");
-  }
 #endif // USE_FBGEMM
+  }
 };
 
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
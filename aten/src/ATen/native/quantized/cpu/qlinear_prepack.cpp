@@ -161,6 +161,29 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightsQnnp::prepack(
       std::move(w_zero_points));
   return wt_ptr;
 }
+
+c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightFp16Qnnp::prepack(
+    at::Tensor weight,
+    c10::optional<at::Tensor> bias) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::linear_prepack_fp16 (qnnpack): Weight tensor rank should be == 2");
+  if (bias.has_value()) {
+    TORCH_CHECK(
+        bias->dim() == 1 && bias->size(0) == weight.size(0),
+        "quantized::linear_prepack_fp16 (qnnpack): Given weight of size ",
+        weight.sizes(),
+        ", expected bias to be 1-dimensional with ",
+        weight.size(0),
+        " elements",
+        ", but got bias of size ",
+        bias->sizes(),
+        " instead");
+  }
+  weight = at::_saturate_weight_to_fp16(weight);
+  return c10::make_intrusive<PackedLinearWeightFp16Qnnp>(
+      weight.to(at::kHalf).contiguous(), std::move(bias));
+}
 #endif // USE_PYTORCH_QNNPACK
 
 #ifdef USE_FBGEMM
@@ -241,10 +264,8 @@ class QLinearPackWeightFp16 final {
 #endif // USE_FBGEMM
 #ifdef USE_PYTORCH_QNNPACK
     if (ctx.qEngine() == at::QEngine::QNNPACK) {
-      TORCH_CHECK(
-          false,
-          "quantized::linear_prepack_fp16 is currently "
-          "not supported by QNNPACK");
+      return PackedLinearWeightFp16Qnnp::prepack(
+          std::move(weight), std::move(bias));
     }
 #endif // USE_PYTORCH_QNNPACK
     TORCH_CHECK(
@@ -304,10 +325,12 @@ class QLinearPackWeightFp16Legacy final {
 #endif // USE_FBGEMM
 #ifdef USE_PYTORCH_QNNPACK
     if (ctx.qEngine() == at::QEngine::QNNPACK) {
-      TORCH_CHECK(
-          false,
-          "quantized::linear_prepack_fp16 is currently "
-          "not supported by QNNPACK");
+      auto prepacked = PackedLinearWeightFp16Qnnp::prepack(
+          std::move(weight), std::move(bias));
+      auto wrapped =
+          std::make_unique<c10::intrusive_ptr<LinearPackedParamsBase>>(
+              std::move(prepacked));
+      return cpp_custom_type_hack::create(std::move(wrapped), options);
     }
 #endif // USE_PYTORCH_QNNPACK
     TORCH_CHECK(
@@ -54,6 +54,11 @@ std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedLinearWeightsQnnp::
       "Call at::globalContext()::setReleaseOriginalWeights(false) before packing or loading to enable unpacking.");
   return std::tuple<at::Tensor, c10::optional<at::Tensor>>(orig_weight, bias_);
 }
+
+std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedLinearWeightFp16Qnnp::
+    unpack() {
+  return std::make_tuple(weight.to(at::kFloat), bias_);
+}
 #endif // USE_PYTORCH_QNNPACK
 
 #ifdef USE_FBGEMM
@@ -90,13 +95,6 @@ class QLinearUnpackWeightFp16 final {
  public:
   static std::tuple<at::Tensor, c10::optional<Tensor>> run(
       const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight) {
-    auto& ctx = at::globalContext();
-
-    TORCH_CHECK(
-        ctx.qEngine() != at::QEngine::QNNPACK,
-        "quantized::linear_unpack_fp16 is currently "
-        "not supported by QNNPACK");
-
     return packed_weight->unpack();
   }
 };
@@ -123,13 +121,6 @@ class QLinearUnpackWeightFp16Legacy final {
         "quantized.linear_unpack(Tensor) is deprecated! Please "
         "upgrade your model to use the newer quantized.linear_"
         "unpack(LinearPackedParamsBase) overload");
-    auto& ctx = at::globalContext();
-
-    TORCH_CHECK(
-        ctx.qEngine() != at::QEngine::QNNPACK,
-        "quantized::linear_unpack_fp16 is currently "
-        "not supported by QNNPACK");
-
     return cpp_custom_type_hack::cast<
                c10::intrusive_ptr<LinearPackedParamsBase>>(packed_weight)
         ->unpack();
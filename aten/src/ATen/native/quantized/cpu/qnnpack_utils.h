@@ -84,6 +84,51 @@ struct PackedLinearWeightsQnnp : public LinearPackedParamsBase {
   at::Tensor apply_dynamic_impl(at::Tensor input);
 };
 
+// PackedWeight struct for fp16 weights on QNNPACK. The weight is stored in
+// half precision, [N, K], which halves the memory and bandwidth of the float
+// weight, and is widened to float block by block of output channels when it is
+// used, so that the GEMM accumulates in float like the FBGEMM fp16 path and
+// gives the same numerics.
+struct PackedLinearWeightFp16Qnnp : public LinearPackedParamsBase {
+  PackedLinearWeightFp16Qnnp(at::Tensor weight, c10::optional<at::Tensor> bias)
+      : weight(std::move(weight)), bias_(std::move(bias)) {}
+
+  at::Tensor weight;
+  c10::optional<at::Tensor> bias_;
+
+  at::Tensor apply(
+      at::Tensor /*input*/,
+      double /*output_scale*/,
+      int64_t /*output_zero_point*/) override {
+    TORCH_INTERNAL_ASSERT(false);
+  }
+  at::Tensor apply_relu(
+      at::Tensor /*input*/,
+      double /*output_scale*/,
+      int64_t /*output_zero_point*/) override {
+    TORCH_INTERNAL_ASSERT(false);
+  }
+
+  at::Tensor apply_dynamic(at::Tensor input, bool reduce_range=false) override;
+  at::Tensor apply_dynamic_relu(at::Tensor input, bool reduce_range=false) override;
+
+  std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
+
+  c10::optional<at::Tensor> bias() override {
+    return bias_;
+  }
+
+  void set_bias(c10::optional<at::Tensor> bias) override;
+
+  static c10::intrusive_ptr<LinearPackedParamsBase> prepack(
+      at::Tensor weight,
+      c10::optional<at::Tensor> bias);
+
+ private:
+  template <bool ReluFused>
+  at::Tensor apply_dynamic_impl(at::Tensor input);
+};
+
 template <int kSpatialDim = 2>
 struct PackedConvWeightsQnnp : public ConvPackedParamsBase<kSpatialDim> {
   PackedConvWeightsQnnp(
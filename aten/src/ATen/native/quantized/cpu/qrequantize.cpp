@@ -0,0 +1,90 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+
+#include <array>
+#include <limits>
+
+namespace at {
+namespace native {
+namespace {
+
+// Same result as quantize_per_tensor(dequantize(qx)), without the float
+// tensor in between. 8-bit inputs only have 256 values, those are
+// requantized once and looked up.
+template <typename SRC_T, typename DST_T>
+void requantize_impl(const Tensor& qx, Tensor& qy) {
+  using src_underlying_t = typename SRC_T::underlying;
+  const double src_scale = qx.q_scale();
+  const int64_t src_zero_point = qx.q_zero_point();
+  const double dst_scale = qy.q_scale();
+  const int64_t dst_zero_point = qy.q_zero_point();
+  const SRC_T* x_data = qx.data_ptr<SRC_T>();
+  DST_T* y_data = qy.data_ptr<DST_T>();
+
+  if (sizeof(src_underlying_t) != 1) {
+    at::parallel_for(
+        0, qx.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            y_data[i] = requantize_val<SRC_T, DST_T>(
+                src_scale, src_zero_point, dst_scale, dst_zero_point, x_data[i]);
+          }
+        });
+    return;
+  }
+
+  constexpr int64_t src_min = std::numeric_limits<src_underlying_t>::min();
+  std::array<DST_T, 256> table;
+  for (int64_t v = 0; v < 256; ++v) {
+    table[v] = requantize_val<SRC_T, DST_T>(
+        src_scale,
+        src_zero_point,
+        dst_scale,
+        dst_zero_point,
+        SRC_T(static_cast<src_underlying_t>(v + src_min)));
+  }
+  at::parallel_for(
+      0, qx.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          y_data[i] = table[x_data[i].val_ - src_min];
+        }
+      });
+}
+
+Tensor qrequantize(
+    Tensor qx,
+    double scale,
+    int64_t zero_point,
+    c10::ScalarType dtype) {
+  TORCH_CHECK(
+      isQIntType(dtype),
+      "requantize expects a quantized dtype, got ",
+      toString(dtype));
+  if (qx.qscheme() != kPerTensorAffine) {
+    return at::quantize_per_tensor(qx.dequantize(), scale, zero_point, dtype);
+  }
+  const auto memory_format = qx.suggest_memory_format();
+  Tensor input = qx.contiguous(memory_format);
+  Tensor qy = at::_empty_affine_quantized(
+      input.sizes(),
+      input.options().dtype(dtype),
+      scale,
+      zero_point,
+      memory_format);
+  AT_DISPATCH_QINT_TYPES(input.scalar_type(), "requantize", [&]() {
+    using src_t = scalar_t;
+    AT_DISPATCH_QINT_TYPES(dtype, "requantize", [&]() {
+      requantize_impl<src_t, scalar_t>(input, qy);
+    });
+  });
+  return qy;
+}
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
+  m.impl("requantize", TORCH_FN(qrequantize));
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,93 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace at {
+namespace native {
+
+// This ALWAYS outputs scale=1.0/256, like sigmoid.
+// The zero_point is 0 for quint8, but -128 for qint8.
+//
+// Inputs of a slice share one scale, so exp(x - max) only depends on the
+// difference of the integer values and is read from a table of all 256
+// possible differences, the input is never dequantized.
+Tensor softmax_quantized_cpu(
+    const Tensor& qx,
+    const int64_t dim_,
+    const bool half_to_float) {
+  TORCH_CHECK(
+      !half_to_float,
+      "softmax with half to float conversion is not supported on quantized tensors");
+  TORCH_CHECK(
+      qx.qscheme() == kPerTensorAffine,
+      "Only per tensor quantization is supported in softmax.");
+  TORCH_CHECK(
+      qx.scalar_type() == kQUInt8 || qx.scalar_type() == kQInt8,
+      "softmax only supports quint8 and qint8 inputs, got ",
+      toString(qx.scalar_type()));
+  const Tensor input = qx.contiguous();
+  const int64_t dim = maybe_wrap_dim(dim_, input.dim());
+
+  constexpr double output_scale = 1.0 / 256.0;
+  const int64_t output_zero_point = qx.scalar_type() == kQInt8 ? -128 : 0;
+  Tensor qy = at::_empty_affine_quantized(
+      input.sizes(), input.options(), output_scale, output_zero_point);
+  if (input.numel() == 0) {
+    return qy;
+  }
+
+  const int64_t dim_size = input.dim() > 0 ? input.size(dim) : 1;
+  int64_t inner_size = 1;
+  for (int64_t i = dim + 1; i < input.dim(); ++i) {
+    inner_size *= input.size(i);
+  }
+  const int64_t outer_size = input.numel() / (dim_size * inner_size);
+
+  std::array<float, 256> exp_table;
+  const float input_scale = input.q_scale();
+  for (int d = 0; d < 256; ++d) {
+    exp_table[d] = std::exp(-d * input_scale);
+  }
+
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "softmax_quantized_cpu", [&]() {
+    using underlying_t = typename scalar_t::underlying;
+    const underlying_t* x_data =
+        reinterpret_cast<const underlying_t*>(input.data_ptr<scalar_t>());
+    scalar_t* y_data = qy.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / dim_size);
+    at::parallel_for(
+        0, outer_size * inner_size, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            const int64_t base =
+                (i / inner_size) * dim_size * inner_size + i % inner_size;
+            int32_t max_val = x_data[base];
+            for (int64_t k = 1; k < dim_size; ++k) {
+              max_val = std::max<int32_t>(max_val, x_data[base + k * inner_size]);
+            }
+            float sum = 0;
+            for (int64_t k = 0; k < dim_size; ++k) {
+              sum += exp_table[max_val - x_data[base + k * inner_size]];
+            }
+            const float inv_sum = 1.0f / sum;
+            for (int64_t k = 0; k < dim_size; ++k) {
+              const int64_t idx = base + k * inner_size;
+              y_data[idx] = quantize_val<scalar_t>(
+                  output_scale,
+                  output_zero_point,
+                  exp_table[max_val - x_data[idx]] * inv_sum);
+            }
+          }
+        });
+  });
+  return qy;
+}
+
+} // namespace native
+} // namespace at
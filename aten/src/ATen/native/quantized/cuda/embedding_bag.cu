@@ -0,0 +1,365 @@
+#include <ATen/ATen.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <torch/library.h>
+
+#include <THC/THCDeviceUtils.cuh>
+
+/*
+ * CUDA kernels for the row-wise quantized embedding tables made by
+ * embedding_bag_{byte,4bit,2bit}_prepack. Each row of the packed weight holds
+ * the quantized values followed by the scale and the bias of the row:
+ * | ... quantized data ... | scale | bias |
+ * They are float for 8-bit rows and half for 4-bit and 2-bit rows, where
+ * multiple values share a byte, the first one in the lowest bits.
+ * The results match the CPU implementation.
+ */
+namespace at {
+namespace native {
+namespace {
+
+template <int bit_rate>
+struct RowwiseQuantTraits {
+  // the 4-bit and 2-bit rows store the scale and bias as fp16
+  using scale_t = at::Half;
+};
+
+template <>
+struct RowwiseQuantTraits<8> {
+  using scale_t = float;
+};
+
+// The scale and bias follow the quantized data of a row, that has any length,
+// so they are not aligned
+template <typename T>
+__device__ __forceinline__ float load_unaligned(const uint8_t* ptr) {
+  T value;
+  memcpy(&value, ptr, sizeof(T));
+  return static_cast<float>(value);
+}
+
+template <typename T>
+__device__ __forceinline__ void store_unaligned(uint8_t* ptr, T value) {
+  memcpy(ptr, &value, sizeof(T));
+}
+
+// Sum mode only, like the CPU operators. Each bag x column is handled by one
+// thread, the threads along x read consecutive bytes of the same rows.
+template <int bit_rate>
+__global__ void embedding_bag_rowwise_kernel(
+    const uint8_t* __restrict__ weight,
+    int64_t num_rows,
+    int64_t row_bytes,
+    const int64_t* __restrict__ indices,
+    int64_t num_indices,
+    const int64_t* __restrict__ offsets,
+    int64_t num_offsets,
+    const float* __restrict__ per_sample_weights,
+    const int32_t* __restrict__ compressed_indices_mapping,
+    int64_t compressed_index_size,
+    float* __restrict__ output,
+    int64_t num_bags,
+    int64_t embedding_dim) {
+  using scale_t = typename RowwiseQuantTraits<bit_rate>::scale_t;
+  constexpr int kElemPerByte = 8 / bit_rate;
+  constexpr int kMask = (1 << bit_rate) - 1;
+
+  const int64_t chunks_per_bag = THCCeilDiv(embedding_dim, (int64_t)blockDim.x);
+  const int64_t num_chunks = num_bags * chunks_per_bag;
+  const int64_t chunk_offset = blockIdx.x * blockDim.y + threadIdx.y;
+  const int64_t chunk_stride = gridDim.x * blockDim.y;
+
+  for (int64_t chunk = chunk_offset; chunk < num_chunks; chunk += chunk_stride) {
+    const int64_t col = (chunk % chunks_per_bag) * blockDim.x + threadIdx.x;
+    if (col >= embedding_dim) {
+      continue;
+    }
+    const int64_t bag = chunk / chunks_per_bag;
+    const int64_t begin = offsets[bag];
+    const int64_t end = bag + 1 < num_offsets ? offsets[bag + 1] : num_indices;
+    CUDA_KERNEL_ASSERT(begin <= end && end <= num_indices);
+
+    float sum = 0;
+    for (int64_t i = begin; i < end; ++i) {
+      int64_t idx = indices[i];
+      if (compressed_indices_mapping) {
+        CUDA_KERNEL_ASSERT(idx >= 0 && idx < compressed_index_size);
+        idx = compressed_indices_mapping[idx];
+        if (idx == -1) {
+          continue;
+        }
+      }
+      CUDA_KERNEL_ASSERT(idx >= 0 && idx < num_rows);
+      const uint8_t* row = weight + idx * row_bytes;
+      const uint8_t* scale_bias = row + row_bytes - 2 * sizeof(scale_t);
+      const float weight_val = per_sample_weights ? per_sample_weights[i] : 1.0f;
+      const float scale = weight_val * load_unaligned<scale_t>(scale_bias);
+      const float bias =
+          weight_val * load_unaligned<scale_t>(scale_bias + sizeof(scale_t));
+      const int quantized =
+          (row[col / kElemPerByte] >> ((col % kElemPerByte) * bit_rate)) & kMask;
+      sum = fmaf(scale, quantized, sum + bias);
+    }
+    output[bag * embedding_dim + col] = sum;
+  }
+}
+
+template <int bit_rate>
+Tensor embedding_bag_rowwise_offsets_cuda(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  using scale_t = typename RowwiseQuantTraits<bit_rate>::scale_t;
+  constexpr int kElemPerByte = 8 / bit_rate;
+
+  TORCH_CHECK(
+      offsets_in.has_value(),
+      "embedding_bag_rowwise_offsets expects offsets to be set");
+  const auto& offsets = offsets_in.value();
+  TORCH_CHECK(weight.scalar_type() == at::kByte);
+  TORCH_CHECK(weight.dim() == 2);
+  TORCH_CHECK(indices.dim() == 1 && indices.scalar_type() == at::kLong);
+  TORCH_CHECK(offsets.dim() == 1 && offsets.scalar_type() == at::kLong);
+  checkAllSameGPU(
+      "embedding_bag_rowwise_offsets",
+      {{weight, "weight", 1}, {indices, "indices", 2}, {offsets, "offsets", 3}});
+  TORCH_CHECK(
+      !include_last_offset || offsets.numel() > 0,
+      "include_last_offset expects at least one offset");
+  c10::cuda::CUDAGuard device_guard(weight.device());
+
+  const auto weight_contig = weight.contiguous();
+  const auto indices_contig = indices.contiguous();
+  const auto offsets_contig = offsets.contiguous();
+  Tensor per_sample_weights;
+  if (per_sample_weights_.has_value()) {
+    per_sample_weights = per_sample_weights_->contiguous();
+    TORCH_CHECK(per_sample_weights.scalar_type() == at::kFloat);
+    TORCH_CHECK(per_sample_weights.numel() == indices.numel());
+  }
+  Tensor mapping;
+  if (sparse) {
+    TORCH_CHECK(
+        compressed_indices_mapping.has_value(),
+        "sparse embedding_bag_rowwise_offsets expects compressed_indices_mapping");
+    mapping = compressed_indices_mapping->to(weight.device(), at::kInt).contiguous();
+  }
+
+  const int64_t row_bytes = weight.size(1);
+  const int64_t embedding_dim =
+      (row_bytes - 2 * static_cast<int64_t>(sizeof(scale_t))) * kElemPerByte;
+  TORCH_CHECK(embedding_dim >= 0, "invalid row-wise quantized weight");
+  const int64_t num_offsets = offsets.numel();
+  const int64_t num_bags = include_last_offset ? num_offsets - 1 : num_offsets;
+
+  auto output = at::empty(
+      {num_bags, embedding_dim}, weight.options().dtype(at::kFloat));
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  const dim3 block(32, 8);
+  const int64_t chunks =
+      num_bags * THCCeilDiv(embedding_dim, static_cast<int64_t>(block.x));
+  const int grid = static_cast<int>(std::min<int64_t>(
+      THCCeilDiv(chunks, static_cast<int64_t>(block.y)), 1024));
+  embedding_bag_rowwise_kernel<bit_rate>
+      <<<grid, block, 0, at::cuda::getCurrentCUDAStream()>>>(
+          weight_contig.data_ptr<uint8_t>(),
+          weight.size(0),
+          row_bytes,
+          indices_contig.data_ptr<int64_t>(),
+          indices.numel(),
+          offsets_contig.data_ptr<int64_t>(),
+          num_offsets,
+          per_sample_weights.defined() ? per_sample_weights.data_ptr<float>()
+                                       : nullptr,
+          mapping.defined() ? mapping.data_ptr<int32_t>() : nullptr,
+          mapping.defined() ? mapping.numel() : 0,
+          output.data_ptr<float>(),
+          num_bags,
+          embedding_dim);
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+Tensor embedding_bag_byte_rowwise_offsets_cuda(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    const bool /* scale_grad_by_freq */,
+    const int64_t /* mode */,
+    bool /* sparse */,
+    const c10::optional<Tensor>& per_sample_weights_,
+    bool include_last_offset) {
+  return embedding_bag_rowwise_offsets_cuda<8>(
+      weight,
+      indices,
+      offsets_in,
+      /*sparse=*/false,
+      per_sample_weights_,
+      c10::nullopt,
+      include_last_offset);
+}
+
+Tensor embedding_bag_4bit_rowwise_offsets_cuda(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    const bool /* scale_grad_by_freq */,
+    const int64_t /* mode */,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_rowwise_offsets_cuda<4>(
+      weight,
+      indices,
+      offsets_in,
+      sparse,
+      per_sample_weights_,
+      compressed_indices_mapping,
+      include_last_offset);
+}
+
+// One thread per byte of the packed rows, the threads of the first byte of
+// each row also write its scale and bias. Follows the rounding of the CPU
+// prepack functions, so both make the same packed weight.
+template <int bit_rate>
+__global__ void embedding_bag_rowwise_prepack_kernel(
+    const float* __restrict__ weight,
+    const float* __restrict__ row_min,
+    const float* __restrict__ row_max,
+    uint8_t* __restrict__ output,
+    int64_t num_rows,
+    int64_t embedding_cols,
+    int64_t output_columns) {
+  using scale_t = typename RowwiseQuantTraits<bit_rate>::scale_t;
+  constexpr int kElemPerByte = 8 / bit_rate;
+  constexpr int kQMax = (1 << bit_rate) - 1;
+  const int64_t data_bytes = THCCeilDiv(embedding_cols, (int64_t)kElemPerByte);
+
+  for (int64_t linear = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+       linear < num_rows * data_bytes;
+       linear += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int64_t row = linear / data_bytes;
+    const int64_t byte = linear % data_bytes;
+    const float* input_row = weight + row * embedding_cols;
+    uint8_t* output_row = output + row * output_columns;
+
+    float x_min = row_min[row];
+    float scale;
+    float inverse_scale;
+    if (bit_rate == 8) {
+      constexpr float kEpsilon = 1e-8f;
+      const float range = row_max[row] - x_min;
+      scale = range / 255.0f;
+      inverse_scale = 255.0f / (range + kEpsilon);
+    } else {
+      x_min = static_cast<float>(static_cast<at::Half>(x_min));
+      const float range = row_max[row] - x_min;
+      scale = static_cast<at::Half>(range == 0 ? 1.0f : range / kQMax);
+      inverse_scale = scale == 0 ? 1.0f : 1.0f / scale;
+      if (scale == 0 || isinf(inverse_scale)) {
+        scale = 1.0f;
+        inverse_scale = 1.0f;
+      }
+    }
+
+    uint8_t packed = 0;
+    for (int k = 0; k < kElemPerByte; ++k) {
+      const int64_t col = byte * kElemPerByte + k;
+      if (col < embedding_cols) {
+        int64_t quantized = lrintf((input_row[col] - x_min) * inverse_scale);
+        if (bit_rate != 8) {
+          quantized = quantized < 0 ? 0 : (quantized > kQMax ? kQMax : quantized);
+        }
+        packed |= static_cast<uint8_t>(quantized) << (k * bit_rate);
+      }
+    }
+    output_row[byte] = packed;
+    if (byte == 0) {
+      store_unaligned<scale_t>(output_row + data_bytes, scale);
+      store_unaligned<scale_t>(output_row + data_bytes + sizeof(scale_t), x_min);
+    }
+  }
+}
+
+template <int bit_rate>
+Tensor embedding_bag_rowwise_prepack_cuda(const Tensor& weight) {
+  using scale_t = typename RowwiseQuantTraits<bit_rate>::scale_t;
+  constexpr int kElemPerByte = 8 / bit_rate;
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == at::kFloat,
+      "embedding_bag_prepack expects a 2-D float weight");
+  TORCH_CHECK(
+      weight.size(1) % kElemPerByte == 0,
+      "embedding_bag_prepack only works for the number of columns a multiple of ",
+      kElemPerByte);
+  c10::cuda::CUDAGuard device_guard(weight.device());
+
+  const auto weight_contig = weight.contiguous();
+  const int64_t num_rows = weight.size(0);
+  const int64_t embedding_cols = weight.size(1);
+  const int64_t data_bytes = embedding_cols / kElemPerByte;
+  const int64_t output_columns = data_bytes + 2 * sizeof(scale_t);
+  auto output =
+      at::empty({num_rows, output_columns}, weight.options().dtype(at::kByte));
+  if (num_rows == 0 || embedding_cols == 0) {
+    return output;
+  }
+
+  Tensor row_min, row_max;
+  std::tie(row_min, row_max) = at::_aminmax(weight_contig, 1);
+  row_min = row_min.contiguous();
+  row_max = row_max.contiguous();
+
+  constexpr int kThreads = 256;
+  const int grid = static_cast<int>(std::min<int64_t>(
+      THCCeilDiv(num_rows * data_bytes, static_cast<int64_t>(kThreads)),
+      at::cuda::getCurrentDeviceProperties()->multiProcessorCount * 8));
+  embedding_bag_rowwise_prepack_kernel<bit_rate>
+      <<<grid, kThreads, 0, at::cuda::getCurrentCUDAStream()>>>(
+          weight_contig.data_ptr<float>(),
+          row_min.data_ptr<float>(),
+          row_max.data_ptr<float>(),
+          output.data_ptr<uint8_t>(),
+          num_rows,
+          embedding_cols,
+          output_columns);
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+Tensor embedding_bag_byte_prepack_cuda(const Tensor& weight) {
+  return embedding_bag_rowwise_prepack_cuda<8>(weight);
+}
+
+Tensor embedding_bag_4bit_prepack_cuda(const Tensor& weight) {
+  return embedding_bag_rowwise_prepack_cuda<4>(weight);
+}
+
+Tensor embedding_bag_2bit_prepack_cuda(const Tensor& weight) {
+  return embedding_bag_rowwise_prepack_cuda<2>(weight);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CUDA, m) {
+  m.impl("embedding_bag_byte_prepack", embedding_bag_byte_prepack_cuda);
+  m.impl("embedding_bag_4bit_prepack", embedding_bag_4bit_prepack_cuda);
+  m.impl("embedding_bag_2bit_prepack", embedding_bag_2bit_prepack_cuda);
+  m.impl(
+      "embedding_bag_byte_rowwise_offsets",
+      embedding_bag_byte_rowwise_offsets_cuda);
+  m.impl(
+      "embedding_bag_4bit_rowwise_offsets",
+      embedding_bag_4bit_rowwise_offsets_cuda);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -64,6 +64,8 @@ TORCH_LIBRARY(quantized, m) {
   m.def("conv1d_relu(Tensor qx, __torch__.torch.classes.quantized.Conv2dPackedParamsBase packed_weight, float output_scale, int output_zero_point) -> Tensor");
   m.def("conv2d.new(Tensor qx, __torch__.torch.classes.quantized.Conv2dPackedParamsBase packed_weight, float output_scale, int output_zero_point) -> Tensor");
   m.def("conv2d_relu.new(Tensor qx, __torch__.torch.classes.quantized.Conv2dPackedParamsBase packed_weight, float output_scale, int output_zero_point) -> Tensor");
+  m.def("conv2d_add(Tensor qx, __torch__.torch.classes.quantized.Conv2dPackedParamsBase packed_weight, Tensor qother, float conv_scale, int conv_zero_point, float output_scale, int output_zero_point) -> Tensor");
+  m.def("conv2d_add_relu(Tensor qx, __torch__.torch.classes.quantized.Conv2dPackedParamsBase packed_weight, Tensor qother, float conv_scale, int conv_zero_point, float output_scale, int output_zero_point) -> Tensor");
   m.def("conv3d.new(Tensor qx, __torch__.torch.classes.quantized.Conv3dPackedParamsBase packed_weight, float output_scale, int output_zero_point) -> Tensor");
   m.def("conv3d_relu.new(Tensor qx, __torch__.torch.classes.quantized.Conv3dPackedParamsBase packed_weight, float output_scale, int output_zero_point) -> Tensor");
   m.def("conv2d(Tensor qx, __torch__.torch.classes.quantized.Conv2dPackedParamsBase weight, int[] stride, int[] padding, int[] dilation, int groups, float output_scale, int output_zero_point) -> Tensor");
@@ -154,6 +156,7 @@ TORCH_LIBRARY(quantized, m) {
   // NB: missing a space after comma here...
   m.def("max_pool2d(Tensor qx, int[] kernel_size, int[] stride, int[] padding, int[] dilation,bool ceil_mode) -> Tensor");
   m.def("relu6(Tensor qx, bool inplace=False) -> Tensor");
+  m.def("requantize(Tensor qx, float scale, int zero_point, ScalarType dtype) -> Tensor");
 }
 
 // According to #33294: The "_" prefix registration will be
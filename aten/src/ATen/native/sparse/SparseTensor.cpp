@@ -10,6 +10,10 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -384,44 +388,95 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   Tensor newValues = at::empty(values.sizes(), values.options());
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
+  // Group the entries by flattened index with an open addressing hash table
+  // instead of sorting all nnz of them. Only the unique indices are sorted,
+  // which is much cheaper when there are many duplicates, like in the
+  // gradient of an embedding.
+  auto indicesScalarAccessor = indices_scalar.accessor<int64_t, 1>();
+  int64_t capacity = 1;
+  while (capacity < 2 * nnz) {
+    capacity <<= 1;
+  }
+  std::vector<int64_t> table(capacity, -1);
+  std::vector<int64_t> groupOf(nnz);
+  std::vector<int64_t> uniqueKeys;
+  std::vector<int64_t> firstPos;
+  for (int64_t j = 0; j < nnz; j++) {
+    const int64_t key = indicesScalarAccessor[j];
+    int64_t slot = static_cast<int64_t>(
+        (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+    while (table[slot] != -1 && uniqueKeys[table[slot]] != key) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    if (table[slot] == -1) {
+      table[slot] = uniqueKeys.size();
+      uniqueKeys.push_back(key);
+      firstPos.push_back(j);
+    }
+    groupOf[j] = table[slot];
+  }
+  const int64_t newNnz = uniqueKeys.size();
+
+  std::vector<int64_t> order(newNnz);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return uniqueKeys[a] < uniqueKeys[b];
+  });
+  std::vector<int64_t> rank(newNnz);
+  for (int64_t r = 0; r < newNnz; r++) {
+    rank[order[r]] = r;
+  }
+
+  // Counting sort of the entries by the rank of their index, entries of
+  // output r are permutation[offsets[r]] to permutation[offsets[r + 1] - 1]
+  std::vector<int64_t> offsets(newNnz + 1, 0);
+  for (int64_t j = 0; j < nnz; j++) {
+    offsets[rank[groupOf[j]] + 1]++;
+  }
+  for (int64_t r = 0; r < newNnz; r++) {
+    offsets[r + 1] += offsets[r];
+  }
+  std::vector<int64_t> permutation(nnz);
+  {
+    std::vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+    for (int64_t j = 0; j < nnz; j++) {
+      permutation[next[rank[groupOf[j]]]++] = j;
+    }
+  }
+
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
-
-  int64_t i = -1;
-  AT_DISPATCH_ALL_TYPES(
-      values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
-        int64_t blockSize = values.stride(0);
-        scalar_t* values_ptr = values.data_ptr<scalar_t>();
-        scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
-            for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
-            }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+  for (int64_t r = 0; r < newNnz; r++) {
+    const int64_t pos = firstPos[order[r]];
+    for (int64_t d = 0; d < sparse_dim; d++) {
+      newIndicesAccessor[d][r] = indicesAccessor[d][pos];
+    }
+  }
+
+  // if values is an empty tensor, there are no elements to copy
+  if (values.numel() > 0) {
+    AT_DISPATCH_ALL_TYPES(
+        values.scalar_type(), "coalesce", [&] {
+          int64_t blockSize = values.stride(0);
+          scalar_t* values_ptr = values.data_ptr<scalar_t>();
+          scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
+          const int64_t grain_size =
+              std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, blockSize * nnz / newNnz));
+          at::parallel_for(0, newNnz, grain_size, [&](int64_t begin, int64_t end) {
+            for (int64_t r = begin; r < end; r++) {
+              scalar_t* out = newValues_ptr + r * blockSize;
+              THBlas_copy<scalar_t>(blockSize, values_ptr + permutation[offsets[r]] * blockSize, 1, out, 1);
+              for (int64_t k = offsets[r] + 1; k < offsets[r + 1]; k++) {
+                THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + permutation[k] * blockSize, 1, out, 1);
+              }
             }
-          }
-          prev = curr;
-        }
-    });
+          });
+      });
+  }
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
+  get_sparse_impl(dst)->set_nnz_and_narrow(newNnz);
 
   return dst;
 }
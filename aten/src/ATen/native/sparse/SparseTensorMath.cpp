@@ -12,6 +12,7 @@
 #include <TH/THBlasUtils.h>
 
 #include <algorithm>
+#include <numeric>
 
 namespace at { namespace native {
 
@@ -42,6 +43,48 @@ namespace {
     return csr;
   }
 
+  // Groups the entries of a 2-D sparse tensor by row with a counting sort
+  // instead of coalescing it, duplicate entries are kept and each adds its
+  // share to the products.
+  SparseCSR _to_csr_uncoalesced(const LongTensor& indices, int64_t dim_i, int64_t dim_j) {
+    int64_t nnz = indices.size(1);
+    LongTensor rows = indices.select(0, 0).contiguous();
+    LongTensor cols = indices.select(0, 1).contiguous();
+    const int64_t* rows_ptr = rows.data_ptr<int64_t>();
+    const int64_t* cols_ptr = cols.data_ptr<int64_t>();
+
+    LongTensor crow = native::zeros({dim_i + 1}, kLong);
+    int64_t* crow_ptr = crow.data_ptr<int64_t>();
+    bool sorted = true;
+    for (int64_t i = 0; i < nnz; i++) {
+      int64_t row = rows_ptr[i];
+      int64_t col = cols_ptr[i];
+      if (col < 0 || col >= dim_j) {
+        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+      } else if (row < 0 || row >= dim_i) {
+        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+      }
+      sorted = sorted && (i == 0 || rows_ptr[i - 1] <= row);
+      crow_ptr[row + 1]++;
+    }
+    std::partial_sum(crow_ptr, crow_ptr + dim_i + 1, crow_ptr);
+
+    SparseCSR csr;
+    csr.crow_indices = crow;
+    if (sorted) {
+      csr.col_indices = cols;
+      return csr;
+    }
+    std::vector<int64_t> next(crow_ptr, crow_ptr + dim_i);
+    csr.permutation = at::empty({nnz}, kLong);
+    int64_t* perm_ptr = csr.permutation.data_ptr<int64_t>();
+    for (int64_t i = 0; i < nnz; i++) {
+      perm_ptr[next[rows_ptr[i]]++] = i;
+    }
+    csr.col_indices = cols.index_select(0, csr.permutation);
+    return csr;
+  }
+
 }
 
 // --------------------------------------------------------------------
@@ -578,7 +621,10 @@ SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const S
 
   r.resize_as_(src);
 
-  if (src._values().is_contiguous() && t._values().is_contiguous()) {
+  // Merging only produces a coalesced result from coalesced inputs, otherwise
+  // concatenating is cheaper and duplicates are summed by the next coalesce.
+  if (src._values().is_contiguous() && t._values().is_contiguous() &&
+      t.is_coalesced() && src.is_coalesced()) {
     return add_out_sparse_contiguous(r, t, src, value, commonDtype);
   } else {
     return add_out_sparse_non_contiguous(r, t, src, value, commonDtype);
@@ -647,15 +693,21 @@ Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTen
 
   // accessors rely on nnz test
   if (nDim > nDimI) {
+    // sparse is coalesced, every entry writes to a different slice of the
+    // result and the entries can be added in parallel
     auto indices_accessor = indices.accessor<int64_t, 2>();
-    for (int64_t k = 0; k < sparse._nnz(); k++) {
-      Tensor dstBuffer = resultBuffer;
-      for (int64_t d = 0; d < sparse.sparse_dim(); d++) {
-        dstBuffer = dstBuffer.select(0, indices_accessor[d][k]);
+    const int64_t slice_numel = std::max<int64_t>(1, valuesBuffer.numel() / sparse._nnz());
+    const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / slice_numel);
+    at::parallel_for(0, sparse._nnz(), grain_size, [&](int64_t start, int64_t end) {
+      for (int64_t k = start; k < end; k++) {
+        Tensor dstBuffer = resultBuffer;
+        for (int64_t d = 0; d < nDimI; d++) {
+          dstBuffer = dstBuffer.select(0, indices_accessor[d][k]);
+        }
+        Tensor srcBuffer = valuesBuffer.select(0, k);
+        dstBuffer.add_(srcBuffer, value);
       }
-      Tensor srcBuffer = valuesBuffer.select(0, k);
-      dstBuffer.add_(srcBuffer, value);
-    }
+    });
   } else {
     AT_DISPATCH_ALL_TYPES(
         commonDtype, "add_dense_sparse", [&] {
@@ -674,14 +726,69 @@ Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTen
 
 Tensor mul_sparse(const Tensor& self, const Tensor& other) {
   auto commonDtype = at::result_type(self, other);
-  Tensor result = at::empty({0}, self.options().dtype(commonDtype));
+  // the product of a sparse and a dense tensor is sparse
+  const Tensor& sparse = self.is_sparse() ? self : other;
+  Tensor result = at::empty({0}, sparse.options().dtype(commonDtype));
   return at::mul_out(result, self, other);  // redispatch!
 }
 
 Tensor& mul_sparse_(Tensor& self, const Tensor& other) {
+  if (!self.is_sparse()) {
+    // dense *= sparse, everything outside of the coordinates of other is zero
+    SparseTensor product = at::mul(other, self);
+    return self.zero_().add_(product);
+  }
   return at::mul_out(self, self, other);  // redispatch!
 }
 
+// --------------------------------------------------------------------
+// mul(SparseTensor, Tensor)
+//
+// The product is zero wherever the sparse tensor is, so only the entries
+// of the dense tensor at the coordinates of the sparse one are read. The
+// dense tensor can broadcast to the size of the sparse one, the broadcast
+// is never materialized.
+// --------------------------------------------------------------------
+
+SparseTensor& mul_out_sparse_dense(SparseTensor& r, const SparseTensor& t, const Tensor& dense) {
+  AT_ASSERT(t.is_sparse());
+  AT_ASSERT(!dense.is_sparse());
+  TORCH_CHECK(r.is_sparse(), "mul: expected 'out' to be a sparse tensor when multiplying a sparse and a dense tensor");
+  TORCH_CHECK(dense.device() == t.device(), "mul: expected the dense tensor to be on ", t.device(), " like the sparse tensor, but got ", dense.device());
+  TORCH_CHECK(is_expandable_to(dense.sizes(), t.sizes()), "mul: expected the dense tensor of size ", dense.sizes(),
+    " to be broadcastable to the size of the sparse tensor ", t.sizes());
+
+  auto commonDtype = at::result_type(t, dense);
+  TORCH_CHECK(canCast(commonDtype, r.scalar_type()), "Can't convert result type ", commonDtype, " to output ", r.scalar_type(), " in mul operation");
+
+  // saving those because they can be overwritten when doing in-place operations
+  const bool coalesced = t.is_coalesced();
+  const int64_t sparse_dim = t.sparse_dim();
+  LongTensor indices = t._indices();
+  Tensor values = t._values();
+
+  Tensor expanded = dense.expand(t.sizes());
+  Tensor gathered;
+  if (sparse_dim == 0) {
+    gathered = expanded.unsqueeze(0).expand(values.sizes());
+  } else {
+    std::vector<Tensor> coordinates;
+    coordinates.reserve(sparse_dim);
+    for (int64_t d = 0; d < sparse_dim; d++) {
+      coordinates.push_back(indices.select(0, d));
+    }
+    gathered = expanded.index(coordinates);
+  }
+  Tensor r_values = at::mul(values.to(commonDtype), gathered.to(commonDtype)).to(r.scalar_type());
+
+  if (!is_same_tensor(r, t)) {
+    r.resize_as_(t);
+    indices = indices.clone(at::MemoryFormat::Contiguous);
+  }
+  alias_into_sparse(r, indices, r_values);
+  return r._coalesced_(coalesced);
+}
+
 SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor& src_) {
   if (src_.dim() == 0) {
     return mul_out_sparse_zerodim(r, t_, src_);
@@ -689,6 +796,12 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
     return mul_out_sparse_zerodim(r, src_, t_);
   }
 
+  if (!src_.is_sparse()) {
+    return mul_out_sparse_dense(r, t_, src_);
+  } else if (!t_.is_sparse()) {
+    return mul_out_sparse_dense(r, src_, t_);
+  }
+
   TORCH_CHECK(t_.sizes().equals(src_.sizes()), "mul operands have incompatible sizes");
   AT_ASSERT(!t_.is_cuda()); // dispatch argument
   TORCH_CHECK(!r.is_cuda(), "mul: expected 'out' to be CPU tensor, but got CUDA tensor");
@@ -792,9 +905,7 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 // --------------------------------------------------------------------
 
 template <typename scalar_t>
-void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
-
+void s_addmm_out_sparse_dense_worker(int64_t dim_i, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const SparseCSR& csr, const Tensor& values, const Tensor& dense) {
   // r_ = alpha * sparse * dense
   scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
@@ -808,9 +919,10 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
     at::mul_out(r, t, scalar_to_tensor(beta));
   }
 
-  auto indices_accessor = indices.accessor<int64_t, 2>();
-
-  auto values_accessor = values.accessor<scalar_t, 1>();
+  const int64_t* crow_ptr = csr.crow_indices.data_ptr<int64_t>();
+  const int64_t* col_ptr = csr.col_indices.data_ptr<int64_t>();
+  const int64_t* perm_ptr = csr.permutation.defined() ? csr.permutation.data_ptr<int64_t>() : nullptr;
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
   scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
   scalar_t* r_ptr = r.data_ptr<scalar_t>();
 
@@ -818,23 +930,32 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
   int64_t dense_stride1 = dense.stride(1);
   int64_t r_stride0 = r.stride(0);
   int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
-    int64_t row = indices_accessor[0][i];
-    int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+
+  // Every row of r only gets the entries of the same row of sparse, the
+  // rows are split so that a task does about GRAIN_SIZE multiply-adds
+  int64_t nnz = crow_ptr[dim_i];
+  int64_t row_work = std::max<int64_t>(1, nnz / std::max<int64_t>(1, dim_i) * dim_k);
+  at::parallel_for(0, dim_i, std::max<int64_t>(1, internal::GRAIN_SIZE / row_work), [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      scalar_t* r_row = r_ptr + row * r_stride0;
+      if (dim_k == 1) {
+        // matrix-vector product
+        scalar_t sum = 0;
+        for (int64_t p = crow_ptr[row]; p < crow_ptr[row + 1]; p++) {
+          sum += values_ptr[perm_ptr ? perm_ptr[p] : p] * dense_ptr[col_ptr[p] * dense_stride0];
+        }
+        *r_row += cast_alpha * sum;
+        continue;
+      }
+      for (int64_t p = crow_ptr[row]; p < crow_ptr[row + 1]; p++) {
+        scalar_t val = values_ptr[perm_ptr ? perm_ptr[p] : p];
+        THBlas_axpy<scalar_t>(dim_k,
+              cast_alpha * val,
+              dense_ptr + col_ptr[p] * dense_stride0, dense_stride1,
+              r_row, r_stride1);
       }
     }
-  }
+  });
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -876,12 +997,16 @@ Tensor& s_addmm_out_sparse_dense_cpu(
     return r;
   }
 
-  LongTensor indices = sparse_._indices();
-  Tensor values      = sparse_._values();
+  // The CSR form is kept on the sparse tensor, multiplying by the same
+  // matrix again does not need to convert it
+  SparseCSR csr = get_sparse_impl(sparse_)->csr(kLong, [&](const LongTensor& indices) {
+    return _to_csr_uncoalesced(indices, dim_i, dim_j);
+  });
+  Tensor values = sparse_._values().contiguous();
 
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "addmm_sparse_dense", [&] {
-        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, indices, values, dense);
+        s_addmm_out_sparse_dense_worker<scalar_t>(dim_i, dim_k, r, beta, t, alpha, csr, values, dense);
       }
   );
 
@@ -1575,15 +1700,14 @@ Tensor& bmm_out_sparse_cpu(Tensor& result, const SparseTensor& self, const Tenso
           const Tensor dense_matrix = mat2[cur_mat_num];
           Tensor result_matrix = result[cur_mat_num];
           LongTensor sparse_indices = indices_dim1_dim2.slice(1, mat_el_begin_idx, mat_el_end_idx);
-          Tensor sparse_values = values.slice(0, mat_el_begin_idx, mat_el_end_idx);
-          int64_t sparse_nnz = mat_el_end_idx - mat_el_begin_idx;
+          Tensor sparse_values = values.slice(0, mat_el_begin_idx, mat_el_end_idx).contiguous();
+          SparseCSR sparse_csr = _to_csr_uncoalesced(sparse_indices, dim_i, dim_j);
 
           s_addmm_out_sparse_dense_worker<scalar_t>(
-            sparse_nnz,
-            dim_i, dim_j, dim_k,
+            dim_i, dim_k,
             result_matrix,
             beta, t_dummy, alpha,
-            sparse_indices, sparse_values,
+            sparse_csr, sparse_values,
             dense_matrix
           );
           mat_el_begin_idx = mat_el_end_idx;
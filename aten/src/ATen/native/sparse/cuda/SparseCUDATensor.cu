@@ -70,9 +70,11 @@ SparseTensor coalesce_sparse_cuda(const SparseTensor& self) {
   thrust::copy(policy, countIterI, countIterI + nnz, origIndicesIter);
   thrust::copy(policy, countIterO, countIterO + nnz, uniqueOffsetsIter);
 
+  // No custom comparator, so that Thrust can use its radix sort for the
+  // integer keys
   thrust::sort_by_key(policy,
     indicesIter, indicesIter + nnz,
-    origIndicesIter, ThrustLTOp<int64_t>()
+    origIndicesIter
   );
 
   // this forces device-host synchronization!
@@ -52,14 +52,11 @@ namespace {
 // wired at all)
 
 template <typename scalar_t>
-void s_addmm_out_sparse_dense_cuda_worker(int64_t nnz, int64_t m, int64_t n, int64_t k, Tensor& r_, Scalar beta, const Tensor& t, Scalar alpha, LongTensor& indices, Tensor& values, const Tensor& dense) {
+void s_addmm_out_sparse_dense_cuda_worker(int64_t nnz, int64_t m, int64_t n, int64_t k, Tensor& r_, Scalar beta, const Tensor& t, Scalar alpha, const SparseCSR& sparse_csr, Tensor& values, const Tensor& dense) {
   scalar_t cast_beta = beta.to<scalar_t>();
   scalar_t cast_alpha = alpha.to<scalar_t>();
-  LongTensor rowIndices = indices.select(0, 0);
-  LongTensor colIndices = indices.select(0, 1);
-  IntTensor csr = _to_csr_int(rowIndices, m, nnz);
-  IntTensor colIndicesInt = at::empty({colIndices.size(0)}, indices.options().dtype(kInt));
-  colIndicesInt.copy_(colIndices);
+  const IntTensor& csr = sparse_csr.crow_indices;
+  const IntTensor& colIndicesInt = sparse_csr.col_indices;
 
   Tensor r__;
   if (cast_beta == 0) {
@@ -147,14 +144,20 @@ Tensor& s_addmm_out_sparse_dense_cuda(Tensor& r_, const Tensor& t, const SparseT
   SparseTensor sparse = sparse_.coalesce();
 
   int64_t nnz = sparse._nnz();
-  LongTensor indices = sparse._indices();
   Tensor values = sparse._values();
-
+  // The CSR form is kept on the coalesced tensor, so that multiplying by
+  // the same matrix again does not convert it
+  SparseCSR csr = get_sparse_impl(sparse)->csr(kInt, [&](const LongTensor& indices) {
+    SparseCSR result;
+    result.crow_indices = _to_csr_int(indices.select(0, 0), m, nnz);
+    result.col_indices = indices.select(0, 1).to(kInt);
+    return result;
+  });
 
   // No half support, so we don't have to use CUDATypeConversion
   AT_DISPATCH_FLOATING_TYPES(
     values.scalar_type(), "addmm_sparse_cuda", [&] {
-      s_addmm_out_sparse_dense_cuda_worker<scalar_t>(nnz, m, n, k, r_, beta, t, alpha, indices, values, dense);
+      s_addmm_out_sparse_dense_cuda_worker<scalar_t>(nnz, m, n, k, r_, beta, t, alpha, csr, values, dense);
     }
   );
 
@@ -489,6 +492,12 @@ SparseTensor& mul_out_sparse_cuda(SparseTensor& r_, const SparseTensor& t_, cons
     return mul_out_sparse_zerodim(r_, src_, t_);
   }
 
+  if (!src_.is_sparse()) {
+    return mul_out_sparse_dense(r_, t_, src_);
+  } else if (!t_.is_sparse()) {
+    return mul_out_sparse_dense(r_, src_, t_);
+  }
+
   TORCH_CHECK(t_.is_cuda(), "mul: expected 'self' to be CUDA, but got CPU");
   TORCH_CHECK(src_.is_cuda(), "mul: expected 'other' to be CUDA, but got CPU");
   TORCH_CHECK(r_.is_cuda(), "mul: expected 'out' to be CUDA, but got CPU");
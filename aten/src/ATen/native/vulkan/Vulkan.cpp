@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <iostream>
@@ -42,6 +43,9 @@ VContext::VContext(const bool enableValidationLayers)
   createDevice();
 
   computeUnitFactory_ = std::make_unique<ComputeUnitFactory>(device_);
+  resourcePool_ = std::make_unique<ResourcePool>(device_);
+  commandRecorder_ = std::make_unique<CommandRecorder>(
+      device_, commandPool_, queue_, resourcePool_.get());
 }
 
 VContext::~VContext() {
@@ -53,6 +57,12 @@ VContext::~VContext() {
     }
   }
 
+  // The recorded commands may use pooled resources, they have to complete
+  // before the pool destroys them. Both need a valid VkDevice for destructing.
+  commandRecorder_->flush();
+  commandRecorder_.reset();
+  resourcePool_.reset();
+
   // ComputeUnitFactory_ owns ComputeUnits and VkPipelineCache, need valid
   // VkDevice for destructing, destructing before vkDestroyDevice
   computeUnitFactory_.reset();
@@ -230,7 +240,9 @@ void VContext::createDevice() {
 
   VkCommandPoolCreateInfo commandPoolCreateInfo{};
   commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-  commandPoolCreateInfo.flags = 0;
+  // The command buffer of the CommandRecorder is recorded again after every
+  // submission.
+  commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
   commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex_;
   VK_CHECK(vkCreateCommandPool(
       device_, &commandPoolCreateInfo, nullptr, &commandPool_));
@@ -308,7 +320,17 @@ VBuffer::VBuffer(
     const VkDeviceSize bufferSizeBytes,
     const VkBufferUsageFlags bufferUsageFlags,
     const VkDescriptorType descriptorType)
-    : bufferSizeBytes_(bufferSizeBytes), descriptorType_(descriptorType) {
+    : bufferSizeBytes_(bufferSizeBytes),
+      bufferUsageFlags_(bufferUsageFlags),
+      descriptorType_(descriptorType) {
+  ResourcePool::Buffer pooled{};
+  if (context().resourcePool().acquireBuffer(
+          bufferSizeBytes_, bufferUsageFlags_, &pooled)) {
+    buffer_ = pooled.buffer;
+    bufferMemory_ = pooled.memory;
+    return;
+  }
+
   const auto device = context().device();
   const auto physicalDevice = context().physicalDevice();
   VkBufferCreateInfo bufferCreateInfo{};
@@ -331,9 +353,42 @@ VBuffer::VBuffer(
   VK_CHECK(vkBindBufferMemory(device, buffer_, bufferMemory_, 0));
 }
 
+VBuffer::VBuffer(VBuffer&& other) noexcept
+    : bufferSizeBytes_(other.bufferSizeBytes_),
+      bufferUsageFlags_(other.bufferUsageFlags_),
+      descriptorType_(other.descriptorType_),
+      buffer_(other.buffer_),
+      bufferMemory_(other.bufferMemory_) {
+  other.buffer_ = VK_NULL_HANDLE;
+  other.bufferMemory_ = VK_NULL_HANDLE;
+}
+
+VBuffer& VBuffer::operator=(VBuffer&& other) noexcept {
+  if (this != &other) {
+    release();
+    bufferSizeBytes_ = other.bufferSizeBytes_;
+    bufferUsageFlags_ = other.bufferUsageFlags_;
+    descriptorType_ = other.descriptorType_;
+    buffer_ = other.buffer_;
+    bufferMemory_ = other.bufferMemory_;
+    other.buffer_ = VK_NULL_HANDLE;
+    other.bufferMemory_ = VK_NULL_HANDLE;
+  }
+  return *this;
+}
+
 VBuffer::~VBuffer() {
-  vkFreeMemory(context().device(), bufferMemory_, nullptr);
-  vkDestroyBuffer(context().device(), buffer_, nullptr);
+  release();
+}
+
+void VBuffer::release() {
+  if (buffer_ == VK_NULL_HANDLE) {
+    return;
+  }
+  context().resourcePool().releaseBuffer(
+      bufferSizeBytes_, bufferUsageFlags_, {buffer_, bufferMemory_});
+  buffer_ = VK_NULL_HANDLE;
+  bufferMemory_ = VK_NULL_HANDLE;
 }
 
 void VBuffer::copy_from_device_to_host(
@@ -423,6 +478,19 @@ void VBuffer::addBufferMemoryBarrier(
 
 VImage::VImage(const ImageSize imageSize, const ImageSize dataSize)
     : imageSize_(imageSize), dataSize_(dataSize) {
+  // A pooled image keeps its last layout, which is not known here anymore.
+  // Its contents are overwritten anyway, so it starts out from the undefined
+  // layout, like a new one.
+  imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
+  ResourcePool::Image pooled{};
+  if (context().resourcePool().acquireImage(imageSize_, &pooled)) {
+    image_ = pooled.image;
+    imageMemory_ = pooled.memory;
+    imageView_ = pooled.imageView;
+    sampler_ = pooled.sampler;
+    return;
+  }
+
   const auto device = context().device();
   const auto physicalDevice = context().physicalDevice();
 
@@ -443,7 +511,6 @@ VImage::VImage(const ImageSize imageSize, const ImageSize dataSize)
   imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
   imageInfo.pNext = nullptr;
   imageInfo.flags = 0;
-  imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
 
   VK_CHECK(vkCreateImage(device, &imageInfo, nullptr, &image_));
 
@@ -468,11 +535,43 @@ VImage::VImage(const ImageSize imageSize, const ImageSize dataSize)
   VK_CHECK(vkCreateSampler(device, &samplerCreateInfo, nullptr, &sampler_));
 }
 
+VImage::VImage(VImage&& other) noexcept
+    : imageSize_(other.imageSize_),
+      dataSize_(other.dataSize_),
+      image_(other.image_),
+      imageMemory_(other.imageMemory_),
+      imageView_(other.imageView_),
+      sampler_(other.sampler_),
+      imageLayout_(other.imageLayout_) {
+  other.image_ = VK_NULL_HANDLE;
+}
+
+VImage& VImage::operator=(VImage&& other) noexcept {
+  if (this != &other) {
+    release();
+    imageSize_ = other.imageSize_;
+    dataSize_ = other.dataSize_;
+    image_ = other.image_;
+    imageMemory_ = other.imageMemory_;
+    imageView_ = other.imageView_;
+    sampler_ = other.sampler_;
+    imageLayout_ = other.imageLayout_;
+    other.image_ = VK_NULL_HANDLE;
+  }
+  return *this;
+}
+
 VImage::~VImage() {
-  vkFreeMemory(context().device(), imageMemory_, nullptr);
-  vkDestroySampler(context().device(), sampler_, nullptr);
-  vkDestroyImageView(context().device(), imageView_, nullptr);
-  vkDestroyImage(context().device(), image_, nullptr);
+  release();
+}
+
+void VImage::release() {
+  if (image_ == VK_NULL_HANDLE) {
+    return;
+  }
+  context().resourcePool().releaseImage(
+      imageSize_, {image_, imageMemory_, imageView_, sampler_});
+  image_ = VK_NULL_HANDLE;
 }
 
 VkImageViewCreateInfo VImage::makeImageViewCreateInfo() const {
@@ -689,37 +788,12 @@ void allocateDescriptorSet(
   VK_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, descriptorSet));
 }
 
-void createDescriptorSetLayoutSinglePool(
-    const VkDevice device,
+void acquireDescriptorSet(
     const std::vector<VkDescriptorType>& descrTypes,
     VkDescriptorSetLayout* const descrSetLayout,
-    VkDescriptorPool* const descrPool,
     VkDescriptorSet* const descrSet) {
-  const auto size = descrTypes.size();
-  std::vector<VkDescriptorSetLayoutBinding> bindings;
-  std::vector<VkDescriptorPoolSize> poolSizes;
-  uint32_t i = 0;
-  for (const auto& descrType : descrTypes) {
-    bindings.push_back(descriptorSetLayoutBinding(i, descrType));
-    poolSizes.push_back(VkDescriptorPoolSize{descrType, 1});
-    i++;
-  }
-  createDescriptorSetLayout(device, bindings.data(), size, descrSetLayout);
-  createDescriptorPool(
-      device, poolSizes.data(), size, 1 /* maxSets */, descrPool);
-  allocateDescriptorSet(device, *descrPool, descrSetLayout, descrSet);
-}
-
-void allocateCommandBuffer(VkDevice device, VkCommandBuffer* commandBuffer) {
-  VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
-  commandBufferAllocateInfo.sType =
-      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  commandBufferAllocateInfo.commandPool = context().commandPool();
-  commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  commandBufferAllocateInfo.commandBufferCount = 1;
-
-  VK_CHECK(vkAllocateCommandBuffers(
-      device, &commandBufferAllocateInfo, commandBuffer));
+  context().resourcePool().acquireDescriptorSet(
+      descrTypes, descrSetLayout, descrSet);
 }
 
 void beginCommandBuffer(VkCommandBuffer commandBuffer) {
@@ -733,25 +807,282 @@ void endCommandBuffer(VkCommandBuffer commandBuffer) {
   VK_CHECK(vkEndCommandBuffer(commandBuffer));
 }
 
-void submitAndWaitCommandBuffer(
-    VkDevice device,
-    VkQueue queue,
-    VkCommandBuffer commandBuffer) {
-  VkSubmitInfo submitInfo{};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffer;
+// CommandRecorder
+
+CommandRecorder::CommandRecorder(
+    const VkDevice device,
+    const VkCommandPool commandPool,
+    const VkQueue queue,
+    ResourcePool* const resourcePool)
+    : device_(device),
+      commandPool_(commandPool),
+      queue_(queue),
+      resourcePool_(resourcePool),
+      recording_(false) {
+  VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+  commandBufferAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  commandBufferAllocateInfo.commandPool = commandPool_;
+  commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  commandBufferAllocateInfo.commandBufferCount = 1;
+  VK_CHECK(vkAllocateCommandBuffers(
+      device_, &commandBufferAllocateInfo, &commandBuffer_));
 
-  VkFence fence;
   VkFenceCreateInfo fenceCreateInfo{};
   fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
   fenceCreateInfo.flags = 0;
-  VK_CHECK(vkCreateFence(device, &fenceCreateInfo, NULL, &fence))
+  VK_CHECK(vkCreateFence(device_, &fenceCreateInfo, nullptr, &fence_));
+}
+
+CommandRecorder::~CommandRecorder() {
+  vkDestroyFence(device_, fence_, nullptr);
+  vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer_);
+}
 
-  VK_CHECK(vkQueueSubmit(queue, 1, &submitInfo, fence));
-  vkWaitForFences(device, 1, &fence, VK_TRUE, ComputeUnit::kFenceTimeoutNanos);
+VkCommandBuffer CommandRecorder::commandBuffer() {
+  if (!recording_) {
+    beginCommandBuffer(commandBuffer_);
+    recording_ = true;
+  }
+  return commandBuffer_;
+}
+
+void CommandRecorder::addMemoryBarrier() {
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.pNext = nullptr;
+  barrier.srcAccessMask =
+      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT |
+      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+      VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(
+      commandBuffer(),
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+      0,
+      1,
+      &barrier,
+      0,
+      nullptr,
+      0,
+      nullptr);
+}
 
-  vkDestroyFence(device, fence, NULL);
+void CommandRecorder::flush() {
+  if (recording_) {
+    // The host maps the buffers the commands wrote to read them.
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.pNext = nullptr;
+    barrier.srcAccessMask =
+        VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer_,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr);
+    recording_ = false;
+    endCommandBuffer(commandBuffer_);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer_;
+    VK_CHECK(vkQueueSubmit(queue_, 1, &submitInfo, fence_));
+    VK_CHECK(vkWaitForFences(
+        device_, 1, &fence_, VK_TRUE, ComputeUnit::kFenceTimeoutNanos));
+    VK_CHECK(vkResetFences(device_, 1, &fence_));
+  }
+  resourcePool_->recycle();
+}
+
+// ResourcePool
+
+ResourcePool::ResourcePool(const VkDevice device)
+    : device_(device), descrPoolIndex_(0) {}
+
+ResourcePool::~ResourcePool() {
+  recycle();
+  for (const auto& entry : buffers_) {
+    for (const Buffer& buffer : entry.second) {
+      vkFreeMemory(device_, buffer.memory, nullptr);
+      vkDestroyBuffer(device_, buffer.buffer, nullptr);
+    }
+  }
+  for (const auto& entry : images_) {
+    for (const Image& image : entry.second) {
+      vkFreeMemory(device_, image.memory, nullptr);
+      vkDestroySampler(device_, image.sampler, nullptr);
+      vkDestroyImageView(device_, image.imageView, nullptr);
+      vkDestroyImage(device_, image.image, nullptr);
+    }
+  }
+  for (const DescriptorPool& descrPool : descrPools_) {
+    vkDestroyDescriptorPool(device_, descrPool.pool, nullptr);
+  }
+  for (const auto& entry : descrSetLayouts_) {
+    vkDestroyDescriptorSetLayout(device_, entry.second, nullptr);
+  }
+}
+
+bool ResourcePool::acquireBuffer(
+    const VkDeviceSize sizeBytes,
+    const VkBufferUsageFlags usageFlags,
+    Buffer* const buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = buffers_.find({sizeBytes, usageFlags});
+  if (it == buffers_.end() || it->second.empty()) {
+    return false;
+  }
+  *buffer = it->second.back();
+  it->second.pop_back();
+  return true;
+}
+
+void ResourcePool::releaseBuffer(
+    const VkDeviceSize sizeBytes,
+    const VkBufferUsageFlags usageFlags,
+    const Buffer buffer) {
+  const bool pending = context().commandRecorder().hasPendingCommands();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending) {
+    releasedBuffers_.emplace_back(BufferKey{sizeBytes, usageFlags}, buffer);
+  } else {
+    buffers_[{sizeBytes, usageFlags}].push_back(buffer);
+  }
+}
+
+bool ResourcePool::acquireImage(const ImageSize imageSize, Image* const image) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = images_.find(imageSize);
+  if (it == images_.end() || it->second.empty()) {
+    return false;
+  }
+  *image = it->second.back();
+  it->second.pop_back();
+  return true;
+}
+
+void ResourcePool::releaseImage(const ImageSize imageSize, const Image image) {
+  const bool pending = context().commandRecorder().hasPendingCommands();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending) {
+    releasedImages_.emplace_back(imageSize, image);
+  } else {
+    images_[imageSize].push_back(image);
+  }
+}
+
+void ResourcePool::acquireDescriptorSet(
+    const std::vector<VkDescriptorType>& descrTypes,
+    VkDescriptorSetLayout* const descrSetLayout,
+    VkDescriptorSet* const descrSet) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto& layout = descrSetLayouts_[descrTypes];
+  if (layout == VK_NULL_HANDLE) {
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    uint32_t i = 0;
+    for (const auto& descrType : descrTypes) {
+      bindings.push_back(descriptorSetLayoutBinding(i, descrType));
+      i++;
+    }
+    createDescriptorSetLayout(
+        device_, bindings.data(), bindings.size(), &layout);
+  }
+  *descrSetLayout = layout;
+
+  std::map<VkDescriptorType, uint32_t> descrCounts;
+  for (const auto& descrType : descrTypes) {
+    descrCounts[descrType]++;
+  }
+  const auto fits = [&descrCounts](const DescriptorPool& descrPool) {
+    if (descrPool.setsLeft == 0) {
+      return false;
+    }
+    for (const auto& entry : descrCounts) {
+      const auto it = descrPool.descriptorsLeft.find(entry.first);
+      if (it == descrPool.descriptorsLeft.end() || it->second < entry.second) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Pools filled up are skipped until recycle() resets them all.
+  while (descrPoolIndex_ < descrPools_.size() &&
+         !fits(descrPools_[descrPoolIndex_])) {
+    descrPoolIndex_++;
+  }
+  if (descrPoolIndex_ == descrPools_.size()) {
+    // Room for the descriptors of the operators, and for those of this set
+    // if it has more of a type, or of another type.
+    std::map<VkDescriptorType, uint32_t> capacity{
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0u},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0u},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0u},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0u},
+    };
+    for (const auto& entry : descrCounts) {
+      capacity[entry.first] = entry.second;
+    }
+    DescriptorPool descrPool{};
+    for (auto& entry : capacity) {
+      entry.second =
+          std::max(kDescriptorSetsPerPool * kDescriptorsPerSet, entry.second);
+      descrPool.sizes.push_back(VkDescriptorPoolSize{entry.first, entry.second});
+    }
+    createDescriptorPool(
+        device_,
+        descrPool.sizes.data(),
+        descrPool.sizes.size(),
+        kDescriptorSetsPerPool,
+        &descrPool.pool);
+    descrPool.reset();
+    descrPools_.push_back(std::move(descrPool));
+  }
+
+  DescriptorPool& descrPool = descrPools_[descrPoolIndex_];
+  allocateDescriptorSet(device_, descrPool.pool, &layout, descrSet);
+  descrPool.setsLeft--;
+  for (const auto& entry : descrCounts) {
+    descrPool.descriptorsLeft[entry.first] -= entry.second;
+  }
+}
+
+void ResourcePool::recycle() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : releasedBuffers_) {
+    buffers_[entry.first].push_back(entry.second);
+  }
+  releasedBuffers_.clear();
+  for (const auto& entry : releasedImages_) {
+    images_[entry.first].push_back(entry.second);
+  }
+  releasedImages_.clear();
+
+  for (DescriptorPool& descrPool : descrPools_) {
+    if (descrPool.setsLeft != kDescriptorSetsPerPool) {
+      VK_CHECK(vkResetDescriptorPool(device_, descrPool.pool, 0));
+      descrPool.reset();
+    }
+  }
+  descrPoolIndex_ = 0;
+}
+
+void ResourcePool::DescriptorPool::reset() {
+  setsLeft = kDescriptorSetsPerPool;
+  for (const auto& size : sizes) {
+    descriptorsLeft[size.type] = size.descriptorCount;
+  }
 }
 
 ComputeUnit::~ComputeUnit() {
@@ -863,21 +1194,7 @@ void ComputeUnit::createComputePipelineCompile(
 #endif
 
 void ComputeUnit::createCommandBuffer(VkDescriptorSet& descriptorSet) {
-  const auto device = context().device();
-  VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
-  commandBufferAllocateInfo.sType =
-      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  commandBufferAllocateInfo.commandPool = context().commandPool();
-  commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  commandBufferAllocateInfo.commandBufferCount = 1;
-
-  VK_CHECK(vkAllocateCommandBuffers(
-      device, &commandBufferAllocateInfo, &commandBuffer_));
-
-  VkCommandBufferBeginInfo beginInfo{};
-  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  VK_CHECK(vkBeginCommandBuffer(commandBuffer_, &beginInfo));
+  commandBuffer_ = context().commandRecorder().commandBuffer();
 
   vkCmdBindPipeline(commandBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
   vkCmdBindDescriptorSets(
@@ -922,7 +1239,7 @@ void ComputeUnit::dispatchCommandBuffer(
 }
 
 void ComputeUnit::endCommandBuffer() {
-  at::native::vulkan::detail::endCommandBuffer(commandBuffer_);
+  context().commandRecorder().addMemoryBarrier();
 }
 
 void ComputeUnit::dispatchCommandBuffer(
@@ -936,24 +1253,6 @@ void ComputeUnit::dispatchCommandBuffer(
       UP_DIV(gridZ, workGroupSize.z));
 }
 
-void ComputeUnit::submitAndWaitCommandBuffer() {
-  VkSubmitInfo submitInfo{};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffer_;
-
-  VkFence fence{};
-  VkFenceCreateInfo fenceCreateInfo{};
-  fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-  fenceCreateInfo.flags = 0;
-  VK_CHECK(vkCreateFence(context().device(), &fenceCreateInfo, NULL, &fence))
-
-  VK_CHECK(vkQueueSubmit(context().queue(), 1, &submitInfo, fence));
-  vkWaitForFences(context().device(), 1, &fence, VK_TRUE, kFenceTimeoutNanos);
-
-  vkDestroyFence(context().device(), fence, NULL);
-}
-
 VBuffer makeUniformConstBuffer(const void* const ptr, const VkDeviceSize size) {
   VBuffer constBuffer = VBuffer::makeUniformBuffer(size);
   constBuffer.copy_from_host_to_device(ptr, size);
@@ -1035,8 +1334,6 @@ ComputeUnit& ComputeUnitFactory::get(
 
 // VBuffer <-> VImage
 void copy_buffer_to_image(const VBuffer& buffer, VImage& image) {
-  const auto device = context().device();
-  const auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t w;
     int32_t h;
@@ -1045,22 +1342,13 @@ void copy_buffer_to_image(const VBuffer& buffer, VImage& image) {
   VBuffer constBuffer = makeUniformConstBuffer(&constBlock, sizeof(constBlock));
 
   VkDescriptorSetLayout descrSetLayout{};
-  VkDescriptorSetLayoutBinding bindings[] = {
-      descriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE),
-      descriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
-      descriptorSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)};
-  createDescriptorSetLayout(
-      device, bindings, 3 /* bindingsCount */, &descrSetLayout);
-
-  VkDescriptorPool descrPool{};
-  VkDescriptorPoolSize poolSizes[] = {{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
-                                      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
-                                      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}};
-  createDescriptorPool(
-      device, poolSizes, 3 /* poolSizeCount */, 1 /* maxSets */, &descrPool);
-
   VkDescriptorSet descrSet{};
-  allocateDescriptorSet(device, descrPool, &descrSetLayout, &descrSet);
+  acquireDescriptorSet(
+      {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER},
+      &descrSetLayout,
+      &descrSet);
 
   image.bindStorageImage(descrSet, 0);
   buffer.bind(descrSet, 1);
@@ -1082,18 +1370,12 @@ void copy_buffer_to_image(const VBuffer& buffer, VImage& image) {
   computeUnit.dispatchCommandBuffer(
       image.w(), image.h(), image.d(), workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descrPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descrSetLayout, nullptr);
 }
 
 void copy_image_to_buffer(
     const VImage& image,
     VBuffer& buffer,
     bool addBufferMemoryBarrierForHost) {
-  const auto device = context().device();
-  const auto physicalDevice = context().physicalDevice();
   TORCH_INTERNAL_ASSERT(
       buffer.sizeBytes() >= image.capacityBytes(),
       "VulkanBuffer's capacity is less than VulkanImage capacity to copy from");
@@ -1105,23 +1387,13 @@ void copy_image_to_buffer(
   VBuffer constBuffer = makeUniformConstBuffer(&constBlock, sizeof(constBlock));
 
   VkDescriptorSetLayout descrSetLayout{};
-  const VkDescriptorSetLayoutBinding bindings[] = {
-      descriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER),
-      descriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
-      descriptorSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)};
-  createDescriptorSetLayout(
-      device, bindings, 3 /* bindingsCount */, &descrSetLayout);
-
-  VkDescriptorPool descrPool{};
-  const VkDescriptorPoolSize poolSizes[] = {
-      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
-      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
-      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}};
-  createDescriptorPool(
-      device, poolSizes, 3 /* poolSizeCount */, 1 /* maxSets */, &descrPool);
-
   VkDescriptorSet descrSet{};
-  allocateDescriptorSet(device, descrPool, &descrSetLayout, &descrSet);
+  acquireDescriptorSet(
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER},
+      &descrSetLayout,
+      &descrSet);
 
   image.bindShaderRead(descrSet, 0);
   buffer.bind(descrSet, 1);
@@ -1144,10 +1416,6 @@ void copy_image_to_buffer(
         VK_ACCESS_HOST_READ_BIT);
   }
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descrPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descrSetLayout, nullptr);
 } // VBuffer <-> VImage
 
 void copy_buffer_to_buffer(
@@ -1156,10 +1424,8 @@ void copy_buffer_to_buffer(
     VkDeviceSize size,
     VkDeviceSize srcOffset,
     VkDeviceSize dstOffset) {
-  auto device = context().device();
-  VkCommandBuffer commandBuffer{};
-  allocateCommandBuffer(device, &commandBuffer);
-  beginCommandBuffer(commandBuffer);
+  auto& commandRecorder = context().commandRecorder();
+  const VkCommandBuffer commandBuffer = commandRecorder.commandBuffer();
 
   VkBufferCopy copyRegion{};
   copyRegion.srcOffset = srcOffset;
@@ -1172,8 +1438,7 @@ void copy_buffer_to_buffer(
       1,
       &copyRegion);
 
-  endCommandBuffer(commandBuffer);
-  submitAndWaitCommandBuffer(device, context().queue(), commandBuffer);
+  commandRecorder.addMemoryBarrier();
 }
 
 // VulkanTensor
@@ -1312,12 +1577,17 @@ class VulkanTensor::Impl final {
   }
 
   void set_data_from_host(const float* const inputData) {
+    // Recorded commands may still access the existing buffer.
+    if (has_buffer()) {
+      context().commandRecorder().flush();
+    }
     buffer()->copy_from_host_to_device(
         (const void*)inputData, sizeof(float) * numel_);
   }
 
   void copy_data_to_host(float* const outputData) const {
     sync_image_to_buffer();
+    context().commandRecorder().flush();
     buffer()->copy_from_device_to_host(outputData, sizeof(float) * numel_);
   }
 
@@ -3,7 +3,9 @@
 #include <c10/util/Optional.h>
 #include <array>
 #include <cstring>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #ifdef USE_VULKAN_WRAPPER
@@ -146,6 +148,127 @@ class VulkanTensor final {
   std::shared_ptr<Impl> impl_;
 };
 
+// Records the commands of consecutive operators into one command buffer,
+// which is only submitted when the host needs the results: when a tensor is
+// copied back to the CPU, or when the data of a tensor the recorded commands
+// may use is overwritten from the host. Operators get the command buffer with
+// ComputeUnit::createCommandBuffer(), every operator ends with a memory
+// barrier, so that the next one sees its results.
+class ResourcePool;
+class CommandRecorder final {
+ public:
+  CommandRecorder(
+      VkDevice device,
+      VkCommandPool commandPool,
+      VkQueue queue,
+      ResourcePool* resourcePool);
+  ~CommandRecorder();
+  CommandRecorder(const CommandRecorder&) = delete;
+  CommandRecorder& operator=(const CommandRecorder&) = delete;
+
+  // Returns the command buffer commands are recorded into, begins recording
+  // if nothing is recorded yet.
+  VkCommandBuffer commandBuffer();
+
+  inline bool hasPendingCommands() const {
+    return recording_;
+  }
+
+  // Makes the writes of the commands recorded so far visible to the
+  // commands recorded next.
+  void addMemoryBarrier();
+
+  // Submits the recorded commands, waits for them to complete, and recycles
+  // the resources that were released in the meantime.
+  void flush();
+
+ private:
+  VkDevice device_;
+  VkCommandPool commandPool_;
+  VkQueue queue_;
+  ResourcePool* resourcePool_;
+  VkCommandBuffer commandBuffer_;
+  VkFence fence_;
+  bool recording_;
+};
+
+// Pools the Vulkan objects operators would otherwise create and destroy on
+// every run: the device memory of VBuffers and VImages, kept by size, and the
+// descriptor set layouts and descriptor sets of the compute units. Once a
+// model ran, running it again allocates nothing.
+//
+// Resources released while the CommandRecorder has commands to submit may
+// still be used by them, they are only reused after CommandRecorder::flush().
+class ResourcePool final {
+ public:
+  struct Buffer final {
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+  };
+
+  struct Image final {
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView imageView;
+    VkSampler sampler;
+  };
+
+  explicit ResourcePool(VkDevice device);
+  ~ResourcePool();
+  ResourcePool(const ResourcePool&) = delete;
+  ResourcePool& operator=(const ResourcePool&) = delete;
+
+  // Returns false if there is no free buffer or image of that size.
+  bool acquireBuffer(
+      VkDeviceSize sizeBytes,
+      VkBufferUsageFlags usageFlags,
+      Buffer* buffer);
+  void releaseBuffer(
+      VkDeviceSize sizeBytes,
+      VkBufferUsageFlags usageFlags,
+      Buffer buffer);
+  bool acquireImage(ImageSize imageSize, Image* image);
+  void releaseImage(ImageSize imageSize, Image image);
+
+  // Returns the layout of the descriptor sets with one binding of each of
+  // `descrTypes`, and a descriptor set with that layout. The layout lives as
+  // long as the pool, the set until the next CommandRecorder::flush().
+  void acquireDescriptorSet(
+      const std::vector<VkDescriptorType>& descrTypes,
+      VkDescriptorSetLayout* descrSetLayout,
+      VkDescriptorSet* descrSet);
+
+  // Called once the commands that may use released resources completed.
+  void recycle();
+
+ private:
+  using BufferKey = std::pair<VkDeviceSize, VkBufferUsageFlags>;
+
+  struct DescriptorPool final {
+    VkDescriptorPool pool;
+    std::vector<VkDescriptorPoolSize> sizes;
+    uint32_t setsLeft;
+    std::map<VkDescriptorType, uint32_t> descriptorsLeft;
+
+    // Marks all the sets and descriptors of the pool as free.
+    void reset();
+  };
+
+  static constexpr uint32_t kDescriptorSetsPerPool = 256u;
+  static constexpr uint32_t kDescriptorsPerSet = 4u;
+
+  VkDevice device_;
+  std::mutex mutex_;
+  std::map<BufferKey, std::vector<Buffer>> buffers_;
+  std::map<ImageSize, std::vector<Image>> images_;
+  std::vector<std::pair<BufferKey, Buffer>> releasedBuffers_;
+  std::vector<std::pair<ImageSize, Image>> releasedImages_;
+  std::map<std::vector<VkDescriptorType>, VkDescriptorSetLayout>
+      descrSetLayouts_;
+  std::vector<DescriptorPool> descrPools_;
+  size_t descrPoolIndex_;
+};
+
 class ComputeUnitFactory;
 class VContext final {
  public:
@@ -174,6 +297,12 @@ class VContext final {
   ComputeUnitFactory& computeUnitFactory() const {
     return *(computeUnitFactory_.get());
   }
+  CommandRecorder& commandRecorder() const {
+    return *(commandRecorder_.get());
+  }
+  ResourcePool& resourcePool() const {
+    return *(resourcePool_.get());
+  }
 
  private:
   void createInstance();
@@ -192,6 +321,8 @@ class VContext final {
   bool enableValidationLayers_;
   VkCommandPool commandPool_;
   std::unique_ptr<ComputeUnitFactory> computeUnitFactory_;
+  std::unique_ptr<CommandRecorder> commandRecorder_;
+  std::unique_ptr<ResourcePool> resourcePool_;
 };
 
 class VBuffer final {
@@ -243,8 +374,9 @@ class VBuffer final {
 
   VBuffer(const VBuffer&) = delete;
   VBuffer& operator=(const VBuffer&) = delete;
-  VBuffer(VBuffer&&) = default;
-  VBuffer& operator=(VBuffer&&) = default;
+  // The moved from buffer does not release the memory to the pool.
+  VBuffer(VBuffer&& other) noexcept;
+  VBuffer& operator=(VBuffer&& other) noexcept;
 
   static inline VBuffer makeUniformBuffer(const VkDeviceSize bufferSize) {
     return VBuffer{bufferSize,
@@ -282,7 +414,10 @@ class VBuffer final {
   }
 
  private:
+  void release();
+
   VkDeviceSize bufferSizeBytes_;
+  VkBufferUsageFlags bufferUsageFlags_;
   VkDescriptorType descriptorType_;
   VkBuffer buffer_;
   VkDeviceMemory bufferMemory_;
@@ -305,8 +440,9 @@ class VImage final {
   ~VImage();
   VImage(const VImage&) = delete;
   VImage& operator=(const VImage&) = delete;
-  VImage(VImage&&) = default;
-  VImage& operator=(VImage&&) = default;
+  // The moved from image does not release the memory to the pool.
+  VImage(VImage&& other) noexcept;
+  VImage& operator=(VImage&& other) noexcept;
 
   inline auto w() const {
     return imageSize_[0];
@@ -354,6 +490,8 @@ class VImage final {
   void addImageMemoryBarrierToShaderRead(VkCommandBuffer commandBuffer) const;
 
  private:
+  void release();
+
   ImageSize imageSize_;
   ImageSize dataSize_;
   VkImage image_;
@@ -396,17 +534,14 @@ void allocateDescriptorSet(
     const VkDescriptorSetLayout* descriptorSetLayout,
     VkDescriptorSet* descriptorSet);
 
-void createDescriptorSetLayoutSinglePool(
-    VkDevice device,
+// See ResourcePool::acquireDescriptorSet().
+void acquireDescriptorSet(
     const std::vector<VkDescriptorType>& descrTypes,
     VkDescriptorSetLayout* descrSetLayout,
-    VkDescriptorPool* descrPool,
     VkDescriptorSet* descrSet);
 
-void allocateCommandBuffer(VkDevice device, VkCommandBuffer* commandBuffer);
 void beginCommandBuffer(VkCommandBuffer commandBuffer);
 void endCommandBuffer(VkCommandBuffer commandBuffer);
-void submitAndWaitCommandBuffer(VkDevice device, VkCommandBuffer commandBuffer);
 
 struct WorkGroupSize {
   uint32_t x;
@@ -460,6 +595,8 @@ class ComputeUnit final {
       WorkGroupSize workGroupSize);
 #endif
 
+  // Binds the pipeline and the descriptor set in the command buffer of the
+  // CommandRecorder, which commandBuffer() returns afterwards.
   void createCommandBuffer(VkDescriptorSet& descriptorSet);
   void addMemoryBarrier(
       VkPipelineStageFlags srcStageMask,
@@ -475,7 +612,8 @@ class ComputeUnit final {
       uint32_t gridY,
       uint32_t gridZ,
       WorkGroupSize workGroupSize);
-  void submitAndWaitCommandBuffer();
+  // Ends the commands of the compute unit with a memory barrier, they execute
+  // with the next CommandRecorder::flush().
   void endCommandBuffer();
   inline VkCommandBuffer commandBuffer() {
     return commandBuffer_;
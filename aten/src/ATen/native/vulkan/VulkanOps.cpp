@@ -26,7 +26,6 @@ void upsample_nearest2d(
     int64_t IC,
     float scaleH,
     float scaleW) {
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   int64_t C = IN * IC;
   struct ConstBlock {
@@ -46,18 +45,12 @@ void upsample_nearest2d(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -70,9 +63,6 @@ void upsample_nearest2d(
   input.image()->addImageMemoryBarrierToShaderRead(computeUnit.commandBuffer());
   computeUnit.dispatchCommandBuffer(OW, OH, C, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 VulkanTensor reshape_copy(
@@ -116,7 +106,6 @@ void adaptive_avg_pool2d(
     const int64_t OW,
     const int64_t IN,
     const int64_t IC) {
-  auto device = context().device();
   int64_t C = IN * IC;
   struct ConstBlock {
     int32_t IW;
@@ -131,18 +120,12 @@ void adaptive_avg_pool2d(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -155,9 +138,6 @@ void adaptive_avg_pool2d(
   input.image()->addImageMemoryBarrierToShaderRead(computeUnit.commandBuffer());
   computeUnit.dispatchCommandBuffer(OW, OH, C, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void max_pool2d(
@@ -177,7 +157,6 @@ void max_pool2d(
     const int padW,
     const int dilationH,
     const int dilationW) {
-  auto device = context().device();
   const auto c = _n * _c;
   struct ConstBlock {
     int32_t inputSize[4];
@@ -198,18 +177,12 @@ void max_pool2d(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -222,9 +195,6 @@ void max_pool2d(
   input.image()->addImageMemoryBarrierToShaderRead(computeUnit.commandBuffer());
   computeUnit.dispatchCommandBuffer(oW, oH, c, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void add(
@@ -261,7 +231,6 @@ void add(
   auto H = os4[2];
   auto W = os4[3];
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t W;
@@ -276,19 +245,13 @@ void add(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input0.image()->bindShaderRead(descriptorSet, 1);
@@ -305,9 +268,6 @@ void add(
   input1.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(W, H, C, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 VBuffer kernelNCHW_OCHW_repack_O4C4HWi4o4(
@@ -417,7 +377,6 @@ void conv2d_depthwise(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
@@ -425,13 +384,7 @@ void conv2d_depthwise(
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  auto device = context().device();
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -450,10 +403,6 @@ void conv2d_depthwise(
   computeUnit.dispatchCommandBuffer(
       params.OW, params.OH, params.OC_4, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void conv2d_depthwise(
@@ -537,18 +486,12 @@ void conv2d_prepack_weights_to_image(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      context().device(),
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   image.bindStorageImage(descriptorSet, 0);
   kernelBuffer.bind(descriptorSet, 1);
@@ -569,10 +512,6 @@ void conv2d_prepack_weights_to_image(
       VK_ACCESS_SHADER_READ_BIT);
   computeUnit.dispatchCommandBuffer(C_4, OC_4, KH * KW, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(context().device(), descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(
-      context().device(), descriptorSetLayout, nullptr);
 }
 
 VImage conv2d_prepack_weights_image(
@@ -647,9 +586,7 @@ void conv2d(
       outputMax};
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
-  auto device = context().device();
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
@@ -657,12 +594,7 @@ void conv2d(
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -683,10 +615,6 @@ void conv2d(
       UP_DIV(params.OH, workGroupSize.y),
       UP_DIV(params.OC_4, workGroupSize.z));
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void conv2d(
@@ -814,7 +742,6 @@ void clamp(
   auto W = sizes[3];
   auto C_4 = UP_DIV(C, 4);
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t W;
@@ -833,18 +760,12 @@ void clamp(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -859,9 +780,6 @@ void clamp(
   input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(W, H, C, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void addmm(
@@ -894,7 +812,6 @@ void addmm(
   const auto C_4 = UP_DIV(C, 4);
   const auto K = m1W;
 
-  auto device = context().device();
 
   struct ConstBlock {
     int32_t OW;
@@ -915,7 +832,6 @@ void addmm(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{};
   if (hasT) {
@@ -935,12 +851,7 @@ void addmm(
     };
   }
 
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   m1.image()->bindShaderRead(descriptorSet, 1);
@@ -962,7 +873,6 @@ void addmm(
     (*t).image()->addImageMemoryBarrierToShaderRead(commandBuffer);
     computeUnit.dispatchCommandBuffer(OW, OH, C_4, workGroupSize);
     computeUnit.endCommandBuffer();
-    computeUnit.submitAndWaitCommandBuffer();
   } else {
     auto& computeUnit = context().computeUnitFactory().get(
         GLSL_SPV(mm), descriptorSetLayout, workGroupSize);
@@ -973,10 +883,7 @@ void addmm(
     m2.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
     computeUnit.dispatchCommandBuffer(OW, OH, C_4, workGroupSize);
     computeUnit.endCommandBuffer();
-    computeUnit.submitAndWaitCommandBuffer();
   }
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void mean(VulkanTensor& output, const VulkanTensor& input) {
@@ -987,7 +894,6 @@ void mean(VulkanTensor& output, const VulkanTensor& input) {
   int32_t W = safe_downcast<int32_t>(isizes[3]);
   int32_t C_4 = UP_DIV(N * C, 4);
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t W;
@@ -999,18 +905,12 @@ void mean(VulkanTensor& output, const VulkanTensor& input) {
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  acquireDescriptorSet(descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -1025,9 +925,6 @@ void mean(VulkanTensor& output, const VulkanTensor& input) {
   input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(1, 1, C_4, workGroupSize);
   computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 } // namespace detail
@@ -0,0 +1,112 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/utils/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// Supports FP32 hardswish and sigmoid on dense tensors of any shape and
+// memory format.  Both are elementwise, so the tensor is handed to XNNPACK as
+// a batch of numel() single channel elements, in the order it is laid out in
+// memory.
+
+bool use_unary(const Tensor& input) {
+  return xnnpack::internal::available() &&
+      // Input
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.numel() > 0) &&
+      input.is_contiguous(input.suggest_memory_format()) &&
+      !input.requires_grad() &&
+      true;
+}
+
+template <typename Create, typename Setup>
+Tensor run_unary(
+    const Tensor& input,
+    const Create create,
+    const Setup setup,
+    const char* const name) {
+  using namespace internal;
+
+  const auto memory_format = input.suggest_memory_format();
+  const Tensor input_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(input, memory_format);
+
+  Tensor output_padded_contig = mobile::empty_with_tail_padding(
+      input_padded_contig.sizes(),
+      input_padded_contig.options().dtype(),
+      memory_format,
+      input_padded_contig.names());
+
+  xnn_operator_t unary_op{};
+
+  const xnn_status create_status = create(
+      1u,           // channels
+      1u,           // input_stride
+      1u,           // output_stride
+      0u,           // flags
+      &unary_op);   // operator
+
+  Operator unary_scoped_op(unary_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nc_f32 failed!");
+
+  const xnn_status setup_status = setup(
+      unary_op,                                   // operator
+      input_padded_contig.numel(),                // batch_size
+      input_padded_contig.data_ptr<float>(),      // input
+      output_padded_contig.data_ptr<float>(),     // output
+      threadpool());                              // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      unary_op,       // operator
+      threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig;
+}
+
+} // namespace
+
+bool use_hardswish(const Tensor& input) {
+  return use_unary(input);
+}
+
+Tensor hardswish(const Tensor& input) {
+  return run_unary(
+      input,
+      xnn_create_hardswish_nc_f32,
+      xnn_setup_hardswish_nc_f32,
+      "hardswish");
+}
+
+bool use_sigmoid(const Tensor& input) {
+  return use_unary(input);
+}
+
+Tensor sigmoid(const Tensor& input) {
+  return run_unary(
+      input,
+      xnn_create_sigmoid_nc_f32,
+      xnn_setup_sigmoid_nc_f32,
+      "sigmoid");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -0,0 +1,277 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/Pool.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/utils/Factory.h>
+#include <ATen/native/xnnpack/Pooling.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+
+// Supports NHWC and NCHW FP32 average pooling with any
+//  - kernel size
+//  - stride
+// but no padding, ceil mode or divisor override, since XNNPACK leaves the
+// padding out of the average the way count_include_pad=False does, and rounds
+// the output size down.  Without padding count_include_pad does not matter.
+
+bool use_avg_pool2d(
+    const Tensor& input,
+    const IntArrayRef kernel_,
+    const IntArrayRef padding_,
+    IntArrayRef stride_,
+    const bool ceil_mode,
+    const c10::optional<int64_t> divisor_override) {
+  using namespace internal;
+
+  // Make sure we are not dealing with an unorthodox configuration.
+  if (kernel_.empty() || padding_.empty()) {
+    return false;
+  }
+
+  // Stride can be legitimately empty, in which case it is to be defaulted to kernel size.
+  if (stride_.empty()) {
+    stride_ = kernel_;
+  }
+
+  // Normalize the parameters.
+  const internal::pooling::Parameters parameters{
+    kernel_,
+    padding_,
+    stride_,
+    {1, 1},
+  };
+
+  return xnnpack::internal::available() &&
+      // Input
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.size(Layout::Activation4D::channels) > 0) &&
+      !input.requires_grad() &&
+      // Kernel
+      (2 == parameters.kernel.size()) &&
+      (parameters.kernel[Layout::Parameter::height] > 0) &&
+      (parameters.kernel[Layout::Parameter::width] > 0) &&
+      ((parameters.kernel[Layout::Parameter::height] *
+        parameters.kernel[Layout::Parameter::width]) > 1) &&
+      // Padding
+      (0 == parameters.padding[Layout::Parameter::height]) &&
+      (0 == parameters.padding[Layout::Parameter::width]) &&
+      // Stride
+      (parameters.stride[Layout::Parameter::height] > 0) &&
+      (parameters.stride[Layout::Parameter::width] > 0) &&
+      // Ceil Mode
+      !ceil_mode &&
+      // Divisor Override
+      !divisor_override &&
+      // Output
+      (pooling_output_shape(
+        input.size(Layout::Activation4D::height),
+        parameters.kernel[Layout::Parameter::height],
+        parameters.padding[Layout::Parameter::height],
+        parameters.stride[Layout::Parameter::height],
+        parameters.dilation[Layout::Parameter::height],
+        ceil_mode) > 0) &&
+      (pooling_output_shape(
+        input.size(Layout::Activation4D::width),
+        parameters.kernel[Layout::Parameter::width],
+        parameters.padding[Layout::Parameter::width],
+        parameters.stride[Layout::Parameter::width],
+        parameters.dilation[Layout::Parameter::width],
+        ceil_mode) > 0) &&
+      true;
+}
+
+Tensor avg_pool2d(
+    const Tensor& input,
+    const IntArrayRef kernel_,
+    const IntArrayRef padding_,
+    IntArrayRef stride_) {
+  using namespace internal;
+
+  // A call to avg_pool2d must have been gated by a call to use_avg_pool2d, so
+  // the parameters are guaranteed to be valid at this point.  Still, stride
+  // can be empty, and the parameters not normalized.
+
+  if (stride_.empty()) {
+    stride_ = kernel_;
+  }
+
+  const internal::pooling::Parameters parameters{
+    kernel_,
+    padding_,
+    stride_,
+    {1, 1},
+  };
+
+  const Tensor input_padded_contig_nhwc =
+      mobile::allocate_padded_contiguous_if_needed(
+          input,
+          MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = mobile::empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        pooling_output_shape(
+            input_padded_contig_nhwc.size(Layout::Activation4D::height),
+            parameters.kernel[Layout::Parameter::height],
+            parameters.padding[Layout::Parameter::height],
+            parameters.stride[Layout::Parameter::height],
+            parameters.dilation[Layout::Parameter::height],
+            false),
+        pooling_output_shape(
+            input_padded_contig_nhwc.size(Layout::Activation4D::width),
+            parameters.kernel[Layout::Parameter::width],
+            parameters.padding[Layout::Parameter::width],
+            parameters.stride[Layout::Parameter::width],
+            parameters.dilation[Layout::Parameter::width],
+            false),
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t avg_pool_op{};
+
+  const xnn_status create_status = xnn_create_average_pooling2d_nhwc_f32(
+      parameters.padding[Layout::Parameter::height],                  // input_padding_top
+      parameters.padding[Layout::Parameter::width],                   // input_padding_right
+      parameters.padding[Layout::Parameter::height],                  // input_padding_bottom
+      parameters.padding[Layout::Parameter::width],                   // input_padding_left
+      parameters.kernel[Layout::Parameter::height],                   // pooling_height
+      parameters.kernel[Layout::Parameter::width],                    // pooling_width
+      parameters.stride[Layout::Parameter::height],                   // stride_height
+      parameters.stride[Layout::Parameter::width],                    // stride_width
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_pixel_stride - NHWC Contiguous
+      output_padded_contig_nhwc.size(Layout::Activation4D::channels), // output_pixel_stride - NHWC Contiguous
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &avg_pool_op);                                                  // operator
+
+  Operator avg_pool_scoped_op(avg_pool_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_average_pooling2d_nhwc_f32 failed!");
+
+  const xnn_status setup_status = xnn_setup_average_pooling2d_nhwc_f32(
+      avg_pool_op,                                                  // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),   // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height),  // input_height
+      input_padded_contig_nhwc.size(Layout::Activation4D::width),   // input_width
+      input_padded_contig_nhwc.data_ptr<float>(),                   // input
+      output_padded_contig_nhwc.data_ptr<float>(),                  // output
+      internal::threadpool());                                      // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_average_pooling2d_nhwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      avg_pool_op,              // operator
+      internal::threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc.contiguous(input.suggest_memory_format());
+}
+
+// Supports NHWC and NCHW FP32 adaptive average pooling to a 1x1 output, the
+// global average pooling at the end of most mobile classification networks.
+
+bool use_global_average_pool(
+    const Tensor& input,
+    const IntArrayRef output_size) {
+  using namespace internal;
+
+  return xnnpack::internal::available() &&
+      // Input
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.size(Layout::Activation4D::batch) > 0) &&
+      (input.size(Layout::Activation4D::channels) > 0) &&
+      (input.size(Layout::Activation4D::height) > 0) &&
+      (input.size(Layout::Activation4D::width) > 0) &&
+      !input.requires_grad() &&
+      // Output
+      (2 == output_size.size()) &&
+      (1 == output_size[Layout::Parameter::height]) &&
+      (1 == output_size[Layout::Parameter::width]) &&
+      true;
+}
+
+Tensor global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  const Tensor input_padded_contig_nhwc =
+      mobile::allocate_padded_contiguous_if_needed(
+          input,
+          MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = mobile::empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        1,
+        1,
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t global_average_pooling_op{};
+
+  const xnn_status create_status = xnn_create_global_average_pooling_nwc_f32(
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_stride
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // output_stride
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &global_average_pooling_op);                                    // operator
+
+  Operator global_avg_pool_scoped_op(global_average_pooling_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_global_average_pooling_nwc_f32 failed!");
+
+  // The H and W dimensions of an NHWC tensor are contiguous, so they are
+  // pooled over as the single W dimension of an NWC one.
+  const xnn_status setup_status = xnn_setup_global_average_pooling_nwc_f32(
+      global_average_pooling_op,                                    // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),   // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height) *
+          input_padded_contig_nhwc.size(Layout::Activation4D::width), // width
+      input_padded_contig_nhwc.data_ptr<float>(),                   // input
+      output_padded_contig_nhwc.data_ptr<float>(),                  // output
+      internal::threadpool());                                      // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_global_average_pooling_nwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      global_average_pooling_op,  // operator
+      internal::threadpool());    // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc.contiguous(input.suggest_memory_format());
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -0,0 +1,149 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/ExpandUtils.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/utils/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// Supports FP32 add and multiply of contiguous tensors with
+//  - broadcasting, of inputs of up to XNN_MAX_TENSOR_DIMS dimensions
+//  - an alpha of 1 for add
+
+bool use_binary(const Tensor& input1, const Tensor& input2) {
+  const auto usable = [](const Tensor& input) {
+    return (c10::DeviceType::CPU == input.device().type()) &&
+        (kFloat == input.scalar_type()) &&
+        (input.dim() > 0) &&
+        (input.dim() <= XNN_MAX_TENSOR_DIMS) &&
+        (input.numel() > 0) &&
+        input.is_contiguous() &&
+        !input.requires_grad();
+  };
+
+  return xnnpack::internal::available() &&
+      // Inputs
+      usable(input1) &&
+      usable(input2) &&
+      true;
+}
+
+template <typename Create, typename Setup>
+Tensor run_binary(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Create create,
+    const Setup setup,
+    const char* const name) {
+  using namespace internal;
+
+  const Tensor input1_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(
+          input1,
+          MemoryFormat::Contiguous);
+  const Tensor input2_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(
+          input2,
+          MemoryFormat::Contiguous);
+
+  Tensor output_padded_contig = mobile::empty_with_tail_padding(
+      infer_size(input1.sizes(), input2.sizes()),
+      input1_padded_contig.options().dtype(),
+      MemoryFormat::Contiguous,
+      {});
+
+  const std::vector<size_t> input1_shape(
+      input1_padded_contig.sizes().cbegin(),
+      input1_padded_contig.sizes().cend());
+  const std::vector<size_t> input2_shape(
+      input2_padded_contig.sizes().cbegin(),
+      input2_padded_contig.sizes().cend());
+
+  xnn_operator_t binary_op{};
+
+  const xnn_status create_status = create(
+      -std::numeric_limits<float>::infinity(),  // output_min
+      +std::numeric_limits<float>::infinity(),  // output_max
+      0u,                                       // flags
+      &binary_op);                              // operator
+
+  Operator binary_scoped_op(binary_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nd_f32 failed!");
+
+  const xnn_status setup_status = setup(
+      binary_op,                                  // operator
+      input1_shape.size(),                        // num_input1_dims
+      input1_shape.data(),                        // input1_shape
+      input2_shape.size(),                        // num_input2_dims
+      input2_shape.data(),                        // input2_shape
+      input1_padded_contig.data_ptr<float>(),     // input1
+      input2_padded_contig.data_ptr<float>(),     // input2
+      output_padded_contig.data_ptr<float>(),     // output
+      threadpool());                              // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nd_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      binary_op,      // operator
+      threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig;
+}
+
+} // namespace
+
+bool use_add(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Scalar alpha) {
+  return use_binary(input1, input2) &&
+      !alpha.isComplex() &&
+      (1.0 == alpha.toDouble());
+}
+
+Tensor add(
+    const Tensor& input1,
+    const Tensor& input2,
+    const Scalar /* alpha */) {
+  return run_binary(
+      input1,
+      input2,
+      xnn_create_add_nd_f32,
+      xnn_setup_add_nd_f32,
+      "add");
+}
+
+bool use_multiply(
+    const Tensor& input1,
+    const Tensor& input2) {
+  return use_binary(input1, input2);
+}
+
+Tensor multiply(
+    const Tensor& input1,
+    const Tensor& input2) {
+  return run_binary(
+      input1,
+      input2,
+      xnn_create_multiply_nd_f32,
+      xnn_setup_multiply_nd_f32,
+      "multiply");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
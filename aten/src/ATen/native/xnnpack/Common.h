@@ -127,6 +127,14 @@ struct Layout final {
 
 bool available();
 
+// The threadpool operators are run on.  It is the pthreadpool ATen runs its
+// intra-op parallel work on in mobile builds, and one sized to the number of
+// intra-op threads of ATen otherwise, so that XNNPACK never runs with more
+// threads than ATen was asked to use.  Returns nullptr inside a parallel
+// region of ATen, where operators run single-threaded on the calling thread
+// instead of waiting on the pool the region itself is running on.
+pthreadpool_t threadpool();
+
 } // namespace internal
 } // namespace xnnpack
 } // namespace native
@@ -342,7 +342,7 @@ Tensor run(
           context.output_padding_[1],                            // adjustment_width
           padded_input_nhwc.data_ptr<float>(),                   // input
           output.data_ptr<float>(),                              // output
-          caffe2::pthreadpool_());                               // threadpool
+          internal::threadpool());                               // threadpool
 
       } else {
         setup_status = xnn_setup_convolution2d_nhwc_f32(
@@ -352,7 +352,7 @@ Tensor run(
           padded_input_nhwc.size(Layout::Activation4D::width),   // input_width
           padded_input_nhwc.data_ptr<float>(),                   // input
           output.data_ptr<float>(),                              // output
-          caffe2::pthreadpool_());
+          internal::threadpool());
       }
 
       TORCH_CHECK(
@@ -371,7 +371,7 @@ Tensor run(
 
   const xnn_status run_status = xnn_run_operator(
       context.op.get(),         // operator
-      caffe2::pthreadpool_());  // threadpool
+      internal::threadpool());  // threadpool
 
   TORCH_INTERNAL_ASSERT(
       xnn_status_success == run_status,
@@ -483,6 +483,29 @@ Tensor convolution2d(
       ContextConv2D::kMax);
 }
 
+Tensor convolution2d_transpose(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const IntArrayRef padding,
+    const IntArrayRef output_padding,
+    const IntArrayRef stride,
+    const IntArrayRef dilation,
+    const int64_t groups) {
+  return internal::convolution2d::create_and_run(
+      input,
+      weight,
+      bias,
+      padding,
+      output_padding,
+      stride,
+      dilation,
+      groups,
+      true,   // transposed
+      ContextConv2D::kMin,
+      ContextConv2D::kMax);
+}
+
 } // namespace xnnpack
 
 } // namespace native
@@ -29,6 +29,16 @@ Tensor convolution2d(
     const IntArrayRef dilation,
     const int64_t groups);
 
+Tensor convolution2d_transpose(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const IntArrayRef padding,
+    const IntArrayRef output_padding,
+    const IntArrayRef stride,
+    const IntArrayRef dilation,
+    const int64_t groups);
+
 //
 // Linear
 //
@@ -67,6 +77,77 @@ Tensor max_pool2d(
     float output_min = -std::numeric_limits<float>::infinity(),
     float output_max = +std::numeric_limits<float>::infinity());
 
+//
+// Average Pooling
+//
+
+bool use_avg_pool2d(
+    const Tensor& input,
+    IntArrayRef kernel,
+    IntArrayRef padding,
+    IntArrayRef stride,
+    bool ceil_mode,
+    c10::optional<int64_t> divisor_override);
+
+Tensor avg_pool2d(
+    const Tensor& input,
+    IntArrayRef kernel,
+    IntArrayRef padding,
+    IntArrayRef stride);
+
+bool use_global_average_pool(
+    const Tensor& input,
+    IntArrayRef output_size);
+
+Tensor global_average_pool(const Tensor& input);
+
+//
+// Activations
+//
+
+bool use_hardswish(const Tensor& input);
+
+Tensor hardswish(const Tensor& input);
+
+bool use_sigmoid(const Tensor& input);
+
+Tensor sigmoid(const Tensor& input);
+
+//
+// Binary Operators
+//
+
+bool use_add(
+    const Tensor& input1,
+    const Tensor& input2,
+    Scalar alpha);
+
+Tensor add(
+    const Tensor& input1,
+    const Tensor& input2,
+    Scalar alpha);
+
+bool use_multiply(
+    const Tensor& input1,
+    const Tensor& input2);
+
+Tensor multiply(
+    const Tensor& input1,
+    const Tensor& input2);
+
+//
+// Softmax
+//
+
+bool use_softmax(
+    const Tensor& input,
+    int64_t dim,
+    bool half_to_float);
+
+Tensor softmax(
+    const Tensor& input,
+    int64_t dim);
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
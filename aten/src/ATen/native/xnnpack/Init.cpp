@@ -1,6 +1,9 @@
 #ifdef USE_XNNPACK
 
 #include <ATen/native/xnnpack/Common.h>
+#include <ATen/Parallel.h>
+
+#include <mutex>
 
 namespace at {
 namespace native {
@@ -55,6 +58,28 @@ bool available() {
   return internal::initialize();
 }
 
+pthreadpool_t threadpool() {
+  if (at::in_parallel_region()) {
+    return nullptr;
+  }
+
+#ifndef C10_MOBILE
+  // Mobile builds of ATen parallelize on this pool already, and resize it in
+  // at::set_num_threads().  Elsewhere ATen has a pool of its own, which
+  // cannot be resized once it is started either, so this one is sized to it
+  // once.  Resizing it later would recreate the pool under operators that
+  // are running on it.
+  static std::once_flag once;
+  std::call_once(once, []() {
+    caffe2::PThreadPool* const pool = caffe2::pthreadpool();
+    TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!");
+    pool->set_thread_count(at::get_num_threads());
+  });
+#endif /* C10_MOBILE */
+
+  return caffe2::pthreadpool_();
+}
+
 } // namespace internal
 } // namespace xnnpack
 } // namespace native
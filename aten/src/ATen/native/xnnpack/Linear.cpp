@@ -137,7 +137,7 @@ Tensor run(
       Layout::ActivationND::batch(padded_input.sizes()),  // Batch,
       padded_input.data_ptr<float>(),                     // input
       output.data_ptr<float>(),                           // output
-      caffe2::pthreadpool_());                            // threadpool
+      internal::threadpool());                            // threadpool
 
   TORCH_CHECK(
       xnn_status_success == setup_status,
@@ -145,7 +145,7 @@ Tensor run(
 
   const xnn_status run_status = xnn_run_operator(
       context.op.get(),         // operator
-      caffe2::pthreadpool_());  // threadpool
+      internal::threadpool());  // threadpool
 
   TORCH_INTERNAL_ASSERT(
       xnn_status_success == run_status,
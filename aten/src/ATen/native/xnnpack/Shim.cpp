@@ -51,6 +51,18 @@ Tensor convolution2d(
   TORCH_CHECK(false, internal::kError);
 }
 
+Tensor convolution2d_transpose(
+    const Tensor&,
+    const Tensor&,
+    const Tensor&,
+    const IntArrayRef,
+    const IntArrayRef,
+    const IntArrayRef,
+    const IntArrayRef,
+    const int64_t) {
+  TORCH_CHECK(false, internal::kError);
+}
+
 bool use_linear(
     const Tensor&,
     const Tensor&,
@@ -89,6 +101,89 @@ Tensor max_pool2d(
   TORCH_CHECK(false, internal::kError);
 }
 
+bool use_avg_pool2d(
+    const Tensor&,
+    const IntArrayRef,
+    const IntArrayRef,
+    const IntArrayRef,
+    const bool,
+    const c10::optional<int64_t>) {
+  return false;
+}
+
+Tensor avg_pool2d(
+    const Tensor&,
+    const IntArrayRef,
+    const IntArrayRef,
+    const IntArrayRef) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_global_average_pool(
+    const Tensor&,
+    const IntArrayRef) {
+  return false;
+}
+
+Tensor global_average_pool(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_hardswish(const Tensor&) {
+  return false;
+}
+
+Tensor hardswish(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_sigmoid(const Tensor&) {
+  return false;
+}
+
+Tensor sigmoid(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_add(
+    const Tensor&,
+    const Tensor&,
+    const Scalar) {
+  return false;
+}
+
+Tensor add(
+    const Tensor&,
+    const Tensor&,
+    const Scalar) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_multiply(
+    const Tensor&,
+    const Tensor&) {
+  return false;
+}
+
+Tensor multiply(
+    const Tensor&,
+    const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_softmax(
+    const Tensor&,
+    const int64_t,
+    const bool) {
+  return false;
+}
+
+Tensor softmax(
+    const Tensor&,
+    const int64_t) {
+  TORCH_CHECK(false, internal::kError);
+}
+
 } // namespace xnnpack
 
 } // namespace native
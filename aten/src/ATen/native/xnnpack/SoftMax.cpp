@@ -0,0 +1,116 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/WrapDimUtils.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/utils/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// XNNPACK computes the softmax over the innermost dimension in memory, which
+// is the last dimension of a contiguous tensor, and the channels of an NHWC
+// tensor.
+c10::optional<MemoryFormat> softmax_memory_format(
+    const Tensor& input,
+    const int64_t dim) {
+  if ((input.dim() - 1) == dim && input.is_contiguous()) {
+    return MemoryFormat::Contiguous;
+  }
+  if ((4 == input.dim()) &&
+      (static_cast<int64_t>(internal::Layout::Activation4D::channels) == dim) &&
+      input.is_contiguous(MemoryFormat::ChannelsLast)) {
+    return MemoryFormat::ChannelsLast;
+  }
+  return c10::nullopt;
+}
+
+} // namespace
+
+// Supports FP32 softmax of contiguous and NHWC tensors over the innermost
+// dimension, without the round trip through a contiguous tensor the default
+// implementation takes for channels last inputs.
+
+bool use_softmax(
+    const Tensor& input,
+    const int64_t dim_,
+    const bool half_to_float) {
+  if (input.dim() == 0) {
+    return false;
+  }
+  const int64_t dim = maybe_wrap_dim(dim_, input.dim());
+
+  return xnnpack::internal::available() &&
+      // Input
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (input.numel() > 0) &&
+      !input.requires_grad() &&
+      softmax_memory_format(input, dim) &&
+      // Output
+      !half_to_float &&
+      true;
+}
+
+Tensor softmax(const Tensor& input, const int64_t dim_) {
+  using namespace internal;
+
+  // A call to softmax must have been gated by a call to use_softmax, so the
+  // memory format is known to exist at this point.
+  const int64_t dim = maybe_wrap_dim(dim_, input.dim());
+  const MemoryFormat memory_format = *softmax_memory_format(input, dim);
+
+  const Tensor input_padded_contig =
+      mobile::allocate_padded_contiguous_if_needed(input, memory_format);
+
+  Tensor output_padded_contig = mobile::empty_with_tail_padding(
+      input_padded_contig.sizes(),
+      input_padded_contig.options().dtype(),
+      memory_format,
+      input_padded_contig.names());
+
+  const int64_t channels = input_padded_contig.size(dim);
+
+  xnn_operator_t softmax_op{};
+
+  const xnn_status create_status = xnn_create_softmax_nc_f32(
+      channels,       // channels
+      channels,       // input_stride
+      channels,       // output_stride
+      0u,             // flags
+      &softmax_op);   // operator
+
+  Operator softmax_scoped_op(softmax_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_softmax_nc_f32 failed!");
+
+  const xnn_status setup_status = xnn_setup_softmax_nc_f32(
+      softmax_op,                                 // operator
+      input_padded_contig.numel() / channels,     // batch_size
+      input_padded_contig.data_ptr<float>(),      // input
+      output_padded_contig.data_ptr<float>(),     // output
+      threadpool());                              // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_softmax_nc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      softmax_op,     // operator
+      threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig;
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
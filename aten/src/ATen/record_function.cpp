@@ -5,6 +5,10 @@
 
 namespace at {
 
+namespace detail {
+std::atomic<int> active_callback_lists{0};
+} // namespace detail
+
 namespace {
 
 // Used to generate unique callback handles
@@ -18,9 +22,31 @@ RecordFunctionHandle next_unique_record_function_handle() {
   return RecordFunctionHandle(++unique_rf_id);
 }
 
+// Keeps a callback list counted in detail::active_callback_lists while the
+// list is not empty
+struct ActiveCallbackListCounter {
+  void update(const RecordFunctionCallbacks& cbs) {
+    const bool active = !cbs.empty();
+    if (active != counted_) {
+      counted_ = active;
+      detail::active_callback_lists.fetch_add(active ? 1 : -1);
+    }
+  }
+
+  ~ActiveCallbackListCounter() {
+    if (counted_) {
+      detail::active_callback_lists.fetch_sub(1);
+    }
+  }
+
+ private:
+  bool counted_ = false;
+};
+
 // Thread local vector of callbacks, holds pairs (callbacks, unique_id);
 // must be sorted in increasing handles order
 thread_local RecordFunctionCallbacks sorted_tls_callbacks_;
+thread_local ActiveCallbackListCounter tls_callbacks_counter_;
 
 std::atomic<int64_t> defaultNodeId(-1);
 
@@ -31,12 +57,14 @@ class CallbackManager {
     // sorted_tls_callbacks_ sorted
     auto handle = next_unique_callback_handle();
     sorted_tls_callbacks_.emplace_back(std::move(cb), handle);
+    tls_callbacks_counter_.update(sorted_tls_callbacks_);
     return handle;
   }
 
   CallbackHandle addGlobalCallback(RecordFunctionCallback cb) {
     auto handle = next_unique_callback_handle();
     sorted_global_callbacks_.emplace_back(std::move(cb), handle);
+    global_callbacks_counter_.update(sorted_global_callbacks_);
     return handle;
   }
 
@@ -61,6 +89,8 @@ class CallbackManager {
     if (!found) {
       found = find_and_remove(sorted_global_callbacks_);
     }
+    tls_callbacks_counter_.update(sorted_tls_callbacks_);
+    global_callbacks_counter_.update(sorted_global_callbacks_);
     if (!found) {
       LOG(WARNING) << "Requested callback is not found";
     }
@@ -68,10 +98,12 @@ class CallbackManager {
 
   void clearGlobalCallbacks() {
     sorted_global_callbacks_.clear();
+    global_callbacks_counter_.update(sorted_global_callbacks_);
   }
 
   void clearThreadLocalCallbacks() {
     sorted_tls_callbacks_.clear();
+    tls_callbacks_counter_.update(sorted_tls_callbacks_);
   }
 
   inline bool hasGlobalCallbacks() const {
@@ -197,6 +229,7 @@ class CallbackManager {
 
   // Global callbacks; must be sorted in increasing handle order
   RecordFunctionCallbacks sorted_global_callbacks_;
+  ActiveCallbackListCounter global_callbacks_counter_;
 };
 
 // Enumerates thread ids logically;
@@ -278,6 +311,7 @@ void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
           const std::pair<RecordFunctionCallback, CallbackHandle>& r) {
         return l.second < r.second;
   });
+  tls_callbacks_counter_.update(sorted_tls_callbacks_);
 }
 
 bool hasCallbacks() {
@@ -330,7 +364,7 @@ void enableRecordFunction(bool enable) {
 }
 
 RecordFunction::RecordFunction(RecordScope scope) : scope_(scope) {
-  if (hasCallbacks() && isRecordFunctionEnabled()) {
+  if (shouldRunRecordFunction() && hasCallbacks() && isRecordFunctionEnabled()) {
     manager().init(*this);
   }
 }
@@ -3,6 +3,8 @@
 #include <ATen/core/ivalue.h>
 #include <c10/util/SmallVector.h>
 #include <c10/macros/Export.h>
+#include <c10/macros/Macros.h>
+#include <atomic>
 #include <memory>
 
 #include <functional>
@@ -400,6 +402,27 @@ TORCH_API void clearGlobalCallbacks();
 TORCH_API bool hasCallbacks();
 TORCH_API void clearCallbacks(); // not thread safe
 
+namespace detail {
+// Number of callback lists that are not empty: the global one and the thread
+// local ones of every thread
+TORCH_API extern std::atomic<int> active_callback_lists;
+} // namespace detail
+
+/**
+ * shouldRunRecordFunction is a cheap check that returns false when no thread
+ * has any callback, in which case RecordFunction does not need to be created;
+ * when it returns true, RecordFunction still checks the callbacks of the
+ * current thread. Always false in builds with PYTORCH_DISABLE_PER_OP_PROFILING.
+ */
+inline bool shouldRunRecordFunction() {
+#ifdef PYTORCH_DISABLE_PER_OP_PROFILING
+  return false;
+#else
+  return C10_UNLIKELY(
+      detail::active_callback_lists.load(std::memory_order_relaxed) > 0);
+#endif
+}
+
 /**
  * enableRecordFunction enables RecordFunction thread locally
  */
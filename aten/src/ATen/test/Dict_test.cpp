@@ -518,3 +518,31 @@ TEST(DictTest, dictEquality) {
   EXPECT_FALSE(dict.is(dictSameValue));
   EXPECT_TRUE(dict.is(dictRef));
 }
+
+TEST(DictTest, givenStringKeys_whenLookingUpEqualStrings_thenFindsThem) {
+  Dict<string, int64_t> dict;
+  for (int64_t i = 0; i < 100; i++) {
+    dict.insert("key" + std::to_string(i), i);
+  }
+  for (int64_t i = 0; i < 100; i++) {
+    // A different string object than the key
+    auto found = dict.find("key" + std::to_string(i));
+    ASSERT_NE(dict.end(), found);
+    EXPECT_EQ(i, found->value());
+  }
+  EXPECT_EQ(dict.end(), dict.find("key100"));
+  EXPECT_EQ(dict.end(), dict.find(""));
+}
+
+TEST(DictTest, givenIntKeysDifferingInHighBits_whenLookingUp_thenFindsThem) {
+  Dict<int64_t, int64_t> dict;
+  for (int64_t i = 0; i < 16; i++) {
+    dict.insert(i << 32, i);
+  }
+  for (int64_t i = 0; i < 16; i++) {
+    auto found = dict.find(i << 32);
+    ASSERT_NE(dict.end(), found);
+    EXPECT_EQ(i, found->value());
+  }
+  EXPECT_EQ(dict.end(), dict.find(1));
+}
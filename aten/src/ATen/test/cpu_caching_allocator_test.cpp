@@ -40,11 +40,58 @@ TEST(CPUCachingAllocatorTest, check_alloc_inside_free_outside) {
   a.reset();
 }
 
+// Requests of nearby sizes share a size class.
+TEST(CPUCachingAllocatorTest, check_size_class_reuse) {
+  c10::CPUCachingAllocator caching_allocator;
+  c10::WithCPUCachingAllocatorGuard cachine_allocator_guard(
+      &caching_allocator);
+  at::Tensor a = at::rand({23, 23});
+  float* data_ptr = a.data_ptr<float>();
+  a.reset();
+  a = at::rand({22, 25});
+  ASSERT_TRUE(data_ptr == a.data_ptr<float>());
+  auto stats = caching_allocator.stats();
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(stats.cached_bytes, 0);
+}
+
+TEST(CPUCachingAllocatorTest, check_trim_and_limit) {
+  c10::CPUCachingAllocator caching_allocator;
+  {
+    c10::WithCPUCachingAllocatorGuard cachine_allocator_guard(
+        &caching_allocator);
+    at::Tensor a = at::rand({23, 23});
+    at::Tensor b = at::rand({64, 64});
+  }
+  ASSERT_GT(caching_allocator.stats().cached_bytes, 0);
+  caching_allocator.trim();
+  ASSERT_EQ(caching_allocator.stats().cached_bytes, 0);
+
+  // Blocks that do not fit the cache are freed.
+  caching_allocator.set_max_cached_bytes(0);
+  {
+    c10::WithCPUCachingAllocatorGuard cachine_allocator_guard(
+        &caching_allocator);
+    at::Tensor a = at::rand({23, 23});
+  }
+  ASSERT_EQ(caching_allocator.stats().cached_bytes, 0);
+}
+
+// The guard restores the allocator of the enclosing scope.
+TEST(CPUCachingAllocatorTest, check_nested_guards) {
+  c10::CPUCachingAllocator outer;
+  c10::CPUCachingAllocator inner;
+  c10::WithCPUCachingAllocatorGuard outer_guard(&outer);
+  {
+    c10::WithCPUCachingAllocatorGuard inner_guard(&inner);
+    ASSERT_EQ(c10::GetThreadLocalCachingAllocator(), &inner);
+  }
+  ASSERT_EQ(c10::GetThreadLocalCachingAllocator(), &outer);
+}
+
 int main(int argc, char* argv[]) {
-// At the moment caching allocator is only exposed to mobile cpu allocator.
-#ifdef C10_MOBILE
   ::testing::InitGoogleTest(&argc, argv);
   at::manual_seed(42);
   return RUN_ALL_TESTS();
-#endif /* C10_Mobile */
 }
@@ -210,3 +210,32 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   config.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(config.build());
 }
+
+TEST(TensorIteratorTest, PlanCacheReusesLayout) {
+  at::clear_tensor_iterator_plan_cache();
+  // a transposed input takes the generic setup, which reorders dimensions
+  auto a = at::randn({3, 5}).t();
+  auto b = at::randn({5, 3});
+  for (int i = 0; i < 3; i++) {
+    Tensor out;
+    auto iter = TensorIterator::binary_op(out, a, b);
+    EXPECT_EQ(iter.ndim(), 2);
+    EXPECT_EQ(iter.output().sizes(), b.sizes());
+    EXPECT_EQ(iter.output().strides(), a.strides());
+  }
+  auto stats = at::tensor_iterator_plan_cache_stats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 2);
+
+  // a cached plan computes the same result, also for the fast setup
+  for (int i = 0; i < 2; i++) {
+    EXPECT_TRUE(at::add(a, b).equal(a.contiguous().add(b)));
+    EXPECT_TRUE(at::add(b, b).equal(at::mul(b, 2)));
+  }
+  EXPECT_GT(at::tensor_iterator_plan_cache_stats().hits, 2);
+
+  at::clear_tensor_iterator_plan_cache();
+  stats = at::tensor_iterator_plan_cache_stats();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, 0);
+}
@@ -4,6 +4,8 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <string.h>
 #include <sstream>
@@ -36,6 +38,87 @@ TEST(TestParallel, NestedParallel) {
   });
 }
 
+TEST(TestParallel, NestedParallelFor) {
+  // inner regions may run in parallel or not, depending on the thread pool
+  std::vector<int64_t> sums(16, 0);
+  at::parallel_for(0, 16, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      auto thread_num = at::get_thread_num();
+      sums[i] = at::parallel_reduce(
+          0, 1000, 1, (int64_t)0,
+          [](int64_t b, int64_t e, int64_t ident) {
+            int64_t partial = ident;
+            for (int64_t j = b; j < e; j++) {
+              partial += j;
+            }
+            return partial;
+          },
+          std::plus<int64_t>());
+      // the inner region restores the state of the outer one
+      ASSERT_TRUE(at::in_parallel_region());
+      ASSERT_EQ(at::get_thread_num(), thread_num);
+    }
+  });
+  for (auto sum : sums) {
+    ASSERT_EQ(sum, 499500);
+  }
+}
+
+#if AT_PARALLEL_NATIVE
+TEST(TestParallel, AdaptiveGrainSize) {
+  at::internal::GrainSizeTuner tuner;
+  ASSERT_EQ(tuner.grain_size(at::internal::GRAIN_SIZE), at::internal::GRAIN_SIZE);
+  // 1us per element
+  tuner.record(1000, 1000000);
+  ASSERT_EQ(
+      tuner.grain_size(at::internal::GRAIN_SIZE),
+      at::internal::GrainSizeTuner::kAdaptiveTaskNs / 1000);
+
+  at::internal::_set_adaptive_grain_size(true);
+  for (int i = 0; i < 20; i++) {
+    auto sum = at::parallel_reduce(
+        0, 100000, at::internal::GRAIN_SIZE, (int64_t)0,
+        [](int64_t b, int64_t e, int64_t ident) {
+          int64_t partial = ident;
+          for (int64_t j = b; j < e; j++) {
+            partial += j;
+          }
+          return partial;
+        },
+        std::plus<int64_t>());
+    ASSERT_EQ(sum, (int64_t)100000 * 99999 / 2);
+  }
+  at::internal::_set_adaptive_grain_size(false);
+}
+#endif
+
+TEST(TestParallel, NamedIntraopPool) {
+  at::create_intraop_pool("test_pool", 2);
+  ASSERT_THROW(at::create_intraop_pool("test_pool", 2), c10::Error);
+  ASSERT_THROW(at::set_current_intraop_pool("no_such_pool"), c10::Error);
+  ASSERT_EQ(at::get_current_intraop_pool(), "");
+  {
+    at::IntraopPoolGuard guard("test_pool");
+    ASSERT_EQ(at::get_current_intraop_pool(), "test_pool");
+#if AT_PARALLEL_NATIVE
+    ASSERT_EQ(at::get_num_threads(), 2);
+#endif
+    std::atomic<int64_t> sum{0};
+    at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+      for (auto i = begin; i < end; i++) {
+        sum += i;
+      }
+    });
+    ASSERT_EQ(sum.load(), 1000 * 999 / 2);
+
+    // follows the thread local state to inter-op tasks
+    std::promise<std::string> pool;
+    at::launch([&]() { pool.set_value(at::get_current_intraop_pool()); });
+    ASSERT_EQ(pool.get_future().get(), "test_pool");
+  }
+  ASSERT_EQ(at::get_current_intraop_pool(), "");
+}
+
 TEST(TestParallel, Exceptions) {
   // parallel case
   ASSERT_THROW(
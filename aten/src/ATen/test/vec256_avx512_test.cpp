@@ -0,0 +1,222 @@
+// Built with the AVX512 capability flags, see caffe2/CMakeLists.txt, so that
+// Vec256 resolves to the vec512 specializations. The tests do nothing on a
+// CPU without the AVX512 extensions those use.
+#include <gtest/gtest.h>
+
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cpuinfo.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace at::vec256;
+
+namespace {
+
+#if !defined(CPU_CAPABILITY_AVX512)
+#error "vec256_avx512_test must be built with CPU_CAPABILITY_AVX512"
+#endif
+
+// Same check as compute_cpu_capability in ATen/native/DispatchStub.cpp.
+bool has_avx512() {
+  return cpuinfo_initialize() && cpuinfo_has_x86_avx512f() &&
+      cpuinfo_has_x86_avx512bw() && cpuinfo_has_x86_avx512dq() &&
+      cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_fma3();
+}
+
+template <typename T>
+void test_partial_loadu_store() {
+  constexpr int64_t size = Vec256<T>::size();
+  static_assert(size * sizeof(T) == 64, "not a 512-bit vector");
+  std::vector<T> src(size);
+  for (int64_t i = 0; i < size; i++) {
+    src[i] = static_cast<T>(i + 1);
+  }
+  for (int64_t count = 0; count <= size; count++) {
+    // Lanes past count are loaded as zeros.
+    std::vector<T> loaded(size, static_cast<T>(-1));
+    Vec256<T>::loadu(src.data(), count).store(loaded.data());
+    for (int64_t i = 0; i < size; i++) {
+      ASSERT_EQ(loaded[i], i < count ? src[i] : static_cast<T>(0))
+          << "count " << count << ", lane " << i;
+    }
+    // Memory past count is left untouched by the store.
+    std::vector<T> stored(size, static_cast<T>(-1));
+    Vec256<T>::loadu(src.data()).store(stored.data(), count);
+    for (int64_t i = 0; i < size; i++) {
+      ASSERT_EQ(stored[i], i < count ? src[i] : static_cast<T>(-1))
+          << "count " << count << ", lane " << i;
+    }
+  }
+}
+
+// The compares expand their k-masks into all-ones or all-zeros lanes, which
+// blendv selects by.
+template <typename T, typename Bits>
+void test_compare_blendv() {
+  static_assert(sizeof(T) == sizeof(Bits), "lanes and bits differ in size");
+  constexpr int64_t size = Vec256<T>::size();
+  std::vector<T> a(size), b(size);
+  for (int64_t i = 0; i < size; i++) {
+    a[i] = static_cast<T>(i);
+    b[i] = static_cast<T>(size - 1 - i);
+  }
+  auto va = Vec256<T>::loadu(a.data());
+  auto vb = Vec256<T>::loadu(b.data());
+
+  std::vector<Bits> mask(size);
+  (va < vb).store(mask.data());
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(mask[i], a[i] < b[i] ? static_cast<Bits>(~Bits(0)) : Bits(0))
+        << "lane " << i;
+  }
+
+  std::vector<T> res(size);
+  Vec256<T>::blendv(va, vb, va < vb).store(res.data());
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[i], a[i] < b[i] ? b[i] : a[i]) << "lane " << i;
+  }
+  Vec256<T>::blendv(va, vb, va == vb).store(res.data());
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[i], a[i]) << "lane " << i;
+  }
+  Vec256<T>::blendv(va, vb, va >= vb).store(res.data());
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[i], a[i] >= b[i] ? b[i] : a[i]) << "lane " << i;
+  }
+}
+
+template <typename T>
+void test_maximum_minimum_nan() {
+  constexpr int64_t size = Vec256<T>::size();
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+  std::vector<T> a(size), b(size);
+  for (int64_t i = 0; i < size; i++) {
+    a[i] = i % 3 == 0 ? nan : static_cast<T>(i);
+    b[i] = i % 4 == 0 ? nan : static_cast<T>(size - i);
+  }
+  auto va = Vec256<T>::loadu(a.data());
+  auto vb = Vec256<T>::loadu(b.data());
+  std::vector<T> max(size), min(size);
+  maximum(va, vb).store(max.data());
+  minimum(va, vb).store(min.data());
+  for (int64_t i = 0; i < size; i++) {
+    if (std::isnan(a[i]) || std::isnan(b[i])) {
+      ASSERT_TRUE(std::isnan(max[i])) << "lane " << i;
+      ASSERT_TRUE(std::isnan(min[i])) << "lane " << i;
+    } else {
+      ASSERT_EQ(max[i], std::max(a[i], b[i])) << "lane " << i;
+      ASSERT_EQ(min[i], std::min(a[i], b[i])) << "lane " << i;
+    }
+  }
+}
+
+template <typename T>
+void test_interleave2() {
+  constexpr int64_t size = Vec256<T>::size();
+  std::vector<T> a(size), b(size);
+  for (int64_t i = 0; i < size; i++) {
+    a[i] = static_cast<T>(i);
+    b[i] = static_cast<T>(size + i);
+  }
+  auto va = Vec256<T>::loadu(a.data());
+  auto vb = Vec256<T>::loadu(b.data());
+  std::vector<T> res(2 * size);
+  auto interleaved = interleave2(va, vb);
+  std::get<0>(interleaved).store(res.data());
+  std::get<1>(interleaved).store(res.data() + size);
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[2 * i], a[i]) << "lane " << i;
+    ASSERT_EQ(res[2 * i + 1], b[i]) << "lane " << i;
+  }
+  auto deinterleaved =
+      deinterleave2(std::get<0>(interleaved), std::get<1>(interleaved));
+  std::get<0>(deinterleaved).store(res.data());
+  std::get<1>(deinterleaved).store(res.data() + size);
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[i], a[i]) << "lane " << i;
+    ASSERT_EQ(res[size + i], b[i]) << "lane " << i;
+  }
+}
+
+template <typename T, typename Index>
+void test_gather() {
+  constexpr int64_t size = Vec256<T>::size();
+  std::vector<T> base(3 * size);
+  for (int64_t i = 0; i < 3 * size; i++) {
+    base[i] = static_cast<T>(i);
+  }
+  std::vector<Index> index(size);
+  for (int64_t i = 0; i < size; i++) {
+    index[i] = static_cast<Index>(3 * (size - 1 - i));
+  }
+  auto vindex = Vec256<Index>::loadu(index.data());
+  std::vector<T> res(size);
+  gather<sizeof(T)>(base.data(), vindex).store(res.data());
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[i], base[index[i]]) << "lane " << i;
+  }
+
+  // Only the lanes with the sign bit set in the mask are gathered.
+  std::vector<T> a(size, static_cast<T>(-1)), b(size, static_cast<T>(0));
+  for (int64_t i = 0; i < size; i += 2) {
+    b[i] = static_cast<T>(1);
+  }
+  auto mask = Vec256<T>::loadu(b.data()) == Vec256<T>(static_cast<T>(1));
+  mask_gather<sizeof(T)>(Vec256<T>::loadu(a.data()), base.data(), vindex, mask)
+      .store(res.data());
+  for (int64_t i = 0; i < size; i++) {
+    ASSERT_EQ(res[i], i % 2 == 0 ? base[index[i]] : a[i]) << "lane " << i;
+  }
+}
+
+} // namespace
+
+TEST(Vec256AVX512Test, PartialLoaduStore) {
+  if (!has_avx512()) {
+    return;
+  }
+  test_partial_loadu_store<float>();
+  test_partial_loadu_store<double>();
+  test_partial_loadu_store<int64_t>();
+  test_partial_loadu_store<int32_t>();
+  test_partial_loadu_store<int16_t>();
+}
+
+TEST(Vec256AVX512Test, CompareBlendv) {
+  if (!has_avx512()) {
+    return;
+  }
+  test_compare_blendv<float, uint32_t>();
+  test_compare_blendv<double, uint64_t>();
+  test_compare_blendv<int64_t, uint64_t>();
+  test_compare_blendv<int32_t, uint32_t>();
+  test_compare_blendv<int16_t, uint16_t>();
+}
+
+TEST(Vec256AVX512Test, MaximumMinimumNaN) {
+  if (!has_avx512()) {
+    return;
+  }
+  test_maximum_minimum_nan<float>();
+  test_maximum_minimum_nan<double>();
+}
+
+TEST(Vec256AVX512Test, Interleave2) {
+  if (!has_avx512()) {
+    return;
+  }
+  test_interleave2<float>();
+  test_interleave2<double>();
+}
+
+TEST(Vec256AVX512Test, Gather) {
+  if (!has_avx512()) {
+    return;
+  }
+  test_gather<float, int32_t>();
+  test_gather<double, int64_t>();
+}
@@ -3,165 +3,242 @@
 #include <ATen/detail/CUDAHooksInterface.h>
 
 
+#include <c10/util/llvmMathExtras.h>
+
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <array>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
 #include <unordered_map>
 #include <unordered_set>
-#include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
-struct BlockSize
-{
-  size_t  size; // allocation size
-  void*   ptr;  // host memory pointer
-
-  BlockSize(size_t size, void* ptr=NULL) : size(size), ptr(ptr) {}
-};
+using c10::cuda::CUDACachingAllocator::Stat;
+
+// Requests are rounded up to a power of two of at least kMinBlockSize bytes
+// and cached in one free list per size, so that allocations of different
+// sizes, as made by the many threads of a data loader, do not contend for
+// the same lock.
+constexpr size_t kMinBlockSize = 512;
+constexpr int kNumBins = 64;
+// number of independently locked shards of the map from pointers to blocks
+constexpr int kNumShards = 16;
+
+void update_stat(Stat& stat, int64_t amount) {
+  stat.current += amount;
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  } else {
+    stat.freed += -amount;
+  }
+}
 
-struct Block : public BlockSize
+struct Block
 {
-  bool  allocated;    // true if the block is currently allocated
-  int   event_count;  // number of outstanding cuda events
+  size_t  size;         // allocation size, a power of two
+  void*   ptr;          // host memory pointer
+  bool    allocated;    // true if the block is currently allocated
+  int     event_count;  // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+  Block(size_t size, void* ptr) :
+      size(size), ptr(ptr), allocated(true), event_count(0), streams() {}
 };
 
-static bool BlockComparator(const BlockSize& a, const BlockSize& b)
-{
-  // sort by size, break ties with pointer
-  if (a.size != b.size) {
-    return a.size < b.size;
-  }
-  return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
-}
-
 struct HostAllocator
 {
-  typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
+  struct BlockShard {
+    std::mutex mutex;
+    std::unordered_map<void*, Block*> blocks;
+  };
+
+  struct FreeList {
+    std::mutex mutex;
+    std::vector<Block*> blocks;
+  };
 
-  // lock around all operations
-  std::mutex mutex;
+  // blocks by pointer; the shard lock also guards allocated and streams of
+  // its blocks
+  std::array<BlockShard, kNumShards> shards;
 
-  // blocks by pointer
-  std::unordered_map<void*, Block> blocks;
+  // blocks that are ready to be allocated (event_count=0), by size
+  std::array<FreeList, kNumBins> free_lists;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  // outstanding cuda events; the lock also guards event_count of all blocks
+  std::mutex events_mutex;
+  std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
-  // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
+  std::mutex stats_mutex;
+  THCCachingHostAllocatorStats stats;
 
-  HostAllocator() : available(BlockComparator) {}
+  static int size_to_bin(size_t size) {
+    return c10::llvm::Log2_64_Ceil(std::max(size, kMinBlockSize));
+  }
+
+  BlockShard& shard_for(void* ptr) {
+    // blocks are at least kMinBlockSize aligned
+    return shards[(reinterpret_cast<uintptr_t>(ptr) / kMinBlockSize) % kNumShards];
+  }
 
   cudaError_t malloc(void** ptr, size_t size)
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    // note that cudaHostAlloc may not touch pointer if size is 0
+    *ptr = 0;
+    if (size == 0) {
+      return cudaSuccess;
+    }
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
+    // process outstanding cuda events which may have occurred, unless
+    // another thread is already doing so
+    cudaError_t err = processEvents(/*wait=*/false);
     if (err != cudaSuccess) {
       return err;
     }
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
-      available.erase(it);
-      return cudaSuccess;
-    }
-
-    // Pinned memory pointers allocated by any device can be directly used by any
-    // other device, regardless of the current device at the time of allocation,
-    // since we assume unified addressing.
-    // So we grab any existing primary context, if available.
-    // See pytorch/pytorch#21081.
-    at::OptionalDeviceGuard device_guard;
-    auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
-    if (primary_ctx_device_index.has_value()) {
-      device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
+    const int bin = size_to_bin(size);
+    const size_t block_size = size_t(1) << bin;
+    Block* block = nullptr;
+    {
+      FreeList& free_list = free_lists[bin];
+      std::lock_guard<std::mutex> lock(free_list.mutex);
+      if (!free_list.blocks.empty()) {
+        block = free_list.blocks.back();
+        free_list.blocks.pop_back();
+      }
     }
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
+    if (block) {
+      BlockShard& shard = shard_for(block->ptr);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      THAssert(!block->allocated && block->event_count == 0);
+      block->allocated = true;
+    } else {
+      // Pinned memory pointers allocated by any device can be directly used by any
+      // other device, regardless of the current device at the time of allocation,
+      // since we assume unified addressing.
+      // So we grab any existing primary context, if available.
+      // See pytorch/pytorch#21081.
+      at::OptionalDeviceGuard device_guard;
+      auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
+      if (primary_ctx_device_index.has_value()) {
+        device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
+      }
 
-    // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
-    if (err != cudaSuccess) {
-      return err;
+      // allocate a new block if no cached allocation is found; no lock is
+      // held, so other threads are served from the cache meanwhile
+      void* new_ptr = nullptr;
+      err = cudaHostAlloc(&new_ptr, block_size, cudaHostAllocDefault);
+      if (err != cudaSuccess) {
+        return err;
+      }
+      block = new Block(block_size, new_ptr);
+      {
+        BlockShard& shard = shard_for(new_ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.blocks.emplace(new_ptr, block);
+      }
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.segment, 1);
+      update_stat(stats.reserved_bytes, block_size);
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.allocation, 1);
+      update_stat(stats.allocated_bytes, block_size);
+    }
+    *ptr = block->ptr;
     return cudaSuccess;
   }
 
   cudaError_t free(void* ptr)
   {
-    std::lock_guard<std::mutex> lock(mutex);
-
     if (!ptr) {
       return cudaSuccess;
     }
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
-    if (err != cudaSuccess) {
-      return err;
+    Block* block;
+    std::unordered_set<at::cuda::CUDAStream> streams;
+    {
+      BlockShard& shard = shard_for(ptr);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.blocks.find(ptr);
+      THAssert(it != shard.blocks.end());
+      block = it->second;
+      THAssert(block->allocated);
+
+      // free (on valid memory) shouldn't fail, so mark unallocated before
+      // we process the streams.
+      block->allocated = false;
+      streams = std::move(block->streams);
+      block->streams.clear();
+    }
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.allocation, -1);
+      update_stat(stats.allocated_bytes, -block->size);
     }
 
-    auto it = blocks.find(ptr);
-    THAssert(it != blocks.end());
-
-    Block& block = it->second;
-    THAssert(block.allocated);
-
-    // free (on valid memory) shouldn't fail, so mark unallocated before
-    // we process the streams.
-    block.allocated = false;
+    if (streams.empty()) {
+      // the block can be re-used right away if it was not used on any stream
+      makeAvailable(block);
+      return processEvents(/*wait=*/false);
+    }
 
-    // insert CUDA events for each stream on which this block was used. This
-    err = insertEvents(block);
+    // insert CUDA events for each stream on which this block was used; the
+    // block becomes available once all of them have completed
+    std::lock_guard<std::mutex> lock(events_mutex);
+    cudaError_t err = insertEvents(block, streams);
     if (err != cudaSuccess) {
       return err;
     }
-
-    if (block.event_count == 0) {
-      // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+    if (block->event_count == 0) {
+      makeAvailable(block);
     }
     return cudaSuccess;
   }
 
   cudaError_t recordEvent(void* ptr, at::cuda::CUDAStream stream)
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    BlockShard& shard = shard_for(ptr);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = blocks.find(ptr);
-    if (it == blocks.end()) {
+    auto it = shard.blocks.find(ptr);
+    if (it == shard.blocks.end()) {
       // ignore events for untracked pointers
       return cudaSuccess;
     }
 
-    Block& block = it->second;
-    THAssert(block.allocated);
+    Block* block = it->second;
+    THAssert(block->allocated);
 
-    block.streams.insert(stream);
+    block->streams.insert(stream);
     return cudaSuccess;
   }
 
-  cudaError_t processEvents()
+  void makeAvailable(Block* block)
   {
+    FreeList& free_list = free_lists[size_to_bin(block->size)];
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    free_list.blocks.push_back(block);
+  }
+
+  cudaError_t processEvents(bool wait)
+  {
+    std::unique_lock<std::mutex> lock(events_mutex, std::defer_lock);
+    if (wait) {
+      lock.lock();
+    } else if (!lock.try_lock()) {
+      return cudaSuccess;
+    }
+
     // Process outstanding cudaEvents. Events that are completed are removed
     // from the queue, and the 'event_count' for the corresponding allocation
     // is decremented. Stops at the first event which has not been completed.
@@ -173,6 +250,8 @@ struct HostAllocator
 
       cudaError_t err = cudaEventQuery(event);
       if (err == cudaErrorNotReady) {
+        // ignore and clear the error if not ready
+        cudaGetLastError();
         break;
       } else if (err != cudaSuccess) {
         return err;
@@ -182,10 +261,10 @@ struct HostAllocator
         return err;
       }
 
-      Block& block = blocks.at(e.second);
-      block.event_count--;
-      if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+      Block* block = e.second;
+      block->event_count--;
+      if (block->event_count == 0) {
+        makeAvailable(block);
       }
       cuda_events.pop_front();
     }
@@ -194,37 +273,51 @@ struct HostAllocator
 
   void emptyCache()
   {
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // remove events for freed blocks
-    for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
-      cudaEvent_t event = it->first;
-      Block& block = blocks.at(it->second);
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaEventDestroy(event));
-        block.event_count--;
+    std::vector<Block*> unused;
+    {
+      std::lock_guard<std::mutex> lock(events_mutex);
+
+      // Blocks with outstanding events are all freed. Their events are
+      // dropped, cudaFreeHost synchronizes with the work using them.
+      for (auto& e : cuda_events) {
+        THCudaCheckWarn(cudaEventDestroy(e.first));
+        Block* block = e.second;
+        if (--block->event_count == 0) {
+          unused.push_back(block);
+        }
       }
+      cuda_events.clear();
     }
 
-    // all cuda_events have been processed
-    cuda_events.clear();
-
-    // clear list of available blocks
-    available.clear();
+    for (auto& free_list : free_lists) {
+      std::lock_guard<std::mutex> lock(free_list.mutex);
+      unused.insert(unused.end(), free_list.blocks.begin(), free_list.blocks.end());
+      free_list.blocks.clear();
+    }
 
-    // free and erase non-allocated blocks
-    for (auto it = blocks.begin(); it != blocks.end();) {
-      Block& block = it->second;
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
-        it = blocks.erase(it);
-      } else {
-        ++it;
+    for (Block* block : unused) {
+      {
+        BlockShard& shard = shard_for(block->ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.blocks.erase(block->ptr);
+      }
+      THCudaCheckWarn(cudaFreeHost(block->ptr));
+      {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        update_stat(stats.segment, -1);
+        update_stat(stats.reserved_bytes, -block->size);
       }
+      delete block;
     }
   }
 
-  cudaError_t insertEvents(Block& block)
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+  }
+
+  cudaError_t insertEvents(Block* block, const std::unordered_set<at::cuda::CUDAStream>& streams)
   {
     cudaError_t err;
 
@@ -232,7 +325,6 @@ struct HostAllocator
     err = cudaGetDevice(&prev_device);
     if (err != cudaSuccess) return err;
 
-    std::unordered_set<at::cuda::CUDAStream> streams(std::move(block.streams));
     for (auto it = streams.begin(); it != streams.end(); ++it) {
       err = cudaSetDevice(it->device_index());
       if (err != cudaSuccess) break;
@@ -244,8 +336,8 @@ struct HostAllocator
       err = cudaEventRecord(event, it->stream());
       if (err != cudaSuccess) break;
 
-      block.event_count++;
-      cuda_events.emplace_back(event, block.ptr);
+      block->event_count++;
+      cuda_events.emplace_back(event, block);
     }
 
     cudaSetDevice(prev_device);
@@ -267,6 +359,11 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
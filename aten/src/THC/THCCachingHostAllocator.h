@@ -4,6 +4,7 @@
 #include <THC/THCGeneral.h>
 
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 
 //
@@ -19,7 +20,10 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Requests are rounded up to a
+// power of two instead and cached per size, with separate locks for every
+// size and for the lookup of pointers, so that many threads can allocate and
+// free pinned memory concurrently.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -30,4 +34,20 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Statistics of the allocator, analogous to those of the caching device
+// allocator.
+struct THCCachingHostAllocatorStats {
+  // COUNT: allocations requested by client code
+  c10::cuda::CUDACachingAllocator::Stat allocation;
+  // COUNT: number of pinned blocks obtained from cudaHostAlloc
+  c10::cuda::CUDACachingAllocator::Stat segment;
+  // SUM: bytes in allocated blocks, after rounding
+  c10::cuda::CUDACachingAllocator::Stat allocated_bytes;
+  // SUM: bytes pinned by this allocator (both free and used)
+  c10::cuda::CUDACachingAllocator::Stat reserved_bytes;
+};
+
+// Returns a copy of the allocator stats
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+
 #endif
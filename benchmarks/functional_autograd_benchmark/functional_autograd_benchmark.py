@@ -9,6 +9,7 @@ from typing import NamedTuple, Callable, List, Any
 import ppl_models
 import vision_models
 import audio_text_models
+import small_ops_models
 
 from utils import to_markdown_table, TimingResultType, InputsType, GetterType, VType
 
@@ -53,6 +54,7 @@ MODELS = [
     ModelDef("deepspeech", audio_text_models.get_deepspeech, FAST_TASKS_NO_DOUBLE_BACK, DOUBLE_BACKWARD_TASKS),
     ModelDef("transformer", audio_text_models.get_transformer, FAST_TASKS, []),
     ModelDef("multiheadattn", audio_text_models.get_multiheadattn, FAST_TASKS, []),
+    ModelDef("many_small_ops", small_ops_models.get_many_small_ops, FAST_TASKS_NO_DOUBLE_BACK, []),
 ]
 
 def get_v_for(model: Callable, inp: InputsType, task: str) -> VType:
@@ -117,8 +119,13 @@ def main():
     parser.add_argument("--num-threads", type=int, default=10,
                         help="Number of concurrent threads to use when running on cpu")
     parser.add_argument("--seed", type=int, default=0, help="The random seed to use.")
+    parser.add_argument("--no-cpu-priority-ordering", action="store_true",
+                        help="Run the nodes of CPU-only backward passes without priority ordering")
     args = parser.parse_args()
 
+    if args.no_cpu_priority_ordering:
+        torch.autograd._set_cpu_priority_ordering(False)
+
     results: TimingResultType = defaultdict(defaultdict)
     torch.set_num_threads(args.num_threads)
     torch.set_num_interop_threads(args.num_threads)
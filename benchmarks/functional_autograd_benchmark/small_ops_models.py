@@ -0,0 +1,21 @@
+import torch
+from torch import Tensor
+
+from utils import GetterReturnType
+
+def get_many_small_ops(device: torch.device) -> GetterReturnType:
+    # A long chain of elementwise ops on tiny tensors, the backward pass is
+    # dominated by the scheduling of the ~10k autograd nodes.
+    N = 16
+    depth = 2500
+
+    weights = torch.rand(4, N, device=device)
+    weights.requires_grad_(True)
+
+    def forward(weights: Tensor) -> Tensor:
+        out = torch.ones(N, device=weights.device)
+        for i in range(depth):
+            out = (out * weights[i % 4]).tanh() + weights[(i + 1) % 4]
+        return out.sum()
+
+    return forward, (weights,)
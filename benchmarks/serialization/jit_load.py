@@ -0,0 +1,38 @@
+import torch
+from pyarkbench import Benchmark, Timer, default_args
+
+
+class ManySmall(torch.nn.Module):
+    def __init__(self, num_params, constant_size):
+        super(ManySmall, self).__init__()
+        for i in range(num_params):
+            self.register_buffer('buffer{}'.format(i), torch.randn(4))
+        self.sizes = [i for i in range(constant_size)]
+        self.table = {str(i): float(i) for i in range(constant_size)}
+
+    def forward(self, x):
+        return x + len(self.sizes) + len(self.table)
+
+
+class Load(Benchmark):
+    def benchmark(self):
+        torch.jit.save(torch.jit.script(ManySmall(2000, 20000)), "many_small.pt")
+        with Timer() as many_small:
+            torch.jit.load("many_small.pt")
+
+        x = {str(i): torch.ones(4) for i in range(5000)}
+        x['list'] = [float(i) for i in range(50000)]
+        torch.save(x, "state_dict.pt")
+        with Timer() as state_dict:
+            torch.load("state_dict.pt")
+
+        return {
+            "torch.jit.load 2000 small buffers": many_small.ms_duration,
+            "torch.load 5000 small tensors": state_dict.ms_duration,
+        }
+
+
+if __name__ == '__main__':
+    bench = Load(*default_args.bench())
+    results = bench.run()
+    bench.print_stats(results, stats=['mean', 'median'])
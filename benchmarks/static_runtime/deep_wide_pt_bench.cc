@@ -88,4 +88,26 @@ BENCHMARK(BM_deep_wide_jit_profiling_executor)
 
 BENCHMARK(BM_deep_wide_static)->RangeMultiplier(8)->Ranges({{1, 20}});
 
-BENCHMARK_MAIN();
+// Prints the per-node and per-op-kind latency breakdown of the static runtime
+static void print_deep_wide_static_breakdown(int batch_size) {
+  auto mod = getDeepAndWideSciptModel();
+  torch::jit::StaticRuntime runtime(mod);
+
+  auto ad_emb_packed = torch::randn({batch_size, 1, embedding_size});
+  auto user_emb = torch::randn({batch_size, 1, embedding_size});
+  auto wide = torch::randn({batch_size, num_features});
+
+  std::vector<c10::IValue> inputs({ad_emb_packed, user_emb, wide});
+
+  std::cout << "deep_wide static runtime breakdown, batch size " << batch_size
+            << std::endl;
+  runtime.benchmark(inputs, /*warmup_runs=*/100, /*main_runs=*/1000);
+}
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  for (int batch_size : {1, 8}) {
+    print_deep_wide_static_breakdown(batch_size);
+  }
+}
@@ -16,8 +16,12 @@
 
 #include "benchmark/benchmark.h"
 
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/TensorImpl.h>
 #include <c10/util/Logging.h>
 
+#include <vector>
+
 #if defined(__GNUC__)
 #define NOINLINE __attribute__((noinline))
 #else
@@ -55,4 +59,57 @@ static void BM_NoAPILogging(benchmark::State& state) {
 }
 BENCHMARK(BM_NoAPILogging);
 
+// Sizes of 2 in each of range(0) dimensions, so that the metadata of up to 5
+// of them is stored inline.
+static std::vector<int64_t> Sizes(const benchmark::State& state) {
+  return std::vector<int64_t>(state.range(0), 2);
+}
+
+static c10::intrusive_ptr<c10::TensorImpl> MakeTensorImpl() {
+  return c10::make_intrusive<c10::TensorImpl>(
+      c10::DispatchKeySet(c10::DispatchKey::CPU),
+      caffe2::TypeMeta::Make<float>(),
+      c10::Device(c10::DeviceType::CPU));
+}
+
+static void BM_TensorImplCreateDestroy(benchmark::State& state) {
+  const auto sizes = Sizes(state);
+  while (state.KeepRunning()) {
+    auto impl = MakeTensorImpl();
+    impl->set_sizes_contiguous(sizes);
+    benchmark::DoNotOptimize(impl);
+  }
+}
+BENCHMARK(BM_TensorImplCreateDestroy)->DenseRange(0, 8);
+
+static void BM_TensorImplShallowCopy(benchmark::State& state) {
+  // Shallow copies share the storage
+  auto impl = c10::make_intrusive<c10::TensorImpl>(
+      c10::Storage(
+          c10::Storage::use_byte_size_t(),
+          0,
+          c10::GetCPUAllocator(),
+          /*resizable=*/true),
+      c10::DispatchKeySet(c10::DispatchKey::CPU),
+      caffe2::TypeMeta::Make<float>());
+  impl->set_sizes_contiguous(Sizes(state));
+  const c10::VariableVersion version_counter;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(impl->shallow_copy_and_detach(
+        version_counter, /*allow_tensor_metadata_change=*/true));
+  }
+}
+BENCHMARK(BM_TensorImplShallowCopy)->DenseRange(0, 8);
+
+static void BM_TensorImplSetSizesAndStrides(benchmark::State& state) {
+  const auto sizes = Sizes(state);
+  std::vector<int64_t> strides(sizes.size(), 1);
+  auto impl = MakeTensorImpl();
+  while (state.KeepRunning()) {
+    impl->set_sizes_and_strides(sizes, strides);
+    benchmark::DoNotOptimize(impl->is_contiguous());
+  }
+}
+BENCHMARK(BM_TensorImplSetSizesAndStrides)->DenseRange(0, 8);
+
 BENCHMARK_MAIN();
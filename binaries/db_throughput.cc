@@ -32,6 +32,18 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    prefetch_cursors,
+    0,
+    "If positive, the reader prefetches records with that many cursors.");
+C10_DEFINE_int(
+    prefetch_window_size,
+    256,
+    "The number of records the reader prefetches at most.");
+C10_DEFINE_int(
+    prefetch_batch_size,
+    16,
+    "The number of records a prefetching cursor reads at a time.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -82,6 +94,12 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
 
 void TestThroughputWithReader() {
   caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  if (FLAGS_prefetch_cursors > 0) {
+    reader.StartPrefetching(
+        FLAGS_prefetch_cursors,
+        FLAGS_prefetch_window_size,
+        FLAGS_prefetch_batch_size);
+  }
   std::vector<std::unique_ptr<std::thread>> reading_threads(
       FLAGS_num_read_threads);
   for (int i = 0; i < reading_threads.size(); ++i) {
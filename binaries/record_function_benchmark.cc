@@ -61,11 +61,23 @@ int main(int argc, char** argv) {
   }
 
   at::enableRecordFunction();
-  setupBenchmarkCallbacks();
 
   auto duration = runBench(kSmallTensorSize, FLAGS_warmup_iter);
   std::cout << "Warmup time: " << duration << " us." << std::endl;
 
+  // Dispatch does not construct RecordFunction at all without callbacks
+  for (auto tensor_size : std::set<int>({kSmallTensorSize, kTensorSize})) {
+    duration = runBench(tensor_size, FLAGS_iter);
+    std::cout << "Time per iteration without callbacks ("
+              << tensor_size
+              << "x"
+              << tensor_size
+              << "): " << (duration/FLAGS_iter)
+              << " us." << std::endl;
+  }
+
+  setupBenchmarkCallbacks();
+
   for (auto tensor_size : std::set<int>({kSmallTensorSize, kTensorSize})) {
     duration = runBench(tensor_size, FLAGS_iter);
     std::cout << "Time per iteration ("
@@ -0,0 +1,260 @@
+#include <c10/core/AllocationPlanner.h>
+
+#include <algorithm>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+
+namespace c10 {
+
+namespace {
+thread_local AllocationPlanner* planner_ptr{nullptr};
+
+size_t aligned_size(size_t bytes) {
+  return (bytes + gAlignment - 1) / gAlignment * gAlignment;
+}
+} // namespace
+
+constexpr size_t AllocationPlanner::kMaxPlanners;
+constexpr size_t AllocationPlanner::kNotPlanned;
+std::atomic<AllocationPlanner*> AllocationPlanner::planners_[kMaxPlanners];
+std::atomic<size_t> AllocationPlanner::num_planners_{0};
+
+AllocationPlanner::AllocationPlanner() {
+  bool registered = false;
+  for (auto& slot : planners_) {
+    AllocationPlanner* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, this)) {
+      registered = true;
+      break;
+    }
+  }
+  TORCH_CHECK(
+      registered,
+      "at most ",
+      kMaxPlanners,
+      " allocation planners can exist at once");
+  num_planners_++;
+}
+
+AllocationPlanner::~AllocationPlanner() {
+  for (auto& slot : planners_) {
+    AllocationPlanner* expected = this;
+    if (slot.compare_exchange_strong(expected, nullptr)) {
+      num_planners_--;
+      break;
+    }
+  }
+  if (!live_.empty()) {
+    TORCH_WARN(
+        "AllocationPlanner destroyed with live allocations, freeing them "
+        "later is undefined behavior");
+  }
+  free_cpu(buffer_);
+}
+
+bool AllocationPlanner::has_plan() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !offsets_.empty();
+}
+
+void AllocationPlanner::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      !in_run_ && live_.empty(),
+      "cannot reset an allocation planner that is in use");
+  sizes_.clear();
+  freed_at_.clear();
+  offsets_.clear();
+  free_cpu(buffer_);
+  buffer_ = nullptr;
+  buffer_size_ = 0;
+  deviated_ = false;
+}
+
+AllocationPlannerStats AllocationPlanner::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AllocationPlannerStats stats;
+  stats.planned_bytes = buffer_size_;
+  for (size_t i = 0; i < offsets_.size(); i++) {
+    if (offsets_[i] != kNotPlanned) {
+      stats.unshared_bytes += aligned_size(sizes_[i]);
+      stats.planned_allocations++;
+    }
+  }
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.recorded_runs = recorded_runs_;
+  return stats;
+}
+
+void* AllocationPlanner::allocate(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!in_run_ || recording_) {
+    return nullptr;
+  }
+  const size_t index = next_++;
+  if (deviated_ || index >= sizes_.size() || sizes_[index] != bytes) {
+    deviated_ = true;
+    misses_++;
+    return nullptr;
+  }
+  const size_t offset = offsets_[index];
+  if (offset == kNotPlanned) {
+    return nullptr;
+  }
+  // The memory may still be used when this run frees its allocations later
+  // than the recorded one did, or kept planned memory from an earlier run.
+  const size_t size = aligned_size(bytes);
+  for (const auto& block : live_) {
+    if (offset < block.first + block.second && block.first < offset + size) {
+      deviated_ = true;
+      misses_++;
+      return nullptr;
+    }
+  }
+  live_.emplace(offset, size);
+  hits_++;
+  return buffer_ + offset;
+}
+
+void AllocationPlanner::record(void* ptr, size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!recording_ || ptr == nullptr) {
+    return;
+  }
+  recorded_[ptr] = sizes_.size();
+  sizes_.push_back(bytes);
+  freed_at_.push_back(kNotPlanned);
+}
+
+bool AllocationPlanner::release(void* ptr) {
+  if (num_planners_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  for (auto& slot : planners_) {
+    AllocationPlanner* planner = slot.load(std::memory_order_acquire);
+    if (planner != nullptr) {
+      std::lock_guard<std::mutex> lock(planner->mutex_);
+      if (planner->release_locked(ptr)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool AllocationPlanner::release_locked(void* ptr) {
+  auto* p = static_cast<char*>(ptr);
+  if (buffer_ != nullptr && p >= buffer_ && p < buffer_ + buffer_size_) {
+    auto it = live_.find(p - buffer_);
+    TORCH_INTERNAL_ASSERT(
+        it != live_.end(), "freeing ", ptr, " twice in an allocation planner");
+    live_.erase(it);
+    return true;
+  }
+  if (!recorded_.empty()) {
+    auto it = recorded_.find(ptr);
+    if (it != recorded_.end()) {
+      freed_at_[it->second] = sizes_.size();
+      recorded_.erase(it);
+    }
+  }
+  return false;
+}
+
+void AllocationPlanner::begin_run() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(!in_run_, "an allocation planner is used by one run at a time");
+  // Plans again after a run that deviated, once the old plan is unused
+  if (deviated_ && live_.empty()) {
+    sizes_.clear();
+    offsets_.clear();
+    free_cpu(buffer_);
+    buffer_ = nullptr;
+    buffer_size_ = 0;
+  }
+  in_run_ = true;
+  deviated_ = false;
+  next_ = 0;
+  recording_ = offsets_.empty() && live_.empty();
+  if (recording_) {
+    sizes_.clear();
+    freed_at_.clear();
+    recorded_.clear();
+    recorded_runs_++;
+  }
+}
+
+void AllocationPlanner::end_run() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_run_ = false;
+  if (recording_) {
+    recording_ = false;
+    // The allocations still live are left out of the plan
+    recorded_.clear();
+    make_plan();
+  }
+}
+
+void AllocationPlanner::make_plan() {
+  // Allocation i is live from the i-th allocation to the freed_at_[i]-th.
+  // The largest allocations are placed first, each at the lowest offset
+  // that no allocation it is live with already uses.
+  std::vector<size_t> order;
+  for (size_t i = 0; i < sizes_.size(); i++) {
+    if (freed_at_[i] != kNotPlanned) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return sizes_[a] > sizes_[b];
+  });
+
+  offsets_.assign(sizes_.size(), kNotPlanned);
+  buffer_size_ = 0;
+  std::vector<size_t> placed;
+  std::vector<std::pair<size_t, size_t>> conflicts;
+  for (size_t i : order) {
+    conflicts.clear();
+    for (size_t j : placed) {
+      if (i < freed_at_[j] && j < freed_at_[i]) {
+        conflicts.emplace_back(offsets_[j], aligned_size(sizes_[j]));
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    const size_t size = aligned_size(sizes_[i]);
+    size_t offset = 0;
+    for (const auto& conflict : conflicts) {
+      if (offset + size <= conflict.first) {
+        break;
+      }
+      offset = std::max(offset, conflict.first + conflict.second);
+    }
+    offsets_[i] = offset;
+    buffer_size_ = std::max(buffer_size_, offset + size);
+    placed.push_back(i);
+  }
+  freed_at_.clear();
+  buffer_ = buffer_size_ > 0 ? static_cast<char*>(alloc_cpu(buffer_size_))
+                             : nullptr;
+}
+
+AllocationPlanner* GetThreadLocalAllocationPlanner() {
+  return planner_ptr;
+}
+
+AllocationPlannerGuard::AllocationPlannerGuard(AllocationPlanner* planner)
+    : planner_(planner) {
+  TORCH_CHECK(planner_ != nullptr, "AllocationPlannerGuard needs a planner");
+  planner_->begin_run();
+  prev_planner_ = planner_ptr;
+  planner_ptr = planner_;
+}
+
+AllocationPlannerGuard::~AllocationPlannerGuard() {
+  planner_ptr = prev_planner_;
+  planner_->end_run();
+}
+
+} // namespace c10
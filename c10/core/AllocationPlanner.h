@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+struct AllocationPlannerStats {
+  // bytes of the buffer the planned allocations are served from
+  size_t planned_bytes = 0;
+  // sum of the sizes of the planned allocations, the memory they would take
+  // if none of them shared memory
+  size_t unshared_bytes = 0;
+  // allocations of a run that the plan covers
+  uint64_t planned_allocations = 0;
+  // allocations served from the plan, over all runs
+  uint64_t hits = 0;
+  // allocations that deviated from the plan and went to the regular allocator
+  uint64_t misses = 0;
+  // runs that were recorded to make a plan
+  uint64_t recorded_runs = 0;
+};
+
+class C10_API AllocationPlanner {
+  /*
+   * What it does:
+   * Plans the CPU memory of a workload that makes the same allocations on
+   * every run, like the inference of a model with fixed input shapes. The
+   * first run under an AllocationPlannerGuard is recorded: the size and
+   * lifetime of each allocation. At the end of that run the allocations
+   * that were freed during it get offsets in one buffer, so that
+   * allocations that are never live at the same time share memory, and the
+   * buffer is as large as the peak of live memory rather than the sum of all
+   * intermediates. Following runs serve the n-th allocation from its offset,
+   * without calling any allocator.
+   * What it does not do:
+   * Plan the allocations that outlive the recorded run, like its outputs,
+   * those always go to the regular allocator. An allocation whose size
+   * differs from the plan, or whose memory is still in use, goes to the
+   * regular allocator too, and the run after such a run is recorded again.
+   *
+   * Memory from the plan can be freed on any thread and after the guard is
+   * gone, but not after the planner is destroyed. One run at a time can use
+   * a planner.
+   */
+ public:
+  AllocationPlanner();
+  ~AllocationPlanner();
+
+  AllocationPlanner(const AllocationPlanner&) = delete;
+  AllocationPlanner& operator=(const AllocationPlanner&) = delete;
+
+  bool has_plan() const;
+  // Drops the plan, the next run is recorded again. The planner must not
+  // have live planned allocations.
+  void reset();
+  AllocationPlannerStats stats() const;
+
+  // Called by the CPU allocators for the allocations of the guarded thread.
+  // Returns the planned memory of the next allocation, or nullptr when the
+  // caller has to allocate it, and then report it with record.
+  void* allocate(size_t bytes);
+  void record(void* ptr, size_t bytes);
+  // Called by the CPU deleters for every pointer. Returns true if ptr came
+  // from the plan of a planner, and must not be freed by the caller. Cheap
+  // while no planner exists.
+  static bool release(void* ptr);
+
+ private:
+  friend class AllocationPlannerGuard;
+  static constexpr size_t kMaxPlanners = 64;
+  static constexpr size_t kNotPlanned = ~size_t{0};
+  static std::atomic<AllocationPlanner*> planners_[kMaxPlanners];
+  static std::atomic<size_t> num_planners_;
+
+  struct LiveBlock {
+    size_t offset;
+    size_t size;
+  };
+
+  void begin_run();
+  void end_run();
+  void make_plan();
+  bool release_locked(void* ptr);
+
+  mutable std::mutex mutex_;
+  bool in_run_ = false;
+  bool recording_ = false;
+  // set when a planned run deviated from the plan
+  bool deviated_ = false;
+  // the index of the next allocation of the current run
+  size_t next_ = 0;
+
+  // What the recorded run allocated, in order, and when it freed it, in
+  // units of allocations made so far. kNotPlanned if it did not free it.
+  std::vector<size_t> sizes_;
+  std::vector<size_t> freed_at_;
+  std::unordered_map<void*, size_t> recorded_;
+
+  // The plan, an offset in buffer_ for each of sizes_, or kNotPlanned
+  std::vector<size_t> offsets_;
+  char* buffer_ = nullptr;
+  size_t buffer_size_ = 0;
+  // Planned memory in use, keyed by offset
+  std::unordered_map<size_t, size_t> live_;
+
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t recorded_runs_ = 0;
+};
+
+// The planner allocations on this thread go through, or nullptr.
+C10_API AllocationPlanner* GetThreadLocalAllocationPlanner();
+
+/*
+ * Makes the default CPU allocator, mobile or not, serve the allocations of
+ * the current thread through a planner. Each guard scope is one run, the
+ * first one is recorded and the following ones use the plan.
+ *
+ * Usage pattern:
+ * c10::AllocationPlanner planner;
+ * for (auto& input : inputs) {
+ *   c10::AllocationPlannerGuard guard(&planner);
+ *   auto output = model.forward(input);
+ * }
+ */
+class C10_API AllocationPlannerGuard {
+ public:
+  explicit AllocationPlannerGuard(AllocationPlanner* planner);
+  ~AllocationPlannerGuard();
+
+  AllocationPlannerGuard(const AllocationPlannerGuard&) = delete;
+  AllocationPlannerGuard& operator=(const AllocationPlannerGuard&) = delete;
+
+ private:
+  AllocationPlanner* planner_;
+  AllocationPlanner* prev_planner_;
+};
+
+} // namespace c10
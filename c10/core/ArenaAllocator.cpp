@@ -0,0 +1,176 @@
+#include <c10/core/ArenaAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+
+namespace c10 {
+
+namespace {
+thread_local ArenaAllocator* cpu_arena_ptr{nullptr};
+thread_local ArenaAllocator* cuda_arena_ptr{nullptr};
+
+ArenaAllocator*& thread_local_arena(DeviceType device_type) {
+  TORCH_CHECK(
+      device_type == DeviceType::CPU || device_type == DeviceType::CUDA,
+      "arena allocators are only supported for CPU and CUDA, got ",
+      device_type);
+  return device_type == DeviceType::CPU ? cpu_arena_ptr : cuda_arena_ptr;
+}
+
+// Layout of ArenaAllocator::state_.
+constexpr int kOffsetBits = 40;
+constexpr uint64_t kOffsetMask = (uint64_t{1} << kOffsetBits) - 1;
+constexpr uint64_t kOneLive = uint64_t{1} << kOffsetBits;
+constexpr uint64_t kMaxLive = ~uint64_t{0} >> kOffsetBits;
+} // namespace
+
+constexpr size_t ArenaAllocator::kMaxArenas;
+std::atomic<ArenaAllocator*> ArenaAllocator::arenas_[kMaxArenas];
+std::atomic<size_t> ArenaAllocator::num_arenas_{0};
+
+ArenaAllocator::ArenaAllocator(at::Allocator* backing, size_t capacity)
+    : backing_(backing), device_(DeviceType::CPU) {
+  TORCH_CHECK(backing_ != nullptr, "ArenaAllocator needs a backing allocator");
+  allocate_buffer(capacity);
+  device_ = buffer_.device();
+  bool registered = false;
+  for (auto& slot : arenas_) {
+    ArenaAllocator* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, this)) {
+      registered = true;
+      break;
+    }
+  }
+  TORCH_CHECK(
+      registered, "at most ", kMaxArenas, " arena allocators can exist at once");
+  num_arenas_++;
+}
+
+ArenaAllocator::~ArenaAllocator() {
+  if ((state_.load() >> kOffsetBits) != 0) {
+    TORCH_WARN(
+        "ArenaAllocator destroyed with live allocations, freeing them later "
+        "is undefined behavior");
+  }
+  for (auto& slot : arenas_) {
+    ArenaAllocator* expected = this;
+    if (slot.compare_exchange_strong(expected, nullptr)) {
+      num_arenas_--;
+      break;
+    }
+  }
+}
+
+void* ArenaAllocator::allocate(size_t bytes) {
+  char* begin = begin_.load(std::memory_order_relaxed);
+  const size_t capacity = end_.load(std::memory_order_relaxed) - begin;
+  // Keeps every allocation aligned like alloc_cpu does.
+  const size_t size = (bytes + gAlignment - 1) / gAlignment * gAlignment;
+  uint64_t state = state_.load();
+  uint64_t offset;
+  do {
+    offset = state & kOffsetMask;
+    if (size > capacity - offset || (state >> kOffsetBits) == kMaxLive) {
+      overflows_++;
+      overflow_bytes_ += bytes;
+      return nullptr;
+    }
+  } while (!state_.compare_exchange_weak(state, state + kOneLive + size));
+  size_t peak = peak_bytes_.load();
+  while (offset + size > peak &&
+         !peak_bytes_.compare_exchange_weak(peak, offset + size)) {
+  }
+  allocations_++;
+  return begin + offset;
+}
+
+void ArenaAllocator::free(void* ptr) {
+  uint64_t state = state_.load();
+  uint64_t next;
+  do {
+    TORCH_INTERNAL_ASSERT(
+        (state >> kOffsetBits) != 0, "freeing ", ptr, " twice in an arena");
+    // The last free rewinds the arena.
+    next = (state >> kOffsetBits) == 1 ? 0 : state - kOneLive;
+  } while (!state_.compare_exchange_weak(state, next));
+  if (next == 0) {
+    rewinds_++;
+  }
+}
+
+void ArenaAllocator::allocate_buffer(size_t capacity) {
+  TORCH_CHECK(
+      capacity <= kOffsetMask, "arena capacity ", capacity, " is too large");
+  // Allocations routed here while the buffer is replaced do not fit, so
+  // they go to the regular allocator.
+  begin_ = nullptr;
+  end_ = nullptr;
+  buffer_.clear();
+  buffer_ = backing_->allocate(capacity);
+  state_ = 0;
+  begin_ = static_cast<char*>(buffer_.get());
+  end_ = static_cast<char*>(buffer_.get()) + (buffer_.get() ? capacity : 0);
+}
+
+void ArenaAllocator::resize(size_t capacity) {
+  TORCH_CHECK(
+      (state_.load() >> kOffsetBits) == 0,
+      "cannot resize an arena that has live allocations");
+  allocate_buffer(capacity);
+  TORCH_CHECK(
+      buffer_.device() == device_,
+      "cannot move an arena from ",
+      device_,
+      " to ",
+      buffer_.device());
+}
+
+ArenaAllocatorStats ArenaAllocator::stats() const {
+  ArenaAllocatorStats stats;
+  stats.capacity = end_.load() - begin_.load();
+  stats.used_bytes = state_.load() & kOffsetMask;
+  stats.peak_bytes = peak_bytes_;
+  stats.allocations = allocations_;
+  stats.overflows = overflows_;
+  stats.overflow_bytes = overflow_bytes_;
+  stats.rewinds = rewinds_;
+  return stats;
+}
+
+ArenaAllocator* ArenaAllocator::owner(const void* ptr) {
+  if (num_arenas_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  for (auto& slot : arenas_) {
+    ArenaAllocator* arena = slot.load(std::memory_order_acquire);
+    if (arena != nullptr && arena->contains(ptr)) {
+      return arena;
+    }
+  }
+  return nullptr;
+}
+
+ArenaAllocator* GetThreadLocalArenaAllocator(DeviceType device_type) {
+  switch (device_type) {
+    case DeviceType::CPU:
+      return cpu_arena_ptr;
+    case DeviceType::CUDA:
+      return cuda_arena_ptr;
+    default:
+      return nullptr;
+  }
+}
+
+ArenaAllocatorGuard::ArenaAllocatorGuard(ArenaAllocator* arena) {
+  TORCH_CHECK(arena != nullptr, "ArenaAllocatorGuard needs an arena");
+  device_type_ = arena->device().type();
+  auto& arena_ptr = thread_local_arena(device_type_);
+  prev_arena_ = arena_ptr;
+  arena_ptr = arena;
+}
+
+ArenaAllocatorGuard::~ArenaAllocatorGuard() {
+  thread_local_arena(device_type_) = prev_arena_;
+}
+
+} // namespace c10
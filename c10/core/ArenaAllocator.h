@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+struct ArenaAllocatorStats {
+  // bytes of the preallocated buffer
+  size_t capacity = 0;
+  // bytes handed out since the arena last rewound
+  size_t used_bytes = 0;
+  // largest used_bytes seen, a good capacity for the next arena
+  size_t peak_bytes = 0;
+  // allocations served from the arena
+  uint64_t allocations = 0;
+  // allocations that did not fit and went to the regular allocator
+  uint64_t overflows = 0;
+  uint64_t overflow_bytes = 0;
+  // times the arena became empty and started over at its beginning
+  uint64_t rewinds = 0;
+};
+
+class C10_API ArenaAllocator {
+  /*
+   * What it does:
+   * Hands out memory from one buffer that is preallocated with a backing
+   * allocator, by bumping an offset. Freeing only counts the allocation,
+   * once every allocation is freed the arena rewinds to the beginning of its
+   * buffer. A workload with fixed shapes thus runs from the same memory on
+   * every iteration without calling any allocator, and without any lock.
+   * Allocations that do not fit are left to the regular allocator, so an
+   * undersized arena stays correct, peak_bytes tells how large it should be.
+   * What it does not do:
+   * Reuse memory before the arena is empty. For CUDA, order work on the
+   * memory: a rewound buffer is reused right away, like the caching
+   * allocator reuses a block on its stream, so all work using an arena must
+   * run on a single stream or be synchronized before its tensors are freed.
+   *
+   * Allocations are routed into an arena by ArenaAllocatorGuard. Memory
+   * from an arena can be freed on any thread and after the guard is gone,
+   * but not after the arena is destroyed.
+   */
+ public:
+  // The buffer is allocated with backing, whose device is the device of the
+  // arena. It has to be the regular allocator of that device type.
+  ArenaAllocator(at::Allocator* backing, size_t capacity);
+  ~ArenaAllocator();
+
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+  // Returns nullptr if bytes do not fit, the caller allocates them elsewhere.
+  void* allocate(size_t bytes);
+  void free(void* ptr);
+  // Replaces the buffer, the arena must not have live allocations.
+  void resize(size_t capacity);
+
+  bool contains(const void* ptr) const {
+    auto* p = static_cast<const char*>(ptr);
+    return p >= begin_.load(std::memory_order_relaxed) &&
+        p < end_.load(std::memory_order_relaxed);
+  }
+  Device device() const {
+    return device_;
+  }
+  ArenaAllocatorStats stats() const;
+
+  // The arena ptr was allocated from, or nullptr. Cheap while no arena
+  // exists, so deleters call it on every free.
+  static ArenaAllocator* owner(const void* ptr);
+
+ private:
+  // Arenas in use, so that deleters can find the arena of a pointer that
+  // is freed outside of its guard.
+  static constexpr size_t kMaxArenas = 64;
+  static std::atomic<ArenaAllocator*> arenas_[kMaxArenas];
+  static std::atomic<size_t> num_arenas_;
+
+  void allocate_buffer(size_t capacity);
+
+  at::Allocator* const backing_;
+  at::DataPtr buffer_;
+  Device device_;
+  // Bounds of buffer_, empty while it is being replaced. Read by deleters
+  // on any thread.
+  std::atomic<char*> begin_{nullptr};
+  std::atomic<char*> end_{nullptr};
+  // The offset of the next allocation in the low bits and the number of
+  // live allocations in the high bits, updated together so that the last
+  // free can rewind the offset without a lock.
+  std::atomic<uint64_t> state_{0};
+  std::atomic<size_t> peak_bytes_{0};
+  std::atomic<uint64_t> allocations_{0};
+  std::atomic<uint64_t> overflows_{0};
+  std::atomic<uint64_t> overflow_bytes_{0};
+  std::atomic<uint64_t> rewinds_{0};
+};
+
+// The arena that allocations of device_type on this thread are routed to,
+// or nullptr.
+C10_API ArenaAllocator* GetThreadLocalArenaAllocator(DeviceType device_type);
+
+/*
+ * Makes the default CPU allocator, or the CUDA caching allocator when the
+ * arena is a CUDA one, serve the allocations of the current thread from an
+ * arena. For CUDA only allocations on the device of the arena are routed.
+ * Guards of different device types nest, so that one scope can route both.
+ *
+ * Usage pattern:
+ * c10::ArenaAllocator arena(c10::GetDefaultCPUAllocator(), 64 << 20);
+ * for (auto& request : requests) {
+ *   c10::ArenaAllocatorGuard guard(&arena);
+ *   ...
+ * }
+ */
+class C10_API ArenaAllocatorGuard {
+ public:
+  explicit ArenaAllocatorGuard(ArenaAllocator* arena);
+  ~ArenaAllocatorGuard();
+
+  ArenaAllocatorGuard(const ArenaAllocatorGuard&) = delete;
+  ArenaAllocatorGuard& operator=(const ArenaAllocatorGuard&) = delete;
+
+ private:
+  DeviceType device_type_;
+  ArenaAllocator* prev_arena_;
+};
+
+} // namespace c10
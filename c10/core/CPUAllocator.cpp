@@ -1,4 +1,6 @@
 #include <c10/core/CPUAllocator.h>
+#include <c10/core/AllocationPlanner.h>
+#include <c10/core/ArenaAllocator.h>
 #include <c10/core/CPUCachingAllocator.h>
 #include <c10/core/DeviceType.h>
 
@@ -72,8 +74,12 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+  // Place data on the NUMA node of the allocating thread. Fresh pages are
+  // only bound and get faulted in on that node; recycled ones are migrated.
+  // Threads keep to a node when the intra-op pool is pinned with
+  // at::set_intraop_numa_node, otherwise this is the node the thread
+  // happens to run on right now.
+  NUMAPlace(data, nbytes, GetCurrentNUMANode());
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -87,6 +93,31 @@ void* alloc_cpu(size_t nbytes) {
   return data;
 }
 
+namespace {
+thread_local CPUAllocationCounter* allocation_counter_ptr{nullptr};
+
+inline void count_allocation(size_t nbytes) {
+  if (C10_UNLIKELY(allocation_counter_ptr != nullptr)) {
+    allocation_counter_ptr->allocations++;
+    allocation_counter_ptr->bytes += nbytes;
+  }
+}
+} // namespace
+
+CPUAllocationCounter* GetThreadLocalCPUAllocationCounter() {
+  return allocation_counter_ptr;
+}
+
+CPUAllocationCounterGuard::CPUAllocationCounterGuard(
+    CPUAllocationCounter* counter)
+    : prev_counter_(allocation_counter_ptr) {
+  allocation_counter_ptr = counter;
+}
+
+CPUAllocationCounterGuard::~CPUAllocationCounterGuard() {
+  allocation_counter_ptr = prev_counter_;
+}
+
 void free_cpu(void* data) {
 #ifdef _MSC_VER
   _aligned_free(data);
@@ -99,7 +130,29 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
-    void* data = alloc_cpu(nbytes);
+    void* data = nullptr;
+    auto planner_ptr = GetThreadLocalAllocationPlanner();
+    if (planner_ptr != nullptr && nbytes > 0) {
+      data = planner_ptr->allocate(nbytes);
+    }
+    auto arena_ptr = GetThreadLocalArenaAllocator(DeviceType::CPU);
+    if (data == nullptr && arena_ptr != nullptr && nbytes > 0) {
+      data = arena_ptr->allocate(nbytes);
+    }
+    if (data == nullptr) {
+      auto allocator_ptr = GetThreadLocalCachingAllocator();
+      if (allocator_ptr != nullptr && nbytes > 0) {
+        data = allocator_ptr->allocate(nbytes);
+      } else {
+        data = alloc_cpu(nbytes);
+      }
+    }
+    if (planner_ptr != nullptr && nbytes > 0) {
+      planner_ptr->record(data, nbytes);
+    }
+    if (nbytes > 0) {
+      count_allocation(nbytes);
+    }
     profiledCPUMemoryReporter().New(data, nbytes);
     return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
   }
@@ -109,7 +162,22 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
       return;
     }
     profiledCPUMemoryReporter().Delete(ptr);
-    free_cpu(ptr);
+    if (AllocationPlanner::release(ptr)) {
+      return;
+    }
+    if (auto arena_ptr = ArenaAllocator::owner(ptr)) {
+      arena_ptr->free(ptr);
+      return;
+    }
+    auto allocator_ptr = GetThreadLocalCachingAllocator();
+    if (allocator_ptr != nullptr) {
+      allocator_ptr->free(ptr);
+    } else {
+      // Only looks the pointer up while some caching allocator holds memory.
+      // Done first, as the address may be handed out again once freed.
+      CPUCachingAllocator::record_free(ptr);
+      free_cpu(ptr);
+    }
   }
 
   at::DeleterFnPtr raw_deleter() const override {
@@ -155,14 +223,21 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
     }
     // TODO: enable with better TLS support on mobile
     // profiledCPUMemoryReporter().Delete(pointer);
+    if (AllocationPlanner::release(pointer)) {
+      return;
+    }
+    if (auto arena_ptr = ArenaAllocator::owner(pointer)) {
+      arena_ptr->free(pointer);
+      return;
+    }
     auto allocator_ptr = GetThreadLocalCachingAllocator();
     if (allocator_ptr != nullptr) {
       allocator_ptr->free(pointer);
     } else {
-      c10::free_cpu(pointer);
       // This adds extra cost to freeing memory to the default case when
       // caching allocator is not enabled.
       CPUCachingAllocator::record_free(pointer);
+      c10::free_cpu(pointer);
     }
   }
 
@@ -177,13 +252,27 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
     }
 
     auto alloc_size = PreGuardBytes + nbytes + PostGuardBytes;
-    void* data;
-    auto allocator_ptr = GetThreadLocalCachingAllocator();
-    if (allocator_ptr != nullptr) {
-      data = allocator_ptr->allocate(alloc_size);
-    } else {
-      data = c10::alloc_cpu(alloc_size);
+    void* data = nullptr;
+    auto planner_ptr = GetThreadLocalAllocationPlanner();
+    if (planner_ptr != nullptr) {
+      data = planner_ptr->allocate(alloc_size);
+    }
+    auto arena_ptr = GetThreadLocalArenaAllocator(DeviceType::CPU);
+    if (data == nullptr && arena_ptr != nullptr) {
+      data = arena_ptr->allocate(alloc_size);
+    }
+    if (data == nullptr) {
+      auto allocator_ptr = GetThreadLocalCachingAllocator();
+      if (allocator_ptr != nullptr) {
+        data = allocator_ptr->allocate(alloc_size);
+      } else {
+        data = c10::alloc_cpu(alloc_size);
+      }
+    }
+    if (planner_ptr != nullptr) {
+      planner_ptr->record(data, alloc_size);
     }
+    count_allocation(nbytes);
     //  profiledCPUMemoryReporter().New(data, alloc_size);
     return {
         reinterpret_cast<uint8_t*>(data) + PreGuardBytes,
@@ -53,6 +53,35 @@ class C10_API ProfiledCPUMemoryReporter {
 
 C10_API ProfiledCPUMemoryReporter& profiledCPUMemoryReporter();
 
+// Allocations made through the default CPU allocators, mobile or not, on one
+// thread while a CPUAllocationCounterGuard is alive
+struct CPUAllocationCounter {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+
+// The counter of this thread, or nullptr
+C10_API CPUAllocationCounter* GetThreadLocalCPUAllocationCounter();
+
+/*
+ * Counts the CPU allocations of the current thread into counter, for as long
+ * as the guard lives. Only the latest guard counts, the counter of an
+ * enclosing guard is restored once it is destroyed. Costs one thread local
+ * load per allocation while no guard is alive.
+ */
+class C10_API CPUAllocationCounterGuard {
+ public:
+  explicit CPUAllocationCounterGuard(CPUAllocationCounter* counter);
+  ~CPUAllocationCounterGuard();
+
+  CPUAllocationCounterGuard(const CPUAllocationCounterGuard&) = delete;
+  CPUAllocationCounterGuard& operator=(const CPUAllocationCounterGuard&) =
+      delete;
+
+ private:
+  CPUAllocationCounter* prev_counter_;
+};
+
 // Get the CPU Allocator.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
@@ -1,13 +1,55 @@
 #include <c10/core/CPUCachingAllocator.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <functional>
 
 namespace c10 {
 
 namespace {
 thread_local CPUCachingAllocator* caching_allocator_ptr{nullptr};
+
+// Smallest size class, requests below it share one class.
+constexpr size_t kMinBlockSize = 64;
+
+std::atomic<size_t> next_thread_cache{0};
 } // namespace
 
-std::mutex CPUCachingAllocator::mutex_;
-ska::flat_hash_map<void*, size_t> CPUCachingAllocator::allocation_map_;
+constexpr size_t CPUCachingAllocator::kNumThreadCaches;
+constexpr size_t CPUCachingAllocator::kMaxThreadCacheBlocks;
+constexpr size_t CPUCachingAllocator::kNumAllocationShards;
+
+CPUCachingAllocator::AllocationShard
+    CPUCachingAllocator::allocation_shards_[kNumAllocationShards];
+std::atomic<size_t> CPUCachingAllocator::num_allocations_{0};
+
+CPUCachingAllocator::CPUCachingAllocator(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes) {}
+
+CPUCachingAllocator::AllocationShard& CPUCachingAllocator::allocation_shard(
+    void* ptr) {
+  // The low bits are zero because of alignment.
+  const size_t h = std::hash<void*>{}(ptr) / gAlignment;
+  return allocation_shards_[h % kNumAllocationShards];
+}
+
+size_t CPUCachingAllocator::round_size(size_t bytes) {
+  // Four size classes per power of two, so at most a quarter of a block is
+  // wasted.
+  if (bytes <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  const size_t step =
+      std::max<size_t>(llvm::PowerOf2Floor(bytes - 1) / 4, kMinBlockSize);
+  return (bytes + step - 1) / step * step;
+}
+
+CPUCachingAllocator::ThreadCache& CPUCachingAllocator::thread_cache() {
+  // Threads are handed out free lists round robin, so as long as there are
+  // fewer threads than free lists every thread has one of its own.
+  thread_local const size_t index =
+      next_thread_cache.fetch_add(1, std::memory_order_relaxed);
+  return thread_caches_[index % kNumThreadCaches];
+}
 
 inline void* CPUCachingAllocator::allocate_and_cache(const size_t bytes) {
   void* ptr;
@@ -16,44 +58,86 @@ inline void* CPUCachingAllocator::allocate_and_cache(const size_t bytes) {
   } catch (c10::Error& e) {
     // If allocation fails, try freeing cached available blocks.
     // For now free all available cached blocks.
-    free_cached();
+    trim();
     // Furthermore to consider: If we ever come here running out of memory
     // perhaps it is best to disable caching, since this is likely to happen
     // again.
     // Try again.
     ptr = c10::alloc_cpu(bytes);
   }
-  allocation_map_[ptr] = bytes;
+  auto& shard = allocation_shard(ptr);
+  {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    shard.allocation_map[ptr] = bytes;
+  }
+  num_allocations_++;
   return ptr;
 }
 
-void* CPUCachingAllocator::allocate(const size_t bytes) {
-  std::lock_guard<std::mutex> guard(mutex_);
-  const auto& it = available_map_.find(bytes);
-  if (it == available_map_.end() || it->second.empty()) {
-    return allocate_and_cache(bytes);
+void* CPUCachingAllocator::pop(FreeLists& free_lists, const size_t bytes) {
+  const auto& it = free_lists.find(bytes);
+  if (it == free_lists.end() || it->second.empty()) {
+    return nullptr;
   }
+  cached_bytes_ -= bytes;
   return it->second.pop_back_val();
 }
 
+void* CPUCachingAllocator::allocate(const size_t bytes) {
+  const size_t size = round_size(bytes);
+  void* ptr;
+  {
+    auto& cache = thread_cache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    ptr = pop(cache.free_lists, size);
+  }
+  if (!ptr) {
+    std::lock_guard<std::mutex> guard(shared_mutex_);
+    ptr = pop(shared_free_lists_, size);
+  }
+  if (ptr) {
+    hits_++;
+    return ptr;
+  }
+  misses_++;
+  return allocate_and_cache(size);
+}
+
 void CPUCachingAllocator::free(void* ptr) {
   // NB: since we are not really freeing the memory
   // the cases such as quantization code freeing original weights
   // on mobile, will not quite work, as we likely will hold
-  // onto that memory.
-  // NB: We can also enable max memory cached for better memory
-  // management such that free will actually free the memory if
-  // we are nearing or above the watermark.
-  std::lock_guard<std::mutex> guard(mutex_);
-  // If this allocation was done before caching allocator was enabled
-  // then free regularly
-  const auto& it = allocation_map_.find(ptr);
-  if (it == allocation_map_.end()) {
-    c10::free_cpu(ptr);
+  // onto that memory, up to max_cached_bytes.
+  size_t alloc_size;
+  {
+    auto& shard = allocation_shard(ptr);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    // If this allocation was done before caching allocator was enabled
+    // then free regularly
+    const auto& it = shard.allocation_map.find(ptr);
+    if (it == shard.allocation_map.end()) {
+      c10::free_cpu(ptr);
+      return;
+    }
+    alloc_size = it->second;
+  }
+  // Blocks that would overflow the cache go back to the OS.
+  if (cached_bytes_.fetch_add(alloc_size) + alloc_size > max_cached_bytes_) {
+    cached_bytes_ -= alloc_size;
+    release(ptr);
     return;
   }
-  const size_t alloc_size = it->second;
-  available_map_[alloc_size].push_back(ptr);
+  {
+    auto& cache = thread_cache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    auto& blocks = cache.free_lists[alloc_size];
+    if (blocks.size() < kMaxThreadCacheBlocks) {
+      blocks.push_back(ptr);
+      return;
+    }
+  }
+  std::lock_guard<std::mutex> guard(shared_mutex_);
+  shared_free_lists_[alloc_size].push_back(ptr);
 }
 
 void CPUCachingAllocator::record_free(void* ptr) {
@@ -66,27 +150,75 @@ void CPUCachingAllocator::record_free(void* ptr) {
   // If the memory is freed in some other way, then we will likely
   // have undefined behavior or page fault. But this can be
   // the case without caching allocator as well.
-  std::lock_guard<std::mutex> guard(mutex_);
-  const auto& it = allocation_map_.find(ptr);
-  if (it != allocation_map_.end()) {
-    allocation_map_.erase(it);
+  if (num_allocations_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  auto& shard = allocation_shard(ptr);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  const auto& it = shard.allocation_map.find(ptr);
+  if (it != shard.allocation_map.end()) {
+    shard.allocation_map.erase(it);
+    num_allocations_--;
   }
 }
 
-void CPUCachingAllocator::free_cached() {
-  for (const auto& it : available_map_) {
-    for (const auto ptr : it.second) {
-      c10::free_cpu(ptr);
-      // When cached memory is return to OS, it must be removed
-      // from allocation_map.
-      allocation_map_.erase(ptr);
+void CPUCachingAllocator::release(void* ptr) {
+  // When cached memory is return to OS, it must be removed
+  // from allocation_map. This happens first, once freed the address may
+  // be handed out and recorded again.
+  {
+    auto& shard = allocation_shard(ptr);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    if (shard.allocation_map.erase(ptr)) {
+      num_allocations_--;
+    }
+  }
+  c10::free_cpu(ptr);
+}
+
+void CPUCachingAllocator::trim_free_lists(
+    FreeLists& free_lists,
+    size_t target_bytes) {
+  for (auto& it : free_lists) {
+    auto& blocks = it.second;
+    while (!blocks.empty() && cached_bytes_ > target_bytes) {
+      release(blocks.pop_back_val());
+      cached_bytes_ -= it.first;
     }
   }
-  available_map_.clear();
+}
+
+void CPUCachingAllocator::trim(size_t target_bytes) {
+  // The shared store holds the overflow of all threads, so it goes first.
+  {
+    std::lock_guard<std::mutex> guard(shared_mutex_);
+    trim_free_lists(shared_free_lists_, target_bytes);
+  }
+  for (auto& cache : thread_caches_) {
+    if (cached_bytes_ <= target_bytes) {
+      break;
+    }
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    trim_free_lists(cache.free_lists, target_bytes);
+  }
+}
+
+void CPUCachingAllocator::set_max_cached_bytes(size_t max_cached_bytes) {
+  max_cached_bytes_ = max_cached_bytes;
+  trim(max_cached_bytes);
+}
+
+CPUCachingAllocatorStats CPUCachingAllocator::stats() const {
+  CPUCachingAllocatorStats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.cached_bytes = cached_bytes_;
+  stats.max_cached_bytes = max_cached_bytes_;
+  return stats;
 }
 
 CPUCachingAllocator::~CPUCachingAllocator() {
-  free_cached();
+  trim();
 }
 
 CPUCachingAllocator* GetThreadLocalCachingAllocator() {
@@ -95,8 +227,8 @@ CPUCachingAllocator* GetThreadLocalCachingAllocator() {
 
 WithCPUCachingAllocatorGuard::WithCPUCachingAllocatorGuard(
     CPUCachingAllocator* allocator) {
-  caching_allocator_ptr = allocator;
   prev_caching_allocator_ptr_ = GetThreadLocalCachingAllocator();
+  caching_allocator_ptr = allocator;
 }
 
 WithCPUCachingAllocatorGuard::~WithCPUCachingAllocatorGuard() {
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <mutex>
 
@@ -12,49 +14,107 @@
 
 namespace c10 {
 
+struct CPUCachingAllocatorStats {
+  // allocations served from the cache
+  uint64_t hits = 0;
+  // allocations that went to alloc_cpu
+  uint64_t misses = 0;
+  // bytes held by the cache, ready for reuse
+  size_t cached_bytes = 0;
+  // limit on cached_bytes, see set_max_cached_bytes
+  size_t max_cached_bytes = 0;
+};
+
 class C10_API CPUCachingAllocator {
   /*
    * What it does:
    * Caches all the allocations carried out by this allocator.
-   * Cache key is the size of the allocation.
-   * If requested size is found in the cache returns the cached pointer.
+   * Requested sizes are rounded up to a size class, which is the cache key,
+   * so that requests of slightly different sizes share cached memory.
+   * If a block of the size class is found in the cache returns the cached
+   * pointer.
+   * Freed blocks go to a small per-thread free list first and to a shared
+   * store once that is full, so threads running inference on the same
+   * allocator rarely contend.
+   * The cache holds at most max_cached_bytes, blocks freed beyond that are
+   * returned to the OS.
    * What it does not do:
    * No speculative allocation for any future allocations.
    */
   private:
+    using FreeLists = ska::flat_hash_map<size_t, c10::SmallVector<void*, 16>>;
+    struct ThreadCache {
+      std::mutex mutex;
+      FreeLists free_lists;
+    };
+    struct AllocationShard {
+      std::mutex mutex;
+      ska::flat_hash_map<void*, size_t> allocation_map;
+    };
+    // Threads are spread over this many free lists. Each is only guarded by
+    // its own mutex, which is uncontended unless more threads than this
+    // share the allocator.
+    static constexpr size_t kNumThreadCaches = 16;
+    // Blocks of one size class a thread cache keeps before overflowing to
+    // the shared store.
+    static constexpr size_t kMaxThreadCacheBlocks = 8;
+    static constexpr size_t kNumAllocationShards = 16;
+
     // Invariants.
     // 1. If memory is ever allocated via this allocator then
-    //    the pointer will exist in allocation_map_, unless the allocator
-    //    returned the memory to OS via free_cached.
+    //    the pointer will exist in allocation_map, unless the allocator
+    //    returned the memory to OS via trim or a full cache.
     //  1.1. Therefore even when the said memory is "freed" via this
     //       allocator (and thus cached), it will continue to stay
-    //       in allocaiton_map_. Furthermore it will also exist in
-    //       available_map_. Thus an allocated memory pointer can be in both
-    //       allocation_map_ and available_map_ simultaneously.
-    // 2. Memory pointer maybe removed from allocation_map_, when it
+    //       in allocation_map. Furthermore it will also exist in
+    //       one free list. Thus an allocated memory pointer can be in both
+    //       allocation_map and a free list simultaneously.
+    // 2. Memory pointer maybe removed from allocation_map, when it
     //    is freed outside of the scope of this allocator, but was allocated
     //    by this allocator.
-    // 3. Available map only contains that memory which was allocated
+    // 3. Free lists only contain memory which was allocated
     //    by this allocator and subsequently freed by this allocator.
     // As a result of above invariants, allocated memory ptr cannot be in
-    // available_map_ unless it is in allocation_map_ as well.
-    ska::flat_hash_map<size_t, c10::SmallVector<void*, 16>> available_map_;
-    static ska::flat_hash_map<void*, size_t> allocation_map_;
-    // Since allocation_map, which is a global instance, is mutated/read via
-    // all public APIs we need a global mutex.
-    static std::mutex mutex_;
+    // a free list unless it is in allocation_map as well.
+    // allocation_map maps a pointer to its size class. It is global, since
+    // memory can be freed by another allocator or by none, and sharded by
+    // pointer so that frees on different threads do not serialize.
+    static AllocationShard allocation_shards_[kNumAllocationShards];
+    // Number of pointers in all allocation maps, lets record_free skip the
+    // lookup while no caching allocator is in use.
+    static std::atomic<size_t> num_allocations_;
+    ThreadCache thread_caches_[kNumThreadCaches];
+    std::mutex shared_mutex_;
+    FreeLists shared_free_lists_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<size_t> cached_bytes_{0};
+    std::atomic<size_t> max_cached_bytes_;
+
+    static AllocationShard& allocation_shard(void* ptr);
+    static size_t round_size(size_t bytes);
+    ThreadCache& thread_cache();
     inline void* allocate_and_cache(const size_t bytes);
-    void free_cached();
+    void* pop(FreeLists& free_lists, const size_t bytes);
+    void release(void* ptr);
+    void trim_free_lists(FreeLists& free_lists, size_t target_bytes);
   public:
+    explicit CPUCachingAllocator(
+        size_t max_cached_bytes = std::numeric_limits<size_t>::max());
     static void record_free(void* ptr);
-    // Checks the cache to see if allocation of size bytes can be found.
-    // If so return cached memory, else
+    // Checks the cache to see if a block of the size class of bytes can be
+    // found. If so return cached memory, else
     // allocates memory, records it for caching and returns.
     void* allocate(const size_t bytes);
     // Checks if the memory being freed is was marked for allocation by
-    // an earlier call to allocate. If so cache the allocation.
-    // Otherwise free.
+    // an earlier call to allocate. If so cache the allocation, unless the
+    // cache is full. Otherwise free.
     void free(void* ptr);
+    // Returns cached memory to the OS until at most target_bytes stay cached.
+    void trim(size_t target_bytes = 0);
+    // Limits the memory the cache holds, trimming it if it holds more.
+    void set_max_cached_bytes(size_t max_cached_bytes);
+    CPUCachingAllocatorStats stats() const;
     // Mainly for testing
     ~CPUCachingAllocator();
 };
@@ -62,9 +122,13 @@ class C10_API CPUCachingAllocator {
 CPUCachingAllocator* GetDefaultCPUCachingAllocator();
 
 bool ThreadLocalCachingAllocatorEnabled();
-CPUCachingAllocator* GetThreadLocalCachingAllocator();
+C10_API CPUCachingAllocator* GetThreadLocalCachingAllocator();
 
 /*
+ * Makes the default CPU allocator, mobile or not, serve the allocations of
+ * the current thread from a caching allocator. One allocator can be shared
+ * by the guards of several threads, e.g. the threads of an inference server.
+ *
  * Usage pattern:
  * std::unique_ptr<c10::CPUCachingAllocator> caching_allocator =
  *   std::make_unique<c10::CPUCachingAllocator>();
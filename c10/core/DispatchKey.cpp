@@ -77,6 +77,8 @@ const char* toString(DispatchKey t) {
     case DispatchKey::AutogradXLA:
       return "AutogradXLA";
 
+    case DispatchKey::AutocastCPU:
+      return "AutocastCPU";
     case DispatchKey::Autocast:
       return "Autocast";
 
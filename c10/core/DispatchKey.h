@@ -206,6 +206,9 @@ enum class DispatchKey : uint8_t {
 
   // Autocasting precedes VariableTypeId, to ensure casts are autograd-exposed
   // and inputs are saved for backward in the post-autocast type.
+  // AutocastCPU handles the CPU tensors (in bfloat16), Autocast the CUDA ones
+  // (in float16).
+  AutocastCPU,
   Autocast,
 
   // Here are some reserved pre-autograd keys for user-defined backends, see
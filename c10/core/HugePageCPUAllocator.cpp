@@ -0,0 +1,164 @@
+#include <c10/core/HugePageCPUAllocator.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <c10/core/CPUAllocator.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define C10_HUGE_PAGES_AVAILABLE
+#endif
+
+namespace c10 {
+
+struct HugePageCPUAllocator::Allocation {
+  void* ptr;
+  size_t size;
+  // from mmap(MAP_HUGETLB) rather than posix_memalign
+  bool mapped;
+  const HugePageCPUAllocator* owner;
+};
+
+constexpr size_t HugePageCPUAllocator::kHugePageSize;
+
+HugePageCPUAllocator::HugePageCPUAllocator(Mode mode, size_t threshold)
+    : mode_(mode), threshold_(std::max(threshold, kHugePageSize)) {}
+
+HugePageCPUAllocator::Allocation* HugePageCPUAllocator::allocate_huge(
+    size_t nbytes) const {
+#ifdef C10_HUGE_PAGES_AVAILABLE
+  if (mode_ == Mode::kExplicit) {
+    const size_t size = (nbytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void* ptr = mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+    if (ptr != MAP_FAILED) {
+      explicit_bytes_ += size;
+      return new Allocation{ptr, size, true, this};
+    }
+    // The pool has no free huge pages left (or none reserved).
+    explicit_fallbacks_++;
+  }
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, kHugePageSize, nbytes) != 0) {
+    return nullptr;
+  }
+  // The range stays usable when THP is disabled, it is just not backed by
+  // huge pages then.
+  madvise(ptr, nbytes, MADV_HUGEPAGE);
+  transparent_bytes_ += nbytes;
+  return new Allocation{ptr, nbytes, false, this};
+#else
+  return nullptr;
+#endif
+}
+
+at::DataPtr HugePageCPUAllocator::allocate(size_t nbytes) const {
+  Allocation* allocation = nbytes >= threshold_ ? allocate_huge(nbytes) : nullptr;
+  if (allocation == nullptr) {
+    return GetDefaultCPUAllocator()->allocate(nbytes);
+  }
+  void* data = allocation->ptr;
+  // Pages are only touched below, so they get placed like alloc_cpu does.
+  NUMAPlace(data, allocation->size, GetCurrentNUMANode());
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill && !allocation->mapped) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+  profiledCPUMemoryReporter().New(data, nbytes);
+  return {data, allocation, &Delete, at::Device(at::DeviceType::CPU)};
+}
+
+void HugePageCPUAllocator::Delete(void* ctx) {
+  auto* allocation = static_cast<Allocation*>(ctx);
+  profiledCPUMemoryReporter().Delete(allocation->ptr);
+#ifdef C10_HUGE_PAGES_AVAILABLE
+  if (allocation->mapped) {
+    munmap(allocation->ptr, allocation->size);
+    allocation->owner->explicit_bytes_ -= allocation->size;
+  } else {
+    free(allocation->ptr);
+    allocation->owner->transparent_bytes_ -= allocation->size;
+  }
+#endif
+  delete allocation;
+}
+
+at::DeleterFnPtr HugePageCPUAllocator::raw_deleter() const {
+  // Small allocations carry the deleter of the default allocator.
+  return nullptr;
+}
+
+HugePageCPUAllocator::Stats HugePageCPUAllocator::stats() const {
+  Stats stats;
+  stats.explicit_bytes = explicit_bytes_;
+  stats.transparent_bytes = transparent_bytes_;
+  stats.explicit_fallbacks = explicit_fallbacks_;
+  return stats;
+}
+
+namespace {
+
+// This runs during static initialization, where c10 logging and warnings
+// are not safe to use yet.
+HugePageCPUAllocator* create_huge_page_allocator_from_env() {
+  const char* mode = std::getenv("PYTORCH_CPU_HUGE_PAGES");
+  if (mode == nullptr || strcmp(mode, "") == 0 || strcmp(mode, "0") == 0) {
+    return nullptr;
+  }
+  HugePageCPUAllocator::Mode parsed;
+  if (strcmp(mode, "transparent") == 0 || strcmp(mode, "1") == 0) {
+    parsed = HugePageCPUAllocator::Mode::kTransparent;
+  } else if (strcmp(mode, "explicit") == 0) {
+    parsed = HugePageCPUAllocator::Mode::kExplicit;
+  } else {
+    std::cerr << "Ignoring invalid PYTORCH_CPU_HUGE_PAGES value " << mode
+              << ", expected transparent or explicit" << std::endl;
+    return nullptr;
+  }
+  size_t threshold = 2 * HugePageCPUAllocator::kHugePageSize;
+  if (const char* min_mb = std::getenv("PYTORCH_CPU_HUGE_PAGES_MIN_MB")) {
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(min_mb, &end, 10);
+    if (end != min_mb && *end == '\0') {
+      threshold = static_cast<size_t>(value) * 1024 * 1024;
+    } else {
+      std::cerr << "Ignoring invalid PYTORCH_CPU_HUGE_PAGES_MIN_MB value "
+                << min_mb << std::endl;
+    }
+  }
+  // Never freed: tensors may outlive any static destructor.
+  return new HugePageCPUAllocator(parsed, threshold);
+}
+
+} // namespace
+
+HugePageCPUAllocator* GetHugePageCPUAllocator() {
+  static HugePageCPUAllocator* allocator = create_huge_page_allocator_from_env();
+  return allocator;
+}
+
+namespace {
+
+struct RegisterHugePageCPUAllocator {
+  RegisterHugePageCPUAllocator() {
+    if (auto* allocator = GetHugePageCPUAllocator()) {
+      // Above the default CPU allocator, which may register after us.
+      SetCPUAllocator(allocator, /*priority=*/1);
+    }
+  }
+};
+
+static RegisterHugePageCPUAllocator g_register_huge_page_cpu_allocator;
+
+} // namespace
+
+} // namespace c10
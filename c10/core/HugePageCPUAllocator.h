@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+/*
+ * A CPU allocator that backs large allocations with 2 MB huge pages, so that
+ * big weight and activation buffers need far fewer TLB entries. Allocations
+ * below the threshold are served like the default CPU allocator does.
+ *
+ * kTransparent aligns large allocations to 2 MB and marks them with
+ * madvise(MADV_HUGEPAGE), which lets transparent huge pages back them even
+ * when THP is set to "madvise" only. kExplicit maps them from the hugetlbfs
+ * pool with mmap(MAP_HUGETLB), rounding the size up to 2 MB, and falls back
+ * to kTransparent when the pool is exhausted.
+ *
+ * Setting PYTORCH_CPU_HUGE_PAGES to "transparent" or "explicit" installs
+ * this allocator as the CPU allocator at startup. The threshold defaults to
+ * 4 MB and can be changed with PYTORCH_CPU_HUGE_PAGES_MIN_MB. Huge pages are
+ * only available on Linux, elsewhere every allocation takes the default
+ * path. An allocator has to outlive the memory it hands out.
+ */
+class C10_API HugePageCPUAllocator final : public at::Allocator {
+ public:
+  enum class Mode { kTransparent, kExplicit };
+
+  static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+  struct Stats {
+    // Bytes currently mapped from the hugetlbfs pool.
+    size_t explicit_bytes = 0;
+    // Bytes currently advised for transparent huge pages. Whether the kernel
+    // actually backs them shows in AnonHugePages of /proc/self/smaps.
+    size_t transparent_bytes = 0;
+    // Explicit requests that fell back to transparent huge pages.
+    uint64_t explicit_fallbacks = 0;
+  };
+
+  explicit HugePageCPUAllocator(
+      Mode mode = Mode::kTransparent,
+      size_t threshold = 2 * kHugePageSize);
+
+  at::DataPtr allocate(size_t nbytes) const override;
+  at::DeleterFnPtr raw_deleter() const override;
+
+  Mode mode() const {
+    return mode_;
+  }
+  size_t threshold() const {
+    return threshold_;
+  }
+  Stats stats() const;
+
+ private:
+  struct Allocation;
+  static void Delete(void* ctx);
+  Allocation* allocate_huge(size_t nbytes) const;
+
+  const Mode mode_;
+  const size_t threshold_;
+  mutable std::atomic<size_t> explicit_bytes_{0};
+  mutable std::atomic<size_t> transparent_bytes_{0};
+  mutable std::atomic<uint64_t> explicit_fallbacks_{0};
+};
+
+// Returns the allocator configured by PYTORCH_CPU_HUGE_PAGES, or nullptr if
+// the variable is not set. It is already the CPU allocator in that case.
+C10_API HugePageCPUAllocator* GetHugePageCPUAllocator();
+
+} // namespace c10
@@ -56,7 +56,6 @@ TensorImpl::TensorImpl(DispatchKeySet key_set, const caffe2::TypeMeta& data_type
 TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::TypeMeta& data_type,
                        c10::optional<c10::Device> device_opt)
     : storage_(std::move(storage)),
-      sizes_{0},
       storage_offset_(0),
       numel_(0),
       data_type_(data_type),
@@ -70,26 +69,28 @@ TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::
   }
   // we would also like to check that non-cpu devices have an index, but some Caffe2 operators create
   // Storages with default devices.
-  strides_.push_back(1);
+  init_bitfields();
 }
 
 IntArrayRef TensorImpl::sizes() const {
-  return sizes_;
+  return sizes_and_strides_.sizes_arrayref();
 }
 
 IntArrayRef TensorImpl::strides() const {
-  return strides_;
+  return sizes_and_strides_.strides_arrayref();
 }
 
 bool TensorImpl::compute_contiguous() const {
   bool is_contiguous = true;
   if (is_empty())
     return is_contiguous;
+  const auto sizes = sizes_and_strides_.sizes_arrayref();
+  const auto strides = sizes_and_strides_.strides_arrayref();
   int64_t z = 1;
   for (int64_t d = dim() - 1; d >= 0; d--) {
-    if (sizes_[d] != 1) {
-      if (strides_[d] == z) {
-        z *= sizes_[d];
+    if (sizes[d] != 1) {
+      if (strides[d] == z) {
+        z *= sizes[d];
       } else {
         is_contiguous = false;
         break;
@@ -100,18 +101,20 @@ bool TensorImpl::compute_contiguous() const {
 }
 
 bool TensorImpl::compute_channels_last_contiguous_2d() const {
+  const auto sizes = sizes_and_strides_.sizes_arrayref();
+  const auto strides = sizes_and_strides_.strides_arrayref();
   // Please don't combine these code, constant array is used here to let
   // compiler fully unroll the loop to get better performance
-  switch (sizes_.size()) {
+  switch (sizes.size()) {
     case 4:
       {
         int64_t expected = 1;
         for (auto& d : {1, 3, 2, 0}) {
-          if (sizes_[d] != 1) {
-            if (strides_[d] != expected) {
+          if (sizes[d] != 1) {
+            if (strides[d] != expected) {
               return false;
             }
-            expected *= sizes_[d];
+            expected *= sizes[d];
           }
         }
         return true;
@@ -125,18 +128,20 @@ bool TensorImpl::compute_channels_last_contiguous_2d() const {
 }
 
 bool TensorImpl::compute_channels_last_contiguous_3d() const {
+  const auto sizes = sizes_and_strides_.sizes_arrayref();
+  const auto strides = sizes_and_strides_.strides_arrayref();
   // Please don't combine these code, constant array is used here to let
   // compiler fully unroll the loop to get better performance
-  switch (sizes_.size()) {
+  switch (sizes.size()) {
     case 5:
       {
         int64_t expected = 1;
         for (auto& d : {1, 4, 3, 2, 0}) {
-          if (sizes_[d] != 1) {
-            if (strides_[d] != expected) {
+          if (sizes[d] != 1) {
+            if (strides[d] != expected) {
               return false;
             }
-            expected *= sizes_[d];
+            expected *= sizes[d];
           }
         }
         return true;
@@ -150,16 +155,20 @@ bool TensorImpl::compute_channels_last_contiguous_3d() const {
 }
 
 bool TensorImpl::compute_strides_like_channels_last_2d() const {
-  return is_channels_last_strides_2d(sizes_, strides_);
+  return is_channels_last_strides_2d(
+      sizes_and_strides_.sizes_arrayref(), sizes_and_strides_.strides_arrayref());
 }
 
 bool TensorImpl::compute_strides_like_channels_last_3d() const {
-  return is_channels_last_strides_3d(sizes_, strides_);
+  return is_channels_last_strides_3d(
+      sizes_and_strides_.sizes_arrayref(), sizes_and_strides_.strides_arrayref());
 }
 
 bool TensorImpl::compute_non_overlapping_and_dense() const {
+  const auto sizes = sizes_and_strides_.sizes_arrayref();
+  const auto strides = sizes_and_strides_.strides_arrayref();
   if (dim() == 1) {
-    return sizes_[0] < 2 || strides_[0] == 1;
+    return sizes[0] < 2 || strides[0] == 1;
   }
   SmallVector<int64_t,5> perm;
   perm.resize(dim());
@@ -168,22 +177,22 @@ bool TensorImpl::compute_non_overlapping_and_dense() const {
   }
   // Sort by strides, leaving 0 and 1 sized dims at the end of the array
   std::sort(perm.begin(), perm.end(), [&](int64_t a, int64_t b) {
-      if (sizes_[a] < 2) {
+      if (sizes[a] < 2) {
         return false;
-      } else if (sizes_[b] < 2) {
+      } else if (sizes[b] < 2) {
         return true;
       }
-      return strides_[a] < strides_[b];
+      return strides[a] < strides[b];
   });
   auto require_stride = 1;
   for (int64_t i = 0; i < dim(); i ++) {
-    if (sizes_[perm[i]] < 2) {
+    if (sizes[perm[i]] < 2) {
       return true;
     }
-    if (strides_[perm[i]] != require_stride) {
+    if (strides[perm[i]] != require_stride) {
       return false;
     }
-    require_stride *= sizes_[perm[i]];
+    require_stride *= sizes[perm[i]];
   }
   return true;
 }
@@ -196,17 +205,17 @@ void TensorImpl::release_resources() {
 }
 
 int64_t TensorImpl::dim() const {
-  return sizes_.size();
+  return sizes_and_strides_.size();
 }
 
 int64_t TensorImpl::size(int64_t d) const {
   d = at::maybe_wrap_dim(d, dim(), false);
-  return sizes_[d];
+  return sizes_and_strides_.size_at_unchecked(d);
 }
 
 int64_t TensorImpl::stride(int64_t d) const {
   d = at::maybe_wrap_dim(d, dim(), false);
-  return strides_[d];
+  return sizes_and_strides_.stride_at_unchecked(d);
 }
 
 bool TensorImpl::has_storage() const {
@@ -285,8 +294,7 @@ void TensorImpl::copy_tensor_metadata(
     const c10::VariableVersion& version_counter,
     bool allow_tensor_metadata_change) {
   dest_impl->storage_ = src_impl->storage_;
-  dest_impl->sizes_ = src_impl->sizes_;
-  dest_impl->strides_ = src_impl->strides_;
+  dest_impl->sizes_and_strides_ = src_impl->sizes_and_strides_;
   dest_impl->storage_offset_ = src_impl->storage_offset_;
   dest_impl->data_type_ = src_impl->data_type_;
   dest_impl->device_opt_ = src_impl->device_opt_;
@@ -0,0 +1,230 @@
+#include <c10/core/WorkStealingThreadPool.h>
+
+#include <c10/util/Logging.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace c10 {
+
+namespace {
+// The pool and worker the current thread belongs to.
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+inline void spin_pause() {
+#if defined(__x86_64__) || defined(_M_X64)
+  _mm_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+} // namespace
+
+constexpr int64_t WorkStealingThreadPool::TaskDeque::kCapacity;
+constexpr int WorkStealingThreadPool::kSpinCount;
+
+WorkStealingThreadPool::TaskDeque::TaskDeque() {
+  for (auto& task : buffer_) {
+    task.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+bool WorkStealingThreadPool::TaskDeque::push(Task* task) {
+  const int64_t b = bottom_.load(std::memory_order_relaxed);
+  const int64_t t = top_.load(std::memory_order_acquire);
+  if (b - t >= kCapacity) {
+    return false;
+  }
+  buffer_[b % kCapacity].store(task, std::memory_order_relaxed);
+  // Publishes the task to thieves.
+  bottom_.store(b + 1, std::memory_order_release);
+  return true;
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::TaskDeque::pop() {
+  const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+  // Reserves the bottom task before looking at top, thieves see either the
+  // reservation or the task.
+  bottom_.store(b);
+  int64_t t = top_.load();
+  if (t > b) {
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Task* task = buffer_[b % kCapacity].load(std::memory_order_relaxed);
+  if (t == b) {
+    // The last task, race thieves for it.
+    if (!top_.compare_exchange_strong(t, t + 1)) {
+      task = nullptr;
+    }
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::TaskDeque::steal() {
+  int64_t t = top_.load();
+  const int64_t b = bottom_.load();
+  if (t >= b) {
+    return nullptr;
+  }
+  Task* task = buffer_[t % kCapacity].load(std::memory_order_relaxed);
+  if (!top_.compare_exchange_strong(t, t + 1)) {
+    return nullptr;
+  }
+  return task;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+    int pool_size,
+    int numa_node_id,
+    std::function<void()> init_thread)
+    : numa_node_id_(numa_node_id) {
+  const size_t num_threads = pool_size < 0 ? defaultNumThreads() : pool_size;
+  available_ = num_threads;
+  // All workers exist before any thread starts, threads steal from each
+  // other right away.
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(new Worker());
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_[i]->thread = std::thread([this, i, init_thread]() {
+      if (init_thread) {
+        init_thread();
+      }
+      this->main_loop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    running_ = false;
+    park_condition_.notify_all();
+  }
+  for (auto& worker : workers_) {
+    try {
+      worker->thread.join();
+    } catch (const std::exception&) {
+    }
+  }
+  for (auto& worker : workers_) {
+    while (Task* task = worker->deque.steal()) {
+      delete task;
+    }
+    for (Task* task : worker->inbox) {
+      delete task;
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::size() const {
+  return workers_.size();
+}
+
+size_t WorkStealingThreadPool::numAvailable() const {
+  return available_;
+}
+
+bool WorkStealingThreadPool::inThreadPool() const {
+  return current_pool == this;
+}
+
+void WorkStealingThreadPool::run(std::function<void()> func) {
+  if (workers_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+  auto* task = new Task(std::move(func));
+  if (current_pool != this || !workers_[current_worker]->deque.push(task)) {
+    auto& worker = *workers_[next_inbox_++ % workers_.size()];
+    std::lock_guard<std::mutex> guard(worker.inbox_mutex);
+    worker.inbox.push_back(task);
+    worker.inbox_size++;
+  }
+  // Counted after the task can be found, and before sleeping_ is read: a
+  // worker that parks after this sees the task, one that parked before is
+  // woken up.
+  pending_++;
+  if (sleeping_.load() > 0) {
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    park_condition_.notify_one();
+  }
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::pop_inbox(
+    Worker& worker) {
+  if (worker.inbox_size.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> guard(worker.inbox_mutex);
+  if (worker.inbox.empty()) {
+    return nullptr;
+  }
+  Task* task = worker.inbox.front();
+  worker.inbox.pop_front();
+  worker.inbox_size--;
+  return task;
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::find_task(
+    size_t index) {
+  if (pending_.load(std::memory_order_relaxed) <= 0) {
+    return nullptr;
+  }
+  auto& self = *workers_[index];
+  Task* task = self.deque.pop();
+  if (task == nullptr) {
+    task = pop_inbox(self);
+  }
+  for (size_t i = 1; task == nullptr && i < workers_.size(); ++i) {
+    auto& victim = *workers_[(index + i) % workers_.size()];
+    task = victim.deque.steal();
+    if (task == nullptr) {
+      task = pop_inbox(victim);
+    }
+  }
+  if (task != nullptr) {
+    pending_--;
+  }
+  return task;
+}
+
+void WorkStealingThreadPool::main_loop(size_t index) {
+  current_pool = this;
+  current_worker = index;
+  while (running_) {
+    Task* task = find_task(index);
+    for (int i = 0; task == nullptr && i < kSpinCount && running_; ++i) {
+      spin_pause();
+      task = find_task(index);
+    }
+    if (task == nullptr) {
+      std::unique_lock<std::mutex> lock(park_mutex_);
+      sleeping_++;
+      while (running_ && pending_.load() <= 0) {
+        park_condition_.wait(lock);
+      }
+      sleeping_--;
+      continue;
+    }
+
+    // Destructed right after running, like ThreadPool does, to release
+    // anything the task holds on to.
+    std::unique_ptr<Task> owned_task(task);
+    --available_;
+    try {
+      (*owned_task)();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Exception in thread pool task: " << e.what();
+    } catch (...) {
+      LOG(ERROR) << "Exception in thread pool task: unknown";
+    }
+    owned_task.reset();
+    ++available_;
+  }
+}
+
+} // namespace c10
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10/core/thread_pool.h>
+
+namespace c10 {
+
+/*
+ * A thread pool without a shared task queue. Every worker owns a Chase-Lev
+ * deque: tasks a worker submits go to the bottom of its own deque and are
+ * taken from there, idle workers steal from the top of the others. Tasks
+ * submitted from outside the pool go round robin to small per-worker
+ * inboxes, which are also open to stealing. An idle worker spins for a
+ * while before it parks on a condition variable, so submitting to a busy
+ * pool takes no lock and wakes nobody.
+ *
+ * Unlike ThreadPool, tasks are not run in submission order, and tasks still
+ * queued when the pool is destroyed are dropped.
+ */
+class C10_API WorkStealingThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  explicit WorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1,
+      std::function<void()> init_thread = nullptr);
+
+  ~WorkStealingThreadPool() override;
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  void run(std::function<void()> func) override;
+
+ private:
+  using Task = std::function<void()>;
+
+  // Chase-Lev deque of fixed capacity. push and pop are only called by the
+  // owning worker, steal by any thread.
+  class TaskDeque {
+   public:
+    TaskDeque();
+    // Returns false if the deque is full.
+    bool push(Task* task);
+    Task* pop();
+    // May return nullptr while the deque is not empty, if another thread
+    // took the task first.
+    Task* steal();
+
+   private:
+    static constexpr int64_t kCapacity = 1024;
+    std::atomic<int64_t> top_{0};
+    std::atomic<int64_t> bottom_{0};
+    std::atomic<Task*> buffer_[kCapacity];
+  };
+
+  struct Worker {
+    TaskDeque deque;
+    std::mutex inbox_mutex;
+    std::deque<Task*> inbox;
+    std::atomic<size_t> inbox_size{0};
+    std::thread thread;
+  };
+
+  // Number of empty polls before an idle worker parks.
+  static constexpr int kSpinCount = 2000;
+
+  Task* pop_inbox(Worker& worker);
+  Task* find_task(size_t index);
+  void main_loop(size_t index);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<bool> running_{true};
+  std::atomic<size_t> available_;
+  std::atomic<size_t> next_inbox_{0};
+  // Tasks submitted and not taken yet, lets idle workers poll cheaply.
+  std::atomic<int64_t> pending_{0};
+  std::atomic<size_t> sleeping_{0};
+  std::mutex park_mutex_;
+  std::condition_variable park_condition_;
+  int numa_node_id_;
+};
+
+} // namespace c10
@@ -12,6 +12,9 @@
 
 namespace c10 {
 
+// forward declaration
+class DataPtr;
+
 /**
  * Flags defining the behavior of events.
  *
@@ -109,6 +112,14 @@ struct C10_API DeviceGuardImplInterface {
     TORCH_CHECK(false, "Backend doesn't support acquiring a default stream.")
   }
 
+  /**
+   * Get a stream from the global pool for a given device.
+   */
+  virtual Stream getStreamFromGlobalPool(Device, bool isHighPriority = false)
+      const {
+    TORCH_CHECK(false, "Backend doesn't support acquiring a stream from pool.")
+  }
+
   /**
    * Set a stream to be the thread local current stream for its device.
    * Return the previous stream for that device. You are NOT required
@@ -161,6 +172,15 @@ struct C10_API DeviceGuardImplInterface {
     TORCH_CHECK(false, "Backend doesn't support events.");
   }
 
+/**
+ * Tells the caching allocator of the backend, if it has one, that the memory
+ * of the DataPtr is used by the stream, so that it is not handed out again
+ * before the work queued on the stream so far is done.
+ */
+  virtual void recordDataPtrOnStream(
+    const c10::DataPtr& data_ptr,
+    const Stream& stream) const { }
+
   /**
    * Get the number of devices.  WARNING: This is REQUIRED to not raise
    * an exception.  If there is some sort of problem, e.g., driver error,
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <c10/macros/Macros.h>
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
+#define C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE 5
+
+namespace c10 {
+namespace impl {
+
+// The sizes and strides of a TensorImpl. They used to be two
+// SmallVector<int64_t, 5>, which store the begin, end and capacity of each
+// even though sizes and strides always have the same number of elements.
+// Here the number of dimensions is stored once, and up to
+// C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE sizes and strides are stored inline,
+// the sizes first. Beyond that they share one out-of-line array, which holds
+// the sizes first too. This takes 11 words instead of 16.
+class C10_API SizesAndStrides {
+ public:
+  // The sizes of a default constructed TensorImpl are {0} and its strides {1}.
+  SizesAndStrides() : size_(1) {
+    size_at_unchecked(0) = 0;
+    stride_at_unchecked(0) = 1;
+  }
+
+  ~SizesAndStrides() {
+    if (C10_UNLIKELY(!isInline())) {
+      free(outOfLineStorage_);
+    }
+  }
+
+  SizesAndStrides(const SizesAndStrides& rhs) : size_(rhs.size_) {
+    if (C10_LIKELY(rhs.isInline())) {
+      copyDataInline(rhs);
+    } else {
+      allocateOutOfLineStorage(size_);
+      copyDataOutline(rhs);
+    }
+  }
+
+  SizesAndStrides& operator=(const SizesAndStrides& rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if (C10_LIKELY(rhs.isInline())) {
+      if (C10_UNLIKELY(!isInline())) {
+        free(outOfLineStorage_);
+      }
+      copyDataInline(rhs);
+    } else {
+      if (isInline()) {
+        allocateOutOfLineStorage(rhs.size_);
+      } else {
+        resizeOutOfLineStorage(rhs.size_);
+      }
+      copyDataOutline(rhs);
+    }
+    size_ = rhs.size_;
+    return *this;
+  }
+
+  // Move from rhs. rhs.size() == 0 afterwards.
+  SizesAndStrides(SizesAndStrides&& rhs) noexcept : size_(rhs.size_) {
+    if (C10_LIKELY(isInline())) {
+      memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+    } else {
+      outOfLineStorage_ = rhs.outOfLineStorage_;
+      rhs.outOfLineStorage_ = nullptr;
+    }
+    rhs.size_ = 0;
+  }
+
+  // Move from rhs. rhs.size() == 0 afterwards.
+  SizesAndStrides& operator=(SizesAndStrides&& rhs) noexcept {
+    if (this == &rhs) {
+      return *this;
+    }
+    if (C10_UNLIKELY(!isInline())) {
+      free(outOfLineStorage_);
+    }
+    if (C10_LIKELY(rhs.isInline())) {
+      memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+    } else {
+      outOfLineStorage_ = rhs.outOfLineStorage_;
+      rhs.outOfLineStorage_ = nullptr;
+    }
+    size_ = rhs.size_;
+    rhs.size_ = 0;
+    return *this;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  const int64_t* sizes_data() const {
+    if (C10_LIKELY(isInline())) {
+      return &inlineStorage_[0];
+    } else {
+      return &outOfLineStorage_[0];
+    }
+  }
+
+  int64_t* sizes_data() {
+    if (C10_LIKELY(isInline())) {
+      return &inlineStorage_[0];
+    } else {
+      return &outOfLineStorage_[0];
+    }
+  }
+
+  const int64_t* sizes_begin() const {
+    return sizes_data();
+  }
+
+  int64_t* sizes_begin() {
+    return sizes_data();
+  }
+
+  const int64_t* sizes_end() const {
+    return sizes_begin() + size();
+  }
+
+  int64_t* sizes_end() {
+    return sizes_begin() + size();
+  }
+
+  IntArrayRef sizes_arrayref() const {
+    return IntArrayRef{sizes_data(), size()};
+  }
+
+  // Keeps the strides of the dimensions that remain.
+  void set_sizes(IntArrayRef newSizes) {
+    resize(newSizes.size());
+    std::copy(newSizes.begin(), newSizes.end(), sizes_begin());
+  }
+
+  const int64_t* strides_data() const {
+    if (C10_LIKELY(isInline())) {
+      return &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE];
+    } else {
+      return &outOfLineStorage_[size()];
+    }
+  }
+
+  int64_t* strides_data() {
+    if (C10_LIKELY(isInline())) {
+      return &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE];
+    } else {
+      return &outOfLineStorage_[size()];
+    }
+  }
+
+  const int64_t* strides_begin() const {
+    return strides_data();
+  }
+
+  int64_t* strides_begin() {
+    return strides_data();
+  }
+
+  const int64_t* strides_end() const {
+    return strides_begin() + size();
+  }
+
+  int64_t* strides_end() {
+    return strides_begin() + size();
+  }
+
+  IntArrayRef strides_arrayref() const {
+    return IntArrayRef{strides_data(), size()};
+  }
+
+  // Size accessors.
+  int64_t size_at(size_t idx) const {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size());
+    return sizes_data()[idx];
+  }
+
+  int64_t& size_at(size_t idx) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size());
+    return sizes_data()[idx];
+  }
+
+  int64_t size_at_unchecked(size_t idx) const {
+    return sizes_data()[idx];
+  }
+
+  int64_t& size_at_unchecked(size_t idx) {
+    return sizes_data()[idx];
+  }
+
+  // Stride accessors.
+  int64_t stride_at(size_t idx) const {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size());
+    return strides_data()[idx];
+  }
+
+  int64_t& stride_at(size_t idx) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size());
+    return strides_data()[idx];
+  }
+
+  int64_t stride_at_unchecked(size_t idx) const {
+    return strides_data()[idx];
+  }
+
+  int64_t& stride_at_unchecked(size_t idx) {
+    return strides_data()[idx];
+  }
+
+  // The sizes and strides of the dimensions that remain are kept, those of
+  // the new dimensions are zero.
+  void resize(size_t newSize) {
+    const auto oldSize = size();
+    if (newSize == oldSize) {
+      return;
+    }
+    if (C10_LIKELY(
+            newSize <= C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE && isInline())) {
+      if (oldSize < newSize) {
+        const auto bytesToZero = (newSize - oldSize) * sizeof(inlineStorage_[0]);
+        memset(&inlineStorage_[oldSize], 0, bytesToZero);
+        memset(
+            &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE + oldSize],
+            0,
+            bytesToZero);
+      }
+      size_ = newSize;
+    } else {
+      resizeSlowPath(newSize, oldSize);
+    }
+  }
+
+ private:
+  bool isInline() const {
+    return size_ <= C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE;
+  }
+
+  void copyDataInline(const SizesAndStrides& rhs) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(rhs.isInline());
+    memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+  }
+
+  static size_t storageBytes(size_t size) {
+    return size * 2 * sizeof(int64_t);
+  }
+
+  void allocateOutOfLineStorage(size_t size) {
+    outOfLineStorage_ = static_cast<int64_t*>(malloc(storageBytes(size)));
+    TORCH_CHECK(
+        outOfLineStorage_,
+        "Could not allocate memory for Tensor SizesAndStrides!");
+  }
+
+  void resizeOutOfLineStorage(size_t newSize) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(!isInline());
+    outOfLineStorage_ = static_cast<int64_t*>(
+        realloc(outOfLineStorage_, storageBytes(newSize)));
+    TORCH_CHECK(
+        outOfLineStorage_,
+        "Could not allocate memory for Tensor SizesAndStrides!");
+  }
+
+  void copyDataOutline(const SizesAndStrides& rhs) noexcept {
+    memcpy(outOfLineStorage_, rhs.outOfLineStorage_, storageBytes(rhs.size_));
+  }
+
+  void resizeSlowPath(size_t newSize, size_t oldSize) {
+    if (newSize <= C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE) {
+      // out of line to inline
+      int64_t* tempStorage = outOfLineStorage_;
+      memcpy(
+          &inlineStorage_[0],
+          &tempStorage[0],
+          C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * sizeof(inlineStorage_[0]));
+      memcpy(
+          &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE],
+          &tempStorage[oldSize],
+          C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * sizeof(inlineStorage_[0]));
+      // outOfLineStorage_ was overwritten by the inline storage
+      free(tempStorage);
+    } else {
+      if (isInline()) {
+        // inline to out of line
+        int64_t* tempStorage =
+            static_cast<int64_t*>(malloc(storageBytes(newSize)));
+        TORCH_CHECK(
+            tempStorage,
+            "Could not allocate memory to change Tensor SizesAndStrides!");
+        const auto bytesToCopy = oldSize * sizeof(inlineStorage_[0]);
+        const auto bytesToZero = (newSize > oldSize)
+            ? (newSize - oldSize) * sizeof(tempStorage[0])
+            : 0;
+        memcpy(&tempStorage[0], &inlineStorage_[0], bytesToCopy);
+        if (bytesToZero) {
+          memset(&tempStorage[oldSize], 0, bytesToZero);
+        }
+        memcpy(
+            &tempStorage[newSize],
+            &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE],
+            bytesToCopy);
+        if (bytesToZero) {
+          memset(&tempStorage[newSize + oldSize], 0, bytesToZero);
+        }
+        outOfLineStorage_ = tempStorage;
+      } else {
+        // out of line to out of line, the strides move with the sizes
+        const bool isGrowing = oldSize < newSize;
+        if (isGrowing) {
+          resizeOutOfLineStorage(newSize);
+        }
+        memmove(
+            outOfLineStorage_ + newSize,
+            outOfLineStorage_ + oldSize,
+            std::min(oldSize, newSize) * sizeof(outOfLineStorage_[0]));
+        if (isGrowing) {
+          const auto bytesToZero =
+              (newSize - oldSize) * sizeof(outOfLineStorage_[0]);
+          memset(&outOfLineStorage_[oldSize], 0, bytesToZero);
+          memset(&outOfLineStorage_[newSize + oldSize], 0, bytesToZero);
+        } else {
+          resizeOutOfLineStorage(newSize);
+        }
+      }
+    }
+    size_ = newSize;
+  }
+
+  size_t size_;
+  union {
+    int64_t* outOfLineStorage_;
+    int64_t inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * 2]{};
+  };
+};
+
+} // namespace impl
+} // namespace c10
@@ -1,15 +1,21 @@
 #include <c10/cuda/CUDACachingAllocator.h>
 
+#include <c10/core/ArenaAllocator.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/util/UniqueVoidPtr.h>
+#include <c10/util/llvmMathExtras.h>
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstdlib>
 #include <deque>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -29,7 +35,10 @@ namespace CUDACachingAllocator {
 // Yet another caching allocator for CUDA device allocations.
 //
 // - Allocations are associated with a stream. Once freed, blocks can be
-//   re-allocated on the same stream, but not on any other stream.
+//   re-allocated on the same stream. A cached segment that is entirely free
+//   can also be handed to another stream once the stream it was freed on has
+//   finished all its work, which a non-blocking cudaStreamQuery tells.
+//   Streams thereby do not strand memory that they cache but no longer use.
 // - The allocator attempts to find the smallest cached block that will fit the
 //   requested size. If the block is larger than the requested size, it may be
 //   split. If no block is found, the allocator will delegate to cudaMalloc.
@@ -40,6 +49,9 @@ namespace CUDACachingAllocator {
 //   smallest available free block or allocate a new block using cudaMalloc.
 //   To reduce fragmentation, requests between 1MB and 10MB will allocate and
 //   split a 20MB block, if no free block of sufficient size is available.
+// - To further reduce fragmentation, blocks above a size limit can be kept
+//   from being split and large request sizes can be rounded to a few steps
+//   per power of two, see CachingAllocatorConfig.
 //
 // With this allocator, allocations and frees should logically be considered
 // "usages" of the memory segment associated with streams, just like kernel
@@ -51,6 +63,31 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Note [Interaction with CUDA graph capture]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A captured graph bakes the addresses of its allocations into its kernels,
+// so the memory must stay reserved for the graph while it can be replayed,
+// even after the tensors that owned it are freed during capture. While a
+// stream is being captured (see notifyCaptureBegin) its allocations are
+// therefore served from a private pool owned by the graph, and blocks that
+// came from a private pool are returned to it when freed. A private pool is
+// only released once no graph uses it any more (notifyCaptureDestroy) and
+// all of its blocks are freed, on the next emptyCache or cudaMalloc retry.
+//
+// Note [Stream pools]
+// ~~~~~~~~~~~~~~~~~~~
+// The allocations of a chosen set of streams can be served from a named pool
+// of their own instead of the device's default pools (see setStreamPool),
+// e.g. to keep the memory of one pipeline stage from being taken by the
+// others. Blocks allocated from a named pool return to it when freed, and
+// its streams reuse each others' cached segments as described above. Unused
+// segments of named pools are released like those of the default pools.
+//
+// Querying or synchronizing events is illegal while a capture is underway,
+// so event processing and the free-and-retry path of malloc are skipped
+// during capture, and freed blocks used on other streams get their events
+// once the capture ends.
+//
 
 
 namespace {
@@ -64,6 +101,95 @@ constexpr size_t kLargeBuffer = 20971520;   // "large" allocations may be packed
 constexpr size_t kMinLargeAlloc = 10485760; // allocations between 1 and 10 MiB may use kLargeBuffer
 constexpr size_t kRoundLarge = 2097152;     // round up large allocs to 2 MiB
 
+// Settings of the allocator. They are read from the PYTORCH_CUDA_ALLOC_CONF
+// environment variable on first use and can be changed at runtime with
+// setAllocatorSettings. Both take a comma separated list of option:value
+// pairs:
+//
+// - max_split_size_mb: blocks of this many MiB or more are never split, and
+//   smaller requests do not take them. A request of that size only reuses a
+//   cached block that is less than kLargeBuffer bigger, so large segments stay
+//   whole for large requests instead of being carved into pieces nothing else
+//   fits in. It must exceed kLargeBuffer so that the segments packing smaller
+//   requests can still be split; 0, the default, splits any block.
+// - roundup_power2_divisions: rounds the size of large requests up to one of
+//   this many equal steps between two powers of two, e.g. with 4 a request of
+//   1200 MiB reserves 1280 MiB. Fewer distinct sizes make freed blocks easier
+//   to reuse when batch shapes vary. Must be a power of two; the default of 0
+//   only rounds to kMinBlockSize.
+class CachingAllocatorConfig {
+ public:
+  static size_t max_split_size() {
+    return instance().max_split_size_.load(std::memory_order_relaxed);
+  }
+
+  static size_t roundup_power2_divisions() {
+    return instance().roundup_power2_divisions_.load(std::memory_order_relaxed);
+  }
+
+  static void parse(const std::string& settings) {
+    instance().apply(settings);
+  }
+
+ private:
+  CachingAllocatorConfig() :
+      max_split_size_(std::numeric_limits<size_t>::max()),
+      roundup_power2_divisions_(0) {}
+
+  static CachingAllocatorConfig& instance() {
+    static CachingAllocatorConfig* config = [] {
+      auto config = new CachingAllocatorConfig();
+      const char* env = std::getenv("PYTORCH_CUDA_ALLOC_CONF");
+      if (env != nullptr) {
+        config->apply(env);
+      }
+      return config;
+    }();
+    return *config;
+  }
+
+  void apply(const std::string& settings) {
+    size_t begin = 0;
+    while (begin < settings.size()) {
+      size_t end = settings.find(',', begin);
+      if (end == std::string::npos) {
+        end = settings.size();
+      }
+      const std::string option = settings.substr(begin, end - begin);
+      begin = end + 1;
+      if (option.empty()) {
+        continue;
+      }
+      const size_t colon = option.find(':');
+      TORCH_CHECK(colon != std::string::npos,
+                  "expected option:value in CUDA allocator settings, got ", option);
+      const std::string name = option.substr(0, colon);
+      const std::string value = option.substr(colon + 1);
+      char* value_end = nullptr;
+      const long long number = std::strtoll(value.c_str(), &value_end, 10);
+      TORCH_CHECK(!value.empty() && *value_end == '\0' && number >= 0,
+                  "expected a non-negative integer for CUDA allocator option ", name, ", got ", value);
+      if (name == "max_split_size_mb") {
+        TORCH_CHECK(number == 0 || static_cast<size_t>(number) > kLargeBuffer / 1048576,
+                    "max_split_size_mb must be 0 or larger than ", kLargeBuffer / 1048576, ", got ", number);
+        const size_t max_split_size = number == 0
+            ? std::numeric_limits<size_t>::max()
+            : static_cast<size_t>(number) * 1048576;
+        max_split_size_.store(max_split_size, std::memory_order_relaxed);
+      } else if (name == "roundup_power2_divisions") {
+        TORCH_CHECK(number == 0 || llvm::isPowerOf2_64(number),
+                    "roundup_power2_divisions must be 0 or a power of two, got ", number);
+        roundup_power2_divisions_.store(number, std::memory_order_relaxed);
+      } else {
+        TORCH_CHECK(false, "unknown CUDA allocator option ", name);
+      }
+    }
+  }
+
+  std::atomic<size_t> max_split_size_;
+  std::atomic<size_t> roundup_power2_divisions_;
+};
+
 typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
 
 void update_stat(Stat& stat, int64_t amount) {
@@ -98,8 +224,17 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
 }
 
 struct Block;
+struct PrivatePool;
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+
+struct BlockPool {
+  BlockPool(Comparison comparator, bool small, PrivatePool* private_pool = nullptr) :
+    blocks(comparator), is_small(small), owner_PrivatePool(private_pool) {}
+
+  std::set<Block*, Comparison> blocks;
+  const bool is_small;
+  PrivatePool* owner_PrivatePool;  // null for the device's default pools
+};
 
 struct Block {
   int           device;      // gpu
@@ -138,6 +273,25 @@ static bool BlockComparator(const Block* a, const Block* b)
   return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
 }
 
+// Memory reserved for the allocations of one or more CUDA graphs.
+// See Note [Interaction with CUDA graph capture].
+struct PrivatePool {
+  PrivatePool() :
+    use_count(1),
+    cudaMalloc_count(0),
+    large_blocks(BlockComparator, /*is_small=*/false, this),
+    small_blocks(BlockComparator, /*is_small=*/true, this) {}
+  PrivatePool(const PrivatePool&) = delete;
+  PrivatePool& operator=(const PrivatePool&) = delete;
+
+  // number of live graphs using this pool
+  int use_count;
+  // number of segments allocated for this pool that have not been freed yet
+  int cudaMalloc_count;
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+};
+
 static std::string format_size(uint64_t size) {
   std::ostringstream os;
   os.precision(2);
@@ -176,6 +330,8 @@ struct AllocParams {
   Block* block;
   StatTypes stat_types;
   cudaError_t err;
+  // for the memory history, see recordHistory
+  std::string context;
 };
 
 } // namespace
@@ -199,41 +355,80 @@ class DeviceCachingAllocator {
   // allocated or in use by a stream
   std::unordered_set<Block*> active_blocks;
 
-  // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
+  // outstanding cuda events, by the stream they were recorded on
+  std::unordered_map<cuda::CUDAStream, std::deque<std::pair<cudaEvent_t, Block*>>> cuda_events;
+
+  // private pools of CUDA graphs
+  std::unordered_map<MempoolId_t, std::unique_ptr<PrivatePool>> graph_pools;
+
+  // private pools no graph uses any more, released once all their blocks
+  // are freed
+  std::unordered_map<MempoolId_t, PrivatePool*> graph_pools_freeable;
+
+  // streams being captured and the pools that serve their allocations
+  std::vector<std::pair<cudaStream_t, PrivatePool*>> captures_underway;
+
+  // blocks freed during capture that still need events for other streams
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
+  // named pools and the streams they serve, see Note [Stream pools]
+  std::unordered_map<std::string, std::unique_ptr<PrivatePool>> named_pools;
+  std::unordered_map<cudaStream_t, PrivatePool*> stream_pools;
+
+  // CachingAllocatorConfig::max_split_size as of the last applySettings, so
+  // that the oversize stats stay consistent while the setting changes
+  size_t max_split_size;
+
+  // Memory history, a ring buffer of the last alloc_trace_max_entries
+  // events with alloc_trace_next the oldest once it is full. The context
+  // recorder is read without the lock, it has to run before taking it.
+  std::atomic<CreateContextFn> context_recorder;
+  bool record_history = false;
+  size_t alloc_trace_max_entries = 1;
+  size_t alloc_trace_next = 0;
+  std::vector<TraceEntry> alloc_trace;
 
  public:
 
   DeviceCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(BlockComparator, /*is_small=*/false),
+      small_blocks(BlockComparator, /*is_small=*/true),
+      max_split_size(CachingAllocatorConfig::max_split_size()),
+      context_recorder(nullptr) {}
 
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
 
   Block* malloc(int device, size_t size, cudaStream_t stream)
   {
+    std::string context = maybe_record_context();
     std::unique_lock<std::recursive_mutex> lock(mutex);
 
-    // process outstanding cudaEvents
-    process_events();
+    if (C10_LIKELY(captures_underway.empty())) {
+      // process outstanding cudaEvents
+      process_events();
+    }
 
     size = round_size(size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
     params.stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
     params.stat_types[static_cast<size_t>(get_stat_type_for_pool(pool))] = true;
+    params.context = std::move(context);
 
     bool block_found =
       // Search pool
       get_free_block(params)
+      // Take over a free segment cached by an idle stream
+      || (C10_LIKELY(captures_underway.empty()) && get_free_block_from_idle_stream(params))
       // Trigger callbacks and retry search
       || (trigger_free_memory_callbacks(params) && get_free_block(params))
       // Attempt allocate
       || alloc_block(params, false)
       // Free all non-split cached blocks and retry alloc.
-      || (free_cached_blocks() && alloc_block(params, true));
+      || (C10_LIKELY(captures_underway.empty()) &&
+          free_cached_blocks() && alloc_block(params, true));
 
     TORCH_INTERNAL_ASSERT((!block_found && params.err != cudaSuccess) || params.block);
     if (!block_found) {
@@ -269,7 +464,9 @@ class DeviceCachingAllocator {
           " already allocated; ",
           format_size(device_free), " free; ",
           format_size(stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current),
-          " reserved in total by PyTorch)");
+          " reserved in total by PyTorch)",
+          " If reserved memory is >> allocated memory try setting max_split_size_mb to avoid"
+          " fragmentation. See the documentation of PYTORCH_CUDA_ALLOC_CONF.");
       } else {
         C10_CUDA_CHECK(params.err);
       }
@@ -293,7 +490,7 @@ class DeviceCachingAllocator {
       remaining->prev = block;
       remaining->ptr = static_cast<char*>(remaining->ptr) + size;
       remaining->size -= size;
-      pool.insert(remaining);
+      pool.blocks.insert(remaining);
 
       if (already_split) {
         // An already-split inactive block is being shrunk by size bytes.
@@ -312,6 +509,9 @@ class DeviceCachingAllocator {
 
     block->allocated = true;
     active_blocks.insert(block);
+    if (block->size >= max_split_size) {
+      update_stat(stats.oversize_allocations, 1);
+    }
 
     c10::reportMemoryUsageToProfiler(
         block, block->size, c10::Device(c10::DeviceType::CUDA, device));
@@ -321,11 +521,15 @@ class DeviceCachingAllocator {
     update_stat_array(stats.active, 1, params.stat_types);
     update_stat_array(stats.active_bytes, block->size, params.stat_types);
 
+    record_trace(TraceEntry::ALLOC, device, block->ptr, block->size, stream,
+                 std::move(params.context));
+
     return block;
   }
 
   void free(Block* block)
   {
+    std::string context = maybe_record_context();
     std::lock_guard<std::recursive_mutex> lock(mutex);
 
     block->allocated = false;
@@ -338,12 +542,28 @@ class DeviceCachingAllocator {
     stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
     update_stat_array(stats.allocation, -1, {stat_types});
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
+    if (block->size >= max_split_size) {
+      update_stat(stats.oversize_allocations, -1);
+    }
+
+    record_trace(TraceEntry::FREE, block->device, block->ptr, block->size,
+                 block->stream, std::move(context));
 
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      if (C10_UNLIKELY(!captures_underway.empty())) {
+        needs_events_deferred_until_no_capture.push_back(block);
+      } else {
+        insert_events(block);
+      }
     } else {
       free_block(block);
     }
+
+    // Return the blocks whose uses on other streams have finished, so that
+    // they do not wait for the next malloc.
+    if (!cuda_events.empty() && C10_LIKELY(captures_underway.empty())) {
+      process_events();
+    }
   }
 
   void* getBaseAllocation(Block* block, size_t* outSize) {
@@ -376,6 +596,8 @@ class DeviceCachingAllocator {
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(captures_underway.empty(),
+                "emptyCache cannot be called while a CUDA graph capture is underway");
     free_cached_blocks();
   }
 
@@ -392,9 +614,105 @@ class DeviceCachingAllocator {
     cache_info_aux(small_blocks, total, largest);
   }
 
+  /** Serves allocations on stream from the private pool mempool_id until the
+      capture ends, creating the pool if it does not exist yet **/
+  void notifyCaptureBegin(cudaStream_t stream, MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto& entry : captures_underway) {
+      TORCH_CHECK(entry.first != stream, "the stream is already being captured");
+    }
+    PrivatePool* pool;
+    auto it = graph_pools.find(mempool_id);
+    if (it == graph_pools.end()) {
+      pool = new PrivatePool();
+      graph_pools.emplace(mempool_id, std::unique_ptr<PrivatePool>(pool));
+    } else {
+      pool = it->second.get();
+      if (pool->use_count++ == 0) {
+        graph_pools_freeable.erase(mempool_id);
+      }
+    }
+    captures_underway.emplace_back(stream, pool);
+  }
+
+  /** Returns allocations on stream to the regular pools **/
+  void notifyCaptureEnd(cudaStream_t stream) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = std::find_if(captures_underway.begin(), captures_underway.end(),
+        [stream](const std::pair<cudaStream_t, PrivatePool*>& entry) {
+          return entry.first == stream;
+        });
+    TORCH_INTERNAL_ASSERT(it != captures_underway.end(), "the stream is not being captured");
+    captures_underway.erase(it);
+
+    if (captures_underway.empty()) {
+      for (Block* block : needs_events_deferred_until_no_capture) {
+        TORCH_INTERNAL_ASSERT(!block->stream_uses.empty());
+        insert_events(block);
+      }
+      needs_events_deferred_until_no_capture.clear();
+    }
+  }
+
+  /** Called when a graph using the private pool mempool_id is destroyed **/
+  void notifyCaptureDestroy(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    TORCH_INTERNAL_ASSERT(it != graph_pools.end(), "unknown private pool id");
+    const int use_count = --(it->second->use_count);
+    TORCH_INTERNAL_ASSERT(use_count >= 0);
+    if (use_count == 0) {
+      graph_pools_freeable.emplace(mempool_id, it->second.get());
+    }
+  }
+
+  /** Picks up a changed max_split_size and recounts the oversize blocks **/
+  void applySettings() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    max_split_size = CachingAllocatorConfig::max_split_size();
+
+    int64_t oversize_allocations = 0;
+    int64_t oversize_segments = 0;
+    for (const Block* block : get_all_blocks()) {
+      if (block->allocated && block->size >= max_split_size) {
+        oversize_allocations++;
+      }
+      if (block->prev == nullptr) {
+        size_t segment_size = 0;
+        for (const Block* b = block; b != nullptr; b = b->next) {
+          segment_size += b->size;
+        }
+        if (segment_size >= max_split_size) {
+          oversize_segments++;
+        }
+      }
+    }
+    stats.oversize_allocations.current = oversize_allocations;
+    stats.oversize_allocations.peak = std::max(stats.oversize_allocations.peak, oversize_allocations);
+    stats.oversize_segments.current = oversize_segments;
+    stats.oversize_segments.peak = std::max(stats.oversize_segments.peak, oversize_segments);
+  }
+
+  /** Serves the allocations of stream from the named pool, creating it if
+      needed, or from the default pools again if name is empty **/
+  void setStreamPool(cudaStream_t stream, const std::string& name) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (name.empty()) {
+      stream_pools.erase(stream);
+      return;
+    }
+    auto& pool = named_pools[name];
+    if (!pool) {
+      pool.reset(new PrivatePool());
+    }
+    stream_pools[stream] = pool.get();
+  }
+
   /** Returns a copy of the memory allocator stats **/
   DeviceStats getStats() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    stats.max_split_size = max_split_size == std::numeric_limits<size_t>::max()
+        ? -1 : static_cast<int64_t>(max_split_size);
     return stats;
   }
 
@@ -413,6 +731,9 @@ class DeviceCachingAllocator {
       reset_accumulated_stat(stats.inactive_split_bytes[statType]);
     }
 
+    reset_accumulated_stat(stats.oversize_allocations);
+    reset_accumulated_stat(stats.oversize_segments);
+
     stats.num_alloc_retries = 0;
     stats.num_ooms = 0;
   }
@@ -431,6 +752,9 @@ class DeviceCachingAllocator {
       reset_peak_stat(stats.active_bytes[statType]);
       reset_peak_stat(stats.inactive_split_bytes[statType]);
     }
+
+    reset_peak_stat(stats.oversize_allocations);
+    reset_peak_stat(stats.oversize_segments);
   }
 
   /** Dump a complete snapshot of the memory held by the allocator. Potentially VERY expensive. **/
@@ -448,7 +772,7 @@ class DeviceCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_large = !head_block->pool->is_small;
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -478,22 +802,97 @@ class DeviceCachingAllocator {
     return result;
   }
 
+  /** Starts or stops the memory history, clearing it when starting **/
+  void recordHistory(bool enabled, size_t max_entries, CreateContextFn recorder) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    record_history = enabled;
+    context_recorder.store(enabled ? recorder : nullptr);
+    if (enabled) {
+      alloc_trace_max_entries = std::max<size_t>(1, max_entries);
+      alloc_trace_next = 0;
+      alloc_trace.clear();
+      alloc_trace.reserve(std::min<size_t>(alloc_trace_max_entries, 4096));
+    }
+  }
+
+  /** Returns the memory history, oldest event first **/
+  std::vector<TraceEntry> history() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<TraceEntry> result;
+    result.reserve(alloc_trace.size());
+    result.insert(result.end(), alloc_trace.begin() + alloc_trace_next, alloc_trace.end());
+    result.insert(result.end(), alloc_trace.begin(), alloc_trace.begin() + alloc_trace_next);
+    return result;
+  }
+
   static size_t round_size(size_t size) {
+    const size_t divisions = CachingAllocatorConfig::roundup_power2_divisions();
     if (size < kMinBlockSize) {
       return kMinBlockSize;
+    } else if (divisions > 0 && size > kSmallSize) {
+      return roundup_power2_next_division(size, divisions);
     } else {
       return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
     }
   }
 
+  // Rounds size up to the next of `divisions` equal steps between the powers
+  // of two below and above it. divisions is a power of two.
+  static size_t roundup_power2_next_division(size_t size, size_t divisions) {
+    const size_t power2_floor = llvm::PowerOf2Floor(size);
+    const size_t step = std::max<size_t>(power2_floor / divisions, kMinBlockSize);
+    return step * ((size + step - 1) / step);
+  }
+
  private:
 
   // All private methods do not acquire the allocator mutex.
 
+  std::string maybe_record_context() {
+    CreateContextFn recorder = context_recorder.load(std::memory_order_relaxed);
+    return recorder ? recorder() : std::string();
+  }
+
+  void record_trace(TraceEntry::Action action, int device, void* ptr,
+                    size_t size, cudaStream_t stream, std::string context) {
+    if (C10_LIKELY(!record_history)) {
+      return;
+    }
+    TraceEntry entry;
+    entry.action = action;
+    entry.device = device;
+    entry.address = reinterpret_cast<int64_t>(ptr);
+    entry.size = size;
+    entry.stream = reinterpret_cast<int64_t>(stream);
+    entry.time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    entry.allocated_bytes = stats.allocated_bytes[static_cast<size_t>(StatType::AGGREGATE)].current;
+    entry.reserved_bytes = stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current;
+    entry.context = std::move(context);
+    if (alloc_trace.size() < alloc_trace_max_entries) {
+      alloc_trace.emplace_back(std::move(entry));
+    } else {
+      alloc_trace[alloc_trace_next] = std::move(entry);
+      if (++alloc_trace_next == alloc_trace_max_entries) {
+        alloc_trace_next = 0;
+      }
+    }
+  }
+
   std::vector<const Block*> get_all_blocks() const {
     std::vector<const Block*> blocks;
-    blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
-    blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    blocks.insert(blocks.end(), small_blocks.blocks.begin(), small_blocks.blocks.end());
+    blocks.insert(blocks.end(), large_blocks.blocks.begin(), large_blocks.blocks.end());
+    for (const auto& entry : graph_pools) {
+      const PrivatePool& pool = *entry.second;
+      blocks.insert(blocks.end(), pool.small_blocks.blocks.begin(), pool.small_blocks.blocks.end());
+      blocks.insert(blocks.end(), pool.large_blocks.blocks.begin(), pool.large_blocks.blocks.end());
+    }
+    for (const auto& entry : named_pools) {
+      const PrivatePool& pool = *entry.second;
+      blocks.insert(blocks.end(), pool.small_blocks.blocks.begin(), pool.small_blocks.blocks.end());
+      blocks.insert(blocks.end(), pool.large_blocks.blocks.begin(), pool.large_blocks.blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
     return blocks;
   }
@@ -519,7 +918,7 @@ class DeviceCachingAllocator {
     }
 
     active_blocks.erase(block);
-    pool.insert(block);
+    pool.blocks.insert(block);
 
     if (block->is_split()) {
       net_change_inactive_split_blocks += 1;
@@ -559,13 +958,26 @@ class DeviceCachingAllocator {
 
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
-    pool.erase(src);
+    pool.blocks.erase(src);
     delete src;
 
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, cudaStream_t stream) {
+    if (C10_UNLIKELY(!captures_underway.empty())) {
+      for (const auto& entry : captures_underway) {
+        if (entry.first == stream) {
+          return size <= kSmallSize ? entry.second->small_blocks : entry.second->large_blocks;
+        }
+      }
+    }
+    if (C10_UNLIKELY(!stream_pools.empty())) {
+      auto it = stream_pools.find(stream);
+      if (it != stream_pools.end()) {
+        return size <= kSmallSize ? it->second->small_blocks : it->second->large_blocks;
+      }
+    }
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -574,23 +986,15 @@ class DeviceCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return size < max_split_size && remaining > kSmallSize;
     }
   }
 
@@ -604,16 +1008,83 @@ class DeviceCachingAllocator {
     }
   }
 
+  // Whether a free block at least as large as the request may serve it.
+  // Blocks that may not be split are left to requests of their size, and
+  // those only take them if not too much of the block goes to waste.
+  bool fits_request(AllocParams& p, const Block* block) {
+    if (p.size() < max_split_size && block->size >= max_split_size)
+      return false;
+    if (p.size() >= max_split_size && block->size >= p.size() + kLargeBuffer)
+      return false;
+    return true;
+  }
+
   bool get_free_block(AllocParams& p) {
     BlockPool& pool = *p.pool;
-    auto it = pool.lower_bound(&p.search_key);
-    if (it == pool.end() || (*it)->stream != p.stream())
+    auto it = pool.blocks.lower_bound(&p.search_key);
+    if (it == pool.blocks.end() || (*it)->stream != p.stream())
+      return false;
+    if (!fits_request(p, *it))
       return false;
     p.block = *it;
-    pool.erase(it);
+    pool.blocks.erase(it);
     return true;
   }
 
+  // Looks for the smallest free segment that fits the request among the
+  // blocks other streams cached in the pool, and moves it to the requesting
+  // stream if the stream it was freed on has no pending work left. Only
+  // blocks that are not split qualify: the pieces of a segment always belong
+  // to the same stream, so merging them never mixes the work of two streams.
+  bool get_free_block_from_idle_stream(AllocParams& p) {
+    BlockPool& pool = *p.pool;
+    std::vector<cudaStream_t> busy_streams;
+    while (true) {
+      auto best = pool.blocks.end();
+      for (auto it = pool.blocks.begin(); it != pool.blocks.end(); ) {
+        const cudaStream_t stream = (*it)->stream;
+        // the blocks of each stream are ordered by size
+        Block key(p.device(), stream, p.size());
+        auto candidate = pool.blocks.lower_bound(&key);
+        key.size = std::numeric_limits<size_t>::max();
+        key.ptr = reinterpret_cast<void*>(std::numeric_limits<uintptr_t>::max());
+        auto next_stream = pool.blocks.upper_bound(&key);
+        if (stream != p.stream() &&
+            std::find(busy_streams.begin(), busy_streams.end(), stream) == busy_streams.end()) {
+          for (; candidate != next_stream; ++candidate) {
+            if (!(*candidate)->is_split()) {
+              break;
+            }
+          }
+          if (candidate != next_stream && fits_request(p, *candidate) &&
+              (best == pool.blocks.end() || (*candidate)->size < (*best)->size)) {
+            best = candidate;
+          }
+        }
+        it = next_stream;
+      }
+      if (best == pool.blocks.end()) {
+        return false;
+      }
+
+      const cudaStream_t stream = (*best)->stream;
+      cudaError_t err = cudaStreamQuery(stream);
+      if (err == cudaErrorNotReady) {
+        // ignore and clear the error if not ready
+        cudaGetLastError();
+        busy_streams.push_back(stream);
+        continue;
+      } else if (err != cudaSuccess) {
+        C10_CUDA_CHECK(err);
+      }
+
+      p.block = *best;
+      pool.blocks.erase(best);
+      p.block->stream = p.stream();
+      return true;
+    }
+  }
+
   bool trigger_free_memory_callbacks(AllocParams& p) {
     bool freed_memory = false;
     for (const auto& name : FreeCudaMemoryCallbacksRegistry()->Keys()) {
@@ -638,9 +1109,17 @@ class DeviceCachingAllocator {
       return false;
     }
 
+    if (p.pool->owner_PrivatePool) {
+      p.pool->owner_PrivatePool->cudaMalloc_count++;
+    }
+
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
     update_stat_array(stats.segment, 1, p.stat_types);
     update_stat_array(stats.reserved_bytes, size, p.stat_types);
+    if (size >= max_split_size) {
+      update_stat(stats.oversize_segments, 1);
+    }
+    record_trace(TraceEntry::SEGMENT_ALLOC, p.device(), ptr, size, p.stream(), p.context);
 
     return (p.block != nullptr);
   }
@@ -654,23 +1133,52 @@ class DeviceCachingAllocator {
     // Free all non-split cached blocks
     free_blocks(large_blocks);
     free_blocks(small_blocks);
+    for (const auto& entry : named_pools) {
+      free_blocks(entry.second->large_blocks);
+      free_blocks(entry.second->small_blocks);
+    }
+
+    // Release the private pools no graph uses any more. A pool is deleted
+    // once all the segments allocated for it are gone.
+    for (auto it = graph_pools_freeable.begin(); it != graph_pools_freeable.end(); ) {
+      PrivatePool* pool = it->second;
+      TORCH_INTERNAL_ASSERT(pool->use_count == 0);
+      free_blocks(pool->large_blocks);
+      free_blocks(pool->small_blocks);
+      if (pool->cudaMalloc_count == 0) {
+        auto erased = graph_pools.erase(it->first);
+        TORCH_INTERNAL_ASSERT(erased == 1);
+        it = graph_pools_freeable.erase(it);
+      } else {
+        ++it;
+      }
+    }
     return true;
   }
 
-  void free_blocks(BlockPool& blocks)
+  void free_blocks(BlockPool& pool)
   {
     // Frees all non-split blocks
+    auto& blocks = pool.blocks;
     auto it = blocks.begin();
     while (it != blocks.end()) {
       Block* block = *it;
       if (!block->prev && !block->next) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+        if (pool.owner_PrivatePool) {
+          pool.owner_PrivatePool->cudaMalloc_count--;
+        }
 
         StatTypes stat_types;
         stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
         stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
         update_stat_array(stats.segment, -1, stat_types);
         update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+        if (block->size >= max_split_size) {
+          update_stat(stats.oversize_segments, -1);
+        }
+        record_trace(TraceEntry::SEGMENT_FREE, block->device, block->ptr, block->size,
+                     block->stream, "");
 
         auto cur = it;
         ++it;
@@ -695,16 +1203,18 @@ class DeviceCachingAllocator {
   void synchronize_and_free_events() {
     // Synchronize on outstanding events and then free associated blocks.
 
-    for (auto& e : cuda_events) {
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
+    for (auto& stream_events : cuda_events) {
+      for (auto& e : stream_events.second) {
+        cudaEvent_t event = e.first;
+        Block* block = e.second;
 
-      C10_CUDA_CHECK(cudaEventSynchronize(event));
-      free_event_internal(event);
+        C10_CUDA_CHECK(cudaEventSynchronize(event));
+        free_event_internal(event);
 
-      block->event_count--;
-      if (block->event_count == 0) {
-        free_block(block);
+        block->event_count--;
+        if (block->event_count == 0) {
+          free_block(block);
+        }
       }
     }
 
@@ -725,7 +1235,7 @@ class DeviceCachingAllocator {
       C10_CUDA_CHECK(cudaEventRecord(event, it->stream()));
 
       block->event_count++;
-      cuda_events.emplace_back(event, block);
+      cuda_events[*it].emplace_back(event, block);
     }
 
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
@@ -734,38 +1244,47 @@ class DeviceCachingAllocator {
   void process_events()
   {
     // Process outstanding cudaEvents. Events that are completed are removed
-    // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
-    while (!cuda_events.empty()) {
-      auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
-
-      cudaError_t err = cudaEventQuery(event);
-      if (err == cudaErrorNotReady) {
-        // ignore and clear the error if not ready
-        cudaGetLastError();
-        break;
-      } else if (err != cudaSuccess) {
-        C10_CUDA_CHECK(err);
-      }
+    // from the queue of their stream, and the 'event_count' for the
+    // corresponding allocation is decremented. Events complete in the order
+    // they were recorded on a stream, so the processing of each queue stops
+    // at its first event which has not been completed, while a busy stream
+    // does not hold up the blocks used on other streams.
+    for (auto it = cuda_events.begin(); it != cuda_events.end(); ) {
+      auto& stream_events = it->second;
+      while (!stream_events.empty()) {
+        auto& e = stream_events.front();
+        cudaEvent_t event = e.first;
+        Block* block = e.second;
+
+        cudaError_t err = cudaEventQuery(event);
+        if (err == cudaErrorNotReady) {
+          // ignore and clear the error if not ready
+          cudaGetLastError();
+          break;
+        } else if (err != cudaSuccess) {
+          C10_CUDA_CHECK(err);
+        }
 
-      free_event_internal(event);
+        free_event_internal(event);
 
-      block->event_count--;
-      if (block->event_count == 0) {
-        free_block(block);
+        block->event_count--;
+        if (block->event_count == 0) {
+          free_block(block);
+        }
+        stream_events.pop_front();
+      }
+      if (stream_events.empty()) {
+        it = cuda_events.erase(it);
+      } else {
+        ++it;
       }
-      cuda_events.pop_front();
     }
   }
 
   // Accumulates sizes of all memory blocks for given device in given pool
-  void cache_info_aux(BlockPool& blocks, size_t* total, size_t* largest)
+  void cache_info_aux(BlockPool& pool, size_t* total, size_t* largest)
   {
-    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    for (auto it = pool.blocks.begin(); it != pool.blocks.end(); ++it) {
       size_t blocksize = (*it)->size;
       *total += blocksize;
       if (blocksize > *largest) {
@@ -876,6 +1395,10 @@ class THCCachingAllocator {
     if (ptr.get_deleter() != &raw_delete)
       return;
 
+    // Arena memory is not tracked per stream, see ArenaAllocator.
+    if (ArenaAllocator::owner(ptr.get()))
+      return;
+
     Block* block = get_allocated_block(ptr.get());
     // block must not be null reaching here
     TORCH_INTERNAL_ASSERT(block != nullptr, "No allocated block can be found");
@@ -904,7 +1427,11 @@ struct CudaCachingAllocator : public Allocator {
     int device;
     C10_CUDA_CHECK(cudaGetDevice(&device));
     void* r = nullptr;
-    if (size != 0) {
+    auto arena = GetThreadLocalArenaAllocator(DeviceType::CUDA);
+    if (size != 0 && arena != nullptr && arena->device().index() == device) {
+      r = arena->allocate(size);
+    }
+    if (size != 0 && r == nullptr) {
       caching_allocator.malloc(&r, device, size, cuda::getCurrentCUDAStream(device));
     }
     return {r, r, &raw_delete, Device(DeviceType::CUDA, device)};
@@ -972,6 +1499,45 @@ std::vector<SegmentInfo> snapshot() {
   return caching_allocator.snapshot();
 }
 
+void recordHistory(bool enabled, size_t max_entries, CreateContextFn context_recorder) {
+  for (auto& allocator : caching_allocator.device_allocator) {
+    allocator->recordHistory(enabled, max_entries, context_recorder);
+  }
+}
+
+std::vector<TraceEntry> memoryHistory(int device) {
+  assertValidDevice(device);
+  return caching_allocator.device_allocator[device]->history();
+}
+
+void setStreamPool(int device, cudaStream_t stream, const std::string& name) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->setStreamPool(stream, name);
+}
+
+void setAllocatorSettings(const std::string& settings) {
+  CachingAllocatorConfig::parse(settings);
+  for (auto& allocator : caching_allocator.device_allocator) {
+    allocator->applySettings();
+  }
+}
+
+// CUDAGraph interactions
+void notifyCaptureBegin(int device, cudaStream_t stream, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureBegin(stream, mempool_id);
+}
+
+void notifyCaptureEnd(int device, cudaStream_t stream) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureEnd(stream);
+}
+
+void notifyCaptureDestroy(int device, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureDestroy(mempool_id);
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
@@ -1049,6 +1615,10 @@ void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream) {
 }
 
 void raw_delete(void* ptr) {
+  if (auto arena = ArenaAllocator::owner(ptr)) {
+    arena->free(ptr);
+    return;
+  }
   caching_allocator.free(ptr);
 }
 
@@ -8,6 +8,8 @@
 
 #include <array>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace c10 {
 
@@ -85,6 +87,14 @@ struct DeviceStats {
 
   // COUNT: total number of OOMs (i.e. failed calls to CUDA after cache flush)
   int64_t num_ooms = 0;
+
+  // COUNT: number of allocated blocks of at least max_split_size bytes
+  Stat oversize_allocations;
+  // COUNT: number of segments of at least max_split_size bytes
+  Stat oversize_segments;
+
+  // SIZE: cached blocks of this size or larger are never split
+  int64_t max_split_size = 0;
 };
 
 // Struct containing info of an allocation block (i.e. a fractional part of a cudaMalloc)..
@@ -105,6 +115,37 @@ struct SegmentInfo {
   std::vector<BlockInfo> blocks;
 };
 
+// An event recorded while memory history is enabled, see recordHistory.
+struct TraceEntry {
+  enum Action {
+    ALLOC,          // block handed out by malloc
+    FREE,           // block returned by the client, it may still be in use
+                    // by other streams
+    SEGMENT_ALLOC,  // cudaMalloc
+    SEGMENT_FREE    // cudaFree
+  };
+  Action action = ALLOC;
+  int64_t device = 0;
+  int64_t address = 0;
+  int64_t size = 0;
+  int64_t stream = 0;
+  // microseconds since the epoch of the steady clock
+  int64_t time_us = 0;
+  // aggregate allocated and reserved bytes of the device after the event
+  int64_t allocated_bytes = 0;
+  int64_t reserved_bytes = 0;
+  // whatever the context recorder returned, e.g. a Python stack
+  std::string context;
+};
+
+// Returns a description of the code that is allocating or freeing, called
+// before the allocator takes its lock.
+typedef std::string (*CreateContextFn)();
+
+// Identifies a private memory pool of CUDA graphs. See Note [Interaction
+// with CUDA graph capture] in CUDACachingAllocator.cpp.
+typedef uint64_t MempoolId_t;
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -119,6 +160,24 @@ C10_CUDA_API DeviceStats getDeviceStats(int device);
 C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
+// Starts or stops recording TraceEntry events of all devices into ring
+// buffers that keep the last max_entries of them. Enabling clears what was
+// recorded before. context_recorder may be null.
+C10_CUDA_API void recordHistory(bool enabled, size_t max_entries, CreateContextFn context_recorder);
+// Returns the recorded events of device, oldest first.
+C10_CUDA_API std::vector<TraceEntry> memoryHistory(int device);
+// Serves the allocations of stream from the named pool of device, or from the
+// default pools of the device if name is empty. See Note [Stream pools] in
+// CUDACachingAllocator.cpp.
+C10_CUDA_API void setStreamPool(int device, cudaStream_t stream, const std::string& name);
+// Applies settings in the format of the PYTORCH_CUDA_ALLOC_CONF environment
+// variable, see CachingAllocatorConfig in CUDACachingAllocator.cpp.
+C10_CUDA_API void setAllocatorSettings(const std::string& settings);
+
+// CUDAGraph interactions
+C10_CUDA_API void notifyCaptureBegin(int device, cudaStream_t stream, MempoolId_t mempool_id);
+C10_CUDA_API void notifyCaptureEnd(int device, cudaStream_t stream);
+C10_CUDA_API void notifyCaptureDestroy(int device, MempoolId_t mempool_id);
 
 C10_CUDA_API std::mutex* getFreeMutex();
 
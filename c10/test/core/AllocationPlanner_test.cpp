@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <c10/core/AllocationPlanner.h>
+#include <c10/core/CPUAllocator.h>
+
+using c10::AllocationPlanner;
+using c10::AllocationPlannerGuard;
+
+namespace {
+// a -> b -> c like three layers, where a is dead once c is allocated, and
+// c is the output
+at::DataPtr run(at::Allocator* allocator, size_t size = 1000) {
+  auto a = allocator->allocate(size);
+  auto b = allocator->allocate(2 * size);
+  a.clear();
+  auto c = allocator->allocate(size);
+  b.clear();
+  return c;
+}
+} // namespace
+
+TEST(AllocationPlannerTest, FirstRunIsRecorded) {
+  AllocationPlanner planner;
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  at::DataPtr output;
+  {
+    AllocationPlannerGuard guard(&planner);
+    ASSERT_EQ(c10::GetThreadLocalAllocationPlanner(), &planner);
+    output = run(allocator);
+  }
+  ASSERT_EQ(c10::GetThreadLocalAllocationPlanner(), nullptr);
+  ASSERT_TRUE(planner.has_plan());
+  auto stats = planner.stats();
+  ASSERT_EQ(stats.recorded_runs, 1);
+  ASSERT_EQ(stats.hits, 0);
+  // the output outlives the run and is not planned
+  ASSERT_EQ(stats.planned_allocations, 2);
+  ASSERT_EQ(stats.unshared_bytes, 1024 + 2048);
+  ASSERT_EQ(stats.planned_bytes, 1024 + 2048);
+}
+
+TEST(AllocationPlannerTest, PlannedRunsShareMemory) {
+  AllocationPlanner planner;
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 3; i++) {
+    AllocationPlannerGuard guard(&planner);
+    auto a = allocator->allocate(1000);
+    ptrs.push_back(a.get());
+    a.clear();
+    auto b = allocator->allocate(1000);
+    ptrs.push_back(b.get());
+  }
+  // a is dead before b is allocated, they share memory
+  auto stats = planner.stats();
+  ASSERT_EQ(stats.planned_bytes, 1024);
+  ASSERT_EQ(stats.unshared_bytes, 2048);
+  ASSERT_EQ(stats.recorded_runs, 1);
+  ASSERT_EQ(stats.hits, 4);
+  ASSERT_EQ(stats.misses, 0);
+  for (size_t i = 3; i < ptrs.size(); i++) {
+    ASSERT_EQ(ptrs[i], ptrs[2]);
+  }
+}
+
+TEST(AllocationPlannerTest, OutputsAreNotPlanned) {
+  AllocationPlanner planner;
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  std::vector<at::DataPtr> outputs;
+  for (int i = 0; i < 3; i++) {
+    AllocationPlannerGuard guard(&planner);
+    outputs.push_back(run(allocator));
+  }
+  auto stats = planner.stats();
+  ASSERT_EQ(stats.recorded_runs, 1);
+  ASSERT_EQ(stats.hits, 4);
+  ASSERT_EQ(stats.misses, 0);
+  ASSERT_NE(outputs[1].get(), outputs[2].get());
+}
+
+TEST(AllocationPlannerTest, DeviatingRunIsRecordedAgain) {
+  AllocationPlanner planner;
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  {
+    AllocationPlannerGuard guard(&planner);
+    run(allocator);
+  }
+  {
+    AllocationPlannerGuard guard(&planner);
+    run(allocator, 5000);
+  }
+  auto stats = planner.stats();
+  ASSERT_EQ(stats.hits, 0);
+  ASSERT_EQ(stats.misses, 3);
+  {
+    AllocationPlannerGuard guard(&planner);
+    run(allocator, 5000);
+  }
+  ASSERT_EQ(planner.stats().recorded_runs, 2);
+  {
+    AllocationPlannerGuard guard(&planner);
+    run(allocator, 5000);
+  }
+  // the output is freed inside the run, so it is planned too
+  ASSERT_EQ(planner.stats().hits, 3);
+}
+
+TEST(AllocationPlannerTest, LiveMemoryIsNotHandedOut) {
+  AllocationPlanner planner;
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  {
+    AllocationPlannerGuard guard(&planner);
+    allocator->allocate(1000);
+  }
+  at::DataPtr kept;
+  {
+    AllocationPlannerGuard guard(&planner);
+    kept = allocator->allocate(1000);
+  }
+  ASSERT_EQ(planner.stats().hits, 1);
+  {
+    AllocationPlannerGuard guard(&planner);
+    auto other = allocator->allocate(1000);
+    ASSERT_NE(other.get(), kept.get());
+  }
+  ASSERT_EQ(planner.stats().misses, 1);
+  // planned memory can be freed anywhere
+  std::thread([&]() { kept.clear(); }).join();
+  planner.reset();
+  ASSERT_FALSE(planner.has_plan());
+}
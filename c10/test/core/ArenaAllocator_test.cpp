@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <c10/core/ArenaAllocator.h>
+#include <c10/core/CPUAllocator.h>
+
+using c10::ArenaAllocator;
+using c10::ArenaAllocatorGuard;
+
+TEST(ArenaAllocatorTest, GuardRoutesCPUAllocations) {
+  ArenaAllocator arena(c10::GetDefaultCPUAllocator(), 1 << 20);
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  auto outside = allocator->allocate(100);
+  ASSERT_FALSE(arena.contains(outside.get()));
+  {
+    ArenaAllocatorGuard guard(&arena);
+    ASSERT_EQ(c10::GetThreadLocalArenaAllocator(c10::DeviceType::CPU), &arena);
+    auto a = allocator->allocate(100);
+    auto b = allocator->allocate(100);
+    ASSERT_TRUE(arena.contains(a.get()));
+    ASSERT_TRUE(arena.contains(b.get()));
+    // bumped by whole alignment units
+    ASSERT_EQ(static_cast<char*>(b.get()) - static_cast<char*>(a.get()), 128);
+    ASSERT_EQ(arena.stats().used_bytes, 256);
+  }
+  ASSERT_EQ(c10::GetThreadLocalArenaAllocator(c10::DeviceType::CPU), nullptr);
+  auto stats = arena.stats();
+  ASSERT_EQ(stats.allocations, 2);
+  ASSERT_EQ(stats.used_bytes, 0);
+  ASSERT_EQ(stats.peak_bytes, 256);
+  ASSERT_EQ(stats.rewinds, 1);
+}
+
+TEST(ArenaAllocatorTest, SteadyStateReusesMemory) {
+  ArenaAllocator arena(c10::GetDefaultCPUAllocator(), 1 << 20);
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  void* first = nullptr;
+  for (int i = 0; i < 10; i++) {
+    ArenaAllocatorGuard guard(&arena);
+    auto a = allocator->allocate(1000);
+    auto b = allocator->allocate(5000);
+    if (first == nullptr) {
+      first = a.get();
+    }
+    ASSERT_EQ(a.get(), first);
+  }
+  ASSERT_EQ(arena.stats().rewinds, 10);
+  ASSERT_EQ(arena.stats().overflows, 0);
+}
+
+TEST(ArenaAllocatorTest, OverflowFallsBack) {
+  ArenaAllocator arena(c10::GetDefaultCPUAllocator(), 1024);
+  ArenaAllocatorGuard guard(&arena);
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  auto a = allocator->allocate(1000);
+  auto b = allocator->allocate(1000);
+  ASSERT_TRUE(arena.contains(a.get()));
+  ASSERT_FALSE(arena.contains(b.get()));
+  ASSERT_NE(b.get(), nullptr);
+  ASSERT_EQ(arena.stats().overflows, 1);
+  ASSERT_EQ(arena.stats().overflow_bytes, 1000);
+  b.clear();
+  ASSERT_EQ(arena.stats().used_bytes, 1024);
+}
+
+TEST(ArenaAllocatorTest, LiveAllocationsOutlastGuard) {
+  ArenaAllocator arena(c10::GetDefaultCPUAllocator(), 1 << 20);
+  auto* allocator = c10::GetDefaultCPUAllocator();
+  c10::DataPtr kept;
+  {
+    ArenaAllocatorGuard guard(&arena);
+    kept = allocator->allocate(100);
+    auto temporary = allocator->allocate(100);
+  }
+  // Not rewound while an allocation is alive.
+  ASSERT_EQ(arena.stats().rewinds, 0);
+  ASSERT_EQ(arena.stats().used_bytes, 128 * 2);
+  ASSERT_THROW(arena.resize(1 << 21), c10::Error);
+  // Freed on another thread, outside of any guard.
+  std::thread([&]() { kept.clear(); }).join();
+  ASSERT_EQ(arena.stats().rewinds, 1);
+  arena.resize(1 << 21);
+  ASSERT_EQ(arena.stats().capacity, 1 << 21);
+}
+
+TEST(ArenaAllocatorTest, ConcurrentAllocations) {
+  ArenaAllocator arena(c10::GetDefaultCPUAllocator(), 1 << 20);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&]() {
+      ArenaAllocatorGuard guard(&arena);
+      auto* allocator = c10::GetDefaultCPUAllocator();
+      for (int i = 0; i < 1000; i++) {
+        auto data = allocator->allocate(64);
+        static_cast<char*>(data.get())[63] = 1;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stats = arena.stats();
+  ASSERT_EQ(stats.allocations + stats.overflows, 4000);
+  ASSERT_EQ(stats.used_bytes, 0);
+}
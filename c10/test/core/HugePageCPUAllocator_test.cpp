@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/HugePageCPUAllocator.h>
+
+using c10::HugePageCPUAllocator;
+
+constexpr size_t kMB = 1024 * 1024;
+
+TEST(HugePageCPUAllocatorTest, SmallAllocationsTakeDefaultPath) {
+  HugePageCPUAllocator allocator(HugePageCPUAllocator::Mode::kTransparent, 4 * kMB);
+  auto data = allocator.allocate(1024);
+  ASSERT_NE(data.get(), nullptr);
+  ASSERT_EQ(allocator.stats().transparent_bytes, 0);
+  ASSERT_EQ(allocator.stats().explicit_bytes, 0);
+}
+
+#if defined(__linux__)
+TEST(HugePageCPUAllocatorTest, TransparentHugePages) {
+  HugePageCPUAllocator allocator(HugePageCPUAllocator::Mode::kTransparent, 4 * kMB);
+  {
+    auto data = allocator.allocate(8 * kMB + 1);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data.get()) % HugePageCPUAllocator::kHugePageSize, 0);
+    ASSERT_EQ(allocator.stats().transparent_bytes, 8 * kMB + 1);
+    static_cast<char*>(data.get())[8 * kMB] = 1;
+  }
+  ASSERT_EQ(allocator.stats().transparent_bytes, 0);
+}
+
+TEST(HugePageCPUAllocatorTest, ExplicitHugePagesOrFallback) {
+  HugePageCPUAllocator allocator(HugePageCPUAllocator::Mode::kExplicit, 4 * kMB);
+  {
+    auto data = allocator.allocate(5 * kMB);
+    ASSERT_NE(data.get(), nullptr);
+    auto stats = allocator.stats();
+    if (stats.explicit_fallbacks == 0) {
+      // rounded up to whole huge pages
+      ASSERT_EQ(stats.explicit_bytes, 6 * kMB);
+    } else {
+      // no huge pages reserved on this machine
+      ASSERT_EQ(stats.transparent_bytes, 5 * kMB);
+    }
+  }
+  ASSERT_EQ(allocator.stats().explicit_bytes, 0);
+  ASSERT_EQ(allocator.stats().transparent_bytes, 0);
+}
+#endif
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <c10/core/WorkStealingThreadPool.h>
+
+using c10::WorkStealingThreadPool;
+
+namespace {
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+} // namespace
+
+TEST(WorkStealingThreadPoolTest, RunsExternalTasks) {
+  WorkStealingThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+  ASSERT_FALSE(pool.inThreadPool());
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 10000; i++) {
+    pool.run([&]() { counter++; });
+  }
+  wait_for(counter, 10000);
+  ASSERT_EQ(counter.load(), 10000);
+}
+
+TEST(WorkStealingThreadPoolTest, RunsNestedTasks) {
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> counter{0};
+  std::atomic<int> in_pool{0};
+  // More nested tasks than a deque holds, the rest go to the inboxes.
+  for (int i = 0; i < 4; i++) {
+    pool.run([&]() {
+      for (int j = 0; j < 3000; j++) {
+        pool.run([&]() {
+          in_pool += pool.inThreadPool();
+          counter++;
+        });
+      }
+    });
+  }
+  wait_for(counter, 12000);
+  ASSERT_EQ(in_pool.load(), 12000);
+}
+
+TEST(WorkStealingThreadPoolTest, WakesParkedWorkers) {
+  WorkStealingThreadPool pool(2);
+  for (int i = 0; i < 3; i++) {
+    // Long enough for the workers to stop spinning.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(pool.numAvailable(), 2);
+    std::promise<void> done;
+    pool.run([&]() { done.set_value(); });
+    done.get_future().wait();
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, SurvivesThrowingTasks) {
+  WorkStealingThreadPool pool(1);
+  std::atomic<int> counter{0};
+  pool.run([]() { throw std::runtime_error("task failed"); });
+  pool.run([&]() { counter++; });
+  wait_for(counter, 1);
+}
+
+TEST(WorkStealingThreadPoolTest, NoThreads) {
+  WorkStealingThreadPool pool(0);
+  ASSERT_THROW(pool.run([]() {}), std::runtime_error);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/impl/SizesAndStrides.h>
+
+using namespace c10;
+using namespace c10::impl;
+
+static void checkData(
+    const SizesAndStrides& sz,
+    IntArrayRef sizes,
+    IntArrayRef strides) {
+  ASSERT_EQ(sizes.size(), strides.size());
+  ASSERT_EQ(sz.size(), sizes.size());
+  EXPECT_EQ(sz.sizes_arrayref(), sizes);
+  EXPECT_EQ(sz.strides_arrayref(), strides);
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    EXPECT_EQ(sz.size_at(i), sizes[i]);
+    EXPECT_EQ(sz.stride_at(i), strides[i]);
+  }
+}
+
+static SizesAndStrides makeOutOfLine() {
+  SizesAndStrides sz;
+  sz.resize(7);
+  for (int i = 0; i < 7; ++i) {
+    sz.size_at(i) = i + 10;
+    sz.stride_at(i) = i + 20;
+  }
+  return sz;
+}
+
+TEST(SizesAndStridesTest, DefaultConstructor) {
+  SizesAndStrides sz;
+  checkData(sz, {0}, {1});
+}
+
+TEST(SizesAndStridesTest, SetSizes) {
+  SizesAndStrides sz;
+  sz.set_sizes({5, 6, 7, 8});
+  checkData(sz, {5, 6, 7, 8}, {1, 0, 0, 0});
+}
+
+TEST(SizesAndStridesTest, Resize) {
+  SizesAndStrides sz;
+  sz.resize(2);
+  checkData(sz, {0, 0}, {1, 0});
+  sz.size_at(1) = 1;
+  sz.stride_at(1) = 2;
+
+  // Inline to out of line, and back
+  sz.resize(7);
+  checkData(sz, {0, 1, 0, 0, 0, 0, 0}, {1, 2, 0, 0, 0, 0, 0});
+  sz.size_at(6) = 3;
+  sz.stride_at(6) = 4;
+  sz.resize(9);
+  checkData(sz, {0, 1, 0, 0, 0, 0, 3, 0, 0}, {1, 2, 0, 0, 0, 0, 4, 0, 0});
+  sz.resize(7);
+  checkData(sz, {0, 1, 0, 0, 0, 0, 3}, {1, 2, 0, 0, 0, 0, 4});
+  sz.resize(3);
+  checkData(sz, {0, 1, 0}, {1, 2, 0});
+  sz.resize(0);
+  checkData(sz, {}, {});
+}
+
+TEST(SizesAndStridesTest, Copy) {
+  SizesAndStrides out_of_line = makeOutOfLine();
+  SizesAndStrides inline_sz;
+  inline_sz.set_sizes({3, 4});
+
+  SizesAndStrides copy(out_of_line);
+  checkData(copy, {10, 11, 12, 13, 14, 15, 16}, {20, 21, 22, 23, 24, 25, 26});
+  copy = inline_sz;
+  checkData(copy, {3, 4}, {1, 0});
+  copy = out_of_line;
+  checkData(copy, {10, 11, 12, 13, 14, 15, 16}, {20, 21, 22, 23, 24, 25, 26});
+  out_of_line.resize(9);
+  copy = out_of_line;
+  checkData(
+      copy, {10, 11, 12, 13, 14, 15, 16, 0, 0}, {20, 21, 22, 23, 24, 25, 26, 0, 0});
+  const SizesAndStrides& self = copy;
+  copy = self;
+  checkData(
+      copy, {10, 11, 12, 13, 14, 15, 16, 0, 0}, {20, 21, 22, 23, 24, 25, 26, 0, 0});
+}
+
+TEST(SizesAndStridesTest, Move) {
+  SizesAndStrides out_of_line = makeOutOfLine();
+  SizesAndStrides moved(std::move(out_of_line));
+  checkData(moved, {10, 11, 12, 13, 14, 15, 16}, {20, 21, 22, 23, 24, 25, 26});
+  EXPECT_EQ(out_of_line.size(), 0);
+
+  SizesAndStrides inline_sz;
+  inline_sz.set_sizes({3, 4});
+  moved = std::move(inline_sz);
+  checkData(moved, {3, 4}, {1, 0});
+  EXPECT_EQ(inline_sz.size(), 0);
+
+  moved = makeOutOfLine();
+  checkData(moved, {10, 11, 12, 13, 14, 15, 16}, {20, 21, 22, 23, 24, 25, 26});
+}
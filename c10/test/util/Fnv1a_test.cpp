@@ -0,0 +1,11 @@
+#include <c10/util/Fnv1a.h>
+
+using c10::util::fnv1a64;
+
+// check concrete expected values of 64-bit FNV-1a
+static_assert(fnv1a64("") == 0xcbf29ce484222325ULL, "");
+static_assert(fnv1a64("a") == 0xaf63dc4c8601ec8cULL, "");
+static_assert(fnv1a64("foobar") == 0x85944171f73967e8ULL, "");
+
+// hashing in pieces is the same as hashing the concatenation
+static_assert(fnv1a64("bar", fnv1a64("foo")) == fnv1a64("foobar"), "");
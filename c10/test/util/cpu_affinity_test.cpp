@@ -0,0 +1,39 @@
+#include <c10/util/Exception.h>
+#include <c10/util/cpu_affinity.h>
+#include <gtest/gtest.h>
+
+namespace {
+TEST(CPUAffinityTest, ParseCPUList) {
+  EXPECT_EQ(c10::ParseCPUList("0"), std::vector<int>({0}));
+  EXPECT_EQ(c10::ParseCPUList("0-3,8"), std::vector<int>({0, 1, 2, 3, 8}));
+  EXPECT_EQ(c10::ParseCPUList("10-11,4"), std::vector<int>({10, 11, 4}));
+  EXPECT_TRUE(c10::ParseCPUList("").empty());
+}
+
+TEST(CPUAffinityTest, ParseInvalidCPUList) {
+  for (const char* cpu_list : {"a", "1,", ",1", "3-1", "1-", "-1", "1;2"}) {
+    EXPECT_THROW(c10::ParseCPUList(cpu_list), c10::Error) << cpu_list;
+  }
+}
+
+TEST(CPUAffinityTest, FormatCPUList) {
+  EXPECT_EQ(c10::FormatCPUList({8, 0, 1, 2, 3, 3}), "0-3,8");
+  EXPECT_EQ(c10::FormatCPUList({5, 7}), "5,7");
+  EXPECT_EQ(c10::FormatCPUList({}), "");
+  EXPECT_EQ(
+      c10::FormatCPUList(c10::ParseCPUList("0-3,6,10-11")), "0-3,6,10-11");
+}
+
+#if defined(__linux__)
+TEST(CPUAffinityTest, ThreadAffinity) {
+  auto cpus = c10::GetThreadAffinity();
+  ASSERT_FALSE(cpus.empty());
+  ASSERT_TRUE(c10::SetThreadAffinity({cpus[0]}));
+  EXPECT_EQ(c10::GetThreadAffinity(), std::vector<int>({cpus[0]}));
+  ASSERT_TRUE(c10::SetThreadAffinity(cpus));
+  EXPECT_EQ(c10::GetThreadAffinity(), cpus);
+  EXPECT_FALSE(c10::SetThreadAffinity({}));
+  EXPECT_FALSE(c10::SetThreadAffinity({-1}));
+}
+#endif // defined(__linux__)
+} // namespace
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <map>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -3382,3 +3383,31 @@ TEST(WeakIntrusivePtrTest, givenStackObject_whenReclaimed_thenCrashes) {
   EXPECT_ANY_THROW(ptr = weak_intrusive_ptr<SomeClass>::reclaim(&obj));
 #endif
 }
+
+TEST(IntrusivePtrTest, givenPtrSharedWithThreads_whenLastOwnerIsAThread_thenDestructsOnce) {
+  for (int iteration = 0; iteration < 100; ++iteration) {
+    bool resourcesReleased = false;
+    bool wasDestructed = false;
+    auto obj = make_intrusive<DestructableMock>(&resourcesReleased, &wasDestructed);
+    weak_intrusive_ptr<DestructableMock> weak(obj);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([obj, weak]() {
+        for (int j = 0; j < 100; ++j) {
+          intrusive_ptr<DestructableMock> copy = obj;
+          intrusive_ptr<DestructableMock> locked = weak.lock();
+          EXPECT_TRUE(locked.defined());
+        }
+      });
+    }
+    obj.reset();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_TRUE(resourcesReleased);
+    EXPECT_FALSE(wasDestructed);
+    EXPECT_FALSE(weak.lock().defined());
+    weak.reset();
+    EXPECT_TRUE(wasDestructed);
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+#include <c10/util/string_view.h>
+#include <cstdint>
+
+namespace c10 {
+namespace util {
+
+constexpr uint64_t kFnv1a64OffsetBasis = 14695981039346656037ULL;
+
+// 64-bit FNV-1a of `str`, continuing from `hash` so that several strings can
+// be hashed as one. Unlike std::hash it is stable across builds and
+// platforms, so it can name files that outlive the process.
+inline C10_HOST_CONSTEXPR uint64_t
+fnv1a64(c10::string_view str, uint64_t hash = kFnv1a64OffsetBasis) {
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+} // namespace util
+} // namespace c10
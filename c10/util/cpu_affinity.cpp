@@ -0,0 +1,123 @@
+#include <c10/util/cpu_affinity.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+#include <c10/util/Exception.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace c10 {
+
+namespace {
+int parse_cpu(const std::string& cpu_list, size_t& pos) {
+  const size_t start = pos;
+  while (pos < cpu_list.size() && std::isdigit(cpu_list[pos])) {
+    pos++;
+  }
+  TORCH_CHECK(
+      pos > start && pos - start < 8,
+      "invalid CPU list \"",
+      cpu_list,
+      "\", expected a list like 0-3,8");
+  return std::atoi(cpu_list.substr(start, pos - start).c_str());
+}
+} // namespace
+
+std::vector<int> ParseCPUList(const std::string& cpu_list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < cpu_list.size()) {
+    const int first = parse_cpu(cpu_list, pos);
+    int last = first;
+    if (pos < cpu_list.size() && cpu_list[pos] == '-') {
+      pos++;
+      last = parse_cpu(cpu_list, pos);
+      TORCH_CHECK(
+          first <= last, "invalid CPU range ", first, "-", last, " in CPU list");
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+    if (pos < cpu_list.size()) {
+      TORCH_CHECK(
+          cpu_list[pos] == ',' && pos + 1 < cpu_list.size(),
+          "invalid CPU list \"",
+          cpu_list,
+          "\", expected a list like 0-3,8");
+      pos++;
+    }
+  }
+  return cpus;
+}
+
+std::string FormatCPUList(std::vector<int> cpus) {
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  std::ostringstream ss;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      j++;
+    }
+    if (i > 0) {
+      ss << ",";
+    }
+    ss << cpus[i];
+    if (j > i) {
+      ss << "-" << cpus[j];
+    }
+    i = j + 1;
+  }
+  return ss.str();
+}
+
+#if defined(__linux__)
+
+bool SetThreadAffinity(const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+std::vector<int> GetThreadAffinity() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+#else // defined(__linux__)
+
+bool SetThreadAffinity(const std::vector<int>& /*cpus*/) {
+  return false;
+}
+
+std::vector<int> GetThreadAffinity() {
+  return {};
+}
+
+#endif // defined(__linux__)
+
+} // namespace c10
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+/**
+ * Parse a CPU list like "0-3,8,10-11", the format of taskset and of
+ * /sys/devices/system/cpu/online, into CPU ids
+ */
+C10_API std::vector<int> ParseCPUList(const std::string& cpu_list);
+
+/**
+ * Format CPU ids as a CPU list, the inverse of ParseCPUList
+ */
+C10_API std::string FormatCPUList(std::vector<int> cpus);
+
+/**
+ * Restrict the calling thread to the given CPUs. Returns false if the CPUs
+ * are not available or thread affinity is not supported on this platform
+ */
+C10_API bool SetThreadAffinity(const std::vector<int>& cpus);
+
+/**
+ * Get the CPUs the calling thread may run on, empty if unknown
+ */
+C10_API std::vector<int> GetThreadAffinity();
+
+} // namespace c10
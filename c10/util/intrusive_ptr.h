@@ -63,6 +63,9 @@ class C10_API intrusive_ptr_target {
   //    atomically increment the use count, if it is greater than 0.
   //    If it is not, you must report that the storage is dead.
   //
+  // See Note [Refcount memory order] for the atomic operations on the
+  // counts.
+  //
   mutable std::atomic<size_t> refcount_;
   mutable std::atomic<size_t> weakcount_;
 
@@ -134,6 +137,41 @@ class C10_API intrusive_ptr_target {
 };
 
 namespace detail {
+
+// Note [Refcount memory order]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Copying a Tensor or an IValue increments a refcount and destroying it
+// decrements one, so these are among the hottest atomic operations we do.
+// They only use the memory orders they need:
+//
+//  - An increment is relaxed. It needs an existing reference, so it cannot
+//    race with the destruction of the object, and it publishes nothing.
+//
+//  - A decrement is acquire-release, so that the writes of all the owners
+//    happen before the destruction by the last one.
+//
+//  - A new object is not shared yet, so make_intrusive() initializes the
+//    counts with relaxed stores. Sharing it later synchronizes anyway.
+//
+//  - Once refcount reached 0, weakcount == 1 means that there are no weak
+//    references, and none can be created anymore, so the object is deleted
+//    without decrementing weakcount. An acquire load is enough to see the
+//    writes of the previous weak owners, which released their references
+//    with acquire-release decrements.
+//
+// So the common case of a temporary, which is created and destroyed by one
+// thread and never referenced weakly, costs one atomic read-modify-write
+// instead of four. Copies still increment atomically: a count that only the
+// owning thread can update non-atomically would break use_count() and
+// unique(), which must be exact whichever thread asks.
+inline size_t atomic_refcount_increment(std::atomic<size_t>& refcount) {
+  return refcount.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+inline size_t atomic_refcount_decrement(std::atomic<size_t>& refcount) {
+  return refcount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+}
+
 template <class TTarget>
 struct intrusive_target_default_null_type final {
   static constexpr TTarget* singleton() noexcept {
@@ -184,7 +222,8 @@ class intrusive_ptr final {
 
   void retain_() {
     if (target_ != NullType::singleton()) {
-      size_t new_refcount = ++target_->refcount_;
+      size_t new_refcount =
+          detail::atomic_refcount_increment(target_->refcount_);
       TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
           new_refcount != 1,
           "intrusive_ptr: Cannot increase refcount after it reached zero.");
@@ -192,15 +231,20 @@ class intrusive_ptr final {
   }
 
   void reset_() noexcept {
-    if (target_ != NullType::singleton() && --target_->refcount_ == 0) {
+    if (target_ != NullType::singleton() &&
+        detail::atomic_refcount_decrement(target_->refcount_) == 0) {
       // justification for const_cast: release_resources is basically a destructor
       // and a destructor always mutates the object, even for const objects.
       const_cast<std::remove_const_t<TTarget>*>(target_)->release_resources();
 
       // See comment above about weakcount. As long as refcount>0,
       // weakcount is one larger than the actual number of weak references.
-      // So we need to decrement it here.
-      if (--target_->weakcount_ == 0) {
+      // So we need to decrement it here, unless there are no weak
+      // references, see Note [Refcount memory order].
+      if (target_->weakcount_.load(std::memory_order_acquire) == 1) {
+        target_->weakcount_.store(0, std::memory_order_relaxed);
+        delete target_;
+      } else if (detail::atomic_refcount_decrement(target_->weakcount_) == 0) {
         delete target_;
       }
     }
@@ -355,9 +399,10 @@ class intrusive_ptr final {
     auto result = intrusive_ptr(new TTarget(std::forward<Args>(args)...));
     // We can't use retain_(), because we also have to increase weakcount
     // and because we allow raising these values from 0, which retain_()
-    // has an assertion against.
-    ++result.target_->refcount_;
-    ++result.target_->weakcount_;
+    // has an assertion against. Nobody else can see the object yet, see
+    // Note [Refcount memory order].
+    result.target_->refcount_.store(1, std::memory_order_relaxed);
+    result.target_->weakcount_.store(1, std::memory_order_relaxed);
 
     return result;
   }
@@ -441,7 +486,8 @@ class weak_intrusive_ptr final {
 
   void retain_() {
     if (target_ != NullType::singleton()) {
-      size_t new_weakcount = ++target_->weakcount_;
+      size_t new_weakcount =
+          detail::atomic_refcount_increment(target_->weakcount_);
       TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
           new_weakcount != 1,
           "weak_intrusive_ptr: Cannot increase weakcount after it reached zero.");
@@ -449,7 +495,8 @@ class weak_intrusive_ptr final {
   }
 
   void reset_() noexcept {
-    if (target_ != NullType::singleton() && --target_->weakcount_ == 0) {
+    if (target_ != NullType::singleton() &&
+        detail::atomic_refcount_decrement(target_->weakcount_) == 0) {
       delete target_;
     }
     target_ = NullType::singleton();
@@ -590,7 +637,8 @@ class weak_intrusive_ptr final {
         // Return nullptr.
         return intrusive_ptr<TTarget, NullType>(NullType::singleton());
       }
-    } while (!target_->refcount_.compare_exchange_weak(refcount, refcount + 1));
+    } while (!target_->refcount_.compare_exchange_weak(
+        refcount, refcount + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
     return intrusive_ptr<TTarget, NullType>(target_);
   }
 
@@ -692,7 +740,7 @@ namespace intrusive_ptr {
   // NullType::singleton to this function
   inline void incref(intrusive_ptr_target* self) {
     if (self) {
-      ++self->refcount_;
+      detail::atomic_refcount_increment(self->refcount_);
     }
   }
 
@@ -726,7 +774,7 @@ namespace intrusive_ptr {
 namespace weak_intrusive_ptr {
 
   inline void incref(weak_intrusive_ptr_target* self) {
-    ++self->weakcount_;
+    detail::atomic_refcount_increment(self->weakcount_);
   }
 
   inline void decref(weak_intrusive_ptr_target* self) {
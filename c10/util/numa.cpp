@@ -19,6 +19,10 @@ bool IsNUMAEnabled() {
   return FLAGS_caffe2_cpu_numa_enabled && numa_available() >= 0;
 }
 
+void SetNUMAEnabled(bool enabled) {
+  FLAGS_caffe2_cpu_numa_enabled = enabled;
+}
+
 void NUMABind(int numa_node_id) {
   if (numa_node_id < 0) {
     return;
@@ -94,6 +98,38 @@ void NUMAMove(void* ptr, size_t size, int numa_node_id) {
       "Could not move memory to a NUMA node");
 }
 
+void NUMAPlace(void* ptr, size_t size, int numa_node_id) {
+  if (numa_node_id < 0) {
+    return;
+  }
+  if (!IsNUMAEnabled()) {
+    return;
+  }
+  AT_ASSERT(ptr);
+
+  // Only whole pages are rebound: a page the range shares with another
+  // allocation keeps the placement of whoever touched it first.
+  const uintptr_t page_size = getpagesize();
+  uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+  uintptr_t page_begin = (begin + page_size - 1) & ~(page_size - 1);
+  uintptr_t page_end = (begin + size) & ~(page_size - 1);
+  if (page_end <= page_begin) {
+    return;
+  }
+  AT_ASSERT(static_cast<unsigned>(numa_node_id) < sizeof(unsigned long) * 8);
+  unsigned long mask = 1UL << numa_node_id;
+  // MPOL_PREFERRED falls back to other nodes when this one is full, and
+  // without MPOL_MF_STRICT pages that are in use elsewhere stay put. Both
+  // are fine for a placement hint, so the result is deliberately ignored.
+  mbind(
+      reinterpret_cast<void*>(page_begin),
+      page_end - page_begin,
+      MPOL_PREFERRED,
+      &mask,
+      sizeof(mask) * 8,
+      MPOL_MF_MOVE);
+}
+
 int GetCurrentNUMANode() {
   if (!IsNUMAEnabled()) {
     return -1;
@@ -109,6 +145,10 @@ bool IsNUMAEnabled() {
   return false;
 }
 
+void SetNUMAEnabled(bool enabled) {
+  FLAGS_caffe2_cpu_numa_enabled = enabled;
+}
+
 void NUMABind(int numa_node_id) {
 }
 
@@ -123,6 +163,9 @@ int GetNumNUMANodes() {
 void NUMAMove(void* ptr, size_t size, int numa_node_id) {
 }
 
+void NUMAPlace(void* ptr, size_t size, int numa_node_id) {
+}
+
 int GetCurrentNUMANode() {
   return -1;
 }
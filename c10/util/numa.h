@@ -12,6 +12,12 @@ namespace c10 {
  */
 C10_API bool IsNUMAEnabled();
 
+/**
+ * Enable or disable NUMA placement at runtime, overriding the
+ * caffe2_cpu_numa_enabled flag
+ */
+C10_API void SetNUMAEnabled(bool enabled);
+
 /**
  * Bind to a given NUMA node
  */
@@ -32,6 +38,13 @@ C10_API int GetNumNUMANodes();
  */
 C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
 
+/**
+ * Ask for the pages lying entirely within [ptr, ptr + size) to be placed on a
+ * given NUMA node. Unlike NUMAMove this never touches pages shared with
+ * neighbouring allocations and silently keeps pages that cannot be moved
+ */
+C10_API void NUMAPlace(void* ptr, size_t size, int numa_node_id);
+
 /**
  * Get the current NUMA node id
  */
@@ -1,5 +1,6 @@
 #include "caffe2/core/db.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "caffe2/core/blob_serialization.h"
@@ -173,6 +174,147 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+DBPrefetcher::DBPrefetcher(
+    DB* db,
+    Cursor* cursor,
+    const uint32_t num_shards,
+    const uint32_t shard_id,
+    const int num_cursors,
+    const int window_size,
+    const int batch_size)
+    : num_shards_(num_shards), shard_id_(shard_id) {
+  CAFFE_ENFORCE_GE(num_cursors, 1);
+  CAFFE_ENFORCE_GE(window_size, num_cursors);
+  CAFFE_ENFORCE_GE(batch_size, 1);
+  stream_window_size_ = (window_size + num_cursors - 1) / num_cursors;
+  batch_size_ = std::min<size_t>(batch_size, stream_window_size_);
+  if (num_cursors > 1) {
+    CAFFE_ENFORCE(
+        db->SupportsConcurrentCursors() && cursor->SupportsSeek(),
+        "Prefetching with more than one cursor needs a db that supports "
+        "concurrent cursors and seeking.");
+  }
+
+  for (int i = 0; i < num_cursors; ++i) {
+    streams_.emplace_back(new Stream());
+    auto& stream = *streams_.back();
+    if (i == 0) {
+      stream.cursor = cursor;
+    } else {
+      // Each cursor starts one record after the previous one.
+      stream.owned_cursor = db->NewCursor();
+      stream.cursor = stream.owned_cursor.get();
+      stream.cursor->Seek(streams_[i - 1]->cursor->key());
+      Next(stream.cursor);
+    }
+  }
+  for (auto& stream : streams_) {
+    stream->thread = std::thread(&DBPrefetcher::Prefetch, this, stream.get());
+  }
+}
+
+DBPrefetcher::~DBPrefetcher() {
+  stopping_ = true;
+  for (auto& stream : streams_) {
+    // Taking the lock makes sure the thread either sees stopping_ or waits.
+    { std::lock_guard<std::mutex> lock(stream->mutex); }
+    stream->not_full.notify_one();
+  }
+  for (auto& stream : streams_) {
+    stream->thread.join();
+  }
+}
+
+void DBPrefetcher::Next(Cursor* cursor) const {
+  for (uint32_t s = 0; s < num_shards_; s++) {
+    cursor->Next();
+    if (!cursor->Valid()) {
+      cursor->SeekToFirst();
+      for (uint32_t t = 0; t < shard_id_; t++) {
+        cursor->Next();
+        CAFFE_ENFORCE(
+            cursor->Valid(), "Db has fewer rows than shard id: ", t, shard_id_);
+      }
+      break;
+    }
+  }
+}
+
+void DBPrefetcher::Prefetch(Stream* stream) {
+  std::vector<std::pair<string, string>> batch;
+  batch.reserve(batch_size_);
+  try {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(stream->mutex);
+        stream->not_full.wait(lock, [&] {
+          return stopping_ ||
+              stream->records.size() + batch_size_ <= stream_window_size_;
+        });
+        if (stopping_) {
+          return;
+        }
+      }
+
+      // Read without holding the lock, the cursor is only used here.
+      batch.clear();
+      for (size_t i = 0; i < batch_size_; ++i) {
+        batch.emplace_back(stream->cursor->key(), stream->cursor->value());
+        for (size_t s = 0; s < streams_.size(); ++s) {
+          Next(stream->cursor);
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        for (auto& record : batch) {
+          stream->records.push_back(std::move(record));
+        }
+      }
+      stream->not_empty.notify_one();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(stream->mutex);
+      stream->error = std::current_exception();
+    }
+    stream->not_empty.notify_one();
+  }
+}
+
+DBPrefetcher::Stream& DBPrefetcher::WaitForNextStream(
+    std::unique_lock<std::mutex>* lock) {
+  auto& stream = *streams_[next_stream_];
+  *lock = std::unique_lock<std::mutex>(stream.mutex);
+  stream.not_empty.wait(
+      *lock, [&] { return !stream.records.empty() || stream.error; });
+  if (stream.records.empty()) {
+    std::rethrow_exception(stream.error);
+  }
+  return stream;
+}
+
+void DBPrefetcher::Read(string* key, string* value) {
+  std::unique_lock<std::mutex> lock;
+  auto& stream = WaitForNextStream(&lock);
+  auto& record = stream.records.front();
+  *key = std::move(record.first);
+  *value = std::move(record.second);
+  stream.records.pop_front();
+  const bool has_room =
+      stream.records.size() + batch_size_ <= stream_window_size_;
+  lock.unlock();
+  if (has_room) {
+    stream.not_full.notify_one();
+  }
+  next_stream_ = (next_stream_ + 1) % streams_.size();
+}
+
+string DBPrefetcher::NextKey() {
+  std::unique_lock<std::mutex> lock;
+  return WaitForNextStream(&lock).records.front().first;
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -185,7 +327,11 @@ void DBReaderSerializer::Serialize(
   proto.set_source(reader.source_);
   proto.set_db_type(reader.db_type_);
   if (reader.cursor() && reader.cursor()->SupportsSeek()) {
-    proto.set_key(reader.cursor()->key());
+    std::lock_guard<std::mutex> lock(reader.reader_mutex_);
+    // The cursor of a prefetching reader is ahead of what it returns.
+    proto.set_key(
+        reader.prefetcher_ ? reader.prefetcher_->NextKey()
+                           : reader.cursor_->key());
   }
   BlobProto blob_proto;
   blob_proto.set_name(name);
@@ -1,7 +1,12 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "c10/util/Registry.h"
 #include "caffe2/core/blob_serialization.h"
@@ -97,6 +102,14 @@ class CAFFE2_API DB {
    * ownership of the pointer.
    */
   virtual std::unique_ptr<Transaction> NewTransaction() = 0;
+  /**
+   * Returns whether several cursors of the database can be used at the same
+   * time from different threads. In default, returns false meaning that the
+   * db only allows one cursor at a time.
+   */
+  virtual bool SupportsConcurrentCursors() {
+    return false;
+  }
 
  protected:
   Mode mode_;
@@ -140,6 +153,72 @@ inline bool DBExists(const string& db_type, const string& full_db_name) {
   }
 }
 
+/**
+ * Reads the records of a DBReader ahead of time, in background threads.
+ *
+ * The records the reader returns are split among num_cursors cursors: the
+ * i-th cursor reads the records i, i + num_cursors, i + 2 * num_cursors, ...
+ * and Read() takes the records from the cursors in turn, so they come in the
+ * same order as without prefetching. Each cursor fetches batch_size records
+ * at a time without holding any lock, and all the cursors together stay at
+ * most window_size records ahead of Read().
+ *
+ * The first cursor is the one of the reader, the others are created from the
+ * db, which needs to support concurrent cursors and seeking for that.
+ */
+class CAFFE2_API DBPrefetcher {
+ public:
+  DBPrefetcher(
+      DB* db,
+      Cursor* cursor,
+      const uint32_t num_shards,
+      const uint32_t shard_id,
+      const int num_cursors,
+      const int window_size,
+      const int batch_size);
+  ~DBPrefetcher();
+
+  /**
+   * Reads the next record, rethrowing the error that stopped its cursor if
+   * there is no record left to read. Not thread safe.
+   */
+  void Read(string* key, string* value);
+
+  /**
+   * Returns the key of the record the next Read() returns. Not thread safe.
+   */
+  string NextKey();
+
+ private:
+  struct Stream {
+    Cursor* cursor;
+    unique_ptr<Cursor> owned_cursor;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<std::pair<string, string>> records;
+    std::exception_ptr error;
+  };
+
+  // Waits for the stream Read() takes the next record from to have one.
+  Stream& WaitForNextStream(std::unique_lock<std::mutex>* lock);
+  void Prefetch(Stream* stream);
+  // Moves the cursor to the next record of the shard, the way
+  // DBReader::Read() does.
+  void Next(Cursor* cursor) const;
+
+  const uint32_t num_shards_;
+  const uint32_t shard_id_;
+  size_t stream_window_size_;
+  size_t batch_size_;
+  std::vector<unique_ptr<Stream>> streams_;
+  size_t next_stream_{0};
+  std::atomic<bool> stopping_{false};
+
+  C10_DISABLE_COPY_AND_ASSIGN(DBPrefetcher);
+};
+
 /**
  * A reader wrapper for DB that also allows us to serialize it.
  */
@@ -184,6 +263,7 @@ class CAFFE2_API DBReader {
       const int32_t shard_id = 0) {
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_type_ = db_type;
@@ -203,6 +283,7 @@ class CAFFE2_API DBReader {
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
@@ -230,6 +311,10 @@ class CAFFE2_API DBReader {
   void Read(string* key, string* value) const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    if (prefetcher_) {
+      prefetcher_->Read(key, value);
+      return;
+    }
     *key = cursor_->key();
     *value = cursor_->value();
 
@@ -249,7 +334,56 @@ class CAFFE2_API DBReader {
   void SeekToFirst() const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    const bool prefetching = prefetcher_ != nullptr;
+    prefetcher_.reset();
     MoveToBeginning();
+    if (prefetching) {
+      ResetPrefetcher();
+    }
+  }
+
+  /**
+   * Starts reading the records ahead of time in background threads, with
+   * num_cursors cursors that together stay at most window_size records
+   * ahead, each fetching batch_size records at a time. See DBPrefetcher.
+   * Read() keeps returning the same records in the same order. Thread safe.
+   *
+   * Using more than one cursor requires a db that supports concurrent
+   * cursors and seeking, such as leveldb or lmdb.
+   */
+  void StartPrefetching(
+      const int num_cursors,
+      const int window_size,
+      const int batch_size) {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    prefetcher_.reset();
+    prefetch_cursors_ = num_cursors;
+    prefetch_window_size_ = window_size;
+    prefetch_batch_size_ = batch_size;
+    ResetPrefetcher();
+  }
+
+  /**
+   * Stops reading ahead of time. The cursor of the reader is moved back to
+   * the next record Read() would have returned if the db supports seeking,
+   * otherwise the records that were read ahead are skipped. Thread safe.
+   */
+  void StopPrefetching() {
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    if (!prefetcher_) {
+      return;
+    }
+    string key = prefetcher_->NextKey();
+    prefetcher_.reset();
+    if (cursor_->SupportsSeek()) {
+      cursor_->Seek(key);
+    }
+  }
+
+  bool IsPrefetching() const {
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    return prefetcher_ != nullptr;
   }
 
   /**
@@ -258,6 +392,8 @@ class CAFFE2_API DBReader {
    * Note that if you directly use the cursor, the read will not be thread
    * safe, because there is no mechanism to stop multiple threads from
    * accessing the same cursor. You should consider using Read() explicitly.
+   * While the reader is prefetching, the cursor is moved by a background
+   * thread.
    */
   inline Cursor* cursor() const {
     VLOG(1) << "Usually for a DBReader you should use Read() to be "
@@ -276,6 +412,17 @@ class CAFFE2_API DBReader {
     SeekToFirst();
   }
 
+  void ResetPrefetcher() const {
+    prefetcher_.reset(new DBPrefetcher(
+        db_.get(),
+        cursor_.get(),
+        num_shards_,
+        shard_id_,
+        prefetch_cursors_,
+        prefetch_window_size_,
+        prefetch_batch_size_));
+  }
+
   void MoveToBeginning() const {
     cursor_->SeekToFirst();
     for (uint32_t s = 0; s < shard_id_; s++) {
@@ -292,6 +439,11 @@ class CAFFE2_API DBReader {
   mutable std::mutex reader_mutex_;
   uint32_t num_shards_{};
   uint32_t shard_id_{};
+  // Declared after the cursor and the db, which its threads use.
+  mutable unique_ptr<DBPrefetcher> prefetcher_;
+  int prefetch_cursors_{};
+  int prefetch_window_size_{};
+  int prefetch_batch_size_{};
 
   C10_DISABLE_COPY_AND_ASSIGN(DBReader);
 };
@@ -1,5 +1,7 @@
 #include "caffe2/core/net_async_base.h"
 
+#include <algorithm>
+
 #include "caffe2/core/net_async_tracing.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
@@ -103,6 +105,15 @@ AsyncNetBase::AsyncNetBase(
     }
   }
 
+  for (int task_id = 0; task_id < tasksNum(); ++task_id) {
+    if (parents(task_id).empty()) {
+      roots_.push_back(task_id);
+    }
+  }
+  if (options_.prioritize_critical_path_) {
+    computeCriticalPaths();
+  }
+
   num_workers_ = net_def->has_num_workers() ? net_def->num_workers() : -1;
 
   tracer_ = tracing::create(this, net_def->name());
@@ -318,6 +329,83 @@ int AsyncNetBase::numOps(int task_id) const {
   return chains_[task_id].size();
 }
 
+void AsyncNetBase::computeCriticalPaths() {
+  const auto num_tasks = tasksNum();
+  std::vector<float> op_times;
+  if (options_.report_stats_) {
+    op_times = counters_.GetPerOpMeanTimes();
+  }
+  const bool has_op_times = op_times.size() == operators_.size();
+
+  // visit tasks in reverse topological order, children before parents
+  critical_paths_.assign(num_tasks, 0.0f);
+  std::vector<int> pending_children(num_tasks);
+  std::vector<int> ready_tasks;
+  for (int task_id = 0; task_id < num_tasks; ++task_id) {
+    pending_children[task_id] = children(task_id).size();
+    if (pending_children[task_id] == 0) {
+      ready_tasks.push_back(task_id);
+    }
+  }
+  while (!ready_tasks.empty()) {
+    auto task_id = ready_tasks.back();
+    ready_tasks.pop_back();
+    float task_cost = 0.0f;
+    if (has_op_times) {
+      for (auto op_id : chains_[task_id]) {
+        task_cost += op_times[op_id];
+      }
+    } else {
+      task_cost = numOps(task_id);
+    }
+    float longest_child_path = 0.0f;
+    for (auto child_id : children(task_id)) {
+      longest_child_path =
+          std::max(longest_child_path, critical_paths_[child_id]);
+    }
+    critical_paths_[task_id] = task_cost + longest_child_path;
+    for (auto parent_id : parents(task_id)) {
+      if (--pending_children[parent_id] == 0) {
+        ready_tasks.push_back(parent_id);
+      }
+    }
+  }
+
+  auto by_path = [this](int lhs, int rhs) {
+    return critical_paths_[lhs] > critical_paths_[rhs];
+  };
+  children_by_path_.resize(num_tasks);
+  for (int task_id = 0; task_id < num_tasks; ++task_id) {
+    children_by_path_[task_id] = children(task_id);
+    std::stable_sort(
+        children_by_path_[task_id].begin(),
+        children_by_path_[task_id].end(),
+        by_path);
+  }
+  roots_by_path_ = roots_;
+  std::stable_sort(roots_by_path_.begin(), roots_by_path_.end(), by_path);
+
+  ideal_makespan_ms_ = -1.0f;
+  if (has_op_times && !roots_by_path_.empty()) {
+    ideal_makespan_ms_ = critical_paths_[roots_by_path_.front()];
+  }
+}
+
+const std::vector<int>& AsyncNetBase::scheduleOrderedChildren(
+    int task_id) const {
+  if (options_.prioritize_critical_path_) {
+    return children_by_path_[task_id];
+  }
+  return children(task_id);
+}
+
+const std::vector<int>& AsyncNetBase::scheduleOrderedRoots() const {
+  if (options_.prioritize_critical_path_) {
+    return roots_by_path_;
+  }
+  return roots_;
+}
+
 int AsyncNetBase::firstTaskOpId(int task_id) const {
   return chains_[task_id].front();
 }
@@ -599,6 +687,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "prioritize_critical_path") {
+      CAFFE_ENFORCE(arg.has_i(), "prioritize_critical_path should be an int");
+      prioritize_critical_path_ = arg.i() == 1;
+    }
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
@@ -55,6 +55,8 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // schedule ready tasks with the longest remaining path first
+  bool prioritize_critical_path_ = false;
 };
 
 struct CAFFE2_API AsyncNetCancelled : public std::exception {
@@ -82,6 +84,10 @@ class CAFFE2_API AsyncNetBase : public NetBase {
     return execution_chains_;
   }
 
+  const std::vector<float>& TEST_critical_paths() const {
+    return critical_paths_;
+  }
+
   ProfDAGProtos GetOperatorStats() const;
   ProfDAGProtos GetPerOperatorCost() const;
   ProfDAGReport GetProfReport() const;
@@ -103,6 +109,15 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   bool testAndSetScheduled(int task_id);
   int numOps(int task_id) const;
 
+  // Computes for each task the length of the longest path from its start to
+  // the end of the net, in ms when per operator timings are reported and in
+  // number of ops otherwise, and orders children and root tasks by it
+  void computeCriticalPaths();
+  // Children of the task, in the order they should be scheduled
+  const std::vector<int>& scheduleOrderedChildren(int task_id) const;
+  // Tasks without parents, in the order they should be scheduled
+  const std::vector<int>& scheduleOrderedRoots() const;
+
   int firstTaskOpId(int task_id) const;
   int lastTaskOpId(int task_id) const;
   const OperatorBase* firstTaskOp(int task_id) const;
@@ -135,6 +150,14 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   std::vector<dag_utils::OpGraphNode> chain_nodes_; // chains' parents/children
   dag_utils::ExecutionChains execution_chains_; // for testing
 
+  // Critical path scheduling
+  std::vector<float> critical_paths_;
+  std::vector<std::vector<int>> children_by_path_;
+  std::vector<int> roots_by_path_;
+  std::vector<int> roots_;
+  // length of the longest path of the net, negative without op timings
+  float ideal_makespan_ms_ = -1.0f;
+
   // Pools and streams
   std::mutex pools_mutex_;
   // first int key - device id, second - pool size, one pool per (device, size)
@@ -72,7 +72,7 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
         }
       }
 
-      for (auto child_id : children(task_id)) {
+      for (auto child_id : scheduleOrderedChildren(task_id)) {
         int parent_count = updateParentCount(child_id);
         if (parent_count == 0) {
           // Schedule a child if:
@@ -182,7 +182,7 @@ void AsyncSchedulingNet::parentCallback(int parent_id) {
   if (event(parent_id).Query() != EventStatus::EVENT_SUCCESS) {
     success_ = false;
   }
-  for (auto child_id : children(parent_id)) {
+  for (auto child_id : scheduleOrderedChildren(parent_id)) {
     int parent_count = getParentCount(child_id);
     if (parent_count == 0) {
       if (!success_ || canSchedule(child_id)) {
@@ -218,6 +218,12 @@ void AsyncSchedulingNet::finishRun() {
   if (options_.report_stats_) {
     counters_.ReportRunEnd();
   }
+  if (tracer_ && tracer_->isEnabled() && ideal_makespan_ms_ >= 0) {
+    tracer_->recordCounters(
+        "makespan",
+        {{"achieved_us", static_cast<long>(run_timer_.MicroSeconds())},
+         {"ideal_us", static_cast<long>(ideal_makespan_ms_ * 1000)}});
+  }
   // notify observers and waiters
   StopAllObservers();
   running_ = false;
@@ -233,10 +239,15 @@ bool AsyncSchedulingNet::RunAsync() {
     }
     running_ = true;
     reset();
+    run_timer_.Start();
 
     StartAllObservers();
     tracing::startIter(tracer_);
     if (options_.report_stats_) {
+      if (options_.prioritize_critical_path_) {
+        // refine the path lengths with the op timings of the previous runs
+        computeCriticalPaths();
+      }
       counters_.ReportRunStart();
     }
   } catch (const std::exception& e) {
@@ -251,10 +262,8 @@ bool AsyncSchedulingNet::RunAsync() {
 
   // schedule() is not expected to throw, at this moment all the initial tasks
   // will be scheduled and the full graph of tasks will be executed
-  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
-    if (parents(task_id).empty()) {
-      schedule(task_id, options_.run_root_tasks_inline_);
-    }
+  for (auto task_id : scheduleOrderedRoots()) {
+    schedule(task_id, options_.run_root_tasks_inline_);
   }
 
   if (tasksNum() == 0) {
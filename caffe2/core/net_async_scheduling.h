@@ -34,6 +34,9 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   std::atomic<int> processed_tasks_num_;
 
+  // time since the start of the current run
+  Timer run_timer_;
+
   C10_DISABLE_COPY_AND_ASSIGN(AsyncSchedulingNet);
 };
 
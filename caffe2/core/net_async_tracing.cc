@@ -73,6 +73,18 @@ void Tracer::recordEvent(const TracerEvent& event) {
   events_.push_back(event);
 }
 
+void Tracer::recordCounters(
+    const char* name,
+    const std::vector<std::pair<const char*, long>>& counters) {
+  TracerEvent event;
+  event.name_ = name;
+  event.timestamp_ = (long)caffe2::round(timer_.MicroSeconds());
+  event.tid_ = std::this_thread::get_id();
+  event.iter_ = getIter();
+  event.counters_ = counters;
+  recordEvent(event);
+}
+
 // Forward
 int getUniqueShardId(const OperatorDef& op_def);
 
@@ -115,7 +127,19 @@ std::string Tracer::serializeEvent(const TracerEvent& event) {
     serialized_event << " \"tid\": " << event.tid_ << ",\n";
   }
 
-  if (event.is_beginning_) {
+  if (!event.counters_.empty()) {
+    serialized_event << " \"name\": \"" << event.name_ << "\",\n";
+    serialized_event << " \"ph\": \"C\",\n";
+    serialized_event << " \"args\": {\n";
+    for (size_t idx = 0; idx < event.counters_.size(); ++idx) {
+      serialized_event << "  \"" << event.counters_[idx].first
+                       << "\": " << event.counters_[idx].second;
+      if (idx + 1 < event.counters_.size()) {
+        serialized_event << ",\n";
+      }
+    }
+    serialized_event << "\n }";
+  } else if (event.is_beginning_) {
     std::unordered_map<std::string, int> int_args;
     std::unordered_map<std::string, std::string> string_args;
     if (event.name_) {
@@ -40,6 +40,8 @@ struct CAFFE2_API TracerEvent {
   long thread_label_ = -1;
   std::thread::id tid_;
   int iter_ = -1;
+  // values of a counter event, serialized instead of a begin/end pair
+  std::vector<std::pair<const char*, long>> counters_;
 };
 
 enum TracingField {
@@ -78,6 +80,10 @@ class CAFFE2_API Tracer {
       TracingConfig = TracingConfig{});
 
   void recordEvent(const TracerEvent& event);
+  // Records the current values of the named counters
+  void recordCounters(
+      const char* name,
+      const std::vector<std::pair<const char*, long>>& counters);
   std::string opTraceName(const OperatorBase* op);
   std::string opBlobsInfo(const OperatorBase& op);
   std::string serializeEvent(const TracerEvent& event);
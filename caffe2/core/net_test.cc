@@ -617,6 +617,62 @@ TEST(NetTest, OperatorWithExecutorHelper) {
   ASSERT_TRUE(net->Run());
 }
 
+TEST(NetTest, CriticalPathScheduling) {
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        external_input: "in"
+        op {
+          input: "in"
+          output: "hidden1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "hidden1"
+          output: "hidden2"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "hidden2"
+          output: "out1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "in"
+          output: "out2"
+          type: "NetTestDummy"
+        }
+        arg {
+          name: "prioritize_critical_path"
+          i: 1
+        }
+        arg {
+          name: "enable_profiling"
+          i: 1
+        }
+)DOC";
+
+  Workspace ws;
+  ws.CreateBlob("in");
+
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  net_def.set_num_workers(kTestPoolSize);
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* async_net = dynamic_cast_if_rtti<AsyncNetBase*>(net.get());
+  ASSERT_TRUE(async_net != nullptr);
+
+  // before the first run the path lengths are in number of ops
+  const auto& paths = async_net->TEST_critical_paths();
+  ASSERT_FALSE(paths.empty());
+  ASSERT_EQ(3, *std::max_element(paths.begin(), paths.end()));
+  ASSERT_EQ(1, *std::min_element(paths.begin(), paths.end()));
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(net->Run());
+  }
+}
+
 TEST(NetTest, DISABLED_OperatorWithDisabledEvent) {
   const auto spec = R"DOC(
         name: "example"
@@ -3,7 +3,25 @@
 namespace caffe2 {
 REGISTER_CPU_OPERATOR(CreateDB, CreateDBOp<CPUContext>);
 
-OPERATOR_SCHEMA(CreateDB).NumInputs(0).NumOutputs(1);
+OPERATOR_SCHEMA(CreateDB)
+    .NumInputs(0)
+    .NumOutputs(1)
+    .Arg("db_type", "Type of the db, leveldb by default")
+    .Arg("db", "Name of the db")
+    .Arg("num_shards", "Number of shards the db is read in, 1 by default")
+    .Arg("shard_id", "Shard the reader reads, 0 by default")
+    .Arg(
+        "prefetch_cursors",
+        "If positive, the reader reads the records ahead of time with that "
+        "many cursors in background threads. 0 by default")
+    .Arg(
+        "prefetch_window_size",
+        "Number of records the prefetching cursors read ahead at most, 256 by "
+        "default")
+    .Arg(
+        "prefetch_batch_size",
+        "Number of records a prefetching cursor reads at a time, 16 by "
+        "default");
 
 NO_GRADIENT(CreateDB);
 }  // namespace caffe2
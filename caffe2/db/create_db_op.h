@@ -19,13 +19,26 @@ class CreateDBOp final : public Operator<Context> {
         num_shards_(
             OperatorBase::template GetSingleArgument<int>("num_shards", 1)),
         shard_id_(
-            OperatorBase::template GetSingleArgument<int>("shard_id", 0)) {
+            OperatorBase::template GetSingleArgument<int>("shard_id", 0)),
+        prefetch_cursors_(OperatorBase::template GetSingleArgument<int>(
+            "prefetch_cursors",
+            0)),
+        prefetch_window_size_(OperatorBase::template GetSingleArgument<int>(
+            "prefetch_window_size",
+            256)),
+        prefetch_batch_size_(OperatorBase::template GetSingleArgument<int>(
+            "prefetch_batch_size",
+            16)) {
     CAFFE_ENFORCE_GT(db_name_.size(), 0, "Must specify a db name.");
   }
 
   bool RunOnDevice() final {
     OperatorBase::Output<db::DBReader>(0)->Open(
         db_type_, db_name_, num_shards_, shard_id_);
+    if (prefetch_cursors_ > 0) {
+      OperatorBase::Output<db::DBReader>(0)->StartPrefetching(
+          prefetch_cursors_, prefetch_window_size_, prefetch_batch_size_);
+    }
     return true;
   }
 
@@ -34,6 +47,9 @@ class CreateDBOp final : public Operator<Context> {
   string db_name_;
   uint32_t num_shards_;
   uint32_t shard_id_;
+  int prefetch_cursors_;
+  int prefetch_window_size_;
+  int prefetch_batch_size_;
   C10_DISABLE_COPY_AND_ASSIGN(CreateDBOp);
 };
 
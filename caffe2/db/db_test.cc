@@ -200,5 +200,68 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+static std::vector<string> ReadKeys(const DBReader& reader, int num_keys) {
+  std::vector<string> keys;
+  string key;
+  string value;
+  for (int i = 0; i < num_keys; ++i) {
+    reader.Read(&key, &value);
+    EXPECT_EQ(key, value);
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+TEST(DBReaderPrefetchTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+
+  for (int num_shards = 1; num_shards <= 3; ++num_shards) {
+    for (int num_cursors = 1; num_cursors <= 4; ++num_cursors) {
+      std::vector<string> expected;
+      {
+        DBReader reader("leveldb", name, num_shards, num_shards - 1);
+        expected = ReadKeys(reader, 3 * kMaxItems);
+      }
+
+      DBReader reader("leveldb", name, num_shards, num_shards - 1);
+      reader.StartPrefetching(num_cursors, 5, 2);
+      EXPECT_TRUE(reader.IsPrefetching());
+      // The records come in the same order, across the end of the db.
+      EXPECT_EQ(ReadKeys(reader, 3 * kMaxItems), expected);
+
+      reader.SeekToFirst();
+      EXPECT_TRUE(reader.IsPrefetching());
+      std::vector<string> keys = ReadKeys(reader, 2);
+      // Stopping moves the cursor back to the next record to read.
+      reader.StopPrefetching();
+      EXPECT_FALSE(reader.IsPrefetching());
+      auto next_keys = ReadKeys(reader, 2);
+      keys.insert(keys.end(), next_keys.begin(), next_keys.end());
+      expected.resize(4);
+      EXPECT_EQ(keys, expected);
+    }
+  }
+}
+
+TEST(DBReaderPrefetchTest, Serialize) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name));
+  reader->StartPrefetching(2, 4, 1);
+  ReadKeys(*reader, 3);
+
+  Blob reader_blob;
+  reader_blob.Reset(reader.release());
+  std::string str = SerializeBlob(reader_blob, "saved_reader");
+  reader_blob.Reset();
+  BlobProto blob_proto;
+  CHECK(blob_proto.ParseFromString(str));
+  DBReaderProto proto;
+  CHECK(proto.ParseFromString(blob_proto.content()));
+  // The key of the next record, not the one of the cursor that reads ahead.
+  EXPECT_EQ(proto.key(), "03");
+}
+
 } // namespace db
 } // namespace caffe2
@@ -80,6 +80,7 @@ class LevelDB : public DB {
   unique_ptr<Cursor> NewCursor() override {
     return make_unique<LevelDBCursor>(db_.get());
   }
+  bool SupportsConcurrentCursors() override { return true; }
   unique_ptr<Transaction> NewTransaction() override {
     return make_unique<LevelDBTransaction>(db_.get());
   }
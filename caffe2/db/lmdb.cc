@@ -132,6 +132,8 @@ class LMDB : public DB {
   unique_ptr<Cursor> NewCursor() override {
     return make_unique<LMDBCursor>(mdb_env_);
   }
+  // Every cursor has its own read-only transaction.
+  bool SupportsConcurrentCursors() override { return true; }
   unique_ptr<Transaction> NewTransaction() override {
     return make_unique<LMDBTransaction>(mdb_env_);
   }
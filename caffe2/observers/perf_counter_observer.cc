@@ -0,0 +1,268 @@
+#include "perf_counter_observer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+namespace {
+
+#if defined(__linux__)
+// The counters of one thread, opened as a group so that they all count over
+// the same time.
+class PerfEventGroup {
+ public:
+  PerfEventGroup() {
+    const uint64_t configs[kNumEvents] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES,
+    };
+    for (const auto config : configs) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = config;
+      attr.disabled = fds_.empty();
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      const int fd = syscall(
+          __NR_perf_event_open,
+          &attr,
+          0 /* this thread */,
+          -1 /* any cpu */,
+          fds_.empty() ? -1 : fds_[0],
+          0);
+      if (fd < 0) {
+        VLOG(1) << "Hardware counters are not available: "
+                << std::strerror(errno);
+        Close();
+        return;
+      }
+      fds_.push_back(fd);
+    }
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~PerfEventGroup() {
+    Close();
+  }
+
+  bool Read(PerfCounters* counters) const {
+    if (fds_.empty()) {
+      return false;
+    }
+    // The number of events, then their values.
+    uint64_t values[1 + kNumEvents];
+    if (read(fds_[0], values, sizeof(values)) != sizeof(values)) {
+      return false;
+    }
+    counters->cycles = values[1];
+    counters->instructions = values[2];
+    counters->cache_references = values[3];
+    counters->cache_misses = values[4];
+    return true;
+  }
+
+ private:
+  static constexpr int kNumEvents = 4;
+
+  void Close() {
+    for (const int fd : fds_) {
+      close(fd);
+    }
+    fds_.clear();
+  }
+
+  std::vector<int> fds_;
+};
+#endif // defined(__linux__)
+
+} // namespace
+
+bool PerfCounters::Read(PerfCounters* counters) {
+#if defined(__linux__)
+  static thread_local PerfEventGroup group;
+  return group.Read(counters);
+#else
+  return false;
+#endif
+}
+
+bool PerfCounters::Available() {
+  PerfCounters counters;
+  return Read(&counters);
+}
+
+PerfCounters& PerfCounters::operator+=(const PerfCounters& other) {
+  cycles += other.cycles;
+  instructions += other.instructions;
+  cache_references += other.cache_references;
+  cache_misses += other.cache_misses;
+  return *this;
+}
+
+PerfCounters PerfCounters::operator-(const PerfCounters& other) const {
+  PerfCounters result;
+  result.cycles = cycles - other.cycles;
+  result.instructions = instructions - other.instructions;
+  result.cache_references = cache_references - other.cache_references;
+  result.cache_misses = cache_misses - other.cache_misses;
+  return result;
+}
+
+PerfOperatorStats& PerfOperatorStats::operator+=(
+    const PerfOperatorStats& other) {
+  iterations += other.iterations;
+  time_ms += other.time_ms;
+  counters += other.counters;
+  flops += other.flops;
+  bytes_read += other.bytes_read;
+  bytes_written += other.bytes_written;
+  return *this;
+}
+
+double PerfOperatorStats::gflops_per_second() const {
+  return time_ms > 0 ? 1.0e-6 * flops / time_ms : 0;
+}
+
+double PerfOperatorStats::bytes_per_run() const {
+  return iterations > 0 ? double(bytes_read + bytes_written) / iterations : 0;
+}
+
+double PerfOperatorStats::arithmetic_intensity() const {
+  const uint64_t bytes = bytes_read + bytes_written;
+  return bytes > 0 ? double(flops) / bytes : 0;
+}
+
+double PerfOperatorStats::instructions_per_cycle() const {
+  return counters.cycles > 0 ? double(counters.instructions) / counters.cycles
+                             : 0;
+}
+
+double PerfOperatorStats::cache_miss_rate() const {
+  return counters.cache_references > 0
+      ? double(counters.cache_misses) / counters.cache_references
+      : 0;
+}
+
+PerfCounterOperatorObserver::PerfCounterOperatorObserver(
+    OperatorBase* subject,
+    PerfCounterObserver* /* unused */)
+    : ObserverBase<OperatorBase>(subject) {
+  if (subject) {
+    stats_.type = subject->debug_def().type();
+  }
+}
+
+void PerfCounterOperatorObserver::Start() {
+  // Inferred before reading the counters, not to count it.
+  run_cost_ = OpSchema::Cost();
+  const auto* schema = OpSchemaRegistry::Schema(stats_.type);
+  if (schema && schema->HasCostInferenceFunction() &&
+      subject_->isLegacyOperator()) {
+    const vector<TensorShape> shapes = subject_->InputTensorShapes();
+    const bool all_good_shapes = std::all_of(
+        shapes.begin(), shapes.end(), [](const TensorShape& shape) {
+          return !shape.unknown_shape();
+        });
+    if (all_good_shapes) {
+      try {
+        run_cost_ = schema->InferCost(subject_->debug_def(), shapes);
+      } catch (const std::exception& e) {
+        VLOG(1) << "Cost inference failed for " << stats_.type << ": "
+                << e.what();
+      }
+    }
+  }
+  PerfCounters::Read(&start_counters_);
+  timer_.Start();
+}
+
+void PerfCounterOperatorObserver::Stop() {
+  const double time_ms = timer_.MilliSeconds();
+  PerfCounters counters;
+  if (PerfCounters::Read(&counters)) {
+    stats_.counters += counters - start_counters_;
+  }
+  ++stats_.iterations;
+  stats_.time_ms += time_ms;
+  stats_.flops += run_cost_.flops;
+  stats_.bytes_read += run_cost_.bytes_read;
+  stats_.bytes_written += run_cost_.bytes_written;
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>>
+PerfCounterOperatorObserver::rnnCopy(OperatorBase* subject, int rnn_order)
+    const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new PerfCounterOperatorObserver(subject, nullptr));
+}
+
+std::vector<PerfOperatorStats> PerfCounterObserver::operator_stats() const {
+  std::vector<PerfOperatorStats> stats;
+  for (const auto* observer : operator_observers_) {
+    stats.push_back(observer->stats());
+  }
+  return stats;
+}
+
+std::map<std::string, PerfOperatorStats>
+PerfCounterObserver::operator_type_stats() const {
+  std::map<std::string, PerfOperatorStats> stats;
+  for (const auto* observer : operator_observers_) {
+    auto& type_stats = stats[observer->stats().type];
+    type_stats.type = observer->stats().type;
+    type_stats += observer->stats();
+  }
+  return stats;
+}
+
+std::string PerfCounterObserver::debugInfo() {
+  std::vector<PerfOperatorStats> stats;
+  for (const auto& type_stats : operator_type_stats()) {
+    stats.push_back(type_stats.second);
+  }
+  std::sort(
+      stats.begin(),
+      stats.end(),
+      [](const PerfOperatorStats& a, const PerfOperatorStats& b) {
+        return a.time_ms > b.time_ms;
+      });
+
+  std::stringstream ss;
+  ss << std::setw(24) << "Operator type" << std::setw(10) << "Runs"
+     << std::setw(12) << "ms" << std::setw(10) << "GFLOP/s" << std::setw(14)
+     << "Bytes/run" << std::setw(10) << "FLOP/B" << std::setw(8) << "IPC"
+     << std::setw(10) << "Miss rate" << "\n";
+  for (const auto& s : stats) {
+    ss << std::setw(24) << s.type << std::setw(10) << s.iterations
+       << std::setw(12) << s.time_ms << std::setw(10) << s.gflops_per_second()
+       << std::setw(14) << s.bytes_per_run() << std::setw(10)
+       << s.arithmetic_intensity() << std::setw(8)
+       << s.instructions_per_cycle() << std::setw(10) << s.cache_miss_rate()
+       << "\n";
+  }
+  if (!PerfCounters::Available()) {
+    ss << "Hardware counters are not available.\n";
+  }
+  return ss.str();
+}
+
+} // namespace caffe2
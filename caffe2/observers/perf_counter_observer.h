@@ -0,0 +1,115 @@
+#pragma once
+
+#include <map>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+/**
+ * Hardware counters of the calling thread, read with perf_event_open. They
+ * stay at zero where perf events are not available: on other platforms than
+ * Linux, or when the kernel does not allow them (see
+ * /proc/sys/kernel/perf_event_paranoid).
+ */
+struct CAFFE2_API PerfCounters {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cache_references = 0;
+  uint64_t cache_misses = 0;
+
+  // Reads the counters of the calling thread, returns false if they are not
+  // available.
+  static bool Read(PerfCounters* counters);
+  static bool Available();
+
+  PerfCounters& operator+=(const PerfCounters& other);
+  PerfCounters operator-(const PerfCounters& other) const;
+};
+
+/**
+ * What the runs of an operator, or of all the operators of a type, cost. The
+ * flops and bytes come from the cost inference function of the operator
+ * schema, for the input shapes of each run, and are zero for the operators
+ * without one.
+ */
+struct CAFFE2_API PerfOperatorStats {
+  std::string type;
+  int iterations = 0;
+  double time_ms = 0;
+  PerfCounters counters;
+  uint64_t flops = 0;
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+
+  PerfOperatorStats& operator+=(const PerfOperatorStats& other);
+
+  double gflops_per_second() const;
+  // Bytes read and written by one run.
+  double bytes_per_run() const;
+  // Flops per byte read or written, the operators with a low intensity and a
+  // high cache miss rate are the memory bound ones.
+  double arithmetic_intensity() const;
+  double instructions_per_cycle() const;
+  double cache_miss_rate() const;
+};
+
+class PerfCounterObserver;
+
+/**
+ * Counts the time, hardware counters and cost of the runs of an operator.
+ * The counters are the ones of the thread running the operator, the work an
+ * operator hands to other threads (e.g. to a thread pool) is not counted.
+ */
+class CAFFE2_API PerfCounterOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit PerfCounterOperatorObserver(OperatorBase* subject) = delete;
+  PerfCounterOperatorObserver(
+      OperatorBase* subject,
+      PerfCounterObserver* /* unused */);
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+  const PerfOperatorStats& stats() const {
+    return stats_;
+  }
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  PerfOperatorStats stats_;
+  OpSchema::Cost run_cost_;
+  Timer timer_;
+  PerfCounters start_counters_;
+};
+
+/**
+ * Attaches a PerfCounterOperatorObserver to every operator of the net,
+ * debugInfo() reports the stats per operator type.
+ */
+class CAFFE2_API PerfCounterObserver final
+    : public OperatorAttachingNetObserver<
+          PerfCounterOperatorObserver,
+          PerfCounterObserver> {
+ public:
+  explicit PerfCounterObserver(NetBase* subject)
+      : OperatorAttachingNetObserver<
+            PerfCounterOperatorObserver,
+            PerfCounterObserver>(subject, this) {}
+
+  // The stats of the operators, in the order of the net.
+  std::vector<PerfOperatorStats> operator_stats() const;
+  std::map<std::string, PerfOperatorStats> operator_type_stats() const;
+
+  std::string debugInfo() override;
+};
+
+} // namespace caffe2
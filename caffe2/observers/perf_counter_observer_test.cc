@@ -0,0 +1,79 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/operator.h"
+#include "perf_counter_observer.h"
+
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+
+namespace {
+
+void AddInput(Workspace* ws, const string& name, const vector<int64_t>& dims) {
+  auto* tensor = BlobGetMutableTensor(ws->CreateBlob(name), CPU);
+  tensor->Resize(dims);
+  float* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = 0.5f;
+  }
+}
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws) {
+  AddInput(ws, "X", {4, 8});
+  AddInput(ws, "W", {16, 8});
+  AddInput(ws, "b", {16});
+  NetDef net_def;
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("FC");
+    op.add_input("X");
+    op.add_input("W");
+    op.add_input("b");
+    op.add_output("Y");
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("Relu");
+    op.add_input("Y");
+    op.add_output("Z");
+  }
+  net_def.add_external_input("X");
+  net_def.add_external_input("W");
+  net_def.add_external_input("b");
+  net_def.add_external_output("Z");
+
+  return CreateNet(net_def, ws);
+}
+} // namespace
+
+TEST(PerfCounterObserverTest, CountsOperatorRuns) {
+  Workspace ws;
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws));
+  auto net_ob = std::make_unique<PerfCounterObserver>(net.get());
+  const auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+  for (int i = 0; i < 3; ++i) {
+    net->Run();
+  }
+
+  const auto stats = ob->operator_stats();
+  ASSERT_EQ(stats.size(), 2);
+  EXPECT_EQ(stats[0].type, "FC");
+  EXPECT_EQ(stats[0].iterations, 3);
+  // M * N * (2 * K + 1) per run.
+  EXPECT_EQ(stats[0].flops, 3 * 4 * 16 * (2 * 8 + 1));
+  EXPECT_GT(stats[0].bytes_per_run(), 0);
+  EXPECT_GT(stats[0].arithmetic_intensity(), 0);
+  EXPECT_EQ(stats[1].type, "Relu");
+  EXPECT_EQ(stats[1].iterations, 3);
+  if (PerfCounters::Available()) {
+    EXPECT_GT(stats[0].counters.cycles, 0);
+    EXPECT_GT(stats[0].counters.instructions, 0);
+  }
+
+  const auto type_stats = ob->operator_type_stats();
+  ASSERT_EQ(type_stats.size(), 2);
+  EXPECT_EQ(type_stats.at("FC").flops, stats[0].flops);
+  LOG(INFO) << const_cast<PerfCounterObserver*>(ob)->debugInfo();
+}
+} // namespace caffe2
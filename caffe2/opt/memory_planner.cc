@@ -0,0 +1,262 @@
+#include "caffe2/opt/memory_planner.h"
+
+#include "caffe2/core/blob.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/types.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace caffe2 {
+
+namespace {
+
+// Ops whose outputs share the memory of their inputs.
+const std::unordered_set<std::string>& aliasingOps() {
+  static const std::unordered_set<std::string> ops{"Alias"};
+  return ops;
+}
+
+// Bytes of the blob at its bound shape, 0 if it can't be planned.
+size_t boundBytes(const ShapeInfoMap& shape_info, const std::string& name) {
+  const auto it = shape_info.find(name);
+  if (it == shape_info.end() || it->second.is_quantized) {
+    return 0;
+  }
+  const auto& shape = it->second.shape;
+  if (shape.unknown_shape() || !shape.has_data_type() ||
+      shape.data_type() == TensorProto_DataType_UNDEFINED) {
+    return 0;
+  }
+  size_t numel = 1;
+  for (const auto dim : shape.dims()) {
+    if (dim < 0) {
+      return 0;
+    }
+    numel *= dim;
+  }
+  const TypeMeta* meta = nullptr;
+  try {
+    meta = &DataTypeToTypeMeta(shape.data_type());
+  } catch (const std::exception&) {
+    return 0;
+  }
+  // Types with constructors can't reuse the memory of another type.
+  if (meta->placementNew() != nullptr) {
+    return 0;
+  }
+  return numel * meta->itemsize();
+}
+
+// Index of the smallest power of two holding `bytes`.
+int sizeBucket(size_t bytes) {
+  int bucket = 0;
+  while ((size_t{1} << bucket) < bytes) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+struct Lifetime {
+  int first_def = -1;
+  int last_use = -1;
+  int device_type = PROTO_CPU;
+  int device_id = 0;
+};
+
+} // namespace
+
+MemoryPlan planActivationMemory(
+    const std::vector<const NetDef*>& nets,
+    const ShapeInfoMap& shape_info,
+    const std::unordered_set<std::string>& dont_share) {
+  std::unordered_set<std::string> excluded = dont_share;
+  std::unordered_set<std::string> all_blobs;
+  std::unordered_map<std::string, Lifetime> lifetimes;
+  // blobs in the order they are first produced
+  std::vector<std::string> produced;
+
+  int op_idx = 0;
+  for (const auto* net : nets) {
+    CAFFE_ENFORCE(net);
+    CAFFE_ENFORCE(
+        !net->has_type() || net->type().empty() || net->type() == "simple",
+        "Memory planning needs the ops to run in order, net ",
+        net->name(),
+        " is of type ",
+        net->type());
+    for (const auto& name : net->external_input()) {
+      excluded.insert(name);
+      all_blobs.insert(name);
+    }
+    for (const auto& name : net->external_output()) {
+      excluded.insert(name);
+      all_blobs.insert(name);
+    }
+    for (const auto& op : net->op()) {
+      for (const auto& arg : op.arg()) {
+        CAFFE_ENFORCE(
+            !arg.has_n() && arg.nets_size() == 0,
+            "Memory planning does not support subnets, op ",
+            op.type(),
+            " of net ",
+            net->name(),
+            " has one");
+      }
+      const auto& device_option =
+          op.has_device_option() ? op.device_option() : net->device_option();
+      if (aliasingOps().count(op.type())) {
+        excluded.insert(op.input().begin(), op.input().end());
+        excluded.insert(op.output().begin(), op.output().end());
+      }
+      for (const auto& input : op.input()) {
+        all_blobs.insert(input);
+        auto it = lifetimes.find(input);
+        if (it != lifetimes.end()) {
+          it->second.last_use = op_idx;
+        }
+      }
+      for (const auto& output : op.output()) {
+        all_blobs.insert(output);
+        auto& lifetime = lifetimes[output];
+        if (lifetime.first_def < 0) {
+          lifetime.first_def = op_idx;
+          lifetime.device_type = device_option.device_type();
+          lifetime.device_id = device_option.device_id();
+          produced.push_back(output);
+        } else if (
+            lifetime.device_type != device_option.device_type() ||
+            lifetime.device_id != device_option.device_id()) {
+          // written on several devices
+          excluded.insert(output);
+        }
+        lifetime.last_use = op_idx;
+      }
+      ++op_idx;
+    }
+  }
+
+  MemoryPlan plan;
+  // free arenas per (device type, device id, size bucket), with the index
+  // of the last op using them
+  std::map<std::tuple<int, int, int>, std::vector<std::pair<int, int>>>
+      arenas_by_bucket;
+  int arena_name_idx = 0;
+  for (const auto& name : produced) {
+    if (excluded.count(name)) {
+      continue;
+    }
+    const auto bytes = boundBytes(shape_info, name);
+    if (bytes == 0) {
+      continue;
+    }
+    const auto& lifetime = lifetimes.at(name);
+    auto& candidates = arenas_by_bucket[std::make_tuple(
+        lifetime.device_type, lifetime.device_id, sizeBucket(bytes))];
+    // An arena is free once its last blob was used by an earlier op, the
+    // op producing the blob may still read the previous one.
+    auto free_arena = std::find_if(
+        candidates.begin(),
+        candidates.end(),
+        [&](const std::pair<int, int>& candidate) {
+          return candidate.second < lifetime.first_def;
+        });
+    int arena_idx;
+    if (free_arena != candidates.end()) {
+      arena_idx = free_arena->first;
+      free_arena->second = lifetime.last_use;
+    } else {
+      MemoryArena arena;
+      do {
+        arena.name = "__arena" + c10::to_string(arena_name_idx++);
+      } while (all_blobs.count(arena.name));
+      arena.device_type = lifetime.device_type;
+      arena.device_id = lifetime.device_id;
+      arena_idx = plan.arenas.size();
+      plan.arenas.push_back(std::move(arena));
+      candidates.emplace_back(arena_idx, lifetime.last_use);
+    }
+    auto& arena = plan.arenas[arena_idx];
+    arena.bytes = std::max(arena.bytes, bytes);
+    arena.blobs.push_back(name);
+    plan.arena_of_blob[name] = arena_idx;
+    plan.unplanned_bytes += bytes;
+  }
+  for (const auto& arena : plan.arenas) {
+    plan.planned_bytes += arena.bytes;
+  }
+  VLOG(1) << "Planned " << plan.arena_of_blob.size() << " activations in "
+          << plan.arenas.size() << " arenas, " << plan.planned_bytes
+          << " bytes instead of " << plan.unplanned_bytes;
+  return plan;
+}
+
+NetDef applyMemoryPlan(const NetDef& net, const MemoryPlan& plan) {
+  NetDef planned = net;
+  auto rename = [&plan](std::string* name) {
+    const auto it = plan.arena_of_blob.find(*name);
+    if (it != plan.arena_of_blob.end()) {
+      *name = plan.arenas[it->second].name;
+    }
+  };
+  for (auto& op : *planned.mutable_op()) {
+    for (auto& input : *op.mutable_input()) {
+      rename(&input);
+    }
+    for (auto& output : *op.mutable_output()) {
+      rename(&output);
+    }
+  }
+  return planned;
+}
+
+void preallocateMemoryPlan(const MemoryPlan& plan, Workspace* ws) {
+  CAFFE_ENFORCE(ws);
+  for (const auto& arena : plan.arenas) {
+    if (arena.device_type != PROTO_CPU) {
+      continue;
+    }
+    auto* tensor = BlobGetMutableTensor(ws->CreateBlob(arena.name), CPU);
+    if (tensor->nbytes() < arena.bytes) {
+      tensor->Resize(static_cast<int64_t>(arena.bytes));
+      tensor->mutable_data<uint8_t>();
+    }
+  }
+}
+
+std::vector<NetDef> optimizeInferenceMemory(
+    const std::vector<NetDef>& nets,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& info,
+    Workspace* ws,
+    const std::unordered_set<std::string>& dont_share) {
+  // The shapes are inferred on all the ops at once, the outputs of a net
+  // are the inputs of the next ones.
+  NetDef all_ops;
+  for (const auto& net : nets) {
+    for (const auto& op : net.op()) {
+      all_ops.add_op()->CopyFrom(op);
+    }
+  }
+  BoundShapeInferencer inferencer(spec);
+  inferencer.InferBoundShapeAndType(all_ops, info, ws);
+
+  std::vector<const NetDef*> net_ptrs;
+  for (const auto& net : nets) {
+    net_ptrs.push_back(&net);
+  }
+  const auto plan =
+      planActivationMemory(net_ptrs, inferencer.shape_info(), dont_share);
+  std::vector<NetDef> planned;
+  for (const auto& net : nets) {
+    planned.push_back(applyMemoryPlan(net, plan));
+  }
+  if (ws) {
+    preallocateMemoryPlan(plan, ws);
+  }
+  return planned;
+}
+
+} // namespace caffe2
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/bound_shape_inferencer.h"
+#include "caffe2/opt/shape_info.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace caffe2 {
+
+/// A blob that the activations of a plan take turns in. All of them are
+/// on the same device and their bound sizes are in the same power of two
+/// bucket, so the memory of the arena is reused without growing much.
+struct CAFFE2_API MemoryArena {
+  std::string name;
+  int device_type = PROTO_CPU;
+  int device_id = 0;
+  /// Bytes of the largest of the activations at their bound shapes.
+  size_t bytes = 0;
+  /// Activations assigned to the arena, in the order they are produced.
+  std::vector<std::string> blobs;
+};
+
+struct CAFFE2_API MemoryPlan {
+  std::vector<MemoryArena> arenas;
+  /// Index in `arenas` of each planned activation.
+  std::unordered_map<std::string, int> arena_of_blob;
+  /// Bytes of the planned activations, with and without the arenas.
+  size_t planned_bytes = 0;
+  size_t unplanned_bytes = 0;
+};
+
+/// Plans the memory of the activations of `nets`, which run one after the
+/// other in a single workspace, e.g. the nets of a predictor. Activations
+/// whose lifetimes do not overlap, within a net or across nets, share an
+/// arena.
+///
+/// The sizes come from `shape_info`, usually the bound shapes given by a
+/// BoundShapeInferencer. Only the bucketing depends on them, when to share
+/// depends on the order of the ops alone, so the plan stays valid for any
+/// batch size; up to the bound no arena needs more than `bytes`.
+///
+/// External inputs and outputs of the nets, blobs in `dont_share`, blobs
+/// without a known size and the blobs of ops that alias their inputs are
+/// left alone. The nets have to run their ops in order, so only simple nets
+/// without subnets are supported.
+CAFFE2_API MemoryPlan planActivationMemory(
+    const std::vector<const NetDef*>& nets,
+    const ShapeInfoMap& shape_info,
+    const std::unordered_set<std::string>& dont_share = {});
+
+/// Returns `net` with its planned activations renamed to their arenas.
+CAFFE2_API NetDef applyMemoryPlan(const NetDef& net, const MemoryPlan& plan);
+
+/// Allocates the CPU arenas of `plan` in `ws` at their bound size, so that
+/// the first run of the nets does not grow them one by one.
+CAFFE2_API void preallocateMemoryPlan(const MemoryPlan& plan, Workspace* ws);
+
+/// Infers the bound shapes of `nets` from `spec` and `info`, then plans and
+/// applies their activation memory. Returns the nets to run instead.
+CAFFE2_API std::vector<NetDef> optimizeInferenceMemory(
+    const std::vector<NetDef>& nets,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& info,
+    Workspace* ws,
+    const std::unordered_set<std::string>& dont_share = {});
+
+} // namespace caffe2
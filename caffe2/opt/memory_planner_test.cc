@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/common.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/memory_planner.h"
+#include "caffe2/utils/proto_utils.h"
+
+using namespace caffe2;
+namespace {
+
+ShapeInfo makeTensorInfo(const std::vector<int64_t>& dims) {
+  ShapeInfo info;
+  std::vector<TensorBoundShape::DimType> dim_types(
+      dims.size(), TensorBoundShape_DimType_CONSTANT);
+  dim_types[0] = TensorBoundShape_DimType_BATCH;
+  info.setDimType(dim_types);
+  for (const auto d : dims) {
+    info.shape.add_dims(d);
+  }
+  info.shape.set_data_type(TensorProto_DataType_FLOAT);
+  return info;
+}
+
+// in -> h1 -> h2 -> h3 -> out
+NetDef makeChainNet() {
+  NetDef net;
+  net.set_name("chain");
+  net.add_external_input("in");
+  net.add_external_output("out");
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"in"}, {"h1"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"h1"}, {"h2"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"h2"}, {"h3"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"h3"}, {"out"}, {}));
+  return net;
+}
+
+ShapeInfoMap makeChainShapes(int64_t batch_size) {
+  ShapeInfoMap shapes;
+  for (const auto* name : {"in", "h1", "h2", "h3", "out"}) {
+    shapes.emplace(name, makeTensorInfo({batch_size, 4}));
+  }
+  return shapes;
+}
+
+} // namespace
+
+TEST(MemoryPlanner, SharesDisjointLifetimes) {
+  const auto net = makeChainNet();
+  const auto plan = planActivationMemory({&net}, makeChainShapes(8));
+
+  // h2 is read while h3 is produced, h1 is not used anymore
+  ASSERT_EQ(plan.arenas.size(), 2);
+  EXPECT_EQ(plan.arena_of_blob.at("h1"), plan.arena_of_blob.at("h3"));
+  EXPECT_NE(plan.arena_of_blob.at("h1"), plan.arena_of_blob.at("h2"));
+  EXPECT_FALSE(plan.arena_of_blob.count("in"));
+  EXPECT_FALSE(plan.arena_of_blob.count("out"));
+  EXPECT_EQ(plan.unplanned_bytes, 3 * 8 * 4 * sizeof(float));
+  EXPECT_EQ(plan.planned_bytes, 2 * 8 * 4 * sizeof(float));
+
+  const auto planned = applyMemoryPlan(net, plan);
+  const auto& h1_arena = plan.arenas[plan.arena_of_blob.at("h1")].name;
+  EXPECT_EQ(planned.op(0).input(0), "in");
+  EXPECT_EQ(planned.op(0).output(0), h1_arena);
+  EXPECT_EQ(planned.op(2).output(0), h1_arena);
+  EXPECT_EQ(planned.op(3).output(0), "out");
+}
+
+TEST(MemoryPlanner, SizeBuckets) {
+  const auto net = makeChainNet();
+  auto shapes = makeChainShapes(8);
+  shapes["h3"] = makeTensorInfo({8, 4000});
+  const auto plan = planActivationMemory({&net}, shapes);
+
+  EXPECT_EQ(plan.arenas.size(), 3);
+  EXPECT_NE(plan.arena_of_blob.at("h1"), plan.arena_of_blob.at("h3"));
+}
+
+TEST(MemoryPlanner, DontShare) {
+  const auto net = makeChainNet();
+  const auto plan = planActivationMemory({&net}, makeChainShapes(8), {"h3"});
+
+  EXPECT_EQ(plan.arenas.size(), 2);
+  EXPECT_FALSE(plan.arena_of_blob.count("h3"));
+}
+
+TEST(MemoryPlanner, SharesAcrossNets) {
+  const auto first = makeChainNet();
+  NetDef second;
+  second.set_name("second");
+  second.add_external_input("out");
+  second.add_external_output("out2");
+  second.add_op()->CopyFrom(
+      CreateOperatorDef("Relu", "", {"out"}, {"g1"}, {}));
+  second.add_op()->CopyFrom(
+      CreateOperatorDef("Relu", "", {"g1"}, {"out2"}, {}));
+  auto shapes = makeChainShapes(8);
+  shapes.emplace("g1", makeTensorInfo({8, 4}));
+  shapes.emplace("out2", makeTensorInfo({8, 4}));
+
+  const auto plan = planActivationMemory({&first, &second}, shapes);
+  EXPECT_EQ(plan.arenas.size(), 2);
+  EXPECT_TRUE(plan.arena_of_blob.count("g1"));
+}
+
+TEST(MemoryPlanner, RunsBeyondTheBound) {
+  const auto net = makeChainNet();
+  const auto plan = planActivationMemory({&net}, makeChainShapes(8));
+  const auto planned = applyMemoryPlan(net, plan);
+
+  Workspace ws;
+  preallocateMemoryPlan(plan, &ws);
+  for (const auto& arena : plan.arenas) {
+    EXPECT_EQ(
+        BlobGetMutableTensor(ws.GetBlob(arena.name), CPU)->nbytes(),
+        arena.bytes);
+  }
+  // The batch is larger than the one the plan was made for.
+  auto* in = BlobGetMutableTensor(ws.CreateBlob("in"), CPU);
+  in->Resize(16, 4);
+  auto* in_data = in->mutable_data<float>();
+  for (int i = 0; i < in->numel(); ++i) {
+    in_data[i] = i % 3 - 1;
+  }
+  ASSERT_TRUE(ws.RunNetOnce(planned));
+  const auto& out = ws.GetBlob("out")->Get<TensorCPU>();
+  ASSERT_EQ(out.numel(), in->numel());
+  for (int i = 0; i < out.numel(); ++i) {
+    EXPECT_EQ(out.data<float>()[i], std::max(0.0f, in_data[i]));
+  }
+}
+
+TEST(MemoryPlanner, RejectsDagNets) {
+  auto net = makeChainNet();
+  net.set_type("dag");
+  EXPECT_THROW(
+      planActivationMemory({&net}, makeChainShapes(8)), EnforceNotMet);
+}
@@ -28,6 +28,13 @@ In foo_avx.cc, do:
      [actual avx implementation]
    }
 
+In foo_neon.cc, do:
+   #if defined(__aarch64__)
+   void foo__neon(int a, float b) {
+     [actual neon implementation]
+   }
+   #endif
+
 In foo.cc, do:
    // The base implementation should *always* be provided.
    void foo__base(int a, float b) {
@@ -36,12 +43,14 @@ In foo.cc, do:
    decltype(foo__base) foo__avx512;
    decltype(foo__base) foo__avx2;
    decltype(foo__base) foo__avx;
+   decltype(foo__base) foo__neon;
    void foo(int a, float b) {
      // You should always order things by their preference, faster
      // implementations earlier in the function.
      AVX512_DO(foo, a, b);
      AVX2_DO(foo, a, b);
      AVX_DO(foo, a, b);
+     NEON_DO(foo, a, b);
      BASE_DO(foo, a, b);
    }
 
@@ -59,6 +68,9 @@ In foo.cc, do:
 //    and __AVX__.
 // During run time:
 //    we use cpuinfo to identify cpu support and run the proper functions.
+//
+// NEON is part of every aarch64 CPU, so the _neon.cc files are built with the
+// common files, without extra flags, and NEON_DO picks them at build time.
 
 #pragma once
 
@@ -124,3 +136,9 @@ In foo.cc, do:
 #define AVX_DO(funcname, ...)
 #define AVX_F16C_DO(funcname, ...)
 #endif // CAFFE2_PERF_WITH_AVX
+
+#if defined(__aarch64__)
+#define NEON_DO(funcname, ...) return funcname##__neon(__VA_ARGS__);
+#else // defined(__aarch64__)
+#define NEON_DO(funcname, ...)
+#endif // defined(__aarch64__)
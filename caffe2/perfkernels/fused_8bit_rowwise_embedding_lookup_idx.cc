@@ -127,6 +127,18 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlowIdx(
         reinterpret_cast<const uint8_t*>(&one)[0],                                          \
         1,                                                                                  \
         "Fused8BitRowwiseEmbeddingLookup is not supported on this platform");               \
+    AVX512_DO(                                                                              \
+        Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                         \
+        output_size,                                                                        \
+        index_size,                                                                         \
+        data_size,                                                                          \
+        input,                                                                              \
+        indices,                                                                            \
+        offsets,                                                                            \
+        weights,                                                                            \
+        normalize_by_lengths,                                                               \
+        out);                                                                               \
     AVX2_FMA_DO(                                                                            \
         Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                         \
@@ -139,6 +151,18 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlowIdx(
         weights,                                                                            \
         normalize_by_lengths,                                                               \
         out);                                                                               \
+    NEON_DO(                                                                                \
+        Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                         \
+        output_size,                                                                        \
+        index_size,                                                                         \
+        data_size,                                                                          \
+        input,                                                                              \
+        indices,                                                                            \
+        offsets,                                                                            \
+        weights,                                                                            \
+        normalize_by_lengths,                                                               \
+        out);                                                                               \
     BASE_DO(                                                                                \
         Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                         \
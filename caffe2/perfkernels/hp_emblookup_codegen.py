@@ -7,39 +7,194 @@ import sys
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
 
+class Isa(object):
+    """Vector types and intrinsics of an instruction set. fmadd(a, b, c)
+    computes a * b + c, add, mul and storeu are function names as well, the other
+    snippets are format strings of the emitted C++ expressions."""
+
+    def __init__(
+        self,
+        name,
+        suffix,
+        width,
+        vec,
+        setzero,
+        set1,
+        fmadd,
+        add,
+        mul,
+        loadu,
+        storeu,
+        load_half,
+        load_uint8,
+        prefetch,
+        prefdist,
+        unroll_block_sizes,
+        generic_load_half=None,
+        generic_load_uint8=None,
+        half_tail=None,
+    ):
+        self.name = name
+        self.suffix = suffix
+        # number of floats per register
+        self.width = width
+        self.vec = vec
+        self.setzero = setzero
+        self.set1 = set1
+        self.fmadd = fmadd
+        self.add = add
+        self.mul = mul
+        self.loadu = loadu
+        self.storeu = storeu
+        self.load_half = load_half
+        self.load_uint8 = load_uint8
+        self.prefetch = prefetch
+        # prefetch distance in rows
+        self.prefdist = prefdist
+        # block sizes with a fully unrolled kernel
+        self.unroll_block_sizes = unroll_block_sizes
+        # loads in the loop of the generic kernel, if formatted differently
+        self.generic_load_half = generic_load_half or load_half
+        self.generic_load_uint8 = generic_load_uint8 or load_uint8
+        # accumulates the at::Half ip[j] in the remainder loop
+        self.half_tail = half_tail or [
+            "          op[j] = std::fma(wgt, static_cast<float>(ip[j]), op[j]);"
+        ]
+
+
+isas = {
+    "avx2": Isa(
+        name="AVX2",
+        suffix="__avx2_fma",
+        width=8,
+        vec="__m256",
+        setzero="_mm256_setzero_ps()",
+        set1="_mm256_set1_ps({})",
+        fmadd="_mm256_fmadd_ps",
+        add="_mm256_add_ps",
+        mul="_mm256_mul_ps",
+        loadu="_mm256_loadu_ps({})",
+        storeu="_mm256_storeu_ps",
+        load_half="_mm256_cvtph_ps(\n"
+        "                _mm_loadu_si128(reinterpret_cast<const __m128i*>({})))",
+        load_uint8="_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
+        "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>({}))))",
+        prefetch="_mm_prefetch(\n"
+        "            reinterpret_cast<const char*>({}), _MM_HINT_T0)",
+        prefdist=16,
+        unroll_block_sizes=[128, 64, 32, 16],
+        generic_load_half="_mm256_cvtph_ps(_mm_loadu_si128(\n"
+        "                      reinterpret_cast<const __m128i*>({})))",
+        generic_load_uint8="_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"
+        "                      reinterpret_cast<const __m128i*>({}))))",
+        half_tail=[
+            "          vtmp1[0] = ip[j];",
+            "          __m256 vtmp2 =\n"
+            "              _mm256_cvtph_ps(*(reinterpret_cast<const __m128i*>(vtmp1)));",
+            "          op[j] = std::fma(wgt, ((float*)(&vtmp2))[0], op[j]);",
+        ],
+    ),
+    # Wider registers go through a row in fewer iterations, so rows are
+    # prefetched further ahead.
+    "avx512": Isa(
+        name="AVX512",
+        suffix="__avx512",
+        width=16,
+        vec="__m512",
+        setzero="_mm512_setzero_ps()",
+        set1="_mm512_set1_ps({})",
+        fmadd="_mm512_fmadd_ps",
+        add="_mm512_add_ps",
+        mul="_mm512_mul_ps",
+        loadu="_mm512_loadu_ps({})",
+        storeu="_mm512_storeu_ps",
+        load_half="_mm512_cvtph_ps(\n"
+        "                _mm256_loadu_si256(reinterpret_cast<const __m256i*>({})))",
+        load_uint8="_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(\n"
+        "                _mm_loadu_si128(reinterpret_cast<const __m128i*>({}))))",
+        prefetch="_mm_prefetch(\n"
+        "            reinterpret_cast<const char*>({}), _MM_HINT_T0)",
+        prefdist=32,
+        unroll_block_sizes=[128, 64, 32, 16],
+    ),
+    # aarch64 has 32 vector registers of 4 floats, 128 floats do not fit.
+    "neon": Isa(
+        name="NEON",
+        suffix="__neon",
+        width=4,
+        vec="float32x4_t",
+        setzero="vdupq_n_f32(0.0f)",
+        set1="vdupq_n_f32({})",
+        fmadd="neon_fmadd",
+        add="vaddq_f32",
+        mul="vmulq_f32",
+        loadu="vld1q_f32({})",
+        storeu="vst1q_f32",
+        load_half="neon_load_half({})",
+        load_uint8="neon_load_uint8({})",
+        prefetch="__builtin_prefetch({}, 0, 3)",
+        prefdist=16,
+        unroll_block_sizes=[64, 32, 16],
+    ),
+}
+
+# Helpers of the NEON kernels, they keep the loads within the row.
+neon_helpers = """\
+static inline float32x4_t
+neon_fmadd(float32x4_t a, float32x4_t b, float32x4_t c) {
+  return vfmaq_f32(c, a, b);
+}
+
+static inline float32x4_t neon_load_half(const at::Half* ptr) {
+  return vcvt_f32_f16(vld1_f16(reinterpret_cast<const __fp16*>(ptr)));
+}
+
+static inline float32x4_t neon_load_uint8(const uint8_t* ptr) {
+  uint32_t bits;
+  std::memcpy(&bits, ptr, sizeof(bits));
+  return vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vcreate_u8(bits)))));
+}
+"""
+
+
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
+        vop = "vop%d" % regid
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        %s = %s(vwgt, %s, %s);"
+                % (vop, isa.fmadd, isa.loadu.format("ip + (%d)" % regid), vop)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        %s = %s(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s,\n"
+                "            %s);"
+                % (vop, isa.fmadd, isa.load_half.format("ip + (%d)" % regid), vop)
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        %s = %s(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s,\n"
+                "            %s(%s, vbio));"
+                % (
+                    vop,
+                    isa.fmadd,
+                    isa.load_uint8.format("ip + (%d)" % regid),
+                    isa.add,
+                    vop,
+                )
             )
         else:
             assert False
 
         if prefetch:
             code.append(
-                "        _mm_prefetch(\n"
-                "            reinterpret_cast<const char*>(&ip_next_T0[%d]), _MM_HINT_T0);"
-                % (regid)
+                "        %s;" % isa.prefetch.format("&ip_next_T0[%d]" % regid)
             )
         else:
             code.append(
@@ -66,8 +221,8 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa.width * i
+        code.append("      " + isa.vec + " vop" + str(j) + " = " + isa.setzero + ";")
 
     # inner loop
     if use_offsets:
@@ -120,7 +275,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + isa.vec + " vbio = " + isa.set1.format("bio") + ";")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +283,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa.vec + " vwgt = " + isa.set1.format("wgt") + ";")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,7 +305,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -162,20 +317,25 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa.width * i
+        code.append("        " + isa.storeu + "(&op[" + str(j) + "], vop" + str(j) + ");")
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        " + isa.vec + " vlen_inv = " + isa.set1.format("1.0f / length") + ";"
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        " + isa.vec + " vlen_inv = "
+            + isa.set1.format("1.0f / lengths[rangeIndex]") + ";"
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         code.append(
-            "        _mm256_storeu_ps(&op["
+            "        " + isa.storeu + "(&op["
             + str(j)
-            + "], _mm256_mul_ps("
+            + "], " + isa.mul + "("
             + "vop"
             + str(j)
             + ", vlen_inv));"
@@ -191,43 +351,62 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         code = []
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              %s(\n"
+                "                  vwgt, %s, %s));"
+                % (
+                    isa.storeu,
+                    isa.fmadd,
+                    isa.loadu.format("&ip[j]"),
+                    isa.loadu.format("&op[j]"),
+                )
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  %s,\n"
+                "                  %s));"
+                % (
+                    isa.storeu,
+                    isa.fmadd,
+                    isa.generic_load_half.format("&ip[j]"),
+                    isa.loadu.format("&op[j]"),
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  %s,\n"
+                "                  %s(%s, vbio)));"
+                % (
+                    isa.storeu,
+                    isa.fmadd,
+                    isa.generic_load_uint8.format("&ip[j]"),
+                    isa.add,
+                    isa.loadu.format("&op[j]"),
+                )
             )
         else:
             assert False
 
         code.append(
-            "          _mm_prefetch(\n"
-            "              reinterpret_cast<const char*>(&ip_next_T0[j]), _MM_HINT_T0);"
+            "          %s;"
+            % isa.prefetch.replace("\n            ", "\n              ").format(
+                "&ip_next_T0[j]"
+            )
         )
 
         return code
 
     code = []
-    if InType == "at::Half":
+    if InType == "at::Half" and isa.name == "AVX2":
         code.append("    alignas(64) at::Half vtmp1[8] = {0};")
 
 
@@ -249,8 +428,10 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {0} <= block_size; j += {0}) {{".format(isa.width)
+    )
+    code.append("        " + isa.storeu + "(op + j, " + isa.setzero + ");")
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -307,7 +488,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + isa.vec + " vbio = " + isa.set1.format("bio") + ";")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +496,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa.vec + " vwgt = " + isa.set1.format("wgt") + ";")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,7 +518,9 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa.width)
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -345,12 +528,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     if InType == "float":
         code.append("          op[j] = std::fma(wgt, ip[j], op[j]);")
     elif InType == "at::Half":
-        code.append("          vtmp1[0] = ip[j];")
-        code.append(
-            "          __m256 vtmp2 =\n"
-            "              _mm256_cvtph_ps(*(reinterpret_cast<const __m128i*>(vtmp1)));"
-        )
-        code.append("          op[j] = std::fma(wgt, ((float*)(&vtmp2))[0], op[j]);")
+        code.extend(isa.half_tail)
     elif InType == "uint8_t":
         code.append("          op[j] = std::fma(wgt, (float)ip[j], bio + op[j]);")
     else:
@@ -366,12 +544,17 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append(
+        "        " + isa.vec + " vlen_inv = " + isa.set1.format("len_inv") + ";"
+    )
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa.width)
+    )
+    code.append(
+        "          %s(\n"
+        "              &op[j], %s(%s, vlen_inv));"
+        % (isa.storeu, isa.mul, isa.loadu.format("&op[j]"))
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -389,19 +572,21 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
 opts = parser.parse_args()
+isa = isas[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -421,10 +606,20 @@ code.append("//// BY {}".format(sys.argv[0]))
 code.append("//// DO NOT MODIFY!!!")
 code.append("//// --------------------------\n")
 
-code.append("#include <c10/util/Half.h>")
-code.append("#include <immintrin.h>")
+if opts.isa == "neon":
+    # NEON is part of aarch64, the file is built with the common files and
+    # is empty on other architectures.
+    code.append("#if defined(__aarch64__)\n")
+    code.append("#include <arm_neon.h>")
+    code.append("#include <c10/util/Half.h>")
+    code.append("#include <cstring>")
+else:
+    code.append("#include <c10/util/Half.h>")
+    code.append("#include <immintrin.h>")
 
 code.append("namespace caffe2 {\n")
+if opts.isa == "neon":
+    code.append(neon_helpers)
 for o in options:
     [IndexTypeName, IndexType, InTypeName, InType, OutTypeName, OutType] = o
 
@@ -438,7 +633,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa.suffix
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -460,7 +655,7 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append("  const " + IndexType + " prefdist_T0 = {};".format(isa.prefdist))
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -474,17 +669,25 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    for i, unroll_block_size in enumerate(isa.unroll_block_sizes):
+        code.append(
+            "  {}if (block_size == {}) {{".format(
+                "} else " if i > 0 else "", unroll_block_size
+            )
+        )
+        code += unroll(
+            unroll_block_size // isa.width,
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+            opts.use_offsets,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
@@ -520,6 +723,8 @@ for o in options:
     code.append("")
 
 code.append("} // namespace caffe2")
+if opts.isa == "neon":
+    code.append("\n#endif // defined(__aarch64__)")
 
 with open(filename, "w") as fout:
     for c in code:
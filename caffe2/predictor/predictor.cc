@@ -1,6 +1,7 @@
 #include "caffe2/predictor/predictor.h"
 #include <unordered_set>
 #include "caffe2/core/init.h"
+#include "caffe2/core/scope_guard.h"
 
 namespace caffe2 {
 
@@ -123,4 +124,158 @@ bool Predictor::operator()(const TensorMap& inputs, TensorMap* outputs) {
   return true;
 }
 
+SharedWorkspacePredictor::SharedWorkspacePredictor(PredictorConfig config)
+    : config_(std::move(config)) {
+  CAFFE_ENFORCE(config_.ws, "SharedWorkspacePredictor needs a workspace");
+  CAFFE_ENFORCE(config_.predict_net, "SharedWorkspacePredictor needs a net");
+  const auto& net = *config_.predict_net;
+  // Everything the net writes is local, even the blobs that also exist in
+  // the shared workspace, so that the shared workspace is never modified.
+  for (const auto& op : net.op()) {
+    for (const auto& output : op.output()) {
+      local_blobs_.insert(output);
+    }
+  }
+  for (const auto& name : config_.input_names) {
+    local_blobs_.insert(name);
+  }
+  for (const auto& name : net.external_input()) {
+    if (!config_.ws->HasBlob(name)) {
+      local_blobs_.insert(name);
+    }
+  }
+  // Creates the first workspace, which checks the net early.
+  release(acquire());
+}
+
+size_t SharedWorkspacePredictor::num_workspaces() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_workspaces_;
+}
+
+std::unique_ptr<SharedWorkspacePredictor::RequestWorkspace>
+SharedWorkspacePredictor::acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_workspaces_.empty()) {
+      auto request_ws = std::move(free_workspaces_.back());
+      free_workspaces_.pop_back();
+      return request_ws;
+    }
+  }
+  auto request_ws = std::make_unique<RequestWorkspace>();
+  request_ws->ws = std::make_unique<Workspace>(config_.ws.get());
+  for (const auto& name : local_blobs_) {
+    BlobGetMutableTensor(request_ws->ws->CreateLocalBlob(name), CPU);
+  }
+  request_ws->net = request_ws->ws->CreateNet(config_.predict_net);
+  CAFFE_ENFORCE(request_ws->net, "Could not create net: ", def().name());
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++num_workspaces_;
+  return request_ws;
+}
+
+void SharedWorkspacePredictor::release(
+    std::unique_ptr<RequestWorkspace> request_ws) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_workspaces_.push_back(std::move(request_ws));
+}
+
+bool SharedWorkspacePredictor::run(
+    const std::vector<std::pair<std::string, const TensorCPU*>>& inputs,
+    const std::vector<std::string>& output_names,
+    TensorList* outputs) {
+  for (const auto& input : inputs) {
+    CAFFE_ENFORCE(
+        local_blobs_.count(input.first),
+        "Input is not a blob of the request workspace: ",
+        input.first);
+  }
+  for (const auto& name : output_names) {
+    CAFFE_ENFORCE(
+        local_blobs_.count(name),
+        "Output is not a blob of the request workspace: ",
+        name);
+  }
+
+  auto request_ws = acquire();
+  auto* ws = request_ws->ws.get();
+  // Drops the references to the inputs and outputs whatever happens, the
+  // next request must neither read the inputs nor write into the tensors
+  // the caller holds, it allocates new outputs instead.
+  auto guard = MakeGuard([&] {
+    for (const auto& input : inputs) {
+      BlobSetTensor(ws->GetBlob(input.first), Tensor(CPU));
+    }
+    for (const auto& name : output_names) {
+      BlobSetTensor(ws->GetBlob(name), Tensor(CPU));
+    }
+    release(std::move(request_ws));
+  });
+
+  for (const auto& input : inputs) {
+    BlobSetTensor(
+        getBlob(ws, input.first), input.second->UnsafeSharedInstance());
+  }
+  if (!request_ws->net->Run()) {
+    return false;
+  }
+  outputs->clear();
+  for (const auto& name : output_names) {
+    outputs->emplace_back(getTensor(ws, name).UnsafeSharedInstance());
+  }
+  return true;
+}
+
+bool SharedWorkspacePredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  const auto& net = def();
+  CAFFE_ENFORCE(
+      inputs.size() <= static_cast<unsigned>(net.external_input_size()));
+  std::vector<std::pair<std::string, const TensorCPU*>> named_inputs;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    named_inputs.emplace_back(net.external_input(i), &inputs[i]);
+  }
+  const std::vector<std::string> output_names{net.external_output().begin(),
+                                              net.external_output().end()};
+  return run(named_inputs, output_names, outputs);
+}
+
+bool SharedWorkspacePredictor::operator()(
+    const TensorMap& inputs,
+    TensorList* outputs) {
+  if (!input_names().empty()) {
+    CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
+  }
+  std::vector<std::pair<std::string, const TensorCPU*>> named_inputs;
+  for (const auto& input : inputs) {
+    named_inputs.emplace_back(input.first, &input.second);
+  }
+  const auto& net = def();
+  const std::vector<std::string> output_names{net.external_output().begin(),
+                                              net.external_output().end()};
+  return run(named_inputs, output_names, outputs);
+}
+
+bool SharedWorkspacePredictor::operator()(
+    const TensorMap& inputs,
+    TensorMap* outputs) {
+  if (!input_names().empty()) {
+    CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
+  }
+  std::vector<std::pair<std::string, const TensorCPU*>> named_inputs;
+  for (const auto& input : inputs) {
+    named_inputs.emplace_back(input.first, &input.second);
+  }
+  TensorList output_list;
+  if (!run(named_inputs, output_names(), &output_list)) {
+    return false;
+  }
+  for (size_t i = 0; i < output_list.size(); ++i) {
+    outputs->emplace(output_names()[i], std::move(output_list[i]));
+  }
+  return true;
+}
+
 } // namespace caffe2
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <unordered_set>
 #include "caffe2/core/net.h"
 #include "caffe2/core/tensor.h"
@@ -68,4 +69,68 @@ class CAFFE2_API Predictor {
  protected:
   PredictorConfig config_;
 };
+
+// Serves concurrent requests of one model without copying it per thread.
+// The parameters live in the workspace of the config, which is shared by all
+// the requests and never written to. Each request runs in a child workspace
+// that only holds the inputs, intermediate and output blobs of the net.
+// The child workspaces and their nets are pooled, so a request neither
+// creates operators nor, once warmed up, allocates its intermediate blobs.
+//
+// Unlike Predictor, the outputs belong to the caller and stay valid after
+// the next execution. The inputs are shared with the child workspace only
+// for the duration of the call.
+class CAFFE2_API SharedWorkspacePredictor {
+ public:
+  using TensorList = Predictor::TensorList;
+  using TensorMap = Predictor::TensorMap;
+
+  explicit SharedWorkspacePredictor(PredictorConfig config);
+
+  // Same as the Predictor ones, callable from several threads at once.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+  bool operator()(const TensorMap& inputs, TensorList* outputs);
+  bool operator()(const TensorMap& inputs, TensorMap* outputs);
+
+  const NetDef& def() const {
+    return *config_.predict_net;
+  };
+
+  const std::vector<std::string>& input_names() const {
+    return config_.input_names;
+  }
+
+  const std::vector<std::string>& output_names() const {
+    return config_.output_names;
+  }
+
+  // Number of child workspaces created so far, the peak number of
+  // concurrent requests.
+  size_t num_workspaces() const;
+
+ private:
+  struct RequestWorkspace {
+    std::unique_ptr<Workspace> ws;
+    NetBase* net = nullptr;
+  };
+
+  std::unique_ptr<RequestWorkspace> acquire();
+  void release(std::unique_ptr<RequestWorkspace> request_ws);
+
+  // Shares `inputs` with the blobs of a pooled workspace, runs the net and
+  // moves the blobs `output_names` out of the workspace into `outputs`.
+  bool run(
+      const std::vector<std::pair<std::string, const TensorCPU*>>& inputs,
+      const std::vector<std::string>& output_names,
+      TensorList* outputs);
+
+  PredictorConfig config_;
+  // Blobs created in each child workspace instead of being looked up in
+  // the shared one
+  std::unordered_set<std::string> local_blobs_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<RequestWorkspace>> free_workspaces_;
+  size_t num_workspaces_ = 0;
+};
 } // namespace caffe2
@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +207,52 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST_F(PredictorTest, SharedWorkspaceConcurrentRequests) {
+  auto config =
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+  auto* shared_ws = config.ws.get();
+  const auto shared_blobs = shared_ws->Blobs().size();
+  SharedWorkspacePredictor predictor(std::move(config));
+  EXPECT_EQ(predictor.num_workspaces(), 1);
+
+  auto inputData = randomTensor({1, 4}, ctx_.get());
+  Predictor::TensorList input;
+  input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList expected;
+  (*p_)(input, &expected);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumRequests = 20;
+  std::vector<std::vector<Predictor::TensorList>> outputs(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kNumRequests; ++i) {
+        Predictor::TensorList output;
+        ASSERT_TRUE(predictor(input, &output));
+        outputs[t].push_back(std::move(output));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the outputs of earlier requests are not overwritten by later ones
+  for (const auto& thread_outputs : outputs) {
+    ASSERT_EQ(thread_outputs.size(), kNumRequests);
+    for (const auto& output : thread_outputs) {
+      ASSERT_EQ(output.size(), 1);
+      ASSERT_EQ(output.front().sizes(), expected.front().sizes());
+      for (int64_t i = 0; i < output.front().numel(); ++i) {
+        EXPECT_EQ(
+            output.front().data<float>()[i], expected.front().data<float>()[i]);
+      }
+    }
+  }
+  EXPECT_LE(predictor.num_workspaces(), kNumThreads);
+  // inputs, intermediates and outputs stay in the request workspaces
+  EXPECT_EQ(shared_ws->Blobs().size(), shared_blobs);
+}
+
 } // namespace caffe2
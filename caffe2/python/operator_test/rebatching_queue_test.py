@@ -165,6 +165,131 @@ class TestReBatchingQueue(TestCase):
                 workspace.FetchBlob(tensors[idx])[:5]
             )
 
+    def test_rebatching_queue_wraps_around(self):
+        net = core.Net('net')
+        workspace.FeedBlob(
+            "tensors", np.array([[x, -x] for x in range(7)], np.float32)
+        )
+
+        # The batches are larger than the capacity, and do not divide it.
+        queue = net.CreateRebatchingQueue([], 1, capacity=3, num_blobs=1)
+
+        producer_net = core.Net('producer')
+        producer_net.EnqueueRebatchingQueue(
+            [queue, "tensors"], [], enqueue_batch=True
+        )
+
+        consumer_net = core.Net('consumer')
+        result = consumer_net.DequeueRebatchingQueue(
+            [queue], 1, num_elements=7
+        )
+
+        plan = core.Plan('test')
+        plan.AddStep(core.execution_step('init', net))
+        plan.AddStep(
+            core.execution_step(
+                'worker', [
+                    core.execution_step('producer', producer_net, num_iter=2),
+                    core.execution_step('consumer', consumer_net, num_iter=2),
+                ],
+                concurrent_substeps=True
+            )
+        )
+        workspace.RunPlan(plan)
+
+        npt.assert_array_equal(
+            workspace.FetchBlob(result), workspace.FetchBlob("tensors")
+        )
+
+    def test_rebatching_queue_rejects_other_shapes(self):
+        net = core.Net('net')
+        workspace.FeedBlob("row", np.zeros(2, np.float32))
+        workspace.FeedBlob("other_row", np.zeros(3, np.float32))
+
+        queue = net.CreateRebatchingQueue([], 1, capacity=10, num_blobs=1)
+        net.EnqueueRebatchingQueue([queue, "row"], [])
+        workspace.RunNetOnce(net)
+
+        net = core.Net('enqueue')
+        net.EnqueueRebatchingQueue([queue, "other_row"], [])
+        with self.assertRaises(RuntimeError):
+            workspace.RunNetOnce(net)
+
+        # Once the queue is empty it takes elements of any shape.
+        net = core.Net('dequeue_enqueue')
+        net.DequeueRebatchingQueue([queue], ["dequeued"])
+        net.EnqueueRebatchingQueue([queue, "other_row"], [])
+        net.DequeueRebatchingQueue([queue], ["dequeued_other"])
+        workspace.RunNetOnce(net)
+
+        self.assertEqual(workspace.FetchBlob("dequeued").shape, (2,))
+        self.assertEqual(workspace.FetchBlob("dequeued_other").shape, (3,))
+
+    @given(
+        batch_size=st.integers(1, 10),
+        num_batches=st.integers(1, 10),
+        num_elements=st.integers(1, 10),
+        capacity=st.integers(1, 10)
+    )
+    @settings(deadline=10000)
+    def test_rebatching_single_producer_single_consumer(
+        self, batch_size, num_batches, num_elements, capacity
+    ):
+        init_net = core.Net('init_net')
+        queue = init_net.CreateRebatchingQueue(
+            [], 1, capacity=capacity, num_blobs=1,
+            single_producer_single_consumer=True
+        )
+
+        producer_net = core.Net('producer')
+        values = list(range(batch_size))
+        tensors = producer_net.GivenTensorIntFill(
+            [], 1, shape=[batch_size], values=values
+        )
+        producer_net.EnqueueRebatchingQueue(
+            [queue, tensors], [], enqueue_batch=True
+        )
+        close_net = core.Net('close')
+        close_net.CloseRebatchingQueue([queue], 0)
+        producer_step = core.execution_step(
+            'producer', [
+                core.execution_step(
+                    'produce', producer_net, num_iter=num_batches
+                ),
+                core.execution_step('close', close_net),
+            ]
+        )
+
+        outputs = []
+
+        def append(ins, outs):
+            outputs.extend(ins[0].data.tolist())
+
+        consumer_net = core.Net('consumer')
+        blobs = consumer_net.DequeueRebatchingQueue(
+            [queue], 1, num_elements=num_elements
+        )
+        consumer_net.Python(append)([blobs], 0)
+        # The last dequeue gets what is left once the queue is closed.
+        total = batch_size * num_batches
+        consumer_step = core.execution_step(
+            'consumer', consumer_net,
+            num_iter=(total + num_elements - 1) // num_elements
+        )
+
+        plan = core.Plan('test')
+        plan.AddStep(core.execution_step('init', init_net))
+        plan.AddStep(
+            core.execution_step(
+                'worker', [consumer_step, producer_step],
+                concurrent_substeps=True
+            )
+        )
+        self.ws.run(plan)
+
+        # A single consumer sees the elements in the order they were enqueued.
+        self.assertEquals(outputs, values * num_batches)
+
     @given(
         num_producers=st.integers(1, 5),
         num_consumers=st.integers(1, 5),
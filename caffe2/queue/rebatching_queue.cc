@@ -1,209 +1,253 @@
 #include "rebatching_queue.h"
-#include "caffe2/utils/smart_tensor_printer.h"
+
+#include <algorithm>
 
 namespace caffe2 {
 
 namespace {
 
-// This concat function will always create a new first dimension to concat
-void concat(
-    CPUContext& context,
-    const std::vector<std::vector<TensorCPU>>& inputs,
-    const std::vector<TensorCPU*>& outputs) {
-  CAFFE_ENFORCE(!inputs.empty());
-
-  const auto& inputZero = inputs[0];
-  const auto numTensors = inputZero.size();
-  const auto numRows = inputs.size();
-
-  // Precompute the output sizes to avoid resizing
-  std::vector<std::vector<int64_t>> outputDims(numTensors);
-
-  for (size_t i = 0; i < numTensors; ++i) {
-    SmartTensorPrinter::PrintTensor(inputZero.at(i));
-    outputDims[i] = inputZero.at(i).sizes().vec();
-    outputDims[i].insert(outputDims[i].begin(), numRows);
-  }
-
-  // Resize to the final output size
-  std::vector<void*> destinations(numTensors);
-  for (size_t i = 0; i < numTensors; ++i) {
-    outputs[i]->Resize(outputDims[i]);
-    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
-  }
-
-  for (size_t i = 0; i < numRows; ++i) {
-    CAFFE_ENFORCE_EQ(inputs[i].size(), numTensors);
-
-    for (int j = 0; j < numTensors; ++j) {
-      const auto& input = inputs[i][j];
-
-      CAFFE_ENFORCE(inputZero[j].meta() == input.dtype());
-      CAFFE_ENFORCE_EQ(inputZero[j].itemsize(), input.itemsize());
-      CAFFE_ENFORCE_EQ(inputZero[j].ndim(), input.dim());
-      for (int k = 0; k < input.dim(); ++k) {
-        CAFFE_ENFORCE_EQ(input.sizes()[k], inputZero[j].size(k));
-      }
-
-      // Skip empty tensors
-      if (input.numel() == 0) {
-        continue;
-      }
-
-      context.CopyItemsToCPU(
-          input.dtype(),
-          input.numel(),
-          input.raw_data() /* src */,
-          destinations[j] /* dst */
-      );
-
-      destinations[j] =
-          (char*)destinations[j] + input.numel() * input.itemsize();
-    }
+// Calls f(slabRow, row, count) for the one or two ranges of rows of a slab
+// that `numRows` rows starting at `position` take, `row` being the index of
+// the first row of the range among the `numRows` rows.
+template <typename F>
+void forEachSlabRange(uint64_t position, size_t numRows, size_t capacity, F f) {
+  const size_t begin = position % capacity;
+  const size_t first = std::min(numRows, capacity - begin);
+  f(begin, 0, first);
+  if (first < numRows) {
+    f(0, first, numRows - first);
   }
 }
+} // anonymous namespace
 
-std::vector<std::vector<TensorCPU>> split(
-    CPUContext& context,
-    const std::vector<const TensorCPU*>& inputs) {
-  CAFFE_ENFORCE(!inputs.empty());
-
-  const auto outputSize = inputs[0]->sizes().at(0);
-  std::vector<std::vector<TensorCPU>> outputs(outputSize);
-
-  for (const auto* inputPtr : inputs) {
-    CAFFE_ENFORCE(inputPtr);
-
-    const auto& input = *inputPtr;
-    const auto innerSize = input.size_from_dim(1);
-    const auto itemSize = input.dtype().itemsize();
-
-    auto outputDims = input.sizes().vec();
-    CAFFE_ENFORCE(!outputDims.empty());
-    outputDims.erase(outputDims.begin());
-    CAFFE_ENFORCE_EQ(input.sizes().at(0), outputSize);
-
-    for (int i = 0; i < outputSize; ++i) {
-      outputs[i].push_back(Tensor(outputDims, CPU));
-      context.CopyItemsToCPU(
-          input.dtype(),
-          innerSize,
-          (char*)input.raw_data() + i * innerSize * itemSize /* src */,
-          outputs[i].back().raw_mutable_data(input.dtype()) /* dst */);
-    }
+RebatchingQueue::RebatchingQueue(
+    size_t capacity,
+    size_t numBlobs,
+    bool singleProducerSingleConsumer)
+    : capacity_(capacity),
+      numBlobs_(numBlobs),
+      singleProducerSingleConsumer_(singleProducerSingleConsumer) {
+  CAFFE_ENFORCE_GT(capacity_, 0);
+  slabs_.reserve(numBlobs_);
+  for (size_t i = 0; i < numBlobs_; ++i) {
+    slabs_.emplace_back(CPU);
   }
-
-  return outputs;
 }
-} // anonymous namespace
-
-RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
-    : capacity_(capacity), numBlobs_(numBlobs), queue_(capacity) {}
 
 RebatchingQueue::~RebatchingQueue() {
   close();
 }
 
-bool RebatchingQueue::canRead() const {
-  return tail_ < head_;
+template <typename Predicate>
+void RebatchingQueue::wait(std::condition_variable& cv, Predicate predicate) {
+  if (predicate() || isClosed_) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  // head_ and tail_ are stored before numBlocked_ is read by notify(), and
+  // numBlocked_ is incremented here before they are read, so either notify()
+  // sees this thread or the predicate sees the new indices.
+  ++numBlocked_;
+  cv.wait(lock, [&] { return predicate() || isClosed_; });
+  --numBlocked_;
+}
+
+void RebatchingQueue::notify(std::condition_variable& cv) {
+  if (numBlocked_ > 0) {
+    // A thread that is about to block holds the mutex until it waits.
+    { std::lock_guard<std::mutex> g(mutex_); }
+    cv.notify_all();
+  }
 }
 
 bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
     const std::vector<TensorCPU*>& outputs) {
-  std::vector<std::vector<TensorCPU>> results;
-  results.reserve(numElements);
+  CAFFE_ENFORCE_EQ(numBlobs_, outputs.size());
 
-  for (;;) {
-    if (results.size() == numElements) {
-      break;
-    }
+  std::unique_lock<std::mutex> lock(consumerMutex_, std::defer_lock);
+  if (!singleProducerSingleConsumer_) {
+    lock.lock();
+  }
 
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
+  size_t numRows = 0;
+  while (numRows < numElements) {
+    wait(cvEmpty_, [this] { return tail_ < head_; });
 
-      cvEmpty_.wait(lock, [this] { return canRead() || isClosed_; });
+    const uint64_t tail = tail_;
+    const uint64_t head = head_;
+    // We only want to stop reading if the queue is empty and closed
+    if (tail == head) {
+      break;
+    }
 
-      // We only want to stop reading if the queue is empty and closed
-      if (!canRead() && isClosed_) {
-        break;
+    const size_t count = std::min<uint64_t>(numElements - numRows, head - tail);
+    for (size_t i = 0; i < numBlobs_; ++i) {
+      const auto& slab = slabs_[i];
+      auto* output = outputs[i];
+      if (numRows == 0) {
+        auto outputDims = slab.sizes().vec();
+        outputDims[0] = numElements;
+        output->Resize(outputDims);
+        output->raw_mutable_data(slab.dtype());
+      } else {
+        // The slabs may have been laid out again once the queue got empty.
+        CAFFE_ENFORCE(
+            output->dtype() == slab.dtype() &&
+                output->sizes().slice(1).equals(slab.sizes().slice(1)),
+            "Dequeued elements of blob ",
+            i,
+            " have different shapes or types");
       }
 
-      do {
-        results.push_back(std::move(queue_[tail_++ % capacity()]));
-      } while (canRead() && results.size() < numElements);
+      const size_t rowSize = slab.size_from_dim(1);
+      if (rowSize == 0) {
+        continue;
+      }
+      const size_t rowBytes = rowSize * slab.itemsize();
+      const char* src = static_cast<const char*>(slab.raw_data());
+      char* dst = static_cast<char*>(output->raw_mutable_data());
+      forEachSlabRange(
+          tail, count, capacity_, [&](size_t slabRow, size_t row, size_t n) {
+            context.CopyItemsToCPU(
+                slab.dtype(),
+                n * rowSize,
+                src + slabRow * rowBytes /* src */,
+                dst + (numRows + row) * rowBytes /* dst */);
+          });
     }
 
-    if (numElements == 1) {
-      cvOverflow_.notify_one();
-    } else {
-      cvOverflow_.notify_all();
-    }
+    tail_ = tail + count;
+    numRows += count;
+    notify(cvOverflow_);
   }
 
-  if (results.empty()) {
+  if (numRows == 0) {
     return false;
   }
 
-  concat(context, results, outputs);
+  if (numRows < numElements) {
+    for (auto* output : outputs) {
+      output->ShrinkTo(numRows);
+    }
+  }
 
   return true;
 }
 
-bool RebatchingQueue::canWrite() const {
-  return tail_ + capacity() > head_;
-}
-
 bool RebatchingQueue::enqueueOne(
-    CPUContext& /*context*/,
+    CPUContext& context,
     const std::vector<const TensorCPU*>& inputs) {
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs.emplace_back();
-  auto& tensorVector = splittedInputs.back();
-  tensorVector.reserve(inputs.size());
-  for (const auto* tensorPtr : inputs) {
-    tensorVector.push_back(tensorPtr->Clone());
-  }
-
-  return enqueue(std::move(splittedInputs));
+  return enqueue(context, inputs, false);
 }
 
 bool RebatchingQueue::enqueueMany(
     CPUContext& context,
     const std::vector<const TensorCPU*>& inputs) {
-  CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
+  return enqueue(context, inputs, true);
+}
+
+void RebatchingQueue::layoutSlabs(
+    const std::vector<const TensorCPU*>& inputs,
+    bool isBatch) {
+  const bool isEmpty = tail_ == head_;
+  for (size_t i = 0; i < numBlobs_; ++i) {
+    const auto& input = *inputs[i];
+    auto slabDims = input.sizes().vec();
+    if (isBatch) {
+      slabDims[0] = capacity_;
+    } else {
+      slabDims.insert(slabDims.begin(), capacity_);
+    }
 
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs = split(context, inputs);
-  return enqueue(std::move(splittedInputs));
+    auto& slab = slabs_[i];
+    if (slab.dtype() == input.dtype() && slab.sizes().equals(slabDims)) {
+      continue;
+    }
+    CAFFE_ENFORCE(
+        isEmpty,
+        "Enqueuing an element of type ",
+        input.dtype().name(),
+        " and shape ",
+        c10::IntArrayRef(slabDims).slice(1),
+        " for blob ",
+        i,
+        " into a queue holding elements of type ",
+        slab.dtype().name(),
+        " and shape ",
+        slab.sizes().slice(1));
+    slab.Resize(slabDims);
+    slab.raw_mutable_data(input.dtype());
+  }
 }
 
 bool RebatchingQueue::enqueue(
-    std::vector<std::vector<TensorCPU>> splittedInputs) {
-  int idx = 0;
-  for (;;) {
-    if (idx >= splittedInputs.size()) {
-      break;
+    CPUContext& context,
+    const std::vector<const TensorCPU*>& inputs,
+    bool isBatch) {
+  CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
+  CAFFE_ENFORCE(!inputs.empty());
+
+  size_t numElements = 1;
+  if (isBatch) {
+    CAFFE_ENFORCE(inputs[0]);
+    CAFFE_ENFORCE_GE(inputs[0]->dim(), 1);
+    numElements = inputs[0]->size(0);
+  }
+  for (const auto* inputPtr : inputs) {
+    CAFFE_ENFORCE(inputPtr);
+    if (isBatch) {
+      CAFFE_ENFORCE_GE(inputPtr->dim(), 1);
+      CAFFE_ENFORCE_EQ(inputPtr->size(0), numElements);
     }
+  }
+  if (numElements == 0) {
+    return true;
+  }
 
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock(producerMutex_, std::defer_lock);
+  if (!singleProducerSingleConsumer_) {
+    lock.lock();
+  }
 
-      cvOverflow_.wait(lock, [this] { return canWrite() || isClosed_; });
+  layoutSlabs(inputs, isBatch);
 
-      if (isClosed_) {
-        // If we are here it means that we didn't apply the entire batch and if
-        // we get closed in the middle of enquing we treat it as a non-success.
-        return false;
-      }
+  size_t numRows = 0;
+  while (numRows < numElements) {
+    wait(cvOverflow_, [this] { return tail_ + capacity_ > head_; });
 
-      do {
-        queue_[head_++ % capacity()] = std::move(splittedInputs[idx++]);
-      } while (canWrite() && idx < splittedInputs.size());
+    if (isClosed_) {
+      // If we are here it means that we didn't apply the entire batch and if
+      // we get closed in the middle of enquing we treat it as a non-success.
+      return false;
     }
 
-    cvEmpty_.notify_all();
+    const uint64_t head = head_;
+    const size_t count =
+        std::min<uint64_t>(numElements - numRows, tail_ + capacity_ - head);
+    for (size_t i = 0; i < numBlobs_; ++i) {
+      auto& slab = slabs_[i];
+      const size_t rowSize = slab.size_from_dim(1);
+      if (rowSize == 0) {
+        continue;
+      }
+      const size_t rowBytes = rowSize * slab.itemsize();
+      const char* src = static_cast<const char*>(inputs[i]->raw_data());
+      char* dst = static_cast<char*>(slab.raw_mutable_data());
+      forEachSlabRange(
+          head, count, capacity_, [&](size_t slabRow, size_t row, size_t n) {
+            context.CopyItemsToCPU(
+                slab.dtype(),
+                n * rowSize,
+                src + (numRows + row) * rowBytes /* src */,
+                dst + slabRow * rowBytes /* dst */);
+          });
+    }
+
+    head_ = head + count;
+    numRows += count;
+    notify(cvEmpty_);
   }
 
   return true;
@@ -218,15 +262,12 @@ size_t RebatchingQueue::numBlobs() const {
 }
 
 bool RebatchingQueue::isClosed() const {
-  std::lock_guard<std::mutex> g(mutex_);
   return isClosed_;
 }
 
 void RebatchingQueue::close() {
-  {
-    std::lock_guard<std::mutex> g(mutex_);
-    isClosed_ = true;
-  }
+  isClosed_ = true;
+  { std::lock_guard<std::mutex> g(mutex_); }
 
   cvEmpty_.notify_all();
   cvOverflow_.notify_all();
@@ -13,13 +13,27 @@
 
 namespace caffe2 {
 
-// TODO: This is a very naive implementation with a single mutex. We can do the
-// atomic index + circular queue optimizations or pull something more
-// heavy-weight later
-
+// The elements are stored in one slab per blob, a tensor of `capacity` rows
+// used as a ring buffer. Enqueuing copies the rows of the inputs into the
+// slabs and dequeuing copies a range of rows of each slab into the outputs,
+// with at most two copies per blob (the range may wrap around).
+//
+// The producers only ever move head_ and the consumers tail_, so a producer
+// and a consumer never wait for each other unless the queue is full or
+// empty. Concurrent producers are serialized by producerMutex_ and
+// concurrent consumers by consumerMutex_. If the queue is created with
+// singleProducerSingleConsumer, the caller guarantees that there is only
+// one producer and one consumer at a time and neither mutex is taken.
+//
+// All the elements in the queue have the same shape and type per blob. The
+// slabs are laid out again when an element of another shape is enqueued
+// into an empty queue, enqueuing it into a non-empty queue fails.
 class RebatchingQueue {
  public:
-  RebatchingQueue(size_t capacity, size_t numBlobs);
+  RebatchingQueue(
+      size_t capacity,
+      size_t numBlobs,
+      bool singleProducerSingleConsumer = false);
 
   ~RebatchingQueue();
 
@@ -45,24 +59,39 @@ class RebatchingQueue {
   void close();
 
  private:
-  bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
+  bool enqueue(
+      CPUContext& context,
+      const std::vector<const TensorCPU*>& inputs,
+      bool isBatch);
+
+  // Lays the slabs out for elements shaped like the inputs if the queue is
+  // empty, otherwise checks that the inputs have the shape of the elements.
+  void layoutSlabs(const std::vector<const TensorCPU*>& inputs, bool isBatch);
 
-  bool canWrite() const;
-  bool canRead() const;
+  // Blocks until the predicate holds or the queue is closed.
+  template <typename Predicate>
+  void wait(std::condition_variable& cv, Predicate predicate);
+  void notify(std::condition_variable& cv);
 
   const size_t capacity_;
   const size_t numBlobs_;
+  const bool singleProducerSingleConsumer_;
 
-  mutable std::mutex mutex_;
+  std::mutex producerMutex_;
+  std::mutex consumerMutex_;
 
-  bool isClosed_{false};
+  std::atomic<bool> isClosed_{false};
 
-  uint64_t head_{0};
-  uint64_t tail_{0};
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
 
+  // Only taken to block on a full or empty queue and to wake up the threads
+  // that are blocked, numBlocked_ lets the others skip it.
+  std::mutex mutex_;
+  std::atomic<int> numBlocked_{0};
   std::condition_variable cvEmpty_;
   std::condition_variable cvOverflow_;
 
-  std::vector<std::vector<TensorCPU>> queue_;
+  std::vector<TensorCPU> slabs_;
 };
 } // caffe2
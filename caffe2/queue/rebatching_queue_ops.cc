@@ -26,7 +26,11 @@ Creates the Queue.
     .Arg("num_blobs", "Number of input tensors the queue will support")
     .Arg(
         "capacity",
-        "Maximal number of elements the queue can hold at any given point");
+        "Maximal number of elements the queue can hold at any given point")
+    .Arg(
+        "single_producer_single_consumer",
+        "Promise that at most one enqueue and one dequeue run at a time, "
+        "which lets the queue skip locking. False by default.");
 
 OPERATOR_SCHEMA(CloseRebatchingQueue)
     .NumInputs(1)
@@ -1,13 +1,41 @@
 #include "miniz.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
+
+#include <ATen/Parallel.h>
 
 #include "caffe2/serialize/crc_alt.h"
 
+namespace {
+// The CRC of records spanning several chunks, mostly tensor data, is
+// computed chunk by chunk in parallel, and the chunk CRCs are then combined
+constexpr size_t kParallelCrcChunkSize = 4 * 1024 * 1024;
+} // namespace
+
 extern "C" {
 // See: miniz.h
 #if defined(USE_EXTERNAL_MZCRC) 
 mz_ulong mz_crc32(mz_ulong crc, const mz_uint8* ptr, size_t buf_len) {
-  auto z = crc32_fast(ptr, buf_len, crc);
+  if (buf_len < 2 * kParallelCrcChunkSize || at::in_parallel_region()) {
+    return crc32_fast(ptr, buf_len, crc);
+  }
+  const size_t num_chunks =
+      (buf_len + kParallelCrcChunkSize - 1) / kParallelCrcChunkSize;
+  std::vector<uint32_t> chunk_crcs(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const size_t offset = i * kParallelCrcChunkSize;
+      chunk_crcs[i] = crc32_fast(
+          ptr + offset, std::min(kParallelCrcChunkSize, buf_len - offset), 0);
+    }
+  });
+  uint32_t z = crc;
+  for (size_t i = 0; i < num_chunks; i++) {
+    const size_t offset = i * kParallelCrcChunkSize;
+    z = crc32_combine(
+        z, chunk_crcs[i], std::min(kParallelCrcChunkSize, buf_len - offset));
+  }
   return z;
 };
 #endif
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <algorithm>
 
+#include <ATen/Parallel.h>
 #include <c10/core/Allocator.h>
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/Backend.h>
@@ -227,10 +228,25 @@ size_t PyTorchStreamReader::getRecordID(const std::string& name) {
 
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  auto prefetched = prefetched_.find(name);
+  if (prefetched != prefetched_.end()) {
+    auto result = std::move(prefetched->second);
+    prefetched_.erase(prefetched);
+    return result;
+  }
   size_t key = getRecordID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  // records are stored uncompressed and aligned so that adapters mapping the
+  // file can return them in place
+  if (stat.m_method == MZ_NO_COMPRESSION) {
+    at::DataPtr mapped =
+        in_->getDataPtr(getRecordOffset(name), stat.m_uncomp_size);
+    if (mapped) {
+      return std::make_tuple(std::move(mapped), stat.m_uncomp_size);
+    }
+  }
   at::DataPtr retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
   valid("reading file ", name.c_str());
@@ -238,6 +254,71 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
+void PyTorchStreamReader::prefetchRecords(const std::vector<std::string>& names) {
+  struct CompressedRecord {
+    const std::string* name;
+    at::DataPtr compressed;
+    size_t compressed_size;
+    at::DataPtr data;
+    size_t size;
+  };
+  // Reading the compressed data goes through in_ and stays serial
+  std::vector<CompressedRecord> records;
+  for (const auto& name : names) {
+    if (prefetched_.count(name)) {
+      continue;
+    }
+    mz_zip_archive_file_stat stat;
+    mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+    valid("retrieving file meta-data for ", name.c_str());
+    if (stat.m_method != MZ_DEFLATED || stat.m_uncomp_size == 0) {
+      continue;
+    }
+    CompressedRecord record;
+    record.name = &name;
+    record.compressed_size = stat.m_comp_size;
+    record.size = stat.m_uncomp_size;
+    size_t offset = getRecordOffset(name);
+    record.compressed = in_->getDataPtr(offset, record.compressed_size);
+    if (!record.compressed) {
+      record.compressed =
+          c10::GetCPUAllocator()->allocate(record.compressed_size);
+      in_->read(
+          offset,
+          record.compressed.get(),
+          record.compressed_size,
+          "reading compressed record");
+    }
+    records.push_back(std::move(record));
+  }
+
+  std::vector<char> failed(records.size(), 0);
+  at::parallel_for(0, records.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      auto& record = records[i];
+      record.data = c10::GetCPUAllocator()->allocate(record.size);
+      // zip records are raw deflate streams, without zlib header
+      size_t size = tinfl_decompress_mem_to_mem(
+          record.data.get(),
+          record.size,
+          record.compressed.get(),
+          record.compressed_size,
+          0);
+      failed[i] = size != record.size;
+      record.compressed.clear();
+    }
+  });
+
+  for (size_t i = 0; i < records.size(); i++) {
+    if (failed[i]) {
+      CAFFE_THROW("PytorchStreamReader failed decompressing ", *records[i].name);
+    }
+    prefetched_.emplace(
+        *records[i].name,
+        std::make_tuple(std::move(records[i].data), records[i].size));
+  }
+}
+
 static int64_t read_le_16(uint8_t* buf) {
   return buf[0] + (buf[1] << 8);
 }
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <istream>
 #include <ostream>
+#include <unordered_map>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
@@ -160,6 +161,10 @@ class CAFFE2_API PyTorchStreamReader final {
 
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
+  // decompresses the compressed records among names in parallel, and keeps
+  // them until they are taken with getRecord. The other records are skipped,
+  // getRecord reads or maps them when asked.
+  void prefetchRecords(const std::vector<std::string>& names);
   size_t getRecordOffset(const std::string& name);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
@@ -182,6 +187,7 @@ class CAFFE2_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::unique_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  std::unordered_map<std::string, std::tuple<at::DataPtr, size_t>> prefetched_;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
@@ -0,0 +1,68 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+
+namespace caffe2 {
+namespace serialize {
+
+namespace {
+
+void deleteMappingRef(void* ctx) {
+  delete static_cast<std::shared_ptr<at::DataPtr>*>(ctx);
+}
+
+} // namespace
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name) {
+  std::ifstream file(file_name, std::ifstream::binary | std::ifstream::ate);
+  if (!file) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  size_ = file.tellg();
+  file.close();
+  TORCH_CHECK(size_ > 0, "cannot map empty file: ", file_name);
+
+  // flags = 0 maps the file read-only and private, i.e. copy-on-write
+  size_t actual_size = 0;
+  mapping_ = std::make_shared<at::DataPtr>(THMapAllocator::makeDataPtr(
+      file_name.c_str(), /*flags=*/0, size_, &actual_size));
+  TORCH_CHECK(
+      mapping_->get() != nullptr && actual_size == size_,
+      "mapping file failed, file path: ",
+      file_name);
+}
+
+size_t MmapFileAdapter::size() const {
+  return size_;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  TORCH_CHECK(
+      pos <= size_ && n <= size_ - pos,
+      "mmap reader failed: ",
+      what,
+      ", reading past the end of the file.");
+  std::memcpy(buf, static_cast<const char*>(mapping_->get()) + pos, n);
+  return n;
+}
+
+at::DataPtr MmapFileAdapter::getDataPtr(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos <= size_ && n <= size_ - pos,
+      "mmap reader failed: record past the end of the file.");
+  return at::DataPtr(
+      static_cast<char*>(mapping_->get()) + pos,
+      new std::shared_ptr<at::DataPtr>(mapping_),
+      &deleteMappingRef,
+      at::kCPU);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
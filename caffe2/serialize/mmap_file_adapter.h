@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/core/Allocator.h"
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Maps the whole file copy-on-write instead of reading it. Uncompressed
+// records are returned by PyTorchStreamReader::getRecord as DataPtrs into the
+// mapping, so they are only paged in when used and share the page cache with
+// the other processes mapping the file. Writes to them stay private to the
+// process. The mapping lives until the adapter and all the DataPtrs into it
+// are gone, and the file must not be truncated in the meantime.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr getDataPtr(uint64_t pos, size_t n) const override;
+  ~MmapFileAdapter();
+
+ private:
+  std::shared_ptr<at::DataPtr> mapping_;
+  size_t size_;
+};
+
+} // namespace serialize
+} // namespace caffe2
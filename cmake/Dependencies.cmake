@@ -1112,6 +1112,7 @@ if(USE_CUDA)
   set(CAFFE2_USE_CUDNN ${USE_CUDNN})
   set(CAFFE2_USE_NVRTC ${USE_NVRTC})
   set(CAFFE2_USE_TENSORRT ${USE_TENSORRT})
+  set(CAFFE2_USE_CUPTI ${USE_CUPTI})
   include(${CMAKE_CURRENT_LIST_DIR}/public/cuda.cmake)
   if(CAFFE2_USE_CUDA)
     # A helper variable recording the list of Caffe2 dependent libraries
@@ -1134,6 +1135,10 @@ if(USE_CUDA)
     else()
       caffe2_update_option(USE_TENSORRT OFF)
     endif()
+    # Only torch_cuda links it, see caffe2/CMakeLists.txt
+    if(NOT CAFFE2_USE_CUPTI)
+      caffe2_update_option(USE_CUPTI OFF)
+    endif()
   else()
     message(WARNING
       "Not compiling with CUDA. Suppress this warning with "
@@ -1142,10 +1147,12 @@ if(USE_CUDA)
     caffe2_update_option(USE_CUDNN OFF)
     caffe2_update_option(USE_NVRTC OFF)
     caffe2_update_option(USE_TENSORRT OFF)
+    caffe2_update_option(USE_CUPTI OFF)
     set(CAFFE2_USE_CUDA OFF)
     set(CAFFE2_USE_CUDNN OFF)
     set(CAFFE2_USE_NVRTC OFF)
     set(CAFFE2_USE_TENSORRT OFF)
+    set(CAFFE2_USE_CUPTI OFF)
   endif()
 endif()
 
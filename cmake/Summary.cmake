@@ -50,10 +50,12 @@ function(caffe2_print_configuration_summary)
 
   message(STATUS "  CODE_COVERAGE         : ${CODE_COVERAGE}")
   message(STATUS "  USE_ASAN              : ${USE_ASAN}")
+  message(STATUS "  DISABLE_PER_OP_PROFILING : ${DISABLE_PER_OP_PROFILING}")
   message(STATUS "  USE_CUDA              : ${USE_CUDA}")
   if(${USE_CUDA})
     message(STATUS "    CUDA static link    : ${CAFFE2_STATIC_LINK_CUDA}")
     message(STATUS "    USE_CUDNN           : ${USE_CUDNN}")
+    message(STATUS "    USE_CUPTI           : ${USE_CUPTI}")
     message(STATUS "    CUDA version        : ${CUDA_VERSION}")
     if(${USE_CUDNN})
       message(STATUS "    cuDNN version       : ${CUDNN_VERSION}")
@@ -253,6 +253,35 @@ else()
       ${LIBNVTOOLSEXT})
 endif()
 
+# cupti
+if(CAFFE2_USE_CUPTI)
+  find_library(LIBCUPTI cupti
+      PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/lib64
+            ${CUDA_TOOLKIT_ROOT_DIR}/lib64
+      NO_DEFAULT_PATH)
+  find_path(CUPTI_INCLUDE_DIR cupti.h
+      PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include
+            ${CUDA_TOOLKIT_ROOT_DIR}/include
+      NO_DEFAULT_PATH)
+  if(CUDA_VERSION VERSION_LESS 10.0)
+    message(WARNING
+      "Caffe2: CUPTI external correlation needs CUDA 10.0. Turning the option off")
+    set(CAFFE2_USE_CUPTI OFF)
+  elseif(NOT LIBCUPTI OR NOT CUPTI_INCLUDE_DIR)
+    message(WARNING
+      "Caffe2: Cannot find CUPTI library. Turning the option off")
+    set(CAFFE2_USE_CUPTI OFF)
+  else()
+    add_library(torch::cupti INTERFACE IMPORTED)
+    set_property(
+        TARGET torch::cupti PROPERTY INTERFACE_LINK_LIBRARIES
+        ${LIBCUPTI})
+    set_property(
+        TARGET torch::cupti PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+        ${CUPTI_INCLUDE_DIR})
+  endif()
+endif()
+
 # cudnn
 # static linking is handled by USE_STATIC_CUDNN environment variable
 if(CAFFE2_USE_CUDNN)
@@ -343,6 +372,19 @@ else()
     set_property(
         TARGET caffe2::cublas PROPERTY INTERFACE_LINK_LIBRARIES
         ${CUDA_CUBLAS_LIBRARIES})
+    # at::cuda::blas::gemm_and_bias uses cuBLASLt, which FindCUDA doesn't add
+    if(CUDA_VERSION VERSION_GREATER_EQUAL 11.0)
+      find_library(CUDA_cublasLt_LIBRARY cublasLt
+          PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+          PATH_SUFFIXES lib64 lib/x64 lib
+          NO_DEFAULT_PATH)
+      if(NOT CUDA_cublasLt_LIBRARY)
+        message(FATAL_ERROR "Cannot find cuBLASLt in ${CUDA_TOOLKIT_ROOT_DIR}")
+      endif()
+      set_property(
+          TARGET caffe2::cublas APPEND PROPERTY INTERFACE_LINK_LIBRARIES
+          ${CUDA_cublasLt_LIBRARY})
+    endif()
 endif()
 set_property(
     TARGET caffe2::cublas PROPERTY INTERFACE_INCLUDE_DIRECTORIES
@@ -30,6 +30,9 @@
 #   USE_CUDNN=0
 #     disables the cuDNN build
 #
+#   USE_CUPTI=1
+#     records the GPU timeline of the autograd profiler with CUPTI
+#
 #   USE_FBGEMM=0
 #     disables the FBGEMM build
 #
@@ -790,6 +793,7 @@ if __name__ == '__main__':
                 'include/ATen/*.h',
                 'include/ATen/cpu/*.h',
                 'include/ATen/cpu/vec256/*.h',
+                'include/ATen/cpu/vec256/vec512/*.h',
                 'include/ATen/core/*.h',
                 'include/ATen/cuda/*.cuh',
                 'include/ATen/cuda/*.h',
@@ -639,6 +639,69 @@ TEST(DataTest, MapDoesNotCopy) {
   ASSERT_EQ(data[0].item<float>(), 7);
 }
 
+struct RowDataset : datasets::BatchBufferDataset<RowDataset> {
+  void get_into(size_t index, torch::Tensor data, torch::Tensor target)
+      override {
+    data.fill_(static_cast<float>(index));
+    target.fill_(static_cast<int64_t>(index));
+  }
+  Example<> allocate_batch(size_t batch_size) override {
+    ++allocations;
+    const int64_t size = batch_size;
+    return {torch::empty({size, 2, 3}), torch::empty({size}, torch::kLong)};
+  }
+  torch::optional<size_t> size() const override {
+    return 8;
+  }
+  size_t allocations = 0;
+};
+
+TEST(DataTest, BatchBufferDatasetWritesExamplesIntoTheirRows) {
+  RowDataset dataset;
+  auto batch = dataset.get_batch({3, 5});
+  ASSERT_EQ(batch.data.sizes(), std::vector<int64_t>({2, 2, 3}));
+  ASSERT_TRUE(batch.data[0].eq(3).all().item<bool>());
+  ASSERT_TRUE(batch.data[1].eq(5).all().item<bool>());
+  ASSERT_EQ(batch.target[0].item<int64_t>(), 3);
+  ASSERT_EQ(batch.target[1].item<int64_t>(), 5);
+}
+
+TEST(DataTest, BatchBufferDatasetReusesReleasedBatches) {
+  RowDataset dataset;
+  auto first = dataset.get_batch({0, 1});
+  const void* first_data = first.data.data_ptr();
+  auto view = first.data[0];
+  first = {};
+  // Still in use through the view.
+  auto second = dataset.get_batch({2, 3});
+  ASSERT_NE(second.data.data_ptr(), first_data);
+  ASSERT_EQ(dataset.allocations, 2);
+
+  view = torch::Tensor();
+  auto third = dataset.get_batch({4, 5});
+  ASSERT_EQ(third.data.data_ptr(), first_data);
+  ASSERT_TRUE(third.data[0].eq(4).all().item<bool>());
+  ASSERT_EQ(dataset.allocations, 2);
+
+  // Batches of another size are allocated separately.
+  auto last = dataset.get_batch({6});
+  ASSERT_EQ(last.data.size(0), 1);
+  ASSERT_EQ(dataset.allocations, 3);
+}
+
+TEST(DataLoaderTest, LoadsBatchBufferDataset) {
+  auto data_loader = torch::data::make_data_loader(
+      RowDataset(),
+      samplers::SequentialSampler(8),
+      DataLoaderOptions().batch_size(4).workers(2));
+  int64_t expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.target.equal(torch::arange(expected, expected + 4)));
+    expected += 4;
+  }
+  ASSERT_EQ(expected, 8);
+}
+
 TEST(DataTest, QueuePushAndPopFromSameThread) {
   torch::data::detail::Queue<int> queue;
   queue.push(1);
@@ -647,6 +710,14 @@ TEST(DataTest, QueuePushAndPopFromSameThread) {
   ASSERT_EQ(queue.pop(), 2);
 }
 
+TEST(DataTest, QueuePopsMoveOnlyValues) {
+  torch::data::detail::Queue<std::unique_ptr<int>> queue;
+  queue.push(torch::make_unique<int>(1));
+  queue.push(torch::make_unique<int>(2));
+  ASSERT_EQ(*queue.pop(), 1);
+  ASSERT_EQ(*queue.pop(), 2);
+}
+
 TEST(DataTest, QueuePopWithTimeoutThrowsUponTimeout) {
   torch::data::detail::Queue<int> queue;
   ASSERT_THROWS_WITH(
@@ -1030,6 +1101,8 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.pin_memory);
+  ASSERT_FALSE(full_options.prefetch_to_device.has_value());
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1429,6 +1502,46 @@ TEST(DataLoaderTest, Reset) {
   ASSERT_EQ(++iterator, end);
 }
 
+TEST(DataLoaderTest, PrefetchesToCPU) {
+  auto data_loader = torch::data::make_data_loader(
+      datasets::TensorDataset(torch::arange(8).view({8, 1}))
+          .map(transforms::Stack<TensorExample>()),
+      torch::data::samplers::SequentialSampler(8),
+      DataLoaderOptions().batch_size(2).workers(2).prefetch_to_device(
+          torch::kCPU));
+  int64_t expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.device().is_cpu());
+    ASSERT_TRUE(batch.data.view(-1).equal(
+        torch::arange(expected, expected + 2)));
+    expected += 2;
+  }
+  ASSERT_EQ(expected, 8);
+}
+
+TEST(DataLoaderTest, PrefetchesToDevice_CUDA) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        datasets::TensorDataset(torch::arange(64).view({64, 1}))
+            .map(transforms::Stack<TensorExample>()),
+        torch::data::samplers::SequentialSampler(64),
+        DataLoaderOptions()
+            .batch_size(4)
+            .workers(workers)
+            .pin_memory(true)
+            .prefetch_to_device(torch::kCUDA));
+    int64_t expected = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.device().is_cuda());
+      // Runs on the current stream, which waits for the copy.
+      auto values = batch.data.view(-1).cpu();
+      ASSERT_TRUE(values.equal(torch::arange(expected, expected + 4)));
+      expected += 4;
+    }
+    ASSERT_EQ(expected, 64);
+  }
+}
+
 TEST(DataLoaderTest, TestExceptionsArePropagatedFromWorkers) {
   struct D : datasets::Dataset<DummyDataset, int> {
     int get(size_t index) override {
@@ -1896,6 +2009,73 @@ TEST(DataLoaderTest, ChunkDatasetDoesNotHang) {
   auto iterator = data_loader->begin();
 }
 
+// chunk data reader with chunks of 1KB tensors, filled with the index of the
+// example.
+struct TensorChunkDataReader
+    : public datasets::ChunkDataReader<torch::Tensor> {
+ public:
+  using BatchType = datasets::ChunkDataReader<torch::Tensor>::ChunkType;
+  using DataType = datasets::ChunkDataReader<torch::Tensor>::ExampleType;
+
+  BatchType read_chunk(size_t chunk_index) override {
+    BatchType batch_data;
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      batch_data.push_back(
+          torch::full({256}, static_cast<float>(chunk_index * kChunkSize + i)));
+    }
+    return batch_data;
+  }
+
+  size_t chunk_count() override {
+    return kChunkCount;
+  };
+
+  void reset() override{};
+
+  static constexpr size_t kChunkCount = 6;
+  static constexpr size_t kChunkSize = 7;
+};
+
+TEST(DataLoaderTest, ChunkDatasetWithCacheBytes) {
+  const size_t prefetch_count = 2;
+  const size_t batch_size = 5;
+
+  for (size_t cross_chunk_shuffle_count : {1, 2}) {
+    TensorChunkDataReader data_reader;
+    samplers::SequentialSampler sampler(0);
+    // Less than a batch, the buffer still has to let a chunk in.
+    auto options = datasets::ChunkDatasetOptions(
+                       prefetch_count, batch_size, 2048,
+                       cross_chunk_shuffle_count)
+                       .cache_bytes(4 * 1024);
+    datasets::SharedBatchDataset<datasets::ChunkDataset<
+        TensorChunkDataReader,
+        samplers::SequentialSampler,
+        samplers::SequentialSampler>>
+        dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+            TensorChunkDataReader,
+            samplers::SequentialSampler,
+            samplers::SequentialSampler>>(
+            data_reader, sampler, sampler, options);
+
+    auto data_loader = torch::data::make_data_loader(
+        dataset, DataLoaderOptions(batch_size).workers(0));
+
+    std::vector<float> values;
+    for (auto& batch : *data_loader) {
+      for (auto& example : batch) {
+        ASSERT_EQ(example.numel(), 256);
+        values.push_back(example[0].item<float>());
+      }
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<float> expected(
+        TensorChunkDataReader::kChunkCount * TensorChunkDataReader::kChunkSize);
+    std::iota(expected.begin(), expected.end(), 0.0f);
+    ASSERT_EQ(values, expected);
+  }
+}
+
 // Test ChunkDataset save function.
 // Note [save/load ChunkDataset as ChunkSampler]:
 // The chunk sampler inside ChunkDataset is used in a separate thread pool other
@@ -3524,6 +3524,33 @@ TEST_F(ModulesTest, MultiheadAttention) {
   );
 }
 
+TEST_F(ModulesTest, MultiheadAttentionFusedSelfAttention) {
+  // Self-attention on the same tensor takes the fused path, on equal tensors
+  // the general one
+  const int64_t tgt_len = 5, bsz = 3, d_model = 12, nheads = 4;
+  MultiheadAttention multihead_attn(MultiheadAttentionOptions(d_model, nheads));
+  const auto attn_mask = torch::randn({tgt_len, tgt_len});
+  auto key_padding_mask = torch::zeros({bsz, tgt_len}, torch::kBool);
+  key_padding_mask[0][tgt_len - 1] = true;
+  key_padding_mask[2][0] = true;
+
+  for (const bool with_masks : {false, true}) {
+    const auto x = torch::randn({tgt_len, bsz, d_model}, torch::requires_grad());
+    const auto y = x.detach().clone().requires_grad_();
+    const auto mask = with_masks ? attn_mask : torch::Tensor();
+    const auto padding_mask = with_masks ? key_padding_mask : torch::Tensor();
+    torch::Tensor fused_output, fused_weights, output, weights;
+    std::tie(fused_output, fused_weights) = multihead_attn(x, x, x, padding_mask, /*need_weights=*/true, mask);
+    std::tie(output, weights) = multihead_attn(y, y.clone(), y.clone(), padding_mask, /*need_weights=*/true, mask);
+    ASSERT_TRUE(torch::allclose(fused_output, output, 1e-5, 1e-6));
+    ASSERT_TRUE(torch::allclose(fused_weights, weights, 1e-5, 1e-6));
+
+    fused_output.sum().backward();
+    output.sum().backward();
+    ASSERT_TRUE(torch::allclose(x.grad(), y.grad(), 1e-5, 1e-6));
+  }
+}
+
 TEST_F(ModulesTest, PrettyPrintIdentity) {
   ASSERT_EQ(c10::str(Identity()), "torch::nn::Identity()");
 }
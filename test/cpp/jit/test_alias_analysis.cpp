@@ -1185,6 +1185,29 @@ void testMemoryDAG() {
       AT_ASSERT(!dag->mayContainAlias(e, elem));
     }
   }
+  {
+    // b(c), c(b(e)), d(c): the contained memory locations are cached, which
+    // must not lose anything on the cycle, whichever element is queried first
+    for (int first = 0; first < 3; first++) {
+      auto t = std::make_unique<MemoryDAGBuilder>();
+      auto b = t->makeFreshValue(bValue);
+      auto c = t->makeFreshValue(cValue);
+      auto d = t->makeFreshValue(dValue);
+      auto e = t->makeFreshValue(eValue);
+      t->addToContainedElements(c, b);
+      t->addToContainedElements(b, c);
+      t->addToContainedElements(e, b);
+      t->addToContainedElements(c, d);
+
+      auto dag = std::make_unique<MemoryDAG>(std::move(t));
+      std::vector<Element*> order = {b, c, d};
+      std::rotate(order.begin(), order.begin() + first, order.end());
+      for (auto elem : order) {
+        AT_ASSERT(dag->mayContainAlias(elem, e));
+        AT_ASSERT(dag->getAllContainedMemoryLocations(elem).test(e->index));
+      }
+    }
+  }
 }
 
 void testAliasRegistration() {
@@ -11,6 +11,7 @@
 #include <torch/csrc/jit/codegen/cuda/ir_graphviz.h>
 #include <torch/csrc/jit/codegen/cuda/ir_iostream.h>
 #include <torch/csrc/jit/codegen/cuda/ir_utils.h>
+#include <torch/csrc/jit/codegen/cuda/kernel_cache.h>
 #include <torch/csrc/jit/codegen/cuda/lower2device.h>
 #include <torch/csrc/jit/codegen/cuda/mutator.h>
 #include <torch/csrc/jit/codegen/cuda/scheduler.h>
@@ -26,6 +27,11 @@
 
 #include <iostream>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 // Tests go in torch::jit
 namespace torch {
 namespace jit {
@@ -5991,6 +5997,251 @@ void testGPU_FusionThreadPredicate() {
   TORCH_CHECK(aten_output_tv3.allclose(cg_output_tv3));
 }
 
+void testGPU_FusionKernelCache() {
+#ifndef _WIN32
+  char cache_dir[] = "/tmp/nvfuser_kernel_cacheXXXXXX";
+  TORCH_CHECK(mkdtemp(cache_dir));
+  setenv("PYTORCH_CUDA_FUSER_KERNEL_CACHE", cache_dir, 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::rand({128, 64}, options);
+  auto countEntries = [&]() {
+    int entries = 0;
+    DIR* dir = opendir(cache_dir);
+    while (dirent* entry = readdir(dir)) {
+      entries += std::string(entry->d_name).find(".ptx") != std::string::npos;
+    }
+    closedir(dir);
+    return entries;
+  };
+
+  // The second executor loads the kernel the first one stored
+  for (int i = 0; i < 2; i++) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeDummyTensor(2);
+    TensorView* tv1 = mul(tv0, new Float(3.0));
+    fusion.addInput(tv0);
+    fusion.addOutput(tv1);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+    torch::jit::fuser::cuda::FusionExecutor fe;
+    fe.compileFusion(&fusion);
+    auto outputs = fe.runFusion({input});
+    TORCH_CHECK(outputs[0].allclose(input * 3.0));
+    TORCH_CHECK(countEntries() == 1);
+  }
+
+  unsetenv("PYTORCH_CUDA_FUSER_KERNEL_CACHE");
+  DIR* dir = opendir(cache_dir);
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      std::remove((std::string(cache_dir) + "/" + entry->d_name).c_str());
+    }
+  }
+  closedir(dir);
+  rmdir(cache_dir);
+#endif
+}
+
+void testGPU_FusionNormalizationSoftmax() {
+  constexpr int dimx = 8;
+  constexpr int dimy = 16;
+  constexpr int dimz = 1000;
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeDummyTensor(3);
+  fusion.addInput(tv0);
+
+  TensorView* tv1 = reductionOp(BinaryOpType::Max, {-1}, new Float(0), tv0);
+  TensorView* tv2 = broadcast(tv1, {false, false, true});
+  TensorView* tv3 = unaryOp(UnaryOpType::Exp, sub(tv0, tv2));
+  TensorView* tv4 = sum(tv3, {-1});
+  TensorView* tv5 = broadcast(tv4, {false, false, true});
+  TensorView* tv6 = div(tv3, tv5);
+  fusion.addOutput(tv6);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::randn({dimx, dimy, dimz}, options);
+
+  auto rparams = cuda::scheduleNormalization(&fusion, {input});
+  TORCH_CHECK(rparams, "Normalization schedule was not generated!");
+  TORCH_CHECK(rparams->persistent);
+
+  cuda::FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  auto outputs = fe.runFusion({input});
+
+  auto aten_output = at::_softmax(input, -1, false);
+  TORCH_CHECK(
+      aten_output.allclose(outputs[0], 1e-5, 1e-5),
+      "Error of: ",
+      aten_output.sub(outputs[0]).abs().max());
+}
+
+void testGPU_FusionNormalizationLayerNorm() {
+  constexpr int rows = 64;
+  constexpr int hidden = 768;
+  constexpr float eps = 1e-5;
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeDummyTensor(2);
+  TensorView* weight = makeDummyTensor(1);
+  TensorView* bias = makeDummyTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(weight);
+  fusion.addInput(bias);
+
+  // Stats
+  TensorView* mean = div(sum(tv0, {1}), new Float(hidden));
+  TensorView* centered = sub(tv0, broadcast(mean, {false, true}));
+  TensorView* var =
+      div(sum(mul(centered, centered), {1}), new Float(hidden));
+  TensorView* rstd = unaryOp(UnaryOpType::Rsqrt, add(var, new Float(eps)));
+  // Normalize and affine
+  TensorView* normalized = mul(centered, broadcast(rstd, {false, true}));
+  TensorView* output = add(
+      mul(normalized, broadcast(weight, {true, false})),
+      broadcast(bias, {true, false}));
+  fusion.addOutput(output);
+  fusion.addOutput(mean);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::randn({rows, hidden}, options);
+  at::Tensor input_weight = at::randn({hidden}, options);
+  at::Tensor input_bias = at::randn({hidden}, options);
+
+  auto rparams = cuda::scheduleNormalization(
+      &fusion, {input, input_weight, input_bias});
+  TORCH_CHECK(rparams, "Normalization schedule was not generated!");
+
+  cuda::FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  auto outputs = fe.runFusion({input, input_weight, input_bias});
+
+  auto aten_output =
+      at::layer_norm(input, {hidden}, input_weight, input_bias, eps);
+  TORCH_CHECK(
+      aten_output.allclose(outputs[0], 1e-4, 1e-4),
+      "Error of: ",
+      aten_output.sub(outputs[0]).abs().max());
+  TORCH_CHECK(input.mean({1}).allclose(outputs[1], 1e-5, 1e-5));
+}
+
+void testGPU_FusionExecutorCacheReuse() {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  // A point-wise kernel is compiled once for all sizes
+  {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    TensorView* tv0 = makeDummyTensor(2);
+    TensorView* tv1 = add(tv0, new Float(1.0));
+    fusion->addInput(tv0);
+    fusion->addOutput(tv1);
+
+    cuda::FusionExecutorCache fec(std::move(fusion), at::Device(at::kCUDA, 0));
+    for (int rows : {16, 37, 128}) {
+      at::Tensor input = at::randn({rows, 65}, options);
+      auto outputs = fec.runFusionWithInputs({input});
+      TORCH_CHECK(outputs[0].allclose(input + 1.0));
+    }
+    TORCH_CHECK(fec.stats().misses == 1 && fec.stats().hits == 2);
+  }
+
+  // A reduction kernel is reused for input sizes seen before
+  {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    TensorView* tv0 = makeDummyTensor(2);
+    TensorView* tv1 = sum(tv0, {1});
+    fusion->addInput(tv0);
+    fusion->addOutput(tv1);
+
+    cuda::FusionExecutorCache fec(std::move(fusion), at::Device(at::kCUDA, 0));
+    at::Tensor input = at::randn({128, 1024}, options);
+    for (int i = 0; i < 2; i++) {
+      auto outputs = fec.runFusionWithInputs({input});
+      TORCH_CHECK(outputs[0].allclose(input.sum({1}), 1e-4, 1e-4));
+    }
+    TORCH_CHECK(fec.stats().misses == 1 && fec.stats().hits == 1);
+  }
+}
+
+void testGPU_FusionPermute() {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeDummyTensor(3);
+  fusion.addInput(tv0);
+
+  TensorView* tv1 = permute(tv0, {2, 0, 1});
+  TensorView* tv2 = add(tv1, new Float(1.0));
+  TensorView* tv3 = transpose(tv2, 0, 2);
+  fusion.addOutput(tv3);
+
+  TORCH_CHECK(tv1->nDims() == 3 && tv3->nDims() == 3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({5, 7, 9}, options);
+
+  fuser::cuda::scheduleFusion(&fusion, {t0});
+
+  torch::jit::fuser::cuda::FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  auto outputs = fe.runFusion({t0});
+
+  auto t3 = t0.permute({2, 0, 1}).add(1.0).transpose(0, 2);
+  TORCH_CHECK(outputs[0].sizes() == t3.sizes());
+  TORCH_CHECK(t3.allclose(outputs[0]));
+}
+
+void testGPU_FusionViewSplitMerge() {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  int batch = 4, seq = 16, heads = 8, head_size = 32;
+
+  // [batch, seq, hidden] -> [batch, seq, heads, head_size] ->
+  // [batch, heads, seq, head_size] -> [batch * heads, seq, head_size]
+  TensorView* tv0 = makeDummyTensor(3);
+  fusion.addInput(tv0);
+
+  TensorView* tv1 = view(
+      tv0, {batch, seq, heads * head_size}, {batch, seq, heads, head_size});
+  TensorView* tv2 = permute(tv1, {0, 2, 1, 3});
+  TensorView* tv3 = mul(tv2, new Float(0.5));
+  TensorView* tv4 =
+      view(tv3, {batch, heads, seq, head_size}, {-1, seq, head_size});
+  fusion.addOutput(tv4);
+
+  TORCH_CHECK(tv1->nDims() == 4 && tv4->nDims() == 3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({batch, seq, heads * head_size}, options);
+
+  fuser::cuda::scheduleFusion(&fusion, {t0});
+
+  torch::jit::fuser::cuda::FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  auto outputs = fe.runFusion({t0});
+
+  auto t4 = t0.view({batch, seq, heads, head_size})
+                .permute({0, 2, 1, 3})
+                .mul(0.5)
+                .reshape({-1, seq, head_size});
+  TORCH_CHECK(outputs[0].sizes() == t4.sizes());
+  TORCH_CHECK(t4.allclose(outputs[0]));
+}
+
 } // namespace jit
 } // namespace torch
 
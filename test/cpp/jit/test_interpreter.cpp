@@ -1,5 +1,6 @@
 #include "test/cpp/jit/test_base.h"
 #include "test/cpp/jit/test_utils.h"
+#include "torch/csrc/jit/runtime/instruction.h"
 
 #include <stdexcept>
 namespace torch {
@@ -103,6 +104,54 @@ graph(%a.1 : Tensor,
   } catch (const std::exception& e) {
   }
 }
+void testInterpreterSuperinstructions() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%n : int, %xs : int[]):
+  %zero : int = prim::Constant[value=0]()
+  %minus_one : int = prim::Constant[value=-1]()
+  %true : bool = prim::Constant[value=1]()
+  %acc : int = prim::Loop(%n, %true, %zero)
+    block0(%i : int, %acc.1 : int):
+      %x : int = aten::__getitem__(%xs, %i)
+      %y : int = aten::mul(%x, %x)
+      %acc.2 : int = aten::add(%acc.1, %y)
+      -> (%true, %acc.2)
+  %last : int = aten::__getitem__(%xs, %minus_one)
+  %lt : bool = aten::lt(%acc, %last)
+  %sum : int = aten::add(%acc, %acc)
+  return (%acc, %last, %lt, %sum)
+  )IR",
+      &*graph);
+
+  Code function(graph, "");
+  // superinstructions are only patched into the code that runs
+  for (const Instruction& inst : function.instructions()) {
+    ASSERT_TRUE(inst.op != OP_STORE && inst.op != FUSED_BINOP);
+  }
+  InterpreterState interp(function);
+  {
+    std::vector<IValue> stack({3, c10::List<int64_t>({1, 2, 3})});
+    interp.run(stack);
+    ASSERT_EQ(stack.size(), 4u);
+    ASSERT_EQ(stack[0].toInt(), 14);
+    ASSERT_EQ(stack[1].toInt(), 3);
+    ASSERT_FALSE(stack[2].toBool());
+    ASSERT_EQ(stack[3].toInt(), 28);
+  }
+  {
+    bool threw = false;
+    std::vector<IValue> stack({4, c10::List<int64_t>({1, 2, 3})});
+    try {
+      interp.run(stack);
+    } catch (const std::exception& e) {
+      threw = true;
+    }
+    ASSERT_TRUE(threw);
+  }
+}
+
 void testInterp() {
   constexpr int batch_size = 4;
   constexpr int input_size = 256;
@@ -1,9 +1,11 @@
 #include <c10/core/TensorOptions.h>
+#include <caffe2/serialize/inline_container.h>
 #include <test/cpp/jit/test_base.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
 #include <torch/torch.h>
@@ -159,6 +161,127 @@ void testLiteInterpreterDict() {
   AT_ASSERT(output.toGenericDict().at("result").toTensor().item().toInt() == 2);
 }
 
+void testLiteInterpreterFlatBytecode() {
+  Module m("m");
+  m.register_parameter("foo", torch::ones({2}), false);
+  m.define(R"JIT(
+  def add_it(self, x, y: List[int]):
+      b = 4
+      return self.foo + x + b + len(y)
+
+  def forward(self, x):
+      return {"result": self.add_it(x, [1, 2])}
+  )JIT");
+  auto input = torch::ones({2});
+  auto ref = m.forward({input}).toGenericDict().at("result").toTensor();
+
+  std::stringstream ss;
+  m._save_for_mobile(ss, {}, true, true);
+  {
+    caffe2::serialize::PyTorchStreamReader reader(&ss);
+    ASSERT_TRUE(reader.hasRecord("bytecode.ff"));
+    ASSERT_TRUE(reader.hasRecord("bytecode_constants.pkl"));
+    ASSERT_FALSE(reader.hasRecord("bytecode.pkl"));
+  }
+  ss.seekg(0);
+  mobile::Module bc = _load_for_mobile(ss);
+  auto res = bc.forward({input}).toGenericDict().at("result").toTensor();
+  AT_ASSERT(res.equal(ref));
+
+  // the debug info is still pickled, and matched with the flat functions
+  bool has_module_info = false;
+  for (size_t pc = 0; !has_module_info; ++pc) {
+    std::string module_info;
+    try {
+      module_info = bc.get_forward_method_debug_info(pc);
+    } catch (const std::exception& e) {
+      break;
+    }
+    has_module_info = module_info != "<no module info>";
+  }
+  AT_ASSERT(has_module_info);
+}
+
+void testLiteInterpreterMemoryPlanning() {
+  Module m("m");
+  m.register_parameter("weight", torch::rand({8, 8}), false);
+  m.define(R"JIT(
+  def forward(self, x):
+      y = torch.relu(torch.mm(x, self.weight))
+      z = torch.sigmoid(torch.mm(y, self.weight))
+      return z + y
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  bc.set_memory_planning();
+
+  std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> refs;
+  for (int i = 0; i < 4; ++i) {
+    // the input shape changes once, which is planned again
+    auto input = torch::rand({i < 2 ? 4 : 16, 8});
+    refs.push_back(m.forward({input}).toTensor());
+    outputs.push_back(bc.forward({input}).toTensor());
+  }
+  // outputs are not planned, earlier ones are not overwritten by later runs
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    AT_ASSERT(outputs[i].allclose(refs[i]));
+  }
+}
+
+namespace {
+struct RecordingOperatorObserver : public MobileOperatorObserver {
+  void onOperatorSample(const MobileOperatorSample& sample) override {
+    samples.push_back(sample);
+  }
+  std::vector<MobileOperatorSample> samples;
+};
+} // namespace
+
+void testLiteInterpreterOperatorObserver() {
+  Module m("m");
+  m.register_parameter("weight", torch::rand({8, 8}), false);
+  m.define(R"JIT(
+  def forward(self, x):
+      return torch.relu(torch.mm(x, self.weight))
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+
+  auto observer = new RecordingOperatorObserver();
+  observerConfig().setOperatorObserver(
+      std::unique_ptr<MobileOperatorObserver>(observer), 1);
+  auto input = torch::rand({4, 8});
+  auto output = bc.forward({input}).toTensor();
+  AT_ASSERT(output.allclose(m.forward({input}).toTensor()));
+
+  bool has_mm = false;
+  for (const auto& sample : observer->samples) {
+    AT_ASSERT(sample.op_name != nullptr);
+    AT_ASSERT(sample.latency_ns >= 0);
+    if (sample.op_name->name == "aten::mm") {
+      has_mm = true;
+      // the output of mm
+      AT_ASSERT(sample.allocations >= 1);
+      AT_ASSERT(sample.allocated_bytes >= 4 * 8 * sizeof(float));
+    }
+  }
+  AT_ASSERT(has_mm);
+  const size_t num_ops = observer->samples.size();
+
+  // every other operator is sampled
+  observer = new RecordingOperatorObserver();
+  observerConfig().setOperatorObserver(
+      std::unique_ptr<MobileOperatorObserver>(observer), 2);
+  for (int i = 0; i < 4; ++i) {
+    bc.forward({input});
+  }
+  AT_ASSERT(observer->samples.size() == 2 * num_ops);
+  observerConfig().setOperatorObserver(nullptr);
+}
+
 void testLiteInterpreterPrimOverload() {
   /*
   // temporarily disabled
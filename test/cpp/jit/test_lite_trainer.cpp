@@ -238,6 +238,41 @@ void testLiteSGD() {
   AT_ASSERT(parameters[0].item<float>() == bc_parameters[0].item<float>());
 }
 
+void testLiteSGDFused() {
+  auto options = ::torch::optim::SGDOptions(0.1)
+                     .momentum(0.9)
+                     .weight_decay(0.01)
+                     .nesterov(true);
+  auto mobile_options = ::torch::jit::mobile::SGDOptions(0.1)
+                            .momentum(0.9)
+                            .weight_decay(0.01)
+                            .nesterov(true);
+  // large enough to take the vectorized and parallel paths, and a
+  // non-contiguous one that takes the regular one
+  std::vector<Tensor> parameters{
+      torch::rand({100003}, at::requires_grad()),
+      torch::rand({10, 10}).t().requires_grad_()};
+  std::vector<Tensor> mobile_parameters;
+  for (const auto& p : parameters) {
+    mobile_parameters.push_back(p.detach().clone().requires_grad_());
+  }
+  ::torch::optim::SGD optimizer(parameters, options);
+  ::torch::jit::mobile::SGD mobile_optimizer(mobile_parameters, mobile_options);
+  for (int step = 0; step < 3; ++step) {
+    optimizer.zero_grad();
+    mobile_optimizer.zero_grad();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      (parameters[i] * parameters[i]).sum().backward();
+      (mobile_parameters[i] * mobile_parameters[i]).sum().backward();
+    }
+    optimizer.step();
+    mobile_optimizer.step();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      AT_ASSERT(parameters[i].allclose(mobile_parameters[i]));
+    }
+  }
+}
+
 namespace {
 struct DummyDataset : torch::data::datasets::Dataset<DummyDataset, int> {
   explicit DummyDataset(size_t size = 100) : size_(size) {}
@@ -1096,6 +1096,25 @@ void testRecordFunction() {
   { RECORD_USER_SCOPE("test"); }
   TORCH_CHECK(!has_ids);
   clearCallbacks();
+
+  // test the check for any callbacks
+  TORCH_CHECK(!shouldRunRecordFunction());
+  auto tls_handle = addThreadLocalCallback(RecordFunctionCallback(
+      [](const RecordFunction&) {}, [](const RecordFunction&) {}));
+  TORCH_CHECK(shouldRunRecordFunction());
+  addGlobalCallback(RecordFunctionCallback(
+      [](const RecordFunction&) {}, [](const RecordFunction&) {}));
+  removeCallback(tls_handle);
+  TORCH_CHECK(shouldRunRecordFunction());
+  clearCallbacks();
+  TORCH_CHECK(!shouldRunRecordFunction());
+  std::thread t_cb([]() {
+    addThreadLocalCallback(RecordFunctionCallback(
+        [](const RecordFunction&) {}, [](const RecordFunction&) {}));
+    TORCH_CHECK(shouldRunRecordFunction());
+  });
+  t_cb.join();
+  TORCH_CHECK(!shouldRunRecordFunction());
 }
 
 class TestThreadLocalDebugInfo : public c10::DebugInfoBase {
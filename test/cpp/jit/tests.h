@@ -80,6 +80,7 @@ namespace jit {
   _(ModuleCloneWithModuleInterface)               \
   _(ClassTypeAddRemoveAttr)                       \
   _(Inliner)                                      \
+  _(InterpreterSuperinstructions)                 \
   _(LiteInterpreterAdd)                           \
   _(LiteInterpreterConv)                          \
   _(LiteInterpreterInline)                        \
@@ -107,11 +108,15 @@ namespace jit {
   _(LiteInterpreterEval)                          \
   _(TorchbindIValueAPI)                           \
   _(LiteInterpreterDict)                          \
+  _(LiteInterpreterFlatBytecode)                  \
+  _(LiteInterpreterMemoryPlanning)                \
+  _(LiteInterpreterOperatorObserver)              \
   _(MobileNamedParameters)                        \
   _(MobileSaveLoadData)                           \
   _(MobileSaveLoadParameters)                     \
   _(MobileSaveLoadParametersEmpty)                \
   _(LiteSGD)                                      \
+  _(LiteSGDFused)                                 \
   _(LiteSequentialSampler)                        \
   _(FusionAliasing)
 
@@ -221,7 +226,13 @@ namespace jit {
   _(GPU_FusionTraversalOrder6)                      \
   _(GPU_FusionTraversalOrder7)                      \
   _(GPU_FusionBranches)                             \
-  _(GPU_FusionThreadPredicate)
+  _(GPU_FusionThreadPredicate)                      \
+  _(GPU_FusionKernelCache)                          \
+  _(GPU_FusionNormalizationSoftmax)                 \
+  _(GPU_FusionNormalizationLayerNorm)               \
+  _(GPU_FusionExecutorCacheReuse)                   \
+  _(GPU_FusionPermute)                              \
+  _(GPU_FusionViewSplitMerge)
 #else
 #define TH_FORALL_TESTS_CUDA(_) \
   _(ArgumentSpec)               \
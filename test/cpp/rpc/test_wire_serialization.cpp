@@ -49,6 +49,36 @@ TEST(WireSerialize, RecopySparseTensors) {
   EXPECT_LT(ser.size(), (tiny.element_size() * k1K) + k1K);
 }
 
+TEST(WireSerialize, AliasWireBuffer) {
+  std::vector<at::Tensor> tensors = {
+      torch::randn({3}), torch::randn({128, 128}), torch::arange(7)};
+  auto serialized =
+      torch::distributed::rpc::wireSerialize({'h', 'i'}, tensors);
+  at::Tensor wire = torch::empty(
+      {static_cast<int64_t>(serialized.size())}, {torch::kChar});
+  memcpy(wire.data_ptr(), serialized.data(), serialized.size());
+
+  auto deser = torch::distributed::rpc::wireDeserialize(wire);
+  const char* begin = static_cast<const char*>(wire.data_ptr());
+  const char* end = begin + serialized.size();
+  wire = at::Tensor();
+  EXPECT_EQ(2, deser.first.size());
+  ASSERT_EQ(tensors.size(), deser.second.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    // The received tensors are views of the buffer, which they keep alive.
+    const char* data = static_cast<const char*>(deser.second[i].data_ptr());
+    EXPECT_TRUE(data >= begin && data < end);
+    EXPECT_TRUE(torch::equal(tensors[i], deser.second[i]));
+  }
+
+  // The buffer is only read from without an owner.
+  auto copied = torch::distributed::rpc::wireDeserialize(
+      serialized.data(), serialized.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    EXPECT_TRUE(torch::equal(tensors[i], copied.second[i]));
+  }
+}
+
 TEST(WireSerialize, CloneSparseTensors) {
   constexpr size_t k1K = 1024;
   at::Tensor big = torch::randn({k1K, k1K});
@@ -7,10 +7,13 @@
 #include <cmath>
 
 #include "test/cpp/tensorexpr/padded_buffer.h"
+#include "torch/csrc/jit/tensorexpr/analysis.h"
 #include "torch/csrc/jit/tensorexpr/buffer.h"
 #include "torch/csrc/jit/tensorexpr/cuda_codegen.h"
+#include "torch/csrc/jit/tensorexpr/ir_simplifier.h"
 #include "torch/csrc/jit/tensorexpr/loopnest.h"
 #include "torch/csrc/jit/tensorexpr/tensor.h"
+#include "torch/csrc/jit/testing/file_check.h"
 
 #include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/util/Half.h>
@@ -864,6 +867,160 @@ void testCudaLocalMemReduce_1() {
   cudaFree(b_dev);
 }
 
+void testCudaVectorizedAccess() {
+  KernelScope kernel_scope;
+  const int block_count = 16;
+  const int block_size = 128;
+  const int kVectorWidth = 4;
+  const int N = block_count * block_size * kVectorWidth;
+  Buffer a_buf("a", kFloat, {N});
+  Buffer b_buf("b", kFloat, {N});
+  Tensor* c = Compute("c", {{N, "n"}}, [&](const VarHandle& n) {
+    return a_buf(n) * b_buf(n);
+  });
+  LoopNest l({c});
+  std::vector<For*> loops = l.getLoopStmtsFor(c);
+  For* n_outer;
+  For* n_vector;
+  For* b_id;
+  For* t_id;
+  l.splitWithMask(loops[0], kVectorWidth, &n_outer, &n_vector);
+  l.splitWithMask(n_outer, block_size, &b_id, &t_id);
+  l.setGPUBlockIndex(b_id, 0);
+  l.setGPUThreadIndex(t_id, 0);
+  l.prepareForCodegen();
+  std::vector<For*> vector_loops = NodeFinder<For>::find(l.root_stmt());
+  ASSERT_EQ(vector_loops.size(), 3);
+  l.vectorize(vector_loops[2]);
+  Stmt* stmt = IRSimplifier::simplify(l.root_stmt());
+  CudaCodeGen cuda_cg(stmt, c, a_buf, b_buf);
+
+  const std::string& verification_pattern =
+      R"IR(
+# CHECK: = *reinterpret_cast<const aligned_vector<float, 4>*>(a
+# CHECK: = *reinterpret_cast<const aligned_vector<float, 4>*>(b
+# CHECK: *reinterpret_cast<aligned_vector<float, 4>*>(c)IR";
+  torch::jit::testing::FileCheck().run(
+      verification_pattern, cuda_cg.getCodeText());
+
+  PaddedBuffer<float> a_v(N);
+  PaddedBuffer<float> b_v(N);
+  PaddedBuffer<float> c_v(N);
+  PaddedBuffer<float> c_ref(N);
+  for (int i = 0; i < N; i++) {
+    a_v(i) = i;
+    b_v(i) = i % 7;
+    c_ref(i) = a_v(i) * b_v(i);
+  }
+
+  float* a_dev = nullptr;
+  cudaMalloc(&a_dev, N * sizeof(float));
+  float* b_dev = nullptr;
+  cudaMalloc(&b_dev, N * sizeof(float));
+  float* c_dev = nullptr;
+  cudaMalloc(&c_dev, N * sizeof(float));
+  cudaMemcpy(a_dev, a_v.data(), N * sizeof(float), cudaMemcpyHostToDevice);
+  cudaMemcpy(b_dev, b_v.data(), N * sizeof(float), cudaMemcpyHostToDevice);
+  cudaDeviceSynchronize();
+
+  cuda_cg(c_dev, a_dev, b_dev);
+
+  cudaDeviceSynchronize();
+  cudaMemcpy(c_v.data(), c_dev, N * sizeof(float), cudaMemcpyDeviceToHost);
+  cudaDeviceSynchronize();
+
+  ExpectAllNear(c_v, c_ref, 1e-5);
+
+  cudaFree(a_dev);
+  cudaFree(b_dev);
+  cudaFree(c_dev);
+}
+
+void testCudaSharedMemTranspose() {
+  KernelScope kernel_scope;
+  // c[i, j] = a[j, i], each block transposing a tile of a through shared
+  // memory, so that both a and c are accessed along their rows:
+  //  for i_outer in 0..4:  // block-idx.x
+  //    for j_outer in 0..4:  // block-idx.y
+  //      alloc(a_cache, {16, 16})
+  //      for idx0 in 0..16:  // thread-idx.y
+  //        for idx1 in 0..16:  // thread-idx.x
+  //          a_cache[idx0, idx1] = a[j_outer*16 + idx0, i_outer*16 + idx1]
+  //      for i_inner in 0..16:  // thread-idx.y
+  //        for j_inner in 0..16:  // thread-idx.x
+  //          c[...] = a_cache[j_inner, i_inner]
+  //      free(a_cache)
+  const int M = 64;
+  const int N = 64;
+  const int kTile = 16;
+  Buffer a_buf("a", kFloat, {N, M});
+  Tensor* c = Compute(
+      "c", {{M, "i"}, {N, "j"}}, [&](const VarHandle& i, const VarHandle& j) {
+        return a_buf(j, i);
+      });
+  LoopNest l({c});
+  std::vector<For*> loops = l.getLoopStmtsFor(c);
+  For* i_outer;
+  For* i_inner;
+  For* j_outer;
+  For* j_inner;
+  l.splitWithMask(loops[0], kTile, &i_outer, &i_inner);
+  l.splitWithMask(loops[1], kTile, &j_outer, &j_inner);
+  l.reorderAxis(i_inner, j_outer);
+  loops = l.getLoopStmtsFor(c);
+  l.setGPUBlockIndex(loops[0], 0);
+  l.setGPUBlockIndex(loops[1], 1);
+  l.setGPUThreadIndex(loops[2], 1);
+  l.setGPUThreadIndex(loops[3], 0);
+  std::vector<For*> cache_loops = l.cacheAccesses(a_buf.data(), loops[1]);
+  ASSERT_EQ(cache_loops.size(), 2);
+  l.setGPUThreadIndex(cache_loops[0], 1);
+  l.setGPUThreadIndex(cache_loops[1], 0);
+  l.prepareForCodegen();
+  Stmt* stmt = l.root_stmt();
+  CudaCodeGen cuda_cg(stmt, c, a_buf);
+
+  const std::string& verification_pattern =
+      R"IR(
+# CHECK: __shared__ float a_cache[256];
+# CHECK: a_cache[
+# CHECK: __syncthreads();
+# CHECK: = a_cache[
+# CHECK: c[)IR";
+  torch::jit::testing::FileCheck().run(
+      verification_pattern, cuda_cg.getCodeText());
+
+  PaddedBuffer<float> a_v(N, M);
+  PaddedBuffer<float> c_v(M, N);
+  PaddedBuffer<float> c_ref(M, N);
+  for (int j = 0; j < N; j++) {
+    for (int i = 0; i < M; i++) {
+      a_v(j, i) = j * M + i;
+      c_ref(i, j) = a_v(j, i);
+    }
+  }
+
+  float* a_dev = nullptr;
+  cudaMalloc(&a_dev, M * N * sizeof(float));
+  float* c_dev = nullptr;
+  cudaMalloc(&c_dev, M * N * sizeof(float));
+  cudaMemcpy(
+      a_dev, a_v.data(), M * N * sizeof(float), cudaMemcpyHostToDevice);
+  cudaDeviceSynchronize();
+
+  cuda_cg(c_dev, a_dev);
+
+  cudaDeviceSynchronize();
+  cudaMemcpy(
+      c_v.data(), c_dev, M * N * sizeof(float), cudaMemcpyDeviceToHost);
+  cudaDeviceSynchronize();
+
+  ExpectAllNear(c_v, c_ref, 1e-5);
+
+  cudaFree(a_dev);
+  cudaFree(c_dev);
+}
+
 } // namespace jit
 } // namespace torch
 
@@ -576,5 +576,33 @@ void testStmtClone() {
   assertAllEqual(cloned_loop_results_after_mutation, 33);
 }
 
+void testExprArenaReuse() {
+  KernelArena arena;
+  size_t reserved = 0;
+  for (int round = 0; round < 2; round++) {
+    KernelScope kernel_scope(&arena);
+    VarHandle x("x", kInt);
+    ExprHandle e = x;
+    for (int i = 0; i < 10000; i++) {
+      e = e + i;
+    }
+    KernelArenaStats stats = arena.stats();
+    ASSERT_GE(stats.objects, 20000);
+    ASSERT_GE(stats.bytesReserved, stats.bytesAllocated);
+    if (round == 0) {
+      ASSERT_GT(stats.slabs, 1);
+      reserved = stats.bytesReserved;
+      arena.reset();
+      ASSERT_EQ(arena.stats().objects, 0);
+      ASSERT_EQ(arena.stats().bytesAllocated, 0);
+      ASSERT_EQ(arena.stats().slabs, 1);
+    } else {
+      // the same kernel fits in the slab kept by the reset
+      ASSERT_EQ(stats.slabs, 1);
+      ASSERT_EQ(stats.bytesReserved, reserved);
+    }
+  }
+}
+
 } // namespace jit
 } // namespace torch
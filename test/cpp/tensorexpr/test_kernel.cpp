@@ -1,3 +1,4 @@
+#include <c10/util/tempfile.h>
 #include <test/cpp/tensorexpr/test_base.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 #include <torch/csrc/jit/ir/ir.h>
@@ -5,9 +6,11 @@
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/schedule_cache.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
 #include <torch/torch.h>
 #include <cmath>
+#include <fstream>
 #include <sstream>
 #include <stdexcept>
 
@@ -424,5 +427,185 @@ void testKernelSumMultipleAxes() {
   }
 }
 
+void testKernelSoftmax() {
+  const auto graph_template = R"IR(
+      graph(%0 : Float(5:12,3:4,4:1, device=cpu)):
+        %1 : int = prim::Constant[value=${dim}]()
+        %2 : None = prim::Constant()
+        %3 : Tensor = aten::${op}(%0, %1, %2)
+        %4 : Tensor = aten::relu(%3)
+        return (%4))IR";
+  auto a = at::rand({5, 3, 4}, TensorOptions(kCPU).dtype(at::kFloat));
+
+  for (bool log_softmax : {false, true}) {
+    for (int dim = -3; dim < 3; ++dim) {
+      KernelScope kernel_scope;
+      TemplateEnv env;
+      env.s("op", log_softmax ? "log_softmax" : "softmax");
+      env.d("dim", dim);
+      auto graph = std::make_shared<Graph>();
+      parseIR(format(graph_template, env), &*graph);
+
+      auto ref = (log_softmax ? a.log_softmax(dim) : a.softmax(dim)).relu();
+      TensorExprKernel k(graph);
+      std::vector<IValue> stack = {a};
+      k.run(stack);
+      auto o = stack[0].toTensor();
+      ASSERT_EQ(o.sizes(), ref.sizes());
+      ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-6));
+    }
+  }
+}
+
+void testKernelLayerNorm() {
+  KernelScope kernel_scope;
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:12,3:4,4:1, device=cpu),
+            %1 : Float(3:4,4:1, device=cpu),
+            %2 : Float(3:4,4:1, device=cpu)):
+        %3 : int = prim::Constant[value=3]()
+        %4 : int = prim::Constant[value=4]()
+        %5 : int[] = prim::ListConstruct(%3, %4)
+        %6 : float = prim::Constant[value=1.0000000000000001e-05]()
+        %7 : bool = prim::Constant[value=1]()
+        %8 : Tensor = aten::layer_norm(%0, %5, %1, %2, %6, %7)
+        return (%8))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto a = at::rand({5, 3, 4}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto w = at::rand({3, 4}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::rand({3, 4}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = at::layer_norm(a, {3, 4}, w, b);
+  TensorExprKernel k(graph);
+  std::vector<IValue> stack = {a, w, b};
+  k.run(stack);
+  auto o = stack[0].toTensor();
+  ASSERT_EQ(o.sizes(), ref.sizes());
+  ASSERT_TRUE(at::allclose(o, ref, 1e-4, 1e-5));
+}
+
+void testKernelDynamicShape() {
+  KernelScope kernel_scope;
+  const auto graph_string = R"IR(
+      graph(%0 : Tensor,
+            %1 : Tensor,
+            %2 : Float(1:4,4:1, device=cpu)):
+        %3 : Tensor = aten::mul(%0, %1)
+        %4 : int = prim::Constant[value=1]()
+        %5 : Tensor = aten::add(%3, %2, %4)
+        return (%5))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  // Float(N, 4) with a unit innermost stride, for any N
+  auto rows = c10::ShapeSymbol::newSymbol();
+  auto type = TensorType::create(
+      at::kFloat,
+      at::kCPU,
+      c10::SymbolicShape({rows, c10::ShapeSymbol::fromStaticSize(4)}),
+      c10::VaryingShape<c10::Stride>(std::vector<c10::Stride>{
+          c10::Stride(1, true, 1), c10::Stride(0, true, c10::nullopt)}),
+      false);
+  graph->inputs()[0]->setType(type);
+  graph->inputs()[1]->setType(type);
+
+  TensorExprKernel k(graph);
+  for (int64_t n : {1, 3, 17}) {
+    auto a = at::rand({n, 4}, TensorOptions(kCPU).dtype(at::kFloat));
+    // strided rows, which the kernel reads through the strides it is passed
+    auto b = at::rand({n, 8}, TensorOptions(kCPU).dtype(at::kFloat))
+                 .narrow(1, 0, 4);
+    auto c = at::rand({1, 4}, TensorOptions(kCPU).dtype(at::kFloat));
+    auto ref = a * b + c;
+    std::vector<IValue> stack = {a, b, c};
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_EQ(o.sizes(), ref.sizes());
+    ASSERT_TRUE(at::allclose(o, ref));
+  }
+}
+
+void testKernelScheduleCache() {
+  auto tempfile = c10::make_tempfile();
+  std::string old_file = getTEScheduleCacheFile();
+  setTEScheduleCacheFile(tempfile.name);
+
+  LoopSchedule schedule;
+  schedule.bodyVectorWidth = 16;
+  schedule.tailVectorWidth = 0;
+  schedule.inlineIntermediates = false;
+  ASSERT_FALSE(lookupSchedule("kernel"));
+  storeSchedule("kernel", schedule);
+  storeSchedule("other kernel", LoopSchedule());
+
+  // reloads the schedules from the file
+  setTEScheduleCacheFile(tempfile.name);
+  ASSERT_EQ(*lookupSchedule("kernel"), schedule);
+  ASSERT_EQ(*lookupSchedule("other kernel"), LoopSchedule());
+  ASSERT_FALSE(lookupSchedule("unknown kernel"));
+
+  ASSERT_FALSE(LoopSchedule::parse("8 8 1"));
+  ASSERT_FALSE(LoopSchedule::parse("3 0 1"));
+  ASSERT_FALSE(LoopSchedule::parse("8 4"));
+
+  setTEScheduleCacheFile(old_file);
+}
+
+#ifdef TORCH_ENABLE_LLVM
+// The number of schedules stored in the cache file, one per line.
+static size_t countSchedules(const std::string& path) {
+  std::ifstream in(path);
+  size_t count = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    count++;
+  }
+  return count;
+}
+
+void testKernelAutotune() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(37:1, device=cpu),
+            %1 : Float(37:1, device=cpu)):
+        %2 : Float(37:1) = aten::mul(%0, %1)
+        %3 : Float(37:1) = aten::mul(%2, %2)
+        return (%3))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto tempfile = c10::make_tempfile();
+  std::string old_file = getTEScheduleCacheFile();
+  bool old_autotune = getTEAutotune();
+  setTEScheduleCacheFile(tempfile.name);
+  getTEAutotune() = true;
+
+  auto a = at::rand({37}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::rand({37}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = (a * b) * (a * b);
+  // The first kernel tunes its schedule and stores it, the second one
+  // reuses it from memory and, once the cache is reloaded, the third one
+  // from the file. Reused schedules are not stored again.
+  for (int i = 0; i < 3; i++) {
+    if (i == 2) {
+      setTEScheduleCacheFile(tempfile.name);
+    }
+    TensorExprKernel k(graph);
+    ASSERT_EQ(countSchedules(tempfile.name), 1);
+    std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{a, b});
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    for (size_t j = 0; j < 37; j++) {
+      CHECK_EQ(((float*)o.data_ptr())[j], ((float*)ref.data_ptr())[j]);
+    }
+  }
+
+  getTEAutotune() = old_autotune;
+  setTEScheduleCacheFile(old_file);
+}
+#endif // TORCH_ENABLE_LLVM
+
 } // namespace jit
 } // namespace torch
@@ -1142,6 +1142,32 @@ void testLLVMDynamicShapeAdd() {
   testWithSize(37);
 }
 
+void testLLVMParallelFor() {
+  KernelScope kernel_scope;
+  // a parallel outer loop over rows, capturing buffers and a scalar
+  constexpr int M = 64;
+  constexpr int N = 1000;
+  VarHandle k("k", kFloat);
+  Buffer a(BufHandle("A", {M * N}, kFloat));
+  Buffer c(BufHandle("C", {M * N}, kFloat));
+  VarHandle i("i", kInt);
+  VarHandle j("j", kInt);
+  For* outer = For::make(
+      i,
+      0,
+      M,
+      For::make(j, 0, N, Store::make(c, {i * N + j}, a(i * N + j) + k, 1)));
+  outer->set_parallel();
+
+  std::vector<float> aData(M * N, 1.0f);
+  std::vector<float> cData(M * N, 0.0f);
+  float kValue = 41.0f;
+  LLVMCodeGen cg(outer, {a, c, k});
+  std::vector<void*> args({aData.data(), cData.data(), &kValue});
+  cg.value<int>(args);
+  ExpectAllNear(cData, std::vector<float>(M * N, 42.0f), 1e-7);
+}
+
 void testLLVMBindDynamicShapeAdd() {
   KernelScope kernel_scope;
   auto testWithSize = [](int32_t size) {
@@ -922,6 +922,70 @@ void testLoopNestComputeAt_4() {
   // TODO: Verify that computeAt works with reduction axis
 }
 
+void testLoopNestCacheAccesses() {
+  // Verify that the row of b read by each iteration of the i loop is copied
+  // to a temp buffer in that loop:
+  //
+  // for (int i = 0; i < M; i++) {
+  //   for (int j = 0; j < N; j++) {
+  //     c[i, j] = a[i, j] * b[i + 1, j]
+  //   }
+  // }
+  KernelScope kernel_scope;
+  const int M = 4;
+  const int N = 16;
+  Buffer a_buf("a", kFloat, {M, N});
+  Buffer b_buf("b", kFloat, {M + 1, N});
+  Tensor* c = Compute(
+      "c", {{M, "i"}, {N, "j"}}, [&](const VarHandle& i, const VarHandle& j) {
+        return a_buf(i, j) * b_buf(i + 1, j);
+      });
+  LoopNest l({c});
+  std::vector<For*> loops = l.getLoopStmtsFor(c);
+  std::vector<For*> cache_loops = l.cacheAccesses(b_buf.data(), loops[0]);
+  ASSERT_EQ(cache_loops.size(), 2);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+  std::ostringstream oss;
+  oss << *s;
+
+  const std::string& verification_pattern =
+      R"IR(
+# CHECK: for (int i = 0; i < 4; i++)
+# CHECK:   Allocate(b_cache, float, {1, 16})
+# CHECK:   b_cache[
+# CHECK-SAME: b[
+# CHECK-NOT: b[
+# CHECK:   c[
+# CHECK-SAME: b_cache[
+# CHECK:   Free(b_cache))IR";
+
+  torch::jit::testing::FileCheck().run(verification_pattern, oss.str());
+
+  // Now check that the loop still produces the correct result.
+  PaddedBuffer<float> a_v(M, N);
+  PaddedBuffer<float> b_v(M + 1, N);
+  PaddedBuffer<float> c_v(M, N);
+  PaddedBuffer<float> c_ref(M, N);
+  for (int i = 0; i < M + 1; i++) {
+    for (int j = 0; j < N; j++) {
+      if (i < M) {
+        a_v(i, j) = i * N + j;
+      }
+      b_v(i, j) = i - j;
+    }
+  }
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      c_ref(i, j) = a_v(i, j) * b_v(i + 1, j);
+    }
+  }
+  SimpleIREvaluator cg(s, {c, a_buf, b_buf});
+  cg.call({c_v, a_v, b_v});
+  ExpectAllNear(c_v, c_ref, 1e-5);
+}
+
 class LoopOrderHelper : public IRVisitor {
   std::stringstream ordering;
 
@@ -33,6 +33,7 @@ namespace jit {
   _(ExprBinaryMath01)                       \
   _(ExprDynamicShapeAdd)                    \
   _(ExprBitwiseOps)                         \
+  _(ExprArenaReuse)                         \
   _(IRPrinterBasicValueTest)                \
   _(IRPrinterBasicValueTest02)              \
   _(IRPrinterCastTest)                      \
@@ -210,6 +211,7 @@ namespace jit {
   _(LoopNestComputeAt_2)                    \
   _(LoopNestComputeAt_3)                    \
   _(LoopNestComputeAt_4)                    \
+  _(LoopNestCacheAccesses)                  \
   _(LoopNestReorderAxis1)                   \
   _(LoopNestReorderPartialAxes)             \
   _(LoopNestReorderInternalAxis)            \
@@ -242,6 +244,10 @@ namespace jit {
   _(KernelSumAllAxes)                       \
   _(KernelSumOneAxis)                       \
   _(KernelSumMultipleAxes)                  \
+  _(KernelSoftmax)                          \
+  _(KernelLayerNorm)                        \
+  _(KernelDynamicShape)                     \
+  _(KernelScheduleCache)                    \
   _(FuserPass_1)                            \
   _(FuserPass_2)                            \
   _(FuserPass_3)                            \
@@ -360,6 +366,7 @@ namespace jit {
   _(LLVMBroadcastAdd)                      \
   _(LLVMBitwiseOps)                        \
   _(LLVMDynamicShapeAdd)                   \
+  _(LLVMParallelFor)                       \
   _(LLVMBindDynamicShapeAdd)               \
   _(LLVMTensorDynamicShapeAdd)             \
   _(LLVMDynamicShape2D)                    \
@@ -368,7 +375,8 @@ namespace jit {
   _(LLVMIfThenElseTest)                    \
   _(LLVMVectorizerLoadStoreTest)           \
   _(LLVMSimpleReduction)                   \
-  _(LLVMRFactorReduction)
+  _(LLVMRFactorReduction)                  \
+  _(KernelAutotune)
 
 // _(LLVMRFactorVectorizedReduction)
 
@@ -383,7 +391,9 @@ namespace jit {
   _(CudaSharedMemReduce_1)                 \
   _(CudaLocalMemReduce_1)                  \
   _(CudaTestRand01)                        \
-  _(CudaSigmoid)
+  _(CudaSigmoid)                           \
+  _(CudaVectorizedAccess)                  \
+  _(CudaSharedMemTranspose)
 
 #define DECLARE_TENSOREXPR_TEST(name) void test##name();
 TH_FORALL_TENSOREXPR_TESTS(DECLARE_TENSOREXPR_TEST)
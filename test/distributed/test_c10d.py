@@ -215,6 +215,19 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set([], [])
+        self.assertEqual([], fs.multi_get([]))
+        fs.set("key1", "old")
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        self.assertEqual([b"value2", b"value0"], fs.multi_get(["key2", "key0"]))
+        self.assertEqual(b"value1", fs.get("key1"))
+        with self.assertRaisesRegex(RuntimeError, "as many values as keys"):
+            fs.multi_set(["key0", "key1"], ["value0"])
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -262,6 +275,24 @@ class TCPStoreTest(TestCase, StoreTestBase):
         store.set_timeout(timedelta(seconds=300))
         return store
 
+    def test_wait_for_set_and_missing_keys(self):
+        store = self._create_store()
+        store.set("key0", "value0")
+
+        # The client waits on a key that is already set and on one that
+        # is set by another connection.
+        client = c10d.TCPStore("localhost", store.port, 1, False)
+
+        def set_later():
+            time.sleep(0.1)
+            store.set("key1", "value1")
+
+        thread = threading.Thread(target=set_later)
+        thread.start()
+        client.wait(["key0", "key1", "key0"], timedelta(seconds=10))
+        thread.join()
+        self.assertEqual([b"value0", b"value1"], client.multi_get(["key0", "key1"]))
+
     def test_address_already_in_use(self):
         with self.assertRaisesRegex(RuntimeError, "^Address already in use$"):
             addr = 'localhost'
@@ -824,6 +855,55 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         inputs = [torch.tensor([i + self.rank]).cuda() for i in range(1000)]
         self._test_allreduce_stress(inputs)
 
+    def test_allgather_base_and_reduce_scatter_base(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        input = torch.full((3,), float(self.rank))
+        output = torch.empty(3 * self.world_size)
+        c10d._all_gather_base(output, input, pg)
+        self.assertEqual(torch.arange(self.world_size, dtype=torch.float).repeat_interleave(3), output)
+
+        input = torch.arange(3 * self.world_size, dtype=torch.float) * (self.rank + 1)
+        original = input.clone()
+        output = torch.empty(3)
+        c10d._reduce_scatter_base(output, input, group=pg)
+        expected = torch.arange(3 * self.rank, 3 * (self.rank + 1), dtype=torch.float)
+        self.assertEqual(expected * sum(range(1, self.world_size + 1)), output)
+        self.assertEqual(original, input)
+
+        with self.assertRaisesRegex(ValueError, "invalid buffer sizes"):
+            pg._allgather_base(torch.empty(3), torch.empty(3))
+        with self.assertRaisesRegex(ValueError, "invalid buffer sizes"):
+            pg._reduce_scatter_base(torch.empty(2), torch.empty(3 * self.world_size))
+        with self.assertRaisesRegex(ValueError, "same type"):
+            pg._allgather_base(torch.empty(3 * self.world_size, dtype=torch.int64), input[:3])
+
+    def test_allreduce_chunked_multi_device(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = self.opts()
+        opts.devices = [
+            c10d.ProcessGroupGloo.create_device(interface=LOOPBACK)
+            for _ in range(3)
+        ]
+        opts.allreduce_min_chunk_bytes = 64
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Too small to be split, split in two and split over all the devices,
+        # with a number of elements that does not divide evenly.
+        for numel in (8, 40, 1001):
+            for dtype in (torch.float, torch.int64):
+                tensor = torch.arange(numel, dtype=dtype) * (self.rank + 1)
+                pg.allreduce(tensor).wait()
+                expected = torch.arange(numel, dtype=dtype) * sum(range(1, self.world_size + 1))
+                self.assertEqual(expected, tensor)
+
+        tensor = torch.full((1001,), float(self.rank))
+        opts = c10d.AllreduceOptions()
+        opts.reduceOp = c10d.ReduceOp.MAX
+        pg.allreduce([tensor], opts).wait()
+        self.assertEqual(torch.full((1001,), float(self.world_size - 1)), tensor)
+
     def test_allreduce_coalesced_checks(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -1532,6 +1612,31 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
             pg.broadcast(tensor, root=0).wait()
             self.assertEqual(torch.full([100, 100], 0.), tensor)
 
+    def test_round_robin_striped(self):
+        num_process_groups = 3
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d._round_robin_process_groups([
+            c10d.ProcessGroupGloo(
+                c10d.PrefixStore(str(i), store),
+                self.rank,
+                self.world_size)
+            for i in range(num_process_groups)
+        ], stripe_min_bytes=1024)
+
+        # Sizes not divisible by the number of process groups, and below the
+        # threshold
+        for size in [[100, 101], [2], [1, 1]]:
+            tensor = torch.arange(float(size[0] * size[1])).view(size) + self.rank
+            expected = torch.arange(float(size[0] * size[1])).view(size)
+            pg.broadcast(tensor, root=0).wait()
+            self.assertEqual(expected, tensor)
+
+            work = pg.allreduce(tensor)
+            work.wait()
+            self.assertEqual(expected * self.world_size, tensor)
+            self.assertTrue(work.is_completed())
+            self.assertTrue(work.is_success())
+
     def test_round_robin_create_destroy(self):
         store = c10d.FileStore(self.file_name, self.world_size)
 
@@ -3231,6 +3336,141 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         # without the comm_hook, result would be still 0.25 * torch.ones(2, 2).
         self._run_and_verify_hook(gpu_model, 8, 1.25 * torch.ones(2, 2))
 
+    @requires_gloo()
+    def test_ddp_overlapped_optimizer(self):
+        """
+        This unit test verifies that applying the optimizer update per bucket in
+        the backward pass gives the same parameters as calling step() after it.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        torch.manual_seed(0)
+        model = nn.Sequential(nn.Linear(8, 16), nn.ReLU(), nn.Linear(16, 4))
+        # A small bucket size, so that the rebuilt buckets hold one parameter each.
+        ddp_model = DistributedDataParallel(
+            copy.deepcopy(model), process_group=process_group, bucket_cap_mb=0.0001)
+        overlapped_model = DistributedDataParallel(
+            copy.deepcopy(model), process_group=process_group, bucket_cap_mb=0.0001)
+
+        optimizer = torch.optim.SGD(ddp_model.parameters(), lr=0.1, momentum=0.9)
+        optimizers = overlapped_model._register_overlapped_optimizer(
+            torch.optim.SGD, lr=0.1, momentum=0.9)
+        self.assertEqual(len(optimizers), len(list(model.parameters())))
+
+        torch.manual_seed(self.rank)
+        for _ in range(3):
+            input = torch.randn(5, 8)
+            optimizer.zero_grad()
+            ddp_model(input).sum().backward()
+            optimizer.step()
+
+            overlapped_model.zero_grad()
+            overlapped_model(input).sum().backward()
+
+            for p, q in zip(ddp_model.parameters(), overlapped_model.parameters()):
+                self.assertEqual(p, q)
+
+        with overlapped_model.no_sync():
+            before = [p.clone() for p in overlapped_model.parameters()]
+            overlapped_model(torch.randn(5, 8)).sum().backward()
+            for p, q in zip(before, overlapped_model.parameters()):
+                self.assertEqual(p, q)
+
+    @requires_gloo()
+    def test_ddp_bucket_cost_model(self):
+        """
+        This unit test verifies that the buckets rebuilt from the gradient ready
+        times give the same gradients as the default buckets.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        torch.manual_seed(0)
+        model = nn.Sequential(nn.Linear(8, 16), nn.ReLU(), nn.Linear(16, 4))
+        ddp_model = DistributedDataParallel(copy.deepcopy(model), process_group=process_group)
+        timed_model = DistributedDataParallel(copy.deepcopy(model), process_group=process_group)
+        timed_model._set_bucket_cost_model()
+
+        torch.manual_seed(self.rank)
+        for _ in range(3):
+            input = torch.randn(5, 8)
+            ddp_model.zero_grad()
+            ddp_model(input).sum().backward()
+            timed_model.zero_grad()
+            timed_model(input).sum().backward()
+            for p, q in zip(ddp_model.parameters(), timed_model.parameters()):
+                self.assertEqual(p.grad, q.grad)
+
+        with self.assertRaisesRegex(RuntimeError, "before the buckets are rebuilt"):
+            timed_model._set_bucket_cost_model(latency=1e-5, bandwidth=1e9)
+
+    def _gpu_model_with_builtin_ddp_comm_hook(self, process_group, hook_type, **kwargs):
+        device_id = gpus_for_rank(self.world_size)[self.rank][0]
+        gpu_model = DistributedDataParallel(
+            TestDdpCommHook().to(device_id),
+            device_ids=[device_id],
+            process_group=process_group,
+        )
+        gpu_model._register_builtin_comm_hook(hook_type, **kwargs)
+        return gpu_model
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(2)
+    def test_builtin_ddp_comm_hooks_nccl(self):
+        """
+        This unit test verifies that the C++ communication hooks give the same
+        gradients as DDP without a hook. The gradients of TestDdpCommHook are the
+        same on all the ranks and exact in half precision. The bucket is too small
+        for PowerSGD and for top-k with a large ratio to compress it.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        for hook_type, kwargs in (
+            (dist.BuiltinCommHookType.ALLREDUCE, {}),
+            (dist.BuiltinCommHookType.FP16_COMPRESS, {}),
+            (dist.BuiltinCommHookType.POWER_SGD, {}),
+            (dist.BuiltinCommHookType.TOPK, {"topk_ratio": 1.0}),
+        ):
+            gpu_model = self._gpu_model_with_builtin_ddp_comm_hook(
+                process_group, hook_type, **kwargs)
+            self._run_and_verify_hook(gpu_model, 8, 0.25 * torch.ones(2, 2))
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(2)
+    def test_builtin_ddp_comm_hook_topk_error_feedback_nccl(self):
+        """
+        With a ratio of 1/4, top-k sends one of the four entries of the gradient
+        per backward pass. The gradient is 0.25 everywhere, the entries that were
+        not sent are added to the next gradient, so the entry that is sent in
+        the k-th pass is 0.25 * k.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        gpu_model = self._gpu_model_with_builtin_ddp_comm_hook(
+            process_group, dist.BuiltinCommHookType.TOPK, topk_ratio=0.25)
+        for k in range(1, 5):
+            gpu_model.zero_grad()
+            gpu_model(8, self.rank).mean().backward()
+            grad = gpu_model.module.t0.p.grad
+            self.assertEqual((grad != 0).sum().item(), 1)
+            self.assertEqual(grad.sum().item(), 0.25 * k)
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(2)
+    def test_builtin_ddp_comm_hook_invalid_args_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        with self.assertRaisesRegex(RuntimeError, "positive matrix approximation rank"):
+            self._gpu_model_with_builtin_ddp_comm_hook(
+                process_group, dist.BuiltinCommHookType.POWER_SGD, matrix_approximation_rank=0)
+        with self.assertRaisesRegex(RuntimeError, "expects a ratio in"):
+            self._gpu_model_with_builtin_ddp_comm_hook(
+                process_group, dist.BuiltinCommHookType.TOPK, topk_ratio=2.0)
+
     @requires_gloo()
     def test_ddp_invalid_comm_hook_init(self):
         """
@@ -3508,6 +3748,41 @@ class ReducerTest(TestCase):
 
 
 class ComputeBucketAssignmentTest(TestCase):
+    def test_timing_latency_bound(self):
+        # Every allreduce costs more than waiting for all the gradients.
+        tensors = [torch.empty([100], dtype=torch.float) for _ in range(4)]
+        result = dist._compute_bucket_assignment_by_timing(
+            tensors, [0, 10, 20, 30], latency=1e6, time_per_byte=0)
+        self.assertEqual([[0, 1, 2, 3]], result)
+
+    def test_timing_bandwidth_bound(self):
+        # Without latency, each gradient is sent as soon as it is ready.
+        tensors = [torch.empty([100], dtype=torch.float) for _ in range(4)]
+        result = dist._compute_bucket_assignment_by_timing(
+            tensors, [0, 1000, 2000, 3000], latency=0, time_per_byte=1)
+        self.assertEqual([[0], [1], [2], [3]], result)
+
+    def test_timing_late_gradients(self):
+        # The first two gradients are ready long before the last two, they
+        # are sent together while the others are computed.
+        tensors = [torch.empty([100], dtype=torch.float) for _ in range(4)]
+        result = dist._compute_bucket_assignment_by_timing(
+            tensors, [0, 1, 1000, 1001], latency=100, time_per_byte=0.1)
+        self.assertEqual([[0, 1], [2, 3]], result)
+
+    def test_timing_multi_dtype_and_indices(self):
+        tensors = [
+            torch.empty([50], dtype=torch.float),
+            torch.empty([25], dtype=torch.double),
+            torch.empty([50], dtype=torch.float),
+            torch.empty([25], dtype=torch.double),
+        ]
+        result = dist._compute_bucket_assignment_by_timing(
+            tensors, [0, 1, 2, 3], latency=1e6, time_per_byte=0,
+            expect_sparse_gradient=[False, False, False, True],
+            tensor_indices=[3, 2, 1, 0])
+        self.assertEqual([[3], [1], [2, 0]], result)
+
     def test_single_limit_single_dtype(self):
         tensors = [
             torch.empty([100], dtype=torch.float),
@@ -3813,6 +4088,146 @@ class CommTest(MultiProcessTestCase):
         device = torch.device("cpu")
         self._test_broadcast_coalesced(process_group, device)
 
+    def _mixed_dtype_tensors(self, device):
+        # Mixed types and sizes, with a non-contiguous tensor.
+        return [
+            torch.full((3,), self.rank + 1, dtype=torch.float32, device=device),
+            torch.full((2, 2), self.rank + 1, dtype=torch.float16, device=device),
+            torch.full((4, 2), self.rank + 1, dtype=torch.float32, device=device).t(),
+            torch.full((1,), self.rank + 1, dtype=torch.int64, device=device),
+            torch.full((0,), self.rank + 1, dtype=torch.float32, device=device),
+        ]
+
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_allreduce_coalesced_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device = torch.device("cuda:%d" % self.rank)
+
+        tensors = self._mixed_dtype_tensors(device)
+        opts = c10d.AllreduceCoalescedOptions()
+        opts.reduceOp = c10d.ReduceOp.SUM
+        process_group.allreduce_coalesced(tensors, opts).wait()
+        expected = sum(range(1, self.world_size + 1))
+        for tensor in tensors:
+            self.assertEqual(tensor, torch.full_like(tensor, expected))
+
+        tensors = self._mixed_dtype_tensors(device)
+        opts.reduceOp = c10d.ReduceOp.MAX
+        process_group.allreduce_coalesced(tensors, opts).wait()
+        for tensor in tensors:
+            self.assertEqual(tensor, torch.full_like(tensor, self.world_size))
+
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_allreduce_coalesced_checks_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        with self.assertRaisesRegex(RuntimeError, "Tensor list must be nonempty"):
+            process_group.allreduce_coalesced([])
+        with self.assertRaisesRegex(RuntimeError, "Tensors must be CUDA and dense"):
+            process_group.allreduce_coalesced([torch.zeros(1)])
+        with self.assertRaisesRegex(RuntimeError, "Tensors must be on the same GPU device"):
+            process_group.allreduce_coalesced(
+                [torch.zeros(1, device="cuda:0"), torch.zeros(1, device="cuda:1")])
+
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_allgather_base_and_reduce_scatter_base_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device = torch.device("cuda:%d" % self.rank)
+
+        input = torch.full((3,), float(self.rank), device=device)
+        output = torch.empty(3 * self.world_size, device=device)
+        c10d._all_gather_base(output, input, process_group)
+        expected = torch.arange(self.world_size, dtype=torch.float, device=device)
+        self.assertEqual(expected.repeat_interleave(3), output)
+
+        input = torch.arange(3 * self.world_size, dtype=torch.float, device=device) * (self.rank + 1)
+        output = torch.empty(3, device=device)
+        c10d._reduce_scatter_base(output, input, group=process_group)
+        expected = torch.arange(3 * self.rank, 3 * (self.rank + 1), dtype=torch.float, device=device)
+        self.assertEqual(expected * sum(range(1, self.world_size + 1)), output)
+
+        with self.assertRaisesRegex(RuntimeError, "Buffer sizes do not match the world size"):
+            process_group._allgather_base(output, output)
+        with self.assertRaisesRegex(RuntimeError, "identical type"):
+            process_group._reduce_scatter_base(output.long(), input)
+
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_allgather_coalesced_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device = torch.device("cuda:%d" % self.rank)
+
+        inputs = self._mixed_dtype_tensors(device)
+        outputs = [
+            [torch.empty_like(tensor) for tensor in inputs]
+            for _ in range(self.world_size)
+        ]
+        c10d.all_gather_coalesced(outputs, inputs, process_group)
+        for rank, output_list in enumerate(outputs):
+            for tensor in output_list:
+                self.assertEqual(tensor, torch.full_like(tensor, rank + 1))
+
+        with self.assertRaisesRegex(RuntimeError, "one output tensor list per rank"):
+            process_group.allgather_coalesced(outputs[:1], inputs)
+        outputs[0][1] = torch.empty(2, 2, device=device)
+        with self.assertRaisesRegex(RuntimeError, "with the type and size of their input tensor"):
+            process_group.allgather_coalesced(outputs, inputs)
+
+
+class HierarchicalAllreduceTest(MultiProcessTestCase):
+    def setUp(self):
+        super(HierarchicalAllreduceTest, self).setUp()
+        # Two nodes of two GPUs.
+        os.environ["NCCL_HIERARCHICAL_ALLREDUCE"] = "2"
+        os.environ["NCCL_HIERARCHICAL_ALLREDUCE_MIN_BYTES"] = "0"
+        self._fork_processes()
+
+    def tearDown(self):
+        super(HierarchicalAllreduceTest, self).tearDown()
+        os.environ.pop("NCCL_HIERARCHICAL_ALLREDUCE", None)
+        os.environ.pop("NCCL_HIERARCHICAL_ALLREDUCE_MIN_BYTES", None)
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 4
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(4)
+    def test_hierarchical_allreduce_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device = torch.device("cuda", self.rank)
+
+        # An even number of elements takes the hierarchical path, an odd one
+        # the flat allreduce.
+        for numel in (2, 1000, 1001):
+            for op, expected in (
+                (c10d.ReduceOp.SUM, sum(range(1, self.world_size + 1))),
+                (c10d.ReduceOp.MAX, self.world_size),
+                (c10d.ReduceOp.MIN, 1),
+            ):
+                tensor = torch.full((numel,), float(self.rank + 1), device=device)
+                opts = c10d.AllreduceOptions()
+                opts.reduceOp = op
+                process_group.allreduce([tensor], opts).wait()
+                self.assertEqual(tensor, torch.full((numel,), float(expected), device=device))
+
+        # The future holds the reduced tensor.
+        tensor = torch.arange(8, dtype=torch.float, device=device) * (self.rank + 1)
+        result = process_group.allreduce([tensor]).get_future().wait()
+        self.assertEqual(result[0], torch.arange(8, dtype=torch.float, device=device) * 10)
+
 
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
@@ -198,6 +198,33 @@ class TestAsync(JitTestCase):
         self.assertEqual(y2, foo2(x1, x2))
         self.assertEqual(y3, foo3(x1, x2, x3))
 
+    def test_async_script_many_small_forks(self):
+        # More forks than inter-op threads: the ones forked while every
+        # thread is busy run inline, including the nested ones and the ones
+        # that wait on a fork that is still running.
+        @torch.jit.script
+        def small(x):
+            return x + 1
+
+        @torch.jit.script
+        def nested(x):
+            fut = torch.jit._fork(small, x)
+            return torch.jit._wait(fut) * 2
+
+        @torch.jit.script
+        def wait_script(x):
+            futs = []
+            for i in range(200):
+                futs.append(torch.jit._fork(small, x + i))
+                futs.append(torch.jit._fork(nested, x + i))
+            return [torch.jit._wait(fut) for fut in futs]
+
+        x = torch.rand(3)
+        results = wait_script(x)
+        for i in range(200):
+            self.assertEqual(results[2 * i], x + i + 1)
+            self.assertEqual(results[2 * i + 1], (x + i + 1) * 2)
+
     def test_async_kwargs(self):
         def foo(x1, x2):
             return 2 * x1 + x2
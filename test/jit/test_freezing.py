@@ -1,5 +1,6 @@
 import torch
 import torch.nn as nn
+import torch.nn.functional as F
 from torch.testing._internal.jit_utils import JitTestCase
 
 from torch.testing import FileCheck
@@ -9,6 +10,7 @@ from torch.testing._internal.common_quantization import skipIfNoFBGEMM
 from torch.jit._recursive import wrap_cpp_module
 
 import io
+import unittest
 
 if __name__ == '__main__':
     raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
@@ -1080,3 +1082,52 @@ class TestFreezing(JitTestCase):
             # It used to segfault while running frozen module.
             m_frozen_res = m_frozen(data)
             self.assertEqual(m_res, m_frozen_res)
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_prepack_cpu_weights(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv = nn.Conv2d(3, 8, 3, padding=1)
+                self.linear = nn.Linear(8, 4)
+
+            def forward(self, x):
+                x = torch.relu(self.conv(x))
+                return self.linear(x.permute(0, 2, 3, 1))
+
+        m = torch.jit.script(Net().eval())
+        fm = wrap_cpp_module(torch._C._freeze_module(m._c))
+        data = torch.randn(2, 3, 6, 6)
+        expected = fm(data)
+        torch._C._jit_pass_prepack_cpu_weights(fm._c)
+        FileCheck().check_not("aten::conv2d").check("aten::mkldnn_convolution") \
+                   .check("aten::linear").run(fm.graph)
+        with torch.no_grad():
+            self.assertEqual(fm(data), expected)
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_propagate_mkldnn_layout(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.bn = nn.BatchNorm2d(8)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1)
+
+            def forward(self, x):
+                x = F.relu(self.bn(self.conv1(x)))
+                x = F.max_pool2d(self.conv2(x), 2)
+                return F.adaptive_avg_pool2d(x, (1, 1)).flatten(1)
+
+        m = torch.jit.script(Net().eval())
+        fm = wrap_cpp_module(torch._C._freeze_module(m._c))
+        data = torch.randn(2, 3, 8, 8)
+        expected = fm(data)
+        torch._C._jit_pass_prepack_cpu_weights(fm._c)
+        torch._C._jit_pass_propagate_mkldnn_layout(fm._c)
+        FileCheck().check_count("aten::to_mkldnn", 1, exactly=True) \
+                   .check("aten::native_batch_norm") \
+                   .check_count("aten::to_dense", 1, exactly=True) \
+                   .check("aten::flatten").run(fm.graph)
+        with torch.no_grad():
+            self.assertEqual(fm(data), expected)
@@ -0,0 +1,56 @@
+import os
+import sys
+
+import torch
+from torch.testing import FileCheck
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+def pointwise_chain(x, y):
+    a = torch.sigmoid(x)
+    b = torch.tanh(a)
+    c = torch.mm(b, y)
+    d = torch.relu(c)
+    return torch.exp(d) + b
+
+class TestMemoryReuse(JitTestCase):
+    def test_reuse_dead_intermediates(self):
+        x = torch.randn(3, 4)
+        y = torch.randn(4, 4)
+        traced = torch.jit.trace(pointwise_chain, (x, y))
+        self.run_pass('reuse_intermediate_buffers', traced.graph)
+        # the input of relu is dead, so it is computed in place
+        FileCheck().check("aten::relu_").run(traced.graph)
+        # tanh writes into the storage of sigmoid, its own dead input
+        sigmoid = traced.graph.findNode("aten::sigmoid")
+        tanh = traced.graph.findNode("aten::tanh")
+        self.assertEqual(len(list(tanh.inputs())), 2)
+        self.assertTrue(list(tanh.inputs())[1] is sigmoid.output())
+        with torch.no_grad():
+            self.assertEqual(traced(x, y), pointwise_chain(x, y))
+
+    def test_no_reuse_of_live_or_grad_values(self):
+        def fn(x):
+            a = torch.sigmoid(x)
+            b = torch.tanh(a)
+            return a, b
+
+        x = torch.randn(3, 4)
+        traced = torch.jit.trace(fn, (x,))
+        self.run_pass('reuse_intermediate_buffers', traced.graph)
+        # a is returned, its storage must not be overwritten
+        tanh = traced.graph.findNode("aten::tanh")
+        self.assertEqual(len(list(tanh.inputs())), 1)
+
+        x = torch.randn(3, 4, requires_grad=True)
+        traced = torch.jit.trace(pointwise_chain, (x, torch.randn(4, 4)))
+        self.run_pass('reuse_intermediate_buffers', traced.graph)
+        FileCheck().check_not("aten::relu_").run(traced.graph)
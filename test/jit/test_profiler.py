@@ -28,6 +28,36 @@ class TestProfiler(JitTestCase):
         torch._C._debug_set_autodiff_subgraph_inlining(self.inline_autodiff)
         torch._C._jit_set_texpr_fuser_enabled(self.texpr_fuser_state)
 
+    def test_plan_cache(self):
+        def test_fn(a, b):
+            return a * b + b
+
+        test_fn.__disable_jit_function_caching__ = True
+
+        scripted_f = torch.jit.script(test_fn)
+        old_capacity = torch._C._jit_set_plan_cache_capacity(2)
+        try:
+            shapes = [[2, 3], [4, 3]]
+            for _ in range(3):
+                for shape in shapes:
+                    x = torch.randn(shape)
+                    y = torch.randn(shape)
+                    self.assertEqual(scripted_f(x, y), test_fn(x, y))
+            state = scripted_f.get_debug_state()
+            self.assertEqual(state.plan_cache_misses, 2)
+            self.assertEqual(state.plan_cache_hits, 4)
+            self.assertEqual(state.plan_cache_evictions, 0)
+
+            # a third shape evicts the least recently used plan
+            x = torch.randn(5, 3)
+            self.assertEqual(scripted_f(x, x), test_fn(x, x))
+            state = scripted_f.get_debug_state()
+            self.assertEqual(state.plan_cache_misses, 3)
+            self.assertEqual(state.plan_cache_evictions, 1)
+            self.assertEqual(state.plan_cache_size, 2)
+        finally:
+            torch._C._jit_set_plan_cache_capacity(old_capacity)
+
     def test_specialize_backward(self):
         def test_fuse(a, b):
             c = a * b
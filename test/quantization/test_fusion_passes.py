@@ -3,6 +3,7 @@
 import torch
 from torch.testing import FileCheck
 from torch.testing._internal.common_quantization import QuantizationTestCase
+from torch.testing._internal.common_quantized import override_qengines
 
 class TestFusionPasses(QuantizationTestCase):
     def test_quantized_add_relu_fusion(self):
@@ -117,3 +118,79 @@ class TestFusionPasses(QuantizationTestCase):
                    .run(scripted_m.graph)
         output = scripted_m(qA, 3., qC)
         self.assertEqual(ref_output, output)
+
+    @override_qengines
+    def test_quantized_conv_add_fusion(self):
+        class MConvAdd(torch.nn.Module):
+            def __init__(self):
+                super(MConvAdd, self).__init__()
+                w = torch.randn(4, 2, 3, 3)
+                qw = torch.quantize_per_tensor(w, 0.05, 0, torch.qint8)
+                self.packed = torch.ops.quantized.conv2d_prepack(
+                    qw, torch.randn(4), [1, 1], [1, 1], [1, 1], 1)
+
+            def forward(self, x, y):
+                c = torch.ops.quantized.conv2d(x, self.packed, 0.2, 120)
+                return torch.ops.quantized.add(c, y, 0.3, 110)
+
+        class MConvAddRelu(MConvAdd):
+            def forward(self, x, y):
+                c = torch.ops.quantized.conv2d(x, self.packed, 0.2, 120)
+                return torch.ops.quantized.add_relu(y, c, 0.3, 110)
+
+        qX = torch.quantize_per_tensor(torch.randn(1, 2, 5, 5), 0.1, 128,
+                                       torch.quint8)
+        qY = torch.quantize_per_tensor(torch.randn(1, 4, 5, 5), 0.1, 128,
+                                       torch.quint8)
+        for m, fused in [(MConvAdd(), "quantized::conv2d_add("),
+                         (MConvAddRelu(), "quantized::conv2d_add_relu(")]:
+            scripted_m = torch.jit.script(m)
+            ref_output = scripted_m(qX, qY)
+            torch._C._jit_pass_fuse_quantized_conv_add(scripted_m.graph)
+            FileCheck().check_not("quantized::conv2d(") \
+                       .check(fused) \
+                       .check_not("quantized::add") \
+                       .run(scripted_m.graph)
+            output = scripted_m(qX, qY)
+            self.assertEqual(ref_output, output)
+
+    def test_requantize_chain_fusion(self):
+        class MRequantize(torch.nn.Module):
+            def __init__(self):
+                super(MRequantize, self).__init__()
+
+            def forward(self, x):
+                q = torch.quantize_per_tensor(x, 0.1, 3, torch.quint8)
+                # quantizes with the parameters q already has
+                q = torch.quantize_per_tensor(q.dequantize(), 0.1, 3, torch.quint8)
+                q = torch.quantize_per_tensor(q.dequantize(), 0.2, 5, torch.qint8)
+                return q
+
+        X = torch.randn(4, 5) * 3
+        m = MRequantize()
+        scripted_m = torch.jit.script(m)
+        ref_output = scripted_m(X)
+        torch._C._jit_pass_fuse_requantize_chains(scripted_m.graph)
+        FileCheck().check_count("aten::quantize_per_tensor", 1, exactly=True) \
+                   .check_not("aten::dequantize") \
+                   .check_count("quantized::requantize", 1, exactly=True) \
+                   .run(scripted_m.graph)
+        self.assertEqual(torch._C._jit_count_dequantize_uses(scripted_m.graph), {})
+        output = scripted_m(X)
+        self.assertEqual(ref_output.q_scale(), output.q_scale())
+        self.assertEqual(ref_output.dequantize(), output.dequantize(),
+                         atol=output.q_scale(), rtol=0)
+
+    def test_count_dequantize_uses(self):
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+
+            def forward(self, x):
+                q = torch.quantize_per_tensor(x, 0.1, 3, torch.quint8)
+                x = q.dequantize()
+                return torch.exp(x) + torch.log(x) + torch.exp(x)
+
+        scripted_m = torch.jit.script(M())
+        counts = torch._C._jit_count_dequantize_uses(scripted_m.graph)
+        self.assertEqual(counts, {"aten::exp": 2, "aten::log": 1})
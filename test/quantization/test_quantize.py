@@ -792,10 +792,6 @@ class TestPostTrainingDynamic(QuantizationTestCase):
                              [-155, 100],
                              [100, -155]], dtype=torch.float)
 
-            if torch.backends.quantized.engine == 'qnnpack' and dtype == torch.float16:
-                continue
-                # fp16 dynamic quant is not supported for qnnpack
-
             if dtype == torch.float16:
                 model_quantized = quantize_dynamic(model=model, dtype=dtype)
             else:
@@ -2525,6 +2525,7 @@ class TestQuantizeJitOps(QuantizationTestCase):
                 x = torch.tanh(x)
                 x = x.tanh()
                 x.tanh_()
+                x = torch.softmax(x, 1)
                 x = self.conv(x)
                 return x
 
@@ -2551,7 +2552,7 @@ class TestQuantizeJitOps(QuantizationTestCase):
         # mapping from number of quant for the op to the number of these ops
         # for example, for `3` in the key means for this type of op
         # we'll have 3 quantize_per_tensor
-        num_op_by_num_quant = {1: 32, 2: 2, 3: 3}
+        num_op_by_num_quant = {1: 33, 2: 2, 3: 3}
         num_quantize_per_tensor = 1  # for output
         for num_quant, num_op in num_op_by_num_quant.items():
             num_quantize_per_tensor += num_op * num_quant
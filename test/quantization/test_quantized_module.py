@@ -829,48 +829,135 @@ class TestDynamicQuantizedModule(QuantizationTestCase):
                 bias_keys.append(key_name1)
                 bias_keys.append(key_name2)
 
-        if not (dtype == torch.float16 and torch.backends.quantized.engine == "qnnpack"):
-            # fp16 dynamic quant is not supported for qnnpack
-            x = torch.randn(seq_len, batch, input_size)
-            h = torch.randn(num_layers * (bidirectional + 1), batch, hidden_size)
-            c = torch.randn(num_layers * (bidirectional + 1), batch, hidden_size)
-            cell_dq = torch.nn.quantized.dynamic.LSTM(input_size=input_size,
-                                                      hidden_size=hidden_size,
-                                                      num_layers=num_layers,
-                                                      bias=bias,
-                                                      batch_first=False,
-                                                      dropout=0.0,
-                                                      bidirectional=bidirectional,
-                                                      dtype=dtype)
-            ref_dq = torch.nn.quantized.dynamic.LSTM(input_size=input_size,
-                                                     hidden_size=hidden_size,
-                                                     num_layers=num_layers,
-                                                     bias=bias,
-                                                     batch_first=False,
-                                                     dropout=0.0,
-                                                     bidirectional=bidirectional,
-                                                     dtype=dtype)
-
-            _all_params = ([m.param for m in cell_dq._all_weight_values])
-            result = torch.quantized_lstm(x, (h, c),
-                                          _all_params,
-                                          cell_dq.bias,
-                                          cell_dq.num_layers,
-                                          float(cell_dq.dropout),
-                                          False,
-                                          bidirectional,
-                                          False,
-                                          dtype=dtype,
-                                          use_dynamic=True)
-
-
-            y, (h, c) = cell_dq(x, (h, c))
-            self.assertEqual(result[0], y)
-            self.assertEqual(result[1], h)
-            self.assertEqual(result[2], c)
-            x = torch.randn(10, 20, 3)
-            self.check_eager_serialization(cell_dq, ref_dq, [x])
-            self.check_weight_bias_api(cell_dq, weight_keys, bias_keys)
+        x = torch.randn(seq_len, batch, input_size)
+        h = torch.randn(num_layers * (bidirectional + 1), batch, hidden_size)
+        c = torch.randn(num_layers * (bidirectional + 1), batch, hidden_size)
+        cell_dq = torch.nn.quantized.dynamic.LSTM(input_size=input_size,
+                                                  hidden_size=hidden_size,
+                                                  num_layers=num_layers,
+                                                  bias=bias,
+                                                  batch_first=False,
+                                                  dropout=0.0,
+                                                  bidirectional=bidirectional,
+                                                  dtype=dtype)
+        ref_dq = torch.nn.quantized.dynamic.LSTM(input_size=input_size,
+                                                 hidden_size=hidden_size,
+                                                 num_layers=num_layers,
+                                                 bias=bias,
+                                                 batch_first=False,
+                                                 dropout=0.0,
+                                                 bidirectional=bidirectional,
+                                                 dtype=dtype)
+
+        _all_params = ([m.param for m in cell_dq._all_weight_values])
+        result = torch.quantized_lstm(x, (h, c),
+                                      _all_params,
+                                      cell_dq.bias,
+                                      cell_dq.num_layers,
+                                      float(cell_dq.dropout),
+                                      False,
+                                      bidirectional,
+                                      False,
+                                      dtype=dtype,
+                                      use_dynamic=True)
+
+
+        y, (h, c) = cell_dq(x, (h, c))
+        self.assertEqual(result[0], y)
+        self.assertEqual(result[1], h)
+        self.assertEqual(result[2], c)
+        x = torch.randn(10, 20, 3)
+        self.check_eager_serialization(cell_dq, ref_dq, [x])
+        self.check_weight_bias_api(cell_dq, weight_keys, bias_keys)
+
+    @given(
+        dtype=st.sampled_from([torch.qint8, torch.float16]),
+        bidirectional=st.booleans(),
+    )
+    @override_qengines
+    def test_gru_api(self, dtype, bidirectional):
+        r"""Test execution and serialization for dynamic quantized gru modules on int8 and fp16
+        """
+        seq_len = 4
+        batch = 2
+        input_size = 3
+        hidden_size = 7
+        num_layers = 2
+        kwargs = {'input_size': input_size, 'hidden_size': hidden_size, 'num_layers': num_layers,
+                  'bias': True, 'batch_first': False, 'dropout': 0.0,
+                  'bidirectional': bidirectional, 'dtype': dtype}
+        x = torch.randn(seq_len, batch, input_size)
+        h = torch.randn(num_layers * (bidirectional + 1), batch, hidden_size)
+        cell_dq = nnqd.GRU(**kwargs)
+        _all_params = ([m.param for m in cell_dq._all_weight_values])
+        result = torch.quantized_gru(x, h, _all_params, cell_dq.bias, cell_dq.num_layers,
+                                     float(cell_dq.dropout), False, bidirectional, False)
+        y, h_out = cell_dq(x, h)
+        self.assertEqual(result[0], y)
+        self.assertEqual(result[1], h_out)
+
+        packed = torch.nn.utils.rnn.pack_padded_sequence(x, [seq_len, seq_len - 1])
+        result = torch.quantized_gru(packed.data, packed.batch_sizes, h, _all_params, cell_dq.bias,
+                                     cell_dq.num_layers, float(cell_dq.dropout), False, bidirectional)
+        y_packed, h_out = cell_dq(packed, h)
+        self.assertEqual(result[0], y_packed.data)
+        self.assertEqual(result[1], h_out)
+
+        self.check_eager_serialization(cell_dq, nnqd.GRU(**kwargs), [x])
+
+        # close to the float module it is converted from
+        float_gru = torch.nn.GRU(input_size, hidden_size, num_layers, bidirectional=bidirectional)
+        float_gru.qconfig = torch.quantization.default_dynamic_qconfig if dtype == torch.qint8 \
+            else torch.quantization.float16_dynamic_qconfig
+        qgru = nnqd.GRU.from_float(float_gru)
+        ref, ref_h = float_gru(x, h)
+        y, h_out = qgru(x, h)
+        self.assertEqual(y, ref, atol=0.05, rtol=0)
+        self.assertEqual(h_out, ref_h, atol=0.05, rtol=0)
+
+    @given(
+        dtype=st.sampled_from([torch.qint8, torch.float16]),
+        add_bias_kv=st.booleans(),
+    )
+    @override_qengines
+    def test_multihead_attention_api(self, dtype, add_bias_kv):
+        r"""Test dynamic quantized multi-head attention against the float module for
+        self-attention, encoder-decoder attention and distinct keys and values
+        """
+        embed_dim = 16
+        num_heads = 4
+        tgt_len = 5
+        src_len = 6
+        batch = 3
+        mha = torch.nn.MultiheadAttention(embed_dim, num_heads, add_bias_kv=add_bias_kv)
+        mha.eval()
+        mha.qconfig = torch.quantization.default_dynamic_qconfig if dtype == torch.qint8 \
+            else torch.quantization.float16_dynamic_qconfig
+        qmha = nnqd.MultiheadAttention.from_float(mha)
+
+        x = torch.randn(tgt_len, batch, embed_dim)
+        memory = torch.randn(src_len, batch, embed_dim)
+        value = torch.randn(src_len, batch, embed_dim)
+        key_padding_mask = torch.zeros(batch, src_len, dtype=torch.bool)
+        key_padding_mask[0, -1] = True
+        attn_mask = torch.zeros(tgt_len, tgt_len, dtype=torch.bool)
+        attn_mask[0, 1:] = True
+        cases = [
+            ((x, x, x), {'attn_mask': attn_mask}),
+            ((x, memory, memory), {'key_padding_mask': key_padding_mask}),
+            ((x, memory, value), {}),
+        ]
+        for args, kwargs in cases:
+            ref, ref_weights = mha(*args, **kwargs)
+            out, weights = qmha(*args, **kwargs)
+            self.assertEqual(out, ref, atol=0.05, rtol=0)
+            self.assertEqual(weights, ref_weights, atol=0.05, rtol=0)
+
+        # the module is swapped by quantize_dynamic when asked for
+        model = torch.nn.Sequential(mha)
+        quantized = torch.quantization.quantize_dynamic(
+            model, {torch.nn.MultiheadAttention}, dtype=dtype)
+        self.assertEqual(type(quantized[0]), nnqd.MultiheadAttention)
 
     @given(
         dtype=st.sampled_from([torch.qint8, torch.float16]),
@@ -904,25 +991,23 @@ class TestDynamicQuantizedModule(QuantizationTestCase):
                     'RNNReLU': torch.ops.quantized.quantized_rnn_relu_cell_dynamic}
 
         for rnn_type in cell_dict.keys():
-            if not (dtype == torch.float16 and torch.backends.quantized.engine == "qnnpack"):
-                # fp16 dynamic quant is not supported for qnnpack
-                kwargs = {'input_size': input_size, 'hidden_size': hidden_size, 'bias': bias, 'dtype': dtype}
-                if rnn_type == 'RNNReLU':
-                    kwargs['nonlinearity'] = "relu"
-                elif rnn_type == 'RNNTanh':
-                    kwargs['nonlinearity'] = "tanh"
-
-                cell_dq = cell_dict[rnn_type](**kwargs)
-                result = qfn_dict[rnn_type](x, state[rnn_type],
-                                            cell_dq._packed_weight_ih, cell_dq._packed_weight_hh,
-                                            cell_dq.bias_ih, cell_dq.bias_hh)
-                result_module = cell_dq(x, state[rnn_type])
-                self.assertEqual(result[0], result_module[0], msg="RNNCell module API failed")
-                self.assertEqual(result[1], result_module[1], msg="RNNCell module API failed")
-                weight_keys = ['weight_ih', 'weight_hh']
-                bias_keys = ['bias_ih', 'bias_hh']
-                self.check_eager_serialization(cell_dq, cell_dict[rnn_type](**kwargs), [x])
-                self.check_weight_bias_api(cell_dq, weight_keys, bias_keys)
+            kwargs = {'input_size': input_size, 'hidden_size': hidden_size, 'bias': bias, 'dtype': dtype}
+            if rnn_type == 'RNNReLU':
+                kwargs['nonlinearity'] = "relu"
+            elif rnn_type == 'RNNTanh':
+                kwargs['nonlinearity'] = "tanh"
+
+            cell_dq = cell_dict[rnn_type](**kwargs)
+            result = qfn_dict[rnn_type](x, state[rnn_type],
+                                        cell_dq._packed_weight_ih, cell_dq._packed_weight_hh,
+                                        cell_dq.bias_ih, cell_dq.bias_hh)
+            result_module = cell_dq(x, state[rnn_type])
+            self.assertEqual(result[0], result_module[0], msg="RNNCell module API failed")
+            self.assertEqual(result[1], result_module[1], msg="RNNCell module API failed")
+            weight_keys = ['weight_ih', 'weight_hh']
+            bias_keys = ['bias_ih', 'bias_hh']
+            self.check_eager_serialization(cell_dq, cell_dict[rnn_type](**kwargs), [x])
+            self.check_weight_bias_api(cell_dq, weight_keys, bias_keys)
 
     @given(
         num_embeddings=st.integers(10, 50),
@@ -262,6 +262,49 @@ class TestQuantizedOps(TestCase):
         ]
         self._test_activation_function(X, 'sigmoid', sigmoid_test_configs)
 
+    """Tests the correctness of the quantized softmax op."""
+    @given(X=hu.tensor(shapes=hu.array_shapes(1, 4, 1, 8),
+                       qparams=hu.qparams(dtypes=[torch.quint8, torch.qint8])),
+           dim=st.integers(-4, 3))
+    def test_qsoftmax(self, X, dim):
+        X, (scale, zero_point, torch_type) = X
+        assume(-X.ndim <= dim < X.ndim)
+        X = torch.from_numpy(X)
+        qX = torch.quantize_per_tensor(X, scale=scale, zero_point=zero_point,
+                                       dtype=torch_type)
+        output_zero_point = -128 if torch_type == torch.qint8 else 0
+        dqY_ref = torch.softmax(qX.dequantize(), dim)
+        qY_ref = torch.quantize_per_tensor(dqY_ref, scale=1.0 / 256,
+                                           zero_point=output_zero_point,
+                                           dtype=torch_type)
+        qY = torch.softmax(qX, dim)
+        self.assertEqual(qY.q_scale(), 1.0 / 256)
+        self.assertEqual(qY.q_zero_point(), output_zero_point)
+        # The exponents are read from a table, allow one off rounding
+        diff = (qY.int_repr().to(torch.int) - qY_ref.int_repr().to(torch.int)).abs()
+        self.assertLessEqual(diff.max().item(), 1)
+
+    """Tests the correctness of the quantized::requantize op."""
+    @given(X=hu.tensor(shapes=hu.array_shapes(1, 5, 1, 5),
+                       qparams=hu.qparams()),
+           output_qparams=hu.qparams())
+    def test_qrequantize(self, X, output_qparams):
+        X, (scale, zero_point, torch_type) = X
+        output_scale, output_zero_point, output_type = output_qparams
+        X = torch.from_numpy(X)
+        qX = torch.quantize_per_tensor(X, scale=scale, zero_point=zero_point,
+                                       dtype=torch_type)
+        qY_ref = torch.quantize_per_tensor(qX.dequantize(), output_scale,
+                                           output_zero_point, output_type)
+        qY = torch.ops.quantized.requantize(qX, output_scale, output_zero_point,
+                                            output_type)
+        self.assertEqual(qY.dtype, output_type)
+        self.assertEqual(qY.q_scale(), qY_ref.q_scale())
+        self.assertEqual(qY.q_zero_point(), output_zero_point)
+        # quantize_per_tensor may multiply by the inverse scale, allow one off rounding
+        diff = (qY.int_repr().to(torch.long) - qY_ref.int_repr().to(torch.long)).abs()
+        self.assertLessEqual(diff.max().item(), 1)
+
     """Tests the correctness of the quantized::hardsigmoid op."""
     @override_qengines
     @given(X=hu.tensor(shapes=hu.array_shapes(1, 5, 1, 5),
@@ -849,6 +892,36 @@ class TestQuantizedOps(TestCase):
             self.assertEqual(qCrelu_hat, qCrelu_out_hat,
                              msg="mulReLU.out failed")
 
+    """Tests the correctness of the add and add_relu op with broadcasting."""
+    @override_qengines
+    def test_qadd_broadcast(self):
+        A = torch.randn(8, 1, 6, 1)
+        B = torch.randn(7, 1, 5)
+        scale_A, zero_point_A = 0.03, 7
+        scale_B, zero_point_B = 0.05, 127
+        scale_C, zero_point_C = 0.1, 5
+
+        qA = torch.quantize_per_tensor(A, scale=scale_A, zero_point=zero_point_A,
+                                       dtype=torch.quint8)
+        qB = torch.quantize_per_tensor(B, scale=scale_B, zero_point=zero_point_B,
+                                       dtype=torch.quint8)
+
+        C = qA.dequantize() + qB.dequantize()
+        for op, ref in [(torch.ops.quantized.add, C),
+                        (torch.ops.quantized.add_relu, torch.relu(C))]:
+            qC = _quantize(ref.numpy(), scale_C, zero_point_C)
+            qC_hat = op(qA, qB, scale=scale_C, zero_point=zero_point_C)
+            self.assertEqual(qC_hat.shape, torch.Size([8, 7, 6, 5]))
+            np.testing.assert_equal(qC, qC_hat.int_repr(),
+                                    "Quantized addition with broadcasting failed.")
+
+            qC_out = torch._empty_affine_quantized(
+                [8, 7, 6, 5], scale=scale_C, zero_point=zero_point_C,
+                dtype=torch.quint8)
+            op(qA, qB, out=qC_out)
+            np.testing.assert_equal(qC, qC_out.int_repr(),
+                                    "Quantized addition with broadcasting failed.")
+
     """Tests the correctness of the mul and mul_relu op."""
     def test_qmul_broadcast(self):
         mul_relu = torch.ops.quantized.mul_relu
@@ -2382,10 +2455,6 @@ class TestDynamicQuantizedRNNOp(TestCase):
 
         for rnn_type in ['LSTM', 'GRU']:
             for dtype in [torch.qint8, torch.float16]:
-                # Fp16 quantization is not supported for qnnpack
-                if torch.backends.quantized.engine == 'qnnpack' and dtype == torch.float16:
-                    continue
-
                 Xq, Hq, Cq = self._get_rnn_inputs(seq_len, num_batches, input_size, hidden_size, num_directions)
                 Wq1, Wq2, b1, b2 = self._get_rnn_weights_and_bias(input_size,
                                                                   hidden_size,
@@ -2511,10 +2580,6 @@ class TestDynamicQuantizedRNNOp(TestCase):
 
         for rnn_type in ['LSTMCell', 'GRUCell', 'RNNTanh', 'RNNReLU']:
             for dtype in [torch.qint8, torch.float16]:
-                # Fp16 quantization is not supported for qnnpack
-                if torch.backends.quantized.engine == 'qnnpack' and dtype == torch.float16:
-                    continue
-
                 Xq, Hq, Cq = self._get_rnn_inputs(seq_len, num_batches, input_size, hidden_size, 1)
                 Wq1, Wq2, b1, b2 = self._get_rnn_weights_and_bias(input_size, hidden_size, 1, per_channel_quant, rnn_type)
                 if dtype == torch.qint8:
@@ -2882,6 +2947,20 @@ class TestQuantizedEmbeddingBag(TestCase):
         torch.testing.assert_allclose(reference_result, result, atol=atol,
                                       rtol=rtol)
 
+        if torch.cuda.is_available():
+            # The CUDA operators pack the weight and sum it like the CPU ones
+            q_weights_cuda = pt_prepack_op(weights.cuda())
+            self.assertEqual(q_weights, q_weights_cuda.cpu())
+            result_cuda = pt_op(
+                q_weights_cuda,
+                indices.cuda(),
+                offsets.cuda(),
+                mode=0,
+                per_sample_weights=per_sample_weights.cuda() if enable_per_sample_weights else None,
+                include_last_offset=include_last_offset,
+            )
+            torch.testing.assert_allclose(result, result_cuda.cpu(), atol=1e-5, rtol=1e-5)
+
         if bit_rate == 8:
             # Test operator that accepts TorchBind packed weights.
             from torch.quantization import PerChannelMinMaxObserver
@@ -2900,7 +2979,6 @@ class TestQuantizedEmbeddingBag(TestCase):
 
 
     """ Tests the correctness of the embedding_bag_8bit quantized operator """
-    @skipIfNoFBGEMM
     @given(num_embeddings=st.integers(10, 100),
            embedding_dim=st.integers(5, 50).filter(lambda x: x % 4 == 0),
            num_offsets=st.integers(1, 20),
@@ -3804,6 +3882,31 @@ class TestQNNPackOps(TestCase):
                 qY, qY_hat,
                 msg="hardtanh failed:\nactual {}\nexpected {}".format(qY_hat, qY))
 
+    """Tests the correctness of the quantized::linear_dynamic_fp16 (qnnpack) op."""
+    @given(batch_size=st.integers(1, 4),
+           # the weight is widened in blocks of output channels, a large input
+           # makes the blocks smaller than the output
+           input_channels=st.sampled_from([1, 16, 1100]),
+           output_channels=st.integers(1, 300),
+           use_bias=st.booleans())
+    def test_qnnpack_linear_dynamic_fp16(self, batch_size, input_channels,
+                                         output_channels, use_bias):
+        with override_quantized_engine('qnnpack'):
+            X = torch.randn(batch_size, 3, input_channels)
+            W = torch.randn(output_channels, input_channels)
+            b = torch.randn(output_channels) if use_bias else None
+
+            W_packed = torch.ops.quantized.linear_prepack_fp16(W.clone(), b)
+            Y_hat = torch.ops.quantized.linear_dynamic_fp16(X, W_packed)
+            # The weight is stored in fp16, the math is done in fp32
+            W_ref = W.to(torch.float16).to(torch.float)
+            Y_ref = torch.nn.functional.linear(X, W_ref, b)
+            self.assertEqual(Y_ref, Y_hat, atol=1e-4, rtol=1e-4)
+
+            W_unpacked, b_unpacked = torch.ops.quantized.linear_unpack_fp16(W_packed)
+            self.assertEqual(W_ref, W_unpacked)
+            self.assertEqual(b, b_unpacked)
+
 """Tests the correctness of the tensor comparators."""
 class TestComparatorOps(TestCase):
     """Tests the element-wise equality ops."""
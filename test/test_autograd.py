@@ -2754,6 +2754,36 @@ class TestAutograd(TestCase):
             # Now validate the json
             json.load(f)
 
+    def test_profiler_cupti(self):
+        with self.assertRaisesRegex(ValueError, "can not be combined"):
+            torch.autograd.profiler.profile(use_cuda=True, use_cupti=True)
+        if not torch.autograd._cupti_available():
+            with self.assertRaisesRegex(RuntimeError, "compiled without CUPTI"):
+                with torch.autograd.profiler.profile(use_cupti=True):
+                    pass
+            return
+        if not torch.cuda.is_available():
+            return
+
+        x = torch.randn(64, 64, device="cuda")
+        with torch.autograd.profiler.profile(use_cupti=True) as prof:
+            y = torch.mm(x, x)
+            y.cpu()
+        mm = [evt for evt in prof.function_events if evt.name == "aten::mm"]
+        self.assertEqual(len(mm), 1)
+        self.assertGreater(len(mm[0].kernels), 0)
+        self.assertGreater(mm[0].cuda_time_total, 0)
+        for kernel in mm[0].kernels:
+            self.assertEqual(kernel.device, x.device.index)
+            self.assertLessEqual(mm[0].cpu_interval.start, kernel.interval.start)
+        copies = [k for evt in prof.function_events for k in evt.kernels if k.name == "Memcpy DtoH"]
+        self.assertEqual(len(copies), 1)
+
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+        self.assertTrue(any(e["pid"] == "CUDA functions" for e in trace))
+
     def test_profiler(self):
         x = torch.randn(10, 10)
 
@@ -3150,6 +3180,40 @@ class TestAutograd(TestCase):
             ]
         )
 
+    def test_memory_profile(self):
+        x = torch.rand(100, 100)
+        with profile(profile_memory=True) as prof:
+            del x
+            y = torch.rand(200, 200)
+            z = torch.rand(300, 300)
+            del y
+            w = torch.rand(10, 10)
+        del z, w
+
+        memory = prof.memory_profile()
+        timeline = memory.timeline("cpu")
+        self.assertEqual([t for t, _ in timeline], sorted(t for t, _ in timeline))
+        peak_time, peak_bytes = memory.peak("cpu")
+        self.assertEqual(peak_bytes, max(live for _, live in timeline))
+        self.assertGreaterEqual(peak_bytes, (200 * 200 + 300 * 300) * 4)
+        # the free of x is not tracked, the free of y is
+        self.assertEqual(timeline[-1][1], peak_bytes - 200 * 200 * 4 + 10 * 10 * 4)
+
+        # rand allocates its output through empty
+        stats = memory.op_stats("cpu")
+        self.assertEqual(stats["aten::empty"].allocated, (200 * 200 + 300 * 300 + 10 * 10) * 4)
+        self.assertEqual(stats["aten::empty"].live_at_peak, (200 * 200 + 300 * 300) * 4)
+        self.assertEqual(stats["[no op]"].freed, (100 * 100 + 200 * 200) * 4)
+        self.assertIn("aten::empty", memory.table("cpu", sort_by="allocated"))
+        with self.assertRaisesRegex(ValueError, "sort_by"):
+            memory.table(sort_by="cpu_time")
+        self.assertEqual(memory.timeline("cuda"), [])
+
+        with profile() as prof:
+            pass
+        with self.assertRaisesRegex(RuntimeError, "profile_memory=True"):
+            prof.memory_profile()
+
     def test_record_function(self):
         x = torch.randn(10, 10)
 
@@ -3825,6 +3889,211 @@ for shape in [(1,), ()]:
         self.assertEqual(order.count("Reentrant"), 10)
         self.assertEqual(order[-1], "MyFunction")
 
+    def test_cpu_workers(self):
+        class Reentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x * 2
+
+            @staticmethod
+            def backward(ctx, grad):
+                with torch.enable_grad():
+                    y = torch.ones(3, requires_grad=True)
+                    (y * 3).sum().backward()
+                return grad * 2 + y.grad.sum() * 0
+
+        class Fail(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                raise RuntimeError("failed in backward")
+
+        def towers():
+            x = torch.randn(8, 16, requires_grad=True)
+            out = sum(Reentrant.apply(x[i].exp().sin()).sum() for i in range(8))
+            out.backward()
+            return x.grad
+
+        prev = torch.autograd._get_num_cpu_workers()
+        try:
+            torch.manual_seed(0)
+            torch.autograd._set_num_cpu_workers(0)
+            expected = towers()
+            torch.autograd._set_num_cpu_workers(3)
+            self.assertEqual(torch.autograd._get_num_cpu_workers(), 3)
+            for _ in range(5):
+                torch.manual_seed(0)
+                self.assertEqual(towers(), expected)
+            x = torch.randn(4, requires_grad=True)
+            out = sum(Fail.apply(x[i]) + x[i] * 2 for i in range(4))
+            with self.assertRaisesRegex(RuntimeError, "failed in backward"):
+                out.backward()
+            with self.assertRaisesRegex(RuntimeError, "non-negative"):
+                torch.autograd._set_num_cpu_workers(-1)
+        finally:
+            torch.autograd._set_num_cpu_workers(prev)
+
+    def test_cpu_priority_ordering_disabled(self):
+        class Reentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                with torch.enable_grad():
+                    y = torch.ones(2, requires_grad=True)
+                    (y * 2).sum().backward()
+                return grad * y.grad[0]
+
+        def chain():
+            x = torch.randn(10, requires_grad=True)
+            out = x
+            for i in range(200):
+                out = out * 1.01 + x[i % 10]
+            Reentrant.apply(out).sum().backward()
+            return x.grad
+
+        prev = torch.autograd._get_cpu_priority_ordering()
+        try:
+            torch.manual_seed(0)
+            torch.autograd._set_cpu_priority_ordering(True)
+            expected = chain()
+            torch.autograd._set_cpu_priority_ordering(False)
+            self.assertFalse(torch.autograd._get_cpu_priority_ordering())
+            torch.manual_seed(0)
+            self.assertEqual(chain(), expected)
+        finally:
+            torch.autograd._set_cpu_priority_ordering(prev)
+
+    def test_sampling_profiler(self):
+        from torch.autograd.profiler import (enable_sampling_profiler, disable_sampling_profiler,
+                                             flush_sampling_profiler)
+        x = torch.randn(4, 4)
+        flush_sampling_profiler()
+        enable_sampling_profiler(sampling_prob=1.0, record_shapes=True)
+        try:
+            self.assertTrue(torch.autograd._sampling_profiler_enabled())
+            with self.assertRaisesRegex(RuntimeError, "already enabled"):
+                enable_sampling_profiler()
+            for _ in range(10):
+                torch.add(x, x)
+            with record_function("user_scope"):
+                torch.mm(x, x)
+            t = threading.Thread(target=lambda: torch.add(x, x))
+            t.start()
+            t.join()
+        finally:
+            disable_sampling_profiler()
+        self.assertFalse(torch.autograd._sampling_profiler_enabled())
+        torch.add(x, x)
+
+        stats = {(s.name, s.shapes): s for s in flush_sampling_profiler()}
+        add = stats[("aten::add", "[[4, 4], [4, 4], []]")]
+        self.assertEqual(add.count, 11)
+        self.assertEqual(sum(add.buckets), add.count)
+        self.assertLessEqual(add.min_ns, add.max_ns)
+        self.assertLessEqual(add.max_ns, add.total_ns)
+        scope = next(s for s in stats.values() if s.name == "user_scope")
+        self.assertGreaterEqual(scope.total_ns, stats[("aten::mm", "[[4, 4], [4, 4]]")].total_ns)
+        self.assertEqual(flush_sampling_profiler(), [])
+
+        with self.assertRaisesRegex(RuntimeError, "sampling probability"):
+            enable_sampling_profiler(sampling_prob=0)
+
+    def test_static_backward(self):
+        def run(x, w, branch):
+            out = x
+            for i in range(4):
+                out = (out @ w).tanh() + out
+            if branch:
+                out = out * x.sigmoid()
+            out.sum().backward()
+            grads = x.grad.clone(), w.grad.clone()
+            x.grad = None
+            w.grad = None
+            return grads
+
+        x = torch.randn(3, 3, requires_grad=True)
+        w = torch.randn(3, 3, requires_grad=True)
+        branches = [False, False, True, True, False, True, False]
+        expected = [run(x, w, branch) for branch in branches]
+        prev = torch.autograd._get_static_backward()
+        try:
+            torch.autograd._set_static_backward(True)
+            self.assertTrue(torch.autograd._get_static_backward())
+            for branch, grads in zip(branches, expected):
+                self.assertEqual(run(x, w, branch), grads)
+            # The same graph twice, and a graph with a leaf reached twice
+            y = (x * w).exp()
+            y.sum().backward(retain_graph=True)
+            y.sum().backward()
+            self.assertEqual(x.grad, 2 * w * y)
+            x.grad = None
+            g, = torch.autograd.grad((x * x).sum(), x)
+            self.assertEqual(g, 2 * x)
+        finally:
+            torch.autograd._set_static_backward(prev)
+
+    def test_saved_tensors_hooks(self):
+        packed = []
+        unpacked = []
+
+        def pack(x):
+            y = x.clone()
+            packed.append(y)
+            return (y, x.shape)
+
+        def unpack(p):
+            unpacked.append(p[1])
+            return p[0]
+
+        a = torch.randn(5, requires_grad=True)
+        b = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.saved_tensors_hooks(pack, unpack):
+            y = (a * b).exp()
+        self.assertEqual(len(packed), 3)
+        y.sum().backward(retain_graph=True)
+        self.assertEqual(len(unpacked), 3)
+        self.assertEqual(a.grad, b * y)
+        self.assertEqual(b.grad, a * y)
+        y.sum().backward()
+        self.assertEqual(len(unpacked), 6)
+        with self.assertRaisesRegex(RuntimeError, "a second time"):
+            y.sum().backward()
+
+        # Nested hooks, the innermost ones apply
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: 1 / 0, lambda x: x):
+            with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: x):
+                y = a * b
+        y.sum().backward()
+        with self.assertRaises(ZeroDivisionError):
+            with torch.autograd.graph.saved_tensors_hooks(lambda x: 1 / 0, lambda x: x):
+                y = a * b
+
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: "not a tensor"):
+            y = a * b
+        with self.assertRaisesRegex(TypeError, "unpack_hook expected to be a Tensor"):
+            y.sum().backward()
+
+        # Hooks do not outlive the context, in-place checks still apply
+        x = a * 1
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: x):
+            z = x.sin()
+        x.add_(1)
+        with self.assertRaisesRegex(RuntimeError, "modified by an inplace operation"):
+            z.sum().backward()
+
+    def test_save_on_cpu_without_cuda(self):
+        a = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.save_on_cpu(pin_memory=False):
+            y = (a * a).sin()
+        y.sum().backward()
+        self.assertEqual(a.grad, 2 * a * (a * a).cos())
+
 
     @slowTest
     def test_checkpointing(self):
@@ -6056,6 +6325,25 @@ class TestAutogradDeviceType(TestCase):
                 with self.assertRaisesRegex(RuntimeError, 'floating point', msg="dt: {} device: {}".format(a.dtype, a.device)):
                     f()
 
+    @onlyCUDA
+    def test_save_on_cpu(self, device):
+        for pin_memory, prefetch in product((True, False), (0, 2)):
+            a = torch.randn(64, 64, device=device, requires_grad=True)
+            b = torch.randn(64, 64, device='cpu', requires_grad=True)
+            with torch.autograd.graph.save_on_cpu(pin_memory=pin_memory, prefetch=prefetch):
+                out = a
+                for _ in range(5):
+                    out = (out * 1.1).tanh().t()
+                out = out.sum() + (b * b).sum()
+            out.backward()
+            expected = a.detach().clone().requires_grad_()
+            out = expected
+            for _ in range(5):
+                out = (out * 1.1).tanh().t()
+            out.sum().backward()
+            self.assertEqual(a.grad, expected.grad)
+            self.assertEqual(b.grad, 2 * b)
+
     @onlyCUDA
     def test_advanced_indexing_backwards_large(self, device):
         # See https://github.com/pytorch/pytorch/issues/22843
@@ -1,5 +1,6 @@
 import collections
 import io
+import json
 import tempfile
 import unittest
 import sys
@@ -52,6 +53,9 @@ if TEST_CUDA:
     TEST_LARGE_TENSOR = torch.cuda.get_device_properties(0).total_memory >= 12e9
     TEST_MEDIUM_TENSOR = torch.cuda.get_device_properties(0).total_memory >= 6e9
 
+TEST_CUDA_GRAPH = TEST_CUDA and not TEST_WITH_ROCM and \
+    torch.version.cuda is not None and int(torch.version.cuda.split(".")[0]) >= 11
+
 types = [
     torch.FloatTensor,
     torch.DoubleTensor,
@@ -369,6 +373,118 @@ class TestCuda(TestCase):
                 end1 = advance(gen1, end1)
                 t += 1
 
+    def test_allocator_settings(self):
+        MiB = 1024 * 1024
+        torch.cuda.empty_cache()
+        torch.cuda.memory._set_allocator_settings("max_split_size_mb:40")
+        try:
+            stats = torch.cuda.memory_stats()
+            self.assertEqual(stats["max_split_size"], 40 * MiB)
+            oversize_allocations = stats["oversize_allocations.current"]
+            oversize_segments = stats["oversize_segments.current"]
+
+            x = torch.empty(60 * MiB, dtype=torch.uint8, device='cuda')
+            stats = torch.cuda.memory_stats()
+            self.assertEqual(stats["oversize_allocations.current"], oversize_allocations + 1)
+            self.assertEqual(stats["oversize_segments.current"], oversize_segments + 1)
+            reserved = torch.cuda.memory_reserved()
+            del x
+            # the free 60 MiB block is not split for a smaller request
+            y = torch.empty(30 * MiB, dtype=torch.uint8, device='cuda')
+            self.assertEqual(torch.cuda.memory_reserved(), reserved + 30 * MiB)
+            self.assertEqual(torch.cuda.memory_stats()["oversize_allocations.current"], oversize_allocations)
+            del y
+
+            # 41 MiB lies between 32 and 64 MiB, so it is rounded to 48 MiB
+            torch.cuda.memory._set_allocator_settings("roundup_power2_divisions:4")
+            allocated = torch.cuda.memory_allocated()
+            z = torch.empty(41 * MiB, dtype=torch.uint8, device='cuda')
+            self.assertEqual(torch.cuda.memory_allocated(), allocated + 48 * MiB)
+            del z
+
+            with self.assertRaisesRegex(RuntimeError, "power of two"):
+                torch.cuda.memory._set_allocator_settings("roundup_power2_divisions:3")
+            with self.assertRaisesRegex(RuntimeError, "must be 0 or larger than 20"):
+                torch.cuda.memory._set_allocator_settings("max_split_size_mb:10")
+            with self.assertRaisesRegex(RuntimeError, "unknown CUDA allocator option"):
+                torch.cuda.memory._set_allocator_settings("split_size:10")
+        finally:
+            torch.cuda.memory._set_allocator_settings("max_split_size_mb:0,roundup_power2_divisions:0")
+            torch.cuda.empty_cache()
+        self.assertEqual(torch.cuda.memory_stats()["max_split_size"], -1)
+
+    def test_caching_allocator_cross_stream_reuse(self):
+        MiB = 1024 * 1024
+        torch.cuda.empty_cache()
+        stream = torch.cuda.Stream()
+        with torch.cuda.stream(stream):
+            x = torch.empty(30 * MiB, dtype=torch.uint8, device='cuda')
+        del x
+        stream.synchronize()
+        reserved = torch.cuda.memory_reserved()
+        # the segment cached for the idle stream serves the current stream
+        y = torch.empty(30 * MiB, dtype=torch.uint8, device='cuda')
+        self.assertEqual(torch.cuda.memory_reserved(), reserved)
+        del y
+        torch.cuda.empty_cache()
+
+    def test_set_stream_pool(self):
+        MiB = 1024 * 1024
+        torch.cuda.empty_cache()
+        s1 = torch.cuda.Stream()
+        s2 = torch.cuda.Stream()
+        torch.cuda.set_stream_pool(s1, "stage")
+        torch.cuda.set_stream_pool(s2, "stage")
+        try:
+            with torch.cuda.stream(s1):
+                x = torch.empty(30 * MiB, dtype=torch.uint8, device='cuda')
+            del x
+            s1.synchronize()
+            reserved = torch.cuda.memory_reserved()
+            # memory cached in the pool does not serve other streams
+            y = torch.empty(30 * MiB, dtype=torch.uint8, device='cuda')
+            self.assertEqual(torch.cuda.memory_reserved(), reserved + 30 * MiB)
+            # but the other streams of the pool
+            with torch.cuda.stream(s2):
+                z = torch.empty(30 * MiB, dtype=torch.uint8, device='cuda')
+            self.assertEqual(torch.cuda.memory_reserved(), reserved + 30 * MiB)
+            del y, z
+        finally:
+            torch.cuda.set_stream_pool(s1, None)
+            torch.cuda.set_stream_pool(s2, None)
+            torch.cuda.synchronize()
+            torch.cuda.empty_cache()
+
+    def test_memory_history(self):
+        MiB = 1024 * 1024
+        torch.cuda.empty_cache()
+        torch.cuda.record_memory_history(max_entries=3)
+        try:
+            x = torch.empty(3 * MiB, dtype=torch.uint8, device='cuda')
+            del x
+            y = torch.empty(3 * MiB, dtype=torch.uint8, device='cuda')
+            del y
+            torch.cuda.empty_cache()
+            history = torch.cuda.memory_history()
+            # the ring buffer keeps the last events only
+            self.assertEqual([e["action"] for e in history], ["alloc", "free", "segment_free"])
+            self.assertEqual(history[0]["size"], 3 * MiB)
+            self.assertEqual(history[0]["allocated_bytes"] - history[1]["allocated_bytes"], 3 * MiB)
+            self.assertIn("test_memory_history", history[0]["stack"])
+            self.assertEqual(history[1]["address"], history[0]["address"])
+            timestamps = [e["time_us"] for e in history]
+            self.assertEqual(timestamps, sorted(timestamps))
+
+            with tempfile.NamedTemporaryFile(mode="r", suffix=".json") as f:
+                torch.cuda.export_memory_timeline(f.name)
+                trace = json.load(f)
+            self.assertEqual(len(trace["traceEvents"]), 2 * len(history))
+        finally:
+            torch.cuda.record_memory_history(enabled=False)
+        z = torch.empty(3 * MiB, dtype=torch.uint8, device='cuda')
+        del z
+        self.assertEqual(len(torch.cuda.memory_history()), 3)
+
     def test_out_of_memory(self):
         tensor = torch.zeros(1024, device='cuda')
 
@@ -1260,6 +1376,68 @@ class TestCuda(TestCase):
 
         self.assertNotEqual(try_realloc.data_ptr(), data_ptr)
 
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_capture_replay(self):
+        s = torch.cuda.Stream()
+        x = torch.zeros(1000, device="cuda")
+        with torch.cuda.stream(s):
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            y = (x + 1) * 2
+            y.add_(x)
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # capture only records the work
+        for i in range(3):
+            x.fill_(i)
+            g.replay()
+            self.assertEqual(y, torch.full_like(x, (i + 1) * 2 + i))
+
+        # the private pool keeps the graph's memory away from eager allocations
+        y_ptr = y.data_ptr()
+        del y
+        z = torch.empty(1000, device="cuda")
+        self.assertNotEqual(z.data_ptr(), y_ptr)
+        g.replay()
+        torch.cuda.synchronize()
+        g.reset()
+
+        with self.assertRaisesRegex(RuntimeError, "non-default stream"):
+            torch.cuda.CUDAGraph().capture_begin()
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_rng(self):
+        size = 10000
+        s = torch.cuda.Stream()
+        x = torch.ones(size, device="cuda")
+
+        torch.cuda.manual_seed(5)
+        eager = [torch.nn.functional.dropout(x, 0.5) + torch.rand(size, device="cuda")
+                 for _ in range(3)]
+
+        torch.cuda.manual_seed(5)
+        with torch.cuda.stream(s):
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            y = torch.nn.functional.dropout(x, 0.5) + torch.rand(size, device="cuda")
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # replays draw the same numbers as consecutive eager runs
+        for expected in eager:
+            g.replay()
+            self.assertEqual(y, expected)
+
+        # random ops that read the philox state by value refuse capture
+        with torch.cuda.stream(s):
+            g2 = torch.cuda.CUDAGraph()
+            g2.capture_begin()
+            with self.assertRaisesRegex(RuntimeError, "does not support CUDA graph capture"):
+                torch.poisson(x)
+            g2.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
     def test_noncontiguous_pinned_memory(self):
         # See issue #3266
         x = torch.arange(0, 10).view((2, 5))
@@ -1284,6 +1462,40 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, msg='allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_caching_pinned_memory_stats(self):
+        torch.cuda.empty_host_cache()
+        before = torch.cuda.host_memory_stats()
+
+        # requests are rounded up to a power of two
+        t = torch.empty(1000, dtype=torch.uint8).pin_memory()
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["allocation.current"], before["allocation.current"] + 1)
+        self.assertEqual(stats["allocated_bytes.current"], before["allocated_bytes.current"] + 1024)
+        self.assertEqual(stats["reserved_bytes.current"], before["reserved_bytes.current"] + 1024)
+        del t
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["allocated_bytes.current"], before["allocated_bytes.current"])
+        self.assertEqual(stats["reserved_bytes.current"], before["reserved_bytes.current"] + 1024)
+
+        # many threads pinning memory of different sizes concurrently
+        def worker(seed):
+            sizes = torch.randint(1, 1 << 20, (50,), generator=torch.Generator().manual_seed(seed))
+            for size in sizes.tolist():
+                x = torch.full((size,), seed, dtype=torch.uint8).pin_memory()
+                self.assertTrue(x.eq(seed).all())
+
+        threads = [threading.Thread(target=worker, args=(i,)) for i in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["allocation.current"], before["allocation.current"])
+
+        torch.cuda.empty_host_cache()
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["reserved_bytes.current"], before["reserved_bytes.current"])
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -1613,6 +1825,27 @@ class TestCuda(TestCase):
         torch.cuda.synchronize()
         self.assertEqual(y[0, 0, 0, 2**31 - 2], expected)
 
+    @unittest.skipIf(not TEST_LARGE_TENSOR, "not enough memory")
+    def test_elementwise_64bit_indexing(self):
+        # More than 2^31 elements, which gpu_kernel runs in a single launch
+        # with 64-bit indices instead of splitting the iterator
+        n = 2**31 + 10
+        x = torch.zeros(n, dtype=torch.int8, device="cuda")
+        x[-3:] = torch.tensor([1, 2, 3], dtype=torch.int8)
+        # contiguous, vectorized
+        y = x + 1
+        self.assertEqual(y[-4:].tolist(), [1, 2, 3, 4])
+        self.assertEqual(y[:2].tolist(), [1, 1])
+        del y
+        # strided input
+        y = x.view(2, -1).t() + 1
+        self.assertEqual(y[-1].tolist(), [1, 4])
+        self.assertEqual(y[-2].tolist(), [1, 3])
+        del y
+        # cast of the input
+        y = torch.add(x, torch.ones(1, dtype=torch.int16, device="cuda"), alpha=2).to(torch.int8)
+        self.assertEqual(y[-4:].tolist(), [2, 3, 4, 5])
+
     @skipCUDANonDefaultStreamIf(True)
     def test_streaming_backwards_sync(self):
         default_stream = torch.cuda.current_stream()
@@ -2805,6 +3038,30 @@ class TestCudaComm(TestCase):
         ]
         self._test_broadcast_coalesced(tensors, 256)
 
+    @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
+    def test_broadcast_coalesced_async(self):
+        tensors = [
+            torch.randn(1000).cuda(),
+            torch.randn(7).long().cuda(),
+            make_sparse_tensor(torch.cuda.sparse.DoubleTensor, 5, 2, 3),
+            torch.randn(3000).double().cuda(),
+            torch.randn(20).cuda(),
+        ]
+        streams = [None, torch.cuda.Stream(1)]
+        outputs, events = comm.broadcast_coalesced_async(tensors, (0, 1), buffer_size=4096, streams=streams)
+        self.assertEqual(len(events), 2)
+        for device, event in enumerate(events):
+            self.assertIsInstance(event, torch.cuda.Event)
+            torch.cuda.current_stream(device).wait_event(event)
+        for inp_t, out_t in zip(tensors, outputs[0]):
+            self.assertIs(inp_t, out_t)
+        for inp_t, out_t in zip(tensors, outputs[1]):
+            self.assertEqual(out_t.get_device(), 1)
+            self.assertEqual(out_t, inp_t)
+
+        with self.assertRaisesRegex(RuntimeError, r"Expected the device associated with the stream at index 1"):
+            comm.broadcast_coalesced_async(tensors, (0, 1), streams=[None, torch.cuda.Stream(0)])
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_reduce_add(self):
         x = torch.randn(5, 5)
@@ -1,6 +1,6 @@
 import torch
 from torch.testing._internal.common_utils import TestCase, run_tests
-from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes
+from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, dtypesIfCUDA
 
 class TestForeach(TestCase):
     @dtypes(*torch.testing.get_all_dtypes())
@@ -119,6 +119,133 @@ class TestForeach(TestCase):
                    torch.tensor([1], dtype=torch.long, device=device)]
         self.assertRaises(RuntimeError, lambda: torch._foreach_add(tensors, 1))
 
+    @dtypes(*torch.testing.get_all_dtypes())
+    def test_add_scalar_with_trailing_empty_tensor(self, device, dtype):
+        if dtype == torch.bool:
+            return
+
+        tensors = [torch.zeros(10, device=device, dtype=dtype), torch.zeros(0, device=device, dtype=dtype)]
+        torch._foreach_add_(tensors, 1)
+        self.assertEqual(tensors[0], torch.ones(10, device=device, dtype=dtype))
+
+    @dtypes(torch.float, torch.double, torch.int32)
+    @dtypesIfCUDA(torch.float, torch.double, torch.half, torch.int32)
+    def test_binary_op_scalar(self, device, dtype):
+        for op, foreach_op, foreach_op_ in [(torch.sub, torch._foreach_sub, torch._foreach_sub_),
+                                            (torch.mul, torch._foreach_mul, torch._foreach_mul_),
+                                            (torch.div, torch._foreach_div, torch._foreach_div_)]:
+            tensors = [torch.arange(1, 11 + n, device=device).to(dtype) for n in range(20)]
+            expected = [op(t, 2) for t in tensors]
+            self.assertEqual(foreach_op(tensors, 2), expected)
+
+            if expected[0].dtype != dtype:
+                # true division of integral tensors
+                self.assertRaises(RuntimeError, lambda: foreach_op_(tensors, 2))
+            else:
+                foreach_op_(tensors, 2)
+                self.assertEqual(tensors, expected)
+
+    @dtypes(torch.float, torch.double, torch.int32)
+    @dtypesIfCUDA(torch.float, torch.double, torch.half, torch.int32)
+    def test_binary_op_list(self, device, dtype):
+        for op, foreach_op, foreach_op_ in [(torch.add, torch._foreach_add, torch._foreach_add_),
+                                            (torch.sub, torch._foreach_sub, torch._foreach_sub_),
+                                            (torch.mul, torch._foreach_mul, torch._foreach_mul_),
+                                            (torch.div, torch._foreach_div, torch._foreach_div_)]:
+            tensors1 = [torch.arange(1, 11 + n, device=device).to(dtype) for n in range(20)]
+            tensors2 = [torch.arange(3, 13 + n, device=device).to(dtype) for n in range(20)]
+            expected = [op(t1, t2) for t1, t2 in zip(tensors1, tensors2)]
+            self.assertEqual(foreach_op(tensors1, tensors2), expected)
+
+            if expected[0].dtype != dtype:
+                self.assertRaises(RuntimeError, lambda: foreach_op_(tensors1, tensors2))
+            else:
+                foreach_op_(tensors1, tensors2)
+                self.assertEqual(tensors1, expected)
+
+    def test_binary_op_list_error_cases(self, device):
+        tensors1 = [torch.zeros(10, 10, device=device) for _ in range(10)]
+        tensors2 = [torch.ones(10, 10, device=device) for _ in range(9)]
+        with self.assertRaisesRegex(RuntimeError, "Tensor lists must have the same number of tensors"):
+            torch._foreach_add(tensors1, tensors2)
+
+        tensors2 = [torch.ones(10, 11, device=device) for _ in range(10)]
+        with self.assertRaisesRegex(RuntimeError, "Corresponding tensors in lists must have the same size"):
+            torch._foreach_add(tensors1, tensors2)
+
+        tensors2 = [torch.ones(10, 10, device=device, dtype=torch.double) for _ in range(10)]
+        with self.assertRaisesRegex(RuntimeError, "All tensors in the tensor list must have the same dtype"):
+            torch._foreach_add(tensors1, tensors2)
+
+    def test_binary_op_list_different_strides(self, device):
+        # mismatched layouts can not be walked in lockstep and take the slow route
+        tensors1 = [torch.randn(4, 5, device=device) for _ in range(3)]
+        tensors2 = [torch.randn(5, 4, device=device).t() for _ in range(3)]
+        expected = [t1 + t2 for t1, t2 in zip(tensors1, tensors2)]
+        self.assertEqual(torch._foreach_add(tensors1, tensors2), expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.float, torch.double, torch.half)
+    def test_unary_op(self, device, dtype):
+        for op, foreach_op, foreach_op_ in [(torch.sqrt, torch._foreach_sqrt, torch._foreach_sqrt_),
+                                            (torch.exp, torch._foreach_exp, torch._foreach_exp_)]:
+            tensors = [torch.rand(10 + n, device=device).to(dtype) for n in range(20)]
+            expected = [op(t) for t in tensors]
+            self.assertEqual(foreach_op(tensors), expected)
+
+            foreach_op_(tensors)
+            self.assertEqual(tensors, expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.float, torch.double, torch.half)
+    def test_pointwise_op(self, device, dtype):
+        for op, foreach_op, foreach_op_ in [(torch.addcmul, torch._foreach_addcmul, torch._foreach_addcmul_),
+                                            (torch.addcdiv, torch._foreach_addcdiv, torch._foreach_addcdiv_)]:
+            tensors = [torch.rand(10 + n, device=device).to(dtype) for n in range(20)]
+            tensors1 = [torch.rand(10 + n, device=device).to(dtype) for n in range(20)]
+            tensors2 = [torch.rand(10 + n, device=device).add(1).to(dtype) for n in range(20)]
+            expected = [op(t, t1, t2, value=0.5) for t, t1, t2 in zip(tensors, tensors1, tensors2)]
+            self.assertEqual(foreach_op(tensors, tensors1, tensors2, 0.5), expected)
+
+            foreach_op_(tensors, tensors1, tensors2, 0.5)
+            self.assertEqual(tensors, expected)
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_adam(self, device, dtype):
+        params = [torch.randn(10 + n, device=device, dtype=dtype, requires_grad=True) for n in range(20)]
+        fused_params = [p.detach().clone() for p in params]
+        exp_avgs = [torch.zeros_like(p) for p in fused_params]
+        exp_avg_sqs = [torch.zeros_like(p) for p in fused_params]
+        optimizer = torch.optim.Adam(params, lr=0.1, betas=(0.8, 0.9), eps=1e-6, weight_decay=0.01)
+        for step in range(1, 4):
+            for p in params:
+                p.grad = torch.randn_like(p)
+            grads = [p.grad.clone() for p in params]
+            optimizer.step()
+            torch._fused_adam_(fused_params, grads, exp_avgs, exp_avg_sqs, 0.1, 0.8, 0.9, 0.01, 1e-6, step)
+            self.assertEqual(fused_params, [p.detach() for p in params])
+            self.assertEqual(exp_avgs, [optimizer.state[p]['exp_avg'] for p in params])
+            self.assertEqual(exp_avg_sqs, [optimizer.state[p]['exp_avg_sq'] for p in params])
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_sgd(self, device, dtype):
+        for momentum, dampening, nesterov in [(0, 0, False), (0.9, 0.1, False), (0.9, 0, True)]:
+            params = [torch.randn(10 + n, device=device, dtype=dtype, requires_grad=True) for n in range(20)]
+            fused_params = [p.detach().clone() for p in params]
+            momentum_buffers = [torch.zeros_like(p) for p in fused_params] if momentum != 0 else []
+            optimizer = torch.optim.SGD(params, lr=0.1, momentum=momentum, dampening=dampening,
+                                        weight_decay=0.01, nesterov=nesterov)
+            for step in range(3):
+                for p in params:
+                    p.grad = torch.randn_like(p)
+                grads = [p.grad.clone() for p in params]
+                optimizer.step()
+                torch._fused_sgd_(fused_params, grads, momentum_buffers, 0.1, momentum, dampening,
+                                  0.01, nesterov, step == 0)
+                self.assertEqual(fused_params, [p.detach() for p in params])
+                if momentum != 0:
+                    self.assertEqual(momentum_buffers, [optimizer.state[p]['momentum_buffer'] for p in params])
+
 instantiate_device_type_tests(TestForeach, globals())
 
 if __name__ == '__main__':
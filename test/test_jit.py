@@ -25,6 +25,7 @@ from jit.test_save_load import TestSaveLoad  # noqa: F401
 from jit.test_python_ir import TestPythonIr  # noqa: F401
 from jit.test_functional_blocks import TestFunctionalBlocks  # noqa: F401
 from jit.test_remove_mutation import TestRemoveMutation  # noqa: F401
+from jit.test_memory_reuse import TestMemoryReuse  # noqa: F401
 from jit.test_torchbind import TestTorchbind  # noqa: F401
 from jit.test_module_interface import TestModuleInterface  # noqa: F401
 from jit.test_onnx_export import TestONNXExport  # noqa: F401
@@ -672,6 +673,42 @@ class TestJit(JitTestCase):
         # a_copy is modified
         torch.testing.assert_allclose(orig_res, a_copy)
 
+    def test_addmm_activation_fusion(self):
+        class M(torch.nn.Module):
+            def __init__(self, activation):
+                super(M, self).__init__()
+                self.activation = activation
+
+            def forward(self, bias, x, w):
+                return self.activation(torch.addmm(bias, x, w))
+
+        bias = torch.randn(11)
+        x = torch.randn(7, 5)
+        w = torch.randn(5, 11)
+        for activation in (torch.relu, torch.relu_, torch._C._nn.gelu):
+            m = torch.jit.script(M(activation))
+            orig_res = m(bias, x, w)
+            torch._C._jit_pass_fuse_addmm_activation(m.graph)
+            buffer = io.BytesIO()
+            torch.jit.save(m, buffer)
+            buffer.seek(0)
+            m = torch.jit.load(buffer)
+            FileCheck().check_not("aten::addmm(") \
+                .check("aten::_addmm_activation(") \
+                .run(m.graph)
+            torch.testing.assert_allclose(orig_res, m(bias, x, w))
+
+        # linear only is an addmm for 2-d inputs
+        def linear_relu(x, weight, bias):
+            return torch.relu(torch._C._nn.linear(x, weight, bias))
+
+        graph = torch.jit.script(linear_relu).graph
+        torch._C._jit_pass_fuse_addmm_activation(graph)
+        FileCheck().check("aten::linear(").check_not("aten::_addmm_activation(").run(graph)
+        torch._C._jit_pass_complete_shape_analysis(graph, (x, w.t(), bias), False)
+        torch._C._jit_pass_fuse_addmm_activation(graph)
+        FileCheck().check_not("aten::linear(").check("aten::_addmm_activation(").run(graph)
+
     @unittest.skipIf(GRAPH_EXECUTOR == ProfilingMode.SIMPLE, "Simple executor doesn't have shape information")
     def test_peephole_optimize_shape_ops(self):
         def test_input(func, input, result):
@@ -1673,6 +1710,36 @@ graph(%Ra, %Rb):
         const = constant_prop.graph.findNode("prim::Constant").output().toIValue()
         self.assertEqual(const, 8)
 
+    def test_memoize_subgraphs(self):
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.register_buffer("pos", torch.randn(16, 4))
+
+            def forward(self, x):
+                n = x.size(0)
+                mask = torch.triu(torch.ones(n, n), diagonal=1)
+                return x + self.pos[:n] + mask.sum(1, keepdim=True)
+
+        m = torch.jit.script(M())
+        self.run_pass('memoize_subgraphs', m.graph)
+        FileCheck().check("prim::MemoizedGraph").check("aten::add").run(m.graph)
+
+        def expected(x):
+            n = x.size(0)
+            mask = torch.triu(torch.ones(n, n), diagonal=1)
+            return x + m.pos[:n] + mask.sum(1, keepdim=True)
+
+        for n in [3, 5, 3, 5]:
+            x = torch.randn(n, 4)
+            self.assertEqual(m(x), expected(x))
+
+        # In-place updates of the attributes are seen
+        with torch.no_grad():
+            m.pos.add_(1)
+        x = torch.randn(3, 4)
+        self.assertEqual(m(x), expected(x))
+
     def test_constant_prop_nested(self):
         @torch.jit.script
         def constant_prop(a):
@@ -2796,6 +2863,38 @@ class TestScript(JitTestCase):
                 FileCheck().check("Double(*:2, 2:1, requires_grad=0, device=cpu) = ").run(graph_str)
                 FileCheck().check_not("Double(1:2, 2:1, requires_grad=0, device=cpu) = ").run(graph_str)
 
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "skip if profiling isn't enabled")
+    def test_profiling_stops_when_stable(self):
+        def fn(x):
+            y = x * 2
+            for _ in range(20):
+                y = y + 1
+            return y
+
+        def fn2(x):
+            return fn(x) * 3
+
+        x = torch.rand(3, 4)
+        with enable_profiling_mode_for_profiling_tests():
+            with num_profiled_runs(10):
+                old_num_stable_runs = torch._C._jit_set_num_stable_profiled_runs(2)
+                try:
+                    scripted = torch.jit.script(fn)
+                    # the second and third runs leave the types of the first unchanged
+                    for _ in range(4):
+                        self.assertEqual(scripted(x), fn(x))
+                    graph = torch.jit.last_executed_optimized_graph()
+                    FileCheck().check_not("prim::profile").run(graph)
+
+                    torch._C._jit_set_num_stable_profiled_runs(0)
+                    scripted = torch.jit.script(fn2)
+                    for _ in range(4):
+                        self.assertEqual(scripted(x), fn2(x))
+                    graph = torch.jit.last_executed_optimized_graph()
+                    FileCheck().check("prim::profile").run(graph)
+                finally:
+                    torch._C._jit_set_num_stable_profiled_runs(old_num_stable_runs)
+
 
     def test_nested_bailouts(self):
         @torch.jit.script
@@ -10606,6 +10705,23 @@ a")
             self.assertEqual(torch.autograd.grad(sout.sum(), inputs),
                              torch.autograd.grad(out.sum(), inputs))
 
+    def test_mm_batching_horizontal(self):
+        def fn(b, x0, x1, x2, x3, w0, w1, w2, w3):
+            return (torch.addmm(b, x0, w0), torch.addmm(b, x1, w1),
+                    torch.addmm(b, x2, w2), torch.addmm(b, x3, w3))
+
+        scripted = torch.jit.script(fn)
+        self.run_pass('batch_mm', scripted.graph)
+        FileCheck().check("prim::MMBatchHorizontal").check_not("aten::addmm") \
+            .run(scripted.graph)
+
+        # same shapes go through a single baddbmm, others one by one
+        b = torch.randn(6)
+        for x3_rows in [3, 5]:
+            xs = [torch.randn(3, 4) for _ in range(3)] + [torch.randn(x3_rows, 4)]
+            ws = [torch.randn(4, 6) for _ in range(4)]
+            self.assertEqual(scripted(b, *xs, *ws), fn(b, *xs, *ws))
+
     def test_loop_unrolling(self):
         def fn(x):
             y = 0
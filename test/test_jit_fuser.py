@@ -3,6 +3,10 @@ from __future__ import division
 from __future__ import print_function
 from __future__ import unicode_literals
 
+import os
+import subprocess
+import sys
+import tempfile
 import unittest
 import torch
 import torch.nn as nn
@@ -68,6 +72,50 @@ class TestFuser(JitTestCase):
     def test_abs_cuda(self):
         self._test_fused_abs(device="cuda")
 
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    @enable_cpu_fuser
+    def test_kernel_disk_cache_cpu(self):
+        def func(x, y):
+            return (x + y).sigmoid() * 3
+
+        with tempfile.TemporaryDirectory() as cache_dir:
+            torch._C._jit_set_fused_kernel_cache_dir(cache_dir)
+            try:
+                a = torch.randn(6, 7)
+                scripted = self.checkScript(func, (a, a))
+                self.assertAllFused(scripted.graph_for(a, a))
+            finally:
+                torch._C._jit_set_fused_kernel_cache_dir("")
+            # each compiled kernel is stored with the key it was built for
+            entries = os.listdir(cache_dir)
+            self.assertTrue(any(e.endswith(".key") for e in entries))
+            self.assertEqual(len(entries) % 2, 0)
+
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    def test_kernel_disk_cache_cpu_without_compiler(self):
+        script = dedent('''
+            import torch
+            torch._C._jit_override_can_fuse_on_cpu(True)
+
+            @torch.jit.script
+            def func(x, y):
+                return (x + y).sigmoid() * 3
+
+            a = torch.randn(6, 7)
+            for _ in range(3):
+                out = func(a, a)
+            assert torch.allclose(out, (a + a).sigmoid() * 3)
+        ''')
+        with tempfile.TemporaryDirectory() as cache_dir:
+            env = dict(os.environ, PYTORCH_FUSER_CACHE_DIR=cache_dir)
+            subprocess.check_call([sys.executable, "-c", script], env=env)
+            entries = sorted(os.listdir(cache_dir))
+            self.assertTrue(any(e.endswith(".key") for e in entries))
+            # a process that finds its kernels in the cache needs no compiler
+            env["CXX"] = os.path.join(cache_dir, "no-such-compiler")
+            subprocess.check_call([sys.executable, "-c", script], env=env)
+            self.assertEqual(sorted(os.listdir(cache_dir)), entries)
+
     @unittest.skipIf(not RUN_CUDA, "requires CUDA")
     def test_zero_element_tensors(self):
         def decode(sin_t, cos_t):
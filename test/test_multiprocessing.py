@@ -4,6 +4,8 @@ import os
 import sys
 import time
 import subprocess
+import tempfile
+import textwrap
 import unittest
 import copy
 from sys import platform
@@ -71,6 +73,13 @@ def send_tensor(queue, event, device, dtype):
     event.wait()
 
 
+def send_pooled_tensors(queue, event, count):
+    torch._C._set_shm_pool_enabled(True)
+    queue.put([torch.full([5], i) for i in range(count)])
+    event.wait()
+    torch._C._set_shm_pool_enabled(False)
+
+
 def send_and_delete_tensors(queue, event, device, dtype, count, size=5):
     for i in range(count):
         t = torch.full([size], i, device=device, dtype=dtype)
@@ -364,6 +373,40 @@ class TestMultiprocessing(TestCase):
             for _ in range(TEST_REPEATS):
                 queue_put()
 
+    @unittest.skipIf(IS_WINDOWS, "storages are not pooled on Windows")
+    def test_fs_pooled_sharing(self):
+        with fs_sharing(), leak_checker(self) as lc:
+            q = mp.Queue()
+            e = mp.Event()
+            p = mp.Process(target=send_pooled_tensors, args=(q, e, 10))
+            p.start()
+            lc.check_pid(p.pid)
+            tensors = q.get()
+            for i, t in enumerate(tensors):
+                self.assertEqual(t, torch.full([5], i))
+            # all of them were carved out of the same segment
+            handles = [t.storage()._share_filename_()[1] for t in tensors]
+            self.assertEqual(len({h.split(b':')[0] for h in handles}), 1)
+            del tensors, t
+            e.set()
+            p.join(100)
+            self.assertFalse(p.is_alive())
+
+    @unittest.skipIf(IS_WINDOWS, "storages are not pooled on Windows")
+    def test_fs_pool_recycles_blocks(self):
+        def new_block_handle():
+            return torch.DoubleStorage(4).share_memory_()._share_filename_()[1]
+
+        with fs_sharing(), leak_checker(self):
+            torch._C._set_shm_pool_enabled(True)
+            try:
+                handle = new_block_handle()
+                self.assertIn(b':', handle)
+                # the block of the freed storage is reused
+                self.assertEqual(new_block_handle(), handle)
+            finally:
+                torch._C._set_shm_pool_enabled(False)
+
     def test_inherit_tensor(self):
         t = torch.zeros(5, 5)
         p = SubProcess(t.share_memory_())
@@ -497,6 +540,50 @@ class TestMultiprocessing(TestCase):
             #
             # self.assertEqual(storage_size, 5)
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_ipc_pool(self):
+        # The pool is read from the environment once per process, and holds
+        # eight batches so that its blocks get recycled.
+        script = textwrap.dedent("""
+            import torch
+            import torch.multiprocessing as mp
+
+            def consumer(inq, outq):
+                for _ in range(100):
+                    tensors = inq.get()
+                    outq.put([t.sum().item() for t in tensors])
+                    del tensors
+
+            if __name__ == '__main__':
+                ctx = mp.get_context('spawn')
+                inq = ctx.Queue()
+                outq = ctx.Queue()
+                p = ctx.Process(target=consumer, args=(inq, outq))
+                p.start()
+                for i in range(100):
+                    tensors = [torch.full((256,), float(i + j), device='cuda') for j in range(8)]
+                    inq.put(tensors)
+                    assert outq.get() == [256. * (i + j) for j in range(8)]
+                    del tensors
+                p.join()
+                torch.cuda.ipc_collect()
+        """)
+        env = dict(os.environ)
+        env['TORCH_CUDA_IPC_POOL_SIZE'] = str(64 << 10)
+        env['TORCH_CUDA_IPC_POOL_MAX_BLOCK_SIZE'] = str(4 << 10)
+        with tempfile.NamedTemporaryFile(mode='w', suffix='.py') as f:
+            f.write(script)
+            f.flush()
+            popen = subprocess.Popen(
+                [sys.executable, f.name],
+                env=env,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE)
+            _, stderr = popen.communicate()
+        self.assertEqual(popen.returncode, 0, stderr.decode('ascii', 'replace'))
+
         # Collect current process (producer) files, make sure nothing holds
         # ref to the sent tensors
         del _tensor
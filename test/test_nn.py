@@ -28,7 +28,7 @@ import torch.nn.init as init
 import torch.nn.utils.rnn as rnn_utils
 from torch.nn.utils import clip_grad_norm_, clip_grad_value_
 import torch.nn.utils.prune as prune
-from torch.nn.utils import parameters_to_vector, vector_to_parameters
+from torch.nn.utils import parameters_to_vector, vector_to_parameters, grads_to_flat_buffer
 from torch.autograd import gradcheck
 from torch.autograd.gradcheck import gradgradcheck
 from torch.nn import Parameter
@@ -44,7 +44,7 @@ from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, NewCrit
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, \
     dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
     skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, \
-    deviceCountAtLeast, expectedAlertNondeterministic, largeTensorTest
+    deviceCountAtLeast, expectedAlertNondeterministic, largeTensorTest, onlyCPU
 from torch.nn import MultiheadAttention
 
 from hypothesis import given
@@ -1777,6 +1777,49 @@ class TestNN(NNTestCase):
         sample = next(model.parameters())[0, 0, 0]
         self.assertTrue(torch.equal(sample.data, vec.data[:5]))
 
+    def test_grads_to_flat_buffer(self):
+        conv1 = nn.Conv2d(3, 10, 5).to(memory_format=torch.channels_last)
+        fc1 = nn.Linear(10, 20)
+        model = nn.Sequential(conv1, nn.Flatten(), fc1)
+        fc1.bias.grad = torch.ones(20)
+        buffer = grads_to_flat_buffer(model.parameters())
+        self.assertEqual(buffer.numel(), 980)
+        self.assertEqual(buffer[-20:], torch.ones(20))
+        self.assertEqual(fc1.bias.grad.data_ptr(), buffer[-20:].data_ptr())
+
+        inp = torch.randn(2, 3, 5, 5)
+        ref = deepcopy(model)
+        for _ in range(2):
+            model(inp).sum().backward()
+            ref(inp).sum().backward()
+        pointer = 0
+        for param, ref_param in zip(model.parameters(), ref.parameters()):
+            self.assertEqual(param.grad, ref_param.grad + (1 if param is fc1.bias else 0))
+            self.assertEqual(param.grad.stride(), param.stride())
+            self.assertEqual(param.grad.data_ptr(), buffer[pointer:].data_ptr())
+            pointer += param.numel()
+
+        # Zeroing the buffer zeroes every grad, a grad set to None comes back
+        buffer.zero_()
+        fc1.weight.grad = None
+        model(inp).sum().backward()
+        ref.zero_grad()
+        ref(inp).sum().backward()
+        self.assertEqual(fc1.weight.grad, ref[2].weight.grad)
+        self.assertEqual(fc1.weight.grad.data_ptr(), buffer[760:].data_ptr())
+        self.assertEqual(conv1.weight.grad, ref[0].weight.grad)
+
+        torch.autograd._set_grad_buffer(fc1.weight, None)
+        fc1.weight.grad = None
+        model(inp).sum().backward()
+        self.assertNotEqual(fc1.weight.grad.data_ptr(), buffer[760:].data_ptr())
+
+        with self.assertRaisesRegex(RuntimeError, "sizes"):
+            torch.autograd._set_grad_buffer(fc1.weight, torch.zeros(3))
+        with self.assertRaisesRegex(TypeError, "dtype"):
+            grads_to_flat_buffer([torch.zeros(2, requires_grad=True),
+                                  torch.zeros(2, dtype=torch.double, requires_grad=True)])
+
     # torch/nn/utils/prune.py
     @unittest.skipIf(not TEST_NUMPY, "numpy not found")
     def test_validate_pruning_amount_init(self):
@@ -3551,6 +3594,51 @@ class TestNN(NNTestCase):
         self.assertTrue(ref_out.is_contiguous())
         self.assertEqual(out, ref_out)
 
+    def test_channels_last_cpu(self):
+        def helper(mod, input_size, train=True):
+            for dtype in [torch.float, torch.double]:
+                input = torch.randn(input_size, dtype=dtype)
+                input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+                ref_input = input.detach().clone().contiguous().requires_grad_()
+                m = mod().to(dtype).train(train)
+                ref_m = deepcopy(m)
+
+                out = m(input)
+                ref_out = ref_m(ref_input)
+                grad = torch.randn_like(ref_out)
+                out.backward(grad.contiguous(memory_format=torch.channels_last))
+                ref_out.backward(grad)
+
+                self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+                self.assertTrue(input.grad.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(out, ref_out)
+                self.assertEqual(input.grad, ref_input.grad)
+                for p, ref_p in zip(m.parameters(), ref_m.parameters()):
+                    self.assertEqual(p.grad, ref_p.grad)
+                for b, ref_b in zip(m.buffers(), ref_m.buffers()):
+                    self.assertEqual(b, ref_b)
+
+        helper(lambda: nn.MaxPool2d(3, stride=2, padding=1), (4, 19, 10, 9))
+        helper(lambda: nn.MaxPool2d(2, dilation=2, ceil_mode=True), (2, 7, 11, 11))
+        helper(lambda: nn.AdaptiveAvgPool2d((3, 5)), (4, 21, 10, 11))
+        helper(lambda: nn.AdaptiveAvgPool2d(1), (3, 35, 7, 7))
+        helper(lambda: nn.BatchNorm2d(19), (4, 19, 10, 9))
+        helper(lambda: nn.BatchNorm2d(19), (4, 19, 10, 9), train=False)
+        helper(lambda: nn.BatchNorm2d(3, affine=False), (2, 3, 5, 5))
+        helper(lambda: nn.Upsample(scale_factor=2, mode='nearest'), (2, 19, 5, 6))
+        helper(lambda: nn.Upsample(size=(11, 7), mode='bilinear', align_corners=False), (2, 19, 5, 6))
+        helper(lambda: nn.Upsample(scale_factor=1.7, mode='bilinear', align_corners=True), (2, 19, 5, 6))
+
+        # max pooling keeps the first maximum and propagates NaNs
+        x = torch.tensor([1., 3., 3., float('nan')]).view(1, 1, 2, 2).repeat(1, 9, 1, 1)
+        out, indices = F.max_pool2d(x.contiguous(memory_format=torch.channels_last), 2, return_indices=True)
+        self.assertTrue(torch.isnan(out).all())
+        self.assertEqual(indices, torch.full_like(indices, 3))
+        out, indices = F.max_pool2d(x[..., :1, :].contiguous(memory_format=torch.channels_last),
+                                    (1, 2), return_indices=True)
+        self.assertEqual(out, torch.full_like(out, 3.))
+        self.assertEqual(indices, torch.full_like(indices, 1))
+
     @unittest.skipIf(not TEST_MULTIGPU, "multi-GPU not supported")
     def test_broadcast_double_backwards_gpu(self):
         tensors = (torch.randn(4, 4, device='cuda', requires_grad=True),
@@ -3910,6 +3998,71 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache_save_load(self):
+        x = torch.randn(2, 3, 17, 19, device='cuda', requires_grad=True)
+        m = nn.Conv2d(3, 5, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True):
+            m(x).sum().backward()
+        with TemporaryFileName() as fname:
+            self.assertGreaterEqual(cudnn.save_benchmark_cache(fname), 3)
+            with open(fname) as f:
+                lines = f.read().splitlines()
+            self.assertTrue(lines[0].startswith('cudnn_benchmark_cache'))
+            self.assertEqual({line.split()[0] for line in lines[1:]}, {'fwd', 'bwd_data', 'bwd_filter'})
+            # everything was in the cache already
+            self.assertEqual(cudnn.load_benchmark_cache(fname), 0)
+            # another cuDNN version
+            header = lines[0].split()
+            header[2] = str(int(header[2]) + 1)
+            with open(fname, 'w') as f:
+                f.write('\n'.join([' '.join(header)] + lines[1:]))
+            self.assertEqual(cudnn.load_benchmark_cache(fname), 0)
+            with open(fname, 'w') as f:
+                f.write('garbage')
+            with self.assertRaisesRegex(RuntimeError, 'not a cuDNN benchmark cache'):
+                cudnn.load_benchmark_cache(fname)
+
+    def test_autocast_cpu(self):
+        x = torch.randn(4, 8)
+        m = nn.Linear(8, 3)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+        with torch.cpu.amp.autocast():
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+            out = m(x)
+            self.assertEqual(out.dtype, torch.bfloat16)
+            self.assertEqual(torch.softmax(out, 1).dtype, torch.float32)
+            self.assertEqual(torch.cat([out, x[:, :3]]).dtype, torch.float32)
+            self.assertEqual(torch.mm(x.double(), x.double().t()).dtype, torch.float64)
+            with torch.cpu.amp.autocast(enabled=False):
+                self.assertEqual(m(x).dtype, torch.float32)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+        self.assertEqual(out.float(), m(x), atol=0.1, rtol=0.05)
+        out.float().sum().backward()
+        self.assertEqual(m.weight.grad.dtype, torch.float32)
+
+    def test_autocast_cpu_persistent_cache(self):
+        x = torch.randn(4, 8)
+        m = nn.Linear(8, 3)
+        self.assertFalse(torch.is_autocast_cache_persistent())
+        try:
+            torch.set_autocast_cache_persistent(True)
+            with torch.no_grad():
+                with torch.cpu.amp.autocast():
+                    out = m(x)
+                with torch.cpu.amp.autocast():
+                    self.assertEqual(m(x), out, atol=0, rtol=0)
+                # the cast of the updated weight replaces the cached one
+                m.weight.mul_(2)
+                with torch.cpu.amp.autocast():
+                    out = m(x)
+            torch.set_autocast_cache_persistent(False)
+            with torch.no_grad(), torch.cpu.amp.autocast():
+                self.assertEqual(m(x), out, atol=0, rtol=0)
+        finally:
+            torch.set_autocast_cache_persistent(False)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4046,6 +4199,45 @@ class TestNN(NNTestCase):
             output = deconv(inputs)
             output.mean().backward()
 
+    def test_cpu_conv_benchmark(self):
+        configs = [
+            # (input size, conv module)
+            ((2, 4, 9, 9), nn.Conv2d(4, 6, 3, padding=1)),
+            ((1, 8, 7, 7), nn.Conv2d(8, 8, 3, groups=8, bias=False)),
+            ((3, 4, 10, 10), nn.Conv2d(4, 4, 3, stride=2, dilation=2, groups=2)),
+            ((2, 4, 11), nn.Conv1d(4, 5, 3)),
+        ]
+        torch.backends.cpu.clear_conv_benchmark_cache()
+        try:
+            for size, m in configs:
+                i = torch.randn(size, requires_grad=True)
+                expected = m(i)
+                expected.sum().backward()
+                expected_grad = i.grad
+                i.grad = None
+                with torch.backends.cpu.flags(conv_benchmark=True):
+                    self.assertTrue(torch.backends.cpu.conv_benchmark)
+                    for _ in range(2):
+                        output = m(i)
+                        output.sum().backward()
+                        self.assertEqual(output, expected)
+                        self.assertEqual(i.grad, expected_grad)
+                        i.grad = None
+                self.assertFalse(torch.backends.cpu.conv_benchmark)
+
+            cache = torch.backends.cpu.conv_benchmark_cache()
+            self.assertEqual(len(cache), len(configs))
+            self.assertTrue(all(choice in ('native', 'mkldnn', 'nnpack', 'xnnpack', 'winograd')
+                                for choice in cache.values()))
+            torch.backends.cpu.clear_conv_benchmark_cache()
+            self.assertEqual(torch.backends.cpu.conv_benchmark_cache(), {})
+            torch.backends.cpu.load_conv_benchmark_cache(cache)
+            self.assertEqual(torch.backends.cpu.conv_benchmark_cache(), cache)
+            with self.assertRaisesRegex(RuntimeError, "unknown CPU convolution backend"):
+                torch.backends.cpu.load_conv_benchmark_cache({'some configuration': 'cudnn'})
+        finally:
+            torch.backends.cpu.clear_conv_benchmark_cache()
+
     # For https://github.com/pytorch/pytorch/pull/1273
     # Almost identical to the above `test_Conv2d_naive_groups`
     def test_Conv2d_groups_nobias(self):
@@ -4379,6 +4571,40 @@ class TestNN(NNTestCase):
         with self.assertRaises(RuntimeError):
             torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths)
 
+    def test_CTCLoss_cpu_backward(self):
+        # the recursions run over vectors of states, with a tail when there
+        # are not a multiple of the vector size, and repeated labels disable
+        # some of the transitions
+        input_lengths = [20, 17, 20, 9]
+        target_lengths = [7, 5, 1, 4]
+        targets = torch.randint(1, 3, (sum(target_lengths),), dtype=torch.int)
+        for dtype in [torch.float, torch.double]:
+            # time major log_probs from batch major ones are not contiguous
+            log_probs = torch.randn(4, 20, 5, dtype=dtype).log_softmax(2).transpose(0, 1).requires_grad_()
+            res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths, reduction='sum')
+            expected = ctcloss_reference(log_probs, targets, input_lengths, target_lengths, reduction='sum')
+            self.assertEqual(res, expected.to(dtype))
+            grad, = torch.autograd.grad(res, log_probs)
+            expected_grad, = torch.autograd.grad(expected, log_probs)
+            # the gradient of ctc_loss is the one through log_softmax
+            expected_grad = expected_grad - log_probs.exp() * expected_grad.sum(2, keepdim=True)
+            self.assertEqual(grad, expected_grad)
+            self.assertEqual(grad[9:, 3], torch.zeros(11, 5, dtype=dtype))
+
+        # an impossible alignment has an infinite loss, whose gradient is
+        # zero with zero_infinity and NaN without
+        log_probs = torch.randn(3, 2, 5, dtype=torch.double).log_softmax(2).requires_grad_()
+        targets = torch.tensor([[1, 2, 3, 4], [1, 2, 0, 0]])
+        for zero_infinity in [False, True]:
+            res = torch.nn.functional.ctc_loss(log_probs, targets, [3, 3], [4, 2], reduction='none',
+                                               zero_infinity=zero_infinity)
+            grad, = torch.autograd.grad(res.sum(), log_probs)
+            self.assertTrue(torch.isfinite(grad[:, 1]).all())
+            if zero_infinity:
+                self.assertEqual(grad[:, 0], torch.zeros(3, 5, dtype=torch.double))
+            else:
+                self.assertTrue(torch.isnan(grad[:, 0]).all())
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_long_targets(self):
         input_length = 4000
@@ -5261,6 +5487,51 @@ class TestNN(NNTestCase):
                     else:
                         self.assertEqual(hx.grad.data, hx_cuda.grad.data)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    def test_cuda_rnn_persistent(self):
+        # without grad and cuDNN, layers with small hidden sizes run as one
+        # persistent kernel per layer; a hidden size of 64 in double does not
+        # fit and keeps the per-timestep path
+        input_size, num_layers, seq_length, batch = 10, 2, 9, 5
+        with torch.backends.cudnn.flags(enabled=False), torch.no_grad():
+            for module, hidden_size, bias, batch_first in product(
+                    (nn.GRU, nn.LSTM), (6, 24, 64), (True, False), (True, False)):
+                rnn = module(input_size, hidden_size, num_layers, bias=bias,
+                             batch_first=batch_first).double()
+                rnn_cuda = deepcopy(rnn).cuda()
+                size = (batch, seq_length) if batch_first else (seq_length, batch)
+                input = torch.randn(*size, input_size, dtype=torch.double)
+                hx = torch.randn(num_layers, batch, hidden_size, dtype=torch.double)
+                if module is nn.LSTM:
+                    hx = (hx, torch.randn_like(hx))
+                    hx_cuda = (hx[0].cuda(), hx[1].cuda())
+                else:
+                    hx_cuda = hx.cuda()
+                output, hy = rnn(input, hx)
+                output_cuda, hy_cuda = rnn_cuda(input.cuda(), hx_cuda)
+                self.assertEqual(output, output_cuda)
+                self.assertEqual(hy, hy_cuda)
+
+            # LSTM with projections
+            hidden_size, proj_size = 24, 8
+            input_gates = torch.randn(seq_length, batch, 4 * hidden_size, dtype=torch.double)
+            w_hh = torch.randn(4 * hidden_size, proj_size, dtype=torch.double) / 4
+            b_hh = torch.randn(4 * hidden_size, dtype=torch.double)
+            w_hr = torch.randn(proj_size, hidden_size, dtype=torch.double) / 4
+            h = torch.randn(batch, proj_size, dtype=torch.double)
+            c = torch.randn(batch, hidden_size, dtype=torch.double)
+            output, hy, cy = torch._thnn_persistent_lstm(
+                input_gates.cuda(), h.cuda(), c.cuda(), w_hh.cuda(), b_hh.cuda(), w_hr.cuda())
+            expected = []
+            for t in range(seq_length):
+                i, f, g, o = (input_gates[t] + h @ w_hh.t() + b_hh).chunk(4, 1)
+                c = f.sigmoid() * c + i.sigmoid() * g.tanh()
+                h = (o.sigmoid() * c.tanh()) @ w_hr.t()
+                expected.append(h)
+            self.assertEqual(output, torch.stack(expected))
+            self.assertEqual(hy, h)
+            self.assertEqual(cy, c)
+
     def test_transformer_args_check(self):
         model_name = 'Transformer'
         d_model = 128
@@ -5697,6 +5968,76 @@ class TestNN(NNTestCase):
             compare_cpu_gpu(outputs_cpu, outputs_gpu)
 
     @unittest.skipIf(not TEST_CUDNN, "needs cudnn")
+    def test_RNN_fused_cell_cpu(self):
+        # inference on CPU runs the gates of LSTM and GRU cells in one kernel,
+        # which must match the ops autograd records
+        for mode, dtype, hidden_size in itertools.product(
+                ['LSTM', 'GRU'], [torch.float, torch.double], [5, 37]):
+            rnn = getattr(nn, mode)(4, hidden_size, 2, bidirectional=True).to(dtype)
+            input = torch.randn(6, 3, 4, dtype=dtype)
+            ref_output, ref_hidden = rnn(input)
+            with torch.no_grad():
+                output, hidden = rnn(input)
+            self.assertEqual(output, ref_output)
+            self.assertEqual(hidden, ref_hidden)
+
+            packed = rnn_utils.pack_padded_sequence(input, [6, 4, 2])
+            ref_output, ref_hidden = rnn(packed)
+            with torch.no_grad():
+                output, hidden = rnn(packed)
+            self.assertEqual(output.data, ref_output.data)
+            self.assertEqual(hidden, ref_hidden)
+
+    def test_RNN_fused_cell_cpu_backward(self):
+        # training on CPU goes through _thnn_fused_lstm_cell and
+        # _thnn_fused_gru_cell, check them and their fused backward against
+        # the cells written out
+        def lstm_ref(ig, hg, cx, ib, hb):
+            gates = ig + hg if ib is None else ig + hg + ib + hb
+            i, f, g, o = gates.chunk(4, 1)
+            cy = torch.sigmoid(f) * cx + torch.sigmoid(i) * torch.tanh(g)
+            return torch.sigmoid(o) * torch.tanh(cy), cy
+
+        def gru_ref(ig, hg, hx, ib, hb):
+            if ib is not None:
+                ig, hg = ig + ib, hg + hb
+            i_r, i_z, i_n = ig.chunk(3, 1)
+            h_r, h_z, h_n = hg.chunk(3, 1)
+            r, z = torch.sigmoid(i_r + h_r), torch.sigmoid(i_z + h_z)
+            n = torch.tanh(i_n + r * h_n)
+            return ((hx - n) * z + n,)
+
+        for mode, dtype, hidden_size, bias in itertools.product(
+                ['LSTM', 'GRU'], [torch.float, torch.double], [5, 37], [True, False]):
+            num_gates = 4 if mode == 'LSTM' else 3
+            fused = torch._thnn_fused_lstm_cell if mode == 'LSTM' else torch._thnn_fused_gru_cell
+            ref = lstm_ref if mode == 'LSTM' else gru_ref
+            inputs = [torch.randn(3, num_gates * hidden_size, dtype=dtype),
+                      torch.randn(3, num_gates * hidden_size, dtype=dtype),
+                      torch.randn(3, hidden_size, dtype=dtype)]
+            if bias:
+                inputs += [torch.randn(num_gates * hidden_size, dtype=dtype) for _ in range(2)]
+            inputs = [t.requires_grad_() for t in inputs]
+            args = inputs if bias else inputs + [None, None]
+            outputs = fused(*args)[:num_gates - 2]
+            ref_outputs = ref(*args)
+            self.assertEqual(outputs, ref_outputs)
+            grad_outputs = [torch.randn_like(out) for out in outputs]
+            grads = torch.autograd.grad(outputs, inputs, grad_outputs)
+            ref_grads = torch.autograd.grad(ref_outputs, inputs, grad_outputs)
+            self.assertEqual(grads, ref_grads)
+            if mode == 'LSTM':
+                # only the gradient of cy
+                grads = torch.autograd.grad(outputs[1], inputs, grad_outputs[1])
+                ref_grads = torch.autograd.grad(ref_outputs[1], inputs, grad_outputs[1])
+                self.assertEqual(grads, ref_grads)
+            if dtype == torch.double:
+                self.assertTrue(gradgradcheck(lambda *args: fused(*args)[:num_gates - 2], inputs))
+
+        rnn = nn.LSTM(4, 6, 2, bidirectional=True).double()
+        input = torch.randn(5, 3, 4, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda input: rnn(input)[0], (input,)))
+
     def test_RNN_cpu_vs_cudnn_no_dropout(self):
         if TEST_WITH_ROCM:
             dtype = torch.float
@@ -7622,6 +7963,42 @@ class TestNN(NNTestCase):
                     input = torch.randn(2, 2, 2, 2, requires_grad=True)
                     gradcheck(lambda x: F.interpolate(x, out_size, **kwargs), [input])
 
+    def test_upsampling_grid_sample_reduced_precision_cpu(self):
+        # the bicubic kernel blends rows with Vec256, use a width past one vector
+        for align_corners in [True, False]:
+            input = torch.randn(2, 3, 5, 19, dtype=torch.double, requires_grad=True)
+            for size in [(7, 40), (3, 9)]:
+                gradcheck(lambda x: F.interpolate(x, size, mode='bicubic', align_corners=align_corners), [input])
+
+        # Half and BFloat16 are computed in float and rounded once
+        for dtype, prec in [(torch.half, 1e-3), (torch.bfloat16, 1e-2)]:
+            input = torch.randn(2, 3, 8, 11).to(dtype)
+            grid = (torch.rand(2, 6, 9, 2) * 2 - 1).to(dtype)
+            for mode in ['bilinear', 'bicubic']:
+                for memory_format in [torch.contiguous_format, torch.channels_last]:
+                    x = input.contiguous(memory_format=memory_format).requires_grad_()
+                    ref_x = input.float().requires_grad_()
+                    out = F.interpolate(x, size=(13, 7), mode=mode, align_corners=False)
+                    ref_out = F.interpolate(ref_x, size=(13, 7), mode=mode, align_corners=False)
+                    self.assertEqual(out.dtype, dtype)
+                    self.assertEqual(out.float(), ref_out.to(dtype).float(), atol=prec, rtol=prec)
+                    grad = torch.randn_like(ref_out).to(dtype)
+                    out.backward(grad)
+                    ref_out.backward(grad.float())
+                    self.assertEqual(x.grad.float(), ref_x.grad.to(dtype).float(), atol=prec, rtol=prec)
+            for mode in ['bilinear', 'nearest']:
+                x = input.clone().requires_grad_()
+                g = grid.clone().requires_grad_()
+                ref_x = input.float().requires_grad_()
+                ref_g = grid.float().requires_grad_()
+                out = F.grid_sample(x, g, mode=mode, align_corners=False)
+                ref_out = F.grid_sample(ref_x, ref_g, mode=mode, align_corners=False)
+                self.assertEqual(out.dtype, dtype)
+                self.assertEqual(out.float(), ref_out.to(dtype).float(), atol=prec, rtol=prec)
+                out.sum().backward()
+                ref_out.sum().backward()
+                self.assertEqual(x.grad.float(), ref_x.grad.to(dtype).float(), atol=prec, rtol=prec)
+
     def test_upsampling_not_recompute_scale_factor(self):
         # test output against known input: result must match opencv
         in_t = torch.arange(8.).view(1, 2, 2, 2)
@@ -9577,6 +9954,76 @@ class TestNNDeviceType(NNTestCase):
             with torch.backends.cudnn.flags(enabled=False):
                 self._test_module_empty_input(mod, inp)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_layer_norm_group_norm_welford_cpu(self, device, dtype):
+        # a large offset makes E[x^2] - E[x]^2 lose every significant digit
+        x = torch.randn(37, 4, 67, dtype=torch.double, device=device) + 1e4
+        x_ref = x - x.mean(dim=(1, 2), keepdim=True)
+        weight = torch.randn(4 * 67, dtype=dtype, device=device).view(4, 67)
+        bias = torch.randn(4 * 67, dtype=dtype, device=device).view(4, 67)
+        out = F.layer_norm(x.to(dtype), (4, 67), weight, bias, eps=1e-5)
+        expected = F.layer_norm(x_ref, (4, 67), weight.double(), bias.double(), eps=1e-5)
+        self.assertEqual(out, expected.to(dtype), atol=1e-2 if dtype == torch.float else 1e-7, rtol=0)
+        out = F.group_norm(x.to(dtype), 2, weight[:, 0].contiguous(), bias[:, 0].contiguous(), eps=1e-5)
+        expected = F.group_norm(x_ref, 2, weight[:, 0].double(), bias[:, 0].double(), eps=1e-5)
+        self.assertEqual(out, expected.to(dtype), atol=1e-2 if dtype == torch.float else 1e-7, rtol=0)
+
+        # dgamma and dbeta are reduced in a fixed order, so they must not
+        # depend on the number of threads
+        x = torch.randn(203, 131, dtype=dtype, device=device, requires_grad=True)
+        weight = torch.randn(131, dtype=dtype, device=device, requires_grad=True)
+        bias = torch.randn(131, dtype=dtype, device=device, requires_grad=True)
+        grad = torch.randn(203, 131, dtype=dtype, device=device)
+        num_threads = torch.get_num_threads()
+        grads = []
+        try:
+            for threads in (1, 3, num_threads):
+                torch.set_num_threads(threads)
+                out = F.layer_norm(x, (131,), weight, bias)
+                grads.append(torch.autograd.grad(out, (x, weight, bias), grad))
+        finally:
+            torch.set_num_threads(num_threads)
+        for g in grads[1:]:
+            for a, b in zip(grads[0], g):
+                self.assertEqual(a, b, atol=0, rtol=0)
+
+        if dtype == torch.double:
+            x = torch.randn(5, 13, dtype=dtype, device=device, requires_grad=True)
+            weight = torch.randn(13, dtype=dtype, device=device, requires_grad=True)
+            bias = torch.randn(13, dtype=dtype, device=device, requires_grad=True)
+            self.assertTrue(gradcheck(lambda x, w, b: F.layer_norm(x, (13,), w, b), (x, weight, bias)))
+            self.assertTrue(gradcheck(lambda x: F.layer_norm(x, (13,)), (x,)))
+
+    @dtypes(torch.float, torch.double)
+    def test_dropout_add_layer_norm(self, device, dtype):
+        x = torch.randn(64, 300, dtype=dtype, device=device, requires_grad=True)
+        r = torch.randn(64, 300, dtype=dtype, device=device, requires_grad=True)
+        weight = torch.randn(300, dtype=dtype, device=device, requires_grad=True)
+        bias = torch.randn(300, dtype=dtype, device=device, requires_grad=True)
+
+        out = torch.dropout_add_layer_norm(x, r, (300,), weight, bias, p=0.3, train=False)
+        self.assertEqual(out, F.layer_norm(r + x, (300,), weight, bias))
+
+        p = 0.3
+        out = torch.dropout_add_layer_norm(x, r, (300,), weight, bias, p=p)
+        grad = torch.randn_like(out)
+        gx, gr, gw, gb = torch.autograd.grad(out, (x, r, weight, bias), grad)
+        # the input gradient is the residual gradient through the dropout mask
+        mask = (gx != 0).to(dtype)
+        self.assertEqual(mask.mean().item(), 1 - p, atol=0.02, rtol=0)
+        self.assertEqual(gx, gr * mask / (1 - p))
+
+        x_ref = x.detach().clone().requires_grad_()
+        r_ref = r.detach().clone().requires_grad_()
+        w_ref = weight.detach().clone().requires_grad_()
+        b_ref = bias.detach().clone().requires_grad_()
+        expected = F.layer_norm(r_ref + x_ref * mask / (1 - p), (300,), w_ref, b_ref)
+        self.assertEqual(out, expected)
+        expected_grads = torch.autograd.grad(expected, (x_ref, r_ref, w_ref, b_ref), grad)
+        for g, g_ref in zip((gx, gr, gw, gb), expected_grads):
+            self.assertEqual(g, g_ref)
+
     @onlyOnCPUAndCUDA
     def test_ReflectionPad_empty(self, device):
         for mod, inp in [
@@ -9944,6 +10391,45 @@ class TestNNDeviceType(NNTestCase):
         # TODO(#38095): Replace assertEqualIgnoreType. See issue #38095
         self.assertEqualIgnoreType(embedding.weight.grad._values(), onesTwice)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_embedding_backward_atomic(self, device, dtype):
+        # small vocabularies accumulate in shared memory, larger ones with
+        # few indices per row use atomics, with one per warp for hot indices
+        tol = dict(atol=1e-1, rtol=1e-2) if dtype == torch.half else {}
+
+        def check(num_weights, indices, padding_idx=None):
+            grad = torch.randn(indices.numel(), 40, dtype=torch.double)
+            weight = torch.randn(num_weights, 40, dtype=torch.double, requires_grad=True)
+            F.embedding(indices, weight, padding_idx=padding_idx).backward(grad)
+            for deterministic in [False, True]:
+                torch.set_deterministic(deterministic)
+                try:
+                    weight_ = weight.detach().to(device, dtype).requires_grad_()
+                    F.embedding(indices.to(device), weight_, padding_idx=padding_idx).backward(grad.to(device, dtype))
+                finally:
+                    torch.set_deterministic(False)
+                self.assertEqual(weight_.grad, weight.grad.to(dtype), **tol)
+
+            offsets = torch.arange(0, indices.numel(), 3)
+            per_sample_weights = torch.randn(indices.numel(), dtype=torch.double)
+            for mode in ['sum', 'mean']:
+                psw = per_sample_weights if mode == 'sum' else None
+                grad = torch.randn(offsets.numel(), 40, dtype=torch.double)
+                weight.grad = None
+                F.embedding_bag(indices, weight, offsets, mode=mode, per_sample_weights=psw).backward(grad)
+                weight_ = weight.detach().to(device, dtype).requires_grad_()
+                F.embedding_bag(indices.to(device), weight_, offsets.to(device), mode=mode,
+                                per_sample_weights=psw.to(device, dtype) if psw is not None else None).backward(
+                                    grad.to(device, dtype))
+                self.assertEqual(weight_.grad, weight.grad.to(dtype), **tol)
+
+        check(100, torch.randint(100, (5000,)))
+        check(100, torch.randint(100, (5000,)), padding_idx=3)
+        hot = torch.randint(20000, (10000,))
+        hot[torch.rand(10000) < 0.5] = 7
+        check(20000, hot)
+
     @dtypesIfCUDA(*ALL_TENSORTYPES2)
     @dtypes(torch.float32)
     def test_embedding_padding_idx(self, device, dtype):
@@ -10004,7 +10490,9 @@ class TestNNDeviceType(NNTestCase):
     def test_softmax_results(self, device, dtype):
         # Non-even sizes and non-zero shifts test fallback paths in vectorized kernel
         # Note: dim1 > 1024 is needed to exercise the vectorized (non-persistent) path, (16, 30576) is BERT-esque
-        sizes = [(0, 10), (32, 20), (10, 0), (31, 20), (32, 21), (31, 23), (32, 1536), (31, 2048), (33, 2049), (16, 30576)]
+        # dim1 in (1024, 8192] runs the block persistent kernels
+        sizes = [(0, 10), (32, 20), (10, 0), (31, 20), (32, 21), (31, 23), (32, 1536), (31, 2048), (33, 2049),
+                 (9, 4097), (8, 8192), (16, 30576)]
         shifts = [(0, 0), (1, 0), (0, 1), (1, 1)]
         for fn in [F.softmax, F.log_softmax]:
             for size in sizes:
@@ -11017,6 +11505,52 @@ class TestNNDeviceType(NNTestCase):
         self._test_EmbeddingBag(device, 'sum', True, dtype, test_backward=test_backward)
         self._test_EmbeddingBag(device, 'mean', True, dtype, test_backward=test_backward)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_embedding_bag_backward_fused_update(self, device, dtype):
+        num_weights, dim, lr, eps = 50, 7, 0.1, 1e-10
+        indices = torch.randint(0, num_weights, (300,), device=device)
+        offsets = torch.tensor([0, 0, 3, 90, 91, 200, 300], device=device)
+        for mode, include_last_offset, use_weights in product(('sum', 'mean'), (True, False), (True, False)):
+            if mode == 'mean' and use_weights:
+                continue
+            bag_offsets = offsets if include_last_offset else offsets[:-1]
+            mode_int = 0 if mode == 'sum' else 1
+            psw = torch.randn(300, device=device, dtype=dtype) if use_weights else None
+            weight = torch.randn(num_weights, dim, device=device, dtype=dtype, requires_grad=True)
+            out = F.embedding_bag(indices, weight, bag_offsets, mode=mode, per_sample_weights=psw,
+                                  include_last_offset=include_last_offset)
+            grad = torch.randn_like(out)
+            out.backward(grad)
+
+            with torch.no_grad():
+                w = weight.detach().clone()
+                torch._embedding_bag_backward_sgd_(w, grad, indices, bag_offsets, mode_int, psw,
+                                                   include_last_offset, lr)
+                self.assertEqual(w, weight - lr * weight.grad)
+
+                w = weight.detach().clone()
+                state_sum = torch.full_like(w, 0.1)
+                torch._embedding_bag_backward_adagrad_(w, state_sum, grad, indices, bag_offsets, mode_int, psw,
+                                                       include_last_offset, lr, eps)
+                expected_state_sum = 0.1 + weight.grad * weight.grad
+                self.assertEqual(state_sum, expected_state_sum)
+                self.assertEqual(w, weight - lr * weight.grad / (expected_state_sum.sqrt() + eps))
+
+    @onlyCPU
+    def test_embedding_bag_half_cpu(self, device):
+        weight = torch.randn(40, 9, device=device).half()
+        indices = torch.randint(0, 40, (200,), device=device)
+        offsets = torch.tensor([0, 0, 5, 120, 121], device=device)
+        psw = torch.rand(200, device=device).half()
+        for mode in ('sum', 'mean', 'max'):
+            out = F.embedding_bag(indices, weight, offsets, mode=mode)
+            self.assertEqual(out.dtype, torch.half)
+            expected = F.embedding_bag(indices, weight.float(), offsets, mode=mode)
+            self.assertEqual(out, expected.half(), atol=1e-2, rtol=1e-3)
+        out = F.embedding_bag(indices, weight, offsets, mode='sum', per_sample_weights=psw)
+        expected = F.embedding_bag(indices, weight.float(), offsets, mode='sum', per_sample_weights=psw.float())
+        self.assertEqual(out, expected.half(), atol=1e-2, rtol=1e-3)
 
     @onlyCUDA
     @skipCUDAIfNotRocm
@@ -11598,6 +12132,98 @@ class TestNNDeviceType(NNTestCase):
     def test_softmax_bfloat16(self, device):
         self._test_bfloat16_ops(torch.nn.Softmax(dim=1), device, inp_dims=(16, 32), prec=1e-2)
 
+    @onlyCPU
+    def test_bfloat16_fp32_accumulate_cpu(self, device):
+        # Rows longer than a vector so both the vectorized body and the tail run
+        for dims in [(16, 37), (4, 3, 301)]:
+            input = torch.randn(dims, device=device) * 4
+            input_bf16 = input.bfloat16()
+            for op in [torch.nn.Softmax(dim=-1), torch.nn.LogSoftmax(dim=-1),
+                       torch.nn.Softmax(dim=0), torch.nn.LogSoftmax(dim=0)]:
+                self.assertEqual(op(input_bf16), op(input_bf16.float()), atol=1e-5, rtol=1e-2, exact_dtype=False)
+            ln = torch.nn.LayerNorm(dims[-1:])
+            with torch.no_grad():
+                ln.weight.uniform_()
+                ln.bias.uniform_()
+            out = ln.bfloat16()(input_bf16)
+            self.assertEqual(out.dtype, torch.bfloat16)
+            self.assertEqual(out, ln.float()(input_bf16.float()), atol=2e-2, rtol=1e-2, exact_dtype=False)
+
+        self._test_bfloat16_ops(torch.nn.Softmax(dim=1), device, inp_dims=(16, 32), prec=1e-2)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_softmax_online_normalizer_cpu(self, device, dtype):
+        # row lengths around the vector and block sizes, large magnitudes so
+        # the running max keeps growing, and -inf masked positions
+        for n in (1, 5, 8, 63, 64, 129, 5000):
+            input = torch.randn(6, n, device=device, dtype=dtype) * 30
+            input[1] = torch.arange(n, device=device, dtype=dtype) * 10
+            if n > 1:
+                input[2, ::2] = -float('inf')
+                input[3, :n - 1] = -float('inf')
+            ref = input.double()
+            self.assertEqual(torch.softmax(input, -1), torch.softmax(ref, -1), exact_dtype=False)
+            self.assertEqual(torch.log_softmax(input, -1), torch.log_softmax(ref, -1), exact_dtype=False)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float)
+    def test_scale_mask_softmax(self, device, dtype):
+        def reference(input, mask, scale):
+            input = (input.float() if input.dtype == torch.half else input) * scale
+            if mask.dtype == torch.bool:
+                input = input.masked_fill(mask, -float('inf'))
+            else:
+                input = input + mask.to(input.dtype)
+            return torch.softmax(input, -1)
+
+        prec = 1e-3 if dtype == torch.half else None
+        for n in (7, 64, 1000, 2048, 5000, 8192, 9000):
+            input = torch.randn(2, 3, 4, n, device=device, dtype=dtype, requires_grad=True)
+            bool_mask = torch.rand(4, n, device=device) < 0.3
+            bool_mask[:, 0] = False
+            masks = [bool_mask, bool_mask.view(1, 1, 4, n).expand(2, 1, 4, n),
+                     torch.randn(4, n, device=device, dtype=dtype),
+                     torch.randn(2, 1, 1, n, device=device, dtype=dtype)]
+            for mask in masks:
+                out = torch.scale_mask_softmax(input, mask, 0.125)
+                self.assertEqual(out.dtype, dtype)
+                ref_input = input.detach().clone().requires_grad_()
+                ref = reference(ref_input, mask, 0.125)
+                self.assertEqual(out, ref, atol=prec, rtol=0, exact_dtype=False)
+                grad = torch.randn_like(out)
+                grad_input, = torch.autograd.grad(out, input, grad)
+                ref_grad_input, = torch.autograd.grad(ref, ref_input, grad)
+                self.assertEqual(grad_input, ref_grad_input, atol=prec, rtol=0, exact_dtype=False)
+
+        # the additive mask gets the gradient of the scaled input, summed over
+        # the dimensions it is broadcast along
+        input = torch.randn(3, 5, 33, device=device, dtype=dtype, requires_grad=True)
+        mask = torch.randn(5, 33, device=device, dtype=dtype, requires_grad=True)
+        out = torch.scale_mask_softmax(input, mask, 0.5)
+        grad = torch.randn_like(out)
+        grad_input, grad_mask = torch.autograd.grad(out, (input, mask), grad)
+        self.assertEqual(grad_mask, (grad_input / 0.5).sum(0), atol=prec, rtol=0)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_cross_entropy_fused_cpu(self, device, dtype):
+        input = torch.randn(20, 11, device=device, dtype=dtype, requires_grad=True)
+        target = torch.randint(0, 11, (20,), device=device)
+        target[3] = -100
+        weight = torch.rand(11, device=device, dtype=dtype)
+        for reduction, w, ignore_index in product(('none', 'mean', 'sum'), (None, weight), (-100, 2)):
+            out = F.cross_entropy(input, target, w, ignore_index=ignore_index, reduction=reduction)
+            ref = F.nll_loss(F.log_softmax(input, 1), target, w, ignore_index=ignore_index, reduction=reduction)
+            self.assertEqual(out, ref)
+            grad = torch.randn_like(out)
+            self.assertEqual(torch.autograd.grad(out, input, grad), torch.autograd.grad(ref, input, grad))
+
+        if dtype == torch.double:
+            fn = lambda x: F.cross_entropy(x, target, weight)
+            gradcheck(fn, (input,))
+            gradgradcheck(fn, (input,))
+
     @onlyCUDA
     @skipCUDAIfRocm
     @skipCUDAIfCudnnVersionLessThan(7603)
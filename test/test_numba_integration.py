@@ -353,6 +353,34 @@ class TestNumbaIntegration(common.TestCase):
         del if2["data"]
         self.assertEqual(if1, if2)
 
+    @unittest.skipIf(not TEST_NUMPY, "No numpy")
+    @unittest.skipIf(not TEST_CUDA, "No cuda")
+    def test_from_cuda_array_interface_v3(self):
+        """torch.as_tensor() shares read-only memory and orders its work after the producer stream."""
+
+        class Producer(object):
+            def __init__(self, tensor, stream, read_only=False):
+                self.tensor = tensor
+                interface = dict(tensor.__cuda_array_interface__)
+                interface.update(version=3, stream=stream, data=(tensor.data_ptr(), read_only))
+                self.__cuda_array_interface__ = interface
+
+        stream = torch.cuda.Stream()
+        with torch.cuda.stream(stream):
+            produced = torch.zeros(1 << 20, device="cuda")
+            torch.cuda._sleep(50000000)
+            produced.fill_(1)
+        torch_ary = torch.as_tensor(Producer(produced, stream.cuda_stream), device="cuda")
+        self.assertEqual(torch_ary.data_ptr(), produced.data_ptr())
+        self.assertEqual(torch_ary.sum().item(), 1 << 20)
+
+        # 1 is the legacy default stream, which is the default stream of PyTorch
+        torch_ary = torch.as_tensor(Producer(produced, 1, read_only=True), device="cuda")
+        self.assertEqual(torch_ary.data_ptr(), produced.data_ptr())
+
+        with self.assertRaisesRegex(ValueError, "ambiguous"):
+            torch.as_tensor(Producer(produced, 0), device="cuda")
+
 
 if __name__ == "__main__":
     common.run_tests()
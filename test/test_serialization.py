@@ -738,6 +738,71 @@ class TestSerialization(TestCase, SerializationMixin):
             torch.save(model, path)
             torch.load(path)
 
+    @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile on windows")
+    def test_serialization_save_async(self):
+        data = self._test_serialization_data()
+        expected = copy.deepcopy(data)
+        with tempfile.NamedTemporaryFile() as f:
+            future = torch.save_async(data, f.name)
+            # the storages were copied, changes after the call aren't saved
+            data[0].fill_(-1)
+            self.assertIsNone(future.result())
+            self._test_serialization_assert(expected, torch.load(f.name))
+
+        buf = io.BytesIO()
+        torch.save_async(expected, buf).result()
+        buf.seek(0)
+        self._test_serialization_assert(expected, torch.load(buf))
+
+        # errors are raised from the future
+        future = torch.save_async(expected, os.path.join(tempfile.gettempdir(), 'missing_dir', 'x.pt'))
+        with self.assertRaises(RuntimeError):
+            future.result()
+
+    @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile on windows")
+    def test_serialization_mmap(self):
+        data = self._test_serialization_data()
+        with tempfile.NamedTemporaryFile() as f:
+            torch.save(data, f.name)
+            result = torch.load(f.name, mmap=True)
+            self._test_serialization_assert(data, result)
+
+            # mapped copy-on-write, the file is not modified
+            tensor = torch.load(f.name, mmap=True)[1]
+            tensor.zero_()
+            self.assertEqual(torch.load(f.name)[1], data[1])
+
+            with open(f.name, 'rb') as opened:
+                with self.assertRaisesRegex(ValueError, "file name"):
+                    torch.load(opened, mmap=True)
+
+        with tempfile.NamedTemporaryFile() as f:
+            torch.jit.save(torch.jit.script(torch.nn.Linear(3, 4)), f.name)
+            loaded = torch.jit.load(f.name)
+            mapped = torch.jit.load(f.name, mmap=True)
+            self.assertEqual(mapped.weight, loaded.weight)
+            self.assertEqual(mapped.bias, loaded.bias)
+
+    @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile on windows")
+    def test_serialization_compress(self):
+        data = self._test_serialization_data()
+        data.append(torch.zeros(1000, 100))
+        uncompressed = io.BytesIO()
+        torch.save(data, uncompressed)
+        buf = io.BytesIO()
+        torch.save(data, buf, compress=True)
+        self.assertLess(len(buf.getvalue()), len(uncompressed.getvalue()))
+        buf.seek(0)
+        self._test_serialization_assert(data, torch.load(buf))
+
+        with tempfile.NamedTemporaryFile() as f:
+            torch.save_async(data, f.name, compress=True).result()
+            self._test_serialization_assert(data, torch.load(f.name))
+            self._test_serialization_assert(data, torch.load(f.name, mmap=True))
+
+        with self.assertRaisesRegex(ValueError, "zipfile"):
+            torch.save(data, io.BytesIO(), _use_new_zipfile_serialization=False, compress=True)
+
     def run(self, *args, **kwargs):
         with serialization_method(use_zip=True):
             return super(TestSerialization, self).run(*args, **kwargs)
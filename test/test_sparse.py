@@ -202,6 +202,32 @@ class TestSparse(TestCase):
             t, _, _ = self._gen_sparse(len(sparse_size), nnz, sparse_size + dense_size)
             self.safeCoalesce(t)  # this tests correctness
 
+    def test_coalesce_many_duplicates(self):
+        # Unsorted indices where most entries are repeated, like the gradient
+        # of an embedding
+        i = torch.randint(0, 7, (2, 200), device=self.device)
+        v = torch.randn(200, 3, dtype=self.value_dtype, device=self.device)
+        x = self.sparse_tensor(i, v, torch.Size([7, 7, 3]))
+        y = x.coalesce()
+        self.assertTrue(y.is_coalesced())
+        self.assertEqual(y._nnz(), torch.unique(i[0] * 7 + i[1]).numel())
+        flat = y._indices()[0] * 7 + y._indices()[1]
+        self.assertTrue((flat[1:] > flat[:-1]).all())
+        self.assertEqual(self.safeToDense(y), self.safeToDense(x))
+
+    def test_sparse_grad_accumulation(self):
+        # Sparse gradients of an embedding are accumulated over several
+        # backward passes, the sum has to match the dense one
+        indices = torch.randint(0, 10, (5, 20), device=self.device)
+        weight = torch.randn(10, 4, dtype=self.value_dtype, device=self.device, requires_grad=True)
+        dense_weight = weight.detach().clone().requires_grad_()
+        for idx in indices:
+            torch.nn.functional.embedding(idx, weight, sparse=True).sum().backward()
+            torch.nn.functional.embedding(idx, dense_weight).sum().backward()
+        self.assertTrue(weight.grad.is_sparse)
+        self.assertEqual(self.safeToDense(weight.grad), dense_weight.grad)
+        self.assertEqual(weight.grad.coalesce().to_dense(), dense_weight.grad)
+
     def test_ctor_size_checks(self):
         indices = self.index_tensor([
             [0, 0, 0],
@@ -1055,6 +1081,32 @@ class TestSparse(TestCase):
                 "bmm sparse-dense requires CUDA 10.1 or greater"):
             ab = a.bmm(b)
 
+    def test_mm_after_modifying_matrix(self):
+        # The CSR form of the sparse matrix is kept across products, it
+        # has to follow in-place changes of the matrix and of its indices
+        def check(x, y):
+            for _ in range(2):
+                self.assertEqual(torch.mm(x, y), torch.mm(self.safeToDense(x), y))
+                self.assertEqual(x.matmul(y[:, 0]), self.safeToDense(x).matmul(y[:, 0]))
+
+        y = torch.randn(6, 5, dtype=self.value_dtype, device=self.device)
+        i = self.index_tensor([[0, 0, 1, 3], [1, 4, 2, 0]])
+        v = self.value_tensor([1., 2., 3., 4.])
+        x = self.sparse_tensor(i, v, torch.Size([4, 6]))
+        check(x, y)
+        x._indices()[1].add_(1)
+        check(x, y)
+        x._values().mul_(2)
+        check(x, y)
+        x.mul_(0.5)
+        check(x, y)
+
+        # entries out of row order and duplicate entries
+        i = self.index_tensor([[3, 0, 3, 0, 2], [2, 1, 2, 4, 5]])
+        v = self.value_tensor([1., 2., 3., 4., 5.])
+        x = self.sparse_tensor(i, v, torch.Size([4, 6]))
+        check(x, y)
+
     @cpu_only
     def test_saddmm(self):
         def test_shape(di, dj, dk, nnz):
@@ -1572,6 +1624,36 @@ class TestSparse(TestCase):
         self._test_sparse_mask_shape(0, 0, [10, 10, 10], [2, 0])
         self._test_sparse_mask_shape(0, 0, [10, 10, 0], [2, 0])
 
+    def test_mul_sparse_dense(self):
+        def test_shape(sparse_dims, nnz, with_size, dense_size=None):
+            x, _, _ = self._gen_sparse(sparse_dims, nnz, with_size)
+            dense_size = with_size if dense_size is None else dense_size
+            y = torch.randn(dense_size, dtype=self.value_dtype, device=self.device)
+            expected = self.safeToDense(x) * y
+            for res in (x * y, y * x, torch.mul(x, y)):
+                self.assertTrue(res.is_sparse)
+                self.assertEqual(res._nnz(), x._nnz())
+                self.assertEqual(self.safeToDense(res), expected)
+            z = x.clone()
+            z.mul_(y)
+            self.assertTrue(z.is_sparse)
+            self.assertEqual(self.safeToDense(z), expected)
+            w = y.clone()
+            w.mul_(x)
+            self.assertFalse(w.is_sparse)
+            self.assertEqual(w, expected)
+
+        test_shape(2, 20, [5, 6])
+        test_shape(2, 20, [5, 6, 4])
+        test_shape(3, 0, [5, 6, 4])
+        # a mask shared by all the rows, like an attention mask
+        test_shape(3, 20, [3, 5, 6], [5, 6])
+        test_shape(2, 20, [5, 6, 4], [6, 1])
+
+        x, _, _ = self._gen_sparse(2, 10, [5, 6])
+        with self.assertRaisesRegex(RuntimeError, "to be broadcastable"):
+            x * torch.randn(5, 7, device=self.device)
+
     def _test_zeros(self, nnzs, shape, out_shape_i, out_shape_v=None):
         out_shape = out_shape_i + (out_shape_v or [])
         for nnz in nnzs:
@@ -263,6 +263,39 @@ class TestFFT(TestCase):
                             self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 10)  # default is cuda:0
                         self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 11)  # default is cuda:1
 
+    @skipCUDAIfRocm
+    @onlyCUDA
+    @dtypes(torch.float)
+    def test_cufft_plan_cache_threads(self, device, dtype):
+        # threads on their own streams share the cached plans; a cache of one
+        # plan also evicts plans other threads are still executing
+        import threading
+        inputs = [torch.randn(64, n, device=device, dtype=dtype) for n in (16, 32, 48, 64)]
+        expected = [torch.fft.fft(x) for x in inputs]
+        torch.cuda.synchronize()
+        original = torch.backends.cuda.cufft_plan_cache.max_size
+        torch.backends.cuda.cufft_plan_cache.max_size = 1
+        errors = []
+
+        def run(stream):
+            try:
+                with torch.cuda.stream(stream):
+                    for _ in range(20):
+                        for x, ref in zip(inputs, expected):
+                            self.assertEqual(torch.fft.fft(x), ref, atol=0, rtol=0)
+            except Exception as e:
+                errors.append(e)
+
+        try:
+            threads = [threading.Thread(target=run, args=(torch.cuda.Stream(),)) for _ in range(4)]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+        finally:
+            torch.backends.cuda.cufft_plan_cache.max_size = original
+        self.assertEqual(errors, [])
+
     # passes on ROCm w/ python 2.7, fails w/ python 3.6
     @skipCUDAIfRocm
     @skipCPUIfNoMkl
@@ -1,19 +1,26 @@
 import torch
 from torch import nn
 import numpy as np
+import threading
 
 
 class StaticRuntime:
-    def __init__(self, scripted):
+    def __init__(self, scripted, **kwargs):
+        options = torch._C.StaticRuntimeOptions()
+        for k, v in kwargs.items():
+            setattr(options, k, v)
         # this is an nn.Module
         if hasattr(scripted, "_c"):
-            self.static_runtime = torch._C._jit_to_static_runtime(scripted._c)
+            self.static_runtime = torch._C._jit_to_static_runtime(scripted._c, options)
         else:
-            self.static_runtime = torch._C._jit_to_static_runtime(scripted.graph)
+            self.static_runtime = torch._C._jit_to_static_runtime(scripted.graph, options)
 
     def __call__(self, *inps):
         return self.static_runtime.run(inps)
 
+    def benchmark_individual_ops(self, inps, warmup_runs, main_runs):
+        return self.static_runtime.benchmark_individual_ops(inps, warmup_runs, main_runs)
+
 def linear_shim(input, weight, bias=None):
     # type: (Tensor, Tensor, Optional[Tensor]) -> Tensor
     output = input.matmul(weight.t())
@@ -91,6 +98,34 @@ def trivial_graph(a, b, c):
     return a + b * c + s
 
 
+class DictOutputs(nn.Module):
+    def forward(self, x, ys, scale: float = 2.0):
+        # type: (Tensor, Tuple[Tensor, Tensor], float) -> Dict[str, Tensor]
+        a, b = ys
+        return {"sum": x + a * scale, "prod": torch.mul(x, b)}
+
+
+def fusable_graph(x, w, b, y):
+    h = torch.relu(torch.addmm(b, x, w)).contiguous().contiguous()
+    g = torch.sigmoid(h) * y
+    return torch.cat([h, g], 1)
+
+
+def towers(x, w1, w2, w3):
+    a = torch.relu(torch.matmul(x, w1))
+    b = torch.sigmoid(torch.matmul(x, w2))
+    c = torch.relu(torch.matmul(x, w3))
+    return torch.cat([a, b, c], 1)
+
+
+def add_tensors(a, b):
+    return a + b
+
+
+def div_tensors(a, b):
+    return a / b
+
+
 if __name__ == "__main__":
     HID_DIM = 256
     QUERY_LEN = 8
@@ -120,6 +155,104 @@ if __name__ == "__main__":
     o_test = tg_a(s, s, s)[0]
     torch.testing.assert_allclose(o_ref, o_test)
 
+    # outputs handed out by one run must not be overwritten by the next
+    a = torch.full((2, 2), 5)
+    o_prev = tg_a(a, a, a)[0]
+    o_prev_ref = o_prev.clone()
+    tg_a(s, s, s)
+    torch.testing.assert_allclose(o_prev, o_prev_ref)
+
+    metrics = tg_a.benchmark_individual_ops([s, s, s], 2, 2)
+    assert abs(sum(metrics.percent_per_node_type.values()) - 100) < 1e-2
+    assert sum(metrics.instances_per_node_type.values()) == len(metrics.time_per_node)
+    assert metrics.instances_per_node_type["aten::add"] == 2
+
+    # IValue inputs and outputs, with kwargs and defaults
+    dm = torch.jit.script(DictOutputs())
+    dm.eval()
+    x = torch.randn(4, 4)
+    ys = (torch.randn(4, 4), torch.randn(4, 4))
+    dm_a = StaticRuntime(dm)
+    for kwargs in ({}, {"scale": 3.0}):
+        o_ref = dm(x, ys, **kwargs)
+        o_test = dm_a.static_runtime(x, ys, **kwargs)
+        assert o_ref.keys() == o_test.keys()
+        for k in o_ref:
+            torch.testing.assert_allclose(o_ref[k], o_test[k])
+
+    # a pool of runtimes shared by several request threads
+    dm_pool = torch._C._jit_to_static_runtime_pool(dm._c, 2)
+    assert dm_pool.num_instances == 2
+    o_ref = dm(x, ys)
+    errors = []
+
+    def serve():
+        try:
+            for _ in range(10):
+                o_test = dm_pool(x, ys)
+                for k in o_ref:
+                    torch.testing.assert_allclose(o_ref[k], o_test[k])
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=serve) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors, errors
+
+    # ops fused by the static runtime passes
+    x = torch.randn(4, 8)
+    w = torch.randn(8, 6)
+    b = torch.randn(6)
+    y = torch.randn(4, 6)
+    fg = torch.jit.script(fusable_graph)
+    o_ref = fg(x, w, b, y)
+    for out_variant in (True, False):
+        fg_a = StaticRuntime(fg, enable_out_variant=out_variant)
+        for _ in range(2):
+            o_test = fg_a(x, w, b, y)[0]
+            torch.testing.assert_allclose(o_ref, o_test)
+
+    # independent towers run as parallel branches
+    x = torch.randn(16, 32)
+    ws = [torch.randn(32, 8) for _ in range(3)]
+    tw = torch.jit.script(towers)
+    o_ref = tw(x, *ws)
+    tw_a = StaticRuntime(tw, max_parallel_branches=4)
+    for _ in range(3):
+        o_test = tw_a(x, *ws)[0]
+        torch.testing.assert_allclose(o_ref, o_test)
+
+    # outputs of binary ops take the promoted dtype, also when it changes
+    # between runs
+    at = torch.jit.script(add_tensors)
+    at_a = StaticRuntime(at)
+    i = torch.full((2, 2), 3, dtype=torch.int32)
+    f = torch.full((2, 2), 0.5)
+    for a, b in ((i, f), (f, i), (i, i), (i, f)):
+        o_ref = at(a, b)
+        o_test = at_a(a, b)[0]
+        assert o_test.dtype == o_ref.dtype
+        torch.testing.assert_allclose(o_ref, o_test)
+
+    dt = torch.jit.script(div_tensors)
+    dt_a = StaticRuntime(dt)
+    for a, b in ((i, f), (f, i)):
+        o_ref = dt(a, b)
+        o_test = dt_a(a, b)[0]
+        assert o_test.dtype == o_ref.dtype
+        torch.testing.assert_allclose(o_ref, o_test)
+    # integer division of tensors is rejected as in eager mode
+    for fn in (dt, dt_a):
+        try:
+            fn(i, i)
+        except RuntimeError as e:
+            assert "Integer division" in str(e)
+        else:
+            raise AssertionError("int / int div did not raise")
+
     # Arguments taken from benchmark script, ./bench/dlrm_s_benchmark.sh
     ln_bot = [512, 512, 64]
     sigmoid_bot = -1
@@ -137,3 +270,13 @@ if __name__ == "__main__":
     ref_top = top_l(top_inp)
     acc_top = top_l_acc(top_inp)[0]
     torch.testing.assert_allclose(acc_top, ref_top)
+
+    # the second run reuses the arena sized by the first one
+    acc_top = top_l_acc(top_inp)[0]
+    torch.testing.assert_allclose(acc_top, ref_top)
+    stats = top_l_acc.static_runtime.memory_stats()
+    assert stats["arena_allocations"] == 1
+    assert 0 < stats["planned_bytes"] <= stats["requested_bytes"]
+    acc_top = top_l_acc(top_inp)[0]
+    torch.testing.assert_allclose(acc_top, ref_top)
+    assert top_l_acc.static_runtime.memory_stats()["arena_allocations"] == 1
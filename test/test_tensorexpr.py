@@ -1,4 +1,7 @@
+import io
 import numpy as np
+import os
+import shutil
 import torch
 import torch.nn.functional as F
 import unittest
@@ -6,7 +9,7 @@ import unittest
 from torch.testing._internal.common_utils import suppress_warnings, num_profiled_runs
 
 from torch.testing._internal.te_utils import CudaCodeGenCreated, CudaCodeGenExecuted, \
-    LLVMCodeGenExecuted, SimpleIREvalExecuted
+    LLVMCodeGenCreated, LLVMCodeGenExecuted, SimpleIREvalExecuted
 
 class BaseTestClass(unittest.TestCase):
     def setUp(self):
@@ -1031,6 +1034,43 @@ class TestTensorExprFuser(BaseTestClass):
     def test_cat_cuda(self):
         self._test_cat('cuda')
 
+    def test_reductions(self):
+        def easy(x, w, b):
+            y = torch.softmax(x * 2, dim=-1) + x.sum(dim=1, keepdim=True)
+            return F.layer_norm(torch.log_softmax(y, dim=1), [16], w, b).relu()
+
+        x = torch.rand(8, 16)
+        w = torch.rand(16)
+        b = torch.rand(16)
+        traced = torch.jit.trace(easy, (x, w, b))
+        for _ in range(3):
+            res = traced(x, w, b)
+        np.testing.assert_allclose(
+            easy(x, w, b).numpy(), res.numpy(), rtol=1e-5, atol=1e-5)
+
+        # the reductions are fused along with the pointwise ops around them
+        graph = torch.jit.last_executed_optimized_graph()
+        groups = [n for n in graph.nodes() if n.kind() == 'tensorexpr::Group']
+        self.assertEqual(len(groups), 1)
+        for op in ['aten::softmax', 'aten::log_softmax', 'aten::layer_norm',
+                   'aten::sum', 'aten::relu']:
+            self.assertNotIn(op, [n.kind() for n in graph.nodes()])
+
+    def test_sum_int(self):
+        def easy(x):
+            return (x + 1).sum(dim=1) + 1
+
+        # ATen sums integers into int64, which is left to the interpreter
+        x = torch.randint(2 ** 30, (8, 16), dtype=torch.int32)
+        traced = torch.jit.trace(easy, (x,))
+        for _ in range(3):
+            res = traced(x)
+        ref = easy(x)
+        self.assertEqual(res.dtype, torch.int64)
+        np.testing.assert_equal(ref.numpy(), res.numpy())
+        graph = torch.jit.last_executed_optimized_graph()
+        self.assertIn('aten::sum', [n.kind() for n in graph.nodes()])
+
     @unittest.skip("temporarily disable")
     def test_scalar(self):
         @torch.jit.script
@@ -1188,6 +1228,64 @@ class TestTensorExprFuser(BaseTestClass):
             # np.testing.assert_allclose(res.cpu().numpy(), xn * yn * zn)
             # assert cuda.elapsed_value() == 1
 
+    def test_dynamic_shapes(self):
+        old_dynamic_shapes = torch._C._jit_texpr_dynamic_shapes_enabled()
+        torch._C._jit_set_texpr_dynamic_shapes_enabled(True)
+        try:
+            @torch.jit.script
+            def test(x, y, z):
+                return x * y + z
+
+            x, y, z = [torch.rand(4, 8) for _ in range(3)]
+            for _ in range(3):
+                test(x, y, z)
+
+            # a single kernel serves inputs of any size
+            llvm = LLVMCodeGenCreated()
+            for n in [1, 5, 16]:
+                x, y, z = [torch.rand(n, 8) for _ in range(3)]
+                np.testing.assert_allclose(
+                    test(x, y, z).numpy(), (x * y + z).numpy(), rtol=1e-6)
+            self.assertEqual(llvm.elapsed_value(), 0)
+
+            # sizes equal when profiled stay equal, others take the fallback
+            x, y = [torch.rand(5, 8) for _ in range(2)]
+            z = torch.rand(1, 8)
+            np.testing.assert_allclose(
+                test(x, y, z).numpy(), (x * y + z).numpy(), rtol=1e-6)
+        finally:
+            torch._C._jit_set_texpr_dynamic_shapes_enabled(old_dynamic_shapes)
+
+    @unittest.skipIf(not torch._C._llvm_enabled(), "requires LLVM")
+    @unittest.skipIf(shutil.which(os.environ.get("CXX", "g++")) is None,
+                     "requires a C++ compiler")
+    def test_compile_ahead_of_time(self):
+        class M(torch.nn.Module):
+            def forward(self, x, y):
+                return (x * y).exp() + x
+
+        m = torch.jit.freeze(torch.jit.script(M()).eval())
+        x, y = torch.rand(4, 8), torch.rand(4, 8)
+        torch._C._jit_pass_te_compile_ahead_of_time(m._c, [x, y])
+        self.assertIn("tensorexpr::aot_kernel", str(m.graph))
+        self.assertNotIn("tensorexpr::Group", str(m.graph))
+
+        buffer = io.BytesIO()
+        torch.jit.save(m, buffer)
+        buffer.seek(0)
+        loaded = torch.jit.load(buffer)
+
+        # the saved kernels run without being compiled again
+        llvm = LLVMCodeGenCreated()
+        for module in (m, loaded):
+            for _ in range(3):
+                np.testing.assert_allclose(
+                    module(x, y).numpy(), ((x * y).exp() + x).numpy(), rtol=1e-5)
+        self.assertEqual(llvm.elapsed_value(), 0)
+
+        with self.assertRaisesRegex(RuntimeError, "compiled for"):
+            loaded(torch.rand(5, 8), torch.rand(5, 8))
+
     @unittest.skipIf(not torch.cuda.is_available(), "requires CUDA")
     def test_guard_fails(self):
         @torch.jit.script
@@ -80,6 +80,25 @@ class TestThroughputBenchmark(TestCase):
         with tempfile.NamedTemporaryFile(delete=False) as f:
             self.linear_test(TwoLayerNetModule, profiler_output_path=f.name)
 
+    def test_open_loop(self):
+        module = TwoLayerNet(10, 5, 15)
+        bench = ThroughputBenchmark(module)
+        bench.add_input(torch.randn(8, 10), torch.randn(8, 10))
+        stats = bench.benchmark(
+            num_calling_threads=2,
+            num_warmup_iters=10,
+            num_iters=200,
+            arrival_rate=2000.0,
+        )
+        self.assertEqual(stats.num_iters, 200)
+        self.assertLessEqual(stats.latency_p50_ms, stats.latency_p90_ms)
+        self.assertLessEqual(stats.latency_p90_ms, stats.latency_p99_ms)
+        self.assertLessEqual(stats.latency_p99_ms, stats.latency_p999_ms)
+        self.assertEqual(len(stats.thread_cpu_time_seconds), 2)
+        # 200 arrivals at 2000/s take 0.1s on average
+        self.assertGreater(stats.total_time_seconds, 0.02)
+        print(stats)
+
 
 if __name__ == '__main__':
     run_tests()
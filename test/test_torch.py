@@ -670,6 +670,20 @@ class AbstractTestCases:
             self.assertEqual(y[:, 0], range(100))
             self.assertEqual(y[:, 40], range(4000, 4100))
 
+        def test_copy_permute(self):
+            # Batched and odd-sized transposes exercise the tiled copy path,
+            # including the partial tiles at the edges
+            for dtype in [torch.uint8, torch.int16, torch.float, torch.int64, torch.bfloat16, torch.cfloat]:
+                x = torch.arange(4 * 67 * 93, dtype=torch.int64).reshape(4, 67, 93).to(dtype)
+                for perm in [(0, 2, 1), (2, 1, 0), (1, 0, 2)]:
+                    y = x.permute(perm).contiguous()
+                    self.assertTrue(y.is_contiguous())
+                    self.assertEqual(y.tolist(), x.permute(perm).tolist())
+                nchw = x.reshape(2, 2, 67, 93)
+                nhwc = nchw.contiguous(memory_format=torch.channels_last)
+                self.assertEqual(nhwc, nchw)
+                self.assertEqual(nhwc.contiguous(), nchw)
+
         def test_device(self):
             cpu = torch.device('cpu')
             self.assertEqual('cpu', str(cpu))
@@ -1064,6 +1078,39 @@ class AbstractTestCases:
             self.assertIsOrdered('descending', x, res2val, res2ind,
                                  'random with NaNs')
 
+        def test_sort_large_1d(self):
+            # Single slices this large take the parallel radix / merge sort path
+            SIZE = 100003
+            for dtype in [torch.uint8, torch.int8, torch.int32, torch.int64, torch.float, torch.double, torch.half]:
+                if dtype.is_floating_point:
+                    x = torch.randn(SIZE, dtype=torch.float).to(dtype)
+                    x[torch.randint(SIZE, (100,))] = float('nan')
+                    x[torch.randint(SIZE, (100,))] = float('-inf')
+                else:
+                    x = torch.randint(-100 if dtype.is_signed else 0, 100, (SIZE,), dtype=dtype)
+                for descending in [False, True]:
+                    values, indices = x.sort(descending=descending)
+                    expected = np.sort(x.float().numpy())
+                    if descending:
+                        # numpy puts NaN last, sort(descending=True) puts it first
+                        expected = np.concatenate([expected[np.isnan(expected)], expected[~np.isnan(expected)][::-1]])
+                    self.assertEqual(values.float().numpy(), expected)
+                    self.assertEqual(x[indices], values)
+                    # Equal keys keep their original order
+                    diff = indices[1:] - indices[:-1]
+                    ties = values[1:] == values[:-1]
+                    self.assertTrue((diff[ties] > 0).all())
+                    self.assertEqual(x.argsort(descending=descending), indices)
+                    # A single slice of a higher dim tensor takes the same path
+                    self.assertEqual(x.view(1, SIZE, 1).sort(1, descending)[0].view(-1), values)
+
+            x = torch.randint(0, 1000, (SIZE,))
+            values, indices, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+            expected_values, expected_inverse, expected_counts = np.unique(x.numpy(), return_inverse=True, return_counts=True)
+            self.assertEqual(values, expected_values)
+            self.assertEqual(indices, expected_inverse)
+            self.assertEqual(counts, expected_counts)
+
         def test_topk(self):
             def topKViaSort(t, k, dim, dir):
                 sorted, indices = t.sort(dim, dir)
@@ -1511,6 +1558,46 @@ class AbstractTestCases:
             self.assertEqual(seeded, reseeded, atol=0, rtol=0,
                              msg='repeated calls to manual_seed not generating same sequence of normally distributed numbers')
 
+        def test_philox_cpu_rng(self):
+            def generate():
+                torch.manual_seed(123)
+                return [torch.rand(10001), torch.rand(3001, dtype=torch.double),
+                        torch.randn(10001), torch.randn(7), torch.randn(100, 30).t_(),
+                        torch.empty(10001).bernoulli_(0.3),
+                        torch.bernoulli(torch.rand(1001, dtype=torch.double)),
+                        torch.empty(50, 40).t_().uniform_(-2, 3)]
+
+            num_threads = torch.get_num_threads()
+            torch.random.set_philox_cpu_rng(True)
+            try:
+                self.assertTrue(torch.random.is_philox_cpu_rng_enabled())
+                expected = generate()
+                torch.set_num_threads(1)
+                one_thread = generate()
+                torch.set_num_threads(max(2, num_threads))
+                many_threads = generate()
+
+                # the generator state is still the mt19937 one
+                state = torch.get_rng_state()
+                midstream = torch.rand(1000)
+                torch.set_rng_state(state)
+                repeat_midstream = torch.rand(1000)
+            finally:
+                torch.set_num_threads(num_threads)
+                torch.random.set_philox_cpu_rng(False)
+
+            for x, y, z in zip(expected, one_thread, many_threads):
+                self.assertEqual(x, y, atol=0, rtol=0)
+                self.assertEqual(x, z, atol=0, rtol=0)
+            self.assertEqual(midstream, repeat_midstream, atol=0, rtol=0)
+            uniform, _, normal, _, _, bernoulli, _, bounded = expected
+            self.assertTrue(((uniform >= 0) & (uniform < 1)).all())
+            self.assertEqual(uniform.mean().item(), 0.5, atol=0.02, rtol=0)
+            self.assertEqual(normal.mean().item(), 0, atol=0.05, rtol=0)
+            self.assertEqual(normal.std().item(), 1, atol=0.05, rtol=0)
+            self.assertEqual(bernoulli.mean().item(), 0.3, atol=0.02, rtol=0)
+            self.assertTrue(((bounded >= -2) & (bounded < 3)).all())
+
         def test_manual_seed(self):
             rng_state = torch.get_rng_state()
             torch.manual_seed(2)
@@ -2973,6 +3060,21 @@ class AbstractTestCases:
                                    "missing 1 required positional arguments",
                                    lambda: torch.tensor().new_zeros((5, 5), 0))
 
+        def test_parsing_overload_cache(self):
+            # The parser skips the overloads which failed before for arguments
+            # of the same types, which must not change the overload that
+            # binds when it depends on the values of the arguments.
+            x = torch.ones(5, 5)
+            for _ in range(3):
+                self.assertEqual(torch.cumsum(x, 0), torch.cumsum(x, torch.tensor(0)))
+                self.assertRaises(TypeError, lambda: torch.cumsum(x, torch.tensor(0.)))
+                self.assertEqual(torch.float64, x.to(torch.float64).dtype)
+                self.assertEqual(torch.float64, x.to(torch.ones(1, dtype=torch.float64)).dtype)
+                self.assertEqual(torch.Size([3, 4]), torch.ones(torch.tensor(3), torch.tensor(4)).shape)
+                self.assertRaises(TypeError, lambda: torch.ones(torch.tensor(3.), torch.tensor(4)))
+                self.assertEqual(x.add(torch.tensor(2)), x.add(2))
+                self.assertEqual(x.add(torch.tensor(2., requires_grad=True)), x.add(2))
+
         def test_half_tensor(self):
             x = torch.randn(5, 5).float()
             y = torch.randn(5, 5).float()
@@ -4128,6 +4230,52 @@ tensor([[[1.+1.j, 1.+1.j, 1.+1.j,  ..., 1.+1.j, 1.+1.j, 1.+1.j],
         def test_parallel_info(self):
             torch.__config__.parallel_info()
 
+        def test_numa_allocation(self):
+            prev = torch._C._get_numa_enabled()
+            try:
+                # stays off on builds or hosts without NUMA support
+                torch._C._set_numa_enabled(True)
+                # small and multi-page allocations on the current node
+                for numel in (3, 4096, 1 << 20):
+                    t = torch.arange(numel, dtype=torch.double)
+                    self.assertEqual(t.sum().item(), numel * (numel - 1) / 2)
+                torch._C._set_numa_enabled(False)
+                self.assertFalse(torch._C._get_numa_enabled())
+                self.assertEqual(torch._C._get_intraop_numa_node(), -1)
+                with self.assertRaisesRegex(RuntimeError, "non-negative"):
+                    torch._C._set_intraop_numa_node(-1)
+            finally:
+                torch._C._set_numa_enabled(prev)
+
+        def test_thread_cpus(self):
+            for get_cpus, set_cpus in ((torch._C._get_intraop_cpus, torch._C._set_intraop_cpus),
+                                       (torch._C._get_interop_cpus, torch._C._set_interop_cpus)):
+                self.assertIsInstance(get_cpus(), list)
+                with self.assertRaises(RuntimeError):
+                    set_cpus([])
+                with self.assertRaises(TypeError):
+                    set_cpus(["0"])
+                with self.assertRaises(TypeError):
+                    set_cpus(0)
+
+        def test_named_intraop_pool(self):
+            name = "test_named_intraop_pool"
+            torch._C._create_intraop_pool(name, 2)
+            with self.assertRaisesRegex(RuntimeError, "already exists"):
+                torch._C._create_intraop_pool(name, 2)
+            with self.assertRaisesRegex(RuntimeError, "Unknown intra-op pool"):
+                torch._C._set_current_intraop_pool("no_such_pool")
+            self.assertEqual(torch._C._get_current_intraop_pool(), "")
+            x = torch.randn(1 << 16, dtype=torch.double)
+            expected = x.sum()
+            try:
+                torch._C._set_current_intraop_pool(name)
+                self.assertEqual(torch._C._get_current_intraop_pool(), name)
+                self.assertEqual(x.sum(), expected)
+            finally:
+                torch._C._set_current_intraop_pool("")
+            self.assertEqual(torch._C._get_current_intraop_pool(), "")
+
         @slowTest
         def test_slow_test(self):
             # Just a smoketest to make sure our slowTest decorator works.
@@ -6828,6 +6976,54 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(torch.matmul(matrices, matrices_inverse),
                          torch.eye(3, dtype=torch.float64).to(device).expand_as(matrices))
 
+    @skipCUDAIfNoMagma
+    @skipCPUIfNoLapack
+    @dtypes(torch.float, torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        from torch.testing._internal.common_utils import random_fullrank_matrix_distinct_singular_value
+
+        # the sizes of at most 4 do not call LAPACK or MAGMA, 5 does
+        for n, batch in product(range(1, 6), [(), (1000,), (7, 3)]):
+            A = random_fullrank_matrix_distinct_singular_value(n, *batch, dtype=dtype).to(device)
+            eye = torch.eye(n, dtype=dtype, device=device).expand_as(A)
+            self.assertEqual(torch.matmul(A, torch.inverse(A)), eye)
+
+            b = torch.randn(*batch, n, 2, dtype=dtype, device=device)
+            x, LU = torch.solve(b, A)
+            self.assertEqual(torch.matmul(A, x), b)
+
+            A_LU, pivots, infos = torch.lu(A, get_infos=True)
+            self.assertEqual(LU, A_LU)
+            self.assertEqual(infos, torch.zeros_like(infos))
+            P, L, U = torch.lu_unpack(A_LU, pivots)
+            self.assertEqual(torch.matmul(P, torch.matmul(L, U)), A)
+
+            S = torch.matmul(A, A.transpose(-2, -1)) + eye
+            for upper in [True, False]:
+                C = torch.cholesky(S, upper=upper)
+                if upper:
+                    self.assertEqual(torch.matmul(C.transpose(-2, -1), C), S)
+                    self.assertEqual(C, C.triu())
+                else:
+                    self.assertEqual(torch.matmul(C, C.transpose(-2, -1)), S)
+                    self.assertEqual(C, C.tril())
+
+        empty = torch.empty(0, 3, 3, dtype=dtype, device=device)
+        self.assertEqual(torch.inverse(empty).shape, empty.shape)
+        self.assertEqual(torch.cholesky(empty).shape, empty.shape)
+
+        # the second matrix of the batch is singular, U(2, 2) is zero
+        A = torch.tensor([[[2., 1., 0.], [1., 3., 1.], [0., 1., 4.]],
+                          [[1., 2., 3.], [2., 4., 1.], [4., 8., 2.]]], dtype=dtype, device=device)
+        _, _, infos = torch.lu(A, get_infos=True)
+        self.assertEqual(infos.tolist(), [0, 2])
+        with self.assertRaisesRegex(RuntimeError, 'For batch 1: U\\(2,2\\) is zero'):
+            torch.inverse(A)
+        with self.assertRaisesRegex(RuntimeError, 'For batch 1: U\\(2,2\\) is zero'):
+            torch.solve(torch.ones(2, 3, 1, dtype=dtype, device=device), A)
+        with self.assertRaisesRegex(RuntimeError, 'For batch 0: U\\(1,1\\) is zero'):
+            torch.cholesky(-torch.eye(3, dtype=dtype, device=device).expand(2, 3, 3))
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -9449,6 +9645,39 @@ class TestTorchDeviceType(TestCase):
         run_test(torch.zeros(64, 61, dtype=dtype, device=device))
         run_test(torch.zeros(64, 1, dtype=dtype, device=device))
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double, torch.cfloat, torch.bool)
+    def test_elementwise_vectorize_broadcast(self, device, dtype):
+        def run_test(a, b):
+            # the reference only sees contiguous inputs of the result dtype
+            result_type = torch.result_type(a, b)
+            ref_a, ref_b = (t.contiguous().to(result_type) for t in torch.broadcast_tensors(a, b))
+            self.assertEqual(torch.mul(a, b), torch.mul(ref_a, ref_b))
+
+        def make(*shape, offset=0):
+            numel = reduce(operator.mul, shape, 1)
+            x = torch.randn(offset + numel, device=device)
+            x = x > 0 if dtype == torch.bool else x.to(dtype)
+            return x[offset:].view(shape)
+
+        for C in (64, 62, 61, 1):
+            x = make(513, C)
+            # bias along the leading dimension, vec 4, vec 2 and vec 1
+            run_test(x, make(C))
+            run_test(x, make(C, offset=2))
+            run_test(x, make(C, offset=1))
+            # broadcast scalar tensor
+            run_test(x, make(1))
+            run_test(make(1), x)
+            # broadcast along the innermost dimension takes the unrolled kernel
+            run_test(x.t(), make(513))
+        if dtype != torch.bool:
+            # mixed dtypes go through dynamic casting
+            x = make(513, 64)
+            run_test(x, torch.randn(64, device=device))
+            run_test(x, torch.randn(513, 64, device=device).half())
+            run_test(x, torch.tensor(3, device=device))
+
     @slowTest
     def test_argminmax_large_axis(self, device):
         # Regression test for gh-32863
@@ -12399,6 +12628,41 @@ class TestTorchDeviceType(TestCase):
         for i in range(idx.size(0)):
             self.assertEqual(dest[i], src[idx[i]])
 
+    @dtypes(torch.float, torch.double, torch.int64, torch.cfloat)
+    def test_index_add_index_select_many_rows(self, device, dtype):
+        # enough work to be split across threads, with both narrow rows
+        # (partitioned over the rows of dest) and wide rows (split by column)
+        def make(*size):
+            return torch.randint(-50, 50, size, device=device).to(dtype)
+
+        for row_size in (7, 65, 40000):
+            num_dest = 513
+            num_src = max(2 * 32768 // row_size, 4)
+            src = make(num_src, row_size)
+            idx = torch.randint(0, num_dest, (num_src,), device=device)
+            dest = make(num_dest, row_size)
+            expected = dest.clone()
+            for i, j in enumerate(idx.tolist()):
+                expected[j] += src[i]
+            self.assertEqual(dest.index_add_(0, idx, src), expected, atol=0, rtol=0)
+
+            selected = torch.index_select(dest, 0, idx)
+            self.assertEqual(selected, dest[idx], atol=0, rtol=0)
+
+        # index_add along an inner dimension whose slices are contiguous
+        src = make(1, 300, 40)
+        idx = torch.randint(0, 20, (300,), device=device)
+        dest = make(1, 20, 40)
+        expected = dest.clone()
+        for i, j in enumerate(idx.tolist()):
+            expected[0, j] += src[0, i]
+        self.assertEqual(dest.index_add_(1, idx, src), expected, atol=0, rtol=0)
+
+        # 1-D gather
+        src = make(100)
+        idx = torch.randint(0, 100, (70000,), device=device)
+        self.assertEqual(torch.index_select(src, 0, idx), src[idx], atol=0, rtol=0)
+
     def test_take_empty(self, device):
         for input_shape in [(0,), (0, 1, 2, 0), (1, 2, 3)]:
             for indices_shape in [(0,), (0, 1, 2, 0)]:
@@ -12494,6 +12758,44 @@ class TestTorchDeviceType(TestCase):
                          torch.tensor([[3], [1]], device=device,
                                       dtype=torch.float32).repeat(1, width))
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_index_add_scatter_add_deterministic(self, device, dtype):
+        # with the deterministic flag set both ops sum colliding indices in a
+        # fixed order, so repeated runs match bitwise
+        tol = dict(atol=1e-2, rtol=1e-3) if dtype == torch.half else {}
+        deterministic_restore = torch.is_deterministic()
+        torch.set_deterministic(True)
+        try:
+            src = torch.randn(4000, 33, device=device, dtype=dtype)
+            idx = torch.randint(0, 10, (4000,), device=device)
+            dest = torch.randn(10, 33, device=device, dtype=dtype)
+            expected = dest.double().index_add_(0, idx, src.double()).to(dtype)
+            res = dest.clone().index_add_(0, idx, src)
+            self.assertEqual(res, expected, **tol)
+            for _ in range(3):
+                self.assertEqual(dest.clone().index_add_(0, idx, src), res, atol=0, rtol=0)
+
+            # index_add along an inner dim
+            expected = dest.t().double().index_add_(1, idx, src.t().double()).to(dtype)
+            res = dest.t().clone().index_add_(1, idx, src.t())
+            self.assertEqual(res, expected, **tol)
+
+            # index smaller than src along the other dim
+            src = torch.randn(300, 70, device=device, dtype=dtype)
+            idx = torch.randint(0, 5, (300, 40), device=device)
+            dest = torch.randn(5, 40, device=device, dtype=dtype)
+            expected = dest.double().scatter_add_(0, idx, src.double()).to(dtype)
+            res = dest.clone().scatter_add_(0, idx, src)
+            self.assertEqual(res, expected, **tol)
+            for _ in range(3):
+                self.assertEqual(dest.clone().scatter_add_(0, idx, src), res, atol=0, rtol=0)
+
+            with self.assertRaisesRegex(IndexError, "index out of range"):
+                dest.scatter_add_(0, torch.full_like(idx, 5), src)
+        finally:
+            torch.set_deterministic(deterministic_restore)
+
     @onlyCPU
     def test_scatter_reduce_non_unique_index(self, device):
         height = 2
@@ -14184,6 +14486,32 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    @onlyCUDA
+    @dtypes(torch.float, torch.double, torch.int32, torch.int64)
+    def test_sort_topk_many_rows(self, device, dtype):
+        # slices around the tile sizes of the segmented sort, past its limit,
+        # and laid out along a non-innermost dim
+        for n in (1, 5, 100, 129, 1000, 2049, 4096, 8192, 9000):
+            if dtype.is_floating_point:
+                x = torch.randn(300, n, device=device, dtype=dtype)
+                x[::7, ::3] = float('nan')
+                x[::5, 1::4] = -float('inf')
+            else:
+                # few distinct values so that there are plenty of ties
+                x = torch.randint(-5, 5, (300, n), device=device, dtype=dtype)
+            for t, dim in ((x, 1), (x.t(), 0)):
+                for descending in (False, True):
+                    values, indices = t.sort(dim, descending)
+                    expected, _ = t.cpu().sort(dim, descending)
+                    self.assertEqual(values, expected, atol=0, rtol=0)
+                    self.assertEqual(t.gather(dim, indices), values, atol=0, rtol=0)
+                k = min(n, 10)
+                for largest in (False, True):
+                    values, indices = t.topk(k, dim, largest)
+                    expected, _ = t.cpu().topk(k, dim, largest)
+                    self.assertEqual(values, expected, atol=0, rtol=0)
+                    self.assertEqual(t.gather(dim, indices), values, atol=0, rtol=0)
+
 
 
 
@@ -14690,6 +15018,37 @@ class TestTorchDeviceType(TestCase):
             self._test_unique_with_expects(device, dtype, f, x, expected_unique, expected_inverse, expected_counts, (3, 3))
             self._test_unique_scalar_empty(dtype, device, f)
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @dtypes(torch.bool, torch.uint8, torch.int64, torch.float)
+    def test_unique_large(self, device, dtype):
+        # Large enough to be split across chunks and hash partitions
+        size = 200003
+        if dtype is torch.bool:
+            x = torch.randint(0, 2, (size,), device=device).bool()
+        else:
+            x = torch.randint(0, 20000 if dtype.is_floating_point or dtype is torch.int64 else 200,
+                              (size,), device=device).to(dtype)
+        x_np = x.cpu().numpy()
+        expected_unique, expected_inverse, expected_counts = np.unique(x_np, return_inverse=True, return_counts=True)
+
+        unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.cpu().numpy(), expected_unique)
+        self.assertEqual(inverse.cpu().numpy(), expected_inverse)
+        self.assertEqual(counts.cpu().numpy(), expected_counts)
+
+        unique, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(unique[inverse], x)
+        self.assertEqual(torch.sort(unique)[0].cpu().numpy(), expected_unique)
+        self.assertEqual(counts, torch.bincount(inverse, minlength=unique.numel()))
+
+        y = x.sort()[0] if dtype is not torch.bool else x
+        unique, inverse, counts = torch.unique_consecutive(y, return_inverse=True, return_counts=True)
+        starts = torch.cat([torch.ones(1, dtype=torch.bool, device=device), y[1:] != y[:-1]])
+        self.assertEqual(unique, y[starts])
+        self.assertEqual(inverse, starts.long().cumsum(0) - 1)
+        self.assertEqual(counts.sum().item(), size)
+        self.assertEqual(unique.repeat_interleave(counts), y)
+
     @dtypesIfCUDA(torch.half, torch.float, torch.double)
     @dtypes(torch.float, torch.double)
     def test_erfinv(self, device, dtype):
@@ -14987,6 +15346,28 @@ class TestTorchDeviceType(TestCase):
     def test_amax(self, device, dtype):
         self._test_minmax_helper(torch.amax, np.amax, device, dtype)
 
+    @onlyOnCPUAndCUDA
+    @dtypesIfCPU(torch.float, torch.double, torch.int, torch.long, torch.bool)
+    @dtypesIfCUDA(torch.half, torch.float, torch.int, torch.long, torch.bool)
+    @dtypes(torch.float, torch.double)
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_aminmax(self, device, dtype):
+        self._test_minmax_helper(lambda *args: torch._aminmax(*args)[0], np.amin, device, dtype, skip_indices=True)
+        self._test_minmax_helper(lambda *args: torch._aminmax(*args)[1], np.amax, device, dtype, skip_indices=True)
+
+        if dtype.is_floating_point:
+            x = torch.randn(4, 5, 6, device=device, dtype=dtype)
+        else:
+            x = torch.randint(0 if dtype == torch.bool else -9, 2 if dtype == torch.bool else 9,
+                              (4, 5, 6), device=device, dtype=dtype)
+        for dim, keepdim in product([(), 0, 2, (0, 1)], [False, True]):
+            min_, max_ = torch._aminmax(x, dim, keepdim)
+            self.assertEqual(min_, torch.amin(x, dim, keepdim), atol=0, rtol=0)
+            self.assertEqual(max_, torch.amax(x, dim, keepdim), atol=0, rtol=0)
+
+        with self.assertRaisesRegex(RuntimeError, "does not have an identity"):
+            torch._aminmax(torch.empty(0, 3, device=device, dtype=dtype), 0)
+
     @onlyOnCPUAndCUDA
     @dtypesIfCPU(torch.float, torch.double)
     @dtypesIfCUDA(torch.half, torch.float)
@@ -16204,6 +16585,31 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
                                 res2[i, j] += m1[i, l] * m2[l, j]
                     self.assertEqual(res1, res2)
 
+    @dtypes(torch.float, torch.double)
+    @tf32_on_and_off(0.005)
+    def test_addmm_activation(self, device, dtype):
+        bias = torch.randn(25, device=device, dtype=dtype)
+        for use_gelu in (False, True):
+            activation = torch.nn.functional.gelu if use_gelu else torch.relu
+            # row and column major matrices, and a bias which is not a vector
+            for m1, m2, M in ((torch.randn(10, 50), torch.randn(50, 25), bias),
+                              (torch.randn(50, 10).t(), torch.randn(25, 50).t(), bias),
+                              (torch.randn(10, 50), torch.randn(50, 25), torch.randn(10, 25))):
+                m1 = m1.to(device=device, dtype=dtype)
+                m2 = m2.to(device=device, dtype=dtype)
+                M = M.to(device=device, dtype=dtype)
+                res = torch._addmm_activation(M, m1, m2, use_gelu=use_gelu)
+                self.assertEqual(res, activation(torch.addmm(M, m1, m2)))
+                res = torch._addmm_activation(M, m1, m2, beta=0.5, alpha=2, use_gelu=use_gelu)
+                self.assertEqual(res, activation(torch.addmm(M, m1, m2, beta=0.5, alpha=2)))
+
+            if dtype == torch.double:
+                inputs = (bias.clone().requires_grad_(),
+                          torch.randn(4, 3, device=device, dtype=dtype, requires_grad=True),
+                          torch.randn(3, 25, device=device, dtype=dtype, requires_grad=True))
+                self.assertTrue(torch.autograd.gradcheck(
+                    lambda M, m1, m2: torch._addmm_activation(M, m1, m2, alpha=0.5, use_gelu=use_gelu), inputs))
+
     @onlyCPU
     @dtypes(*(torch.testing.get_all_complex_dtypes() + [torch.float, torch.double]))
     def test_dot(self, device, dtype):
@@ -16855,6 +17261,46 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
 
             _test_mm(n, m, p, dtype, genf)
 
+    @onlyOnCPUAndCUDA
+    @dtypes(torch.float32, torch.float64)
+    @dtypesIfCUDA(torch.float16, torch.float32, torch.float64)
+    @tf32_on_and_off(0.01)
+    def test_grouped_mm(self, device, dtype):
+        def gen(*size):
+            return torch.randn(*size, device=device, dtype=dtype)
+
+        # repeated shapes share a batched call, transposed and strided views
+        # and empty products are handled on the side
+        shapes = [(8, 16, 4), (32, 8, 24), (8, 16, 4), (1, 5, 7), (8, 16, 4), (0, 3, 2), (4, 0, 3)]
+        self_list = [gen(m, k) for m, k, n in shapes]
+        mat2_list = [gen(k, n) for m, k, n in shapes]
+        self_list.append(gen(12, 6).t())
+        mat2_list.append(gen(7, 12).t())
+        self_list.append(gen(10, 20)[:, :8])
+        mat2_list.append(gen(6, 8).t())
+        self_list.append(gen(5, 8))
+        mat2_list.append(gen(8, 1).expand(8, 3))
+
+        tol = dict(atol=1e-2, rtol=1e-2) if dtype == torch.half else {}
+        res = torch.grouped_mm(self_list, mat2_list)
+        self.assertEqual(len(res), len(self_list))
+        for a, b, r in zip(self_list, mat2_list, res):
+            self.assertEqual(r, torch.mm(a, b), **tol)
+
+        self.assertEqual(torch.grouped_mm([], []), [])
+        with self.assertRaisesRegex(RuntimeError, "same number of tensors"):
+            torch.grouped_mm(self_list, mat2_list[1:])
+
+        # pairs that require grad go through mm
+        a = gen(3, 4).requires_grad_()
+        b = gen(4, 5).requires_grad_()
+        c = gen(2, 4)
+        d = gen(4, 2).requires_grad_()
+        res = torch.grouped_mm([a, c], [b, d])
+        (res[0].sum() + res[1].sum()).backward()
+        self.assertEqual(a.grad, torch.ones(3, 5, device=device, dtype=dtype).mm(b.t()), **tol)
+        self.assertEqual(d.grad, c.t().mm(torch.ones(2, 2, device=device, dtype=dtype)), **tol)
+
     @onlyOnCPUAndCUDA
     @dtypes(torch.float32, torch.float64)
     @unittest.skipIf(not TEST_NUMPY, "NumPy not found")
@@ -17464,6 +17910,27 @@ else:
         self.assertRaises(RuntimeError, lambda: torch.cat([]))
         self.assertRaisesRegex(TypeError, 'got None', lambda: torch.cat([x, None]))
 
+    @onlyCPU
+    @dtypes(torch.bool, torch.half, torch.float, torch.int64, torch.cfloat)
+    def test_cat_many_inputs(self, device, dtype):
+        # Large enough, and with enough inputs, to run the block copies in parallel
+        widths = [1, 3, 16, 0, 7] * 40
+        for dim in range(3):
+            tensors = []
+            for w in widths:
+                size = [64, 5, 9]
+                size[dim] = w
+                tensors.append(torch.randint(0, 2 if dtype is torch.bool else 100, size, device=device).to(dtype))
+            res = torch.cat(tensors, dim)
+            self.assertEqual(res.size(dim), sum(widths))
+            self.assertEqual(list(res.split(widths, dim)), tensors, atol=0, rtol=0)
+
+        tensors = [torch.randn(8, w, 6, 6, device=device).to(dtype).contiguous(memory_format=torch.channels_last)
+                   for w in (1, 5, 32, 2)]
+        res = torch.cat(tensors, 1)
+        self.assertTrue(res.is_contiguous(memory_format=torch.channels_last))
+        self.assertEqual(res, torch.cat([t.contiguous() for t in tensors], 1), atol=0, rtol=0)
+
     @onlyCPU
     def test_cat_scalars(self, device):
         x = torch.tensor(0, device=device)
@@ -17697,6 +18164,64 @@ else:
         t_copy.abs_()
         self.assertEqual(t, t_copy)
 
+    @dtypes(torch.float, torch.double)
+    def test_segment_reduce(self, device, dtype):
+        def reference(data, reduce, offsets, axis):
+            ops = {'sum': lambda x: x.sum(axis, keepdim=True),
+                   'mean': lambda x: x.mean(axis, keepdim=True),
+                   'max': lambda x: x.amax(axis, keepdim=True),
+                   'min': lambda x: x.amin(axis, keepdim=True)}
+            empty = {'sum': 0, 'mean': nan, 'max': -inf, 'min': inf}
+            segments = []
+            for start, stop in zip(offsets[:-1].tolist(), offsets[1:].tolist()):
+                segment = data.narrow(axis, start, stop - start)
+                if stop == start:
+                    sizes = list(data.shape)
+                    sizes[axis] = 1
+                    segments.append(torch.full(sizes, empty[reduce], device=device, dtype=dtype))
+                else:
+                    segments.append(ops[reduce](segment))
+            return torch.cat(segments, axis)
+
+        # few long segments, many short ones and empty ones, with and without inner dimension
+        lengths = ([40, 60], [1, 0, 3, 2] * 20, [0, 5, 0])
+        for reduce in ('sum', 'mean', 'max', 'min'):
+            for segment_lengths in lengths:
+                offsets = torch.tensor([0] + segment_lengths, device=device).cumsum(0)
+                size = sum(segment_lengths)
+                for shape, axis in (((size,), 0), ((3, size), 1), ((size, 4), 0), ((2, size, 5), -2)):
+                    data = torch.randn(shape, device=device, dtype=dtype)
+                    self.assertEqual(torch.segment_reduce(data, reduce, offsets=offsets, axis=axis),
+                                     reference(data, reduce, offsets, axis))
+
+        data = torch.tensor([1., nan, 3., 4.], device=device, dtype=dtype)
+        offsets = torch.tensor([0, 2, 4], device=device)
+        self.assertEqual(torch.segment_reduce(data, 'max', offsets=offsets),
+                         torch.tensor([nan, 4.], device=device, dtype=dtype))
+
+        with self.assertRaisesRegex(RuntimeError, "must start at 0"):
+            torch.segment_reduce(data, 'sum', offsets=torch.tensor([1, 4], device=device))
+        with self.assertRaisesRegex(RuntimeError, "non decreasing"):
+            torch.segment_reduce(data, 'sum', offsets=torch.tensor([0, 3, 1, 4], device=device))
+        with self.assertRaisesRegex(RuntimeError, "reduce must be one of"):
+            torch.segment_reduce(data, 'prod', offsets=offsets)
+
+        if dtype == torch.double:
+            offsets = torch.tensor([0, 2, 2, 5], device=device)
+            for reduce in ('sum', 'mean', 'max', 'min'):
+                data = torch.randn(3, 5, device=device, dtype=dtype, requires_grad=True)
+                self.assertTrue(torch.autograd.gradcheck(
+                    lambda x: torch.segment_reduce(x, reduce, offsets=offsets, axis=1), (data,)))
+
+    @onlyCUDA
+    @dtypes(torch.half, torch.float)
+    def test_sum_short_rows(self, device, dtype):
+        # rows shorter than a warp, which are reduced by a thread or a few lanes each
+        for n in (1, 3, 16, 17, 100, 128, 129):
+            x = torch.randn(1000, n, device=device, dtype=dtype)
+            self.assertEqual(x.sum(-1), x.double().sum(-1).to(dtype), atol=1e-2 * n, rtol=0)
+            self.assertEqual(x.amax(-1), x.float().amax(-1).to(dtype))
+
     def test_bucketization(self, device):
         values_1d = torch.tensor([1, 2, 3, 4, 5, 6, 7, 8, 9], device=device)
         values_3d = torch.tensor([[[1, 3, 5], [2, 4, 6]], [[1, 2, 3], [4, 5, 6]]], device=device)
@@ -18531,6 +19056,20 @@ class TestDevicePrecision(TestCase):
         self.assertEqual(x.sum(dim=(-1, -2)).cpu(), y.sum(dim=(-1, -2)))
         self.assertEqual(x.sum(dim=(1, 3)).cpu(), y.sum(dim=(1, 3)))
 
+    @onlyCPU
+    def test_sum_bfloat16_accumulate(self, device):
+        # BFloat16 sums accumulate in fp32, so long reductions don't stall once
+        # the partial sum outgrows the 8-bit mantissa
+        x = torch.ones(3, 40001, dtype=torch.bfloat16, device=device)
+        for dim in (None, 0, 1):
+            res = x.sum() if dim is None else x.sum(dim)
+            expected = x.float().sum() if dim is None else x.float().sum(dim)
+            self.assertEqual(res.dtype, torch.bfloat16)
+            self.assertEqual(res, expected, atol=0, rtol=1e-2, exact_dtype=False)
+        y = torch.randn(257, 35, device=device).bfloat16()
+        self.assertEqual(y.sum(0), y.float().sum(0), atol=1e-1, rtol=1e-2, exact_dtype=False)
+        self.assertEqual(y.t().sum(1), y.float().t().sum(1), atol=1e-1, rtol=1e-2, exact_dtype=False)
+
     def test_device_serialization(self, device):
         x = torch.randn(4, 4, device=device)
 
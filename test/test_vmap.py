@@ -475,6 +475,18 @@ class TestVmapAPI(TestCase):
         result = vmap(vmap(vmap(op)))(x, y)
         self.assertEqual(result, op(x, y.view(100, 10, 10, 1)))
 
+    def test_fallback_counts(self):
+        # NB: uses torch.atan2 for the same reason as test_fallback_atan2.
+        x = torch.randn(5, 7)
+        torch._C._vmap_reset_fallback_counts()
+        with warnings.catch_warnings(record=True):
+            vmap(torch.atan2)(x, x)
+            vmap(torch.atan2)(x, x)
+            vmap(torch.mul)(x, x)
+        self.assertEqual(torch._C._vmap_fallback_counts(), {'aten::atan2': 2})
+        torch._C._vmap_reset_fallback_counts()
+        self.assertEqual(torch._C._vmap_fallback_counts(), {})
+
     def test_fallback_masked_fill(self):
         # NB: One day we will implement a batching rule for masked_fill
         # If/when we do, this test should be replaced to test the fallback
@@ -1083,6 +1095,165 @@ class TestVmapOperators(TestCase):
              (torch.rand(B1, B2, B0, 3, 2, 5), torch.rand(B0, 3 * 2 * 5)),
              in_dims=(2, 0))
 
+    def test_matmul_family(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+
+        self._assert_doesnt_use_vmap_fallback(
+            [torch.matmul], [torch.rand(B0, 2, 3), torch.rand(B0, 3, 5)])
+
+        # matmul of every combination of 1D, 2D and 3D logical tensors
+        for self_shape, other_shape in [
+                ([3], [3]), ([3], [3, 5]), ([2, 3], [3]), ([2, 3], [3, 5]),
+                ([4, 2, 3], [3]), ([3], [4, 3, 5]), ([4, 2, 3], [3, 5]), ([4, 2, 3], [4, 3, 5])]:
+            x = torch.rand([B0] + self_shape)
+            y = torch.rand([B0] + other_shape)
+            test(torch.matmul, (x, y))
+            test(torch.matmul, (x, y[0]), in_dims=(0, None))
+            test(torch.matmul, (x[0], y), in_dims=(None, 0))
+            test(vmap(torch.matmul, in_dims=(0, None)),
+                 (torch.rand([B1, B0] + self_shape), y), in_dims=(1, 0))
+
+        test(torch.mm, (torch.rand(B0, 2, 3), torch.rand(3, 5)), in_dims=(0, None))
+        test(torch.mm, (torch.rand(2, 3), torch.rand(5, 3, B0)), in_dims=(None, 2))
+        test(torch.mv, (torch.rand(B0, 2, 3), torch.rand(B0, 3)))
+        test(torch.dot, (torch.rand(B0, 3), torch.rand(3)), in_dims=(0, None))
+        test(vmap(torch.dot), (torch.rand(B1, B0, 3), torch.rand(B0, B1, 3)), in_dims=(1, 0))
+        test(torch.bmm, (torch.rand(B0, 4, 2, 3), torch.rand(4, 3, 5)), in_dims=(0, None))
+
+        # addmm, with the inputs of linear and with everything batched
+        addmm = torch.addmm
+        test(addmm, (torch.rand(5), torch.rand(B0, 2, 3), torch.rand(3, 5)), in_dims=(None, 0, None))
+        test(addmm, (torch.rand(B0, 2, 5), torch.rand(B0, 2, 3), torch.rand(B0, 3, 5)))
+        test(lambda *args: addmm(*args, beta=0.5, alpha=2.), (torch.rand(B0, 1, 5), torch.rand(2, 3), torch.rand(3, 5)),
+             in_dims=(0, None, None))
+        test(lambda *args: addmm(*args, beta=0), (torch.rand(5), torch.rand(2, 3), torch.rand(B0, 3, 5)),
+             in_dims=(None, None, 0))
+
+        # linear, batched over the input or over the weight and bias
+        linear = torch.nn.functional.linear
+        test(linear, (torch.rand(B0, 2, 3), torch.rand(5, 3)), in_dims=(0, None))
+        test(linear, (torch.rand(B0, 2, 3), torch.rand(5, 3), torch.rand(5)), in_dims=(0, None, None))
+        test(linear, (torch.rand(B0, 4, 2, 3), torch.rand(5, 3), torch.rand(5)), in_dims=(0, None, None))
+        test(linear, (torch.rand(2, 3), torch.rand(B0, 5, 3), torch.rand(B0, 5)), in_dims=(None, 0, 0))
+        test(vmap(linear, in_dims=(0, None, None)),
+             (torch.rand(B1, B0, 2, 3), torch.rand(5, 3), torch.rand(5)), in_dims=(1, None, None))
+
+    def test_conv2d(self):
+        test = self._vmap_test
+        conv2d = torch.nn.functional.conv2d
+        B0, B1 = 3, 2
+
+        self._assert_doesnt_use_vmap_fallback(
+            [conv2d, (0, None)], [torch.rand(B0, 2, 4, 6, 6), torch.rand(5, 4, 3, 3)])
+
+        test(conv2d, (torch.rand(B0, 2, 4, 6, 6), torch.rand(5, 4, 3, 3), torch.rand(5)),
+             in_dims=(0, None, None))
+        test(lambda x, w: conv2d(x, w, stride=2, padding=1, groups=2),
+             (torch.rand(2, B0, 4, 7, 7), torch.rand(6, 2, 3, 3)), in_dims=(1, None))
+        test(conv2d, (torch.rand(2, 4, 6, 6), torch.rand(B0, 5, 4, 3, 3), torch.rand(B0, 5)),
+             in_dims=(None, 0, 0))
+        test(lambda x, w, b: conv2d(x, w, b, dilation=2, groups=2),
+             (torch.rand(B0, 2, 4, 7, 7), torch.rand(B0, 6, 2, 3, 3), torch.rand(6)),
+             in_dims=(0, 0, None))
+        test(vmap(conv2d, in_dims=(0, None)),
+             (torch.rand(B1, B0, 2, 4, 6, 6), torch.rand(B0, 5, 4, 3, 3)), in_dims=(1, 0))
+
+    def test_embedding(self):
+        test = self._vmap_test
+        embedding = torch.nn.functional.embedding
+        B0, B1 = 5, 3
+
+        self._assert_doesnt_use_vmap_fallback(
+            [embedding, (0, None)], [torch.randint(10, (B0, 4)), torch.rand(10, 3)])
+
+        test(embedding, (torch.randint(10, (B0, 4)), torch.rand(10, 3)),
+             in_dims=(0, None), check_propagates_grad=False)
+        test(embedding, (torch.randint(10, (4,)), torch.rand(B0, 10, 3)),
+             in_dims=(None, 0), check_propagates_grad=False)
+        test(embedding, (torch.randint(10, (B0, 2, 4)), torch.rand(10, B0, 3)),
+             in_dims=(0, 1), check_propagates_grad=False)
+        test(vmap(embedding), (torch.randint(10, (B1, B0, 4)), torch.rand(B0, B1, 10, 3)),
+             in_dims=(1, 0), check_propagates_grad=False)
+
+        # no gradient for the padding_idx rows of a batched weight
+        weight = torch.rand(B0, 10, 3, requires_grad=True)
+        indices = torch.tensor([[0, 2, 2, 1]] * B0)
+        result = vmap(lambda i, w: embedding(i, w, padding_idx=2))(indices, weight)
+        self.assertEqual(result, torch.stack([embedding(indices[0], w) for w in weight]))
+        result.sum().backward()
+        expected_grad = torch.zeros(B0, 10, 3)
+        expected_grad[:, 0] = 1
+        expected_grad[:, 1] = 1
+        self.assertEqual(weight.grad, expected_grad)
+
+    def test_index_select_and_gather(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+
+        self._assert_doesnt_use_vmap_fallback(
+            [torch.index_select, (0, None, 0)], [torch.rand(B0, 5, 3), 0, torch.randint(5, (B0, 2))])
+
+        index = torch.tensor([4, 0, 2])
+        test(torch.index_select, (torch.rand(B0, 5, 3), 0, index), in_dims=(0, None, None))
+        test(torch.index_select, (torch.rand(5, B0, 3), -1, torch.randint(3, (B0, 4))), in_dims=(1, None, 0))
+        test(torch.index_select, (torch.rand(5, 3), 0, torch.randint(5, (B0, 4))), in_dims=(None, None, 0))
+        test(vmap(torch.index_select, in_dims=(0, None, 0)),
+             (torch.rand(B1, B0, 5, 3), 1, torch.randint(3, (B0, B1, 2))), in_dims=(1, None, 1))
+
+        test(torch.gather, (torch.rand(B0, 5, 3), 1, torch.randint(3, (B0, 5, 2))))
+        test(torch.gather, (torch.rand(B0, 5, 3), 0, torch.randint(5, (2, 3))), in_dims=(0, None, None))
+        test(vmap(torch.gather, in_dims=(0, None, None)),
+             (torch.rand(B1, B0, 5, 3), -1, torch.randint(3, (5, 4))), in_dims=(1, None, None))
+
+    def test_layer_norm(self):
+        test = self._vmap_test
+        layer_norm = torch.nn.functional.layer_norm
+        B0, B1 = 7, 11
+
+        self._assert_doesnt_use_vmap_fallback(
+            [lambda x: layer_norm(x, (3,))], [torch.rand(B0, 2, 3)])
+
+        test(lambda x, w, b: layer_norm(x, (3,), w, b), (torch.rand(B0, 2, 3), torch.rand(3), torch.rand(3)),
+             in_dims=(0, None, None))
+        test(lambda x: layer_norm(x, (2, 3)), (torch.rand(4, B0, 2, 3),), in_dims=1)
+        test(lambda x, w, b: layer_norm(x, (3,), w, b), (torch.rand(2, 3), torch.rand(B0, 3), torch.rand(B0, 3)),
+             in_dims=(None, 0, 0))
+        test(lambda x, w: layer_norm(x, (3,), w), (torch.rand(B0, 2, 3), torch.rand(3, B0)), in_dims=(0, 1))
+        test(vmap(lambda x: layer_norm(x, (3,))), (torch.rand(B1, B0, 2, 3),), in_dims=1)
+
+    def test_reductions(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+
+        self._assert_doesnt_use_vmap_fallback([torch.sum], [torch.rand(B0, 3)])
+
+        for op in [torch.sum, torch.mean, torch.logsumexp, torch.amax]:
+            test(lambda x: op(x, 0), (torch.rand(B0, 2, 3),))
+            test(lambda x: op(x, [0, -1], keepdim=True), (torch.rand(2, B0, 3, 5),), in_dims=1)
+            test(lambda x: op(x, -1), (torch.rand(B0),))
+            test(vmap(lambda x: op(x, 1)), (torch.rand(B1, 2, B0, 3),), in_dims=2)
+
+        # reduce over all of the logical dims, and never over the batch dims
+        test(torch.sum, (torch.rand(B0, 2, 3),))
+        test(torch.mean, (torch.rand(2, B0, 3),), in_dims=1)
+        test(lambda x: torch.sum(x, []), (torch.rand(B0, 2, 3),))
+        test(lambda x: torch.amax(x, []), (torch.rand(B0, 2, 3),))
+        test(vmap(torch.sum), (torch.rand(B0, B1, 3),))
+        test(torch.sum, (torch.rand(B0),))
+
+    def test_softmax(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+
+        self._assert_doesnt_use_vmap_fallback([lambda x: torch.softmax(x, -1)], [torch.rand(B0, 3)])
+
+        for op in [torch.softmax, torch.log_softmax]:
+            test(lambda x: op(x, 0), (torch.rand(B0, 2, 3),))
+            test(lambda x: op(x, -1), (torch.rand(2, B0, 3),), in_dims=1)
+            test(lambda x: op(x, 0), (torch.rand(B0),))
+            test(vmap(lambda x: op(x, 0)), (torch.rand(B1, 2, B0),), in_dims=2)
+
     def test_no_random_op_support(self):
         B0 = 2
 
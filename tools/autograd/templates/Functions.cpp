@@ -761,6 +761,24 @@ Tensor evenly_distribute_backward(Tensor grad, const Tensor & input, const Tenso
   }
 }
 
+// Like amax and amin, max and min split the gradient of a segment evenly
+// between its values equal to the result.
+Tensor segment_reduce_backward(const Tensor & grad, const Tensor & result, const Tensor & data, const std::string & reduce, const Tensor & offsets, int64_t axis) {
+  axis = at::maybe_wrap_dim(axis, data.dim());
+  auto lengths = offsets.slice(0, 1) - offsets.slice(0, 0, -1);
+  if (reduce == "sum") {
+    return grad.repeat_interleave(lengths, axis);
+  }
+  if (reduce == "mean") {
+    std::vector<int64_t> shape(data.dim(), 1);
+    shape[axis] = -1;
+    return (grad / lengths.view(shape).to(grad.scalar_type())).repeat_interleave(lengths, axis);
+  }
+  auto mask = (data == result.repeat_interleave(lengths, axis)).to(grad.scalar_type());
+  auto count = at::segment_reduce(mask, "sum", offsets, axis);
+  return (grad / count).repeat_interleave(lengths, axis) * mask;
+}
+
 Tensor index_select_backward(Tensor grad, int64_t dim, Tensor indices, IntArrayRef sizes, bool keepdim) {
   if (!keepdim && sizes.size() > 0) {
     grad = grad.unsqueeze(dim);
@@ -978,6 +996,37 @@ Tensor infinitely_differentiable_gelu_backward(
   return cdf.addcmul_(self, pdf, kAlpha).mul_(grad);
 }
 
+std::tuple<Tensor, Tensor, Tensor> addmm_activation_backward(
+    const Tensor& grad,
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Scalar& beta,
+    const Scalar& alpha,
+    bool use_gelu,
+    const Tensor& result,
+    std::array<bool, 3> grad_input_mask) {
+  // The input of gelu is not saved, so compute it again
+  Tensor grad_mm;
+  if (use_gelu) {
+    const Tensor mm = at::addmm(self, mat1, mat2, beta, alpha);
+    grad_mm = GradMode::is_enabled() ? infinitely_differentiable_gelu_backward(grad, mm) : at::gelu_backward(grad, mm);
+  } else {
+    grad_mm = at::threshold_backward(grad, result, 0);
+  }
+  Tensor grad_self, grad_mat1, grad_mat2;
+  if (grad_input_mask[0]) {
+    grad_self = maybe_multiply(grad_mm, beta);
+  }
+  if (grad_input_mask[1]) {
+    grad_mat1 = mm_mat1_backward(grad_mm, mat2, mat1, alpha);
+  }
+  if (grad_input_mask[2]) {
+    grad_mat2 = mm_mat2_backward(grad_mm, mat1, mat2.sizes(), mat2.strides(), alpha);
+  }
+  return std::make_tuple(grad_self, grad_mat1, grad_mat2);
+}
+
 Tensor infinitely_differentiable_silu_backward(
     const Tensor& grad_output,
     const Tensor& input) {
@@ -1078,6 +1127,13 @@ Tensor log_softmax_double_backward(const Tensor & grad, const Tensor & grad_outp
   return z * grad_output.sum(dim, true) * ((grad * z).sum(dim, true) - grad);
 }
 
+// Backward of nll_loss(log_softmax(self, 1)), written with differentiable ops
+// so double backward works. Only the backward pays for a softmax of self.
+Tensor log_softmax_nll_loss_backward(const Tensor & grad, const Tensor & self, const Tensor & target, const c10::optional<Tensor>& weight, int64_t reduction, int64_t ignore_index, const Tensor & total_weight) {
+  auto grad_log_probs = at::nll_loss_backward(grad, self, target, weight, reduction, ignore_index, total_weight);
+  return grad_log_probs - at::softmax(self, 1) * grad_log_probs.sum(1, true);
+}
+
 Tensor binary_cross_entropy_double_backward(const Tensor & grad_output, const Tensor & grad, const Tensor & input, const Tensor & target, const c10::optional<Tensor>& weight, int64_t reduction) {
   auto eps = 1e-12;
   auto inp_pl_eps = input + eps;
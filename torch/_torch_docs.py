@@ -9106,6 +9106,44 @@ Example::
             [1, 3, 4]])
 """)
 
+add_docstr(torch.segment_reduce,
+           r"""
+segment_reduce(data, reduce, *, offsets, axis=0) -> Tensor
+
+Reduces the consecutive segments of :attr:`data` along dimension :attr:`axis`.
+Segment ``i`` is made of the slices ``offsets[i]`` to ``offsets[i + 1] - 1``
+of :attr:`data` in :attr:`axis`, so the result has the size of :attr:`data`,
+except for :attr:`axis`, where it has ``offsets.numel() - 1`` elements.
+
+The sum of an empty segment is 0 and its mean is NaN, its maximum is ``-inf``
+and its minimum is ``inf``. The maximum and the minimum propagate NaN.
+
+This is faster than masking :attr:`data` or calling a reduction once per
+segment, in particular for many short segments.
+
+.. note:: The offsets are checked on the host, which synchronizes with the
+          device when they are on a CUDA device.
+
+Args:
+    data (Tensor): the floating point tensor to reduce
+    reduce (str): the reduction, one of ``"sum"``, ``"mean"``, ``"max"`` or ``"min"``
+
+Keyword args:
+    offsets (LongTensor): the 1-D tensor of the starts of the segments, followed by
+                          ``data.size(axis)``. It starts at 0, is non decreasing and is
+                          on the device of :attr:`data`.
+    axis (int, optional): the dimension to reduce. Default: 0
+
+Example::
+
+    >>> data = torch.tensor([1., 2., 3., 4., 5., 6.])
+    >>> offsets = torch.tensor([0, 2, 2, 6])
+    >>> torch.segment_reduce(data, "sum", offsets=offsets)
+    tensor([ 3.,  0., 18.])
+    >>> torch.segment_reduce(data, "max", offsets=offsets)
+    tensor([2., -inf, 6.])
+""")
+
 add_docstr(torch.bucketize,
            r"""
 bucketize(input, boundaries, out_int32=False, right=False, out=None) -> Tensor
@@ -0,0 +1,159 @@
+import torch
+import weakref
+
+from typing import Any, Callable, List, Optional
+
+
+class saved_tensors_hooks(object):
+    r"""Context-manager that sets a pair of pack / unpack hooks for saved tensors.
+
+    Use this context-manager to define how the tensors an operation saves for
+    backward are stored, for example to move them off the device during the
+    forward pass and bring them back in the backward pass.
+
+    ``pack_hook`` is called with a tensor, detached, every time an operation
+    run inside the context saves it for backward, and may return any object.
+    ``unpack_hook`` gets that object back every time the backward pass needs
+    the tensor, and has to return a tensor with the same content. Tensors
+    saved while a pack hook runs are stored as usual, so that the hooks can
+    use autograd operations themselves.
+
+    Dropping activations in ``pack_hook`` and recomputing them in
+    ``unpack_hook`` is possible too, but :func:`torch.utils.checkpoint.checkpoint`
+    already provides that for whole segments of a model.
+
+    .. warning::
+        The hooks only apply on the thread that entered the context, and
+        only to tensors saved by built-in operations and by
+        :meth:`~torch.autograd.function._ContextMethodMixin.save_for_backward`.
+
+    Example:
+
+        >>> def pack_hook(x):
+        ...     print("Packing", x)
+        ...     return x
+        >>>
+        >>> def unpack_hook(x):
+        ...     print("Unpacking", x)
+        ...     return x
+        >>>
+        >>> a = torch.ones(5, requires_grad=True)
+        >>> b = torch.ones(5, requires_grad=True) * 2
+        >>> with torch.autograd.graph.saved_tensors_hooks(pack_hook, unpack_hook):
+        ...     y = a * b
+        Packing tensor([1., 1., 1., 1., 1.])
+        Packing tensor([2., 2., 2., 2., 2.])
+        >>> y.sum().backward()
+        Unpacking tensor([1., 1., 1., 1., 1.])
+        Unpacking tensor([2., 2., 2., 2., 2.])
+    """
+
+    def __init__(self, pack_hook: Callable[[torch.Tensor], Any],
+                 unpack_hook: Callable[[Any], torch.Tensor]) -> None:
+        self.pack_hook = pack_hook
+        self.unpack_hook = unpack_hook
+
+    def __enter__(self) -> None:
+        torch.autograd._push_saved_tensors_default_hooks(self.pack_hook, self.unpack_hook)
+
+    def __exit__(self, *args: Any) -> None:
+        torch.autograd._pop_saved_tensors_default_hooks()
+
+
+class _OffloadedTensor(object):
+    __slots__ = ['tensor', 'device', 'ready', 'restored', '__weakref__']
+
+    def __init__(self, tensor: torch.Tensor, device: Optional[torch.device] = None,
+                 ready: Any = None) -> None:
+        self.tensor = tensor
+        self.device = device
+        # Event recorded after the last asynchronous copy of the tensor
+        self.ready = ready
+        self.restored: Optional[torch.Tensor] = None
+
+
+class save_on_cpu(saved_tensors_hooks):
+    r"""Context-manager under which the tensors saved for backward live in CPU memory.
+
+    CUDA tensors saved by operations run inside the context are copied to
+    the CPU during the forward pass, and the device memory they used is
+    released as soon as nothing else refers to it. In the backward pass they
+    are copied back to their device. Tensors on other devices are saved as
+    usual.
+
+    With ``pin_memory`` the copies go to page-locked memory and run
+    asynchronously in both directions. Copies back to the device then run on
+    a side stream, and unpacking a tensor also starts copying the
+    ``prefetch`` tensors saved just before it, which the backward pass
+    usually needs next, so that the copies overlap with backward
+    computation.
+
+    Args:
+        pin_memory (bool): copy to page-locked memory, asynchronously.
+            Default: ``True``.
+        prefetch (int): number of tensors to start copying back ahead of
+            use. Only used with ``pin_memory``. Default: ``2``.
+
+    Example:
+
+        >>> with torch.autograd.graph.save_on_cpu():
+        ...     loss = model(inputs).sum()
+        >>> loss.backward()
+    """
+
+    def __init__(self, pin_memory: bool = True, prefetch: int = 2) -> None:
+        if prefetch < 0:
+            raise ValueError("prefetch should be non-negative, got {}".format(prefetch))
+        self.pin_memory = pin_memory
+        self.prefetch = prefetch if pin_memory else 0
+        # In the order tensors were saved, which backward mostly reverses
+        self._saved: List[weakref.ref] = []
+        self._streams = {}
+        super(save_on_cpu, self).__init__(self._pack, self._unpack)
+
+    def _pack(self, tensor: torch.Tensor) -> Any:
+        if not tensor.is_cuda:
+            return _OffloadedTensor(tensor)
+        cpu = torch.empty_strided(tensor.size(), tensor.stride(), dtype=tensor.dtype,
+                                  layout=tensor.layout, pin_memory=self.pin_memory)
+        cpu.copy_(tensor, non_blocking=self.pin_memory)
+        ready = None
+        if self.pin_memory:
+            ready = torch.cuda.Event()
+            ready.record(torch.cuda.current_stream(tensor.device))
+        saved = _OffloadedTensor(cpu, tensor.device, ready)
+        self._saved.append(weakref.ref(saved))
+        return (len(self._saved) - 1, saved)
+
+    def _restore(self, saved: _OffloadedTensor) -> None:
+        if saved.restored is not None:
+            return
+        if saved.ready is None:
+            saved.restored = saved.tensor.to(saved.device)
+            return
+        stream = self._streams.get(saved.device)
+        if stream is None:
+            stream = self._streams[saved.device] = torch.cuda.Stream(saved.device)
+        stream.wait_event(saved.ready)
+        with torch.cuda.stream(stream):
+            saved.restored = saved.tensor.to(saved.device, non_blocking=True)
+        saved.ready = torch.cuda.Event()
+        saved.ready.record(stream)
+
+    def _unpack(self, packed: Any) -> torch.Tensor:
+        if isinstance(packed, _OffloadedTensor):
+            return packed.tensor
+        index, saved = packed
+        self._restore(saved)
+        for i in range(index - 1, max(index - 1 - self.prefetch, -1), -1):
+            ahead = self._saved[i]()
+            if ahead is not None:
+                self._restore(ahead)
+        tensor = saved.restored
+        saved.restored = None
+        if saved.ready is not None:
+            current = torch.cuda.current_stream(saved.device)
+            current.wait_event(saved.ready)
+            # Allocated on the side stream but used and freed on this one
+            tensor.record_stream(current)
+        return tensor
@@ -247,6 +247,14 @@ class profile(object):
             Adds approximately 4us of overhead to each tensor operation.
             Default: ``False``
 
+        use_cupti (bool, optional): Records the kernels, memcpys and memsets that
+            run on the GPU with CUPTI instead, without CUDA events around every
+            operation. Each of them is attributed to the innermost operation that
+            launched it, GPU work launched outside of profiled operations is not
+            reported. Needs PyTorch built with ``USE_CUPTI=1``, and can not be
+            combined with ``use_cuda``.
+            Default: ``False``
+
         record_shapes (bool, optional): If shapes recording is set, information
             about input dimensions will be collected. This allows one to see which
             dimensions have been used under the hood and further group by them
@@ -258,7 +266,9 @@ class profile(object):
             self cpu time might be artificially increased because of the shape
             collection.
 
-        profile_memory (bool, optional): Whether to report memory usage, default: ``False``
+        profile_memory (bool, optional): Whether to report memory usage, default: ``False``.
+            The allocations and frees are also attributed to the innermost
+            operation running when they happen, see :meth:`memory_profile`.
 
     .. warning:
         Enabling memory profiling incurs additional profiler overhead
@@ -297,15 +307,20 @@ class profile(object):
             enabled=True,
             use_cuda=False,
             record_shapes=False,
-            profile_memory=False):
+            profile_memory=False,
+            use_cupti=False):
         self.enabled = enabled
         self.use_cuda = use_cuda
+        self.use_cupti = use_cupti
         self.function_events = None
+        self._memory_profile = None
         if not self.enabled:
             return
         self.entered = False
         self.record_shapes = record_shapes
         self.profile_memory = profile_memory
+        if use_cuda and use_cupti:
+            raise ValueError("use_cuda and use_cupti can not be combined")
 
     def __enter__(self):
         if not self.enabled:
@@ -313,8 +328,12 @@ class profile(object):
         if self.entered:
             raise RuntimeError("autograd profiler traces are not reentrant")
         self.entered = True
-        profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
-            else torch.autograd.ProfilerState.CPU
+        if self.use_cupti:
+            profiler_kind = torch.autograd.ProfilerState.CUPTI
+        elif self.use_cuda:
+            profiler_kind = torch.autograd.ProfilerState.CUDA
+        else:
+            profiler_kind = torch.autograd.ProfilerState.CPU
 
         config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory)
         torch.autograd._enable_profiler(config)
@@ -324,10 +343,13 @@ class profile(object):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
+        gpu_activities = torch.autograd._take_gpu_activities() if self.use_cupti else None
         self.function_events = EventList(
-            parse_cpu_trace(records),
-            use_cuda=self.use_cuda,
+            parse_cpu_trace(records, gpu_activities),
+            use_cuda=self.use_cuda or self.use_cupti,
             profile_memory=self.profile_memory)
+        if self.profile_memory:
+            self._memory_profile = parse_memory_trace(records)
         return False
 
     def __repr__(self):
@@ -367,6 +389,13 @@ class profile(object):
         return self.function_events.total_average()
     total_average.__doc__ = EventList.total_average.__doc__
 
+    def memory_profile(self):
+        """Returns the :class:`MemoryProfile` of the run, which needs ``profile_memory=True``."""
+        self._check_finish()
+        if self._memory_profile is None:
+            raise RuntimeError("memory profile needs profile_memory=True")
+        return self._memory_profile
+
     @property
     def self_cpu_time_total(self):
         """ Returns total time spent on CPU obtained as a sum of
@@ -563,6 +592,43 @@ class emit_nvtx(object):
         return False
 
 
+def enable_sampling_profiler(sampling_prob=0.001, record_shapes=False):
+    """Start timing a sample of the ops run on any thread.
+
+    Unlike :class:`profile`, which records every event of a range of code,
+    the sampling profiler is cheap enough to stay enabled in production. It
+    only aggregates the latencies of the sampled ops per op name, and per
+    input shapes with ``record_shapes``, into histograms, which
+    :func:`flush_sampling_profiler` returns. Enable and disable it while no
+    ops run, e.g. when the process starts.
+
+    Arguments:
+        sampling_prob (float): probability that an op is timed.
+            Default: ``0.001``.
+        record_shapes (bool): aggregate per input shapes too, which has to
+            copy the inputs of the sampled ops. Default: ``False``.
+    """
+    torch.autograd._enable_sampling_profiler(sampling_prob, record_shapes)
+
+
+def disable_sampling_profiler():
+    """Stop the sampling profiler. Stats collected since the last flush can
+    still be flushed."""
+    torch.autograd._disable_sampling_profiler()
+
+
+def flush_sampling_profiler():
+    """Return the stats the sampling profiler collected on all threads since
+    the last flush, and start over.
+
+    Returns a list of ``OpLatencyStats``, heaviest first, with attributes
+    ``name``, ``shapes``, ``count``, ``total_ns``, ``min_ns``, ``max_ns``
+    and ``buckets``, where ``buckets[i]`` counts the samples that took
+    between ``2**i`` and ``2**(i + 1)`` nanoseconds.
+    """
+    return torch.autograd._flush_sampling_profiler()
+
+
 def load_nvprof(path):
     """Opens an nvprof trace file and parses autograd annotations.
 
@@ -816,7 +882,7 @@ class StringTable(defaultdict):
 ################################################################################
 # CPU checkpoints
 
-def parse_cpu_trace(thread_records):
+def parse_cpu_trace(thread_records, gpu_activities=None):
     def get_record_key(record):
         """
         Returns a tuple to be used by parse_cpu_trace for correlating start and
@@ -952,10 +1018,166 @@ def parse_cpu_trace(thread_records):
     # granularity of the given clock tick)--we always show
     # the outermost nested call first. This adds stability
     # in how FunctionEvents appear
+    # GPU work recorded by CUPTI, correlated with the ranges by handle
+    if gpu_activities:
+        local_functions = {fe.id: fe for fe in functions if not fe.is_remote}
+        start_us = start_record.cpu_us()
+        for activity in gpu_activities:
+            fe = local_functions.get(activity.correlation_id)
+            if fe is not None:
+                fe.append_kernel(
+                    activity.name,
+                    activity.device,
+                    activity.start_ns / 1000.0 - start_us,
+                    activity.end_ns / 1000.0 - start_us)
+
     functions.sort(key=lambda evt: [evt.cpu_interval.start, -evt.cpu_interval.end])
     return functions
 
 
+################################################################################
+# Memory profile
+
+# time in us since the start of the profile, nbytes is negative for frees
+MemoryEvent = namedtuple('MemoryEvent', ['time', 'device', 'ptr', 'nbytes', 'op'])
+MemoryStats = namedtuple('MemoryStats', ['allocated', 'freed', 'live_at_peak'])
+
+
+class MemoryProfile(object):
+    """Allocations and frees recorded by :class:`profile` with ``profile_memory=True``.
+
+    Each one is attributed to the innermost operation running on the thread
+    that made it, ``"[no op]"`` if there was none. Devices are ``"cpu"`` and
+    ``"cuda"``, which adds up all the CUDA devices.
+
+    Memory allocated before the profile started is not tracked: its frees only
+    count towards the ``freed`` bytes of the operation that freed it.
+
+    Example:
+        >>> with torch.autograd.profiler.profile(profile_memory=True) as prof:
+        ...     model(inputs).sum().backward()
+        >>> print(prof.memory_profile().table(device="cpu"))
+    """
+    def __init__(self, events):
+        self.events = sorted(events, key=lambda evt: evt.time)
+
+    def _tracked(self, device):
+        allocated = set()
+        for evt in self.events:
+            if evt.device != device:
+                continue
+            if evt.nbytes > 0:
+                allocated.add(evt.ptr)
+            elif evt.ptr in allocated:
+                allocated.remove(evt.ptr)
+            else:
+                continue
+            yield evt
+
+    def timeline(self, device="cpu"):
+        """Returns the memory allocated on device during the profile and still
+        live, as a list of ``(time in us, bytes)`` pairs, one per allocation or free.
+        """
+        live = 0
+        points = []
+        for evt in self._tracked(device):
+            live += evt.nbytes
+            points.append((evt.time, live))
+        return points
+
+    def peak(self, device="cpu"):
+        """Returns the ``(time in us, bytes)`` pair of the timeline with the most live memory."""
+        return max(self.timeline(device), key=lambda point: point[1], default=(0.0, 0))
+
+    def op_stats(self, device="cpu"):
+        """Returns a dict from operation name to :class:`MemoryStats`: the bytes
+        the operation allocated, freed, and allocated that were still live at the peak.
+        """
+        allocated = defaultdict(int)
+        freed = defaultdict(int)
+        for evt in self.events:
+            if evt.device != device:
+                continue
+            if evt.nbytes > 0:
+                allocated[evt.op] += evt.nbytes
+            else:
+                freed[evt.op] -= evt.nbytes
+
+        tracked = list(self._tracked(device))
+        peak_index, live_bytes, peak_bytes = -1, 0, 0
+        for i, evt in enumerate(tracked):
+            live_bytes += evt.nbytes
+            if live_bytes > peak_bytes:
+                peak_index, peak_bytes = i, live_bytes
+        live = {}
+        for evt in tracked[:peak_index + 1]:
+            if evt.nbytes > 0:
+                live[evt.ptr] = evt
+            else:
+                del live[evt.ptr]
+        live_at_peak = defaultdict(int)
+        for evt in live.values():
+            live_at_peak[evt.op] += evt.nbytes
+
+        ops = set(allocated) | set(freed)
+        return {op: MemoryStats(allocated[op], freed[op], live_at_peak[op]) for op in ops}
+
+    def table(self, device="cpu", sort_by="live_at_peak", row_limit=100):
+        """Prints the :meth:`op_stats` of device as a table, sorted by
+        ``allocated``, ``freed`` or ``live_at_peak``, in decreasing order.
+        """
+        if sort_by not in MemoryStats._fields:
+            raise ValueError("sort_by should be one of {}, got {}".format(MemoryStats._fields, sort_by))
+        stats = sorted(self.op_stats(device).items(),
+                       key=lambda item: getattr(item[1], sort_by), reverse=True)
+        if row_limit > 0:
+            stats = stats[:row_limit]
+        name_width = max([len(op) for op, _ in stats] + [len("Name")]) + 2
+        row_format = "{:<" + str(name_width) + "}" + "{:>15}" * 3 + "\n"
+        header = row_format.format("Name", "Allocated", "Freed", "Live at peak")
+        separator = "-" * (len(header) - 1) + "\n"
+        result = [separator, header, separator]
+        for op, op_stats in stats:
+            result.append(row_format.format(
+                op, format_memory(op_stats.allocated), format_memory(op_stats.freed),
+                format_memory(op_stats.live_at_peak)))
+        result.append(separator)
+        peak_time, peak_bytes = self.peak(device)
+        result.append("Peak: {} at {}\n".format(format_memory(peak_bytes), format_time(peak_time)))
+        return "".join(result)
+
+
+def parse_memory_trace(thread_records):
+    start_record = None
+    names = {}
+    memory_records = []
+    for record in itertools.chain(*thread_records):
+        if record.is_remote():
+            continue
+        kind = record.kind()
+        if start_record is None and record.name() == '__start_profile':
+            start_record = record
+        if kind == 'push':
+            names[record.handle()] = record.name()
+        elif kind == 'memory_alloc':
+            memory_records.append(record)
+    assert start_record is not None
+
+    events = []
+    for record in memory_records:
+        if record.cpu_memory_usage() != 0:
+            device, nbytes = "cpu", record.cpu_memory_usage()
+        else:
+            device, nbytes = "cuda", record.cuda_memory_usage()
+        events.append(MemoryEvent(
+            time=start_record.cpu_elapsed_us(record),
+            device=device,
+            ptr=record.memory_ptr(),
+            nbytes=nbytes,
+            op=names.get(record.handle(), "[no op]")))
+    return MemoryProfile(events)
+
+
 ################################################################################
 # CUDA checkpoints
 
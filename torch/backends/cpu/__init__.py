@@ -0,0 +1,47 @@
+import sys
+import torch
+from contextlib import contextmanager
+from torch.backends import ContextProp, PropModule, __allow_nonbracketed_mutation
+
+def set_flags(_conv_benchmark):
+    orig_flags = (torch._C._get_cpu_conv_benchmark(),)
+    torch._C._set_cpu_conv_benchmark(_conv_benchmark)
+    return orig_flags
+
+@contextmanager
+def flags(conv_benchmark=False):
+    with __allow_nonbracketed_mutation():
+        orig_flags = set_flags(conv_benchmark)
+    try:
+        yield
+    finally:
+        with __allow_nonbracketed_mutation():
+            set_flags(orig_flags[0])
+
+def conv_benchmark_cache():
+    r"""Returns the implementations chosen by :attr:`conv_benchmark`, as a
+    dict from a description of each convolution configuration to the name of
+    its implementation. It can be saved, e.g. with ``json``, and given to
+    :func:`load_conv_benchmark_cache` by another process with the same build
+    and number of threads to skip the benchmarking."""
+    return torch._C._get_cpu_conv_benchmark_cache()
+
+def load_conv_benchmark_cache(choices):
+    r"""Adds the choices of :func:`conv_benchmark_cache` to the cache."""
+    torch._C._load_cpu_conv_benchmark_cache(choices)
+
+def clear_conv_benchmark_cache():
+    r"""Forgets the implementations chosen by :attr:`conv_benchmark`."""
+    torch._C._clear_cpu_conv_benchmark_cache()
+
+class CpuModule(PropModule):
+    def __init__(self, m, name):
+        super(CpuModule, self).__init__(m, name)
+
+    # Times the implementations of each configuration of 2d convolution on
+    # CPU once, and then uses the fastest, like torch.backends.cudnn.benchmark
+    conv_benchmark = ContextProp(torch._C._get_cpu_conv_benchmark, torch._C._set_cpu_conv_benchmark)
+
+# Cool stuff from torch/backends/cudnn/__init__.py and
+# https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
+sys.modules[__name__] = CpuModule(sys.modules[__name__], __name__)
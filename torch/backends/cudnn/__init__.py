@@ -1,3 +1,4 @@
+import os
 import sys
 import torch
 import warnings
@@ -83,6 +84,30 @@ def is_acceptable(tensor):
     return True
 
 
+def save_benchmark_cache(path):
+    r"""Saves the convolution algorithms chosen so far to the file at ``path``,
+    so that other processes can skip benchmarking them, see
+    :func:`load_benchmark_cache`. The entries already in the file are kept.
+    Returns the number of entries saved.
+    """
+    if not _init() or not hasattr(_cudnn, '_save_benchmark_cache'):
+        raise RuntimeError('save_benchmark_cache requires cuDNN')
+    return _cudnn._save_benchmark_cache(os.fspath(path))
+
+
+def load_benchmark_cache(path):
+    r"""Loads the convolution algorithms saved by :func:`save_benchmark_cache`.
+    The algorithms only apply to the cuDNN version and the GPU architectures
+    they were chosen for, a file saved by another cuDNN version loads nothing.
+    Setting the ``TORCH_CUDNN_BENCHMARK_CACHE`` environment variable to a path
+    loads it before the first convolution is benchmarked.
+    Returns the number of entries loaded.
+    """
+    if not _init() or not hasattr(_cudnn, '_load_benchmark_cache'):
+        raise RuntimeError('load_benchmark_cache requires cuDNN')
+    return _cudnn._load_benchmark_cache(os.fspath(path))
+
+
 def set_flags(_enabled, _benchmark, _deterministic):
     orig_flags = (torch._C._get_cudnn_enabled(),
                   torch._C._get_cudnn_benchmark(),
@@ -0,0 +1,6 @@
+r"""
+This package holds the CPU counterparts of the :mod:`torch.cuda` utilities,
+for now only :mod:`torch.cpu.amp`.
+"""
+
+from . import amp  # noqa: F401
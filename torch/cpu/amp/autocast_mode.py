@@ -0,0 +1,52 @@
+import torch
+import functools
+
+
+class autocast(object):
+    r"""
+    The CPU counterpart of :class:`torch.cuda.amp.autocast`: in the regions it
+    enables, CPU ops run in an op-specific dtype chosen by autocast, ``bfloat16``
+    for the convolutions and matrix products, ``float32`` for the ops which need
+    its precision.  CUDA ops are not affected.
+
+    Example::
+
+        model = Net()
+        model.eval()
+
+        # Casts the weights once rather than in every iteration
+        torch.set_autocast_cache_persistent(True)
+        with torch.no_grad():
+            for input in data:
+                with torch.cpu.amp.autocast():
+                    output = model(input)
+
+    The casts of the fp32 weights are cached until the region is exited.  After
+    ``torch.set_autocast_cache_persistent(True)``, the casts made with grad mode
+    disabled are kept across regions instead, and redone when a weight is updated
+    in place.  ``torch.set_autocast_cache_persistent(False)`` drops them.
+
+    Arguments:
+        enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+    """
+    def __init__(self, enabled=True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_cpu_enabled()
+        torch.set_autocast_cpu_enabled(self._enabled)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # Drop the cache when we exit to a nesting level that's outside any instance of autocast.
+        if torch.autocast_decrement_nesting() == 0:
+            torch.clear_autocast_cache()
+        torch.set_autocast_cpu_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
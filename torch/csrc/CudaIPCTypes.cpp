@@ -1,9 +1,15 @@
 #ifdef USE_CUDA
 #include <torch/csrc/CudaIPCTypes.h>
 #include <TH/THAllocator.h>
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <list>
 #include <map>
 #include <mutex>
 #include <random>
+#include <unordered_map>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -32,6 +38,10 @@ struct CudaIPCGlobalEntities {
       ref_counters_files_;
   std::shared_ptr<CudaIPCRefCountersFile> next_available_ref_counters_file_;
   CudaIPCSentDataLimbo CudaIPCSentDataLimbo_;
+  // The events recorded for all the pooled storages of a device, never
+  // destroyed as consumers may still wait on them.
+  std::mutex pooled_events_mutex_;
+  std::map<c10::DeviceIndex, cudaEvent_t> pooled_events_;
   CudaIPCGlobalEntities() : ref_counters_files_() {}
   ~CudaIPCGlobalEntities() {
     CudaIPCSentDataLimbo_.collect();
@@ -106,6 +116,22 @@ void CudaIPCSentDataDelete(void* ptr) {
   cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
 }
 
+cudaEvent_t getPooledEvent(at::Device device) {
+  std::lock_guard<std::mutex> lock(
+      cuda_ipc_global_entities.pooled_events_mutex_);
+  auto it = cuda_ipc_global_entities.pooled_events_.find(device.index());
+  if (it != cuda_ipc_global_entities.pooled_events_.end()) {
+    return it->second;
+  }
+  at::cuda::CUDAGuard device_guard(device.index());
+  cudaEvent_t event;
+  C10_CUDA_CHECK(cudaEventCreateWithFlags(
+      &event,
+      cudaEventDisableTiming | cudaEventInterprocess | cudaEventBlockingSync));
+  cuda_ipc_global_entities.pooled_events_.emplace(device.index(), event);
+  return event;
+}
+
 void ReturnRefCounter(const std::string& handle, uint64_t offset /* unused */) {
   std::lock_guard<std::mutex> lock(
       cuda_ipc_global_entities.ref_counters_mutex_);
@@ -117,18 +143,406 @@ void ReturnRefCounter(const std::string& handle, uint64_t offset /* unused */) {
   }
 }
 
+// Note [CUDA IPC memory pool]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Sending a storage costs the producer a new interprocess event, and the
+// consumer opening that event and possibly the memory handle of the
+// allocation, then synchronizing its stream and mapping the ref counter file
+// on release. With many small tensors, e.g. the batches of a DataLoader, this
+// costs more than the copies.
+//
+// With TORCH_CUDA_IPC_POOL_SIZE set to a number of bytes, the producer copies
+// the storages of up to TORCH_CUDA_IPC_POOL_MAX_BLOCK_SIZE bytes (4MB by
+// default) into blocks of one allocation of that size per device when they
+// are first sent, and records one long-lived event per device on each send in
+// place of a new event. The block goes back to the pool like any sent data,
+// once its ref counter drops to zero. A consumer may wait on a later record of
+// the event than the one of its storage, which is only slower.
+//
+// The consumer of a pooled storage keeps the event opened, the pool mapped
+// and the ref counter files mapped. Instead of synchronizing the stream when
+// the storage is released, it records an event on it, and decrements the
+// counters of all the storages whose events completed the next time it
+// receives or releases a pooled storage, or on torch.cuda.ipc_collect().
+
+constexpr size_t CUDA_IPC_POOL_BLOCK_ALIGNMENT = 512;
+// Mappings of pools and ref counter files the consumer keeps open, the least
+// recently used are closed past these.
+constexpr size_t CUDA_IPC_MAXIMUM_POOL_MAPPINGS_TO_KEEP = 8;
+constexpr size_t CUDA_IPC_MAXIMUM_REF_COUNTER_FILES_TO_KEEP = 16;
+
+size_t getEnvSize(const char* name, size_t default_value) {
+  const char* value = std::getenv(name);
+  if (!value || !*value) {
+    return default_value;
+  }
+  char* end;
+  unsigned long long size = std::strtoull(value, &end, 10);
+  TORCH_CHECK(*end == '\0', "invalid value of ", name, ": ", value);
+  return size;
+}
+
+size_t poolSize() {
+  static const size_t size = getEnvSize("TORCH_CUDA_IPC_POOL_SIZE", 0) /
+      CUDA_IPC_POOL_BLOCK_ALIGNMENT * CUDA_IPC_POOL_BLOCK_ALIGNMENT;
+  return size;
+}
+
+size_t poolMaxBlockSize() {
+  static const size_t size = std::min<size_t>(
+      getEnvSize("TORCH_CUDA_IPC_POOL_MAX_BLOCK_SIZE", 4 << 20), poolSize());
+  return size;
+}
+
+// First fit blocks of one allocation of the caching allocator.
+struct CudaIPCMemoryPool final {
+  explicit CudaIPCMemoryPool(size_t size)
+      : base_(static_cast<char*>(
+            c10::cuda::CUDACachingAllocator::raw_alloc(size))),
+        size_(size) {
+    free_blocks_.emplace(0, size);
+  }
+  ~CudaIPCMemoryPool() {
+    c10::cuda::CUDACachingAllocator::raw_delete(base_);
+  }
+
+  void* allocate(size_t nbytes) {
+    const size_t block_size =
+        (nbytes + CUDA_IPC_POOL_BLOCK_ALIGNMENT - 1) /
+        CUDA_IPC_POOL_BLOCK_ALIGNMENT * CUDA_IPC_POOL_BLOCK_ALIGNMENT;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = free_blocks_.begin(); it != free_blocks_.end(); ++it) {
+      if (it->second < block_size) {
+        continue;
+      }
+      const size_t offset = it->first;
+      const size_t remaining = it->second - block_size;
+      free_blocks_.erase(it);
+      if (remaining > 0) {
+        free_blocks_.emplace(offset + block_size, remaining);
+      }
+      used_blocks_.emplace(offset, block_size);
+      return base_ + offset;
+    }
+    return nullptr;
+  }
+
+  void free(void* ptr) {
+    const size_t offset = static_cast<char*>(ptr) - base_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto used = used_blocks_.find(offset);
+    size_t block_size = used->second;
+    used_blocks_.erase(used);
+    // merge with the neighbouring free blocks
+    auto next = free_blocks_.lower_bound(offset);
+    if (next != free_blocks_.end() && offset + block_size == next->first) {
+      block_size += next->second;
+      next = free_blocks_.erase(next);
+    }
+    if (next != free_blocks_.begin()) {
+      auto prev = std::prev(next);
+      if (prev->first + prev->second == offset) {
+        prev->second += block_size;
+        return;
+      }
+    }
+    free_blocks_.emplace(offset, block_size);
+  }
+
+  bool contains(const void* ptr) const {
+    return ptr >= base_ && ptr < base_ + size_;
+  }
+
+ private:
+  char* const base_;
+  const size_t size_;
+  std::mutex mutex_;
+  std::map<size_t, size_t> free_blocks_; // offset -> size
+  std::unordered_map<size_t, size_t> used_blocks_; // offset -> size
+};
+
+struct CudaIPCMemoryPools {
+  std::mutex mutex_;
+  std::map<c10::DeviceIndex, CudaIPCMemoryPool*> pools_;
+
+  CudaIPCMemoryPool* find(const void* ptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& pool : pools_) {
+      if (pool.second->contains(ptr)) {
+        return pool.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// Leaked on purpose, the blocks still in limbo are returned at exit.
+CudaIPCMemoryPools& getMemoryPools() {
+  static auto* pools = new CudaIPCMemoryPools();
+  return *pools;
+}
+
+void CudaIPCPoolBlockDelete(void* ptr) {
+  getMemoryPools().find(ptr)->free(ptr);
+}
+
+struct CudaIPCPendingRelease {
+  std::string ref_counter_handle_;
+  int64_t ref_counter_offset_;
+  at::Device device_;
+  cudaEvent_t event_;
+};
+
+// What the consumer keeps of the pooled storages it received.
+struct CudaIPCConsumerEntities {
+  std::mutex mutex_;
+  std::unordered_map<std::string, cudaEvent_t> opened_events_;
+  // most recently used first
+  std::list<std::pair<std::string, std::shared_ptr<void>>> pool_mappings_;
+  std::list<std::pair<std::string, at::DataPtr>> ref_counters_files_;
+  std::deque<CudaIPCPendingRelease> pending_releases_;
+  std::map<c10::DeviceIndex, std::vector<cudaEvent_t>> free_events_;
+
+  // Requires mutex_.
+  int64_t* counter_ptr(const std::string& ref_counter_handle) {
+    for (auto it = ref_counters_files_.begin(); it != ref_counters_files_.end();
+         ++it) {
+      if (it->first == ref_counter_handle) {
+        ref_counters_files_.splice(
+            ref_counters_files_.begin(), ref_counters_files_, it);
+        return static_cast<int64_t*>(it->second.get());
+      }
+    }
+    int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+    ref_counters_files_.emplace_front(
+        ref_counter_handle,
+        THRefcountedMapAllocator::makeDataPtr(
+            ref_counter_handle.c_str(),
+            flags,
+            sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+            nullptr));
+    if (ref_counters_files_.size() > CUDA_IPC_MAXIMUM_REF_COUNTER_FILES_TO_KEEP) {
+      ref_counters_files_.pop_back();
+    }
+    return static_cast<int64_t*>(ref_counters_files_.front().second.get());
+  }
+
+  // Requires mutex_.
+  void release_counter(
+      const std::string& ref_counter_handle,
+      int64_t ref_counter_offset) {
+    // We don't want to break existing code, so resource deletion is best
+    // effort basis. Exception expected if producer process terminated
+    // before consumer released data.
+    try {
+      *(counter_ptr(ref_counter_handle) + ref_counter_offset) -= 1;
+    } catch (c10::Error& err) {
+      // Already warned inside of producer process
+    }
+  }
+
+  // Requires mutex_. Releases the counters of the storages the consumer is
+  // done with, in order, up to the first one it may still use.
+  void process_pending_releases(bool wait) {
+    while (!pending_releases_.empty()) {
+      auto& release = pending_releases_.front();
+      if (wait) {
+        cudaEventSynchronize(release.event_);
+      } else {
+        cudaError_t err = cudaEventQuery(release.event_);
+        if (err == cudaErrorNotReady) {
+          // ignore and clear the error if not ready
+          cudaGetLastError();
+          break;
+        }
+      }
+      release_counter(
+          release.ref_counter_handle_, release.ref_counter_offset_);
+      free_events_[release.device_.index()].push_back(release.event_);
+      pending_releases_.pop_front();
+    }
+  }
+};
+
+// Leaked on purpose, as the storages may be released at exit.
+CudaIPCConsumerEntities& getConsumerEntities() {
+  static auto* entities = new CudaIPCConsumerEntities();
+  return *entities;
+}
+
+// Releases the counters still pending at exit, so that the producer does not
+// keep their storages in limbo.
+struct CudaIPCConsumerFlush {
+  ~CudaIPCConsumerFlush() {
+    try {
+      auto& entities = getConsumerEntities();
+      std::lock_guard<std::mutex> lock(entities.mutex_);
+      entities.process_pending_releases(/*wait=*/true);
+    } catch (...) { /* No throw */
+    }
+  }
+};
+
+CudaIPCConsumerFlush cuda_ipc_consumer_flush;
+
 } // namespace
 
+at::DataPtr CudaIPCPoolAllocate(size_t nbytes, at::Device device) {
+  if (poolSize() == 0 || nbytes == 0 || nbytes > poolMaxBlockSize()) {
+    return at::DataPtr();
+  }
+  auto& pools = getMemoryPools();
+  CudaIPCMemoryPool* pool = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(pools.mutex_);
+    auto it = pools.pools_.find(device.index());
+    if (it != pools.pools_.end()) {
+      pool = it->second;
+    }
+  }
+  if (!pool) {
+    // Allocated out of the critical section, as the allocator may collect
+    // the blocks in limbo.
+    at::cuda::CUDAGuard device_guard(device.index());
+    auto new_pool = std::make_unique<CudaIPCMemoryPool>(poolSize());
+    std::lock_guard<std::mutex> lock(pools.mutex_);
+    auto& device_pool = pools.pools_[device.index()];
+    if (!device_pool) {
+      device_pool = new_pool.release();
+    }
+    pool = device_pool;
+  }
+  void* ptr = pool->allocate(nbytes);
+  if (!ptr) {
+    // Return the blocks released by the consumers since the last collect
+    CudaIPCCollect();
+    ptr = pool->allocate(nbytes);
+    if (!ptr) {
+      return at::DataPtr();
+    }
+  }
+  return at::DataPtr(ptr, ptr, CudaIPCPoolBlockDelete, device);
+}
+
+bool CudaIPCPoolContains(const void* ptr, at::Device device) {
+  auto& pools = getMemoryPools();
+  std::lock_guard<std::mutex> lock(pools.mutex_);
+  auto it = pools.pools_.find(device.index());
+  return it != pools.pools_.end() && it->second->contains(ptr);
+}
+
+cudaEvent_t CudaIPCOpenPooledEvent(const std::string& ipc_event_handle) {
+  auto& entities = getConsumerEntities();
+  std::lock_guard<std::mutex> lock(entities.mutex_);
+  entities.process_pending_releases(/*wait=*/false);
+  auto it = entities.opened_events_.find(ipc_event_handle);
+  if (it != entities.opened_events_.end()) {
+    return it->second;
+  }
+#ifndef __HIP_PLATFORM_HCC__
+  cudaEvent_t event;
+  C10_CUDA_CHECK(cudaIpcOpenEventHandle(
+      &event,
+      *reinterpret_cast<const cudaIpcEventHandle_t*>(
+          ipc_event_handle.c_str())));
+  entities.opened_events_.emplace(ipc_event_handle, event);
+  return event;
+#else
+  AT_ERROR("interprocess events are not supported with HIP");
+#endif
+}
+
+void CudaIPCRetainPoolMapping(
+    const std::string& handle,
+    std::shared_ptr<void> base_ptr) {
+  std::shared_ptr<void> evicted;
+  auto& entities = getConsumerEntities();
+  std::lock_guard<std::mutex> lock(entities.mutex_);
+  auto& mappings = entities.pool_mappings_;
+  for (auto it = mappings.begin(); it != mappings.end(); ++it) {
+    if (it->first == handle) {
+      mappings.splice(mappings.begin(), mappings, it);
+      return;
+    }
+  }
+  mappings.emplace_front(handle, std::move(base_ptr));
+  if (mappings.size() > CUDA_IPC_MAXIMUM_POOL_MAPPINGS_TO_KEEP) {
+    // closed outside of the critical section
+    evicted = std::move(mappings.back().second);
+    mappings.pop_back();
+  }
+}
+
+void CudaIPCReleaseCounter(
+    const std::string& ref_counter_handle,
+    int64_t ref_counter_offset,
+    bool pooled) {
+  if (pooled) {
+    auto& entities = getConsumerEntities();
+    std::lock_guard<std::mutex> lock(entities.mutex_);
+    entities.release_counter(ref_counter_handle, ref_counter_offset);
+    return;
+  }
+  // We don't want to break existing code, so resource deletion is best
+  // effort basis. Exception expected if producer process terminated
+  // before consumer released data.
+  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+  try {
+    auto sptr = THRefcountedMapAllocator::makeDataPtr(
+        ref_counter_handle.c_str(),
+        flags,
+        sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+        nullptr);
+    *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
+  } catch (c10::Error& err) {
+    // Already warned inside of producer process
+  }
+}
+
+void CudaIPCReleaseCounterAsync(
+    std::string ref_counter_handle,
+    int64_t ref_counter_offset,
+    at::Device device) {
+  auto& entities = getConsumerEntities();
+  std::lock_guard<std::mutex> lock(entities.mutex_);
+  entities.process_pending_releases(/*wait=*/false);
+  auto& free_events = entities.free_events_[device.index()];
+  cudaEvent_t event = nullptr;
+  if (!free_events.empty()) {
+    event = free_events.back();
+    free_events.pop_back();
+  }
+  at::cuda::CUDAGuard device_guard(device.index());
+  // Called from deleters, so errors fall back to synchronizing the stream
+  if ((event ||
+       cudaEventCreateWithFlags(&event, cudaEventDisableTiming) ==
+           cudaSuccess) &&
+      cudaEventRecord(event, c10::cuda::getCurrentCUDAStream(device.index())) ==
+          cudaSuccess) {
+    entities.pending_releases_.push_back(CudaIPCPendingRelease{
+        std::move(ref_counter_handle), ref_counter_offset, device, event});
+    return;
+  }
+  cudaGetLastError();
+  cudaStreamSynchronize(c10::cuda::getCurrentCUDAStream(device.index()));
+  if (event) {
+    free_events.push_back(event);
+  }
+  entities.release_counter(ref_counter_handle, ref_counter_offset);
+}
+
 CudaIPCSentData::CudaIPCSentData(
     std::string handle,
     int64_t offset,
     int64_t* counter_ptr,
-    at::Device device)
+    at::Device device,
+    bool pooled)
     : handle_(handle),
       offset_(offset),
       counter_ptr_(counter_ptr),
       original_ptr_(),
-      device_(device) {
+      device_(device),
+      pooled_(pooled) {
 #ifndef __HIP_PLATFORM_HCC__
   // CUDA have the unofficial limit on the number of recorded blocking interprocess
   // events, to prevent using of all events, we are switching to StreamSync
@@ -141,7 +555,13 @@ CudaIPCSentData::CudaIPCSentData(
   //  [i.record() for i in a]
   //  ```
   //
-  if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
+  if (pooled_) {
+    // See Note [CUDA IPC memory pool]
+    event_ = getPooledEvent(device);
+    C10_CUDA_CHECK(cudaEventRecord(
+        event_, c10::cuda::getCurrentCUDAStream(device.index())));
+    event_sync_required_ = true;
+  } else if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
     // TODO: More efficient would be to create event inside of main thread (at
     // the moment of the queue.put). The reason this is more efficient is
     // because the main thread may have queued extra work on the stream, which
@@ -172,7 +592,7 @@ CudaIPCSentData::~CudaIPCSentData() {
   ReturnRefCounter(handle_, offset_);
 #ifndef __HIP_PLATFORM_HCC__
   try {
-    if (event_sync_required_) {
+    if (event_sync_required_ && !pooled_) {
       at::cuda::CUDAGuard device_guard(device_.index());
       cudaEventDestroy(event_);
       cuda_ipc_global_entities.sync_events_used_ --;
@@ -186,7 +606,10 @@ int64_t CudaIPCSentData::counter_value() {
   return *counter_ptr_;
 }
 
-at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
+at::DataPtr GetNewRefCountedSentData(
+    void* data,
+    at::Device device,
+    bool pooled) {
   {
     std::lock_guard<std::mutex> lock(
         cuda_ipc_global_entities.ref_counters_mutex_);
@@ -218,7 +641,8 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
       cuda_ipc_global_entities.next_available_ref_counters_file_->handle(),
       cuda_ipc_global_entities.next_available_ref_counters_file_->get_offset(),
       cuda_ipc_global_entities.next_available_ref_counters_file_->counter_ptr(),
-      device);
+      device,
+      pooled);
 
   cuda_ipc_global_entities.next_available_ref_counters_file_->rotate_offset();
   if (!cuda_ipc_global_entities.next_available_ref_counters_file_
@@ -229,6 +653,11 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
 }
 
 bool CudaIPCCollect() {
+  {
+    auto& entities = getConsumerEntities();
+    std::lock_guard<std::mutex> lock(entities.mutex_);
+    entities.process_pending_releases(/*wait=*/false);
+  }
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
     cuda_ipc_global_entities.safe_clean_current_file();
@@ -27,12 +27,16 @@ struct CudaIPCSentData final {
   cudaEvent_t event_; // Sync cuEventDestroy
   bool event_sync_required_;
   at::Device device_;
+  // Whether the data is in the IPC memory pool, and the event the one of the
+  // pool. See Note [CUDA IPC memory pool]
+  bool pooled_;
 
   CudaIPCSentData(
       std::string handle,
       int64_t offset,
       int64_t* counter_ptr,
-      at::Device device);
+      at::Device device,
+      bool pooled = false);
   ~CudaIPCSentData();
 
   int64_t counter_value();
@@ -47,7 +51,37 @@ struct CudaIPCSentData final {
   }
 };
 
-at::DataPtr GetNewRefCountedSentData(void* data, at::Device device);
+at::DataPtr GetNewRefCountedSentData(
+    void* data,
+    at::Device device,
+    bool pooled = false);
+
+// See Note [CUDA IPC memory pool]
+//
+// Returns a block of the IPC memory pool of device for a storage of nbytes,
+// or an empty DataPtr if the pool is disabled, full or nbytes too large.
+at::DataPtr CudaIPCPoolAllocate(size_t nbytes, at::Device device);
+bool CudaIPCPoolContains(const void* ptr, at::Device device);
+
+// Consumer side: opens the event of a pool once per process.
+cudaEvent_t CudaIPCOpenPooledEvent(const std::string& ipc_event_handle);
+// Consumer side: keeps the mapping of a pool open after its last storage is
+// released, for the next storages sent in it.
+void CudaIPCRetainPoolMapping(
+    const std::string& handle,
+    std::shared_ptr<void> base_ptr);
+// Consumer side: decrements a ref counter of the producer, through a mapping
+// of its file that is kept open if pooled.
+void CudaIPCReleaseCounter(
+    const std::string& ref_counter_handle,
+    int64_t ref_counter_offset,
+    bool pooled);
+// Consumer side: decrements a ref counter of a pooled storage once the work
+// queued on the current stream of device completed, without synchronizing.
+void CudaIPCReleaseCounterAsync(
+    std::string ref_counter_handle,
+    int64_t ref_counter_offset,
+    at::Device device);
 
 namespace {
 
@@ -10,13 +10,16 @@
 #include <libshm.h>
 #include <TH/TH.h>
 #include <c10/util/Logging.h>
+#include <c10/util/numa.h>
 #include <ATen/ATen.h>
+#include <ATen/BatchedFallback.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/dlpack.h>
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
 #include <ATen/VmapMode.h>
+#include <ATen/native/ConvolutionBenchmark.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -195,6 +198,92 @@ static PyObject * THPModule_setNumInteropThreads(PyObject *module, PyObject *arg
   Py_RETURN_NONE;
 }
 
+static PyObject * THPModule_getIntraopNumaNode(PyObject *module, PyObject *noargs)
+{
+  return PyLong_FromLong(at::get_intraop_numa_node());
+}
+
+static PyObject * THPModule_setIntraopNumaNode(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "set_intraop_numa_node expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  at::set_intraop_numa_node((int)THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static std::vector<int> THPModule_unpackCPUList(PyObject *arg, const char *name)
+{
+  TORCH_CHECK_TYPE(PySequence_Check(arg), name, " expects a sequence of ints, "
+          "but got ", THPUtils_typename(arg));
+  THPObjectPtr seq(PySequence_Fast(arg, "expected a sequence"));
+  if (!seq) throw python_error();
+  std::vector<int> cpus;
+  const auto size = PySequence_Fast_GET_SIZE(seq.get());
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* item = PySequence_Fast_GET_ITEM(seq.get(), i);
+    TORCH_CHECK_TYPE(THPUtils_checkLong(item), name, " expects a sequence of ints, "
+            "but got an element of type ", THPUtils_typename(item));
+    cpus.push_back((int)THPUtils_unpackLong(item));
+  }
+  return cpus;
+}
+
+static PyObject * THPModule_packCPUList(const std::vector<int>& cpus)
+{
+  THPObjectPtr list(PyList_New(cpus.size()));
+  if (!list) throw python_error();
+  for (size_t i = 0; i < cpus.size(); i++) {
+    PyList_SET_ITEM(list.get(), i, PyLong_FromLong(cpus[i]));
+  }
+  return list.release();
+}
+
+static PyObject * THPModule_getIntraopCpus(PyObject *module, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  return THPModule_packCPUList(at::get_intraop_cpus());
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_setIntraopCpus(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  at::set_intraop_cpus(THPModule_unpackCPUList(arg, "set_intraop_cpus"));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_getInteropCpus(PyObject *module, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  return THPModule_packCPUList(at::get_interop_cpus());
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_setInteropCpus(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  at::set_interop_cpus(THPModule_unpackCPUList(arg, "set_interop_cpus"));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_setNumaEnabled(PyObject *module, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_numa_enabled expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  c10::SetNUMAEnabled(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+static PyObject * THPModule_numaEnabled(PyObject *module, PyObject *noargs)
+{
+  if (c10::IsNUMAEnabled()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject * THPModule_setDefaultTensorType(PyObject *_unused, PyObject *type)
 {
   HANDLE_TH_ERRORS
@@ -300,6 +389,15 @@ static PyObject *THPModule_getBackcompatBroadcastWarn(PyObject *module, PyObject
   else Py_RETURN_FALSE;
 }
 
+static PyObject *THPModule_setShmPoolEnabled(PyObject *module, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyBool_Check(arg), "set_shm_pool_enabled expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  libshm_set_pool_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject *THPModule_setBackcompatKeepdimWarn(PyObject *module, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "set_backcompat_keepdim_warn expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -464,6 +562,20 @@ PyObject *THPModule_benchmarkCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setBenchmarkCPUConv(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_benchmark_cpu_conv expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setBenchmarkCPUConv(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_benchmarkCPUConv(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().benchmarkCPUConv()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setAllowTF32CuBLAS(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_allow_tf32_cublas expects a bool, "
@@ -478,6 +590,20 @@ PyObject *THPModule_allowTF32CuBLAS(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setPhiloxCPURNG(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_philox_cpu_rng expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setPhiloxCPURNG(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_philoxCPURNG(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().philoxCPURNG()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setFlushDenormal(PyObject *_unused, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "flush_denormal expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -550,6 +676,27 @@ static PyObject * THPModule_vmapmode_decrement_nesting(PyObject* _unused, PyObje
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * THPModule_vmap_fallback_counts(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPObjectPtr counts(PyDict_New());
+  if (!counts) throw python_error();
+  for (const auto& count : at::batchedFallbackCounts()) {
+    THPObjectPtr value(THPUtils_packInt64(count.second));
+    if (!value || PyDict_SetItemString(counts.get(), count.first.c_str(), value.get()) != 0) {
+      throw python_error();
+    }
+  }
+  return counts.release();
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_vmap_reset_fallback_counts(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  at::resetBatchedFallbackCounts();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 //NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
 static PyMethodDef TorchMethods[] = {
   {"_initExtension",  (PyCFunction)THPModule_initExtension,   METH_O,       nullptr},
@@ -567,26 +714,41 @@ static PyMethodDef TorchMethods[] = {
   {"_parallel_info",    (PyCFunction)THPModule_parallelInfo, METH_NOARGS, nullptr},
   {"_set_backcompat_broadcast_warn", (PyCFunction)THPModule_setBackcompatBroadcastWarn, METH_O, nullptr},
   {"_get_backcompat_broadcast_warn", (PyCFunction)THPModule_getBackcompatBroadcastWarn, METH_NOARGS, nullptr},
+  {"_set_shm_pool_enabled", (PyCFunction)THPModule_setShmPoolEnabled, METH_O, nullptr},
   {"_set_backcompat_keepdim_warn", (PyCFunction)THPModule_setBackcompatKeepdimWarn, METH_O, nullptr},
   {"_get_backcompat_keepdim_warn", (PyCFunction)THPModule_getBackcompatKeepdimWarn, METH_NOARGS, nullptr},
   {"get_num_threads", (PyCFunction)THPModule_getNumThreads,     METH_NOARGS,  nullptr},
   {"set_num_threads", (PyCFunction)THPModule_setNumThreads,     METH_O,       nullptr},
   {"get_num_interop_threads", (PyCFunction)THPModule_getNumInteropThreads,     METH_NOARGS,  nullptr},
   {"set_num_interop_threads", (PyCFunction)THPModule_setNumInteropThreads,     METH_O,       nullptr},
+  {"_get_intraop_numa_node", (PyCFunction)THPModule_getIntraopNumaNode, METH_NOARGS, nullptr},
+  {"_set_intraop_numa_node", (PyCFunction)THPModule_setIntraopNumaNode, METH_O,      nullptr},
+  {"_get_intraop_cpus", (PyCFunction)THPModule_getIntraopCpus, METH_NOARGS, nullptr},
+  {"_set_intraop_cpus", (PyCFunction)THPModule_setIntraopCpus, METH_O,      nullptr},
+  {"_get_interop_cpus", (PyCFunction)THPModule_getInteropCpus, METH_NOARGS, nullptr},
+  {"_set_interop_cpus", (PyCFunction)THPModule_setInteropCpus, METH_O,      nullptr},
+  {"_get_numa_enabled", (PyCFunction)THPModule_numaEnabled, METH_NOARGS,     nullptr},
+  {"_set_numa_enabled", (PyCFunction)THPModule_setNumaEnabled, METH_O,  nullptr},
   {"_get_cudnn_enabled", (PyCFunction)THPModule_userEnabledCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  nullptr},
   {"_get_mkldnn_enabled", (PyCFunction)THPModule_userEnabledMkldnn, METH_NOARGS,     nullptr},
   {"_set_mkldnn_enabled", (PyCFunction)THPModule_setUserEnabledMkldnn, METH_O,  nullptr},
   {"_get_cudnn_benchmark", (PyCFunction)THPModule_benchmarkCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
+  {"_get_cpu_conv_benchmark", (PyCFunction)THPModule_benchmarkCPUConv, METH_NOARGS,     nullptr},
+  {"_set_cpu_conv_benchmark", (PyCFunction)THPModule_setBenchmarkCPUConv, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
   {"_get_deterministic", (PyCFunction)THPModule_deterministic, METH_NOARGS,     nullptr},
   {"_set_deterministic", (PyCFunction)THPModule_setDeterministic, METH_O,  nullptr},
   {"_get_cublas_allow_tf32", (PyCFunction)THPModule_allowTF32CuBLAS, METH_NOARGS,     nullptr},
   {"_set_cublas_allow_tf32", (PyCFunction)THPModule_setAllowTF32CuBLAS, METH_O,  nullptr},
+  {"_get_philox_cpu_rng", (PyCFunction)THPModule_philoxCPURNG, METH_NOARGS,     nullptr},
+  {"_set_philox_cpu_rng", (PyCFunction)THPModule_setPhiloxCPURNG, METH_O,  nullptr},
   {"_vmapmode_increment_nesting", (PyCFunction)THPModule_vmapmode_increment_nesting, METH_NOARGS, nullptr},
   {"_vmapmode_decrement_nesting", (PyCFunction)THPModule_vmapmode_decrement_nesting, METH_NOARGS, nullptr},
+  {"_vmap_fallback_counts", (PyCFunction)THPModule_vmap_fallback_counts, METH_NOARGS, nullptr},
+  {"_vmap_reset_fallback_counts", (PyCFunction)THPModule_vmap_reset_fallback_counts, METH_NOARGS, nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
@@ -801,6 +963,19 @@ Call this whenever a new thread is created in order to propagate values from
 :func:`torch.set_num_threads` onto the new thread.
 )");
 
+  py_module.def("_create_intraop_pool",
+                torch::wrap_pybind_function(at::create_intraop_pool));
+  py_module.def("_set_current_intraop_pool",
+                torch::wrap_pybind_function(at::set_current_intraop_pool));
+  py_module.def("_get_current_intraop_pool", &at::get_current_intraop_pool);
+
+  py_module.def("_get_cpu_conv_benchmark_cache",
+                torch::wrap_pybind_function(at::native::getCPUConvBenchmarkCache));
+  py_module.def("_load_cpu_conv_benchmark_cache",
+                torch::wrap_pybind_function(at::native::loadCPUConvBenchmarkCache));
+  py_module.def("_clear_cpu_conv_benchmark_cache",
+                torch::wrap_pybind_function(at::native::clearCPUConvBenchmarkCache));
+
   ASSERT_TRUE(set_module_attr("has_openmp", at::hasOpenMP() ? Py_True : Py_False));
   ASSERT_TRUE(set_module_attr("has_mkl", at::hasMKL() ? Py_True : Py_False));
   ASSERT_TRUE(set_module_attr("has_lapack", at::hasLAPACK() ? Py_True : Py_False));
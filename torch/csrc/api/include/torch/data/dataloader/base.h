@@ -2,6 +2,7 @@
 
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
+#include <torch/data/detail/device_transfer.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
@@ -11,6 +12,9 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/variadic.h>
 
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/DeviceGuardImplInterface.h>
 #include <c10/util/Exception.h>
 
 #include <cstddef>
@@ -126,6 +130,9 @@ class DataLoaderBase {
         : Sequenced(sqn), exception(std::move(exception)) {}
     optional<Batch> batch;
     std::exception_ptr exception;
+    /// Recorded on the stream of the worker after the copies of the batch to
+    /// the `prefetch_to_device` device, if it is not the CPU.
+    std::shared_ptr<c10::Event> ready_event;
   };
 
   /// Subclass hook for getting the next batch request. The stateless case will
@@ -169,25 +176,72 @@ class DataLoaderBase {
           throw WorkerException(result->exception);
         } else if (result->batch) {
           prefetch(1);
+          if (result->ready_event) {
+            wait_for_transfer(*result);
+          }
           return std::move(result->batch);
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      optional<BatchType> batch =
+          this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      detail::transfer_batch(
+          batch, options_.pin_memory, options_.prefetch_to_device);
+      return batch;
     }
     return nullopt;
   }
 
+  /// Makes the current stream of the thread iterating over the DataLoader
+  /// wait for the copies of the batch made by a worker thread. The caching
+  /// allocator is told the batch is used on that stream, so that its memory
+  /// is not reused by the worker before the work queued on it is done.
+  void wait_for_transfer(Result& result) {
+    const c10::Device device(
+        result.ready_event->device_type(), result.ready_event->device_index());
+    const auto* impl = c10::impl::getDeviceGuardImpl(device.type());
+    const c10::Stream stream = impl->getStream(device);
+    result.ready_event->block(stream);
+    detail::for_each_tensor(result.batch, [&](Tensor& tensor) {
+      if (tensor.is_sparse()) {
+        impl->recordDataPtrOnStream(
+            tensor._indices().storage().data_ptr(), stream);
+        impl->recordDataPtrOnStream(
+            tensor._values().storage().data_ptr(), stream);
+      } else {
+        impl->recordDataPtrOnStream(tensor.storage().data_ptr(), stream);
+      }
+    });
+  }
+
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
+    // Copies to a device other than the CPU are queued on a stream of the
+    // worker, acquired with the first batch.
+    optional<c10::Stream> stream;
     while (true) {
       auto job = shuttle_.pop_job();
       if (job.quit) {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
-        shuttle_.push_result({std::move(batch), job.sequence_number});
+        Result result(
+            dataset.get_batch(std::move(*job.batch_request)),
+            job.sequence_number);
+        const auto& device = options_.prefetch_to_device;
+        if (device && !device->is_cpu()) {
+          const auto* impl = c10::impl::getDeviceGuardImpl(device->type());
+          if (!stream) {
+            stream = impl->getStreamFromGlobalPool(*device);
+          }
+          c10::StreamGuard guard(*stream);
+          detail::transfer_batch(result.batch, options_.pin_memory, device);
+          result.ready_event = std::make_shared<c10::Event>(device->type());
+          result.ready_event->record(*stream);
+        } else {
+          detail::transfer_batch(result.batch, options_.pin_memory, device);
+        }
+        shuttle_.push_result(std::move(result));
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
       }
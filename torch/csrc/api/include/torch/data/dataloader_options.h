@@ -37,6 +37,17 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// Whether to copy the tensors of each batch into pinned memory, so that
+  /// they can be copied to a CUDA device asynchronously.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// A device to copy the tensors of each batch to. The worker threads copy
+  /// the batches they load, on a stream of their own, so that the copies of
+  /// the next `max_jobs` batches overlap with the work on the current one.
+  /// The current stream of the thread iterating over the DataLoader waits
+  /// for the copies of a batch before it is returned.
+  TORCH_ARG(optional<Device>, prefetch_to_device);
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +63,9 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory()),
+        prefetch_to_device(options.prefetch_to_device()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +73,8 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
+  optional<Device> prefetch_to_device;
 };
 } // namespace data
 } // namespace torch
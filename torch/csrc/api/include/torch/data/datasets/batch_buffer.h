@@ -0,0 +1,116 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/util/ArrayRef.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace detail {
+
+/// Keeps the batches a `BatchBufferDataset` has handed out, to fill them again
+/// once nothing else holds on to their memory.
+class BatchBufferPool {
+ public:
+  explicit BatchBufferPool(size_t max_batches) : max_batches_(max_batches) {}
+
+  /// Returns a pooled batch of `batch_size` examples that is not in use
+  /// anymore, or one made by `allocate_batch`.
+  template <typename F>
+  Example<> acquire(size_t batch_size, const F& allocate_batch) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& batch : batches_) {
+        if (batch.data.size(0) == static_cast<int64_t>(batch_size) &&
+            is_free(batch.data) && is_free(batch.target)) {
+          return batch;
+        }
+      }
+    }
+    Example<> batch = allocate_batch(batch_size);
+    TORCH_CHECK(
+        batch.data.size(0) == static_cast<int64_t>(batch_size) &&
+            batch.target.size(0) == static_cast<int64_t>(batch_size),
+        "allocate_batch() returned a batch of ",
+        batch.data.size(0),
+        " data and ",
+        batch.target.size(0),
+        " targets, expected ",
+        batch_size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (batches_.size() < max_batches_) {
+      batches_.push_back(batch);
+    }
+    return batch;
+  }
+
+ private:
+  /// Only the pool refers to the tensor, and to its memory through views.
+  static bool is_free(const Tensor& tensor) {
+    return tensor.use_count() == 1 && tensor.storage().use_count() == 1;
+  }
+
+  const size_t max_batches_;
+  std::mutex mutex_;
+  std::vector<Example<>> batches_;
+};
+
+} // namespace detail
+
+/// A dataset of examples whose data and target tensors all have the same
+/// shape, which writes each example straight into its row of the batch.
+///
+/// `Dataset::get_batch` followed by the `Stack` collation allocates a tensor
+/// per example and copies them all into the batch. A `BatchBufferDataset`
+/// allocates whole batches instead, with `allocate_batch`, and `get_into`
+/// fills one row of them per example. The batches are pooled: a batch is
+/// filled again once its tensors, and all views of them, are destroyed, so
+/// after warm-up loading a batch allocates nothing. The pool is shared by the
+/// copies the DataLoader makes of the dataset for its workers.
+///
+/// Since a pooled batch is overwritten once it is released, keep the tensors
+/// of the batch, not copies of their data pointers, for as long as they are
+/// used.
+template <typename Self>
+class BatchBufferDataset : public BatchDataset<Self, Example<>> {
+ public:
+  /// `max_pooled_batches` bounds the number of batches kept for reuse, it
+  /// should be at least the number of batches alive at once, e.g. the
+  /// `max_jobs` of the DataLoader plus the ones the training loop holds on
+  /// to.
+  explicit BatchBufferDataset(size_t max_pooled_batches = 16)
+      : pool_(std::make_shared<detail::BatchBufferPool>(max_pooled_batches)) {}
+
+  /// Writes the example at `index` into `data` and `target`, the rows of
+  /// the batch it belongs to.
+  virtual void get_into(size_t index, Tensor data, Tensor target) = 0;
+
+  /// Returns new, uninitialized data and target tensors for `batch_size`
+  /// examples, e.g. `torch::empty({batch_size, 3, 32, 32})`.
+  virtual Example<> allocate_batch(size_t batch_size) = 0;
+
+  /// Fills a pooled batch with the examples at `indices`.
+  Example<> get_batch(ArrayRef<size_t> indices) override {
+    Example<> batch = pool_->acquire(
+        indices.size(), [this](size_t size) { return allocate_batch(size); });
+    for (size_t i = 0; i < indices.size(); ++i) {
+      get_into(indices[i], batch.data[i], batch.target[i]);
+    }
+    return batch;
+  }
+
+ private:
+  std::shared_ptr<detail::BatchBufferPool> pool_;
+};
+
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -3,6 +3,7 @@
 #include <torch/arg.h>
 #include <torch/csrc/utils/memory.h>
 #include <torch/data/datasets/stateful.h>
+#include <torch/data/detail/device_transfer.h>
 #include <torch/data/samplers.h>
 #include <queue>
 #include <thread>
@@ -55,10 +56,12 @@ class BatchDataBuffer {
   BatchDataBuffer(
       size_t batch_size,
       ExampleSampler& example_sampler,
-      size_t queue_capacity)
+      size_t queue_capacity,
+      size_t queue_capacity_bytes = 0)
       : batch_size_(batch_size),
         example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+        queue_capacity_(queue_capacity),
+        queue_capacity_bytes_(queue_capacity_bytes) {}
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
@@ -84,6 +87,7 @@ class BatchDataBuffer {
     }
 
     total_example_count_in_queue_ -= batch.batch_data.size();
+    total_bytes_in_queue_ -= batch.batch_bytes;
     lock.unlock();
     cv_write_.notify_all();
 
@@ -96,8 +100,7 @@ class BatchDataBuffer {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_write_.wait(lock, [this] {
       // stop loading if we have preloaded enough data.
-      return this->total_example_count_in_queue_ < this->queue_capacity_ ||
-          this->stop_;
+      return this->has_capacity() || this->stop_;
     });
     if (stop_) {
       // When stop_ is true, it means no further chunk loading is necessary.
@@ -109,7 +112,8 @@ class BatchDataBuffer {
     auto remaining_size = data_size;
     example_sampler_.reset(data_size);
 
-    auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
+    size_t data_bytes = 0;
+    auto fill_batch = [&](size_t example_count, UnwrappedBatchData& batch) {
       auto batch_example_indices = this->example_sampler_.next(example_count);
       AT_ASSERT(
           batch_example_indices &&
@@ -117,7 +121,10 @@ class BatchDataBuffer {
       BatchRequestType& indices = batch_example_indices.value();
       for (size_t i : indices) {
         TORCH_CHECK(i < data_size, "Index out of range");
-        batch.emplace_back(std::move(data[i]));
+        const size_t bytes = example_bytes(data[i]);
+        batch.batch_bytes += bytes;
+        data_bytes += bytes;
+        batch.batch_data.emplace_back(std::move(data[i]));
       }
       remaining_size -= example_count;
     };
@@ -130,7 +137,7 @@ class BatchDataBuffer {
       if (current_count < batch_size_) {
         auto example_count =
             std::min(remaining_size, batch_size_ - current_count);
-        fill_batch(example_count, batch.batch_data);
+        fill_batch(example_count, batch);
       }
     }
 
@@ -141,12 +148,13 @@ class BatchDataBuffer {
 
       // Allocate the batch memory ahead of time.
       current_batch.reserve(batch_size_);
+      batch_queue_.emplace(std::move(current_batch));
 
       auto example_count = std::min(remaining_size, batch_size_);
-      fill_batch(example_count, current_batch);
-      batch_queue_.emplace(std::move(current_batch));
+      fill_batch(example_count, batch_queue_.back());
     }
     total_example_count_in_queue_ += data_size;
+    total_bytes_in_queue_ += data_bytes;
     lock.unlock();
     cv_read_.notify_all();
   }
@@ -157,9 +165,7 @@ class BatchDataBuffer {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_write_.wait(lock, [this] {
       // stop loading if we have preloaded enough data.
-      return (
-        this->total_example_count_in_queue_ < this->queue_capacity_ ||
-        this->stop_);
+      return this->has_capacity() || this->stop_;
     });
     if (stop_){
       // When stop_ is true, it means this current thread needs to be tore down,
@@ -203,6 +209,31 @@ class BatchDataBuffer {
   /// count of total example stored in the queue
   size_t total_example_count_in_queue_ = 0;
 
+  /// bytes of the examples stored in the queue, see `example_bytes`.
+  size_t total_bytes_in_queue_ = 0;
+
+  /// The size of an example, counting the memory of the tensors it holds.
+  template <typename Example>
+  static size_t example_bytes(Example& example) {
+    size_t bytes = sizeof(Example);
+    torch::data::detail::for_each_tensor(example, [&](Tensor& tensor) {
+      bytes += tensor.nbytes();
+    });
+    return bytes;
+  }
+
+  /// Whether more chunks can be loaded. Below a batch worth of examples a
+  /// chunk is always let in, or `get_batch` could wait forever for the
+  /// examples that the byte limit keeps out.
+  bool has_capacity() const {
+    if (total_example_count_in_queue_ >= queue_capacity_) {
+      return false;
+    }
+    return queue_capacity_bytes_ == 0 ||
+        total_bytes_in_queue_ < queue_capacity_bytes_ ||
+        total_example_count_in_queue_ < batch_size_;
+  }
+
   /// struct that contains a raw unwrapped batch unit. An unwrapped batch unit is
   /// the raw data without 'optional' wrapper. It can be a collection of images,
   /// utterances, e.t.c.
@@ -214,6 +245,9 @@ class BatchDataBuffer {
     /// batch data to return
     UnwrappedBatchType batch_data;
 
+    /// bytes of the examples in batch_data.
+    size_t batch_bytes = 0;
+
     /// exception pointer which captures any abnormal exceptions while creating the
     /// batch.
     std::exception_ptr exception;
@@ -233,6 +267,11 @@ class BatchDataBuffer {
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
+  // configurable maximum number of bytes the queue can hold at one time, zero
+  // for no limit. A chunk is let in while the queue is below it, so the queue
+  // can go past it by up to one chunk.
+  size_t queue_capacity_bytes_;
+
   // When set to true, it wakes the writer threads from the wait and exit current
   // function call. This is needed when ChunkDataSet.Reset is called while the
   // previous epoch is not exhausted yet. When ChunkDataset is waiting its
@@ -292,6 +331,11 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  /// The maximum number of bytes of examples to cache, counting the memory of
+  /// their tensors. Zero, the default, means no limit other than
+  /// `cache_size`. Use it when chunks vary a lot in size.
+  TORCH_ARG(size_t, cache_bytes) = 0;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -387,7 +431,8 @@ class ChunkDataset final
         detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
         options_.batch_size(),
         example_sampler_,
-        options_.cache_size());
+        options_.cache_size(),
+        options_.cache_bytes());
 
     // create new workers for this new epoch.
     quit_worker_ = false;
@@ -436,10 +481,21 @@ class ChunkDataset final
           }
         }
         UnwrappedBatchType data = chunk_reader_.read_chunk(chunk_idx[0]);
-        for (size_t i = 1; i < chunk_idx.size(); ++i) {
-          auto chunk_data = chunk_reader_.read_chunk(chunk_idx[i]);
-          std::move(
-              chunk_data.begin(), chunk_data.end(), std::back_inserter(data));
+        if (chunk_idx.size() > 1) {
+          // Read all the chunks first, so that the examples are moved into a
+          // buffer of the final size only once.
+          std::vector<UnwrappedBatchType> chunks;
+          chunks.reserve(chunk_idx.size() - 1);
+          size_t total_size = data.size();
+          for (size_t i = 1; i < chunk_idx.size(); ++i) {
+            chunks.push_back(chunk_reader_.read_chunk(chunk_idx[i]));
+            total_size += chunks.back().size();
+          }
+          data.reserve(total_size);
+          for (auto& chunk_data : chunks) {
+            std::move(
+                chunk_data.begin(), chunk_data.end(), std::back_inserter(data));
+          }
         }
         if (preprocessing_policy_) {
           preprocessing_policy_(data);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Calls `function` with a reference to each tensor of a batch, looking into
+/// the `Example`s, vectors and optionals the batch is made of. Anything else
+/// in the batch is left as is.
+template <typename T, typename F>
+void for_each_tensor(T& value, const F& function);
+template <typename F>
+void for_each_tensor(Tensor& tensor, const F& function);
+template <typename Data, typename Target, typename F>
+void for_each_tensor(Example<Data, Target>& example, const F& function);
+template <typename Data, typename F>
+void for_each_tensor(
+    Example<Data, example::NoTarget>& example,
+    const F& function);
+template <typename T, typename F>
+void for_each_tensor(std::vector<T>& values, const F& function);
+template <typename T, typename F>
+void for_each_tensor(optional<T>& value, const F& function);
+
+template <typename T, typename F>
+void for_each_tensor(T& /*value*/, const F& /*function*/) {}
+
+template <typename F>
+void for_each_tensor(Tensor& tensor, const F& function) {
+  if (tensor.defined()) {
+    function(tensor);
+  }
+}
+
+template <typename Data, typename Target, typename F>
+void for_each_tensor(Example<Data, Target>& example, const F& function) {
+  for_each_tensor(example.data, function);
+  for_each_tensor(example.target, function);
+}
+
+template <typename Data, typename F>
+void for_each_tensor(
+    Example<Data, example::NoTarget>& example,
+    const F& function) {
+  for_each_tensor(example.data, function);
+}
+
+template <typename T, typename F>
+void for_each_tensor(std::vector<T>& values, const F& function) {
+  for (auto& value : values) {
+    for_each_tensor(value, function);
+  }
+}
+
+template <typename T, typename F>
+void for_each_tensor(optional<T>& value, const F& function) {
+  if (value) {
+    for_each_tensor(*value, function);
+  }
+}
+
+/// Pins the CPU tensors of the batch if `pin_memory` is true, and copies all
+/// of them to `device` if it is set. The copies are non-blocking, they are
+/// queued on the current stream of the device.
+template <typename Batch>
+void transfer_batch(
+    Batch& batch,
+    bool pin_memory,
+    const optional<Device>& device) {
+  for_each_tensor(batch, [&](Tensor& tensor) {
+    if (pin_memory && tensor.device().is_cpu() && !tensor.is_sparse() &&
+        !tensor.is_pinned()) {
+      tensor = tensor.pin_memory();
+    }
+    if (device) {
+      tensor = tensor.to(*device, /*non_blocking=*/true);
+    }
+  });
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <mutex>
 #include <queue>
+#include <utility>
 
 namespace torch {
 namespace data {
@@ -55,7 +56,8 @@ class Queue {
       cv_.wait(lock, [this] { return !this->queue_.empty(); });
     }
     AT_ASSERT(!queue_.empty());
-    T value = queue_.front();
+    // Moved out, batches can be large and are not always cheap to copy.
+    T value = std::move(queue_.front());
     queue_.pop();
     lock.unlock();
     return value;
@@ -68,9 +70,7 @@ class Queue {
   size_t clear() {
     std::lock_guard<std::mutex> lock(this->mutex_);
     const auto size = queue_.size();
-    while (!queue_.empty()) {
-      queue_.pop();
-    }
+    std::queue<T>().swap(queue_);
     return size;
   }
 
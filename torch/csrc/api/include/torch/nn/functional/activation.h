@@ -574,6 +574,87 @@ inline Tensor threshold(Tensor input, const ThresholdFuncOptions& options) {
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace detail {
+// Self-attention with packed projection weights and without bias_k, bias_v,
+// zero attention or static keys and values, in fewer kernels than the general
+// multi_head_attention_forward: one GEMM for the packed input projection, one
+// copy to lay the heads of q, k and v out as batches, one batched GEMM which
+// also scales and adds the masks, the softmax, one batched GEMM, one copy back
+// to (tgt_len, bsz, embed_dim) and one GEMM for the output projection.
+inline std::tuple<Tensor, Tensor> fused_self_attention_forward(
+  const Tensor& query,
+  int64_t num_heads,
+  const Tensor& in_proj_weight,
+  const Tensor& in_proj_bias,
+  double dropout_p,
+  const Tensor& out_proj_weight,
+  const Tensor& out_proj_bias,
+  bool training,
+  const Tensor& key_padding_mask,
+  bool need_weights,
+  const Tensor& attn_mask) {
+  namespace F = torch::nn::functional;
+
+  const auto tgt_len = query.size(0);
+  const auto bsz = query.size(1);
+  const auto embed_dim = query.size(2);
+  const auto head_dim = embed_dim / num_heads;
+  TORCH_CHECK(head_dim * num_heads == embed_dim,
+              "embed_dim must be divisible by num_heads");
+  const auto scaling = 1 / std::sqrt(head_dim);
+
+  // (tgt_len * bsz, 3 * embed_dim) -> (3, bsz * num_heads, tgt_len, head_dim)
+  const auto qkv = F::linear(query.reshape({tgt_len * bsz, embed_dim}), in_proj_weight, in_proj_bias)
+    .view({tgt_len, bsz, 3, num_heads, head_dim})
+    .permute({2, 1, 3, 0, 4})
+    .contiguous()
+    .view({3, bsz * num_heads, tgt_len, head_dim});
+  const auto q = qkv[0];
+  const auto k = qkv[1];
+  const auto v = qkv[2];
+
+  // The masks added to the attention weights, broadcastable to
+  // (bsz, num_heads, tgt_len, src_len)
+  Tensor mask;
+  if (attn_mask.defined()) {
+    TORCH_CHECK(attn_mask.sizes() == IntArrayRef({tgt_len, tgt_len}));
+    mask = attn_mask;
+  }
+  if (key_padding_mask.defined()) {
+    TORCH_CHECK(key_padding_mask.sizes() == IntArrayRef({bsz, tgt_len}));
+    auto padding = torch::zeros({bsz, 1, 1, tgt_len}, q.options()).masked_fill_(
+      key_padding_mask.view({bsz, 1, 1, tgt_len}),
+      -std::numeric_limits<double>::infinity());
+    mask = mask.defined() ? padding + mask : padding;
+  }
+  Tensor attn_output_weights;
+  if (mask.defined()) {
+    attn_output_weights = torch::baddbmm(
+      mask.expand({bsz, num_heads, tgt_len, tgt_len}).reshape({bsz * num_heads, tgt_len, tgt_len}),
+      q,
+      k.transpose(1, 2),
+      /*beta=*/1,
+      /*alpha=*/scaling);
+  } else {
+    attn_output_weights = torch::bmm(q * scaling, k.transpose(1, 2));
+  }
+  attn_output_weights = F::softmax(attn_output_weights, /*dim=*/-1);
+  attn_output_weights = F::dropout(attn_output_weights, F::DropoutFuncOptions().p(dropout_p).training(training));
+
+  // (bsz * num_heads, tgt_len, head_dim) -> (tgt_len * bsz, embed_dim)
+  auto attn_output = torch::bmm(attn_output_weights, v)
+    .view({bsz, num_heads, tgt_len, head_dim})
+    .permute({2, 0, 1, 3})
+    .reshape({tgt_len * bsz, embed_dim});
+  attn_output = F::linear(attn_output, out_proj_weight, out_proj_bias).view({tgt_len, bsz, embed_dim});
+  if (need_weights) {
+    // average attention weights over heads
+    attn_output_weights = attn_output_weights.view({bsz, num_heads, tgt_len, tgt_len});
+    return std::make_tuple(attn_output, attn_output_weights.sum(/*dim=*/1) / num_heads);
+  } else {
+    return std::make_tuple(attn_output, Tensor());
+  }
+}
+
 inline std::tuple<Tensor, Tensor> multi_head_attention_forward(
   const Tensor& query,
   const Tensor& key,
@@ -607,6 +688,25 @@ inline std::tuple<Tensor, Tensor> multi_head_attention_forward(
   TORCH_INTERNAL_ASSERT(embed_dim == embed_dim_to_check);
   TORCH_INTERNAL_ASSERT(key.sizes() == value.sizes());
 
+  if (query.is_same(key) && key.is_same(value) && !use_separate_proj_weight &&
+      !bias_k.defined() && !bias_v.defined() && !add_zero_attn &&
+      !static_k.defined() && !static_v.defined() &&
+      (!attn_mask.defined() || (attn_mask.dim() == 2 && attn_mask.is_floating_point())) &&
+      (!key_padding_mask.defined() || key_padding_mask.dim() == 2)) {
+    return fused_self_attention_forward(
+      query,
+      num_heads,
+      in_proj_weight,
+      in_proj_bias,
+      dropout_p,
+      out_proj_weight,
+      out_proj_bias,
+      training,
+      key_padding_mask,
+      need_weights,
+      attn_mask);
+  }
+
   const auto head_dim = embed_dim / num_heads;
   TORCH_CHECK(head_dim * num_heads == embed_dim,
               "embed_dim must be divisible by num_heads");
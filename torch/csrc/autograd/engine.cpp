@@ -16,13 +16,17 @@
 #include <c10/core/Event.h>
 #include <c10/core/DeviceGuard.h>
 #include <c10/util/Optional.h>
+#include <c10/util/string_utils.h>
 #include <c10/core/StreamGuard.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -172,12 +176,18 @@ auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
   {
     // Lock mutex for writing to heap_
     std::lock_guard<std::mutex> lock(mutex_);
+    bool unordered = false;
     if (incrementOutstandingTasks) {
       std::shared_ptr<GraphTask> graph_task = item.base_.lock();
       TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
       ++graph_task->outstanding_tasks_;
+      unordered = graph_task->unordered_cpu_tasks_ && item.fn_;
+    }
+    if (unordered) {
+      unordered_tasks_.push_back(std::move(item));
+    } else {
+      heap_.push(std::move(item));
     }
-    heap_.push(std::move(item));
   }
   not_empty_.notify_one();
 }
@@ -193,25 +203,79 @@ auto ReadyQueue::pushShutdownTask() -> void {
 size_t ReadyQueue::size() const {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
-  return heap_.size();
+  return heap_.size() + unordered_tasks_.size();
 }
 
-auto ReadyQueue::pop() -> NodeTask {
-  // Lock mutex for accesses to heap_
-  std::unique_lock<std::mutex> lock(mutex_);
-  not_empty_.wait(lock, [this]{ return !heap_.empty(); });
+auto ReadyQueue::pop_locked() -> NodeTask {
+  // The tasks on heap_ are shutdown and wake-up tasks, and the tasks of
+  // reentrant graph tasks, which all come before the others.
+  if (heap_.empty()) {
+    auto task = std::move(unordered_tasks_.back());
+    unordered_tasks_.pop_back();
+    return task;
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
   return task;
 }
 
+auto ReadyQueue::pop() -> NodeTask {
+  // Lock mutex for accesses to heap_
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this]{ return !heap_.empty() || !unordered_tasks_.empty(); });
+  return pop_locked();
+}
+
+auto ReadyQueue::try_pop() -> c10::optional<NodeTask> {
+  // Lock mutex for accesses to heap_
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Tasks without a function are ordered first
+  if (heap_.empty() ? unordered_tasks_.empty()
+                    : !heap_.top().fn_ || heap_.top().isShutdownTask_) {
+    return c10::nullopt;
+  }
+  return pop_locked();
+}
+
 bool ReadyQueue::empty() const {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
-  return heap_.empty();
+  return heap_.empty() && unordered_tasks_.empty();
+}
+
+namespace {
+bool cpu_priority_ordering_from_env() {
+  const char* value = std::getenv("PYTORCH_AUTOGRAD_CPU_PRIORITY_ORDERING");
+  return value == nullptr || strcmp(value, "0") != 0;
+}
+
+bool static_backward_from_env() {
+  const char* value = std::getenv("PYTORCH_AUTOGRAD_STATIC_BACKWARD");
+  return value != nullptr && strcmp(value, "1") == 0;
+}
+
+int num_cpu_workers_from_env() {
+  const char* value = std::getenv("PYTORCH_AUTOGRAD_CPU_WORKERS");
+  if (value == nullptr) {
+    return 0;
+  }
+  try {
+    int num_workers = c10::stoi(value);
+    TORCH_CHECK(num_workers >= 0);
+    return num_workers;
+  } catch (const std::exception&) {
+    TORCH_WARN("Ignoring invalid PYTORCH_AUTOGRAD_CPU_WORKERS value ", value);
+  }
+  return 0;
 }
+} // namespace
 
-Engine::Engine() : max_recursion_depth_(MAX_DEPTH), non_reentrant_device_thread_count_(0) {}
+Engine::Engine()
+    : max_recursion_depth_(MAX_DEPTH),
+      num_cpu_workers_(num_cpu_workers_from_env()),
+      cpu_priority_ordering_(cpu_priority_ordering_from_env()),
+      static_backward_(static_backward_from_env()),
+      non_reentrant_device_thread_count_(0) {}
 
 // Send shutdown tasks to all device_ready_queues_ if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest priority
@@ -368,6 +432,9 @@ auto Engine::thread_main(const std::shared_ptr<GraphTask>& graph_task) -> void {
       }
 
       if (task.fn_ && !local_graph_task->has_error_.load()) {
+        if (local_ready_queue == local_graph_task->cpu_ready_queue_) {
+          add_cpu_workers(local_graph_task);
+        }
         AutoGradMode grad_mode(local_graph_task->grad_mode_);
         try {
           // The guard sets the thread_local current_graph_task on construction
@@ -437,6 +504,110 @@ void Engine::reentrant_thread_init() {
   }
 }
 
+void Engine::set_num_cpu_workers(int num_workers) {
+  TORCH_CHECK(num_workers >= 0, "Expected a non-negative number of CPU workers");
+  num_cpu_workers_.store(num_workers);
+}
+
+int Engine::get_num_cpu_workers() const {
+  return num_cpu_workers_.load();
+}
+
+void Engine::set_cpu_priority_ordering(bool enabled) {
+  cpu_priority_ordering_.store(enabled);
+}
+
+bool Engine::get_cpu_priority_ordering() const {
+  return cpu_priority_ordering_.load();
+}
+
+void Engine::set_static_backward(bool enabled) {
+  static_backward_.store(enabled);
+}
+
+bool Engine::get_static_backward() const {
+  return static_backward_.load();
+}
+
+void Engine::add_cpu_workers(const std::shared_ptr<GraphTask>& graph_task) {
+  int max_workers = num_cpu_workers_.load(std::memory_order_relaxed);
+  // Device threads are the only ones that may run their tasks
+  if (max_workers == 0 || graph_task->owner_ != CPU_DEVICE) {
+    return;
+  }
+  std::call_once(start_cpu_workers_flag_, [this, max_workers]() {
+    cpu_worker_pool_ = std::make_shared<c10::ThreadPool>(
+        max_workers, -1, []() { at::init_num_threads(); });
+  });
+  max_workers = std::min(max_workers, static_cast<int>(cpu_worker_pool_->size()));
+  // Every running worker takes one of the ready tasks
+  const size_t num_ready = graph_task->cpu_ready_queue_->size();
+  int num_workers = graph_task->cpu_workers_.load();
+  while (static_cast<size_t>(num_workers) < num_ready &&
+         num_workers < max_workers) {
+    if (graph_task->cpu_workers_.compare_exchange_weak(
+            num_workers, num_workers + 1)) {
+      std::weak_ptr<GraphTask> weak_graph_task = graph_task;
+      cpu_worker_pool_->run(
+          [this, weak_graph_task]() { cpu_worker_main(weak_graph_task); });
+      ++num_workers;
+    }
+  }
+}
+
+// A CPU worker runs ready tasks from the CPU ready queue of a graph task like
+// its owning thread does, but returns as soon as the queue has no task for
+// it, so it never waits for work. The owning thread keeps popping tasks and
+// sleeps on the queue, which is why the worker always wakes it up when it
+// completes a graph task.
+void Engine::cpu_worker_main(const std::weak_ptr<GraphTask>& weak_graph_task) {
+  std::shared_ptr<GraphTask> graph_task = weak_graph_task.lock();
+  if (!graph_task) {
+    return;
+  }
+  // A backward call from a node run by the worker is reentrant, like one
+  // from the owning thread.
+  set_device(CPU_DEVICE);
+  total_depth = graph_task->reentrant_depth_;
+  const auto cpu_ready_queue = graph_task->cpu_ready_queue_;
+
+  while (!graph_task->future_result_->completed()) {
+    std::shared_ptr<GraphTask> local_graph_task;
+    {
+      c10::optional<NodeTask> task = cpu_ready_queue->try_pop();
+      if (!task) {
+        break;
+      }
+      if (!(local_graph_task = task->base_.lock())) {
+        continue;
+      }
+      if (!local_graph_task->has_error_.load()) {
+        add_cpu_workers(local_graph_task);
+        AutoGradMode grad_mode(local_graph_task->grad_mode_);
+        try {
+          GraphTaskGuard guard(local_graph_task);
+          evaluate_function(local_graph_task, task->fn_.get(), task->inputs_, local_graph_task->cpu_ready_queue_);
+        } catch (std::exception& e) {
+          thread_on_exception(local_graph_task, task->fn_, e);
+        }
+      }
+    }
+
+    --local_graph_task->outstanding_tasks_;
+
+    if (local_graph_task->completed()) {
+      local_graph_task->mark_as_completed_and_run_post_processing();
+      std::atomic_thread_fence(std::memory_order_release);
+      ready_queue_by_index(local_graph_task->cpu_ready_queue_, local_graph_task->owner_)
+          ->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
+    }
+  }
+
+  --graph_task->cpu_workers_;
+  worker_device = NO_DEVICE;
+  total_depth = 0;
+}
+
 void Engine::thread_on_exception(
     std::shared_ptr<GraphTask> graph_task,
     const std::shared_ptr<Node>& fn,
@@ -819,15 +990,151 @@ void Engine::evaluate_function(
   }
 }
 
+// Whether all nodes of a graph task take their inputs on CPU, call after
+// compute_dependencies. The ready queues of device threads are shared between
+// graph tasks, so only those that never reach one can skip the ordering.
+static bool is_cpu_only(const GraphTask& task) {
+  for (const auto& dependency : task.dependencies_) {
+    const Node* fn = dependency.first;
+    for (uint32_t i = 0; i < fn->num_inputs(); i++) {
+      if (fn->input_metadata(i).device().type() != at::kCPU) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+namespace {
+// How compute_dependencies traversed a graph. Nodes are numbered in the
+// order they are first reached, the root being 0. For each node in the
+// order it is expanded, num_edges has its number of next edges and
+// edge_targets the numbers of the nodes they point to, kNoTarget for
+// undefined edges.
+constexpr uint32_t kNoTarget = std::numeric_limits<uint32_t>::max();
+
+struct StaticBackwardPlan {
+  std::vector<uint32_t> num_edges;
+  std::vector<uint32_t> edge_targets;
+  std::vector<int> dependencies;
+};
+
+// Plans of the graphs the calling thread backwarded through last, the most
+// recently used first
+constexpr size_t kMaxStaticBackwardPlans = 4;
+thread_local std::vector<std::unique_ptr<StaticBackwardPlan>> static_backward_plans;
+
+// Computes the dependencies of the graph at root from plan, or returns false
+// and leaves dependencies empty if the graph does not have its shape
+bool replay_dependencies(
+    const StaticBackwardPlan& plan,
+    Node* root,
+    std::unordered_map<Node*, int>& dependencies) {
+  std::vector<Node*> nodes;
+  nodes.reserve(plan.dependencies.size());
+  nodes.push_back(root);
+  std::vector<Node*> queue { root };
+  size_t step = 0;
+  size_t edge_idx = 0;
+  while (!queue.empty()) {
+    auto fn = queue.back(); queue.pop_back();
+    const auto& next_edges = fn->next_edges();
+    if (step == plan.num_edges.size() || next_edges.size() != plan.num_edges[step]) {
+      return false;
+    }
+    step++;
+    for (const auto& edge : next_edges) {
+      const uint32_t target = plan.edge_targets[edge_idx++];
+      auto next_ptr = edge.function.get();
+      if (!next_ptr) {
+        if (target != kNoTarget) {
+          return false;
+        }
+      } else if (target == nodes.size()) {
+        nodes.push_back(next_ptr);
+        queue.push_back(next_ptr);
+      } else if (target > nodes.size() || nodes[target] != next_ptr) {
+        return false;
+      }
+    }
+  }
+  if (step != plan.num_edges.size()) {
+    return false;
+  }
+  // A node the plan reached twice as a new one shows up here
+  dependencies.reserve(nodes.size());
+  for (size_t i = 1; i < nodes.size(); i++) {
+    if (!dependencies.emplace(nodes[i], plan.dependencies[i]).second) {
+      dependencies.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+// compute_dependencies recording its traversal
+std::unique_ptr<StaticBackwardPlan> record_dependencies(
+    Node* root,
+    std::unordered_map<Node*, int>& dependencies) {
+  auto plan = std::make_unique<StaticBackwardPlan>();
+  std::unordered_map<Node*, uint32_t> seen;
+  seen.emplace(root, 0);
+  plan->dependencies.push_back(0);
+  std::vector<Node*> queue { root };
+  while (!queue.empty()) {
+    auto fn = queue.back(); queue.pop_back();
+    plan->num_edges.push_back(fn->next_edges().size());
+    for (const auto& edge : fn->next_edges()) {
+      auto next_ptr = edge.function.get();
+      if (!next_ptr) {
+        plan->edge_targets.push_back(kNoTarget);
+        continue;
+      }
+      auto it = seen.emplace(next_ptr, plan->dependencies.size());
+      if (it.second) {
+        plan->dependencies.push_back(0);
+        queue.push_back(next_ptr);
+      }
+      plan->edge_targets.push_back(it.first->second);
+      plan->dependencies[it.first->second] += 1;
+    }
+  }
+  dependencies.reserve(seen.size());
+  for (const auto& node : seen) {
+    if (node.first != root) {
+      dependencies.emplace(node.first, plan->dependencies[node.second]);
+    }
+  }
+  return plan;
+}
+} // namespace
+
 /* Computes the number of dependencies for each function which requires grad */
 auto Engine::compute_dependencies(Node* root, GraphTask& task) -> void {
+  auto& dependencies = task.dependencies_;
+  if (static_backward_.load(std::memory_order_relaxed)) {
+    auto& plans = static_backward_plans;
+    for (size_t i = 0; i < plans.size(); i++) {
+      if (replay_dependencies(*plans[i], root, dependencies)) {
+        std::rotate(plans.begin(), plans.begin() + i, plans.begin() + i + 1);
+        task.not_ready_.reserve(dependencies.size());
+        return;
+      }
+    }
+    if (plans.size() == kMaxStaticBackwardPlans) {
+      plans.pop_back();
+    }
+    plans.insert(plans.begin(), record_dependencies(root, dependencies));
+    task.not_ready_.reserve(dependencies.size());
+    return;
+  }
+
   // Just to make sure that they will never be added to the queue again
   std::unordered_set<Node*> seen;
   std::vector<Node*> queue { root };
 
   // Queue contains all nodes that will start propagating gradients.
   // We no longer have to expand functions that don't require grad.
-  auto& dependencies = task.dependencies_;
   while (!queue.empty()) {
     auto fn = queue.back(); queue.pop_back();
     for (const auto& edge : fn->next_edges()) {
@@ -867,6 +1174,10 @@ auto Engine::execute(const edge_list& roots,
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
   compute_dependencies(graph_root.get(), *graph_task);
 
+  if (not_reentrant_backward_call && !cpu_priority_ordering_.load()) {
+    graph_task->unordered_cpu_tasks_ = is_cpu_only(*graph_task);
+  }
+
   if (!outputs.empty()) {
     graph_task->init_to_execute(*graph_root, outputs);
   }
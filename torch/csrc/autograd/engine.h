@@ -11,6 +11,8 @@
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/utils/future.h>
+#include <c10/core/thread_pool.h>
+#include <c10/util/Optional.h>
 
 #include <deque>
 #include <exception>
@@ -54,9 +56,16 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // true, it signals all threads to stop executing.
   std::atomic_bool has_error_{false};
   std::atomic_bool future_completed_{false};
+  // Number of CPU worker tasks started to help with this graph task, see
+  // Engine::set_num_cpu_workers.
+  std::atomic<int> cpu_workers_{0};
   // It is safe to read grad_mode_ and keep_graph_ without synchronization
   bool keep_graph_;
   bool grad_mode_;
+  // Whether the CPU tasks of this graph task skip the priority ordering of
+  // the ReadyQueue, see Engine::set_cpu_priority_ordering. Set before the
+  // first task is pushed, safe to read without synchronization.
+  bool unordered_cpu_tasks_ = false;
 
   // To protect reads/writes to not_ready_, dependencies_, captured_vars_,
   // has_error_, future_result_, cpu_ready_queue_, and leaf_streams.
@@ -242,6 +251,11 @@ struct ReadyQueue {
   mutable std::mutex mutex_;
 
   std::priority_queue<NodeTask, std::vector<NodeTask>, CompareNodeTaskTime> heap_;
+  // Tasks of graph tasks with unordered_cpu_tasks_, run last in first out
+  // after the tasks on heap_, without a heap operation per push and pop.
+  std::vector<NodeTask> unordered_tasks_;
+
+  NodeTask pop_locked();
 
  public:
   // incrementOutstandingTasks indicates whether or not we should increment
@@ -251,6 +265,9 @@ struct ReadyQueue {
   void push(NodeTask item, bool incrementOutstandingTasks = true);
   void pushShutdownTask();
   NodeTask pop();
+  // Pops a ready task without waiting. Leaves the tasks without a function,
+  // which wake up the thread owning the queue, for that thread.
+  c10::optional<NodeTask> try_pop();
   bool empty() const;
   size_t size() const;
 };
@@ -312,6 +329,33 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Sets the number of extra threads that take CPU tasks of a backward pass
+  // from the thread that called it, whenever several of its nodes are ready
+  // at once. 0, the default, runs all CPU work on the calling thread.
+  // PYTORCH_AUTOGRAD_CPU_WORKERS sets it in the environment. The threads are
+  // created by the first backward pass that uses them, raising the number
+  // later does not add more.
+  void set_num_cpu_workers(int num_workers);
+  int get_num_cpu_workers() const;
+
+  // When disabled, backward passes whose nodes all run on CPU and that are
+  // not reentrant run their nodes in last in first out order instead of by
+  // sequence number, which saves a heap operation per node for graphs of
+  // many small nodes. Enabled by default, PYTORCH_AUTOGRAD_CPU_PRIORITY_ORDERING=0
+  // disables it in the environment.
+  void set_cpu_priority_ordering(bool enabled);
+  bool get_cpu_priority_ordering() const;
+
+  // When enabled, the calling thread remembers how it traversed the last few
+  // graphs to compute their dependencies and replays that traversal for a
+  // graph of the same shape, checking the shape as it goes instead of
+  // hashing every edge, and falling back to the full computation when the
+  // graph changed. Meant for training loops that backward through the same
+  // architecture every iteration. Disabled by default,
+  // PYTORCH_AUTOGRAD_STATIC_BACKWARD=1 enables it in the environment.
+  void set_static_backward(bool enabled);
+  bool get_static_backward() const;
+
   // Initializes a device thread for the autograd engine.
   virtual void thread_init(
       int device,
@@ -341,6 +385,9 @@ struct TORCH_API Engine {
   virtual void thread_main(const std::shared_ptr<GraphTask>& task);
   void reentrant_thread_init();
   void add_thread_pool_task(const std::weak_ptr<GraphTask>& graph_task);
+  // Starts CPU workers for the ready tasks of graph_task nobody took yet
+  void add_cpu_workers(const std::shared_ptr<GraphTask>& graph_task);
+  void cpu_worker_main(const std::weak_ptr<GraphTask>& graph_task);
 
   // Ensures device_ready_queues_ are initialized only once
   std::once_flag start_device_threads_flag_;
@@ -377,6 +424,14 @@ struct TORCH_API Engine {
  // for the graphtasks_queue_ to be nonempty.
  std::shared_ptr<ThreadPoolShared> thread_pool_shared_;
 
+ // Threads that help the calling thread with the CPU work of a backward pass.
+ // Like the threads above, they wait for work until the process exits.
+ std::atomic<int> num_cpu_workers_;
+ std::atomic<bool> cpu_priority_ordering_;
+ std::atomic<bool> static_backward_;
+ std::once_flag start_cpu_workers_flag_;
+ std::shared_ptr<c10::ThreadPool> cpu_worker_pool_;
+
 private:
   // Number of non-reentrant threads
   std::atomic<uint32_t> non_reentrant_device_thread_count_;
@@ -45,6 +45,17 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
 
   at::Tensor& grad = variable.mutable_grad();
 
+  // The first gradient goes into the grad buffer if there is one, see
+  // impl::set_grad_buffer. Accumulating later ones in place keeps it there.
+  if (!grad.defined() && !GradMode::is_enabled() && !new_grad.is_sparse()) {
+    auto buffer = impl::grad_buffer(variable);
+    if (buffer.defined()) {
+      buffer.copy_(new_grad);
+      grad = std::move(buffer);
+      return variable_list();
+    }
+  }
+
   // If the function has post hooks (for example, a DDP allreduce hook),
   // call_function in Engine.cpp will temporarily bump the expected refcount
   // by one, hence the addition of !post_hooks().empty() for 'num_expected_refs'
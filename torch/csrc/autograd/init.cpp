@@ -2,11 +2,15 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/utils/pybind.h>
+#include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <ATen/autocast_mode.h>
 #include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/sampling_profiler.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/variable.h>
 
 PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   using namespace torch::autograd::profiler;
@@ -34,7 +38,8 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("Disabled", ProfilerState::Disabled)
       .value("CPU", ProfilerState::CPU)
       .value("CUDA", ProfilerState::CUDA)
-      .value("NVTX", ProfilerState::NVTX);
+      .value("NVTX", ProfilerState::NVTX)
+      .value("CUPTI", ProfilerState::CUPTI);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
       .def(py::init<ProfilerState, bool, bool>());
@@ -45,19 +50,52 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("thread_id", &Event::thread_id)
       .def("device", &Event::device)
       .def("cpu_elapsed_us", &Event::cpu_elapsed_us)
+      .def("cpu_us", &Event::cpu_us)
       .def("cuda_elapsed_us", &Event::cuda_elapsed_us)
       .def("has_cuda", &Event::has_cuda)
       .def("shapes", &Event::shapes)
       .def("cpu_memory_usage", &Event::cpu_memory_usage)
       .def("cuda_memory_usage", &Event::cuda_memory_usage)
       .def("handle", &Event::handle)
+      .def("memory_ptr", &Event::memory_ptr)
       .def("node_id", &Event::node_id)
       .def("is_remote", &Event::isRemote)
       .def("sequence_nr", &Event::sequence_nr);
 
+  py::class_<GPUActivity>(m, "GPUActivity")
+      .def_readonly("name", &GPUActivity::name)
+      .def_readonly("device", &GPUActivity::device)
+      .def_readonly("stream", &GPUActivity::stream)
+      .def_readonly("start_ns", &GPUActivity::start_ns)
+      .def_readonly("end_ns", &GPUActivity::end_ns)
+      .def_readonly("correlation_id", &GPUActivity::correlation_id);
+
+  py::class_<OpLatencyStats>(m, "OpLatencyStats")
+      .def_readonly("name", &OpLatencyStats::name)
+      .def_readonly("shapes", &OpLatencyStats::shapes)
+      .def_readonly("count", &OpLatencyStats::count)
+      .def_readonly("total_ns", &OpLatencyStats::total_ns)
+      .def_readonly("min_ns", &OpLatencyStats::min_ns)
+      .def_readonly("max_ns", &OpLatencyStats::max_ns)
+      .def_property_readonly("buckets", [](const OpLatencyStats& stats) {
+        return std::vector<int64_t>(stats.buckets.begin(), stats.buckets.end());
+      });
+
+  m.def("_enable_sampling_profiler", [](double sampling_prob, bool record_shapes) {
+    SamplingProfilerConfig config;
+    config.sampling_prob = sampling_prob;
+    config.record_shapes = record_shapes;
+    enableSamplingProfiler(std::move(config));
+  });
+  m.def("_disable_sampling_profiler", disableSamplingProfiler);
+  m.def("_sampling_profiler_enabled", samplingProfilerEnabled);
+  m.def("_flush_sampling_profiler", flushSamplingProfiler);
+
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
   m.def("_profiler_enabled", profilerEnabled);
+  m.def("_take_gpu_activities", takeGPUActivities);
+  m.def("_cupti_available", cuptiAvailable);
   m.def("_enable_record_function", [](bool enable) {
     at::enableRecordFunction(enable);
   });
@@ -76,6 +114,40 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   m.def("_clear_callbacks", []() {
     at::clearCallbacks();
   });
+  m.def("_set_num_cpu_workers", [](int num_workers) {
+    torch::autograd::Engine::get_default_engine().set_num_cpu_workers(num_workers);
+  });
+  m.def("_get_num_cpu_workers", []() {
+    return torch::autograd::Engine::get_default_engine().get_num_cpu_workers();
+  });
+  m.def("_set_cpu_priority_ordering", [](bool enabled) {
+    torch::autograd::Engine::get_default_engine().set_cpu_priority_ordering(enabled);
+  });
+  m.def("_get_cpu_priority_ordering", []() {
+    return torch::autograd::Engine::get_default_engine().get_cpu_priority_ordering();
+  });
+  m.def("_set_static_backward", [](bool enabled) {
+    torch::autograd::Engine::get_default_engine().set_static_backward(enabled);
+  });
+  m.def("_get_static_backward", []() {
+    return torch::autograd::Engine::get_default_engine().get_static_backward();
+  });
+  m.def("_set_grad_buffer", [](const at::Tensor& tensor, c10::optional<at::Tensor> buffer) {
+    torch::autograd::impl::set_grad_buffer(tensor, buffer.value_or(at::Tensor()));
+  });
+  m.def("_get_grad_buffer", [](const at::Tensor& tensor) -> c10::optional<at::Tensor> {
+    auto buffer = torch::autograd::impl::grad_buffer(tensor);
+    if (!buffer.defined()) {
+      return c10::nullopt;
+    }
+    return buffer;
+  });
+  m.def("_push_saved_tensors_default_hooks", [](py::function pack_hook, py::function unpack_hook) {
+    torch::autograd::push_py_saved_variable_hooks(std::move(pack_hook), std::move(unpack_hook));
+  });
+  m.def("_pop_saved_tensors_default_hooks", []() {
+    torch::autograd::pop_saved_variable_hooks();
+  });
 
   Py_RETURN_TRUE;
 }
@@ -102,6 +174,46 @@ static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cpu_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cpu_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autocast_cache_persistent(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("persistent must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cache_persistent(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cache_persistent(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cache_persistent()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   at::autocast::clear_cache();
@@ -167,6 +279,10 @@ static PyMethodDef methods[] = { // NOLINT
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
   {"set_autocast_enabled", (PyCFunction)set_autocast_enabled, METH_O, nullptr},
   {"is_autocast_enabled", (PyCFunction)is_autocast_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cpu_enabled", (PyCFunction)set_autocast_cpu_enabled, METH_O, nullptr},
+  {"is_autocast_cpu_enabled", (PyCFunction)is_autocast_cpu_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cache_persistent", (PyCFunction)set_autocast_cache_persistent, METH_O, nullptr},
+  {"is_autocast_cache_persistent", (PyCFunction)is_autocast_cache_persistent, METH_NOARGS, nullptr},
   {"clear_autocast_cache", (PyCFunction)clear_autocast_cache, METH_NOARGS, nullptr},
   {"autocast_increment_nesting", (PyCFunction)autocast_increment_nesting, METH_NOARGS, nullptr},
   {"autocast_decrement_nesting", (PyCFunction)autocast_decrement_nesting, METH_NOARGS, nullptr},
@@ -7,7 +7,9 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <list>
 #include <mutex>
 #include <sstream>
@@ -142,6 +144,10 @@ static CUDAStubs* cuda_stubs = default_stubs_addr;
 //  - save profiling events into the profiling state
 //
 
+// Handles of the ranges open on this thread, innermost last, that the memory
+// events are attributed to
+thread_local std::vector<at::RecordFunctionHandle> memory_ranges;
+
 // Profiler state
 struct ProfilerThreadLocalState
     : public c10::MemoryReportingInfoBase {
@@ -223,6 +229,12 @@ struct ProfilerThreadLocalState
           at::RecordFunction::getDefaultNodeId());
       evt.setSequenceNr(sequence_nr);
       getEventList().record(std::move(evt));
+      if (config_.profile_memory) {
+        memory_ranges.push_back(handle);
+      }
+      if (config_.state == ProfilerState::CUPTI) {
+        cuda_stubs->pushCorrelationId(handle);
+      }
     }
   }
 
@@ -244,6 +256,18 @@ struct ProfilerThreadLocalState
           handle);
       evt.setNodeId(at::RecordFunction::getDefaultNodeId());
       getEventList(thread_id).record(std::move(evt));
+      if (config_.profile_memory) {
+        auto it = std::find(memory_ranges.rbegin(), memory_ranges.rend(), handle);
+        if (it != memory_ranges.rend()) {
+          memory_ranges.erase(std::next(it).base());
+        }
+      }
+      // CUPTI keeps a stack of correlation ids per thread, GPU work after an
+      // async pop stays attributed to the range until the thread ends it
+      if (config_.state == ProfilerState::CUPTI &&
+          thread_id == at::RecordFunction::currentThreadId()) {
+        cuda_stubs->popCorrelationId();
+      }
     }
   }
 
@@ -256,15 +280,17 @@ struct ProfilerThreadLocalState
   }
 
   void reportMemoryUsage(
-      void* /* unused */, int64_t alloc_size, c10::Device device) override {
+      void* ptr, int64_t alloc_size, c10::Device device) override {
     if (config_.profile_memory && config_.state != ProfilerState::Disabled) {
       uint64_t thread_id = at::RecordFunction::currentThreadId();
       Event evt(
           EventKind::MemoryAlloc,
           at::StringView(""),
           thread_id,
-          config_.state == ProfilerState::CUDA);
+          config_.state == ProfilerState::CUDA,
+          memory_ranges.empty() ? 0 : memory_ranges.back());
       evt.updateMemoryStats(alloc_size, device);
+      evt.setMemoryPtr(ptr);
       getEventList(thread_id).record(std::move(evt));
     }
   }
@@ -391,6 +417,10 @@ const int kCUDAWarmupStart = 5;
 // temp. workaround for dispatcher ::Profiler key
 thread_local std::vector<std::shared_ptr<at::RecordFunctionGuard>> g_;
 
+// Activities of the last CUPTI profiler run, see takeGPUActivities
+std::mutex gpu_activities_mutex;
+std::vector<GPUActivity> gpu_activities;
+
 } // namespace
 
 void registerCUDAMethods(CUDAStubs* stubs) {
@@ -442,10 +472,17 @@ bool profilerEnabled() {
 void enableProfiler(const ProfilerConfig& new_config) {
   TORCH_CHECK(new_config.state != ProfilerState::NVTX || cuda_stubs->enabled(),
     "Can't use NVTX profiler - PyTorch was compiled without CUDA");
+  TORCH_CHECK(new_config.state != ProfilerState::CUPTI || cuda_stubs->cuptiEnabled(),
+    "Can't use CUPTI profiler - PyTorch was compiled without CUPTI");
 
   auto state_ptr = getProfilerTLSState();
   TORCH_CHECK(!state_ptr, "Profiler is already enabled on this thread");
 
+  if (new_config.state == ProfilerState::CUPTI) {
+    cuda_stubs->startActivityTracing();
+  }
+
+  memory_ranges.clear();
   auto state = std::make_shared<ProfilerThreadLocalState>(new_config);
   c10::ThreadLocalDebugInfo::_push(c10::DebugInfoKind::PROFILER_STATE, state);
 
@@ -482,6 +519,12 @@ thread_event_lists disableProfiler() {
   g_.pop_back();
   at::removeCallback(state_ptr->callbackHandle());
 
+  if (state_ptr->config().state == ProfilerState::CUPTI) {
+    auto activities = cuda_stubs->stopActivityTracing();
+    std::lock_guard<std::mutex> guard(gpu_activities_mutex);
+    gpu_activities = std::move(activities);
+  }
+
   if (state_ptr->config().state == ProfilerState::NVTX) {
     return thread_event_lists();
   }
@@ -491,6 +534,15 @@ thread_event_lists disableProfiler() {
   return state_ptr->consolidate();
 }
 
+std::vector<GPUActivity> takeGPUActivities() {
+  std::lock_guard<std::mutex> guard(gpu_activities_mutex);
+  return std::move(gpu_activities);
+}
+
+bool cuptiAvailable() {
+  return cuda_stubs->cuptiEnabled();
+}
+
 void addEventList(std::vector<Event>&& profiledEvents) {
   auto state_ptr = getProfilerTLSState();
   TORCH_CHECK(state_ptr, "Profiler must be enabled.");
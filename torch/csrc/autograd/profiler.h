@@ -29,6 +29,19 @@ struct Node;
 
 namespace profiler {
 
+// A kernel, memcpy or memset that ran on a GPU, as reported by CUPTI
+struct TORCH_API GPUActivity {
+  std::string name;
+  int64_t device = -1;
+  int64_t stream = -1;
+  // In the time base of getTime()
+  int64_t start_ns = 0;
+  int64_t end_ns = 0;
+  // Handle of the innermost profiled RecordFunction range that launched it,
+  // 0 if none did
+  uint64_t correlation_id = 0;
+};
+
 struct TORCH_API CUDAStubs {
   virtual void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) {
     fail();
@@ -55,12 +68,33 @@ struct TORCH_API CUDAStubs {
   virtual void synchronize() {
     fail();
   }
+  // Whether PyTorch was built with CUPTI, see ProfilerState::CUPTI
+  virtual bool cuptiEnabled() {
+    return false;
+  }
+  virtual void startActivityTracing() {
+    failCUPTI();
+  }
+  virtual std::vector<GPUActivity> stopActivityTracing() {
+    failCUPTI();
+    return {};
+  }
+  // Tags the GPU work the calling thread launches until the matching pop
+  virtual void pushCorrelationId(uint64_t id) {
+    failCUPTI();
+  }
+  virtual void popCorrelationId() {
+    failCUPTI();
+  }
   virtual ~CUDAStubs();
 
 private:
   void fail() {
     AT_ERROR("CUDA used in profiler but not enabled.");
   }
+  void failCUPTI() {
+    AT_ERROR("CUPTI used in profiler but PyTorch was not built with it, set USE_CUPTI=1.");
+  }
 };
 
 TORCH_API void registerCUDAMethods(CUDAStubs* stubs);
@@ -93,6 +127,7 @@ enum class C10_API_ENUM ProfilerState {
     CPU, // CPU-only profiling
     CUDA, // CPU + CUDA events
     NVTX,  // only emit NVTX markers
+    CUPTI, // CPU-only events plus the GPU activity CUPTI records
 };
 
 struct TORCH_API ProfilerConfig {
@@ -246,10 +281,22 @@ struct TORCH_API Event final {
     return cuda_memory_usage_;
   }
 
+  // For memory events, the handle of the innermost range open on the thread
+  // that allocated or freed, 0 if none was
   at::RecordFunctionHandle handle() const {
     return handle_;
   }
 
+  // Address of the memory a MemoryAlloc event allocated or freed, not
+  // serialized for remote events
+  uint64_t memory_ptr() const {
+    return memory_ptr_;
+  }
+
+  void setMemoryPtr(const void* ptr) {
+    memory_ptr_ = reinterpret_cast<uintptr_t>(ptr);
+  }
+
   // Node ID corresponding to this event.
   int node_id( ) const {
     return node_id_;
@@ -290,6 +337,7 @@ struct TORCH_API Event final {
   std::vector<std::vector<int64_t>> shapes_;
   int64_t cpu_memory_usage_ = 0;
   int64_t cuda_memory_usage_ = 0;
+  uint64_t memory_ptr_ = 0;
   int device_ = -1;
   CUDAEventStub cuda_event = nullptr;
   int node_id_ = 0;
@@ -342,6 +390,11 @@ using thread_event_lists = std::vector<std::vector<Event>>;
 // across thread boundary (e.g. at::launch tasks)
 TORCH_API void enableProfiler(const ProfilerConfig&);
 TORCH_API thread_event_lists disableProfiler();
+// Returns the GPU activity recorded by the last profiler run with
+// ProfilerState::CUPTI that was disabled, once
+TORCH_API std::vector<GPUActivity> takeGPUActivities();
+// Whether ProfilerState::CUPTI can be used
+TORCH_API bool cuptiAvailable();
 // adds profiledEvents to the current thread local recorded events. Each event
 // will be marked with node ID given by fromNodeId.
 TORCH_API void addEventList(std::vector<Event>&& profiledEvents);
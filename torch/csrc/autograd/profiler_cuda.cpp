@@ -1,6 +1,9 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <nvToolsExt.h>
+#ifdef USE_CUPTI
+#include <torch/csrc/autograd/profiler_cupti.h>
+#endif
 
 #include <sstream>
 
@@ -73,6 +76,27 @@ struct CUDAMethods : public CUDAStubs {
   bool enabled() override {
     return true;
   }
+#ifdef USE_CUPTI
+  bool cuptiEnabled() override {
+    return true;
+  }
+  void startActivityTracing() override {
+    cupti::startTracing();
+  }
+  std::vector<GPUActivity> stopActivityTracing() override {
+    // CUPTI only hands out the records of finished work
+    onEachDevice([](int /*device*/) {
+      TORCH_CUDA_CHECK(cudaDeviceSynchronize());
+    });
+    return cupti::stopTracing();
+  }
+  void pushCorrelationId(uint64_t id) override {
+    cupti::pushCorrelationId(id);
+  }
+  void popCorrelationId() override {
+    cupti::popCorrelationId();
+  }
+#endif
 
 };
 
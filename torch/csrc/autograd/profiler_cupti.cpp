@@ -0,0 +1,203 @@
+#include <torch/csrc/autograd/profiler_cupti.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/Type.h>
+#include <cupti.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+namespace torch { namespace autograd { namespace profiler { namespace cupti {
+
+namespace {
+
+#define TORCH_CUPTI_CHECK(call)                                      \
+  do {                                                               \
+    CUptiResult status = (call);                                     \
+    if (status != CUPTI_SUCCESS) {                                   \
+      const char* msg = nullptr;                                     \
+      cuptiGetResultString(status, &msg);                            \
+      TORCH_CHECK(false, #call, " failed: ", msg ? msg : "unknown"); \
+    }                                                                \
+  } while (0)
+
+constexpr size_t kBufferSize = 8 * 1024 * 1024;
+constexpr size_t kBufferAlignment = 8;
+
+const CUpti_ActivityKind kActivityKinds[] = {
+    CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION,
+    CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL,
+    CUPTI_ACTIVITY_KIND_MEMCPY,
+    CUPTI_ACTIVITY_KIND_MEMSET,
+};
+
+// GPUActivity with the CUPTI correlation id, which is only mapped to the
+// RecordFunction handle once all the records have been delivered
+struct Record {
+  GPUActivity activity;
+  uint32_t cupti_correlation_id;
+};
+
+// Filled from the CUPTI thread that delivers the buffers, and from
+// cuptiActivityFlushAll in stopTracing
+struct Session {
+  std::mutex mutex;
+  bool active = false;
+  // Added to CUPTI timestamps to get the time base of getTime()
+  int64_t time_offset = 0;
+  std::vector<Record> records;
+  std::unordered_map<uint32_t, uint64_t> external_ids;
+};
+
+Session& session() {
+  static Session session;
+  return session;
+}
+
+const char* memcpy_name(uint8_t kind) {
+  switch (kind) {
+    case CUPTI_ACTIVITY_MEMCPY_KIND_HTOD:
+      return "Memcpy HtoD";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_DTOH:
+      return "Memcpy DtoH";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_DTOD:
+      return "Memcpy DtoD";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_HTOH:
+      return "Memcpy HtoH";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_PTOP:
+      return "Memcpy PtoP";
+    default:
+      return "Memcpy";
+  }
+}
+
+template <typename T>
+void add_record(Session& s, const T* r, std::string name) {
+  Record record;
+  record.activity.name = std::move(name);
+  record.activity.device = r->deviceId;
+  record.activity.stream = r->streamId;
+  record.activity.start_ns = static_cast<int64_t>(r->start) + s.time_offset;
+  record.activity.end_ns = static_cast<int64_t>(r->end) + s.time_offset;
+  record.cupti_correlation_id = r->correlationId;
+  s.records.push_back(std::move(record));
+}
+
+void CUPTIAPI buffer_requested(uint8_t** buffer, size_t* size, size_t* max_num_records) {
+  *buffer = static_cast<uint8_t*>(aligned_alloc(kBufferAlignment, kBufferSize));
+  *size = *buffer ? kBufferSize : 0;
+  *max_num_records = 0;
+}
+
+// Runs on a CUPTI thread, must not throw
+void CUPTIAPI buffer_completed(
+    CUcontext /*ctx*/,
+    uint32_t /*stream_id*/,
+    uint8_t* buffer,
+    size_t /*size*/,
+    size_t valid_size) {
+  auto& s = session();
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    CUpti_Activity* record = nullptr;
+    while (s.active &&
+           cuptiActivityGetNextRecord(buffer, valid_size, &record) == CUPTI_SUCCESS) {
+      switch (record->kind) {
+        case CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL:
+        case CUPTI_ACTIVITY_KIND_KERNEL: {
+          auto kernel = reinterpret_cast<const CUpti_ActivityKernel4*>(record);
+          add_record(s, kernel, c10::demangle(kernel->name));
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMCPY: {
+          auto copy = reinterpret_cast<const CUpti_ActivityMemcpy*>(record);
+          add_record(s, copy, memcpy_name(copy->copyKind));
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMSET: {
+          auto set = reinterpret_cast<const CUpti_ActivityMemset*>(record);
+          add_record(s, set, "Memset");
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION: {
+          auto correlation =
+              reinterpret_cast<const CUpti_ActivityExternalCorrelation*>(record);
+          if (correlation->externalKind == CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0) {
+            s.external_ids[correlation->correlationId] = correlation->externalId;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+  free(buffer);
+}
+
+} // namespace
+
+void startTracing() {
+  auto& s = session();
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    TORCH_CHECK(!s.active, "Only one profiler can use CUPTI at a time");
+    uint64_t cupti_now = 0;
+    TORCH_CUPTI_CHECK(cuptiGetTimestamp(&cupti_now));
+    s.time_offset = getTime() - static_cast<int64_t>(cupti_now);
+    s.records.clear();
+    s.external_ids.clear();
+    s.active = true;
+  }
+  try {
+    TORCH_CUPTI_CHECK(cuptiActivityRegisterCallbacks(buffer_requested, buffer_completed));
+    for (auto kind : kActivityKinds) {
+      TORCH_CUPTI_CHECK(cuptiActivityEnable(kind));
+    }
+  } catch (...) {
+    for (auto kind : kActivityKinds) {
+      cuptiActivityDisable(kind);
+    }
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.active = false;
+    throw;
+  }
+}
+
+std::vector<GPUActivity> stopTracing() {
+  for (auto kind : kActivityKinds) {
+    TORCH_CUPTI_CHECK(cuptiActivityDisable(kind));
+  }
+  // Delivers the completed records through buffer_completed
+  TORCH_CUPTI_CHECK(cuptiActivityFlushAll(0));
+
+  auto& s = session();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  s.active = false;
+  std::vector<GPUActivity> activities;
+  activities.reserve(s.records.size());
+  for (auto& record : s.records) {
+    auto it = s.external_ids.find(record.cupti_correlation_id);
+    if (it != s.external_ids.end()) {
+      record.activity.correlation_id = it->second;
+    }
+    activities.push_back(std::move(record.activity));
+  }
+  s.records.clear();
+  s.external_ids.clear();
+  return activities;
+}
+
+void pushCorrelationId(uint64_t id) {
+  TORCH_CUPTI_CHECK(cuptiActivityPushExternalCorrelationId(
+      CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, id));
+}
+
+void popCorrelationId() {
+  uint64_t id = 0;
+  TORCH_CUPTI_CHECK(cuptiActivityPopExternalCorrelationId(
+      CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, &id));
+}
+
+}}}} // namespace torch::autograd::profiler::cupti
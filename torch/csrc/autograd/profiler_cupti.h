@@ -0,0 +1,27 @@
+#pragma once
+
+#include <torch/csrc/autograd/profiler.h>
+
+#include <cstdint>
+#include <vector>
+
+// GPU activity tracing for ProfilerState::CUPTI, only built with USE_CUPTI.
+// Kernels, memcpys and memsets are recorded by CUPTI, asynchronously, and
+// tagged with the handle of the RecordFunction range that launched them, so
+// that they do not need CUDA events nor synchronization around every op.
+
+namespace torch { namespace autograd { namespace profiler { namespace cupti {
+
+// Starts recording GPU activity, only one tracing session can be active
+void startTracing();
+
+// Stops recording and returns the activities of the session. The GPU work
+// launched during the session has to be finished.
+std::vector<GPUActivity> stopTracing();
+
+// GPU work launched by the calling thread between a push and the matching pop
+// gets id as correlation id, the innermost pushed id wins
+void pushCorrelationId(uint64_t id);
+void popCorrelationId();
+
+}}}} // namespace torch::autograd::profiler::cupti
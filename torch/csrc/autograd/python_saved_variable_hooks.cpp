@@ -0,0 +1,83 @@
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/object_ptr.h>
+
+#include <memory>
+
+namespace py = pybind11;
+
+namespace torch { namespace autograd {
+
+PySavedVariableHooks::PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook)
+  : pack_hook_(pack_hook), unpack_hook_(unpack_hook) {
+  // Only called by the factory below, which holds the GIL
+  Py_INCREF(pack_hook_);
+  Py_INCREF(unpack_hook_);
+}
+
+PySavedVariableHooks::~PySavedVariableHooks() {
+  // The graph, and with it the saved variables, can be freed by a thread
+  // without the GIL or after the interpreter is gone
+  if (Py_IsInitialized()) {
+    py::gil_scoped_acquire gil;
+    Py_DECREF(pack_hook_);
+    Py_DECREF(unpack_hook_);
+    Py_XDECREF(data_);
+  }
+}
+
+void PySavedVariableHooks::call_pack_hook(const at::Tensor& tensor) {
+  py::gil_scoped_acquire gil;
+  THPObjectPtr obj(THPVariable_Wrap(tensor));
+  if (!obj) {
+    throw python_error();
+  }
+  data_ = PyObject_CallFunctionObjArgs(pack_hook_, obj.get(), nullptr);
+  if (!data_) {
+    throw python_error();
+  }
+}
+
+at::Tensor PySavedVariableHooks::call_unpack_hook() {
+  py::gil_scoped_acquire gil;
+  THPObjectPtr res(PyObject_CallFunctionObjArgs(unpack_hook_, data_, nullptr));
+  if (!res) {
+    throw python_error();
+  }
+  if (!THPVariable_Check(res.get())) {
+    throw TypeError("Output of saved tensor unpack_hook expected to be a Tensor "
+        "but got result of type %s", Py_TYPE(res.get())->tp_name);
+  }
+  return ((THPVariable*)res.get())->cdata;
+}
+
+namespace {
+// Holds the hooks for the factory, which can be copied and destroyed without
+// the GIL
+struct PyHooksPair {
+  PyHooksPair(py::function pack_hook, py::function unpack_hook)
+    : pack_hook(pack_hook.release().ptr()),
+      unpack_hook(unpack_hook.release().ptr()) {}
+  ~PyHooksPair() {
+    if (Py_IsInitialized()) {
+      py::gil_scoped_acquire gil;
+      Py_DECREF(pack_hook);
+      Py_DECREF(unpack_hook);
+    }
+  }
+  PyObject* pack_hook;
+  PyObject* unpack_hook;
+};
+} // namespace
+
+void push_py_saved_variable_hooks(py::function pack_hook, py::function unpack_hook) {
+  auto pair = std::make_shared<PyHooksPair>(std::move(pack_hook), std::move(unpack_hook));
+  push_saved_variable_hooks([pair]() -> std::unique_ptr<SavedVariableHooks> {
+    py::gil_scoped_acquire gil;
+    return std::make_unique<PySavedVariableHooks>(pair->pack_hook, pair->unpack_hook);
+  });
+}
+
+}}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/python_headers.h>
+
+namespace torch { namespace autograd {
+
+// Saved variable hooks calling a pair of Python functions: pack_hook gets
+// the saved tensor and returns any object, which unpack_hook gets back and
+// turns into a tensor again.
+struct PySavedVariableHooks : public SavedVariableHooks {
+  PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook);
+  ~PySavedVariableHooks() override;
+  void call_pack_hook(const at::Tensor& tensor) override;
+  at::Tensor call_unpack_hook() override;
+
+private:
+  PyObject* pack_hook_;
+  PyObject* unpack_hook_;
+  PyObject* data_ = nullptr;
+};
+
+// Makes the variables saved on the calling thread use a pair of Python
+// hooks, until the matching pop_saved_variable_hooks
+void push_py_saved_variable_hooks(
+    pybind11::function pack_hook,
+    pybind11::function unpack_hook);
+
+}}
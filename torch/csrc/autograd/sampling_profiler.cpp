@@ -0,0 +1,246 @@
+#include <torch/csrc/autograd/sampling_profiler.h>
+
+#include <torch/csrc/autograd/profiler.h>
+
+#include <ATen/record_function.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+using StatsKey = std::pair<std::string, std::string>;
+
+struct StatsKeyHash {
+  size_t operator()(const StatsKey& key) const {
+    const size_t h = std::hash<std::string>()(key.first);
+    return h ^ (std::hash<std::string>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+  }
+};
+
+using StatsTable = std::unordered_map<StatsKey, OpLatencyStats, StatsKeyHash>;
+
+// Only the owning thread adds samples, flushes take the table away from it,
+// so the mutex is almost never contended
+struct ThreadStats {
+  std::mutex mutex;
+  StatsTable table;
+};
+
+std::mutex registry_mutex;
+std::vector<std::shared_ptr<ThreadStats>> registry;
+
+ThreadStats& local_stats() {
+  thread_local std::shared_ptr<ThreadStats> stats = []() {
+    auto stats = std::make_shared<ThreadStats>();
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(stats);
+    return stats;
+  }();
+  return *stats;
+}
+
+// Start times of the sampled RecordFunctions open on this thread, innermost
+// last. Ops ending on another thread than they started on are not timed.
+thread_local std::vector<std::pair<at::RecordFunctionHandle, int64_t>> open_ranges;
+
+struct SamplingProfilerState {
+  std::mutex mutex;
+  bool enabled = false;
+  at::CallbackHandle handle = 0;
+
+  std::thread flush_thread;
+  std::condition_variable flush_cv;
+  bool stop_flushing = false;
+};
+
+SamplingProfilerState& state() {
+  static SamplingProfilerState state;
+  return state;
+}
+
+// Read by the callbacks, only changed while no ops run
+bool record_shapes = false;
+
+std::string input_shapes(const at::RecordFunction& fn) {
+  std::ostringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < fn.inputs().size(); i++) {
+    if (i > 0) {
+      ss << ", ";
+    }
+    const auto& input = fn.inputs()[i];
+    if (input.isTensor() && input.toTensor().defined()) {
+      ss << input.toTensor().sizes();
+    } else {
+      ss << "[]";
+    }
+  }
+  ss << "]";
+  return ss.str();
+}
+
+size_t latency_bucket(int64_t ns) {
+  size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < kSamplingProfilerBuckets) {
+    ns >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void on_start(const at::RecordFunction& fn) {
+  open_ranges.emplace_back(fn.handle(), getTime());
+}
+
+void on_end(const at::RecordFunction& fn) {
+  const int64_t end = getTime();
+  auto it = std::find_if(open_ranges.rbegin(), open_ranges.rend(),
+      [&](const std::pair<at::RecordFunctionHandle, int64_t>& range) {
+        return range.first == fn.handle();
+      });
+  if (it == open_ranges.rend()) {
+    return;
+  }
+  const int64_t ns = std::max<int64_t>(end - it->second, 0);
+  open_ranges.erase(std::next(it).base());
+
+  StatsKey key(fn.name().str(), record_shapes ? input_shapes(fn) : std::string());
+  auto& stats = local_stats();
+  std::lock_guard<std::mutex> lock(stats.mutex);
+  auto& entry = stats.table[std::move(key)];
+  if (entry.count == 0 || ns < entry.min_ns) {
+    entry.min_ns = ns;
+  }
+  entry.max_ns = std::max(entry.max_ns, ns);
+  entry.count++;
+  entry.total_ns += ns;
+  entry.buckets[latency_bucket(ns)]++;
+}
+
+void merge(OpLatencyStats& into, const OpLatencyStats& from) {
+  if (into.count == 0 || from.min_ns < into.min_ns) {
+    into.min_ns = from.min_ns;
+  }
+  into.max_ns = std::max(into.max_ns, from.max_ns);
+  into.count += from.count;
+  into.total_ns += from.total_ns;
+  for (size_t i = 0; i < kSamplingProfilerBuckets; i++) {
+    into.buckets[i] += from.buckets[i];
+  }
+}
+
+} // namespace
+
+void enableSamplingProfiler(SamplingProfilerConfig config) {
+  TORCH_CHECK(config.sampling_prob > 0.0 && config.sampling_prob <= 1.0,
+      "sampling probability should be in (0, 1], got ", config.sampling_prob);
+  TORCH_CHECK(config.flush_interval_ms >= 0,
+      "flush interval should be non-negative, got ", config.flush_interval_ms);
+  auto& s = state();
+  std::unique_lock<std::mutex> lock(s.mutex);
+  TORCH_CHECK(!s.enabled, "the sampling profiler is already enabled");
+  s.enabled = true;
+  record_shapes = config.record_shapes;
+  s.handle = at::addGlobalCallback(at::RecordFunctionCallback(on_start, on_end)
+      .needsInputs(config.record_shapes)
+      .needsIds(true)
+      .samplingProb(config.sampling_prob));
+
+  if (config.flush_interval_ms > 0 && config.flush_callback) {
+    s.stop_flushing = false;
+    s.flush_thread = std::thread([interval = config.flush_interval_ms,
+                                  callback = std::move(config.flush_callback)]() {
+      auto& s = state();
+      std::unique_lock<std::mutex> lock(s.mutex);
+      while (!s.flush_cv.wait_for(lock, std::chrono::milliseconds(interval),
+                                  [&s]() { return s.stop_flushing; })) {
+        lock.unlock();
+        callback(flushSamplingProfiler());
+        lock.lock();
+      }
+    });
+  }
+}
+
+void disableSamplingProfiler() {
+  auto& s = state();
+  std::unique_lock<std::mutex> lock(s.mutex);
+  if (!s.enabled) {
+    return;
+  }
+  at::removeCallback(s.handle);
+  s.enabled = false;
+  if (s.flush_thread.joinable()) {
+    s.stop_flushing = true;
+    s.flush_cv.notify_all();
+    auto flush_thread = std::move(s.flush_thread);
+    lock.unlock();
+    flush_thread.join();
+  }
+}
+
+bool samplingProfilerEnabled() {
+  auto& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  return s.enabled;
+}
+
+std::vector<OpLatencyStats> flushSamplingProfiler() {
+  std::vector<std::shared_ptr<ThreadStats>> threads;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    threads = registry;
+    // Forget the threads that exited, whose stats only registry and threads
+    // still refer to. They are flushed one last time below.
+    registry.erase(
+        std::remove_if(registry.begin(), registry.end(),
+            [](const std::shared_ptr<ThreadStats>& stats) {
+              return stats.use_count() == 2;
+            }),
+        registry.end());
+  }
+
+  StatsTable total;
+  for (const auto& thread : threads) {
+    StatsTable table;
+    {
+      std::lock_guard<std::mutex> lock(thread->mutex);
+      std::swap(table, thread->table);
+    }
+    for (auto& entry : table) {
+      auto it = total.find(entry.first);
+      if (it == total.end()) {
+        entry.second.name = entry.first.first;
+        entry.second.shapes = entry.first.second;
+        total.emplace(entry.first, std::move(entry.second));
+      } else {
+        merge(it->second, entry.second);
+      }
+    }
+  }
+
+  std::vector<OpLatencyStats> result;
+  result.reserve(total.size());
+  for (auto& entry : total) {
+    result.push_back(std::move(entry.second));
+  }
+  std::sort(result.begin(), result.end(),
+      [](const OpLatencyStats& a, const OpLatencyStats& b) {
+        return a.total_ns > b.total_ns;
+      });
+  return result;
+}
+
+} // namespace profiler
+}} // namespace torch::autograd
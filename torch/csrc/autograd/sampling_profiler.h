@@ -0,0 +1,62 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Profiler meant to stay enabled in production. Instead of recording every
+// event like enableProfiler, it times a sample of the ops run on any thread
+// through a global RecordFunction callback, and aggregates their latencies
+// per op name, and optionally per input shapes, in tables local to each
+// thread. flushSamplingProfiler sums the tables up and resets them.
+
+// The latency histograms have one bucket per power of two nanoseconds, the
+// last one also counts all slower samples
+constexpr size_t kSamplingProfilerBuckets = 32;
+
+struct TORCH_API OpLatencyStats {
+  std::string name;
+  // Input sizes like "[[2, 3], [], [3]]", empty unless record_shapes is set
+  std::string shapes;
+  int64_t count = 0;
+  int64_t total_ns = 0;
+  int64_t min_ns = 0;
+  int64_t max_ns = 0;
+  // buckets[0] counts the samples that took less than 2ns, buckets[i] those
+  // that took [2^i, 2^(i+1)) ns
+  std::array<int64_t, kSamplingProfilerBuckets> buckets{};
+};
+
+struct TORCH_API SamplingProfilerConfig {
+  // Probability that an op is timed
+  double sampling_prob = 0.001;
+  bool record_shapes = false;
+  // If both are set, a background thread calls flush_callback with the
+  // result of flushSamplingProfiler every flush_interval_ms
+  int64_t flush_interval_ms = 0;
+  std::function<void(std::vector<OpLatencyStats>)> flush_callback;
+};
+
+// Starts sampling. Like other global RecordFunction callbacks, the sampling
+// profiler has to be enabled and disabled while no ops run, e.g. when the
+// process starts and exits.
+TORCH_API void enableSamplingProfiler(SamplingProfilerConfig config);
+
+// Stops sampling and the background flushes, the stats collected since the
+// last flush stay available to flushSamplingProfiler
+TORCH_API void disableSamplingProfiler();
+
+TORCH_API bool samplingProfilerEnabled();
+
+// Returns the stats of all threads collected since the last flush, and
+// starts over
+TORCH_API std::vector<OpLatencyStats> flushSamplingProfiler();
+
+} // namespace profiler
+}} // namespace torch::autograd
@@ -11,9 +11,47 @@
 #include <list>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 namespace torch { namespace autograd {
 
+namespace {
+thread_local std::vector<SavedVariableHooksFactory> saved_variable_hooks;
+thread_local bool in_pack_hook = false;
+
+struct PackHookGuard {
+  PackHookGuard() {
+    in_pack_hook = true;
+  }
+  ~PackHookGuard() {
+    in_pack_hook = false;
+  }
+};
+
+std::unique_ptr<SavedVariableHooks> pack_with_default_hooks(const at::Tensor& data) {
+  if (saved_variable_hooks.empty() || in_pack_hook) {
+    return nullptr;
+  }
+  // Tensors the hooks save themselves are stored as usual
+  PackHookGuard guard;
+  auto hooks = saved_variable_hooks.back()();
+  if (hooks) {
+    hooks->call_pack_hook(data);
+  }
+  return hooks;
+}
+} // namespace
+
+void push_saved_variable_hooks(SavedVariableHooksFactory factory) {
+  TORCH_CHECK(factory, "saved variable hooks factory must not be empty");
+  saved_variable_hooks.push_back(std::move(factory));
+}
+
+void pop_saved_variable_hooks() {
+  TORCH_CHECK(!saved_variable_hooks.empty(), "no saved variable hooks to pop");
+  saved_variable_hooks.pop_back();
+}
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -33,6 +71,10 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     }
     version_counter_ = impl::version_counter(variable);
     saved_version_ = version_counter_.current_version();
+    hooks_ = pack_with_default_hooks(data_);
+    if (hooks_) {
+      data_.reset();
+    }
   }
 }
 
@@ -40,7 +82,7 @@ SavedVariable::SavedVariable(const c10::optional<Variable>& variable, bool is_ou
   : SavedVariable(variable.has_value() ? *variable : Variable(), is_output, is_inplace_view) {}
 
 Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
-  if (!data_.defined()) {
+  if (!data_.defined() && !hooks_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -60,8 +102,10 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation";
+    if (data_.defined()) {
+      message << ": [" << data_.toString() << " " << data_.sizes() << "]";
+    }
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -81,14 +125,16 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
     throw std::runtime_error(message.str());
   }
 
+  at::Tensor data = hooks_ ? hooks_->call_unpack_hook() : data_;
+
   // NB: saved views are unpacked as normal Variables (not views) even though
   // they still share the same storage. This works only because we never call
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
@@ -5,6 +5,7 @@
 #include <ATen/ATen.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 namespace torch { namespace autograd {
@@ -14,6 +15,26 @@ struct Node;
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
+/// Takes over storing the data of a `SavedVariable`, for example to move it
+/// off the device during forward and bring it back for backward.
+/// `call_pack_hook` is called once when the variable is saved,
+/// `call_unpack_hook` every time it is unpacked.
+struct TORCH_API SavedVariableHooks {
+  virtual void call_pack_hook(const at::Tensor& tensor) = 0;
+  virtual at::Tensor call_unpack_hook() = 0;
+  virtual ~SavedVariableHooks() = default;
+};
+
+/// Creates the hooks of a newly saved variable, or returns nullptr to store
+/// its data as usual.
+using SavedVariableHooksFactory =
+    std::function<std::unique_ptr<SavedVariableHooks>()>;
+
+/// Variables saved on the calling thread use the factory pushed last, until
+/// it is popped. Variables saved while a pack hook runs are stored as usual.
+TORCH_API void push_saved_variable_hooks(SavedVariableHooksFactory factory);
+TORCH_API void pop_saved_variable_hooks();
+
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
 class TORCH_API SavedVariable {
@@ -30,7 +51,8 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
   void reset_data() {
-    return data_.reset();
+    hooks_.reset();
+    data_.reset();
   }
 
   void reset_grad_function() {
@@ -39,6 +61,9 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // Set when default hooks were in place while saving, they then hold the
+  // data instead of data_.
+  std::unique_ptr<SavedVariableHooks> hooks_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
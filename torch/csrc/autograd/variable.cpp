@@ -242,6 +242,32 @@ namespace impl {
     materialize_autograd_meta(self)->name_ = name;
   }
 
+  void set_grad_buffer(const Variable& self, Variable buffer) {
+    TORCH_CHECK(self.is_leaf(), "a grad buffer can only be set on a leaf tensor");
+    if (buffer.defined()) {
+      TORCH_CHECK(!buffer.requires_grad(), "a grad buffer must not require grad");
+      TORCH_CHECK(!buffer.is_sparse() && !self.is_sparse(),
+          "grad buffers do not support sparse tensors");
+      TORCH_CHECK(buffer.sizes() == self.sizes(),
+          "grad buffer has sizes ", buffer.sizes(), " but the tensor has sizes ", self.sizes());
+      TORCH_CHECK(buffer.options().type_equal(self.options()),
+          "grad buffer is ", buffer.toString(), " but the tensor is ", self.toString());
+      TORCH_CHECK(buffer.device() == self.device(),
+          "grad buffer is on ", buffer.device(), " but the tensor is on ", self.device());
+    }
+    auto meta = materialize_autograd_meta(self);
+    std::lock_guard<std::mutex> lock(meta->mutex_);
+    meta->grad_buffer_ = std::move(buffer);
+  }
+
+  Variable grad_buffer(const Variable& self) {
+    if (auto meta = get_autograd_meta(self)) {
+      std::lock_guard<std::mutex> lock(meta->mutex_);
+      return meta->grad_buffer_;
+    }
+    return Variable();
+  }
+
   // Miscellaneous
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -175,6 +175,13 @@ namespace impl {
   TORCH_API void clear_hooks(const Variable&);
 
   TORCH_API void create_cpp_hook(const Variable&);
+
+  /// Sets the tensor AccumulateGrad copies the gradient of a leaf into when
+  /// its grad is undefined, instead of allocating a new grad. This is
+  /// typically a view into one flat buffer holding the gradients of many
+  /// parameters. Pass an undefined tensor to go back to allocating grads.
+  TORCH_API void set_grad_buffer(const Variable&, Variable buffer);
+  TORCH_API Variable grad_buffer(const Variable&);
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -192,6 +199,8 @@ struct TORCH_API AutogradMeta : public c10::AutogradMetaInterface {
   Variable grad_;
   std::shared_ptr<Node> grad_fn_;
   std::weak_ptr<Node> grad_accumulator_;
+  // See impl::set_grad_buffer, only meaningful on leaf variables
+  Variable grad_buffer_;
 
   std::vector<std::shared_ptr<FunctionPreHook>> hooks_;
   std::shared_ptr<hooks_list> cpp_hooks_list;
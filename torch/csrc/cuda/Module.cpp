@@ -6,6 +6,7 @@
 #include <TH/TH.h>
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGraph.h>
 #include <ATen/CUDAGeneratorImpl.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/cuda/CUDACachingAllocator.h>
@@ -189,6 +190,36 @@ PyObject * THCPModule_cudaCachingAllocator_raw_delete(PyObject *_unused, PyObjec
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_cudaCachingAllocator_set_allocator_settings(PyObject *_unused, PyObject *arg){
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkString(arg), "invalid argument to set_allocator_settings");
+  c10::cuda::CUDACachingAllocator::setAllocatorSettings(THPUtils_unpackString(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_cudaCachingAllocator_set_stream_pool(PyObject *_unused, PyObject *args){
+  HANDLE_TH_ERRORS
+  PyObject* device_o = nullptr;
+  PyObject* stream_o = nullptr;
+  PyObject* name_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OOO", &device_o, &stream_o, &name_o) ||
+      !THPUtils_checkLong(device_o) || !THPUtils_checkString(name_o)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "set_stream_pool",
+        1,
+        "(int device, intptr_t stream, str name);");
+    return nullptr;
+  }
+  const int device = (int) THPUtils_unpackLong(device_o);
+  cudaStream_t stream = static_cast<cudaStream_t>(PyLong_AsVoidPtr(stream_o));
+  c10::cuda::CUDACachingAllocator::setStreamPool(device, stream, THPUtils_unpackString(name_o));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_cudaSynchronize(PyObject *_unused, PyObject *noargs)
 {
   HANDLE_TH_ERRORS
@@ -316,6 +347,44 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
   result["reserved_bytes"] = statArrayToDict(stats.reserved_bytes);
   result["active_bytes"] = statArrayToDict(stats.active_bytes);
   result["inactive_split_bytes"] = statArrayToDict(stats.inactive_split_bytes);
+  result["oversize_allocations"] = statToDict(stats.oversize_allocations);
+  result["oversize_segments"] = statToDict(stats.oversize_segments);
+  result["max_split_size"] = stats.max_split_size;
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_emptyHostCache(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_emptyCache();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  using c10::cuda::CUDACachingAllocator::Stat;
+
+  const auto statToDict = [](const Stat& stat) {
+    py::dict dict;
+
+    dict["current"] = stat.current;
+    dict["peak"] = stat.peak;
+    dict["allocated"] = stat.allocated;
+    dict["freed"] = stat.freed;
+    return dict;
+  };
+
+  const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+
+  py::dict result;
+  result["allocation"] = statToDict(stats.allocation);
+  result["segment"] = statToDict(stats.segment);
+  result["allocated_bytes"] = statToDict(stats.allocated_bytes);
+  result["reserved_bytes"] = statToDict(stats.reserved_bytes);
 
   return result.release().ptr();
   END_HANDLE_TH_ERRORS
@@ -380,6 +449,86 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+// Formats the Python stack of the calling thread, innermost frame first.
+// Most ops release the GIL before they allocate, so it is taken back here.
+// The allocator calls this before taking its lock, so whoever holds the GIL
+// can still use the allocator meanwhile.
+static std::string gatherPythonContext() {
+  if (!Py_IsInitialized()) {
+    return std::string();
+  }
+  pybind11::gil_scoped_acquire gil;
+  std::ostringstream stack_trace;
+  for (PyFrameObject* frame = PyEval_GetFrame(); frame != nullptr; frame = frame->f_back) {
+    int line = PyCode_Addr2Line(frame->f_code, frame->f_lasti);
+    stack_trace << THPUtils_unpackString(frame->f_code->co_filename) << "(" << line << "): "
+                << THPUtils_unpackString(frame->f_code->co_name) << "\n";
+  }
+  return stack_trace.str();
+}
+
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* enabled_o = nullptr;
+  PyObject* record_stacks_o = nullptr;
+  PyObject* max_entries_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OOO", &enabled_o, &record_stacks_o, &max_entries_o) ||
+      !PyBool_Check(enabled_o) || !PyBool_Check(record_stacks_o) ||
+      !THPUtils_checkLong(max_entries_o)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "record_memory_history",
+        1,
+        "(bool enabled, bool record_stacks, int max_entries);");
+    return nullptr;
+  }
+  const int64_t max_entries = THPUtils_unpackLong(max_entries_o);
+  THPUtils_assert(max_entries > 0, "record_memory_history expects a positive max_entries");
+  c10::cuda::CUDACachingAllocator::recordHistory(
+      enabled_o == Py_True,
+      static_cast<size_t>(max_entries),
+      record_stacks_o == Py_True ? gatherPythonContext : nullptr);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_memoryHistory(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to memory_history");
+  const int device = (int) THPUtils_unpackLong(arg);
+
+  using c10::cuda::CUDACachingAllocator::TraceEntry;
+  const auto actionToStr = [](TraceEntry::Action action) {
+    switch (action) {
+      case TraceEntry::ALLOC: return "alloc";
+      case TraceEntry::FREE: return "free";
+      case TraceEntry::SEGMENT_ALLOC: return "segment_alloc";
+      case TraceEntry::SEGMENT_FREE: return "segment_free";
+    }
+    return "unknown";
+  };
+
+  py::list result;
+  for (const auto& entry : c10::cuda::CUDACachingAllocator::memoryHistory(device)) {
+    py::dict entryDict;
+    entryDict["action"] = actionToStr(entry.action);
+    entryDict["device"] = entry.device;
+    entryDict["address"] = entry.address;
+    entryDict["size"] = entry.size;
+    entryDict["stream"] = entry.stream;
+    entryDict["time_us"] = entry.time_us;
+    entryDict["allocated_bytes"] = entry.allocated_bytes;
+    entryDict["reserved_bytes"] = entry.reserved_bytes;
+    entryDict["stack"] = entry.context;
+    result.append(entryDict);
+  }
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -412,6 +561,22 @@ static void bindGetDeviceProperties(PyObject* module) {
   }, py::return_value_policy::reference);
 }
 
+static void registerCudaGraph(PyObject* module) {
+  // Add _CUDAGraph class to torch._C, wrapped by torch.cuda.CUDAGraph
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<at::cuda::CUDAGraph>(m, "_CUDAGraph")
+    .def(py::init<>())
+    .def("capture_begin", &at::cuda::CUDAGraph::capture_begin,
+         py::arg("pool") = 0, py::call_guard<py::gil_scoped_release>())
+    .def("capture_end", &at::cuda::CUDAGraph::capture_end,
+         py::call_guard<py::gil_scoped_release>())
+    .def("replay", &at::cuda::CUDAGraph::replay,
+         py::call_guard<py::gil_scoped_release>())
+    .def("reset", &at::cuda::CUDAGraph::reset,
+         py::call_guard<py::gil_scoped_release>())
+    .def("pool", &at::cuda::CUDAGraph::pool);
+}
+
 // Callback for python part. Used for additional initialization of python classes
 static PyObject * THCPModule_initExtension(PyObject *self, PyObject *noargs)
 {
@@ -500,12 +665,18 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_hasPrimaryContext", (PyCFunction) THCPModule_hasPrimaryContext,  METH_O,  nullptr},
   {"_cuda_emptyCache", (PyCFunction) THCPModule_emptyCache, METH_NOARGS, nullptr},
   {"_cuda_memoryStats", (PyCFunction) THCPModule_memoryStats, METH_O, nullptr},
+  {"_cuda_emptyHostCache", (PyCFunction) THCPModule_emptyHostCache, METH_NOARGS, nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction) THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_VARARGS, nullptr},
+  {"_cuda_memoryHistory", (PyCFunction) THCPModule_memoryHistory, METH_O, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", (PyCFunction)THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", (PyCFunction)THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
+  {"_cuda_cudaCachingAllocator_set_stream_pool", (PyCFunction)THCPModule_cudaCachingAllocator_set_stream_pool, METH_VARARGS, nullptr},
+  {"_cuda_cudaCachingAllocator_set_allocator_settings", (PyCFunction)THCPModule_cudaCachingAllocator_set_allocator_settings, METH_O, nullptr},
   {"_cuda_synchronize", (PyCFunction)THCPModule_cudaSynchronize, METH_NOARGS, nullptr},
   {"_cuda_ipc_collect", (PyCFunction)THCPModule_cudaIPCCollect, METH_NOARGS, nullptr},
   {"_cuda_sleep", (PyCFunction)THCPModule_cudaSleep, METH_O, nullptr},
@@ -550,6 +721,7 @@ void initModule(PyObject *module) {
   shared::initCudnnBindings(module);
 #endif
   registerCudaDeviceProperties(module);
+  registerCudaGraph(module);
 }
 
 }}
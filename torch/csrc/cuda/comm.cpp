@@ -10,11 +10,13 @@
 #include <ATen/ATen.h>
 #include <ATen/WrapDimUtils.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/util/Optional.h>
 #include <torch/csrc/autograd/variable.h>
 
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace torch {
@@ -150,10 +152,26 @@ std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
 //
 // Similarly for reduce_add_coalesced, when the output are newly created
 // Variables.
-tensor_list2d broadcast_coalesced(
+//
+// NOTE [ Streams in broadcast_coalesced ]
+//
+// The buckets are flattened on the current stream of devices[0], but broadcast
+// on a communication stream per device, so that the flattening of a bucket
+// overlaps with the broadcast of the previous ones. The communication streams
+// first wait for the current streams, since the outputs are allocated on them,
+// and every bucket waits for its flattening. The buffers are recorded on the
+// communication streams, so that they are not reused before the broadcasts
+// completed even if they are freed before. broadcast_coalesced_async returns an
+// event per device, recorded at the end of its communication stream, after
+// which the outputs on that device can be used; broadcast_coalesced makes the
+// current streams wait for them.
+std::pair<tensor_list2d, std::vector<at::cuda::CUDAEvent>>
+broadcast_coalesced_async(
     TensorList tensors,
     IntArrayRef devices,
-    size_t buffer_size) {
+    size_t buffer_size,
+    const c10::optional<std::vector<c10::optional<at::cuda::CUDAStream>>>&
+        streams) {
   TORCH_CHECK(
       std::all_of(
           tensors.begin(),
@@ -161,10 +179,46 @@ tensor_list2d broadcast_coalesced(
           [&](const at::Tensor& t) { return t.get_device() == devices[0]; }),
       "All tensors must be on devices[0]: ",
       devices[0]);
+  TORCH_CHECK(
+      !streams || streams->size() == devices.size(),
+      "Expected devices and streams to be of same length, but got "
+      "len(devices) = ",
+      devices.size(),
+      " and len(streams) = ",
+      streams ? streams->size() : 0);
 #ifdef USE_NCCL
   buffer_size = std::min(torch::cuda::nccl::get_max_count(), buffer_size);
 #endif
 
+  std::vector<at::cuda::CUDAStream> comm_streams;
+  comm_streams.reserve(devices.size());
+  for (size_t i = 0, num_devices = devices.size(); i < num_devices; ++i) {
+    const auto device_index = static_cast<c10::DeviceIndex>(devices[i]);
+    if (streams && (*streams)[i]) {
+      TORCH_CHECK(
+          (*streams)[i]->device_index() == device_index,
+          "Expected the device associated with the stream at index ",
+          i,
+          " (was ",
+          (*streams)[i]->device_index(),
+          ") ",
+          "to match the device supplied at that index ",
+          "(expected ",
+          device_index,
+          ")");
+      comm_streams.push_back(*(*streams)[i]);
+    } else {
+      comm_streams.push_back(
+          at::cuda::getStreamFromPool(/*isHighPriority=*/false, device_index));
+    }
+    at::cuda::CUDAEvent ready;
+    ready.record(at::cuda::getCurrentCUDAStream(device_index));
+    ready.block(comm_streams.back());
+  }
+#ifdef USE_NCCL
+  nccl::stream_list nccl_streams(comm_streams.begin(), comm_streams.end());
+#endif
+
   tensor_list2d outputs(devices.size());
   outputs[0] = tensors.vec();
   for (auto& o : outputs)
@@ -194,13 +248,40 @@ tensor_list2d broadcast_coalesced(
         }
       }
     } else {
-      auto results =
-          broadcast(utils::flatten_dense_tensors(chunk.tensors), devices);
+      device_guard.set_index(devices[0]);
+      auto flat = utils::flatten_dense_tensors(chunk.tensors);
+      std::vector<Tensor> buffers;
+      buffers.reserve(devices.size());
+      buffers.push_back(flat);
+      for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
+        buffers.push_back(at::empty(
+            flat.sizes(),
+            flat.options().device(at::Device(DeviceType::CUDA, devices[i]))));
+      }
+#ifdef USE_NCCL
+      if (nccl::is_available(buffers)) {
+        // See NOTE [ Streams in broadcast_coalesced ]
+        at::cuda::CUDAEvent flattened;
+        flattened.record(at::cuda::getCurrentCUDAStream(devices[0]));
+        flattened.block(comm_streams[0]);
+        for (size_t i = 0, num_devices = devices.size(); i < num_devices; ++i) {
+          c10::cuda::CUDACachingAllocator::recordStream(
+              buffers[i].storage().data_ptr(), comm_streams[i]);
+        }
+        nccl::broadcast(buffers, nccl_streams);
+      } else {
+#else
+      {
+#endif
+        for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
+          buffers[i].copy_(flat, /*non_blocking=*/true);
+        }
+      }
       for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
         device_guard.set_index(devices[i]);
         auto& device_outputs = outputs[i];
         for (auto& t :
-             utils::unflatten_dense_tensors(results[i], chunk.tensors)) {
+             utils::unflatten_dense_tensors(buffers[i], chunk.tensors)) {
           // See NOTE [ Version Counter in comm.*_coalesced ]
           Variable var = t;
           device_outputs.push_back(make_variable(var.tensor_data(), false));
@@ -214,7 +295,28 @@ tensor_list2d broadcast_coalesced(
     for (auto& o : outputs)
       utils::reorder_tensors_like(o, tensors);
   }
-  return outputs;
+
+  // The copies of the sparse buckets, and of the dense ones NCCL can't
+  // broadcast, are on the current streams.
+  std::vector<at::cuda::CUDAEvent> events(devices.size());
+  for (size_t i = 0, num_devices = devices.size(); i < num_devices; ++i) {
+    at::cuda::CUDAEvent copied;
+    copied.record(at::cuda::getCurrentCUDAStream(devices[i]));
+    copied.block(comm_streams[i]);
+    events[i].record(comm_streams[i]);
+  }
+  return std::make_pair(std::move(outputs), std::move(events));
+}
+
+tensor_list2d broadcast_coalesced(
+    TensorList tensors,
+    IntArrayRef devices,
+    size_t buffer_size) {
+  auto result = broadcast_coalesced_async(tensors, devices, buffer_size);
+  for (size_t i = 0, num_devices = devices.size(); i < num_devices; ++i) {
+    result.second[i].block(at::cuda::getCurrentCUDAStream(devices[i]));
+  }
+  return std::move(result.first);
 }
 
 // ***************** Scatter *******************
@@ -4,9 +4,11 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <ATen/cuda/ATenCUDAGeneral.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
 #include <c10/util/Optional.h>
 
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace torch { namespace cuda {
@@ -18,6 +20,18 @@ TORCH_CUDA_API std::vector<at::Tensor> broadcast(const at::Tensor& tensor, at::I
 TORCH_CUDA_API tensor_list2d broadcast_coalesced(at::TensorList tensors, at::IntArrayRef devices,
                                   size_t buffer_size);
 
+// Like broadcast_coalesced, but the outputs on devices[i] may only be used
+// after the i-th event, instead of being ready on the current streams. The
+// broadcasts are issued on the given streams, or on streams from the pool when
+// a stream is not given.
+TORCH_CUDA_API std::pair<tensor_list2d, std::vector<at::cuda::CUDAEvent>>
+broadcast_coalesced_async(
+    at::TensorList tensors,
+    at::IntArrayRef devices,
+    size_t buffer_size,
+    const c10::optional<std::vector<c10::optional<at::cuda::CUDAStream>>>& streams =
+        c10::nullopt);
+
 TORCH_CUDA_API std::vector<at::Tensor>& scatter_out(
     const at::Tensor& tensor,
     std::vector<at::Tensor>& out_tensors,
@@ -1,5 +1,6 @@
 #include <torch/csrc/utils/pybind.h>
 #include <torch/csrc/cuda/comm.h>
+#include <torch/csrc/cuda/Event.h>
 #include <torch/csrc/cuda/Stream.h>
 #include <torch/csrc/cuda/THCP.h>
 #include <pybind11/pybind11.h>
@@ -26,6 +27,38 @@ void initCommMethods(PyObject *module) {
        py::arg("devices"),
        py::arg("buffer_size"),
        py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_broadcast_coalesced_async",
+          [](std::vector<at::Tensor>& tensors,
+             std::vector<int64_t> devices,
+             size_t buffer_size,
+             c10::optional<py::object> py_streams) {
+            c10::optional<std::vector<c10::optional<at::cuda::CUDAStream>>> streams;
+            if (py_streams) {
+              py::handle handle = *py_streams;
+              streams = THPUtils_PySequence_to_CUDAStreamList(handle.ptr());
+            }
+            std::pair<tensor_list2d, std::vector<at::cuda::CUDAEvent>> result;
+            {
+              // Note: We're holding the GIL outside of this block.
+              pybind11::gil_scoped_release no_gil;
+              result =
+                  broadcast_coalesced_async(tensors, devices, buffer_size, streams);
+            }
+            // torch.cuda.Event derives from THCPEventClass
+            auto event_class = py::module::import("torch.cuda").attr("Event");
+            py::list events;
+            for (auto& event : result.second) {
+              py::object py_event = event_class();
+              ((THCPEvent*)py_event.ptr())->cuda_event = std::move(event);
+              events.append(py_event);
+            }
+            return py::make_tuple(result.first, events);
+          },
+          py::arg("tensors"),
+          py::arg("devices"),
+          py::arg("buffer_size"),
+          py::arg("streams"))
       .def(
           "_broadcast",
           [](at::Tensor& tensor, std::vector<int64_t> devices) {
@@ -122,6 +122,17 @@ void DistAutogradContext::resetGraphTask() {
   graphTask_ = nullptr;
 }
 
+void DistAutogradContext::releaseAutogradFunctions() {
+  std::unordered_map<int64_t, std::shared_ptr<SendRpcBackward>> sendFunctions;
+  std::unordered_map<int64_t, std::shared_ptr<RecvRpcBackward>> recvFunctions;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    sendFunctions.swap(sendAutogradFunctions_);
+    recvFunctions.swap(recvAutogradFunctions_);
+  }
+  // The graph is destroyed here, outside of the lock.
+}
+
 void DistAutogradContext::addOutstandingRpc(
     const std::shared_ptr<rpc::FutureMessage>& futureMessage) {
   futureMessage->addCallback([this](const rpc::FutureMessage& futureMessage) {
@@ -202,7 +213,9 @@ std::shared_ptr<SendRpcBackward> DistAutogradContext::retrieveSendFunction(
   TORCH_CHECK(
       it != sendAutogradFunctions_.end(),
       "Could not find send function for autograd message id: ",
-      autograd_message_id);
+      autograd_message_id,
+      ". Note that the send functions are released after a backward pass ",
+      "which doesn't retain the graph.");
   return it->second;
 }
 
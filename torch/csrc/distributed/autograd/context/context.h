@@ -102,6 +102,11 @@ class TORCH_API DistAutogradContext {
   // pass for the same autograd context.
   void resetGraphTask();
 
+  // Drops the 'send' and 'recv' functions, which keep the autograd graph of
+  // this context alive, once a backward pass which doesn't retain the graph
+  // ran all of them, rather than when the context is released.
+  void releaseAutogradFunctions();
+
   // Waits for all outstanding RPCs for this context to finish and clears all
   // outstanding rpcs held in this context. This should be called only once.
   std::shared_ptr<rpc::FutureMessage> clearAndWaitForOutstandingRpcsAsync();
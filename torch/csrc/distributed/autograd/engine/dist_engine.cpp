@@ -26,6 +26,9 @@ using torch::autograd::variable_list;
 
 static constexpr char* kNumBackwardPasses = "num_current_backward_passes";
 static constexpr char* kNumAutogradContexts = "num_autograd_contexts";
+static constexpr char* kNumRemoteGradientWaits = "num_remote_gradient_waits";
+static constexpr char* kAverageRemoteGradientWaitTime =
+    "average_remote_gradient_wait_time_us";
 
 // This hook does 3 things:
 //   1. Call pre hooks of the original AccumulateGrad to modify the input grad.
@@ -462,10 +465,14 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
             }
 
             // Wait for all RPCs after the autograd engine is done.
+            auto waitStart = std::chrono::steady_clock::now();
             auto rpcFuture =
                 autogradContext->clearAndWaitForOutstandingRpcsAsync();
-            rpcFuture->addCallback([callbackFuture, autogradContext](
+            rpcFuture->addCallback([callbackFuture, autogradContext, waitStart](
                                        const rpc::FutureMessage& rpcFuture) {
+              DistEngine::getInstance().recordRemoteGradientWait(
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - waitStart));
               try {
                 // Perform cleanup at the end of the backward pass (before
                 // we mark the future as completed).
@@ -542,7 +549,16 @@ void DistEngine::execute(
       ->wait();
 
   // Wait for all of the outstanding rpcs to complete.
+  auto waitStart = std::chrono::steady_clock::now();
   autogradContext->clearAndWaitForOutstandingRpcsAsync()->wait();
+  recordRemoteGradientWait(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - waitStart));
+}
+
+void DistEngine::recordRemoteGradientWait(std::chrono::microseconds waitTime) {
+  remoteGradientWaitTimeUs_ += waitTime.count();
+  ++numRemoteGradientWaits_;
 }
 
 void DistEngine::cleanupBackwardPass(const ContextPtr& autogradContext) {
@@ -554,13 +570,20 @@ void DistEngine::cleanupBackwardPass(const ContextPtr& autogradContext) {
   // This ensures our 'use_count' checks in
   // AccumulateGrad::accumulateGrad are correct and we're
   // not leaking any references to the gradients anywhere else.
-  const auto& futureGrads =
-      autogradContext->retrieveGraphTask()->future_result_;
-  TORCH_INTERNAL_ASSERT(futureGrads.use_count() == 1);
+  auto graphTask = autogradContext->retrieveGraphTask();
+  const bool keepGraph = graphTask->keep_graph_;
+  TORCH_INTERNAL_ASSERT(graphTask->future_result_.use_count() == 1);
+  graphTask.reset();
 
   // Reset the graph task once we're done with all processing.
   autogradContext->resetGraphTask();
 
+  // All the send and recv functions of this context ran in the backward pass,
+  // so that, unless the graph is retained, nothing needs them anymore.
+  if (!keepGraph) {
+    autogradContext->releaseAutogradFunctions();
+  }
+
   // Clear any outstanding rpcs.
   autogradContext->clearOutstandingRpcs();
 
@@ -581,6 +604,10 @@ std::unordered_map<std::string, int> DistEngine::getDebugInfo() const {
   debugInfo[kNumBackwardPasses] = numBackwardPasses();
   debugInfo[kNumAutogradContexts] =
       DistAutogradContainer::getInstance().numAutogradContexts();
+  const uint64_t numWaits = numRemoteGradientWaits_.load();
+  debugInfo[kNumRemoteGradientWaits] = numWaits;
+  debugInfo[kAverageRemoteGradientWaitTime] =
+      numWaits == 0 ? 0 : remoteGradientWaitTimeUs_.load() / numWaits;
   return debugInfo;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <unordered_set>
 
@@ -134,6 +136,12 @@ class TORCH_API DistEngine {
   // Run after the backward pass is done to appropriately cleanup structures.
   void cleanupBackwardPass(const ContextPtr& autogradContext);
 
+  // Records how long a backward pass waited for the gradients it sent to
+  // other nodes once the local backward pass was done. Gradient RPCs are sent
+  // as soon as the corresponding 'recv' function runs, so this is the time
+  // that was not overlapped with local computation.
+  void recordRemoteGradientWait(std::chrono::microseconds waitTime);
+
   // Global thread to execute CPU continuations.
   void globalCpuThread(
       const std::shared_ptr<torch::autograd::ReadyQueue>& ready_queue);
@@ -144,6 +152,11 @@ class TORCH_API DistEngine {
 
   mutable std::mutex initializedContextIdsLock_;
 
+  // Number of backward passes that waited for outstanding gradient RPCs, and
+  // the total time they waited.
+  std::atomic<uint64_t> numRemoteGradientWaits_{0};
+  std::atomic<uint64_t> remoteGradientWaitTimeUs_{0};
+
   // Reference to local autograd engine.
   torch::autograd::Engine& engine_;
 
@@ -0,0 +1,114 @@
+#include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_tracing_req.h>
+#include <torch/csrc/distributed/rpc/utils.h>
+#include <torch/csrc/jit/serialization/pickle.h>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace autograd {
+
+constexpr auto kTracingElementExpectedSize = 3;
+
+using rpc::RpcCommandBase;
+
+// This constructor is called when creating the RpcWithTracingReq on the
+// client.
+RpcWithTracingReq::RpcWithTracingReq(
+    rpc::Message&& wrappedMessage,
+    rpc::RpcTraceContext traceContext)
+    : wrappedMessage_(std::move(wrappedMessage)),
+      traceContext_(traceContext) {
+  tensors_ = wrappedMessage_.tensors();
+  wrappedMessageType_ = wrappedMessage_.type();
+}
+
+// this constructor is only called in fromMessage() which is called in
+// deserializeRequest(). It is called when reconstructing the
+// RpcWithTracingReq on the remote end.
+RpcWithTracingReq::RpcWithTracingReq(
+    std::unique_ptr<rpc::RpcCommandBase> wrappedRpc,
+    rpc::MessageType wrappedMessageType,
+    std::vector<torch::Tensor> tensors,
+    rpc::RpcTraceContext traceContext)
+    : wrappedRpc_(std::move(wrappedRpc)),
+      wrappedMessageType_(wrappedMessageType),
+      tensors_(std::move(tensors)),
+      traceContext_(traceContext) {
+  TORCH_INTERNAL_ASSERT(wrappedRpc_ != nullptr, "wrappedRpc cant be null");
+}
+
+rpc::MessageType RpcWithTracingReq::wrappedMessageType() const {
+  return wrappedMessageType_;
+}
+
+void RpcWithTracingReq::setWrappedRpc(
+    std::unique_ptr<RpcCommandBase> wrappedRpc) {
+  wrappedRpc_ = std::move(wrappedRpc);
+}
+
+rpc::Message RpcWithTracingReq::toMessageImpl() && {
+  // save the original message ID and type before moving it.
+  auto wrappedMsgId = wrappedMessage_.id();
+  auto wrappedMsgType = wrappedMessage_.type();
+  auto wrappedPayload = std::move(wrappedMessage_).movePayload();
+  TORCH_INTERNAL_ASSERT(
+      !wrappedPayload.empty(), "Wrapped payload should not be empty.");
+  // Only the ids are sent, which keeps the overhead of a sampled RPC to a few
+  // bytes.
+  std::vector<at::IValue> ivalues{
+      wrappedMsgType, traceContext_.traceId, traceContext_.spanId};
+  std::vector<torch::Tensor> tensorTable;
+  std::vector<char> tracingPayload =
+      jit::pickle(c10::ivalue::Tuple::create(std::move(ivalues)), &tensorTable);
+  rpc::writeWrappedPayload(wrappedPayload, tracingPayload);
+  return rpc::Message(
+      std::move(wrappedPayload),
+      std::move(tensors_),
+      rpc::MessageType::RUN_WITH_TRACING_REQ,
+      wrappedMsgId);
+}
+
+RpcCommandBase& RpcWithTracingReq::wrappedRpc() {
+  TORCH_INTERNAL_ASSERT(wrappedRpc_ != nullptr, "wrappedRpc cannot be null!");
+  return *wrappedRpc_;
+}
+
+const rpc::RpcTraceContext& RpcWithTracingReq::traceContext() const {
+  return traceContext_;
+}
+
+std::unique_ptr<RpcWithTracingReq> RpcWithTracingReq::fromMessage(
+    const rpc::Message& message) {
+  std::vector<torch::Tensor> tensors = message.tensors();
+  int64_t msgId = message.id();
+  auto payload = message.payload();
+  auto tupleElements = rpc::readWrappedPayload(payload, message);
+  TORCH_INTERNAL_ASSERT(
+      tupleElements.size() == kTracingElementExpectedSize,
+      c10::str(
+          "Expected payload of size ",
+          kTracingElementExpectedSize,
+          " but got ",
+          tupleElements.size()));
+  rpc::MessageType wrappedMsgType =
+      static_cast<rpc::MessageType>(tupleElements[0].toInt());
+  rpc::RpcTraceContext traceContext{
+      tupleElements[1].toInt(), tupleElements[2].toInt()};
+
+  rpc::Message wrappedMessage(
+      std::move(payload), std::move(tensors), wrappedMsgType, msgId);
+  TORCH_INTERNAL_ASSERT(
+      wrappedMessage.isRequest(),
+      "Messages wrapped with tracing requests must be requests.");
+  std::unique_ptr<RpcCommandBase> wrappedRpc =
+      deserializeRequest(wrappedMessage);
+
+  return std::make_unique<RpcWithTracingReq>(
+      std::move(wrappedRpc),
+      wrappedMsgType,
+      std::move(wrappedMessage.tensors()),
+      traceContext);
+}
+} // namespace autograd
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/distributed/rpc/profiler/rpc_tracer.h>
+#include <torch/csrc/distributed/rpc/rpc_command_base.h>
+#include <torch/csrc/distributed/rpc/types.h>
+
+namespace torch {
+namespace distributed {
+namespace autograd {
+
+// Wraps a sampled request with the trace and span ids of its client span. The
+// callee responds with the response of the wrapped request, so that there is
+// no response type for it.
+class TORCH_API RpcWithTracingReq : public rpc::RpcCommandBase {
+ public:
+  // For sending RPCs, invoked when client is creating this RPC command.
+  RpcWithTracingReq(
+      rpc::Message&& wrappedMessage,
+      rpc::RpcTraceContext traceContext);
+
+  // For receiving an RPC
+  // Used in fromMessage.
+  RpcWithTracingReq(
+      std::unique_ptr<rpc::RpcCommandBase> wrappedRpc,
+      rpc::MessageType wrappedMessageType,
+      std::vector<torch::Tensor> tensors,
+      rpc::RpcTraceContext traceContext);
+
+  // Convert this RPC Command to a Message that can be sent over the wire.
+  rpc::Message toMessageImpl() && override;
+  static std::unique_ptr<RpcWithTracingReq> fromMessage(
+      const rpc::Message& message);
+
+  // Retrieve the trace and the client span of the wrapped RPC.
+  const rpc::RpcTraceContext& traceContext() const;
+  // Retrieve the original RPC which this TracingRPC wraps.
+  RpcCommandBase& wrappedRpc();
+  // Message type of the wrapped RPC
+  rpc::MessageType wrappedMessageType() const;
+  void setWrappedRpc(std::unique_ptr<RpcCommandBase> wrappedRpc);
+
+ private:
+  // wrapped message
+  rpc::Message wrappedMessage_;
+  std::unique_ptr<RpcCommandBase> wrappedRpc_;
+  rpc::MessageType wrappedMessageType_;
+  std::vector<torch::Tensor> tensors_;
+  const rpc::RpcTraceContext traceContext_;
+};
+} // namespace autograd
+} // namespace distributed
+} // namespace torch
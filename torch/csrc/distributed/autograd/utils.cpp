@@ -5,8 +5,10 @@
 #include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <torch/csrc/distributed/autograd/functions/sendrpc_backward.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_tracing_req.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/profiler/remote_profiler_manager.h>
+#include <torch/csrc/distributed/rpc/profiler/rpc_tracer.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/types.h>
 
@@ -144,12 +146,33 @@ std::shared_ptr<FutureMessage> sendMessageWithAutograd(
     torch::distributed::rpc::Message&& wrappedRpcMsg,
     bool forceGradRecording,
     const float rpcTimeoutSeconds) {
+  auto requestType = wrappedRpcMsg.type();
   auto msg = getMessageWithAutograd(
       dst.id_,
       std::move(wrappedRpcMsg),
       MessageType::FORWARD_AUTOGRAD_REQ,
       forceGradRecording);
 
+  // If the RPC is sampled for tracing, wrap it with the ids of its client span
+  // and record the span once the response arrives.
+  auto& tracer = rpc::RpcTracer::getInstance();
+  c10::optional<rpc::RpcSpan> clientSpan;
+  auto workerId = agent.getWorkerInfo().id_;
+  if (auto traceContext = tracer.startClientSpan(workerId)) {
+    auto parentContext = rpc::RpcTracer::currentContext();
+    clientSpan = rpc::RpcSpan{traceContext->traceId,
+                              traceContext->spanId,
+                              parentContext ? parentContext->spanId : -1,
+                              rpc::RpcSpanKind::CLIENT,
+                              workerId,
+                              dst.id_,
+                              requestType,
+                              rpc::RpcTracer::nowUs(),
+                              0,
+                              false};
+    msg = RpcWithTracingReq(std::move(msg), *traceContext).toMessage();
+  }
+
   std::shared_ptr<FutureMessage> fut;
   // If profiler is enabled, wrap this message with profiling metadata that will
   // tell the remote end to process this request with the profiler enabled.
@@ -164,6 +187,15 @@ std::shared_ptr<FutureMessage> sendMessageWithAutograd(
     fut = agent.send(dst, std::move(msg), rpcTimeoutSeconds);
   }
 
+  if (clientSpan) {
+    fut->addCallback([span = *clientSpan](
+                         const FutureMessage& futureMessage) mutable {
+      span.endUs = rpc::RpcTracer::nowUs();
+      span.hasError = futureMessage.hasError();
+      rpc::RpcTracer::getInstance().recordSpan(span);
+    });
+  }
+
   return fut;
 }
 
@@ -81,12 +81,19 @@ void broadcast_coalesced(
 }
 
 GradBucket::GradBucket(std::vector<at::Tensor> tensors)
-    : tensors_(std::move(tensors)){};
+    : GradBucket(0, std::move(tensors)){};
 
-const std::vector<at::Tensor>& GradBucket::getTensors() {
+GradBucket::GradBucket(size_t index, std::vector<at::Tensor> tensors)
+    : index_(index), tensors_(std::move(tensors)){};
+
+const std::vector<at::Tensor>& GradBucket::getTensors() const {
   return tensors_;
 }
 
+size_t GradBucket::getIndex() const {
+  return index_;
+}
+
 PythonCommHook::PythonCommHook(py::object state, py::object hook)
     : state_(std::move(state)), hook_(std::move(hook)){};
 
@@ -21,13 +21,20 @@ void broadcast_coalesced(
 class GradBucket {
  public:
   explicit GradBucket(std::vector<at::Tensor> tensors);
+  GradBucket(size_t index, std::vector<at::Tensor> tensors);
   // Each tensor in the list that getTensors returns refers to the replica on
   // each device. There will be multiple replicas only in the case of single
   // process multiple device mode. In the single process single device mode,
   // this list would consist of only a single tensor.
-  const std::vector<at::Tensor>& getTensors();
+  const std::vector<at::Tensor>& getTensors() const;
+
+  // Index of the bucket in the reducer, hooks that keep state across
+  // iterations can use it as the key of that state. It changes when the
+  // reducer rebuilds its buckets.
+  size_t getIndex() const;
 
  private:
+  size_t index_;
   std::vector<at::Tensor> tensors_;
 };
 
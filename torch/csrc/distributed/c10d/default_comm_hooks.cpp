@@ -0,0 +1,174 @@
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
+
+#include <cmath>
+
+#include <ATen/CPUGeneratorImpl.h>
+
+namespace c10d {
+namespace {
+
+c10::TypePtr tensorListType() {
+  return c10::ListType::create(c10::TensorType::get());
+}
+
+} // namespace
+
+c10::intrusive_ptr<torch::jit::Future> CppCommHook::allreduceAverage(
+    std::vector<at::Tensor> tensors) {
+  for (auto& tensor : tensors) {
+    tensor.div_(process_group_->getSize());
+  }
+  return process_group_->allreduce(tensors)->getFuture();
+}
+
+c10::intrusive_ptr<torch::jit::Future> AllReduceCommHook::runHook(
+    const GradBucket& bucket) {
+  return allreduceAverage(bucket.getTensors());
+}
+
+c10::intrusive_ptr<torch::jit::Future> FP16CompressCommHook::runHook(
+    const GradBucket& bucket) {
+  auto tensor = bucket.getTensors()[0];
+  if (tensor.is_sparse()) {
+    return allreduceAverage(bucket.getTensors());
+  }
+  // Divide before the cast, the sum of the halves could overflow.
+  std::vector<at::Tensor> compressed = {
+      tensor.div(process_group_->getSize()).to(at::kHalf)};
+  auto fut = process_group_->allreduce(compressed)->getFuture();
+  return fut->then(
+      [tensor, compressed]() mutable {
+        tensor.copy_(compressed[0]);
+        return c10::IValue(std::vector<at::Tensor>{tensor});
+      },
+      tensorListType());
+}
+
+PowerSGDCommHook::PowerSGDCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank)
+    : CppCommHook(std::move(process_group)),
+      matrix_approximation_rank_(matrix_approximation_rank) {
+  TORCH_CHECK(
+      matrix_approximation_rank_ > 0,
+      "PowerSGD expects a positive matrix approximation rank, got ",
+      matrix_approximation_rank_);
+}
+
+c10::intrusive_ptr<torch::jit::Future> PowerSGDCommHook::runHook(
+    const GradBucket& bucket) {
+  auto tensor = bucket.getTensors()[0];
+  const int64_t numel = tensor.numel();
+  const int64_t side = std::ceil(std::sqrt(static_cast<double>(numel)));
+  const int64_t rank = std::min(matrix_approximation_rank_, side);
+  // Compressing does not pay off when the factors are not smaller than the
+  // bucket. Half buckets are not compressed either, qr does not support them.
+  if (tensor.is_sparse() || tensor.scalar_type() == at::kHalf ||
+      2 * side * rank >= numel) {
+    return allreduceAverage(bucket.getTensors());
+  }
+
+  std::shared_ptr<BucketState> state;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = states_[bucket.getIndex()];
+    if (!entry || entry->error.numel() != side * side) {
+      entry = std::make_shared<BucketState>();
+      entry->error = at::zeros({side * side}, tensor.options());
+      // Q has to start out the same on all the ranks.
+      auto generator = at::detail::createCPUGenerator(/*seed_val=*/0);
+      entry->q = at::randn({side, rank}, generator, tensor.options().device(at::kCPU))
+                     .to(tensor.device());
+    }
+    state = entry;
+  }
+
+  state->error.narrow(0, 0, numel).add_(tensor.view(-1));
+  at::Tensor matrix = state->error.view({side, side});
+  std::vector<at::Tensor> p = {at::matmul(matrix, state->q)};
+  auto fut = process_group_->allreduce(p)->getFuture();
+  auto process_group = process_group_;
+  return fut->then(
+      [tensor, matrix, state, p, process_group]() mutable {
+        // The orthogonal basis of the sum of the P of all the ranks, the
+        // scale of P does not matter here.
+        at::Tensor basis = std::get<0>(at::qr(p[0]));
+        std::vector<at::Tensor> q = {at::matmul(matrix.t(), basis)};
+        process_group->allreduce(q)->wait();
+        q[0].div_(process_group->getSize());
+
+        at::Tensor approximation = at::matmul(basis, q[0].t());
+        // What the approximation misses is added back in the next iteration.
+        matrix.sub_(approximation);
+        state->error.narrow(0, tensor.numel(), matrix.numel() - tensor.numel())
+            .zero_();
+        state->q = q[0];
+        tensor.view(-1).copy_(approximation.view(-1).narrow(0, 0, tensor.numel()));
+        return c10::IValue(std::vector<at::Tensor>{tensor});
+      },
+      tensorListType());
+}
+
+TopKCommHook::TopKCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    double ratio)
+    : CppCommHook(std::move(process_group)), ratio_(ratio) {
+  TORCH_CHECK(
+      ratio_ > 0 && ratio_ <= 1,
+      "top-k compression expects a ratio in (0, 1], got ",
+      ratio_);
+}
+
+c10::intrusive_ptr<torch::jit::Future> TopKCommHook::runHook(
+    const GradBucket& bucket) {
+  auto tensor = bucket.getTensors()[0];
+  const int64_t numel = tensor.numel();
+  const int64_t k = std::max<int64_t>(1, std::ceil(ratio_ * numel));
+  // An index and a value are sent per entry, so keeping more than a third
+  // of the entries of a float bucket sends more than the bucket.
+  if (tensor.is_sparse() || 3 * k >= numel) {
+    return allreduceAverage(bucket.getTensors());
+  }
+
+  at::Tensor error;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = errors_[bucket.getIndex()];
+    if (!entry.defined() || entry.numel() != numel) {
+      entry = at::zeros({numel}, tensor.options());
+    }
+    error = entry;
+  }
+
+  error.add_(tensor.view(-1));
+  at::Tensor indices = std::get<1>(error.abs().topk(k, 0, true, false));
+  at::Tensor values = error.index_select(0, indices);
+  // The entries that are sent are not part of the error anymore.
+  error.index_fill_(0, indices, 0);
+
+  const int world_size = process_group_->getSize();
+  std::vector<std::vector<at::Tensor>> gathered_indices(1);
+  std::vector<std::vector<at::Tensor>> gathered_values(1);
+  for (int rank = 0; rank < world_size; rank++) {
+    gathered_indices[0].push_back(at::empty_like(indices));
+    gathered_values[0].push_back(at::empty_like(values));
+  }
+  std::vector<at::Tensor> local_indices = {indices};
+  std::vector<at::Tensor> local_values = {values};
+  process_group_->allgather(gathered_indices, local_indices)->wait();
+  auto fut =
+      process_group_->allgather(gathered_values, local_values)->getFuture();
+  return fut->then(
+      [tensor, gathered_indices, gathered_values, world_size]() mutable {
+        at::Tensor flat = tensor.view(-1);
+        flat.zero_();
+        for (int rank = 0; rank < world_size; rank++) {
+          flat.index_add_(0, gathered_indices[0][rank], gathered_values[0][rank]);
+        }
+        flat.div_(world_size);
+        return c10::IValue(std::vector<at::Tensor>{tensor});
+      },
+      tensorListType());
+}
+
+} // namespace c10d
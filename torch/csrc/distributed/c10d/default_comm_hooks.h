@@ -0,0 +1,104 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/c10d/comm.h>
+
+namespace c10d {
+
+// DDP communication hooks implemented in C++, they run without the GIL.
+// Every hook averages the gradients over the process group itself, as
+// the reducer does not divide them by the world size once a hook is
+// registered. Their futures come from ProcessGroup::Work::getFuture, which
+// is only implemented by the NCCL process group.
+enum class BuiltinCommHookType {
+  ALLREDUCE,
+  FP16_COMPRESS,
+  POWER_SGD,
+  TOPK,
+};
+
+// Base class of the C++ hooks, their futures hold the list of the reduced
+// bucket tensors.
+class TORCH_API CppCommHook : public CommHookInterface {
+ public:
+  explicit CppCommHook(std::shared_ptr<ProcessGroup> process_group)
+      : process_group_(std::move(process_group)) {}
+
+  std::vector<at::Tensor> processFuture(c10::IValue future_value) override {
+    return future_value.toTensorVector();
+  }
+
+ protected:
+  // Allreduces the average of the tensors, sparse gradients and the hooks
+  // that do not compress a bucket fall back to this.
+  c10::intrusive_ptr<torch::jit::Future> allreduceAverage(
+      std::vector<at::Tensor> tensors);
+
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// Same as the default behavior of the reducer.
+class TORCH_API AllReduceCommHook : public CppCommHook {
+ public:
+  using CppCommHook::CppCommHook;
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+};
+
+// Casts the bucket to half precision before the allreduce and back to the
+// type of the bucket after it, halving the bytes that are sent.
+class TORCH_API FP16CompressCommHook : public CppCommHook {
+ public:
+  using CppCommHook::CppCommHook;
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+};
+
+// PowerSGD (Vogels et al., 2019). The bucket is viewed as a square matrix
+// M, padded with zeros, and only the factors P = M Q and Q = M^T P of a low
+// rank approximation P Q^T are allreduced, with one step of power iteration
+// per backward pass. Q is reused by the next iteration as the starting point
+// of the power iteration, and what the approximation misses is added back
+// to the bucket in the next iteration (error feedback).
+class TORCH_API PowerSGDCommHook : public CppCommHook {
+ public:
+  PowerSGDCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank);
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+
+ private:
+  struct BucketState {
+    at::Tensor error;
+    at::Tensor q;
+  };
+
+  const int64_t matrix_approximation_rank_;
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::shared_ptr<BucketState>> states_;
+};
+
+// Only the k entries of the bucket with the largest magnitude are sent,
+// with their indices. The entries that are not sent are added back to the
+// bucket in the next iteration (error feedback).
+class TORCH_API TopKCommHook : public CppCommHook {
+ public:
+  TopKCommHook(std::shared_ptr<ProcessGroup> process_group, double ratio);
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+
+ private:
+  const double ratio_;
+  std::mutex mutex_;
+  std::unordered_map<size_t, at::Tensor> errors_;
+};
+
+} // namespace c10d
@@ -23,6 +23,7 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/object_ptr.h>
@@ -121,6 +122,33 @@ void _register_comm_hook(
       std::move(state), std::move(comm_hook)));
 };
 
+// Registers one of the communication hooks implemented in C++, they do not
+// need the GIL while DDP runs them.
+void _register_builtin_comm_hook(
+    ::c10d::Reducer& reducer,
+    std::shared_ptr<::c10d::ProcessGroup> process_group,
+    ::c10d::BuiltinCommHookType comm_hook_type,
+    int64_t matrix_approximation_rank,
+    double topk_ratio) {
+  std::unique_ptr<::c10d::CommHookInterface> hook;
+  switch (comm_hook_type) {
+    case ::c10d::BuiltinCommHookType::ALLREDUCE:
+      hook = std::make_unique<::c10d::AllReduceCommHook>(process_group);
+      break;
+    case ::c10d::BuiltinCommHookType::FP16_COMPRESS:
+      hook = std::make_unique<::c10d::FP16CompressCommHook>(process_group);
+      break;
+    case ::c10d::BuiltinCommHookType::POWER_SGD:
+      hook = std::make_unique<::c10d::PowerSGDCommHook>(
+          process_group, matrix_approximation_rank);
+      break;
+    case ::c10d::BuiltinCommHookType::TOPK:
+      hook = std::make_unique<::c10d::TopKCommHook>(process_group, topk_ratio);
+      break;
+  }
+  reducer.register_comm_hook(std::move(hook));
+}
+
 PyObject* c10d_init(PyObject* _unused) {
   C10_LOG_API_USAGE_ONCE("c10d.python.import");
   auto c10d_module = THPObjectPtr(PyImport_ImportModule("torch.distributed"));
@@ -137,8 +165,33 @@ PyObject* c10d_init(PyObject* _unused) {
       py::arg("state"),
       py::arg("comm_hook"));
 
+  py::enum_<::c10d::BuiltinCommHookType>(module, "BuiltinCommHookType", R"(
+An enum-like class for the DDP communication hooks implemented in C++:
+``ALLREDUCE``, ``FP16_COMPRESS``, ``POWER_SGD`` and ``TOPK``.)")
+      .value("ALLREDUCE", ::c10d::BuiltinCommHookType::ALLREDUCE)
+      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS)
+      .value("POWER_SGD", ::c10d::BuiltinCommHookType::POWER_SGD)
+      .value("TOPK", ::c10d::BuiltinCommHookType::TOPK);
+
+  module.def(
+      "_register_builtin_comm_hook",
+      &_register_builtin_comm_hook,
+      py::arg("reducer"),
+      py::arg("process_group"),
+      py::arg("comm_hook_type"),
+      py::arg("matrix_approximation_rank") = 1,
+      py::arg("topk_ratio") = 0.01,
+      py::call_guard<py::gil_scoped_release>());
+
   shared_ptr_class_<::c10d::GradBucket>(module, "_GradBucket")
       .def(py::init<std::vector<Tensor>&>(), py::arg("tensors"))
+      .def(
+          "get_index",
+          &::c10d::GradBucket::getIndex,
+          R"(
+            ``get_index`` returns the index of the bucket in the reducer.
+            It changes when the reducer rebuilds its buckets.
+           )")
       .def(
           "get_tensors",
           &::c10d::GradBucket::getTensors,
@@ -180,7 +233,30 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def(
+          "_register_bucket_ready_callback",
+          [](::c10d::Reducer& reducer, py::object callback) {
+            // The callback is released by the reducer, which may not hold
+            // the GIL at that point.
+            std::shared_ptr<py::object> fn(
+                new py::object(std::move(callback)), [](py::object* obj) {
+                  py::gil_scoped_acquire ag;
+                  delete obj;
+                });
+            reducer.register_bucket_ready_callback(
+                [fn](const std::vector<torch::autograd::Variable>& variables) {
+                  py::gil_scoped_acquire ag;
+                  (*fn)(variables);
+                });
+          },
+          py::arg("callback"))
+      .def(
+          "_set_bucket_cost_model",
+          &::c10d::Reducer::set_bucket_cost_model,
+          py::arg("latency_ns"),
+          py::arg("ns_per_byte"),
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -276,6 +352,34 @@ They are used in specifying strategies for reduction collectives, e.g.,
                     reinterpret_cast<char*>(value.data()), value.size());
               },
               py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<char*>(value.data()), value.size()));
+                }
+                return result;
+              })
           .def(
               "add",
               &::c10d::Store::add,
@@ -318,7 +422,8 @@ They are used in specifying strategies for reduction collectives, e.g.,
           py::arg("world_size"),
           py::arg("is_master"),
           py::arg("timeout") =
-              std::chrono::milliseconds(::c10d::Store::kDefaultTimeout));
+              std::chrono::milliseconds(::c10d::Store::kDefaultTimeout))
+      .def_property_readonly("port", &::c10d::TCPStore::getPort);
 
   shared_ptr_class_<::c10d::PrefixStore>(module, "PrefixStore", store)
       .def(py::init<const std::string&, std::shared_ptr<::c10d::Store>>());
@@ -444,6 +549,14 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("opts") = ::c10d::AllgatherOptions(),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "_allgather_base",
+              &::c10d::ProcessGroup::allgather_base,
+              py::arg("output"),
+              py::arg("input"),
+              py::arg("opts") = ::c10d::AllgatherOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "gather",
               &::c10d::ProcessGroup::gather,
@@ -516,6 +629,14 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("input_tensor"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "_reduce_scatter_base",
+              &::c10d::ProcessGroup::reduce_scatter_base,
+              py::arg("output"),
+              py::arg("input"),
+              py::arg("opts") = ::c10d::ReduceScatterOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "alltoall_base",
               &::c10d::ProcessGroup::alltoall_base,
@@ -588,16 +709,20 @@ They are used in specifying strategies for reduction collectives, e.g.,
 
   module.def(
       "_round_robin_process_groups",
-      [](std::vector<std::shared_ptr<::c10d::ProcessGroup>> processGroups)
-          -> std::shared_ptr<::c10d::ProcessGroup> {
+      [](std::vector<std::shared_ptr<::c10d::ProcessGroup>> processGroups,
+         int64_t stripeMinBytes) -> std::shared_ptr<::c10d::ProcessGroup> {
         if (processGroups.size() == 0) {
           throw std::invalid_argument("Specify at least 1 process group");
         }
         const auto& first = processGroups.front();
         return std::make_shared<::c10d::ProcessGroupRoundRobin>(
-            first->getRank(), first->getSize(), std::move(processGroups));
+            first->getRank(),
+            first->getSize(),
+            std::move(processGroups),
+            stripeMinBytes);
       },
       py::arg("process_groups"),
+      py::arg("stripe_min_bytes") = 0,
       py::call_guard<py::gil_scoped_release>());
 
 #ifdef USE_C10D_GLOO
@@ -611,7 +736,10 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "allreduce_min_chunk_bytes",
+          &::c10d::ProcessGroupGloo::Options::allreduceMinChunkBytes);
 
   processGroupGloo.def_static(
       "create_device",
@@ -766,6 +894,17 @@ They are used in specifying strategies for reduction collectives, e.g.,
       py::arg("tensor_indices") = std::vector<int64_t>(),
       py::call_guard<py::gil_scoped_release>());
 
+  module.def(
+      "_compute_bucket_assignment_by_timing",
+      &::c10d::compute_bucket_assignment_by_timing,
+      py::arg("tensors"),
+      py::arg("ready_times"),
+      py::arg("latency"),
+      py::arg("time_per_byte"),
+      py::arg("expect_sparse_gradient") = std::vector<bool>(),
+      py::arg("tensor_indices") = std::vector<int64_t>(),
+      py::call_guard<py::gil_scoped_release>());
+
   module.def(
       "_broadcast_coalesced",
       // Define a lambda such that the pybind11 prototype can take a std::vector
@@ -1,6 +1,7 @@
 #include <torch/csrc/distributed/c10d/reducer.h>
 
 #include <functional>
+#include <limits>
 
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
@@ -43,7 +44,9 @@ Reducer::Reducer(
       backward_stats_base_(0),
       has_rebuilt_bucket_(false),
       bucket_bytes_cap_(bucket_bytes_cap),
-      comm_hook_(nullptr) {
+      comm_hook_(nullptr),
+      bucket_latency_ns_(-1),
+      bucket_ns_per_byte_(0) {
   C10_LOG_API_USAGE_ONCE("torch.distributed.ddp.reducer");
   TORCH_CHECK(replicas_.size() >= 1, "Expected at least one model replica.");
   TORCH_CHECK(replicas_[0].size() >= 1, "Expected at least one parameter.");
@@ -606,7 +609,8 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
     if (comm_hook_ == nullptr) {
       bucket.work = process_group_->allreduce(tensors);
     } else {
-      bucket.future_work = comm_hook_->runHook(GradBucket(tensors));
+      bucket.future_work =
+          comm_hook_->runHook(GradBucket(next_bucket_, tensors));
     }
   }
 }
@@ -1010,6 +1014,9 @@ void Reducer::finalize_backward() {
       // the allreduce is done, the sparse grads are automatically updated.
       finalize_bucket_dense(bucket);
     }
+    if (bucket_ready_callback_) {
+      bucket_ready_callback_(bucket.replicas[0].variables);
+    }
   }
 
   // See Note [Skip allreducing local_used_maps_dev]
@@ -1139,11 +1146,26 @@ std::vector<std::vector<size_t>> Reducer::rebuildBuckets() {
   std::vector<size_t> bucket_size_limits;
   bucket_size_limits.push_back(kDefaultFirstBucketBytes);
   bucket_size_limits.push_back(bucket_bytes_cap_);
-  rebuilt_bucket_indices = compute_bucket_assignment_by_size(
-      rebuilt_params_,
-      bucket_size_limits,
-      expect_sparse_gradients_[0],
-      rebuilt_param_indices_);
+  if (bucket_latency_ns_ >= 0) {
+    std::vector<int64_t> ready_times;
+    ready_times.reserve(rebuilt_param_indices_.size());
+    for (const auto index : rebuilt_param_indices_) {
+      ready_times.push_back(backward_stats_[0][index]);
+    }
+    rebuilt_bucket_indices = compute_bucket_assignment_by_timing(
+        rebuilt_params_,
+        ready_times,
+        bucket_latency_ns_,
+        bucket_ns_per_byte_,
+        expect_sparse_gradients_[0],
+        rebuilt_param_indices_);
+  } else {
+    rebuilt_bucket_indices = compute_bucket_assignment_by_size(
+        rebuilt_params_,
+        bucket_size_limits,
+        expect_sparse_gradients_[0],
+        rebuilt_param_indices_);
+  }
 
   // For rebuilt bucket indices, it needs to be synced across all ranks.
   // Broadcast the newly rebuilt bucket indices from rank 0 in default.
@@ -1170,6 +1192,28 @@ void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
   comm_hook_ = std::move(iface);
 }
 
+void Reducer::register_bucket_ready_callback(BucketReadyCallback callback) {
+  TORCH_CHECK(
+      !bucket_ready_callback_,
+      "register_bucket_ready_callback can only be called once.");
+  bucket_ready_callback_ = std::move(callback);
+}
+
+void Reducer::set_bucket_cost_model(double latency_ns, double ns_per_byte) {
+  TORCH_CHECK(
+      latency_ns >= 0 && ns_per_byte >= 0,
+      "set_bucket_cost_model expects a non-negative latency and time per byte, got ",
+      latency_ns,
+      " and ",
+      ns_per_byte);
+  TORCH_CHECK(
+      !has_rebuilt_bucket_,
+      "set_bucket_cost_model must be called before the buckets are rebuilt "
+      "at the end of the first iteration.");
+  bucket_latency_ns_ = latency_ns;
+  bucket_ns_per_byte_ = ns_per_byte;
+}
+
 namespace {
 
 // Tensors may be coalesced into buckets. Buckets must contain tensors of
@@ -1304,4 +1348,115 @@ std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
   return result;
 }
 
+std::vector<std::vector<size_t>> compute_bucket_assignment_by_timing(
+    const std::vector<at::Tensor>& tensors,
+    const std::vector<int64_t>& ready_times,
+    double latency,
+    double time_per_byte,
+    const std::vector<bool>& expect_sparse_gradient,
+    const std::vector<int64_t>& tensor_indices) {
+  TORCH_INTERNAL_ASSERT(
+      expect_sparse_gradient.empty() ||
+      (tensors.size() == expect_sparse_gradient.size()));
+  TORCH_INTERNAL_ASSERT(tensors.size() > 0);
+  TORCH_CHECK(
+      ready_times.size() == tensors.size(),
+      "Expected a ready time per tensor, got ",
+      ready_times.size(),
+      " for ",
+      tensors.size(),
+      " tensors.");
+
+  // Buckets with the position of their last tensor, they are ready in that
+  // order.
+  std::vector<std::pair<size_t, std::vector<size_t>>> buckets;
+
+  // Positions of the dense tensors by type and device.
+  std::unordered_map<BucketKey, std::vector<size_t>, torch::hash<BucketKey>>
+      groups;
+  std::vector<BucketKey> group_order;
+
+  const auto index_of = [&](size_t i) -> size_t {
+    return tensor_indices.empty() ? i : tensor_indices[i];
+  };
+
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const auto& tensor = tensors[i];
+    TORCH_CHECK(!tensor.is_sparse(), "No support for sparse tensors.");
+    if (!expect_sparse_gradient.empty() && expect_sparse_gradient[index_of(i)]) {
+      buckets.push_back({i, {index_of(i)}});
+      continue;
+    }
+    auto key = BucketKey(tensor.scalar_type(), tensor.device());
+    auto it = groups.find(key);
+    if (it == groups.end()) {
+      group_order.push_back(key);
+      it = groups.emplace(key, std::vector<size_t>()).first;
+    }
+    it->second.push_back(i);
+  }
+
+  for (const auto& key : group_order) {
+    const auto& positions = groups.at(key);
+    const size_t n = positions.size();
+    // A bucket is ready when all of its tensors are, a tensor that was ready
+    // earlier than the one before it does not make the bucket ready earlier.
+    std::vector<double> ready(n);
+    std::vector<double> bytes(n + 1, 0);
+    for (size_t j = 0; j < n; j++) {
+      const auto& tensor = tensors[positions[j]];
+      ready[j] = static_cast<double>(ready_times[positions[j]]);
+      if (j > 0) {
+        ready[j] = std::max(ready[j], ready[j - 1]);
+      }
+      bytes[j + 1] = bytes[j] + tensor.numel() * tensor.element_size();
+    }
+
+    // finish[j] is the earliest time at which the allreduces of the first j
+    // tensors are done, and start[j] where the last bucket of the best
+    // assignment of these j tensors starts.
+    std::vector<double> finish(n + 1, 0);
+    std::vector<size_t> start(n + 1, 0);
+    for (size_t j = 1; j <= n; j++) {
+      finish[j] = std::numeric_limits<double>::infinity();
+      for (size_t i = 0; i < j; i++) {
+        const double cost = std::max(finish[i], ready[j - 1]) + latency +
+            (bytes[j] - bytes[i]) * time_per_byte;
+        if (cost < finish[j]) {
+          finish[j] = cost;
+          start[j] = i;
+        }
+      }
+    }
+
+    std::vector<std::pair<size_t, std::vector<size_t>>> group_buckets;
+    for (size_t j = n; j > 0; j = start[j]) {
+      std::vector<size_t> indices;
+      for (size_t k = start[j]; k < j; k++) {
+        indices.push_back(index_of(positions[k]));
+      }
+      group_buckets.push_back({positions[j - 1], std::move(indices)});
+    }
+    buckets.insert(
+        buckets.end(),
+        std::make_move_iterator(group_buckets.rbegin()),
+        std::make_move_iterator(group_buckets.rend()));
+  }
+
+  std::stable_sort(
+      buckets.begin(),
+      buckets.end(),
+      [](const std::pair<size_t, std::vector<size_t>>& a,
+         const std::pair<size_t, std::vector<size_t>>& b) {
+        return a.first < b.first;
+      });
+
+  std::vector<std::vector<size_t>> result;
+  result.reserve(buckets.size());
+  for (auto& bucket : buckets) {
+    result.push_back(std::move(bucket.second));
+  }
+  return result;
+}
+
 } // namespace c10d
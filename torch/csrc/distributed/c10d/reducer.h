@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <tuple>
@@ -59,6 +60,24 @@ class Reducer {
   // be called once before calling backward.
   void register_comm_hook(std::unique_ptr<CommHookInterface> iface);
 
+  // Registers a function that is called with the parameters of a bucket as
+  // soon as the reduced gradients of the bucket have been written to them,
+  // before waiting for the reduction of the next bucket. Applying the
+  // optimizer update in this function overlaps it with the communication
+  // of the buckets that are still being reduced. Only the parameters of the
+  // first model replica are passed, the other replicas are synced from it in
+  // the forward pass.
+  using BucketReadyCallback =
+      std::function<void(const std::vector<torch::autograd::Variable>&)>;
+  void register_bucket_ready_callback(BucketReadyCallback callback);
+
+  // Sets the cost of an allreduce of `n` bytes to
+  // `latency_ns + n * ns_per_byte`. The bucket rebuild after the first
+  // iteration then picks the bucket boundaries with
+  // compute_bucket_assignment_by_timing, using the times at which the
+  // gradients were ready in that iteration, instead of the byte caps.
+  void set_bucket_cost_model(double latency_ns, double ns_per_byte);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -262,6 +281,11 @@ class Reducer {
   std::vector<int64_t> rebuilt_param_indices_;
   const int64_t bucket_bytes_cap_;
 
+  // Allreduce cost model of set_bucket_cost_model, a negative latency means
+  // that it is not set.
+  double bucket_latency_ns_;
+  double bucket_ns_per_byte_;
+
   struct RpcContext {
     using ContextPtr = torch::distributed::autograd::ContextPtr;
     // The shared_ptr is to hold the context instance.
@@ -275,6 +299,8 @@ class Reducer {
  private:
   // comm_hook_ is used to access the DDP communication hook if registered.
   std::unique_ptr<CommHookInterface> comm_hook_;
+
+  BucketReadyCallback bucket_ready_callback_;
 };
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
@@ -283,4 +309,20 @@ std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
     const std::vector<bool>& expect_sparse_gradient = {},
     const std::vector<int64_t>& tensor_indices = {});
 
+// Tensors are given in the order in which their gradients are ready, at the
+// times `ready_times` (in any unit). The allreduce of a bucket of `n` bytes
+// takes `latency + n * time_per_byte` and the allreduces run one after the
+// other. Picks the bucket boundaries for which the last allreduce finishes
+// first: small buckets start the communication early, while large ones pay
+// the latency fewer times. As in compute_bucket_assignment_by_size, tensors
+// are only grouped with tensors of the same type and device, and tensors
+// that expect a sparse gradient get their own bucket.
+std::vector<std::vector<size_t>> compute_bucket_assignment_by_timing(
+    const std::vector<at::Tensor>& tensors,
+    const std::vector<int64_t>& ready_times,
+    double latency,
+    double time_per_byte,
+    const std::vector<bool>& expect_sparse_gradient = {},
+    const std::vector<int64_t>& tensor_indices = {});
+
 } // namespace c10d
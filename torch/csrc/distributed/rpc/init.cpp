@@ -2,6 +2,7 @@
 
 #include <torch/csrc/distributed/rpc/process_group_agent.h>
 #include <torch/csrc/distributed/rpc/profiler/remote_profiler_manager.h>
+#include <torch/csrc/distributed/rpc/profiler/rpc_tracer.h>
 #include <torch/csrc/distributed/rpc/profiler/server_process_global_profiler.h>
 #include <torch/csrc/distributed/rpc/py_rref.h>
 #include <torch/csrc/distributed/rpc/python_functions.h>
@@ -467,14 +468,16 @@ PyObject* rpc_init(PyObject* /* unused */) {
               optional<std::vector<std::string>>,
               float,
               std::string,
-              std::unordered_map<std::string, tensorpipe::DeviceMap>>(),
+              std::unordered_map<std::string, tensorpipe::DeviceMap>,
+              size_t>(),
           py::arg("num_worker_threads") = kDefaultNumWorkerThreads,
           py::arg("_transports") = optional<std::vector<std::string>>(),
           py::arg("_channels") = optional<std::vector<std::string>>(),
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
           py::arg("init_method") = kDefaultInitMethod,
           py::arg("device_maps") =
-              std::unordered_map<std::string, tensorpipe::DeviceMap>())
+              std::unordered_map<std::string, tensorpipe::DeviceMap>(),
+          py::arg("max_batch_bytes") = 0)
       .def_readwrite(
           "num_worker_threads",
           &TensorPipeRpcBackendOptions::numWorkerThreads,
@@ -487,6 +490,13 @@ PyObject* rpc_init(PyObject* /* unused */) {
           "device_maps",
           &TensorPipeRpcBackendOptions::deviceMaps,
           R"(The device map locations.)")
+      .def_readwrite(
+          "max_batch_bytes",
+          &TensorPipeRpcBackendOptions::maxBatchBytes,
+          R"(
+              The byte cap of a batch of requests to the same worker, zero
+              if requests are not batched.
+          )")
       .def("set_device_map", &TensorPipeRpcBackendOptions::setDeviceMap);
 
   module.attr("_DEFAULT_NUM_WORKER_THREADS") =
@@ -736,6 +746,51 @@ PyObject* rpc_init(PyObject* /* unused */) {
         inst.setCurrentKey(key);
       });
 
+  py::class_<RpcSpan>(module, "_RpcSpan")
+      .def_readonly("trace_id", &RpcSpan::traceId)
+      .def_readonly("span_id", &RpcSpan::spanId)
+      .def_readonly("parent_span_id", &RpcSpan::parentSpanId)
+      .def_property_readonly(
+          "is_server",
+          [](const RpcSpan& span) { return span.kind == RpcSpanKind::SERVER; })
+      .def_readonly("worker_id", &RpcSpan::workerId)
+      .def_readonly("peer_id", &RpcSpan::peerId)
+      .def_property_readonly(
+          "message_type",
+          [](const RpcSpan& span) { return static_cast<int>(span.messageType); })
+      .def_readonly("start_us", &RpcSpan::startUs)
+      .def_readonly("end_us", &RpcSpan::endUs)
+      .def_readonly("has_error", &RpcSpan::hasError);
+
+  module.def(
+      "_set_rpc_trace_sample_rate",
+      [](double sampleRate) {
+        RpcTracer::getInstance().setSampleRate(sampleRate);
+      },
+      py::arg("sample_rate"),
+      R"(
+          Sets the fraction of the RPCs issued by this worker outside of other
+          traced RPCs which start a new trace. The RPCs issued by a worker
+          while it processes a traced request are traced regardless. Tracing
+          is disabled with 0, the default.
+      )");
+  module.def("_get_rpc_trace_sample_rate", []() {
+    return RpcTracer::getInstance().getSampleRate();
+  });
+  module.def(
+      "_set_rpc_trace_capacity",
+      [](size_t capacity) { RpcTracer::getInstance().setCapacity(capacity); },
+      py::arg("capacity"));
+  module.def(
+      "_get_rpc_trace_spans",
+      []() { return RpcTracer::getInstance().getSpans(); },
+      R"(
+          Returns the spans of traced RPCs recorded by this worker, oldest
+          first. ``torch.distributed.rpc._tracing`` merges them across workers.
+      )");
+  module.def(
+      "_clear_rpc_trace_spans", []() { RpcTracer::getInstance().clear(); });
+
   module.def(
       "_enable_jit_rref_pickle",
       &enableJitRRefPickle,
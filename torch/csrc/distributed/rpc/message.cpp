@@ -84,6 +84,7 @@ bool Message::isRequest() const {
       MessageType::SCRIPT_RREF_FETCH_CALL == type_ ||
       MessageType::PYTHON_RREF_FETCH_CALL == type_ ||
       MessageType::RREF_USER_DELETE == type_ ||
+      MessageType::RREF_USER_DELETE_BATCH == type_ ||
       MessageType::RREF_CHILD_ACCEPT == type_ ||
       MessageType::RREF_FORK_REQUEST == type_ ||
       // Autograd message
@@ -92,7 +93,9 @@ bool Message::isRequest() const {
       // Cleanup Autograd context request
       MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ == type_ ||
       // Run with profiling request
-      MessageType::RUN_WITH_PROFILING_REQ == type_;
+      MessageType::RUN_WITH_PROFILING_REQ == type_ ||
+      // Run with tracing request
+      MessageType::RUN_WITH_TRACING_REQ == type_;
 }
 
 bool Message::isResponse() const {
@@ -56,6 +56,14 @@ enum MessageType {
   RUN_WITH_PROFILING_REQ = 21,
   RUN_WITH_PROFILING_RESP = 22,
 
+  // Several RREF_USER_DELETE messages to the same owner in one request, the
+  // owner replies with a single RREF_ACK.
+  RREF_USER_DELETE_BATCH = 23,
+
+  // A sampled request with its trace context, the response is the one of the
+  // wrapped request.
+  RUN_WITH_TRACING_REQ = 24,
+
   // Other internal message types
   EXCEPTION = 55,
   UNKNOWN = 60
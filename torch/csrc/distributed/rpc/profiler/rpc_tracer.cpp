@@ -0,0 +1,131 @@
+#include <torch/csrc/distributed/rpc/profiler/rpc_tracer.h>
+
+#include <chrono>
+#include <random>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+constexpr int kAutoIncrementBits = 48;
+constexpr int64_t kAutoIncrementMask = (1LL << kAutoIncrementBits) - 1;
+constexpr size_t kDefaultCapacity = 1 << 16;
+
+bool sample(double sampleRate) {
+  if (sampleRate <= 0) {
+    return false;
+  }
+  if (sampleRate >= 1) {
+    return true;
+  }
+  static thread_local std::minstd_rand generator{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0, 1)(generator) < sampleRate;
+}
+
+} // namespace
+
+/*static */ thread_local c10::optional<RpcTraceContext>
+    RpcTracer::currentContext_ = c10::nullopt;
+
+/*static */ RpcTracer& RpcTracer::getInstance() {
+  static RpcTracer* tracer = new RpcTracer();
+  return *tracer;
+}
+
+RpcTracer::RpcTracer()
+    : sampleRate_(0), nextLocalId_(0), capacity_(kDefaultCapacity), next_(0) {}
+
+void RpcTracer::setSampleRate(double sampleRate) {
+  TORCH_CHECK(
+      sampleRate >= 0 && sampleRate <= 1,
+      "RPC trace sample rate must be in [0, 1], but got ",
+      sampleRate);
+  sampleRate_ = sampleRate;
+}
+
+double RpcTracer::getSampleRate() const {
+  return sampleRate_;
+}
+
+void RpcTracer::setCapacity(size_t capacity) {
+  TORCH_CHECK(capacity > 0, "RPC trace capacity must be positive.");
+  std::lock_guard<std::mutex> guard(mutex_);
+  spans_.clear();
+  capacity_ = capacity;
+  next_ = 0;
+}
+
+c10::optional<RpcTraceContext> RpcTracer::startClientSpan(
+    worker_id_t workerId) {
+  if (currentContext_) {
+    return RpcTraceContext{currentContext_->traceId, nextSpanId(workerId)};
+  }
+  if (!sample(sampleRate_.load(std::memory_order_relaxed))) {
+    return c10::nullopt;
+  }
+  // The trace is named after its first span.
+  auto spanId = nextSpanId(workerId);
+  return RpcTraceContext{spanId, spanId};
+}
+
+int64_t RpcTracer::nextSpanId(worker_id_t workerId) {
+  auto localId = nextLocalId_++ & kAutoIncrementMask;
+  return (static_cast<int64_t>(workerId) << kAutoIncrementBits) | localId;
+}
+
+/*static */ worker_id_t RpcTracer::creatorOf(int64_t id) {
+  return static_cast<worker_id_t>(id >> kAutoIncrementBits);
+}
+
+/*static */ c10::optional<RpcTraceContext> RpcTracer::currentContext() {
+  return currentContext_;
+}
+
+void RpcTracer::recordSpan(const RpcSpan& span) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (spans_.size() < capacity_) {
+    spans_.push_back(span);
+  } else {
+    spans_[next_] = span;
+  }
+  next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<RpcSpan> RpcTracer::getSpans() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (spans_.size() < capacity_) {
+    return spans_;
+  }
+  std::vector<RpcSpan> spans;
+  spans.reserve(spans_.size());
+  spans.insert(spans.end(), spans_.begin() + next_, spans_.end());
+  spans.insert(spans.end(), spans_.begin(), spans_.begin() + next_);
+  return spans;
+}
+
+void RpcTracer::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  spans_.clear();
+  next_ = 0;
+}
+
+/*static */ int64_t RpcTracer::nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+RpcTraceContextGuard::RpcTraceContextGuard(RpcTraceContext context)
+    : prevContext_(RpcTracer::currentContext_) {
+  RpcTracer::currentContext_ = context;
+}
+
+RpcTraceContextGuard::~RpcTraceContextGuard() {
+  RpcTracer::currentContext_ = prevContext_;
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,124 @@
+#pragma once
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/distributed/rpc/types.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// The trace and the span which an RPC belongs to. Trace and span ids are
+// globally unique, the worker which created them is in their upper 16 bits.
+struct TORCH_API RpcTraceContext {
+  int64_t traceId;
+  int64_t spanId;
+};
+
+enum class RpcSpanKind : int8_t {
+  // From sending the request until its response arrives on the caller.
+  CLIENT = 0,
+  // From processing the request until its response is ready on the callee.
+  SERVER = 1,
+};
+
+// A timed part of a traced RPC. The time a request spends on the wire and in
+// the queues of the callee is the part of the client span not covered by its
+// server span.
+struct TORCH_API RpcSpan {
+  int64_t traceId;
+  int64_t spanId;
+  // -1 for the client span of the first RPC of a trace.
+  int64_t parentSpanId;
+  RpcSpanKind kind;
+  // Worker which recorded the span.
+  worker_id_t workerId;
+  // Callee of a client span, caller of a server span.
+  worker_id_t peerId;
+  // Type of the traced request, before it was wrapped for autograd and
+  // tracing.
+  MessageType messageType;
+  // Microseconds since the epoch of the system clock of the worker.
+  int64_t startUs;
+  int64_t endUs;
+  bool hasError;
+};
+
+// Records the spans of sampled RPCs into a bounded in-memory buffer, from
+// which they can be collected offline and merged across workers.
+//
+// Whether a trace is sampled is decided once on the worker issuing its first
+// RPC. The RPCs which are issued while a sampled request is processed carry
+// on its trace, so that the whole tree of nested RPCs is recorded. Only the
+// trace and span ids are sent along with a sampled request, and RPCs which
+// aren't sampled are not changed at all.
+class TORCH_API RpcTracer {
+ public:
+  // Retrieves the lazily-initialized RpcTracer singleton instance.
+  static RpcTracer& getInstance();
+
+  // Sets the fraction in [0, 1] of the RPCs starting a new trace which are
+  // sampled. Tracing is disabled with 0, the default.
+  void setSampleRate(double sampleRate);
+  double getSampleRate() const;
+  // Sets the number of spans kept, the oldest ones are dropped once it is
+  // reached. Clears the recorded spans.
+  void setCapacity(size_t capacity);
+
+  // Returns the context a new RPC from this thread should be traced in, if it
+  // is sampled. Its span id is the one of the new client span.
+  c10::optional<RpcTraceContext> startClientSpan(worker_id_t workerId);
+  // Returns a new span id for the server span of a traced request.
+  int64_t nextSpanId(worker_id_t workerId);
+  // Returns the worker which created the given trace or span id.
+  static worker_id_t creatorOf(int64_t id);
+  // Returns the context of the traced request processed by this thread.
+  static c10::optional<RpcTraceContext> currentContext();
+
+  void recordSpan(const RpcSpan& span);
+  // Returns the recorded spans, oldest first.
+  std::vector<RpcSpan> getSpans() const;
+  void clear();
+
+  // Microseconds since the epoch of the system clock, which is assumed to be
+  // roughly in sync across workers.
+  static int64_t nowUs();
+
+ private:
+  friend class RpcTraceContextGuard;
+
+  RpcTracer();
+  ~RpcTracer() = default;
+  RpcTracer(const RpcTracer& other) = delete;
+  RpcTracer operator=(const RpcTracer& other) = delete;
+  RpcTracer(RpcTracer&&) = delete;
+  RpcTracer& operator=(RpcTracer&&) = delete;
+
+  std::atomic<double> sampleRate_;
+  std::atomic<int64_t> nextLocalId_;
+  static thread_local c10::optional<RpcTraceContext> currentContext_;
+
+  mutable std::mutex mutex_;
+  // Ring buffer of the spans, next_ is where the next one goes.
+  std::vector<RpcSpan> spans_;
+  size_t capacity_;
+  size_t next_;
+};
+
+// Sets the trace context of the current thread during the processing of a
+// traced request, so that the RPCs it issues are part of the trace.
+class TORCH_API RpcTraceContextGuard {
+ public:
+  explicit RpcTraceContextGuard(RpcTraceContext context);
+  ~RpcTraceContextGuard();
+
+ private:
+  c10::optional<RpcTraceContext> prevContext_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
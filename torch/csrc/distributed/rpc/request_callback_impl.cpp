@@ -12,6 +12,7 @@
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_profiling_req.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_profiling_resp.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_tracing_req.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/profiler/server_process_global_profiler.h>
 #include <torch/csrc/distributed/rpc/python_call.h>
@@ -77,6 +78,17 @@ std::unique_ptr<RpcCommandBase> deserializePythonRpcCommandReference(
       }
       return nullptr;
     }
+    case MessageType::RUN_WITH_TRACING_REQ: {
+      // Deserialize wrapped RPC if it contains python call
+      auto& rpcWithTracingReq = static_cast<RpcWithTracingReq&>(rpc);
+      auto& wrappedRpc = rpcWithTracingReq.wrappedRpc();
+      auto pythonRpc = deserializePythonRpcCommandReference(
+          wrappedRpc, rpcWithTracingReq.wrappedMessageType());
+      if (pythonRpc) {
+        rpcWithTracingReq.setWrappedRpc(std::move(pythonRpc));
+      }
+      return nullptr;
+    }
     default: {
       return nullptr;
     }
@@ -6,8 +6,11 @@
 #include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_resp.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_tracing_req.h>
 #include <torch/csrc/distributed/autograd/utils.h>
+#include <torch/csrc/distributed/rpc/profiler/rpc_tracer.h>
 #include <torch/csrc/distributed/rpc/profiler/server_process_global_profiler.h>
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/rref_context.h>
 #include <torch/csrc/distributed/rpc/rref_proto.h>
 #include <torch/csrc/distributed/rpc/script_resp.h>
@@ -348,6 +351,16 @@ void RequestCallbackNoPython::processRpc(
       markComplete(std::move(RRefAck()).toMessage());
       return;
     }
+    case MessageType::RREF_USER_DELETE_BATCH: {
+      auto& rudb = static_cast<RRefUserDeleteBatch&>(rpc);
+      auto& ctx = RRefContext::getInstance();
+      for (const auto& del : rudb.deletes()) {
+        auto deletedRRef = ctx.delForkOfOwner(del.first, del.second);
+        handleRRefDelete(deletedRRef);
+      }
+      markComplete(std::move(RRefAck()).toMessage());
+      return;
+    }
     case MessageType::RREF_CHILD_ACCEPT: {
       auto& rca = static_cast<RRefChildAccept&>(rpc);
       auto& ctx = RRefContext::getInstance();
@@ -604,6 +617,54 @@ void RequestCallbackNoPython::processRpc(
       });
       return;
     }
+    case MessageType::RUN_WITH_TRACING_REQ: {
+      auto& rpcWithTracingReq = static_cast<RpcWithTracingReq&>(rpc);
+      const auto& clientContext = rpcWithTracingReq.traceContext();
+      auto& tracer = RpcTracer::getInstance();
+      auto workerId = RpcAgent::getCurrentRpcAgent()->getWorkerInfo().id_;
+      RpcSpan span;
+      span.traceId = clientContext.traceId;
+      span.spanId = tracer.nextSpanId(workerId);
+      span.parentSpanId = clientContext.spanId;
+      span.kind = RpcSpanKind::SERVER;
+      span.workerId = workerId;
+      span.peerId = RpcTracer::creatorOf(clientContext.spanId);
+      auto wrappedMsgType = rpcWithTracingReq.wrappedMessageType();
+      span.messageType = wrappedMsgType;
+      if (wrappedMsgType == MessageType::FORWARD_AUTOGRAD_REQ) {
+        span.messageType =
+            static_cast<RpcWithAutograd&>(rpcWithTracingReq.wrappedRpc())
+                .wrappedMessageType();
+      }
+      span.startUs = RpcTracer::nowUs();
+      span.hasError = false;
+
+      auto wrappedRpcResponseFuture = std::make_shared<FutureMessage>();
+      {
+        // The RPCs issued while processing the request are part of its trace.
+        RpcTraceContextGuard guard(RpcTraceContext{span.traceId, span.spanId});
+        processRpc(
+            rpcWithTracingReq.wrappedRpc(),
+            wrappedMsgType,
+            messageId,
+            wrappedRpcResponseFuture);
+      }
+      wrappedRpcResponseFuture->addCallback(
+          [wrappedRpcResponseFuture, responseFuture, span]() mutable {
+            span.endUs = RpcTracer::nowUs();
+            span.hasError = wrappedRpcResponseFuture->hasError();
+            RpcTracer::getInstance().recordSpan(span);
+            if (span.hasError) {
+              // Propagate error
+              responseFuture->setError(
+                  wrappedRpcResponseFuture->error()->what());
+            } else {
+              responseFuture->markCompleted(
+                  std::move(*wrappedRpcResponseFuture).moveValue());
+            }
+          });
+      return;
+    }
     default: {
       TORCH_INTERNAL_ASSERT(
           false, "Request type ", messageType, " not supported.");
@@ -207,16 +207,22 @@ void RRefContext::delUser(
     if (!destroyed_) {
       // Sending an RRefUserDelete causes the receiver to run delForkOfOwner,
       // which is now idempotent. See the comment at RRefContext::delForkOfOwner
-      // for more details.
+      // for more details. Queued deletes count as pending futures too, so
+      // that waiting for those to reach zero also waits for the queue.
       ++numPendingFutures_;
-      auto fm = agent_->sendWithRetries(
-          agent_->getWorkerInfo(owner),
-          RRefUserDelete(rrefId, forkId).toMessage());
-
-      fm->addCallback([this](const FutureMessage& fm) {
-        handleException(fm);
-        --numPendingFutures_;
-      });
+      std::vector<std::pair<RRefId, ForkId>> deletes;
+      {
+        std::lock_guard<std::mutex> deletesLock(userDeletesMutex_);
+        auto& pending = pendingUserDeletes_[owner];
+        pending.deletes.emplace_back(rrefId, forkId);
+        if (!pending.inFlight) {
+          pending.inFlight = true;
+          deletes.swap(pending.deletes);
+        }
+      }
+      if (!deletes.empty()) {
+        sendUserDeletes(owner, std::move(deletes));
+      }
     }
   }
 
@@ -224,6 +230,32 @@ void RRefContext::delUser(
   confirmedUsers_.erase(forkId);
 }
 
+void RRefContext::sendUserDeletes(
+    worker_id_t owner,
+    std::vector<std::pair<RRefId, ForkId>> deletes) {
+  const auto numDeletes = deletes.size();
+  auto fm = agent_->sendWithRetries(
+      agent_->getWorkerInfo(owner),
+      numDeletes == 1
+          ? RRefUserDelete(deletes[0].first, deletes[0].second).toMessage()
+          : RRefUserDeleteBatch(std::move(deletes)).toMessage());
+
+  fm->addCallback([this, owner, numDeletes](const FutureMessage& fm) {
+    std::vector<std::pair<RRefId, ForkId>> next;
+    {
+      std::lock_guard<std::mutex> lock(userDeletesMutex_);
+      auto& pending = pendingUserDeletes_[owner];
+      next.swap(pending.deletes);
+      pending.inFlight = !next.empty();
+    }
+    if (!next.empty()) {
+      sendUserDeletes(owner, std::move(next));
+    }
+    numPendingFutures_ -= static_cast<int64_t>(numDeletes);
+    handleException(fm);
+  });
+}
+
 void RRefContext::delAllUsersAndUnforkedOwners(
     std::chrono::milliseconds timeoutMillis) {
   // First, wait for all pending UserRRefs to be confirmed,
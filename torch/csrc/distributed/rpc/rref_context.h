@@ -234,6 +234,13 @@ class TORCH_API RRefContext {
 
   void finishForkRequest(const ForkId& forkId, worker_id_t parent);
 
+  // Sends the deletes to the owner, as an RRefUserDelete if there is only one
+  // of them. Once the owner acks, the deletes queued for it in the meantime
+  // are sent the same way.
+  void sendUserDeletes(
+      worker_id_t owner,
+      std::vector<std::pair<RRefId, ForkId>> deletes);
+
   // If there is any leak on any RRef, this method will throw an error.
   void checkRRefLeaks(bool ignoreRRefLeak);
 
@@ -304,6 +311,18 @@ class TORCH_API RRefContext {
   std::mutex destroyedMutex_;
   bool destroyed_;
 
+  // Deleting many UserRRefs, e.g. a list of them going out of scope, would
+  // otherwise send one RREF_USER_DELETE per RRef. At most one delete message
+  // is in flight per owner, the deletes that come in while it is are queued
+  // and sent as one RREF_USER_DELETE_BATCH once it is acked. A delete is thus
+  // never delayed when the owner is idle, and there is no timer to flush.
+  struct PendingUserDeletes {
+    bool inFlight{false};
+    std::vector<std::pair<RRefId, ForkId>> deletes;
+  };
+  std::mutex userDeletesMutex_;
+  std::unordered_map<worker_id_t, PendingUserDeletes> pendingUserDeletes_;
+
   // Thread local states to keep UserRRefs deserialized from user function
   // arguments.
   static thread_local std::vector<std::shared_ptr<PendingUserState>> userTable_;
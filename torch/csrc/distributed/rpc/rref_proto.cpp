@@ -161,6 +161,40 @@ std::unique_ptr<RRefUserDelete> RRefUserDelete::fromMessage(
       RRefUserDelete(pair.first, pair.second));
 }
 
+/////////////////////////// RRefUserDeleteBatch ////////////////////////////
+
+const std::vector<std::pair<RRefId, ForkId>>& RRefUserDeleteBatch::deletes()
+    const {
+  return deletes_;
+}
+
+Message RRefUserDeleteBatch::toMessageImpl() && {
+  std::vector<at::IValue> ivalues;
+  ivalues.reserve(2 * deletes_.size());
+  for (const auto& del : deletes_) {
+    ivalues.emplace_back(del.first.toIValue());
+    ivalues.emplace_back(del.second.toIValue());
+  }
+  return fromIValues(std::move(ivalues), MessageType::RREF_USER_DELETE_BATCH);
+}
+
+std::unique_ptr<RRefUserDeleteBatch> RRefUserDeleteBatch::fromMessage(
+    const Message& message) {
+  auto ivalues = toIValues(message, MessageType::RREF_USER_DELETE_BATCH);
+  TORCH_INTERNAL_ASSERT(
+      ivalues.size() % 2 == 0,
+      "RRefUserDeleteBatch expects an even number of IValues, got ",
+      ivalues.size());
+
+  std::vector<std::pair<RRefId, ForkId>> deletes;
+  deletes.reserve(ivalues.size() / 2);
+  for (size_t i = 0; i < ivalues.size(); i += 2) {
+    deletes.emplace_back(
+        RRefId::fromIValue(ivalues[i]), ForkId::fromIValue(ivalues[i + 1]));
+  }
+  return std::make_unique<RRefUserDeleteBatch>(std::move(deletes));
+}
+
 std::unique_ptr<RemoteRet> RemoteRet::fromMessage(const Message& message) {
   auto pair = ForkMessageBase::fromMessage(message, MessageType::REMOTE_RET);
   return std::make_unique<RemoteRet>(pair.first, pair.second);
@@ -123,6 +123,22 @@ class TORCH_API RRefUserDelete final : public ForkMessageBase {
   static std::unique_ptr<RRefUserDelete> fromMessage(const Message& message);
 };
 
+// The deletes a UserRRef context has queued for one owner while an earlier
+// RRefUserDelete to that owner was in flight, sent as one message.
+class TORCH_API RRefUserDeleteBatch final : public RpcCommandBase {
+ public:
+  explicit RRefUserDeleteBatch(std::vector<std::pair<RRefId, ForkId>> deletes)
+      : deletes_(std::move(deletes)) {}
+
+  const std::vector<std::pair<RRefId, ForkId>>& deletes() const;
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefUserDeleteBatch> fromMessage(
+      const Message& message);
+
+ private:
+  const std::vector<std::pair<RRefId, ForkId>> deletes_;
+};
+
 class TORCH_API RemoteRet final : public ForkMessageBase {
  public:
   RemoteRet(const RRefId& rrefId, const ForkId& forkId)
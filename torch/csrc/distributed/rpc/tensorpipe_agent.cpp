@@ -26,6 +26,10 @@ constexpr long kToMilliseconds = 1000;
 const std::string kGilAverageWaitTime = "agent.gil_average_wait_time_us";
 const std::string kThreadPoolSize = "agent.thread_pool_size";
 const std::string kNumIdleThreads = "agent.num_idle_threads";
+const std::string kPythonThreadPoolSize = "agent.python_thread_pool_size";
+const std::string kNumIdlePythonThreads = "agent.num_idle_python_threads";
+// Followed by the integer value of the MessageType of the requests.
+const std::string kRequestLatencyPrefix = "agent.request_latency_us.";
 const std::string kClientActiveCalls = "agent.client_active_calls";
 const std::string kServerActiveCalls = "agent.server_active_calls";
 const std::string kServerActiveAsyncCalls = "agent.server_active_async_calls";
@@ -70,6 +74,86 @@ std::vector<c10::DeviceIndex> getDevicesForTensors(
   }
 }
 
+// Batched requests are sent as one TensorPipe message holding the payloads
+// and the tensors of all of them, one after the other. Its metadata lists the
+// number of tensors of each request, a single request has no metadata.
+const std::string kBatchMetadataPrefix = "batch:";
+
+bool isBatch(const tensorpipe::Message& tpMessage) {
+  return tpMessage.metadata.compare(
+             0, kBatchMetadataPrefix.size(), kBatchMetadataPrefix) == 0;
+}
+
+tensorpipe::Message mergeTpMessages(
+    std::vector<tensorpipe::Message>&& tpMessages) {
+  if (tpMessages.size() == 1) {
+    return std::move(tpMessages[0]);
+  }
+  tensorpipe::Message merged;
+  merged.metadata = kBatchMetadataPrefix;
+  for (auto& tpMessage : tpMessages) {
+    merged.metadata.append(c10::to_string(tpMessage.tensors.size()))
+        .append(",");
+    for (auto& payload : tpMessage.payloads) {
+      merged.payloads.push_back(std::move(payload));
+    }
+    for (auto& tensor : tpMessage.tensors) {
+      merged.tensors.push_back(std::move(tensor));
+    }
+  }
+  return merged;
+}
+
+// The inverse of mergeTpMessages, the descriptors are copied.
+std::vector<tensorpipe::Message> splitTpMessage(
+    const tensorpipe::Message& tpMessage) {
+  std::vector<size_t> numTensors;
+  size_t pos = kBatchMetadataPrefix.size();
+  while (pos < tpMessage.metadata.size()) {
+    size_t end = tpMessage.metadata.find(',', pos);
+    TORCH_INTERNAL_ASSERT(
+        end != std::string::npos, "Malformed batch: ", tpMessage.metadata);
+    numTensors.push_back(
+        std::stoul(tpMessage.metadata.substr(pos, end - pos)));
+    pos = end + 1;
+  }
+  TORCH_INTERNAL_ASSERT(
+      !numTensors.empty() &&
+          tpMessage.payloads.size() % numTensors.size() == 0,
+      "Malformed batch of ",
+      numTensors.size(),
+      " messages with ",
+      tpMessage.payloads.size(),
+      " payloads");
+  const size_t numPayloads = tpMessage.payloads.size() / numTensors.size();
+
+  std::vector<tensorpipe::Message> tpMessages(numTensors.size());
+  auto payloadIt = tpMessage.payloads.begin();
+  auto tensorIt = tpMessage.tensors.begin();
+  for (size_t i = 0; i < numTensors.size(); ++i) {
+    tpMessages[i].payloads.assign(payloadIt, payloadIt + numPayloads);
+    payloadIt += numPayloads;
+    TORCH_INTERNAL_ASSERT(
+        static_cast<size_t>(tpMessage.tensors.end() - tensorIt) >=
+            numTensors[i],
+        "Malformed batch, not enough tensors");
+    tpMessages[i].tensors.assign(tensorIt, tensorIt + numTensors[i]);
+    tensorIt += numTensors[i];
+  }
+  TORCH_INTERNAL_ASSERT(
+      tensorIt == tpMessage.tensors.end(), "Malformed batch, too many tensors");
+  return tpMessages;
+}
+
+// What counts towards the byte cap of a batch.
+size_t messageBytes(const Message& message) {
+  size_t bytes = message.payload().size();
+  for (const auto& tensor : message.tensors()) {
+    bytes += tensor.numel() * tensor.element_size();
+  }
+  return bytes;
+}
+
 } // namespace
 
 C10_DEFINE_REGISTRY(TensorPipeTransportRegistry, TransportRegistration);
@@ -227,6 +311,30 @@ float TensorPipeAgent::TimeSeriesMetricsTracker::computeAverage() const {
   return currentCount_ == 0 ? 0 : currentSum_ / (float)currentCount_;
 }
 
+void TensorPipeAgent::LatencyHistogram::addData(uint64_t latencyUs) {
+  size_t bucket = 0;
+  while (bucket + 1 < kNumBuckets && (uint64_t(1) << bucket) <= latencyUs) {
+    ++bucket;
+  }
+  ++counts_[bucket];
+}
+
+std::string TensorPipeAgent::LatencyHistogram::toString() const {
+  std::string str;
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    if (counts_[bucket] == 0) {
+      continue;
+    }
+    if (!str.empty()) {
+      str += ",";
+    }
+    str += bucket + 1 < kNumBuckets ? c10::to_string(uint64_t(1) << bucket)
+                                    : std::string("inf");
+    str += ":" + c10::to_string(counts_[bucket]);
+  }
+  return str;
+}
+
 ////////////////////////  TensorpipeRpcAgent  /////////////////////////////////
 
 void TensorPipeAgent::collectNames() {
@@ -275,6 +383,7 @@ TensorPipeAgent::TensorPipeAgent(
               (long)(opts.rpcTimeoutSeconds * kToMilliseconds))),
       opts_(std::move(opts)),
       threadPool_(opts_.numWorkerThreads),
+      pythonThreadPool_(opts_.numWorkerThreads),
       context_(std::make_shared<tensorpipe::Context>(
           tensorpipe::ContextOptions().name(workerInfo_.name_))),
       rankToNameStore_("names", store),
@@ -406,35 +515,48 @@ void TensorPipeAgent::onListenerAccepted(
 
 void TensorPipeAgent::pipeRead(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
-    std::function<void(const tensorpipe::Error&, Message&&)> fn) {
+    std::function<void(const tensorpipe::Error&, std::vector<Message>&&)> fn) {
   pipe->readDescriptor([fn{std::move(fn)}, pipe](
                            const tensorpipe::Error& error,
                            tensorpipe::Message tpMessage) mutable {
     if (error) {
-      fn(error, Message());
+      fn(error, {});
       return;
     }
 
-    TensorpipeReadBuffers tpBuffers = tensorpipeAllocate(tpMessage);
+    auto tpMessages = std::make_shared<std::vector<tensorpipe::Message>>();
+    if (isBatch(tpMessage)) {
+      *tpMessages = splitTpMessage(tpMessage);
+    } else {
+      tpMessages->push_back(std::move(tpMessage));
+    }
+    auto tpBuffers = std::make_shared<std::vector<TensorpipeReadBuffers>>();
+    tpBuffers->reserve(tpMessages->size());
+    for (auto& part : *tpMessages) {
+      tpBuffers->push_back(tensorpipeAllocate(part));
+    }
 
     pipe->read(
-        std::move(tpMessage),
-        [tpBuffers{
-             std::make_shared<TensorpipeReadBuffers>(std::move(tpBuffers))},
-         fn{std::move(fn)}](
+        // The descriptors now point to the buffers.
+        mergeTpMessages(std::vector<tensorpipe::Message>(*tpMessages)),
+        [tpMessages, tpBuffers, fn{std::move(fn)}](
             const tensorpipe::Error& error,
-            tensorpipe::Message tpMessage) mutable {
+            tensorpipe::Message /* unused */) mutable {
           if (error) {
-            fn(error, Message());
+            fn(error, {});
             return;
           }
 
           // FIXME This does some unpickling, which could be a bit expensive:
           // perhaps it would be best to perform it inside the worker threads?
-          Message rpcMessage = tensorpipeDeserialize(
-              std::move(tpMessage), std::move(*tpBuffers));
+          std::vector<Message> rpcMessages;
+          rpcMessages.reserve(tpMessages->size());
+          for (size_t i = 0; i < tpMessages->size(); ++i) {
+            rpcMessages.push_back(tensorpipeDeserialize(
+                std::move((*tpMessages)[i]), std::move((*tpBuffers)[i])));
+          }
 
-          fn(error, std::move(rpcMessage));
+          fn(error, std::move(rpcMessages));
         });
   });
 }
@@ -443,21 +565,36 @@ void TensorPipeAgent::pipeWrite(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
     Message&& rpcMessage,
     std::function<void(const tensorpipe::Error&)> fn) {
-  tensorpipe::Message tpMessage;
-  TensorpipeWriteBuffers tpBuffers;
+  std::vector<Message> rpcMessages;
+  rpcMessages.push_back(std::move(rpcMessage));
+  pipeWrite(pipe, std::move(rpcMessages), std::move(fn));
+}
 
-  const auto& deviceMaps =
-      rpcMessage.isRequest() ? opts_.deviceMaps : reverseDeviceMaps_;
-  auto devices = getDevicesForTensors(
-      pipe->getRemoteName(), rpcMessage.tensors(), deviceMaps);
-  std::tie(tpMessage, tpBuffers) = tensorpipeSerialize(
-      std::move(rpcMessage), std::move(devices));
+void TensorPipeAgent::pipeWrite(
+    const std::shared_ptr<tensorpipe::Pipe>& pipe,
+    std::vector<Message>&& rpcMessages,
+    std::function<void(const tensorpipe::Error&)> fn) {
+  std::vector<tensorpipe::Message> tpMessages;
+  auto tpBuffers = std::make_shared<std::vector<TensorpipeWriteBuffers>>();
+  tpMessages.reserve(rpcMessages.size());
+  tpBuffers->reserve(rpcMessages.size());
+
+  for (auto& rpcMessage : rpcMessages) {
+    tensorpipe::Message tpMessage;
+    TensorpipeWriteBuffers buffers;
+    const auto& deviceMaps =
+        rpcMessage.isRequest() ? opts_.deviceMaps : reverseDeviceMaps_;
+    auto devices = getDevicesForTensors(
+        pipe->getRemoteName(), rpcMessage.tensors(), deviceMaps);
+    std::tie(tpMessage, buffers) =
+        tensorpipeSerialize(std::move(rpcMessage), std::move(devices));
+    tpMessages.push_back(std::move(tpMessage));
+    tpBuffers->push_back(std::move(buffers));
+  }
 
   pipe->write(
-      std::move(tpMessage),
-      [tpBuffers{
-           std::make_shared<TensorpipeWriteBuffers>(std::move(tpBuffers))},
-       fn{std::move(fn)}](
+      mergeTpMessages(std::move(tpMessages)),
+      [tpBuffers, fn{std::move(fn)}](
           const tensorpipe::Error& error, tensorpipe::Message /* unused */) {
         fn(error);
       });
@@ -563,7 +700,8 @@ void TensorPipeAgent::respond(std::shared_ptr<tensorpipe::Pipe>& pipe) {
   pipeRead(
       pipe,
       [this, pipe](
-          const tensorpipe::Error& error, Message&& requestMessage) mutable {
+          const tensorpipe::Error& error,
+          std::vector<Message>&& requestMessages) mutable {
         if (error) {
           // FIXME This is not a correct way to check whether this error was
           // "intentionally" caused by the remote end shutting down. We should
@@ -585,51 +723,69 @@ void TensorPipeAgent::respond(std::shared_ptr<tensorpipe::Pipe>& pipe) {
         // Arm for next read
         respond(pipe);
 
-        uint64_t messageId = requestMessage.id();
-        increaseCallCount(serverActiveCalls_);
+        // A batch of requests is handled as if they had come one by one.
+        for (auto& requestMessage : requestMessages) {
+          uint64_t messageId = requestMessage.id();
+          increaseCallCount(serverActiveCalls_);
 
-        VLOG(1) << "RPC agent for " << workerInfo_.name_
-                << " received request #" << messageId << " from "
-                << pipe->getRemoteName();
-
-        // Defer user RPC UDF run to thread pool
-        threadPool_.run([this,
-                         pipe,
-                         messageId,
-                         requestMessage{std::move(requestMessage)}]() mutable {
           VLOG(1) << "RPC agent for " << workerInfo_.name_
-                  << " is running request #" << messageId << " from "
-                  << pipe->getRemoteName() << " in thread pool";
-
-          std::shared_ptr<FutureMessage> futureResponseMessage;
-          try {
-            futureResponseMessage = cb_->operator()(requestMessage);
-          } catch (const std::exception& e) {
-            futureResponseMessage = std::make_shared<FutureMessage>();
-            futureResponseMessage->setError(e.what());
-          }
-
-          // Shortcut if immediately done
-          if (futureResponseMessage->completed()) {
-            decreaseCallCount(serverActiveCalls_);
-            sendCompletedResponseMessage(
-                pipe, futureResponseMessage, messageId);
-          } else {
-            // Not complete yet
-            increaseCallCount(serverActiveAsyncCalls_);
-            futureResponseMessage->addCallback(
-                [this, pipe, futureResponseMessage, messageId]() mutable {
-                  decreaseCallCount(serverActiveCalls_);
-                  decreaseCallCount(serverActiveAsyncCalls_);
-                  sendCompletedResponseMessage(
-                      pipe, futureResponseMessage, messageId);
-                });
-          }
-
-          VLOG(1) << "RPC agent for " << workerInfo_.name_
-                  << " done running request #" << messageId << " from "
-                  << pipe->getRemoteName() << " in thread pool";
-        });
+                  << " received request #" << messageId << " from "
+                  << pipe->getRemoteName();
+
+          const auto requestType = requestMessage.type();
+          const auto startTime = std::chrono::steady_clock::now();
+          const bool holdsGil = requestType == MessageType::PYTHON_CALL ||
+              requestType == MessageType::PYTHON_REMOTE_CALL ||
+              requestType == MessageType::PYTHON_RREF_FETCH_CALL;
+
+          // Defer user RPC UDF run to thread pool
+          auto& pool = holdsGil ? pythonThreadPool_ : threadPool_;
+          pool.run([this,
+                    pipe,
+                    messageId,
+                    requestType,
+                    startTime,
+                    requestMessage{std::move(requestMessage)}]() mutable {
+            VLOG(1) << "RPC agent for " << workerInfo_.name_
+                    << " is running request #" << messageId << " from "
+                    << pipe->getRemoteName() << " in thread pool";
+
+            std::shared_ptr<FutureMessage> futureResponseMessage;
+            try {
+              futureResponseMessage = cb_->operator()(requestMessage);
+            } catch (const std::exception& e) {
+              futureResponseMessage = std::make_shared<FutureMessage>();
+              futureResponseMessage->setError(e.what());
+            }
+
+            // Shortcut if immediately done
+            if (futureResponseMessage->completed()) {
+              decreaseCallCount(serverActiveCalls_);
+              recordRequestLatency(requestType, startTime);
+              sendCompletedResponseMessage(
+                  pipe, futureResponseMessage, messageId);
+            } else {
+              // Not complete yet
+              increaseCallCount(serverActiveAsyncCalls_);
+              futureResponseMessage->addCallback([this,
+                                                  pipe,
+                                                  futureResponseMessage,
+                                                  messageId,
+                                                  requestType,
+                                                  startTime]() mutable {
+                decreaseCallCount(serverActiveCalls_);
+                decreaseCallCount(serverActiveAsyncCalls_);
+                recordRequestLatency(requestType, startTime);
+                sendCompletedResponseMessage(
+                    pipe, futureResponseMessage, messageId);
+              });
+            }
+
+            VLOG(1) << "RPC agent for " << workerInfo_.name_
+                    << " done running request #" << messageId << " from "
+                    << pipe->getRemoteName() << " in thread pool";
+          });
+        }
       });
 }
 
@@ -706,103 +862,165 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
   VLOG(1) << "RPC agent for " << workerInfo_.name_ << " is sending request #"
           << messageId << " to " << clientPipe.pipe_->getRemoteName();
 
-  pipeWrite(
+  std::vector<Message> requests;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (opts_.maxBatchBytes > 0 && clientPipe.writesInFlight_ > 0) {
+      // Requests queue up while a write to the worker is in flight and go out
+      // together once it completes, or once they reach the byte cap. An idle
+      // pipe does not delay any request. Tensors that cannot be sent fail
+      // here rather than when the batch is written.
+      getDevicesForTensors(
+          toWorkerInfo.name_, requestMessage.tensors(), opts_.deviceMaps);
+      clientPipe.pendingWriteBytes_ += messageBytes(requestMessage);
+      clientPipe.pendingWrites_.push_back(std::move(requestMessage));
+      if (clientPipe.pendingWriteBytes_ < opts_.maxBatchBytes) {
+        return std::shared_ptr<FutureMessage>(
+            futureResponseMessage, &futureResponseMessage->futMsg);
+      }
+      std::swap(requests, clientPipe.pendingWrites_);
+      clientPipe.pendingWriteBytes_ = 0;
+    } else {
+      requests.push_back(std::move(requestMessage));
+    }
+    ++clientPipe.writesInFlight_;
+  }
+  writeRequests(clientPipe, std::move(requests));
+
+  return std::shared_ptr<FutureMessage>(
+      futureResponseMessage, &futureResponseMessage->futMsg);
+}
+
+void TensorPipeAgent::writeRequests(
+    ClientPipe& clientPipe,
+    std::vector<Message>&& requests) {
+  std::vector<uint64_t> messageIds;
+  messageIds.reserve(requests.size());
+  for (const auto& request : requests) {
+    messageIds.push_back(request.id());
+  }
+
+  auto onWritten = [this, &clientPipe, messageIds](
+                       const tensorpipe::Error& error) mutable {
+    for (uint64_t messageId : messageIds) {
+      if (error) {
+        if (error.isOfType<tensorpipe::PipeClosedError>() &&
+            !rpcAgentRunning_.load()) {
+          // This is expected.
+        } else {
+          LOG(WARNING) << "RPC agent for " << workerInfo_.name_
+                       << " encountered error when sending outgoing request #"
+                       << messageId << " to "
+                       << clientPipe.pipe_->getRemoteName() << ": "
+                       << error.what();
+        }
+        auto pendingFutIt = clientPipe.pendingResponseMessage_.find(messageId);
+        if (pendingFutIt != clientPipe.pendingResponseMessage_.end()) {
+          markFutureWithError(pendingFutIt->second, error.what());
+        }
+        continue;
+      }
+
+      VLOG(1) << "RPC agent for " << workerInfo_.name_ << " sent request #"
+              << messageId << " to " << clientPipe.pipe_->getRemoteName();
+
+      readResponse(clientPipe);
+    }
+
+    // The requests that queued up during the write are sent together.
+    std::vector<Message> pendingWrites;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (clientPipe.pendingWrites_.empty()) {
+        --clientPipe.writesInFlight_;
+        return;
+      }
+      std::swap(pendingWrites, clientPipe.pendingWrites_);
+      clientPipe.pendingWriteBytes_ = 0;
+    }
+    writeRequests(clientPipe, std::move(pendingWrites));
+  };
+
+  try {
+    pipeWrite(clientPipe.pipe_, std::move(requests), std::move(onWritten));
+  } catch (const std::exception&) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --clientPipe.writesInFlight_;
+    throw;
+  }
+}
+
+void TensorPipeAgent::readResponse(ClientPipe& clientPipe) {
+  pipeRead(
       clientPipe.pipe_,
-      std::move(requestMessage),
-      [this, &clientPipe, messageId](const tensorpipe::Error& error) mutable {
+      [this, &clientPipe](
+          const tensorpipe::Error& error,
+          std::vector<Message>&& responseMessages) {
         if (error) {
           if (error.isOfType<tensorpipe::PipeClosedError>() &&
               !rpcAgentRunning_.load()) {
             // This is expected.
           } else {
-            LOG(WARNING) << "RPC agent for " << workerInfo_.name_
-                         << " encountered error when sending outgoing request #"
-                         << messageId << " to "
-                         << clientPipe.pipe_->getRemoteName() << ": "
-                         << error.what();
+            LOG(WARNING)
+                << "RPC agent for " << workerInfo_.name_
+                << " encountered error when reading incoming response from "
+                << clientPipe.pipe_->getRemoteName() << ": " << error.what();
           }
-          auto pendingFutIt =
-              clientPipe.pendingResponseMessage_.find(messageId);
-          if (pendingFutIt != clientPipe.pendingResponseMessage_.end()) {
-            markFutureWithError(pendingFutIt->second, error.what());
+          // We may get garbage content in responseMessage upon error.
+          // Flushing all future messages belonging to this pipe due to
+          // error state.
+          decltype(clientPipe.pendingResponseMessage_) pendingMsgs;
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(clientPipe.pendingResponseMessage_, pendingMsgs);
+            clientPipe.readError_ = true;
+          }
+          std::string errorMsg = error.what();
+          for (auto& p : pendingMsgs) {
+            markFutureWithError(std::move(p.second), errorMsg);
           }
           return;
         }
 
-        VLOG(1) << "RPC agent for " << workerInfo_.name_ << " sent request #"
-                << messageId << " to " << clientPipe.pipe_->getRemoteName();
-
-        pipeRead(
-            clientPipe.pipe_,
-            [this, &clientPipe](
-                const tensorpipe::Error& error, Message&& responseMessage) {
-              if (error) {
-                if (error.isOfType<tensorpipe::PipeClosedError>() &&
-                    !rpcAgentRunning_.load()) {
-                  // This is expected.
-                } else {
-                  LOG(WARNING)
-                      << "RPC agent for " << workerInfo_.name_
-                      << " encountered error when reading incoming response from "
-                      << clientPipe.pipe_->getRemoteName() << ": "
-                      << error.what();
-                }
-                // We may get garbage content in responseMessage upon error.
-                // Flushing all future messages belonging to this pipe due to
-                // error state.
-                decltype(clientPipe.pendingResponseMessage_) pendingMsgs;
-                {
-                  std::lock_guard<std::mutex> lock(mutex_);
-                  std::swap(clientPipe.pendingResponseMessage_, pendingMsgs);
-                  clientPipe.readError_ = true;
-                }
-                std::string errorMsg = error.what();
-                for (auto& p : pendingMsgs) {
-                  markFutureWithError(std::move(p.second), errorMsg);
-                }
-                return;
-              }
-
-              // Identify future response message by message ID
-              uint64_t messageId = responseMessage.id();
-
-              VLOG(1) << "RPC agent for " << workerInfo_.name_
-                      << " received response #" << messageId << " from "
-                      << clientPipe.pipe_->getRemoteName();
-
-              std::shared_ptr<AtomicFutureMessage> futureResponseMessage;
-              {
-                std::lock_guard<std::mutex> lock(mutex_);
-                // A read error will lead all following callbacks to be
-                // invoked with error, and shouldn't reach here.
-                TORCH_INTERNAL_ASSERT(
-                    !clientPipe.readError_, "Shouldn't in error state");
-                auto it = clientPipe.pendingResponseMessage_.find(messageId);
-                TORCH_INTERNAL_ASSERT(
-                    it != clientPipe.pendingResponseMessage_.end(),
-                    "message ID ",
-                    messageId,
-                    " is not recognized");
-                futureResponseMessage = std::move(it->second);
-                clientPipe.pendingResponseMessage_.erase(it);
-              }
-
-              if (responseMessage.type() == MessageType::EXCEPTION) {
-                markFutureWithError(
-                    std::move(futureResponseMessage),
-                    std::string(
-                        responseMessage.payload().begin(),
-                        responseMessage.payload().end()));
-              } else {
-                markFutureAsComplete(
-                    std::move(futureResponseMessage),
-                    std::move(responseMessage));
-              }
-            });
-      });
+        // Responses are not batched.
+        TORCH_INTERNAL_ASSERT(responseMessages.size() == 1);
+        Message& responseMessage = responseMessages[0];
 
-  return std::shared_ptr<FutureMessage>(
-      futureResponseMessage, &futureResponseMessage->futMsg);
+        // Identify future response message by message ID
+        uint64_t messageId = responseMessage.id();
+
+        VLOG(1) << "RPC agent for " << workerInfo_.name_
+                << " received response #" << messageId << " from "
+                << clientPipe.pipe_->getRemoteName();
+
+        std::shared_ptr<AtomicFutureMessage> futureResponseMessage;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          // A read error will lead all following callbacks to be
+          // invoked with error, and shouldn't reach here.
+          TORCH_INTERNAL_ASSERT(
+              !clientPipe.readError_, "Shouldn't in error state");
+          auto it = clientPipe.pendingResponseMessage_.find(messageId);
+          TORCH_INTERNAL_ASSERT(
+              it != clientPipe.pendingResponseMessage_.end(),
+              "message ID ",
+              messageId,
+              " is not recognized");
+          futureResponseMessage = std::move(it->second);
+          clientPipe.pendingResponseMessage_.erase(it);
+        }
+
+        if (responseMessage.type() == MessageType::EXCEPTION) {
+          markFutureWithError(
+              std::move(futureResponseMessage),
+              std::string(
+                  responseMessage.payload().begin(),
+                  responseMessage.payload().end()));
+        } else {
+          markFutureAsComplete(
+              std::move(futureResponseMessage), std::move(responseMessage));
+        }
+      });
 }
 
 void TensorPipeAgent::pollTimeoutRpcs() {
@@ -933,6 +1151,7 @@ void TensorPipeAgent::shutdownImpl() {
   // additional work could be added after this call and before we shutdown
   // listeners. This work would continue executing in the threadpool and might
   // cause issues during shutdown of the system.
+  pythonThreadPool_.waitWorkComplete();
   threadPool_.waitWorkComplete();
   VLOG(1) << "RPC agent for " << workerInfo_.name_
           << " done waiting for thread pool to complete work";
@@ -973,12 +1192,22 @@ std::unordered_map<std::string, std::string> TensorPipeAgent::getMetrics() {
   std::unordered_map<std::string, std::string> metrics;
   metrics[kThreadPoolSize] = c10::to_string(threadPool_.size());
   metrics[kNumIdleThreads] = c10::to_string(threadPool_.numAvailable());
+  metrics[kPythonThreadPoolSize] = c10::to_string(pythonThreadPool_.size());
+  metrics[kNumIdlePythonThreads] =
+      c10::to_string(pythonThreadPool_.numAvailable());
   {
     std::unique_lock<std::mutex> lock(callCountMutex_);
     metrics[kClientActiveCalls] = c10::to_string(clientActiveCalls_);
     metrics[kServerActiveCalls] = c10::to_string(serverActiveCalls_);
     metrics[kServerActiveAsyncCalls] = c10::to_string(serverActiveAsyncCalls_);
   }
+  {
+    std::lock_guard<std::mutex> lock(metricsMutex_);
+    for (const auto& entry : requestLatencies_) {
+      metrics[kRequestLatencyPrefix + c10::to_string(entry.first)] =
+          entry.second.toString();
+    }
+  }
   if (isGILProfilingEnabled()) {
     {
       std::unique_lock<std::mutex> lock(metricsMutex_);
@@ -994,6 +1223,15 @@ std::unordered_map<std::string, std::string> TensorPipeAgent::getMetrics() {
   return metrics;
 }
 
+void TensorPipeAgent::recordRequestLatency(
+    MessageType type,
+    std::chrono::steady_clock::time_point startTime) {
+  const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startTime);
+  std::lock_guard<std::mutex> lock(metricsMutex_);
+  requestLatencies_[static_cast<int>(type)].addData(latency.count());
+}
+
 void TensorPipeAgent::addGilWaitTime(
     const std::chrono::microseconds gilWaitTime) {
   std::lock_guard<std::mutex> lock(metricsMutex_);
@@ -2,6 +2,7 @@
 
 #ifdef USE_TENSORPIPE
 
+#include <array>
 #include <atomic>
 #include <thread>
 
@@ -68,12 +69,14 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
       optional<std::vector<std::string>> channels,
       float rpc_timeout,
       std::string init_method,
-      std::unordered_map<std::string, tensorpipe::DeviceMap> device_maps = {})
+      std::unordered_map<std::string, tensorpipe::DeviceMap> device_maps = {},
+      size_t max_batch_bytes = 0)
       : RpcBackendOptions(rpc_timeout, init_method),
         numWorkerThreads(numWorkerThreads),
         transports(std::move(transports)),
         channels(std::move(channels)),
-        deviceMaps(std::move(device_maps)) {
+        deviceMaps(std::move(device_maps)),
+        maxBatchBytes(max_batch_bytes) {
     TORCH_CHECK(
         numWorkerThreads > 0,
         "num_worker_threads must be positive, got ",
@@ -115,6 +118,10 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
   const optional<std::vector<std::string>> transports;
   const optional<std::vector<std::string>> channels;
   std::unordered_map<std::string, tensorpipe::DeviceMap> deviceMaps;
+  // When positive, the requests to a worker that are issued while a write to
+  // it is in flight are sent as one TensorPipe message once it completes, or
+  // as soon as they add up to this many bytes. Zero disables batching.
+  size_t maxBatchBytes;
 };
 
 // Struct to track the network source metrics
@@ -195,9 +202,10 @@ class TensorPipeAgent : public RpcAgent {
 
   // TensorPipe read function that could be used to read response messages
   // by client, and read request messages by server.
+  // A batch of requests is read as a whole.
   void pipeRead(
       const std::shared_ptr<tensorpipe::Pipe>&,
-      std::function<void(const tensorpipe::Error&, Message&&)>);
+      std::function<void(const tensorpipe::Error&, std::vector<Message>&&)>);
 
   // TensorPipe write function that could be used to write response
   // messages by server, and write request messages by client.
@@ -206,6 +214,12 @@ class TensorPipeAgent : public RpcAgent {
       Message&& message,
       std::function<void(const tensorpipe::Error&)>);
 
+  // Writes several messages as a single batch, which pipeRead splits up.
+  void pipeWrite(
+      const std::shared_ptr<tensorpipe::Pipe>&,
+      std::vector<Message>&& messages,
+      std::function<void(const tensorpipe::Error&)>);
+
   // Callback of listener accept()
   void onListenerAccepted(
       const tensorpipe::Error& error,
@@ -253,12 +267,28 @@ class TensorPipeAgent : public RpcAgent {
     // Map from Message Request ID's to corresponding futures.
     std::unordered_map<uint64_t, std::shared_ptr<AtomicFutureMessage>>
         pendingResponseMessage_;
+    // The requests waiting for a write to complete to be sent as a batch, see
+    // TensorPipeRpcBackendOptions::maxBatchBytes. Protected by mutex_ too.
+    size_t writesInFlight_{0};
+    std::vector<Message> pendingWrites_;
+    size_t pendingWriteBytes_{0};
   };
 
+  // Writes the requests and, once that is done, reads their responses and
+  // writes the requests that queued up in the meantime.
+  void writeRequests(ClientPipe& clientPipe, std::vector<Message>&& requests);
+
+  // Reads the response to one request.
+  void readResponse(ClientPipe& clientPipe);
+
   const TensorPipeRpcBackendOptions opts_;
   std::unordered_map<std::string, tensorpipe::DeviceMap> reverseDeviceMaps_;
 
   ThreadPool threadPool_;
+  // Runs the requests whose handlers hold the GIL, so that TorchScript and
+  // builtin calls don't queue up behind them in threadPool_. It has as many
+  // threads as threadPool_, as Python UDFs may block on nested RPCs.
+  ThreadPool pythonThreadPool_;
   std::shared_ptr<tensorpipe::Context> context_;
   std::shared_ptr<tensorpipe::Listener> listener_;
   std::unordered_map<worker_id_t, ClientPipe> connectedPipes_;
@@ -331,9 +361,28 @@ class TensorPipeAgent : public RpcAgent {
     float computeAverage() const;
   };
 
+  // Histogram of the time it takes to respond to requests, from when they
+  // are read to when their response is ready. Bucket i counts the latencies
+  // in [2^(i-1), 2^i) microseconds, the last one counts all the longer ones.
+  struct LatencyHistogram {
+    static constexpr size_t kNumBuckets = 32;
+    std::array<uint64_t, kNumBuckets> counts_{};
+
+    void addData(uint64_t latencyUs);
+    // Comma-separated "<bucket upper bound in us>:<count>" pairs of the
+    // non-empty buckets, "inf" being the bound of the last one.
+    std::string toString() const;
+  };
+
+  void recordRequestLatency(
+      MessageType type,
+      std::chrono::steady_clock::time_point startTime);
+
   // Map of Time-Series metrics tracked by the RPC Agent
   std::unordered_map<std::string, TimeSeriesMetricsTracker> timeSeriesMetrics_;
-  // Mutex to guard timeSeriesMetrics_
+  // Latencies of the requests handled by this agent, per message type.
+  std::unordered_map<int, LatencyHistogram> requestLatencies_;
+  // Mutex to guard timeSeriesMetrics_ and requestLatencies_
   std::mutex metricsMutex_;
 
   // Map to Track Network Data
@@ -9,6 +9,7 @@
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_profiling_req.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_profiling_resp.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_tracing_req.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/profiler/remote_profiler_manager.h>
 #include <torch/csrc/distributed/rpc/python_call.h>
@@ -22,6 +23,7 @@
 #include <torch/csrc/jit/serialization/unpickler.h>
 
 #ifdef USE_TENSORPIPE
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <tensorpipe/core/message.h>
 #endif
 
@@ -128,6 +130,9 @@ std::unique_ptr<RpcCommandBase> deserializeRequest(const Message& request) {
     case MessageType::RREF_USER_DELETE: {
       return RRefUserDelete::fromMessage(request);
     }
+    case MessageType::RREF_USER_DELETE_BATCH: {
+      return RRefUserDeleteBatch::fromMessage(request);
+    }
     case MessageType::RREF_CHILD_ACCEPT: {
       return RRefChildAccept::fromMessage(request);
     }
@@ -146,6 +151,9 @@ std::unique_ptr<RpcCommandBase> deserializeRequest(const Message& request) {
     case MessageType::RUN_WITH_PROFILING_REQ: {
       return autograd::RpcWithProfilingReq::fromMessage(request);
     }
+    case MessageType::RUN_WITH_TRACING_REQ: {
+      return autograd::RpcWithTracingReq::fromMessage(request);
+    }
     default: {
       TORCH_INTERNAL_ASSERT(
           false, "Request type ", request.type(), " not supported.");
@@ -256,6 +264,9 @@ namespace {
 //    - "payload" - the payload bits
 //    - "meta"    - metadata for the unpickler
 //    - "0" ...   - tensor sections for the unpickler
+//    - "pad0" ... - zeros placed before the tensor sections, so that they
+//                   start at a multiple of kWireAlignment from the start of
+//                   the buffer and can be used in place by the receiver
 //
 // Note that per the header comments, the format is subject to change,
 // and is best used for rpcs, rather than persistent disk storage.
@@ -313,6 +324,83 @@ parseWireSections(const void* data, size_t data_size) {
 
 static const char* kMeta = "meta";
 static const char* kPayload = "payload";
+static const char* kPad = "pad";
+
+// Same as the alignment of the CPU allocator, the buffers the agents receive
+// into are allocated with it.
+constexpr size_t kWireAlignment = 64;
+// The sizes of the pad sections always take two digits in the header, the
+// header does not change size when they are filled in.
+static_assert(kWireAlignment <= 100, "pad sizes must fit in two digits");
+const char kZeros[kWireAlignment] = {};
+
+void deleteWireBuffer(void* ctx) {
+  delete static_cast<at::Tensor*>(ctx);
+}
+
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserializeImpl(
+    const void* data,
+    size_t data_size,
+    const at::Tensor* wire) {
+  auto sections = parseWireSections(data, data_size);
+
+  std::vector<char> payload;
+  auto payloadIt = sections.find(kPayload);
+  if (payloadIt != sections.end() && payloadIt->second.second != 0) {
+    payload.assign(
+        payloadIt->second.first,
+        payloadIt->second.first + payloadIt->second.second);
+  }
+
+  std::vector<at::Tensor> tensors;
+  auto metaIt = sections.find(kMeta);
+  if (metaIt != sections.end()) {
+    const auto& metaData = metaIt->second;
+    size_t metaDataPos = 0;
+    auto metaDataReadFunc = [&](char* buf, size_t n) -> size_t {
+      if (metaDataPos >= metaData.second || n == 0) {
+        return 0;
+      }
+      size_t toCopy = std::min(metaDataPos + n, metaData.second) - metaDataPos;
+      memcpy(buf, metaData.first + metaDataPos, toCopy);
+      metaDataPos += toCopy;
+      return toCopy;
+    };
+    auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
+      auto it = sections.find(ename);
+      if (it == sections.end()) {
+        throw std::runtime_error("Couldn't find entity " + ename);
+      }
+      const auto& idat = it->second;
+      // The tensor is a view of the wire buffer, which it keeps alive.
+      if (wire != nullptr && idat.second != 0 &&
+          reinterpret_cast<uintptr_t>(idat.first) % kWireAlignment == 0) {
+        return at::DataPtr(
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            const_cast<char*>(idat.first),
+            new at::Tensor(*wire),
+            &deleteWireBuffer,
+            at::Device(at::kCPU));
+      }
+      auto dptr = at::getCPUAllocator()->allocate(idat.second);
+      if (idat.second != 0) {
+        memcpy(dptr.get(), idat.first, idat.second);
+      }
+      return dptr;
+    };
+
+    // No need to pass typeResolver here, as it always processes string and
+    // tensors only
+    torch::jit::Unpickler unpickler(
+        metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
+    auto ival = unpickler.parse_ivalue();
+    for (auto&& t : ival.toTensorList()) {
+      tensors.emplace_back(std::move(t));
+    }
+  }
+  return {std::move(payload), std::move(tensors)};
+}
+
 }; // namespace
 
 c10::List<at::Tensor> cloneSparseTensors(
@@ -383,25 +471,37 @@ std::string wireSerialize(
       // converts CUDA tensor to cpu and data() might get destructed as we go
       // out of scope of this loop.
       auto writeableTensorData = jit::getWriteableTensorData(tensorData[i]);
+      entries.push_back({kPad + c10::to_string(i), kZeros, 0});
       entries.push_back({c10::to_string(i),
                          writeableTensorData.data(),
                          writeableTensorData.sizeInBytes()});
     }
   }
 
-  std::string header;
-  size_t tot = 0;
-  for (const auto& e : entries) {
+  auto makeHeader = [&entries]() {
+    std::string header;
+    for (const auto& e : entries) {
+      header.append(e.name).append(" ");
+      if (e.data == kZeros && e.size < 10) {
+        header.push_back('0');
+      }
+      header.append(c10::to_string(e.size)).append("\n");
+    }
+    header.push_back('\n');
+    return header;
+  };
+  // The header has the same size once the pads are filled in.
+  size_t tot = makeHeader().size();
+  for (auto& e : entries) {
+    if (e.data == kZeros) {
+      e.size = (kWireAlignment - tot % kWireAlignment) % kWireAlignment;
+    }
     tot += e.size;
-    header.append(e.name)
-        .append(" ")
-        .append(c10::to_string(e.size))
-        .append("\n");
   }
-  header.push_back('\n');
+  std::string header = makeHeader();
 
   std::string out;
-  out.reserve(header.size() + tot);
+  out.reserve(tot);
   out.append(header);
   for (const auto& e : entries) {
     out.append(e.data, e.size);
@@ -412,53 +512,12 @@ std::string wireSerialize(
 std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size) {
-  auto sections = parseWireSections(data, data_size);
-
-  std::vector<char> payload;
-  auto payloadIt = sections.find(kPayload);
-  if (payloadIt != sections.end() && payloadIt->second.second != 0) {
-    payload.assign(
-        payloadIt->second.first,
-        payloadIt->second.first + payloadIt->second.second);
-  }
-
-  std::vector<at::Tensor> tensors;
-  auto metaIt = sections.find(kMeta);
-  if (metaIt != sections.end()) {
-    const auto& metaData = metaIt->second;
-    size_t metaDataPos = 0;
-    auto metaDataReadFunc = [&](char* buf, size_t n) -> size_t {
-      if (metaDataPos >= metaData.second || n == 0) {
-        return 0;
-      }
-      size_t toCopy = std::min(metaDataPos + n, metaData.second) - metaDataPos;
-      memcpy(buf, metaData.first + metaDataPos, toCopy);
-      metaDataPos += toCopy;
-      return toCopy;
-    };
-    auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
-      auto it = sections.find(ename);
-      if (it == sections.end()) {
-        throw std::runtime_error("Couldn't find entity " + ename);
-      }
-      const auto& idat = it->second;
-      auto dptr = at::getCPUAllocator()->allocate(idat.second);
-      if (idat.second != 0) {
-        memcpy(dptr.get(), idat.first, idat.second);
-      }
-      return dptr;
-    };
+  return wireDeserializeImpl(data, data_size, nullptr);
+}
 
-    // No need to pass typeResolver here, as it always processes string and
-    // tensors only
-    torch::jit::Unpickler unpickler(
-        metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
-    auto ival = unpickler.parse_ivalue();
-    for (auto&& t : ival.toTensorList()) {
-      tensors.emplace_back(std::move(t));
-    }
-  }
-  return {std::move(payload), std::move(tensors)};
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
+    const at::Tensor& wire) {
+  return wireDeserializeImpl(wire.data_ptr(), wire.nbytes(), &wire);
 }
 
 #ifdef USE_TENSORPIPE
@@ -480,6 +539,22 @@ constexpr int kTpMessageDevicesIdx = 3;
 // stored as, well, tensors in the tensorpipe::Message).
 constexpr int kTpMessagePickleIdx = 4;
 
+// The TensorPipe version we use only moves host memory, so GPU tensors still
+// go through the host. Copies between a GPU and pinned memory are DMA
+// transfers, whereas copies from or to pageable memory are staged by the CUDA
+// driver through a pinned buffer of its own, hence the extra copy is avoided
+// by staging the tensors in pinned memory on both ends.
+torch::Tensor toPinnedCPU(const torch::Tensor& tensor) {
+  if (tensor.device().is_cpu() || tensor.is_sparse()) {
+    return tensor.cpu();
+  }
+  auto pinned = at::empty(
+      tensor.sizes(),
+      tensor.options().device(at::kCPU).pinned_memory(true));
+  pinned.copy_(tensor);
+  return pinned;
+}
+
 } // namespace
 
 std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
@@ -523,7 +598,7 @@ std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
     std::vector<torch::Tensor> tensors;
     tensors.reserve(rpcMessage.tensors().size());
     for (const auto& tensor : rpcMessage.tensors()) {
-      tensors.emplace_back(tensor.cpu());
+      tensors.emplace_back(toPinnedCPU(tensor));
     }
     buffers.tensors = cloneSparseTensors(tensors).vec();
   }
@@ -612,8 +687,14 @@ TensorpipeReadBuffers tensorpipeAllocate(tensorpipe::Message& tpMessage) {
   buffers.pickle.resize(tpMessage.payloads[kTpMessagePickleIdx].length);
   tpMessage.payloads[kTpMessagePickleIdx].data = buffers.pickle.data();
 
+  // Only messages to a peer with a device map carry device indices, their
+  // tensors are received in pinned memory to be moved to the GPU.
+  at::Allocator* allocator = at::getCPUAllocator();
+  if (!buffers.deviceIndices.empty() && at::hasCUDA()) {
+    allocator = at::detail::getCUDAHooks().getPinnedMemoryAllocator();
+  }
   for (auto& tensor : tpMessage.tensors) {
-    buffers.tensors.push_back(at::getCPUAllocator()->allocate(tensor.length));
+    buffers.tensors.push_back(allocator->allocate(tensor.length));
     tensor.data = buffers.tensors.back().get();
   }
 
@@ -679,6 +760,9 @@ Message tensorpipeDeserialize(
 void writeWrappedPayload(
     std::vector<char>& originalPayload,
     std::vector<char>& additionalPayload) {
+  // Grow the payload once, it can be large.
+  originalPayload.reserve(
+      originalPayload.size() + additionalPayload.size() + sizeof(int64_t));
   originalPayload.insert(
       originalPayload.end(),
       additionalPayload.begin(),
@@ -53,6 +53,11 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size);
 
+// Same as above, except that the tensors whose section is aligned in the
+// buffer are views of it instead of copies, they keep the buffer alive.
+TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
+    const at::Tensor& wire);
+
 // We use vector<char> as the type of blobs because it's what rpc::Message uses
 // for its payload, even though it has the disadvantage that it cannot be
 // allocated with uninitialized memory: it is always zeroed out.
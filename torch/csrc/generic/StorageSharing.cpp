@@ -14,6 +14,8 @@ static PyObject * THPStorage_(sharedDecref)(THPStorage *self, PyObject *noargs)
   THManagedMapAllocator *ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
   if (ctx) {
     ctx->decref();
+  } else if (THManagedBlock *block = THManagedBlock::fromDataPtr(storage->data_ptr())) {
+    block->decref();
   }
 #endif
   Py_INCREF(self);
@@ -29,6 +31,8 @@ static PyObject * THPStorage_(sharedIncref)(THPStorage *self, PyObject *noargs)
   THManagedMapAllocator *ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
   if (ctx) {
     ctx->incref();
+  } else if (THManagedBlock *block = THManagedBlock::fromDataPtr(storage->data_ptr())) {
+    block->incref();
   }
 #endif
   Py_RETURN_NONE;
@@ -52,10 +56,14 @@ static std::string THPStorage_(__newHandle)() {
 
 static THWStorage* THPStorage_(newFilenameStorage)(ptrdiff_t size)
 {
-  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
-  std::string handle = THPStorage_(__newHandle)();
-  return THWStorage_(newWithDataAndAllocator)(
-      THManagedMapAllocator::makeDataPtr("", handle.c_str(), flags, size * sizeof(scalar_t)), size, /* allocator */ nullptr);
+  // small storages are carved out of the pooled segments, when enabled
+  at::DataPtr data_ptr = THManagedBlock::allocate(size * sizeof(scalar_t));
+  if (!data_ptr) {
+    int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
+    std::string handle = THPStorage_(__newHandle)();
+    data_ptr = THManagedMapAllocator::makeDataPtr("", handle.c_str(), flags, size * sizeof(scalar_t));
+  }
+  return THWStorage_(newWithDataAndAllocator)(std::move(data_ptr), size, /* allocator */ nullptr);
 }
 
 static PyObject * THPStorage_(pyNewFilenameStorage)(PyObject *_unused, PyObject *args)
@@ -73,9 +81,10 @@ static PyObject * THPStorage_(shareFilename)(THPStorage *self, PyObject *noargs)
 {
   HANDLE_TH_ERRORS
   THWStorage *storage = self->cdata;
-  THManagedMapAllocator *ctx;
+  THManagedMapAllocator *ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
+  THManagedBlock *block = THManagedBlock::fromDataPtr(storage->data_ptr());
   // Storage is already in shared memory, just return a handle
-  if ((ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr()))) {
+  if (ctx || block) {
     // done
   } else {
     // TODO: retry on collision
@@ -85,12 +94,15 @@ static PyObject * THPStorage_(shareFilename)(THPStorage *self, PyObject *noargs)
     THWStorage_(copy)(new_storage, storage);
     THWStorage_(swap)(storage, new_storage);
     ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
-    AT_ASSERT(ctx);
+    block = THManagedBlock::fromDataPtr(storage->data_ptr());
+    AT_ASSERT(ctx || block);
   }
 
-  THPObjectPtr manager_handle(PyBytes_FromString(ctx->manager_handle()));
+  THPObjectPtr manager_handle(PyBytes_FromString(
+      ctx ? ctx->manager_handle() : block->manager_handle()));
   if (!manager_handle) return nullptr;
-  THPObjectPtr storage_handle(PyBytes_FromString(ctx->filename()));
+  THPObjectPtr storage_handle(PyBytes_FromString(
+      ctx ? ctx->filename() : block->handle().c_str()));
   if (!storage_handle) return nullptr;
   THPObjectPtr size(PyLong_FromLong(storage->nbytes() / sizeof(scalar_t)));
   if (!size) return nullptr;
@@ -119,11 +131,17 @@ static PyObject * THPStorage_(newSharedFilename)(PyObject *_unused, PyObject *ar
   const char *manager_handle = PyBytes_AS_STRING(_manager_handle);
   const char *object_handle = PyBytes_AS_STRING(_object_handle);
   int64_t size = THPUtils_unpackLong(_size);
-  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM |
-              TH_ALLOCATOR_MAPPED_NOCREATE;
+  at::DataPtr data_ptr;
+  if (THManagedBlock::isHandle(object_handle)) {
+    data_ptr = THManagedBlock::makeDataPtr(manager_handle, object_handle);
+  } else {
+    int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM |
+                TH_ALLOCATOR_MAPPED_NOCREATE;
+    data_ptr = THManagedMapAllocator::makeDataPtr(manager_handle, object_handle, flags, size * sizeof(scalar_t));
+  }
   return THPStorage_(New)(
           THWStorage_(newWithDataAndAllocator)(
-            THManagedMapAllocator::makeDataPtr(manager_handle, object_handle, flags, size * sizeof(scalar_t)),
+            std::move(data_ptr),
             size,
             /* allocator */ nullptr));
   END_HANDLE_TH_ERRORS
@@ -225,7 +243,7 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
   }
 
   at::DeviceGuard device_guard(storage->device());
-  THPObjectPtr tuple(PyTuple_New(8));
+  THPObjectPtr tuple(PyTuple_New(9));
   THPObjectPtr device(PyLong_FromLong(storage->device().index()));
   THPObjectPtr _handle(Py_None);
   Py_INCREF(Py_None);
@@ -238,7 +256,25 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
   Py_INCREF(Py_None);
   THPObjectPtr _event_sync_required(Py_None);
   Py_INCREF(Py_None);
+  THPObjectPtr _pooled(PyBool_FromLong(false));
   if (THWStorage_(data)(LIBRARY_STATE storage)) {
+    // Move small storages into the IPC memory pool when first sent, storages
+    // already sent have to stay where the consumers see them.
+    // See Note [CUDA IPC memory pool]
+    bool pooled = torch::CudaIPCPoolContains(storage->data(), storage->device());
+    if (!pooled && storage->data_ptr().get_deleter() ==
+            c10::cuda::CUDACachingAllocator::get()->raw_deleter()) {
+      at::DataPtr block = torch::CudaIPCPoolAllocate(storage->nbytes(), storage->device());
+      if (block) {
+        auto stream = c10::cuda::getCurrentCUDAStream();
+        THCudaCheck(cudaMemcpyAsync(
+            block.get(), storage->data(), storage->nbytes(),
+            cudaMemcpyDeviceToDevice, stream));
+        c10::cuda::CUDACachingAllocator::recordStream(storage->data_ptr(), stream);
+        storage->set_data_ptr(std::move(block));
+        pooled = true;
+      }
+    }
     size_t base_size;
     void *base_ptr = c10::cuda::CUDACachingAllocator::getBaseAllocation(THWStorage_(data)(LIBRARY_STATE storage), &base_size);
     ptrdiff_t offset_bytes = (char*)storage->data<scalar_t>() - (char*)base_ptr;
@@ -251,7 +287,7 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
 
     // Put Storage Data behind new ref counting context
     // See Note [CUDA IPC Refcounting implementation explained]
-    at::DataPtr sent_data_ptr = torch::GetNewRefCountedSentData(storage->data(), storage->device());
+    at::DataPtr sent_data_ptr = torch::GetNewRefCountedSentData(storage->data(), storage->device(), pooled);
     auto old_data_ptr = storage->set_data_ptr(std::move(sent_data_ptr));
     auto sent_data  =  static_cast<torch::CudaIPCSentData*>(storage->data_ptr().get_context());
     sent_data->set_original_ptr(std::move(old_data_ptr));
@@ -271,10 +307,10 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
 
     _event_handle = PyBytes_FromStringAndSize((char *)&ipc_event_handle, CUDA_IPC_HANDLE_SIZE);
     _event_sync_required = PyBool_FromLong(sent_data->event_sync_required_);
-
+    _pooled = PyBool_FromLong(pooled);
   }
 
-  if (!tuple || !device || !_handle || !size_bytes || !_offset_bytes || !_event_handle) {
+  if (!tuple || !device || !_handle || !size_bytes || !_offset_bytes || !_event_handle || !_pooled) {
     return nullptr;
   }
   PyTuple_SET_ITEM(tuple.get(), 0, device.release());
@@ -291,6 +327,8 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
   PyTuple_SET_ITEM(tuple.get(), 5, _ref_counter_offset.release());
   PyTuple_SET_ITEM(tuple.get(), 6, _event_handle.release());
   PyTuple_SET_ITEM(tuple.get(), 7, _event_sync_required.release());
+  // Whether the storage is in the IPC memory pool, and the event long-lived
+  PyTuple_SET_ITEM(tuple.get(), 8, _pooled.release());
   return tuple.release();
   END_HANDLE_TH_ERRORS
 }
@@ -298,37 +336,26 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
 static PyObject * THPStorage_(releaseIPCCounter)(PyObject *_unused, PyObject *args)
 {
   HANDLE_TH_ERRORS
-  THPUtils_assert(PyTuple_GET_SIZE(args) == 2, "tuple of 2 items expected");
+  Py_ssize_t num_args = PyTuple_GET_SIZE(args);
+  THPUtils_assert(num_args == 2 || num_args == 3, "tuple of 2 or 3 items expected");
   PyObject *_ref_counter = PyTuple_GET_ITEM(args, 0);
   PyObject *_ref_counter_offset = PyTuple_GET_ITEM(args, 1);
+  PyObject *_pooled = num_args == 3 ? PyTuple_GET_ITEM(args, 2) : Py_False;
   if (!(PyBytes_Check(_ref_counter) &&
-        THPUtils_checkLong(_ref_counter_offset))) {
+        THPUtils_checkLong(_ref_counter_offset) && PyBool_Check(_pooled))) {
     THPUtils_invalidArguments(
         args,
         nullptr,
         "_release_ipc_counter in CUDA mode",
         1,
-        "(bytes _ref_counter, int _ref_counter_offset)");
+        "(bytes _ref_counter, int _ref_counter_offset, bool pooled=False)");
     return nullptr;
   }
   std::string ref_counter_handle = PyBytes_AS_STRING(_ref_counter);
   ptrdiff_t ref_counter_offset =
       (ptrdiff_t)THPUtils_unpackLong(_ref_counter_offset);
-  // We don't want to break existing code, so resource deletion is best
-  // effort basis. Exception expected if producer process terminated
-  // before consumer released data.
-  int flags =
-      TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
-  try {
-    auto sptr = THRefcountedMapAllocator::makeDataPtr(
-        ref_counter_handle.c_str(),
-        flags,
-        sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-        nullptr);
-    *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
-  } catch (c10::Error& err) {
-    // Already warned inside of producer process
-  }
+  torch::CudaIPCReleaseCounter(
+      ref_counter_handle, ref_counter_offset, _pooled == Py_True);
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
 }
@@ -347,7 +374,7 @@ static std::string THPStorage_(bytesAsHandleString)(PyObject *handle) {
 static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
 {
   HANDLE_TH_ERRORS
-  THPUtils_assert(PyTuple_GET_SIZE(args) == 8, "tuple of 8 items expected");
+  THPUtils_assert(PyTuple_GET_SIZE(args) == 9, "tuple of 9 items expected");
   PyObject *_device = PyTuple_GET_ITEM(args, 0);
   PyObject *_handle = PyTuple_GET_ITEM(args, 1);
   PyObject *_size_bytes = PyTuple_GET_ITEM(args, 2);
@@ -356,18 +383,22 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
   PyObject *_ref_counter_offset = PyTuple_GET_ITEM(args, 5);
   PyObject *_event_handle = PyTuple_GET_ITEM(args, 6);
   PyObject *_event_sync_required = PyTuple_GET_ITEM(args, 7);
+  PyObject *_pooled = PyTuple_GET_ITEM(args, 8);
   if (!(THPUtils_checkLong(_device) && THPUtils_checkLong(_size_bytes) &&
         PyBytes_Check(_handle) && PyBytes_Check(_ref_counter) &&
         PyBytes_Check(_event_handle) && THPUtils_checkLong(_offset_bytes) &&
-        THPUtils_checkLong(_ref_counter_offset) && PyBool_Check(_event_sync_required))) {
+        THPUtils_checkLong(_ref_counter_offset) && PyBool_Check(_event_sync_required) &&
+        PyBool_Check(_pooled))) {
     THPUtils_invalidArguments(
         args,
         nullptr,
         "_new_shared in CUDA mode",
         1,
-        "(int device, bytes handle, int storage_size_bytes, int storage_offset_bytes, bytes _ref_counter, int _ref_counter_offset, bytes event_handle, bool event_sync_required)");
+        "(int device, bytes handle, int storage_size_bytes, int storage_offset_bytes, bytes _ref_counter, int _ref_counter_offset, bytes event_handle, bool event_sync_required, bool pooled)");
     return nullptr;
   }
+  // See Note [CUDA IPC memory pool]
+  bool pooled = _pooled == Py_True;
 
   size_t storage_size = (size_t)THPUtils_unpackLong(_size_bytes) / sizeof(scalar_t);
   ptrdiff_t storage_offset_bytes = (ptrdiff_t)THPUtils_unpackLong(_offset_bytes);
@@ -383,7 +414,11 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
     auto ipc_event_handle = reinterpret_cast<const cudaIpcEventHandle_t*>(
         s_ipc_event_handle.c_str());
     cudaEvent_t event;
-    cudaIpcOpenEventHandle(&event, *ipc_event_handle);
+    if (pooled) {
+      event = torch::CudaIPCOpenPooledEvent(s_ipc_event_handle);
+    } else {
+      cudaIpcOpenEventHandle(&event, *ipc_event_handle);
+    }
     AT_CUDA_CHECK(
         cudaStreamWaitEvent(c10::cuda::getCurrentCUDAStream(device), event, 0));
   }
@@ -393,6 +428,9 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
 
   std::string s_handle = THPStorage_(bytesAsHandleString)(_handle);
   std::shared_ptr<void> basePtr = c10::cuda::CUDACachingAllocator::getIpcDevPtr(s_handle);
+  if (pooled) {
+    torch::CudaIPCRetainPoolMapping(s_handle, basePtr);
+  }
 
   // Offset the basePtr to reconstruct the real storage
   // devPtr = basePtr + storage_offset
@@ -404,8 +442,12 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
 
   auto c = new torch::CudaIPCReceivedData(std::move(basePtr));
   auto sp = std::shared_ptr<void>(
-      (void*)c, [ref_counter_handle, ref_counter_offset, device](void* ptr) {
+      (void*)c, [ref_counter_handle, ref_counter_offset, device, pooled](void* ptr) {
         delete static_cast<torch::CudaIPCReceivedData*>(ptr);
+        if (pooled) {
+          torch::CudaIPCReleaseCounterAsync(ref_counter_handle, ref_counter_offset, device);
+          return;
+        }
         // Sync default stream to make sure all operations related to the storage is
         // finished (otherwise another process may reuse memory and corrupt
         // data)
@@ -420,21 +462,7 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
         // Callback and release counter inside of it (need to check performance impact)
         cudaStreamSynchronize(c10::cuda::getCurrentCUDAStream(device));
 
-        // We don't want to break existing code, so resource deletion is best
-        // effort basis. Exception expected if producer process terminated
-        // before consumer released data.
-        int flags =
-            TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
-        try {
-          auto sptr = THRefcountedMapAllocator::makeDataPtr(
-              ref_counter_handle.c_str(),
-              flags,
-              sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-              nullptr);
-          *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
-        } catch (c10::Error& err) {
-          // Already warned inside of producer process
-        }
+        torch::CudaIPCReleaseCounter(ref_counter_handle, ref_counter_offset, /*pooled=*/false);
       });
 
   THWStoragePtr base(THWStorage_(newWithDataAndAllocator)(
@@ -518,7 +546,8 @@ PyObject * THPStorage_(isShared)(THPStorage *self, PyObject *noargs)
   Py_RETURN_TRUE;
 #else
   if (THMapAllocator::fromDataPtr(self->cdata->data_ptr()) ||
-      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr())) {
+      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr()) ||
+      THManagedBlock::fromDataPtr(self->cdata->data_ptr())) {
     Py_RETURN_TRUE;
   } else {
     Py_RETURN_FALSE;
@@ -3,6 +3,10 @@
 #include <torch/csrc/jit/codegen/cuda/ir_all_nodes.h>
 #include <torch/csrc/jit/codegen/cuda/type.h>
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
 namespace torch {
 namespace jit {
 namespace fuser {
@@ -49,10 +53,11 @@ TensorView* newOutputTV(const std::vector<Val*>& vals, DataType dtype) {
       "Tried to create new output TensorView but received empty list.");
 
   std::vector<IterDomain*> out_domain(
-      TensorDomain::noReductions(tvs[0]->getRootDomain()).size(), nullptr);
+      TensorDomain::noReductions(tvs[0]->getMaybeRFactorDomain()).size(),
+      nullptr);
 
   for (auto tv : tvs) {
-    auto dom = TensorDomain::noReductions(tv->getRootDomain());
+    auto dom = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
     TORCH_INTERNAL_ASSERT(
         dom.size() == out_domain.size(),
         "Invalid tensor view found while producing and output, it has ",
@@ -71,7 +76,8 @@ TensorView* newOutputTV(const std::vector<Val*>& vals, DataType dtype) {
     if (out_domain[dim_i] == nullptr) {
       IterType itype = IterType::BroadcastWithoutStride;
       for (const auto tv : tvs) {
-        auto dim = TensorDomain::noReductions(tv->getRootDomain())[dim_i];
+        auto dim =
+            TensorDomain::noReductions(tv->getMaybeRFactorDomain())[dim_i];
         // If there's an unresolved bcast dim and it came from a strided dim,
         // assume output of it should be strided too
         if (dim->getIterType() == IterType::BroadcastWithStride) {
@@ -96,7 +102,8 @@ std::vector<Val*> maybeBroadcast(const std::vector<Val*>& vals) {
     if (val->getValType().value() == ValType::TensorView) {
       n_dims = std::max(
           n_dims,
-          TensorDomain::noReductions(val->as<TensorView>()->getRootDomain())
+          TensorDomain::noReductions(
+              val->as<TensorView>()->getMaybeRFactorDomain())
               .size());
     }
   }
@@ -104,7 +111,8 @@ std::vector<Val*> maybeBroadcast(const std::vector<Val*>& vals) {
   for (size_t i = 0; i < vals.size(); i++) {
     if (vals[i]->getValType().value() == ValType::TensorView) {
       auto tv = vals[i]->as<TensorView>();
-      size_t tv_dims = TensorDomain::noReductions(tv->getRootDomain()).size();
+      size_t tv_dims =
+          TensorDomain::noReductions(tv->getMaybeRFactorDomain()).size();
       if (tv_dims < n_dims) {
         std::vector<bool> bcast_flags(n_dims, false);
         for (size_t j = 0; j < n_dims - tv_dims; j++) {
@@ -397,7 +405,7 @@ TensorView* andOp(TensorView* v1, TensorView* v2) {
 static TensorView* newForReduction(
     TensorView* tv,
     const std::vector<unsigned int>& axes) {
-  auto orig_domain = TensorDomain::noReductions(tv->getRootDomain());
+  auto orig_domain = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
   std::set<unsigned int> axes_set(axes.begin(), axes.end());
 
   std::vector<IterDomain*> new_domain;
@@ -448,7 +456,8 @@ TensorView* reductionOp(
       "Cannot create a reduction operation where the initial value is not a const scalar.");
 
   TORCH_CHECK(
-      TensorDomain::sameAs(tv->getRootDomain(), tv->domain()->domain()),
+      TensorDomain::sameAs(
+          tv->getMaybeRFactorDomain(), tv->domain()->domain()),
       "Reducing a tensor once it's gone under transformations is not permitted at this time. Please set reductions before calling split/merge/computeAt.");
 
   TORCH_CHECK(tv->nDims() > 0, "Tried to reduce a 0-dim tensor");
@@ -508,9 +517,9 @@ TensorView* broadcast(
       n_broadcasts++;
   TORCH_CHECK(
       nBCastDims - n_broadcasts ==
-          TensorDomain::noReductions(inp->getRootDomain()).size(),
+          TensorDomain::noReductions(inp->getMaybeRFactorDomain()).size(),
       "Invalid broadcast, number of false entries in is_broadcast_dim expected to be ",
-      TensorDomain::noReductions(inp->getRootDomain()).size(),
+      TensorDomain::noReductions(inp->getMaybeRFactorDomain()).size(),
       " but received ",
       nBCastDims - n_broadcasts);
 
@@ -523,7 +532,7 @@ TensorView* broadcast(
   }
 
   std::vector<IterDomain*> out_domain;
-  auto inp_domain = TensorDomain::noReductions(inp->getRootDomain());
+  auto inp_domain = TensorDomain::noReductions(inp->getMaybeRFactorDomain());
   size_t iinp = 0, ibdim = 0;
   while (ibdim < is_broadcast_dim.size()) {
     if (is_broadcast_dim[ibdim]) {
@@ -547,6 +556,167 @@ TensorView* broadcast(
   return out_tensor;
 }
 
+namespace {
+
+// New root domain mapping to the (no reduction) domain inp exposes to its
+// consumers
+std::vector<IterDomain*> newLayoutRoot(TensorView* inp) {
+  std::vector<IterDomain*> root;
+  for (auto id : TensorDomain::noReductions(inp->getMaybeRFactorDomain())) {
+    root.push_back(new IterDomain(
+        id->start(), id->extent(), ParallelType::Serial, id->getIterType()));
+  }
+  return root;
+}
+
+TensorView* newLayoutOp(
+    TensorView* inp,
+    const std::vector<IterDomain*>& root,
+    const std::vector<IterDomain*>& rfactor) {
+  TensorView* out = new TensorView(
+      new TensorDomain(
+          root, rfactor, rfactor, std::vector<bool>(rfactor.size(), true)),
+      inp->getDataType().value());
+  new UnaryOp(UnaryOpType::Set, out, inp);
+  return out;
+}
+
+} // namespace
+
+TensorView* permute(TensorView* inp, const std::vector<int>& dims) {
+  auto root = newLayoutRoot(inp);
+  const int ndims = static_cast<int>(root.size());
+  TORCH_CHECK(
+      dims.size() == root.size(),
+      "Invalid permute, expected ",
+      ndims,
+      " dimensions but received ",
+      dims.size());
+
+  std::vector<IterDomain*> rfactor(root.size(), nullptr);
+  bool is_identity = true;
+  for (int i = 0; i < ndims; i++) {
+    const int dim = dims[i] < 0 ? dims[i] + ndims : dims[i];
+    TORCH_CHECK(
+        dim >= 0 && dim < ndims && rfactor[i] == nullptr &&
+            std::find(rfactor.begin(), rfactor.end(), root[dim]) ==
+                rfactor.end(),
+        "Invalid permute, dimension ",
+        dims[i],
+        " is out of range or repeated.");
+    rfactor[i] = root[dim];
+    is_identity = is_identity && dim == i;
+  }
+
+  if (is_identity) {
+    return unaryOp(UnaryOpType::Set, inp);
+  }
+  return newLayoutOp(inp, root, rfactor);
+}
+
+TensorView* transpose(TensorView* inp, int dim0, int dim1) {
+  const int ndims =
+      static_cast<int>(TensorDomain::noReductions(inp->getMaybeRFactorDomain())
+                           .size());
+  dim0 = dim0 < 0 ? dim0 + ndims : dim0;
+  dim1 = dim1 < 0 ? dim1 + ndims : dim1;
+  TORCH_CHECK(
+      dim0 >= 0 && dim0 < ndims && dim1 >= 0 && dim1 < ndims,
+      "Invalid transpose, dimensions out of range.");
+  std::vector<int> dims(ndims);
+  std::iota(dims.begin(), dims.end(), 0);
+  std::swap(dims[dim0], dims[dim1]);
+  return permute(inp, dims);
+}
+
+TensorView* view(
+    TensorView* inp,
+    const std::vector<int64_t>& original_sizes,
+    const std::vector<int64_t>& new_sizes) {
+  auto root = newLayoutRoot(inp);
+  TORCH_CHECK(
+      original_sizes.size() == root.size(),
+      "Invalid view, expected sizes of ",
+      root.size(),
+      " dimensions but received ",
+      original_sizes.size());
+
+  const int64_t numel = std::accumulate(
+      original_sizes.begin(),
+      original_sizes.end(),
+      (int64_t)1,
+      std::multiplies<int64_t>());
+  std::vector<int64_t> sizes = new_sizes;
+  auto infer_dim = std::find(sizes.begin(), sizes.end(), -1);
+  if (infer_dim != sizes.end()) {
+    *infer_dim = 1;
+    const int64_t known = std::accumulate(
+        sizes.begin(), sizes.end(), (int64_t)1, std::multiplies<int64_t>());
+    TORCH_CHECK(known > 0 && numel % known == 0, "Invalid view sizes.");
+    *infer_dim = numel / known;
+  }
+  TORCH_CHECK(
+      std::accumulate(
+          sizes.begin(),
+          sizes.end(),
+          (int64_t)1,
+          std::multiplies<int64_t>()) == numel,
+      "Invalid view, the number of elements changes.");
+  TORCH_CHECK(numel > 0, "Views of empty tensors are not supported.");
+
+  // Walk both shapes, grouping the dimensions of inp that make up the same
+  // elements as a group of output dimensions. Each group of inp is merged
+  // into one IterDomain, which is then split into the output dimensions.
+  std::vector<IterDomain*> rfactor;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < original_sizes.size() || j < sizes.size()) {
+    const size_t group_i = i;
+    const size_t group_j = j;
+    int64_t inp_elems = i < original_sizes.size() ? original_sizes[i++] : 1;
+    int64_t out_elems = j < sizes.size() ? sizes[j++] : 1;
+    while (inp_elems != out_elems) {
+      if (inp_elems < out_elems) {
+        TORCH_INTERNAL_ASSERT(i < original_sizes.size());
+        inp_elems *= original_sizes[i++];
+      } else {
+        TORCH_INTERNAL_ASSERT(j < sizes.size());
+        out_elems *= sizes[j++];
+      }
+    }
+
+    // Trailing size-1 dimensions of either shape join the last group
+    if (i == original_sizes.size()) {
+      while (j < sizes.size() && sizes[j] == 1) {
+        j++;
+      }
+    }
+    if (j == sizes.size()) {
+      while (i < original_sizes.size() && original_sizes[i] == 1) {
+        i++;
+      }
+    }
+
+    IterDomain* merged = nullptr;
+    for (size_t k = group_i; k < i; k++) {
+      merged = merged == nullptr ? root[k] : IterDomain::merge(merged, root[k]);
+    }
+    TORCH_CHECK(merged != nullptr, "Invalid view of a 0-dim tensor.");
+    std::vector<IterDomain*> group_ids;
+    for (size_t k = j; k > group_j + 1; k--) {
+      auto split = IterDomain::split(merged, new Int(sizes[k - 1]));
+      merged = split.first;
+      group_ids.push_back(split.second);
+    }
+    if (j > group_j) {
+      group_ids.push_back(merged);
+    }
+    rfactor.insert(rfactor.end(), group_ids.rbegin(), group_ids.rend());
+  }
+
+  return newLayoutOp(inp, root, rfactor);
+}
+
 // COMPOUND OPERATIONS
 
 // add_alpha
@@ -56,6 +56,23 @@ TORCH_CUDA_API TensorView* broadcast(
     TensorView* inp,
     const std::vector<bool>& is_broadcast_dim);
 
+// Layout operations don't move data, they only change what the dimensions of
+// inp are to its consumers. The output's root domain maps to inp and its
+// rfactor domain, which consumers see, is derived from the root by reorders,
+// merges and splits.
+
+// Dimension i of the output is dimension dims[i] of inp.
+TORCH_CUDA_API TensorView* permute(TensorView* inp, const std::vector<int>& dims);
+TORCH_CUDA_API TensorView* transpose(TensorView* inp, int dim0, int dim1);
+
+// Views inp of original_sizes as new_sizes, same as at::Tensor::view. One of
+// new_sizes may be -1. The sizes are only used to find which dimensions are
+// merged and split, the extents of the output are still derived from inp.
+TORCH_CUDA_API TensorView* view(
+    TensorView* inp,
+    const std::vector<int64_t>& original_sizes,
+    const std::vector<int64_t>& new_sizes);
+
 // BINARY OPERATIONS
 // add
 TORCH_CUDA_API Val* add(Val* v1, Val* v2);
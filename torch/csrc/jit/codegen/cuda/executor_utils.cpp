@@ -2,6 +2,7 @@
 #include <ATen/cuda/CUDAContext.h>
 
 #include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/util/Fnv1a.h>
 
 #include <torch/csrc/jit/resource_guard.h>
 
@@ -10,7 +11,20 @@
 
 #include <torch/csrc/jit/codegen/cuda/executor_utils.h>
 
+#include <atomic>
+#include <cctype>
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
+#include <iterator>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace torch {
 namespace jit {
@@ -47,7 +61,8 @@ bool validateKernelArgTensor(
   size_t arg_dim = arg.dim();
   // Note: This requires current Fusion to be active.
   size_t param_dim =
-      TensorDomain::noReductions(param->as<TensorView>()->getRootDomain())
+      TensorDomain::noReductions(
+          param->as<TensorView>()->getMaybeRFactorDomain())
           .size();
   // see [Note - broadcast support in integration]
   // Because of broadcasting support handled in integration, we relax the rank
@@ -232,6 +247,125 @@ EvaluationContext bindInputs(
   return eval_context;
 }
 
+namespace {
+
+// [Note - kernel binary cache]
+// When PYTORCH_CUDA_FUSER_KERNEL_CACHE names a directory, the PTX NVRTC
+// produces is stored there and reused by any process that compiles the same
+// kernel, instead of running NVRTC again. Entries are named by a hash of
+// their key, the NVRTC version, compile options and kernel source, and hold
+// the key itself, so a hash collision is a miss rather than a wrong kernel.
+// Entries are written to a temporary file and renamed into place, so
+// concurrent processes never read a partial entry.
+//
+// Kernels are named after a per-process counter, which is left out of the
+// key: each kernel has a module of its own, so a kernel is looked up under
+// the name it was compiled with, whatever name it has in this process.
+const char* kKernelCacheMagic = "nvfuser-ptx-v1";
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string kernelCacheKey(
+    const std::string& code,
+    const std::string& func_name,
+    const std::vector<const char*>& args,
+    int nvrtc_major,
+    int nvrtc_minor) {
+  std::stringstream key;
+  key << "nvrtc " << nvrtc_major << "." << nvrtc_minor << "\n";
+  for (const char* arg : args) {
+    key << arg << "\n";
+  }
+  const auto pos = func_name.rfind("::");
+  const std::string name =
+      pos == std::string::npos ? func_name : func_name.substr(pos + 2);
+  size_t begin = 0;
+  for (size_t i = code.find(name); i != std::string::npos;
+       i = code.find(name, i + name.size())) {
+    const size_t end = i + name.size();
+    if ((i > 0 && isIdentifierChar(code[i - 1])) ||
+        (end < code.size() && isIdentifierChar(code[end]))) {
+      continue;
+    }
+    key << code.substr(begin, i - begin) << "$kernel";
+    begin = end;
+  }
+  key << code.substr(begin);
+  return key.str();
+}
+
+std::string kernelCacheDir() {
+  const char* dir = getenv("PYTORCH_CUDA_FUSER_KERNEL_CACHE");
+  return dir ? dir : "";
+}
+
+std::string kernelCacheFileName(const std::string& key) {
+  std::ostringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0')
+     << c10::util::fnv1a64(key) << ".ptx";
+  return ss.str();
+}
+
+bool loadCachedKernel(
+    const std::string& path,
+    const std::string& key,
+    std::string& lowered_kernel_name,
+    std::vector<char>& ptx) {
+  std::ifstream in(path, std::ios::binary);
+  std::string magic;
+  size_t key_size = 0;
+  if (!std::getline(in, magic) || magic != kKernelCacheMagic ||
+      !(in >> key_size) || in.get() != '\n' || key_size != key.size()) {
+    return false;
+  }
+  std::string cached_key(key_size, '\0');
+  if (!in.read(&cached_key[0], key_size) || cached_key != key ||
+      !std::getline(in, lowered_kernel_name)) {
+    return false;
+  }
+  ptx.assign(
+      std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return !ptx.empty();
+}
+
+void storeCachedKernel(
+    const std::string& dir,
+    const std::string& path,
+    const std::string& key,
+    const std::string& lowered_kernel_name,
+    const std::vector<char>& ptx) {
+  static std::atomic<int> counter{0};
+#ifdef _WIN32
+  _mkdir(dir.c_str());
+  const int pid = _getpid();
+#else
+  mkdir(dir.c_str(), 0777);
+  const int pid = getpid();
+#endif
+  const std::string tmp_path = path + ".tmp" + std::to_string(pid) + "_" +
+      std::to_string(counter++);
+  {
+    std::ofstream out(tmp_path, std::ios::binary);
+    out << kKernelCacheMagic << "\n" << key.size() << "\n" << key
+        << lowered_kernel_name << "\n";
+    out.write(ptx.data(), ptx.size());
+    if (!out) {
+      TORCH_WARN("Failed to store a CUDA fuser kernel in ", dir);
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  // On Windows rename does not replace an existing entry, which another
+  // process stored first, so dropping ours is fine
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+} // namespace
+
 NvrtcFunction nvrtcCompile(
     const std::string& code,
     const std::string& func_name,
@@ -257,45 +391,67 @@ NvrtcFunction nvrtcCompile(
   // based on the NVRTC version
   const int major = prop->major;
   const int minor = prop->minor;
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(at::globalContext().getNVRTC().nvrtcCreateProgram(
-      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
-  ResourceGuard holdProgram([&] {
-    AT_CUDA_NVRTC_CHECK(
-        at::globalContext().getNVRTC().nvrtcDestroyProgram(&program));
-  });
 
   const std::string compute = "--gpu-architecture=compute_" +
       std::to_string(major) + std::to_string(minor);
   const std::vector<const char*> args = {
       "--std=c++14", compute.c_str(), "-default-device"};
 
-  at::globalContext().getNVRTC().nvrtcAddNameExpression(
-      program, func_name.c_str());
-  const auto result = at::globalContext().getNVRTC().nvrtcCompileProgram(
-      program, args.size(), args.data());
+  // See [Note - kernel binary cache]
+  const std::string cache_dir = kernelCacheDir();
+  std::string cache_key;
+  std::string cache_path;
+  std::string lowered_kernel_name;
+  std::vector<char> ptx;
+  if (!cache_dir.empty()) {
+    cache_key =
+        kernelCacheKey(code, func_name, args, nvrtc_major, nvrtc_minor);
+    cache_path = cache_dir + "/" + kernelCacheFileName(cache_key);
+  }
 
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    at::globalContext().getNVRTC().nvrtcGetProgramLogSize(program, &logsize);
-    std::vector<char> log(logsize);
-    at::globalContext().getNVRTC().nvrtcGetProgramLog(program, log.data());
+  if (cache_dir.empty() ||
+      !loadCachedKernel(cache_path, cache_key, lowered_kernel_name, ptx)) {
+    nvrtcProgram program;
+    AT_CUDA_NVRTC_CHECK(at::globalContext().getNVRTC().nvrtcCreateProgram(
+        &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+    ResourceGuard holdProgram([&] {
+      AT_CUDA_NVRTC_CHECK(
+          at::globalContext().getNVRTC().nvrtcDestroyProgram(&program));
+    });
+
+    at::globalContext().getNVRTC().nvrtcAddNameExpression(
+        program, func_name.c_str());
+    const auto result = at::globalContext().getNVRTC().nvrtcCompileProgram(
+        program, args.size(), args.data());
+
+    if (result != NVRTC_SUCCESS) {
+      size_t logsize;
+      at::globalContext().getNVRTC().nvrtcGetProgramLogSize(program, &logsize);
+      std::vector<char> log(logsize);
+      at::globalContext().getNVRTC().nvrtcGetProgramLog(program, log.data());
 
-    TORCH_INTERNAL_ASSERT(
-        false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
-  }
-  const char* lowered_kernel_name;
-  at::globalContext().getNVRTC().nvrtcGetLoweredName(
-      program, func_name.c_str(), &lowered_kernel_name);
+      TORCH_INTERNAL_ASSERT(
+          false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+    }
+    const char* lowered_name;
+    at::globalContext().getNVRTC().nvrtcGetLoweredName(
+        program, func_name.c_str(), &lowered_name);
+    lowered_kernel_name = lowered_name;
 
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
-  AT_CUDA_NVRTC_CHECK(
-      at::globalContext().getNVRTC().nvrtcGetPTXSize(program, &ptx_size));
-  std::vector<char> ptx;
-  ptx.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(
-      at::globalContext().getNVRTC().nvrtcGetPTX(program, ptx.data()));
+    AT_CUDA_NVRTC_CHECK(result);
+    size_t ptx_size;
+    AT_CUDA_NVRTC_CHECK(
+        at::globalContext().getNVRTC().nvrtcGetPTXSize(program, &ptx_size));
+    ptx.resize(ptx_size);
+    AT_CUDA_NVRTC_CHECK(
+        at::globalContext().getNVRTC().nvrtcGetPTX(program, ptx.data()));
+
+    if (!cache_dir.empty()) {
+      storeCachedKernel(
+          cache_dir, cache_path, cache_key, lowered_kernel_name, ptx);
+    }
+  }
+  const size_t ptx_size = ptx.size();
 
   NvrtcFunction compiled_kernel_;
 
@@ -354,7 +510,7 @@ NvrtcFunction nvrtcCompile(
   AT_CUDA_DRIVER_CHECK(at::globalContext().getNVRTC().cuModuleGetFunction(
       &(compiled_kernel_.function),
       compiled_kernel_.module,
-      lowered_kernel_name));
+      lowered_kernel_name.c_str()));
 
   return compiled_kernel_;
 }
@@ -47,6 +47,8 @@ struct NvrtcFunction {
   CUfunction function = CUfunction();
 };
 
+// Compiles and loads a kernel. The PTX is reused across processes when
+// PYTORCH_CUDA_FUSER_KERNEL_CACHE names a cache directory.
 NvrtcFunction nvrtcCompile(
     const std::string& code,
     const std::string& func_name,
@@ -2,6 +2,7 @@
 
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/codegen/cuda/interface.h>
+#include <torch/csrc/jit/codegen/cuda/parser.h>
 #include <torch/csrc/jit/codegen/cuda/partition.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/ir/alias_analysis.h>
@@ -242,6 +243,13 @@ struct CudaGraphFuser {
     return group;
   }
 
+  // view-like ops alias their input, inside a fusion group they produce a
+  // new tensor instead. That is only safe when nothing writes to the aliased
+  // memory.
+  bool isAliasSafe(Node* n) {
+    return !fuser::cuda::isLayoutNode(n) || !aliasDb_->hasWriters(n->output());
+  }
+
   at::optional<Node*> tryFuse(Node* consumer, Value* producer) {
     // this handles cases where producer can be moved _into_ the fusion group of
     // consumer.
@@ -252,6 +260,7 @@ struct CudaGraphFuser {
     // done now
     bool shouldFuse =
         fuser::cuda::isFusableCudaFusionGroup(consumer, producer->node()) &&
+        isAliasSafe(producer->node()) &&
         // Rearrange nodes such that all uses of producer are after the
         // consumer. Fusion will rewrite those later uses to use the version of
         // producer generated by the fused blob. In this case, producer becomes
@@ -609,7 +618,8 @@ struct CudaGraphFuser {
 
   // returns where to continue scanning, and whether any fusion was made
   std::pair<graph_node_list::iterator, bool> scanNode(Node* consumer) {
-    if (fuser::cuda::isFusableCudaFusionGroup(consumer)) {
+    if (fuser::cuda::isFusableCudaFusionGroup(consumer) &&
+        isAliasSafe(consumer)) {
       // handle inputs in reverse topological order as well...
       // otherwise in f(a,a+b) it will appear a is used twice if we consider
       // the f-a fusion before the f-(a+b) fusion first.
@@ -96,6 +96,15 @@ at::DimVector graphReductionAxes(const std::shared_ptr<Graph>& graph) {
   return reduction_axes;
 }
 
+bool graphHasLayoutNode(const std::shared_ptr<Graph>& graph) {
+  for (const auto& n : graph->nodes()) {
+    if (isLayoutNode(n)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 at::DimVector getPermutationPerSortedStride(const TensorTypePtr& type) {
   // `permute_seq` is the returned permutation to achieve sorted stride;
   at::DimVector permute_seq;
@@ -183,6 +192,21 @@ at::DimVector inversePermutation(
   }
 }
 
+// sizes of all tensor inputs, which together with the fusion determine the
+// schedule
+std::vector<int64_t> inputSizes(const at::ArrayRef<IValue>& inputs) {
+  std::vector<int64_t> sizes;
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      const auto& tensor_sizes = input.toTensor().sizes();
+      // the rank separates the sizes of different tensors
+      sizes.push_back(-static_cast<int64_t>(tensor_sizes.size()));
+      sizes.insert(sizes.end(), tensor_sizes.begin(), tensor_sizes.end());
+    }
+  }
+  return sizes;
+}
+
 } // namespace
 
 FusionExecutorCache::FusionExecutorCache(
@@ -190,24 +214,35 @@ FusionExecutorCache::FusionExecutorCache(
     at::Device device)
     : device_(device), fusion_(std::move(fusion)) {}
 
-// TODO: dummy cache
 std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     const at::ArrayRef<IValue>& inputs) {
   // caching strategy is different for pw-fusion and reduction-fusion.
   if (fusion_->hasReduction()) {
+    auto input_sizes = inputSizes(inputs);
+    auto size_entry = red_input_sizes_cache_.find(input_sizes);
+    if (size_entry != red_input_sizes_cache_.end()) {
+      stats_.hits++;
+      return size_entry->second->runFusion(inputs);
+    }
+
     // copy the fusion, since each FusionExecutor needs to manipulate the fusion
     // in order to generate kernel.
     Fusion fusion = *fusion_;
     FusionGuard fg(&fusion);
-    TensorView* red_tv = nullptr;
-    for (auto expr : fusion.exprs()) {
-      if (expr->getExprType().has_value() &&
-          expr->getExprType().value() == ExprType::ReductionOp) {
-        red_tv = expr->outputs()[0]->as<TensorView>();
-        break;
+    // normalizations, reductions consumed within the fusion, run as a single
+    // persistent kernel when their rows fit in registers.
+    auto reduction_params = scheduleNormalization(&fusion, inputs);
+    if (!reduction_params.has_value()) {
+      TensorView* red_tv = nullptr;
+      for (auto expr : fusion.exprs()) {
+        if (expr->getExprType().has_value() &&
+            expr->getExprType().value() == ExprType::ReductionOp) {
+          red_tv = expr->outputs()[0]->as<TensorView>();
+          break;
+        }
       }
+      reduction_params = scheduleReduction(&fusion, inputs, red_tv);
     }
-    auto reduction_params = scheduleReduction(&fusion, inputs, red_tv);
     TORCH_INTERNAL_ASSERT(
         reduction_params.has_value(),
         "reduction schedule failed in `scheduleReduction`");
@@ -219,10 +254,17 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       CompileOptions options;
       options.device = device_;
       fusion_executor.compileFusion(&fusion, options);
+      stats_.misses++;
+    } else {
+      stats_.hits++;
     }
+    red_input_sizes_cache_[input_sizes] = &fusion_executor;
     return fusion_executor.runFusion(inputs);
   } else {
-    if (!pw_fusion_executor_cache_) {
+    if (pw_fusion_executor_cache_) {
+      stats_.hits++;
+    } else {
+      stats_.misses++;
       pw_fusion_executor_cache_ = std::make_unique<FusionExecutor>();
       CompileOptions options;
       options.device = device_;
@@ -294,6 +336,11 @@ GraphCache::InputsRequirement::InputsRequirement(
   device_ = acc_type->device();
 }
 
+void GraphCache::InputsRequirement::disablePermutation() {
+  input_permutation_.clear();
+  output_permutation_.clear();
+}
+
 bool GraphCache::InputsRequirement::requiresPermutation() {
   const size_t input_rank = input_permutation_.size();
   for (size_t i = 0; i < input_rank; i++) {
@@ -507,18 +554,27 @@ GraphCache::GraphCache(std::shared_ptr<Graph> graph)
   //    permute changes the semantics of axes, we need to update the reduction
   //    axes in the graph in order to match the behavior;
   reduction_axes_ = graphReductionAxes(graph_);
+  // view and permute index into the axes of their input, which permuting
+  // the inputs would scramble, so we don't coalesce such graphs.
+  has_layout_node_ = graphHasLayoutNode(graph_);
 
   // compile a kernel if we have enough information from graph (profiling
   // record)
   if (IsNewExecutorEnabled()) {
-    createFusionExecutorCache(
-        InputsRequirement(graph_, toVector(reduction_axes_)));
+    InputsRequirement input_stack(graph_, toVector(reduction_axes_));
+    if (has_layout_node_) {
+      input_stack.disablePermutation();
+    }
+    createFusionExecutorCache(input_stack);
   }
 }
 
 std::vector<at::Tensor> GraphCache::runGraphWithInputs(
     const at::ArrayRef<IValue>& inputs) {
   InputsRequirement input_stack(inputs, toVector(reduction_axes_));
+  if (has_layout_node_) {
+    input_stack.disablePermutation();
+  }
   FusionExecutorCache* fusion_executor_cache = nullptr;
 
   // TODO: hash indexing;
@@ -558,6 +614,15 @@ std::vector<at::Tensor> GraphCache::runGraphWithInputs(
   }
 }
 
+FusionExecutorCache::Stats GraphCache::stats() const {
+  FusionExecutorCache::Stats stats;
+  for (const auto& fe_cache : fe_cache_) {
+    stats.hits += fe_cache->stats().hits;
+    stats.misses += fe_cache->stats().misses;
+  }
+  return stats;
+}
+
 } // namespace cuda
 } // namespace fuser
 } // namespace jit
@@ -7,6 +7,7 @@
 #include <c10/util/ArrayRef.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <map>
 #include <type_traits>
 
 namespace torch {
@@ -39,8 +40,12 @@ namespace cuda {
 //     b. FusionExecutorCache
 //        - holds a group of `FusionExecutor` to handle dynamic shape (varying
 //          tensor sizes)
-//        - currently this is a dummy implementation and has branching to handle
-//          different scheduler for point-wise fusion and reduction fusion;
+//        - a compiled kernel only bakes in its schedule, extents are evaluated
+//          at launch time. So a `FusionExecutor` is shared by all input sizes
+//          that yield the same schedule and we only compile when the schedule
+//          changes (never for point-wise fusion);
+//        - currently this has branching to handle different scheduler for
+//          point-wise fusion and reduction fusion;
 //
 // * note computational graph
 // In theory, computational graph should refer to only the computational nodes
@@ -67,6 +72,17 @@ class FusionExecutorCache {
   std::vector<at::Tensor> runFusionWithInputs(
       const at::ArrayRef<IValue>& inputs);
 
+  // `runFusionWithInputs` calls that ran an already compiled kernel (hits)
+  // and calls that had to compile a new one (misses);
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+  };
+
+  const Stats& stats() const {
+    return stats_;
+  }
+
  private:
   // device_ where compiled binaries are loaded on & inputs are expected to
   // reside;
@@ -84,14 +100,20 @@ class FusionExecutorCache {
   //    `pw_fusion_executor_cache_`
   // 2. For reduction fusion we have a hash table with ReductionParams as entry
   //    pointing to the actual `FusionExecutor` in `red_fusion_executor_cache_`
+  //    (normalizations scheduled by `scheduleNormalization` included)
   //
   // Unfortunately, at run-time in order to search compatible `FusionExecutor`,
   // we have to call `scheduleReduction` in order to get an instance of
-  // `ReductionParams` for indexing. This is not very efficient. Hence the TODO:
-  // add a direct cache from inputs shapes to `FusionExecutor` entries.
+  // `ReductionParams` for indexing. This is not very efficient, so we also
+  // keep a direct cache from input sizes to the `FusionExecutor` entries in
+  // `red_fusion_executor_cache_`, which skips scheduling for sizes we have
+  // seen before.
   std::unique_ptr<FusionExecutor> pw_fusion_executor_cache_;
   std::unordered_map<ReductionParams, FusionExecutor, ReductionParamsHash>
       red_fusion_executor_cache_;
+  std::map<std::vector<int64_t>, FusionExecutor*> red_input_sizes_cache_;
+
+  Stats stats_;
 };
 
 class GraphCache {
@@ -107,6 +129,9 @@ class GraphCache {
   std::vector<at::Tensor> runGraphWithInputs(
       const at::ArrayRef<IValue>& inputs);
 
+  // kernel cache statistics summed over all `FusionExecutorCache` entries;
+  FusionExecutorCache::Stats stats() const;
+
  private:
   // TODO: place holder with naive implementation for now.
   // structure use to mark the compatibility of each FusionExecutorCache;
@@ -142,6 +167,9 @@ class GraphCache {
     // helper function used at run-time to check whether a common permutation is
     // present, this is used to take the short-cut to skip permutation logic.
     bool requiresPermutation();
+
+    // drops the common permutation, inputs are then fed in their own order;
+    void disablePermutation();
   };
 
   // construct FusionExecutorCache per InputsRequirement.
@@ -155,6 +183,8 @@ class GraphCache {
   std::shared_ptr<Graph> graph_;
   // TODO: poor name, we should use `eliminated_axes_` instead;
   at::DimVector reduction_axes_;
+  // whether graph_ contains view/permute, see `isLayoutNode`;
+  bool has_layout_node_ = false;
 
   // TODO: we should really hash instead of iterative check. Optimize later...
   //       unordered_map<InputsRequirement, FusionExecutorCache>;
@@ -97,7 +97,9 @@ void GpuLower::buildSizesMap() {
   for (TensorView* tv : inputs_and_outputs) {
     // Replace the domain with one based on Ti.size[j]
     std::vector<IterDomain*> new_domain_iters;
-    const std::vector<IterDomain*>& root_td = tv->getRootDomain();
+    // Global tensors are laid out per their rfactor domain, see
+    // Index::getGlobalProducerIndex
+    const std::vector<IterDomain*>& root_td = tv->getMaybeRFactorDomain();
 
     size_t dim = 0;
     for (auto id : root_td) {
@@ -119,11 +121,12 @@ void GpuLower::buildSizesMap() {
 
       if (kir_map_.find(orig_size) == kir_map_.end()) {
         std::stringstream ss;
-        ss << "T" << tv->name() << ".size[" << dim++ << "]";
+        ss << "T" << tv->name() << ".size[" << dim << "]";
         auto new_size =
             new kir::NamedScalar(ss.str(), orig_size->getDataType().value());
         kir_map_[orig_size] = new_size;
       }
+      dim++;
     }
   }
 }
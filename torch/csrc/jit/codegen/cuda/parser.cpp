@@ -23,6 +23,7 @@ constexpr auto kNumUnaryOps = 31;
 constexpr auto kNumBinaryOps = 24;
 constexpr auto kNumBinaryOpsWithAlpha = 4;
 constexpr auto kNumLerpOps = 2;
+constexpr auto kNumViewOps = 2;
 
 namespace {
 
@@ -177,6 +178,16 @@ class IrParser {
     return jit_reduction_op_registry_.count(node->kind());
   }
 
+  static bool isLayoutNode(const Node* node) {
+    if (init_registry_) {
+      // TODO: mutex this guy;
+      registerJitOperator();
+      init_registry_ = false;
+    }
+
+    return jit_layout_op_registry_.count(node->kind());
+  }
+
   // TODO: is_reduction is too hacky here. we should categorize operation types
   //       based on their memory accessing pattern, which would affect fusion
   //       strategy and partition logic.
@@ -522,6 +533,97 @@ class IrParser {
           },
           true);
     }
+
+    {
+      auto ptr_op = getOperatorForLiteral(
+          "aten::permute(Tensor(a) self, int[] dims) -> Tensor(a)");
+      registerParseRule(
+          ptr_op,
+          [](const Node* node,
+             std::unordered_map<size_t, CgValue>& value_map) -> void {
+            auto self = value_map[node->input(0)->unique()];
+            auto dims_list = constant_as<c10::List<int64_t>>(node->input(1));
+            TORCH_INTERNAL_ASSERT(
+                dims_list.has_value(), "requires static permute dims");
+            std::vector<int> dims;
+            for (const auto dim : dims_list->vec()) {
+              dims.emplace_back(static_cast<int>(dim));
+            }
+            auto out = permute(self->as<TensorView>(), dims);
+            value_map.emplace(node->output()->unique(), out);
+          },
+          [](const Node* node) -> bool {
+            // we don't support dynamic permute dims;
+            return node->input(1)->node()->kind() == prim::Constant;
+          });
+      jit_layout_op_registry_.emplace(aten::permute);
+    }
+
+    {
+      auto ptr_op = getOperatorForLiteral(
+          "aten::transpose.int(Tensor(a) self, int dim0, int dim1) -> Tensor(a)");
+      registerParseRule(
+          ptr_op,
+          [](const Node* node,
+             std::unordered_map<size_t, CgValue>& value_map) -> void {
+            auto self = value_map[node->input(0)->unique()];
+            auto dim0 = constant_as<int64_t>(node->input(1));
+            auto dim1 = constant_as<int64_t>(node->input(2));
+            TORCH_INTERNAL_ASSERT(
+                dim0.has_value() && dim1.has_value(),
+                "requires static transpose dims");
+            auto out = transpose(
+                self->as<TensorView>(),
+                static_cast<int>(dim0.value()),
+                static_cast<int>(dim1.value()));
+            value_map.emplace(node->output()->unique(), out);
+          },
+          [](const Node* node) -> bool {
+            // we don't support dynamic transpose dims;
+            return node->input(1)->node()->kind() == prim::Constant &&
+                node->input(2)->node()->kind() == prim::Constant;
+          });
+      jit_layout_op_registry_.emplace(aten::transpose);
+    }
+
+    {
+      std::array<const char*, kNumViewOps> ViewOps = {
+          "aten::view(Tensor(a) self, int[] size) -> Tensor(a)",
+          "aten::reshape(Tensor(a) self, int[] shape) -> Tensor(a)"};
+      for (auto signature : ViewOps) {
+        auto ptr_op = getOperatorForLiteral(signature);
+        registerParseRule(
+            ptr_op,
+            [](const Node* node,
+               std::unordered_map<size_t, CgValue>& value_map) -> void {
+              auto self = value_map[node->input(0)->unique()];
+              auto original_sizes = node->input(0)
+                                        ->type()
+                                        ->cast<TensorType>()
+                                        ->sizes()
+                                        .concrete_sizes();
+              auto new_sizes = constant_as<c10::List<int64_t>>(node->input(1));
+              TORCH_INTERNAL_ASSERT(
+                  original_sizes.has_value() && new_sizes.has_value(),
+                  "requires static view sizes");
+              auto out = view(
+                  self->as<TensorView>(),
+                  original_sizes.value(),
+                  new_sizes->vec());
+              value_map.emplace(node->output()->unique(), out);
+            },
+            [](const Node* node) -> bool {
+              // we need the sizes of both shapes to tell which dimensions are
+              // merged and split;
+              auto self_type = node->input(0)->type()->cast<TensorType>();
+              return self_type &&
+                  self_type->sizes().concrete_sizes().has_value() &&
+                  node->input(1)->node()->kind() == prim::Constant;
+            });
+      }
+      jit_layout_op_registry_.emplace(aten::view);
+      jit_layout_op_registry_.emplace(aten::reshape);
+    }
   }
 
   void processJitNode(const JitOp* node) {
@@ -625,6 +727,7 @@ class IrParser {
       std::vector<std::pair<std::shared_ptr<Operator>, RegistrationEntry>>>
       jit_operator_registry_;
   static std::unordered_set<Symbol> jit_reduction_op_registry_;
+  static std::unordered_set<Symbol> jit_layout_op_registry_;
   static bool init_registry_;
 };
 
@@ -634,6 +737,7 @@ std::unordered_map<
         std::pair<std::shared_ptr<Operator>, IrParser::RegistrationEntry>>>
     IrParser::jit_operator_registry_;
 std::unordered_set<Symbol> IrParser::jit_reduction_op_registry_;
+std::unordered_set<Symbol> IrParser::jit_layout_op_registry_;
 bool IrParser::init_registry_ = true;
 
 } // namespace
@@ -656,6 +760,10 @@ bool isReductionNode(const Node* node) {
   return IrParser::isReductionNode(node);
 }
 
+bool isLayoutNode(const Node* node) {
+  return IrParser::isLayoutNode(node);
+}
+
 bool isNodeParsible(const Node* node) {
   return IrParser::canParseNode(node);
 }
@@ -34,6 +34,11 @@ TORCH_CUDA_API bool hasReductionNode(const Block* block);
 
 TORCH_CUDA_API bool isReductionNode(const Node* node);
 
+// returns whether the node only changes the layout of its input, i.e. view,
+// reshape, permute and transpose. These alias their input in eager mode but
+// produce a new tensor inside a fusion.
+TORCH_CUDA_API bool isLayoutNode(const Node* node);
+
 // returns whether or not a parsing function exists for the given node type.
 TORCH_CUDA_API bool isNodeParsible(const Node* node);
 
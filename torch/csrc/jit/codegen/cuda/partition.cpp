@@ -85,6 +85,10 @@ bool maybeBroadcastOnShape(
   TORCH_INTERNAL_ASSERT(
       n->outputs().size() == 1,
       "not expecting multiple outputs from a node, graph partitioning logic needs to be updated");
+  // views change the rank without broadcasting;
+  if (isLayoutNode(n)) {
+    return false;
+  }
   // assumes that if output is not a tensor type, it's not broadcasting
   if (auto out_type = n->output(0)->type()->cast<TensorType>()) {
     if (out_type->dim()) {
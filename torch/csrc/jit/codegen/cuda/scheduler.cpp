@@ -10,6 +10,9 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace torch {
 namespace jit {
 namespace fuser {
@@ -363,6 +366,53 @@ ReductionParams reductionHeuristic(
       LaunchParams::UNINITIALIZED_VAL);
   return rparams;
 }
+
+// Every thread keeps persistent_factor elements of the row in registers, see
+// scheduleNormalization.
+c10::optional<ReductionParams> normalizationHeuristic(
+    int red_elems,
+    bool red_on_fastest_dim) {
+  TORCH_INTERNAL_ASSERT(red_elems > 0);
+
+  constexpr int kMaxNumThreads = 512;
+  // Beyond this the row is kept in too many registers per thread
+  constexpr int kMaxPersistentFactor = 8;
+
+  ReductionParams rparams;
+  rparams.fastest_dim = red_on_fastest_dim;
+  rparams.cross_block = true;
+  rparams.persistent = true;
+
+  const int bdimx = red_elems >= kMaxNumThreads
+      ? kMaxNumThreads
+      : std::max(at::cuda::warp_size(), lastPow2(red_elems));
+  rparams.persistent_factor = ceilDiv(red_elems, bdimx);
+  if (rparams.persistent_factor > kMaxPersistentFactor) {
+    return c10::nullopt;
+  }
+
+  const char* debug_env = getenv("PYTORCH_CUDA_FUSER_RED_SCHED_DEBUG");
+  if (debug_env && atoi(debug_env)) {
+    std::cout << "\n===== Normalization Parameters ====" << std::endl
+              << "Inputs:" << std::endl
+              << "\tRed Elems: " << red_elems << " Red On Fastest Dim? "
+              << red_on_fastest_dim << std::endl
+              << "Recommended Blocking:" << std::endl
+              << "\tBlckX: " << bdimx
+              << " Persistent Factor: " << rparams.persistent_factor
+              << std::endl
+              << "====================================" << std::endl;
+  }
+
+  rparams.lparams = LaunchParams(
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      bdimx,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL);
+  return rparams;
+}
 } // anonymous namespace
 
 // fusion is the input IR that will be modified by this function
@@ -709,6 +759,177 @@ c10::optional<ReductionParams> scheduleReduction(
   return rparams;
 }
 
+namespace {
+
+// Moves the given axes of a tensor that isn't scheduled yet to the right,
+// keeping the order of the other axes
+void moveAxesRight(TensorView* tv, const std::vector<int>& axes) {
+  const int n_dims = static_cast<int>(tv->nDims());
+  int outer_pos = 0;
+  int inner_pos = n_dims - static_cast<int>(axes.size());
+  std::unordered_map<int, int> old2new;
+  for (int i = 0; i < n_dims; i++) {
+    if (std::find(axes.begin(), axes.end(), i) != axes.end()) {
+      old2new[i] = inner_pos++;
+    } else {
+      old2new[i] = outer_pos++;
+    }
+  }
+  tv->reorder(old2new);
+}
+
+// Splits the row of a [rows, row] tensor into
+//      [rows, |Row-Leftover, Persistent, X-Block|]
+// Idx:   0    |    1(-3)       2(-2)      3(-1) |
+// With persistent_factor * bdimx covering the row, Row-Leftover has an
+// extent of 1. It is bound to TIDy, so it neither makes the register
+// allocation depend on the row size nor needs a loop.
+void splitRow(TensorView* tv, const ReductionParams& rparams) {
+  tv->split(1, rparams.lparams.bdimx());
+  tv->split(1, rparams.persistent_factor);
+}
+
+void parallelizeRow(TensorView* tv) {
+  tv->axis(0)->parallelize(ParallelType::BIDx);
+  tv->axis(1)->parallelize(ParallelType::TIDy);
+  tv->axis(-1)->parallelize(ParallelType::TIDx);
+}
+
+} // namespace
+
+c10::optional<ReductionParams> scheduleNormalization(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& fusion_inputs) {
+  FusionGuard fg(fusion);
+
+  std::vector<TensorView*> tvs;
+  std::vector<TensorView*> red_tvs;
+  bool reduction_consumed = false;
+  for (auto expr : fusion->exprs()) {
+    for (auto out : expr->outputs()) {
+      if (out->getValType() != ValType::TensorView) {
+        continue;
+      }
+      TensorView* tv = out->as<TensorView>();
+      tvs.push_back(tv);
+      if (expr->getExprType() == ExprType::ReductionOp) {
+        red_tvs.push_back(tv);
+        reduction_consumed =
+            reduction_consumed || !fusion->unordered_uses(tv).empty();
+      }
+    }
+  }
+  // Reductions that are only outputs are left to scheduleReduction
+  if (!reduction_consumed) {
+    return c10::nullopt;
+  }
+
+  const auto& red_root = red_tvs[0]->getRootDomain();
+  const size_t rank = red_root.size();
+  std::vector<int> row_axes;
+  for (size_t i = 0; i < rank; i++) {
+    if (red_root[i]->isReduction()) {
+      row_axes.push_back(static_cast<int>(i));
+    }
+  }
+  const size_t num_iter_axes = rank - row_axes.size();
+  if (num_iter_axes == 0) {
+    return c10::nullopt;
+  }
+
+  // Every tensor has to be either a row tensor, of the rank of the
+  // reductions, or a reduced tensor holding a single value per row, such as
+  // a mean. Only reductions may reduce and only the row axes.
+  for (auto tv : tvs) {
+    const auto& root = tv->getRootDomain();
+    if (tv->hasComputeAt() || tv->nDims() != root.size()) {
+      return c10::nullopt;
+    }
+    if (root.size() == num_iter_axes && !tv->hasReduction()) {
+      continue;
+    }
+    if (root.size() != rank) {
+      return c10::nullopt;
+    }
+    const bool is_red =
+        std::find(red_tvs.begin(), red_tvs.end(), tv) != red_tvs.end();
+    for (size_t i = 0; i < rank; i++) {
+      const bool is_row_axis =
+          std::find(row_axes.begin(), row_axes.end(), static_cast<int>(i)) !=
+          row_axes.end();
+      if (root[i]->isReduction() != (is_red && is_row_axis)) {
+        return c10::nullopt;
+      }
+    }
+  }
+
+  EvaluationContext eval_context(
+      executor_utils::bindInputs(fusion_inputs, fusion));
+  int64_t red_elems = 1;
+  for (auto axis : row_axes) {
+    const auto extent =
+        ExpressionEvaluator::evaluate(red_root[axis]->extent(), &eval_context);
+    if (!extent.has_value()) {
+      return c10::nullopt;
+    }
+    red_elems *= extent.value();
+  }
+  if (red_elems <= 0 || red_elems > std::numeric_limits<int>::max()) {
+    return c10::nullopt;
+  }
+
+  const bool red_on_fastest_dim = row_axes.back() == (int)rank - 1;
+  auto rparams = normalizationHeuristic(red_elems, red_on_fastest_dim);
+  if (!rparams.has_value()) {
+    return c10::nullopt;
+  }
+
+  // Read each row input from global memory once, into registers
+  for (auto input : fusion->inputs()) {
+    if (input->getValType() == ValType::TensorView &&
+        input->as<TensorView>()->getRootDomain().size() == rank &&
+        !fusion->unordered_uses(input).empty()) {
+      tvs.push_back(input->as<TensorView>()->cache_after());
+    }
+  }
+
+  // No tensor is computed at another one, so each expression gets its own
+  // loop nest over the row slice of a thread. The block reductions and
+  // broadcasts in between synchronize the threads of a row, and all other
+  // intermediates are local arrays of persistent_factor elements.
+  for (auto tv : tvs) {
+    if (tv->nDims() == num_iter_axes) {
+      while (tv->nDims() > 1) {
+        tv->merge(0);
+      }
+      tv->axis(0)->parallelize(ParallelType::BIDx);
+      continue;
+    }
+
+    // Coalesce the row axes to the right, then merge into [rows, row]
+    moveAxesRight(tv, row_axes);
+    for (size_t i = 1; i < num_iter_axes; i++) {
+      tv->merge(0);
+    }
+    while (tv->nDims() > 2) {
+      tv->merge(1);
+    }
+    splitRow(tv, rparams.value());
+
+    if (tv->hasReduction()) {
+      // Each thread first reduces its persistent elements, the block then
+      // reduces across the threads of the row
+      //      [rows, |Row-Leftover, X-Block|]
+      // Idx:   0    |    1(-2)      2(-1) |
+      auto tv_rf = tv->rFactor({2});
+      parallelizeRow(tv_rf);
+    }
+    parallelizeRow(tv);
+  }
+
+  return rparams;
+}
+
 } // namespace cuda
 } // namespace fuser
 } // namespace jit
@@ -23,13 +23,18 @@ struct ReductionParams {
   bool cross_block = false;
   bool cross_grid = false;
   bool mul_reds_per_blk = false;
+  // Normalization Attributes, see scheduleNormalization
+  bool persistent = false;
+  int persistent_factor = 1;
 
   LaunchParams lparams;
 
   bool operator==(const ReductionParams& other) const {
     bool attr_equal = other.fastest_dim == fastest_dim &&
         other.cross_block == cross_block && other.cross_grid == cross_grid &&
-        other.mul_reds_per_blk == mul_reds_per_blk;
+        other.mul_reds_per_blk == mul_reds_per_blk &&
+        other.persistent == persistent &&
+        other.persistent_factor == persistent_factor;
     return attr_equal && lparams == other.lparams;
   }
 };
@@ -43,8 +48,9 @@ class ReductionParamsHash {
     size_t attr_hash = static_cast<size_t>(rp.fastest_dim) << (bits - 1) |
         static_cast<size_t>(rp.cross_block) << (bits - 2) |
         static_cast<size_t>(rp.cross_grid) << (bits - 3) |
-        static_cast<size_t>(rp.mul_reds_per_blk) << (bits - 4);
-    return lp_hash | attr_hash;
+        static_cast<size_t>(rp.mul_reds_per_blk) << (bits - 4) |
+        static_cast<size_t>(rp.persistent) << (bits - 5);
+    return (lp_hash ^ static_cast<size_t>(rp.persistent_factor)) | attr_hash;
   }
 };
 
@@ -53,6 +59,18 @@ TORCH_CUDA_API c10::optional<ReductionParams> scheduleReduction(
     const at::ArrayRef<c10::IValue>& fusion_inputs,
     TensorView* red_tv);
 
+// Schedules a fusion whose reductions are consumed within the fusion, the
+// pattern of softmax, layer_norm and batch_norm, as a single persistent
+// kernel: each block owns whole rows, every thread keeps its slice of the row
+// in registers across the reductions and the elementwise ops around them, so
+// the stats, normalize and affine steps run without a round trip through
+// global memory. All reductions have to reduce the same axes. Returns
+// c10::nullopt without modifying the fusion if it doesn't have that pattern
+// or the rows are too long to keep in registers.
+TORCH_CUDA_API c10::optional<ReductionParams> scheduleNormalization(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& fusion_inputs);
+
 } // namespace cuda
 } // namespace fuser
 } // namespace jit
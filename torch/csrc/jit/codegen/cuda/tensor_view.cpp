@@ -492,7 +492,8 @@ TensorView* TensorView::cache_after() {
   // Keep Broadcast Axis (Permanent)
   // Remove Reduction Axis
   size_t i = 0;
-  auto no_reduction_root_domain = TensorDomain::noReductions(getRootDomain());
+  auto no_reduction_root_domain =
+      TensorDomain::noReductions(getMaybeRFactorDomain());
   std::vector<IterDomain*> new_root_domain(no_reduction_root_domain.size());
   for (auto dom : no_reduction_root_domain) {
     new_root_domain[i++] = dom->clone();
@@ -3,6 +3,7 @@
 #include <c10/util/Optional.h>
 #include <torch/csrc/jit/codegen/fuser/compiler.h>
 #include <torch/csrc/jit/codegen/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/codegen/fuser/kernel_disk_cache.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 #include <torch/csrc/utils/memory.h>
 
@@ -173,18 +174,24 @@ struct CompilerConfig {
     if (cxx_env != nullptr) {
       cxx = cxx_env;
     }
+  }
+
+  ~CompilerConfig() = default;
 
+  // Looking for the compiler spawns processes, so it is only done once a
+  // kernel has to be compiled. Kernels loaded from the disk cache never need
+  // a compiler, which may not even be installed.
+  bool findCompiler() {
+    if (!searched) {
+      searched = true;
 #ifdef _MSC_VER
-    activate();
+      activate();
 #endif
-
-    if (!programExists(cxx)) {
-      cxx = "";
+      found = programExists(cxx);
     }
+    return found;
   }
 
-  ~CompilerConfig() = default;
-
 #ifdef _MSC_VER
   std::string cxx = "cl";
   const std::string openmp_flags = "/openmp";
@@ -193,6 +200,8 @@ struct CompilerConfig {
   const std::string openmp_flags = "-fopenmp";
 #endif
   bool openmp = true;
+  bool searched = false;
+  bool found = false;
 };
 
 static CompilerConfig& getConfig() {
@@ -249,6 +258,11 @@ static void runCompiler(
     const std::string& cpp_file,
     const std::string& so_file) {
   auto& config = getConfig();
+  TORCH_CHECK(
+      config.findCompiler(),
+      "Failed to compile a fused CPU kernel, compiler '",
+      config.cxx,
+      "' not found. Set CXX to a C++ compiler.");
   TemplateEnv env;
   env.s("cxx", config.cxx);
   env.s("fopenmp", config.openmp ? config.openmp_flags : "");
@@ -269,6 +283,17 @@ static void runCompiler(
   TORCH_CHECK(r == 0, "Failed to compile a fused CPU kernel");
 }
 
+// What a kernel is compiled for, as part of its key in the disk cache
+static std::string compilerTarget(bool openmp) {
+  auto& config = getConfig();
+  TemplateEnv env;
+  env.s("cxx", config.cxx);
+  env.s("fopenmp", openmp ? config.openmp_flags : "");
+  env.s("cpp_file", "");
+  env.s("so_file", "");
+  return format(compile_string, env);
+}
+
 #ifdef _MSC_VER
 static const std::string disas_string =
     "dumpbin /DISASM:NOBYTES \"${so_file}\"";
@@ -299,18 +324,34 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
-  TempFile so_file(so_template, so_suffix_len);
-  TempFile cpp_file(cpp_template, cpp_suffix_len);
-  cpp_file.write(code_);
-  cpp_file.sync();
+  const std::string so_suffix =
+      so_template.substr(so_template.size() - so_suffix_len);
+  auto& config = getConfig();
+  auto cached =
+      lookupKernelArtifact(code_, compilerTarget(config.openmp), so_suffix);
+  if (!cached && config.openmp) {
+    // the process that compiled it may have had to do without OpenMP
+    cached = lookupKernelArtifact(code_, compilerTarget(false), so_suffix);
+  }
+  if (cached) {
+    so_lib = make_unique<at::DynamicLibrary>(cached->c_str());
+  } else {
+    TempFile so_file(so_template, so_suffix_len);
+    TempFile cpp_file(cpp_template, cpp_suffix_len);
+    cpp_file.write(code_);
+    cpp_file.sync();
 #ifdef _MSC_VER
-  so_file.close();
-  cpp_file.close();
+    so_file.close();
+    cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    runCompiler(cpp_file.name(), so_file.name());
+    if (debugFuser() >= 2)
+      disas(so_file.name());
+    so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    // compiling may have turned off OpenMP
+    storeKernelArtifactFile(
+        code_, compilerTarget(config.openmp), so_suffix, so_file.name());
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
       reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
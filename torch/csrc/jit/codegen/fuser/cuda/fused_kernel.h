@@ -43,6 +43,9 @@ struct TORCH_CUDA_API FusedKernelCUDA
  private:
   static constexpr auto kBlockSize = 128;
 
+  // Compiles code_ with NVRTC into ptx_
+  void compileToPTX(const std::vector<const char*>& args);
+
   // Note: per device to store device properties and compute launch heuristics
   //  Acquiring these values at launch time would be too slow
   int16_t device_;
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/codegen/fuser/executor.h>
 #include <torch/csrc/jit/codegen/fuser/fallback.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
+#include <torch/csrc/jit/codegen/fuser/kernel_disk_cache.h>
 
 #include <stdexcept>
 
@@ -45,6 +46,10 @@ void overrideCanFuseOnGPU(bool value) {
   detail::gpu_fuser_enabled = value;
 }
 
+void setFusedKernelCacheDir(std::string dir) {
+  fuser::setKernelDiskCacheDir(std::move(dir));
+}
+
 // Uses the above interface by stuffing the graph into a node and treating that
 // node as a fusion group.
 std::vector<at::Tensor> debugLaunchGraph(
@@ -35,6 +35,11 @@ TORCH_API void overrideCanFuseOnCPU(bool value);
 // Sets whether fusion on the GPU is allowed (enabled by default)
 TORCH_API void overrideCanFuseOnGPU(bool value);
 
+// Sets the directory of the on-disk cache of compiled fusion kernels, so that
+// a restarted process does not compile them again. An empty string disables
+// the cache. Defaults to the PYTORCH_FUSER_CACHE_DIR environment variable.
+TORCH_API void setFusedKernelCacheDir(std::string dir);
+
 // Treats the given graph as a fusion group and launches it on the
 // specified device with the given inputs.
 // Returns the outputs.
@@ -0,0 +1,177 @@
+#include <torch/csrc/jit/codegen/fuser/kernel_disk_cache.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/Fnv1a.h>
+#include <torch/csrc/jit/codegen/fuser/compiler.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+namespace {
+
+std::mutex& cacheDirMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::string& cacheDir() {
+  static std::string dir = [] {
+    const char* env = std::getenv("PYTORCH_FUSER_CACHE_DIR");
+    return env ? std::string(env) : std::string();
+  }();
+  return dir;
+}
+
+std::string entryPrefix(
+    const std::string& dir,
+    const std::string& code,
+    const std::string& target) {
+  // the separator keeps ("ab", "c") and ("a", "bc") apart
+  uint64_t h = c10::util::fnv1a64(code, c10::util::fnv1a64(target + '\0'));
+  std::ostringstream path;
+  path << dir << "/fused_" << std::hex << std::setw(16) << std::setfill('0')
+       << h;
+  return path.str();
+}
+
+bool readFile(const std::string& path, std::string& contents) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  contents = ss.str();
+  return static_cast<bool>(in);
+}
+
+bool writeFileAtomically(
+    const std::string& path,
+    const std::string& contents) {
+  std::random_device rd;
+  std::string tmp_path = path + ".tmp" + std::to_string(rd());
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+    out.write(contents.data(), contents.size());
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Returns the prefix of the entry for (code, target) if the cache is enabled
+// and holds it. The source is stored next to the artifact and compared, so
+// that a hash collision can never load the wrong kernel.
+c10::optional<std::string> findEntry(
+    const std::string& code,
+    const std::string& target) {
+  auto dir = kernelDiskCacheDir();
+  if (!dir) {
+    return c10::nullopt;
+  }
+  std::string prefix = entryPrefix(*dir, code, target);
+  std::string key;
+  if (!readFile(prefix + ".key", key) || key != target + '\0' + code) {
+    return c10::nullopt;
+  }
+  return prefix;
+}
+
+} // namespace
+
+void setKernelDiskCacheDir(std::string dir) {
+  std::lock_guard<std::mutex> lock(cacheDirMutex());
+  cacheDir() = std::move(dir);
+}
+
+c10::optional<std::string> kernelDiskCacheDir() {
+  std::lock_guard<std::mutex> lock(cacheDirMutex());
+  if (cacheDir().empty()) {
+    return c10::nullopt;
+  }
+  return cacheDir();
+}
+
+c10::optional<std::string> lookupKernelArtifact(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension) {
+  auto prefix = findEntry(code, target);
+  if (!prefix) {
+    return c10::nullopt;
+  }
+  std::string path = *prefix + extension;
+  if (!std::ifstream(path)) {
+    return c10::nullopt;
+  }
+  if (debugFuser()) {
+    std::cout << "Loading fused kernel from " << path << std::endl;
+  }
+  return path;
+}
+
+c10::optional<std::string> readKernelArtifact(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension) {
+  auto path = lookupKernelArtifact(code, target, extension);
+  std::string artifact;
+  if (!path || !readFile(*path, artifact)) {
+    return c10::nullopt;
+  }
+  return artifact;
+}
+
+void storeKernelArtifact(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension,
+    const std::string& artifact) {
+  auto dir = kernelDiskCacheDir();
+  if (!dir) {
+    return;
+  }
+  std::string prefix = entryPrefix(*dir, code, target);
+  // the artifact goes first, an entry only becomes visible with its key
+  if (!writeFileAtomically(prefix + extension, artifact) ||
+      !writeFileAtomically(prefix + ".key", target + '\0' + code)) {
+    TORCH_WARN("failed to store a fused kernel in ", *dir);
+  }
+}
+
+void storeKernelArtifactFile(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension,
+    const std::string& path) {
+  if (!kernelDiskCacheDir()) {
+    return;
+  }
+  std::string artifact;
+  if (readFile(path, artifact)) {
+    storeKernelArtifact(code, target, extension, artifact);
+  }
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
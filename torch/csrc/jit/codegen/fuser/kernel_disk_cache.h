@@ -0,0 +1,56 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <string>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// An opt-in cache of compiled fusion kernels on disk, shared by all processes
+// that use the same directory. It is enabled by setting the
+// PYTORCH_FUSER_CACHE_DIR environment variable or by calling
+// setKernelDiskCacheDir(). Entries are keyed by the generated kernel source
+// and a target string describing what it was compiled for (compiler and
+// flags, device architecture), so kernels are only reused for identical
+// fusion groups on identical hardware. Failing to read or write the cache
+// never fails a compilation.
+
+// An empty directory disables the cache.
+TORCH_API void setKernelDiskCacheDir(std::string dir);
+TORCH_API c10::optional<std::string> kernelDiskCacheDir();
+
+// Looks up the compiled artifact of `code` built for `target`. Returns the
+// path of the cached file on a hit.
+c10::optional<std::string> lookupKernelArtifact(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension);
+
+// Same as lookupKernelArtifact but returns the contents of the file.
+c10::optional<std::string> readKernelArtifact(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension);
+
+// Stores the compiled artifact of `code` built for `target`. The file is
+// written under a temporary name and renamed into place, so concurrent
+// readers never see a partial artifact.
+void storeKernelArtifact(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension,
+    const std::string& artifact);
+
+// Same as storeKernelArtifact with the contents of the file at `path`.
+void storeKernelArtifactFile(
+    const std::string& code,
+    const std::string& target,
+    const std::string& extension,
+    const std::string& path);
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -206,6 +206,16 @@ size_t HashNode::operator()(const Node* k) const {
       constant_hash = std::hash<double>{}(k->f(attr::value));
     } else if (type->isSubtypeOf(BoolType::get())) {
       constant_hash = std::hash<bool>{}(k->i(attr::value));
+    } else if (
+        k->hasAttribute(attr::value) &&
+        k->kindOf(attr::value) == AttributeKind::s) {
+      // Otherwise all of the string constants of a graph would collide
+      constant_hash = std::hash<std::string>{}(k->s(attr::value));
+    } else if (
+        k->hasAttribute(attr::value) &&
+        k->kindOf(attr::value) == AttributeKind::t) {
+      const auto& t = k->t(attr::value);
+      constant_hash = get_hash(t.scalar_type(), t.sizes().vec());
     }
   }
   return get_hash(
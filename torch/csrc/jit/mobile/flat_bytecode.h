@@ -0,0 +1,62 @@
+#pragma once
+#include <torch/csrc/jit/runtime/instruction.h>
+
+#include <cstdint>
+
+// Layout of bytecode.ff, an alternative to bytecode.pkl that
+// _load_for_mobile uses in place, without unpickling. Modules saved with
+// _save_for_mobile(..., flat_bytecode=true) have it instead of bytecode.pkl.
+//
+// Offsets are from the start of the record, which the archive aligns like
+// all its records, and every array is aligned on its element size. Fields
+// are little-endian. A string is a uint32_t length followed by that many
+// characters, without terminator.
+//
+// The constants are IValues, and are kept in the bytecode_constants.pkl
+// archive: a tuple holding the tuple of constants of each function, in the
+// order of the function table.
+
+namespace torch {
+namespace jit {
+namespace mobile {
+namespace flat {
+
+constexpr char kMagic[4] = {'P', 'T', 'F', 'B'};
+constexpr uint32_t kFormatVersion = 1;
+
+struct Header {
+  char magic[4];
+  uint32_t format_version;
+  // same as the first element of bytecode.pkl
+  int64_t bytecode_version;
+  uint32_t num_functions;
+  // offset of Function[num_functions]
+  uint32_t functions;
+};
+
+struct Function {
+  // offset of the qualified name
+  uint32_t name;
+  uint32_t register_size;
+  uint32_t num_instructions;
+  // offset of Instruction[num_instructions]
+  uint32_t instructions;
+  uint32_t num_operators;
+  // offset of uint32_t[2 * num_operators], the offsets of the name and
+  // overload name of each operator
+  uint32_t operators;
+  uint32_t num_types;
+  // offset of uint32_t[num_types], the offsets of the type annotations
+  uint32_t types;
+};
+
+static_assert(sizeof(Header) == 24, "bytecode.ff header layout changed");
+static_assert(sizeof(Function) == 32, "bytecode.ff function layout changed");
+static_assert(
+    sizeof(Instruction) == 8,
+    "bytecode.ff stores instructions as they are in memory");
+
+} // namespace flat
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -35,15 +35,17 @@ bool Function::append_operator(
   auto opname = code_->op_names_.back();
 
   auto opname_c10 = opname;
-  std::function<void(Stack&)> fn;
+  Operation fn;
 
+  // The operation is taken out of the operator here, once, so that running
+  // it is a single indirect call
   auto jit_op = findOperatorFor(opname);
   if (jit_op) {
-    fn = [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
+    fn = jit_op->getOperation();
   } else {
     auto op = c10::Dispatcher::singleton().findSchema(opname_c10);
     if (op.has_value()) {
-      fn = [op](Stack& stack) { op->callBoxed(&stack); };
+      fn = [op = *op](Stack* stack) { op.callBoxed(stack); };
     } else {
       return false;
     }
@@ -56,13 +58,13 @@ bool Function::append_operator(
     // https://github.com/pytorch/pytorch/pull/40737. This wrapper is used to
     // handle backward compatibility, where there is no default bool value in
     // old models.
-    fn = [fn](Stack& stack) {
-      stack.push_back(true);
+    fn = [fn](Stack* stack) {
+      stack->push_back(true);
       fn(stack);
     };
   }
 
-  code_->operators_.emplace_back(fn);
+  code_->operators_.emplace_back(std::move(fn));
   return true;
 }
 
@@ -2,12 +2,14 @@
 #include <ATen/core/ivalue.h>
 #include <caffe2/serialize/inline_container.h>
 #include <torch/csrc/jit/api/compilation_unit.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 #include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/serialization/import_export_constants.h>
 #include <torch/csrc/jit/serialization/unpickler.h>
 #include <torch/custom_class.h>
 
+#include <cstring>
 #include <exception>
 #include <fstream>
 #include <string>
@@ -86,6 +88,42 @@ void print_unsupported_ops_and_throw(
   TORCH_CHECK(false, "Following ops cannot be found:", error_message);
 }
 
+void check_model_version(int64_t model_version) {
+  TORCH_CHECK(
+      caffe2::serialize::kMinSupportedBytecodeVersion <= model_version &&
+          model_version <= caffe2::serialize::kProducedBytecodeVersion,
+      "Lite Interpreter verson number does not match. ",
+      "The model version must be between ",
+      caffe2::serialize::kMinSupportedBytecodeVersion,
+      " and ",
+      caffe2::serialize::kProducedBytecodeVersion,
+      "But the model version is ",
+      model_version);
+}
+
+std::vector<IValue> parse_module_debug_info(
+    const IValue& debug_info_element,
+    const std::string& function_name,
+    size_t num_operators) {
+  const auto& debug_info_m_tuple = debug_info_element.toTuple()->elements();
+  const std::string& debug_info_function_name =
+      debug_info_m_tuple[0].toStringRef();
+  TORCH_CHECK(
+      debug_info_function_name == function_name,
+      "The function names in the bytecode table and the debug info table do not match.");
+  IValue debug_info_table = debug_info_m_tuple[1];
+  auto module_debug_info_list = expect_field(
+                                    debug_info_table,
+                                    "module_debug_info",
+                                    BYTECODE_INDEX_MODULE_DEBUG_INFO)
+                                    .toTuple()
+                                    ->elements();
+  TORCH_CHECK(
+      module_debug_info_list.size() == num_operators,
+      "The numbers of operators and module info strings do not match.");
+  return module_debug_info_list;
+}
+
 void parseMethods(
     const std::vector<IValue>& vals,
     const c10::optional<std::vector<IValue>>& debug_info_vals,
@@ -100,16 +138,7 @@ void parseMethods(
     model_version = vals[0].toInt();
     method_i_start = 1;
   }
-  TORCH_CHECK(
-      caffe2::serialize::kMinSupportedBytecodeVersion <= model_version &&
-          model_version <= caffe2::serialize::kProducedBytecodeVersion,
-      "Lite Interpreter verson number does not match. ",
-      "The model version must be between ",
-      caffe2::serialize::kMinSupportedBytecodeVersion,
-      " and ",
-      caffe2::serialize::kProducedBytecodeVersion,
-      "But the model version is ",
-      model_version);
+  check_model_version(model_version);
 
   bool has_debug_info = debug_info_vals.has_value();
   if (has_debug_info) {
@@ -147,23 +176,8 @@ void parseMethods(
 
     std::vector<IValue> module_debug_info_list;
     if (has_debug_info) {
-      const auto& debug_info_element = (*debug_info_vals)[i];
-      const auto& debug_info_m_tuple = debug_info_element.toTuple()->elements();
-      const std::string& debug_info_function_name =
-          debug_info_m_tuple[0].toStringRef();
-      TORCH_CHECK(
-          debug_info_function_name == function_name,
-          "The function names in the bytecode table and the debug info table do not match.");
-      IValue debug_info_table = debug_info_m_tuple[1];
-      module_debug_info_list = expect_field(
-                                   debug_info_table,
-                                   "module_debug_info",
-                                   BYTECODE_INDEX_MODULE_DEBUG_INFO)
-                                   .toTuple()
-                                   ->elements();
-      TORCH_CHECK(
-          module_debug_info_list.size() == ops_list.size(),
-          "The numbers of operators and module info strings do not match.");
+      module_debug_info_list = parse_module_debug_info(
+          (*debug_info_vals)[i], function_name, ops_list.size());
     }
 
     function->set_module_debug_info_list_size(ins_list.size());
@@ -218,6 +232,131 @@ void parseMethods(
   }
 }
 
+// Checked views into bytecode.ff, see mobile/flat_bytecode.h
+class FlatBytecode {
+ public:
+  FlatBytecode(const void* data, size_t size)
+      : data_(static_cast<const char*>(data)), size_(size) {
+    TORCH_CHECK(
+        size_ >= sizeof(mobile::flat::Header) &&
+            std::memcmp(
+                header().magic,
+                mobile::flat::kMagic,
+                sizeof(mobile::flat::kMagic)) == 0,
+        "bytecode.ff is not a flat bytecode record");
+    TORCH_CHECK(
+        header().format_version == mobile::flat::kFormatVersion,
+        "Unsupported flat bytecode format version ",
+        header().format_version);
+  }
+
+  const mobile::flat::Header& header() const {
+    return *array<mobile::flat::Header>(0, 1);
+  }
+
+  template <typename T>
+  const T* array(uint32_t offset, size_t n) const {
+    TORCH_CHECK(
+        offset % alignof(T) == 0 &&
+            reinterpret_cast<uintptr_t>(data_) % alignof(T) == 0 &&
+            offset <= size_ && n <= (size_ - offset) / sizeof(T),
+        "Invalid offset ",
+        offset,
+        " in bytecode.ff");
+    return reinterpret_cast<const T*>(data_ + offset);
+  }
+
+  std::string string(uint32_t offset) const {
+    uint32_t length = *array<uint32_t>(offset, 1);
+    return std::string(
+        array<char>(offset + sizeof(uint32_t), length), length);
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+void parseFlatMethods(
+    const FlatBytecode& bytecode,
+    const std::vector<IValue>& constants,
+    const c10::optional<std::vector<IValue>>& debug_info_vals,
+    mobile::CompilationUnit& mcu) {
+  const auto& header = bytecode.header();
+  const int64_t model_version = header.bytecode_version;
+  check_model_version(model_version);
+  TORCH_CHECK(
+      constants.size() == header.num_functions,
+      "The numbers of functions and constant tables do not match.");
+  // debug info values start with the version, like bytecode.pkl
+  bool has_debug_info = debug_info_vals.has_value();
+  if (has_debug_info) {
+    TORCH_CHECK(
+        debug_info_vals->size() == header.num_functions + 1,
+        "The numbers of bytecode values and debug info values do not match.");
+  }
+
+  const auto* functions = bytecode.array<mobile::flat::Function>(
+      header.functions, header.num_functions);
+  for (size_t i = 0; i < header.num_functions; ++i) {
+    const auto& f = functions[i];
+    const std::string function_name = bytecode.string(f.name);
+    auto function = std::unique_ptr<mobile::Function>(
+        new mobile::Function(c10::QualifiedName(function_name)));
+
+    std::vector<IValue> module_debug_info_list;
+    if (has_debug_info) {
+      module_debug_info_list = parse_module_debug_info(
+          (*debug_info_vals)[i + 1], function_name, f.num_operators);
+    }
+
+    const auto* instructions =
+        bytecode.array<Instruction>(f.instructions, f.num_instructions);
+    function->set_module_debug_info_list_size(f.num_instructions);
+    for (size_t pc = 0; pc < f.num_instructions; ++pc) {
+      const Instruction& ins = instructions[pc];
+      TORCH_CHECK(
+          isOpSupportedInMobile(ins.op),
+          "Unsupported instruction ",
+          static_cast<int>(ins.op),
+          " in bytecode.ff. The function name is ",
+          function_name);
+      function->append_instruction(ins.op, ins.X, ins.N);
+      if (ins.op == OP && has_debug_info) {
+        function->set_module_info(
+            module_debug_info_list.at(ins.X).toStringRef(), pc);
+      }
+    }
+
+    const auto* op_names =
+        bytecode.array<uint32_t>(f.operators, 2 * size_t(f.num_operators));
+    std::unordered_set<std::string> unsupported_op_names;
+    for (size_t j = 0; j < f.num_operators; ++j) {
+      auto name = bytecode.string(op_names[2 * j]);
+      auto overload_name = bytecode.string(op_names[2 * j + 1]);
+      if (!function->append_operator(name, overload_name, model_version)) {
+        unsupported_op_names.emplace(operator_str(name, overload_name));
+      }
+    }
+    if (!unsupported_op_names.empty()) {
+      print_unsupported_ops_and_throw(unsupported_op_names);
+    }
+
+    for (const auto& constant : constants[i].toTuple()->elements()) {
+      function->append_constant(constant);
+    }
+
+    const auto* types = bytecode.array<uint32_t>(f.types, f.num_types);
+    for (size_t j = 0; j < f.num_types; ++j) {
+      function->append_type(c10::parseType(bytecode.string(types[j])));
+    }
+
+    function->set_register_size(f.register_size);
+
+    mcu.register_function(std::move(function));
+  }
+}
+
 // The deserializer class which loads the bytecode package from bc files.
 class BytecodeDeserializer final {
  public:
@@ -245,13 +384,26 @@ mobile::Module BytecodeDeserializer::deserialize(
     c10::optional<at::Device> device) {
   device_ = device;
   auto mcu = std::make_shared<mobile::CompilationUnit>();
-  auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
 
   c10::optional<std::vector<IValue>> debug_info_bvals;
   if (reader_->hasRecord("mobile_debug.pkl")) {
     debug_info_bvals = readArchive("mobile_debug", mcu).toTuple()->elements();
   }
-  parseMethods(bvals, debug_info_bvals, *mcu);
+  if (reader_->hasRecord("bytecode.ff")) {
+    at::DataPtr bytecode_ptr;
+    size_t bytecode_size;
+    std::tie(bytecode_ptr, bytecode_size) = reader_->getRecord("bytecode.ff");
+    auto constants =
+        readArchive("bytecode_constants", mcu).toTuple()->elements();
+    parseFlatMethods(
+        FlatBytecode(bytecode_ptr.get(), bytecode_size),
+        constants,
+        debug_info_bvals,
+        *mcu);
+  } else {
+    auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
+    parseMethods(bvals, debug_info_bvals, *mcu);
+  }
   auto meta_dict = readMobileMetadata(mcu);
   return mobile::Module(readArchive("data", mcu).toObject(), meta_dict, mcu);
 }
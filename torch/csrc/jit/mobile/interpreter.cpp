@@ -6,8 +6,11 @@
 #include <torch/csrc/jit/runtime/vararg_functions.h>
 
 #include <ATen/record_function.h>
+#include <c10/core/CPUAllocator.h>
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <chrono>
+
 namespace torch {
 namespace jit {
 char const* toString(OpCode op);
@@ -20,8 +23,48 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code)
 
 using namespace at;
 
+namespace {
+// Operators left until the next sampled one, shared by the methods that run
+// on the thread so that short methods get sampled too
+thread_local uint32_t ops_until_sample = 0;
+
+bool sample_operator(uint32_t sampling_period) {
+  if (ops_until_sample == 0) {
+    ops_until_sample = sampling_period;
+  }
+  return --ops_until_sample == 0;
+}
+
+void run_observed(
+    const Operation& op,
+    const c10::OperatorName& op_name,
+    size_t pc,
+    Stack& stack,
+    MobileOperatorObserver* observer) {
+  c10::CPUAllocationCounter counter;
+  MobileOperatorSample sample;
+  {
+    c10::CPUAllocationCounterGuard guard(&counter);
+    auto start = std::chrono::steady_clock::now();
+    op(&stack);
+    auto end = std::chrono::steady_clock::now();
+    sample.latency_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count();
+  }
+  sample.op_name = &op_name;
+  sample.op_idx = pc;
+  sample.allocations = counter.allocations;
+  sample.allocated_bytes = counter.bytes;
+  observer->onOperatorSample(sample);
+}
+} // namespace
+
 bool InterpreterState::run(Stack& stack) {
   size_t pc = 0;
+  auto op_observer = torch::observerConfig().getOperatorObserver();
+  const uint32_t sampling_period =
+      torch::observerConfig().getOperatorSamplingPeriod();
   while (true) {
     Instruction inst = code_->instructions_[pc];
 
@@ -56,12 +99,32 @@ bool InterpreterState::run(Stack& stack) {
         if (!prev_value) {
           enableRecordFunction(false);
         }
-        code_->operators_[inst.X](stack);
+        if (C10_UNLIKELY(op_observer != nullptr) &&
+            sample_operator(sampling_period)) {
+          run_observed(
+              code_->operators_[inst.X],
+              code_->op_names_[inst.X],
+              pc,
+              stack,
+              op_observer);
+        } else {
+          code_->operators_[inst.X](&stack);
+        }
         ++pc;
       } break;
       case OPN: {
         stack.push_back(inst.N);
-        code_->operators_[inst.X](stack);
+        if (C10_UNLIKELY(op_observer != nullptr) &&
+            sample_operator(sampling_period)) {
+          run_observed(
+              code_->operators_[inst.X],
+              code_->op_names_[inst.X],
+              pc,
+              stack,
+              op_observer);
+        } else {
+          code_->operators_[inst.X](&stack);
+        }
         ++pc;
       } break;
       case INTERFACE_CALL: {
@@ -52,6 +52,15 @@ c10::IValue Module::run_method(const std::string& method_name, Stack stack) {
     }
     AT_ERROR("Method '", method_name, "' is not defined.");
   }
+  // Outputs outlive the guard, so only intermediates are planned
+  c10::optional<c10::AllocationPlannerGuard> planner_guard;
+  if (memory_planning_) {
+    auto& planner = planners_[method_name];
+    if (!planner) {
+      planner = std::make_shared<c10::AllocationPlanner>();
+    }
+    planner_guard.emplace(planner.get());
+  }
   try {
     stack.insert(stack.begin(), object_);
     m->run(stack);
@@ -149,6 +158,11 @@ std::string Module::get_forward_method_debug_info(size_t pc) const {
   return find_method("forward")->get_module_debug_info(pc);
 }
 
+void Module::set_memory_planning(bool enabled) {
+  // The plans are kept, memory from them may still be in use
+  memory_planning_ = enabled;
+}
+
 void Module::train(bool on) {
   set_train_recurse(object_, on);
 }
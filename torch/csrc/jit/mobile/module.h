@@ -1,5 +1,6 @@
 #pragma once
 //#include <ATen/core/function_schema.h>
+#include <c10/core/AllocationPlanner.h>
 #include <torch/csrc/jit/mobile/function.h>
 
 namespace torch {
@@ -61,11 +62,21 @@ class TORCH_API Module {
   const std::unordered_map<std::string, std::string> metadata() const {
     return metadata_;
   }
+  /// Plans the CPU memory of the intermediates of each method. The first
+  /// run of a method records its allocations, the following runs serve them
+  /// from one buffer in which intermediates that are not live at the same
+  /// time share memory, see c10::AllocationPlanner. Only worth it when the
+  /// input shapes don't change from run to run. Copies of the module share
+  /// the plans, and must not run the same method concurrently.
+  void set_memory_planning(bool enabled = true);
 
  private:
   c10::intrusive_ptr<c10::ivalue::Object> object_;
   std::unordered_map<std::string, std::string> metadata_;
   std::shared_ptr<CompilationUnit> cu_;
+  bool memory_planning_ = false;
+  std::unordered_map<std::string, std::shared_ptr<c10::AllocationPlanner>>
+      planners_;
 };
 } // namespace mobile
 } // namespace jit
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <ATen/core/operator_name.h>
+#include <c10/util/Exception.h>
 #include <c10/util/ThreadLocalDebugInfo.h>
+#include <cstdint>
 #include <string>
 
 namespace torch {
@@ -76,6 +79,28 @@ class MobileModuleObserver {
   virtual void onFailLoadModel(const std::string&) {}
 };
 
+// One operator call of the lite interpreter
+struct MobileOperatorSample {
+  const c10::OperatorName* op_name = nullptr;
+  // Index of the instruction in its method, like MobileDebugInfo::getOpIdx.
+  // The model and method names are in the MobileDebugInfo of the thread.
+  size_t op_idx = 0;
+  int64_t latency_ns = 0;
+  // CPU allocations made by the operator through the default allocators
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+};
+
+// Called on the thread that runs the operator, in the middle of the method.
+// Only one in every sampling period operators is observed, the other ones
+// run without timing or counting.
+class MobileOperatorObserver {
+ public:
+  virtual ~MobileOperatorObserver() = default;
+
+  virtual void onOperatorSample(const MobileOperatorSample&) {}
+};
+
 class MobileObserverConfig {
  public:
   void setModuleObserver(std::unique_ptr<MobileModuleObserver> reporter) {
@@ -85,8 +110,25 @@ class MobileObserverConfig {
     return module_observer_.get();
   }
 
+  // Not synchronized with running methods, set it before running any.
+  void setOperatorObserver(
+      std::unique_ptr<MobileOperatorObserver> reporter,
+      uint32_t sampling_period = 100) {
+    TORCH_CHECK(sampling_period > 0, "sampling period must be positive");
+    operator_observer_ = std::move(reporter);
+    operator_sampling_period_ = sampling_period;
+  }
+  MobileOperatorObserver* getOperatorObserver() {
+    return operator_observer_.get();
+  }
+  uint32_t getOperatorSamplingPeriod() {
+    return operator_sampling_period_;
+  }
+
  private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  std::unique_ptr<MobileOperatorObserver> operator_observer_;
+  uint32_t operator_sampling_period_ = 100;
 };
 
 MobileObserverConfig& observerConfig();
@@ -4,6 +4,8 @@
 #include <torch/utils.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
 
 #include <functional>
 
@@ -11,6 +13,79 @@ namespace torch {
 namespace jit {
 namespace mobile {
 
+namespace {
+
+struct FusedSGDOptions {
+  float lr;
+  float momentum;
+  float one_minus_dampening;
+  float weight_decay;
+  bool nesterov;
+  // the momentum buffer is new, and starts as the first gradient
+  bool first_step;
+};
+
+// The update of SGD::step for one value, or one vector of values, of a
+// parameter. buf is null without momentum.
+template <typename T>
+T sgd_update(T p, T g, T* buf, const FusedSGDOptions& options) {
+  if (options.weight_decay != 0) {
+    g = g + T(options.weight_decay) * p;
+  }
+  if (buf != nullptr) {
+    *buf = options.first_step
+        ? g
+        : T(options.momentum) * *buf + T(options.one_minus_dampening) * g;
+    g = options.nesterov ? g + T(options.momentum) * *buf : *buf;
+  }
+  return p - T(options.lr) * g;
+}
+
+// Updates param in place in one pass, without temporaries
+void fused_sgd_update(
+    float* param,
+    const float* grad,
+    float* momentum_buffer,
+    int64_t n,
+    const FusedSGDOptions& options) {
+  using Vec = at::vec256::Vec256<float>;
+  at::parallel_for(
+      0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        int64_t i = begin;
+        for (; i + Vec::size() <= end; i += Vec::size()) {
+          Vec buf;
+          if (momentum_buffer != nullptr) {
+            buf = Vec::loadu(momentum_buffer + i);
+          }
+          Vec p = sgd_update(
+              Vec::loadu(param + i),
+              Vec::loadu(grad + i),
+              momentum_buffer != nullptr ? &buf : nullptr,
+              options);
+          p.store(param + i);
+          if (momentum_buffer != nullptr) {
+            buf.store(momentum_buffer + i);
+          }
+        }
+        for (; i < end; ++i) {
+          param[i] = sgd_update(
+              param[i],
+              grad[i],
+              momentum_buffer != nullptr ? momentum_buffer + i : nullptr,
+              options);
+        }
+      });
+}
+
+bool can_fuse(const Tensor& p, const Tensor& grad) {
+  return p.device().is_cpu() && p.scalar_type() == at::kFloat &&
+      p.is_contiguous() && grad.layout() == at::kStrided &&
+      grad.device().is_cpu() && grad.scalar_type() == at::kFloat &&
+      grad.is_contiguous() && grad.sizes() == p.sizes();
+}
+
+} // namespace
+
 bool SGDParamGroup::has_options() const {
   return options_ != nullptr;
 }
@@ -98,6 +173,10 @@ Tensor SGD::step(const LossClosure& closure) {
       if (!p.grad().defined()) {
         continue;
       }
+      if (can_fuse(p, p.grad())) {
+        step_fused(p, options);
+        continue;
+      }
       auto d_p = p.grad().data();
       if (weight_decay != 0) {
         d_p = d_p.add(p.data(), weight_decay);
@@ -128,6 +207,38 @@ Tensor SGD::step(const LossClosure& closure) {
   }
   return loss;
 }
+
+void SGD::step_fused(Tensor& p, const SGDOptions& options) {
+  FusedSGDOptions fused_options;
+  fused_options.lr = options.lr();
+  fused_options.momentum = options.momentum();
+  fused_options.one_minus_dampening = 1 - options.dampening();
+  fused_options.weight_decay = options.weight_decay();
+  fused_options.nesterov = options.nesterov();
+  fused_options.first_step = false;
+
+  float* momentum_buffer = nullptr;
+  if (options.momentum() != 0) {
+    auto key = c10::guts::to_string(p.unsafeGetTensorImpl());
+    auto param_state = state_.find(key);
+    if (param_state == state_.end()) {
+      auto state = std::make_unique<SGDParamState>();
+      state->momentum_buffer(at::empty_like(p, at::MemoryFormat::Contiguous));
+      param_state = state_.emplace(std::move(key), std::move(state)).first;
+      fused_options.first_step = true;
+    }
+    auto& buf =
+        static_cast<SGDParamState&>(*param_state->second).momentum_buffer();
+    TORCH_INTERNAL_ASSERT(buf.is_contiguous() && buf.sizes() == p.sizes());
+    momentum_buffer = buf.data_ptr<float>();
+  }
+  fused_sgd_update(
+      p.data_ptr<float>(),
+      p.grad().data_ptr<float>(),
+      momentum_buffer,
+      p.numel(),
+      fused_options);
+}
 } // namespace mobile
 } // namespace jit
 } // namespace torch
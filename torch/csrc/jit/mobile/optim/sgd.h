@@ -115,6 +115,10 @@ class TORCH_API SGD {
   void zero_grad();
 
  protected:
+  // Updates a contiguous float parameter, its contiguous gradient and its
+  // momentum buffer in a single pass, in place
+  void step_fused(Tensor& p, const SGDOptions& options);
+
   std::vector<SGDParamGroup> param_groups_;
   ska::flat_hash_map<std::string, std::unique_ptr<SGDParamState>> state_;
   std::unique_ptr<SGDOptions> defaults_;
@@ -11,6 +11,7 @@
 
 #include <ATen/ATen.h>
 #include <algorithm>
+#include <sstream>
 #include <unordered_map>
 
 namespace torch {
@@ -361,33 +362,47 @@ RegisterOperators mm_batch_side_reg({Operator(
     },
     aliasAnalysisIsSpecialCase())});
 
-std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
-    Value* value,
+// Sorts nodes topologically and drops those that depend on an earlier one.
+// This algorithm might do very badly if e.g. you have a lot of independent
+// nodes, that depend on the first one, but I doubt this will be a common
+// scenario.
+std::vector<Node*> filterIndependentNodes(
+    std::vector<Node*> nodes,
     AliasDb& alias_db) {
-  const auto postprocess = [&](std::vector<Node*> mms) {
-    if (mms.size() == 0) {
-      return mms;
-    }
-    std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
-      return n->isBefore(m);
-    });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
+  if (nodes.size() == 0) {
+    return nodes;
+  }
+  std::sort(nodes.begin(), nodes.end(), [](Node* n, Node* m) {
+    return n->isBefore(m);
+  });
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < nodes.size(); ++j) {
+      if (nodes[j] == nullptr)
         continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
+      if (!alias_db.couldMoveBeforeTopologically(nodes[j], nodes[i])) {
+        nodes[j] = nullptr;
       }
     }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
-  };
+  }
+  return c10::filter(nodes, [](Node* n) { return n != nullptr; });
+}
 
+// Moves independent nodes (see filterIndependentNodes) next to each other,
+// right before the last one.
+void moveNextToEachOther(std::vector<Node*>& nodes, AliasDb& alias_db) {
+  AT_ASSERT(!nodes.empty());
+  for (int64_t i = static_cast<int64_t>(nodes.size()) - 2; i >= 0; --i) {
+    bool move_ok =
+        alias_db.moveBeforeTopologicallyValid(nodes[i], nodes[i + 1]);
+    AT_ASSERT(move_ok);
+  }
+}
+
+std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
+    Value* value,
+    AliasDb& alias_db) {
   Block* block = value->node()->owningBlock();
   std::vector<Node*> lhses; // Will contain nodes where value is used as an lhs
   std::vector<Node*> rhses; // Like above, but rhs
@@ -401,18 +416,16 @@ std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
       }
     }
   }
-  return std::make_pair(postprocess(lhses), postprocess(rhses));
+  return std::make_pair(
+      filterIndependentNodes(lhses, alias_db),
+      filterIndependentNodes(rhses, alias_db));
 }
 
 void BatchMMSide(Block* block, AliasDb& alias_db) {
   // NB: 8 is the current loop unrolling factor
   static constexpr size_t how_many_is_many = 8;
   const auto batch_side = [&](std::vector<Node*>& mms, Side side) {
-    AT_ASSERT(!mms.empty());
-    for (int64_t i = static_cast<int64_t>(mms.size()) - 2; i >= 0; --i) {
-      bool move_ok = alias_db.moveBeforeTopologicallyValid(mms[i], mms[i + 1]);
-      AT_ASSERT(move_ok);
-    }
+    moveNextToEachOther(mms, alias_db);
     WithInsertPoint insert_guard{mms[0]};
     Graph* graph = mms[0]->owningGraph();
     Node* batch_mm = graph->create(
@@ -452,6 +465,194 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// Note [Horizontal batching]
+// Multi-task heads often apply many small dense layers of the same shape to
+// different inputs. Each of them is a separate GEMM, and on GPU their launch
+// overhead dominates. Independent aten::addmm (with beta = alpha = 1) and
+// aten::linear nodes are gathered into a single prim::MMBatchHorizontal, which
+// stacks their operands and computes all of them with one baddbmm:
+//
+//   addmm(b_i, x_i, w_i) for i in [0, n) == baddbmm(B, X, W).unbind(0)
+//   where B = stack(b_i), X = stack(x_i), W = stack(w_i)
+//
+// Shapes are only known at runtime, so the operator falls back to computing
+// them one by one when they don't line up.
+static constexpr size_t min_horizontal_batch_size = 4;
+
+bool have_same_options(at::TensorList inputs, const at::Tensor& expected) {
+  return std::all_of(
+      inputs.begin(), inputs.end(), [&expected](const at::Tensor& t) {
+        return t.scalar_type() == expected.scalar_type() &&
+            t.device() == expected.device();
+      });
+}
+
+bool can_batch_horizontally(
+    at::TensorList biases,
+    at::TensorList mat1s,
+    at::TensorList mat2s) {
+  return mat1s[0].dim() == 2 && mat2s[0].dim() == 2 && biases[0].dim() <= 2 &&
+      have_same_shape(biases) && have_same_shape(mat1s) &&
+      have_same_shape(mat2s) && have_same_options(biases, mat1s[0]) &&
+      have_same_options(mat1s, mat1s[0]) && have_same_options(mat2s, mat1s[0]);
+}
+
+RegisterOperators mm_batch_horizontal_reg({Operator(
+    prim::MMBatchHorizontal,
+    [](const Node* node) -> Operation {
+      size_t num_mms = node->outputs().size();
+      return [num_mms](Stack* stack) {
+        std::vector<at::Tensor> inputs;
+        inputs.reserve(3 * num_mms);
+        for (auto it = stack->end() - 3 * num_mms; it != stack->end(); ++it) {
+          inputs.push_back(std::move(*it).toTensor());
+        }
+        drop(stack, 3 * num_mms);
+        auto biases = at::TensorList(inputs).slice(0, num_mms);
+        auto mat1s = at::TensorList(inputs).slice(num_mms, num_mms);
+        auto mat2s = at::TensorList(inputs).slice(2 * num_mms);
+
+        if (can_batch_horizontally(biases, mat1s, mat2s)) {
+          auto mat1 = at::stack(mat1s);
+          auto mat2 = at::stack(mat2s);
+          auto bias = at::stack(biases);
+          // broadcast each bias against its own [n, m] result
+          while (bias.dim() < 3) {
+            bias = bias.unsqueeze(1);
+          }
+          bias = bias.expand(
+              {static_cast<int64_t>(num_mms), mat1.size(1), mat2.size(2)});
+          auto outputs = at::baddbmm(bias, mat1, mat2).unbind(0);
+          stack->insert(
+              stack->end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
+        } else {
+          for (size_t i = 0; i < num_mms; ++i) {
+            // a linear may have more than 2 dimensional inputs
+            if (mat1s[i].dim() == 2) {
+              stack->emplace_back(at::addmm(biases[i], mat1s[i], mat2s[i]));
+            } else {
+              stack->emplace_back(
+                  at::matmul(mat1s[i], mat2s[i]).add(biases[i]));
+            }
+          }
+        }
+      };
+    },
+    aliasAnalysisIsSpecialCase())});
+
+bool is_constant_one(Value* v) {
+  auto ival = toIValue(v);
+  return ival &&
+      ((ival->isInt() && ival->toInt() == 1) ||
+       (ival->isDouble() && ival->toDouble() == 1.));
+}
+
+bool isHorizontalBatchLeaf(Node* node) {
+  if (node->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor")) {
+    return is_constant_one(node->inputs()[3]) &&
+        is_constant_one(node->inputs()[4]);
+  }
+  if (node->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+    return node->inputs()[2]->type()->isSubtypeOf(TensorType::get());
+  }
+  return false;
+}
+
+// Leaves are only batched with others that have the same signature, which
+// includes their shapes when these are known.
+std::string horizontalBatchSignature(Node* leaf) {
+  std::stringstream ss;
+  ss << leaf->kind().toQualString();
+  for (size_t i = 0; i < 3; ++i) {
+    auto type = leaf->inputs()[i]->type()->cast<TensorType>();
+    auto sizes = type ? type->sizes().concrete_sizes() : c10::nullopt;
+    ss << " ";
+    if (sizes) {
+      ss << c10::IntArrayRef(*sizes);
+    } else {
+      ss << "?";
+    }
+  }
+  return ss.str();
+}
+
+void batchHorizontally(std::vector<Node*>& leaves, AliasDb& alias_db) {
+  moveNextToEachOther(leaves, alias_db);
+  WithInsertPoint insert_guard{leaves[0]};
+  Graph* graph = leaves[0]->owningGraph();
+  std::vector<Value*> biases, mat1s, mat2s;
+  for (Node* leaf : leaves) {
+    if (leaf->kind() == aten::linear) {
+      biases.push_back(leaf->inputs()[2]);
+      mat1s.push_back(leaf->inputs()[0]);
+      mat2s.push_back(graph->insert(aten::t, {leaf->inputs()[1]}));
+    } else {
+      biases.push_back(leaf->inputs()[0]);
+      mat1s.push_back(leaf->inputs()[1]);
+      mat2s.push_back(leaf->inputs()[2]);
+    }
+  }
+  Node* batch_mm = graph->create(
+      prim::MMBatchHorizontal,
+      /*inputs=*/{},
+      /*num_outputs=*/leaves.size());
+  for (const auto& operands : {biases, mat1s, mat2s}) {
+    for (Value* operand : operands) {
+      batch_mm->addInput(operand);
+    }
+  }
+  graph->insertNode(batch_mm);
+  for (size_t i = 0; i < leaves.size(); ++i) {
+    leaves[i]->output()->replaceAllUsesWith(batch_mm->outputs().at(i));
+    leaves[i]->destroy();
+  }
+}
+
+// Batches one group of leaves found in block or its sub-blocks. Returns false
+// if there is none, the graph is modified otherwise, so alias_db needs to be
+// rebuilt before looking for the next one.
+bool BatchMMHorizontalOnce(Block* block, AliasDb& alias_db) {
+  std::vector<std::string> signatures;
+  std::unordered_map<std::string, std::vector<Node*>> groups;
+  for (Node* node : block->nodes()) {
+    if (isHorizontalBatchLeaf(node)) {
+      auto signature = horizontalBatchSignature(node);
+      auto& group = groups[signature];
+      if (group.empty()) {
+        signatures.push_back(signature);
+      }
+      group.push_back(node);
+    } else {
+      for (Block* subblock : node->blocks()) {
+        if (BatchMMHorizontalOnce(subblock, alias_db)) {
+          return true;
+        }
+      }
+    }
+  }
+  for (const auto& signature : signatures) {
+    auto leaves = filterIndependentNodes(groups[signature], alias_db);
+    if (leaves.size() >= min_horizontal_batch_size) {
+      batchHorizontally(leaves, alias_db);
+      return true;
+    }
+  }
+  return false;
+}
+
+void BatchMMHorizontal(std::shared_ptr<Graph>& graph) {
+  while (true) {
+    AliasDb alias_db(graph);
+    if (!BatchMMHorizontalOnce(graph->block(), alias_db)) {
+      break;
+    }
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -473,6 +674,7 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
   EliminateDeadCode(graph);
+  BatchMMHorizontal(graph);
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
   PeepholeOptimize(graph);
@@ -0,0 +1,197 @@
+#include <torch/csrc/jit/passes/cpu_prepack.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+c10::optional<at::Tensor> constantFloatTensor(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  at::Tensor t = ival->toTensor();
+  if (!t.defined() || t.device() != at::kCPU || t.layout() != at::kStrided ||
+      t.scalar_type() != at::kFloat || t.requires_grad()) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+// a constant tensor of the above kind, or None
+bool isConstantBias(Value* v) {
+  return v->type()->kind() == TypeKind::NoneType ||
+      constantFloatTensor(v).has_value();
+}
+
+c10::optional<std::vector<int64_t>> constantPair(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isIntList()) {
+    return c10::nullopt;
+  }
+  auto list = ival->toIntVector();
+  if (list.size() != 2) {
+    return c10::nullopt;
+  }
+  return list;
+}
+
+bool fbgemmSupported() {
+  const auto& engines = at::globalContext().supportedQEngines();
+  return std::find(engines.begin(), engines.end(), at::kFBGEMM) !=
+      engines.end();
+}
+
+class CPUWeightPacker {
+ public:
+  CPUWeightPacker(script::Module& module, bool allow_fp16_weights)
+      : module_(module),
+        graph_(module.get_method("forward").graph()),
+        use_mkldnn_(at::hasMKLDNN()),
+        use_fbgemm_fp16_(allow_fp16_weights && fbgemmSupported()) {}
+
+  void run() {
+    // traced modules use aten::_convolution and decomposed linear ops
+    graph_rewrite_helper::replaceConvolutionWithAtenConv(graph_);
+    FuseLinear(graph_);
+    packBlock(graph_->block());
+    EliminateDeadCode(graph_);
+    GRAPH_DUMP("After PrePackCPUWeights: ", graph_);
+  }
+
+ private:
+  void packBlock(Block* b) {
+    for (auto it = b->nodes().begin(); it != b->nodes().end();) {
+      Node* n = *it++;
+      for (Block* sub : n->blocks()) {
+        packBlock(sub);
+      }
+      if (use_mkldnn_ &&
+          n->matches(
+              "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor")) {
+        packConv2d(n);
+      } else if (
+          use_fbgemm_fp16_ &&
+          n->matches(
+              "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+        packLinear(n);
+      }
+    }
+  }
+
+  void packConv2d(Node* n) {
+    auto weight = constantFloatTensor(n->namedInput(attr::weight));
+    auto stride = constantPair(n->namedInput(attr::stride));
+    auto padding = constantPair(n->namedInput(attr::padding));
+    auto dilation = constantPair(n->namedInput(attr::dilation));
+    auto groups = toIValue(n->namedInput(attr::groups));
+    if (!weight || weight->dim() != 4 ||
+        !isConstantBias(n->namedInput(attr::bias)) || !stride || !padding ||
+        !dilation || !groups) {
+      return;
+    }
+    at::Tensor packed;
+    {
+      at::NoGradGuard no_grad;
+      packed = at::mkldnn_reorder_conv2d_weight(
+          weight->contiguous().to_mkldnn(),
+          *padding,
+          *stride,
+          *dilation,
+          groups->toInt());
+    }
+
+    WithInsertPoint guard(n);
+    // mkldnn_convolution views a dense input as is, ignoring its strides
+    Value* input =
+        graph_->insert(aten::contiguous, {n->namedInput(attr::input)});
+    Value* conv = graph_->insert(
+        aten::mkldnn_convolution,
+        {input,
+         insertPackedWeight(packed),
+         n->namedInput(attr::bias),
+         n->namedInput(attr::padding),
+         n->namedInput(attr::stride),
+         n->namedInput(attr::dilation),
+         n->namedInput(attr::groups)});
+    replace(n, conv);
+  }
+
+  void packLinear(Node* n) {
+    auto input_type = n->namedInput(attr::input)->type()->cast<TensorType>();
+    if (input_type && input_type->dim() && *input_type->dim() < 2) {
+      return;
+    }
+    auto weight = constantFloatTensor(n->namedInput(attr::weight));
+    Value* bias = n->namedInput(attr::bias);
+    if (!weight || weight->dim() != 2 || !isConstantBias(bias)) {
+      return;
+    }
+    at::Tensor packed;
+    {
+      at::NoGradGuard no_grad;
+      packed = at::fbgemm_pack_gemm_matrix_fp16(*weight);
+    }
+
+    WithInsertPoint guard(n);
+    // the fbgemm op always adds a bias
+    if (bias->type()->kind() == TypeKind::NoneType) {
+      bias = graph_->insertConstant(at::zeros({weight->size(0)}));
+    }
+    static const Symbol fbgemm_linear =
+        Symbol::aten("fbgemm_linear_fp16_weight_fp32_activation");
+    Value* linear = graph_->insert(
+        fbgemm_linear,
+        {n->namedInput(attr::input), insertPackedWeight(packed), bias});
+    replace(n, linear);
+  }
+
+  // Packed weights are module attributes rather than constants, as MKL-DNN
+  // tensors cannot be constants.
+  Value* insertPackedWeight(const at::Tensor& packed) {
+    auto attr_name = "_jit_pass_cpu_packed_weight_" + c10::to_string(uid_++);
+    TORCH_CHECK(
+        !module_.type()->findAttributeSlot(attr_name),
+        "Attribute name ",
+        attr_name,
+        " already exists in module of type:",
+        module_.type()->name()->qualifiedName(),
+        ". Please make sure that PrePackCPUWeights is run only once.");
+    module_.register_attribute(attr_name, TensorType::get(), packed);
+    return graph_->insertGetAttr(graph_->inputs()[0], attr_name)
+        ->setType(TensorType::get());
+  }
+
+  void replace(Node* n, Value* replacement) {
+    GRAPH_UPDATE("Replacing ", *n, " with ", *replacement->node());
+    replacement->node()->copyMetadata(n);
+    replacement->setType(n->output()->type());
+    n->output()->replaceAllUsesWith(replacement);
+    n->destroy();
+  }
+
+  script::Module& module_;
+  std::shared_ptr<Graph> graph_;
+  bool use_mkldnn_;
+  bool use_fbgemm_fp16_;
+  int64_t uid_ = 0;
+};
+
+} // namespace
+
+void PrePackCPUWeights(script::Module& module, bool allow_fp16_weights) {
+  CPUWeightPacker(module, allow_fp16_weights).run();
+}
+
+} // namespace jit
+} // namespace torch
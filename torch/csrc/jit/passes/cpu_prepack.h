@@ -0,0 +1,29 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Chooses a CPU backend for the dense conv2d and linear ops in the forward
+// method of a frozen module, and packs their constant weights into the layout
+// that backend computes with, once, instead of on every call.
+//
+// conv2d weights are reordered into MKL-DNN's blocked layout and the op is
+// replaced by aten::mkldnn_convolution. When allow_fp16_weights is set and
+// FBGEMM supports the CPU, linear weights are packed into FBGEMM's fp16 GEMM
+// layout and the op is replaced by
+// aten::fbgemm_linear_fp16_weight_fp32_activation; this changes numerics and
+// requires inputs of at least 2 dimensions, so it is opt-in. Other linear ops
+// are left as they are.
+//
+// The packed weights are registered as attributes of the module. MKL-DNN
+// tensors cannot be serialized, so the packed module is meant to be run in
+// the process that packed it.
+TORCH_API void PrePackCPUWeights(
+    script::Module& module,
+    bool allow_fp16_weights = false);
+
+} // namespace jit
+} // namespace torch
@@ -89,5 +89,58 @@ void FuseLinear(std::shared_ptr<Graph>& graph) {
       linear_weight_extra_transpose, linear_weight_no_transpose);
   cleanup.runOnGraph(graph);
 }
+
+void FuseAddMMActivation(std::shared_ptr<Graph>& graph) {
+  // linear only is an addmm for a 2-d input and a bias
+  auto input_is_matrix_and_has_bias =
+      [](const Match& match,
+         const std::unordered_map<std::string, Value*>& vmap) {
+        const auto& match_vmap = match.values_map;
+        auto input_type =
+            match_vmap.at(vmap.at("input"))->type()->cast<TensorType>();
+        auto bias_type =
+            match_vmap.at(vmap.at("bias"))->type()->cast<TensorType>();
+        return input_type && input_type->dim() && *input_type->dim() == 2 &&
+            bias_type;
+      };
+
+  const std::vector<std::pair<std::string, std::string>> activations = {
+      {"aten::relu", "0"}, {"aten::relu_", "0"}, {"aten::gelu", "1"}};
+  for (const auto& activation_and_use_gelu : activations) {
+    const auto& activation = activation_and_use_gelu.first;
+    const auto& use_gelu = activation_and_use_gelu.second;
+    std::string addmm_activation_pattern = R"IR(
+    graph(%bias, %input, %weight_t, %beta, %alpha):
+        %mm = aten::addmm(%bias, %input, %weight_t, %beta, %alpha)
+        %res = )IR" + activation + R"IR((%mm)
+        return (%res))IR";
+    std::string fused_addmm_activation = R"IR(
+    graph(%bias, %input, %weight_t, %beta, %alpha):
+        %use_gelu : bool = prim::Constant[value=)IR" + use_gelu + R"IR(]()
+        %res = aten::_addmm_activation(%bias, %input, %weight_t, %beta, %alpha, %use_gelu)
+        return (%res))IR";
+    SubgraphRewriter addmm_activation;
+    addmm_activation.RegisterRewritePattern(
+        addmm_activation_pattern, fused_addmm_activation);
+    addmm_activation.runOnGraph(graph);
+
+    std::string linear_activation_pattern = R"IR(
+    graph(%input, %weight, %bias):
+        %linear = aten::linear(%input, %weight, %bias)
+        %res = )IR" + activation + R"IR((%linear)
+        return (%res))IR";
+    std::string fused_linear_activation = R"IR(
+    graph(%input, %weight, %bias):
+        %weight_t = aten::t(%weight)
+        %one : int = prim::Constant[value=1]()
+        %use_gelu : bool = prim::Constant[value=)IR" + use_gelu + R"IR(]()
+        %res = aten::_addmm_activation(%bias, %input, %weight_t, %one, %one, %use_gelu)
+        return (%res))IR";
+    SubgraphRewriter linear_activation;
+    linear_activation.RegisterRewritePattern(
+        linear_activation_pattern, fused_linear_activation);
+    linear_activation.runOnGraph(graph, input_is_matrix_and_has_bias);
+  }
+}
 } // namespace jit
 } // namespace torch
@@ -13,5 +13,11 @@ namespace jit {
  * This pass can be deleted once the JIT can emit the aten::linear in the future
  */
 TORCH_API void FuseLinear(std::shared_ptr<Graph>& graph);
+
+/** \brief Fuse aten::addmm or 2-d aten::linear followed by aten::relu or
+ * aten::gelu into aten::_addmm_activation, which applies the bias and the
+ * activation in the epilogue of the gemm on CUDA
+ */
+TORCH_API void FuseAddMMActivation(std::shared_ptr<Graph>& graph);
 } // namespace jit
 } // namespace torch
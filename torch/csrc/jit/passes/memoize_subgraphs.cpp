@@ -0,0 +1,317 @@
+#include <torch/csrc/jit/passes/memoize_subgraphs.h>
+
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/utils/subgraph_utils.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <list>
+#include <mutex>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Types of the values on which the cache is keyed by value.
+bool isKeyType(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::IntType:
+    case TypeKind::FloatType:
+    case TypeKind::BoolType:
+    case TypeKind::NoneType:
+    case TypeKind::StringType:
+    case TypeKind::DeviceObjType:
+      return true;
+    case TypeKind::ListType: {
+      auto elem = type->expect<ListType>()->getElementType();
+      return elem->kind() == TypeKind::IntType ||
+          elem->kind() == TypeKind::FloatType ||
+          elem->kind() == TypeKind::BoolType;
+    }
+    case TypeKind::OptionalType:
+      return isKeyType(type->expect<OptionalType>()->getElementType());
+    default:
+      return false;
+  }
+}
+
+bool isTensorType(const TypePtr& type) {
+  if (auto optional = type->cast<OptionalType>()) {
+    return optional->getElementType()->kind() == TypeKind::TensorType;
+  }
+  return type->kind() == TypeKind::TensorType;
+}
+
+bool hasTensorOutput(Node* n) {
+  for (Value* output : n->outputs()) {
+    if (isTensorType(output->type())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct SubgraphMemoizer {
+  SubgraphMemoizer(std::shared_ptr<Graph> graph) : graph_(std::move(graph)) {}
+
+  void run() {
+    // Creating the subgraphs invalidates the AliasDb, so that all nodes are
+    // analyzed first.
+    aliasDb_ = torch::make_unique<AliasDb>(graph_);
+    analyze(graph_->block());
+    createMemoizedGraphs(graph_->block());
+  }
+
+ private:
+  void analyze(Block* block) {
+    for (Node* n : block->nodes()) {
+      for (Block* b : n->blocks()) {
+        analyze(b);
+      }
+      if (isMemoizable(n)) {
+        memoizable_.insert(n);
+      }
+    }
+  }
+
+  bool isMemoizable(Node* n) {
+    if (!n->blocks().empty() || n->hasAttribute(attr::Subgraph)) {
+      return false;
+    }
+    if (n->kind() != prim::ListConstruct && n->kind() != prim::TupleConstruct &&
+        !(n->kind().is_aten() && n->maybeSchema())) {
+      return false;
+    }
+    if (n->isNondeterministic() || n->hasSideEffects()) {
+      return false;
+    }
+    // The outputs are reused across runs, so neither they nor the inputs may
+    // be written to, and they may not be returned to the caller.
+    if (aliasDb_->hasWriters(n) || aliasDb_->isMutable(n) ||
+        aliasDb_->mayContainAlias(n->outputs(), graph_->outputs())) {
+      return false;
+    }
+    for (Value* input : n->inputs()) {
+      Node* producer = input->node();
+      if (producer->kind() == prim::Constant || memoizable_.count(producer) ||
+          isKeyType(input->type())) {
+        continue;
+      }
+      // Attributes are keyed on by identity and version, which only hit if
+      // they are the same tensors in every run.
+      if (producer->kind() == prim::GetAttr && isTensorType(input->type())) {
+        continue;
+      }
+      return false;
+    }
+    return true;
+  }
+
+  // Merges the memoizable nodes whose outputs are only used by the group.
+  void mergeInputs(Node* group) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (Value* input : group->inputs()) {
+        Node* producer = input->node();
+        if (producer->owningBlock() != group->owningBlock() ||
+            !memoizable_.count(producer)) {
+          continue;
+        }
+        bool onlyUsedByGroup = true;
+        for (Value* output : producer->outputs()) {
+          for (const Use& use : output->uses()) {
+            onlyUsedByGroup = onlyUsedByGroup && use.user == group;
+          }
+        }
+        if (!onlyUsedByGroup) {
+          continue;
+        }
+        GRAPH_UPDATE("Merging ", getHeader(producer));
+        memoizable_.erase(producer);
+        SubgraphUtils::mergeNodeIntoSubgraph(producer, group);
+        changed = true;
+        break;
+      }
+    }
+  }
+
+  void createMemoizedGraphs(Block* block) {
+    auto reverse_iter = block->nodes().reverse();
+    for (auto it = reverse_iter.begin(); it != reverse_iter.end();) {
+      Node* n = *it;
+      for (Block* b : n->blocks()) {
+        createMemoizedGraphs(b);
+      }
+      // Nodes which only compute scalars are cheaper than looking them up.
+      if (!memoizable_.count(n) || !hasTensorOutput(n)) {
+        it++;
+        continue;
+      }
+      GRAPH_UPDATE("Creating a prim::MemoizedGraph node from: ", *n);
+      memoizable_.erase(n);
+      Node* group =
+          SubgraphUtils::createSingletonSubgraph(n, prim::MemoizedGraph);
+      mergeInputs(group);
+      it = group->reverseIterator();
+      it++;
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::unique_ptr<AliasDb> aliasDb_;
+  std::unordered_set<Node*> memoizable_;
+};
+
+// Whether the cache is keyed on the value of v, rather than on its identity.
+bool isKeyValue(const IValue& v) {
+  return v.isInt() || v.isDouble() || v.isBool() || v.isNone() ||
+      v.isString() || v.isDevice() || v.isIntList() || v.isDoubleList() ||
+      v.isBoolList();
+}
+
+uint32_t versionOf(const IValue& v) {
+  if (!v.isTensor() || !v.toTensor().defined()) {
+    return 0;
+  }
+  return v.unsafeToTensorImpl()->version_counter().current_version();
+}
+
+size_t bytesOf(const std::vector<IValue>& values) {
+  size_t bytes = 0;
+  for (const auto& v : values) {
+    if (v.isTensor() && v.toTensor().defined() &&
+        v.toTensor().has_storage()) {
+      bytes += v.toTensor().storage().nbytes();
+    }
+  }
+  return bytes;
+}
+
+class MemoizedGraphCache {
+ public:
+  explicit MemoizedGraphCache(const std::shared_ptr<Graph>& graph)
+      : code_(graph, "<memoized graph>"),
+        num_inputs_(graph->inputs().size()),
+        num_outputs_(graph->outputs().size()) {}
+
+  void run(Stack& stack) {
+    auto inputs = last(stack, num_inputs_);
+    if (at::GradMode::is_enabled() && anyRequiresGrad(inputs)) {
+      InterpreterState(code_).run(stack);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (matches(*it, inputs)) {
+          entries_.splice(entries_.begin(), entries_, it);
+          drop(stack, num_inputs_);
+          stack.insert(stack.end(), it->outputs.begin(), it->outputs.end());
+          return;
+        }
+      }
+    }
+
+    Entry entry;
+    entry.inputs = inputs.vec();
+    entry.versions.reserve(num_inputs_);
+    for (const auto& input : inputs) {
+      entry.versions.push_back(versionOf(input));
+    }
+    InterpreterState(code_).run(stack);
+    auto outputs = last(stack, num_outputs_);
+    entry.outputs = outputs.vec();
+    entry.bytes = bytesOf(entry.outputs);
+    if (entry.bytes > kMemoizedGraphMaxBytes) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    bytes_ += entry.bytes;
+    entries_.push_front(std::move(entry));
+    while (entries_.size() > kMemoizedGraphMaxEntries ||
+           bytes_ > kMemoizedGraphMaxBytes) {
+      bytes_ -= entries_.back().bytes;
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  struct Entry {
+    // The inputs are kept alive, so that their identities can't be reused.
+    std::vector<IValue> inputs;
+    std::vector<uint32_t> versions;
+    std::vector<IValue> outputs;
+    size_t bytes = 0;
+  };
+
+  static bool anyRequiresGrad(at::ArrayRef<IValue> inputs) {
+    for (const auto& input : inputs) {
+      if (input.isTensor() && input.toTensor().requires_grad()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool matches(const Entry& entry, at::ArrayRef<IValue> inputs) {
+    for (size_t i = 0; i < inputs.size(); i++) {
+      const IValue& cached = entry.inputs[i];
+      const IValue& input = inputs[i];
+      if (input.isTensor()) {
+        if (!cached.isTensor() ||
+            cached.unsafeToTensorImpl() != input.unsafeToTensorImpl() ||
+            entry.versions[i] != versionOf(input)) {
+          return false;
+        }
+      } else if (isKeyValue(input)) {
+        if (cached.isTensor() || !(cached == input)) {
+          return false;
+        }
+      } else if (!cached.isSameIdentity(input)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const Code code_;
+  const size_t num_inputs_;
+  const size_t num_outputs_;
+
+  std::mutex mutex_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  size_t bytes_ = 0;
+};
+
+Operation createMemoizedGraphOp(const Node* node) {
+  auto cache = std::make_shared<MemoizedGraphCache>(node->g(attr::Subgraph));
+  return [cache](Stack* stack) {
+    cache->run(*stack);
+    return 0;
+  };
+}
+
+RegisterOperators MemoizedGraphOps({
+    torch::jit::Operator(
+        prim::MemoizedGraph,
+        createMemoizedGraphOp,
+        AliasAnalysisKind::PURE_FUNCTION),
+});
+
+} // namespace
+
+void MemoizeSubgraphs(const std::shared_ptr<Graph>& graph) {
+  SubgraphMemoizer(graph).run();
+  GRAPH_DUMP("After MemoizeSubgraphs: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
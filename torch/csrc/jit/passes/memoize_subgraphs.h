@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Moves the pure computations which only depend on constants, module
+// attributes and values of scalar types (e.g. sizes of the inputs) into
+// prim::MemoizedGraph nodes, which cache their outputs. Such computations
+// can't be folded by constant propagation, but only need to run again when
+// those scalars change, e.g. position embeddings sliced to the sequence
+// length, or masks built for it.
+//
+// The cache of a prim::MemoizedGraph is keyed on the values of its scalar
+// inputs and on the identity and version of its tensor inputs, so that an
+// in-place update of an attribute is seen. It keeps the outputs of at most
+// kMemoizedGraphMaxEntries different inputs, of at most
+// kMemoizedGraphMaxBytes in total, evicting the least recently used ones. It
+// isn't used for tensor inputs which require grad while grad mode is enabled.
+//
+// The outputs of the memoized computations are reused across runs, which is
+// only done if the graph doesn't write to them or return them.
+TORCH_API void MemoizeSubgraphs(const std::shared_ptr<Graph>& graph);
+
+constexpr size_t kMemoizedGraphMaxEntries = 8;
+constexpr size_t kMemoizedGraphMaxBytes = 64 * 1024 * 1024;
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,305 @@
+#include <torch/csrc/jit/passes/memory_reuse.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <limits>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+struct PointwiseOp {
+  const char* schema;
+  // writes the result to a trailing out argument, or to self if inplace is set
+  const char* variant;
+  bool inplace;
+};
+
+const std::vector<PointwiseOp>& pointwiseOps() {
+  static const std::vector<PointwiseOp> ops = {
+      {"aten::abs(Tensor self) -> Tensor",
+       "aten::abs.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::neg(Tensor self) -> Tensor",
+       "aten::neg.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::exp(Tensor self) -> Tensor",
+       "aten::exp.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::log(Tensor self) -> Tensor",
+       "aten::log.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::sqrt(Tensor self) -> Tensor",
+       "aten::sqrt.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::rsqrt(Tensor self) -> Tensor",
+       "aten::rsqrt.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::reciprocal(Tensor self) -> Tensor",
+       "aten::reciprocal.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::sin(Tensor self) -> Tensor",
+       "aten::sin.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::cos(Tensor self) -> Tensor",
+       "aten::cos.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::erf(Tensor self) -> Tensor",
+       "aten::erf.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::sigmoid(Tensor self) -> Tensor",
+       "aten::sigmoid.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::tanh(Tensor self) -> Tensor",
+       "aten::tanh.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       "aten::add.out(Tensor self, Tensor other, *, Scalar alpha=1, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       "aten::sub.out(Tensor self, Tensor other, *, Scalar alpha=1, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
+       "aten::mul.out(Tensor self, Tensor other, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      {"aten::div.Tensor(Tensor self, Tensor other) -> Tensor",
+       "aten::div.out(Tensor self, Tensor other, *, Tensor(a!) out) -> Tensor(a!)",
+       false},
+      // relu has no out variant
+      {"aten::relu(Tensor self) -> Tensor",
+       "aten::relu_(Tensor(a!) self) -> Tensor(a!)",
+       true},
+  };
+  return ops;
+}
+
+// ops that always return a newly allocated tensor, whose storage can be
+// reused once it is dead but which cannot write into an existing one
+const std::vector<const char*>& allocatingOps() {
+  static const std::vector<const char*> ops = {
+      "aten::mm(Tensor self, Tensor mat2) -> Tensor",
+      "aten::bmm(Tensor self, Tensor mat2) -> Tensor",
+      "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+      "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor",
+      "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor",
+  };
+  return ops;
+}
+
+const PointwiseOp* matchPointwiseOp(Node* n) {
+  for (const auto& op : pointwiseOps()) {
+    if (n->matches(op.schema)) {
+      return &op;
+    }
+  }
+  return nullptr;
+}
+
+bool isAllocatingOp(Node* n) {
+  if (matchPointwiseOp(n)) {
+    return true;
+  }
+  for (const char* schema : allocatingOps()) {
+    if (n->matches(schema)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool hasReusableType(const Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  return type && type->isComplete() && type->requiresGrad() == false;
+}
+
+constexpr size_t kForever = std::numeric_limits<size_t>::max();
+
+// Storage shared by a chain of values whose live ranges do not overlap, in
+// program order. The last one is what a new occupant writes into.
+struct Slot {
+  TypePtr type;
+  std::vector<Value*> occupants;
+  size_t live_until;
+};
+
+class MemoryReuser {
+ public:
+  explicit MemoryReuser(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {}
+
+  void run() {
+    std::vector<Node*> nodes(graph_->nodes().begin(), graph_->nodes().end());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      positions_[nodes[i]] = i;
+    }
+    collectMutableValues(graph_->block());
+
+    // decide first, then rewrite, so that all aliasing queries are made on
+    // the graph the AliasDb was built for
+    std::vector<std::pair<Node*, Value*>> rewrites;
+    for (size_t pos = 0; pos < nodes.size(); ++pos) {
+      Node* n = nodes[pos];
+      if (n->outputs().size() != 1 || !isAllocatingOp(n) ||
+          !hasReusableType(n->output())) {
+        continue;
+      }
+      Value* out = n->output();
+      size_t until = liveUntil(out);
+      Slot* slot = nullptr;
+      if (const PointwiseOp* op = matchPointwiseOp(n)) {
+        slot = findFreeSlot(n, *op, pos);
+      }
+      if (slot) {
+        rewrites.emplace_back(n, slot->occupants.back());
+        slot->occupants.push_back(out);
+        slot->live_until = std::max(slot->live_until, until);
+      } else {
+        slots_.push_back(Slot{out->type(), {out}, until});
+      }
+    }
+
+    std::unordered_map<Value*, Value*> replaced;
+    for (const auto& rewrite : rewrites) {
+      Value* buffer = rewrite.second;
+      auto it = replaced.find(buffer);
+      if (it != replaced.end()) {
+        buffer = it->second;
+      }
+      replaced[rewrite.first->output()] = rewriteNode(rewrite.first, buffer);
+    }
+    GRAPH_DUMP("After ReuseIntermediateBuffers: ", graph_);
+  }
+
+ private:
+  // every value that may alias a slot
+  void collectMutableValues(Block* b) {
+    for (Value* v : b->inputs()) {
+      if (AliasDb::isMutableType(v)) {
+        mutable_values_.push_back(v);
+      }
+    }
+    for (Node* n : b->nodes()) {
+      for (Value* v : n->outputs()) {
+        if (AliasDb::isMutableType(v)) {
+          mutable_values_.push_back(v);
+        }
+      }
+      for (Block* sub : n->blocks()) {
+        collectMutableValues(sub);
+      }
+    }
+  }
+
+  // position of the top level node that n is, or is nested in
+  size_t topLevelPosition(Node* n) const {
+    while (n->owningBlock() != graph_->block()) {
+      n = n->owningBlock()->owningNode();
+    }
+    if (n == graph_->param_node()) {
+      return 0;
+    }
+    if (n == graph_->return_node()) {
+      return kForever;
+    }
+    return positions_.at(n);
+  }
+
+  size_t lastUse(Value* v) const {
+    size_t last = topLevelPosition(v->node());
+    for (const Use& use : v->uses()) {
+      last = std::max(last, topLevelPosition(use.user));
+    }
+    return last;
+  }
+
+  // the last position at which the storage of v may be read or written
+  size_t liveUntil(Value* v) {
+    if (aliasDb_.escapesScope({v})) {
+      return kForever;
+    }
+    size_t until = lastUse(v);
+    for (Value* u : mutable_values_) {
+      if (u != v && aliasDb_.mayContainAlias(u, v)) {
+        until = std::max(until, lastUse(u));
+      }
+    }
+    return until;
+  }
+
+  Slot* findFreeSlot(Node* n, const PointwiseOp& op, size_t pos) {
+    for (Slot& slot : slots_) {
+      if (*slot.type != *n->output()->type()) {
+        continue;
+      }
+      if (slot.live_until < pos && !op.inplace) {
+        return &slot;
+      }
+      // the slot dies at n, it can be written in place as long as n reads it
+      // through the value it currently holds and not through a view
+      if (slot.live_until == pos && readsOnlyThroughLastOccupant(n, slot) &&
+          (!op.inplace || n->input(0) == slot.occupants.back())) {
+        return &slot;
+      }
+    }
+    return nullptr;
+  }
+
+  bool readsOnlyThroughLastOccupant(Node* n, const Slot& slot) {
+    for (Value* input : n->inputs()) {
+      if (input == slot.occupants.back()) {
+        continue;
+      }
+      for (Value* occupant : slot.occupants) {
+        if (aliasDb_.mayContainAlias(input, occupant)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  Value* rewriteNode(Node* n, Value* buffer) {
+    const PointwiseOp* op = matchPointwiseOp(n);
+    TORCH_INTERNAL_ASSERT(op);
+    Node* replacement = nullptr;
+    if (op->inplace) {
+      auto kind = Symbol::fromQualString(
+          getOperatorForLiteral(op->variant)->schema().name());
+      replacement = graph_->create(kind, n->inputs());
+    } else {
+      std::vector<Value*> inputs(n->inputs().begin(), n->inputs().end());
+      inputs.push_back(buffer);
+      replacement = graph_->create(n->kind(), inputs);
+    }
+    replacement->insertBefore(n);
+    replacement->copyMetadata(n);
+    replacement->output()->setType(n->output()->type());
+    TORCH_INTERNAL_ASSERT(replacement->matches(op->variant));
+    GRAPH_UPDATE(
+        "Writing the result of ",
+        *n,
+        " into the storage of %",
+        buffer->debugName());
+    n->output()->replaceAllUsesWith(replacement->output());
+    n->destroy();
+    return replacement->output();
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  std::unordered_map<Node*, size_t> positions_;
+  std::vector<Value*> mutable_values_;
+  std::vector<Slot> slots_;
+};
+
+} // namespace
+
+void ReuseIntermediateBuffers(std::shared_ptr<Graph>& graph) {
+  MemoryReuser(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Lets pointwise ops write their results into the storage of intermediates
+// that are dead by then, instead of allocating a new tensor, by rewriting them
+// into their out= variant (or in-place variant, when the reused storage is
+// that of the op's own input).
+//
+// Intermediates are assigned to storage slots by a linear scan over the top
+// level nodes: a slot is free once every value that may alias it has had its
+// last use, and is only reused for a value of exactly the same complete
+// tensor type (sizes, strides, dtype and device), so no out= call resizes.
+//
+// This is meant for inference graphs with complete types, such as traced or
+// frozen graphs run under no_grad: values that may require grad, that alias
+// graph inputs or constants, or whose types are incomplete are never touched.
+TORCH_API void ReuseIntermediateBuffers(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
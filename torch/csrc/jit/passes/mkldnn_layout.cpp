@@ -0,0 +1,233 @@
+#include <torch/csrc/jit/passes/mkldnn_layout.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+c10::optional<at::Tensor> constantFloatTensor(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  at::Tensor t = ival->toTensor();
+  if (!t.defined() || t.device() != at::kCPU || t.layout() != at::kStrided ||
+      t.scalar_type() != at::kFloat || t.requires_grad()) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+bool constantIntListEquals(Value* v, const std::vector<int64_t>& expected) {
+  auto ival = toIValue(v);
+  return ival && ival->isIntList() && ival->toIntVector() == expected;
+}
+
+bool isConstantNone(Value* v) {
+  auto ival = toIValue(v);
+  return ival && ival->isNone();
+}
+
+class MKLDNNLayoutPropagator {
+ public:
+  explicit MKLDNNLayoutPropagator(script::Module& module)
+      : module_(module), graph_(module.get_method("forward").graph()) {}
+
+  void run() {
+    if (!at::hasMKLDNN()) {
+      return;
+    }
+    propagateBlock(graph_->block());
+    EliminateDeadCode(graph_);
+    GRAPH_DUMP("After PropagateMKLDNNLayout: ", graph_);
+  }
+
+ private:
+  void propagateBlock(Block* b) {
+    // values of this block computed in the MKL-DNN layout, and the nodes
+    // consuming them as MKL-DNN tensors
+    std::unordered_set<Value*> mkldnn_values;
+    std::unordered_set<Node*> chain_nodes;
+    for (auto it = b->nodes().begin(); it != b->nodes().end();) {
+      Node* n = *it++;
+      for (Block* sub : n->blocks()) {
+        propagateBlock(sub);
+      }
+      if (n->kind() == aten::contiguous && mkldnn_values.count(n->input(0))) {
+        // MKL-DNN tensors have no strides; their uses through aten::contiguous
+        // are chain or edge uses of the tensor itself.
+        n->output()->replaceAllUsesWith(n->input(0));
+        n->destroy();
+        continue;
+      }
+      if (n->inputs().empty() || n->outputs().empty()) {
+        continue;
+      }
+      const bool in_chain = mkldnn_values.count(n->input(0)) > 0;
+      if (in_chain ? !continuesChain(n) : !startsChain(n)) {
+        continue;
+      }
+      if (!in_chain) {
+        WithInsertPoint guard(n);
+        Value* input = graph_->insert(Symbol::aten("to_mkldnn"), {n->input(0)});
+        input->setType(n->input(0)->type());
+        n->replaceInput(0, input);
+      }
+      if (n->kind() == aten::batch_norm) {
+        n = replaceBatchNorm(n);
+      }
+      GRAPH_UPDATE("Computing ", *n, " in MKL-DNN layout");
+      mkldnn_values.insert(n->outputs()[0]);
+      chain_nodes.insert(n);
+    }
+    for (Value* v : mkldnn_values) {
+      convertEdgeUses(v, chain_nodes);
+    }
+  }
+
+  // A chain is started where the conversion to the MKL-DNN layout saves one
+  // back to the dense layout: mkldnn_convolution views a dense input as is,
+  // but has to convert its output.
+  bool startsChain(Node* n) {
+    return n->kind() == aten::mkldnn_convolution &&
+        feedsChain(n->output());
+  }
+
+  bool feedsChain(Value* v) {
+    for (const Use& use : v->uses()) {
+      if (use.user->kind() == aten::contiguous) {
+        if (feedsChain(use.user->output())) {
+          return true;
+        }
+      } else if (use.offset == 0 && continuesChain(use.user)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The ops with an MKL-DNN kernel for their first input, under the
+  // conditions those kernels support.
+  bool continuesChain(Node* n) {
+    if (n->kind() == aten::mkldnn_convolution ||
+        n->matches("aten::relu(Tensor self) -> Tensor")) {
+      return true;
+    }
+    if (n->matches("aten::relu_(Tensor(a!) self) -> Tensor(a!)")) {
+      // only the chain sees the tensor, which is not dense anymore
+      return n->input(0)->uses().size() == 1;
+    }
+    if (n->matches(
+            "aten::max_pool2d(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, int[2] dilation=1, bool ceil_mode=False) -> Tensor")) {
+      return constantIntListEquals(n->namedInput(attr::dilation), {1, 1});
+    }
+    if (n->matches(
+            "aten::avg_pool2d(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, bool ceil_mode=False, bool count_include_pad=True, int? divisor_override=None) -> Tensor")) {
+      return isConstantNone(n->namedInput(attr::divisor_override));
+    }
+    if (n->matches(
+            "aten::adaptive_avg_pool2d(Tensor self, int[2] output_size) -> Tensor")) {
+      // the MKL-DNN kernel needs the input size divisible by the output size
+      return constantIntListEquals(n->namedInput(attr::output_size), {1, 1});
+    }
+    if (n->matches(
+            "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor")) {
+      auto training = toIValue(n->namedInput(attr::training));
+      return training && training->isBool() && !training->toBool() &&
+          constantFloatTensor(n->namedInput(attr::weight)) &&
+          constantFloatTensor(n->namedInput(attr::bias)) &&
+          constantFloatTensor(n->namedInput(attr::running_mean)) &&
+          constantFloatTensor(n->namedInput(attr::running_var));
+    }
+    return false;
+  }
+
+  // aten::batch_norm checks its input the dense way; the MKL-DNN kernel is
+  // called through aten::native_batch_norm, with its parameters converted.
+  Node* replaceBatchNorm(Node* n) {
+    WithInsertPoint guard(n);
+    std::vector<Value*> inputs{n->namedInput(attr::input)};
+    for (const Symbol name :
+         {attr::weight, attr::bias, attr::running_mean, attr::running_var}) {
+      at::Tensor param;
+      {
+        at::NoGradGuard no_grad;
+        param = constantFloatTensor(n->namedInput(name))
+                    ->contiguous()
+                    .to_mkldnn();
+      }
+      inputs.push_back(insertMKLDNNParameter(param));
+    }
+    inputs.push_back(n->namedInput(attr::training));
+    inputs.push_back(n->namedInput(attr::momentum));
+    inputs.push_back(n->namedInput(attr::eps));
+
+    Node* batch_norm =
+        graph_->insertNode(graph_->create(aten::native_batch_norm, inputs, 3));
+    batch_norm->copyMetadata(n);
+    for (Value* output : batch_norm->outputs()) {
+      output->setType(TensorType::get());
+    }
+    batch_norm->outputs()[0]->setType(n->output()->type());
+    GRAPH_UPDATE("Replacing ", *n, " with ", *batch_norm);
+    n->output()->replaceAllUsesWith(batch_norm->outputs()[0]);
+    n->destroy();
+    return batch_norm;
+  }
+
+  // Converts `v` back to the dense layout for its uses outside of the chain.
+  void convertEdgeUses(Value* v, const std::unordered_set<Node*>& chain_nodes) {
+    std::vector<Use> edge_uses;
+    for (const Use& use : v->uses()) {
+      if (use.offset != 0 || !chain_nodes.count(use.user)) {
+        edge_uses.push_back(use);
+      }
+    }
+    if (edge_uses.empty()) {
+      return;
+    }
+    WithInsertPoint guard(v->node()->next());
+    Value* dense = graph_->insert(aten::to_dense, {v});
+    dense->setType(v->type());
+    for (const Use& use : edge_uses) {
+      use.user->replaceInput(use.offset, dense);
+    }
+  }
+
+  // Like the packed weights of PrePackCPUWeights, MKL-DNN tensors cannot be
+  // constants.
+  Value* insertMKLDNNParameter(const at::Tensor& param) {
+    auto attr_name = "_jit_pass_mkldnn_parameter_" + c10::to_string(uid_++);
+    TORCH_CHECK(
+        !module_.type()->findAttributeSlot(attr_name),
+        "Attribute name ",
+        attr_name,
+        " already exists in module of type:",
+        module_.type()->name()->qualifiedName(),
+        ". Please make sure that PropagateMKLDNNLayout is run only once.");
+    module_.register_attribute(attr_name, TensorType::get(), param);
+    return graph_->insertGetAttr(graph_->inputs()[0], attr_name)
+        ->setType(TensorType::get());
+  }
+
+  script::Module& module_;
+  std::shared_ptr<Graph> graph_;
+  int64_t uid_ = 0;
+};
+
+} // namespace
+
+void PropagateMKLDNNLayout(script::Module& module) {
+  MKLDNNLayoutPropagator(module).run();
+}
+
+} // namespace jit
+} // namespace torch
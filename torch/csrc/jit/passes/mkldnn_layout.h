@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Keeps the chains of conv2d, batch_norm, relu and pooling ops in the forward
+// method of a frozen module in MKL-DNN's blocked layout, instead of
+// converting from and to the dense layout around every op.
+//
+// A chain starts at an aten::mkldnn_convolution, as inserted by
+// PrePackCPUWeights, and continues through the supported ops consuming its
+// output. The input of the chain is converted with aten::to_mkldnn, and only
+// the values used outside of it are converted back with aten::to_dense. The
+// constant parameters of the batch_norm ops are converted once, and
+// registered as attributes of the module like the packed weights.
+//
+// Run it after PrePackCPUWeights; the module is then meant to be run with
+// gradients disabled.
+TORCH_API void PropagateMKLDNNLayout(script::Module& module);
+
+} // namespace jit
+} // namespace torch
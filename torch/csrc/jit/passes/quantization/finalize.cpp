@@ -2,6 +2,7 @@
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
 #include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/quantization/fusion_passes.h>
 #include <torch/csrc/jit/passes/quantization/quantization_patterns.h>
 
 namespace torch {
@@ -78,6 +79,10 @@ Module Finalize(Module& module, QuantType quant_type) {
   InsertPrepackUnpack(graph);
   GRAPH_DUMP("Before QuantFusion:", graph);
   QuantFusion(graph, quant_type);
+  FuseRequantizeChains(graph);
+  for (const auto& entry : CountDequantizeUses(graph)) {
+    GRAPH_DEBUG(entry.first, " uses ", entry.second, " dequantized values");
+  }
   auto frozen = freeze_module(module);
   FoldQuantizedPrepackingOps(frozen);
   return frozen;
@@ -1,4 +1,7 @@
 #include <torch/csrc/jit/passes/quantization/fusion_passes.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 
 namespace torch {
@@ -53,11 +56,116 @@ void fuseQuantizeAddReluImpl(std::shared_ptr<Graph>& graph) {
       quantized_add_scalar_out_relu_pattern, fused_add_scalar_out_relu_pattern);
   fused_add_relu_rewriter.runOnGraph(graph);
 }
+
+void fuseQuantizedConvAddImpl(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter rewriter;
+  for (const std::string add : {"add", "add_relu"}) {
+    std::string fused = R"(
+    graph(%x, %packed_params, %conv_scale, %conv_zero_point, %other, %scale, %zero_point):
+         %r = quantized::conv2d_)" +
+        add + R"((%x, %packed_params, %other, %conv_scale, %conv_zero_point, %scale, %zero_point)
+         return (%r) )";
+    // quantized::add is symmetric in its operands, so the convolution may be
+    // either of them.
+    for (const std::string operands : {"%conv_out, %other", "%other, %conv_out"}) {
+      std::string pattern = R"(
+    graph(%x, %packed_params, %conv_scale, %conv_zero_point, %other, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%x, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::)" +
+          add + "(" + operands + R"(, %scale, %zero_point)
+         return (%r) )";
+      rewriter.RegisterRewritePattern(pattern, fused);
+    }
+  }
+  rewriter.runOnGraph(graph);
+}
+
+bool isQuantizePerTensor(const Node* n) {
+  return n->matches(
+      "aten::quantize_per_tensor(Tensor self, float scale, int zero_point, ScalarType dtype) -> Tensor");
+}
+
+bool isDequantize(const Node* n) {
+  return n->matches("aten::dequantize.self(Tensor self) -> Tensor");
+}
+
+// Both values are the same value or constants that are equal
+bool sameQParam(Value* a, Value* b) {
+  if (a == b) {
+    return true;
+  }
+  auto ivalue_a = toIValue(a);
+  auto ivalue_b = toIValue(b);
+  return ivalue_a && ivalue_b && *ivalue_a == *ivalue_b;
+}
+
+void collectRequantizations(Block* block, std::vector<Node*>& quants) {
+  for (Node* n : block->nodes()) {
+    for (Block* subblock : n->blocks()) {
+      collectRequantizations(subblock, quants);
+    }
+    if (isQuantizePerTensor(n) && isDequantize(n->input(0)->node())) {
+      quants.push_back(n);
+    }
+  }
+}
+
+void countDequantizeUses(
+    Block* block,
+    std::unordered_map<std::string, size_t>& counts) {
+  for (Node* n : block->nodes()) {
+    for (Block* subblock : n->blocks()) {
+      countDequantizeUses(subblock, counts);
+    }
+    if (isDequantize(n)) {
+      for (const Use& use : n->output()->uses()) {
+        counts[use.user->kind().toQualString()]++;
+      }
+    }
+  }
+}
 } // namespace
 
 void FuseQuantizedAddRelu(std::shared_ptr<Graph>& graph) {
   fuseQuantizeAddReluImpl(graph);
 }
 
+void FuseQuantizedConvAdd(std::shared_ptr<Graph>& graph) {
+  fuseQuantizedConvAddImpl(graph);
+  GRAPH_DUMP("After FuseQuantizedConvAdd:", graph);
+}
+
+void FuseRequantizeChains(std::shared_ptr<Graph>& graph) {
+  std::vector<Node*> quants;
+  collectRequantizations(graph->block(), quants);
+  for (Node* quant : quants) {
+    Value* quantized = quant->input(0)->node()->input();
+    Node* producer = quantized->node();
+    if (isQuantizePerTensor(producer) &&
+        sameQParam(producer->input(1), quant->input(1)) &&
+        sameQParam(producer->input(2), quant->input(2)) &&
+        sameQParam(producer->input(3), quant->input(3))) {
+      quant->output()->replaceAllUsesWith(quantized);
+      continue;
+    }
+    WithInsertPoint ins(quant);
+    Node* requant = graph->create(
+        Symbol::fromQualString("quantized::requantize"),
+        {quantized, quant->input(1), quant->input(2), quant->input(3)});
+    requant->output()->setType(quant->output()->type());
+    graph->insertNode(requant);
+    quant->output()->replaceAllUsesWith(requant->output());
+  }
+  EliminateDeadCode(graph);
+  GRAPH_DUMP("After FuseRequantizeChains:", graph);
+}
+
+std::unordered_map<std::string, size_t> CountDequantizeUses(
+    const std::shared_ptr<Graph>& graph) {
+  std::unordered_map<std::string, size_t> counts;
+  countDequantizeUses(graph->block(), counts);
+  return counts;
+}
+
 } // namespace jit
 } // namespace torch
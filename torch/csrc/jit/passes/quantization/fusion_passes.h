@@ -5,5 +5,21 @@
 namespace torch {
 namespace jit {
 TORCH_API void FuseQuantizedAddRelu(std::shared_ptr<Graph>& graph);
+
+// Fuses a quantized::conv2d whose only use is a quantized::add or
+// quantized::add_relu, e.g. a residual connection, into
+// quantized::conv2d_add(_relu). Run after FuseQuantizedAddRelu to also fuse
+// the relu.
+TORCH_API void FuseQuantizedConvAdd(std::shared_ptr<Graph>& graph);
+
+// Fuses the aten::dequantize - aten::quantize_per_tensor pairs left between
+// quantized values into one quantized::requantize, the pairs that quantize
+// with the parameters the value already has are removed
+TORCH_API void FuseRequantizeChains(std::shared_ptr<Graph>& graph);
+
+// Counts the aten::dequantize uses by the kind of the node that uses them,
+// that is the ops that still run in floating point in a quantized graph
+TORCH_API std::unordered_map<std::string, size_t> CountDequantizeUses(
+    const std::shared_ptr<Graph>& graph);
 } // namespace jit
 } // namespace torch
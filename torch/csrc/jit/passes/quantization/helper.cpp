@@ -185,6 +185,7 @@ std::unordered_map<NodeKind, std::tuple<c10::QScheme, QParamVector>>
         {Symbol::aten("hardsigmoid_"), _per_tensor_asym_qparam},
         {Symbol::aten("sigmoid"), _per_tensor_asym_qparam},
         {Symbol::aten("sigmoid_"), _per_tensor_asym_qparam},
+        {Symbol::aten("softmax"), _per_tensor_asym_qparam},
         {Symbol::aten("tanh"), _per_tensor_sym_qparam},
         {Symbol::aten("tanh_"), _per_tensor_sym_qparam},
 };
@@ -230,6 +230,16 @@ bool input_b_is_scalar(
   return isScalar(b_scalar);
 }
 
+// filter that checks %dtype is None, softmax with a dtype casts its input
+// and is not quantized
+bool softmax_dtype_is_none(
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const auto& match_vmap = match.values_map;
+  auto dtype = match_vmap.at(vmap.at("dtype"));
+  return dtype->mustBeNone();
+}
+
 // Patterns for ops that require observation for output quantization parameters
 // Example:
 //
@@ -866,6 +876,10 @@ graph(%a_quant, %alpha, %scale, %input_scale, %r_scale, %r_zero_point, %r_dtype)
 
   auto tanh_ = getFixedQParamOpFusionInfo("aten::tanh_", {}, true);
 
+  auto softmax =
+      getFixedQParamOpFusionInfo("aten::softmax", {"%dim", "%dtype"}, false);
+  softmax.filters = {softmax_dtype_is_none};
+
   auto hardswish = getObservedQParamOpFusionInfo(
       "aten::hardswish", "quantized::hardswish", {}, {});
 
@@ -1013,6 +1027,7 @@ graph(%a_quant, %alpha, %scale, %input_scale, %r_scale, %r_zero_point, %r_dtype)
       sigmoid_,
       tanh,
       tanh_,
+      softmax,
   };
 }
 
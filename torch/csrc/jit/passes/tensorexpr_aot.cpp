@@ -0,0 +1,200 @@
+#include <torch/csrc/jit/passes/tensorexpr_aot.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/shape_analysis.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
+#include <torch/csrc/jit/passes/utils/subgraph_utils.h>
+#include <torch/csrc/jit/tensorexpr/aot_kernel.h>
+#include <torch/csrc/jit/tensorexpr/kernel.h>
+
+#ifndef _WIN32
+#include <torch/csrc/jit/codegen/fuser/cpu/temp_file.h>
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const char* kLibraryAttribute = "_nnc_aot_kernels";
+
+struct CompiledKernel {
+  Node* group;
+  std::string name;
+  std::vector<int64_t> signature;
+  std::string object;
+};
+
+class TensorExprAOTCompiler {
+ public:
+  explicit TensorExprAOTCompiler(script::Module& module)
+      : module_(module), graph_(module.get_method("forward").graph()) {}
+
+  void run(const std::vector<at::Tensor>& example_inputs) {
+    TORCH_CHECK(
+        example_inputs.size() + 1 == graph_->inputs().size(),
+        "expected ",
+        graph_->inputs().size() - 1,
+        " example inputs, got ",
+        example_inputs.size());
+    TORCH_CHECK(
+        !module_.type()->findAttributeSlot(kLibraryAttribute),
+        "The module already has compiled TensorExpr kernels. Please make sure "
+        "that CompileTensorExprsAheadOfTime is run only once.");
+    for (size_t i = 0; i < example_inputs.size(); i++) {
+      graph_->inputs()[i + 1]->setType(
+          TensorType::create(example_inputs[i].detach()));
+    }
+    PropagateInputShapes(graph_);
+    FuseTensorExprs(graph_);
+
+    std::vector<Node*> groups;
+    collectGroups(graph_->block(), groups);
+    for (Node* group : groups) {
+      if (!compileGroup(group)) {
+        GRAPH_UPDATE("Unfusing ", *group);
+        SubgraphUtils::unmergeSubgraph(group);
+      }
+    }
+    if (!kernels_.empty()) {
+      module_.register_attribute(
+          kLibraryAttribute, TensorType::get(), linkLibrary());
+      Value* library;
+      {
+        WithInsertPoint guard(graph_->block()->nodes().front());
+        library = graph_->insertGetAttr(graph_->inputs()[0], kLibraryAttribute)
+                      ->setType(TensorType::get());
+      }
+      for (const CompiledKernel& kernel : kernels_) {
+        replaceGroup(kernel, library);
+      }
+    }
+    EliminateDeadCode(graph_);
+    GRAPH_DUMP("After CompileTensorExprsAheadOfTime: ", graph_);
+  }
+
+ private:
+  void collectGroups(Block* b, std::vector<Node*>& groups) {
+    static const Symbol group_kind =
+        Symbol::fromQualString("tensorexpr::Group");
+    for (Node* n : b->nodes()) {
+      for (Block* sub : n->blocks()) {
+        collectGroups(sub, groups);
+      }
+      if (n->kind() == group_kind) {
+        groups.push_back(n);
+      }
+    }
+  }
+
+  bool compileGroup(Node* group) {
+    auto subgraph = SubgraphUtils::getSubgraph(group);
+    std::vector<TensorTypePtr> input_types;
+    for (Value* input : subgraph->inputs()) {
+      auto type = input->type()->cast<TensorType>();
+      if (!type || !type->isComplete() || *type->device() != at::kCPU) {
+        return false;
+      }
+      input_types.push_back(type);
+    }
+
+    CompiledKernel compiled;
+    compiled.group = group;
+    compiled.name = "nnc_aot_kernel_" + c10::to_string(kernels_.size());
+    try {
+      tensorexpr::TensorExprKernel kernel(subgraph);
+      compiled.object = kernel.compileToObject(compiled.name);
+      compiled.signature = tensorexpr::encodeAOTKernelSignature(
+          input_types, kernel.outputTypes());
+    } catch (const std::exception& e) {
+      GRAPH_DEBUG("Cannot compile ", *group, " ahead of time: ", e.what());
+      return false;
+    }
+    kernels_.push_back(std::move(compiled));
+    return true;
+  }
+
+  at::Tensor linkLibrary() {
+#ifdef _WIN32
+    TORCH_CHECK(
+        false, "Compiling TensorExpr kernels is not supported on Windows");
+#else
+    std::vector<std::unique_ptr<fuser::cpu::TempFile>> objects;
+    std::ostringstream command;
+    const char* cxx = std::getenv("CXX");
+    command << "\"" << (cxx ? cxx : "g++") << "\" -shared";
+    for (const CompiledKernel& kernel : kernels_) {
+      objects.push_back(std::make_unique<fuser::cpu::TempFile>(
+          "/tmp/pytorch_nnc_aotXXXXXX.o", 2));
+      objects.back()->write(kernel.object);
+      objects.back()->sync();
+      command << " \"" << objects.back()->name() << "\"";
+    }
+    fuser::cpu::TempFile so_file("/tmp/pytorch_nnc_aotXXXXXX.so", 3);
+    command << " -o \"" << so_file.name() << "\"";
+    int r = std::system(command.str().c_str());
+    TORCH_CHECK(r == 0, "Failed to link compiled TensorExpr kernels");
+
+    std::ifstream in(so_file.name(), std::ios::binary);
+    std::string bytes(
+        (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    TORCH_CHECK(in, "Failed to read linked TensorExpr kernels");
+    at::Tensor library = at::empty({(int64_t)bytes.size()}, at::kByte);
+    std::memcpy(library.data_ptr<uint8_t>(), bytes.data(), bytes.size());
+    return library;
+#endif
+  }
+
+  void replaceGroup(const CompiledKernel& kernel, Value* library) {
+    static const Symbol aot_kernel =
+        Symbol::fromQualString("tensorexpr::aot_kernel");
+    Node* group = kernel.group;
+    WithInsertPoint guard(group);
+    Value* inputs = graph_
+                        ->insertNode(graph_->createList(
+                            TensorType::get(), group->inputs()))
+                        ->output();
+    Value* outputs = graph_->insert(
+        aot_kernel,
+        {library,
+         graph_->insertConstant(kernel.name),
+         graph_->insertConstant(kernel.signature),
+         inputs});
+    Node* unpack = graph_->insertNode(
+        graph_->createListUnpack(outputs, group->outputs().size()));
+    GRAPH_UPDATE("Replacing ", *group, " with ", *outputs->node());
+    for (size_t i = 0; i < group->outputs().size(); i++) {
+      unpack->output(i)->setType(group->output(i)->type());
+      group->output(i)->replaceAllUsesWith(unpack->output(i));
+    }
+    group->destroy();
+  }
+
+  script::Module& module_;
+  std::shared_ptr<Graph> graph_;
+  std::vector<CompiledKernel> kernels_;
+};
+
+} // namespace
+
+void CompileTensorExprsAheadOfTime(
+    script::Module& module,
+    const std::vector<at::Tensor>& example_inputs) {
+#ifndef TORCH_ENABLE_LLVM
+  TORCH_CHECK(false, "Compiling TensorExpr kernels requires a build with LLVM");
+#endif
+  TensorExprAOTCompiler(module).run(example_inputs);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Compiles the TensorExpr fusion groups of the forward method of a frozen
+// module ahead of time, for inputs of the sizes, strides and dtypes of
+// example_inputs, into a shared library that is registered as an attribute
+// of the module. Each group is replaced by a tensorexpr::aot_kernel call of
+// its kernel in the library, so that the saved module runs the kernels in
+// processes without LLVM or a compiler, on CPUs with the features of the
+// compiling one. The kernels reject inputs of other shapes. Groups that
+// cannot be compiled this way are unfused.
+//
+// Needs a build with LLVM, and links the library with the C++ compiler in
+// the CXX environment variable, g++ by default.
+TORCH_API void CompileTensorExprsAheadOfTime(
+    script::Module& module,
+    const std::vector<at::Tensor>& example_inputs);
+
+} // namespace jit
+} // namespace torch
@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 #include <ATen/record_function.h>
 #include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
@@ -25,6 +26,38 @@ bool isSupportedForBlock(Node* node) {
 }
 
 namespace tensorexpr {
+
+// Whether v is a non-empty int[] known at compile time: either a constant or
+// a ListConstruct of constants, which is fused along with its user.
+static bool isConstantIntList(Value* v) {
+  if (v->node()->kind() == prim::ListConstruct) {
+    for (Value* item : v->node()->inputs()) {
+      if (item->node()->kind() != prim::Constant) {
+        return false;
+      }
+    }
+    return v->node()->inputs().size() > 0;
+  }
+  auto ival = toIValue(v);
+  return ival && ival->isIntList() && ival->toIntList().size() > 0;
+}
+
+static bool isConstant(Value* v) {
+  return v->node()->kind() == prim::Constant;
+}
+
+static bool isReduction(Node* node) {
+  switch (node->kind()) {
+    case aten::sum:
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return true;
+    default:
+      return false;
+  }
+}
+
 bool isSupported(Node* node) {
   // For Block codegen we allow limited ops.
   if (tensorexpr::getTEGenerateBlockCode()) {
@@ -110,11 +143,40 @@ bool isSupported(Node* node) {
     case aten::slice:
       // TODO: Shape inference is not implemented for this op yet
       return false;
+    // Reductions, as long as the reduced dimensions are known at compile
+    // time:
+    case aten::sum:
+      if (node->matches(
+              "aten::sum(Tensor self, *, ScalarType? dtype=None) -> Tensor")) {
+        return isConstant(node->input(1));
+      }
+      return node->matches(
+                 "aten::sum.dim_IntList(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor") &&
+          isConstantIntList(node->input(1)) && isConstant(node->input(2)) &&
+          isConstant(node->input(3));
+    case aten::softmax:
+    case aten::log_softmax:
+      return node->inputs().size() == 3 && isConstant(node->input(1)) &&
+          node->input(2)->type()->kind() == TypeKind::NoneType;
+    case aten::layer_norm:
+      return isConstantIntList(node->input(1)) && isConstant(node->input(4));
     default:
       return false;
   }
 }
 
+// The ListConstruct holding the reduced dimensions of a reduction, if any.
+static Node* reductionListConstruct(Node* node) {
+  if ((node->kind() == aten::sum && node->inputs().size() > 2) ||
+      node->kind() == aten::layer_norm) {
+    Node* list = node->input(1)->node();
+    if (list->kind() == prim::ListConstruct) {
+      return list;
+    }
+  }
+  return nullptr;
+}
+
 } // namespace tensorexpr
 
 static bool texpr_fuser_enabled_ = false;
@@ -133,6 +195,20 @@ bool tensorExprFuserEnabled() {
   return true;
 }
 
+static bool texpr_dynamic_shapes_enabled_ = false;
+void setTensorExprDynamicShapesEnabled(bool val) {
+  texpr_dynamic_shapes_enabled_ = val;
+}
+
+bool tensorExprDynamicShapesEnabled() {
+  static const char* enable_c_str =
+      std::getenv("PYTORCH_TENSOREXPR_DYNAMIC_SHAPES");
+  if (!enable_c_str) {
+    return texpr_dynamic_shapes_enabled_;
+  }
+  return std::string(enable_c_str) != "0";
+}
+
 const Symbol& getTensorExprSymbol() {
   static Symbol s = Symbol::fromQualString("tensorexpr::Group");
   return s;
@@ -351,6 +427,9 @@ class TensorExprFuser {
     if (to_merge->kind() == aten::cat) {
       Node* listconstruct = to_merge->input(0)->node();
       nodes_to_merge.push_back(listconstruct);
+    } else if (
+        Node* listconstruct = tensorexpr::reductionListConstruct(to_merge)) {
+      nodes_to_merge.push_back(listconstruct);
     }
 
     // First, try to move all the nodes we want to fuse next to the fusion
@@ -383,11 +462,69 @@ class TensorExprFuser {
       return true;
     }
     if (typeinfo_map_.count(v)) {
-      return typeinfo_map_.at(v)->isComplete();
+      auto type = typeinfo_map_.at(v);
+      if (type->isComplete()) {
+        return true;
+      }
+      return tensorExprDynamicShapesEnabled() && isKnownUpToSizes(type);
     }
     return v->isCompleteTensor();
   }
 
+  // Whether a profiled type, e.g. one merged from runs of different sizes,
+  // has everything but its sizes and strides known, as kernels of symbolic
+  // shape need.
+  static bool isKnownUpToSizes(const TensorTypePtr& type) {
+    if (!type->scalarType() || !type->device() || !type->requiresGrad() ||
+        !type->symbolic_sizes().sizes()) {
+      return false;
+    }
+    const auto& strides = type->stride_properties();
+    if (!strides.size() || *strides.size() != *type->dim()) {
+      return false;
+    }
+    for (size_t i = 0; i < *strides.size(); i++) {
+      if (!strides[i] || !strides[i]->stride_index_ ||
+          !strides[i]->contiguous_) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  TensorTypePtr tensorType(Value* v) {
+    if (typeinfo_map_.count(v)) {
+      return typeinfo_map_.at(v);
+    }
+    return v->type()->cast<TensorType>();
+  }
+
+  // Reductions are only lowered for CPU, where every reduced row becomes a
+  // loop of its own; CudaCodeGen cannot reduce across threads. sum is lowered
+  // for float and double tensors only, as ATen promotes integral and bool sums
+  // to int64 while the lowering keeps the input dtype. softmax and layer_norm
+  // are lowered for float tensors only.
+  bool canHandleReduction(Node* node) {
+    for (Value* input : node->inputs()) {
+      if (!input->type()->cast<TensorType>()) {
+        continue;
+      }
+      auto type = tensorType(input);
+      if (!type->device() || !type->device()->is_cpu()) {
+        return false;
+      }
+      auto dtype = type->scalarType();
+      if (!dtype) {
+        return false;
+      }
+      if (*dtype != at::kFloat &&
+          (node->kind() != aten::sum || *dtype != at::kDouble)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   bool allShapesAreKnown(Node* node) {
     // TODO: Relax the checks to support dynamic shapes
     for (Value* input : node->inputs()) {
@@ -406,6 +543,9 @@ class TensorExprFuser {
     if (!allShapesAreKnown(node)) {
       return false;
     }
+    if (tensorexpr::isReduction(node) && !canHandleReduction(node)) {
+      return false;
+    }
 
     // Don't include nodes whose inputs are tensor constants - we cannot handle
     // them at the moment.
@@ -468,6 +608,14 @@ class TensorExprFuser {
       REQ(consumer->input(1)->node()->kind() == prim::Constant);
     }
 
+    // The ListConstruct of a reduction is fused along with it.
+    if (Node* listconstruct = tensorexpr::reductionListConstruct(producer)) {
+      REQ(listconstruct->output()->uses().size() == 1);
+    } else if (
+        Node* listconstruct = tensorexpr::reductionListConstruct(consumer)) {
+      REQ(listconstruct->output()->uses().size() == 1);
+    }
+
     return true;
   }
 #undef REQ
@@ -510,9 +658,86 @@ class TensorExprFuser {
     }
   }
 
+  // The size of a prim::ConstantChunk input is only ever split statically,
+  // and layer_norm takes the sizes it normalizes over as constants.
+  static bool needsStaticShapes(const std::shared_ptr<Graph>& subgraph) {
+    for (Node* n : subgraph->nodes()) {
+      if (n->kind() == prim::ConstantChunk || n->kind() == aten::layer_norm) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Replaces the profiled sizes of the inputs of a fusion group with shape
+  // symbols, so that the group is guarded on, and compiled for, a family of
+  // shapes rather than a single one. Sizes that were equal when profiled
+  // share a symbol, as the kernel relies on the sizes of broadcast operands
+  // being equal, and sizes of 1 stay static, as they decide broadcasting.
+  // Strides are only guarded on their order and contiguity, and on the
+  // innermost one being 1.
+  void generalizeInputShapes(const std::shared_ptr<Graph>& subgraph) {
+    if (needsStaticShapes(subgraph)) {
+      return;
+    }
+    std::unordered_map<int64_t, c10::ShapeSymbol> symbols;
+    for (Value* input : subgraph->inputs()) {
+      if (!typeinfo_map_.count(input)) {
+        continue;
+      }
+      auto type = typeinfo_map_.at(input);
+      auto sizes = type->symbolic_sizes().sizes();
+      const auto& strides = type->stride_properties();
+      if (!sizes || !strides.size() || *strides.size() != sizes->size()) {
+        continue;
+      }
+      std::vector<c10::ShapeSymbol> dims;
+      for (const auto& size : *sizes) {
+        if (!size.is_static() || size.static_size() == 1) {
+          dims.push_back(size);
+          continue;
+        }
+        auto it = symbols.find(size.static_size());
+        if (it == symbols.end()) {
+          auto symbol = c10::ShapeSymbol::newSymbol();
+          it = symbols.emplace(size.static_size(), symbol).first;
+        }
+        dims.push_back(it->second);
+      }
+      c10::VaryingShape<c10::Stride>::ListOfOptionalElements stride_props;
+      for (size_t i = 0; i < sizes->size(); i++) {
+        if (!strides[i]) {
+          stride_props.emplace_back();
+          continue;
+        }
+        c10::optional<size_t> stride;
+        if (i == 0 && strides[i]->stride_ == static_cast<size_t>(1)) {
+          stride = 1;
+        }
+        stride_props.emplace_back(c10::Stride(
+            strides[i]->stride_index_, strides[i]->contiguous_, stride));
+      }
+      typeinfo_map_[input] = TensorType::create(
+          type->scalarType(),
+          type->device(),
+          c10::SymbolicShape(dims),
+          c10::VaryingShape<c10::Stride>(stride_props),
+          type->requiresGrad(),
+          type->undefined());
+      GRAPH_DEBUG(
+          "Generalized the type of %",
+          input->debugName(),
+          " to ",
+          *typeinfo_map_.at(input));
+    }
+  }
+
   void guardFusionGroup(Node* fusion_group) {
     GRAPH_DEBUG("Inserting a typecheck guard for a node", *fusion_group);
     auto subgraph = SubgraphUtils::getSubgraph(fusion_group);
+    if (tensorExprDynamicShapesEnabled()) {
+      generalizeInputShapes(subgraph);
+    }
 
     // Fixup types of the subgraph inputs
     std::vector<Value*> inputs_to_check;
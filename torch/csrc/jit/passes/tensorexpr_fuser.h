@@ -17,6 +17,13 @@ TORCH_API void FuseTensorExprs(
 TORCH_API void setTensorExprFuserEnabled(bool val);
 TORCH_API bool tensorExprFuserEnabled();
 
+// When set, fusion groups are guarded on and compiled for the profiled ranks,
+// dtypes, devices and stride order of their inputs rather than their exact
+// sizes, so that a single kernel serves inputs of any size. Defaults to the
+// PYTORCH_TENSOREXPR_DYNAMIC_SHAPES environment variable.
+TORCH_API void setTensorExprDynamicShapesEnabled(bool val);
+TORCH_API bool tensorExprDynamicShapesEnabled();
+
 namespace tensorexpr {
 TORCH_API bool isSupported(Node* node);
 }
@@ -51,8 +51,8 @@ bool MemoryDAG::mayAlias(const Element* a, const Element* b) const {
 }
 
 bool MemoryDAG::mayAliasImpl(const Element* a, const Element* b) const {
-  const auto aMemLoc = getMemoryLocations(a);
-  const auto bMemLoc = getMemoryLocations(b);
+  const auto& aMemLoc = getMemoryLocations(a);
+  const auto& bMemLoc = getMemoryLocations(b);
 
   return aMemLoc.intersects(bMemLoc);
 }
@@ -65,33 +65,53 @@ bool MemoryDAG::mayContainAlias(Element* a, Element* b) const {
   return mayContainAliasImpl(a, b);
 }
 
+const MemoryLocations& MemoryDAG::getAllContainedMemoryLocations(
+    const Element* elem) const {
+  // Without this cache, every query walks everything reachable from the
+  // queried elements again, which makes passes that query each node
+  // quadratic in the size of the graph.
+  if (!elem->cachedAllContainedMemoryLocations_) {
+    MemoryLocations cont;
+    collectAllContainedMemoryLocationsImpl(elem, cont);
+    elem->cachedAllContainedMemoryLocations_ = std::move(cont);
+  }
+  return *elem->cachedAllContainedMemoryLocations_;
+}
+
 void MemoryDAG::collectAllContainedMemoryLocations(
     const Element* elem,
     MemoryLocations& cont) const {
+  cont |= getAllContainedMemoryLocations(elem);
+}
+
+void MemoryDAG::collectAllContainedMemoryLocationsImpl(
+    const Element* elem,
+    MemoryLocations& cont) const {
   // we have already recursed on this element
   unsigned compIdx = elem->index;
   if (cont.test(compIdx)) {
     return;
   }
+  // A cached element is complete. The elements being computed are not
+  // cached yet, so the cycles through them are cut by `cont` as above.
+  if (elem->cachedAllContainedMemoryLocations_) {
+    cont |= *elem->cachedAllContainedMemoryLocations_;
+    return;
+  }
   cont.set(compIdx);
 
   for (const auto& mem_loc : getMemoryLocations(elem)) {
-    collectAllContainedMemoryLocations(fromIndex(mem_loc), cont);
+    collectAllContainedMemoryLocationsImpl(fromIndex(mem_loc), cont);
   }
 
   for (const auto& contained : elem->containedElements) {
-    collectAllContainedMemoryLocations(fromIndex(contained), cont);
+    collectAllContainedMemoryLocationsImpl(fromIndex(contained), cont);
   }
 }
 
 bool MemoryDAG::mayContainAliasImpl(const Element* a, const Element* b) const {
-  MemoryLocations all_a_mlocs;
-  MemoryLocations all_b_mlocs;
-
-  collectAllContainedMemoryLocations(a, all_a_mlocs);
-  collectAllContainedMemoryLocations(b, all_b_mlocs);
-
-  return all_a_mlocs.intersects(all_b_mlocs);
+  return getAllContainedMemoryLocations(a).intersects(
+      getAllContainedMemoryLocations(b));
 }
 
 bool MemoryDAG::mayContainAlias(
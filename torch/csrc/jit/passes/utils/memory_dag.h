@@ -91,6 +91,11 @@ class TORCH_API MemoryDAG {
   // Converts from the compressed index representation
   const Element* fromIndex(unsigned x) const;
   Element* fromIndex(unsigned x);
+
+  // Return the memory locations of `elem` and of everything it contains,
+  // recursively.
+  const MemoryLocations& getAllContainedMemoryLocations(
+      const Element* elem) const;
   void collectAllContainedMemoryLocations(
       const Element* elem,
       MemoryLocations& cont) const;
@@ -114,6 +119,9 @@ class TORCH_API MemoryDAG {
   bool mayAliasImpl(const Element* a, const Element* b) const;
   bool mayContainAliasImpl(const Element* contained, const Element* container)
       const;
+  void collectAllContainedMemoryLocationsImpl(
+      const Element* elem,
+      MemoryLocations& cont) const;
   std::vector<std::unique_ptr<Element>> indexToElementMap_;
 };
 
@@ -151,6 +159,9 @@ struct Element {
   // A nullopt means that this cache is not yet populated. Since `MemoryDAG` is
   // immutable, this cache should never need to be invalidated.
   mutable c10::optional<MemoryLocations> cachedMemoryLocations_;
+  // The same for `getAllContainedMemoryLocations`. It is only populated once
+  // the wildcards are set, which is the last change to `cachedMemoryLocations_`.
+  mutable c10::optional<MemoryLocations> cachedAllContainedMemoryLocations_;
 };
 
 } // namespace jit
@@ -12,6 +12,7 @@
 #include <torch/csrc/jit/passes/hoist_conv_packed_params.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/quantization/fusion_passes.h>
 #include <torch/csrc/jit/passes/remove_dropout.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 #include <torch/csrc/jit/passes/xnnpack_rewrite.h>
@@ -389,6 +390,14 @@ script::Module optimizeForMobile(
 
   if (!optimization_blocklist.count(MobileOptimizerType::FUSE_ADD_RELU)) {
     FuseAddRelu(cloned_module);
+    auto graph = cloned_module.get_method("forward").graph();
+    FuseQuantizedAddRelu(graph);
+  }
+
+  if (!optimization_blocklist.count(
+          MobileOptimizerType::FUSE_QUANTIZED_CONV_ADD)) {
+    auto graph = cloned_module.get_method("forward").graph();
+    FuseQuantizedConvAdd(graph);
   }
 
   return cloned_module;
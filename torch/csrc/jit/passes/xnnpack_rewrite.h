@@ -12,6 +12,7 @@ enum class MobileOptimizerType : int8_t {
   REMOVE_DROPOUT,
   FUSE_ADD_RELU,
   HOIST_CONV_PACKED_PARAMS,
+  FUSE_QUANTIZED_CONV_ADD,
 };
 
 TORCH_API void transformConv1dToConv2d(std::shared_ptr<Graph>& graph);
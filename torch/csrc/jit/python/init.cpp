@@ -7,11 +7,13 @@
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/frontend/tracer.h>
 #include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_graph_fuser_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/cpu_prepack.h>
 #include <torch/csrc/jit/passes/create_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/create_functional_graphs.h>
 #include <torch/csrc/jit/passes/cuda_graph_fuser.h>
@@ -28,6 +30,9 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memoize_subgraphs.h>
+#include <torch/csrc/jit/passes/memory_reuse.h>
+#include <torch/csrc/jit/passes/mkldnn_layout.h>
 #include <torch/csrc/jit/passes/normalize_ops.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/cast_all_constant_to_floating.h>
@@ -57,6 +62,7 @@
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/passes/tensorexpr_aot.h>
 #include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 #include <torch/csrc/jit/passes/utils/check_alias_annotation.h>
 #include <torch/csrc/jit/passes/vulkan_rewrite.h>
@@ -82,6 +88,7 @@
 
 #include <c10/macros/Export.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 
 #include <ATen/core/function_schema.h>
 
@@ -100,6 +107,7 @@ namespace jit {
 
 using ::c10::Argument;
 using ::c10::FunctionSchema;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::PyTorchStreamWriter;
 
@@ -211,6 +219,9 @@ void initJITBindings(PyObject* module) {
           [](std::shared_ptr<Graph>& g) {
             return FuseQuantizedAddRelu(g); // overload resolution
           })
+      .def("_jit_pass_fuse_quantized_conv_add", &FuseQuantizedConvAdd)
+      .def("_jit_pass_fuse_requantize_chains", &FuseRequantizeChains)
+      .def("_jit_count_dequantize_uses", &CountDequantizeUses)
       .def(
           "_jit_pass_insert_observers",
           [](Module& module,
@@ -267,6 +278,7 @@ void initJITBindings(PyObject* module) {
           py::arg("preservedAttrs") = std::vector<std::string>(),
           py::arg("freezeInterfaces") = true)
       .def("_jit_pass_fuse_linear", &FuseLinear)
+      .def("_jit_pass_fuse_addmm_activation", &FuseAddMMActivation)
       .def(
           "_jit_pass_fuse_add_relu",
           [](std::shared_ptr<Graph>& graph) { FuseAddRelu(graph); })
@@ -321,6 +333,9 @@ void initJITBindings(PyObject* module) {
           "_jit_pass_remove_inplace_ops",
           [](std::shared_ptr<Graph> g) { return RemoveInplaceOps(g); })
       .def("_jit_pass_constant_pooling", ConstantPooling)
+      .def(
+          "_jit_pass_batch_mm",
+          [](std::shared_ptr<Graph>& g) { return BatchMM(g); })
       .def(
           "_jit_pass_create_functional_graphs",
           [](std::shared_ptr<Graph>& g) { return CreateFunctionalGraphs(g); })
@@ -330,6 +345,9 @@ void initJITBindings(PyObject* module) {
             RemoveListMutation(g);
             return RemoveTensorMutation(g);
           })
+      .def(
+          "_jit_pass_reuse_intermediate_buffers",
+          [](std::shared_ptr<Graph>& g) { return ReuseIntermediateBuffers(g); })
       .def(
           "_jit_pass_inline_functional_graphs",
           [](std::shared_ptr<Graph>& g) { return InlineFunctionalGraphs(g); })
@@ -388,6 +406,7 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_constant_propagation",
           [](std::shared_ptr<Graph>& g) { return ConstantPropagation(g); })
+      .def("_jit_pass_memoize_subgraphs", MemoizeSubgraphs)
       .def("_jit_pass_erase_shape_information", EraseShapeInformation)
       .def(
           "_jit_pass_create_autodiff_subgraphs",
@@ -441,6 +460,7 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_decompose_ops", DecomposeOps)
       .def("_jit_pass_specialize_autogradzero", specializeAutogradZero)
       .def("_jit_override_can_fuse_on_cpu", &overrideCanFuseOnCPU)
+      .def("_jit_set_fused_kernel_cache_dir", &setFusedKernelCacheDir)
       .def("_jit_override_can_fuse_on_gpu", &overrideCanFuseOnGPU)
       .def("_jit_can_fuse_on_cpu", &canFuseOnCPU)
       .def("_jit_can_fuse_on_gpu", &canFuseOnGPU)
@@ -484,6 +504,13 @@ void initJITBindings(PyObject* module) {
             getNumProfiledRuns() = num;
             return old_num;
           })
+      .def(
+          "_jit_set_num_stable_profiled_runs",
+          [](size_t num) {
+            size_t old_num = getNumStableProfiledRuns();
+            getNumStableProfiledRuns() = num;
+            return old_num;
+          })
       .def(
           "_jit_set_bailout_depth",
           [](size_t depth) {
@@ -491,6 +518,13 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def(
+          "_jit_set_plan_cache_capacity",
+          [](size_t capacity) {
+            size_t old_capacity = getPlanCacheCapacity();
+            getPlanCacheCapacity() = capacity;
+            return old_capacity;
+          })
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { getInlineEverythingMode() = enabled; })
@@ -552,7 +586,22 @@ void initJITBindings(PyObject* module) {
           })
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
       .def("_jit_texpr_fuser_enabled", &tensorExprFuserEnabled)
+      .def(
+          "_jit_set_texpr_dynamic_shapes_enabled",
+          &setTensorExprDynamicShapesEnabled)
+      .def(
+          "_jit_texpr_dynamic_shapes_enabled",
+          &tensorExprDynamicShapesEnabled)
       .def("_jit_texpr_fallback_allowed", &tensorexpr::fallbackAllowed)
+      .def(
+          "_llvm_enabled",
+          []() {
+#ifdef TORCH_ENABLE_LLVM
+            return true;
+#else
+            return false;
+#endif
+          })
       .def("_jit_texpr_set_fallback_allowed", &tensorexpr::setFallbackAllowed)
       .def(
           "_jit_set_te_generate_block_code",
@@ -566,6 +615,24 @@ void initJITBindings(PyObject* module) {
             using namespace torch::jit::tensorexpr;
             return getTEGenerateBlockCode();
           })
+      .def(
+          "_jit_set_te_autotune",
+          [](bool autotune) {
+            using namespace torch::jit::tensorexpr;
+            return getTEAutotune() = autotune;
+          })
+      .def(
+          "_jit_get_te_autotune",
+          []() -> bool {
+            using namespace torch::jit::tensorexpr;
+            return getTEAutotune();
+          })
+      .def(
+          "_jit_set_te_schedule_cache_file",
+          &tensorexpr::setTEScheduleCacheFile)
+      .def(
+          "_jit_get_te_schedule_cache_file",
+          &tensorexpr::getTEScheduleCacheFile)
       .def(
           "_jit_pass_fuse_tensorexprs",
           [](std::shared_ptr<Graph>& g) { return FuseTensorExprs(g); })
@@ -603,6 +670,22 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_fold_prepacking_ops",
           [](script::Module& module) { return FoldPrePackingOps(module); })
+      .def(
+          "_jit_pass_prepack_cpu_weights",
+          [](script::Module& module, bool allow_fp16_weights) {
+            return PrePackCPUWeights(module, allow_fp16_weights);
+          },
+          py::arg("module"),
+          py::arg("allow_fp16_weights") = false)
+      .def(
+          "_jit_pass_propagate_mkldnn_layout",
+          [](script::Module& module) { return PropagateMKLDNNLayout(module); })
+      .def(
+          "_jit_pass_te_compile_ahead_of_time",
+          [](script::Module& module,
+             const std::vector<at::Tensor>& example_inputs) {
+            return CompileTensorExprsAheadOfTime(module, example_inputs);
+          })
       .def(
           "_jit_pass_optimize_for_mobile",
           [](script::Module& module,
@@ -736,12 +819,20 @@ void initJITBindings(PyObject* module) {
           "execution_plans",
           [](GraphExecutorState& s) { return s.execution_plans; })
       .def_property_readonly(
-          "fallback", [](GraphExecutorState& s) { return s.fallback; });
+          "fallback", [](GraphExecutorState& s) { return s.fallback; })
+      .def_readonly("plan_cache_hits", &GraphExecutorState::plan_cache_hits)
+      .def_readonly(
+          "plan_cache_misses", &GraphExecutorState::plan_cache_misses)
+      .def_readonly(
+          "plan_cache_evictions", &GraphExecutorState::plan_cache_evictions)
+      .def_readonly("plan_cache_size", &GraphExecutorState::plan_cache_size);
 
   py::class_<PyTorchStreamWriter>(m, "PyTorchFileWriter")
       .def(py::init<std::string>())
       .def(py::init([](const py::object& buffer) {
         auto writer_func = [=](const void* data, size_t size) {
+          // write_record runs without the GIL
+          pybind11::gil_scoped_acquire gil;
           auto bytes = py::bytes(reinterpret_cast<const char*>(data), size);
           buffer.attr("write")(std::move(bytes));
           return size;
@@ -754,17 +845,34 @@ void initJITBindings(PyObject* module) {
           [](PyTorchStreamWriter& self,
              const std::string& name,
              const char* data,
-             size_t size) { return self.writeRecord(name, data, size); })
-      .def("write_end_of_file", &PyTorchStreamWriter::writeEndOfFile)
+             size_t size,
+             bool compress) {
+            return self.writeRecord(name, data, size, compress);
+          },
+          py::arg("name"),
+          py::arg("data"),
+          py::arg("size"),
+          py::arg("compress") = false,
+          py::call_guard<pybind11::gil_scoped_release>())
+      .def(
+          "write_end_of_file",
+          &PyTorchStreamWriter::writeEndOfFile,
+          py::call_guard<pybind11::gil_scoped_release>())
       .def(
           "write_record",
           [](PyTorchStreamWriter& self,
              const std::string& name,
              uintptr_t data,
-             size_t size) {
+             size_t size,
+             bool compress) {
             return self.writeRecord(
-                name, reinterpret_cast<const char*>(data), size);
-          });
+                name, reinterpret_cast<const char*>(data), size, compress);
+          },
+          py::arg("name"),
+          py::arg("data"),
+          py::arg("size"),
+          py::arg("compress") = false,
+          py::call_guard<pybind11::gil_scoped_release>());
 
   py::enum_<MobileOptimizerType>(m, "MobileOptimizerType")
       .value("CONV_BN_FUSION", MobileOptimizerType::CONV_BN_FUSION)
@@ -776,6 +884,9 @@ void initJITBindings(PyObject* module) {
       .value(
           "HOIST_CONV_PACKED_PARAMS",
           MobileOptimizerType::HOIST_CONV_PACKED_PARAMS)
+      .value(
+          "FUSE_QUANTIZED_CONV_ADD",
+          MobileOptimizerType::FUSE_QUANTIZED_CONV_ADD)
       .export_values();
 
   // This allows PyTorchStreamReader to read from a Python buffer. It requires
@@ -809,6 +920,8 @@ void initJITBindings(PyObject* module) {
 
     size_t read(uint64_t pos, void* buf, size_t n, const char* what)
         const override {
+      // prefetch_records reads without the GIL
+      pybind11::gil_scoped_acquire gil;
       // Seek to desired position (NB: this has to be a Py_ssize_t or Python
       // throws a weird error)
       Py_ssize_t absolute_pos = start_offset_ + pos;
@@ -843,6 +956,13 @@ void initJITBindings(PyObject* module) {
 
   py::class_<PyTorchStreamReader>(m, "PyTorchFileReader")
       .def(py::init<std::string>())
+      .def(py::init([](const std::string& file_name, bool mmap) {
+        if (!mmap) {
+          return std::make_unique<PyTorchStreamReader>(file_name);
+        }
+        return std::make_unique<PyTorchStreamReader>(
+            std::make_unique<MmapFileAdapter>(file_name));
+      }))
       .def(py::init([](const py::object& buffer) {
         auto adapter = std::make_unique<BufferAdapter>(std::move(buffer));
         return std::make_unique<PyTorchStreamReader>(std::move(adapter));
@@ -878,6 +998,10 @@ void initJITBindings(PyObject* module) {
                     at::CPU(scalar_type).typeMeta());
             return at::Tensor(std::move(ptr));
           })
+      .def(
+          "prefetch_records",
+          &PyTorchStreamReader::prefetchRecords,
+          py::call_guard<pybind11::gil_scoped_release>())
       .def("get_all_records", [](PyTorchStreamReader& self) {
         return self.getAllRecords();
       });
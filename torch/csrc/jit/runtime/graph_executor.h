@@ -41,6 +41,11 @@ struct GraphExecutorState {
   const Graph* graph = nullptr;
   ExecutionPlan fallback; // XXX: members of this field are optional
   std::unordered_map<ArgumentSpec, ExecutionPlan> execution_plans;
+  // statistics of the profiling executor's plan cache
+  size_t plan_cache_hits = 0;
+  size_t plan_cache_misses = 0;
+  size_t plan_cache_evictions = 0;
+  size_t plan_cache_size = 0;
 };
 
 struct GraphExecutorImplBase;
@@ -86,7 +91,15 @@ TORCH_API std::shared_ptr<Graph> lastExecutedOptimizedGraph();
 TORCH_API std::atomic<bool>& getProfilingMode();
 TORCH_API std::atomic<bool>& getExecutorMode();
 TORCH_API std::atomic<size_t>& getNumProfiledRuns();
+// Number of profiling runs in a row which leave the profiled types unchanged
+// after which profiling stops, before getNumProfiledRuns() runs. 0 always
+// profiles getNumProfiledRuns() runs.
+TORCH_API std::atomic<size_t>& getNumStableProfiledRuns();
 TORCH_API std::atomic<size_t>& getBailoutDepth();
+// Maximum number of shape-specialized plans the profiling executor keeps per
+// graph, evicting the least recently used one. 0 disables the cache, in
+// which case a single plan is profiled and guarded against bailouts.
+TORCH_API std::atomic<size_t>& getPlanCacheCapacity();
 TORCH_API bool IsNewExecutorEnabled();
 
 struct TORCH_API GraphOptimizerEnabledGuard {
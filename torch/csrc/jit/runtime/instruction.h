@@ -17,6 +17,7 @@ namespace jit {
 // T - index into the type table, used for guard instructions
 // S - index into object slots
 // C - index into code table
+// X - operand of a superinstruction, see CodeImpl::emitSuperinstructions
 
 #define FORALL_OPCODES(_)                                                      \
   _(OP, "O") /* invoke operator X */                                           \
@@ -54,7 +55,9 @@ namespace jit {
   _(FORK, "CN") /* launch a thread to run code entry x with N inputs  */       \
   _(WARN, "") /* emit a warning with line information */                       \
   _(ENTER, "EN") /* enter scope of a contextmanager */                         \
-  _(EXIT, "EX") /* exit the last entered contextmanager */
+  _(EXIT, "EX") /* exit the last entered contextmanager */                     \
+  _(OP_STORE, "OR") /* invoke operator X, store its output to register N */    \
+  _(FUSED_BINOP, "XI") /* run a LOAD, LOAD, OP, STORE sequence in place */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
@@ -30,6 +30,7 @@ using torch::distributed::autograd::DistAutogradContainer;
 
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <ostream>
@@ -273,6 +274,95 @@ inline int64_t getDistAutogradContextId() {
   return 0;
 #endif
 }
+
+// The operators that a FUSED_BINOP superinstruction runs without going
+// through the stack. They are stored in the high byte of its N, the low byte
+// holds the opcode of the instruction it replaced (LOAD, MOVE or LOADC).
+enum class FusedBinop : uint8_t {
+  AddInt,
+  SubInt,
+  MulInt,
+  EqInt,
+  NeInt,
+  LtInt,
+  GtInt,
+  LeInt,
+  GeInt,
+  ListGetItem,
+};
+
+c10::optional<FusedBinop> fusedBinopFor(Node* node) {
+  static const std::vector<std::pair<const char*, FusedBinop>> binops = {
+      {"aten::add.int(int a, int b) -> int", FusedBinop::AddInt},
+      {"aten::sub.int(int a, int b) -> int", FusedBinop::SubInt},
+      {"aten::mul.int(int a, int b) -> int", FusedBinop::MulInt},
+      {"aten::eq.int(int a, int b) -> bool", FusedBinop::EqInt},
+      {"aten::ne.int(int a, int b) -> bool", FusedBinop::NeInt},
+      {"aten::lt.int(int a, int b) -> bool", FusedBinop::LtInt},
+      {"aten::gt.int(int a, int b) -> bool", FusedBinop::GtInt},
+      {"aten::le.int(int a, int b) -> bool", FusedBinop::LeInt},
+      {"aten::ge.int(int a, int b) -> bool", FusedBinop::GeInt},
+      {"aten::__getitem__.t(t[](a) list, int idx) -> t(*)",
+       FusedBinop::ListGetItem},
+  };
+  static const std::unordered_set<Symbol> kinds = {aten::add,
+                                                   aten::sub,
+                                                   aten::mul,
+                                                   aten::eq,
+                                                   aten::ne,
+                                                   aten::lt,
+                                                   aten::gt,
+                                                   aten::le,
+                                                   aten::ge,
+                                                   aten::__getitem__};
+  if (!kinds.count(node->kind())) {
+    return c10::nullopt;
+  }
+  for (const auto& binop : binops) {
+    if (node->matches(binop.first)) {
+      return binop.second;
+    }
+  }
+  return c10::nullopt;
+}
+
+// Same semantics as the registered operators, see register_prim_ops.cpp
+// and getItem in register_ops_utils.h
+IValue runFusedBinop(FusedBinop op, const IValue& a, const IValue& b) {
+  switch (op) {
+    case FusedBinop::AddInt:
+      return a.toInt() + b.toInt();
+    case FusedBinop::SubInt:
+      return a.toInt() - b.toInt();
+    case FusedBinop::MulInt:
+      return a.toInt() * b.toInt();
+    case FusedBinop::EqInt:
+      return a.toInt() == b.toInt();
+    case FusedBinop::NeInt:
+      return a.toInt() != b.toInt();
+    case FusedBinop::LtInt:
+      return a.toInt() < b.toInt();
+    case FusedBinop::GtInt:
+      return a.toInt() > b.toInt();
+    case FusedBinop::LeInt:
+      return a.toInt() <= b.toInt();
+    case FusedBinop::GeInt:
+      return a.toInt() >= b.toInt();
+    case FusedBinop::ListGetItem: {
+      auto list = a.toListRef();
+      const int64_t list_size = list.size();
+      int64_t idx = b.toInt();
+      if (idx < 0) {
+        idx += list_size;
+      }
+      if (idx < 0 || idx >= list_size) {
+        throw std::out_of_range("list index out of range");
+      }
+      return list[idx];
+    }
+  }
+  TORCH_INTERNAL_ASSERT(false, "unknown fused binop");
+}
 } // namespace
 
 std::ostream& operator<<(std::ostream& out, Instruction inst);
@@ -415,6 +505,10 @@ struct CodeImpl {
   friend struct InterpreterState;
   std::vector<Instruction> instructions_;
 
+  // instructions_ with superinstructions patched in, this is what actually
+  // runs. instructions_ itself is left alone for serialization and mobile.
+  std::vector<Instruction> run_instructions_;
+
   // same length as instructions.
   // what node in the graph cause this
   // instruction to be emitted?
@@ -483,6 +577,7 @@ struct CodeImpl {
     // we deferred the emission of bailout blocks so they appear at the end
     // emit them now and patch up the jumps
     insertBailoutBlocks();
+    emitSuperinstructions();
   }
 
   const std::vector<c10::IValue>& constant_table() const {
@@ -498,6 +593,7 @@ struct CodeImpl {
         if (count-- == 0) {
           // patching GUARD to FAIL_GUARD
           instructions_[instr_index].op = FAIL_GUARD;
+          run_instructions_[instr_index].op = FAIL_GUARD;
           GRAPH_DEBUG(
               "Added a bailout request for ",
               index,
@@ -975,6 +1071,54 @@ struct CodeImpl {
     return *grad_executors_;
   }
 
+  static bool isOperandLoad(const Instruction& inst) {
+    return inst.op == LOAD || inst.op == MOVE || inst.op == LOADC;
+  }
+
+  // A superinstruction replaces the first instruction of the sequence it
+  // stands for and reads the operands it needs from the instructions after
+  // it, which are left in place. This keeps the length of the code and every
+  // index into it unchanged, so jump offsets, bailout requests and the source
+  // nodes used for error messages all stay valid, and executing one is the
+  // same as executing the sequence.
+  //
+  // - OP_STORE: an OP immediately followed by the STORE of its output
+  // - FUSED_BINOP: LOAD/MOVE/LOADC, LOAD/MOVE/LOADC, OP, STORE of an int
+  //   arithmetic or comparison operator or a list __getitem__. The registers
+  //   are read in place, so the operands never touch the stack and the
+  //   Operation is not called.
+  void emitSuperinstructions() {
+    run_instructions_ = instructions_;
+    const size_t n = instructions_.size();
+    for (size_t i = 0; i < n; ++i) {
+      Node* node = instructions_source_[i];
+      // all four instructions are emitted for the same node only when its
+      // inputs are loaded from registers as opposed to computed inline
+      if (i + 3 < n && isOperandLoad(instructions_[i]) &&
+          isOperandLoad(instructions_[i + 1]) &&
+          instructions_[i + 2].op == OP && instructions_[i + 3].op == STORE &&
+          instructions_source_[i + 1] == node &&
+          instructions_source_[i + 2] == node &&
+          instructions_source_[i + 3] == node && node->inputs().size() == 2) {
+        if (auto binop = fusedBinopFor(node)) {
+          uint16_t N = (static_cast<uint16_t>(*binop) << 8) |
+              static_cast<uint16_t>(instructions_[i].op);
+          run_instructions_[i] =
+              Instruction(FUSED_BINOP, instructions_[i].X, N);
+          i += 3;
+          continue;
+        }
+      }
+      if (i + 1 < n && instructions_[i].op == OP &&
+          instructions_[i + 1].op == STORE &&
+          instructions_[i + 1].X <= std::numeric_limits<uint16_t>::max()) {
+        run_instructions_[i] =
+            Instruction(OP_STORE, instructions_[i].X, instructions_[i + 1].X);
+        i += 1;
+      }
+    }
+  }
+
   void dump(std::ostream& out, size_t i) const {
     out << i << " " << instructions_[i];
     if (instructions_[i].op == OP || instructions_[i].op == CALL ||
@@ -993,6 +1137,16 @@ struct CodeImpl {
   }
 };
 
+// Forks of at most this many instructions run on the forking thread when no
+// inter-op thread is idle: queueing such a fork behind busy threads costs
+// more than running it, and delays the wait on it.
+constexpr size_t kMaxInlinedForkInstructions = 64;
+
+static bool shouldInlineFork(const Code& code) {
+  return code.instructions().size() <= kMaxInlinedForkInstructions &&
+      !at::internal::_interop_pool_has_idle_threads();
+}
+
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
@@ -1059,7 +1213,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
 
     ActiveFrame(const Frame& frame)
         : pc(frame.pc),
-          instructions(frame.function->instructions_.data()),
+          instructions(frame.function->run_instructions_.data()),
           constants(frame.function->constant_table_.data()),
           operators(frame.function->operator_table_.data()),
           functions(frame.function->function_table_.data()),
@@ -1092,6 +1246,17 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     return *(registers.end() - reg);
   }
 
+  // the value a LOAD, MOVE or LOADC folded into a superinstruction would push
+  const IValue& operand(const ActiveFrame& af, const Instruction& inst) {
+    return inst.op == LOADC ? af.constants[inst.X] : reg(inst.X);
+  }
+
+  void releaseOperand(const Instruction& inst) {
+    if (inst.op == MOVE) {
+      reg(inst.X) = IValue();
+    }
+  }
+
   void dump(std::ostream& out, const Stack& stack) const {
     out << "Stack:\n";
     for (const auto& val : stack) {
@@ -1195,6 +1360,23 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             reg(inst.X) = pop(stack);
             ++af.pc;
             break;
+          case OP_STORE:
+            af.operators[inst.X](&stack);
+            reg(inst.N) = pop(stack);
+            af.pc += 2;
+            break;
+          case FUSED_BINOP: {
+            Instruction lhs(static_cast<OpCode>(inst.N & 0xff), inst.X, 0);
+            Instruction rhs = af.instructions[af.pc + 1];
+            IValue result = runFusedBinop(
+                static_cast<FusedBinop>(inst.N >> 8),
+                operand(af, lhs),
+                operand(af, rhs));
+            releaseOperand(lhs);
+            releaseOperand(rhs);
+            reg(af.instructions[af.pc + 3].X) = std::move(result);
+            af.pc += 4;
+          } break;
           case STOREN:
             for (size_t i = inst.N; i > 0; --i) {
               reg(inst.X + i - 1) = pop(stack);
@@ -1481,17 +1663,24 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
           case FORK: {
             // Move inputs to a separate stack
             Function* forked_fn = af.functions[inst.X];
-            InterpreterState forked_interpreter(
+            const Code& forked_code =
                 forked_fn->get_executor()
                     .getPlanFor(stack, GraphExecutor::getDefaultNumBailOuts())
-                    .code);
+                    .code;
+            InterpreterState forked_interpreter(forked_code);
             InterpreterContinuation continuation(
                 forked_interpreter,
                 Stack(stack.end() - inst.N, stack.end()),
                 getDistAutogradContextId());
             drop(stack, inst.N);
             push(stack, forked_interpreter.getFuture());
-            at::launch(std::move(continuation));
+            if (shouldInlineFork(forked_code)) {
+              // A WAIT in the fork suspends it as usual, so this cannot
+              // deadlock on work this interpreter has yet to do.
+              continuation();
+            } else {
+              at::launch(std::move(continuation));
+            }
             ++af.pc;
           } break;
           case WARN: {
@@ -48,7 +48,9 @@ static std::atomic<bool> profiling_mode{false};
 #endif
 
 static std::atomic<size_t> num_profiled_runs{1};
+static std::atomic<size_t> num_stable_profiled_runs{2};
 static std::atomic<size_t> bailout_depth{1};
+static std::atomic<size_t> plan_cache_capacity{0};
 
 std::atomic<bool>& getProfilingMode() {
   return profiling_mode;
@@ -61,10 +63,18 @@ std::atomic<size_t>& getNumProfiledRuns() {
   return num_profiled_runs;
 }
 
+std::atomic<size_t>& getNumStableProfiledRuns() {
+  return num_stable_profiled_runs;
+}
+
 std::atomic<size_t>& getBailoutDepth() {
   return bailout_depth;
 }
 
+std::atomic<size_t>& getPlanCacheCapacity() {
+  return plan_cache_capacity;
+}
+
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
     if (n->kind() == prim::BailOut) {
@@ -382,8 +392,42 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
   std::lock_guard<std::mutex> lock(compile_mutex);
   GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
 
-  if (optimized_plan_) {
-    return *optimized_plan_;
+  // the simple executor does not specialize, a single plan serves all inputs
+  size_t capacity = getPlanCacheCapacity();
+  if (capacity == 0 || remaining_bailout_depth == 0) {
+    return selectPlan(plans_, remaining_bailout_depth);
+  }
+  return selectPlan(getCachedPlans(stack, capacity), remaining_bailout_depth);
+}
+
+ProfilingGraphExecutorImpl::ProfiledPlans& ProfilingGraphExecutorImpl::
+    getCachedPlans(const Stack& stack, size_t capacity) {
+  CompleteArgumentSpec spec(
+      autograd::GradMode::is_enabled(), last(stack, num_inputs));
+  auto it = plan_cache_index_.find(spec);
+  if (it != plan_cache_index_.end()) {
+    plan_cache_hits_++;
+    plan_cache_.splice(plan_cache_.begin(), plan_cache_, it->second);
+    return it->second->second;
+  }
+
+  plan_cache_misses_++;
+  while (plan_cache_.size() >= capacity) {
+    // plans handed out earlier stay valid, ExecutionPlan shares its Code
+    plan_cache_index_.erase(plan_cache_.back().first);
+    plan_cache_.pop_back();
+    plan_cache_evictions_++;
+  }
+  plan_cache_.emplace_front(spec, ProfiledPlans());
+  plan_cache_index_.emplace(std::move(spec), plan_cache_.begin());
+  return plan_cache_.front().second;
+}
+
+ExecutionPlan ProfilingGraphExecutorImpl::selectPlan(
+    ProfiledPlans& plans,
+    size_t remaining_bailout_depth) {
+  if (plans.optimized_plan) {
+    return *plans.optimized_plan;
   }
 
   // simple executor
@@ -391,43 +435,55 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
     GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
-    optimized_plan_ = ExecutionPlan(copy, function_name_);
-    return *optimized_plan_;
+    plans.optimized_plan = ExecutionPlan(copy, function_name_);
+    return *plans.optimized_plan;
   }
 
   // if a profiling graph hasn't been created yet
-  if (!pr_) {
+  if (!plans.pr) {
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
     if (remaining_bailout_depth == getBailoutDepth()) {
       PeelProfilingLoops(copy);
     }
-    pr_ = ProfilingRecord::instrumentGraph(copy);
-    auto pr_copy = pr_->graph()->copy();
+    plans.pr = ProfilingRecord::instrumentGraph(copy);
+    auto pr_copy = plans.pr->graph()->copy();
     GRAPH_DUMP("Profiled Graph: ", pr_copy);
-    profiling_plan_ = ExecutionPlan(pr_copy, function_name_);
+    plans.profiling_plan = ExecutionPlan(pr_copy, function_name_);
     // fall-through
   }
 
   // profile until a graph is ready
-  if (!pr_->ready()) {
-    return *profiling_plan_;
+  if (!plans.pr->ready()) {
+    return *plans.profiling_plan;
   }
 
-  auto copy = pr_->graph()->copy();
+  auto copy = plans.pr->graph()->copy();
   ProfilingRecord::removeProfileCounter(copy->block());
   runProfilingOptimizations(copy);
   // cache
-  optimized_plan_ =
+  plans.optimized_plan =
       ExecutionPlan(copy, function_name_, remaining_bailout_depth);
-  return *optimized_plan_;
+  return *plans.optimized_plan;
 }
 
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
+  std::lock_guard<std::mutex> lock(compile_mutex);
   GraphExecutorState state;
-  TORCH_INTERNAL_ASSERT(optimized_plan_);
-  auto opt_plan = *optimized_plan_;
-  state.execution_plans.emplace(ArgumentSpec{0, 0}, opt_plan);
+  // with the plan cache, report the most recently used optimized plan
+  const ProfiledPlans* plans = &plans_;
+  for (const auto& entry : plan_cache_) {
+    if (entry.second.optimized_plan) {
+      plans = &entry.second;
+      break;
+    }
+  }
+  TORCH_INTERNAL_ASSERT(plans->optimized_plan);
+  state.execution_plans.emplace(ArgumentSpec{0, 0}, *plans->optimized_plan);
+  state.plan_cache_hits = plan_cache_hits_;
+  state.plan_cache_misses = plan_cache_misses_;
+  state.plan_cache_evictions = plan_cache_evictions_;
+  state.plan_cache_size = plan_cache_.size();
   return state;
 }
 
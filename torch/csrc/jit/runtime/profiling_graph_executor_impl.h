@@ -1,6 +1,8 @@
 #pragma once
 #include <torch/csrc/jit/runtime/graph_executor_impl.h>
 
+#include <list>
+
 namespace torch {
 namespace jit {
 
@@ -15,12 +17,38 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   ~ProfilingGraphExecutorImpl() override = default;
 
  private:
+  // The profiling state and plans for one set of input shapes, or for all
+  // inputs if the plan cache is disabled.
+  struct ProfiledPlans {
+    std::unique_ptr<ProfilingRecord> pr;
+    // plan to run in order to profile the code
+    c10::optional<ExecutionPlan> profiling_plan;
+    c10::optional<ExecutionPlan> optimized_plan;
+  };
+
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
-  std::unique_ptr<ProfilingRecord> pr_;
-  c10::optional<ExecutionPlan>
-      profiling_plan_; // plan to run in order to profiling the code
-  c10::optional<ExecutionPlan> optimized_plan_;
+  // profiles or optimizes `plans` and returns the plan to run next
+  ExecutionPlan selectPlan(
+      ProfiledPlans& plans,
+      size_t remaining_bailout_depth);
+  // Returns the entry of the plan cache for the inputs on `stack`, creating
+  // it and evicting the least recently used entry if needed.
+  ProfiledPlans& getCachedPlans(const Stack& stack, size_t capacity);
+
+  ProfiledPlans plans_;
+
+  // Plans specialized to the exact sizes and strides of the inputs, used
+  // when getPlanCacheCapacity() is non-zero. Most recently used first.
+  using PlanCacheEntry = std::pair<CompleteArgumentSpec, ProfiledPlans>;
+  std::list<PlanCacheEntry> plan_cache_;
+  std::unordered_map<
+      CompleteArgumentSpec,
+      std::list<PlanCacheEntry>::iterator>
+      plan_cache_index_;
+  size_t plan_cache_hits_ = 0;
+  size_t plan_cache_misses_ = 0;
+  size_t plan_cache_evictions_ = 0;
 };
 
 } // namespace jit
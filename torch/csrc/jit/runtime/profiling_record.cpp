@@ -7,9 +7,115 @@
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 
+// Note [Profiling runs]
+// ~~~~~~~~~~~~~~~~~~~~~
+// The prim::profile nodes of a run record the types they observe in a
+// profile of the run kept by the thread executing it, without locking, and
+// the counter at the end of the graph merges the profile into the record once
+// per run under its mutex. A run which resumes on another thread after
+// waiting on a future loses the observations made before, which only makes
+// the profile less specific.
+//
+// Profiling is also cheaper once the types are known:
+//  - In a run, a value whose type was left unchanged by
+//    kNumUnchangedObservations observations in a row, e.g. in a loop, is
+//    only profiled every kSamplingInterval observations, until one changes
+//    its type again. A shape seen by the skipped observations only can fail
+//    a guard of the optimized graph, like a shape not seen during profiling.
+//  - Profiling stops before getNumProfiledRuns() runs once
+//    getNumStableProfiledRuns() runs in a row left the merged types
+//    unchanged.
+
+namespace {
+
+constexpr size_t kNumUnchangedObservations = 8;
+constexpr size_t kSamplingInterval = 8;
+// bounds the profiles of runs which never reached their counter because
+// they threw or resumed on another thread
+constexpr size_t kMaxRunProfilesPerThread = 16;
+
+std::atomic<size_t> num_profiling_records{0};
+
+struct ProfiledValue {
+  TensorTypePtr type;
+  size_t num_unchanged = 0;
+  size_t num_skipped = 0;
+};
+
+using RunTypes = std::unordered_map<Value*, ProfiledValue>;
+
+struct RunProfile {
+  size_t record_id;
+  int64_t frame_id;
+  RunTypes types;
+};
+
+thread_local std::vector<RunProfile> run_profiles;
+
+RunTypes& getRunTypes(size_t record_id, int64_t frame_id) {
+  // the innermost run in progress is the last one
+  for (auto it = run_profiles.rbegin(); it != run_profiles.rend(); ++it) {
+    if (it->record_id == record_id && it->frame_id == frame_id) {
+      return it->types;
+    }
+  }
+  if (run_profiles.size() >= kMaxRunProfilesPerThread) {
+    run_profiles.erase(run_profiles.begin());
+  }
+  run_profiles.push_back(RunProfile{record_id, frame_id, RunTypes()});
+  return run_profiles.back().types;
+}
+
+// Removes the profile of the run from the thread, as well as the ones of runs
+// of the same record which never completed.
+RunTypes takeRunTypes(size_t record_id, int64_t frame_id) {
+  RunTypes types;
+  for (auto& run : run_profiles) {
+    if (run.record_id == record_id && run.frame_id == frame_id) {
+      types = std::move(run.types);
+    }
+  }
+  run_profiles.erase(
+      std::remove_if(
+          run_profiles.begin(),
+          run_profiles.end(),
+          [record_id](const RunProfile& run) {
+            return run.record_id == record_id;
+          }),
+      run_profiles.end());
+  return types;
+}
+
+void observeTensor(ProfiledValue& profiled, const IValue& v) {
+  if (profiled.type && profiled.num_unchanged >= kNumUnchangedObservations &&
+      ++profiled.num_skipped % kSamplingInterval != 0) {
+    return;
+  }
+  auto t = v.toTensor();
+  TensorTypePtr type;
+  if (t.defined()) {
+    type = tensorTypeInCurrentExecutionContext(t);
+    if (profiled.type) {
+      type = profiled.type->merge(type);
+    }
+  } else {
+    type = TensorType::get()->withUndefined();
+  }
+  if (profiled.type && *type == *profiled.type) {
+    profiled.num_unchanged++;
+  } else {
+    profiled.type = type;
+    profiled.num_unchanged = 0;
+  }
+}
+
+} // namespace
+
 bool ShapeSymbolTable::bindSymbolicShapes(
     at::IntArrayRef new_sizes,
     const c10::SymbolicShape& sym_shapes) {
@@ -38,7 +144,9 @@ bool ShapeSymbolTable::bindSymbolicShapes(
 }
 
 ProfilingRecord::ProfilingRecord(std::shared_ptr<Graph> g)
-    : profiled_graph_(std::move(g)), profiling_count_(getNumProfiledRuns()) {}
+    : profiled_graph_(std::move(g)),
+      id_(num_profiling_records++),
+      profiling_count_(getNumProfiledRuns().load()) {}
 
 ProfileOp* ProfilingRecord::createProfileNode(
     const std::function<void(Stack&)>& fp,
@@ -127,31 +235,9 @@ void ProfilingRecord::insertShapeProfile(Node* n, size_t offset) {
     pop(stack, frame_id);
     IValue v;
     pop(stack, v);
-    if (v.isTensor()) {
-      std::lock_guard<std::mutex> lock(this->mutex_);
-      auto& profiled_types = profiled_types_per_frame_[frame_id];
-      auto t = v.toTensor();
-      if (t.defined()) {
-        auto pttp = tensorTypeInCurrentExecutionContext(t);
-        GRAPH_DEBUG(
-            "In run ",
-            frame_id,
-            " annotating %",
-            pno->debugName(),
-            " with ",
-            *pttp);
-        if (profiled_types.count(pno) == 0) {
-          profiled_types.insert({pno, pttp});
-        } else {
-          auto type = profiled_types.at(pno);
-          GRAPH_DEBUG("Existing type for %", pno->debugName(), " ", *type);
-          pttp = type->merge(pttp);
-          GRAPH_DEBUG("Result for %", pno->debugName(), " ", *pttp);
-          profiled_types[pno] = pttp;
-        }
-      } else {
-        profiled_types[pno] = TensorType::get()->withUndefined();
-      }
+    // See Note [Profiling runs]
+    if (v.isTensor() && !ready()) {
+      observeTensor(getRunTypes(id_, frame_id)[pno], v);
     }
     // passing t through
     push(stack, v);
@@ -247,10 +333,11 @@ void ProfilingRecord::instrumentBlock(Block* block) {
           pop(stack, frame_id);
           IValue value;
           pop(stack, value);
-          if (value.isNone()) {
-            opt_pn->i_(attr::num_none, opt_pn->i(attr::num_none) + 1);
-          } else {
-            opt_pn->i_(attr::num_present, opt_pn->i(attr::num_present) + 1);
+          // the counts are read once the record is ready
+          if (!ready()) {
+            auto count = value.isNone() ? attr::num_none : attr::num_present;
+            optional_profile_changed_ |= opt_pn->i(count) == 0;
+            opt_pn->i_(count, opt_pn->i(count) + 1);
           }
           push(stack, value);
         };
@@ -295,73 +382,68 @@ std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
     int64_t frame_id = 0;
     pop(stack, frame_id);
 
+    // See Note [Profiling runs]
+    auto run_types = takeRunTypes(raw_pr->id_, frame_id);
     std::lock_guard<std::mutex> lock(raw_pr->mutex_);
-
-    if (raw_pr->profiling_count_ > 0) {
-      raw_pr->profiling_count_--;
+    if (raw_pr->ready()) {
+      return;
     }
-
-    // merge profiling information from all runs
-    if (raw_pr->profiling_count_ == 0) {
-      GRAPH_DEBUG(
-          "Collected ",
-          raw_pr->profiled_types_per_frame_.size(),
-          " records for run ",
-          frame_id);
-
-      if (raw_pr->profiled_types_per_frame_.size() == 0) {
-        return;
+    GRAPH_DEBUG("Collected ", run_types.size(), " records for run ", frame_id);
+
+    // merge the profiling information of the run into the one of the
+    // previous runs, the first run provides the symbol sets
+    auto& merged_profiled_types = raw_pr->merged_profiled_types_;
+    bool changed = raw_pr->optional_profile_changed_;
+    raw_pr->optional_profile_changed_ = false;
+    SetPartitioningHelper partition_helper;
+    for (const auto& val_type_pair : run_types) {
+      Value* val = val_type_pair.first;
+      const auto& run_type = val_type_pair.second.type;
+      if (merged_profiled_types.count(val) == 0) {
+        merged_profiled_types[val] = run_type;
+        changed = true;
+        continue;
       }
-
-      // the key is a frame id
-      // the value is a mapping from a Value in a graph
-      // to a profiled TensorType
-      // we make a copy of profiling information from the very first run
-      // and use it for building the symbol sets
-      auto profiled_types_iter = raw_pr->profiled_types_per_frame_.begin();
-      auto merged_profiled_types = profiled_types_iter->second;
-      profiled_types_iter++;
-
-      // merge profiling information from next runs into the first one
-      for (; profiled_types_iter != raw_pr->profiled_types_per_frame_.end();
-           profiled_types_iter++) {
-        SetPartitioningHelper partition_helper;
-        for (const auto& val_type_pair : profiled_types_iter->second) {
-          if (merged_profiled_types.count(val_type_pair.first) == 0) {
-            merged_profiled_types[val_type_pair.first] = val_type_pair.second;
-          } else {
-            auto type = merged_profiled_types[val_type_pair.first];
-            auto merged_type = type->merge(val_type_pair.second);
-            if (merged_type->sizes().size().has_value()) {
-              auto new_shape = raw_pr->mergeSymbolicShapes(
-                  val_type_pair.second->symbolic_sizes(),
-                  type->symbolic_sizes(),
-                  partition_helper);
-              GRAPH_DEBUG(
-                  "Merging ",
-                  *val_type_pair.second,
-                  " of run ",
-                  profiled_types_iter->first,
-                  " into ",
-                  *type);
-              merged_type = type->withSymbolicShapes(new_shape);
-              GRAPH_DEBUG("Result : ", *merged_type);
-              merged_profiled_types[val_type_pair.first] = merged_type;
-            } else {
-              // reset symbolic shapes when ranks are different
-              type = type->merge(val_type_pair.second);
-              merged_profiled_types[val_type_pair.first] = type;
-            }
-          }
-        }
+      auto type = merged_profiled_types[val];
+      auto merged_type = type->merge(run_type);
+      if (merged_type->sizes().size().has_value()) {
+        auto new_shape = raw_pr->mergeSymbolicShapes(
+            run_type->symbolic_sizes(), type->symbolic_sizes(), partition_helper);
+        GRAPH_DEBUG(
+            "Merging ", *run_type, " of run ", frame_id, " into ", *type);
+        merged_type = type->withSymbolicShapes(new_shape);
+        GRAPH_DEBUG("Result : ", *merged_type);
+      }
+      // otherwise symbolic shapes are reset as the ranks are different
+      if (!(*merged_type == *type)) {
+        merged_profiled_types[val] = merged_type;
+        changed = true;
       }
+    }
+    raw_pr->num_merged_runs_++;
+    raw_pr->num_stable_runs_ = changed ? 0 : raw_pr->num_stable_runs_ + 1;
+
+    size_t profiling_count = raw_pr->profiling_count_.load() - 1;
+    size_t num_stable_runs_to_stop = getNumStableProfiledRuns();
+    if (profiling_count > 0 && num_stable_runs_to_stop > 0 &&
+        raw_pr->num_stable_runs_ >= num_stable_runs_to_stop) {
+      GRAPH_DEBUG(
+          "Profiled types stable after ",
+          raw_pr->num_merged_runs_,
+          " runs, skipping the ",
+          profiling_count,
+          " remaining ones");
+      profiling_count = 0;
+    }
 
-      // update types in the graph
-      for (auto val_type_pair : merged_profiled_types) {
+    // update types in the graph before the record is seen ready
+    if (profiling_count == 0) {
+      for (const auto& val_type_pair : merged_profiled_types) {
         val_type_pair.first->node()->ty_(
             attr::profiled_type, val_type_pair.second);
       }
     }
+    raw_pr->profiling_count_.store(profiling_count);
   };
 
   auto pop = pr->createProfileNode(counter, {});
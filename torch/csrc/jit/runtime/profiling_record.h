@@ -7,6 +7,7 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/jit/ir/ir.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <unordered_map>
@@ -180,12 +181,22 @@ struct ProfilingRecord {
   TORCH_API static void removeProfileCounter(Block* b);
 
   std::shared_ptr<Graph> profiled_graph_;
+  // identifies the record in the profiles of the runs in progress, which
+  // are kept per thread, see Note [Profiling runs]
+  const size_t id_;
+  // guards the members below and the profiled types of the nodes
   std::mutex mutex_;
-  size_t profiling_count_;
-  // the key is a frame id
-  // the value is a mapping from a Value in a graph
-  // to a profiled TensorType
-  std::map<int64_t, std::map<Value*, TensorTypePtr>> profiled_types_per_frame_;
+  // the number of runs left to profile, only written under mutex_ and after
+  // the profiled types of the nodes
+  std::atomic<size_t> profiling_count_;
+  // the profiled TensorTypes of the Values of the graph, merged over the
+  // completed runs
+  std::map<Value*, TensorTypePtr> merged_profiled_types_;
+  size_t num_merged_runs_ = 0;
+  // the number of last runs which didn't change the merged types
+  size_t num_stable_runs_ = 0;
+  // whether an optional value was first seen None, or present, in this run
+  bool optional_profile_changed_ = false;
 
   // A thin wrapper around `partitionSetByDimension` to ensure
   // `new_sizes` and `sym_shapes` are of the same rank
@@ -196,7 +207,7 @@ struct ProfilingRecord {
       SetPartitioningHelper& partition_helper);
 
   bool ready() const {
-    return profiling_count_ == 0;
+    return profiling_count_.load() == 0;
   }
   std::shared_ptr<Graph> graph() const {
     return profiled_graph_;
@@ -1,72 +1,66 @@
 #include <torch/csrc/jit/runtime/static/impl.h>
-#include <ATen/core/op_registration/op_registration.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/liveness.h>
 #include <torch/csrc/jit/passes/remove_mutation.h>
-#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/runtime/static/passes.h>
+#include <torch/csrc/jit/runtime/vararg_functions.h>
+
+#include <ATen/Parallel.h>
+#include <c10/core/CPUAllocator.h>
+#include <caffe2/core/timer.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
 
 namespace torch {
 namespace jit {
 
-using c10::DispatchKey;
-using c10::RegisterOperators;
-
-static auto reg =
-    RegisterOperators()
-        .op("static::add(Tensor a, Tensor b) -> Tensor",
-            RegisterOperators::options().kernel(
-                DispatchKey::CPU,
-                [](at::Tensor a, at::Tensor b) -> at::Tensor { return a + b; }))
-        .op("static::mul.a(Tensor a, Tensor b) -> Tensor",
-            RegisterOperators::options().kernel(
-                DispatchKey::CPU,
-                [](at::Tensor a, at::Tensor b) -> at::Tensor { return a * b; }))
-        .op("static::mul.b(Tensor a, int b) -> Tensor",
-            RegisterOperators::options().kernel(
-                DispatchKey::CPU,
-                [](at::Tensor a, int64_t b) -> at::Tensor { return a * b; }));
-
-#define SUPPORTED_OPS(F) \
-  F(aten::__getitem__)   \
-  F(aten::add)           \
-  F(aten::addmm)         \
-  F(aten::bmm)           \
-  F(aten::cat)           \
-  F(aten::clamp)         \
-  F(aten::contiguous)    \
-  F(aten::div)           \
-  F(aten::flatten)       \
-  F(aten::index_put_)    \
-  F(aten::isnan)         \
-  F(aten::matmul)        \
-  F(aten::mul)           \
-  F(aten::permute)       \
-  F(aten::relu)          \
-  F(aten::sigmoid)       \
-  F(aten::size)          \
-  F(aten::softmax)       \
-  F(aten::t)             \
-  F(aten::to)            \
-  F(aten::transpose)     \
-  F(aten::view)          \
-  F(prim::Constant)      \
-  F(prim::ListConstruct) \
-  F(prim::TupleConstruct)
-
-StaticRuntime::StaticRuntime(const torch::jit::Module& m)
-    : module_(m.copy()), graph_(nullptr) {
-  module_.eval();
-  module_ = freeze_module(module_);
-  graph_ = module_.get_method("forward").graph();
+#define SUPPORTED_OPS(F)        \
+  F(aten::__getitem__)          \
+  F(aten::add)                  \
+  F(aten::addmm)                \
+  F(aten::bmm)                  \
+  F(aten::cat)                  \
+  F(aten::clamp)                \
+  F(aten::contiguous)           \
+  F(aten::div)                  \
+  F(aten::flatten)              \
+  F(aten::index_put_)           \
+  F(aten::isnan)                \
+  F(aten::matmul)               \
+  F(aten::mul)                  \
+  F(aten::permute)              \
+  F(aten::relu)                 \
+  F(aten::sigmoid)              \
+  F(aten::size)                 \
+  F(aten::softmax)              \
+  F(aten::t)                    \
+  F(aten::to)                   \
+  F(aten::transpose)            \
+  F(aten::view)                 \
+  F(prim::Constant)             \
+  F(prim::DictConstruct)        \
+  F(prim::FusedConcat)          \
+  F(prim::ListConstruct)        \
+  F(prim::ListUnpack)           \
+  F(prim::TupleConstruct)       \
+  F(prim::TupleIndex)           \
+  F(prim::TupleUnpack)          \
+  F(static_runtime::addmm_relu) \
+  F(static_runtime::sigmoid_mul)
 
-  Inline(*graph_);
-  ConstantPropagation(graph_);
-  Canonicalize(graph_);
-  ConstantPropagation(graph_);
-  RemoveTensorMutation(graph_);
-  ConstantPropagation(graph_);
+namespace {
 
-  for (auto n : graph_->nodes()) {
+void checkGraph(const std::shared_ptr<Graph>& graph) {
+  for (auto n : graph->nodes()) {
     if (n->kind() == c10::Symbol::fromQualString("prim::GetAttr")) {
       throw std::runtime_error("Cannot accelerate unfrozen graphs");
     }
@@ -82,36 +76,347 @@ StaticRuntime::StaticRuntime(const torch::jit::Module& m)
           std::string("Unsupported operation: ") + n->kind().toQualString());
     }
   }
+}
 
-  SubgraphRewriter sr;
-  sr.RegisterRewritePattern(
-      R"IR(
-  graph(%x, %w, %s):
-    %r = aten::add(%x, %w, %s)
-    return (%r))IR",
-      R"IR(
-  graph(%x, %w, %s):
-    %y = static::add(%x, %w)
-    %r = static::mul(%y, %s)
-    return (%r))IR");
-  sr.runOnGraph(graph_);
-  code_ = std::make_unique<Code>(graph_, "");
-  interp_ = std::make_unique<InterpreterState>(*code_);
+} // namespace
+
+StaticModule::StaticModule(
+    std::shared_ptr<torch::jit::Graph> g,
+    const StaticRuntimeOptions& opts)
+    : graph_(g->copy()), opts_(opts) {
+  init();
 }
 
-std::vector<at::Tensor> StaticRuntime::run(
-    const std::vector<at::Tensor>& inps) const {
-  std::vector<torch::jit::IValue> stack;
-  if (graph_->inputs().at(0)->type()->is_module()) {
-    stack.emplace_back(module_._ivalue());
+StaticModule::StaticModule(
+    const torch::jit::Module& m,
+    const StaticRuntimeOptions& opts)
+    : module_(m.copy()), graph_(nullptr), opts_(opts) {
+  module_.eval();
+  module_ = freeze_module(module_);
+  Method forward = module_.get_method("forward");
+  graph_ = forward.graph();
+  schema_ = forward.function().getSchema();
+
+  Inline(*graph_);
+  ConstantPropagation(graph_);
+  Canonicalize(graph_);
+  ConstantPropagation(graph_);
+  RemoveTensorMutation(graph_);
+  ConstantPropagation(graph_);
+  init();
+}
+
+void StaticModule::init() {
+  FuseStaticRuntimeOps(graph_);
+  checkGraph(graph_);
+
+  std::unordered_map<const Value*, size_t> value_to_reg;
+  auto assign_reg = [&](const Value* v) {
+    size_t r = initial_values_.size();
+    value_to_reg.emplace(v, r);
+    initial_values_.emplace_back();
+    return r;
+  };
+
+  for (size_t i = 0; i < graph_->inputs().size(); ++i) {
+    const Value* v = graph_->inputs()[i];
+    size_t r = assign_reg(v);
+    if (i == 0 && v->type()->is_module()) {
+      // the frozen module's self is never read by the graph body, but it is
+      // kept in the table so that any attribute access would still resolve
+      initial_values_[r] = module_._ivalue();
+    } else {
+      input_regs_.push_back(r);
+    }
   }
-  for (const auto& inp : inps) {
-    stack.emplace_back(inp);
+
+  for (Node* n : graph_->nodes()) {
+    if (n->kind() == prim::Constant) {
+      TORCH_CHECK(n->outputs().size() == 1);
+      size_t r = assign_reg(n->output());
+      initial_values_[r] = toIValue(n->output()).value();
+      continue;
+    }
+    std::vector<size_t> input_regs;
+    input_regs.reserve(n->inputs().size());
+    for (const Value* v : n->inputs()) {
+      input_regs.push_back(value_to_reg.at(v));
+    }
+    std::vector<size_t> output_regs;
+    output_regs.reserve(n->outputs().size());
+    for (const Value* v : n->outputs()) {
+      output_regs.push_back(assign_reg(v));
+    }
+    nodes_.emplace_back(
+        n,
+        std::move(input_regs),
+        std::move(output_regs),
+        opts_.enable_out_variant);
+  }
+
+  for (const Value* v : graph_->outputs()) {
+    output_regs_.push_back(value_to_reg.at(v));
+  }
+
+  AliasDb alias_db(graph_);
+  for (const auto& pnode : nodes_) {
+    for (size_t i = 0; i < pnode.num_outputs(); ++i) {
+      Value* v = pnode.get_node()->outputs()[i];
+      if (alias_db.mayContainAlias(v, graph_->outputs())) {
+        output_alias_regs_.push_back(pnode.output_regs()[i]);
+      }
+    }
   }
 
-  interp_->run(stack);
+  if (opts_.max_parallel_branches > 1) {
+    initBranchPlan(alias_db);
+  }
+  if (opts_.enable_out_variant && opts_.optimize_memory) {
+    initMemoryPlanner(alias_db);
+  }
+}
+
+void StaticModule::initBranchPlan(AliasDb& alias_db) {
+  for (const auto& pnode : nodes_) {
+    Node* n = pnode.get_node();
+    if (n->hasSideEffects() || alias_db.isMutable(n)) {
+      // ordering between writers and readers is not expressed as data
+      // dependencies, keep running the graph sequentially
+      return;
+    }
+  }
+
+  std::unordered_map<const Node*, size_t> node_index;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    node_index.emplace(nodes_[i].get_node(), i);
+  }
+
+  auto plan = std::make_unique<BranchPlan>();
+  plan->branch_of.resize(nodes_.size());
+  // last node of each branch, a node only continues a branch from its tail
+  std::vector<size_t> tail;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    std::vector<size_t> preds;
+    for (const Value* v : nodes_[i].get_node()->inputs()) {
+      auto it = node_index.find(v->node());
+      if (it != node_index.end() &&
+          std::find(preds.begin(), preds.end(), it->second) == preds.end()) {
+        preds.push_back(it->second);
+      }
+    }
+
+    // Only nodes with a single producer extend a branch. Nodes with several
+    // producers start a new one, so that branches only have incoming
+    // dependencies at their head and the branch graph stays acyclic.
+    if (preds.size() == 1 && tail[plan->branch_of[preds[0]]] == preds[0]) {
+      size_t b = plan->branch_of[preds[0]];
+      plan->branch_of[i] = b;
+      plan->branches[b].push_back(i);
+      tail[b] = i;
+      continue;
+    }
+
+    size_t b = plan->branches.size();
+    plan->branches.push_back({i});
+    plan->successors.emplace_back();
+    plan->num_predecessors.push_back(0);
+    plan->ancestors.emplace_back(b + 1, false);
+    tail.push_back(i);
+    plan->branch_of[i] = b;
+    for (size_t p : preds) {
+      size_t pb = plan->branch_of[p];
+      auto& succs = plan->successors[pb];
+      if (std::find(succs.begin(), succs.end(), b) != succs.end()) {
+        continue;
+      }
+      succs.push_back(b);
+      plan->num_predecessors[b]++;
+      auto& anc = plan->ancestors[b];
+      const auto& pred_anc = plan->ancestors[pb];
+      for (size_t a = 0; a < pred_anc.size(); ++a) {
+        anc[a] = anc[a] || pred_anc[a];
+      }
+      anc[pb] = true;
+    }
+  }
+
+  if (plan->branches.size() > 1) {
+    branch_plan_ = std::move(plan);
+  }
+}
+
+bool StaticModule::happensBefore(size_t a, size_t b) const {
+  if (!branch_plan_) {
+    return a < b;
+  }
+  size_t branch_a = branch_plan_->branch_of[a];
+  size_t branch_b = branch_plan_->branch_of[b];
+  if (branch_a == branch_b) {
+    return a < b;
+  }
+  const auto& anc = branch_plan_->ancestors[branch_b];
+  return branch_a < anc.size() && anc[branch_a];
+}
+
+size_t StaticModule::numParallelWorkers() const {
+  if (!branch_plan_) {
+    return 1;
+  }
+  size_t workers = std::min(
+      opts_.max_parallel_branches,
+      static_cast<size_t>(at::get_num_interop_threads()) + 1);
+  // Each concurrently running branch calls into the shared intra-op pool
+  // from its own thread, adding one thread on top of the pool. Keep the
+  // total within the default intra-op budget, i.e. the number of cores.
+  int budget = at::intraop_default_num_threads() - at::get_num_threads() + 1;
+  workers = std::min(workers, static_cast<size_t>(std::max(budget, 1)));
+  return std::min(workers, branch_plan_->branches.size());
+}
+
+void StaticModule::initMemoryPlanner(AliasDb& alias_db) {
+  // nodes at which each value is used or live
+  std::unordered_map<const Value*, std::vector<size_t>> live_at;
+  auto liveness = BuildLivenessSets(graph_);
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    Node* n = nodes_[i].get_node();
+    for (const Value* v : n->inputs()) {
+      live_at[v].push_back(i);
+    }
+    auto it = liveness.find(n);
+    if (it != liveness.end()) {
+      for (const Value* v : it->second) {
+        live_at[v].push_back(i);
+      }
+    }
+  }
+
+  std::vector<Value*> all_values;
+  for (const auto& pnode : nodes_) {
+    for (Value* v : pnode.get_node()->outputs()) {
+      all_values.push_back(v);
+    }
+  }
+
+  std::unordered_set<size_t> output_alias_regs(
+      output_alias_regs_.begin(), output_alias_regs_.end());
+
+  // slots in order of creation, each with the nodes that have to finish
+  // before the slot can be handed to another value
+  std::vector<std::vector<size_t>> slots;
+  std::vector<std::vector<size_t>> slot_users;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const auto& pnode = nodes_[i];
+    if (!pnode.has_out_variant()) {
+      continue;
+    }
+    for (size_t j = 0; j < pnode.num_outputs(); ++j) {
+      Value* v = pnode.get_node()->outputs()[j];
+      size_t r = pnode.output_regs()[j];
+      if (!v->type()->cast<TensorType>() || output_alias_regs.count(r)) {
+        continue;
+      }
+      // a value is live until the last use of anything that may alias it,
+      // e.g. a view or a list holding it
+      std::vector<size_t> users{i};
+      for (Value* w : all_values) {
+        auto it = live_at.find(w);
+        if (it != live_at.end() && alias_db.mayContainAlias(w, v)) {
+          users.insert(users.end(), it->second.begin(), it->second.end());
+        }
+      }
+      // Sharing with a value that is read by the producing node would let
+      // the kernel write into its own input, so every user of the previous
+      // occupant has to finish strictly before this node.
+      size_t s = 0;
+      for (; s < slots.size(); ++s) {
+        const auto& prev_users = slot_users[s];
+        if (std::all_of(prev_users.begin(), prev_users.end(), [&](size_t u) {
+              return happensBefore(u, i);
+            })) {
+          break;
+        }
+      }
+      if (s == slots.size()) {
+        slots.emplace_back();
+        slot_users.emplace_back();
+      }
+      slots[s].push_back(r);
+      slot_users[s] = std::move(users);
+    }
+  }
+
+  memory_slots_ = std::move(slots);
+  plans_memory_ = true;
+}
+
+std::vector<IValue> StaticModule::normalizeInputs(
+    std::vector<IValue> args,
+    const std::unordered_map<std::string, IValue>& kwargs) const {
+  if (!schema_) {
+    TORCH_CHECK(
+        kwargs.empty(),
+        "Keyword arguments require a StaticModule created from a Module");
+    return args;
+  }
+  // the schema of forward includes self
+  args.insert(args.begin(), module_._ivalue());
+  schema_->checkAndNormalizeInputs(args, kwargs);
+  args.erase(args.begin());
+  return args;
+}
+
+StaticRuntime::StaticRuntime(
+    std::shared_ptr<torch::jit::Graph> g,
+    const StaticRuntimeOptions& opts)
+    : StaticRuntime(std::make_shared<StaticModule>(std::move(g), opts)) {}
+
+StaticRuntime::StaticRuntime(
+    const torch::jit::Module& m,
+    const StaticRuntimeOptions& opts)
+    : StaticRuntime(std::make_shared<StaticModule>(m, opts)) {}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<const StaticModule> static_module)
+    : static_module_(std::move(static_module)),
+      reg_(static_module_->initial_values()) {
+  if (static_module_->plans_memory()) {
+    planner_ = std::make_unique<MemoryPlanner>(static_module_->memory_slots());
+  }
+}
+
+void StaticRuntime::setInputs(std::vector<IValue>&& inps) {
+  const auto& input_regs = static_module_->input_regs();
+  TORCH_CHECK(
+      inps.size() == input_regs.size(),
+      "Expected ",
+      input_regs.size(),
+      " inputs but got ",
+      inps.size());
+  for (size_t i = 0; i < inps.size(); ++i) {
+    reg_[input_regs[i]] = std::move(inps[i]);
+  }
+
+  if (planner_) {
+    planner_->allocate(reg_);
+  }
+}
+
+void StaticRuntime::runNodes() {
+  if (branch_plan() && numParallelWorkers() > 1) {
+    runBranches();
+  } else {
+    for (const auto& n : nodes()) {
+      n.run(reg_);
+    }
+  }
+}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inps) {
+  setInputs(std::vector<IValue>(inps.begin(), inps.end()));
+  runNodes();
+
   std::vector<at::Tensor> out;
-  for (const auto& v : stack) {
+  for (const IValue& v : finishRun()) {
     if (v.isTuple()) {
       auto t = v.toTuple();
       for (const auto& el : t->elements()) {
@@ -123,5 +428,451 @@ std::vector<at::Tensor> StaticRuntime::run(
   }
   return out;
 }
+
+c10::IValue StaticRuntime::run(
+    const std::vector<c10::IValue>& args,
+    const std::unordered_map<std::string, c10::IValue>& kwargs) {
+  setInputs(static_module_->normalizeInputs(args, kwargs));
+  runNodes();
+
+  std::vector<IValue> outputs = finishRun();
+  if (outputs.size() == 1) {
+    return std::move(outputs[0]);
+  }
+  return c10::ivalue::Tuple::create(std::move(outputs));
+}
+
+std::vector<IValue> StaticRuntime::finishRun() {
+  const auto& output_regs = static_module_->output_regs();
+  std::vector<IValue> out;
+  out.reserve(output_regs.size());
+  for (size_t r : output_regs) {
+    out.push_back(reg_[r]);
+  }
+
+  // hand the output buffers over to the caller; the producing nodes allocate
+  // fresh ones on the next run
+  for (size_t r : static_module_->output_alias_regs()) {
+    reg_[r] = IValue();
+  }
+  for (size_t r : static_module_->input_regs()) {
+    reg_[r] = IValue();
+  }
+
+  if (planner_) {
+    planner_->deallocate(reg_);
+  }
+  return out;
+}
+
+void StaticRuntime::benchmark(
+    const std::vector<c10::IValue>& inputs,
+    int warmup_runs,
+    int main_runs) {
+  float time_per_iter = benchmark_model(inputs, warmup_runs, main_runs);
+  std::cout << "Static runtime ms per iter: " << time_per_iter
+            << ". Iters per second: " << 1000.0 / time_per_iter << std::endl;
+
+  IndividualMetrics results =
+      benchmark_individual_ops(inputs, warmup_runs, main_runs);
+  for (size_t i = 0; i < nodes().size(); i++) {
+    const Node* node = nodes()[i].get_node();
+    std::cout << "Node #" << i << ": " << results.time_per_node[i]
+              << " ms/iter, " << std::setprecision(4)
+              << results.time_per_node[i] / results.total_time * 100
+              << "%, ";
+    node->print(std::cout, 0, nullptr, false);
+  }
+
+  std::vector<std::pair<std::string, float>> time_per_node_type_vec{
+      results.time_per_node_type.begin(), results.time_per_node_type.end()};
+  std::sort(
+      time_per_node_type_vec.begin(),
+      time_per_node_type_vec.end(),
+      [](const std::pair<std::string, float>& p1,
+         const std::pair<std::string, float>& p2) {
+        return p1.second > p2.second;
+      });
+
+  std::cout << "Time per node type:" << std::endl;
+  for (const auto& p : time_per_node_type_vec) {
+    const std::string& kind = p.first;
+    const float ms = p.second;
+    std::cout << std::setw(15) << ms << " ms. " << std::setw(10)
+              << results.percent_per_node_type[kind] << "%. " << kind << " ("
+              << results.instances_per_node_type[kind] << " nodes)"
+              << std::endl;
+  }
+  std::cout << std::setw(15) << results.total_time << " ms. in Total"
+            << std::endl;
+  std::cout << "StaticRuntime setup time: " << results.setup_time << " ms"
+            << std::endl;
+  std::cout << "StaticRuntime cleanup time: " << results.cleanup_time << " ms"
+            << std::endl;
+
+  if (planner_) {
+    std::cout << "Total memory managed: " << planner_->planned_bytes()
+              << " bytes planned, " << planner_->requested_bytes()
+              << " bytes requested by " << planner_->num_managed_tensors()
+              << " tensors in " << planner_->num_slots() << " slots"
+              << std::endl;
+  }
+}
+
+float StaticRuntime::benchmark_model(
+    const std::vector<c10::IValue>& inputs,
+    int warmup_runs,
+    int main_runs) {
+  TORCH_CHECK(warmup_runs >= 0 && main_runs >= 1);
+
+  for (int i = 0; i < warmup_runs; i++) {
+    run(inputs, {});
+  }
+  caffe2::Timer timer;
+  for (int i = 0; i < main_runs; i++) {
+    run(inputs, {});
+  }
+  float millis = timer.MilliSeconds();
+  return millis / static_cast<float>(main_runs);
+}
+
+StaticRuntime::IndividualMetrics StaticRuntime::benchmark_individual_ops(
+    const std::vector<c10::IValue>& inputs,
+    int warmup_runs,
+    int main_runs) {
+  TORCH_CHECK(warmup_runs >= 0 && main_runs >= 1);
+
+  IndividualMetrics results;
+  results.time_per_node.resize(nodes().size(), 0);
+
+  for (int i = 0; i < warmup_runs; i++) {
+    run(inputs, {});
+  }
+
+  caffe2::Timer timer;
+  for (int k = 0; k < main_runs; k++) {
+    timer.Start();
+    setInputs(static_module_->normalizeInputs(inputs, {}));
+    results.setup_time += timer.MilliSeconds();
+
+    for (size_t i = 0; i < nodes().size(); i++) {
+      timer.Start();
+      nodes()[i].run(reg_);
+      results.time_per_node[i] += timer.MilliSeconds();
+    }
+
+    timer.Start();
+    finishRun();
+    results.cleanup_time += timer.MilliSeconds();
+  }
+
+  // post processing
+  for (size_t i = 0; i < nodes().size(); i++) {
+    const Node* node = nodes()[i].get_node();
+    std::string kind = std::string(node->kind().toQualString());
+    results.time_per_node[i] /= static_cast<float>(main_runs);
+    results.time_per_node_type[kind] += results.time_per_node[i];
+    ++results.instances_per_node_type[kind];
+    results.total_time += results.time_per_node[i];
+  }
+  results.setup_time /= static_cast<float>(main_runs);
+  results.cleanup_time /= static_cast<float>(main_runs);
+  for (const auto& p : results.time_per_node_type) {
+    const std::string& kind = p.first;
+    results.percent_per_node_type[kind] = p.second / results.total_time * 100;
+  }
+  return results;
+}
+
+void StaticRuntime::runBranches() {
+  const BranchPlan& plan = *branch_plan();
+
+  // State shared with the inter-op workers. Workers may start after the run
+  // is over (e.g. when the pool is busy), so it outlives this call and a late
+  // worker only ever sees that there is nothing left to do.
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<size_t> pending;
+    std::deque<size_t> ready;
+    size_t remaining{0};
+    size_t in_flight{0};
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>();
+  state->pending = plan.num_predecessors;
+  state->remaining = plan.branches.size();
+  for (size_t b = 0; b < plan.branches.size(); ++b) {
+    if (state->pending[b] == 0) {
+      state->ready.push_back(b);
+    }
+  }
+
+  auto work = [this, &plan](const std::shared_ptr<State>& state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (true) {
+      state->cv.wait(lock, [&] {
+        return !state->ready.empty() || state->remaining == 0 || state->error;
+      });
+      if (state->remaining == 0 || state->error) {
+        return;
+      }
+      size_t b = state->ready.front();
+      state->ready.pop_front();
+      state->in_flight++;
+      lock.unlock();
+      try {
+        for (size_t i : plan.branches[b]) {
+          nodes()[i].run(reg_);
+        }
+        lock.lock();
+      } catch (...) {
+        lock.lock();
+        if (!state->error) {
+          state->error = std::current_exception();
+        }
+      }
+      state->in_flight--;
+      if (!state->error) {
+        state->remaining--;
+        for (size_t succ : plan.successors[b]) {
+          if (--state->pending[succ] == 0) {
+            state->ready.push_back(succ);
+          }
+        }
+      }
+      state->cv.notify_all();
+    }
+  };
+
+  size_t num_workers = numParallelWorkers();
+  for (size_t w = 1; w < num_workers; ++w) {
+    at::launch([work, state]() { work(state); });
+  }
+  work(state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  // on error, wait for branches still running on other threads, they write
+  // into the value table
+  state->cv.wait(lock, [&] { return state->in_flight == 0; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+StaticRuntimePool::StaticRuntimePool(
+    std::shared_ptr<const StaticModule> static_module,
+    size_t num_instances)
+    : static_module_(std::move(static_module)),
+      in_use_(new std::atomic<bool>[num_instances]) {
+  TORCH_CHECK(num_instances > 0, "StaticRuntimePool needs an instance");
+  runtimes_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; ++i) {
+    runtimes_.push_back(std::make_unique<StaticRuntime>(static_module_));
+    in_use_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+StaticRuntimePool::Handle StaticRuntimePool::acquire() {
+  const size_t n = runtimes_.size();
+  const size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+  for (size_t k = 0; k < n; ++k) {
+    size_t i = (start + k) % n;
+    bool expected = false;
+    // test before the exchange so that busy instances are skipped without
+    // taking their cache line exclusively
+    if (!in_use_[i].load(std::memory_order_relaxed) &&
+        in_use_[i].compare_exchange_strong(
+            expected, true, std::memory_order_acquire)) {
+      return Handle(this, i, runtimes_[i].get());
+    }
+  }
+  num_overflows_.fetch_add(1, std::memory_order_relaxed);
+  return Handle(std::make_unique<StaticRuntime>(static_module_));
+}
+
+void StaticRuntimePool::release(size_t index) {
+  in_use_[index].store(false, std::memory_order_release);
+}
+
+std::vector<at::Tensor> StaticRuntimePool::run(
+    const std::vector<at::Tensor>& inps) {
+  return acquire()->run(inps);
+}
+
+c10::IValue StaticRuntimePool::run(
+    const std::vector<c10::IValue>& args,
+    const std::unordered_map<std::string, c10::IValue>& kwargs) {
+  return acquire()->run(args, kwargs);
+}
+
+StaticRuntimePool::Handle::Handle(
+    StaticRuntimePool* pool,
+    size_t index,
+    StaticRuntime* runtime)
+    : pool_(pool), index_(index), runtime_(runtime) {}
+
+StaticRuntimePool::Handle::Handle(std::unique_ptr<StaticRuntime> overflow)
+    : runtime_(overflow.get()), overflow_(std::move(overflow)) {}
+
+StaticRuntimePool::Handle::Handle(Handle&& other) noexcept
+    : pool_(other.pool_),
+      index_(other.index_),
+      runtime_(other.runtime_),
+      overflow_(std::move(other.overflow_)) {
+  other.pool_ = nullptr;
+  other.runtime_ = nullptr;
+}
+
+StaticRuntimePool::Handle::~Handle() {
+  if (pool_) {
+    pool_->release(index_);
+  }
+}
+
+namespace {
+
+constexpr size_t kArenaAlignment = 64;
+
+size_t alignArenaSize(size_t nbytes) {
+  return (nbytes + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+} // namespace
+
+MemoryPlanner::MemoryPlanner(std::vector<std::vector<size_t>> slots) {
+  slots_.reserve(slots.size());
+  for (auto& regs : slots) {
+    num_managed_tensors_ += regs.size();
+    slots_.push_back(Slot{std::move(regs), 0});
+  }
+}
+
+void MemoryPlanner::allocate(std::vector<IValue>& reg) {
+  if (planned_bytes_ == 0) {
+    // nothing learned yet; the first run allocates on its own
+    return;
+  }
+  if (arena_bytes_ < planned_bytes_) {
+    arena_ = c10::GetCPUAllocator()->allocate(planned_bytes_);
+    arena_bytes_ = planned_bytes_;
+    ++num_arena_allocations_;
+  }
+
+  uint8_t* start = static_cast<uint8_t*>(arena_.get());
+  size_t offset = 0;
+  for (const auto& slot : slots_) {
+    void* ptr = start + offset;
+    for (size_t r : slot.regs) {
+      if (!reg[r].isTensor()) {
+        continue;
+      }
+      auto* impl = reg[r].toTensor().storage().unsafeGetStorageImpl();
+      impl->set_data_ptr(at::DataPtr(ptr, ptr, nullptr, arena_.device()));
+      impl->set_nbytes(slot.nbytes);
+    }
+    offset += slot.nbytes;
+  }
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(offset == planned_bytes_);
+}
+
+void MemoryPlanner::deallocate(std::vector<IValue>& reg) {
+  planned_bytes_ = 0;
+  requested_bytes_ = 0;
+  for (auto& slot : slots_) {
+    for (size_t r : slot.regs) {
+      if (!reg[r].isTensor()) {
+        continue;
+      }
+      const auto& t = reg[r].toTensor();
+      size_t nbytes = (t.storage_offset() + t.numel()) * t.element_size();
+      requested_bytes_ += nbytes;
+      // slots never shrink, so that alternating shapes do not reallocate
+      slot.nbytes = std::max(slot.nbytes, alignArenaSize(nbytes));
+    }
+    planned_bytes_ += slot.nbytes;
+  }
+}
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<size_t> input_regs,
+    std::vector<size_t> output_regs,
+    bool enable_out_variant)
+    : node_(node),
+      input_regs_(std::move(input_regs)),
+      output_regs_(std::move(output_regs)) {
+  fn_ = getNativeOperation(node, &has_out_variant_);
+  if (has_out_variant_ && !enable_out_variant) {
+    fn_ = nullptr;
+    has_out_variant_ = false;
+  }
+  // these are emitted directly by the interpreter or by FuseStaticRuntimeOps
+  // and have no Operator
+  if (!fn_ && node->kind() != prim::ListConstruct &&
+      node->kind() != prim::TupleConstruct &&
+      node->kind() != prim::ListUnpack &&
+      node->kind() != prim::DictConstruct &&
+      node->kind() != prim::FusedConcat) {
+    op_ = node->getOperation();
+  }
+}
+
+void ProcessedNode::run(std::vector<IValue>& reg) const {
+  if (fn_) {
+    fn_(this, reg);
+    return;
+  }
+
+  std::vector<IValue> stack;
+  const size_t size = node_->inputs().size();
+  stack.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    stack.emplace_back(Input(i, reg));
+  }
+
+  if (op_) {
+    (*op_)(&stack);
+  } else if (node_->kind() == prim::ListConstruct) {
+    listConstruct(
+        stack,
+        node_->output()->type()->expect<ListType>(),
+        node_->inputs().size());
+  } else if (node_->kind() == prim::TupleConstruct) {
+    bool named =
+        node_->output()->type()->expect<TupleType>()->name().has_value();
+    if (named) {
+      namedTupleConstruct(
+          stack,
+          node_->output()->type()->expect<TupleType>(),
+          node_->inputs().size());
+    } else {
+      tupleConstruct(stack, node_->inputs().size());
+    }
+  } else if (node_->kind() == prim::ListUnpack) {
+    listUnpack(stack, node_->outputs().size());
+  } else if (node_->kind() == prim::DictConstruct) {
+    dictConstruct(
+        stack,
+        node_->output()->type()->expect<DictType>(),
+        node_->inputs().size());
+  } else if (node_->kind() == prim::FusedConcat) {
+    std::vector<at::Tensor> tensors;
+    tensors.reserve(stack.size());
+    for (const IValue& v : stack) {
+      tensors.push_back(v.toTensor());
+    }
+    stack.clear();
+    stack.emplace_back(at::cat(tensors, node_->i(attr::dim)));
+  } else {
+    TORCH_CHECK(false, "Unsupported node kind: ", node_->kind().toQualString());
+  }
+
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(stack.size() == node_->outputs().size());
+  for (size_t i = 0; i < node_->outputs().size(); i++) {
+    Output(i, reg) = std::move(stack[i]);
+  }
+}
+
 } // namespace jit
 } // namespace torch
@@ -3,29 +3,421 @@
 #include <ATen/core/interned_strings.h>
 #include <ATen/core/ivalue.h>
 #include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
 #include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <atomic>
 
 namespace torch {
 namespace jit {
 
-class TORCH_API StaticRuntime {
+// A node of the flattened graph bound to the kernel that executes it.
+// Inputs and outputs are indices into the runtime's value table, so running
+// a node never touches an interpreter stack unless the node has no native
+// kernel and falls back to its boxed Operation.
+class ProcessedNode {
+ public:
+  ProcessedNode(
+      Node* n,
+      std::vector<size_t> input_regs,
+      std::vector<size_t> output_regs,
+      bool enable_out_variant = true);
+
+  void run(std::vector<IValue>& reg) const;
+
+  Node* get_node() const {
+    return node_;
+  }
+
+  const IValue& Input(size_t i, std::vector<IValue>& reg) const {
+    return reg[input_regs_[i]];
+  }
+
+  IValue& Output(size_t i, std::vector<IValue>& reg) const {
+    return reg[output_regs_[i]];
+  }
+
+  size_t num_inputs() const {
+    return input_regs_.size();
+  }
+
+  size_t num_outputs() const {
+    return output_regs_.size();
+  }
+
+  const std::vector<size_t>& input_regs() const {
+    return input_regs_;
+  }
+
+  const std::vector<size_t>& output_regs() const {
+    return output_regs_;
+  }
+
+  bool has_native_kernel() const {
+    return static_cast<bool>(fn_);
+  }
+
+  bool has_out_variant() const {
+    return has_out_variant_;
+  }
+
+ private:
+  Node* node_;
+  SROperator fn_;
+  bool has_out_variant_{false};
+  c10::optional<Operation> op_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+};
+
+// Places the tensors produced by out-variant kernels in a single arena.
+// Values whose lifetimes, extended over all of their aliases, do not overlap
+// share a slot of the arena. Slot sizes are learned from the tensors at the
+// end of each run, so the arena is sized by the first run and only grows
+// when a later run needs more memory; runs with the same shapes do not
+// allocate tensor memory at all.
+class TORCH_API MemoryPlanner {
  public:
-  explicit StaticRuntime(std::shared_ptr<torch::jit::Graph> g)
-      : graph_(std::move(g)) {}
+  // `slots` holds, for each slot, the registers of the values placed in it.
+  explicit MemoryPlanner(std::vector<std::vector<size_t>> slots);
+
+  // Points the storages of all managed tensors into the arena, (re)allocating
+  // the arena if the planned size grew. Called before running the nodes.
+  void allocate(std::vector<IValue>& reg);
+  // Records the sizes of the managed tensors produced by the run that just
+  // finished and updates the plan for the next run.
+  void deallocate(std::vector<IValue>& reg);
+
+  // Size of the arena required by the current plan.
+  size_t planned_bytes() const {
+    return planned_bytes_;
+  }
+  // Sum of the sizes of all managed tensors in the last run, i.e. what would
+  // have been allocated without sharing.
+  size_t requested_bytes() const {
+    return requested_bytes_;
+  }
+  size_t num_managed_tensors() const {
+    return num_managed_tensors_;
+  }
+  size_t num_slots() const {
+    return slots_.size();
+  }
+  // Number of times the arena has been (re)allocated.
+  size_t num_arena_allocations() const {
+    return num_arena_allocations_;
+  }
+
+ private:
+  struct Slot {
+    std::vector<size_t> regs;
+    size_t nbytes{0};
+  };
+  std::vector<Slot> slots_;
+  at::DataPtr arena_;
+  size_t arena_bytes_{0};
+  size_t planned_bytes_{0};
+  size_t requested_bytes_{0};
+  size_t num_managed_tensors_{0};
+  size_t num_arena_allocations_{0};
+};
+
+// Partition of the nodes into branches, i.e. chains of nodes that each
+// depend on the previous one, along with the dependencies between branches.
+// A branch only ever waits on other branches before its first node, so
+// independent branches can run concurrently.
+struct BranchPlan {
+  // node indices of each branch, in execution order
+  std::vector<std::vector<size_t>> branches;
+  std::vector<std::vector<size_t>> successors;
+  std::vector<size_t> num_predecessors;
+  // branch containing each node
+  std::vector<size_t> branch_of;
+  // ancestors[b][a] is true if branch a must finish before branch b starts
+  std::vector<std::vector<bool>> ancestors;
+};
+
+struct TORCH_API StaticRuntimeOptions {
+  // Run ops with an out variant through kernels that write into the output
+  // tensor left over from the previous run.
+  bool enable_out_variant{true};
+  // Place out-variant outputs in a shared arena (requires enable_out_variant).
+  bool optimize_memory{true};
+  // Maximum number of independent branches of the graph run concurrently on
+  // the inter-op thread pool; 1 runs the graph sequentially. The effective
+  // number is further capped by the inter-op pool size and by the intra-op
+  // thread budget (see StaticRuntime::numParallelWorkers).
+  size_t max_parallel_branches{1};
+};
+
+// The immutable part of a static runtime: the optimized graph, its nodes
+// bound to kernels, the register layout, the branch partition and the memory
+// plan layout. A StaticModule can be shared by any number of StaticRuntimes,
+// each of which only holds the mutable per-run state.
+class TORCH_API StaticModule {
+ public:
+  explicit StaticModule(
+      std::shared_ptr<torch::jit::Graph> g,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions());
+
+  explicit StaticModule(
+      const torch::jit::Module& m,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions());
+
+  const StaticRuntimeOptions& options() const {
+    return opts_;
+  }
+
+  const std::shared_ptr<torch::jit::Graph>& graph() const {
+    return graph_;
+  }
+
+  const std::vector<ProcessedNode>& nodes() const {
+    return nodes_;
+  }
+
+  // Value table a runtime starts from: constants and the frozen module's
+  // self are filled in, every other register is None.
+  const std::vector<IValue>& initial_values() const {
+    return initial_values_;
+  }
+
+  const std::vector<size_t>& input_regs() const {
+    return input_regs_;
+  }
+
+  const std::vector<size_t>& output_regs() const {
+    return output_regs_;
+  }
+
+  const std::vector<size_t>& output_alias_regs() const {
+    return output_alias_regs_;
+  }
+
+  // nullptr if the graph is run sequentially
+  const BranchPlan* branch_plan() const {
+    return branch_plan_.get();
+  }
+
+  // The registers placed in each arena slot, empty if memory planning is
+  // disabled.
+  const std::vector<std::vector<size_t>>& memory_slots() const {
+    return memory_slots_;
+  }
+
+  bool plans_memory() const {
+    return plans_memory_;
+  }
 
-  explicit StaticRuntime(const torch::jit::Module& m);
+  // Number of threads, including the calling one, that a run would use to
+  // execute independent branches.
+  size_t numParallelWorkers() const;
 
-  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inps) const;
+  // Fills in keyword arguments and defaults of forward.
+  std::vector<IValue> normalizeInputs(
+      std::vector<IValue> args,
+      const std::unordered_map<std::string, IValue>& kwargs) const;
 
  private:
+  void init();
+  void initBranchPlan(AliasDb& alias_db);
+  void initMemoryPlanner(AliasDb& alias_db);
+  // whether node `a` is guaranteed to finish before node `b` starts
+  bool happensBefore(size_t a, size_t b) const;
+
   torch::jit::Module module_;
   std::shared_ptr<torch::jit::Graph> graph_;
+  // schema of forward, only set for modules created from a Module
+  c10::optional<c10::FunctionSchema> schema_;
+  StaticRuntimeOptions opts_;
+  std::unique_ptr<BranchPlan> branch_plan_;
+  std::vector<std::vector<size_t>> memory_slots_;
+  bool plans_memory_{false};
+
+  // Value table layout, indexed by the registers assigned to each graph
+  // Value. Constants are materialized once at construction.
+  std::vector<IValue> initial_values_;
+  std::vector<ProcessedNode> nodes_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // Registers produced by nodes whose values may alias a graph output. They
+  // are handed to the caller and cleared after each run so that the next run
+  // does not write into tensors the caller still holds.
+  std::vector<size_t> output_alias_regs_;
+};
+
+// The per-run state of a StaticModule: the value table and the memory arena.
+// A StaticRuntime must not be run from several threads at once; use one
+// runtime per thread over a shared StaticModule, e.g. via StaticRuntimePool.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(
+      std::shared_ptr<torch::jit::Graph> g,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions());
+
+  explicit StaticRuntime(
+      const torch::jit::Module& m,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions());
+
+  explicit StaticRuntime(std::shared_ptr<const StaticModule> static_module);
+
+  // Runs the graph on tensor inputs and returns its outputs, with tuple
+  // outputs flattened into their elements.
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inps);
+
+  // Runs the graph on arbitrary inputs, e.g. tuples, lists or dicts of
+  // tensors, and returns its output as is (a tuple if the graph has several
+  // outputs). Keyword arguments and defaults are resolved against the
+  // schema of forward and are only supported for runtimes created from a
+  // Module. Tensors are passed in and out by reference, without copies.
+  c10::IValue run(
+      const std::vector<c10::IValue>& args,
+      const std::unordered_map<std::string, c10::IValue>& kwargs);
+
+  // Runs the graph `warmup_runs + main_runs` times and prints the per-node
+  // and per-op-kind breakdown of benchmark_individual_ops along with the
+  // memory planner statistics.
+  void benchmark(
+      const std::vector<c10::IValue>& inputs,
+      int warmup_runs,
+      int main_runs);
+
+  // Mean time of a whole run in milliseconds.
+  float benchmark_model(
+      const std::vector<c10::IValue>& inputs,
+      int warmup_runs,
+      int main_runs);
+
+  // Times in milliseconds, averaged over the main runs.
+  struct IndividualMetrics {
+    // setting the inputs and placing managed tensors in the arena
+    float setup_time{0.0};
+    // releasing the outputs and updating the memory plan
+    float cleanup_time{0.0};
+    float total_time{0.0};
+    std::vector<float> time_per_node;
+    std::unordered_map<std::string, float> time_per_node_type;
+    std::unordered_map<std::string, float> percent_per_node_type;
+    std::unordered_map<std::string, int> instances_per_node_type;
+  };
+
+  // Runs the nodes one at a time (ignoring max_parallel_branches) and times
+  // each of them. Timing uses a steady clock only, no RecordFunction.
+  IndividualMetrics benchmark_individual_ops(
+      const std::vector<c10::IValue>& inputs,
+      int warmup_runs,
+      int main_runs);
+
+  const StaticModule& static_module() const {
+    return *static_module_;
+  }
+
+  const std::vector<ProcessedNode>& nodes() const {
+    return static_module_->nodes();
+  }
+
+  // nullptr if memory planning is disabled
+  const MemoryPlanner* memory_planner() const {
+    return planner_.get();
+  }
+
+  // nullptr if the graph is run sequentially
+  const BranchPlan* branch_plan() const {
+    return static_module_->branch_plan();
+  }
+
+  size_t numParallelWorkers() const {
+    return static_module_->numParallelWorkers();
+  }
+
+ private:
+  void setInputs(std::vector<IValue>&& inps);
+  void runNodes();
+  // collects the outputs and releases the values that must not be reused
+  std::vector<IValue> finishRun();
+  void runBranches();
+
+  std::shared_ptr<const StaticModule> static_module_;
+  std::unique_ptr<MemoryPlanner> planner_;
+  // Value table, starting from StaticModule::initial_values(). Every slot
+  // that is not a constant is owned by the node that produces it and keeps
+  // its tensor across runs.
+  std::vector<IValue> reg_;
+};
+
+// A fixed set of StaticRuntimes over one StaticModule, for serving requests
+// from many threads at once. The graph, the weights and the memory plan
+// layout are shared; each instance only owns its value table and arena.
+// Checking out an instance is lock-free. When every instance is busy, the
+// request gets a temporary runtime instead of waiting, see num_overflows.
+class TORCH_API StaticRuntimePool {
+ public:
+  StaticRuntimePool(
+      std::shared_ptr<const StaticModule> static_module,
+      size_t num_instances);
+
+  // Exclusive use of one runtime, given back to the pool on destruction.
+  class TORCH_API Handle {
+   public:
+    Handle(Handle&& other) noexcept;
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+    Handle& operator=(Handle&&) = delete;
+    ~Handle();
+
+    StaticRuntime& operator*() const {
+      return *runtime_;
+    }
+
+    StaticRuntime* operator->() const {
+      return runtime_;
+    }
+
+   private:
+    friend class StaticRuntimePool;
+    Handle(StaticRuntimePool* pool, size_t index, StaticRuntime* runtime);
+    explicit Handle(std::unique_ptr<StaticRuntime> overflow);
+
+    StaticRuntimePool* pool_{nullptr};
+    size_t index_{0};
+    StaticRuntime* runtime_{nullptr};
+    std::unique_ptr<StaticRuntime> overflow_;
+  };
+
+  Handle acquire();
+
+  // Runs the graph on whichever instance is free, see StaticRuntime::run.
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inps);
+
+  c10::IValue run(
+      const std::vector<c10::IValue>& args,
+      const std::unordered_map<std::string, c10::IValue>& kwargs);
+
+  const StaticModule& static_module() const {
+    return *static_module_;
+  }
+
+  size_t num_instances() const {
+    return runtimes_.size();
+  }
+
+  // Number of requests that found every instance busy.
+  size_t num_overflows() const {
+    return num_overflows_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void release(size_t index);
 
-  // Jit interpreter state
-  std::unique_ptr<torch::jit::Code> code_;
-  std::unique_ptr<torch::jit::InterpreterState> interp_;
+  std::shared_ptr<const StaticModule> static_module_;
+  std::vector<std::unique_ptr<StaticRuntime>> runtimes_;
+  std::unique_ptr<std::atomic<bool>[]> in_use_;
+  // where the next checkout starts looking, spreads threads over instances
+  std::atomic<size_t> next_{0};
+  std::atomic<size_t> num_overflows_{0};
 };
 
 } // namespace jit
@@ -4,17 +4,134 @@
 namespace torch {
 namespace jit {
 
+namespace {
+
+std::vector<IValue> toIValueArgs(const py::args& args) {
+  std::vector<IValue> arg_ivalues;
+  arg_ivalues.reserve(args.size());
+  for (const auto& arg : args) {
+    arg_ivalues.push_back(toTypeInferredIValue(arg));
+  }
+  return arg_ivalues;
+}
+
+std::unordered_map<std::string, IValue> toIValueKwargs(
+    const py::kwargs& kwargs) {
+  std::unordered_map<std::string, IValue> kwarg_ivalues;
+  for (const auto& kv : kwargs) {
+    kwarg_ivalues.emplace(
+        py::cast<std::string>(kv.first), toTypeInferredIValue(kv.second));
+  }
+  return kwarg_ivalues;
+}
+
+} // namespace
+
 void initStaticRuntimeBindings(PyObject* module) {
   auto m = py::handle(module).cast<py::module>();
-  py::class_<StaticRuntime>(m, "StaticRuntime").def("run", &StaticRuntime::run);
+  py::class_<StaticRuntime::IndividualMetrics>(
+      m, "StaticRuntimeIndividualMetrics")
+      .def_readonly("setup_time", &StaticRuntime::IndividualMetrics::setup_time)
+      .def_readonly(
+          "cleanup_time", &StaticRuntime::IndividualMetrics::cleanup_time)
+      .def_readonly("total_time", &StaticRuntime::IndividualMetrics::total_time)
+      .def_readonly(
+          "time_per_node", &StaticRuntime::IndividualMetrics::time_per_node)
+      .def_readonly(
+          "time_per_node_type",
+          &StaticRuntime::IndividualMetrics::time_per_node_type)
+      .def_readonly(
+          "percent_per_node_type",
+          &StaticRuntime::IndividualMetrics::percent_per_node_type)
+      .def_readonly(
+          "instances_per_node_type",
+          &StaticRuntime::IndividualMetrics::instances_per_node_type);
+  py::class_<StaticRuntime>(m, "StaticRuntime")
+      .def(
+          "run",
+          py::overload_cast<const std::vector<at::Tensor>&>(
+              &StaticRuntime::run))
+      .def(
+          "__call__",
+          [](StaticRuntime& self, py::args args, py::kwargs kwargs) {
+            return toPyObject(
+                self.run(toIValueArgs(args), toIValueKwargs(kwargs)));
+          })
+      .def(
+          "benchmark",
+          &StaticRuntime::benchmark,
+          py::arg("inputs"),
+          py::arg("warmup_runs"),
+          py::arg("main_runs"))
+      .def(
+          "benchmark_individual_ops",
+          &StaticRuntime::benchmark_individual_ops,
+          py::arg("inputs"),
+          py::arg("warmup_runs"),
+          py::arg("main_runs"))
+      .def(
+          "memory_stats",
+          [](const StaticRuntime& self) {
+            py::dict stats;
+            if (const MemoryPlanner* planner = self.memory_planner()) {
+              stats["planned_bytes"] = planner->planned_bytes();
+              stats["requested_bytes"] = planner->requested_bytes();
+              stats["managed_tensors"] = planner->num_managed_tensors();
+              stats["slots"] = planner->num_slots();
+              stats["arena_allocations"] = planner->num_arena_allocations();
+            }
+            return stats;
+          });
+  py::class_<StaticRuntimePool>(m, "StaticRuntimePool")
+      .def(
+          "__call__",
+          [](StaticRuntimePool& self, py::args args, py::kwargs kwargs) {
+            auto arg_ivalues = toIValueArgs(args);
+            auto kwarg_ivalues = toIValueKwargs(kwargs);
+            IValue out;
+            {
+              // let other Python threads run requests on other instances
+              pybind11::gil_scoped_release no_gil;
+              out = self.run(arg_ivalues, kwarg_ivalues);
+            }
+            return toPyObject(std::move(out));
+          })
+      .def_property_readonly(
+          "num_instances", &StaticRuntimePool::num_instances)
+      .def_property_readonly(
+          "num_overflows", &StaticRuntimePool::num_overflows);
+  py::class_<StaticRuntimeOptions>(m, "StaticRuntimeOptions")
+      .def(py::init<>())
+      .def_readwrite(
+          "enable_out_variant", &StaticRuntimeOptions::enable_out_variant)
+      .def_readwrite("optimize_memory", &StaticRuntimeOptions::optimize_memory)
+      .def_readwrite(
+          "max_parallel_branches",
+          &StaticRuntimeOptions::max_parallel_branches);
   m.def(
        "_jit_to_static_runtime",
-       [](const std::shared_ptr<torch::jit::Graph>& g) {
-         return StaticRuntime(g);
-       })
-      .def("_jit_to_static_runtime", [](const torch::jit::Module& m) {
-        return StaticRuntime(m);
-      });
+       [](const std::shared_ptr<torch::jit::Graph>& g,
+          const StaticRuntimeOptions& opts) { return StaticRuntime(g, opts); },
+       py::arg("graph"),
+       py::arg("options") = StaticRuntimeOptions())
+      .def(
+          "_jit_to_static_runtime",
+          [](const torch::jit::Module& m, const StaticRuntimeOptions& opts) {
+            return StaticRuntime(m, opts);
+          },
+          py::arg("module"),
+          py::arg("options") = StaticRuntimeOptions())
+      .def(
+          "_jit_to_static_runtime_pool",
+          [](const torch::jit::Module& m,
+             size_t num_instances,
+             const StaticRuntimeOptions& opts) {
+            return std::make_unique<StaticRuntimePool>(
+                std::make_shared<StaticModule>(m, opts), num_instances);
+          },
+          py::arg("module"),
+          py::arg("num_instances"),
+          py::arg("options") = StaticRuntimeOptions());
 }
 
 } // namespace jit
@@ -0,0 +1,411 @@
+#include <torch/csrc/jit/runtime/static/ops.h>
+#include <ATen/NativeFunctions.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+C10_DEFINE_REGISTRY(SROperatorRegistry, SROperatorFunctor);
+
+bool canRunNatively(Node* n) {
+  return static_cast<bool>(getNativeOperation(n));
+}
+
+SROperator getNativeOperation(Node* n, bool* has_out_variant) {
+  if (has_out_variant) {
+    *has_out_variant = false;
+  }
+  auto op_name = n->kind().toQualString();
+  if (!SROperatorRegistry()->Has(op_name)) {
+    return SROperator();
+  }
+  auto functor = SROperatorRegistry()->Create(op_name);
+  auto fn = functor->Generate(n);
+  if (fn && has_out_variant) {
+    *has_out_variant = functor->HasOutVariant();
+  }
+  return fn;
+}
+
+namespace {
+
+// Shrinks `t` to zero elements without touching its storage, so that an out
+// kernel can resize it to the new shape and reuse the previous allocation
+// without emitting the resize-of-nonempty-output warning.
+inline void fastResizeToZero(at::Tensor& t) {
+  t.unsafeGetTensorImpl()->set_sizes_contiguous({0});
+}
+
+// Returns the output tensor of `p_node` at `i`, creating an empty tensor
+// with the options of `like` and the given dtype, that of `like` by default,
+// on the first run and whenever the dtype changes between runs.
+inline at::Tensor prepareOutput(
+    const ProcessedNode* p_node,
+    std::vector<IValue>& reg,
+    const at::Tensor& like,
+    c10::optional<at::ScalarType> dtype = c10::nullopt,
+    size_t i = 0) {
+  auto out_dtype = dtype.value_or(like.scalar_type());
+  IValue& out = p_node->Output(i, reg);
+  if (out.isNone() || out.toTensor().scalar_type() != out_dtype) {
+    out = at::empty({0}, like.options().dtype(out_dtype));
+    return out.toTensor();
+  }
+  auto out_t = out.toTensor();
+  fastResizeToZero(out_t);
+  return out_t;
+}
+
+inline c10::optional<at::Scalar> toOptionalScalar(const IValue& v) {
+  if (v.isNone()) {
+    return c10::nullopt;
+  }
+  return v.toScalar();
+}
+
+} // namespace
+
+// Out-variant kernels
+
+REGISTER_OPERATOR_FUNCTOR(aten::add, aten_add, [](Node* n) -> SROperator {
+  if (!n->matches(
+          "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_t = p_node->Input(1, reg).toTensor();
+    auto in2_s = p_node->Input(2, reg).toScalar();
+    auto out_t =
+        prepareOutput(p_node, reg, in0_t, at::result_type(in0_t, in1_t));
+    at::native::add_out(out_t, in0_t, in1_t, in2_s);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::mul, aten_mul, [](Node* n) -> SROperator {
+  if (!n->matches("aten::mul.Tensor(Tensor self, Tensor other) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_t = p_node->Input(1, reg).toTensor();
+    auto out_t =
+        prepareOutput(p_node, reg, in0_t, at::result_type(in0_t, in1_t));
+    at::native::mul_out(out_t, in0_t, in1_t);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::div, aten_div, [](Node* n) -> SROperator {
+  if (!n->matches("aten::div.Tensor(Tensor self, Tensor other) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_t = p_node->Input(1, reg).toTensor();
+    auto out_t =
+        prepareOutput(p_node, reg, in0_t, at::result_type(in0_t, in1_t));
+    at::native::div_out(out_t, in0_t, in1_t);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::addmm, aten_addmm, [](Node* n) -> SROperator {
+  if (!n->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_t = p_node->Input(1, reg).toTensor();
+    auto in2_t = p_node->Input(2, reg).toTensor();
+    auto in3_s = p_node->Input(3, reg).toScalar();
+    auto in4_s = p_node->Input(4, reg).toScalar();
+    auto out_t = prepareOutput(p_node, reg, in0_t);
+    at::native::addmm_cpu_out(out_t, in0_t, in1_t, in2_t, in3_s, in4_s);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::bmm, aten_bmm, [](Node* n) -> SROperator {
+  if (!n->matches("aten::bmm(Tensor self, Tensor mat2) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_t = p_node->Input(1, reg).toTensor();
+    auto out_t = prepareOutput(p_node, reg, in0_t);
+    at::native::bmm_out_cpu(out_t, in0_t, in1_t);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::cat, aten_cat, [](Node* n) -> SROperator {
+  if (!n->matches("aten::cat(Tensor[] tensors, int dim=0) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_tl = p_node->Input(0, reg).toTensorVector();
+    auto in1_i = p_node->Input(1, reg).toInt();
+    TORCH_CHECK(!in0_tl.empty(), "cat expects a non-empty TensorList");
+    auto out_t = prepareOutput(p_node, reg, in0_tl[0]);
+    at::native::_cat_out_cpu(out_t, in0_tl, in1_i);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::clamp, aten_clamp, [](Node* n) -> SROperator {
+  if (!n->matches(
+          "aten::clamp(Tensor self, Scalar? min=None, Scalar? max=None) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_s = toOptionalScalar(p_node->Input(1, reg));
+    auto in2_s = toOptionalScalar(p_node->Input(2, reg));
+    auto out_t = prepareOutput(p_node, reg, in0_t);
+    at::native::clamp_out(out_t, in0_t, in1_s, in2_s);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(
+    aten::sigmoid,
+    aten_sigmoid,
+    [](Node* n) -> SROperator {
+      if (!n->matches("aten::sigmoid(Tensor self) -> Tensor")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto out_t = prepareOutput(p_node, reg, in0_t);
+        at::native::sigmoid_out(out_t, in0_t);
+      };
+    });
+
+REGISTER_OPERATOR_FUNCTOR(aten::relu, aten_relu, [](Node* n) -> SROperator {
+  if (!n->matches("aten::relu(Tensor self) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto out_t = prepareOutput(p_node, reg, in0_t);
+    at::native::threshold_out(out_t, in0_t, 0, 0);
+  };
+});
+
+REGISTER_OPERATOR_FUNCTOR(aten::matmul, aten_matmul, [](Node* n) -> SROperator {
+  if (!n->matches("aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    auto in1_t = p_node->Input(1, reg).toTensor();
+    auto out_t = prepareOutput(p_node, reg, in0_t);
+    at::native::matmul_out(out_t, in0_t, in1_t);
+  };
+});
+
+// Kernels of the ops introduced by FuseStaticRuntimeOps (see passes.h)
+
+REGISTER_OPERATOR_FUNCTOR(
+    prim::FusedConcat,
+    prim_FusedConcat,
+    [](Node* n) -> SROperator {
+      for (const Value* v : n->inputs()) {
+        if (!v->type()->isSubtypeOf(TensorType::get())) {
+          return nullptr;
+        }
+      }
+      const int64_t dim = n->i(attr::dim);
+      return [dim](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        std::vector<at::Tensor> in_tl;
+        in_tl.reserve(p_node->num_inputs());
+        for (size_t i = 0; i < p_node->num_inputs(); ++i) {
+          in_tl.push_back(p_node->Input(i, reg).toTensor());
+        }
+        auto out_t = prepareOutput(p_node, reg, in_tl[0]);
+        at::native::_cat_out_cpu(out_t, in_tl, dim);
+      };
+    });
+
+REGISTER_OPERATOR_FUNCTOR(
+    static_runtime::sigmoid_mul,
+    static_runtime_sigmoid_mul,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "static_runtime::sigmoid_mul(Tensor self, Tensor other) -> Tensor")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_t = p_node->Input(1, reg).toTensor();
+        if (in0_t.scalar_type() != in1_t.scalar_type()) {
+          // leave type promotion to mul
+          p_node->Output(0, reg) = at::mul(at::sigmoid(in0_t), in1_t);
+          return;
+        }
+        auto out_t = prepareOutput(p_node, reg, in0_t);
+        auto out_sizes = at::infer_size(in0_t.sizes(), in1_t.sizes());
+        if (in0_t.sizes().equals(out_sizes)) {
+          // the product has the shape of sigmoid(self), compute it in place
+          at::native::sigmoid_out(out_t, in0_t);
+          at::native::mul_out(out_t, out_t, in1_t);
+        } else {
+          at::native::mul_out(out_t, at::sigmoid(in0_t), in1_t);
+        }
+      };
+    });
+
+REGISTER_OPERATOR_FUNCTOR(
+    static_runtime::addmm_relu,
+    static_runtime_addmm_relu,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "static_runtime::addmm_relu(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_t = p_node->Input(1, reg).toTensor();
+        auto in2_t = p_node->Input(2, reg).toTensor();
+        auto in3_s = p_node->Input(3, reg).toScalar();
+        auto in4_s = p_node->Input(4, reg).toScalar();
+        auto out_t = prepareOutput(p_node, reg, in0_t);
+        at::native::addmm_cpu_out(out_t, in0_t, in1_t, in2_t, in3_s, in4_s);
+        at::native::threshold_out(out_t, out_t, 0, 0);
+      };
+    });
+
+// Kernels without an out variant. These still skip the interpreter stack and
+// the boxed calling convention by calling the ATen function directly.
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::softmax,
+    aten_softmax,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_i = p_node->Input(1, reg).toInt();
+        const auto& in2 = p_node->Input(2, reg);
+        p_node->Output(0, reg) = in2.isNone()
+            ? at::softmax(in0_t, in1_i)
+            : at::softmax(in0_t, in1_i, in2.toScalarType());
+      };
+    });
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::isnan,
+    aten_isnan,
+    [](Node* n) -> SROperator {
+      if (!n->matches("aten::isnan(Tensor self) -> Tensor")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        p_node->Output(0, reg) = at::isnan(in0_t);
+      };
+    });
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::size,
+    aten_size,
+    [](Node* n) -> SROperator {
+      if (!n->matches("aten::size.int(Tensor self, int dim) -> int")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_i = p_node->Input(1, reg).toInt();
+        p_node->Output(0, reg) = in0_t.size(in1_i);
+      };
+    });
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::contiguous,
+    aten_contiguous,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "aten::contiguous(Tensor(a) self, *, MemoryFormat memory_format=contiguous_format) -> Tensor(a)")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_m = p_node->Input(1, reg).toMemoryFormat();
+        p_node->Output(0, reg) = in0_t.contiguous(in1_m);
+      };
+    });
+
+// View kernels
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::flatten,
+    aten_flatten,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "aten::flatten.using_ints(Tensor(a) self, int start_dim=0, int end_dim=-1) -> Tensor(a)")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_i = p_node->Input(1, reg).toInt();
+        auto in2_i = p_node->Input(2, reg).toInt();
+        p_node->Output(0, reg) = at::native::flatten(in0_t, in1_i, in2_i);
+      };
+    });
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::permute,
+    aten_permute,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "aten::permute(Tensor(a) self, int[] dims) -> Tensor(a)")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_iv = p_node->Input(1, reg).toIntVector();
+        p_node->Output(0, reg) = at::native::permute(in0_t, in1_iv);
+      };
+    });
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(aten::t, aten_t, [](Node* n) -> SROperator {
+  if (!n->matches("aten::t(Tensor(a) self) -> Tensor(a)")) {
+    return nullptr;
+  }
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto in0_t = p_node->Input(0, reg).toTensor();
+    p_node->Output(0, reg) = at::native::t(in0_t);
+  };
+});
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::transpose,
+    aten_transpose,
+    [](Node* n) -> SROperator {
+      if (!n->matches(
+              "aten::transpose.int(Tensor(a) self, int dim0, int dim1) -> Tensor(a)")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_i = p_node->Input(1, reg).toInt();
+        auto in2_i = p_node->Input(2, reg).toInt();
+        p_node->Output(0, reg) = at::native::transpose(in0_t, in1_i, in2_i);
+      };
+    });
+
+REGISTER_NATIVE_OPERATOR_FUNCTOR(
+    aten::view,
+    aten_view,
+    [](Node* n) -> SROperator {
+      if (!n->matches("aten::view(Tensor(a) self, int[] size) -> Tensor(a)")) {
+        return nullptr;
+      }
+      return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+        auto in0_t = p_node->Input(0, reg).toTensor();
+        auto in1_iv = p_node->Input(1, reg).toIntVector();
+        p_node->Output(0, reg) = at::native::view(in0_t, in1_iv);
+      };
+    });
+
+} // namespace jit
+} // namespace torch
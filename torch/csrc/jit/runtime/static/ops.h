@@ -0,0 +1,68 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/Registry.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+class ProcessedNode;
+
+// A static runtime kernel reads its inputs from and writes its outputs to the
+// runtime's value table (one IValue per graph Value) through the index maps
+// held by the ProcessedNode. Out-variant kernels reuse the output tensor left
+// in the table by the previous run instead of allocating a new one.
+using SROperator =
+    std::function<void(const ProcessedNode*, std::vector<IValue>&)>;
+using SROpFunctor = SROperator (*)(Node* n);
+
+struct SROperatorFunctor {
+  virtual SROperator Generate(Node*) {
+    return SROperator();
+  }
+  // Whether the generated kernel writes into the output tensor it finds in
+  // the value table. Only such outputs can be placed by the memory planner.
+  virtual bool HasOutVariant() {
+    return false;
+  }
+  virtual ~SROperatorFunctor() = default;
+};
+
+C10_DECLARE_REGISTRY(SROperatorRegistry, SROperatorFunctor);
+
+// Registers a kernel generator for the operator `name`. The generator is
+// invoked once per node when the runtime is constructed and may return an
+// empty SROperator if it does not handle the node's overload, in which case
+// the node falls back to the operator's boxed JIT Operation. `out` states
+// whether the kernel is an out variant (see HasOutVariant).
+#define REGISTER_OPERATOR_FUNCTOR_OPT(name, id, out, ...)    \
+  struct SROperatorFunctor_##id : public SROperatorFunctor { \
+    const SROpFunctor fn = __VA_ARGS__;                      \
+    SROperator Generate(Node* n) override {                  \
+      return fn(n);                                          \
+    }                                                        \
+    bool HasOutVariant() override {                          \
+      return out;                                            \
+    }                                                        \
+  };                                                         \
+  C10_REGISTER_CLASS(SROperatorRegistry, name, SROperatorFunctor_##id);
+
+#define REGISTER_OPERATOR_FUNCTOR(name, id, ...) \
+  REGISTER_OPERATOR_FUNCTOR_OPT(name, id, true, __VA_ARGS__)
+
+#define REGISTER_NATIVE_OPERATOR_FUNCTOR(name, id, ...) \
+  REGISTER_OPERATOR_FUNCTOR_OPT(name, id, false, __VA_ARGS__)
+
+// Returns true if a native static runtime kernel is registered for the
+// node's operator and overload.
+TORCH_API bool canRunNatively(Node* n);
+
+// Returns the native kernel for `n`, or an empty SROperator if there is none.
+// If `has_out_variant` is given it is set to whether the kernel writes into
+// a preexisting output tensor.
+TORCH_API SROperator
+getNativeOperation(Node* n, bool* has_out_variant = nullptr);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,163 @@
+#include <torch/csrc/jit/runtime/static/passes.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/library.h>
+
+namespace torch {
+namespace jit {
+
+// Reference implementations of the fused ops, used when the static runtime
+// falls back to boxed Operations (i.e. with out variants disabled).
+TORCH_LIBRARY(static_runtime, m) {
+  m.def(
+      "sigmoid_mul(Tensor self, Tensor other) -> Tensor",
+      [](const at::Tensor& self, const at::Tensor& other) {
+        return at::mul(at::sigmoid(self), other);
+      });
+  m.def(
+      "addmm_relu(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+      [](const at::Tensor& self,
+         const at::Tensor& mat1,
+         const at::Tensor& mat2,
+         at::Scalar beta,
+         at::Scalar alpha) {
+        auto out = at::addmm(self, mat1, mat2, beta, alpha);
+        return at::relu_(out);
+      });
+}
+
+namespace {
+
+bool isTensor(const Value* v) {
+  return v->type()->isSubtypeOf(TensorType::get());
+}
+
+void UseVariadicCat(std::shared_ptr<Graph>& graph) {
+  std::vector<Node*> cats;
+  for (Node* n : graph->nodes()) {
+    if (n->kind() == aten::cat) {
+      cats.push_back(n);
+    }
+  }
+  for (Node* cat : cats) {
+    Value* list = cat->namedInput(attr::tensors);
+    Node* list_construct = list->node();
+    // the list must not be seen, and possibly mutated, by anything else
+    if (list_construct->kind() != prim::ListConstruct ||
+        list->uses().size() != 1 || list_construct->inputs().empty()) {
+      continue;
+    }
+    auto dim = toIValue(cat->namedInput(attr::dim));
+    if (!dim) {
+      continue;
+    }
+    Node* fused_cat =
+        graph->create(prim::FusedConcat, list_construct->inputs())
+            ->i_(attr::dim, dim->toInt());
+    fused_cat->insertBefore(cat);
+    fused_cat->output()->copyMetadata(cat->output());
+    cat->output()->replaceAllUsesWith(fused_cat->output());
+    cat->destroy();
+    list_construct->destroy();
+  }
+}
+
+void FuseSigmoidMul(std::shared_ptr<Graph>& graph) {
+  std::string pattern = R"IR(
+    graph(%a, %b):
+        %s = aten::sigmoid(%a)
+        %r = aten::mul(%s, %b)
+        return (%r))IR";
+  std::string commuted_pattern = R"IR(
+    graph(%a, %b):
+        %s = aten::sigmoid(%a)
+        %r = aten::mul(%b, %s)
+        return (%r))IR";
+  std::string fused = R"IR(
+    graph(%a, %b):
+        %r = static_runtime::sigmoid_mul(%a, %b)
+        return (%r))IR";
+  // aten::mul.Scalar has the same kind but takes a number
+  auto other_is_tensor =
+      [](const Match& match,
+         const std::unordered_map<std::string, Value*>& vmap) {
+        return isTensor(match.values_map.at(vmap.at("b")));
+      };
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(pattern, fused);
+  rewriter.RegisterRewritePattern(commuted_pattern, fused);
+  rewriter.runOnGraph(graph, other_is_tensor);
+}
+
+void FuseAddmmRelu(std::shared_ptr<Graph>& graph) {
+  std::string pattern = R"IR(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %y = aten::addmm(%self, %mat1, %mat2, %beta, %alpha)
+        %r = aten::relu(%y)
+        return (%r))IR";
+  std::string fused = R"IR(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %r = static_runtime::addmm_relu(%self, %mat1, %mat2, %beta, %alpha)
+        return (%r))IR";
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(pattern, fused);
+  rewriter.runOnGraph(graph);
+}
+
+bool isContiguousFormat(const Value* memory_format) {
+  auto ival = toIValue(memory_format);
+  return ival && ival->isInt() &&
+      ival->toInt() == static_cast<int64_t>(c10::MemoryFormat::Contiguous);
+}
+
+void RemoveNoopContiguous(std::shared_ptr<Graph>& graph) {
+  static const Symbol addmm_relu =
+      Symbol::fromQualString("static_runtime::addmm_relu");
+  std::vector<Node*> to_remove;
+  for (Node* n : graph->nodes()) {
+    if (n->kind() != aten::contiguous || n->inputs().size() != 2) {
+      continue;
+    }
+    Node* producer = n->input(0)->node();
+    bool noop = false;
+    if (producer->kind() == aten::contiguous &&
+        producer->inputs().size() == 2) {
+      auto format = toIValue(n->input(1));
+      auto producer_format = toIValue(producer->input(1));
+      noop = format && producer_format && format->isInt() &&
+          producer_format->isInt() &&
+          format->toInt() == producer_format->toInt();
+    } else if (
+        producer->kind() == aten::addmm || producer->kind() == aten::bmm ||
+        producer->kind() == addmm_relu) {
+      // these always produce fresh row-major tensors
+      noop = isContiguousFormat(n->input(1));
+    }
+    if (noop) {
+      to_remove.push_back(n);
+    }
+  }
+  for (Node* n : to_remove) {
+    n->output()->replaceAllUsesWith(n->input(0));
+    n->destroy();
+  }
+}
+
+} // namespace
+
+void FuseStaticRuntimeOps(std::shared_ptr<Graph>& graph) {
+  UseVariadicCat(graph);
+  FuseSigmoidMul(graph);
+  FuseAddmmRelu(graph);
+  RemoveNoopContiguous(graph);
+  EliminateDeadCode(graph);
+}
+
+} // namespace jit
+} // namespace torch
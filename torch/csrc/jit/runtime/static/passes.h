@@ -0,0 +1,21 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Rewrites applied to graphs run by the static runtime, and only to those:
+// the fused ops they introduce have kernels in runtime/static/ops.cpp and
+// are not meant to be run by the interpreter.
+//
+// - aten::cat over a prim::ListConstruct becomes a variadic
+//   prim::FusedConcat, so no list is built on every run
+// - aten::mul of an aten::sigmoid becomes static_runtime::sigmoid_mul
+// - aten::relu of an aten::addmm becomes static_runtime::addmm_relu
+// - aten::contiguous of a value that is already contiguous in the requested
+//   format, e.g. the result of another aten::contiguous, is removed
+TORCH_API void FuseStaticRuntimeOps(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/ir/attributes.h>
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/ir/type_hashing.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/reconstruct_scopes.h>
 #include <torch/csrc/jit/runtime/instruction.h>
@@ -20,6 +21,8 @@
 
 #include <ATen/core/jit_type.h>
 #include <ATen/core/qualified_name.h>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -27,6 +30,7 @@ namespace torch {
 namespace jit {
 
 char const* toString(OpCode op);
+OpCode parseOpCode(const char* str);
 
 namespace {
 
@@ -216,6 +220,114 @@ void setstateTuple(
     }
   }
 }
+
+IValue tableField(const IValue& table, size_t entry) {
+  return table.toTuple()->elements().at(entry).toTuple()->elements().at(1);
+}
+
+// Lays the bytecode tuples of moduleMethodsTuple out as in bytecode.ff, see
+// mobile/flat_bytecode.h. The constants of each function are moved to
+// constants, in order.
+std::string flatBytecode(
+    const std::vector<IValue>& elements,
+    std::vector<IValue>& constants) {
+  std::string out;
+  auto align = [&](size_t alignment) {
+    out.resize((out.size() + alignment - 1) / alignment * alignment, '\0');
+  };
+  auto reserve = [&](size_t size, size_t alignment) {
+    align(alignment);
+    size_t offset = out.size();
+    out.resize(offset + size, '\0');
+    TORCH_CHECK(
+        out.size() <= std::numeric_limits<uint32_t>::max(),
+        "The bytecode is too large for the flat format");
+    return static_cast<uint32_t>(offset);
+  };
+  auto writeString = [&](const std::string& str) {
+    uint32_t offset = reserve(sizeof(uint32_t) + str.size(), sizeof(uint32_t));
+    uint32_t length = str.size();
+    std::memcpy(&out[offset], &length, sizeof(length));
+    std::memcpy(&out[offset + sizeof(length)], str.data(), str.size());
+    return offset;
+  };
+
+  // elements[0] is the bytecode version
+  mobile::flat::Header header;
+  std::memcpy(header.magic, mobile::flat::kMagic, sizeof(header.magic));
+  header.format_version = mobile::flat::kFormatVersion;
+  header.bytecode_version = elements.at(0).toInt();
+  header.num_functions = elements.size() - 1;
+  reserve(sizeof(header), alignof(mobile::flat::Header));
+  header.functions = reserve(
+      header.num_functions * sizeof(mobile::flat::Function),
+      alignof(mobile::flat::Function));
+
+  for (size_t i = 1; i < elements.size(); ++i) {
+    const auto& m_tuple = elements[i].toTuple()->elements();
+    const IValue& table = m_tuple[1];
+    const auto& ins_list =
+        tableField(table, BYTECODE_INDEX_INSTRUCTION).toTuple()->elements();
+    const auto& ops_list =
+        tableField(table, BYTECODE_INDEX_OPERATOR).toTuple()->elements();
+    const auto& types_list =
+        tableField(table, BYTECODE_INDEX_TYPE).toTuple()->elements();
+
+    mobile::flat::Function function;
+    function.name = writeString(m_tuple[0].toStringRef());
+    function.register_size =
+        tableField(table, BYTECODE_INDEX_REGISTER_SIZE).toInt();
+
+    function.num_instructions = ins_list.size();
+    function.instructions =
+        reserve(ins_list.size() * sizeof(Instruction), alignof(Instruction));
+    for (size_t j = 0; j < ins_list.size(); ++j) {
+      const auto& ins_item = ins_list[j].toTuple()->elements();
+      Instruction ins(
+          parseOpCode(ins_item[0].toStringRef().c_str()),
+          ins_item[1].toInt(),
+          ins_item[2].toInt());
+      std::memcpy(
+          &out[function.instructions + j * sizeof(Instruction)],
+          &ins,
+          sizeof(ins));
+    }
+
+    std::vector<uint32_t> op_names;
+    op_names.reserve(2 * ops_list.size());
+    for (const auto& op : ops_list) {
+      const auto& op_item = op.toTuple()->elements();
+      op_names.push_back(writeString(op_item[0].toStringRef()));
+      op_names.push_back(writeString(op_item[1].toStringRef()));
+    }
+    function.num_operators = ops_list.size();
+    function.operators =
+        reserve(op_names.size() * sizeof(uint32_t), alignof(uint32_t));
+    std::memcpy(
+        &out[function.operators],
+        op_names.data(),
+        op_names.size() * sizeof(uint32_t));
+
+    std::vector<uint32_t> types;
+    types.reserve(types_list.size());
+    for (const auto& type : types_list) {
+      types.push_back(writeString(type.toStringRef()));
+    }
+    function.num_types = types.size();
+    function.types =
+        reserve(types.size() * sizeof(uint32_t), alignof(uint32_t));
+    std::memcpy(
+        &out[function.types], types.data(), types.size() * sizeof(uint32_t));
+
+    constants.push_back(tableField(table, BYTECODE_INDEX_CONSTANT));
+    std::memcpy(
+        &out[header.functions + (i - 1) * sizeof(function)],
+        &function,
+        sizeof(function));
+  }
+  std::memcpy(&out[0], &header, sizeof(header));
+  return out;
+}
 } // namespace
 
 void moduleMethodsTuple(
@@ -265,7 +377,8 @@ class ScriptModuleSerializer {
       const Module& module,
       const ExtraFilesMap& extra_files,
       bool bytecode_format,
-      bool save_mobile_debug_info) {
+      bool save_mobile_debug_info,
+      bool flat_bytecode) {
     C10_LOG_API_USAGE_ONCE("torch.script.save");
     writeExtraFiles(module, extra_files);
     // Serialize the model object
@@ -278,7 +391,7 @@ class ScriptModuleSerializer {
         constant_table_.begin(), constant_table_.end());
     writeArchive("constants", c10::ivalue::Tuple::create(ivalue_constants));
     if (bytecode_format) {
-      writeByteCode(module, save_mobile_debug_info);
+      writeByteCode(module, save_mobile_debug_info, flat_bytecode);
       writeMobileMetadata(module, extra_files);
     }
 
@@ -406,7 +519,10 @@ class ScriptModuleSerializer {
     }
   }
 
-  void writeByteCode(const Module& module, bool save_mobile_debug_info) {
+  void writeByteCode(
+      const Module& module,
+      bool save_mobile_debug_info,
+      bool flat_bytecode) {
     std::vector<c10::IValue> elements;
     elements.emplace_back(
         static_cast<int64_t>(caffe2::serialize::kProducedBytecodeVersion));
@@ -419,8 +535,15 @@ class ScriptModuleSerializer {
 
     moduleMethodsTuple(
         module, elements, debug_info_elements, save_mobile_debug_info);
-    auto telements = Tup(std::move(elements));
-    writeArchive("bytecode", telements);
+    if (flat_bytecode) {
+      std::vector<IValue> constants;
+      std::string bytecode = flatBytecode(elements, constants);
+      writer_.writeRecord("bytecode.ff", bytecode.data(), bytecode.size());
+      writeArchive("bytecode_constants", Tup(std::move(constants)));
+    } else {
+      auto telements = Tup(std::move(elements));
+      writeArchive("bytecode", telements);
+    }
     if (save_mobile_debug_info) {
       auto debug_info_telements = Tup(std::move(debug_info_elements.value()));
       writeArchive("mobile_debug", debug_info_telements);
@@ -472,14 +595,19 @@ void ExportModule(
     std::ostream& out,
     const ExtraFilesMap& extra_files,
     bool bytecode_format,
-    bool save_mobile_debug_info) {
+    bool save_mobile_debug_info,
+    bool flat_bytecode) {
   ScriptModuleSerializer serializer(
       [&](const void* buf, size_t nbytes) -> size_t {
         out.write(static_cast<const char*>(buf), nbytes);
         return !out ? 0 : nbytes;
       });
   serializer.serialize(
-      module, extra_files, bytecode_format, save_mobile_debug_info);
+      module,
+      extra_files,
+      bytecode_format,
+      save_mobile_debug_info,
+      flat_bytecode);
 }
 
 void ExportModule(
@@ -487,10 +615,15 @@ void ExportModule(
     const std::string& filename,
     const ExtraFilesMap& extra_files,
     bool bytecode_format,
-    bool save_mobile_debug_info) {
+    bool save_mobile_debug_info,
+    bool flat_bytecode) {
   ScriptModuleSerializer serializer(filename);
   serializer.serialize(
-      module, extra_files, bytecode_format, save_mobile_debug_info);
+      module,
+      extra_files,
+      bytecode_format,
+      save_mobile_debug_info,
+      flat_bytecode);
 }
 
 void ExportModule(
@@ -498,10 +631,15 @@ void ExportModule(
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& extra_files,
     bool bytecode_format,
-    bool save_mobile_debug_info) {
+    bool save_mobile_debug_info,
+    bool flat_bytecode) {
   ScriptModuleSerializer serializer(writer_func);
   serializer.serialize(
-      module, extra_files, bytecode_format, save_mobile_debug_info);
+      module,
+      extra_files,
+      bytecode_format,
+      save_mobile_debug_info,
+      flat_bytecode);
 }
 
 namespace {
@@ -59,7 +59,9 @@ TORCH_API Module load(
 ///
 /// The reader adapter, which is for customized input stream, must contain a
 /// serialized `Module`, exported either via `ScriptModule.save()` in
-/// Python or `torch::jit::ExportModule` in C++.
+/// Python or `torch::jit::ExportModule` in C++. Passing a
+/// `caffe2::serialize::MmapFileAdapter` maps the file instead of reading it,
+/// and the CPU tensors of the module then point into the mapping.
 TORCH_API Module load(
     std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt,
@@ -309,12 +309,10 @@ PickleOpCode Unpickler::readInstruction() {
     case PickleOpCode::TUPLE: {
       size_t start = marks_.back();
       marks_.pop_back();
-      auto tuple = c10::ivalue::Tuple::create({});
-      tuple->elements().reserve(stack_.size() - start);
       auto start_it = stack_.begin() + start;
-      for (auto it = start_it; it != stack_.end(); ++it) {
-        tuple->elements().emplace_back(*it);
-      }
+      auto tuple = c10::ivalue::Tuple::create(std::vector<IValue>(
+          std::make_move_iterator(start_it),
+          std::make_move_iterator(stack_.end())));
       stack_.erase(start_it, stack_.end());
       stack_.emplace_back(tuple);
     } break;
@@ -348,20 +346,14 @@ PickleOpCode Unpickler::readInstruction() {
       size_t start = marks_.back();
       marks_.pop_back();
       auto dict = c10::impl::GenericDict(AnyType::get(), AnyType::get());
-      for (size_t i = start; i < stack_.size(); i += 2) {
-        dict.insert_or_assign(stack_[i], stack_[i + 1]);
-      }
-      stack_.erase(stack_.begin() + start, stack_.end());
+      readDictItems(dict, start);
       stack_.push_back(std::move(dict));
     } break;
     case PickleOpCode::SETITEMS: {
       size_t start = marks_.back();
       marks_.pop_back();
       auto dict = stack_.at(start - 1).toGenericDict();
-      for (size_t i = start; i < stack_.size(); i += 2) {
-        dict.insert_or_assign(stack_[i], stack_[i + 1]);
-      }
-      stack_.erase(stack_.begin() + start, stack_.end());
+      readDictItems(dict, start);
     } break;
     case PickleOpCode::BINGET: {
       stack_.push_back(memo_table_.at(read<uint8_t>()));
@@ -421,7 +413,11 @@ PickleOpCode Unpickler::readInstruction() {
         tensor = at::_empty_affine_quantized({}, options, 0, 0)
                      .set_(storage, 0, {}, {});
       } else {
-        tensor = at::empty({0}, options).set_(storage);
+        // Same as at::empty({0}, options).set_(storage), without going
+        // through the dispatcher twice for each of the tensors
+        tensor = at::detail::make_tensor<c10::TensorImpl>(
+            std::move(storage), at::DispatchKey::CPU, dtype);
+        tensor.unsafeGetTensorImpl()->set_sizes_contiguous({numel});
       }
 
       if (device.type() == DeviceType::CUDA) {
@@ -784,8 +780,8 @@ void Unpickler::readList(IValue list_ivalue) {
   } else if (list_ivalue.isList()) {
     auto list = std::move(list_ivalue).toList();
     list.reserve(num_elements);
-    for (const auto& elem : elements) {
-      list.emplace_back(elem);
+    for (auto it = stack_.begin() + start; it != stack_.end(); ++it) {
+      list.emplace_back(std::move(*it));
     }
   } else {
     AT_ERROR("Unknown IValue list kind: ", list_ivalue.tagKind());
@@ -794,6 +790,16 @@ void Unpickler::readList(IValue list_ivalue) {
   stack_.erase(stack_.begin() + start, stack_.end());
 }
 
+// Pop the key value pairs above the MARK at start off of the stack and
+// insert them into dict
+void Unpickler::readDictItems(c10::impl::GenericDict& dict, size_t start) {
+  dict.reserve(dict.size() + (stack_.size() - start) / 2);
+  for (size_t i = start; i + 1 < stack_.size(); i += 2) {
+    dict.insert_or_assign(std::move(stack_[i]), std::move(stack_[i + 1]));
+  }
+  stack_.erase(stack_.begin() + start, stack_.end());
+}
+
 inline bool is_valid_python_id_char(char c) {
   return c == '_' || c == '.' || (c >= '0' && c <= '9') ||
       (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
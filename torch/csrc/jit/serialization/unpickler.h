@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ATen/core/Dict.h>
 #include <ATen/core/ivalue.h>
 #include <caffe2/serialize/inline_container.h>
 #include <torch/csrc/jit/serialization/pickler.h>
@@ -105,6 +106,7 @@ class Unpickler {
   }
   std::string readString();
   void readList(IValue list_ivalue);
+  void readDictItems(c10::impl::GenericDict& dict, size_t start);
   void setInput(size_t memo_id);
   void run();
 
@@ -0,0 +1,205 @@
+#include <torch/csrc/jit/tensorexpr/aot_kernel.h>
+
+#include <ATen/ATen.h>
+#include <ATen/DynamicLibrary.h>
+#include <c10/util/tempfile.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
+#include <torch/csrc/jit/runtime/register_ops_utils.h>
+#include <torch/csrc/jit/tensorexpr/external_functions.h>
+
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+
+namespace {
+
+using KernelFunction = int (*)(void**);
+using InitFunction = void (*)(void* (*)(const char*));
+
+// Names the kernel being initialized asked for and that are not defined, a
+// lookup cannot throw through the generated code.
+std::vector<std::string>& unresolvedNames() {
+  static std::vector<std::string> names;
+  return names;
+}
+
+void* lookupExternalFunction(const char* name) {
+  const auto& functions = getNNCExternalFunctions();
+  auto it = functions.find(name);
+  if (it == functions.end()) {
+    unresolvedNames().emplace_back(name);
+    return nullptr;
+  }
+  return it->second;
+}
+
+// Libraries are loaded once per tensor holding them, which each loaded
+// kernel keeps alive.
+class AOTLibraries {
+ public:
+  KernelFunction kernel(const at::Tensor& bytes, const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LoadedLibrary& loaded = libraries_[bytes.unsafeGetTensorImpl()];
+    if (!loaded.library) {
+      loaded.library = load(bytes);
+      loaded.bytes = bytes;
+    }
+    auto it = loaded.kernels.find(name);
+    if (it != loaded.kernels.end()) {
+      return it->second;
+    }
+
+    std::string init_name = name + "_init";
+    auto init =
+        reinterpret_cast<InitFunction>(loaded.library->sym(init_name.c_str()));
+    unresolvedNames().clear();
+    init(&lookupExternalFunction);
+    TORCH_CHECK(
+        unresolvedNames().empty(),
+        "compiled kernel ",
+        name,
+        " calls undefined function ",
+        unresolvedNames().front());
+    auto kernel =
+        reinterpret_cast<KernelFunction>(loaded.library->sym(name.c_str()));
+    loaded.kernels.emplace(name, kernel);
+    return kernel;
+  }
+
+ private:
+  struct LoadedLibrary {
+    at::Tensor bytes;
+    std::unique_ptr<at::DynamicLibrary> library;
+    std::unordered_map<std::string, KernelFunction> kernels;
+  };
+
+  static std::unique_ptr<at::DynamicLibrary> load(const at::Tensor& bytes) {
+    TORCH_CHECK(
+        bytes.device() == at::kCPU && bytes.scalar_type() == at::kByte &&
+            bytes.dim() == 1 && bytes.is_contiguous(),
+        "expected the compiled kernel library as a 1-D uint8 CPU tensor");
+    // the library stays mapped once its file is removed
+    auto file = c10::try_make_tempfile("torch-nnc-aot-");
+    TORCH_CHECK(file, "failed to create a file for a compiled kernel library");
+    std::ofstream out(file->name, std::ios::binary);
+    out.write(
+        reinterpret_cast<const char*>(bytes.data_ptr<uint8_t>()),
+        bytes.numel());
+    out.close();
+    TORCH_CHECK(out, "failed to write compiled kernel library ", file->name);
+    return std::make_unique<at::DynamicLibrary>(file->name.c_str());
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<c10::TensorImpl*, LoadedLibrary> libraries_;
+};
+
+AOTLibraries& aotLibraries() {
+  static AOTLibraries libraries;
+  return libraries;
+}
+
+std::vector<int64_t> decodeShape(
+    const std::vector<int64_t>& signature,
+    size_t& pos,
+    int64_t rank) {
+  TORCH_CHECK(
+      rank >= 0 && pos + rank <= signature.size(),
+      "malformed compiled kernel signature");
+  std::vector<int64_t> shape(
+      signature.begin() + pos, signature.begin() + pos + rank);
+  pos += rank;
+  return shape;
+}
+
+void runAOTKernel(Stack* stack) {
+  auto inputs = pop(stack).toTensorVector();
+  auto signature = pop(stack).toIntVector();
+  std::string name = pop(stack).toStringRef();
+  at::Tensor library = pop(stack).toTensor();
+  KernelFunction kernel = aotLibraries().kernel(library, name);
+
+  // the kernel takes the data of the inputs, then of the outputs
+  std::vector<void*> args;
+  size_t pos = 0;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    TORCH_CHECK(pos + 2 <= signature.size(), "malformed kernel signature");
+    auto dtype = static_cast<at::ScalarType>(signature[pos++]);
+    int64_t rank = signature[pos++];
+    auto sizes = decodeShape(signature, pos, rank);
+    auto strides = decodeShape(signature, pos, rank);
+    const at::Tensor& input = inputs[i];
+    bool matches = input.device() == at::kCPU &&
+        input.scalar_type() == dtype && input.sizes().equals(sizes);
+    for (int64_t d = 0; matches && d < rank; d++) {
+      // the stride of a dimension of size 1 is never used
+      matches = sizes[d] == 1 || input.strides()[d] == strides[d];
+    }
+    TORCH_CHECK(
+        matches,
+        "input ",
+        i,
+        " of compiled kernel ",
+        name,
+        " is not of the ",
+        dtype,
+        " type, sizes ",
+        c10::IntArrayRef(sizes),
+        " and strides ",
+        c10::IntArrayRef(strides),
+        " it was compiled for");
+    args.push_back(input.data_ptr());
+  }
+  std::vector<at::Tensor> outputs;
+  while (pos < signature.size()) {
+    TORCH_CHECK(pos + 2 <= signature.size(), "malformed kernel signature");
+    auto dtype = static_cast<at::ScalarType>(signature[pos++]);
+    int64_t rank = signature[pos++];
+    auto sizes = decodeShape(signature, pos, rank);
+    outputs.push_back(at::empty(sizes, at::TensorOptions(dtype)));
+    args.push_back(outputs.back().data_ptr());
+  }
+
+  kernel(args.data());
+  push(stack, std::move(outputs));
+}
+
+RegisterOperators AOTKernelOps({
+    Operator(
+        "tensorexpr::aot_kernel(Tensor library, str name, int[] signature, Tensor[] inputs) -> Tensor[]",
+        runAOTKernel,
+        aliasAnalysisFromSchema()),
+});
+
+} // namespace
+
+std::vector<int64_t> encodeAOTKernelSignature(
+    at::ArrayRef<c10::TensorTypePtr> inputs,
+    at::ArrayRef<c10::TensorTypePtr> outputs) {
+  std::vector<int64_t> signature;
+  for (const auto& type : inputs) {
+    TORCH_INTERNAL_ASSERT(type->isComplete());
+    auto sizes = *type->sizes().concrete_sizes();
+    auto strides = *type->strides().concrete_sizes();
+    signature.push_back(static_cast<int64_t>(*type->scalarType()));
+    signature.push_back(sizes.size());
+    signature.insert(signature.end(), sizes.begin(), sizes.end());
+    signature.insert(signature.end(), strides.begin(), strides.end());
+  }
+  for (const auto& type : outputs) {
+    TORCH_INTERNAL_ASSERT(type->scalarType() && type->sizes().concrete_sizes());
+    auto sizes = *type->sizes().concrete_sizes();
+    signature.push_back(static_cast<int64_t>(*type->scalarType()));
+    signature.push_back(sizes.size());
+    signature.insert(signature.end(), sizes.begin(), sizes.end());
+  }
+  return signature;
+}
+
+} // namespace tensorexpr
+} // namespace jit
+} // namespace torch
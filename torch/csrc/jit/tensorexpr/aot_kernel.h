@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ATen/core/jit_type.h>
+#include <c10/util/ArrayRef.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+
+// Fusion groups compiled ahead of time, see CompileTensorExprsAheadOfTime,
+// run as
+//
+//   tensorexpr::aot_kernel(Tensor library, str name, int[] signature,
+//                          Tensor[] inputs) -> Tensor[]
+//
+// where library holds the bytes of a shared library of kernels compiled by
+// LLVMCodeGen::compileToObject and name is the kernel to run. The op loads
+// the library on its first call and needs neither LLVM nor a compiler.
+//
+// As the kernel is specialized to the shapes it was compiled for, the
+// signature lists them, for each input its scalar type, rank, sizes and
+// strides, then for each output its scalar type, rank and sizes. The op
+// checks the inputs against them before calling the kernel.
+TORCH_API std::vector<int64_t> encodeAOTKernelSignature(
+    at::ArrayRef<c10::TensorTypePtr> inputs,
+    at::ArrayRef<c10::TensorTypePtr> outputs);
+
+} // namespace tensorexpr
+} // namespace jit
+} // namespace torch
@@ -11,6 +11,8 @@
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 namespace tensorexpr {
@@ -123,6 +125,99 @@ std::string cudaDtypeCppString(const Dtype& dtype) {
   }
 }
 
+// Vectors of elements accessed with a single instruction, as in ATen's CUDA
+// kernels.
+static const char* aligned_vector_string = R"(
+template <typename scalar_t, int vec_size>
+struct alignas(sizeof(scalar_t) * vec_size) aligned_vector {
+  scalar_t val[vec_size];
+};
+)";
+
+// The aligned_vector a vector of the given dtype is accessed as, or an empty
+// string if there are no such accesses of its size.
+static std::string alignedVectorType(Dtype dtype) {
+  int bytes = dtype.byte_size();
+  if (bytes > 16 || (bytes & (bytes - 1)) != 0) {
+    return "";
+  }
+  return "aligned_vector<" + cudaDtypeCppString(dtype) + ", " +
+      std::to_string(dtype.lanes()) + ">";
+}
+
+// Declares a local vector of the given dtype and returns the array of its
+// elements.
+static std::string declareVector(
+    std::ostream& os,
+    Dtype dtype,
+    const std::string& vec) {
+  const std::string vector_type = alignedVectorType(dtype);
+  if (vector_type.empty()) {
+    os << cudaDtypeCppString(dtype) << " " << vec << "[" << dtype.lanes()
+       << "];" << std::endl;
+    return vec;
+  }
+  os << vector_type << " " << vec << ";" << std::endl;
+  return vec + ".val";
+}
+
+class VectorStoreChecker : public IRVisitor {
+ public:
+  bool hasVectorStore() const {
+    return has_vector_store_;
+  }
+
+ private:
+  void visit(const Store* v) override {
+    has_vector_store_ |= v->value()->dtype().lanes() > 1;
+  }
+
+  bool has_vector_store_ = false;
+};
+
+// Collects the vector loads of an expression, the loads its indices depend on
+// first.
+class VectorLoadFinder : public IRVisitor {
+ public:
+  const std::vector<const Load*>& loads() const {
+    return loads_;
+  }
+
+ private:
+  void visit(const Load* v) override {
+    IRVisitor::visit(v);
+    if (v->dtype().lanes() > 1 &&
+        std::find(loads_.begin(), loads_.end(), v) == loads_.end()) {
+      loads_.push_back(v);
+    }
+  }
+
+  std::vector<const Load*> loads_;
+};
+
+void CudaAnalysis::visit(const For* v) {
+  const LoopOptions& loop_options = v->loop_options();
+  if (loop_options.is_gpu_thread_index()) {
+    int gpu_thread_index = loop_options.gpu_thread_index();
+    if (gpu_thread_extents_.size() <= gpu_thread_index) {
+      gpu_thread_extents_.resize(gpu_thread_index + 1);
+    }
+    const Expr*& extent = gpu_thread_extents_[gpu_thread_index];
+    if (!extent) {
+      extent = v->stop();
+    } else if (extent->isConstant() && v->stop()->isConstant()) {
+      if (immediateAs<int>(v->stop()) > immediateAs<int>(extent)) {
+        extent = v->stop();
+      }
+    } else if (!immediateEquals(v->stop(), 1)) {
+      // A thread-idx whose extent is only known at runtime, all of the other
+      // loops bound to it are assumed to have the same one.
+      extent = v->stop();
+    }
+  }
+  IRVisitor::visit(v);
+}
+
 static void print_flat_alloc(std::ostream& os, const Allocate* alloc) {
   std::vector<const Expr*> dims = alloc->dims();
   // TODO: this should be merged with the storage flattener.
@@ -198,12 +293,15 @@ void CudaPrinter::visit(const For* v) {
     ScopedVarName var_name(
         name_manager(), v->var(), loop_options.gpu_thread_index_str());
     emitIndent();
+    // Threads beyond the extent of this loop skip it.
+    const Expr* extent =
+        cuda_analysis_->gpu_thread_extents()[loop_options.gpu_thread_index()];
+    if (v->stop()->isConstant() && extent->isConstant() &&
+        immediateAs<int>(v->stop()) < immediateAs<int>(extent)) {
+      os() << "if (" << *v->var() << "<" << *v->stop() << ") ";
+    }
     v->body()->accept(this);
     os() << std::endl;
-    int gpu_thread_index = loop_options.gpu_thread_index();
-    if (gpu_thread_extents_.size() <= gpu_thread_index) {
-      gpu_thread_extents_.resize(gpu_thread_index + 1);
-    }
     if (!is_zero(v->start())) {
       throw std::runtime_error(
           "start must be zero for gpu_block_index: " +
@@ -216,13 +314,6 @@ void CudaPrinter::visit(const For* v) {
     // TODO: maybe move this to a dedicated IRNode, if the logic gets
     // sufficiently complicated.
     need_sync_ = true;
-    if (gpu_thread_extents_[gpu_thread_index]) {
-      if (immediateEquals(v->stop(), 1)) {
-        // This is a trivial thread-idx
-        return;
-      }
-    }
-    gpu_thread_extents_[gpu_thread_index] = v->stop();
   } else {
     IRPrinter::visit(v);
   }
@@ -264,6 +355,18 @@ void CudaPrinter::visit(const Intrinsics* v) {
 }
 
 void CudaPrinter::visit(const Load* v) {
+  if (v->dtype().lanes() > 1) {
+    auto it = vector_loads_.find(v);
+    if (lane_ < 0 || it == vector_loads_.end()) {
+      throw unimplemented_lowering(v);
+    }
+    if (v->dtype().scalar_type() == ScalarType::Half) {
+      os() << "__half2float(" << it->second << "[" << lane_ << "])";
+    } else {
+      os() << it->second << "[" << lane_ << "]";
+    }
+    return;
+  }
   // TODO: find a better metric in using ldg or not. Support different dtypes.
   if (v->dtype().scalar_type() == ScalarType::Half) {
     if (v->indices().empty()) {
@@ -348,6 +451,10 @@ class AtomicAddFuser : public IRMutator {
 };
 
 void CudaPrinter::visit(const Store* v) {
+  if (v->value()->dtype().lanes() > 1) {
+    emitVectorStore(v);
+    return;
+  }
   emitIndent();
   if (v->indices().empty()) {
     os() << *v->base_handle() << " = ";
@@ -362,6 +469,118 @@ void CudaPrinter::visit(const Store* v) {
   os() << std::endl;
 }
 
+// Vector stores are computed lane by lane, into a local vector that the
+// vector loads of their value are copied to as well. Local vectors are moved
+// from and to memory with single accesses where the indices are contiguous and
+// the address is aligned to the size of the vector.
+void CudaPrinter::emitVectorStore(const Store* v) {
+  emitIndent();
+  os() << "{" << std::endl;
+  indent_++;
+
+  VectorLoadFinder load_finder;
+  v->value()->accept(&load_finder);
+  for (const Load* load : load_finder.loads()) {
+    const std::string vec =
+        name_manager()->get_unique_name(new Var("vec", kHandle));
+    emitIndent();
+    const std::string elements = declareVector(os(), load->dtype(), vec);
+    emitVectorAccess(
+        load->base_handle(), load->flat_index(), load->dtype(), vec, true);
+    vector_loads_[load] = elements;
+  }
+
+  Dtype dtype = v->value()->dtype();
+  const std::string vec =
+      name_manager()->get_unique_name(new Var("vec", kHandle));
+  emitIndent();
+  const std::string elements = declareVector(os(), dtype, vec);
+  for (lane_ = 0; lane_ < dtype.lanes(); lane_++) {
+    emitIndent();
+    if (dtype.scalar_type() == ScalarType::Half) {
+      os() << elements << "[" << lane_ << "] = __float2half(" << *v->value()
+           << ");";
+    } else {
+      os() << elements << "[" << lane_ << "] = " << *v->value() << ";";
+    }
+    os() << std::endl;
+  }
+  lane_ = -1;
+  emitVectorAccess(v->base_handle(), v->flat_index(), dtype, vec, false);
+  vector_loads_.clear();
+
+  indent_--;
+  emitIndent();
+  os() << "}" << std::endl;
+}
+
+// Copies between the local vector vec and the elements of a vector access.
+void CudaPrinter::emitVectorAccess(
+    const Var* base_handle,
+    const Expr* flat_index,
+    Dtype dtype,
+    const std::string& vec,
+    bool is_load) {
+  const Ramp* ramp = dynamic_cast<const Ramp*>(flat_index);
+  const std::string vector_type = alignedVectorType(dtype);
+  bool contiguous =
+      ramp && immediateEquals(ramp->stride(), 1) && !vector_type.empty();
+  if (contiguous) {
+    emitIndent();
+    os() << "if (reinterpret_cast<unsigned long long>(" << *base_handle
+         << " + " << *ramp->base() << ") % sizeof(" << vector_type
+         << ") == 0) {" << std::endl;
+    indent_++;
+    emitIndent();
+    if (is_load) {
+      os() << vec << " = *reinterpret_cast<const " << vector_type << "*>("
+           << *base_handle << " + " << *ramp->base() << ");";
+    } else {
+      os() << "*reinterpret_cast<" << vector_type << "*>(" << *base_handle
+           << " + " << *ramp->base() << ") = " << vec << ";";
+    }
+    os() << std::endl;
+    indent_--;
+    emitIndent();
+    os() << "} else {" << std::endl;
+    indent_++;
+  }
+  const std::string elements = vector_type.empty() ? vec : vec + ".val";
+  for (lane_ = 0; lane_ < dtype.lanes(); lane_++) {
+    emitIndent();
+    if (is_load) {
+      os() << elements << "[" << lane_ << "] = " << *base_handle << "["
+           << *flat_index << "];";
+    } else {
+      os() << *base_handle << "[" << *flat_index << "] = " << elements << "["
+           << lane_ << "];";
+    }
+    os() << std::endl;
+  }
+  lane_ = -1;
+  if (contiguous) {
+    indent_--;
+    emitIndent();
+    os() << "}" << std::endl;
+  }
+}
+
+void CudaPrinter::visit(const Ramp* v) {
+  if (lane_ < 0) {
+    IRPrinter::visit(v);
+    return;
+  }
+  os() << "(" << *v->base() << " + " << *v->stride() << " * " << lane_ << ")";
+}
+
+void CudaPrinter::visit(const Broadcast* v) {
+  if (lane_ < 0) {
+    IRPrinter::visit(v);
+    return;
+  }
+  os() << *v->value();
+}
+
 void CudaPrinter::visit(const AtomicAdd* v) {
   emitIndent();
   if (thread_local_bufs_.count(v->base_handle()) > 0) {
@@ -462,6 +681,10 @@ class PrioritizeLoad : public IRMutator {
     if (nested_if_then_else_ > 0) {
       return IRMutator::mutate(v);
     }
+    // Vector loads are printed with the vector store of their value.
+    if (v->dtype().lanes() > 1) {
+      return IRMutator::mutate(v);
+    }
     if (thread_local_bufs_.count(v->base_handle()) > 0) {
       return IRMutator::mutate(v);
     }
@@ -786,6 +1009,12 @@ void CudaCodeGen::Initialize() {
     os() << fuser::cuda::half_support_literal << std::endl;
   }
 
+  VectorStoreChecker vectorStoreChecker;
+  stmt()->accept(&vectorStoreChecker);
+  if (vectorStoreChecker.hasVectorStore()) {
+    os() << aligned_vector_string << std::endl;
+  }
+
   std::string func_name = GetUniqueFuncName("func");
   os() << "extern \"C\" __global__" << std::endl << "void " << func_name << "(";
   const std::vector<BufferArg> buffer_args = this->buffer_args();
@@ -26,12 +26,20 @@ class CudaAnalysis : public IRVisitor {
     return store_targets_.count(buf) > 0;
   }
 
+  // The kernel is launched with the largest constant extent of the loops
+  // bound to each thread index, loops of smaller extents are guarded.
+  const std::vector<const Expr*>& gpu_thread_extents() const {
+    return gpu_thread_extents_;
+  }
+
  private:
   void visit(const Store* v) override {
     store_targets_.insert(v->buf());
   }
+  void visit(const For* v) override;
 
   std::unordered_set<const Buf*> store_targets_;
+  std::vector<const Expr*> gpu_thread_extents_;
 };
 
 // A class that overrides the underlying IRPrinter to produce Cuda C.
@@ -61,13 +69,15 @@ class CudaPrinter : public IRPrinter {
   void visit(const Allocate* v) override;
   void visit(const Free* v) override;
   void visit(const Let* v) override;
+  void visit(const Ramp* v) override;
+  void visit(const Broadcast* v) override;
 
   const std::vector<const Expr*>& gpu_block_extents() const {
     return gpu_block_extents_;
   }
 
   const std::vector<const Expr*>& gpu_thread_extents() const {
-    return gpu_thread_extents_;
+    return cuda_analysis_->gpu_thread_extents();
   }
 
   const Var* rand_func() const {
@@ -79,12 +89,22 @@ class CudaPrinter : public IRPrinter {
 
  private:
   void maybe_insert_sync();
+  void emitVectorStore(const Store* v);
+  void emitVectorAccess(
+      const Var* base_handle,
+      const Expr* flat_index,
+      Dtype dtype,
+      const std::string& vec,
+      bool is_load);
   std::vector<const Expr*> gpu_block_extents_;
-  std::vector<const Expr*> gpu_thread_extents_;
   const Var* rand_func_;
   const CudaAnalysis* cuda_analysis_;
   bool need_sync_ = false;
   std::unordered_set<const Var*> thread_local_bufs_;
+  // The lane of the vector expression being printed, -1 outside of them.
+  int lane_ = -1;
+  // The local copies of the vector loads of the store being printed.
+  std::unordered_map<const Load*, std::string> vector_loads_;
 };
 
 // Construct Cuda C from the buffer and tensor input, and invoke the kernel
@@ -117,6 +137,10 @@ class TORCH_CUDA_API CudaCodeGen : public CodeGen {
     call(std::vector<CallArg>({CallArg(ts)...}));
   }
 
+  std::string getCodeText() override {
+    return oss_.str();
+  }
+
  private:
   void Initialize();
 
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+
+// The functions outside of the kernel that code generated by the LLVM backend
+// calls, by the name it calls them with. The JIT defines these names in the
+// kernel's address space, and kernels compiled ahead of time resolve them
+// when they are loaded, in a process that need not link LLVM.
+TORCH_API const std::unordered_map<std::string, void*>&
+getNNCExternalFunctions();
+
+} // namespace tensorexpr
+} // namespace jit
+} // namespace torch
@@ -2,10 +2,16 @@
 
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
+#include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/schedule_cache.h>
+
+#include <chrono>
+#include <limits>
 
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
@@ -313,6 +319,19 @@ std::vector<ExprHandle> TensorExprKernel::inferSizesForValue(
       shape[dim] = concat_size;
       return shape;
     }
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return sizesForValue(v->node()->input(0));
+
+    case aten::sum: {
+      std::vector<ExprHandle> shape;
+      for (const DimArg& dim : getReductionInfo(v->node()).outputDims) {
+        shape.push_back(dim.dim());
+      }
+      return shape;
+    }
+
     case aten::slice:
       throw std::runtime_error(
           "Shape info is not implemented for this kind of node");
@@ -1133,16 +1152,16 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
 
             std::vector<ExprHandle> newAxes(axes.begin(), axes.end());
             ExprHandle load = tensorOrConstant(inputs[0], newAxes);
-            size_t offset = bufferSizes(tensors_.at(inputs[0]->unique()))[dim];
-            newAxes[dim] = newAxes[dim] - IntImm::make(offset);
+            ExprHandle offset = sizesForValue(inputs[0])[dim];
+            newAxes[dim] = newAxes[dim] - offset;
 
             for (size_t ii = 1; ii < inputs.size(); ++ii) {
               load = ifThenElse(
-                  CompareSelect::make(axes[dim], IntImm::make(offset), kLT),
+                  CompareSelect::make(axes[dim], offset, kLT),
                   load,
                   tensorOrConstant(inputs[ii], newAxes));
-              offset += bufferSizes(tensors_.at(inputs[ii]->unique()))[dim];
-              newAxes[dim] = axes[dim] - IntImm::make(offset);
+              offset = offset + sizesForValue(inputs[ii])[dim];
+              newAxes[dim] = axes[dim] - offset;
             }
 
             return load;
@@ -1215,6 +1234,18 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
       return computeSum(v);
     }
 
+    case aten::softmax: {
+      return computeSoftmax(v, false);
+    }
+
+    case aten::log_softmax: {
+      return computeSoftmax(v, true);
+    }
+
+    case aten::layer_norm: {
+      return computeLayerNorm(v);
+    }
+
     default: {
       throw std::runtime_error("Unhandled node kind");
     }
@@ -1267,7 +1298,79 @@ void TensorExprKernel::flattenTensors(BackendType backendType) {
   }
 }
 
-Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
+// An outer loop can run its iterations in parallel if each of them only
+// writes elements indexed by the loop variable, i.e. it is not a reduction
+// axis.
+static bool isParallelizable(For* f) {
+  for (Store* store : NodeFinder<Store>::find(f)) {
+    VarFinder finder;
+    for (const Expr* index : store->indices()) {
+      index->accept(&finder);
+    }
+    if (!finder.vars().count(f->var())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void parallelizeOuterLoops(LoopNest& l) {
+  std::vector<tensorexpr::Block*> blocks;
+  if (For* f = dynamic_cast<For*>(l.root_stmt())) {
+    if (isParallelizable(f)) {
+      l.setParallel(f);
+    }
+  } else if (
+      tensorexpr::Block* body =
+          dynamic_cast<tensorexpr::Block*>(l.root_stmt())) {
+    blocks.push_back(body);
+  }
+  while (blocks.size()) {
+    tensorexpr::Block* b = blocks.back();
+    blocks.pop_back();
+    for (Stmt* s : *b) {
+      if (For* f = dynamic_cast<For*>(s)) {
+        if (isParallelizable(f)) {
+          l.setParallel(f);
+        }
+      } else if (
+          tensorexpr::Block* b2 = dynamic_cast<tensorexpr::Block*>(s)) {
+        blocks.push_back(b2);
+      }
+    }
+  }
+}
+
+// The number of contiguous elements of a flattened output each CUDA thread
+// computes, so that they are accessed as one vector of 16 bytes, or of 8
+// bytes of halves.
+static int cudaVectorWidth(ScalarType dtype) {
+  switch (dtype) {
+    case ScalarType::Float:
+    case ScalarType::Half:
+    case ScalarType::Int:
+      return 4;
+    case ScalarType::Double:
+    case ScalarType::Long:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+static bool isInGPUThreadLoop(For* f) {
+  for (Stmt* s = f->get_parent(); s; s = s->get_parent()) {
+    For* loop = dynamic_cast<For*>(s);
+    if (loop && loop->loop_options().is_gpu_thread_index()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Stmt* TensorExprKernel::generateStmt(
+    BackendType backendType,
+    const LoopSchedule& schedule) {
   flattenTensors(backendType);
 
   torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
@@ -1279,12 +1382,20 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       continue;
     }
     Stmt* loop = l.getLoopBodyFor(p.second);
+    // A reduction is computed into a buffer of its own, as inlining it would
+    // repeat the whole reduction for every element that reads it.
+    if (NodeFinder<ReduceOp>::find(loop).size()) {
+      continue;
+    }
     if (torch::jit::tensorexpr::HasRand(loop).has_rand()) {
       l.computeInlineWithRandom(loop);
-    } else {
+    } else if (schedule.inlineIntermediates) {
       l.computeInline(loop);
     }
   }
+  bool allowVectorization =
+      NodeFinder<ReduceOp>::find(l.root_stmt()).size() == 0;
+
   if (backendType == kCudaCodeGen) {
     for (size_t i = 0; i < flatTensorOutputs_.size(); i++) {
       Tensor* tensor = flatTensorOutputs_[i];
@@ -1307,7 +1418,19 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
           blockSize = kDefaultBlockSize;
         }
         std::vector<For*> loops = l.getLoopStmtsFor(tensor);
-        l.splitWithMask(loops[0], blockSize, &outer, &inner);
+        // Each thread computes a vector of elements, vectorized once the
+        // loops are lowered. Vectors must not straddle the end of the
+        // output, and random numbers are drawn thread by thread.
+        For* flat = loops[0];
+        int vectorWidth =
+            cudaVectorWidth(tensor->buf()->dtype().scalar_type());
+        const IntImm* numel = dynamic_cast<const IntImm*>(flat->stop());
+        if (allowVectorization && !hasRandom_ && vectorWidth > 1 && numel &&
+            numel->value() % vectorWidth == 0) {
+          For* vector;
+          l.splitWithMask(flat, vectorWidth, &flat, &vector);
+        }
+        l.splitWithMask(flat, blockSize, &outer, &inner);
         l.setGPUBlockIndex(outer, 0);
         l.setGPUThreadIndex(inner, 0);
       } else if (loopLevels == 3) {
@@ -1359,12 +1482,19 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
     }
   }
 
-  bool allowVectorization =
-      NodeFinder<ReduceOp>::find(l.root_stmt()).size() == 0;
-
   l.prepareForCodegen();
 
-  if (backendType == kLLVMCodeGen && allowVectorization) {
+  if (backendType == kCudaCodeGen && allowVectorization) {
+    // The only loops within thread loops are the vectors of the schedule
+    for (For* loop : NodeFinder<For>::find(l.root_stmt())) {
+      if (loop->loop_options().isDefault() && isInGPUThreadLoop(loop)) {
+        l.vectorize(loop);
+      }
+    }
+  }
+
+  if (backendType == kLLVMCodeGen && allowVectorization &&
+      schedule.bodyVectorWidth > 1) {
     std::vector<For*> innerLoops;
     std::vector<For*> worklist;
 
@@ -1414,21 +1544,27 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       For* split1;
       For* tail1;
 
-      static const int kBodyVectorWidth = 8;
-      l.splitWithTail(loop, kBodyVectorWidth, &outer1, &split1, &tail1);
+      l.splitWithTail(
+          loop, schedule.bodyVectorWidth, &outer1, &split1, &tail1);
       l.vectorize(split1);
 
-      if (tail1) {
+      if (tail1 && schedule.tailVectorWidth > 0) {
         For* outer2;
         For* split2;
         For* tail2;
-        static const int kTailVectorWidth = 4;
-        l.splitWithTail(tail1, kTailVectorWidth, &outer2, &split2, &tail2);
+        l.splitWithTail(
+            tail1, schedule.tailVectorWidth, &outer2, &split2, &tail2);
         l.vectorize(split2);
       }
     }
   }
 
+  // Run the outer loops on the intra-op thread pool, like TensorIterator
+  // kernels.
+  if (backendType == kLLVMCodeGen) {
+    parallelizeOuterLoops(l);
+  }
+
   Stmt* stmt = l.root_stmt();
   // Arithmetic Simplification.
   stmt = IRSimplifier::simplify(stmt);
@@ -1436,6 +1572,100 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
   return stmt;
 }
 
+std::string TensorExprKernel::scheduleKey(BackendType backendType) {
+  // canonical value names, so identical subgraphs in different processes
+  // share a key
+  return getCodeGenName(backendType) + "\n" +
+      Canonicalize(graph_, false)->toString(false);
+}
+
+LoopSchedule TensorExprKernel::pickSchedule(BackendType backendType) {
+  // only schedules of CPU kernels are tuned
+  if (backendType != kLLVMCodeGen) {
+    return LoopSchedule();
+  }
+  std::string key = scheduleKey(backendType);
+  if (auto cached = lookupSchedule(key)) {
+    GRAPH_DEBUG("Using cached schedule ", cached->toString());
+    return *cached;
+  }
+  // kernels with symbolic shapes have no sample inputs to be tuned with
+  bool allInputsComplete = std::all_of(
+      inputTypes_.begin(), inputTypes_.end(), [](const TypePtr& type) {
+        auto tt = type->cast<TensorType>();
+        return !tt || tt->isComplete();
+      });
+  if (!getTEAutotune() || !allInputsComplete) {
+    return LoopSchedule();
+  }
+  LoopSchedule tuned = tuneSchedule(backendType);
+  storeSchedule(key, tuned);
+  return tuned;
+}
+
+// Inputs of the types the kernel was compiled for. They are filled with
+// ones, which no op here traps on (e.g. integer division).
+std::vector<IValue> TensorExprKernel::sampleInputs() {
+  std::vector<IValue> inputs;
+  for (const auto& type : inputTypes_) {
+    if (auto tt = type->cast<TensorType>()) {
+      auto options = c10::TensorOptions(*tt->scalarType()).device(device_);
+      inputs.emplace_back(at::empty_strided(
+                              *tt->sizes().concrete_sizes(),
+                              *tt->strides().concrete_sizes(),
+                              options)
+                              .fill_(1));
+    } else if (type->kind() == TypeKind::FloatType) {
+      inputs.emplace_back(1.0);
+    } else if (type->kind() == TypeKind::IntType) {
+      inputs.emplace_back(1);
+    } else {
+      inputs.emplace_back(true);
+    }
+  }
+  return inputs;
+}
+
+LoopSchedule TensorExprKernel::tuneSchedule(BackendType backendType) {
+  const int kWarmupRuns = 2;
+  const int kTimedRuns = 10;
+  std::vector<IValue> inputs = sampleInputs();
+  LoopSchedule best;
+  auto bestTime = std::chrono::steady_clock::duration::max();
+  for (const LoopSchedule& candidate : candidateSchedules()) {
+    try {
+      Stmt* stmt = generateStmt(backendType, candidate);
+      auto codegen = CreateCodeGen(
+          getCodeGenName(backendType), stmt, prepareBufferArgs(), device_);
+      std::vector<at::Tensor> outputs;
+      std::vector<CodeGen::CallArg> runArgs = prepareRunArgs(inputs, outputs);
+      for (int i = 0; i < kWarmupRuns; i++) {
+        codegen->call(runArgs);
+      }
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kTimedRuns; i++) {
+        codegen->call(runArgs);
+      }
+      auto time = std::chrono::steady_clock::now() - start;
+      GRAPH_DEBUG(
+          "Schedule ",
+          candidate.toString(),
+          " took ",
+          std::chrono::duration_cast<std::chrono::microseconds>(time).count(),
+          "us");
+      if (time < bestTime) {
+        bestTime = time;
+        best = candidate;
+      }
+    } catch (const std::exception& e) {
+      GRAPH_DEBUG(
+          "Schedule ", candidate.toString(), " failed to compile: ", e.what());
+    }
+  }
+  GRAPH_DEBUG("Picked schedule ", best.toString());
+  return best;
+}
+
 std::string TensorExprKernel::getCodeGenName(BackendType backendType) {
   switch (backendType) {
     case kCudaCodeGen:
@@ -1581,6 +1811,57 @@ TensorExprKernel::BackendType TensorExprKernel::inferBackendTypeFromDevice(
   return backendType;
 }
 
+void TensorExprKernel::bindSymbolicShape(
+    const torch::jit::Value* input,
+    std::vector<ExprHandle>& sizes,
+    std::vector<ExprHandle>& strides,
+    std::vector<ShapeArg>& sizeArgs,
+    std::vector<ShapeArg>& strideArgs) {
+  auto tt = input->type()->cast<TensorType>();
+  auto symbols = tt->symbolic_sizes().sizes();
+  if (!symbols) {
+    throw malformed_input("input of unknown rank: %" + input->debugName());
+  }
+  // Dimensions of the same symbol are guarded to be equal, so they share a
+  // kernel argument.
+  for (size_t i = 0; i < symbols->size(); i++) {
+    const c10::ShapeSymbol& symbol = (*symbols)[i];
+    if (symbol.is_static()) {
+      sizes.push_back(IntImm::make(symbol.static_size()));
+      continue;
+    }
+    auto it = shapeSymbols_.find(symbol);
+    if (it == shapeSymbols_.end()) {
+      VarHandle size(
+          "size_" + input->debugName() + "_" + c10::to_string(i), kInt);
+      it = shapeSymbols_.emplace(symbol, size).first;
+      sizeArgs.emplace_back(i, size);
+    }
+    sizes.push_back(it->second);
+  }
+
+  // Strides are kernel arguments too, unless the type fixes them; it does for
+  // the innermost one of a dense tensor.
+  strides.resize(sizes.size());
+  const auto& strideProps = tt->stride_properties();
+  if (strideProps.size() && *strideProps.size() == sizes.size()) {
+    for (size_t i = 0; i < sizes.size(); i++) {
+      const auto& prop = strideProps[i];
+      if (prop && prop->stride_index_ && prop->stride_) {
+        strides[*prop->stride_index_] = IntImm::make(*prop->stride_);
+      }
+    }
+  }
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (!strides[i].node()) {
+      VarHandle stride(
+          "stride_" + input->debugName() + "_" + c10::to_string(i), kInt);
+      strideArgs.emplace_back(i, stride);
+      strides[i] = stride;
+    }
+  }
+}
+
 void TensorExprKernel::bindInput(const torch::jit::Value* input) {
   auto const& t = input->type();
   switch (t->kind()) {
@@ -1590,13 +1871,24 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
           "t" + input->debugName(),
           ToDtype(static_cast<ScalarType>(*tt->scalarType())),
           {0});
+      std::vector<ExprHandle> sizes;
+      std::vector<ExprHandle> strides;
+      std::vector<ShapeArg> sizeArgs;
+      std::vector<ShapeArg> strideArgs;
+      if (tt->isComplete()) {
+        for (size_t i = 0; i < *tt->sizes().size(); i++) {
+          sizes.push_back(IntImm::make(*tt->sizes()[i]));
+          strides.push_back(IntImm::make(*tt->strides()[i]));
+        }
+      } else {
+        bindSymbolicShape(input, sizes, strides, sizeArgs, strideArgs);
+        known_sizes_[input] = sizes;
+      }
       std::vector<DimArg> inputTensorDims;
-      for (size_t i = 0; i < *tt->sizes().size(); i++) {
-        auto const size = *tt->sizes()[i];
+      for (size_t i = 0; i < sizes.size(); i++) {
         inputTensorDims.emplace_back(
-            DimArg(IntImm::make(size), "i" + c10::to_string(i)));
+            DimArg(sizes[i], "i" + c10::to_string(i)));
       }
-      auto const strides = tt->strides();
       tensors_.emplace(
           input->unique(),
           Compute(
@@ -1605,12 +1897,12 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
               [&](const std::vector<VarHandle>& axes) {
                 ExprHandle idx = 0;
                 for (size_t i = 0; i < axes.size(); i++) {
-                  idx = idx + axes[i] * IntImm::make(*strides[i]);
+                  idx = idx + axes[i] * strides[i];
                 }
                 return inBuffer(idx);
               }));
       kernelArgs_.emplace_back(
-          inBuffer, std::vector<ShapeArg>(), std::vector<ShapeArg>());
+          inBuffer, std::move(sizeArgs), std::move(strideArgs));
       break;
     }
     case TypeKind::FloatType: {
@@ -1653,6 +1945,68 @@ std::vector<VarHandle> squeezeIndices(
   return indices_squeezed;
 }
 
+// The value of an int[] input, either a constant or a ListConstruct of
+// constants.
+std::vector<int64_t> constantIntList(const torch::jit::Value* v) {
+  if (auto ival = toIValue(v)) {
+    return ival->toIntVector();
+  }
+  TORCH_INTERNAL_ASSERT(v->node()->kind() == prim::ListConstruct);
+  std::vector<int64_t> list;
+  for (auto item : v->node()->inputs()) {
+    auto ival = toIValue(item);
+    TORCH_INTERNAL_ASSERT(ival && ival->isInt());
+    list.push_back(ival->toInt());
+  }
+  return list;
+}
+
+// Reduces a tensor of the given sizes over the given axes, keeping them as
+// one-sized dimensions. The body computes the element at the given indices of
+// that tensor.
+Tensor* reduceKeepDims(
+    const std::string& name,
+    const std::vector<ExprHandle>& sizes,
+    const std::vector<size_t>& axes,
+    const Reducer& reducer,
+    const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body) {
+  std::vector<DimArg> outputDims;
+  std::vector<DimArg> reductionDims;
+  for (size_t dim = 0; dim < sizes.size(); ++dim) {
+    if (std::count(axes.begin(), axes.end(), dim)) {
+      outputDims.emplace_back(1);
+      reductionDims.emplace_back(sizes[dim]);
+    } else {
+      outputDims.emplace_back(sizes[dim]);
+    }
+  }
+  return Reduce(
+      name,
+      outputDims,
+      reducer,
+      [&](ParameterList& indices) {
+        std::vector<ExprHandle> indices_exprs(
+            indices.begin(), indices.begin() + sizes.size());
+        size_t i = sizes.size();
+        for (auto axis : axes) {
+          indices_exprs[axis] = indices[i++];
+        }
+        return body(indices_exprs);
+      },
+      reductionDims);
+}
+
+// The indices of the element of a reduceKeepDims result that the element at
+// the given indices is reduced into.
+std::vector<ExprHandle> reducedIndices(
+    std::vector<ExprHandle> indices,
+    const std::vector<size_t>& axes) {
+  for (auto axis : axes) {
+    indices[axis] = IntImm::make(0);
+  }
+  return indices;
+}
+
 } // namespace
 
 Tensor* TensorExprKernel::computeSum(const torch::jit::Value* v) {
@@ -1691,6 +2045,124 @@ Tensor* TensorExprKernel::computeSum(const torch::jit::Value* v) {
       reduction_info.reductionDims);
 }
 
+Tensor* TensorExprKernel::computeSoftmax(
+    const torch::jit::Value* v,
+    bool logSoftmax) {
+  // Computed the numerically stable way, as in ATen:
+  //   softmax(x) = exp(x - max(x)) / sum(exp(x - max(x)))
+  //   log_softmax(x) = x - max(x) - log(sum(exp(x - max(x))))
+  // The max and the sum are reductions into temporary buffers, and
+  // exp(x - max(x)) is computed once for softmax.
+  auto const& n = v->node();
+  auto input = n->input(0);
+  auto sizes = sizesForValue(input);
+  if (sizes.empty()) {
+    throw malformed_input("softmax of a zero-dimensional tensor");
+  }
+  int rank = sizes.size();
+  std::vector<size_t> axes = {static_cast<size_t>(at::maybe_wrap_dim(
+      constant(n->input(1)).AsNode<IntImm>()->value(), rank))};
+  auto load = [&](const std::vector<ExprHandle>& indices) {
+    return tensorOrConstant(input, indices);
+  };
+
+  Tensor* max = reduceKeepDims(
+      "aten_softmax_max",
+      sizes,
+      axes,
+      Maximum(ExprHandle(-std::numeric_limits<float>::infinity())),
+      load);
+  auto shifted = [&](const std::vector<ExprHandle>& indices) {
+    return load(indices) - max->call(reducedIndices(indices, axes));
+  };
+  Tensor* e = Compute(
+      "aten_softmax_exp",
+      dimsFromSizes(sizes),
+      [&](const std::vector<VarHandle>& axes_vars) {
+        std::vector<ExprHandle> indices(axes_vars.begin(), axes_vars.end());
+        return exp(shifted(indices));
+      });
+  Tensor* sum = reduceKeepDims(
+      "aten_softmax_sum",
+      sizes,
+      axes,
+      Sum(),
+      [&](const std::vector<ExprHandle>& indices) {
+        return e->call(indices);
+      });
+  return Compute(
+      logSoftmax ? "aten_log_softmax" : "aten_softmax",
+      dimsFromSizes(sizes),
+      [&](const std::vector<VarHandle>& axes_vars) {
+        std::vector<ExprHandle> indices(axes_vars.begin(), axes_vars.end());
+        auto total = sum->call(reducedIndices(indices, axes));
+        if (logSoftmax) {
+          return shifted(indices) - log(total);
+        }
+        return e->call(indices) / total;
+      });
+}
+
+Tensor* TensorExprKernel::computeLayerNorm(const torch::jit::Value* v) {
+  // The mean and the variance over the normalized dimensions are reductions
+  // into temporary buffers; the variance is computed from the centered
+  // input, as in ATen.
+  auto const& n = v->node();
+  auto input = n->input(0);
+  auto weight = n->input(2);
+  auto bias = n->input(3);
+  auto sizes = sizesForValue(input);
+  auto normalizedShape = constantIntList(n->input(1));
+  if (normalizedShape.empty() || normalizedShape.size() > sizes.size()) {
+    throw malformed_input("invalid normalized_shape in aten::layer_norm");
+  }
+  size_t firstAxis = sizes.size() - normalizedShape.size();
+  std::vector<size_t> axes;
+  int64_t count = 1;
+  for (size_t axis = firstAxis; axis < sizes.size(); ++axis) {
+    axes.push_back(axis);
+    count *= normalizedShape[axis - firstAxis];
+  }
+  ExprHandle invCount(1.0f / count);
+  ExprHandle eps = constant(n->input(4));
+  auto load = [&](const std::vector<ExprHandle>& indices) {
+    return tensorOrConstant(input, indices);
+  };
+
+  Tensor* sum = reduceKeepDims("aten_layer_norm_sum", sizes, axes, Sum(), load);
+  auto centered = [&](const std::vector<ExprHandle>& indices) {
+    return load(indices) -
+        sum->call(reducedIndices(indices, axes)) * invCount;
+  };
+  Tensor* squares = reduceKeepDims(
+      "aten_layer_norm_squares",
+      sizes,
+      axes,
+      Sum(),
+      [&](const std::vector<ExprHandle>& indices) {
+        auto d = centered(indices);
+        return d * d;
+      });
+  return Compute(
+      "aten_layer_norm",
+      dimsFromSizes(sizes),
+      [&](const std::vector<VarHandle>& axes_vars) {
+        std::vector<ExprHandle> indices(axes_vars.begin(), axes_vars.end());
+        std::vector<ExprHandle> normalizedIndices(
+            indices.begin() + firstAxis, indices.end());
+        auto variance =
+            squares->call(reducedIndices(indices, axes)) * invCount;
+        auto result = centered(indices) * rsqrt(variance + eps);
+        if (weight->type()->kind() != TypeKind::NoneType) {
+          result = result * tensorOrConstant(weight, normalizedIndices);
+        }
+        if (bias->type()->kind() != TypeKind::NoneType) {
+          result = result + tensorOrConstant(bias, normalizedIndices);
+        }
+        return result;
+      });
+}
+
 TensorExprKernel::ReductionInfo TensorExprKernel::getReductionInfo(
     const torch::jit::Node* node) {
   std::vector<size_t> axes;
@@ -1700,13 +2172,9 @@ TensorExprKernel::ReductionInfo TensorExprKernel::getReductionInfo(
   const auto inputs = node->inputs();
   if (inputs.size() > 2) {
     // Canonicalize axes: wrap around, sort and make unique.
-    auto axesValue = node->namedInput(attr::dim);
-    TORCH_INTERNAL_ASSERT(axesValue->node()->kind() == prim::ListConstruct);
-    for (auto axisNode : axesValue->node()->inputs()) {
+    for (auto axis : constantIntList(node->namedInput(attr::dim))) {
       int rank = sizes.size();
-      int axis = at::maybe_wrap_dim(
-          constant(axisNode).AsNode<IntImm>()->value(), rank);
-      axes.push_back(axis);
+      axes.push_back(at::maybe_wrap_dim(axis, rank));
     }
     std::sort(axes.begin(), axes.end());
     axes.erase(std::unique(axes.begin(), axes.end()), axes.end());
@@ -1778,12 +2246,24 @@ void TensorExprKernel::compile() {
 
   device_ = pickDeviceType(graph_->inputs());
   BackendType backendType = inferBackendTypeFromDevice(device_);
-  Stmt* stmt = generateStmt(backendType);
+  Stmt* stmt = generateStmt(backendType, pickSchedule(backendType));
   // Set up formal params (inputs, then outputs) for kernel.
   std::vector<CodeGen::BufferArg> params = prepareBufferArgs();
 
   // Generate code.
   codegen_ = CreateCodeGen(getCodeGenName(backendType), stmt, params, device_);
+
+  KernelArenaStats stats = kernelArena_.stats();
+  GRAPH_DEBUG(
+      "Compiled a kernel from ",
+      stats.objects,
+      " IR objects, taking ",
+      stats.bytesAllocated,
+      " bytes of ",
+      stats.bytesReserved,
+      " in ",
+      stats.slabs,
+      " slabs");
 }
 
 TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
@@ -1818,10 +2298,41 @@ void TensorExprKernel::run(Stack& stack) {
   }
 }
 
+// Evaluates an output size, an expression of the input sizes, without
+// allocating any IR.
+static int64_t evaluateSize(
+    const Expr* e,
+    const std::unordered_map<const Expr*, int64_t>& varToSize) {
+  if (const IntImm* imm = dynamic_cast<const IntImm*>(e)) {
+    return imm->value();
+  }
+  auto it = varToSize.find(e);
+  if (it != varToSize.end()) {
+    return it->second;
+  }
+  if (const Add* add = dynamic_cast<const Add*>(e)) {
+    return evaluateSize(add->lhs(), varToSize) +
+        evaluateSize(add->rhs(), varToSize);
+  }
+  if (const Sub* sub = dynamic_cast<const Sub*>(e)) {
+    return evaluateSize(sub->lhs(), varToSize) -
+        evaluateSize(sub->rhs(), varToSize);
+  }
+  if (const Mul* mul = dynamic_cast<const Mul*>(e)) {
+    return evaluateSize(mul->lhs(), varToSize) *
+        evaluateSize(mul->rhs(), varToSize);
+  }
+  if (const Div* div = dynamic_cast<const Div*>(e)) {
+    return evaluateSize(div->lhs(), varToSize) /
+        evaluateSize(div->rhs(), varToSize);
+  }
+  throw malformed_input("output expected Int", e);
+}
+
 std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
     const at::ArrayRef<IValue>& inputs,
     std::vector<at::Tensor>& outputs) {
-  std::map<const Expr*, int32_t> varToSize;
+  std::unordered_map<const Expr*, int64_t> varToSize;
 
   std::vector<CodeGen::CallArg> runArgs;
   for (size_t i = 0; i < inputs.size(); i++) {
@@ -1848,16 +2359,7 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
   for (auto& o : tensorOutputs_) {
     std::vector<int64_t> tensorSize;
     for (const Expr* dim : o->dims()) {
-      auto it = varToSize.find(dim);
-      if (it != varToSize.end()) {
-        tensorSize.push_back(it->second);
-      } else {
-        const IntImm* s = dynamic_cast<const IntImm*>(dim);
-        if (!s) {
-          throw malformed_input("output expected Int", dim);
-        }
-        tensorSize.push_back(s->value());
-      }
+      tensorSize.push_back(evaluateSize(dim, varToSize));
     }
 
     outputs.push_back(at::empty(
@@ -1871,6 +2373,40 @@ Stmt* TensorExprKernel::getCodeGenStmt() {
   return codegen_->stmt();
 }
 
+std::string TensorExprKernel::compileToObject(const std::string& name) {
+  if (fallback_ ||
+      inferBackendTypeFromDevice(device_) != BackendType::kLLVMCodeGen) {
+    throw std::runtime_error("Only LLVM kernels can be compiled to objects");
+  }
+  for (const auto& arg : kernelArgs_) {
+    if (arg.buffer().isVar() || !arg.sizes().empty() ||
+        !arg.strides().empty()) {
+      throw std::runtime_error(
+          "Kernels compiled to objects take tensors of static shapes");
+    }
+  }
+#ifdef TORCH_ENABLE_LLVM
+  KernelScope kernelScope(&kernelArena_);
+  return LLVMCodeGen::compileToObject(
+      codegen_->stmt(), codegen_->buffer_args(), name);
+#else
+  throw std::runtime_error("Compiling kernels to objects requires LLVM");
+#endif
+}
+
+std::vector<c10::TensorTypePtr> TensorExprKernel::outputTypes() {
+  std::vector<c10::TensorTypePtr> types;
+  for (Tensor* o : tensorOutputs_) {
+    std::vector<int64_t> sizes;
+    for (const Expr* dim : o->dims()) {
+      sizes.push_back(evaluateSize(dim, {}));
+    }
+    types.push_back(
+        TensorType::createContiguous(tensorType(o), device_, sizes));
+  }
+  return types;
+}
+
 void TensorExprKernel::runKernel(Stack& stack) {
   KernelScope kernelScope(&kernelArena_);
 
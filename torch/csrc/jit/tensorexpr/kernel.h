@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/codegen.h>
+#include <torch/csrc/jit/tensorexpr/schedule_cache.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
 
 namespace torch {
@@ -35,6 +36,15 @@ class TORCH_API TensorExprKernel {
     return codegen_->getCodeText();
   }
 
+  // Compiles the kernel into an object file for the host CPU, in which it is
+  // named name, see LLVMCodeGen::compileToObject. It takes the data of the
+  // inputs and then of the outputs, so all of these have to be tensors of
+  // static shapes; throws when they are not.
+  std::string compileToObject(const std::string& name);
+
+  // The types of the outputs of a kernel of static shapes.
+  std::vector<c10::TensorTypePtr> outputTypes();
+
  private:
   enum BackendType {
     kUninitialized,
@@ -121,12 +131,22 @@ class TORCH_API TensorExprKernel {
 
   Tensor* computeSum(const torch::jit::Value* v);
 
+  Tensor* computeSoftmax(const torch::jit::Value* v, bool logSoftmax);
+
+  Tensor* computeLayerNorm(const torch::jit::Value* v);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
-  Stmt* generateStmt(BackendType backendType);
+  Stmt* generateStmt(BackendType backendType, const LoopSchedule& schedule);
   std::vector<CodeGen::BufferArg> prepareBufferArgs();
 
+  // Returns the cached schedule for this kernel, or tunes it if enabled.
+  LoopSchedule pickSchedule(BackendType backendType);
+  LoopSchedule tuneSchedule(BackendType backendType);
+  std::string scheduleKey(BackendType backendType);
+  std::vector<IValue> sampleInputs();
+
   std::string getCodeGenName(BackendType backendType);
 
   std::vector<CodeGen::CallArg> prepareRunArgs(
@@ -184,6 +204,15 @@ class TORCH_API TensorExprKernel {
     std::vector<ShapeArg> strideArgs_;
   };
 
+  // Binds the sizes and strides of an input of symbolic shape to kernel
+  // arguments, except for those its type fixes.
+  void bindSymbolicShape(
+      const torch::jit::Value* input,
+      std::vector<ExprHandle>& sizes,
+      std::vector<ExprHandle>& strides,
+      std::vector<ShapeArg>& sizeArgs,
+      std::vector<ShapeArg>& strideArgs);
+
   int64_t nInputs_ = 0;
   std::vector<KernelArg> kernelArgs_;
   std::vector<Tensor*> tensorOutputs_;
@@ -201,6 +230,8 @@ class TORCH_API TensorExprKernel {
   bool hasBroadcast_{false};
   std::unordered_map<const torch::jit::Value*, std::vector<ExprHandle>>
       known_sizes_;
+  // The kernel argument of each shape symbol of the input sizes.
+  std::map<c10::ShapeSymbol, VarHandle> shapeSymbols_;
 };
 
 TORCH_API int& getTECudaPointwiseLoopLevels();
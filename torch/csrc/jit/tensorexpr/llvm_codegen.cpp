@@ -3,9 +3,12 @@
 #include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
+
 #include <memory>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
@@ -15,6 +18,7 @@
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
+#include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
@@ -43,6 +47,10 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Value* value_{nullptr};
   llvm::JITTargetAddress kernelAddress_;
   std::unique_ptr<void* []> argv_ { nullptr };
+  // Set when compiling into an object file rather than the JIT, see
+  // LLVMCodeGen::compileToObject.
+  std::string kernelName_;
+  std::string object_;
 
 #define LLVM_TYPE_DECLARE(_1, Name) llvm::Type* Name##Ty_;
   AT_FORALL_SCALAR_TYPES_AND2(Bool, Half, LLVM_TYPE_DECLARE);
@@ -59,17 +67,27 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  void emitLoop(
+      const Var* var,
+      llvm::Value* start,
+      llvm::Value* stop,
+      const Block* body);
+  void emitParallelFor(const For* v);
+  void emitImportResolver();
+  void emitObject();
 
  public:
   LLVMCodeGenImpl(
       Stmt* stmt,
       const std::vector<CodeGen::BufferArg>& args,
       at::Device device,
-      Dtype dtype);
+      Dtype dtype,
+      std::string kernelName = "");
   ~LLVMCodeGenImpl() = default;
 
   llvm::JITTargetAddress getKernelAddress() const;
   void** getArgvAddress() const;
+  const std::string& getObject() const;
 
   void visit(const Add* v) override;
   void visit(const Sub* v) override;
@@ -202,6 +220,15 @@ void LLVMCodeGen::call(const std::vector<CallArg>& args) {
   USE_TRIGGER(llvm_codegen_executed);
 }
 
+std::string LLVMCodeGen::compileToObject(
+    Stmt* stmt,
+    const std::vector<BufferArg>& args,
+    const std::string& name,
+    Dtype dtype) {
+  TORCH_CHECK(!name.empty(), "compiled kernels need a name");
+  return LLVMCodeGenImpl(stmt, args, at::kCPU, dtype, name).getObject();
+}
+
 void* LLVMCodeGen::getKernelAddress(LLVMCodeGenImpl* impl) {
   return (void*)impl->getKernelAddress();
 }
@@ -214,12 +241,19 @@ void** LLVMCodeGenImpl::getArgvAddress() const {
   return argv_.get();
 }
 
+const std::string& LLVMCodeGenImpl::getObject() const {
+  return object_;
+}
+
 LLVMCodeGenImpl::LLVMCodeGenImpl(
     Stmt* stmt,
     const std::vector<CodeGen::BufferArg>& args,
     at::Device device,
-    Dtype dtype)
-    : context_(std::make_unique<llvm::LLVMContext>()), irb_(getContext()) {
+    Dtype dtype,
+    std::string kernelName)
+    : context_(std::make_unique<llvm::LLVMContext>()),
+      irb_(getContext()),
+      kernelName_(std::move(kernelName)) {
   // Manually map types to LLVM types.
   ByteTy_ = llvm::Type::getInt8Ty(getContext());
   CharTy_ = llvm::Type::getInt8Ty(getContext());
@@ -235,9 +269,12 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   llvm::InitializeNativeTargetAsmPrinter();
 
   auto JTMB = makeTargetMachineBuilder();
+  if (!kernelName_.empty()) {
+    // the object is linked into a shared library
+    JTMB.setRelocationModel(llvm::Reloc::PIC_);
+  }
   TM_ = llvm::cantFail(JTMB.createTargetMachine());
 
-  jit_ = std::make_unique<llvm::orc::PytorchLLVMJIT>();
   module_ = std::make_unique<llvm::Module>("pytorch", getContext());
   module_->setDataLayout(cantFail(JTMB.getDefaultDataLayoutForTarget()));
   module_->setTargetTriple(JTMB.getTargetTriple().str());
@@ -266,6 +303,13 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   emitWrapper(params);
   emitKernel(stmt, params);
 
+  if (!kernelName_.empty()) {
+    emitImportResolver();
+    emitObject();
+    return;
+  }
+
+  jit_ = std::make_unique<llvm::orc::PytorchLLVMJIT>();
   cantFail(jit_->addModule(
       llvm::orc::ThreadSafeModule(std::move(module_), context_)));
   auto sym = jit_->findSymbol("wrapper");
@@ -303,7 +347,7 @@ void LLVMCodeGenImpl::emitWrapper(const std::vector<llvm::Type*>& params) {
   auto wrapper = llvm::Function::Create(
       llvm::FunctionType::get(IntTy_, {voidPtrPtrTy}, false),
       llvm::Function::ExternalLinkage,
-      "wrapper",
+      kernelName_.empty() ? "wrapper" : kernelName_,
       module_.get());
   auto wrapBB = llvm::BasicBlock::Create(getContext(), "wrapBB", wrapper);
   irb_.SetInsertPoint(wrapBB);
@@ -458,6 +502,75 @@ void LLVMCodeGenImpl::emitKernel(
 #endif
 }
 
+// An object file cannot rely on the JIT to define the functions the kernel
+// calls, and the process loading it need not export them. Instead every call
+// of a function outside of the module goes through a pointer, which the
+// exported <name>_init function fills in with a lookup callback.
+void LLVMCodeGenImpl::emitImportResolver() {
+  std::vector<llvm::Function*> imports;
+  for (llvm::Function& F : *module_) {
+    if (F.isDeclaration() && !F.isIntrinsic()) {
+      imports.push_back(&F);
+    }
+  }
+
+  auto voidTy = llvm::Type::getVoidTy(getContext());
+  auto charPtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto lookupTy = llvm::FunctionType::get(charPtrTy, {charPtrTy}, false);
+  auto init = llvm::Function::Create(
+      llvm::FunctionType::get(voidTy, {lookupTy->getPointerTo()}, false),
+      llvm::Function::ExternalLinkage,
+      kernelName_ + "_init",
+      module_.get());
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", init));
+  for (llvm::Function* F : imports) {
+    auto slot = new llvm::GlobalVariable(
+        *module_,
+        F->getType(),
+        false,
+        llvm::GlobalValue::InternalLinkage,
+        llvm::ConstantPointerNull::get(F->getType()),
+        F->getName() + ".import");
+    auto name = irb_.CreateGlobalStringPtr(F->getName());
+    auto address = irb_.CreateCall(lookupTy, init->arg_begin(), {name});
+    irb_.CreateStore(irb_.CreatePointerCast(address, F->getType()), slot);
+
+    std::vector<llvm::CallInst*> calls;
+    for (llvm::User* user : F->users()) {
+      auto call = llvm::dyn_cast<llvm::CallInst>(user);
+      if (!call || call->getCalledOperand() != F) {
+        throw std::runtime_error(
+            "Unsupported use of external function " + F->getName().str());
+      }
+      calls.push_back(call);
+    }
+    for (llvm::CallInst* call : calls) {
+      llvm::IRBuilder<> callIrb(call);
+      call->setCalledFunction(F->getFunctionType(), callIrb.CreateLoad(slot));
+    }
+  }
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*init, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+}
+
+void LLVMCodeGenImpl::emitObject() {
+  llvm::SmallVector<char, 0> buffer;
+  llvm::raw_svector_ostream stream(buffer);
+  llvm::legacy::PassManager PM;
+#if LLVM_VERSION_MAJOR >= 10
+  auto fileType = llvm::CGFT_ObjectFile;
+#else
+  auto fileType = llvm::TargetMachine::CGFT_ObjectFile;
+#endif
+  if (TM_->addPassesToEmitFile(PM, stream, nullptr, fileType)) {
+    throw std::runtime_error("Target cannot emit object files");
+  }
+  PM.run(*module_);
+  object_.assign(buffer.begin(), buffer.end());
+}
+
 // TODO: The binary ops are copypasta.
 
 void LLVMCodeGenImpl::visit(const Add* v) {
@@ -964,12 +1077,26 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
   v->stop()->accept(this);
   auto stop = this->value_;
 
+  emitLoop(v->var(), start, stop, v->body());
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
+void LLVMCodeGenImpl::emitLoop(
+    const Var* var,
+    llvm::Value* start,
+    llvm::Value* stop,
+    const Block* body_stmt) {
   // Create block for loop condition test.
   auto preheader = irb_.GetInsertBlock();
   auto condBlock = llvm::BasicBlock::Create(getContext(), "cond", fn_);
@@ -979,8 +1106,8 @@ void LLVMCodeGenImpl::visit(const For* v) {
   // Set up phi node for index variable.
   auto idx = irb_.CreatePHI(IntTy_, 2);
   idx->addIncoming(start, preheader);
-  if (!varToVal_.count(v->var())) {
-    varToVal_.emplace(v->var(), idx);
+  if (!varToVal_.count(var)) {
+    varToVal_.emplace(var, idx);
   } else {
     throw std::runtime_error("var should not exist before");
   }
@@ -995,8 +1122,8 @@ void LLVMCodeGenImpl::visit(const For* v) {
 
   // Codegen the body.
   irb_.SetInsertPoint(body);
-  if (v->body()) {
-    v->body()->accept(this);
+  if (body_stmt) {
+    body_stmt->accept(this);
   }
   // "Body" block may have changed if we generated nested control flow.
   body = irb_.GetInsertBlock();
@@ -1009,7 +1136,144 @@ void LLVMCodeGenImpl::visit(const For* v) {
   // Exit the loop.
   irb_.SetInsertPoint(exit);
 
-  varToVal_.erase(v->var());
+  varToVal_.erase(var);
+}
+
+namespace {
+
+// Estimates the number of elements one iteration of a loop computes, from the
+// lanes of its stores and the trip counts of its inner loops.
+class IterationCostEstimator : public IRVisitor {
+ public:
+  static int64_t estimate(const Stmt* s) {
+    IterationCostEstimator estimator;
+    s->accept(&estimator);
+    return std::max<int64_t>(estimator.cost_, 1);
+  }
+
+ private:
+  void visit(const For* v) override {
+    int64_t outer_cost = cost_;
+    cost_ = 0;
+    v->body()->accept(this);
+    const IntImm* start = dynamic_cast<const IntImm*>(v->start());
+    const IntImm* stop = dynamic_cast<const IntImm*>(v->stop());
+    // loops of unknown length are assumed to be long
+    int64_t trips = (start && stop) ? stop->value() - start->value()
+                                    : at::internal::GRAIN_SIZE;
+    cost_ = outer_cost + cost_ * std::max<int64_t>(trips, 0);
+  }
+
+  void visit(const Store* v) override {
+    cost_ += v->value()->dtype().lanes();
+  }
+
+  int64_t cost_ = 0;
+};
+
+} // namespace
+
+// The body of a parallel loop is outlined into a function over a range of
+// iterations, which nnc_parallel_for runs with at::parallel_for. The values it
+// uses from the enclosing function are passed through an array of pointers.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = this->value_;
+  v->stop()->accept(this);
+  auto stop = this->value_;
+
+  auto voidTy = llvm::Type::getVoidTy(getContext());
+  auto voidPtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto voidPtrPtrTy = voidPtrTy->getPointerTo();
+
+  VarFinder finder;
+  v->body()->accept(&finder);
+  std::vector<const Var*> captured;
+  for (const Var* var : finder.vars()) {
+    if (varToArg_.count(var) || varToVal_.count(var)) {
+      captured.push_back(var);
+    }
+  }
+
+  // Allocas go to the entry block, as the loop may be nested in another one.
+  llvm::IRBuilder<> entryIrb(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto closure = entryIrb.CreateAlloca(
+      voidPtrTy,
+      llvm::ConstantInt::get(IntTy_, std::max<size_t>(captured.size(), 1)));
+  std::vector<llvm::Type*> capturedTypes;
+  for (size_t i = 0; i < captured.size(); i++) {
+    captured[i]->accept(this);
+    llvm::Value* val = value_;
+    capturedTypes.push_back(val->getType());
+    if (!val->getType()->isPointerTy()) {
+      auto storage = entryIrb.CreateAlloca(val->getType());
+      irb_.CreateStore(val, storage);
+      val = storage;
+    }
+    irb_.CreateStore(
+        irb_.CreatePointerCast(val, voidPtrTy),
+        irb_.CreateGEP(closure, llvm::ConstantInt::get(IntTy_, i)));
+  }
+
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(
+          voidTy, {LongTy_, LongTy_, voidPtrPtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+
+  // Emit the body function with the captured values bound to its closure.
+  auto savedIP = irb_.saveIP();
+  llvm::Function* savedFn = fn_;
+  std::unordered_map<const Var*, int> savedVarToArg;
+  std::unordered_map<const Var*, llvm::Value*> savedVarToVal;
+  std::swap(varToArg_, savedVarToArg);
+  std::swap(varToVal_, savedVarToVal);
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto args = bodyFn->arg_begin();
+  llvm::Value* begin = irb_.CreateTrunc(&args[0], IntTy_);
+  llvm::Value* end = irb_.CreateTrunc(&args[1], IntTy_);
+  llvm::Value* closureArg = &args[2];
+  for (size_t i = 0; i < captured.size(); i++) {
+    llvm::Value* slot = irb_.CreateLoad(
+        irb_.CreateGEP(closureArg, llvm::ConstantInt::get(IntTy_, i)));
+    llvm::Type* type = capturedTypes[i];
+    if (type->isPointerTy()) {
+      varToVal_[captured[i]] = irb_.CreatePointerCast(slot, type);
+    } else {
+      varToVal_[captured[i]] =
+          irb_.CreateLoad(irb_.CreatePointerCast(slot, type->getPointerTo()));
+    }
+  }
+  emitLoop(v->var(), begin, end, v->body());
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+  fn_ = savedFn;
+  std::swap(varToArg_, savedVarToArg);
+  std::swap(varToVal_, savedVarToVal);
+  irb_.restoreIP(savedIP);
+
+  // Each task should get at least GRAIN_SIZE elements, as in TensorIterator.
+  int64_t grain = std::max<int64_t>(
+      at::internal::GRAIN_SIZE / IterationCostEstimator::estimate(v->body()),
+      1);
+  auto parallelFor = module_->getOrInsertFunction(
+      "nnc_parallel_for",
+      llvm::FunctionType::get(
+          voidTy,
+          {LongTy_, LongTy_, LongTy_, bodyFn->getType(), voidPtrPtrTy},
+          false));
+  irb_.CreateCall(
+      parallelFor,
+      {irb_.CreateSExt(start, LongTy_),
+       irb_.CreateSExt(stop, LongTy_),
+       llvm::ConstantInt::getSigned(LongTy_, grain),
+       bodyFn,
+       closure});
   value_ = llvm::ConstantInt::get(IntTy_, 0);
 }
 
@@ -7,6 +7,7 @@
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_visitor.h>
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -30,6 +31,17 @@ class TORCH_API LLVMCodeGen : public CodeGen {
 
   TORCH_API void call(const std::vector<CallArg>& args) override;
 
+  // Compiles stmt into a relocatable object file for the host CPU instead of
+  // the JIT. The object defines `int name(void** args)`, which takes args as
+  // call() passes them to the JIT'ed kernel, and
+  // `void name_init(void* (*lookup)(const char*))`, which must be called once
+  // before it with a lookup of the names in getNNCExternalFunctions().
+  static std::string compileToObject(
+      Stmt* stmt,
+      const std::vector<BufferArg>& args,
+      const std::string& name,
+      Dtype dtype = kInt);
+
   template <typename T>
   T value() {
     return value<T>(nullptr);
@@ -1258,6 +1258,10 @@ void LoopNest::setGPUThreadIndex(For* f, int thread_index) {
   f->set_gpu_thread_index(thread_index);
 }
 
+void LoopNest::setParallel(For* f) {
+  f->set_parallel();
+}
+
 void LoopNest::setBufferMap(
     For* f,
     const std::unordered_map<std::string, const Buf*>& map) {
@@ -1545,6 +1549,90 @@ void LoopNest::computeAt(Stmt* s, For* f) {
   temp_bufs_.emplace_back(temp_buf);
 }
 
+std::vector<For*> LoopNest::cacheAccesses(const Buf* buf, For* f) {
+  auto loop_bounds_info = inferBounds(f->body());
+  auto it = loop_bounds_info.find(buf);
+  if (it == loop_bounds_info.end()) {
+    return {};
+  }
+
+  // The temp buffer covers all the accesses to buf in the loop
+  std::vector<const Expr*> start;
+  std::vector<const Expr*> stop;
+  for (const TensorAccessBoundsInfo& p : it->second) {
+    if (p.kind == kStore) {
+      throw malformed_input("cacheAccesses attempted on a written buffer", f);
+    }
+    if (start.empty()) {
+      start = p.start;
+      stop = p.stop;
+      continue;
+    }
+    for (size_t i = 0; i < start.size(); i++) {
+      start[i] = IRSimplifier::simplify(new Min(start[i], p.start[i], true));
+      stop[i] = IRSimplifier::simplify(new Max(stop[i], p.stop[i], true));
+    }
+  }
+
+  std::vector<const Expr*> dims;
+  for (size_t i = 0; i < start.size(); i++) {
+    dims.push_back(IRSimplifier::simplify(
+        new Add(new Sub(stop[i], start[i]), new IntImm(1))));
+  }
+  const Buf* temp_buf =
+      new Buf(buf->name_hint() + "_cache", dims, buf->dtype());
+
+  // Rewrite the accesses to buf in the loop with accesses to temp
+  LoopComputeAtRewriter lr(buf, temp_buf, start);
+  std::vector<Stmt*> stmts(f->body()->begin(), f->body()->end());
+  for (Stmt* s : stmts) {
+    Stmt* new_s = s->accept_mutator(&lr);
+    if (new_s != s) {
+      f->body()->replace_stmt(s, new_s);
+    }
+  }
+
+  // Construct the loop nest filling temp. The bounds of the accesses ignore
+  // the conditions they are made under, so elements outside of buf are
+  // skipped.
+  std::vector<const Expr*> temp_indices(dims.size());
+  std::vector<const Expr*> buf_indices(dims.size());
+  for (size_t i = 0; i < dims.size(); i++) {
+    temp_indices[i] = new Var(std::string("idx") + c10::to_string(i), kInt);
+    buf_indices[i] =
+        IRSimplifier::simplify(new Add(temp_indices[i], start[i]));
+  }
+  Stmt* bd = new Store(
+      temp_buf,
+      temp_indices,
+      new Load(buf->dtype(), buf, buf_indices, new IntImm(1)),
+      new IntImm(1));
+  for (size_t i = 0; i < dims.size(); i++) {
+    const Expr* in_bounds = IRSimplifier::simplify(
+        CompareSelect::make(
+            ExprHandle(buf_indices[i]), ExprHandle(buf->dim(i)), kLT)
+            .node());
+    if (!immediateEquals(in_bounds, 1)) {
+      bd = new Cond(in_bounds, bd, nullptr);
+    }
+  }
+  std::vector<For*> loops(dims.size());
+  for (size_t i = dims.size(); i-- > 0;) {
+    loops[i] = new For(
+        dynamic_cast<const Var*>(temp_indices[i]),
+        new IntImm(0),
+        dims[i],
+        bd);
+    bd = loops[i];
+  }
+  f->body()->prepend_stmt(bd);
+
+  // Mark the new temp buffer as requiring an alloc (it will be inserted as a
+  // part of prepareForCodegen).
+  temp_bufs_.emplace_back(temp_buf);
+  return loops;
+}
+
 class SwapReduce : public IRMutator {
  public:
   SwapReduce(const ReduceOp* old_reduce, ReduceOp* new_reduce)
@@ -44,6 +44,7 @@ class TORCH_API LoopNest {
 
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
+  void setParallel(For* f);
   void setBufferMap(
       For* f,
       const std::unordered_map<std::string, const Buf*>& map);
@@ -53,6 +54,13 @@ class TORCH_API LoopNest {
   // computation itself, this transformation inserts Alloc/Free statements for
   // the temporary buffer used in the computation.
   void computeAt(Stmt* s, For* at);
+  // Copy the part of BUF read in the scope of loop F into a temporary buffer
+  // at the start of F, and read it from there instead. When F is bound to a
+  // GPU block index the temporary buffer lives in shared memory, and binding
+  // the returned loops, which fill it one dimension of BUF each from the
+  // outermost, to thread indices lets the threads of a block share the
+  // accesses to global memory. The loops within F are replaced.
+  std::vector<For*> cacheAccesses(const Buf* buf, For* f);
   void rfactor(
       const Expr* f,
       const Var* reduction_var,
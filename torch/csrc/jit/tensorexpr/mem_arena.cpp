@@ -1,5 +1,9 @@
 #include <torch/csrc/jit/tensorexpr/mem_arena.h>
 
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 namespace tensorexpr {
@@ -8,12 +12,79 @@ namespace {
 // Define in an anonymous namespace to hide this symbol from other compilation
 // units
 thread_local KernelArena* current_arena = nullptr;
+
+// Arenas of finished KernelScopes, reset, for the next ones on the thread.
+thread_local std::vector<std::unique_ptr<KernelArena>> free_arenas;
+
+constexpr size_t kMaxFreeArenas = 4;
+constexpr size_t kAlignment = alignof(std::max_align_t);
+// Slabs double in size from the first to the last, so that an arena makes
+// few of them however large its kernel.
+constexpr size_t kFirstSlabSize = 64 * 1024;
+constexpr size_t kLastSlabSize = 4 * 1024 * 1024;
 } // namespace
 
 KernelArena::~KernelArena() {
+  destroyObjects();
+}
+
+void KernelArena::destroyObjects() {
   for (KernelScopedObject* p : kernel_objects_) {
-    delete p;
+    p->~KernelScopedObject();
+  }
+  kernel_objects_.clear();
+}
+
+void KernelArena::reset() {
+  destroyObjects();
+  if (slabs_.size() > 1) {
+    // one slab the size of everything allocated serves as many objects
+    // without growing
+    size_t size = std::min(bytes_reserved_, kLastSlabSize);
+    slabs_.clear();
+    slabs_.emplace_back(new char[size]);
+    last_slab_size_ = size;
+    bytes_reserved_ = size;
+  }
+  if (!slabs_.empty()) {
+    cursor_ = slabs_.back().get();
+    end_ = cursor_ + last_slab_size_;
   }
+  bytes_allocated_ = 0;
+}
+
+KernelArenaStats KernelArena::stats() const {
+  KernelArenaStats stats;
+  stats.objects = kernel_objects_.size();
+  stats.bytesAllocated = bytes_allocated_;
+  stats.bytesReserved = bytes_reserved_;
+  stats.slabs = slabs_.size();
+  return stats;
+}
+
+void* KernelArena::allocate(size_t size) {
+  size = (size + kAlignment - 1) / kAlignment * kAlignment;
+  if (static_cast<size_t>(end_ - cursor_) < size) {
+    size_t slab_size = last_slab_size_ == 0
+        ? kFirstSlabSize
+        : std::min(last_slab_size_ * 2, kLastSlabSize);
+    slab_size = std::max(slab_size, size);
+    slabs_.emplace_back(new char[slab_size]);
+    last_slab_size_ = slab_size;
+    bytes_reserved_ += slab_size;
+    cursor_ = slabs_.back().get();
+    end_ = cursor_ + slab_size;
+  }
+  void* p = cursor_;
+  cursor_ += size;
+  bytes_allocated_ += size;
+  return p;
+}
+
+void* KernelScopedObject::operator new(size_t size) {
+  KernelArena* kernel = KernelArena::GetCurrentKernelArena();
+  TORCH_INTERNAL_ASSERT(kernel, "no KernelScope for tensorexpr objects");
+  return kernel->allocate(size);
 }
 
 KernelScopedObject::KernelScopedObject() {
@@ -31,7 +102,14 @@ KernelArena* KernelArena::GetCurrentKernelArena() {
 
 KernelScope::KernelScope() : owning_(true) {
   old_kernel_arena_ = KernelArena::GetCurrentKernelArena();
-  KernelArena::SetCurrentKernelArena(new KernelArena);
+  KernelArena* arena = nullptr;
+  if (!free_arenas.empty()) {
+    arena = free_arenas.back().release();
+    free_arenas.pop_back();
+  } else {
+    arena = new KernelArena;
+  }
+  KernelArena::SetCurrentKernelArena(arena);
 }
 
 KernelScope::KernelScope(KernelArena* arena_) : owning_(false) {
@@ -41,7 +119,13 @@ KernelScope::KernelScope(KernelArena* arena_) : owning_(false) {
 
 KernelScope::~KernelScope() {
   if (owning_) {
-    delete KernelArena::GetCurrentKernelArena();
+    KernelArena* arena = KernelArena::GetCurrentKernelArena();
+    if (free_arenas.size() < kMaxFreeArenas) {
+      arena->reset();
+      free_arenas.emplace_back(arena);
+    } else {
+      delete arena;
+    }
   }
   KernelArena::SetCurrentKernelArena(old_kernel_arena_);
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace torch {
@@ -8,7 +10,20 @@ namespace tensorexpr {
 
 class KernelScopedObject;
 
+struct KernelArenaStats {
+  // kernel-scoped objects alive in the arena
+  size_t objects = 0;
+  // bytes handed out to them
+  size_t bytesAllocated = 0;
+  // bytes of the slabs the arena holds
+  size_t bytesReserved = 0;
+  size_t slabs = 0;
+};
+
 // An arena that manages all the underlying kernel-scoped objects.
+// Their memory comes from slabs owned by the arena, by bumping a pointer, and
+// is only released with the arena or when it is reset, so that building the
+// IR of a kernel does not cost a malloc and a free per node.
 class KernelArena {
  public:
   static KernelArena* GetCurrentKernelArena();
@@ -16,17 +31,34 @@ class KernelArena {
   TORCH_API KernelArena() {}
   TORCH_API ~KernelArena();
 
+  // Destroys all the objects of the arena. Their memory is kept, in a single
+  // slab, for the objects allocated next.
+  TORCH_API void reset();
+
+  TORCH_API KernelArenaStats stats() const;
+
  private:
   KernelArena(const KernelArena&) = delete;
   KernelArena& operator=(const KernelArena&) = delete;
   friend class KernelScopedObject;
+  void* allocate(size_t size);
+  void destroyObjects();
+
   std::vector<KernelScopedObject*> kernel_objects_; // owned
+  std::vector<std::unique_ptr<char[]>> slabs_;
+  size_t last_slab_size_ = 0;
+  char* cursor_ = nullptr;
+  char* end_ = nullptr;
+  size_t bytes_allocated_ = 0;
+  size_t bytes_reserved_ = 0;
 };
 
 // A RAII convenience wrapper on top of a kernel.
 // It either creates or takes an existing Kernel and sets it as the current
 // Kernel. When this object is destroyed, the previous Kernel is set as current,
 // and the created kernel is freed. If the kernel was passed, it stays alive.
+// Created kernels are reset and kept by the thread for the next scope
+// instead of being freed.
 class KernelScope {
  public:
   TORCH_API KernelScope();
@@ -43,13 +75,18 @@ class KernelScope {
 };
 
 // The base object managed by the Kernel.
-// The object must be created through "new", and when the Kernel is destroyed,
-// All its registered objects are destroyed through "delete".
+// The object must be created through "new", which allocates it in the current
+// Kernel, and when the Kernel is destroyed, all its registered objects are
+// destroyed with it.
 class TORCH_API KernelScopedObject {
  public:
   KernelScopedObject();
   virtual ~KernelScopedObject() = default;
 
+  static void* operator new(size_t size);
+  // The memory is released with the arena.
+  static void operator delete(void*) {}
+
  private:
   KernelScopedObject(const KernelScopedObject&) = delete;
   KernelScopedObject& operator=(const KernelScopedObject&) = delete;
@@ -0,0 +1,188 @@
+#include <torch/csrc/jit/tensorexpr/schedule_cache.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/Fnv1a.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+
+namespace {
+
+bool autotuneFromEnv() {
+  const char* enable_c_str = std::getenv("PYTORCH_TENSOREXPR_AUTOTUNE");
+  return enable_c_str && std::string(enable_c_str) != "0";
+}
+
+std::string stableHash(const std::string& s) {
+  std::ostringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0')
+     << c10::util::fnv1a64(s);
+  return ss.str();
+}
+
+// Each line of the file is a key hash followed by a schedule. Lines are only
+// ever appended, a later line for the same key wins.
+class ScheduleCache {
+ public:
+  ScheduleCache() {
+    const char* path = std::getenv("PYTORCH_TENSOREXPR_SCHEDULE_CACHE");
+    path_ = path ? path : "";
+  }
+
+  void setFile(std::string path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = std::move(path);
+    schedules_.clear();
+    loaded_ = false;
+  }
+
+  std::string file() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return path_;
+  }
+
+  c10::optional<LoopSchedule> lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    auto it = schedules_.find(stableHash(key));
+    if (it == schedules_.end()) {
+      return c10::nullopt;
+    }
+    return it->second;
+  }
+
+  void store(const std::string& key, const LoopSchedule& schedule) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    std::string hash = stableHash(key);
+    schedules_[hash] = schedule;
+    if (path_.empty()) {
+      return;
+    }
+    // a single short write in append mode, so concurrent writers do not
+    // interleave within a line
+    std::ofstream out(path_, std::ios::app);
+    out << hash + " " + schedule.toString() + "\n" << std::flush;
+    if (!out) {
+      TORCH_WARN("failed to store a tensorexpr schedule in ", path_);
+    }
+  }
+
+ private:
+  void load() {
+    if (loaded_) {
+      return;
+    }
+    loaded_ = true;
+    if (path_.empty()) {
+      return;
+    }
+    std::ifstream in(path_);
+    std::string line;
+    while (std::getline(in, line)) {
+      auto space = line.find(' ');
+      if (space == std::string::npos) {
+        continue;
+      }
+      // lines that do not parse, e.g. one cut short by a crash, are skipped
+      if (auto schedule = LoopSchedule::parse(line.substr(space + 1))) {
+        schedules_[line.substr(0, space)] = *schedule;
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::string path_;
+  bool loaded_ = false;
+  std::unordered_map<std::string, LoopSchedule> schedules_;
+};
+
+ScheduleCache& scheduleCache() {
+  static ScheduleCache cache;
+  return cache;
+}
+
+bool isVectorWidth(int width) {
+  return width == 1 || width == 2 || width == 4 || width == 8 || width == 16;
+}
+
+} // namespace
+
+std::string LoopSchedule::toString() const {
+  std::ostringstream ss;
+  ss << bodyVectorWidth << " " << tailVectorWidth << " "
+     << (inlineIntermediates ? 1 : 0);
+  return ss.str();
+}
+
+c10::optional<LoopSchedule> LoopSchedule::parse(const std::string& str) {
+  std::istringstream ss(str);
+  LoopSchedule schedule;
+  int inline_intermediates = 0;
+  if (!(ss >> schedule.bodyVectorWidth >> schedule.tailVectorWidth >>
+        inline_intermediates) ||
+      !isVectorWidth(schedule.bodyVectorWidth) ||
+      (schedule.tailVectorWidth != 0 &&
+       (!isVectorWidth(schedule.tailVectorWidth) ||
+        schedule.tailVectorWidth >= schedule.bodyVectorWidth)) ||
+      (inline_intermediates != 0 && inline_intermediates != 1)) {
+    return c10::nullopt;
+  }
+  schedule.inlineIntermediates = inline_intermediates;
+  return schedule;
+}
+
+const std::vector<LoopSchedule>& candidateSchedules() {
+  static const std::vector<LoopSchedule> candidates = [] {
+    std::vector<LoopSchedule> schedules;
+    for (bool inline_intermediates : {true, false}) {
+      for (int body : {1, 4, 8, 16}) {
+        for (int tail : {0, 4}) {
+          if (tail != 0 && tail >= body) {
+            continue;
+          }
+          LoopSchedule schedule;
+          schedule.bodyVectorWidth = body;
+          schedule.tailVectorWidth = tail;
+          schedule.inlineIntermediates = inline_intermediates;
+          schedules.push_back(schedule);
+        }
+      }
+    }
+    return schedules;
+  }();
+  return candidates;
+}
+
+bool& getTEAutotune() {
+  static bool autotune = autotuneFromEnv();
+  return autotune;
+}
+
+void setTEScheduleCacheFile(std::string path) {
+  scheduleCache().setFile(std::move(path));
+}
+
+std::string getTEScheduleCacheFile() {
+  return scheduleCache().file();
+}
+
+c10::optional<LoopSchedule> lookupSchedule(const std::string& key) {
+  return scheduleCache().lookup(key);
+}
+
+void storeSchedule(const std::string& key, const LoopSchedule& schedule) {
+  scheduleCache().store(key, schedule);
+}
+
+} // namespace tensorexpr
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+
+// The tunable parameters of the loop schedule TensorExprKernel applies on
+// CPU. The defaults are the fixed schedule used when nothing is tuned.
+struct TORCH_API LoopSchedule {
+  // Inner loops are split by this factor and the body vectorized, 1 leaves
+  // them scalar.
+  int bodyVectorWidth = 8;
+  // The remainder of the split is split again and vectorized by this factor,
+  // 0 leaves it scalar.
+  int tailVectorWidth = 4;
+  // Whether intermediate tensors are computed inline or into temporary
+  // buffers.
+  bool inlineIntermediates = true;
+
+  bool operator==(const LoopSchedule& other) const {
+    return bodyVectorWidth == other.bodyVectorWidth &&
+        tailVectorWidth == other.tailVectorWidth &&
+        inlineIntermediates == other.inlineIntermediates;
+  }
+  bool operator!=(const LoopSchedule& other) const {
+    return !(*this == other);
+  }
+
+  std::string toString() const;
+  static c10::optional<LoopSchedule> parse(const std::string& str);
+};
+
+// The schedules the autotuner times for each kernel.
+TORCH_API const std::vector<LoopSchedule>& candidateSchedules();
+
+// When set, kernels without a cached schedule time every candidate schedule
+// on their first compilation and keep the fastest one. Defaults to the
+// PYTORCH_TENSOREXPR_AUTOTUNE environment variable.
+TORCH_API bool& getTEAutotune();
+
+// Tuned schedules are kept in memory and, if a cache file is set, appended
+// to it, so that other processes reuse them without tuning again. Defaults
+// to the PYTORCH_TENSOREXPR_SCHEDULE_CACHE environment variable; an empty
+// path disables the file. Setting the file reloads the cache from it.
+TORCH_API void setTEScheduleCacheFile(std::string path);
+TORCH_API std::string getTEScheduleCacheFile();
+
+// Keys identify a kernel: its canonical graph, with the complete input types,
+// and the backend. As any schedule computes the same result, a key collision
+// can only cost performance.
+TORCH_API c10::optional<LoopSchedule> lookupSchedule(const std::string& key);
+TORCH_API void storeSchedule(
+    const std::string& key,
+    const LoopSchedule& schedule);
+
+} // namespace tensorexpr
+} // namespace jit
+} // namespace torch
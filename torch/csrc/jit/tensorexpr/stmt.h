@@ -529,12 +529,28 @@ class TORCH_API LoopOptions {
     gpu_thread_index_ = index;
   }
 
+  // Whether the iterations of the loop can run in parallel on CPU. This is
+  // only a hint: backends without threading ignore it, and loops with a
+  // single iteration can still be simplified away.
+  bool is_parallel() const {
+    return is_parallel_;
+  }
+
+  void set_parallel() {
+    if (is_gpu_block_index() || is_gpu_thread_index()) {
+      throw std::runtime_error("Cannot parallelize a gpu block or thread loop");
+    }
+    is_parallel_ = true;
+  }
+
   std::string ToString() const {
     std::ostringstream oss;
     if (is_gpu_block_index()) {
       oss << gpu_block_index_str();
     } else if (is_gpu_thread_index()) {
       oss << gpu_thread_index_str();
+    } else if (is_parallel()) {
+      oss << "parallel";
     }
     return oss.str();
   }
@@ -555,6 +571,7 @@ class TORCH_API LoopOptions {
  private:
   int gpu_block_index_{IDX_UNSET};
   int gpu_thread_index_{IDX_UNSET};
+  bool is_parallel_{false};
   std::unordered_map<std::string, const Buf*> map_input_to_tensor_bufs_;
 };
 
@@ -649,6 +666,10 @@ class TORCH_API For : public StmtNode<For> {
     loop_options_.set_gpu_thread_index(thread_index);
   }
 
+  void set_parallel() {
+    loop_options_.set_parallel();
+  }
+
   void set_buffer_map(const std::unordered_map<std::string, const Buf*>& map) {
     loop_options_.set_buffer_mapping(map);
   }
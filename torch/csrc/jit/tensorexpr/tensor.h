@@ -12,7 +12,7 @@ namespace torch {
 namespace jit {
 namespace tensorexpr {
 
-class Tensor : KernelScopedObject {
+class Tensor : public KernelScopedObject {
  public:
   Function* function() const {
     return function_;
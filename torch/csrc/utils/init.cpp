@@ -17,11 +17,22 @@ void initThroughputBenchmarkBindings(PyObject* module) {
       .def_readwrite("num_worker_threads", &BenchmarkConfig::num_worker_threads)
       .def_readwrite("num_warmup_iters", &BenchmarkConfig::num_warmup_iters)
       .def_readwrite("num_iters", &BenchmarkConfig::num_iters)
+      .def_readwrite("arrival_rate", &BenchmarkConfig::arrival_rate)
       .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path);
 
   py::class_<BenchmarkExecutionStats>(m, "BenchmarkExecutionStats")
       .def_readonly("latency_avg_ms", &BenchmarkExecutionStats::latency_avg_ms)
-      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters);
+      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters)
+      .def_readonly("latency_p50_ms", &BenchmarkExecutionStats::latency_p50_ms)
+      .def_readonly("latency_p90_ms", &BenchmarkExecutionStats::latency_p90_ms)
+      .def_readonly("latency_p99_ms", &BenchmarkExecutionStats::latency_p99_ms)
+      .def_readonly(
+          "latency_p999_ms", &BenchmarkExecutionStats::latency_p999_ms)
+      .def_readonly(
+          "queueing_avg_ms", &BenchmarkExecutionStats::queueing_avg_ms)
+      .def_readonly("wall_time_s", &BenchmarkExecutionStats::wall_time_s)
+      .def_readonly(
+          "thread_cpu_time_s", &BenchmarkExecutionStats::thread_cpu_time_s);
 
   py::class_<ThroughputBenchmark>(m, "ThroughputBenchmark", py::dynamic_attr())
       .def(py::init<jit::Module>())
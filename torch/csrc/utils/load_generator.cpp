@@ -0,0 +1,304 @@
+#include <torch/csrc/utils/load_generator.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace torch {
+namespace throughput_benchmark {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double toMilliseconds(Clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+double threadCpuTimeSeconds() {
+#ifdef _WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(
+          GetCurrentThread(),
+          &creation_time,
+          &exit_time,
+          &kernel_time,
+          &user_time)) {
+    return 0;
+  }
+  // in units of 100ns
+  const auto ticks = [](const FILETIME& t) {
+    return (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+  };
+  return (ticks(kernel_time) + ticks(user_time)) * 1e-7;
+#else
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return 0;
+  }
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Nearest-rank percentile of sorted values.
+double percentile(const std::vector<double>& sorted, double p) {
+  const auto rank =
+      static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+uint64_t pickSeed(uint64_t seed) {
+  return seed != 0 ? seed : std::random_device{}();
+}
+
+// Picks the inputs of the requests of each calling thread at random.
+class InputSampler {
+ public:
+  InputSampler(const LoadConfig& config, size_t num_inputs)
+      : num_inputs_(num_inputs) {
+    TORCH_CHECK(num_inputs > 0, "Please provide benchmark inputs.");
+    const uint64_t seed = pickSeed(config.seed);
+    for (int thread_id = 0; thread_id < config.num_calling_threads;
+         ++thread_id) {
+      engines_.emplace_back(seed + thread_id + 1);
+    }
+  }
+
+  size_t next(int thread_id) {
+    std::uniform_int_distribution<size_t> dist(0, num_inputs_ - 1);
+    return dist(engines_[thread_id]);
+  }
+
+ private:
+  const size_t num_inputs_;
+  std::vector<std::mt19937_64> engines_;
+};
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, const LoadStats& value) {
+  os << "Average latency / iter (ms): " << value.latency_avg_ms
+     << "\n Latency p50 / p90 / p99 / p99.9 / max (ms): "
+     << value.latency_p50_ms << " / " << value.latency_p90_ms << " / "
+     << value.latency_p99_ms << " / " << value.latency_p999_ms << " / "
+     << value.latency_max_ms
+     << "\n Average queueing / iter (ms): " << value.queueing_avg_ms
+     << "\n Total number of iters: " << value.num_iters
+     << "\n Iters per second: " << value.iters_per_second
+     << "\n CPU time per calling thread (s):";
+  for (const double cpu_time : value.thread_cpu_time_s) {
+    os << " " << cpu_time;
+  }
+  return os;
+}
+
+LoadStats runLoad(
+    const LoadConfig& config,
+    const std::function<void(int thread_id)>& run_once,
+    const std::function<void()>& on_measure_begin,
+    const std::function<void()>& on_measure_end) {
+  TORCH_CHECK(
+      config.num_calling_threads > 0,
+      "num_calling_threads must be positive, got ",
+      config.num_calling_threads);
+  TORCH_CHECK(
+      config.num_iters > 0, "num_iters must be positive, got ", config.num_iters);
+  TORCH_CHECK(
+      config.arrival_rate >= 0,
+      "arrival_rate must not be negative, got ",
+      config.arrival_rate);
+  const bool open_loop = config.arrival_rate > 0;
+
+  // Arrival times of the measured requests, from the start of the
+  // measurement. They are drawn upfront so that drawing them does not add to
+  // the latencies.
+  std::vector<Clock::duration> arrivals;
+  if (open_loop) {
+    std::mt19937_64 engine(pickSeed(config.seed));
+    std::exponential_distribution<double> interarrival(config.arrival_rate);
+    arrivals.reserve(config.num_iters);
+    double arrival_s = 0;
+    for (int64_t i = 0; i < config.num_iters; ++i) {
+      arrivals.push_back(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(arrival_s)));
+      arrival_s += interarrival(engine);
+    }
+  }
+
+  // Every request is measured by the one thread that served it.
+  std::vector<double> latencies_ms(config.num_iters);
+  std::vector<double> queueing_ms(config.num_iters);
+  std::vector<double> thread_cpu_time_s(config.num_calling_threads);
+  std::vector<Clock::time_point> last_completion(config.num_calling_threads);
+
+  std::mutex m;
+  std::condition_variable worker_main_cv;
+  std::condition_variable main_worker_cv;
+  // TODO: add GUARDED_BY once it is available
+  int initialized{0};
+  int finished{0};
+  bool start{false};
+  Clock::time_point start_time;
+  std::exception_ptr error;
+  std::atomic<int64_t> next_iter{0};
+
+  const auto record_error = [&]() {
+    std::lock_guard<std::mutex> lock(m);
+    if (!error) {
+      error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> callers;
+  for (int thread_id = 0; thread_id < config.num_calling_threads;
+       ++thread_id) {
+    callers.emplace_back([&, thread_id]() {
+      bool failed = false;
+      try {
+        for (int j = 0; j < config.num_warmup_iters; ++j) {
+          run_once(thread_id);
+        }
+      } catch (...) {
+        record_error();
+        failed = true;
+      }
+      // wait for all the threads to warm up before measuring
+      {
+        std::unique_lock<std::mutex> lock(m);
+        ++initialized;
+        worker_main_cv.notify_one();
+        main_worker_cv.wait(lock, [&]() { return start; });
+      }
+      const double cpu_time_begin = threadCpuTimeSeconds();
+      if (!failed) {
+        try {
+          for (int64_t i = next_iter.fetch_add(1); i < config.num_iters;
+               i = next_iter.fetch_add(1)) {
+            Clock::time_point arrival = Clock::now();
+            if (open_loop) {
+              arrival = start_time + arrivals[i];
+              std::this_thread::sleep_until(arrival);
+            }
+            const Clock::time_point begin = Clock::now();
+            run_once(thread_id);
+            const Clock::time_point end = Clock::now();
+            latencies_ms[i] = toMilliseconds(end - arrival);
+            queueing_ms[i] = toMilliseconds(begin - arrival);
+            last_completion[thread_id] = end;
+          }
+        } catch (...) {
+          record_error();
+          // stop the other threads
+          next_iter = config.num_iters;
+        }
+      }
+      thread_cpu_time_s[thread_id] = threadCpuTimeSeconds() - cpu_time_begin;
+      {
+        std::lock_guard<std::mutex> lock(m);
+        ++finished;
+        worker_main_cv.notify_one();
+      }
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m);
+    worker_main_cv.wait(
+        lock, [&]() { return initialized == config.num_calling_threads; });
+    if (on_measure_begin) {
+      on_measure_begin();
+    }
+    start = true;
+    start_time = Clock::now();
+  }
+  main_worker_cv.notify_all();
+  {
+    std::unique_lock<std::mutex> lock(m);
+    worker_main_cv.wait(
+        lock, [&]() { return finished == config.num_calling_threads; });
+  }
+  if (on_measure_end) {
+    on_measure_end();
+  }
+  for (auto& t : callers) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  LoadStats stats;
+  stats.num_iters = config.num_iters;
+  stats.thread_cpu_time_s = std::move(thread_cpu_time_s);
+  const Clock::time_point end_time =
+      *std::max_element(last_completion.begin(), last_completion.end());
+  stats.wall_time_s = toMilliseconds(end_time - start_time) / 1000.0;
+  stats.iters_per_second = stats.num_iters / stats.wall_time_s;
+
+  double latency_sum_ms = 0;
+  double queueing_sum_ms = 0;
+  for (int64_t i = 0; i < config.num_iters; ++i) {
+    latency_sum_ms += latencies_ms[i];
+    queueing_sum_ms += queueing_ms[i];
+  }
+  stats.latency_avg_ms = latency_sum_ms / config.num_iters;
+  stats.queueing_avg_ms = queueing_sum_ms / config.num_iters;
+
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  stats.latency_p50_ms = percentile(latencies_ms, 50);
+  stats.latency_p90_ms = percentile(latencies_ms, 90);
+  stats.latency_p99_ms = percentile(latencies_ms, 99);
+  stats.latency_p999_ms = percentile(latencies_ms, 99.9);
+  stats.latency_max_ms = latencies_ms.back();
+  return stats;
+}
+
+LoadStats benchmarkModule(
+    const jit::Module& module,
+    const std::vector<std::vector<c10::IValue>>& inputs,
+    const LoadConfig& config) {
+  InputSampler sampler(config, inputs.size());
+  auto& function = module.get_method("forward").function();
+  // the stacks forward is called with, including self
+  std::vector<jit::Stack> stacks;
+  for (const auto& input : inputs) {
+    jit::Stack stack{module._ivalue()};
+    stack.insert(stack.end(), input.begin(), input.end());
+    stacks.push_back(std::move(stack));
+  }
+  return runLoad(config, [&](int thread_id) {
+    function(stacks[sampler.next(thread_id)]);
+  });
+}
+
+LoadStats benchmarkStaticModule(
+    std::shared_ptr<const jit::StaticModule> module,
+    const std::vector<std::vector<c10::IValue>>& inputs,
+    const LoadConfig& config) {
+  InputSampler sampler(config, inputs.size());
+  std::vector<std::unique_ptr<jit::StaticRuntime>> runtimes;
+  for (int thread_id = 0; thread_id < config.num_calling_threads;
+       ++thread_id) {
+    runtimes.push_back(std::make_unique<jit::StaticRuntime>(module));
+  }
+  return runLoad(config, [&](int thread_id) {
+    runtimes[thread_id]->run(inputs[sampler.next(thread_id)], {});
+  });
+}
+
+} // namespace throughput_benchmark
+} // namespace torch
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace throughput_benchmark {
+
+/**
+ * Configures a run of the load generator. Unlike BenchmarkConfig this has no
+ * Python-specific settings, so that models can be benchmarked from C++ only.
+ */
+struct LoadConfig {
+  // Threads calling into the model in parallel, i.e. the number of requests
+  // being served at once.
+  int num_calling_threads{1};
+  // Requests each calling thread runs before the measurement starts, to warm
+  // up caches, allocators and lazily initialized state.
+  int num_warmup_iters{1};
+  // Requests measured, shared by all the calling threads.
+  int64_t num_iters{100};
+  // 0 runs in closed loop: every calling thread issues its next request as
+  // soon as its previous one completes, so the load adapts to the model.
+  // A positive rate runs in open loop: requests arrive as a Poisson process
+  // with this mean number of requests per second, independent of how fast
+  // they complete. A request waits until a calling thread is free, and its
+  // latency includes that wait, as it would for a server at this load.
+  double arrival_rate{0};
+  // Seeds the arrival times and the choice of inputs; 0 picks a random seed.
+  uint64_t seed{0};
+};
+
+struct LoadStats {
+  int64_t num_iters{0};
+  // Latency of the measured requests, from arrival to completion.
+  double latency_avg_ms{-1};
+  double latency_p50_ms{-1};
+  double latency_p90_ms{-1};
+  double latency_p99_ms{-1};
+  double latency_p999_ms{-1};
+  double latency_max_ms{-1};
+  // Mean time requests waited for a calling thread, open loop only.
+  double queueing_avg_ms{0};
+  // From the arrival of the first measured request to the completion of
+  // the last one.
+  double wall_time_s{0};
+  double iters_per_second{0};
+  // CPU time each calling thread spent in the measured phase. Intra-op
+  // threads the model uses are not accounted for.
+  std::vector<double> thread_cpu_time_s;
+};
+
+TORCH_API std::ostream& operator<<(std::ostream& os, const LoadStats& value);
+
+/**
+ * Runs `run_once(thread_id)` from `config.num_calling_threads` threads,
+ * `num_warmup_iters` times per thread and then for `num_iters` measured
+ * requests overall, and returns the statistics of the measured requests.
+ * `on_measure_begin` and `on_measure_end` are called on the calling thread
+ * of runLoad around the measured phase, e.g. to profile only that phase.
+ *
+ * run_once may be called concurrently for different thread ids, never for
+ * the same one.
+ */
+TORCH_API LoadStats runLoad(
+    const LoadConfig& config,
+    const std::function<void(int thread_id)>& run_once,
+    const std::function<void()>& on_measure_begin = nullptr,
+    const std::function<void()>& on_measure_end = nullptr);
+
+/**
+ * Benchmarks the forward method of `module` on inputs picked at random from
+ * `inputs`, each of which holds the positional arguments of forward.
+ */
+TORCH_API LoadStats benchmarkModule(
+    const jit::Module& module,
+    const std::vector<std::vector<c10::IValue>>& inputs,
+    const LoadConfig& config);
+
+/**
+ * Same as benchmarkModule for the Static Runtime, with a StaticRuntime of
+ * `module` per calling thread.
+ */
+TORCH_API LoadStats benchmarkStaticModule(
+    std::shared_ptr<const jit::StaticModule> module,
+    const std::vector<std::vector<c10::IValue>>& inputs,
+    const LoadConfig& config);
+
+} // namespace throughput_benchmark
+} // namespace torch
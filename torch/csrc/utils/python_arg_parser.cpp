@@ -717,8 +717,36 @@ static void extra_kwargs(FunctionSignature& signature, PyObject* kwargs, ssize_t
   throw TypeError("invalid keyword arguments");
 }
 
+// Whether param.check() fails for all the objects of the type of obj, given
+// that it failed for obj.
+static bool check_fails_on_type(const FunctionParameter& param, PyObject* obj, bool allow_varargs_intlist) {
+  if (THPVariable_Check(obj)) {
+    switch (param.type_) {
+      // zero-dim tensors bind to numbers
+      case ParameterType::SCALAR:
+      case ParameterType::COMPLEX:
+      case ParameterType::DOUBLE:
+      case ParameterType::INT64:
+        return false;
+      default:
+        // zero-dim integral tensors bind to a var-args IntArrayRef
+        return !allow_varargs_intlist;
+    }
+  }
+  // The attributes of heap types, e.g. __torch_function__ or __index__, may
+  // change.
+  if (PyType_HasFeature(Py_TYPE(obj), Py_TPFLAGS_HEAPTYPE)) {
+    return false;
+  }
+  // these depend on the elements
+  if (param.type_ == ParameterType::DIMNAME_LIST) {
+    return !PyTuple_Check(obj) && !PyList_Check(obj);
+  }
+  return true;
+}
+
 bool FunctionSignature::parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* dst[],  // NOLINT
-                              bool raise_exception) {
+                              bool raise_exception, bool* failed_on_types) {
   auto nargs = args ? PyTuple_GET_SIZE(args) : 0;
   ssize_t remaining_kwargs = kwargs ? PyDict_Size(kwargs) : 0;
   ssize_t arg_pos = 0;
@@ -730,6 +758,10 @@ bool FunctionSignature::parse(PyObject* self, PyObject* args, PyObject* kwargs,
     allow_varargs_intlist = true;
   }
 
+  if (failed_on_types) {
+    *failed_on_types = true;
+  }
+
   if (nargs > max_pos_args && !allow_varargs_intlist) {
     if (raise_exception) {
       // foo() takes takes 2 positional arguments but 3 were given
@@ -802,6 +834,9 @@ bool FunctionSignature::parse(PyObject* self, PyObject* args, PyObject* kwargs,
             param.type_name().c_str(), Py_TYPE(obj)->tp_name);
       }
     } else {
+      if (failed_on_types) {
+        *failed_on_types = check_fails_on_type(param, obj, allow_varargs_intlist && arg_pos == 0);
+      }
       return false;
     }
 
@@ -826,6 +861,8 @@ PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
  : max_args(0)
  , traceable(traceable)
 {
+  // find_overload_cache_entry() hands out pointers into it
+  overload_cache_.reserve(kMaxCacheEntries);
   int index = 0;
   for (auto& fmt : fmts) {
     signatures_.emplace_back(fmt, index);
@@ -865,6 +902,61 @@ void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
   }
 }
 
+// Note [Overload cache]
+// ~~~~~~~~~~~~~~~~~~~~~
+// Functions like add, index or to have many overloads, and each call tries
+// them in order until one binds (see Note [Order of overloads matters]).
+// Most of the signatures tried before the one that binds fail because of the
+// number or the types of the arguments, which are the same at a given call
+// site from one call to the next.
+//
+// So for calls without keyword arguments, the parser remembers, for the
+// types of the positional arguments, which signatures failed in a way that
+// only depends on these types (see check_fails_on_type), and does not try
+// them again. The other signatures are still tried in order, so that the
+// same overload binds as without the cache, and the arguments are still
+// checked, since e.g. whether a zero-dim tensor binds to a number depends
+// on the tensor.
+//
+// The cache holds a reference to the types, so that their addresses are not
+// reused by other types. It is bounded per parser, and only updated with
+// the GIL held, like the rest of the parser state.
+auto PythonArgParser::find_overload_cache_entry(PyObject* args) -> OverloadCacheEntry* {
+  const auto nargs = args ? PyTuple_GET_SIZE(args) : 0;
+  if (nargs > kMaxCachedArgs || signatures_.size() > 64) {
+    return nullptr;
+  }
+  const bool torch_function = torch_function_enabled();
+  for (auto& entry : overload_cache_) {
+    if (entry.nargs != nargs || entry.torch_function_enabled != torch_function) {
+      continue;
+    }
+    bool same_types = true;
+    for (ssize_t i = 0; i < nargs; i++) {
+      if (entry.types[i] != Py_TYPE(PyTuple_GET_ITEM(args, i))) {
+        same_types = false;
+        break;
+      }
+    }
+    if (same_types) {
+      return &entry;
+    }
+  }
+  if (overload_cache_.size() == kMaxCacheEntries) {
+    return nullptr;
+  }
+  OverloadCacheEntry entry;
+  entry.nargs = nargs;
+  entry.torch_function_enabled = torch_function;
+  entry.skip = 0;
+  for (ssize_t i = 0; i < nargs; i++) {
+    entry.types[i] = Py_TYPE(PyTuple_GET_ITEM(args, i));
+    Py_INCREF(entry.types[i]);
+  }
+  overload_cache_.push_back(entry);
+  return &overload_cache_.back();
+}
+
 PythonArgs PythonArgParser::raw_parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {  // NOLINT
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
@@ -873,11 +965,23 @@ PythonArgs PythonArgParser::raw_parse(PyObject* self, PyObject* args, PyObject*
     return PythonArgs(traceable, signature, parsed_args);
   }
 
-  for (auto& signature : signatures_) {
-    if (signature.parse(self, args, kwargs, parsed_args, false)) {
+  OverloadCacheEntry* cache_entry = nullptr;
+  if (!kwargs || PyDict_Size(kwargs) == 0) {
+    cache_entry = find_overload_cache_entry(args);
+  }
+  for (size_t i = 0; i < signatures_.size(); i++) {
+    auto& signature = signatures_[i];
+    if (cache_entry && (cache_entry->skip & (uint64_t(1) << i))) {
+      continue;
+    }
+    bool failed_on_types = false;
+    if (signature.parse(self, args, kwargs, parsed_args, false, cache_entry ? &failed_on_types : nullptr)) {
       check_deprecated(signature);
       return PythonArgs(traceable, signature, parsed_args);
     }
+    if (failed_on_types) {
+      cache_entry->skip |= uint64_t(1) << i;
+    }
   }
 
   print_error(self, args, kwargs, parsed_args);
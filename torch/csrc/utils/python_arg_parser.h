@@ -114,7 +114,20 @@ private:
   void check_deprecated(const FunctionSignature & signature);
   PythonArgs raw_parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
+  // See Note [Overload cache]
+  static constexpr int kMaxCachedArgs = 8;
+  static constexpr size_t kMaxCacheEntries = 8;
+  struct OverloadCacheEntry {
+    std::array<PyTypeObject*, kMaxCachedArgs> types;
+    ssize_t nargs;
+    bool torch_function_enabled;
+    // bit i is set if signatures_[i] cannot match
+    uint64_t skip;
+  };
+  OverloadCacheEntry* find_overload_cache_entry(PyObject* args);
+
   std::vector<FunctionSignature> signatures_;
+  std::vector<OverloadCacheEntry> overload_cache_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
@@ -123,7 +136,11 @@ private:
 struct PYBIND11_EXPORT FunctionSignature {
   explicit FunctionSignature(const std::string& fmt, int index);
 
-  bool parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* dst[], bool raise_exception);
+  // For a call without keyword arguments, if parsing fails and
+  // failed_on_types is given, it is set to whether all the calls with
+  // positional arguments of the same types fail too.
+  bool parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* dst[], bool raise_exception,
+             bool* failed_on_types = nullptr);
 
   std::string toString() const;
 
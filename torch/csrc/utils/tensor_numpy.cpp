@@ -26,13 +26,20 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils/python_numbers.h>
 
 #include <ATen/ATen.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 
+#ifdef USE_CUDA
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#endif
+
 using namespace at;
 using namespace torch::autograd;
 
@@ -250,6 +257,37 @@ bool is_numpy_scalar(PyObject* obj) {
   return is_numpy_int(obj) || PyArray_IsScalar(obj, Floating);
 }
 
+// The producer may still be writing the data on `stream`: the work queued on
+// the current stream of `device` after this call waits for it. Unlike a
+// synchronization of the host, this does not stall the producer nor the
+// consumer.
+static void wait_for_cuda_array_interface_stream(at::Device device, void* stream) {
+#ifdef USE_CUDA
+  cudaStream_t producer_stream;
+  if (stream == reinterpret_cast<void*>(1)) {
+    producer_stream = cudaStreamLegacy;
+  } else if (stream == reinterpret_cast<void*>(2)) {
+    producer_stream = cudaStreamPerThread;
+  } else {
+    producer_stream = static_cast<cudaStream_t>(stream);
+  }
+  c10::cuda::CUDAGuard device_guard(device);
+  cudaStream_t consumer_stream = at::cuda::getCurrentCUDAStream(device.index()).stream();
+  // the default stream of PyTorch is the legacy default stream
+  if (producer_stream == consumer_stream ||
+      (producer_stream == cudaStreamLegacy && consumer_stream == nullptr)) {
+    return;
+  }
+  cudaEvent_t event;
+  C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  C10_CUDA_CHECK(cudaEventRecord(event, producer_stream));
+  C10_CUDA_CHECK(cudaStreamWaitEvent(consumer_stream, event, 0));
+  C10_CUDA_CHECK(cudaEventDestroy(event));
+#else
+  TORCH_CHECK(false, "PyTorch was compiled without CUDA support");
+#endif
+}
+
 at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
   auto cuda_dict = THPObjectPtr(PyObject_GetAttrString(obj, "__cuda_array_interface__"));
   TORCH_INTERNAL_ASSERT(cuda_dict);
@@ -304,7 +342,11 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
       throw python_error();
     }
     if (read_only) {
-      throw TypeError("the read only flag is not supported, should always be False");
+      TORCH_WARN_ONCE(
+        "The given __cuda_array_interface__ is read-only, and PyTorch does "
+        "not support non-writeable tensors. This means you can write to the "
+        "underlying (supposedly non-writeable) array using the tensor. "
+        "This type of warning will be suppressed for the rest of this program.");
     }
   }
 
@@ -332,6 +374,32 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
     }
   }
 
+  // The memory may be on another device than the current one. Empty arrays
+  // may have a null pointer.
+  at::Device device = data_ptr
+      ? at::detail::getCUDAHooks().getDeviceFromPtr(data_ptr)
+      : at::Device(kCUDA, static_cast<c10::DeviceIndex>(at::detail::getCUDAHooks().current_device()));
+
+  // Extract the `obj.__cuda_array_interface__['stream']` attribute, which
+  // version 3 of the protocol added.
+  {
+    PyObject *py_stream = PyDict_GetItemString(cuda_dict, "stream");
+    if (py_stream != nullptr && py_stream != Py_None) {
+      if (!THPUtils_checkLong(py_stream)) {
+        throw TypeError("`stream` must be an int or None");
+      }
+      void* stream = PyLong_AsVoidPtr(py_stream);
+      if (stream == nullptr) {
+        if (PyErr_Occurred()) {
+          throw python_error();
+        }
+        throw ValueError("`stream` 0 is ambiguous, it must be 1 for the legacy default stream "
+            "or 2 for the per-thread default stream");
+      }
+      wait_for_cuda_array_interface_stream(device, stream);
+    }
+  }
+
   Py_INCREF(obj);
   return at::from_blob(
       data_ptr,
@@ -341,7 +409,7 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
         pybind11::gil_scoped_acquire gil;
         Py_DECREF(obj);
       },
-      at::device(kCUDA).dtype(dtype)
+      at::device(device).dtype(dtype)
   );
 }
 }} // namespace torch::utils
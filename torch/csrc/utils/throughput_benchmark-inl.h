@@ -48,96 +48,41 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     }
   }
 
-  std::mutex m;
-  std::condition_variable worker_main_cv;
-  std::condition_variable main_worker_cv;
-  // TODO: add GUARDED_BY once it is available
-  int64_t initialized{0};
-  int64_t finished{0};
-  bool start{false};
-  std::atomic<int64_t> num_attempted_iters{0};
-  std::vector<std::thread> callers;
+  LoadConfig load_config;
+  load_config.num_calling_threads = config.num_calling_threads;
+  load_config.num_warmup_iters = config.num_warmup_iters;
+  load_config.num_iters = config.num_iters;
+  load_config.arrival_rate = config.arrival_rate;
 
-  for (auto thread_id = 0; thread_id < config.num_calling_threads;
-       ++thread_id) {
-    callers.emplace_back([&, thread_id]() {
-      // We use conditional variable as a barrier to make sure each thread
-      // performs required warmeup iterations before we start measuring
-      for (auto j = 0; j < config.num_warmup_iters; ++j) {
+  std::unique_ptr<torch::autograd::profiler::RecordProfile> profiler_guard;
+  LoadStats load_stats = runLoad(
+      load_config,
+      [&](int thread_id) {
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
         ++input_iters[thread_id];
-      }
-      {
-        std::unique_lock<std::mutex> lock(m);
-        ++initialized;
-        worker_main_cv.notify_one();
-        while (!start) {
-          main_worker_cv.wait(lock);
+      },
+      [&]() {
+        if (!config.profiler_output_path.empty()) {
+          LOG(INFO) << "Using Autograd profiler. Trace will be saved to "
+                    << config.profiler_output_path;
+          profiler_guard.reset(new torch::autograd::profiler::RecordProfile(
+              config.profiler_output_path));
         }
-      }
-      LOG(INFO) << "Starting forward thread " << thread_id;
-      while (num_attempted_iters.fetch_add(1) < config.num_iters) {
-        runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
-        ++input_iters[thread_id];
-      }
-
-      {
-        std::unique_lock<std::mutex> lock(m);
-        ++finished;
-        worker_main_cv.notify_one();
-        LOG(INFO) << "Shutting down forward thread " << thread_id
-                  << ". Total number of finished threads: " << finished;
-      }
-
-    });
-  }
-
-  using Clock = std::chrono::high_resolution_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
-  TimePoint start_time;
-
-  std::unique_ptr<torch::autograd::profiler::RecordProfile> profiler_guard;
-  {
-    std::unique_lock<std::mutex> lock(m);
-    while (initialized != config.num_calling_threads) {
-      worker_main_cv.wait(lock);
-    }
-    if (!config.profiler_output_path.empty()) {
-      LOG(INFO) << "Using Autograd profiler. Trace will be saved to "
-                << config.profiler_output_path;
-      profiler_guard.reset(new torch::autograd::profiler::RecordProfile(
-        config.profiler_output_path));
-    }
-    LOG(INFO) << "Starting threads";
-    start = true;
-    start_time = Clock::now();
-  }
-
-  main_worker_cv.notify_all();
-  {
-    std::unique_lock<std::mutex> lock(m);
-    worker_main_cv.wait(
-        lock, [&]() { return finished == config.num_calling_threads; });
-  }
-  auto end_time = std::chrono::high_resolution_clock::now();
-  profiler_guard.reset();
+        LOG(INFO) << "Starting threads";
+      },
+      [&]() { profiler_guard.reset(); });
   LOG(INFO) << "Finished benchmark";
 
   BenchmarkExecutionStats stats;
-  float total_time_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                            end_time - start_time)
-                            .count() /
-      1000.0 / 1000.0;
-  // We use config.num_iters instead of num_attempted_iters as it is
-  // repsesatative of the real work done. Last attempted iteration on each
-  // calling threads doesn't represent the real work (i.e. running the model)
-  stats.latency_avg_ms =
-      total_time_ms * config.num_calling_threads / config.num_iters;
-  stats.num_iters = config.num_iters;
-
-  for (auto& t : callers) {
-    t.join();
-  }
+  stats.latency_avg_ms = load_stats.latency_avg_ms;
+  stats.num_iters = load_stats.num_iters;
+  stats.latency_p50_ms = load_stats.latency_p50_ms;
+  stats.latency_p90_ms = load_stats.latency_p90_ms;
+  stats.latency_p99_ms = load_stats.latency_p99_ms;
+  stats.latency_p999_ms = load_stats.latency_p999_ms;
+  stats.queueing_avg_ms = load_stats.queueing_avg_ms;
+  stats.wall_time_s = load_stats.wall_time_s;
+  stats.thread_cpu_time_s = std::move(load_stats.thread_cpu_time_s);
   return stats;
 }
 
@@ -5,6 +5,7 @@
 #include <pybind11/pybind11.h>
 
 #include <torch/csrc/jit/python/pybind_utils.h>
+#include <torch/csrc/utils/load_generator.h>
 
 #include <iostream>
 #include <memory>
@@ -23,6 +24,14 @@ namespace throughput_benchmark {
 struct BenchmarkExecutionStats {
   float latency_avg_ms{-1};
   int64_t num_iters{-1};
+  // See LoadStats for the definitions.
+  float latency_p50_ms{-1};
+  float latency_p90_ms{-1};
+  float latency_p99_ms{-1};
+  float latency_p999_ms{-1};
+  float queueing_avg_ms{0};
+  float wall_time_s{0};
+  std::vector<double> thread_cpu_time_s;
 };
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value);
@@ -53,6 +62,9 @@ struct BenchmarkConfig {
   // Number of iterations the benchmark should run with. This number is separate
   // from the warmup iterations
   int64_t num_iters{100};
+  // Mean number of requests per second arriving in open loop, 0 for closed
+  // loop. See LoadConfig::arrival_rate.
+  double arrival_rate{0};
   // If set autograd profiler will be enabled. I.e. this variable would be created
   // before the main benchmark loop (but after the warmup):
   // RecordProfile guard(profiler_output_path);
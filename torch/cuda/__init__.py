@@ -18,6 +18,7 @@ from typing import List, Optional, Tuple, Union
 from torch._six import raise_from
 from ._utils import _get_device_index, _dummy_type
 from .streams import Stream, Event
+from .graphs import CUDAGraph
 from .. import device as _device
 import torch._C
 
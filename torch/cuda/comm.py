@@ -1,5 +1,6 @@
 # The functions here have been moved to torch.nn.parallel.comm
-from torch.nn.parallel.comm import broadcast, broadcast_coalesced, reduce_add, \
-    reduce_add_coalesced, scatter, gather
+from torch.nn.parallel.comm import broadcast, broadcast_coalesced, broadcast_coalesced_async, \
+    reduce_add, reduce_add_coalesced, scatter, gather
 
-__all__ = [broadcast, broadcast_coalesced, reduce_add, reduce_add_coalesced, scatter, gather]
+__all__ = [broadcast, broadcast_coalesced, broadcast_coalesced_async, reduce_add, reduce_add_coalesced,
+           scatter, gather]
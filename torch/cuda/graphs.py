@@ -0,0 +1,58 @@
+import torch
+
+from ._utils import _dummy_type
+
+
+if not hasattr(torch._C, '_CUDAGraph'):
+    # Define dummy base classes
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('_CUDAGraph')
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    A CUDA graph records the kernels a workload launches on one stream and
+    replays all of them with a single launch, which removes the CPU overhead
+    of launching many small kernels, e.g. for static-shape inference.
+
+    Capture runs on the current stream, which must not be the default stream.
+    Replays read and write the same memory as the captured run: feed new
+    inputs by copying them into the tensors used during capture, and read the
+    results from the tensors it produced. Memory allocated during capture is
+    reserved for the graph until :meth:`reset` is called and the cache is
+    emptied. Random ops using the default CUDA generator draw new numbers on
+    every replay.
+
+    .. warning::
+        This API is experimental and requires PyTorch built with CUDA >= 11.0.
+    """
+
+    def capture_begin(self, pool=0):
+        r"""Begins capturing the work enqueued on the current stream.
+
+        Arguments:
+            pool (int, optional): the :meth:`pool` of another graph whose
+                private memory pool this capture should share. Only graphs
+                that are replayed in the order they were captured may share
+                a pool. By default the capture gets a new pool.
+        """
+        super(CUDAGraph, self).capture_begin(pool)
+
+    def capture_end(self):
+        r"""Ends the capture and instantiates the graph. Must be called on
+        the stream the capture began on."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Launches the captured work on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Deletes the graph and gives up its use of the private memory
+        pool."""
+        super(CUDAGraph, self).reset()
+
+    def pool(self):
+        r"""Returns an id of this graph's private memory pool, which can be
+        passed to :meth:`capture_begin` of another graph."""
+        return super(CUDAGraph, self).pool()
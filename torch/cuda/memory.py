@@ -1,7 +1,8 @@
 import collections
 import contextlib
+import json
 import warnings
-from typing import Any, Dict, Union
+from typing import Any, Dict, List, Optional, Union
 
 import torch
 from . import is_initialized, _get_device_index, _lazy_init
@@ -72,6 +73,45 @@ def caching_allocator_delete(mem_ptr):
     torch._C._cuda_cudaCachingAllocator_raw_delete(mem_ptr)
 
 
+def set_stream_pool(stream, name: Optional[str]) -> None:
+    r"""Serves the allocations made on a stream from a named memory pool.
+
+    The caching allocator normally serves all streams of a device from the
+    same pools. The streams given the same pool name share a pool of their
+    own instead: memory they free is cached for them only, and it does not
+    serve the allocations of other streams. Like in the default pools, a
+    cached segment that is entirely free can be reused by another stream of
+    the pool once the stream that freed it has finished its pending work.
+    Memory that was allocated before the call keeps returning to the pool it
+    came from.
+
+    Arguments:
+        stream (torch.cuda.Stream): the stream whose allocations to redirect.
+        name (str, optional): name of the pool on the device of
+            :attr:`stream`, created if it does not exist yet. ``None`` serves
+            the stream from the default pools again.
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    _lazy_init()
+    torch._C._cuda_cudaCachingAllocator_set_stream_pool(
+        stream.device_index, stream.cuda_stream, name or "")
+
+
+def _set_allocator_settings(settings: str) -> None:
+    r"""Changes the settings of the CUDA caching allocator, given in the same
+    format as the ``PYTORCH_CUDA_ALLOC_CONF`` environment variable, e.g.
+    ``"max_split_size_mb:128,roundup_power2_divisions:4"``. Options that are
+    not listed keep their value.
+
+    .. note::
+        See :ref:`cuda-memory-management` for the available options.
+    """
+    torch._C._cuda_cudaCachingAllocator_set_allocator_settings(settings)
+
+
 def empty_cache() -> None:
     r"""Releases all unoccupied cached memory currently held by the caching
     allocator so that those can be used in other GPU application and visible in
@@ -137,6 +177,17 @@ def memory_stats(device: Union[Device, int] = None) -> Dict[str, Any]:
       result in a cache flush and retry.
     - ``"num_ooms"``: number of out-of-memory errors thrown.
 
+    The allocator does not split blocks of at least ``max_split_size`` bytes
+    (see :ref:`cuda-memory-management`). To tell how much memory is held in
+    such blocks we also provide:
+
+    - ``"max_split_size"``: the current limit, or -1 if every block can be
+      split.
+    - ``"oversize_allocations.{current,peak,allocated,freed}"``: number of
+      allocated blocks of at least ``max_split_size`` bytes.
+    - ``"oversize_segments.{current,peak,allocated,freed}"``: number of
+      reserved segments of at least ``max_split_size`` bytes.
+
     Arguments:
         device (torch.device or int, optional): selected device. Returns
             statistics for the current device, given by :func:`~torch.cuda.current_device`,
@@ -164,6 +215,38 @@ def memory_stats(device: Union[Device, int] = None) -> Dict[str, Any]:
     return collections.OrderedDict(result)
 
 
+def host_memory_stats() -> Dict[str, Any]:
+    r"""Returns a dictionary of statistics of the caching allocator for
+    pinned host memory, which serves :meth:`~torch.Tensor.pin_memory` and
+    ``pin_memory=True`` in the data loader.
+
+    The statistics are flattened like those of :func:`~torch.cuda.memory_stats`:
+
+    - ``"allocation.{current,peak,allocated,freed}"``: number of allocation
+      requests received by the allocator.
+    - ``"allocated_bytes.{current,peak,allocated,freed}"``: amount of
+      allocated memory. Requests are rounded up to a power of two.
+    - ``"segment.{current,peak,allocated,freed}"``: number of blocks pinned
+      with ``cudaHostAlloc()``.
+    - ``"reserved_bytes.{current,peak,allocated,freed}"``: amount of pinned
+      memory held by the allocator, free or in use.
+    """
+    result = []
+    for name, stat in torch._C._cuda_hostMemoryStats().items():
+        for metric, value in stat.items():
+            result.append((name + "." + metric, value))
+    result.sort()
+    return collections.OrderedDict(result)
+
+
+def empty_host_cache() -> None:
+    r"""Releases the pinned host memory cached by the caching host allocator
+    that is not in use, with ``cudaFreeHost()``.
+    """
+    if is_initialized():
+        torch._C._cuda_emptyHostCache()
+
+
 def memory_stats_as_nested_dict(device: Union[Device, int] = None) -> Dict[str, Any]:
     r"""Returns the result of :func:`~torch.cuda.memory_stats` as a nested dictionary."""
     device = _get_device_index(device, optional=True)
@@ -368,6 +451,101 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def record_memory_history(enabled: bool = True, record_stacks: bool = True,
+                          max_entries: int = 100000) -> None:
+    r"""Starts or stops recording the history of the CUDA caching allocator.
+
+    While enabled, every allocation and free, and every ``cudaMalloc`` and
+    ``cudaFree`` of a segment, is recorded with its size, stream, a timestamp
+    and the allocated and reserved memory of the device after it. Each device
+    keeps the last :attr:`max_entries` events. Starting a recording discards
+    the events recorded before.
+
+    Arguments:
+        enabled (bool, optional): whether to record (default: ``True``).
+        record_stacks (bool, optional): whether to record the Python stack of
+            every allocation and free (default: ``True``). This is the
+            expensive part of the recording, it takes the GIL for every
+            event. Threads that run no Python code, such as the ones of the
+            autograd engine, record an empty stack.
+        max_entries (int, optional): number of events kept per device
+            (default: 100000).
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    _lazy_init()
+    torch._C._cuda_recordMemoryHistory(enabled, record_stacks, max_entries)
+
+
+def memory_history(device: Union[Device, int] = None) -> List[Dict[str, Any]]:
+    r"""Returns the events recorded by :func:`~torch.cuda.record_memory_history`
+    for a given device, oldest first.
+
+    Each event is a dictionary with the keys ``"action"`` (``"alloc"``,
+    ``"free"``, ``"segment_alloc"`` or ``"segment_free"``), ``"address"``,
+    ``"size"``, ``"stream"``, ``"time_us"``, ``"allocated_bytes"``,
+    ``"reserved_bytes"`` and ``"stack"``.
+
+    Arguments:
+        device (torch.device or int, optional): selected device. Returns
+            the history of the current device, given by
+            :func:`~torch.cuda.current_device`, if :attr:`device` is ``None``
+            (default).
+    """
+    if not is_initialized():
+        return []
+    device = _get_device_index(device, optional=True)
+    return torch._C._cuda_memoryHistory(device)
+
+
+def export_memory_timeline(path: str, device: Union[Device, int] = None) -> None:
+    r"""Writes the events recorded by :func:`~torch.cuda.record_memory_history`
+    to :attr:`path` in the Chrome trace event format, which
+    ``chrome://tracing`` and Perfetto display as a timeline.
+
+    The allocated and reserved memory of the device show as counters, and
+    every event as an instant event on the track of its stream, with its
+    size, address and stack as arguments.
+
+    Arguments:
+        path (str): file to write.
+        device (torch.device or int, optional): selected device. Exports the
+            history of the current device, given by
+            :func:`~torch.cuda.current_device`, if :attr:`device` is ``None``
+            (default).
+    """
+    device = _get_device_index(device, optional=True)
+    events = []
+    for entry in memory_history(device):
+        events.append({
+            "name": "CUDA memory",
+            "ph": "C",
+            "ts": entry["time_us"],
+            "pid": device,
+            "args": {
+                "allocated": entry["allocated_bytes"],
+                "reserved": entry["reserved_bytes"],
+            },
+        })
+        events.append({
+            "name": "{} {}".format(entry["action"], entry["size"]),
+            "ph": "i",
+            "s": "t",
+            "ts": entry["time_us"],
+            "pid": device,
+            "tid": entry["stream"],
+            "args": {
+                "size": entry["size"],
+                "address": hex(entry["address"]),
+                "stack": entry["stack"],
+            },
+        })
+    with open(path, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+
+
 def memory_summary(device: Union[Device, int] = None, abbreviated: bool = False) -> str:
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
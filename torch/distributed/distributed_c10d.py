@@ -374,6 +374,16 @@ def init_process_group(backend,
     To enable ``backend == Backend.MPI``, PyTorch needs to be built from source
     on a system that supports MPI.
 
+    With the ``nccl`` backend, setting the environment variable
+    ``NCCL_HIERARCHICAL_ALLREDUCE`` to the number of GPUs per node makes
+    allreduce of a single tensor a reduce-scatter inside the nodes, an
+    allreduce across the nodes and an allgather inside the nodes. This can be
+    faster when the links between the nodes are much slower than the ones
+    inside them. Ranks must be numbered node by node. Tensors smaller than
+    ``NCCL_HIERARCHICAL_ALLREDUCE_MIN_BYTES`` (1MB by default), or whose
+    number of elements is not a multiple of the number of GPUs per node, use
+    the flat allreduce.
+
     """
     global _pg_group_ranks
     global _backend
@@ -1355,6 +1365,48 @@ def all_gather(tensor_list,
     else:
         work.wait()
 
+
+def _all_gather_base(output_tensor,
+                     input_tensor,
+                     group=group.WORLD,
+                     async_op=False):
+    """
+    Single tensor all gather. Gathers a single tensor from all ranks, and puts
+    them in a single output tensor, without per rank output tensors.
+
+    Arguments:
+        output_tensor (Tensor): Output tensor. It should contain
+            ``world_size`` times the elements of ``input_tensor``, the input
+            of rank ``i`` is the ``i``-th chunk of it.
+        input_tensor (Tensor): Tensor to be broadcast from current process.
+        group (ProcessGroup, optional): The process group to work on
+        async_op (bool, optional): Whether this op should be an async op
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group
+
+    .. note:: Only the NCCL and Gloo backends support this, for contiguous
+        tensors.
+
+    """
+    _check_single_tensor(input_tensor, "input_tensor")
+    _check_single_tensor(output_tensor, "output_tensor")
+    if _rank_not_in_group(group):
+        return
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg._allgather_base(output_tensor, input_tensor)
+    else:
+        work = group._allgather_base(output_tensor, input_tensor)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def all_gather_coalesced(output_tensor_lists,
                          input_tensor_list,
                          group=group.WORLD,
@@ -1666,6 +1718,52 @@ def reduce_scatter(output,
         work.wait()
 
 
+def _reduce_scatter_base(output,
+                         input,
+                         op=ReduceOp.SUM,
+                         group=group.WORLD,
+                         async_op=False):
+    """
+    Reduces, then scatters a flattened tensor to all processes in a group.
+
+    Arguments:
+        output (Tensor): Output tensor.
+        input (Tensor): Input tensor that is of size output tensor size times
+            world size, its ``i``-th chunk is reduced into the output of rank
+            ``i``.
+        op (optional): One of the values from
+            ``torch.distributed.ReduceOp``
+            enum.  Specifies an operation used for element-wise reductions.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether this op should be an async op.
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    .. note:: Only the NCCL and Gloo backends support this, for contiguous
+        tensors.
+
+    """
+    _check_single_tensor(output, "output")
+    _check_single_tensor(input, "input")
+    if _rank_not_in_group(group):
+        return
+
+    opts = ReduceScatterOptions()
+    opts.reduceOp = op
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg._reduce_scatter_base(output, input, opts)
+    else:
+        work = group._reduce_scatter_base(output, input, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def all_to_all_single(output,
                       input,
                       output_split_sizes=None,
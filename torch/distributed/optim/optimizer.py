@@ -28,6 +28,10 @@ class _LocalOptimizer:
             for param, grad in all_local_grads.items():
                 param.grad = grad
             self.optim.step()
+            # Don't keep the gradients of this context alive until the next
+            # step, they are still in the context if needed.
+            for param in all_local_grads.keys():
+                param.grad = None
 
 
 def _new_local_optimizer(optim_cls, local_params_rref, *args, **kwargs):
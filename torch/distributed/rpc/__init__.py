@@ -30,6 +30,7 @@ if is_available():
     from .server_process_global_profiler import (
         _server_process_global_profile,
     )
+    from . import _tracing  # noqa: F401
     import torch.distributed.autograd as dist_autograd
 
     import numbers
@@ -0,0 +1,155 @@
+"""
+Collection and offline merging of the spans of traced RPCs.
+
+Each worker records the spans of the RPCs it sends and processes for the
+sampled traces, see ``torch.distributed.rpc._set_rpc_trace_sample_rate``. The
+spans of all workers are dumped with :func:`save_spans` and merged afterwards
+with :func:`merge_traces` into a single trace, which can be viewed in
+``chrome://tracing``. The client and server spans of an RPC are connected, and
+the time between them, spent on the wire and in the queues of the callee, is
+reported separately from the time spent processing the request.
+"""
+
+import json
+
+from . import _get_rpc_trace_spans
+
+
+_MESSAGE_TYPE_NAMES = {
+    0: "script_call",
+    2: "python_call",
+    4: "script_remote_call",
+    5: "python_remote_call",
+    7: "script_rref_fetch_call",
+    8: "python_rref_fetch_call",
+    11: "rref_user_delete",
+    12: "rref_fork_request",
+    13: "rref_child_accept",
+    17: "backward_autograd_req",
+    19: "cleanup_autograd_context_req",
+    23: "rref_user_delete_batch",
+}
+
+
+def get_spans():
+    r"""
+    Returns the spans recorded by this worker, oldest first, as dicts which can
+    be serialized with ``json``.
+    """
+    return [
+        {
+            "trace_id": span.trace_id,
+            "span_id": span.span_id,
+            "parent_span_id": span.parent_span_id,
+            "is_server": span.is_server,
+            "worker_id": span.worker_id,
+            "peer_id": span.peer_id,
+            "message_type": span.message_type,
+            "start_us": span.start_us,
+            "end_us": span.end_us,
+            "has_error": span.has_error,
+        }
+        for span in _get_rpc_trace_spans()
+    ]
+
+
+def save_spans(path):
+    r"""
+    Writes the spans recorded by this worker to ``path`` as JSON, to be merged
+    with the ones of the other workers by :func:`merge_traces`.
+    """
+    with open(path, "w") as f:
+        json.dump(get_spans(), f)
+
+
+def merge_traces(span_lists, worker_names=None):
+    r"""
+    Merges the spans of several workers into a Chrome trace.
+
+    Arguments:
+        span_lists (list): for each worker, a list of spans as returned by
+            :func:`get_spans`, or the path of a file written by
+            :func:`save_spans`.
+        worker_names (dict, optional): names of the workers by id, used to
+            label their processes.
+
+    Returns:
+        A dict in the Chrome trace event format, to be written with
+        ``json.dump``. The client span of an RPC has the duration of its
+        server span as ``server_us`` and the rest as ``network_and_queue_us``,
+        which includes the skew between the clocks of the workers.
+    """
+    spans = []
+    for span_list in span_lists:
+        if isinstance(span_list, str):
+            with open(span_list) as f:
+                span_list = json.load(f)
+        spans.extend(span_list)
+
+    # An RPC has one server span, whose parent is the client span.
+    server_spans = {
+        span["parent_span_id"]: span for span in spans if span["is_server"]
+    }
+
+    events = []
+    worker_ids = set()
+    for span in spans:
+        worker_ids.add(span["worker_id"])
+        name = _MESSAGE_TYPE_NAMES.get(
+            span["message_type"], "message_type_{}".format(span["message_type"])
+        )
+        duration_us = span["end_us"] - span["start_us"]
+        args = {
+            "trace_id": span["trace_id"],
+            "span_id": span["span_id"],
+            "parent_span_id": span["parent_span_id"],
+            "peer_id": span["peer_id"],
+            "has_error": span["has_error"],
+        }
+        if not span["is_server"]:
+            server_span = server_spans.get(span["span_id"])
+            if server_span is not None:
+                server_us = server_span["end_us"] - server_span["start_us"]
+                args["server_us"] = server_us
+                args["network_and_queue_us"] = duration_us - server_us
+                flow = {
+                    "name": name,
+                    "cat": "rpc",
+                    "id": span["span_id"],
+                }
+                events.append(dict(
+                    flow,
+                    ph="s",
+                    ts=span["start_us"],
+                    pid=span["worker_id"],
+                    tid="client",
+                ))
+                events.append(dict(
+                    flow,
+                    ph="f",
+                    bp="e",
+                    ts=server_span["start_us"],
+                    pid=server_span["worker_id"],
+                    tid="server",
+                ))
+        events.append({
+            "name": name,
+            "cat": "rpc",
+            "ph": "X",
+            "ts": span["start_us"],
+            "dur": duration_us,
+            "pid": span["worker_id"],
+            "tid": "server" if span["is_server"] else "client",
+            "args": args,
+        })
+
+    for worker_id in sorted(worker_ids):
+        if worker_names and worker_id in worker_names:
+            events.append({
+                "name": "process_name",
+                "ph": "M",
+                "pid": worker_id,
+                "args": {"name": worker_names[worker_id]},
+            })
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
@@ -32,6 +32,13 @@ class TensorPipeRpcBackendOptions(_TensorPipeRpcBackendOptionsBase):
             dictionary (``Dict`` of ``int``, ``str``, or ``torch.device``) that
             maps this worker's devices to the callee worker's devices.
             (default: ``None``)
+        max_batch_bytes (int, optional): When positive, the requests to a
+            worker that are issued while a previous write to it is still in
+            flight are coalesced and sent together once it completes, or as
+            soon as they add up to this many bytes, which saves per-message
+            overhead when many small RPCs go to the same worker. A worker
+            that is not busy receives requests right away (default: 0, which
+            disables batching).
     """
     def __init__(
         self,
@@ -40,6 +47,7 @@ class TensorPipeRpcBackendOptions(_TensorPipeRpcBackendOptionsBase):
         rpc_timeout: float = rpc_contants.DEFAULT_RPC_TIMEOUT_SEC,
         init_method: str = rpc_contants.DEFAULT_INIT_METHOD,
         device_maps: Dict = None,
+        max_batch_bytes: int = 0,
         _transports: List = None,
         _channels: List = None,
     ):
@@ -49,7 +57,8 @@ class TensorPipeRpcBackendOptions(_TensorPipeRpcBackendOptionsBase):
             _channels,
             rpc_timeout,
             init_method,
-            device_maps if device_maps else {}
+            device_maps if device_maps else {},
+            max_batch_bytes,
         )
 
     def set_device_map(self, to: str, device_map: Dict):
@@ -486,6 +486,9 @@ if _enabled:
             Arguments:
                 f: a string containing a file name.
                 _extra_files: Map from filename to contents which will be stored as part of 'f'.
+                _flat_bytecode: save the bytecode in a flat format, which the lite interpreter
+                    uses in place instead of unpickling it. Such models need a lite interpreter
+                    that supports the format.
 
             """
             return self._c._save_for_mobile(*args, **kwargs)
@@ -85,7 +85,7 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
         f.write(ret)
 
 
-def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP, mmap=False):
     r"""
     Load a :class:`ScriptModule` or :class:`ScriptFunction` previously
     saved with :func:`torch.jit.save <torch.jit.save>`
@@ -104,6 +104,10 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
         _extra_files (dictionary of filename to content): The extra
             filenames given in the map would be loaded and their content
             would be stored in the provided map.
+        mmap (bool): map the file into memory copy-on-write instead of reading
+            it, so that the CPU tensors point into the mapping and are only
+            read from disk when first accessed. ``f`` has to be a file name.
+            Default: ``False``.
 
     Returns:
         A :class:`ScriptModule` object.
@@ -158,7 +162,9 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
 
     cu = torch._C.CompilationUnit()
     if isinstance(f, str) or isinstance(f, pathlib.Path):
-        cpp_module = torch._C.import_ir_module(cu, f, map_location, _extra_files)
+        cpp_module = torch._C.import_ir_module(cu, str(f), map_location, _extra_files, mmap)
+    elif mmap:
+        raise ValueError("mmap can only be used when f is a file name")
     else:
         cpp_module = torch._C.import_ir_module_from_buffer(
             cu, f.read(), map_location, _extra_files
@@ -96,4 +96,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroup::allgather_coalesced(
       "no support for allgather_coalesced in this process group");
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::reduce_scatter_base(
+    at::Tensor& /* unused */,
+    at::Tensor& /* unused */,
+    const ReduceScatterOptions& /* unused */) {
+  throw std::runtime_error(
+      "no support for reduce_scatter_base in this process group");
+}
+
 } // namespace c10d
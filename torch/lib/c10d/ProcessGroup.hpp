@@ -174,6 +174,16 @@ class ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputTensors,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) = 0;
 
+  // Reduces a single tensor inputBuffer, interpreted as a contigious
+  // collection of WORLD_SIZE chunks of the size of outputBuffer, and writes
+  // chunk i of the result to outputBuffer of rank i. The counterpart of
+  // allgather_base, neither needs per rank tensor lists.
+  // For implementers of ProcessGroup API and advanced users only.
+  virtual std::shared_ptr<ProcessGroup::Work> reduce_scatter_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const ReduceScatterOptions& opts = ReduceScatterOptions());
+
   virtual std::shared_ptr<ProcessGroup::Work> alltoall_base(
       at::Tensor& outputTensor,
       at::Tensor& inputTensor,
@@ -7,6 +7,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <exception>
 #include <type_traits>
 
 #include <gloo/allgather.h>
@@ -405,7 +407,9 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      allreduceMinChunkBytes(1 << 20) {}
 
 namespace {
 
@@ -523,7 +527,8 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
-      collectiveCounter_(0) {
+      collectiveCounter_(0),
+      allreduceMinChunkBytes_(options.allreduceMinChunkBytes) {
   auto& devices = options.devices;
   if (devices.empty()) {
     throw std::runtime_error("No device(s) specified");
@@ -588,6 +593,16 @@ std::shared_ptr<::gloo::Context> ProcessGroupGloo::getContext(uint32_t tag) {
   return contexts_[tag % contexts_.size()];
 }
 
+std::vector<std::shared_ptr<::gloo::Context>> ProcessGroupGloo::getContexts(
+    uint32_t tag) {
+  std::vector<std::shared_ptr<::gloo::Context>> contexts;
+  contexts.reserve(contexts_.size());
+  for (size_t i = 0; i < contexts_.size(); i++) {
+    contexts.push_back(contexts_[(tag + i) % contexts_.size()]);
+  }
+  return contexts;
+}
+
 void ProcessGroupGloo::runLoop(int workerIndex) {
   std::unique_lock<std::mutex> lock(workMutex_);
 
@@ -785,15 +800,80 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
   const ReduceOp reduceOp;
   const uint32_t tag;
 
+  // A single tensor of at least twice minChunkBytes is split into chunks of
+  // at least minChunkBytes, one per context. The chunks are allreduced in
+  // parallel, each on its own thread and context, so that the transfers and
+  // the local reductions of a large tensor use several cores and, when the
+  // contexts have their own devices, several I/O threads or NICs. The first
+  // context is `context'.
+  std::vector<std::shared_ptr<gloo::Context>> chunkContexts;
+  size_t minChunkBytes = 0;
+
   void allreduce(std::vector<at::Tensor>& tensors) {
+    if (tensors.size() == 1 && tensors[0].is_contiguous() &&
+        minChunkBytes > 0) {
+      const size_t bytes = tensors[0].numel() * tensors[0].element_size();
+      const size_t numChunks = std::min(
+          {chunkContexts.size(),
+           bytes / minChunkBytes,
+           static_cast<size_t>(tensors[0].numel())});
+      if (numChunks > 1) {
+        allreduceChunks(tensors[0], numChunks);
+        return;
+      }
+    }
+    allreduce(context, tensors);
+  }
+
+  void allreduce(
+      const std::shared_ptr<gloo::Context>& chunkContext,
+      std::vector<at::Tensor>& tensors) {
     const auto& scalarType = tensors[0].scalar_type();
-    gloo::AllreduceOptions opts(context);
+    gloo::AllreduceOptions opts(chunkContext);
     opts.setReduceFunction(getFunction(scalarType, reduceOp));
+    // Every chunk runs on a different context, they can share the tag.
     opts.setTag(tag);
     GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors);
     gloo::allreduce(opts);
   }
 
+  void allreduceChunks(at::Tensor& tensor, size_t numChunks) {
+    at::Tensor flat = tensor.view(-1);
+    const int64_t numel = flat.numel();
+    std::vector<std::vector<at::Tensor>> chunks(numChunks);
+    for (size_t i = 0; i < numChunks; i++) {
+      const int64_t begin = numel * i / numChunks;
+      const int64_t end = numel * (i + 1) / numChunks;
+      chunks[i] = {flat.slice(0, begin, end)};
+    }
+
+    std::vector<std::exception_ptr> errors(numChunks);
+    std::vector<std::thread> threads;
+    threads.reserve(numChunks - 1);
+    for (size_t i = 1; i < numChunks; i++) {
+      threads.emplace_back([&, i]() {
+        try {
+          allreduce(chunkContexts[i], chunks[i]);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+    try {
+      allreduce(chunkContexts[0], chunks[0]);
+    } catch (...) {
+      errors[0] = std::current_exception();
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
   void run() override {
     allreduce(inputs);
   }
@@ -1272,8 +1352,11 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     if (layout == c10::kStrided) {
-      work = std::make_shared<AsyncAllreduceWork>(
+      auto allreduceWork = std::make_shared<AsyncAllreduceWork>(
           std::move(context), inputs, opts.reduceOp, tag);
+      allreduceWork->chunkContexts = getContexts(tag);
+      allreduceWork->minChunkBytes = allreduceMinChunkBytes_;
+      work = std::move(allreduceWork);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceWork>(
           std::move(context), inputs, tag);
@@ -1283,8 +1366,11 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     if (layout == c10::kStrided) {
-      work = std::make_shared<AsyncAllreduceCUDAWork>(
+      auto allreduceWork = std::make_shared<AsyncAllreduceCUDAWork>(
           std::move(context), inputs, opts.reduceOp, tag);
+      allreduceWork->chunkContexts = getContexts(tag);
+      allreduceWork->minChunkBytes = allreduceMinChunkBytes_;
+      work = std::move(allreduceWork);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceCUDAWork>(
           std::move(context), inputs, tag);
@@ -1573,6 +1659,32 @@ class AsyncAllgatherWork : public ProcessGroupGloo::AsyncWork {
   }
 };
 
+// The inputs of all the ranks are gathered straight into the flat output,
+// nothing is copied.
+class AsyncAllgatherBaseWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncAllgatherBaseWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& output,
+      at::Tensor& input,
+      uint32_t tag)
+      : context(context), output(output), input(input), tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  at::Tensor output;
+  at::Tensor input;
+  const uint32_t tag;
+
+  void run() override {
+    const auto& scalarType = input.scalar_type();
+    gloo::AllgatherOptions opts(context);
+    opts.setTag(tag);
+    GENERATE_ALL_TYPES(scalarType, setInput, opts, input);
+    GENERATE_ALL_TYPES(scalarType, setOutput, opts, output);
+    gloo::allgather(opts);
+  }
+};
+
 #ifdef USE_CUDA
 
 // Note: current CUDA implementation holds the assumption that the
@@ -1843,12 +1955,56 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather_coalesced(
   return work;
 }
 
+namespace {
+
+// Checks the buffers of allgather_base and reduce_scatter_base: contiguous
+// CPU tensors of the same type, the output having `outputFactor' elements
+// for every `inputFactor' elements of the input.
+void assertFlatBuffers(
+    std::function<void(const std::string&)> fn,
+    const at::Tensor& output,
+    const at::Tensor& input,
+    int64_t outputFactor,
+    int64_t inputFactor) {
+  for (const auto& tensor : {output, input}) {
+    assertCPU(fn, tensor);
+    assertDense(fn, tensor);
+  }
+  if (!output.is_contiguous() || !input.is_contiguous()) {
+    fn("requires contiguous buffers");
+  }
+  if (!output.options().type_equal(input.options())) {
+    fn("requires input and output buffers of the same type");
+  }
+  if (output.numel() * inputFactor != input.numel() * outputFactor) {
+    fn(c10::str(
+        "invalid buffer sizes (input ",
+        input.numel(),
+        ", output ",
+        output.numel(),
+        " elements, for a world size of ",
+        std::max(outputFactor, inputFactor),
+        ")"));
+  }
+}
+
+} // namespace
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather_base(
-    at::Tensor& /*unused */,
-    at::Tensor& /*unused */,
-    const AllgatherOptions& /*unused */) {
-  throw std::runtime_error(
-      "no support for allgather_base in Gloo process group");
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::allgather_base: " + msg);
+  };
+  assertFlatBuffers(invalidArgument, outputBuffer, inputBuffer, size_, 1);
+
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncAllgatherBaseWork>(
+      std::move(context), outputBuffer, inputBuffer, tag);
+  enqueue(work);
+  return work;
 }
 
 namespace {
@@ -2250,6 +2406,55 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
 
 namespace {
 
+// Gloo has no reduce-scatter in its collectives API, the copy of the flat
+// input is allreduced and the chunk of this rank is copied to the output.
+class AsyncReduceScatterBaseWork : public AsyncAllreduceWork {
+ public:
+  AsyncReduceScatterBaseWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& output,
+      std::vector<at::Tensor>& buffer,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(context, buffer, reduceOp, tag), output(output) {}
+
+  at::Tensor output;
+
+  void run() override {
+    allreduce(inputs);
+    output.copy_(inputs[0]
+                     .view(-1)
+                     .narrow(0, context->rank * output.numel(), output.numel())
+                     .view_as(output));
+  }
+};
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter_base(
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const ReduceScatterOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupGloo::reduce_scatter_base: " + msg);
+  };
+  assertFlatBuffers(invalidArgument, outputBuffer, inputBuffer, 1, size_);
+
+  // The input is left untouched, as with the other process groups.
+  std::vector<at::Tensor> buffer = {inputBuffer.clone()};
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncReduceScatterBaseWork>(
+      std::move(context), outputBuffer, buffer, opts.reduceOp, tag);
+  work->chunkContexts = getContexts(tag);
+  work->minChunkBytes = allreduceMinChunkBytes_;
+  enqueue(work);
+  return work;
+}
+
+namespace {
+
 class AsyncAlltoallWork : public ProcessGroupGloo::AsyncWork {
  public:
   AsyncAlltoallWork(
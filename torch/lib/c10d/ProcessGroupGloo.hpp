@@ -129,6 +129,11 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // With more than one device, the allreduce of a tensor of at least twice
+    // this many bytes is split into chunks of at least this many bytes that
+    // are allreduced in parallel over the contexts. 0 disables the split.
+    size_t allreduceMinChunkBytes;
   };
 
   // Helper functions to create a new device object.
@@ -204,6 +209,11 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputs,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> alltoall_base(
       at::Tensor& outputTensor,
       at::Tensor& inputTensor,
@@ -252,6 +262,12 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // Returns all the contexts, starting with the one of getContext(tag).
+  std::vector<std::shared_ptr<::gloo::Context>> getContexts(uint32_t tag);
+
+  // See Options::allreduceMinChunkBytes.
+  const size_t allreduceMinChunkBytes_;
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
@@ -1,5 +1,7 @@
 #include <c10d/ProcessGroupNCCL.hpp>
 
+#include <algorithm>
+#include <condition_variable>
 #include <map>
 #include <tuple>
 #include <unordered_set>
@@ -9,6 +11,7 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <c10/cuda/CUDAGuard.h>
 
+#include <c10d/PrefixStore.hpp>
 #include <c10d/Utils.hpp>
 namespace c10d {
 
@@ -225,10 +228,133 @@ ncclResult_t ncclAlltoallv(
 }
 #endif
 
+// Note [Completion callbacks of FutureNCCL]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A callback added to a FutureNCCL whose events haven't completed yet runs
+// once they have. Rather than a thread per callback waiting on its events, a
+// single thread of the process polls the events of all the pending
+// callbacks, in batches every kCompletionPollMicros, and sleeps while there
+// are none. Callbacks are handed to it through a lock-free stack, so that
+// adding one never waits for the poller while it polls or runs callbacks;
+// the mutex only serves to put the poller to sleep and to wake it up.
+constexpr int64_t kCompletionPollMicros = 50;
+
+class CompletionPoller {
+ public:
+  // Leaked, so that it outlives the static destructors which could still add
+  // callbacks.
+  static CompletionPoller& get() {
+    static CompletionPoller* poller = new CompletionPoller();
+    return *poller;
+  }
+
+  void add(
+      c10::DeviceIndex deviceIndex,
+      std::shared_ptr<std::vector<at::cuda::CUDAEvent>> cudaEvents,
+      std::function<void(void)> callback) {
+    auto node = new Node{
+        deviceIndex, std::move(cudaEvents), std::move(callback), nullptr};
+    node->next = head_.load();
+    while (!head_.compare_exchange_weak(node->next, node)) {
+    }
+    if (sleeping_.load()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_one();
+    }
+  }
+
+ private:
+  struct Node {
+    c10::DeviceIndex deviceIndex;
+    std::shared_ptr<std::vector<at::cuda::CUDAEvent>> cudaEvents;
+    std::function<void(void)> callback;
+    Node* next;
+  };
+
+  CompletionPoller() {
+    std::thread(&CompletionPoller::run, this).detach();
+  }
+
+  static bool completed(const Node& node) {
+    at::cuda::CUDAGuard gpuGuard(node.deviceIndex);
+    for (const auto& cudaEvent : *node.cudaEvents) {
+      auto ret = cudaEventQuery(cudaEvent);
+      if (ret == cudaErrorNotReady) {
+        return false;
+      }
+      if (ret != cudaSuccess) {
+        // the callback sees the error when it uses the value
+        LOG(ERROR) << "Completion poller: " << cudaGetErrorString(ret);
+        cudaGetLastError();
+      }
+    }
+    return true;
+  }
+
+  void run() {
+    std::vector<std::unique_ptr<Node>> pending;
+    while (true) {
+      // the stack is in reverse order of addition
+      auto first = pending.size();
+      for (Node* node = head_.exchange(nullptr); node != nullptr;) {
+        Node* next = node->next;
+        pending.emplace_back(node);
+        node = next;
+      }
+      std::reverse(pending.begin() + first, pending.end());
+
+      if (pending.empty()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true);
+        cv_.wait(lock, [this] { return head_.load() != nullptr; });
+        sleeping_.store(false);
+        continue;
+      }
+
+      auto done = std::stable_partition(
+          pending.begin(), pending.end(), [](const std::unique_ptr<Node>& node) {
+            return !completed(*node);
+          });
+      for (auto it = done; it != pending.end(); ++it) {
+        at::cuda::CUDAGuard gpuGuard((*it)->deviceIndex);
+        try {
+          (*it)->callback();
+        } catch (const std::exception& e) {
+          LOG(ERROR) << "Exception in FutureNCCL callback: " << e.what();
+        }
+      }
+      pending.erase(done, pending.end());
+
+      if (!pending.empty()) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(kCompletionPollMicros));
+      }
+    }
+  }
+
+  std::atomic<Node*> head_{nullptr};
+  std::atomic<bool> sleeping_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
 } // namespace
 
+void ProcessGroupNCCL::FutureNCCL::addCallback(
+    std::function<void(void)> callback) {
+  if (completed()) {
+    callback();
+    return;
+  }
+  CompletionPoller::get().add(deviceIndex_, cudaEvents_, std::move(callback));
+}
+
 const int64_t ProcessGroupNCCL::kWatchdogThreadSleepMillis = 10000;
 constexpr int64_t kWaitForAbortCommStoreKey = 1000;
+// The first sleep of a blocking wait, which doubles up to
+// kSynchronizeBusyWaitMillis, so that short collectives aren't made to wait
+// for the longest one.
+constexpr int64_t kSynchronizeMinBusyWaitMicros = 10;
 constexpr int64_t kSynchronizeBusyWaitMillis = 10;
 const int64_t ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis = 10 * 1000;
 
@@ -245,8 +371,15 @@ ProcessGroupNCCL::WorkNCCL::WorkNCCL(const std::vector<at::Device>& devices)
 ProcessGroupNCCL::WorkNCCL::~WorkNCCL() {}
 
 bool ProcessGroupNCCL::WorkNCCL::isCompleted() {
+  if (eventsCompleted_.load()) {
+    return true;
+  }
   checkAndSetException();
-  return exception() || finishedGPUExecutionInternal();
+  if (exception() || finishedGPUExecutionInternal()) {
+    eventsCompleted_.store(true);
+    return true;
+  }
+  return false;
 }
 
 bool ProcessGroupNCCL::WorkNCCL::isSuccess() const {
@@ -325,6 +458,7 @@ void ProcessGroupNCCL::WorkNCCL::synchronizeInternal(
     std::chrono::milliseconds workTimeout =
         timeout == kNoTimeout ? opTimeout_ : timeout;
     // Wait for the operation to complete.
+    auto busyWait = std::chrono::microseconds(kSynchronizeMinBusyWaitMicros);
     while (!isCompleted()) {
       auto currentTimepoint = std::chrono::steady_clock::now();
       if (std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -349,8 +483,9 @@ void ProcessGroupNCCL::WorkNCCL::synchronizeInternal(
       }
       // Check for errors and throw appropriate exception.
       checkAndThrowException();
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(kSynchronizeBusyWaitMillis));
+      std::this_thread::sleep_for(busyWait);
+      busyWait = std::min<std::chrono::microseconds>(
+          2 * busyWait, std::chrono::milliseconds(kSynchronizeBusyWaitMillis));
     }
     checkAndThrowException();
   }
@@ -413,6 +548,53 @@ ProcessGroupNCCL::ProcessGroupNCCL(
   ncclCommWatchdogThread_ =
       std::thread(&ProcessGroupNCCL::ncclCommWatchdog, this);
 #endif
+
+  initHierarchicalAllreduce();
+}
+
+void ProcessGroupNCCL::initHierarchicalAllreduce() {
+  char* localSize = getenv(NCCL_HIERARCHICAL_ALLREDUCE);
+  if (localSize == nullptr) {
+    return;
+  }
+  hierarchicalLocalSize_ = std::stoi(localSize);
+  if (hierarchicalLocalSize_ < 0) {
+    throw std::runtime_error(
+        "Invalid value for environment variable: " +
+        std::string(NCCL_HIERARCHICAL_ALLREDUCE));
+  }
+  char* minBytes = getenv(NCCL_HIERARCHICAL_ALLREDUCE_MIN_BYTES);
+  if (minBytes != nullptr) {
+    hierarchicalMinBytes_ = std::stoull(minBytes);
+  }
+  // Nothing to split on a single node, or when nodes do not all have the
+  // same number of ranks.
+  if (hierarchicalLocalSize_ <= 1 || size_ <= hierarchicalLocalSize_ ||
+      size_ % hierarchicalLocalSize_ != 0) {
+    hierarchicalLocalSize_ = 0;
+    return;
+  }
+
+  const int node = rank_ / hierarchicalLocalSize_;
+  const int localRank = rank_ % hierarchicalLocalSize_;
+  intraNodeGroup_ = std::make_shared<ProcessGroupNCCL>(
+      std::make_shared<PrefixStore>(
+          "hierarchical_intra_" + std::to_string(node), store_),
+      localRank,
+      hierarchicalLocalSize_,
+      opTimeout_);
+  interNodeGroup_ = std::make_shared<ProcessGroupNCCL>(
+      std::make_shared<PrefixStore>(
+          "hierarchical_inter_" + std::to_string(localRank), store_),
+      node,
+      size_ / hierarchicalLocalSize_,
+      opTimeout_);
+  // The sub groups run the flat collectives.
+  for (auto& group : {intraNodeGroup_, interNodeGroup_}) {
+    group->hierarchicalLocalSize_ = 0;
+    group->intraNodeGroup_.reset();
+    group->interNodeGroup_.reset();
+  }
 }
 
 ProcessGroupNCCL::~ProcessGroupNCCL() {
@@ -764,6 +946,87 @@ std::vector<at::Tensor> flatten_for_scatter_gather(
   return flattened;
 }
 
+// Check that the tensors of a coalesced collective are dense and on the same
+// GPU. Unlike check_gpu_tensors, their types and sizes may differ.
+void check_gpu_tensors_same_device(const std::vector<at::Tensor>& tensors) {
+  if (tensors.size() == 0) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+  const auto& first = tensors.front();
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (t.get_device() != first.get_device()) {
+      throw std::runtime_error("Tensors must be on the same GPU device");
+    }
+  }
+}
+
+// Check the buffers of allgather_base and reduce_scatter_base: one
+// contiguous tensor each, on the same GPU and of the same type, the output
+// having `outputFactor' elements for every `inputFactor' of the input.
+void check_gpu_flat_buffers(
+    const at::Tensor& output,
+    const at::Tensor& input,
+    int64_t outputFactor,
+    int64_t inputFactor) {
+  check_gpu_single_tensor(output);
+  check_gpu_single_tensor(input);
+  if (output.get_device() != input.get_device()) {
+    throw std::runtime_error(
+        "Input and output buffers must be on the same GPU device");
+  }
+  if (output.scalar_type() != input.scalar_type()) {
+    throw std::runtime_error("Input and output buffers must have identical type");
+  }
+  if (output.numel() * inputFactor != input.numel() * outputFactor) {
+    throw std::runtime_error(
+        "Buffer sizes do not match the world size: the output of allgather_base "
+        "and the input of reduce_scatter_base are world size times the other buffer");
+  }
+}
+
+// The tensors of one type of a coalesced collective, back to back in `flat'.
+// `indices' are the positions of these tensors in the tensor list.
+struct CoalescedBuffer {
+  std::vector<size_t> indices;
+  at::Tensor flat;
+  // Whether `flat' is a view of the only tensor, so that nothing has to be
+  // copied back into it.
+  bool isView;
+};
+
+// Groups `tensors' by type, in the order in which the types first appear, so
+// that a coalesced collective is one NCCL call per type.
+std::vector<CoalescedBuffer> coalesceByType(
+    const std::vector<at::Tensor>& tensors) {
+  std::vector<CoalescedBuffer> buffers;
+  std::map<at::ScalarType, size_t> bufferOfType;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    auto it = bufferOfType.emplace(tensors[i].scalar_type(), buffers.size());
+    if (it.second) {
+      buffers.emplace_back();
+    }
+    buffers[it.first->second].indices.push_back(i);
+  }
+  for (auto& buffer : buffers) {
+    const auto& first = tensors[buffer.indices.front()];
+    buffer.isView = buffer.indices.size() == 1 && first.is_contiguous();
+    if (buffer.isView) {
+      buffer.flat = first.view(-1);
+      continue;
+    }
+    std::vector<at::Tensor> parts;
+    parts.reserve(buffer.indices.size());
+    for (auto index : buffer.indices) {
+      parts.push_back(tensors[index].reshape(-1));
+    }
+    buffer.flat = at::cat(parts);
+  }
+  return buffers;
+}
+
 } // namespace
 
 std::shared_ptr<ProcessGroupNCCL::WorkNCCL> ProcessGroupNCCL::initWork(
@@ -865,6 +1128,10 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
     const AllreduceOptions& opts) {
   check_gpu_tensors(tensors);
 
+  if (useHierarchicalAllreduce(tensors)) {
+    return hierarchicalAllreduce(tensors[0], opts);
+  }
+
   return collective(
       tensors,
       tensors,
@@ -883,11 +1150,120 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
       });
 }
 
+bool ProcessGroupNCCL::useHierarchicalAllreduce(
+    const std::vector<at::Tensor>& tensors) const {
+  if (hierarchicalLocalSize_ == 0 || tensors.size() != 1) {
+    return false;
+  }
+  const auto& tensor = tensors[0];
+  return tensor.is_contiguous() &&
+      tensor.numel() % hierarchicalLocalSize_ == 0 &&
+      static_cast<size_t>(tensor.numel() * tensor.element_size()) >=
+      hierarchicalMinBytes_;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::hierarchicalAllreduce(
+    at::Tensor& tensor,
+    const AllreduceOptions& opts) {
+  const int64_t chunkSize = tensor.numel() / hierarchicalLocalSize_;
+  const int localRank = rank_ % hierarchicalLocalSize_;
+  std::vector<at::Tensor> full = {tensor};
+  std::vector<at::Tensor> chunk = {
+      tensor.view(-1).narrow(0, localRank * chunkSize, chunkSize)};
+
+  // All three collectives are in place: the chunk of a rank is at its offset
+  // in the tensor, which is where NCCL reads and writes it. Waiting on the
+  // work only makes the current stream wait, the next collective starts
+  // after it on the GPU.
+  intraNodeGroup_
+      ->collective(
+          full,
+          chunk,
+          [&](at::Tensor& input,
+              at::Tensor& output,
+              ncclComm_t comm,
+              at::cuda::CUDAStream& stream) {
+            return ncclReduceScatter(
+                input.data_ptr(),
+                output.data_ptr(),
+                output.numel(),
+                getNcclDataType(input.scalar_type()),
+                getNcclReduceOp(opts.reduceOp, input),
+                comm,
+                stream.stream());
+          })
+      ->wait();
+  interNodeGroup_->allreduce(chunk, opts)->wait();
+  return intraNodeGroup_->collective(
+      chunk,
+      full,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      });
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with NCCL");
+  check_gpu_tensors_same_device(tensors);
+
+  // The tensors are flattened into one buffer per type on the current
+  // stream, and the allreduce of all the buffers is one NCCL group.
+  auto buffers = coalesceByType(tensors);
+  std::vector<at::Tensor> first = {buffers.front().flat};
+
+  return collective(
+      first,
+      first,
+      [&](at::Tensor& /* unused */,
+          at::Tensor& /* unused */,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        for (auto& buffer : buffers) {
+          c10::cuda::CUDACachingAllocator::recordStream(
+              buffer.flat.storage().data_ptr(), stream);
+          C10D_NCCL_CHECK(ncclAllReduce(
+              buffer.flat.data_ptr(),
+              buffer.flat.data_ptr(),
+              buffer.flat.numel(),
+              getNcclDataType(buffer.flat.scalar_type()),
+              getNcclReduceOp(opts.reduceOp, buffer.flat),
+              comm,
+              stream.stream()));
+        }
+        return ncclSuccess;
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        // Copy the reduced buffers back to the tensors.
+        at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+        for (auto& buffer : buffers) {
+          if (buffer.isView) {
+            continue;
+          }
+          int64_t offset = 0;
+          for (auto index : buffer.indices) {
+            auto& tensor = tensors[index];
+            // See [Sync Streams].
+            c10::cuda::CUDACachingAllocator::recordStream(
+                tensor.storage().data_ptr(), ncclStreams[0]);
+            tensor.copy_(
+                buffer.flat.narrow(0, offset, tensor.numel())
+                    .view(tensor.sizes()),
+                true);
+            offset += tensor.numel();
+          }
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
@@ -982,11 +1358,84 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_coalesced(
-    std::vector<std::vector<at::Tensor>>& /* unused */,
-    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& outputTensorLists,
+    std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& /* unused */) {
-  throw std::runtime_error(
-      "ProcessGroupNCCL does not support allgather_coalesced");
+  check_gpu_tensors_same_device(inputTensors);
+  if (outputTensorLists.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "allgather_coalesced expects one output tensor list per rank");
+  }
+  for (const auto& outputTensors : outputTensorLists) {
+    if (outputTensors.size() != inputTensors.size()) {
+      throw std::runtime_error(
+          "allgather_coalesced expects as many output tensors per rank as input tensors");
+    }
+    for (size_t i = 0; i < inputTensors.size(); ++i) {
+      if (outputTensors[i].sizes() != inputTensors[i].sizes() ||
+          !outputTensors[i].options().type_equal(inputTensors[i].options())) {
+        throw std::runtime_error(
+            "allgather_coalesced expects output tensors with the type and size of their input tensor");
+      }
+    }
+  }
+
+  // One buffer per type holds the inputs of a rank back to back, the
+  // gathered buffer holds the buffers of all the ranks in rank order.
+  auto buffers = coalesceByType(inputTensors);
+  std::vector<at::Tensor> gathered;
+  gathered.reserve(buffers.size());
+  for (const auto& buffer : buffers) {
+    gathered.push_back(
+        at::empty({size_ * buffer.flat.numel()}, buffer.flat.options()));
+  }
+  std::vector<at::Tensor> first = {buffers.front().flat};
+
+  return collective(
+      first,
+      first,
+      [&](at::Tensor& /* unused */,
+          at::Tensor& /* unused */,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        for (size_t i = 0; i < buffers.size(); ++i) {
+          const auto& input = buffers[i].flat;
+          c10::cuda::CUDACachingAllocator::recordStream(
+              input.storage().data_ptr(), stream);
+          c10::cuda::CUDACachingAllocator::recordStream(
+              gathered[i].storage().data_ptr(), stream);
+          C10D_NCCL_CHECK(ncclAllGather(
+              input.data_ptr(),
+              gathered[i].data_ptr(),
+              input.numel(),
+              getNcclDataType(input.scalar_type()),
+              comm,
+              stream.stream()));
+        }
+        return ncclSuccess;
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        // Copy the gathered buffers to the output tensors.
+        at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+        for (size_t i = 0; i < buffers.size(); ++i) {
+          const int64_t bufferSize = buffers[i].flat.numel();
+          for (size_t rank = 0; rank < outputTensorLists.size(); ++rank) {
+            int64_t offset = static_cast<int64_t>(rank) * bufferSize;
+            for (auto index : buffers[i].indices) {
+              auto& output = outputTensorLists[rank][index];
+              // See [Sync Streams].
+              c10::cuda::CUDACachingAllocator::recordStream(
+                  output.storage().data_ptr(), ncclStreams[0]);
+              output.copy_(
+                  gathered[i].narrow(0, offset, output.numel())
+                      .view(output.sizes()),
+                  true);
+              offset += output.numel();
+            }
+          }
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
@@ -1033,6 +1482,34 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
       [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {});
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter_base(
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const ReduceScatterOptions& opts) {
+  check_gpu_flat_buffers(outputBuffer, inputBuffer, 1, size_);
+
+  std::vector<at::Tensor> inputTensors = {inputBuffer};
+  std::vector<at::Tensor> outputTensors = {outputBuffer};
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclReduceScatter(
+            input.data_ptr(),
+            output.data_ptr(),
+            output.numel(),
+            getNcclDataType(input.scalar_type()),
+            getNcclReduceOp(opts.reduceOp, input),
+            comm,
+            stream.stream());
+      });
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::barrier(
     const BarrierOptions& opts) {
   std::vector<at::Device> devices;
@@ -1189,11 +1666,30 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recvAnysource(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_base(
-    at::Tensor& /*unused */,
-    at::Tensor& /*unused */,
-    const AllgatherOptions& /*unused */) {
-  throw std::runtime_error(
-      "no support for allgather_base in NCCL process group");
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& /* unused */) {
+  check_gpu_flat_buffers(outputBuffer, inputBuffer, size_, 1);
+
+  std::vector<at::Tensor> inputTensors = {inputBuffer};
+  std::vector<at::Tensor> outputTensors = {outputBuffer};
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      });
 }
 
 } // namespace c10d
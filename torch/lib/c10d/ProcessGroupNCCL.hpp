@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
@@ -18,6 +19,20 @@ namespace c10d {
 // non-blocking.
 constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 
+// Environment variable which, when set to the number of GPUs per node,
+// enables the hierarchical allreduce: a reduce-scatter inside every node, an
+// allreduce of 1/local size of the tensor across the nodes, then an
+// allgather inside every node. Ranks are expected to be numbered node by
+// node, as launchers do.
+constexpr const char* NCCL_HIERARCHICAL_ALLREDUCE =
+    "NCCL_HIERARCHICAL_ALLREDUCE";
+
+// Tensors with fewer bytes than this use the flat allreduce, where the
+// latency of the three collectives of the hierarchical one does not pay off.
+// Defaults to 1MB.
+constexpr const char* NCCL_HIERARCHICAL_ALLREDUCE_MIN_BYTES =
+    "NCCL_HIERARCHICAL_ALLREDUCE_MIN_BYTES";
+
 // ProcessGroupNCCL implements NCCL bindings for c10d.
 //
 // All functions of the class are expected to be called in the same order
@@ -112,6 +127,10 @@ class ProcessGroupNCCL : public ProcessGroup {
     // Time point representing when the work started.
     std::chrono::time_point<std::chrono::steady_clock> workStartTime_;
 
+    // Whether isCompleted() returned true, which it then keeps doing without
+    // querying the events and communicators again.
+    std::atomic<bool> eventsCompleted_{false};
+
     // Wrapper method for the static checkForNCCLErrors which can be overridden
     // for tests.
     virtual std::exception_ptr checkForNCCLErrors(
@@ -245,12 +264,12 @@ class ProcessGroupNCCL : public ProcessGroup {
       (*thenFutCudaEvents)[0].record(stream);
     }
 
-    // We use addCallbackWithStream instead of addCallback.
-    void addCallback(std::function<void(void)> /* unused */) override {
-      C10_THROW_ERROR(
-          Error,
-          "FutureNCCL uses addCallbackWithStream instead of addCallback.");
-    }
+    // Invokes the callback once the cudaEvents completed on the GPU, inline
+    // if they already have, and otherwise from the thread polling the events
+    // of all the pending callbacks of the process, see
+    // Note [Completion callbacks of FutureNCCL]. Unlike then(), the callback
+    // may use the value on any stream.
+    void addCallback(std::function<void(void)> callback) override;
 
     // Adds a callback to FutureNCCL, and returns another FutureNCCL to hold
     // the return value of the callback and new cudaEvents that recorded the
@@ -352,6 +371,10 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
 
+  // The tensors of the coalesced collectives are on a single GPU and may
+  // have different types and sizes. They are flattened into one buffer per
+  // type and all the buffers are communicated in one NCCL group, instead of
+  // one collective per tensor.
   std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
       std::vector<at::Tensor>& tensors,
       const AllreduceCoalescedOptions& opts =
@@ -381,6 +404,11 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputTensors,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
@@ -482,6 +510,17 @@ class ProcessGroupNCCL : public ProcessGroup {
   // accordingly.
   void parseNcclBlockingWait();
 
+  // Reads the NCCL_HIERARCHICAL_ALLREDUCE environment variables and creates
+  // the process groups inside the node and across the nodes of this rank.
+  void initHierarchicalAllreduce();
+
+  // Whether allreduce of these tensors goes through the hierarchical one.
+  bool useHierarchicalAllreduce(const std::vector<at::Tensor>& tensors) const;
+
+  std::shared_ptr<ProcessGroup::Work> hierarchicalAllreduce(
+      at::Tensor& tensor,
+      const AllreduceOptions& opts);
+
  protected:
   static const int64_t kWatchdogThreadSleepMillis;
 
@@ -571,6 +610,14 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Timeout for operations. This is only used when blockingWait_ is enabled.
   std::chrono::milliseconds opTimeout_;
 
+  // Number of GPUs per node of the hierarchical allreduce, 0 when it is not
+  // enabled, and the process groups of the ranks of the node and of the
+  // ranks with the same local rank in the other nodes.
+  int hierarchicalLocalSize_ = 0;
+  size_t hierarchicalMinBytes_ = 1024 * 1024;
+  std::shared_ptr<ProcessGroupNCCL> intraNodeGroup_;
+  std::shared_ptr<ProcessGroupNCCL> interNodeGroup_;
+
   // Set of communicators that this process group has aborted and their
   // ncclUniqueId has been written to the store. We don't need a lock
   // for this map since only the watchdog thread accesses this set. The
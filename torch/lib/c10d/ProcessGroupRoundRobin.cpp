@@ -1,13 +1,19 @@
 #include <c10d/ProcessGroupRoundRobin.hpp>
 
+#include <algorithm>
+
 namespace c10d {
 
 ProcessGroupRoundRobin::ProcessGroupRoundRobin(
     int rank,
     int size,
-    std::vector<std::shared_ptr<ProcessGroup>> processGroups)
-    : ProcessGroup(rank, size), processGroups_(std::move(processGroups)) {
+    std::vector<std::shared_ptr<ProcessGroup>> processGroups,
+    int64_t stripeMinBytes)
+    : ProcessGroup(rank, size),
+      processGroups_(std::move(processGroups)),
+      stripeMinBytes_(stripeMinBytes) {
   TORCH_CHECK(processGroups_.size() >= 1);
+  TORCH_CHECK(stripeMinBytes_ >= 0);
   for (const auto& processGroup : processGroups_) {
     TORCH_CHECK(processGroup->getRank() == rank_);
     TORCH_CHECK(processGroup->getSize() == size_);
@@ -20,12 +26,24 @@ ProcessGroupRoundRobin::~ProcessGroupRoundRobin() {}
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::broadcast(
     std::vector<at::Tensor>& tensors,
     const BroadcastOptions& opts) {
+  if (shouldStripe(tensors)) {
+    return stripe(
+        tensors, [&](ProcessGroup& pg, std::vector<at::Tensor>& chunks) {
+          return pg.broadcast(chunks, opts);
+        });
+  }
   return next()->broadcast(tensors, opts);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
+  if (shouldStripe(tensors)) {
+    return stripe(
+        tensors, [&](ProcessGroup& pg, std::vector<at::Tensor>& chunks) {
+          return pg.allreduce(chunks, opts);
+        });
+  }
   return next()->allreduce(tensors, opts);
 }
 
@@ -38,6 +56,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce_coalesced(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
+  if (shouldStripe(tensors)) {
+    return stripe(
+        tensors, [&](ProcessGroup& pg, std::vector<at::Tensor>& chunks) {
+          return pg.reduce(chunks, opts);
+        });
+  }
   return next()->reduce(tensors, opts);
 }
 
@@ -120,6 +144,108 @@ const std::shared_ptr<ProcessGroup>& ProcessGroupRoundRobin::next() {
   return processGroup;
 }
 
+bool ProcessGroupRoundRobin::shouldStripe(
+    const std::vector<at::Tensor>& tensors) const {
+  // The chunks of the tensors of different devices must match up, and the
+  // decision must be the same in all processes, which it is as long as the
+  // tensors have the same number of elements everywhere, as the collectives
+  // require anyway.
+  if (stripeMinBytes_ == 0 || processGroups_.size() < 2 || tensors.empty()) {
+    return false;
+  }
+  for (const auto& tensor : tensors) {
+    if (!tensor.is_contiguous() || tensor.is_sparse() ||
+        tensor.numel() != tensors[0].numel()) {
+      return false;
+    }
+  }
+  return tensors[0].numel() * tensors[0].element_size() >= stripeMinBytes_;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::stripe(
+    std::vector<at::Tensor>& tensors,
+    const std::function<std::shared_ptr<ProcessGroup::Work>(
+        ProcessGroup&,
+        std::vector<at::Tensor>&)>& fn) {
+  const int64_t numel = tensors[0].numel();
+  const int64_t numChunks = std::min<int64_t>(processGroups_.size(), numel);
+  const int64_t chunkSize = (numel + numChunks - 1) / numChunks;
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+  works.reserve(numChunks);
+  for (int64_t i = 0; i < numChunks; i++) {
+    const int64_t start = i * chunkSize;
+    const int64_t length = std::min(chunkSize, numel - start);
+    if (length <= 0) {
+      break;
+    }
+    std::vector<at::Tensor> chunks;
+    chunks.reserve(tensors.size());
+    for (const auto& tensor : tensors) {
+      chunks.push_back(tensor.view({-1}).narrow(0, start, length));
+    }
+    works.push_back(fn(*processGroups_[i], chunks));
+  }
+  return std::make_shared<StripedWork>(tensors, std::move(works));
+}
+
+ProcessGroupRoundRobin::StripedWork::StripedWork(
+    std::vector<at::Tensor> tensors,
+    std::vector<std::shared_ptr<ProcessGroup::Work>> works)
+    : tensors_(std::move(tensors)), works_(std::move(works)) {}
+
+bool ProcessGroupRoundRobin::StripedWork::isCompleted() {
+  for (const auto& work : works_) {
+    if (!work->isCompleted()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ProcessGroupRoundRobin::StripedWork::isSuccess() const {
+  for (const auto& work : works_) {
+    if (!work->isSuccess()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::exception_ptr ProcessGroupRoundRobin::StripedWork::exception() const {
+  for (const auto& work : works_) {
+    if (auto exception = work->exception()) {
+      return exception;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<at::Tensor> ProcessGroupRoundRobin::StripedWork::result() const {
+  return tensors_;
+}
+
+void ProcessGroupRoundRobin::StripedWork::synchronize() {
+  for (const auto& work : works_) {
+    work->synchronize();
+  }
+}
+
+bool ProcessGroupRoundRobin::StripedWork::wait(
+    std::chrono::milliseconds timeout) {
+  // The chunks run concurrently, so that the timeout applies to each of them.
+  bool success = true;
+  for (const auto& work : works_) {
+    success = work->wait(timeout) && success;
+  }
+  return success;
+}
+
+void ProcessGroupRoundRobin::StripedWork::abort() {
+  for (const auto& work : works_) {
+    work->abort();
+  }
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allgather_base(
     at::Tensor& /*unused */,
     at::Tensor& /*unused */,
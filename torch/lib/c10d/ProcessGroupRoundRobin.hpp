@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include <c10d/ProcessGroup.hpp>
@@ -12,6 +13,14 @@ namespace c10d {
 // one of the specified process groups in a round robin fashion. Each process
 // group instance must have the same rank and size.
 //
+// If stripeMinBytes is positive, broadcast, allreduce and reduce of
+// contiguous tensors of at least that many bytes are instead striped: the
+// tensors are split into one chunk per process group, which run the
+// collective on their chunk concurrently, so that a single large collective
+// can use the network resources of all the process groups (e.g. a NCCL
+// process group per NIC, each with its own CUDA streams). The chunks are
+// views of the tensors, so that the results don't need to be reassembled.
+//
 // All functions of the class are expected to be called in the same order
 // across all processes in the process group. This is the only way that we
 // can guarantee to match up the same calls among all processes.
@@ -21,7 +30,8 @@ class ProcessGroupRoundRobin final : public ProcessGroup {
   explicit ProcessGroupRoundRobin(
       int rank,
       int size,
-      std::vector<std::shared_ptr<ProcessGroup>> processGroups);
+      std::vector<std::shared_ptr<ProcessGroup>> processGroups,
+      int64_t stripeMinBytes = 0);
 
   ~ProcessGroupRoundRobin() override;
 
@@ -97,11 +107,50 @@ class ProcessGroupRoundRobin final : public ProcessGroup {
       const BarrierOptions& opts = BarrierOptions()) override;
 
  private:
+  // Work of a striped collective, which completes once the collectives on
+  // all the chunks did.
+  class StripedWork : public ProcessGroup::Work {
+   public:
+    StripedWork(
+        std::vector<at::Tensor> tensors,
+        std::vector<std::shared_ptr<ProcessGroup::Work>> works);
+
+    bool isCompleted() override;
+
+    bool isSuccess() const override;
+
+    std::exception_ptr exception() const override;
+
+    std::vector<at::Tensor> result() const override;
+
+    void synchronize() override;
+
+    bool wait(std::chrono::milliseconds timeout = kNoTimeout) override;
+
+    void abort() override;
+
+   private:
+    const std::vector<at::Tensor> tensors_;
+    const std::vector<std::shared_ptr<ProcessGroup::Work>> works_;
+  };
+
   std::vector<std::shared_ptr<ProcessGroup>> processGroups_;
   std::vector<std::shared_ptr<ProcessGroup>>::const_iterator iterator_;
+  const int64_t stripeMinBytes_;
 
   // Returns the next ProcessGroup to use.
   const std::shared_ptr<ProcessGroup>& next();
+
+  // Returns whether the collective on the tensors is striped.
+  bool shouldStripe(const std::vector<at::Tensor>& tensors) const;
+
+  // Runs fn(processGroup, chunks) for the chunks of the tensors of each
+  // process group. fn returns the work of the collective on the chunks.
+  std::shared_ptr<ProcessGroup::Work> stripe(
+      std::vector<at::Tensor>& tensors,
+      const std::function<std::shared_ptr<ProcessGroup::Work>(
+          ProcessGroup&,
+          std::vector<at::Tensor>&)>& fn);
 };
 
 } // namespace c10d
@@ -28,6 +28,16 @@ class Store {
 
   virtual std::vector<uint8_t> get(const std::string& key) = 0;
 
+  // Sets or gets many keys at once. Stores that talk to a server do it in a
+  // single round trip, the default implementations call set and get for
+  // every key.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
   virtual int64_t add(const std::string& key, int64_t value) = 0;
 
   virtual bool check(const std::vector<std::string>& keys) = 0;
@@ -10,17 +10,56 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+// Every worker thread of the daemon serves about this many connections, up
+// to kMaxDaemonWorkerThreads threads.
+constexpr int kConnectionsPerDaemonWorkerThread = 128;
+constexpr int kMaxDaemonWorkerThreads = 8;
+
+size_t numDaemonWorkerThreads(int numWorkers) {
+  int numThreads = numWorkers / kConnectionsPerDaemonWorkerThread;
+  numThreads = std::min(numThreads, kMaxDaemonWorkerThreads);
+  numThreads =
+      std::min(numThreads, static_cast<int>(std::thread::hardware_concurrency()));
+  return std::max(numThreads, 1);
+}
+
+std::vector<std::string> recvKeys(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  return keys;
+}
+
+void sendKeys(int socket, const std::vector<std::string>& keys) {
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(socket, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(socket, keys[i], (i != (nkeys - 1)));
+  }
+}
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
-// Simply start the daemon thread
-TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
+// Simply start the daemon thread and its workers
+TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket, size_t numWorkerThreads)
     : storeListenSocket_(storeListenSocket) {
   // Use control pipe to signal instance destruction to the daemon thread.
   if (pipe(controlPipeFd_.data()) == -1) {
@@ -28,6 +67,18 @@ TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
         "Failed to create the control pipe to start the "
         "TCPStoreDaemon run");
   }
+  for (size_t i = 0; i < std::max<size_t>(numWorkerThreads, 1); i++) {
+    auto worker = std::unique_ptr<Worker>(new Worker());
+    if (pipe(worker->wakeupPipeFd.data()) == -1) {
+      throw std::runtime_error(
+          "Failed to create the wakeup pipe of a TCPStoreDaemon worker");
+    }
+    workers_.push_back(std::move(worker));
+  }
+  for (auto& worker : workers_) {
+    worker->thread =
+        std::thread(&TCPStoreDaemon::runWorker, this, std::ref(*worker));
+  }
   daemonThread_ = std::thread(&TCPStoreDaemon::run, this);
 }
 
@@ -36,11 +87,19 @@ TCPStoreDaemon::~TCPStoreDaemon() {
   stop();
   // Join the thread
   join();
-  // Close unclosed sockets
-  for (auto socket : sockets_) {
-    if (socket != -1) {
+  // Close unclosed sockets and the wakeup pipes
+  for (auto& worker : workers_) {
+    for (auto socket : worker->sockets) {
+      ::close(socket);
+    }
+    for (auto socket : worker->newSockets) {
       ::close(socket);
     }
+    for (auto fd : worker->wakeupPipeFd) {
+      if (fd != -1) {
+        ::close(fd);
+      }
+    }
   }
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
@@ -60,15 +119,27 @@ void TCPStoreDaemon::run() {
   // Push the read end of the pipe to signal the stopping of the daemon run
   fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
 
-  // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
+  // accept the connections
+  size_t nextWorker = 0;
+  while (true) {
+    for (auto& fd : fds) {
+      fd.revents = 0;
     }
 
     SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
 
+    // The pipe receives an event which tells us to shutdown the daemon
+    if (fds[1].revents != 0) {
+      // Will be POLLUP when the pipe is closed
+      if (fds[1].revents ^ POLLHUP) {
+        throw std::system_error(
+            ECONNABORTED,
+            std::system_category(),
+            "Unexpected poll revent on the control pipe's reading fd: " +
+                std::to_string(fds[1].revents));
+      }
+      break;
+    }
     // TCPStore's listening socket has an event and it should now be able to
     // accept new connections.
     if (fds[0].revents != 0) {
@@ -80,26 +151,56 @@ void TCPStoreDaemon::run() {
                 std::to_string(fds[0].revents));
       }
       int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
+      auto& worker = *workers_[nextWorker++ % workers_.size()];
+      {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.newSockets.push_back(sockFd);
+      }
+      const char wakeup = 0;
+      SYSCHECK_ERR_RETURN_NEG1(::write(worker.wakeupPipeFd[1], &wakeup, 1));
     }
-    // The pipe receives an event which tells us to shutdown the daemon
-    if (fds[1].revents != 0) {
-      // Will be POLLUP when the pipe is closed
-      if (fds[1].revents ^ POLLHUP) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the control pipe's reading fd: " +
-                std::to_string(fds[1].revents));
+  }
+
+  // Closing the write ends of the wakeup pipes stops the workers.
+  for (auto& worker : workers_) {
+    ::close(worker->wakeupPipeFd[1]);
+    worker->wakeupPipeFd[1] = -1;
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void TCPStoreDaemon::runWorker(Worker& worker) {
+  std::vector<struct pollfd> fds;
+  fds.push_back({.fd = worker.wakeupPipeFd[0], .events = POLLIN});
+
+  // receive the queries
+  while (true) {
+    for (auto& fd : fds) {
+      fd.revents = 0;
+    }
+
+    SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
+
+    // The daemon thread assigned new sockets, or closed the pipe.
+    if (fds[0].revents != 0) {
+      char buffer[64];
+      ssize_t bytesRead;
+      SYSCHECK_ERR_RETURN_NEG1(
+          bytesRead = ::read(fds[0].fd, buffer, sizeof(buffer)));
+      if (bytesRead == 0) {
+        break;
       }
-      finished = true;
-      break;
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      for (int socket : worker.newSockets) {
+        worker.sockets.push_back(socket);
+        fds.push_back({.fd = socket, .events = POLLIN});
+      }
+      worker.newSockets.clear();
     }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
+    // Skipping fds[0], the wakeup pipe's reading fd
+    for (size_t fdIdx = 1; fdIdx < fds.size(); ++fdIdx) {
       if (fds[fdIdx].revents == 0) {
         continue;
       }
@@ -115,32 +216,9 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
+        closeSocket(fds[fdIdx].fd);
         fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
+        worker.sockets.erase(worker.sockets.begin() + fdIdx - 1);
         --fdIdx;
         continue;
       }
@@ -156,11 +234,38 @@ void TCPStoreDaemon::stop() {
   }
 }
 
+void TCPStoreDaemon::closeSocket(int socket) {
+  // The socket is closed with the lock held, so that no other worker can
+  // wake it up once its number is reused by a new connection.
+  std::lock_guard<std::mutex> lock(mutex_);
+  ::close(socket);
+
+  // Remove all the tracking state of the close FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
+      if (*vecIt == socket) {
+        vecIt = it->second.erase(vecIt);
+      } else {
+        ++vecIt;
+      }
+    }
+    if (it->second.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+}
+
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of wait, check and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi set
+// type of query | number of keys | size of key1 | key1 | size of value1 |
+// value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -168,12 +273,18 @@ void TCPStoreDaemon::query(int socket) {
   if (qt == QueryType::SET) {
     setHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
   } else if (qt == QueryType::ADD) {
     addHandler(socket);
 
   } else if (qt == QueryType::GET) {
     getHandler(socket);
 
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
   } else if (qt == QueryType::CHECK) {
     checkHandler(socket);
 
@@ -190,8 +301,14 @@ void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   if (socketsToWait != waitingSockets_.end()) {
     for (int socket : socketsToWait->second) {
       if (--keysAwaited_[socket] == 0) {
-        tcputil::sendValue<WaitResponseType>(
-            socket, WaitResponseType::STOP_WAITING);
+        keysAwaited_.erase(socket);
+        try {
+          tcputil::sendValue<WaitResponseType>(
+              socket, WaitResponseType::STOP_WAITING);
+        } catch (...) {
+          // The waiting client is gone, the worker of its socket closes it.
+          // This must not fail the query of the client that set the key.
+        }
       }
     }
     waitingSockets_.erase(socketsToWait);
@@ -200,43 +317,83 @@ void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
 
 void TCPStoreDaemon::setHandler(int socket) {
   std::string key = tcputil::recvString(socket);
-  tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+  auto value = tcputil::recvVector<uint8_t>(socket);
+  std::lock_guard<std::mutex> lock(mutex_);
+  tcpStore_[key] = std::move(value);
   // On "set", wake up all clients that have been waiting
   wakeupWaitingClients(key);
 }
 
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  std::vector<std::vector<uint8_t>> values(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+    values[i] = tcputil::recvVector<uint8_t>(socket);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < nargs; i++) {
+    tcpStore_[keys[i]] = std::move(values[i]);
+    wakeupWaitingClients(keys[i]);
+  }
+}
+
 void TCPStoreDaemon::addHandler(int socket) {
   std::string key = tcputil::recvString(socket);
   int64_t addVal = tcputil::recvValue<int64_t>(socket);
 
-  if (tcpStore_.find(key) != tcpStore_.end()) {
-    auto buf = reinterpret_cast<const char*>(tcpStore_[key].data());
-    auto len = tcpStore_[key].size();
-    addVal += std::stoll(std::string(buf, len));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tcpStore_.find(key) != tcpStore_.end()) {
+      auto buf = reinterpret_cast<const char*>(tcpStore_[key].data());
+      auto len = tcpStore_[key].size();
+      addVal += std::stoll(std::string(buf, len));
+    }
+    auto addValStr = std::to_string(addVal);
+    tcpStore_[key] = std::vector<uint8_t>(addValStr.begin(), addValStr.end());
+    // On "add", wake up all clients that have been waiting
+    wakeupWaitingClients(key);
   }
-  auto addValStr = std::to_string(addVal);
-  tcpStore_[key] = std::vector<uint8_t>(addValStr.begin(), addValStr.end());
   // Now send the new value
   tcputil::sendValue<int64_t>(socket, addVal);
-  // On "add", wake up all clients that have been waiting
-  wakeupWaitingClients(key);
 }
 
-void TCPStoreDaemon::getHandler(int socket) const {
+void TCPStoreDaemon::getHandler(int socket) {
   std::string key = tcputil::recvString(socket);
-  auto data = tcpStore_.at(key);
+  std::vector<uint8_t> data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data = tcpStore_.at(key);
+  }
   tcputil::sendVector<uint8_t>(socket, data);
 }
 
-void TCPStoreDaemon::checkHandler(int socket) const {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+void TCPStoreDaemon::multiGetHandler(int socket) {
+  auto keys = recvKeys(socket);
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& key : keys) {
+      values.push_back(tcpStore_.at(key));
+    }
+  }
+  for (size_t i = 0; i < values.size(); i++) {
+    tcputil::sendVector<uint8_t>(socket, values[i], (i != (values.size() - 1)));
   }
+}
+
+void TCPStoreDaemon::checkHandler(int socket) {
+  auto keys = recvKeys(socket);
   // Now we have received all the keys
-  if (checkKeys(keys)) {
+  bool ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready = checkKeys(keys);
+  }
+  if (ready) {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
   } else {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::NOT_READY);
@@ -244,13 +401,19 @@ void TCPStoreDaemon::checkHandler(int socket) const {
 }
 
 void TCPStoreDaemon::waitHandler(int socket) {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
-  }
-  if (checkKeys(keys)) {
+  auto keys = recvKeys(socket);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Only the keys that are missing are awaited, a key that is already set
+  // may never be set again.
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  keys.erase(
+      std::remove_if(
+          keys.begin(),
+          keys.end(),
+          [this](const std::string& key) { return tcpStore_.count(key) > 0; }),
+      keys.end());
+  if (keys.empty()) {
     tcputil::sendValue<WaitResponseType>(
         socket, WaitResponseType::STOP_WAITING);
   } else {
@@ -286,8 +449,8 @@ TCPStore::TCPStore(
     // Opening up the listening socket
     std::tie(masterListenSocket_, tcpStorePort_) = tcputil::listen(masterPort);
     // Now start the daemon
-    tcpStoreDaemon_ = std::unique_ptr<TCPStoreDaemon>(
-        new TCPStoreDaemon(masterListenSocket_));
+    tcpStoreDaemon_ = std::unique_ptr<TCPStoreDaemon>(new TCPStoreDaemon(
+        masterListenSocket_, numDaemonWorkerThreads(numWorkers_)));
   }
   // Connect to the daemon
   storeSocket_ = tcputil::connect(
@@ -340,6 +503,39 @@ void TCPStore::set(const std::string& key, const std::vector<uint8_t>& data) {
   tcputil::sendVector<uint8_t>(storeSocket_, data);
 }
 
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::runtime_error("multiSet expects as many values as keys");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regularPrefix_ + keys[i], true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.push_back(regularPrefix_ + key);
+  }
+  // One wait for all the keys, then one round trip for all the values.
+  waitHelper_(regKeys, timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  sendKeys(storeSocket_, regKeys);
+  std::vector<std::vector<uint8_t>> values(regKeys.size());
+  for (auto& value : values) {
+    value = tcputil::recvVector<uint8_t>(storeSocket_);
+  }
+  return values;
+}
+
 std::vector<uint8_t> TCPStore::get(const std::string& key) {
   std::string regKey = regularPrefix_ + key;
   return getHelper_(regKey);
@@ -365,13 +561,13 @@ int64_t TCPStore::addHelper_(const std::string& key, int64_t value) {
 }
 
 bool TCPStore::check(const std::vector<std::string>& keys) {
-  tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK);
-  SizeType nkeys = keys.size();
-  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
-  for (size_t i = 0; i < nkeys; i++) {
-    std::string regKey = regularPrefix_ + keys[i];
-    tcputil::sendString(storeSocket_, regKey, (i != (nkeys - 1)));
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.push_back(regularPrefix_ + key);
   }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK);
+  sendKeys(storeSocket_, regKeys);
   auto checkResponse = tcputil::recvValue<CheckResponseType>(storeSocket_);
   if (checkResponse == CheckResponseType::READY) {
     return true;
@@ -412,11 +608,7 @@ void TCPStore::waitHelper_(
         sizeof(timeoutTV)));
   }
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
-  SizeType nkeys = keys.size();
-  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
-  for (size_t i = 0; i < nkeys; i++) {
-    tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
-  }
+  sendKeys(storeSocket_, keys);
   auto waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
   if (waitResponse != WaitResponseType::STOP_WAITING) {
     throw std::runtime_error("Stop_waiting response is expected");
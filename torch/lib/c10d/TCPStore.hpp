@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 
@@ -9,36 +10,59 @@
 
 namespace c10d {
 
+// The daemon thread accepts the connections and hands them out round-robin
+// to the worker threads, each of which polls its own sockets and serves
+// their queries. The keys and the waiting clients are shared by the workers
+// and guarded by mutex_, the sockets are only read outside of it.
 class TCPStoreDaemon {
  public:
-  explicit TCPStoreDaemon(int storeListenSocket);
+  explicit TCPStoreDaemon(int storeListenSocket, size_t numWorkerThreads = 1);
   ~TCPStoreDaemon();
 
   void join();
 
  protected:
+  struct Worker {
+    std::thread thread;
+    // The daemon thread writes to the pipe when it assigned new sockets to
+    // the worker, and closes it to stop the worker.
+    std::vector<int> wakeupPipeFd{-1, -1};
+    // Sockets assigned by the daemon thread, guarded by mutex.
+    std::mutex mutex;
+    std::vector<int> newSockets;
+    // Sockets polled by the worker, only used by its thread.
+    std::vector<int> sockets;
+  };
+
   void run();
+  void runWorker(Worker& worker);
   void stop();
+  void closeSocket(int socket);
 
   void query(int socket);
 
   void setHandler(int socket);
+  void multiSetHandler(int socket);
   void addHandler(int socket);
-  void getHandler(int socket) const;
-  void checkHandler(int socket) const;
+  void getHandler(int socket);
+  void multiGetHandler(int socket);
+  void checkHandler(int socket);
   void waitHandler(int socket);
 
+  // Both expect mutex_ to be held.
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
 
   std::thread daemonThread_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex mutex_;
   std::unordered_map<std::string, std::vector<uint8_t>> tcpStore_;
   // From key -> the list of sockets waiting on it
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
 
-  std::vector<int> sockets_;
   int storeListenSocket_;
   std::vector<int> controlPipeFd_{-1, -1};
 };
@@ -59,6 +83,13 @@ class TCPStore : public Store {
 
   std::vector<uint8_t> get(const std::string& key) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
   int64_t add(const std::string& key, int64_t value) override;
 
   bool check(const std::vector<std::string>& keys) override;
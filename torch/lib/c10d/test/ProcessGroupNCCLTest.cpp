@@ -1,3 +1,4 @@
+#include <future>
 #include <iostream>
 
 #include <c10d/FileStore.hpp>
@@ -380,6 +381,31 @@ void testReduceScatter(const std::string& path, int rank, int size) {
   }
 }
 
+void testFutureCallback(const std::string& path, int rank, int size) {
+  auto test = NCCLTestBase(path);
+  test.initialize(rank, size);
+  at::cuda::CUDAGuard deviceGuard(0);
+
+  // The callbacks run once the allreduce completed, from the thread polling
+  // the events when it didn't complete yet.
+  std::vector<std::promise<float>> promises(4);
+  for (auto& promise : promises) {
+    std::vector<at::Tensor> tensors = {at::ones({1024}, at::kCUDA)};
+    auto work = test.getProcessGroup().allreduce(tensors);
+    auto fut = work->getFuture();
+    fut->addCallback([fut, &promise]() {
+      auto tensor = fut->value().toTensorVector()[0];
+      promise.set_value(tensor[0].item<float>());
+    });
+  }
+  for (auto& promise : promises) {
+    auto result = promise.get_future();
+    ASSERT_EQ(
+        result.wait_for(std::chrono::seconds(60)), std::future_status::ready);
+    EXPECT_EQ(result.get(), size);
+  }
+}
+
 class ProcessGroupNCCLTest: public ::testing::Test {
  protected:
   void SetUp() override {
@@ -462,3 +488,13 @@ TEST_F(ProcessGroupNCCLTest, testReduceScatter) {
     testReduceScatter(file.path, rank_, size_);
   }
 }
+
+TEST_F(ProcessGroupNCCLTest, testFutureCallback) {
+  if (skipTest()) {
+    return;
+  }
+  {
+    TemporaryFile file;
+    testFutureCallback(file.path, rank_, size_);
+  }
+}
@@ -116,3 +116,59 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testMultiSetGetAcrossDaemonWorkers) {
+  // Enough workers for the daemon to serve the connections with several
+  // threads.
+  const auto numWorkers = 512;
+  const auto numClients = 8;
+  auto serverStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1",
+      0,
+      numWorkers,
+      true,
+      std::chrono::seconds(30),
+      /* wait */ false);
+
+  std::vector<std::shared_ptr<c10d::TCPStore>> clientStores;
+  for (auto i = 0; i < numClients; i++) {
+    clientStores.push_back(std::make_shared<c10d::TCPStore>(
+        "127.0.0.1",
+        serverStore->getPort(),
+        numWorkers,
+        false,
+        std::chrono::seconds(30),
+        /* wait */ false));
+  }
+
+  // Every client waits for the keys of all the clients, which are set on
+  // other connections and so likely by other daemon threads.
+  std::vector<std::string> keys;
+  for (auto i = 0; i < numClients; i++) {
+    keys.push_back("key_" + std::to_string(i));
+  }
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < numClients; i++) {
+    threads.push_back(std::thread([&clientStores, &keys, i] {
+      std::string value = "value_" + std::to_string(i);
+      clientStores[i]->multiSet(
+          {keys[i], "other_" + std::to_string(i)},
+          {std::vector<uint8_t>(value.begin(), value.end()),
+           std::vector<uint8_t>()});
+      auto values = clientStores[i]->multiGet(keys);
+      EXPECT_EQ(keys.size(), values.size());
+      for (size_t j = 0; j < values.size(); j++) {
+        EXPECT_EQ(
+            "value_" + std::to_string(j),
+            std::string(values[j].begin(), values[j].end()));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // A wait on keys that are already set returns immediately.
+  serverStore->wait(keys);
+  c10d::test::check(*serverStore, "key_0", "value_0");
+}
@@ -4,6 +4,10 @@
 
 #ifdef __cplusplus
 
+#include <atomic>
+#include <memory>
+#include <string>
+
 void libshm_init(const char *manager_exec_path);
 
 // Superclass to run a constructor before THRefcountedMapAllocator
@@ -30,4 +34,46 @@ public:
   const char* manager_handle() const { return manager_handle_.c_str(); }
 };
 
+// Enables the pool of shared memory segments of this process, or disables it
+// and releases its segments. The blocks still used keep their segment alive.
+void libshm_set_pool_enabled(bool enabled);
+
+struct THManagedSegment;
+
+// A storage carved out of a large shared memory segment shared by many
+// storages. The segment is created through a THManagedMapAllocator, and each
+// process maps it once, so that creating, sharing and freeing a block takes no
+// system calls. A block is refcounted across processes like a
+// THRefcountedMapAllocator, and is recycled by the process which created it
+// once no process uses it anymore.
+class THManagedBlock {
+public:
+  THManagedBlock(std::shared_ptr<THManagedSegment> segment, size_t offset);
+  THManagedBlock(const THManagedBlock&) = delete;
+  THManagedBlock& operator=(const THManagedBlock&) = delete;
+  ~THManagedBlock();
+
+  // Returns a null DataPtr if the pool is disabled or `size` is too large
+  // to be pooled (see TORCH_SHM_POOL_MAX_BLOCK_SIZE).
+  static at::DataPtr allocate(size_t size);
+  // Whether `handle` was returned by THManagedBlock::handle().
+  static bool isHandle(const char* handle);
+  static at::DataPtr makeDataPtr(const char* manager_handle, const char* handle);
+  static THManagedBlock* fromDataPtr(const at::DataPtr&);
+
+  void* data() const;
+  void incref();
+  int decref();
+
+  const char* manager_handle() const;
+  // Identifies the block to the other processes, for makeDataPtr.
+  std::string handle() const;
+
+private:
+  std::atomic<int>& refcount() const;
+
+  std::shared_ptr<THManagedSegment> segment_;
+  size_t offset_;
+};
+
 #endif
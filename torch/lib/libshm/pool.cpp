@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <TH/TH.h>
+#include <libshm/libshm.h>
+
+// Blocks are aligned like the data of a THRefcountedMapAllocator, and each
+// starts with its refcount.
+static constexpr size_t kBlockAlignment = 64;
+static_assert(sizeof(std::atomic<int>) <= kBlockAlignment, "block header too large");
+
+static size_t get_env_size(const char* name, size_t default_value) {
+  const char* value = std::getenv(name);
+  if (!value || !*value) {
+    return default_value;
+  }
+  char* end;
+  unsigned long long size = std::strtoull(value, &end, 10);
+  TORCH_CHECK(*end == '\0', "invalid value of ", name, ": ", value);
+  return size;
+}
+
+static size_t segment_size() {
+  static const size_t size = std::max<size_t>(
+      get_env_size("TORCH_SHM_POOL_SEGMENT_SIZE", 64 << 20), 2 * kBlockAlignment);
+  return size;
+}
+
+// Larger storages get a file of their own.
+static size_t max_block_size() {
+  static const size_t size = std::min<size_t>(
+      get_env_size("TORCH_SHM_POOL_MAX_BLOCK_SIZE", 4 << 20),
+      segment_size() - kBlockAlignment);
+  return size;
+}
+
+static std::string new_segment_filename() {
+  static std::random_device rd;
+  std::string filename = "/torch_";
+  filename += std::to_string(getpid());
+  filename += "_";
+  filename += std::to_string(rd());
+  return filename;
+}
+
+// A segment mapped by this process. The free and used blocks are only tracked
+// by the process which created the segment, under pool_mutex.
+struct THManagedSegment {
+  THManagedSegment(const char* manager_handle, const std::string& filename, int flags, size_t size, bool owned)
+    : mapping(manager_handle, filename.c_str(), flags, size), size(size), owned(owned) {}
+
+  char* data() { return static_cast<char*>(mapping.data()); }
+
+  std::atomic<int>& refcount(size_t offset) {
+    return *reinterpret_cast<std::atomic<int>*>(data() + offset);
+  }
+
+  // First fit, so that the pages used last are reused.
+  bool carve(size_t block_size, size_t& offset) {
+    for (auto it = free_blocks.begin(); it != free_blocks.end(); ++it) {
+      if (it->second < block_size) {
+        continue;
+      }
+      offset = it->first;
+      const size_t remaining = it->second - block_size;
+      free_blocks.erase(it);
+      if (remaining > 0) {
+        free_blocks.emplace(offset + block_size, remaining);
+      }
+      used_blocks.emplace(offset, block_size);
+      new (&refcount(offset)) std::atomic<int>(1);
+      return true;
+    }
+    return false;
+  }
+
+  void release(size_t offset) {
+    auto used = used_blocks.find(offset);
+    size_t block_size = used->second;
+    used_blocks.erase(used);
+    // merge with the neighbouring free blocks
+    auto next = free_blocks.lower_bound(offset);
+    if (next != free_blocks.end() && offset + block_size == next->first) {
+      block_size += next->second;
+      next = free_blocks.erase(next);
+    }
+    if (next != free_blocks.begin()) {
+      auto prev = std::prev(next);
+      if (prev->first + prev->second == offset) {
+        prev->second += block_size;
+        return;
+      }
+    }
+    free_blocks.emplace(offset, block_size);
+  }
+
+  // Recycles the blocks last used by other processes.
+  void reclaim() {
+    std::vector<size_t> unused;
+    for (const auto& block : used_blocks) {
+      if (refcount(block.first).load() == 0) {
+        unused.push_back(block.first);
+      }
+    }
+    for (size_t offset : unused) {
+      release(offset);
+    }
+  }
+
+  THManagedMapAllocator mapping;
+  const size_t size;
+  const bool owned;
+  std::map<size_t, size_t> free_blocks; // offset -> size
+  std::unordered_map<size_t, size_t> used_blocks; // offset -> size
+};
+
+struct PoolState {
+  bool enabled = false;
+  // all the segments mapped by this process, by filename
+  std::unordered_map<std::string, std::weak_ptr<THManagedSegment>> mapped_segments;
+  // the segments this process carves blocks out of
+  std::vector<std::shared_ptr<THManagedSegment>> owned_segments;
+};
+
+static std::mutex pool_mutex;
+// Leaked on purpose: the segments are closed through the manager sockets,
+// which may already be destroyed at exit. The manager frees them then.
+static PoolState* pool_state = nullptr;
+
+// Requires pool_mutex.
+static PoolState& get_pool_state() {
+  if (!pool_state) {
+    pool_state = new PoolState();
+    // The segments of the parent are not the child's to carve blocks out of,
+    // nor to close.
+    static int registered = pthread_atfork(nullptr, nullptr, [] { pool_state = nullptr; });
+    (void)registered;
+  }
+  return *pool_state;
+}
+
+void libshm_set_pool_enabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  PoolState& state = get_pool_state();
+  state.enabled = enabled;
+  if (!enabled) {
+    state.owned_segments.clear();
+  }
+}
+
+THManagedBlock::THManagedBlock(std::shared_ptr<THManagedSegment> segment, size_t offset)
+  : segment_(std::move(segment)), offset_(offset) {}
+
+THManagedBlock::~THManagedBlock() {
+  if (segment_->owned) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    if (--refcount() == 0) {
+      segment_->release(offset_);
+    }
+  } else {
+    --refcount();
+  }
+}
+
+static void deleteTHManagedBlock(void* ptr) {
+  delete static_cast<THManagedBlock*>(ptr);
+}
+
+at::DataPtr THManagedBlock::allocate(size_t size) {
+  if (size > max_block_size()) {
+    return {};
+  }
+  const size_t block_size =
+      kBlockAlignment + (size + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+  std::shared_ptr<THManagedSegment> segment;
+  size_t offset;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    PoolState& state = get_pool_state();
+    if (!state.enabled) {
+      return {};
+    }
+    const auto carve = [&]() {
+      for (const auto& owned : state.owned_segments) {
+        if (owned->carve(block_size, offset)) {
+          segment = owned;
+          return true;
+        }
+      }
+      return false;
+    };
+    if (!carve()) {
+      for (const auto& owned : state.owned_segments) {
+        owned->reclaim();
+      }
+      if (!carve()) {
+        const std::string filename = new_segment_filename();
+        segment = std::make_shared<THManagedSegment>(
+            "", filename, TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE,
+            segment_size(), /*owned=*/true);
+        segment->free_blocks.emplace(0, segment->size);
+        state.mapped_segments[filename] = segment;
+        state.owned_segments.push_back(segment);
+        segment->carve(block_size, offset);
+      }
+    }
+  }
+  auto* block = new THManagedBlock(std::move(segment), offset);
+  return {block->data(), block, &deleteTHManagedBlock, at::DeviceType::CPU};
+}
+
+// <segment filename>:<segment size>:<offset>
+bool THManagedBlock::isHandle(const char* handle) {
+  return std::strchr(handle, ':') != nullptr;
+}
+
+std::string THManagedBlock::handle() const {
+  std::string handle = segment_->mapping.filename();
+  handle += ":";
+  handle += std::to_string(segment_->size);
+  handle += ":";
+  handle += std::to_string(offset_);
+  return handle;
+}
+
+at::DataPtr THManagedBlock::makeDataPtr(const char* manager_handle, const char* handle) {
+  const char* size_begin = std::strchr(handle, ':');
+  const char* offset_begin = size_begin ? std::strchr(size_begin + 1, ':') : nullptr;
+  TORCH_CHECK(offset_begin, "invalid shared memory block handle ", handle);
+  const std::string filename(handle, size_begin);
+  const size_t size = std::strtoull(size_begin + 1, nullptr, 10);
+  const size_t offset = std::strtoull(offset_begin + 1, nullptr, 10);
+
+  std::shared_ptr<THManagedSegment> segment;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    PoolState& state = get_pool_state();
+    auto& mapped = state.mapped_segments[filename];
+    segment = mapped.lock();
+    if (!segment) {
+      segment = std::make_shared<THManagedSegment>(
+          manager_handle, filename, TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE,
+          size, /*owned=*/false);
+      mapped = segment;
+      // forget the segments unmapped since
+      for (auto it = state.mapped_segments.begin(); it != state.mapped_segments.end();) {
+        it = it->second.expired() ? state.mapped_segments.erase(it) : std::next(it);
+      }
+    }
+  }
+  auto* block = new THManagedBlock(std::move(segment), offset);
+  ++block->refcount();
+  return {block->data(), block, &deleteTHManagedBlock, at::DeviceType::CPU};
+}
+
+THManagedBlock* THManagedBlock::fromDataPtr(const at::DataPtr& dptr) {
+  return dptr.cast_context<THManagedBlock>(&deleteTHManagedBlock);
+}
+
+std::atomic<int>& THManagedBlock::refcount() const {
+  return segment_->refcount(offset_);
+}
+
+void* THManagedBlock::data() const {
+  return segment_->data() + offset_ + kBlockAlignment;
+}
+
+// A block shared with another process also keeps its segment alive, until
+// that process has mapped it.
+void THManagedBlock::incref() {
+  ++refcount();
+  segment_->mapping.incref();
+}
+
+int THManagedBlock::decref() {
+  segment_->mapping.decref();
+  return --refcount() == 0;
+}
+
+const char* THManagedBlock::manager_handle() const {
+  return segment_->mapping.manager_handle();
+}
@@ -23,4 +23,23 @@ public:
   const char* manager_handle() const { return "no_manager"; }
 };
 
+// Storages are not pooled on Windows, see torch/lib/libshm/libshm.h.
+inline void libshm_set_pool_enabled(bool enabled) {}
+
+class THManagedBlock {
+public:
+  static at::DataPtr allocate(size_t size) { return {}; }
+  static bool isHandle(const char* handle) { return false; }
+  static at::DataPtr makeDataPtr(const char* manager_handle, const char* handle) {
+    AT_ERROR("shared memory blocks are not supported on Windows");
+  }
+  static THManagedBlock* fromDataPtr(const at::DataPtr&) { return nullptr; }
+
+  void incref() {}
+  int decref() { return 0; }
+
+  const char* manager_handle() const { return "no_manager"; }
+  std::string handle() const { return ""; }
+};
+
 #endif
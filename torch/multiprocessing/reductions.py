@@ -98,7 +98,8 @@ def rebuild_tensor(cls, storage, metadata):
 
 def rebuild_cuda_tensor(tensor_cls, tensor_size, tensor_stride, tensor_offset,
                         storage_cls, storage_device, storage_handle, storage_size_bytes, storage_offset_bytes,
-                        requires_grad, ref_counter_handle, ref_counter_offset, event_handle, event_sync_required):
+                        requires_grad, ref_counter_handle, ref_counter_offset, event_handle, event_sync_required,
+                        pooled):
     # If storage_handle is None, storage points to nullptr.
     if storage_handle is None or storage_size_bytes == 0:
         storage = storage_cls(0)
@@ -114,11 +115,12 @@ def rebuild_cuda_tensor(tensor_cls, tensor_size, tensor_stride, tensor_offset,
                 ref_counter_handle,
                 ref_counter_offset,
                 event_handle,
-                event_sync_required)
+                event_sync_required,
+                pooled)
             shared_cache[(storage_handle, storage_offset_bytes)] = StorageWeakRef(storage)
         else:
             # We already ref counting this Storage, but producer needs new ref-counters to be released.
-            storage_cls._release_ipc_counter(ref_counter_handle, ref_counter_offset)
+            storage_cls._release_ipc_counter(ref_counter_handle, ref_counter_offset, pooled)
 
     t = torch._utils._rebuild_tensor(storage, tensor_offset, tensor_size, tensor_stride)
     if tensor_cls == torch.nn.parameter.Parameter:
@@ -237,7 +239,8 @@ def reduce_tensor(tensor):
          ref_counter_handle,
          ref_counter_offset,
          event_handle,
-         event_sync_required) = storage._share_cuda_()
+         event_sync_required,
+         pooled) = storage._share_cuda_()
         tensor_offset = tensor.storage_offset()
         shared_cache[handle] = StorageWeakRef(storage)
         # _backward_hooks purposely omitted here, see
@@ -256,7 +259,8 @@ def reduce_tensor(tensor):
                  ref_counter_handle,
                  ref_counter_offset,
                  event_handle,
-                 event_sync_required))
+                 event_sync_required,
+                 pooled))
 
     # _backward_hooks purposely omitted here, see Note [Don't serialize hooks]
     metadata = (tensor.storage_offset(), tensor.size(), tensor.stride(), tensor.requires_grad)
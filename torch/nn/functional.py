@@ -2458,6 +2458,12 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
                 reduction=reduction)
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
+    if not torch.jit.is_scripting():
+        if (input.dim() == 2 and target.dim() == 1 and input.device.type == 'cpu' and
+                input.layout == torch.strided and input.dtype in (torch.float, torch.double)):
+            # fused CPU path that never materializes log_softmax(input)
+            return torch._C._nn._log_softmax_nll_loss_forward(
+                input, target, weight, _Reduction.get_enum(reduction), ignore_index)[0]
     return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
 
 
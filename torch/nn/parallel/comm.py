@@ -56,6 +56,30 @@ def broadcast_coalesced(tensors, devices, buffer_size=10485760):
     return torch._C._broadcast_coalesced(tensors, devices, buffer_size)
 
 
+def broadcast_coalesced_async(tensors, devices, buffer_size=10485760, streams=None):
+    """Broadcasts a sequence tensors to the specified GPUs, like
+    :func:`broadcast_coalesced`, without waiting for the broadcasts.
+
+    Arguments:
+        tensors (sequence): tensors to broadcast. Must be on the same device,
+          either CPU or GPU.
+        devices (Iterable[torch.device, str or int]): an iterable of GPU
+          devices, among which to broadcast.
+        buffer_size (int): maximum size of the buffer used for coalescing
+        streams (Iterable[torch.cuda.Stream], optional): the streams on which
+          to broadcast, one per device. Streams from the pool are used for
+          the ones which are ``None``, or if this is not given.
+
+    Returns:
+        A tuple containing copies of :attr:`tensor`, placed on :attr:`devices`,
+        and a list of :class:`torch.cuda.Event`, one per device. The copies on
+        ``devices[i]`` may only be used after ``events[i]``, e.g. after
+        ``torch.cuda.current_stream(devices[i]).wait_event(events[i])``.
+    """
+    devices = [_get_device_index(d) for d in devices]
+    return torch._C._broadcast_coalesced_async(tensors, devices, buffer_size, streams)
+
+
 def reduce_add(inputs, destination=None):
     """Sums tensors from multiple GPUs.
 
@@ -3,6 +3,7 @@ import copy
 import itertools
 import os
 import inspect
+import time
 
 import torch
 
@@ -699,6 +700,134 @@ class DistributedDataParallel(Module):
         self._check_comm_hook(hook)
         dist._register_comm_hook(self.reducer, state, hook)
 
+    def _register_builtin_comm_hook(self, comm_hook_type, matrix_approximation_rank=1, topk_ratio=0.01):
+        r"""
+        Register one of the communication hooks that are implemented in C++.
+        Unlike the hooks of ``_register_comm_hook``, they do not acquire the
+        GIL for every bucket.
+
+        Arguments:
+            comm_hook_type (dist.BuiltinCommHookType): the hook to register:
+
+                - ``ALLREDUCE``: averages the gradients with an allreduce, like
+                  DDP without a hook.
+                - ``FP16_COMPRESS``: casts the buckets to half precision for the
+                  allreduce, halving the bytes sent.
+                - ``POWER_SGD``: allreduces the factors of a low rank
+                  approximation of every bucket (PowerSGD), with error feedback.
+                - ``TOPK``: allgathers only the ``topk_ratio`` entries of every
+                  bucket with the largest magnitude, with error feedback.
+            matrix_approximation_rank (int): rank of the approximation of
+                ``POWER_SGD``. Default: 1
+            topk_ratio (float): ratio of the entries of a bucket that ``TOPK``
+                sends. Default: 0.01
+
+        .. warning ::
+            These hooks use ``get_future`` and only support the NCCL backend.
+
+        .. warning ::
+            DDP communication hook can only be registered once and should be registered
+            before calling backward.
+
+        Example::
+            >>> ddp._register_builtin_comm_hook(dist.BuiltinCommHookType.FP16_COMPRESS)
+        """
+        dist._register_builtin_comm_hook(
+            self.reducer, self.process_group, comm_hook_type,
+            matrix_approximation_rank, topk_ratio)
+
+    def _measure_allreduce_cost(self, small_bytes=2 ** 12, large_bytes=2 ** 24, iterations=5):
+        r"""
+        Time allreduces of two sizes on the device and with the process group
+        of the parameters, and fit ``time = latency + bytes / bandwidth`` to
+        them. Returns ``(latency, bandwidth)`` in seconds and bytes per second.
+        """
+        param = next(self.module.parameters())
+
+        def timed(nbytes):
+            tensor = torch.zeros(nbytes // param.element_size(), dtype=param.dtype, device=param.device)
+            # The first allreduce also sets up the communicators.
+            self.process_group.allreduce([tensor]).wait()
+            if tensor.is_cuda:
+                torch.cuda.synchronize(tensor.device)
+            start = time.perf_counter()
+            for _ in range(iterations):
+                self.process_group.allreduce([tensor]).wait()
+            if tensor.is_cuda:
+                torch.cuda.synchronize(tensor.device)
+            return (time.perf_counter() - start) / iterations
+
+        small_time = timed(small_bytes)
+        large_time = timed(large_bytes)
+        time_per_byte = max(large_time - small_time, 1e-12) / (large_bytes - small_bytes)
+        latency = max(small_time - small_bytes * time_per_byte, 0.0)
+        return latency, 1.0 / time_per_byte
+
+    def _set_bucket_cost_model(self, latency=None, bandwidth=None):
+        r"""
+        Pick the bucket boundaries from the gradient ready times and the cost
+        of an allreduce when the buckets are rebuilt at the end of the first
+        iteration, instead of from ``bucket_cap_mb``. The allreduce of ``n`` bytes
+        is assumed to take ``latency + n / bandwidth`` seconds. The boundaries are
+        the ones for which the allreduce of the last bucket, after the ready time
+        of the last gradient, finishes first.
+
+        Arguments:
+            latency (float, optional): latency of an allreduce in seconds
+            bandwidth (float, optional): bandwidth of an allreduce in bytes per
+                second. When either of them is not given, both are measured with
+                :meth:`_measure_allreduce_cost`.
+
+        .. warning ::
+            This must be called before the first backward pass. The gradient
+            ready times are taken from the first iteration, the bucket
+            assignment of rank 0 is used by all the ranks.
+        """
+        if latency is None or bandwidth is None:
+            latency, bandwidth = self._measure_allreduce_cost()
+        self.reducer._set_bucket_cost_model(latency * 1e9, 1e9 / bandwidth)
+
+    def _register_overlapped_optimizer(self, optimizer_class, *args, **kwargs):
+        r"""
+        Apply the optimizer update in the backward pass, to the parameters of
+        every bucket as soon as its reduced gradients are ready. The update of
+        a bucket then overlaps with the communication of the buckets that are
+        still being reduced, instead of starting after all of them.
+
+        One ``optimizer_class([param], *args, **kwargs)`` is created per
+        parameter, ``optimizer.step()`` must not be called on the parameters
+        anymore. Only backward passes that synchronize gradients update the
+        parameters, the ones run under :meth:`no_sync` do not.
+
+        Arguments:
+            optimizer_class (type): a :class:`torch.optim.Optimizer` subclass
+            *args, **kwargs: the arguments of ``optimizer_class`` after the
+                parameters
+
+        Returns:
+            the per-parameter optimizers, in the order of ``parameters()``
+
+        .. warning ::
+            The callback can only be registered once.
+
+        Example::
+            >>> ddp._register_overlapped_optimizer(torch.optim.SGD, lr=0.1)
+            >>> for input in inputs:
+            >>>     ddp.zero_grad()
+            >>>     ddp(input).sum().backward()  # updates the parameters
+        """
+        params = list(self.module.parameters())
+        optimizers = [optimizer_class([p], *args, **kwargs) for p in params]
+        by_param = {p: optim for p, optim in zip(params, optimizers)}
+
+        def step(bucket_params):
+            for p in bucket_params:
+                if p.grad is not None:
+                    by_param[p].step()
+
+        self.reducer._register_bucket_ready_callback(step)
+        return optimizers
+
     def _distributed_broadcast_coalesced(self, tensors, buffer_size):
         dist._broadcast_coalesced(self.process_group, tensors, buffer_size)
 
@@ -1,13 +1,16 @@
 
 from .linear import Linear
-from .rnn import LSTM, LSTMCell, RNNCell, GRUCell
+from .rnn import LSTM, GRU, LSTMCell, RNNCell, GRUCell
 from .embeddingbag import EmbeddingBag
+from .activation import MultiheadAttention
 
 __all__ = [
     'Linear',
     'LSTM',
+    'GRU',
     'LSTMCell',
     'RNNCell',
     'GRUCell',
     'EmbeddingBag',
+    'MultiheadAttention',
 ]
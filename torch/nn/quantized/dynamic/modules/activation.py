@@ -0,0 +1,233 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import warnings
+
+import torch
+import torch.nn as nn
+import torch.nn.functional as F
+from torch.nn.quantized.modules.linear import LinearPackedParams
+from torch.nn.quantized.modules.utils import _quantize_weight
+
+
+def _empty_weight(out_features, in_features, dtype):
+    if dtype == torch.qint8:
+        return torch._empty_affine_quantized([out_features, in_features], scale=1, zero_point=0,
+                                             dtype=torch.qint8)
+    elif dtype == torch.float16:
+        return torch.zeros([out_features, in_features], dtype=torch.float)
+    else:
+        raise RuntimeError('Unsupported dtype specified for dynamic quantized MultiheadAttention!')
+
+
+class MultiheadAttention(torch.nn.Module):
+    r"""
+    A dynamic quantized multi-head attention module with floating point tensors
+    as inputs and outputs. We adopt the same interface as
+    `torch.nn.MultiheadAttention`, please see
+    https://pytorch.org/docs/stable/nn.html#torch.nn.MultiheadAttention for documentation.
+
+    The input and output projections are dynamic quantized linear layers.
+    For self-attention, where ``query``, ``key`` and ``value`` are the same
+    tensor, the query, key and value projections are fused: the input is
+    quantized once and goes through one GEMM with the packed ``in_proj``
+    weight. When only ``key`` and ``value`` are the same tensor, as in
+    encoder-decoder attention, the key and value projections are fused in the
+    same way. The attention itself is computed in floating point.
+
+    Only embedding sizes that are the same for the query, key and value are
+    supported, that is ``kdim`` and ``vdim`` must be ``None``.
+
+    Attributes:
+        in_proj: the packed weight and bias of the fused query, key and value
+                 projections, of shape :math:`(3 \times \text{embed\_dim}, \text{embed\_dim})`.
+        q_proj, kv_proj: the packed weight and bias of the query projection and
+                         of the fused key and value projections, for the attention
+                         of a query to other keys and values.
+        out_proj: the packed weight and bias of the output projection.
+
+    Examples::
+
+        >>> mha = nn.MultiheadAttention(512, 8)
+        >>> mha.qconfig = torch.quantization.default_dynamic_qconfig
+        >>> qmha = nn.quantized.dynamic.MultiheadAttention.from_float(mha)
+        >>> x = torch.randn(10, 32, 512)
+        >>> attn_output, attn_output_weights = qmha(x, x, x)
+    """
+    _FLOAT_MODULE = nn.MultiheadAttention
+
+    def __init__(self, embed_dim, num_heads, dropout=0., bias=True, add_bias_kv=False,
+                 add_zero_attn=False, dtype=torch.qint8):
+        super(MultiheadAttention, self).__init__()
+        self.embed_dim = embed_dim
+        self.num_heads = num_heads
+        self.dropout = dropout
+        self.head_dim = embed_dim // num_heads
+        assert self.head_dim * num_heads == self.embed_dim, "embed_dim must be divisible by num_heads"
+        self.add_zero_attn = add_zero_attn
+        self.dtype = dtype
+
+        def packed_params(out_features, in_features, with_bias):
+            params = LinearPackedParams(dtype)
+            b = torch.zeros(out_features, dtype=torch.float) if with_bias else None
+            params.set_weight_bias(_empty_weight(out_features, in_features, dtype), b)
+            return params
+
+        self.in_proj = packed_params(3 * embed_dim, embed_dim, bias)
+        self.q_proj = packed_params(embed_dim, embed_dim, bias)
+        self.kv_proj = packed_params(2 * embed_dim, embed_dim, bias)
+        self.out_proj = packed_params(embed_dim, embed_dim, True)
+
+        if add_bias_kv:
+            self.register_buffer('bias_k', torch.zeros(1, 1, embed_dim))
+            self.register_buffer('bias_v', torch.zeros(1, 1, embed_dim))
+        else:
+            self.bias_k = self.bias_v = None
+
+    def _get_name(self):
+        return 'DynamicQuantizedMultiheadAttention'
+
+    def extra_repr(self):
+        return 'embed_dim={}, num_heads={}, dtype={}'.format(
+            self.embed_dim, self.num_heads, self.dtype)
+
+    def _linear(self, x, params):
+        if params.dtype == torch.qint8:
+            return torch.ops.quantized.linear_dynamic(x, params._packed_params, reduce_range=True)
+        else:
+            return torch.ops.quantized.linear_dynamic_fp16(x, params._packed_params)
+
+    def forward(self, query, key, value, key_padding_mask=None,
+                need_weights=True, attn_mask=None):
+        tgt_len, bsz, embed_dim = query.size()
+        assert embed_dim == self.embed_dim
+        assert key.size(0) == value.size(0) and key.size(1) == value.size(1)
+        num_heads = self.num_heads
+        head_dim = self.head_dim
+
+        if torch.equal(query, key) and torch.equal(key, value):
+            q, k, v = self._linear(query, self.in_proj).chunk(3, dim=-1)
+        elif torch.equal(key, value):
+            q = self._linear(query, self.q_proj)
+            k, v = self._linear(key, self.kv_proj).chunk(2, dim=-1)
+        else:
+            q = self._linear(query, self.q_proj)
+            k = self._linear(key, self.kv_proj).narrow(-1, 0, embed_dim)
+            v = self._linear(value, self.kv_proj).narrow(-1, embed_dim, embed_dim)
+        q = q * (float(head_dim) ** -0.5)
+
+        if attn_mask is not None:
+            if attn_mask.dtype == torch.uint8:
+                warnings.warn("Byte tensor for attn_mask in nn.MultiheadAttention is deprecated. "
+                              "Use bool tensor instead.")
+                attn_mask = attn_mask.to(torch.bool)
+            if attn_mask.dim() == 2:
+                attn_mask = attn_mask.unsqueeze(0)
+                if list(attn_mask.size()) != [1, query.size(0), key.size(0)]:
+                    raise RuntimeError('The size of the 2D attn_mask is not correct.')
+            elif attn_mask.dim() == 3:
+                if list(attn_mask.size()) != [bsz * num_heads, query.size(0), key.size(0)]:
+                    raise RuntimeError('The size of the 3D attn_mask is not correct.')
+            else:
+                raise RuntimeError("attn_mask's dimension {} is not supported".format(attn_mask.dim()))
+
+        if key_padding_mask is not None and key_padding_mask.dtype == torch.uint8:
+            warnings.warn("Byte tensor for key_padding_mask in nn.MultiheadAttention is deprecated. "
+                          "Use bool tensor instead.")
+            key_padding_mask = key_padding_mask.to(torch.bool)
+
+        if self.bias_k is not None and self.bias_v is not None:
+            k = torch.cat([k, self.bias_k.repeat(1, bsz, 1)])
+            v = torch.cat([v, self.bias_v.repeat(1, bsz, 1)])
+            if attn_mask is not None:
+                attn_mask = F.pad(attn_mask, (0, 1))
+            if key_padding_mask is not None:
+                key_padding_mask = F.pad(key_padding_mask, (0, 1))
+
+        q = q.contiguous().view(tgt_len, bsz * num_heads, head_dim).transpose(0, 1)
+        k = k.contiguous().view(-1, bsz * num_heads, head_dim).transpose(0, 1)
+        v = v.contiguous().view(-1, bsz * num_heads, head_dim).transpose(0, 1)
+        src_len = k.size(1)
+
+        if key_padding_mask is not None:
+            assert key_padding_mask.size(0) == bsz
+            assert key_padding_mask.size(1) == src_len
+
+        if self.add_zero_attn:
+            src_len += 1
+            k = torch.cat([k, torch.zeros((k.size(0), 1) + k.size()[2:], dtype=k.dtype, device=k.device)], dim=1)
+            v = torch.cat([v, torch.zeros((v.size(0), 1) + v.size()[2:], dtype=v.dtype, device=v.device)], dim=1)
+            if attn_mask is not None:
+                attn_mask = F.pad(attn_mask, (0, 1))
+            if key_padding_mask is not None:
+                key_padding_mask = F.pad(key_padding_mask, (0, 1))
+
+        attn_output_weights = torch.bmm(q, k.transpose(1, 2))
+        if attn_mask is not None:
+            if attn_mask.dtype == torch.bool:
+                attn_output_weights.masked_fill_(attn_mask, float('-inf'))
+            else:
+                attn_output_weights += attn_mask
+        if key_padding_mask is not None:
+            attn_output_weights = attn_output_weights.view(bsz, num_heads, tgt_len, src_len)
+            attn_output_weights = attn_output_weights.masked_fill(
+                key_padding_mask.unsqueeze(1).unsqueeze(2), float('-inf'))
+            attn_output_weights = attn_output_weights.view(bsz * num_heads, tgt_len, src_len)
+
+        attn_output_weights = F.softmax(attn_output_weights, dim=-1)
+        attn_output_weights = F.dropout(attn_output_weights, p=self.dropout, training=self.training)
+
+        attn_output = torch.bmm(attn_output_weights, v)
+        attn_output = attn_output.transpose(0, 1).contiguous().view(tgt_len, bsz, embed_dim)
+        attn_output = self._linear(attn_output, self.out_proj)
+
+        if need_weights:
+            # average attention weights over heads
+            attn_output_weights = attn_output_weights.view(bsz, num_heads, tgt_len, src_len)
+            return attn_output, attn_output_weights.sum(dim=1) / num_heads
+        else:
+            return attn_output, None
+
+    @classmethod
+    def from_float(cls, mod):
+        r"""Create a dynamic quantized module from a float module
+
+        Args:
+            mod (Module): a float nn.MultiheadAttention module, either produced by
+                          torch.quantization utilities or provided by the user
+        """
+        assert type(mod) == cls._FLOAT_MODULE, \
+            'nn.quantized.dynamic.MultiheadAttention.from_float only works for nn.MultiheadAttention'
+        assert hasattr(mod, 'qconfig'), 'Input float module must have qconfig defined'
+        assert mod._qkv_same_embed_dim, \
+            'nn.quantized.dynamic.MultiheadAttention needs the same embedding size for query, key and value'
+        if mod.qconfig is not None and mod.qconfig.weight is not None:
+            weight_observer_method = mod.qconfig.weight
+        else:
+            from torch.quantization.qconfig import default_dynamic_qconfig
+            weight_observer_method = default_dynamic_qconfig.weight
+        dtype = weight_observer_method().dtype
+        assert dtype in [torch.qint8, torch.float16], \
+            'The only supported dtypes for dynamic quantized MultiheadAttention are qint8 and float16'
+
+        def pack(params, weight, bias):
+            if dtype == torch.qint8:
+                weight_observer = weight_observer_method()
+                weight_observer(weight)
+                weight = _quantize_weight(weight.float(), weight_observer)
+            else:
+                weight = weight.float()
+            params.set_weight_bias(weight, bias)
+
+        embed_dim = mod.embed_dim
+        qmod = cls(embed_dim, mod.num_heads, mod.dropout, mod.in_proj_bias is not None,
+                   mod.bias_k is not None, mod.add_zero_attn, dtype)
+        weight = mod.in_proj_weight.detach()
+        bias = mod.in_proj_bias.detach() if mod.in_proj_bias is not None else None
+        pack(qmod.in_proj, weight, bias)
+        pack(qmod.q_proj, weight[:embed_dim], bias[:embed_dim] if bias is not None else None)
+        pack(qmod.kv_proj, weight[embed_dim:], bias[embed_dim:] if bias is not None else None)
+        pack(qmod.out_proj, mod.out_proj.weight.detach(), mod.out_proj.bias.detach())
+        if mod.bias_k is not None:
+            qmod.bias_k.copy_(mod.bias_k.detach())
+            qmod.bias_v.copy_(mod.bias_v.detach())
+        qmod.train(mod.training)
+        return qmod
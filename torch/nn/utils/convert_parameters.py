@@ -54,6 +54,68 @@ def vector_to_parameters(vec: torch.Tensor, parameters: Iterable[torch.Tensor])
         pointer += num_param
 
 
+def grads_to_flat_buffer(parameters: Iterable[torch.Tensor]) -> torch.Tensor:
+    r"""Make the gradients of parameters views into one flat buffer
+
+    Autograd then copies the first gradient of each parameter into its part
+    of the buffer and accumulates later ones there, instead of allocating a
+    separate ``.grad`` per parameter, so that the gradients can be zeroed,
+    scaled or reduced all at once through the buffer. Gradients that already
+    exist are copied into the buffer, and parts for parameters without one
+    are zero. A gradient set to ``None`` goes back into the buffer on the
+    next backward, use ``torch.autograd._set_grad_buffer(param, None)`` to
+    stop using the buffer for a parameter.
+
+    Arguments:
+        parameters (Iterable[Tensor]): an iterator of Tensors that are the
+            parameters of a model, all of the same dtype and on the same
+            device.
+
+    Returns:
+        The buffer holding the gradients of the parameters one after another
+    """
+    parameters = [p for p in parameters if p.requires_grad]
+    if not parameters:
+        raise ValueError("grads_to_flat_buffer expects at least one parameter that requires grad")
+    param_device = None
+    for param in parameters:
+        param_device = _check_param_device(param, param_device)
+        if param.dtype != parameters[0].dtype:
+            raise TypeError("all parameters should have the same dtype, got {} and {}"
+                            .format(parameters[0].dtype, param.dtype))
+
+    buffer = torch.zeros(sum(p.numel() for p in parameters),
+                         dtype=parameters[0].dtype, device=parameters[0].device)
+    with torch.no_grad():
+        pointer = 0
+        for param in parameters:
+            num_param = param.numel()
+            view = buffer[pointer:pointer + num_param]
+            # Same strides as the parameter for dense ones, the layout
+            # AccumulateGrad gives a new grad
+            if param.is_contiguous() or not _is_non_overlapping_and_dense(param):
+                view = view.view(param.size())
+            else:
+                view = view.as_strided(param.size(), param.stride())
+            if param.grad is not None:
+                view.copy_(param.grad)
+                param.grad = view
+            torch.autograd._set_grad_buffer(param, view)
+            pointer += num_param
+    return buffer
+
+
+def _is_non_overlapping_and_dense(tensor: torch.Tensor) -> bool:
+    # The strides are a permutation of contiguous ones
+    dims = sorted(range(tensor.dim()), key=lambda d: (tensor.stride(d), tensor.size(d)))
+    expected = 1
+    for d in dims:
+        if tensor.size(d) != 1 and tensor.stride(d) != expected:
+            return False
+        expected *= tensor.size(d)
+    return True
+
+
 def _check_param_device(param: torch.Tensor, old_param_device: Optional[int]) -> int:
     r"""This helper function is to check if the parameters are located
     in the same device. Currently, the conversion between model parameters
@@ -148,6 +148,10 @@ def get_ignored_functions() -> Set[Callable]:
         torch.nn.functional.tanh,
         torch.set_autocast_enabled,
         torch.is_autocast_enabled,
+        torch.set_autocast_cpu_enabled,
+        torch.is_autocast_cpu_enabled,
+        torch.set_autocast_cache_persistent,
+        torch.is_autocast_cache_persistent,
         torch.clear_autocast_cache,
         torch.autocast_increment_nesting,
         torch.autocast_decrement_nesting,
@@ -323,6 +327,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.div: lambda input, other, out=None: -1,
         torch.dot: lambda mat1, mat2: -1,
         torch.dropout: lambda input, p, train, inplace=False: -1,
+        torch.dropout_add_layer_norm: (lambda input, residual, normalized_shape, weight=None, bias=None, p=0.5, eps=1e-05,
+                                       train=True, generator=None: -1),
         torch.dsmm: lambda input, mat2: -1,
         torch.hsmm: lambda mat1, mat2: -1,
         torch.dstack: lambda tensors, out=None: -1,
@@ -375,6 +381,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.grid_sampler_2d: lambda input, grid, interpolation_mode, padding_mode, align_corners: -1,
         torch.grid_sampler_3d: lambda input, grid, interpolation_mode, padding_mode, align_corners: -1,
         torch.group_norm: lambda input, num_groups, weight=None, bias=None, eps=1e-05, cudnn_enabled=True: -1,
+        torch.grouped_mm: lambda input, mat2: -1,
         torch.gru: lambda input, hx, params, has_biases, num_layers, gropout, train, bidirectional, batch_first: -1,
         torch.gru_cell: lambda input, hx, w_ih, w_hh, b_ih=None, b_hh=None: -1,
         torch.gt: lambda input, other, out=None: -1,
@@ -681,10 +688,12 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.rsqrt: lambda input, out=None: -1,
         torch.rsub: lambda input, other, alpha=1: -1,
         torch.saddmm: lambda input, mat1, mat2, beta=1, alpha=1, out=None: -1,
+        torch.scale_mask_softmax: lambda input, mask, scale=1.0: -1,
         torch.scatter: lambda input, dim, index, src: -1,
         torch.scatter_add: lambda input, dim, index, src: -1,
         torch.searchsorted: lambda sorted_sequence, input, out_int32=False, right=False, out=None: -1,
         torch.select: lambda input, dim, index: -1,
+        torch.segment_reduce: lambda data, reduce, offsets, axis=0: -1,
         torch.selu: lambda input, inplace=False: -1,
         torch.sigmoid: lambda input, out=None: -1,
         torch.sign: lambda input, out=None: -1,
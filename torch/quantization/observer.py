@@ -378,12 +378,13 @@ class MinMaxObserver(_ObserverBase):
         x = x.to(self.min_val.dtype)
         min_val = self.min_val
         max_val = self.max_val
+        min_val_cur, max_val_cur = torch._aminmax(x)
         if min_val.numel() == 0 or max_val.numel() == 0:
-            min_val = torch.min(x)
-            max_val = torch.max(x)
+            min_val = min_val_cur
+            max_val = max_val_cur
         else:
-            min_val = torch.min(torch.min(x), min_val)
-            max_val = torch.max(torch.max(x), max_val)
+            min_val = torch.min(min_val_cur, min_val)
+            max_val = torch.max(max_val_cur, max_val)
         self.min_val.resize_(min_val.shape)
         self.max_val.resize_(max_val.shape)
         self.min_val.copy_(min_val)
@@ -629,12 +630,13 @@ class PerChannelMinMaxObserver(_ObserverBase):
         # are done in place and types need to match for comparisons
         y = y.to(self.min_vals.dtype)
         y = torch.flatten(y, start_dim=1)
+        min_vals_cur, max_vals_cur = torch._aminmax(y, 1)
         if min_vals.numel() == 0 or max_vals.numel() == 0:
-            min_vals = torch.min(y, 1)[0]
-            max_vals = torch.max(y, 1)[0]
+            min_vals = min_vals_cur
+            max_vals = max_vals_cur
         else:
-            min_vals = torch.min(torch.min(y, 1)[0], min_vals)
-            max_vals = torch.max(torch.max(y, 1)[0], max_vals)
+            min_vals = torch.min(min_vals_cur, min_vals)
+            max_vals = torch.max(max_vals_cur, max_vals)
         self.min_vals.resize_(min_vals.shape)
         self.max_vals.resize_(max_vals.shape)
         self.min_vals.copy_(min_vals)
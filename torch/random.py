@@ -51,6 +51,30 @@ def seed() -> int:
     return seed
 
 
+def set_philox_cpu_rng(enabled) -> None:
+    r"""Makes :meth:`~Tensor.uniform_`, :meth:`~Tensor.normal_` and
+    :meth:`~Tensor.bernoulli_` on CPU, and the functions built on them like
+    :func:`torch.rand`, :func:`torch.randn` and dropout, generate their
+    numbers in parallel with the counter based Philox engine.
+
+    Each call then takes a single 64 bit seed from the CPU generator, so
+    :func:`manual_seed`, :func:`get_rng_state` and :func:`set_rng_state`
+    work as before, and the numbers it generates do not depend on the number
+    of threads. They are not the same as the ones generated otherwise.
+
+    Args:
+        enabled (bool): whether to generate with Philox
+    """
+    torch._C._set_philox_cpu_rng(enabled)
+
+
+def is_philox_cpu_rng_enabled() -> bool:
+    r"""Returns whether the CPU generation with Philox is enabled, see
+    :func:`set_philox_cpu_rng`.
+    """
+    return torch._C._get_philox_cpu_rng()
+
+
 def initial_seed() -> int:
     r"""Returns the initial seed for generating random numbers as a
     Python `long`.
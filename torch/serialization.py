@@ -1,3 +1,4 @@
+import concurrent.futures
 import difflib
 import os
 import io
@@ -238,8 +239,12 @@ def _open_file_like(name_or_buffer, mode):
 
 
 class _open_zipfile_reader(_opener):
-    def __init__(self, name_or_buffer) -> None:
-        super(_open_zipfile_reader, self).__init__(torch._C.PyTorchFileReader(name_or_buffer))
+    def __init__(self, name_or_buffer, mmap=False) -> None:
+        if mmap:
+            reader = torch._C.PyTorchFileReader(str(name_or_buffer), True)
+        else:
+            reader = torch._C.PyTorchFileReader(name_or_buffer)
+        super(_open_zipfile_reader, self).__init__(reader)
 
 
 class _open_zipfile_writer_file(_opener):
@@ -331,7 +336,8 @@ def _check_dill_version(pickle_module) -> None:
             ))
 
 def save(obj, f: Union[str, os.PathLike, BinaryIO],
-         pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=True) -> None:
+         pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=True,
+         compress=False) -> None:
     """Saves an object to a disk file.
 
     See also: `saving-loading-tensors`
@@ -342,6 +348,11 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO],
            os.PathLike object containing a file name
         pickle_module: module used for pickling metadata and objects
         pickle_protocol: can be specified to override the default protocol
+        compress: deflate the tensor data. It makes the file smaller, e.g. for
+           embedding tables, at the cost of compressing while saving and
+           decompressing while loading, which :func:`torch.load` does in
+           parallel. Compressed tensors are not memory-mapped by
+           ``torch.load(mmap=True)``. Default: ``False``.
 
     .. note::
         A common PyTorch convention is to save tensors using .pt file extension.
@@ -350,6 +361,9 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO],
         PyTorch preserves storage sharing across serialization. See
         `preserve-storage-sharing` for more details.
 
+    .. note::
+        :func:`torch.save_async` saves in the background instead.
+
     .. note::
         The 1.6 release of PyTorch switched ``torch.save`` to use a new
         zipfile-based file format. ``torch.load`` still retains the ability to
@@ -369,8 +383,10 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO],
     with _open_file_like(f, 'wb') as opened_file:
         if _use_new_zipfile_serialization:
             with _open_zipfile_writer(opened_file) as opened_zipfile:
-                _save(obj, opened_zipfile, pickle_module, pickle_protocol)
+                _save(obj, opened_zipfile, pickle_module, pickle_protocol, compress)
                 return
+        if compress:
+            raise ValueError("compress is only supported by the zipfile based format")
         _legacy_save(obj, opened_file, pickle_module, pickle_protocol)
 
 
@@ -447,7 +463,12 @@ def _legacy_save(obj, f, pickle_module, pickle_protocol) -> None:
         serialized_storages[key]._write_file(f, _should_read_directly(f), True)
 
 
-def _save(obj, zip_file, pickle_module, pickle_protocol):
+def _save(obj, zip_file, pickle_module, pickle_protocol, compress=False):
+    data_value, serialized_storages = _pickle_with_storages(obj, pickle_module, pickle_protocol)
+    _write_zipfile(zip_file, data_value, serialized_storages, compress)
+
+
+def _pickle_with_storages(obj, pickle_module, pickle_protocol):
     serialized_storages = {}
 
     def persistent_id(obj):
@@ -469,12 +490,16 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
                     obj.size())
         return None
 
-    # Write the pickle data for `obj`
+    # Pickle `obj`, the storages are written separately
     data_buf = io.BytesIO()
     pickler = pickle_module.Pickler(data_buf, protocol=pickle_protocol)
     pickler.persistent_id = persistent_id
     pickler.dump(obj)
-    data_value = data_buf.getvalue()
+    return data_buf.getvalue(), serialized_storages
+
+
+def _write_zipfile(zip_file, data_value, serialized_storages, compress=False):
+    # Write the pickle data for `obj`
     zip_file.write_record('data.pkl', data_value, len(data_value))
 
     # Write each tensor to a file named tensor/the_tensor_key in the zip archive
@@ -484,16 +509,69 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
         if storage.device.type == 'cpu':
             # If it's on the CPU we can directly copy it into the zip file
             num_bytes = storage.size() * storage.element_size()
-            zip_file.write_record(name, storage.data_ptr(), num_bytes)
+            zip_file.write_record(name, storage.data_ptr(), num_bytes, compress)
         else:
             # Copy to a buffer, then serialize that
             buf = io.BytesIO()
             storage._write_file(buf, _should_read_directly(buf))
             buf_value = buf.getvalue()
-            zip_file.write_record(name, buf_value, len(buf_value))
+            zip_file.write_record(name, buf_value, len(buf_value), compress)
 
 
-def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
+# A single thread, so that the saves are written in the order they were made
+_save_async_executor: Optional[concurrent.futures.ThreadPoolExecutor] = None
+
+
+def save_async(obj, f: Union[str, os.PathLike, BinaryIO],
+               pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, compress=False) -> concurrent.futures.Future:
+    """Saves an object to a disk file like :func:`torch.save`, in the background.
+
+    ``obj`` is pickled and the storages of its tensors are copied to CPU memory
+    before this returns, so ``obj`` can be modified right away, e.g. by the
+    next training step. The copies are then written to ``f`` by a background
+    thread, which does not hold the GIL while writing them to a file. Saves are
+    written one at a time, in the order they were started.
+
+    Args:
+        obj: saved object
+        f: a file-like object (has to implement write and flush) or a string or
+           os.PathLike object containing a file name. It must not be used
+           until the save is done.
+        pickle_module: module used for pickling metadata and objects
+        pickle_protocol: can be specified to override the default protocol
+        compress: deflate the tensor data, see :func:`torch.save`
+
+    Returns:
+        A :class:`concurrent.futures.Future` completed once ``f`` is written,
+        which raises the errors of the save from :meth:`~concurrent.futures.Future.result`.
+
+    .. note::
+        The copies of the storages take as much CPU memory as the storages,
+        until they are written.
+
+    Example:
+        >>> future = torch.save_async(model.state_dict(), 'checkpoint.pt')
+        >>> train_one_epoch(model)
+        >>> future.result()
+    """
+    global _save_async_executor
+    _check_dill_version(pickle_module)
+
+    data_value, serialized_storages = _pickle_with_storages(obj, pickle_module, pickle_protocol)
+    serialized_storages = {key: storage.clone() if storage.device.type == 'cpu' else storage.cpu()
+                           for key, storage in serialized_storages.items()}
+
+    def write():
+        # File names are written from C++, without going through Python
+        with _open_zipfile_writer(f) as opened_zipfile:
+            _write_zipfile(opened_zipfile, data_value, serialized_storages, compress)
+
+    if _save_async_executor is None:
+        _save_async_executor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+    return _save_async_executor.submit(write)
+
+
+def load(f, map_location=None, pickle_module=pickle, mmap=False, **pickle_load_args):
     """Loads an object saved with :func:`torch.save` from a file.
 
     :func:`torch.load` uses Python's unpickling facilities but treats storages,
@@ -532,6 +610,12 @@ def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
             locations
         pickle_module: module used for unpickling metadata and objects (has to
             match the :attr:`pickle_module` used to serialize file)
+        mmap: map the file into memory copy-on-write instead of reading it. The
+            storages of the CPU tensors then point into the mapping, are only
+            read from disk when first accessed, and share the page cache with
+            the other processes mapping the file. :attr:`f` has to be a file
+            name, of a file saved with the default zipfile based format.
+            Default: ``False``.
         pickle_load_args: (Python 3 only) optional keyword arguments passed over to
             :func:`pickle_module.load` and :func:`pickle_module.Unpickler`, e.g.,
             :attr:`errors=...`.
@@ -578,20 +662,28 @@ def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
     if 'encoding' not in pickle_load_args.keys():
         pickle_load_args['encoding'] = 'utf-8'
 
+    if mmap and not _is_path(f):
+        raise ValueError("mmap can only be used when f is a file name")
+
     with _open_file_like(f, 'rb') as opened_file:
         if _is_zipfile(opened_file):
             # The zipfile reader is going to advance the current file position.
             # If we want to actually tail call to torch.jit.load, we need to
             # reset back to the original position.
             orig_position = opened_file.tell()
-            with _open_zipfile_reader(opened_file) as opened_zipfile:
+            with _open_zipfile_reader(f if mmap else opened_file, mmap) as opened_zipfile:
                 if _is_torchscript_zip(opened_zipfile):
                     warnings.warn("'torch.load' received a zip file that looks like a TorchScript archive"
                                   " dispatching to 'torch.jit.load' (call 'torch.jit.load' directly to"
                                   " silence this warning)", UserWarning)
+                    if mmap:
+                        return torch.jit.load(f, mmap=True)
                     opened_file.seek(orig_position)
                     return torch.jit.load(opened_file)
                 return _load(opened_zipfile, map_location, pickle_module, **pickle_load_args)
+        if mmap:
+            raise RuntimeError("mmap can only be used with files saved with the zipfile based "
+                               "format, which is the default of torch.save")
         return _legacy_load(opened_file, map_location, pickle_module, **pickle_load_args)
 
 
@@ -847,6 +939,9 @@ def _load(zip_file, map_location, pickle_module, **pickle_load_args):
         storage = loaded_storages[key]
         return storage
 
+    # Decompresses the compressed tensors, if any, in parallel
+    zip_file.prefetch_records([name for name in zip_file.get_all_records() if name.startswith('data/')])
+
     # Load the data (which may in turn use `persistent_load` to load tensors)
     data_file = io.BytesIO(zip_file.get_record('data.pkl'))
     unpickler = pickle_module.Unpickler(data_file, **pickle_load_args)
@@ -900,6 +900,30 @@ class DistAutogradTest(RpcAgentTestFixture):
             self.assertEqual(t1_grad_before, t1.grad)
             self.assertEqual(t2_grad_before, t2.grad)
 
+    @dist_init
+    def test_backward_releases_autograd_functions(self):
+        t1 = torch.rand((3, 3), requires_grad=True)
+        t2 = torch.rand((3, 3), requires_grad=True)
+        with dist_autograd.context() as context_id:
+            loss = rpc.rpc_sync(
+                worker_name(self._next_rank()),
+                torch.add,
+                args=(t1, t2)).sum()
+            ctx = dist_autograd._current_context()
+
+            dist_autograd.backward(context_id, [loss], retain_graph=True)
+            self.assertEqual(1, len(ctx._send_functions()))
+            self.assertEqual(1, len(ctx._recv_functions()))
+
+            dist_autograd.backward(context_id, [loss])
+            self.assertEqual(0, len(ctx._send_functions()))
+            self.assertEqual(0, len(ctx._recv_functions()))
+
+            # The gradients are still in the context.
+            grads = dist_autograd.get_gradients(context_id)
+            self.assertEqual(torch.full((3, 3), 2.), grads[t1])
+            self.assertEqual(torch.full((3, 3), 2.), grads[t2])
+
     def _test_backward_simple(self, dst):
         # Run the same code locally and with dist autograd and verify gradients
         # are same.
@@ -1729,8 +1753,13 @@ class DistAutogradTest(RpcAgentTestFixture):
         debug_info = dist_autograd._get_debug_info()
         assert debug_info is not None
         self.assertEqual(0, int(debug_info["num_current_backward_passes"]))
-        # only have `num_current_backward_passes` and `num_autograd contexts`
-        self.assertTrue(len(debug_info) == 2)
+        # only have `num_current_backward_passes`, `num_autograd contexts` and
+        # the remote gradient wait metrics
+        self.assertTrue(len(debug_info) == 4)
+        self.assertGreaterEqual(int(debug_info["num_remote_gradient_waits"]), 1)
+        self.assertGreaterEqual(
+            int(debug_info["average_remote_gradient_wait_time_us"]), 0
+        )
 
         self.assertTrue(_all_contexts_cleaned_up())
 
@@ -238,6 +238,15 @@ def multi_layer_nested_async_rpc(dst, world_size, ttl):
         return 0
 
 
+def wait_for_trace_spans(num_spans, timeout=10):
+    start = time.time()
+    spans = rpc._tracing.get_spans()
+    while len(spans) < num_spans and time.time() - start < timeout:
+        time.sleep(0.1)
+        spans = rpc._tracing.get_spans()
+    return spans
+
+
 def nested_rref(dst):
     return (
         rpc.remote(dst, torch.add, args=(torch.ones(2, 2), 1)),
@@ -315,6 +324,10 @@ def get_rref_debug_info():
     return _rref_context_get_debug_info()
 
 
+def get_agent_debug_info():
+    return rpc.api._get_current_rpc_agent().get_debug_info()
+
+
 def add_use_future_cb(to, x, y, z):
     out = concurrent.futures.Future()
 
@@ -1451,6 +1464,56 @@ class RpcTest(RpcAgentTestFixture):
         inner_profile_rref.rpc_sync().key_averages()
         outer_profile_rref.rpc_sync().key_averages()
 
+    @dist_init
+    def test_rpc_tracing(self):
+        if self.rank != 0:
+            return
+
+        dst_worker_name = worker_name((self.rank + 1) % self.world_size)
+        nested_worker_name = worker_name((self.rank + 2) % self.world_size)
+        rpc._set_rpc_trace_sample_rate(1.0)
+        rpc.rpc_sync(dst_worker_name, nested_rpc, args=(nested_worker_name,))
+        rpc._set_rpc_trace_sample_rate(0.0)
+
+        client_spans = wait_for_trace_spans(1)
+        dst_spans = rpc.rpc_sync(dst_worker_name, wait_for_trace_spans, args=(2,))
+        nested_spans = rpc.rpc_sync(
+            nested_worker_name, wait_for_trace_spans, args=(1,)
+        )
+        self.assertEqual(len(client_spans), 1)
+        self.assertEqual(len(dst_spans), 2)
+        self.assertEqual(len(nested_spans), 1)
+
+        # The nested RPC issued by the callee carries on the trace.
+        root = client_spans[0]
+        server = next(span for span in dst_spans if span["is_server"])
+        nested_client = next(span for span in dst_spans if not span["is_server"])
+        nested_server = nested_spans[0]
+        self.assertEqual(root["parent_span_id"], -1)
+        self.assertEqual(server["parent_span_id"], root["span_id"])
+        self.assertEqual(nested_client["parent_span_id"], server["span_id"])
+        self.assertEqual(nested_server["parent_span_id"], nested_client["span_id"])
+        for span in dst_spans + nested_spans:
+            self.assertEqual(span["trace_id"], root["trace_id"])
+            self.assertFalse(span["has_error"])
+        self.assertEqual(server["peer_id"], self.rank)
+        self.assertLessEqual(root["start_us"], root["end_us"])
+
+        trace = rpc._tracing.merge_traces([client_spans, dst_spans, nested_spans])
+        complete_events = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+        self.assertEqual(len(complete_events), 4)
+        root_event = next(
+            e for e in complete_events if e["args"]["span_id"] == root["span_id"]
+        )
+        self.assertEqual(
+            root_event["args"]["server_us"], server["end_us"] - server["start_us"]
+        )
+        self.assertEqual(
+            root_event["args"]["server_us"]
+            + root_event["args"]["network_and_queue_us"],
+            root_event["dur"],
+        )
+
     @dist_init
     def test_async_record_function_double_end_callbacks(self):
         num_sleep_seconds = 1
@@ -2533,6 +2596,24 @@ class RpcTest(RpcAgentTestFixture):
         )
         self.assertEqual(ret, True)
 
+    @dist_init
+    def test_rref_batched_user_deletes(self):
+        dst_rank = (self.rank + 1) % self.world_size
+        # Deleting these at once queues the deletes behind the first one, they
+        # reach the owner as RREF_USER_DELETE_BATCH messages.
+        rrefs = [
+            rpc.remote(worker_name(dst_rank), torch.add, args=(torch.ones(2, 2), i))
+            for i in range(50)
+        ]
+        for i, rref in enumerate(rrefs):
+            self.assertEqual(rref.to_here(), torch.ones(2, 2) + i)
+        wait_until_pending_futures_and_users_flushed()
+
+        del rref
+        del rrefs
+        wait_until_pending_futures_and_users_flushed()
+        wait_until_owners_and_forks_on_rank(0, 0, dst_rank)
+
     @dist_init
     def test_user_rrefs_confirmed_remote(self):
         dst_rank = (self.rank + 1) % self.world_size
@@ -3759,6 +3840,51 @@ class TensorPipeAgentRpcTest(RpcAgentTestFixture):
         self.assertEqual(default_timeout, timeout)
         rpc.shutdown()
 
+    @dist_init
+    def test_tensorpipe_request_latency_metrics(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        rpc.rpc_sync(dst, torch.add, args=(torch.ones(2), 1))
+        rpc.rpc_sync(dst, my_function, args=(torch.ones(2), 1, 1))
+
+        # The latencies are recorded before the responses are sent.
+        info = rpc.rpc_sync(dst, get_agent_debug_info)
+        self.assertEqual(
+            int(info["agent.python_thread_pool_size"]),
+            self.rpc_backend_options.num_worker_threads,
+        )
+        # The values of MessageType::SCRIPT_CALL and MessageType::PYTHON_CALL.
+        for message_type in (0, 2):
+            histogram = info["agent.request_latency_us.{}".format(message_type)]
+            counts = [int(bucket.split(":")[1]) for bucket in histogram.split(",")]
+            self.assertGreaterEqual(sum(counts), 1)
+
+    @dist_init(setup_rpc=False)
+    def test_tensorpipe_batched_requests(self):
+        rpc_backend_options = rpc.TensorPipeRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+            num_worker_threads=self.rpc_backend_options.num_worker_threads,
+            max_batch_bytes=4096,
+        )
+        self.assertEqual(rpc_backend_options.max_batch_bytes, 4096)
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+
+        dst = worker_name((self.rank + 1) % self.world_size)
+        # Small and large requests, the latter fill a batch on their own.
+        futs = [
+            rpc.rpc_async(dst, torch.add, args=(torch.ones(n), i))
+            for i, n in enumerate([1, 2, 3, 2048] * 50)
+        ]
+        for i, fut in enumerate(futs):
+            n = [1, 2, 3, 2048][i % 4]
+            self.assertEqual(fut.wait(), torch.ones(n) + i)
+        rpc.shutdown()
+
     # FIXME Merge this test with the corresponding one in RpcTest.
     @dist_init(setup_rpc=False)
     def test_tensorpipe_options_throw_on_timedelta_timeout(self):
@@ -3871,6 +3997,30 @@ class TensorPipeAgentRpcTest(RpcAgentTestFixture):
         self.assertEqual(ret, (torch.zeros(2) + torch.ones(2)).to(1))
         rpc.shutdown()
 
+    @skip_if_lt_x_gpu(2)
+    def test_device_maps_gpu_non_contiguous(self):
+        options = self.rpc_backend_options
+        dst = worker_name((self.rank + 1) % self.world_size)
+        options.set_device_map(dst, {0: 1, 1: 0})
+
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=options,
+        )
+
+        x = torch.arange(64.).view(8, 8).to(0)
+        ret = rpc.rpc_sync(
+            dst,
+            TensorPipeAgentRpcTest._gpu_add,
+            args=(x.t(), x[::2].repeat(2, 1))
+        )
+        self.assertEqual(ret.device, torch.device(1))
+        self.assertEqual(ret, (x.t() + x[::2].repeat(2, 1)).to(1))
+        rpc.shutdown()
+
     @staticmethod
     def _gpu_add_multi_gpu(x, y):
         if all([x.is_cuda, x.device.index == 0, y.is_cuda, y.device.index == 1]):
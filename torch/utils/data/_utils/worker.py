@@ -126,6 +126,9 @@ def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
         signal_handling._set_worker_signal_handlers()
 
         torch.set_num_threads(1)
+        # With the file_system sharing strategy, carve the many small storages
+        # sent to the main process out of a few pooled shared memory segments.
+        torch._C._set_shm_pool_enabled(True)
         random.seed(seed)
         torch.manual_seed(seed)
 
@@ -204,3 +207,5 @@ def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
     if done_event.is_set():
         data_queue.cancel_join_thread()
         data_queue.close()
+    # The process exits without destructors, the segments are released here.
+    torch._C._set_shm_pool_enabled(False)
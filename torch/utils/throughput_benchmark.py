@@ -37,6 +37,37 @@ class ExecutionStats(object):
     def num_iters(self):
         return self._c_stats.num_iters
 
+    @property
+    def latency_p50_ms(self):
+        return self._c_stats.latency_p50_ms
+
+    @property
+    def latency_p90_ms(self):
+        return self._c_stats.latency_p90_ms
+
+    @property
+    def latency_p99_ms(self):
+        return self._c_stats.latency_p99_ms
+
+    @property
+    def latency_p999_ms(self):
+        return self._c_stats.latency_p999_ms
+
+    @property
+    def queueing_avg_ms(self):
+        '''
+        Returns the average time a request waited for a calling thread, which
+        is only non-zero in open loop mode
+        '''
+        return self._c_stats.queueing_avg_ms
+
+    @property
+    def thread_cpu_time_seconds(self):
+        '''
+        Returns the CPU time each calling thread spent in the measured phase
+        '''
+        return self._c_stats.thread_cpu_time_s
+
     @property
     def iters_per_second(self):
         '''
@@ -46,13 +77,16 @@ class ExecutionStats(object):
 
     @property
     def total_time_seconds(self):
-        return self.num_iters * (
-            self.latency_avg_ms / 1000.0) / self.benchmark_config.num_calling_threads
+        return self._c_stats.wall_time_s
 
 
     def __str__(self):
         return '\n'.join([
             "Average latency per example: " + format_time(time_ms=self.latency_avg_ms),
+            "Latency p50 / p90 / p99 / p99.9: " + " / ".join(
+                format_time(time_ms=t) for t in [
+                    self.latency_p50_ms, self.latency_p90_ms,
+                    self.latency_p99_ms, self.latency_p999_ms]),
             "Total number of iterations: {}".format(self.num_iters),
             "Total number of iterations per second (across all threads): {:.2f}".format(self.iters_per_second),
             "Total time: " + format_time(time_s=self.total_time_seconds)
@@ -122,7 +156,8 @@ class ThroughputBenchmark(object):
             num_calling_threads=1,
             num_warmup_iters=10,
             num_iters=100,
-            profiler_output_path=""):
+            profiler_output_path="",
+            arrival_rate=0.0):
         '''
         Args:
             num_warmup_iters (int): Warmup iters are used to make sure we run a module
@@ -142,16 +177,26 @@ class ThroughputBenchmark(object):
                 execution (but not the warmup phase). The full trace will be saved
                 into the file path provided by this argument
 
+            arrival_rate (float): If positive, runs in open loop: requests arrive
+                as a Poisson process with this mean number of requests per second,
+                whether or not the calling threads keep up with them, and their
+                latency includes the time they wait for a free calling thread.
+                With the default of 0 every calling thread issues its next request
+                as soon as the previous one completes
+
 
         This function returns BenchmarkExecutionStats object which is defined via pybind11.
-        It currently has two fields:
+        Its main fields are:
             - num_iters - number of actual iterations the benchmark have made
             - avg_latency_ms - average time it took to infer on one input example in milliseconds
+            - latency_p50_ms, latency_p90_ms, latency_p99_ms, latency_p999_ms - latency
+              percentiles in milliseconds
         '''
         config = torch._C.BenchmarkConfig()
         config.num_calling_threads = num_calling_threads
         config.num_warmup_iters = num_warmup_iters
         config.num_iters = num_iters
         config.profiler_output_path = profiler_output_path
+        config.arrival_rate = arrival_rate
         c_stats = self._benchmark.benchmark(config)
         return ExecutionStats(c_stats, config)